@@ -0,0 +1,437 @@
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/findrandompointaroundcircle.hpp>
+#include <components/detournavigator/findsmoothpath.hpp>
+#include <components/detournavigator/generatenavmeshtile.hpp>
+#include <components/detournavigator/makenavmesh.hpp>
+#include <components/detournavigator/navmeshdata.hpp>
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/detournavigator/raycast.hpp>
+#include <components/detournavigator/recastmeshprovider.hpp>
+#include <components/detournavigator/serialization.hpp>
+#include <components/detournavigator/settings.hpp>
+#include <components/detournavigator/settingsutils.hpp>
+#include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/resource/bulletshape.hpp>
+
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+
+#include <DetourNavMesh.h>
+
+#include <osg/Math>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr int heightfieldSize = ESM::Land::LAND_SIZE;
+    constexpr int cellSize = ESM::Land::REAL_SIZE;
+    constexpr std::size_t boxesPerCell = 300;
+    constexpr std::size_t queryPoints = 256;
+    const osg::Vec2i cellPosition(0, 0);
+    const std::string worldspace = "sys::default";
+    const osg::Vec3f agentHalfExtents(29, 29, 66);
+    constexpr float stepSize = 28.333332061767578125f;
+
+    Settings makeSettings()
+    {
+        Settings result;
+        result.mRecast.mBorderSize = 16;
+        result.mRecast.mCellHeight = 0.2f;
+        result.mRecast.mCellSize = 0.2f;
+        result.mRecast.mDetailSampleDist = 6;
+        result.mRecast.mDetailSampleMaxError = 1;
+        result.mRecast.mMaxClimb = 34;
+        result.mRecast.mMaxSimplificationError = 1.3f;
+        result.mRecast.mMaxSlope = 49;
+        result.mRecast.mRecastScaleFactor = 0.017647058823529415f;
+        result.mRecast.mSwimHeightScale = 0.89999997615814208984375f;
+        result.mRecast.mMaxEdgeLen = 12;
+        result.mRecast.mMaxVertsPerPoly = 6;
+        result.mRecast.mRegionMergeArea = 400;
+        result.mRecast.mRegionMinArea = 64;
+        result.mRecast.mTileSize = 64;
+        result.mDetour.mMaxNavMeshQueryNodes = 2048;
+        result.mDetour.mMaxPolygonPathSize = 1024;
+        result.mDetour.mMaxSmoothPathSize = 1024;
+        result.mDetour.mMaxPolys = 4096;
+        result.mMaxTilesNumber = 512;
+        result.mNavMeshVersion = 1;
+        return result;
+    }
+
+    float getGroundHeight(float x, float y)
+    {
+        return 400 * std::sin(x / 1500) * std::cos(y / 1100) + 150 * std::sin((x + y) / 600);
+    }
+
+    /// Terrain with hills and boxes of various sizes standing on it, generated from a fixed seed
+    class Scene
+    {
+    public:
+        explicit Scene(const RecastSettings& settings)
+            : mRecastMeshManager(settings)
+            , mInstance(new Resource::BulletShapeInstance(new Resource::BulletShape))
+        {
+            mRecastMeshManager.setWorldspace(worldspace);
+
+            const float step = static_cast<float>(cellSize) / (heightfieldSize - 1);
+            mHeights.reserve(heightfieldSize * heightfieldSize);
+            for (int y = 0; y < heightfieldSize; ++y)
+                for (int x = 0; x < heightfieldSize; ++x)
+                    mHeights.push_back(getGroundHeight(x * step, y * step));
+            const auto [minHeight, maxHeight] = std::minmax_element(mHeights.begin(), mHeights.end());
+            const HeightfieldSurface surface {mHeights.data(), static_cast<std::size_t>(heightfieldSize),
+                                              *minHeight, *maxHeight};
+            mRecastMeshManager.addHeightfield(cellPosition, cellSize, surface);
+            mRecastMeshManager.addWater(cellPosition, cellSize, -200);
+
+            std::minstd_rand random;
+            std::uniform_real_distribution<float> position(0, static_cast<float>(cellSize));
+            std::uniform_real_distribution<float> size(16, 256);
+            std::uniform_real_distribution<float> angle(0, 2 * osg::PI);
+            mBoxes.reserve(boxesPerCell);
+            for (std::size_t i = 0; i < boxesPerCell; ++i)
+            {
+                const btVector3 halfExtents(size(random), size(random), size(random));
+                const float x = position(random);
+                const float y = position(random);
+                const float z = getGroundHeight(x, y) + halfExtents.z() / 2;
+                const float rotation = angle(random);
+                mBoxes.push_back(std::make_unique<btBoxShape>(halfExtents));
+                const btTransform transform(btQuaternion(btVector3(0, 0, 1), rotation), btVector3(x, y, z));
+                const ObjectTransform objectTransform {ESM::Position {{x, y, z}, {0, 0, rotation}}, 1.0f};
+                mRecastMeshManager.addObject(ObjectId(mBoxes.back().get()),
+                    CollisionShape(mInstance, *mBoxes.back(), objectTransform), transform, AreaType_ground,
+                    [] (const TilePosition&) {});
+            }
+
+            mRecastMeshManager.forEachTile([&] (const TilePosition& tilePosition, const auto&)
+            {
+                mTilesPositions.push_back(tilePosition);
+            });
+        }
+
+        TileCachedRecastMeshManager& getRecastMeshManager() { return mRecastMeshManager; }
+
+        const std::vector<TilePosition>& getTilesPositions() const { return mTilesPositions; }
+
+    private:
+        TileCachedRecastMeshManager mRecastMeshManager;
+        osg::ref_ptr<const Resource::BulletShapeInstance> mInstance;
+        std::vector<float> mHeights;
+        std::vector<std::unique_ptr<btBoxShape>> mBoxes;
+        std::vector<TilePosition> mTilesPositions;
+    };
+
+    /// Stores generated tiles into the database the same way navmeshtool does
+    struct NavMeshDbConsumer final : NavMeshTileConsumer
+    {
+        NavMeshDb& mDb;
+        TileId mNextTileId {1};
+        std::size_t mInserted = 0;
+
+        explicit NavMeshDbConsumer(NavMeshDb& db) : mDb(db) {}
+
+        std::int64_t resolveMeshSource(const MeshSource& /*source*/) override { return 0; }
+
+        std::optional<NavMeshTileInfo> find(const std::string& /*worldspace*/, const TilePosition& /*tilePosition*/,
+            const std::vector<std::byte>& /*input*/) override
+        {
+            return {};
+        }
+
+        void ignore() override {}
+
+        void insert(const std::string& worldspace, const TilePosition& tilePosition, std::int64_t version,
+            const std::vector<std::byte>& input, PreparedNavMeshData& data) override
+        {
+            data.mUserId = static_cast<unsigned>(mNextTileId);
+            mDb.insertTile(mNextTileId, worldspace, tilePosition, TileVersion {version}, input, serialize(data));
+            ++mNextTileId.t;
+            ++mInserted;
+        }
+
+        void update(std::int64_t /*tileId*/, std::int64_t /*version*/, PreparedNavMeshData& /*data*/) override {}
+    };
+
+    /// Ignores generated tiles to measure only generation
+    struct NullConsumer final : NavMeshTileConsumer
+    {
+        std::int64_t resolveMeshSource(const MeshSource& /*source*/) override { return 0; }
+
+        std::optional<NavMeshTileInfo> find(const std::string& /*worldspace*/, const TilePosition& /*tilePosition*/,
+            const std::vector<std::byte>& /*input*/) override
+        {
+            return {};
+        }
+
+        void ignore() override {}
+
+        void insert(const std::string& /*worldspace*/, const TilePosition& /*tilePosition*/, std::int64_t /*version*/,
+            const std::vector<std::byte>& /*input*/, PreparedNavMeshData& data) override
+        {
+            benchmark::DoNotOptimize(data);
+        }
+
+        void update(std::int64_t /*tileId*/, std::int64_t /*version*/, PreparedNavMeshData& data) override
+        {
+            benchmark::DoNotOptimize(data);
+        }
+    };
+
+    template <class Function>
+    void forEachDbTile(NavMeshDb& db, Function&& function)
+    {
+        constexpr std::size_t tilesPerRequest = 1000;
+        TileId lastTileId {0};
+        while (true)
+        {
+            const std::vector<DbTile> tiles = db.getTiles(lastTileId, tilesPerRequest);
+            if (tiles.empty())
+                break;
+            lastTileId = tiles.back().mTileId;
+            for (const DbTile& tile : tiles)
+                function(tile);
+        }
+    }
+
+    NavMeshPtr loadNavMesh(NavMeshDb& db, const Settings& settings)
+    {
+        NavMeshPtr navMesh = makeEmptyNavMesh(settings);
+        forEachDbTile(db, [&] (const DbTile& tile)
+        {
+            PreparedNavMeshData prepared;
+            if (!deserialize(tile.mData, prepared))
+                throw std::runtime_error("Failed to deserialize navmesh tile");
+            NavMeshData data = makeNavMeshTileData(prepared, {}, agentHalfExtents, tile.mTilePosition,
+                                                   settings.mRecast);
+            if (data.mValue == nullptr)
+                return;
+            if (!dtStatusSucceed(navMesh->addTile(data.mValue.get(), data.mSize, DT_TILE_FREE_DATA, 0, nullptr)))
+                throw std::runtime_error("Failed to add navmesh tile");
+            data.mValue.release();
+        });
+        return navMesh;
+    }
+
+    /// Scene is generated once and its tiles are serialized into an in-memory database. Queries run over a navmesh
+    /// loaded back from that database, so no game data is required.
+    struct World
+    {
+        Settings mSettings = makeSettings();
+        Scene mScene {mSettings.mRecast};
+        NavMeshDb mDb {":memory:"};
+        std::vector<DbTile> mTiles;
+        NavMeshPtr mNavMesh;
+        std::vector<osg::Vec3f> mPoints;
+
+        World()
+        {
+            const auto consumer = std::make_shared<NavMeshDbConsumer>(mDb);
+            for (const TilePosition& tilePosition : mScene.getTilesPositions())
+                GenerateNavMeshTile(worldspace, tilePosition, RecastMeshProvider(mScene.getRecastMeshManager()),
+                                    agentHalfExtents, mSettings, consumer).doWork();
+            if (consumer->mInserted == 0)
+                throw std::runtime_error("No navmesh tiles are generated");
+
+            forEachDbTile(mDb, [&] (const DbTile& tile) { mTiles.push_back(tile); });
+            mNavMesh = loadNavMesh(mDb, mSettings);
+
+            std::minstd_rand random;
+            std::uniform_real_distribution<float> position(0, static_cast<float>(cellSize));
+            mPoints.reserve(queryPoints);
+            for (std::size_t i = 0; i < queryPoints; ++i)
+            {
+                const float x = position(random);
+                const float y = position(random);
+                mPoints.emplace_back(x, y, getGroundHeight(x, y));
+            }
+        }
+    };
+
+    World& getWorld()
+    {
+        static World world;
+        return world;
+    }
+
+    void buildRecastMesh(benchmark::State& state)
+    {
+        World& world = getWorld();
+        const std::vector<TilePosition>& tiles = world.mScene.getTilesPositions();
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const auto recastMesh = world.mScene.getRecastMeshManager().getNewMesh(worldspace, tiles[n++ % tiles.size()]);
+            benchmark::DoNotOptimize(recastMesh);
+        }
+    }
+
+    void generateNavMeshTile(benchmark::State& state)
+    {
+        World& world = getWorld();
+        const std::vector<TilePosition>& tiles = world.mScene.getTilesPositions();
+        const auto consumer = std::make_shared<NullConsumer>();
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            GenerateNavMeshTile(worldspace, tiles[n++ % tiles.size()],
+                RecastMeshProvider(world.mScene.getRecastMeshManager()), agentHalfExtents, world.mSettings,
+                consumer).doWork();
+        }
+    }
+
+    void makeTileData(benchmark::State& state)
+    {
+        World& world = getWorld();
+        std::vector<PreparedNavMeshData> prepared(world.mTiles.size());
+        for (std::size_t i = 0; i < world.mTiles.size(); ++i)
+            deserialize(world.mTiles[i].mData, prepared[i]);
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const std::size_t i = n++ % prepared.size();
+            const NavMeshData data = DetourNavigator::makeNavMeshTileData(prepared[i], {}, agentHalfExtents,
+                world.mTiles[i].mTilePosition, world.mSettings.mRecast);
+            benchmark::DoNotOptimize(data);
+        }
+    }
+
+    void loadNavMeshFromDb(benchmark::State& state)
+    {
+        World& world = getWorld();
+
+        for (auto _ : state)
+        {
+            const NavMeshPtr navMesh = loadNavMesh(world.mDb, world.mSettings);
+            benchmark::DoNotOptimize(navMesh);
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(world.mTiles.size()));
+    }
+
+    void findSmoothPathAtDistance(benchmark::State& state)
+    {
+        World& world = getWorld();
+        const RecastSettings& recast = world.mSettings.mRecast;
+        const float distance = static_cast<float>(state.range(0));
+        std::vector<std::pair<osg::Vec3f, osg::Vec3f>> queries;
+        for (const osg::Vec3f& start : world.mPoints)
+            for (const osg::Vec3f& end : world.mPoints)
+                if (queries.size() < queryPoints && std::abs((end - start).length() - distance) < distance / 4)
+                    queries.emplace_back(start, end);
+        if (queries.empty())
+        {
+            state.SkipWithError("No points at given distance");
+            return;
+        }
+        std::vector<osg::Vec3f> path;
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const auto& [start, end] = queries[n++ % queries.size()];
+            path.clear();
+            auto out = std::back_inserter(path);
+            const Status status = DetourNavigator::findSmoothPath(*world.mNavMesh,
+                toNavMeshCoordinates(recast, agentHalfExtents), toNavMeshCoordinates(recast, stepSize),
+                toNavMeshCoordinates(recast, start), toNavMeshCoordinates(recast, end), Flag_walk | Flag_swim,
+                AreaCosts {}, world.mSettings, 0, out);
+            benchmark::DoNotOptimize(status);
+            benchmark::DoNotOptimize(path);
+        }
+    }
+
+    void findRandomPointAroundCircleWithRadius(benchmark::State& state)
+    {
+        World& world = getWorld();
+        const RecastSettings& recast = world.mSettings.mRecast;
+        const float maxRadius = toNavMeshCoordinates(recast, static_cast<float>(state.range(0)));
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const auto result = DetourNavigator::findRandomPointAroundCircle(*world.mNavMesh,
+                toNavMeshCoordinates(recast, agentHalfExtents),
+                toNavMeshCoordinates(recast, world.mPoints[n++ % world.mPoints.size()]), maxRadius,
+                Flag_walk | Flag_swim, world.mSettings.mDetour);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void raycastBetweenPoints(benchmark::State& state)
+    {
+        World& world = getWorld();
+        const RecastSettings& recast = world.mSettings.mRecast;
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const osg::Vec3f& start = world.mPoints[n % world.mPoints.size()];
+            const osg::Vec3f& end = world.mPoints[(n + 1) % world.mPoints.size()];
+            ++n;
+            const auto result = DetourNavigator::raycast(*world.mNavMesh, toNavMeshCoordinates(recast, agentHalfExtents),
+                toNavMeshCoordinates(recast, start), toNavMeshCoordinates(recast, end), Flag_walk | Flag_swim,
+                world.mSettings.mDetour);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void getTileDataFromDb(benchmark::State& state)
+    {
+        World& world = getWorld();
+        std::size_t n = 0;
+
+        for (auto _ : state)
+        {
+            const DbTile& tile = world.mTiles[n++ % world.mTiles.size()];
+            const auto result = world.mDb.getTileData(tile.mWorldspace, tile.mTilePosition, tile.mInput);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void insertTileIntoDb(benchmark::State& state)
+    {
+        World& world = getWorld();
+        NavMeshDb db(":memory:");
+        TileId tileId {1};
+
+        for (auto _ : state)
+        {
+            const DbTile& tile = world.mTiles[static_cast<std::size_t>(tileId.t) % world.mTiles.size()];
+            // Position makes every inserted tile unique
+            const TilePosition tilePosition(static_cast<int>(tileId.t), 0);
+            db.insertTile(tileId, tile.mWorldspace, tilePosition, tile.mVersion, tile.mInput, tile.mData);
+            ++tileId.t;
+        }
+    }
+} // namespace
+
+BENCHMARK(buildRecastMesh);
+BENCHMARK(generateNavMeshTile);
+BENCHMARK(makeTileData);
+BENCHMARK(loadNavMeshFromDb);
+BENCHMARK(findSmoothPathAtDistance)->Arg(1000)->Arg(3000)->Arg(6000);
+BENCHMARK(findRandomPointAroundCircleWithRadius)->Arg(500)->Arg(2000);
+BENCHMARK(raycastBetweenPoints);
+BENCHMARK(getTileDataFromDb);
+BENCHMARK(insertTileIntoDb);
+
+BENCHMARK_MAIN();
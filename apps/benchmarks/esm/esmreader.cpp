@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+
+#include <components/esm/defs.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/esm3/loadbook.hpp>
+#include <components/esm3/loadmisc.hpp>
+#include <components/esm3/loadnpc.hpp>
+#include <components/esm3/loadstat.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // The content file to measure is given by this environment variable, the benchmark is skipped without it
+    constexpr char contentFileVariable[] = "OPENMW_BENCHMARK_CONTENT_FILE";
+    constexpr char missingPathError[] = "Set OPENMW_BENCHMARK_CONTENT_FILE to the path of a content file";
+
+    std::string makeId(const char* prefix, int index)
+    {
+        return prefix + std::to_string(index);
+    }
+
+    template <class T>
+    void save(ESM::ESMWriter& writer, const T& record)
+    {
+        writer.startRecord(T::sRecordId);
+        record.save(writer);
+        writer.endRecord(T::sRecordId);
+    }
+
+    // Equal numbers of statics, misc items, books and NPCs, from small to large records
+    std::string makeContentFile(int count)
+    {
+        std::ostringstream stream;
+        ESM::ESMWriter writer;
+        writer.setFormat(0);
+        writer.setRecordCount(count * 4);
+        writer.save(stream);
+        for (int i = 0; i < count; ++i)
+        {
+            ESM::Static stat;
+            stat.blank();
+            stat.mId = makeId("static_", i);
+            stat.mModel = "x\\ex_common_house_" + std::to_string(i) + ".nif";
+            save(writer, stat);
+
+            ESM::Miscellaneous misc;
+            misc.blank();
+            misc.mId = makeId("misc_", i);
+            misc.mName = "Misc Item";
+            misc.mModel = "m\\misc_" + std::to_string(i) + ".nif";
+            misc.mIcon = "m\\misc_" + std::to_string(i) + ".dds";
+            save(writer, misc);
+
+            ESM::Book book;
+            book.blank();
+            book.mId = makeId("book_", i);
+            book.mName = "Book";
+            book.mModel = "m\\text_octavo_" + std::to_string(i) + ".nif";
+            book.mText = std::string(2048, 'a');
+            save(writer, book);
+
+            ESM::NPC npc;
+            npc.blank();
+            npc.mId = makeId("npc_", i);
+            npc.mName = "Someone";
+            npc.mRace = "dark elf";
+            npc.mClass = "guard";
+            npc.mHair = "b_n_dark elf_m_hair_01";
+            npc.mHead = "b_n_dark elf_m_head_01";
+            for (int j = 0; j < 8; ++j)
+            {
+                ESM::ContItem item;
+                item.mCount = 1;
+                item.mItem = makeId("misc_", j);
+                npc.mInventory.mList.push_back(item);
+            }
+            save(writer, npc);
+        }
+        writer.close();
+        return stream.str();
+    }
+
+    template <class T>
+    void load(ESM::ESMReader& reader)
+    {
+        T record;
+        bool isDeleted = false;
+        record.load(reader, isDeleted);
+        benchmark::DoNotOptimize(record);
+    }
+
+    // Parses the record types made by makeContentFile, other records are skipped
+    std::size_t loadRecords(ESM::ESMReader& reader)
+    {
+        std::size_t records = 0;
+        while (reader.hasMoreRecs())
+        {
+            const ESM::NAME name = reader.getRecName();
+            reader.getRecHeader();
+            switch (name.toInt())
+            {
+                case ESM::REC_STAT: load<ESM::Static>(reader); break;
+                case ESM::REC_MISC: load<ESM::Miscellaneous>(reader); break;
+                case ESM::REC_BOOK: load<ESM::Book>(reader); break;
+                case ESM::REC_NPC_: load<ESM::NPC>(reader); break;
+                default: reader.skipRecord(); break;
+            }
+            ++records;
+        }
+        return records;
+    }
+
+    void loadSyntheticRecords(benchmark::State& state)
+    {
+        const std::string content = makeContentFile(static_cast<int>(state.range(0)));
+        std::size_t records = 0;
+        for (auto _ : state)
+        {
+            ESM::ESMReader reader;
+            reader.open(std::make_shared<std::istringstream>(content), "synthetic.esp");
+            records = loadRecords(reader);
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(content.size()));
+        state.counters["records"] = static_cast<double>(records);
+    }
+
+    void loadContentFile(benchmark::State& state)
+    {
+        const char* const path = std::getenv(contentFileVariable);
+        if (path == nullptr || *path == '\0')
+        {
+            state.SkipWithError(missingPathError);
+            return;
+        }
+        std::size_t records = 0;
+        for (auto _ : state)
+        {
+            ESM::ESMReader reader;
+            reader.open(path);
+            records = loadRecords(reader);
+        }
+        state.counters["records"] = static_cast<double>(records);
+    }
+}
+
+BENCHMARK(loadSyntheticRecords)->Arg(256)->Arg(4096);
+BENCHMARK(loadContentFile)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,230 @@
+#include <benchmark/benchmark.h>
+
+#include <components/esm/defs.hpp>
+#include <components/esm3/cellstate.hpp>
+#include <components/esm3/compressedsavedgame.hpp>
+#include <components/esm3/controlsstate.hpp>
+#include <components/esm3/dialoguestate.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/esm3/globalmap.hpp>
+#include <components/esm3/journalentry.hpp>
+#include <components/esm3/queststate.hpp>
+#include <components/esm3/savedgame.hpp>
+#include <components/esm3/weatherstate.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    // The saved game to measure is given by this environment variable, the benchmarks are skipped without it
+    constexpr char savedGameVariable[] = "OPENMW_BENCHMARK_SAVED_GAME";
+    constexpr char missingPathError[] = "Set OPENMW_BENCHMARK_SAVED_GAME to the path of a saved game";
+
+    struct Record
+    {
+        ESM::NAME mName;
+        std::uint32_t mFlags;
+        std::vector<char> mData;
+    };
+
+    struct SavedGame
+    {
+        ESM::Header mHeader;
+        std::vector<Record> mRecords;
+    };
+
+    std::optional<std::string> getSavedGamePath()
+    {
+        const char* const path = std::getenv(savedGameVariable);
+        if (path == nullptr || *path == '\0')
+            return std::nullopt;
+        return std::string(path);
+    }
+
+    double getPeakMemory()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#if defined(__APPLE__)
+        return static_cast<double>(usage.ru_maxrss);
+#else
+        return static_cast<double>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    SavedGame readSavedGame(const std::string& path, ESM::ESMReader& reader)
+    {
+        reader.open(ESM::openSavedGame(path), path);
+        SavedGame result;
+        result.mHeader = reader.getHeader();
+        while (reader.hasMoreRecs())
+        {
+            Record& record = result.mRecords.emplace_back();
+            record.mName = reader.getRecName();
+            reader.getRecHeader(record.mFlags);
+            reader.getRecordData(record.mData);
+        }
+        return result;
+    }
+
+    void skipSubRecords(ESM::ESMReader& reader)
+    {
+        while (reader.hasMoreSubs())
+        {
+            reader.getSubName();
+            reader.skipHSub();
+        }
+    }
+
+    template <class T>
+    void load(ESM::ESMReader& reader)
+    {
+        T value;
+        value.load(reader);
+        benchmark::DoNotOptimize(value);
+    }
+
+    // Parses the records that can be read without the game data, the other ones are only split into their
+    // sub-records. References in cell states need the content files, so only the cell state itself is parsed.
+    void parseRecord(ESM::ESMReader& reader, ESM::NAME name)
+    {
+        switch (name.toInt())
+        {
+            case ESM::REC_SAVE: load<ESM::SavedGame>(reader); break;
+            case ESM::REC_JOUR: load<ESM::JournalEntry>(reader); break;
+            case ESM::REC_QUES: load<ESM::QuestState>(reader); break;
+            case ESM::REC_DIAS: load<ESM::DialogueState>(reader); break;
+            case ESM::REC_GMAP: load<ESM::GlobalMap>(reader); break;
+            case ESM::REC_WTHR: load<ESM::WeatherState>(reader); break;
+            case ESM::REC_ACTC: load<ESM::ControlsState>(reader); break;
+            case ESM::REC_CSTA: load<ESM::CellState>(reader); break;
+            default: break;
+        }
+        skipSubRecords(reader);
+    }
+
+    void loadSavedGame(benchmark::State& state)
+    {
+        const std::optional<std::string> path = getSavedGamePath();
+        if (!path.has_value())
+        {
+            state.SkipWithError(missingPathError);
+            return;
+        }
+
+        std::map<std::string, double> parseTimes;
+        std::size_t records = 0;
+
+        for (auto _ : state)
+        {
+            ESM::ESMReader reader;
+            SavedGame savedGame = readSavedGame(*path, reader);
+            records = savedGame.mRecords.size();
+
+            for (Record& record : savedGame.mRecords)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                ESM::ESMReader recordReader;
+                recordReader.openRecord(std::move(record.mData), reader);
+                parseRecord(recordReader, record.mName);
+                const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                parseTimes[record.mName.toString()] += duration.count();
+            }
+        }
+
+        for (const auto& [name, time] : parseTimes)
+            state.counters[name] = benchmark::Counter(time, benchmark::Counter::kAvgIterations);
+        state.counters["records"] = static_cast<double>(records);
+        state.counters["peak_memory"] = benchmark::Counter(getPeakMemory(), benchmark::Counter::kDefaults,
+            benchmark::Counter::OneK::kIs1024);
+    }
+
+    void saveSavedGame(benchmark::State& state, bool compressed)
+    {
+        const std::optional<std::string> path = getSavedGamePath();
+        if (!path.has_value())
+        {
+            state.SkipWithError(missingPathError);
+            return;
+        }
+
+        ESM::ESMReader reader;
+        const SavedGame savedGame = readSavedGame(*path, reader);
+        std::size_t written = 0;
+
+        for (auto _ : state)
+        {
+            std::stringstream stream;
+            ESM::ESMWriter writer;
+            for (const ESM::Header::MasterData& master : savedGame.mHeader.mMaster)
+                writer.addMaster(master.name, master.size);
+            writer.setFormat(savedGame.mHeader.mFormat);
+            writer.setVersion(savedGame.mHeader.mData.version);
+            writer.setType(savedGame.mHeader.mData.type);
+            writer.setAuthor(savedGame.mHeader.mData.author);
+            writer.setDescription(savedGame.mHeader.mData.desc);
+            writer.setRecordCount(static_cast<int>(savedGame.mRecords.size()));
+            writer.save(stream);
+
+            // Saved games start with the REC_SAVE record, the compressed container keeps it in a frame of its own
+            std::size_t headerSize = 0;
+            for (const Record& record : savedGame.mRecords)
+            {
+                const std::string name = record.mName.toString();
+                writer.startRecord(name, record.mFlags);
+                writer.write(record.mData.data(), record.mData.size());
+                writer.endRecord(name);
+                if (headerSize == 0 && record.mName == ESM::REC_SAVE)
+                    headerSize = static_cast<std::size_t>(stream.tellp());
+            }
+            writer.close();
+
+            if (compressed)
+            {
+                std::ostringstream compressedStream;
+                ESM::writeCompressedSavedGame(compressedStream, stream.str(), headerSize);
+                written = static_cast<std::size_t>(compressedStream.tellp());
+            }
+            else
+                written = static_cast<std::size_t>(stream.tellp());
+            benchmark::DoNotOptimize(written);
+        }
+
+        state.counters["bytes"] = static_cast<double>(written);
+        state.counters["peak_memory"] = benchmark::Counter(getPeakMemory(), benchmark::Counter::kDefaults,
+            benchmark::Counter::OneK::kIs1024);
+    }
+
+    void saveSavedGameUncompressed(benchmark::State& state)
+    {
+        saveSavedGame(state, false);
+    }
+
+    void saveSavedGameCompressed(benchmark::State& state)
+    {
+        saveSavedGame(state, true);
+    }
+} // namespace
+
+BENCHMARK(loadSavedGame)->Unit(benchmark::kMillisecond);
+BENCHMARK(saveSavedGameUncompressed)->Unit(benchmark::kMillisecond);
+BENCHMARK(saveSavedGameCompressed)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
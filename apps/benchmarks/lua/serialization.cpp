@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <components/lua/serialization.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace
+{
+    // Shaped like the saved state of a script: a table of records, each with a few numbers, strings and flags
+    sol::table makeTable(sol::state& lua, std::int64_t count)
+    {
+        sol::table result(lua, sol::create);
+        for (std::int64_t i = 0; i < count; ++i)
+        {
+            sol::table record(lua, sol::create);
+            record["id"] = "record_" + std::to_string(i);
+            record["count"] = i;
+            record["weight"] = 0.5 * static_cast<double>(i);
+            record["active"] = i % 2 == 0;
+            sol::table position(lua, sol::create);
+            position[1] = 1.0 * static_cast<double>(i);
+            position[2] = 2.0 * static_cast<double>(i);
+            position[3] = 3.0 * static_cast<double>(i);
+            record["position"] = position;
+            result[i + 1] = record;
+        }
+        return result;
+    }
+
+    void serialize(benchmark::State& state)
+    {
+        sol::state lua;
+        const sol::table table = makeTable(lua, state.range(0));
+        std::size_t size = 0;
+        for (auto _ : state)
+        {
+            const LuaUtil::BinaryData data = LuaUtil::serialize(table);
+            size = data.size();
+            benchmark::DoNotOptimize(data);
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    }
+
+    void deserialize(benchmark::State& state)
+    {
+        sol::state lua;
+        const LuaUtil::BinaryData data = LuaUtil::serialize(makeTable(lua, state.range(0)));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(LuaUtil::deserialize(lua, data));
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+    }
+
+    void deserializeReadOnly(benchmark::State& state)
+    {
+        sol::state lua;
+        const LuaUtil::BinaryData data = LuaUtil::serialize(makeTable(lua, state.range(0)));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(LuaUtil::deserialize(lua, data, nullptr, true));
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+    }
+
+    void roundTrip(benchmark::State& state)
+    {
+        sol::state lua;
+        const sol::table table = makeTable(lua, state.range(0));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(LuaUtil::deserialize(lua, LuaUtil::serialize(table)));
+    }
+}
+
+BENCHMARK(serialize)->Arg(1)->Arg(64)->Arg(4096);
+BENCHMARK(deserialize)->Arg(1)->Arg(64)->Arg(4096);
+BENCHMARK(deserializeReadOnly)->Arg(1)->Arg(64)->Arg(4096);
+BENCHMARK(roundTrip)->Arg(1)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
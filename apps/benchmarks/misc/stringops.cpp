@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <components/misc/stringops.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // Typical lengths of record ids and of resource paths
+    constexpr std::size_t idLength = 16;
+    constexpr std::size_t pathLength = 48;
+
+    std::string generateString(std::size_t length, std::minstd_rand& random)
+    {
+        constexpr char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_\\ ";
+        std::uniform_int_distribution<std::size_t> distribution(0, sizeof(characters) - 2);
+        std::string result(length, '\0');
+        std::generate(result.begin(), result.end(), [&] { return characters[distribution(random)]; });
+        return result;
+    }
+
+    std::vector<std::string> generateStrings(std::size_t count, std::size_t length)
+    {
+        std::minstd_rand random;
+        std::vector<std::string> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            result.push_back(generateString(length, random));
+        return result;
+    }
+
+    std::string swapCase(std::string value)
+    {
+        for (char& ch : value)
+        {
+            if (ch >= 'a' && ch <= 'z')
+                ch -= 'a' - 'A';
+            else if (ch >= 'A' && ch <= 'Z')
+                ch += 'a' - 'A';
+        }
+        return value;
+    }
+
+    void ciHash(benchmark::State& state)
+    {
+        const std::vector<std::string> strings = generateStrings(1024, static_cast<std::size_t>(state.range(0)));
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(Misc::StringUtils::CiHash {}(strings[i]));
+            i = (i + 1) % strings.size();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void ciEqual(benchmark::State& state)
+    {
+        const std::vector<std::string> strings = generateStrings(1024, static_cast<std::size_t>(state.range(0)));
+        std::vector<std::string> swapped;
+        std::transform(strings.begin(), strings.end(), std::back_inserter(swapped), swapCase);
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(Misc::StringUtils::ciEqual(strings[i], swapped[i]));
+            i = (i + 1) % strings.size();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void ciLess(benchmark::State& state)
+    {
+        const std::vector<std::string> strings = generateStrings(1024, static_cast<std::size_t>(state.range(0)));
+        std::vector<std::string> swapped;
+        std::transform(strings.begin(), strings.end(), std::back_inserter(swapped), swapCase);
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(Misc::StringUtils::ciLess(strings[i], swapped[i]));
+            i = (i + 1) % strings.size();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void lowerCase(benchmark::State& state)
+    {
+        const std::vector<std::string> strings = generateStrings(1024, static_cast<std::size_t>(state.range(0)));
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(Misc::StringUtils::lowerCase(strings[i]));
+            i = (i + 1) % strings.size();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    // Same container and functors as MWWorld::Store<T>::search, looked up with ids in a different case
+    void storeSearch(benchmark::State& state)
+    {
+        const std::vector<std::string> ids = generateStrings(static_cast<std::size_t>(state.range(0)), idLength);
+        std::unordered_map<std::string, int, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> store;
+        for (std::size_t i = 0; i < ids.size(); ++i)
+            store.emplace(ids[i], static_cast<int>(i));
+        std::vector<std::string> queries;
+        std::transform(ids.begin(), ids.end(), std::back_inserter(queries), swapCase);
+        std::shuffle(queries.begin(), queries.end(), std::minstd_rand());
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(store.find(queries[i]));
+            i = (i + 1) % queries.size();
+        }
+    }
+
+    void normalizeFilename(benchmark::State& state)
+    {
+        const VFS::Manager manager(state.range(0) != 0);
+        const std::vector<std::string> paths = generateStrings(1024, pathLength);
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(manager.normalizeFilename(paths[i]));
+            i = (i + 1) % paths.size();
+        }
+        state.SetBytesProcessed(state.iterations() * pathLength);
+    }
+}
+
+BENCHMARK(ciHash)->Arg(8)->Arg(idLength)->Arg(pathLength)->Arg(256);
+BENCHMARK(ciEqual)->Arg(8)->Arg(idLength)->Arg(pathLength)->Arg(256);
+BENCHMARK(ciLess)->Arg(8)->Arg(idLength)->Arg(pathLength)->Arg(256);
+BENCHMARK(lowerCase)->Arg(8)->Arg(idLength)->Arg(pathLength)->Arg(256);
+BENCHMARK(storeSearch)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK(normalizeFilename)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
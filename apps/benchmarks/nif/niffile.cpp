@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include <components/nif/niffile.hpp>
+#include <components/vfs/filesystemarchive.hpp>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // The directory with the models to measure is given by this environment variable, the benchmark is skipped without it
+    constexpr char dataVariable[] = "OPENMW_BENCHMARK_DATA";
+    constexpr char missingPathError[] = "Set OPENMW_BENCHMARK_DATA to the path of a data directory with NIF files";
+
+    char normalize(char c)
+    {
+        if (c == '\\')
+            return '/';
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    bool isNif(const std::string& name)
+    {
+        return name.size() > 4 && name.compare(name.size() - 4, 4, ".nif") == 0;
+    }
+
+    // Contents of all NIF files of the data directory by their normalized names
+    std::optional<std::vector<std::pair<std::string, std::string>>> readNifFiles()
+    {
+        const char* const path = std::getenv(dataVariable);
+        if (path == nullptr || *path == '\0')
+            return std::nullopt;
+        VFS::FileSystemArchive archive(path);
+        std::map<std::string, VFS::File*> files;
+        archive.listResources(files, &normalize);
+        std::vector<std::pair<std::string, std::string>> result;
+        for (const auto& [name, file] : files)
+        {
+            if (!isNif(name))
+                continue;
+            const Files::IStreamPtr stream = file->open();
+            result.emplace_back(name, std::string(std::istreambuf_iterator<char>(*stream), {}));
+        }
+        return result;
+    }
+
+    void parseNifFiles(benchmark::State& state)
+    {
+        const std::optional<std::vector<std::pair<std::string, std::string>>> files = readNifFiles();
+        if (!files.has_value())
+        {
+            state.SkipWithError(missingPathError);
+            return;
+        }
+
+        std::size_t bytes = 0;
+        for (const auto& [name, data] : *files)
+            bytes += data.size();
+
+        std::size_t records = 0;
+        std::size_t failed = 0;
+        for (auto _ : state)
+        {
+            records = 0;
+            failed = 0;
+            for (const auto& [name, data] : *files)
+            {
+                try
+                {
+                    const Nif::NIFFile file(std::string_view(data), name);
+                    records += file.numRecords();
+                }
+                catch (const std::exception&)
+                {
+                    ++failed;
+                }
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+        state.counters["files"] = static_cast<double>(files->size());
+        state.counters["records"] = static_cast<double>(records);
+        state.counters["failed"] = static_cast<double>(failed);
+    }
+}
+
+BENCHMARK(parseNifFiles)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,301 @@
+#include <benchmark/benchmark.h>
+
+#include "apps/openmw/mwphysics/cellgridbroadphase.hpp"
+#include "apps/openmw/mwphysics/collisiontype.hpp"
+
+#include <components/misc/constants.hpp>
+#include <components/misc/hash.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+
+#include <osg/Math>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace MWPhysics;
+
+    constexpr int cellsPerSide = 3;
+    constexpr int heightfieldSize = 65;
+    constexpr float cellSize = static_cast<float>(Constants::CellSizeInUnits);
+    constexpr std::size_t staticsPerCell = 200;
+    constexpr std::size_t recordedFrames = 600;
+    constexpr float frameTime = 1.f / 60.f;
+    constexpr int maxIterations = 4;
+    // Keep actors above the ground so horizontal sweeps don't start in contact with it
+    constexpr float groundOffset = 2;
+    const btVector3 actorHalfExtents(30, 30, 64);
+
+    struct ClosestNotMeConvexResultCallback : btCollisionWorld::ClosestConvexResultCallback
+    {
+        const btCollisionObject* mMe;
+
+        ClosestNotMeConvexResultCallback(const btCollisionObject* me, const btVector3& from, const btVector3& to)
+            : btCollisionWorld::ClosestConvexResultCallback(from, to)
+            , mMe(me)
+        {
+        }
+
+        btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+        {
+            if (convexResult.m_hitCollisionObject == mMe)
+                return 1;
+            return btCollisionWorld::ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
+        }
+    };
+
+    struct StageTimes
+    {
+        double mSweep = 0;
+        double mTraceDown = 0;
+        double mUpdateAabb = 0;
+    };
+
+    /// Terrain, statics and actors generated from a fixed seed; every replay starts from the same state
+    class Scene
+    {
+    public:
+        Scene(std::unique_ptr<btBroadphaseInterface>&& broadphase, std::size_t actors)
+            : mCollisionConfiguration(std::make_unique<btDefaultCollisionConfiguration>())
+            , mDispatcher(std::make_unique<btCollisionDispatcher>(mCollisionConfiguration.get()))
+            , mBroadphase(std::move(broadphase))
+            , mCollisionWorld(std::make_unique<btCollisionWorld>(mDispatcher.get(), mBroadphase.get(), mCollisionConfiguration.get()))
+            , mActorShape(std::make_unique<btBoxShape>(actorHalfExtents))
+        {
+            mCollisionWorld->setForceUpdateAllAabbs(false);
+
+            std::minstd_rand random;
+            std::uniform_real_distribution<float> height(-64, 64);
+            std::uniform_real_distribution<float> position(0, cellSize);
+            std::uniform_real_distribution<float> extent(16, 256);
+
+            for (int x = 0; x < cellsPerSide; ++x)
+                for (int y = 0; y < cellsPerSide; ++y)
+                {
+                    auto& heights = mHeights.emplace_back(heightfieldSize * heightfieldSize);
+                    std::generate(heights.begin(), heights.end(), [&] { return height(random); });
+                    auto shape = std::make_unique<btHeightfieldTerrainShape>(heightfieldSize, heightfieldSize,
+                        heights.data(), 1, -64, 64, 2, PHY_FLOAT, false);
+                    shape->setLocalScaling(btVector3(cellSize / (heightfieldSize - 1), cellSize / (heightfieldSize - 1), 1));
+                    const btVector3 origin((x + 0.5f) * cellSize, (y + 0.5f) * cellSize, 0);
+                    addStatic(std::move(shape), origin, CollisionType_HeightMap);
+
+                    for (std::size_t i = 0; i < staticsPerCell; ++i)
+                    {
+                        const btVector3 halfExtents(extent(random), extent(random), extent(random));
+                        const btVector3 center(x * cellSize + position(random), y * cellSize + position(random), 0);
+                        addStatic(std::make_unique<btBoxShape>(halfExtents), center, CollisionType_World);
+                    }
+                }
+
+            const float worldSize = cellsPerSide * cellSize;
+            std::uniform_real_distribution<float> start(0, worldSize);
+            for (std::size_t i = 0; i < actors; ++i)
+            {
+                auto object = std::make_unique<btCollisionObject>();
+                object->setCollisionShape(mActorShape.get());
+                mCollisionWorld->addCollisionObject(object.get(), CollisionType_Actor,
+                    CollisionType_World | CollisionType_HeightMap | CollisionType_Actor);
+                mActors.push_back(std::move(object));
+                mStartPositions.emplace_back(start(random), start(random), 256);
+            }
+
+            // Stands for movement recorded from a session: actors walk in a direction for a while, then turn
+            std::uniform_real_distribution<float> angle(0, 2 * osg::PI);
+            std::uniform_int_distribution<std::size_t> duration(30, 240);
+            mMovements.resize(actors);
+            for (auto& movement : mMovements)
+            {
+                while (movement.size() < recordedFrames)
+                {
+                    const float direction = angle(random);
+                    const btVector3 velocity(std::cos(direction) * 150, std::sin(direction) * 150, 0);
+                    movement.insert(movement.end(), std::min(duration(random), recordedFrames - movement.size()), velocity);
+                }
+            }
+
+            reset();
+        }
+
+        ~Scene()
+        {
+            for (const auto& object : mActors)
+                mCollisionWorld->removeCollisionObject(object.get());
+            for (const auto& object : mStatics)
+                mCollisionWorld->removeCollisionObject(object.get());
+        }
+
+        void reset()
+        {
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                setPosition(*mActors[i], mStartPositions[i]);
+        }
+
+        void replayFrame(std::size_t frame, StageTimes& times)
+        {
+            using Clock = std::chrono::steady_clock;
+            std::vector<btVector3> positions;
+            positions.reserve(mActors.size());
+
+            auto start = Clock::now();
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                positions.push_back(move(*mActors[i], mMovements[i][frame] * frameTime));
+            auto end = Clock::now();
+            times.mSweep += std::chrono::duration<double>(end - start).count();
+
+            start = end;
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                traceDown(positions[i]);
+            end = Clock::now();
+            times.mTraceDown += std::chrono::duration<double>(end - start).count();
+
+            start = end;
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                setPosition(*mActors[i], positions[i]);
+            end = Clock::now();
+            times.mUpdateAabb += std::chrono::duration<double>(end - start).count();
+        }
+
+        std::size_t getStateHash() const
+        {
+            std::size_t result = 0;
+            for (const auto& object : mActors)
+            {
+                const btVector3& origin = object->getWorldTransform().getOrigin();
+                for (int i = 0; i < 3; ++i)
+                {
+                    std::uint32_t bits = 0;
+                    const float value = static_cast<float>(origin[i]);
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    Misc::hashCombine(result, bits);
+                }
+            }
+            return result;
+        }
+
+    private:
+        std::unique_ptr<btDefaultCollisionConfiguration> mCollisionConfiguration;
+        std::unique_ptr<btCollisionDispatcher> mDispatcher;
+        std::unique_ptr<btBroadphaseInterface> mBroadphase;
+        std::unique_ptr<btCollisionWorld> mCollisionWorld;
+        std::unique_ptr<btBoxShape> mActorShape;
+        std::vector<std::vector<float>> mHeights;
+        std::vector<std::unique_ptr<btCollisionShape>> mStaticShapes;
+        std::vector<std::unique_ptr<btCollisionObject>> mStatics;
+        std::vector<std::unique_ptr<btCollisionObject>> mActors;
+        std::vector<btVector3> mStartPositions;
+        std::vector<std::vector<btVector3>> mMovements;
+
+        void addStatic(std::unique_ptr<btCollisionShape>&& shape, const btVector3& origin, int collisionType)
+        {
+            auto object = std::make_unique<btCollisionObject>();
+            object->setCollisionShape(shape.get());
+            object->setWorldTransform(btTransform(btMatrix3x3::getIdentity(), origin));
+            mCollisionWorld->addCollisionObject(object.get(), collisionType, CollisionType_Actor);
+            mStaticShapes.push_back(std::move(shape));
+            mStatics.push_back(std::move(object));
+        }
+
+        void setPosition(btCollisionObject& object, const btVector3& position)
+        {
+            object.setWorldTransform(btTransform(btMatrix3x3::getIdentity(), position));
+            mCollisionWorld->updateSingleAabb(&object);
+        }
+
+        /// Slide along the hit surfaces like the movement solver does, without stepping up
+        btVector3 move(const btCollisionObject& object, btVector3 movement) const
+        {
+            btVector3 position = object.getWorldTransform().getOrigin();
+            for (int iteration = 0; iteration < maxIterations && movement.length2() > 1e-4f; ++iteration)
+            {
+                const btVector3 target = position + movement;
+                ClosestNotMeConvexResultCallback callback(&object, position, target);
+                callback.m_collisionFilterGroup = CollisionType_Actor;
+                callback.m_collisionFilterMask = CollisionType_World | CollisionType_HeightMap | CollisionType_Actor;
+                mCollisionWorld->convexSweepTest(mActorShape.get(), btTransform(btMatrix3x3::getIdentity(), position),
+                                                 btTransform(btMatrix3x3::getIdentity(), target), callback);
+                if (!callback.hasHit())
+                    return target;
+                position.setInterpolate3(position, target, callback.m_closestHitFraction);
+                const btVector3 remaining = movement * (1 - callback.m_closestHitFraction);
+                movement = remaining - callback.m_hitNormalWorld * remaining.dot(callback.m_hitNormalWorld);
+            }
+            return position;
+        }
+
+        void traceDown(btVector3& position) const
+        {
+            const btVector3 from = position;
+            const btVector3 to = position - btVector3(0, 0, 2 * actorHalfExtents.z() + 64);
+            btCollisionWorld::ClosestRayResultCallback callback(from, to);
+            callback.m_collisionFilterGroup = CollisionType_Actor;
+            callback.m_collisionFilterMask = CollisionType_World | CollisionType_HeightMap;
+            mCollisionWorld->rayTest(from, to, callback);
+            if (callback.hasHit())
+                position.setZ(callback.m_hitPointWorld.z() + actorHalfExtents.z() + groundOffset);
+        }
+    };
+
+    std::unique_ptr<btBroadphaseInterface> makeDbvtBroadphase()
+    {
+        return std::make_unique<btDbvtBroadphase>();
+    }
+
+    std::unique_ptr<btBroadphaseInterface> makeCellGridBroadphase()
+    {
+        return std::make_unique<CellGridBroadphase>(cellSize);
+    }
+
+    template <std::unique_ptr<btBroadphaseInterface> (*makeBroadphase)()>
+    void replayMovement(benchmark::State& state)
+    {
+        Scene scene(makeBroadphase(), static_cast<std::size_t>(state.range(0)));
+        StageTimes times;
+        std::optional<std::size_t> expectedHash;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            scene.reset();
+            state.ResumeTiming();
+
+            for (std::size_t frame = 0; frame < recordedFrames; ++frame)
+                scene.replayFrame(frame, times);
+
+            // Every replay has to give the same result, otherwise the timings can't be compared
+            const std::size_t hash = scene.getStateHash();
+            if (!expectedHash.has_value())
+                expectedHash = hash;
+            else if (*expectedHash != hash)
+            {
+                state.SkipWithError("Replay result differs from the first run");
+                break;
+            }
+        }
+
+        state.counters["sweep"] = benchmark::Counter(times.mSweep, benchmark::Counter::kAvgIterations);
+        state.counters["trace_down"] = benchmark::Counter(times.mTraceDown, benchmark::Counter::kAvgIterations);
+        state.counters["update_aabb"] = benchmark::Counter(times.mUpdateAabb, benchmark::Counter::kAvgIterations);
+    }
+
+    constexpr auto replayMovementDbvt = replayMovement<makeDbvtBroadphase>;
+    constexpr auto replayMovementCellGrid = replayMovement<makeCellGridBroadphase>;
+} // namespace
+
+BENCHMARK(replayMovementDbvt)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK(replayMovementCellGrid)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
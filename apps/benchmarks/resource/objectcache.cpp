@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <components/resource/objectcache.hpp>
+
+#include <osg/Image>
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Number of resources cached while a cell with its neighbours is loaded
+    constexpr std::size_t cacheSize = 4096;
+
+    std::string makeKey(std::size_t index)
+    {
+        return "meshes/x/ex_common_house_" + std::to_string(index) + ".nif";
+    }
+
+    // Shared by all threads of a benchmark, like the caches of the resource managers are shared by the preloading threads
+    Resource::ObjectCache& getCache()
+    {
+        static const osg::ref_ptr<Resource::ObjectCache> cache = [] {
+            osg::ref_ptr<Resource::ObjectCache> result = new Resource::ObjectCache;
+            for (std::size_t i = 0; i < cacheSize; ++i)
+                result->addEntryToObjectCache(makeKey(i), new osg::Image);
+            return result;
+        }();
+        return *cache;
+    }
+
+    // Each thread gets different keys to look up
+    std::vector<std::string> makeQueries()
+    {
+        static std::atomic<std::minstd_rand::result_type> seed {1};
+        std::minstd_rand random(seed++);
+        std::uniform_int_distribution<std::size_t> distribution(0, cacheSize - 1);
+        std::vector<std::string> result;
+        for (std::size_t i = 0; i < 1024; ++i)
+            result.push_back(makeKey(distribution(random)));
+        return result;
+    }
+
+    void getRefFromObjectCache(benchmark::State& state)
+    {
+        Resource::ObjectCache& cache = getCache();
+        const std::vector<std::string> queries = makeQueries();
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(cache.getRefFromObjectCache(queries[i]));
+            i = (i + 1) % queries.size();
+        }
+    }
+
+    // One in 16 accesses replaces the entry, as a load after a miss would
+    void getRefOrAddToObjectCache(benchmark::State& state)
+    {
+        Resource::ObjectCache& cache = getCache();
+        const std::vector<std::string> queries = makeQueries();
+        const osg::ref_ptr<osg::Image> image = new osg::Image;
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            if (i % 16 == 0)
+                cache.addEntryToObjectCache(queries[i], image);
+            else
+                benchmark::DoNotOptimize(cache.getRefFromObjectCache(queries[i]));
+            i = (i + 1) % queries.size();
+        }
+    }
+
+    void checkInObjectCache(benchmark::State& state)
+    {
+        Resource::ObjectCache& cache = getCache();
+        const std::vector<std::string> queries = makeQueries();
+        std::size_t i = 0;
+        double time = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(cache.checkInObjectCache(queries[i], time));
+            i = (i + 1) % queries.size();
+            time += 1;
+        }
+    }
+}
+
+BENCHMARK(getRefFromObjectCache)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(getRefOrAddToObjectCache)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(checkInObjectCache)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <components/to_utf8/to_utf8.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace
+{
+    // Text of the length of a typical dialogue response, book texts are a lot longer
+    constexpr std::size_t textLength = 256;
+    constexpr std::size_t asciiOnly = std::numeric_limits<std::size_t>::max();
+
+    // Latin text with one legacy character out of every nonAsciiInterval, or only Cyrillic ones for 0
+    std::string generateText(std::size_t length, std::size_t nonAsciiInterval)
+    {
+        std::minstd_rand random;
+        std::uniform_int_distribution<int> ascii('a', 'z');
+        std::uniform_int_distribution<int> legacy(0xC0, 0xFF);
+        std::string result(length, '\0');
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const bool isAscii = nonAsciiInterval != 0 && i % nonAsciiInterval != nonAsciiInterval - 1;
+            result[i] = static_cast<char>(isAscii ? ascii(random) : legacy(random));
+        }
+        return result;
+    }
+
+    void getUtf8(benchmark::State& state, ToUTF8::FromType encoding, std::size_t nonAsciiInterval)
+    {
+        ToUTF8::Utf8Encoder encoder(encoding);
+        const std::string text = generateText(static_cast<std::size_t>(state.range(0)), nonAsciiInterval);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(encoder.getUtf8(text));
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void getUtf8WithBuffer(benchmark::State& state, ToUTF8::FromType encoding, std::size_t nonAsciiInterval)
+    {
+        const ToUTF8::Utf8Encoder encoder(encoding);
+        const std::string text = generateText(static_cast<std::size_t>(state.range(0)), nonAsciiInterval);
+        std::string buffer;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(encoder.getUtf8(text, buffer));
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void getLegacyEnc(benchmark::State& state, ToUTF8::FromType encoding, std::size_t nonAsciiInterval)
+    {
+        ToUTF8::Utf8Encoder encoder(encoding);
+        const std::string text(encoder.getUtf8(generateText(static_cast<std::size_t>(state.range(0)), nonAsciiInterval)));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(encoder.getLegacyEnc(text));
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+    }
+}
+
+BENCHMARK_CAPTURE(getUtf8, ascii, ToUTF8::WINDOWS_1252, asciiOnly)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getUtf8, windows1252, ToUTF8::WINDOWS_1252, 16)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getUtf8, windows1251, ToUTF8::WINDOWS_1251, 0)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getUtf8WithBuffer, windows1252, ToUTF8::WINDOWS_1252, 16)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getLegacyEnc, ascii, ToUTF8::WINDOWS_1252, asciiOnly)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getLegacyEnc, windows1252, ToUTF8::WINDOWS_1252, 16)->Arg(textLength)->Arg(16384);
+BENCHMARK_CAPTURE(getLegacyEnc, windows1251, ToUTF8::WINDOWS_1251, 0)->Arg(textLength)->Arg(16384);
+
+BENCHMARK_MAIN();
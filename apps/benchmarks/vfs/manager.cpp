@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <components/vfs/archive.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct File : VFS::File
+    {
+        Files::IStreamPtr open() override
+        {
+            return std::make_shared<std::istringstream>(std::string());
+        }
+    };
+
+    // Paths shaped like the ones of the game data, e.g. Meshes\x\Ex_Common_House_12.nif
+    std::vector<std::string> generatePaths(std::size_t count)
+    {
+        static const char* const directories[] = { "Meshes\\x\\", "Meshes\\f\\", "Meshes\\i\\", "Textures\\", "Textures\\tx_", "Icons\\m\\", "Sound\\Fx\\" };
+        static const char* const names[] = { "Ex_Common_House_", "Furn_De_Table_", "In_Hlaalu_Wall_", "Misc_Com_Bucket_", "Terrain_Rock_" };
+        static const char* const extensions[] = { ".nif", ".nif", ".nif", ".dds", ".tga", ".wav" };
+        std::minstd_rand random;
+        std::vector<std::string> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            result.push_back(std::string(directories[random() % std::size(directories)])
+                + names[random() % std::size(names)] + std::to_string(i) + extensions[random() % std::size(extensions)]);
+        }
+        return result;
+    }
+
+    struct Archive : VFS::Archive
+    {
+        std::vector<std::string> mPaths;
+        File mFile;
+
+        explicit Archive(std::vector<std::string> paths) : mPaths(std::move(paths)) {}
+
+        void listResources(std::map<std::string, VFS::File*>& out, char (*normalize)(char)) override
+        {
+            for (const std::string& path : mPaths)
+            {
+                std::string normalized = path;
+                std::transform(normalized.begin(), normalized.end(), normalized.begin(), normalize);
+                out[std::move(normalized)] = &mFile;
+            }
+        }
+
+        bool contains(const std::string& file, char (*)(char)) const override
+        {
+            return std::find(mPaths.begin(), mPaths.end(), file) != mPaths.end();
+        }
+
+        std::string getDescription() const override { return "Archive"; }
+    };
+
+    std::unique_ptr<VFS::Manager> makeManager(const std::vector<std::string>& paths)
+    {
+        auto manager = std::make_unique<VFS::Manager>(false);
+        manager->addArchive(new Archive(paths));
+        manager->buildIndex();
+        return manager;
+    }
+
+    void buildIndex(benchmark::State& state)
+    {
+        const std::vector<std::string> paths = generatePaths(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(makeManager(paths));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Models and textures are looked up with the case and slashes of the content files, not normalized
+    void exists(benchmark::State& state)
+    {
+        std::vector<std::string> paths = generatePaths(static_cast<std::size_t>(state.range(0)));
+        const std::unique_ptr<VFS::Manager> manager = makeManager(paths);
+        std::shuffle(paths.begin(), paths.end(), std::minstd_rand());
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(manager->exists(paths[i]));
+            i = (i + 1) % paths.size();
+        }
+    }
+
+    void existsMissing(benchmark::State& state)
+    {
+        const std::unique_ptr<VFS::Manager> manager = makeManager(generatePaths(static_cast<std::size_t>(state.range(0))));
+        std::vector<std::string> missing = generatePaths(1024);
+        for (std::string& path : missing)
+            path.insert(path.find('\\') + 1, "missing\\");
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(manager->exists(missing[i]));
+            i = (i + 1) % missing.size();
+        }
+    }
+
+    void get(benchmark::State& state)
+    {
+        std::vector<std::string> paths = generatePaths(static_cast<std::size_t>(state.range(0)));
+        const std::unique_ptr<VFS::Manager> manager = makeManager(paths);
+        std::shuffle(paths.begin(), paths.end(), std::minstd_rand());
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(manager->get(paths[i]));
+            i = (i + 1) % paths.size();
+        }
+    }
+
+    void recursiveDirectoryIterator(benchmark::State& state)
+    {
+        const std::unique_ptr<VFS::Manager> manager = makeManager(generatePaths(static_cast<std::size_t>(state.range(0))));
+        std::size_t count = 0;
+        for (auto _ : state)
+        {
+            count = 0;
+            for (const std::string& name : manager->getRecursiveDirectoryIterator("textures/"))
+            {
+                benchmark::DoNotOptimize(name);
+                ++count;
+            }
+        }
+        state.counters["files"] = static_cast<double>(count);
+    }
+}
+
+BENCHMARK(buildIndex)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(exists)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 18);
+BENCHMARK(existsMissing)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 18);
+BENCHMARK(get)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 18);
+BENCHMARK(recursiveDirectoryIterator)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 18);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <boost/program_options.hpp>
@@ -283,7 +287,19 @@ int extract(std::unique_ptr<Bsa::BSAFile>& bsa, Arguments& info)
 
 int extractAll(std::unique_ptr<Bsa::BSAFile>& bsa, Arguments& info)
 {
-    for (const auto &file : bsa->getList())
+    const Bsa::BSAFile::FileList& files = bsa->getList();
+
+    // getFile() of the base class would return the raw data of compressed files
+    Bsa::CompressedBSAFile* compressed = dynamic_cast<Bsa::CompressedBSAFile*>(bsa.get());
+
+    // Serve the file data from the page cache instead of opening a stream for every file
+    bsa->mapIntoMemory();
+
+    // Create the directory hierarchy first, so that the files can be written on several threads
+    std::vector<bfs::path> targets;
+    targets.reserve(files.size());
+
+    for (const auto &file : files)
     {
         std::string extractPath(file.name());
         Misc::StringUtils::replaceAll(extractPath, "\\", "/");
@@ -292,7 +308,6 @@ int extractAll(std::unique_ptr<Bsa::BSAFile>& bsa, Arguments& info)
         bfs::path target (info.outdir);
         target /= extractPath;
 
-        // Create the directory hierarchy
         bfs::create_directories(target.parent_path());
 
         bfs::file_status s = bfs::status(target.parent_path());
@@ -302,14 +317,72 @@ int extractAll(std::unique_ptr<Bsa::BSAFile>& bsa, Arguments& info)
             return 3;
         }
 
-        // Get a stream for the file to extract
-        Files::IStreamPtr data = bsa->getFile(&file);
-        bfs::ofstream out(target, std::ios::binary);
+        targets.push_back(std::move(target));
+    }
+
+    std::atomic<std::size_t> next {0};
+    std::mutex mutex;
+    std::string error;
+
+    auto extractFiles = [&]
+    {
+        try
+        {
+            for (std::size_t i = next++; i < files.size(); i = next++)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error.empty())
+                        return;
+                    std::cout << "Extracting " << targets[i] << '\n';
+                }
+
+                bfs::ofstream out(targets[i], std::ios::binary);
+
+                // Write the file to disk
+                std::optional<std::string_view> view;
+                if (compressed == nullptr)
+                    view = bsa->getFileView(&files[i]);
+
+                if (view)
+                    out.write(view->data(), view->size());
+                else
+                {
+                    Files::IStreamPtr data = compressed != nullptr ? compressed->getFile(&files[i]) : bsa->getFile(&files[i]);
+                    out << data->rdbuf();
+                }
+
+                out.close();
+
+                if (out.bad())
+                    throw std::runtime_error("Failed to write " + targets[i].string());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error.empty())
+                error = e.what();
+        }
+    };
+
+    const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; ++i)
+        threads.emplace_back(extractFiles);
+
+    extractFiles();
 
-        // Write the file to disk
-        std::cout << "Extracting " << target << std::endl;
-        out << data->rdbuf();
-        out.close();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::cout.flush();
+
+    if (!error.empty())
+    {
+        std::cout << "ERROR: " << error << std::endl;
+        return 3;
     }
 
     return 0;
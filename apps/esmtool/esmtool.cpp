@@ -7,12 +7,17 @@
 #include <fstream>
 #include <cmath>
 #include <memory>
+#include <sstream>
+#include <string_view>
+#include <thread>
 
 #include <boost/program_options.hpp>
 
 #include <components/esm3/esmreader.hpp>
 #include <components/esm3/esmwriter.hpp>
 #include <components/esm/records.hpp>
+#include <components/misc/hash.hpp>
+#include <components/misc/stringops.hpp>
 
 #include "record.hpp"
 
@@ -58,7 +63,7 @@ struct Arguments
 
 bool parseOptions (int argc, char** argv, Arguments &info)
 {
-    bpo::options_description desc("Inspect and extract from Morrowind ES files (ESM, ESP, ESS)\nSyntax: esmtool [options] mode infile [outfile]\nAllowed modes:\n  dump\t Dumps all readable data from the input file.\n  clone\t Clones the input file to the output file.\n  comp\t Compares the given files.\n\nAllowed options");
+    bpo::options_description desc("Inspect and extract from Morrowind ES files (ESM, ESP, ESS)\nSyntax: esmtool [options] mode infile [outfile]\nAllowed modes:\n  dump\t Dumps all readable data from the input file.\n  clone\t Clones the input file to the output file.\n  comp\t Compares the records of the given files.\n\nAllowed options");
 
     desc.add_options()
         ("help,h", "print help message.")
@@ -189,373 +194,181 @@ void loadCell(ESM::Cell &cell, ESM::ESMReader &esm, Arguments& info);
 
 int load(Arguments& info);
 int clone(Arguments& info);
-int comp(Arguments& info);
+// Record key, hash of the record contents
+typedef std::map<std::string, std::size_t> RecordHashes;
 
-int main(int argc, char**argv)
+std::string getRecordKey(EsmTool::RecordBase& record)
 {
-    try
-    {
-        Arguments info;
-        if(!parseOptions (argc, argv, info))
-            return 1;
-
-        if (info.mode == "dump")
-            return load(info);
-        else if (info.mode == "clone")
-            return clone(info);
-        else if (info.mode == "comp")
-            return comp(info);
-        else
-        {
-            std::cout << "Invalid or no mode specified, dying horribly. Have a nice day." << std::endl;
-            return 1;
-        }
-    }
-    catch (std::exception& e)
-    {
-        std::cerr << "ERROR: " << e.what() << std::endl;
-        return 1;
-    }
-
-    return 0;
-}
+    std::ostringstream stream;
+    stream << record.getType().toString() << " '";
 
-void loadCell(ESM::Cell &cell, ESM::ESMReader &esm, Arguments& info)
-{
-    bool quiet = (info.quiet_given || info.mode == "clone");
-    bool save = (info.mode == "clone");
-
-    // Skip back to the beginning of the reference list
-    // FIXME: Changes to the references backend required to support multiple plugins have
-    //  almost certainly broken this following line. I'll leave it as is for now, so that
-    //  the compiler does not complain.
-    cell.restore(esm, 0);
-
-    // Loop through all the references
-    ESM::CellRef ref;
-    if(!quiet) std::cout << "  References:\n";
-
-    bool deleted = false;
-    ESM::MovedCellRef movedCellRef;
-    bool moved = false;
-    while(cell.getNextRef(esm, ref, deleted, movedCellRef, moved))
+    // some records have no ID, so identify them by what the game uses instead
+    switch (record.getType().toInt())
     {
-        if (save) {
-            info.data.mCellRefs[&cell].push_back(std::make_pair(ref, deleted));
-        }
-
-        if(quiet) continue;
-
-        std::cout << "  - Refnum: " << ref.mRefNum.mIndex << '\n';
-        std::cout << "    ID: " << ref.mRefID << '\n';
-        std::cout << "    Position: (" << ref.mPos.pos[0] << ", " << ref.mPos.pos[1] << ", " << ref.mPos.pos[2] << ")\n";
-        if (ref.mScale != 1.f)
-            std::cout << "    Scale: " << ref.mScale << '\n';
-        if (!ref.mOwner.empty())
-            std::cout << "    Owner: " << ref.mOwner << '\n';
-        if (!ref.mGlobalVariable.empty())
-            std::cout << "    Global: " << ref.mGlobalVariable << '\n';
-        if (!ref.mFaction.empty())
-            std::cout << "    Faction: " << ref.mFaction << '\n';
-        if (!ref.mFaction.empty() || ref.mFactionRank != -2)
-            std::cout << "    Faction rank: " << ref.mFactionRank << '\n';
-        std::cout << "    Enchantment charge: " << ref.mEnchantmentCharge << '\n';
-        std::cout << "    Uses/health: " << ref.mChargeInt << '\n';
-        std::cout << "    Gold value: " << ref.mGoldValue << '\n';
-        std::cout << "    Blocked: " << static_cast<int>(ref.mReferenceBlocked) << '\n';
-        std::cout << "    Deleted: " << deleted << '\n';
-        if (!ref.mKey.empty())
-            std::cout << "    Key: " << ref.mKey << '\n';
-        std::cout << "    Lock level: " << ref.mLockLevel << '\n';
-        if (!ref.mTrap.empty())
-            std::cout << "    Trap: " << ref.mTrap << '\n';
-        if (!ref.mSoul.empty())
-            std::cout << "    Soul: " << ref.mSoul << '\n';
-        if (ref.mTeleport)
+        case ESM::REC_CELL:
         {
-            std::cout << "    Destination position: (" << ref.mDoorDest.pos[0] << ", "
-                      << ref.mDoorDest.pos[1] << ", " << ref.mDoorDest.pos[2] << ")\n";
-            if (!ref.mDestCell.empty())
-                std::cout << "    Destination cell: " << ref.mDestCell << '\n';
+            const ESM::Cell& cell = record.cast<ESM::Cell>()->get();
+            if (cell.isExterior())
+                stream << "#" << cell.getGridX() << " " << cell.getGridY();
+            else
+                stream << Misc::StringUtils::lowerCase(cell.mName);
+            break;
         }
-        std::cout << "    Moved: " << std::boolalpha << moved << std::noboolalpha << '\n';
-        if (moved)
+        case ESM::REC_LAND:
         {
-            std::cout << "    Moved refnum: " << movedCellRef.mRefNum.mIndex << '\n';
-            std::cout << "    Moved content file: " << movedCellRef.mRefNum.mContentFile << '\n';
-            std::cout << "    Target: " << movedCellRef.mTarget[0] << ", " << movedCellRef.mTarget[1] << '\n';
+            const ESM::Land& land = record.cast<ESM::Land>()->get();
+            stream << "#" << land.mX << " " << land.mY;
+            break;
         }
-    }
-}
-
-void printRaw(ESM::ESMReader &esm)
-{
-    while(esm.hasMoreRecs())
-    {
-        ESM::NAME n = esm.getRecName();
-        std::cout << "Record: " << n.toString() << '\n';
-        esm.getRecHeader();
-        while(esm.hasMoreSubs())
+        case ESM::REC_PGRD:
         {
-            size_t offs = esm.getFileOffset();
-            esm.getSubName();
-            esm.skipHSub();
-            n = esm.retSubName();
-            std::ios::fmtflags f(std::cout.flags());
-            std::cout << "    " << n.toString() << " - " << esm.getSubSize()
-                 << " bytes @ 0x" << std::hex << offs << '\n';
-            std::cout.flags(f);
+            const ESM::Pathgrid& pathgrid = record.cast<ESM::Pathgrid>()->get();
+            stream << Misc::StringUtils::lowerCase(pathgrid.mCell) << " #" << pathgrid.mData.mX << " " << pathgrid.mData.mY;
+            break;
         }
+        case ESM::REC_SKIL:
+            stream << record.cast<ESM::Skill>()->get().mIndex;
+            break;
+        case ESM::REC_MGEF:
+            stream << record.cast<ESM::MagicEffect>()->get().mIndex;
+            break;
+        default:
+            stream << Misc::StringUtils::lowerCase(record.getId());
+            break;
     }
+
+    stream << "'";
+    return stream.str();
 }
 
-int load(Arguments& info)
+// Hashes the raw contents of every record in the file, without keeping the records in memory
+void hashRecords(const std::string& filename, ToUTF8::FromType encoding, RecordHashes& hashes)
 {
-    ESM::ESMReader& esm = info.reader;
-    ToUTF8::Utf8Encoder encoder (ToUTF8::calculateEncoding(info.encoding));
+    ESM::ESMReader esm;
+    ToUTF8::Utf8Encoder encoder (encoding);
     esm.setEncoder(&encoder);
+    esm.open(filename);
 
-    std::string filename = info.filename;
-    std::cout << "Loading file: " << filename << '\n';
+    std::map<std::string, int> occurrences;
+    std::string data;
 
-    std::unordered_set<uint32_t> skipped;
+    while(esm.hasMoreRecs())
+    {
+        const ESM::NAME n = esm.getRecName();
+        uint32_t flags;
+        esm.getRecHeader(flags);
 
-    try {
+        std::string key;
+        const ESM::ESM_Context context = esm.getContext();
 
-        if(info.raw_given && info.mode == "dump")
+        auto record = EsmTool::RecordBase::create(n);
+        if (record != nullptr)
         {
-            std::cout << "RAW file listing:\n";
-
-            esm.openRaw(filename);
-
-            printRaw(esm);
-
-            return 0;
+            record->load(esm);
+            key = getRecordKey(*record);
+            esm.restoreContext(context);
         }
+        else
+            key = n.toString();
 
-        bool quiet = (info.quiet_given || info.mode == "clone");
-        bool loadCells = (info.loadcells_given || info.mode == "clone");
-        bool save = (info.mode == "clone");
-
-        esm.open(filename);
-
-        info.data.author = esm.getAuthor();
-        info.data.description = esm.getDesc();
-        info.data.masters = esm.getGameFiles();
+        // tell apart records with the same key by their order in the file
+        int occurrence = occurrences[key]++;
+        if (occurrence > 0 || record == nullptr)
+            key += " #" + std::to_string(occurrence);
 
-        if (!quiet)
-        {
-            std::cout << "Author: " << esm.getAuthor() << '\n'
-                 << "Description: " << esm.getDesc() << '\n'
-                 << "File format version: " << esm.getFVer() << '\n';
-            std::vector<ESM::Header::MasterData> masterData = esm.getGameFiles();
-            if (!masterData.empty())
-            {
-                std::cout << "Masters:" << '\n';
-                for(const auto& master : masterData)
-                    std::cout << "  " << master.name << ", " << master.size << " bytes\n";
-            }
-        }
+        std::size_t hash = 0;
+        Misc::hashCombine(hash, flags);
 
-        // Loop through all records
-        while(esm.hasMoreRecs())
+        while(esm.hasMoreSubs())
         {
-            const ESM::NAME n = esm.getRecName();
-            uint32_t flags;
-            esm.getRecHeader(flags);
-
-            auto record = EsmTool::RecordBase::create(n);
-            if (record == nullptr)
-            {
-                if (skipped.count(n.toInt()) == 0)
-                {
-                    std::cout << "Skipping " << n.toString() << " records.\n";
-                    skipped.emplace(n.toInt());
-                }
-
-                esm.skipRecord();
-                if (quiet) break;
-                std::cout << "  Skipping\n";
-
-                continue;
-            }
-
-            record->setFlags(static_cast<int>(flags));
-            record->setPrintPlain(info.plain_given);
-            record->load(esm);
+            esm.getSubName();
+            esm.getSubHeader();
+            Misc::hashCombine(hash, esm.retSubName().toInt());
 
-            // Is the user interested in this record type?
-            bool interested = true;
-            if (!info.types.empty())
-            {
-                std::vector<std::string>::iterator match;
-                match = std::find(info.types.begin(), info.types.end(), n.toString());
-                if (match == info.types.end()) interested = false;
-            }
-
-            if (!info.name.empty() && !Misc::StringUtils::ciEqual(info.name, record->getId()))
-                interested = false;
-
-            if(!quiet && interested)
-            {
-                std::cout << "\nRecord: " << n.toString() << " '" << record->getId() << "'\n";
-                record->print();
-            }
-
-            if (record->getType().toInt() == ESM::REC_CELL && loadCells && interested)
-            {
-                loadCell(record->cast<ESM::Cell>()->get(), esm, info);
-            }
-
-            if (save)
-            {
-                info.data.mRecords.push_back(std::move(record));
-            }
-            ++info.data.mRecordStats[n.toInt()];
+            data.resize(esm.getSubSize());
+            esm.getExact(data.data(), static_cast<int>(data.size()));
+            Misc::hashCombine(hash, std::string_view(data));
         }
 
-    } catch(std::exception &e) {
-        std::cout << "\nERROR:\n\n  " << e.what() << std::endl;
-
-        info.data.mRecords.clear();
-        return 1;
+        hashes[key] = hash;
     }
-
-    return 0;
 }
 
-#include <iomanip>
-
-int clone(Arguments& info)
+int comp(Arguments& info)
 {
-    if (info.outname.empty())
-    {
-        std::cout << "You need to specify an output name" << std::endl;
-        return 1;
-    }
-
-    if (load(info) != 0)
+    if (info.filename.empty() || info.outname.empty())
     {
-        std::cout << "Failed to load, aborting." << std::endl;
+        std::cout << "You need to specify two input files" << std::endl;
         return 1;
     }
 
-    size_t recordCount = info.data.mRecords.size();
+    const ToUTF8::FromType encoding = ToUTF8::calculateEncoding(info.encoding);
 
-    int digitCount = 1; // For a nicer output
-    if (recordCount > 0)
-        digitCount = (int)std::log10(recordCount) + 1;
+    RecordHashes hashesOne;
+    RecordHashes hashesTwo;
+    std::string errorTwo;
 
-    std::cout << "Loaded " << recordCount << " records:\n\n";
+    // The files are independent, so read the second one on another thread
+    std::thread thread ([&] {
+        try
+        {
+            hashRecords(info.outname, encoding, hashesTwo);
+        }
+        catch (const std::exception& e)
+        {
+            errorTwo = e.what();
+        }
+    });
 
-    int i = 0;
-    for (std::pair<int, int> stat : info.data.mRecordStats)
+    try
     {
-        ESM::NAME name;
-        name = stat.first;
-        int amount = stat.second;
-        std::cout << std::setw(digitCount) << amount << " " << name.toString() << "  ";
-        if (++i % 3 == 0)
-            std::cout << '\n';
+        hashRecords(info.filename, encoding, hashesOne);
     }
-
-    if (i % 3 != 0)
-        std::cout << '\n';
-
-    std::cout << "\nSaving records to: " << info.outname << "...\n";
-
-    ESM::ESMWriter& esm = info.writer;
-    ToUTF8::Utf8Encoder encoder (ToUTF8::calculateEncoding(info.encoding));
-    esm.setEncoder(&encoder);
-    esm.setAuthor(info.data.author);
-    esm.setDescription(info.data.description);
-    esm.setVersion(info.data.version);
-    esm.setRecordCount (recordCount);
-
-    for (const ESM::Header::MasterData &master : info.data.masters)
-        esm.addMaster(master.name, master.size);
-
-    std::fstream save(info.outname.c_str(), std::fstream::out | std::fstream::binary);
-    esm.save(save);
-
-    int saved = 0;
-    for (auto& record : info.data.mRecords)
+    catch (const std::exception& e)
     {
-        if (i <= 0)
-            break;
-
-        const ESM::NAME& typeName = record->getType();
-
-        esm.startRecord(typeName.toString(), record->getFlags());
-
-        record->save(esm);
-        if (typeName.toInt() == ESM::REC_CELL) {
-            ESM::Cell *ptr = &record->cast<ESM::Cell>()->get();
-            if (!info.data.mCellRefs[ptr].empty()) 
-            {
-                for (std::pair<ESM::CellRef, bool> &ref : info.data.mCellRefs[ptr])
-                    ref.first.save(esm, ref.second);
-            }
-        }
-
-        esm.endRecord(typeName.toString());
-
-        saved++;
-        int perc = recordCount == 0 ? 100 : (int)((saved / (float)recordCount)*100);
-        if (perc % 10 == 0)
-        {
-            std::cerr << "\r" << perc << "%";
-        }
+        thread.join();
+        std::cout << "Failed to load " << info.filename << ": " << e.what() << ", aborting comparison." << std::endl;
+        return 1;
     }
 
-    std::cout << "\rDone!" << std::endl;
+    thread.join();
 
-    esm.close();
-    save.close();
-
-    return 0;
-}
-
-int comp(Arguments& info)
-{
-    if (info.filename.empty() || info.outname.empty())
+    if (!errorTwo.empty())
     {
-        std::cout << "You need to specify two input files" << std::endl;
+        std::cout << "Failed to load " << info.outname << ": " << errorTwo << ", aborting comparison." << std::endl;
         return 1;
     }
 
-    Arguments fileOne;
-    Arguments fileTwo;
-
-    fileOne.raw_given = false;
-    fileTwo.raw_given = false;
-
-    fileOne.mode = "clone";
-    fileTwo.mode = "clone";
-
-    fileOne.encoding = info.encoding;
-    fileTwo.encoding = info.encoding;
-
-    fileOne.filename = info.filename;
-    fileTwo.filename = info.outname;
+    int differences = 0;
 
-    if (load(fileOne) != 0)
+    for (const auto& record : hashesOne)
     {
-        std::cout << "Failed to load " << info.filename << ", aborting comparison." << std::endl;
-        return 1;
+        auto other = hashesTwo.find(record.first);
+        if (other == hashesTwo.end())
+            std::cout << "Only in " << info.filename << ": " << record.first << '\n';
+        else if (other->second != record.second)
+            std::cout << "Changed: " << record.first << '\n';
+        else
+            continue;
+
+        ++differences;
     }
 
-    if (load(fileTwo) != 0)
+    for (const auto& record : hashesTwo)
     {
-        std::cout << "Failed to load " << info.outname << ", aborting comparison." << std::endl;
-        return 1;
+        if (hashesOne.find(record.first) == hashesOne.end())
+        {
+            std::cout << "Only in " << info.outname << ": " << record.first << '\n';
+            ++differences;
+        }
     }
 
-    if (fileOne.data.mRecords.size() != fileTwo.data.mRecords.size())
+    if (differences != 0)
     {
-        std::cout << "Not equal, different amount of records." << std::endl;
+        std::cout << "Not equal, " << differences << " different records." << std::endl;
         return 1;
     }
 
+    std::cout << "Equal, " << hashesOne.size() << " records." << std::endl;
     return 0;
 }
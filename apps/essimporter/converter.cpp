@@ -2,6 +2,10 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 #include <osgDB/WriteFile>
 
@@ -314,7 +318,37 @@ namespace ESSImport
             mIntCells[cell.mName] = newcell;
     }
 
-    void ConvertCell::writeCell(const Cell &cell, ESM::ESMWriter& esm)
+    std::vector<int> ConvertCell::assignActorIds(const Cell& cell)
+    {
+        // same lookup order as in writeCell
+        std::vector<int> actorIds(cell.mRefs.size(), -1);
+
+        for (std::size_t i = 0; i < cell.mRefs.size(); ++i)
+        {
+            const CellRef& cellref = cell.mRefs[i];
+            if (!isIndexedRefId(cellref.mIndexedRefId))
+                continue;
+
+            int refIndex;
+            std::string refId;
+            splitIndexedRefId(cellref.mIndexedRefId, refIndex, refId);
+            const auto key = std::make_pair(refIndex, refId);
+
+            if (mContext->mNpcChanges.find(key) == mContext->mNpcChanges.end())
+            {
+                if (mContext->mContainerChanges.find(key) != mContext->mContainerChanges.end()
+                    || mContext->mCreatureChanges.find(key) == mContext->mCreatureChanges.end())
+                    continue;
+            }
+
+            actorIds[i] = mContext->generateActorId();
+            mContext->mActorIdMap.insert(std::make_pair(key, actorIds[i]));
+        }
+
+        return actorIds;
+    }
+
+    void ConvertCell::writeCell(const Cell &cell, const std::vector<int>& actorIds, ESM::ESMWriter& esm) const
     {
         ESM::Cell esmcell = cell.mCell;
         esm.startRecord(ESM::REC_CSTA);
@@ -327,8 +361,9 @@ namespace ESSImport
         csta.mWaterLevel = esmcell.mWater;
         csta.save(esm);
 
-        for (const auto & cellref : cell.mRefs)
+        for (std::size_t i = 0; i < cell.mRefs.size(); ++i)
         {
+            const CellRef& cellref = cell.mRefs[i];
             ESM::CellRef out (cellref);
 
             // TODO: use mContext->mCreatures/mNpcs
@@ -377,8 +412,7 @@ namespace ESSImport
                     convertNPCC(npccIt->second, objstate);
                     convertCellRef(cellref, objstate);
 
-                    objstate.mCreatureStats.mActorId = mContext->generateActorId();
-                    mContext->mActorIdMap.insert(std::make_pair(std::make_pair(refIndex, out.mRefID), objstate.mCreatureStats.mActorId));
+                    objstate.mCreatureStats.mActorId = actorIds[i];
 
                     esm.writeHNT ("OBJE", ESM::REC_NPC_);
                     objstate.save(esm);
@@ -419,8 +453,7 @@ namespace ESSImport
                     convertCREC(crecIt->second, objstate);
                     convertCellRef(cellref, objstate);
 
-                    objstate.mCreatureStats.mActorId = mContext->generateActorId();
-                    mContext->mActorIdMap.insert(std::make_pair(std::make_pair(refIndex, out.mRefID), objstate.mCreatureStats.mActorId));
+                    objstate.mCreatureStats.mActorId = actorIds[i];
 
                     esm.writeHNT ("OBJE", ESM::REC_CREA);
                     objstate.save(esm);
@@ -438,11 +471,63 @@ namespace ESSImport
 
     void ConvertCell::write(ESM::ESMWriter &esm)
     {
+        std::vector<const Cell*> cells;
+        cells.reserve(mIntCells.size() + mExtCells.size());
         for (const auto & cell : mIntCells)
-            writeCell(cell.second, esm);
-
+            cells.push_back(&cell.second);
         for (const auto & cell : mExtCells)
-            writeCell(cell.second, esm);
+            cells.push_back(&cell.second);
+
+        // Actor IDs are handed out in the order the cells are written, so assign them before the cells are
+        // serialised on several threads. The records are then copied to the file in the same order.
+        std::vector<std::vector<int>> actorIds;
+        actorIds.reserve(cells.size());
+        for (const Cell* cell : cells)
+            actorIds.push_back(assignActorIds(*cell));
+
+        std::vector<std::string> records(cells.size());
+        std::atomic<std::size_t> next {0};
+        std::mutex errorMutex;
+        std::string error;
+
+        auto writeCells = [&]
+        {
+            try
+            {
+                ESM::ESMWriter writer;
+                writer.setVersion(esm.getVersion());
+
+                for (std::size_t i = next++; i < cells.size(); i = next++)
+                {
+                    std::ostringstream stream;
+                    writer.saveRecords(stream);
+                    writeCell(*cells[i], actorIds[i], writer);
+                    records[i] = stream.str();
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty())
+                    error = e.what();
+            }
+        };
+
+        const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount && i < cells.size(); ++i)
+            threads.emplace_back(writeCells);
+
+        writeCells();
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        if (!error.empty())
+            throw std::runtime_error(error);
+
+        for (const std::string& record : records)
+            esm.writeRecord(record);
 
         for (const auto & marker : mMarkers)
         {
@@ -354,7 +354,11 @@ private:
 
     std::vector<ESM::CustomMarker> mMarkers;
 
-    void writeCell(const Cell& cell, ESM::ESMWriter &esm);
+    std::vector<int> assignActorIds(const Cell& cell);
+    ///< \return actor ID for each reference of the cell, -1 for references that are not actors
+
+    void writeCell(const Cell& cell, const std::vector<int>& actorIds, ESM::ESMWriter &esm) const;
+    ///< \note Does not change the context, so that cells can be written on several threads
 };
 
 class ConvertKLST : public Converter
@@ -136,6 +136,8 @@ bool Launcher::GraphicsPage::loadSettings()
         lightingMethod = 0;
     else if (Settings::Manager::getString("lighting method", "Shaders") == "shaders")
         lightingMethod = 2;
+    else if (Settings::Manager::getString("lighting method", "Shaders") == "clustered")
+        lightingMethod = 3;
     lightingMethodComboBox->setCurrentIndex(lightingMethod);
 
     // Shadows
@@ -230,7 +232,7 @@ void Launcher::GraphicsPage::saveSettings()
     }
 
     // Lighting
-    static std::array<std::string, 3> lightingMethodMap = {"legacy", "shaders compatibility", "shaders"};
+    static std::array<std::string, 4> lightingMethodMap = {"legacy", "shaders compatibility", "shaders", "clustered"};
     Settings::Manager::setString("lighting method", "Shaders", lightingMethodMap[lightingMethodComboBox->currentIndex()]);
 
     // Shadows
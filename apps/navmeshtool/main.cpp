@@ -28,6 +28,7 @@
 
 #include <cstddef>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -83,6 +84,30 @@ namespace NavMeshTool
 
                 ("process-interior-cells", bpo::value<bool>()->implicit_value(true)
                     ->default_value(false), "build navmesh for interior cells")
+
+                ("worldspace", bpo::value<StringsVector>()->default_value(StringsVector(), "")
+                    ->multitoken()->composing(), "build navmesh only for given worldspace(s), all by default")
+
+                ("shards", bpo::value<std::size_t>()->default_value(1),
+                    "split tiles of each worldspace into given number of ranges to build them by separate processes")
+
+                ("shard", bpo::value<std::size_t>()->default_value(0),
+                    "index of the tiles range to build, from 0 to shards - 1")
+
+                ("output", bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), ""),
+                    "navmesh database path, navmesh.db in user data directory by default")
+
+                ("merge", bpo::value<Files::MaybeQuotedPathContainer>()->default_value(Files::MaybeQuotedPathContainer(), "")
+                    ->multitoken()->composing(), "merge given navmesh databases into output database and quit")
+
+                ("recompress", bpo::value<bool>()->implicit_value(true)
+                    ->default_value(false), "recompress tiles of output database with a new trained dictionary and quit")
+
+                ("dictionary-size", bpo::value<std::size_t>()->default_value(64 * 1024),
+                    "max size of the tile data dictionary in bytes for recompress")
+
+                ("dictionary-samples", bpo::value<std::size_t>()->default_value(1000),
+                    "number of tiles used to build the tile data dictionary for recompress")
             ;
             Files::ConfigurationManager::addCommonOptions(result);
 
@@ -141,6 +166,23 @@ namespace NavMeshTool
             }
 
             const bool processInteriorCells = variables["process-interior-cells"].as<bool>();
+            const auto worldspaces = variables["worldspace"].as<StringsVector>();
+
+            Shard shard;
+            shard.mCount = variables["shards"].as<std::size_t>();
+            shard.mIndex = variables["shard"].as<std::size_t>();
+
+            if (shard.mCount < 1 || shard.mIndex >= shard.mCount)
+            {
+                std::cerr << "Invalid shard: " << shard.mIndex << " of " << shard.mCount
+                          << ", expected shards >= 1 and 0 <= shard < shards";
+                return -1;
+            }
+
+            const auto mergePaths = asPathContainer(variables["merge"].as<Files::MaybeQuotedPathContainer>());
+            const bool recompress = variables["recompress"].as<bool>();
+            const std::size_t dictionarySize = variables["dictionary-size"].as<std::size_t>();
+            const std::size_t dictionarySamples = variables["dictionary-samples"].as<std::size_t>();
 
             Fallback::Map::init(variables["fallback"].as<Fallback::FallbackMap>().mMap);
 
@@ -153,7 +195,32 @@ namespace NavMeshTool
 
             const osg::Vec3f agentHalfExtents = Settings::Manager::getVector3("default actor pathfind half extents", "Game");
 
-            DetourNavigator::NavMeshDb db((config.getUserDataPath() / "navmesh.db").string());
+            boost::filesystem::path outputPath = variables["output"].as<Files::MaybeQuotedPath>();
+            if (outputPath.empty())
+                outputPath = config.getUserDataPath() / "navmesh.db";
+
+            DetourNavigator::NavMeshDb db(outputPath.string());
+
+            if (!mergePaths.empty())
+            {
+                DetourNavigator::RecastGlobalAllocator::init();
+                for (const boost::filesystem::path& path : mergePaths)
+                {
+                    Log(Debug::Info) << "Merging " << path << " into " << outputPath << "...";
+                    DetourNavigator::NavMeshDb source(path.string());
+                    mergeNavMeshDb(source, db);
+                }
+                Log(Debug::Info) << "Done";
+                return 0;
+            }
+
+            if (recompress)
+            {
+                Log(Debug::Info) << "Recompressing " << outputPath << "...";
+                recompressNavMeshDb(db, dictionarySize, dictionarySamples);
+                Log(Debug::Info) << "Done";
+                return 0;
+            }
 
             std::vector<ESM::ESMReader> readers(contentFiles.size());
             EsmLoader::Query query;
@@ -175,9 +242,9 @@ namespace NavMeshTool
             navigatorSettings.mRecast.mSwimHeightScale = EsmLoader::getGameSetting(esmData.mGameSettings, "fSwimHeightScale").getFloat();
 
             WorldspaceData cellsData = gatherWorldspaceData(navigatorSettings, readers, vfs, bulletShapeManager,
-                                                            esmData, processInteriorCells);
+                                                            esmData, processInteriorCells, worldspaces);
 
-            generateAllNavMeshTiles(agentHalfExtents, navigatorSettings, threadsNumber, cellsData, std::move(db));
+            generateAllNavMeshTiles(agentHalfExtents, navigatorSettings, threadsNumber, shard, cellsData, std::move(db));
 
             Log(Debug::Info) << "Done";
 
@@ -11,6 +11,7 @@
 #include <components/detournavigator/recastmesh.hpp>
 #include <components/detournavigator/recastmeshprovider.hpp>
 #include <components/detournavigator/serialization.hpp>
+#include <components/detournavigator/tilegraph.hpp>
 #include <components/detournavigator/tileposition.hpp>
 #include <components/misc/progressreporter.hpp>
 #include <components/sceneutil/workqueue.hpp>
@@ -21,6 +22,10 @@
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 #include <random>
@@ -29,6 +34,8 @@ namespace NavMeshTool
 {
     namespace
     {
+        using DetourNavigator::DbShape;
+        using DetourNavigator::DbTile;
         using DetourNavigator::GenerateNavMeshTile;
         using DetourNavigator::NavMeshDb;
         using DetourNavigator::NavMeshTileInfo;
@@ -105,6 +112,7 @@ namespace NavMeshTool
                 {
                     std::lock_guard lock(mMutex);
                     mDb.insertTile(mNextTileId, worldspace, tilePosition, TileVersion {version}, input, serialize(data));
+                    mDb.insertTilePortals(mNextTileId, DetourNavigator::getTilePortals(data));
                     ++mNextTileId.t;
                 }
                 ++mInserted;
@@ -117,6 +125,7 @@ namespace NavMeshTool
                 {
                     std::lock_guard lock(mMutex);
                     mDb.updateTile(TileId {tileId}, TileVersion {version}, serialize(data));
+                    mDb.insertTilePortals(TileId {tileId}, DetourNavigator::getTilePortals(data));
                 }
                 ++mUpdated;
                 report();
@@ -162,10 +171,13 @@ namespace NavMeshTool
     }
 
     void generateAllNavMeshTiles(const osg::Vec3f& agentHalfExtents, const Settings& settings,
-        const std::size_t threadsNumber, WorldspaceData& data, NavMeshDb&& db)
+        const std::size_t threadsNumber, const Shard& shard, WorldspaceData& data, NavMeshDb&& db)
     {
         Log(Debug::Info) << "Generating navmesh tiles by " << threadsNumber << " parallel workers...";
 
+        if (shard.mCount > 1)
+            Log(Debug::Info) << "Generating shard " << shard.mIndex << " of " << shard.mCount;
+
         SceneUtil::WorkQueue workQueue(threadsNumber);
         auto navMeshTileConsumer = std::make_shared<NavMeshTileConsumer>(std::move(db));
         std::size_t tiles = 0;
@@ -184,6 +196,15 @@ namespace NavMeshTool
                 [&] (const TilePosition& tilePosition) { worldspaceTiles.push_back(tilePosition); }
             );
 
+            if (shard.mCount > 1)
+            {
+                // Each shard takes a contiguous range of the tiles so its objects are shared by less shards
+                const std::size_t begin = worldspaceTiles.size() * shard.mIndex / shard.mCount;
+                const std::size_t end = worldspaceTiles.size() * (shard.mIndex + 1) / shard.mCount;
+                worldspaceTiles.erase(worldspaceTiles.begin() + end, worldspaceTiles.end());
+                worldspaceTiles.erase(worldspaceTiles.begin(), worldspaceTiles.begin() + begin);
+            }
+
             tiles += worldspaceTiles.size();
 
             navMeshTileConsumer->mExpected = tiles;
@@ -208,4 +229,141 @@ namespace NavMeshTool
             << navMeshTileConsumer->getInserted() << " are inserted and "
             << navMeshTileConsumer->getUpdated() << " updated";
     }
+    void mergeNavMeshDb(NavMeshDb& source, NavMeshDb& target)
+    {
+        Transaction transaction = target.startTransaction();
+
+        std::map<std::int64_t, std::int64_t> shapeIds;
+        ShapeId nextShapeId {target.getMaxShapeId() + 1};
+        for (const DbShape& shape : source.getShapes())
+        {
+            const Sqlite3::ConstBlob hash {reinterpret_cast<const char*>(shape.mHash.data()),
+                                           static_cast<int>(shape.mHash.size())};
+            if (const std::optional<ShapeId> existing = target.findShapeId(shape.mName, shape.mType, hash))
+            {
+                shapeIds.emplace(shape.mShapeId, *existing);
+                continue;
+            }
+            target.insertShape(nextShapeId, shape.mName, shape.mType, hash);
+            shapeIds.emplace(shape.mShapeId, nextShapeId);
+            ++nextShapeId.t;
+        }
+
+        const auto getShapeId = [&] (std::int64_t shapeId)
+        {
+            const auto it = shapeIds.find(shapeId);
+            if (it == shapeIds.end())
+                throw std::runtime_error("Shape " + std::to_string(shapeId) + " is not found");
+            return it->second;
+        };
+
+        constexpr std::size_t tilesPerRequest = 1000;
+        TileId nextTileId {target.getMaxTileId() + 1};
+        TileId lastTileId {0};
+        std::size_t inserted = 0;
+        std::size_t updated = 0;
+        std::size_t skipped = 0;
+        while (true)
+        {
+            std::vector<DbTile> tiles = source.getTiles(lastTileId, tilesPerRequest);
+            if (tiles.empty())
+                break;
+            lastTileId = tiles.back().mTileId;
+            for (DbTile& tile : tiles)
+            {
+                PreparedNavMeshData data;
+                try
+                {
+                    if (!DetourNavigator::replaceShapeIds(tile.mInput, getShapeId) || !deserialize(tile.mData, data))
+                        throw std::runtime_error("invalid data");
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Warning) << "Skipped tile " << static_cast<std::int64_t>(tile.mTileId) << " for worldspace ""
+                        << tile.mWorldspace << "": " << e.what();
+                    ++skipped;
+                    continue;
+                }
+                if (const std::optional<DetourNavigator::Tile> existing
+                        = target.findTile(tile.mWorldspace, tile.mTilePosition, tile.mInput))
+                {
+                    if (existing->mVersion == tile.mVersion)
+                        continue;
+                    data.mUserId = static_cast<unsigned>(existing->mTileId);
+                    target.updateTile(existing->mTileId, tile.mVersion, serialize(data));
+                    target.insertTilePortals(existing->mTileId, DetourNavigator::getTilePortals(data));
+                    ++updated;
+                    continue;
+                }
+                data.mUserId = static_cast<unsigned>(nextTileId);
+                target.insertTile(nextTileId, tile.mWorldspace, tile.mTilePosition, tile.mVersion, tile.mInput,
+                                  serialize(data));
+                target.insertTilePortals(nextTileId, DetourNavigator::getTilePortals(data));
+                ++nextTileId.t;
+                ++inserted;
+            }
+        }
+
+        transaction.commit();
+
+        Log(Debug::Info) << "Merged " << shapeIds.size() << " shapes and " << (inserted + updated) << " tiles, "
+            << inserted << " are inserted, " << updated << " updated and " << skipped << " skipped";
+    }
+
+    void recompressNavMeshDb(NavMeshDb& db, std::size_t dictionarySize, std::size_t samplesCount)
+    {
+        constexpr std::size_t tilesPerRequest = 1000;
+
+        std::vector<std::vector<std::byte>> samples;
+        samples.reserve(samplesCount);
+        std::minstd_rand random;
+        std::size_t tilesCount = 0;
+        TileId lastTileId {0};
+        while (true)
+        {
+            std::vector<DbTile> tiles = db.getTiles(lastTileId, tilesPerRequest);
+            if (tiles.empty())
+                break;
+            lastTileId = tiles.back().mTileId;
+            for (DbTile& tile : tiles)
+            {
+                ++tilesCount;
+                if (samples.size() < samplesCount)
+                {
+                    samples.push_back(std::move(tile.mData));
+                    continue;
+                }
+                const std::size_t index = std::uniform_int_distribution<std::size_t>(0, tilesCount - 1)(random);
+                if (index < samples.size())
+                    samples[index] = std::move(tile.mData);
+            }
+        }
+
+        const std::vector<std::byte> dictionary = DetourNavigator::makeTileDataDictionary(samples, dictionarySize);
+        if (dictionary.empty())
+        {
+            Log(Debug::Info) << "No tiles to recompress";
+            return;
+        }
+
+        Transaction transaction = db.startTransaction();
+
+        const std::int64_t dictionaryId = db.insertTileDataDictionary(dictionary);
+
+        lastTileId = TileId {0};
+        while (true)
+        {
+            std::vector<DbTile> tiles = db.getTiles(lastTileId, tilesPerRequest);
+            if (tiles.empty())
+                break;
+            lastTileId = tiles.back().mTileId;
+            for (const DbTile& tile : tiles)
+                db.updateTile(tile.mTileId, tile.mVersion, tile.mData);
+        }
+
+        transaction.commit();
+
+        Log(Debug::Info) << "Recompressed " << tilesCount << " tiles with dictionary " << dictionaryId << " of "
+            << dictionary.size() << " bytes built from " << samples.size() << " samples";
+    }
 }
@@ -16,8 +16,20 @@ namespace NavMeshTool
 {
     struct WorldspaceData;
 
+    struct Shard
+    {
+        std::size_t mIndex = 0;
+        std::size_t mCount = 1;
+    };
+
     void generateAllNavMeshTiles(const osg::Vec3f& agentHalfExtents, const DetourNavigator::Settings& settings,
-        const std::size_t threadsNumber, WorldspaceData& cellsData, DetourNavigator::NavMeshDb&& db);
+        const std::size_t threadsNumber, const Shard& shard, WorldspaceData& cellsData, DetourNavigator::NavMeshDb&& db);
+
+    /// Copies tiles and shapes from source to target, replacing ids to not conflict with target ones
+    void mergeNavMeshDb(DetourNavigator::NavMeshDb& source, DetourNavigator::NavMeshDb& target);
+
+    /// Builds a new tile data dictionary from a sample of stored tiles and recompresses all tiles with it
+    void recompressNavMeshDb(DetourNavigator::NavMeshDb& db, std::size_t dictionarySize, std::size_t samplesCount);
 }
 
 #endif
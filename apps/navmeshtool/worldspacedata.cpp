@@ -226,7 +226,7 @@ namespace NavMeshTool
 
     WorldspaceData gatherWorldspaceData(const DetourNavigator::Settings& settings, std::vector<ESM::ESMReader>& readers,
         const VFS::Manager& vfs, Resource::BulletShapeManager& bulletShapeManager, const EsmLoader::EsmData& esmData,
-        bool processInteriorCells)
+        bool processInteriorCells, const std::vector<std::string>& worldspaces)
     {
         Log(Debug::Info) << "Processing " << esmData.mCells.size() << " cells...";
 
@@ -247,6 +247,14 @@ namespace NavMeshTool
                 continue;
             }
 
+            if (!worldspaces.empty() && std::none_of(worldspaces.begin(), worldspaces.end(),
+                    [&] (const std::string& v) { return Misc::StringUtils::ciEqual(v, cell.mCellId.mWorldspace); }))
+            {
+                Log(Debug::Debug) << "Skipped cell (" << (i + 1) << "/" << esmData.mCells.size() << ") \""
+                    << cell.getDescription() << "\" from not selected worldspace";
+                continue;
+            }
+
             Log(Debug::Debug) << "Processing " << (exterior ? "exterior" : "interior")
                 << " cell (" << (i + 1) << "/" << esmData.mCells.size() << ") \"" << cell.getDescription() << "\"";
 
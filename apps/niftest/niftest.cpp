@@ -1,10 +1,22 @@
 ///Program to test .nif files both on the FileSystem and in BSA archives.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <osg/Node>
 
 #include <components/misc/stringops.hpp>
 #include <components/nif/niffile.hpp>
+#include <components/nifbullet/bulletnifloader.hpp>
+#include <components/nifosg/nifloader.hpp>
 #include <components/files/constrainedfilestream.hpp>
+#include <components/resource/imagemanager.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/vfs/bsaarchive.hpp>
 #include <components/vfs/filesystemarchive.hpp>
@@ -34,29 +46,67 @@ bool isBSA(const std::string & filename)
     return hasExtension(filename,"bsa");
 }
 
-/// Check all the nif files in a given VFS::Archive
+/// VFS of an archive or directory, with the resource managers needed to convert its nif files
+struct Source
+{
+    std::unique_ptr<VFS::Manager> mVfs;
+    std::unique_ptr<Resource::ImageManager> mImageManager;
+};
+
+/// A nif file to check
+struct Task
+{
+    const Source* mSource;
+    std::string mName; ///< Name in the VFS of the source, or path of a loose file
+    std::string mPath; ///< Name used in messages
+    bool mLooseFile;
+    double mDuration;
+};
+
+struct Arguments
+{
+    std::vector<std::string> mFiles;
+    unsigned int mJobs;
+    std::size_t mSlowest;
+    bool mConvert;
+    bool mProgress;
+};
+
+Source& addSource(std::vector<std::unique_ptr<Source>>& sources, VFS::Archive* anArchive, bool convert)
+{
+    auto source = std::make_unique<Source>();
+    source->mVfs = std::make_unique<VFS::Manager>(true);
+    if (anArchive != nullptr)
+        source->mVfs->addArchive(anArchive);
+    source->mVfs->buildIndex();
+    if (convert)
+        source->mImageManager = std::make_unique<Resource::ImageManager>(source->mVfs.get());
+
+    sources.push_back(std::move(source));
+    return *sources.back();
+}
+
+/// Collect all the nif files in a given VFS::Archive
 /// \note Takes ownership!
 /// \note Can not read a bsa file inside of a bsa file.
-void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
+void readVFS(VFS::Archive* anArchive, std::vector<std::unique_ptr<Source>>& sources, std::vector<Task>& tasks,
+    bool convert, std::string archivePath = "")
 {
-    VFS::Manager myManager(true);
-    myManager.addArchive(anArchive);
-    myManager.buildIndex();
+    const Source& source = addSource(sources, anArchive, convert);
 
-    for(const auto& name : myManager.getRecursiveDirectoryIterator(""))
+    for(const auto& name : source.mVfs->getRecursiveDirectoryIterator(""))
     {
         try{
             if(isNIF(name))
             {
-            //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(myManager.get(name),archivePath+name);
+                tasks.push_back({&source, name, archivePath+name, false, 0});
             }
             else if(isBSA(name))
             {
                 if(!archivePath.empty() && !isBSA(archivePath))
                 {
 //                     std::cout << "Reading BSA File: " << name << std::endl;
-                    readVFS(new VFS::BsaArchive(archivePath+name),archivePath+name+"/");
+                    readVFS(new VFS::BsaArchive(archivePath+name, true), sources, tasks, convert, archivePath+name+"/");
 //                     std::cout << "Done with BSA File: " << name << std::endl;
                 }
             }
@@ -68,7 +118,33 @@ void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
     }
 }
 
-bool parseOptions (int argc, char** argv, std::vector<std::string>& files)
+/// Parse a nif file, and optionally convert it to a scene graph and collision shape like the game does
+void checkNIF(const Task& task, bool convert)
+{
+    Nif::NIFFilePtr nif;
+
+    if (task.mLooseFile)
+        nif = std::make_shared<Nif::NIFFile>(Files::openConstrainedFileStream(task.mName.c_str()), task.mPath);
+    else if (const auto view = task.mSource->mVfs->getView(task.mName))
+        nif = std::make_shared<Nif::NIFFile>(*view, task.mPath);
+    else
+        nif = std::make_shared<Nif::NIFFile>(task.mSource->mVfs->get(task.mName), task.mPath);
+
+    if (!convert)
+        return;
+
+    try
+    {
+        NifOsg::Loader::load(nif, task.mSource->mImageManager.get());
+        NifBullet::BulletNifLoader().load(*nif);
+    }
+    catch (std::exception& e)
+    {
+        throw std::runtime_error("Failed to convert " + task.mPath + ": " + e.what());
+    }
+}
+
+bool parseOptions (int argc, char** argv, Arguments& info)
 {
     bpo::options_description desc("Ensure that OpenMW can use the provided NIF and BSA files\n\n"
         "Usages:\n"
@@ -77,6 +153,10 @@ bool parseOptions (int argc, char** argv, std::vector<std::string>& files)
         "Allowed options");
     desc.add_options()
         ("help,h", "print help message.")
+        ("jobs,j", bpo::value<unsigned int>(&info.mJobs)->default_value(1), "number of files to check at the same time, 0 to use all cores.")
+        ("convert,c", "also convert the files to scene graphs and collision shapes, like the game does.")
+        ("slowest,s", bpo::value<std::size_t>(&info.mSlowest)->default_value(0), "report the given number of files that took the longest to check.")
+        ("progress,p", "report how many files have been checked.")
         ("input-file", bpo::value< std::vector<std::string> >(), "input file")
         ;
 
@@ -98,7 +178,11 @@ bool parseOptions (int argc, char** argv, std::vector<std::string>& files)
         }
         if (variables.count("input-file"))
         {
-            files = variables["input-file"].as< std::vector<std::string> >();
+            info.mFiles = variables["input-file"].as< std::vector<std::string> >();
+            info.mConvert = variables.count("convert") != 0;
+            info.mProgress = variables.count("progress") != 0;
+            if (info.mJobs == 0)
+                info.mJobs = std::max(1u, std::thread::hardware_concurrency());
             return true;
         }
     }
@@ -116,13 +200,20 @@ bool parseOptions (int argc, char** argv, std::vector<std::string>& files)
 
 int main(int argc, char **argv)
 {
-    std::vector<std::string> files;
-    if(!parseOptions (argc, argv, files))
+    Arguments info;
+    if(!parseOptions (argc, argv, info))
         return 1;
 
     Nif::NIFFile::setLoadUnsupportedFiles(true);
+
+    std::vector<std::unique_ptr<Source>> sources;
+    std::vector<Task> tasks;
+
+    // Loose nif files are not part of a VFS, but conversion still needs one for the textures
+    const Source& looseFiles = addSource(sources, nullptr, info.mConvert);
+
 //     std::cout << "Reading Files" << std::endl;
-    for(auto it=files.begin(); it!=files.end(); ++it)
+    for(auto it=info.mFiles.begin(); it!=info.mFiles.end(); ++it)
     {
         std::string name = *it;
 
@@ -130,18 +221,17 @@ int main(int argc, char **argv)
         {
             if(isNIF(name))
             {
-                //std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(Files::openConstrainedFileStream(name.c_str()),name);
+                tasks.push_back({&looseFiles, name, name, true, 0});
              }
              else if(isBSA(name))
              {
 //                 std::cout << "Reading BSA File: " << name << std::endl;
-                readVFS(new VFS::BsaArchive(name));
+                readVFS(new VFS::BsaArchive(name, true), sources, tasks, info.mConvert);
              }
              else if(bfs::is_directory(bfs::path(name)))
              {
 //                 std::cout << "Reading All Files in: " << name << std::endl;
-                readVFS(new VFS::FileSystemArchive(name),name);
+                readVFS(new VFS::FileSystemArchive(name), sources, tasks, info.mConvert, name);
              }
              else
              {
@@ -153,5 +243,64 @@ int main(int argc, char **argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
      }
+
+    // The files are independent, so each job takes the next file that nobody checked yet
+    std::atomic<std::size_t> next {0};
+    std::atomic<std::size_t> checked {0};
+    std::mutex outputMutex;
+
+    auto checkFiles = [&]
+    {
+        for (std::size_t i = next++; i < tasks.size(); i = next++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            try
+            {
+                checkNIF(tasks[i], info.mConvert);
+            }
+            catch (std::exception& e)
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
+            }
+
+            tasks[i].mDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const std::size_t count = ++checked;
+            if (info.mProgress && (count % 100 == 0 || count == tasks.size()))
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cout << "Checked " << count << " of " << tasks.size() << " files" << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < info.mJobs; ++i)
+        threads.emplace_back(checkFiles);
+
+    checkFiles();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (info.mSlowest > 0)
+    {
+        std::vector<const Task*> slowest;
+        slowest.reserve(tasks.size());
+        for (const Task& task : tasks)
+            slowest.push_back(&task);
+
+        const std::size_t count = std::min(info.mSlowest, slowest.size());
+        std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+            [] (const Task* left, const Task* right) { return left->mDuration > right->mDuration; });
+
+        std::cout << "Slowest files:" << std::endl;
+        for (std::size_t i = 0; i < count; ++i)
+            std::cout << std::fixed << std::setprecision(3) << std::setw(10) << slowest[i]->mDuration * 1000
+                      << " ms  " << slowest[i]->mPath << std::endl;
+    }
+
      return 0;
 }
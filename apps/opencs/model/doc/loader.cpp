@@ -1,5 +1,6 @@
 #include "loader.hpp"
 
+#include <chrono>
 #include <iostream>
 
 #include "../tools/reportmodel.hpp"
@@ -59,15 +60,26 @@ void CSMDoc::Loader::load()
         if (iter->second.mRecordsLeft)
         {
             Messages messages (Message::Severity_Error);
-            const int batchingSize = 50;
-            for (int i=0; i<batchingSize; ++i) // do not flood the system with update signals
+
+            // Load records for a fixed time instead of a fixed number of records, so that small
+            // records don't cost a timer event and an update signal each few microseconds, while
+            // large records still don't block stopping or aborting.
+            const auto batchEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds (sBatchDuration);
+            int loaded = 0;
+            for (;;)
+            {
                 if (document->getData().continueLoading (messages))
                 {
                     iter->second.mRecordsLeft = false;
                     break;
                 }
-                else
-                    ++(iter->second.mRecordsLoaded);
+
+                ++(iter->second.mRecordsLoaded);
+
+                // checking the clock costs more than loading the smallest records
+                if (++loaded % sClockCheckInterval==0 && std::chrono::steady_clock::now()>=batchEnd)
+                    break;
+            }
 
             CSMWorld::UniversalId log (CSMWorld::UniversalId::Type_LoadErrorLog, 0);
 
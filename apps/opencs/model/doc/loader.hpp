@@ -32,6 +32,12 @@ namespace CSMDoc
             QTimer* mTimer;
             bool mShouldStop;
 
+            /// Time in milliseconds to load records for before giving control back to the event loop
+            static constexpr int sBatchDuration = 50;
+
+            /// Number of records loaded between checks of the batch time
+            static constexpr int sClockCheckInterval = 16;
+
         public:
 
             Loader();
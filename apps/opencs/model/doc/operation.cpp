@@ -1,6 +1,10 @@
 #include "operation.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <QTimer>
@@ -28,7 +32,8 @@ CSMDoc::Operation::Operation (int type, bool ordered, bool finalAlways)
 : mType (type), mStages(std::vector<std::pair<Stage *, int> >()), mCurrentStage(mStages.begin()),
   mCurrentStep(0), mCurrentStepTotal(0), mTotalSteps(0), mOrdered (ordered),
   mFinalAlways (finalAlways), mError(false), mConnected (false), mPrepared (false),
-  mDefaultSeverity (Message::Severity_Error)
+  mDefaultSeverity (Message::Severity_Error),
+  mThreads (std::max (1, static_cast<int> (std::thread::hardware_concurrency())))
 {
     mTimer = new QTimer (this);
 }
@@ -98,6 +103,10 @@ void CSMDoc::Operation::executeStage()
 
     Messages messages (mDefaultSeverity);
 
+    // perform steps for a fixed time, so that short steps don't cost an event and a progress
+    // signal each
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds (sStepDuration);
+
     while (mCurrentStage!=mStages.end())
     {
         if (mCurrentStep>=mCurrentStage->second)
@@ -107,9 +116,14 @@ void CSMDoc::Operation::executeStage()
         }
         else
         {
+            int steps = 1;
+
             try
             {
-                mCurrentStage->first->perform (mCurrentStep++, messages);
+                if (mCurrentStage->first->isParallel())
+                    steps = performParallel (messages);
+                else
+                    mCurrentStage->first->perform (mCurrentStep++, messages);
             }
             catch (const std::exception& e)
             {
@@ -117,8 +131,10 @@ void CSMDoc::Operation::executeStage()
                 abort();
             }
 
-            ++mCurrentStepTotal;
-            break;
+            mCurrentStepTotal += steps;
+
+            if (std::chrono::steady_clock::now()>=end)
+                break;
         }
     }
 
@@ -131,6 +147,57 @@ void CSMDoc::Operation::executeStage()
         operationDone();
 }
 
+int CSMDoc::Operation::performParallel (Messages& messages)
+{
+    Stage& stage = *mCurrentStage->first;
+    const int first = mCurrentStep;
+    const int count = std::min (mCurrentStage->second-first, sParallelSteps*mThreads);
+    const int threadCount = std::min (mThreads, count);
+    mCurrentStep += count;
+
+    std::vector<Messages> threadMessages (threadCount, Messages (mDefaultSeverity));
+    std::vector<std::string> errors (threadCount);
+
+    auto performRange = [&] (int thread)
+    {
+        const int begin = first + count*thread/threadCount;
+        const int end = first + count*(thread+1)/threadCount;
+
+        try
+        {
+            for (int step=begin; step<end; ++step)
+                stage.perform (step, threadMessages[thread]);
+        }
+        catch (const std::exception& e)
+        {
+            errors[thread] = e.what();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve (threadCount-1);
+    for (int thread=1; thread<threadCount; ++thread)
+        threads.emplace_back (performRange, thread);
+
+    performRange (0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // each thread handled a consecutive range of steps, so this keeps the messages in step order
+    for (const Messages& results : threadMessages)
+        for (Messages::Iterator iter (results.begin()); iter!=results.end(); ++iter)
+            messages.add (iter->mId, iter->mMessage, iter->mHint, iter->mSeverity);
+
+    for (const std::string& error : errors)
+        if (!error.empty())
+            throw std::runtime_error (error);
+
+    stage.finishSteps (first, first+count, messages);
+
+    return count;
+}
+
 void CSMDoc::Operation::operationDone()
 {
     mTimer->stop();
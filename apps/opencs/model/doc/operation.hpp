@@ -36,9 +36,21 @@ namespace CSMDoc
             QTimer *mTimer;
             bool mPrepared;
             Message::Severity mDefaultSeverity;
+            int mThreads;
+
+            /// Time in milliseconds to perform steps for before giving control back to the event loop
+            static constexpr int sStepDuration = 50;
+
+            /// Number of steps each thread performs at once in a parallel stage
+            static constexpr int sParallelSteps = 256;
 
             void prepareStages();
 
+            int performParallel (Messages& messages);
+            ///< Perform the next steps of the current stage on several threads.
+            ///
+            /// \return number of steps performed
+
         public:
 
             Operation (int type, bool ordered, bool finalAlways = false);
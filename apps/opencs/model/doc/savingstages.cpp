@@ -1,5 +1,8 @@
 #include "savingstages.hpp"
 
+#include <memory>
+#include <sstream>
+
 #include <boost/filesystem.hpp>
 
 #include <components/esm3/loaddial.hpp>
@@ -79,6 +82,72 @@ void CSMDoc::WriteHeaderStage::perform (int stage, Messages& messages)
 }
 
 
+namespace
+{
+    // The encoder converts into an internal buffer, so every thread needs its own
+    struct RecordWriter
+    {
+        ToUTF8::FromType mEncoding;
+        ToUTF8::Utf8Encoder mEncoder;
+        std::ostringstream mStream;
+        ESM::ESMWriter mWriter;
+
+        RecordWriter (ToUTF8::FromType encoding) : mEncoding (encoding), mEncoder (encoding)
+        {
+            mWriter.setEncoder (&mEncoder);
+        }
+    };
+}
+
+CSMDoc::WriteRecordStage::WriteRecordStage (SavingState& state)
+: mState (state)
+{}
+
+int CSMDoc::WriteRecordStage::setup()
+{
+    mRecords.clear();
+    mRecords.resize (getSize());
+    return static_cast<int> (mRecords.size());
+}
+
+void CSMDoc::WriteRecordStage::perform (int stage, Messages& messages)
+{
+    thread_local std::unique_ptr<RecordWriter> recordWriter;
+
+    if (!recordWriter || recordWriter->mEncoding!=mState.getEncoding())
+        recordWriter = std::make_unique<RecordWriter> (mState.getEncoding());
+
+    ESM::ESMWriter& writer = recordWriter->mWriter;
+    recordWriter->mStream.str (std::string());
+    writer.setVersion (mState.getWriter().getVersion());
+    writer.saveRecords (recordWriter->mStream);
+
+    save (stage, writer);
+
+    writer.close();
+
+    if (recordWriter->mStream.tellp()>0)
+        mRecords[stage] = recordWriter->mStream.str();
+}
+
+bool CSMDoc::WriteRecordStage::isParallel() const
+{
+    return true;
+}
+
+void CSMDoc::WriteRecordStage::finishSteps (int begin, int end, Messages& messages)
+{
+    ESM::ESMWriter& writer = mState.getWriter();
+
+    for (int i=begin; i<end; ++i)
+        if (!mRecords[i].empty())
+        {
+            writer.writeRecord (mRecords[i]);
+            std::string().swap (mRecords[i]);
+        }
+}
+
+
 CSMDoc::WriteDialogueCollectionStage::WriteDialogueCollectionStage (Document& document,
     SavingState& state, bool journal)
 : mState (state),
@@ -171,17 +240,17 @@ void CSMDoc::WriteDialogueCollectionStage::perform (int stage, Messages& message
 
 
 CSMDoc::WriteRefIdCollectionStage::WriteRefIdCollectionStage (Document& document, SavingState& state)
-: mDocument (document), mState (state)
+: WriteRecordStage (state), mDocument (document)
 {}
 
-int CSMDoc::WriteRefIdCollectionStage::setup()
+int CSMDoc::WriteRefIdCollectionStage::getSize() const
 {
     return mDocument.getData().getReferenceables().getSize();
 }
 
-void CSMDoc::WriteRefIdCollectionStage::perform (int stage, Messages& messages)
+void CSMDoc::WriteRefIdCollectionStage::save (int index, ESM::ESMWriter& writer) const
 {
-    mDocument.getData().getReferenceables().save (stage, mState.getWriter());
+    mDocument.getData().getReferenceables().save (index, writer);
 }
 
 
@@ -394,19 +463,18 @@ void CSMDoc::WriteCellCollectionStage::perform (int stage, Messages& messages)
 
 CSMDoc::WritePathgridCollectionStage::WritePathgridCollectionStage (Document& document,
     SavingState& state)
-: mDocument (document), mState (state)
+: WriteRecordStage (state), mDocument (document)
 {}
 
-int CSMDoc::WritePathgridCollectionStage::setup()
+int CSMDoc::WritePathgridCollectionStage::getSize() const
 {
     return mDocument.getData().getPathgrids().getSize();
 }
 
-void CSMDoc::WritePathgridCollectionStage::perform (int stage, Messages& messages)
+void CSMDoc::WritePathgridCollectionStage::save (int index, ESM::ESMWriter& writer) const
 {
-    ESM::ESMWriter& writer = mState.getWriter();
     const CSMWorld::Record<CSMWorld::Pathgrid>& pathgrid =
-        mDocument.getData().getPathgrids().getRecord (stage);
+        mDocument.getData().getPathgrids().getRecord (index);
 
     if (pathgrid.isModified() || pathgrid.mState == CSMWorld::RecordBase::State_Deleted)
     {
@@ -430,19 +498,18 @@ void CSMDoc::WritePathgridCollectionStage::perform (int stage, Messages& message
 
 CSMDoc::WriteLandCollectionStage::WriteLandCollectionStage (Document& document,
     SavingState& state)
-: mDocument (document), mState (state)
+: WriteRecordStage (state), mDocument (document)
 {}
 
-int CSMDoc::WriteLandCollectionStage::setup()
+int CSMDoc::WriteLandCollectionStage::getSize() const
 {
     return mDocument.getData().getLand().getSize();
 }
 
-void CSMDoc::WriteLandCollectionStage::perform (int stage, Messages& messages)
+void CSMDoc::WriteLandCollectionStage::save (int index, ESM::ESMWriter& writer) const
 {
-    ESM::ESMWriter& writer = mState.getWriter();
     const CSMWorld::Record<CSMWorld::Land>& land =
-        mDocument.getData().getLand().getRecord (stage);
+        mDocument.getData().getLand().getRecord (index);
 
     if (land.isModified() || land.mState == CSMWorld::RecordBase::State_Deleted)
     {
@@ -456,19 +523,18 @@ void CSMDoc::WriteLandCollectionStage::perform (int stage, Messages& messages)
 
 CSMDoc::WriteLandTextureCollectionStage::WriteLandTextureCollectionStage (Document& document,
     SavingState& state)
-: mDocument (document), mState (state)
+: WriteRecordStage (state), mDocument (document)
 {}
 
-int CSMDoc::WriteLandTextureCollectionStage::setup()
+int CSMDoc::WriteLandTextureCollectionStage::getSize() const
 {
     return mDocument.getData().getLandTextures().getSize();
 }
 
-void CSMDoc::WriteLandTextureCollectionStage::perform (int stage, Messages& messages)
+void CSMDoc::WriteLandTextureCollectionStage::save (int index, ESM::ESMWriter& writer) const
 {
-    ESM::ESMWriter& writer = mState.getWriter();
     const CSMWorld::Record<CSMWorld::LandTexture>& landTexture =
-        mDocument.getData().getLandTextures().getRecord (stage);
+        mDocument.getData().getLandTextures().getRecord (index);
 
     if (landTexture.isModified() || landTexture.mState == CSMWorld::RecordBase::State_Deleted)
     {
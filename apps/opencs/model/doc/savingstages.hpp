@@ -1,6 +1,9 @@
 #ifndef CSM_DOC_SAVINGSTAGES_H
 #define CSM_DOC_SAVINGSTAGES_H
 
+#include <string>
+#include <vector>
+
 #include "stage.hpp"
 
 #include "../world/record.hpp"
@@ -63,51 +66,83 @@ namespace CSMDoc
     };
 
 
-    template<class CollectionT>
-    class WriteCollectionStage : public Stage
+    /// \brief Base class for stages that write at most one record per step
+    ///
+    /// The records are serialised on several threads into separate buffers, which are then
+    /// written to the file in step order.
+    class WriteRecordStage : public Stage
     {
-            const CollectionT& mCollection;
+            std::vector<std::string> mRecords;
+
+        protected:
+
             SavingState& mState;
-            CSMWorld::Scope mScope;
+
+            virtual int getSize() const = 0;
+            ///< \return number of records
+
+            virtual void save (int index, ESM::ESMWriter& writer) const = 0;
+            ///< Write record \a index to \a writer, if it needs to be saved.
+            ///
+            /// \note Called from several threads at the same time.
 
         public:
 
-            WriteCollectionStage (const CollectionT& collection, SavingState& state,
-                CSMWorld::Scope scope = CSMWorld::Scope_Content);
+            WriteRecordStage (SavingState& state);
 
             int setup() override;
             ///< \return number of steps
 
             void perform (int stage, Messages& messages) override;
             ///< Messages resulting from this stage will be appended to \a messages.
+
+            bool isParallel() const override;
+
+            void finishSteps (int begin, int end, Messages& messages) override;
+    };
+
+
+    template<class CollectionT>
+    class WriteCollectionStage : public WriteRecordStage
+    {
+            const CollectionT& mCollection;
+            CSMWorld::Scope mScope;
+
+            int getSize() const override;
+
+            void save (int index, ESM::ESMWriter& writer) const override;
+
+        public:
+
+            WriteCollectionStage (const CollectionT& collection, SavingState& state,
+                CSMWorld::Scope scope = CSMWorld::Scope_Content);
     };
 
     template<class CollectionT>
     WriteCollectionStage<CollectionT>::WriteCollectionStage (const CollectionT& collection,
         SavingState& state, CSMWorld::Scope scope)
-    : mCollection (collection), mState (state), mScope (scope)
+    : WriteRecordStage (state), mCollection (collection), mScope (scope)
     {}
 
     template<class CollectionT>
-    int WriteCollectionStage<CollectionT>::setup()
+    int WriteCollectionStage<CollectionT>::getSize() const
     {
         return mCollection.getSize();
     }
 
     template<class CollectionT>
-    void WriteCollectionStage<CollectionT>::perform (int stage, Messages& messages)
+    void WriteCollectionStage<CollectionT>::save (int index, ESM::ESMWriter& writer) const
     {
-        if (CSMWorld::getScopeFromId (mCollection.getRecord (stage).get().mId)!=mScope)
+        if (CSMWorld::getScopeFromId (mCollection.getRecord (index).get().mId)!=mScope)
             return;
 
-        ESM::ESMWriter& writer = mState.getWriter();
-        CSMWorld::RecordBase::State state = mCollection.getRecord (stage).mState;
-        typename CollectionT::ESXRecord record = mCollection.getRecord (stage).get();
+        CSMWorld::RecordBase::State state = mCollection.getRecord (index).mState;
 
         if (state == CSMWorld::RecordBase::State_Modified ||
             state == CSMWorld::RecordBase::State_ModifiedOnly ||
             state == CSMWorld::RecordBase::State_Deleted)
         {
+            typename CollectionT::ESXRecord record = mCollection.getRecord (index).get();
             writer.startRecord (record.sRecordId, record.mRecordFlags);
             record.save (writer, state == CSMWorld::RecordBase::State_Deleted);
             writer.endRecord (record.sRecordId);
@@ -133,20 +168,17 @@ namespace CSMDoc
     };
 
 
-    class WriteRefIdCollectionStage : public Stage
+    class WriteRefIdCollectionStage : public WriteRecordStage
     {
             Document& mDocument;
-            SavingState& mState;
 
-        public:
+            int getSize() const override;
 
-            WriteRefIdCollectionStage (Document& document, SavingState& state);
+            void save (int index, ESM::ESMWriter& writer) const override;
 
-            int setup() override;
-            ///< \return number of steps
+        public:
 
-            void perform (int stage, Messages& messages) override;
-            ///< Messages resulting from this stage will be appended to \a messages.
+            WriteRefIdCollectionStage (Document& document, SavingState& state);
     };
 
 
@@ -185,54 +217,45 @@ namespace CSMDoc
     };
 
 
-    class WritePathgridCollectionStage : public Stage
+    class WritePathgridCollectionStage : public WriteRecordStage
     {
             Document& mDocument;
-            SavingState& mState;
 
-        public:
+            int getSize() const override;
 
-            WritePathgridCollectionStage (Document& document, SavingState& state);
+            void save (int index, ESM::ESMWriter& writer) const override;
 
-            int setup() override;
-            ///< \return number of steps
+        public:
 
-            void perform (int stage, Messages& messages) override;
-            ///< Messages resulting from this stage will be appended to \a messages.
+            WritePathgridCollectionStage (Document& document, SavingState& state);
     };
 
 
-    class WriteLandCollectionStage : public Stage
+    class WriteLandCollectionStage : public WriteRecordStage
     {
             Document& mDocument;
-            SavingState& mState;
 
-        public:
+            int getSize() const override;
 
-            WriteLandCollectionStage (Document& document, SavingState& state);
+            void save (int index, ESM::ESMWriter& writer) const override;
 
-            int setup() override;
-            ///< \return number of steps
+        public:
 
-            void perform (int stage, Messages& messages) override;
-            ///< Messages resulting from this stage will be appended to \a messages.
+            WriteLandCollectionStage (Document& document, SavingState& state);
     };
 
 
-    class WriteLandTextureCollectionStage : public Stage
+    class WriteLandTextureCollectionStage : public WriteRecordStage
     {
             Document& mDocument;
-            SavingState& mState;
 
-        public:
+            int getSize() const override;
 
-            WriteLandTextureCollectionStage (Document& document, SavingState& state);
+            void save (int index, ESM::ESMWriter& writer) const override;
 
-            int setup() override;
-            ///< \return number of steps
+        public:
 
-            void perform (int stage, Messages& messages) override;
-            ///< Messages resulting from this stage will be appended to \a messages.
+            WriteLandTextureCollectionStage (Document& document, SavingState& state);
     };
 
     class CloseSaveStage : public Stage
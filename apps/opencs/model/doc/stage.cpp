@@ -1,3 +1,10 @@
 #include "stage.hpp"
 
 CSMDoc::Stage::~Stage() {}
+
+bool CSMDoc::Stage::isParallel() const
+{
+    return false;
+}
+
+void CSMDoc::Stage::finishSteps (int begin, int end, Messages& messages) {}
@@ -23,6 +23,15 @@ namespace CSMDoc
 
             virtual void perform (int stage, Messages& messages) = 0;
             ///< Messages resulting from this stage will be appended to \a messages.
+
+            virtual bool isParallel() const;
+            ///< Can perform() be called for several steps at the same time from different
+            /// threads? Steps are then not necessarily performed in order, but their messages are
+            /// still reported in order.
+
+            virtual void finishSteps (int begin, int end, Messages& messages);
+            ///< Called from the main thread after the steps from \a begin to \a end (exclusive) of a
+            /// parallel stage have been performed.
     };
 }
 
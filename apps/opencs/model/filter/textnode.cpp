@@ -9,8 +9,21 @@
 #include "../world/idtablebase.hpp"
 
 CSMFilter::TextNode::TextNode (int columnId, const std::string& text)
-: mColumnId (columnId), mText (text)
-{}
+: mColumnId (columnId), mText (text),
+  mRegExp (QString::fromUtf8 (text.c_str()), Qt::CaseInsensitive),
+  mHasEnums (CSMWorld::Columns::hasEnums (static_cast<CSMWorld::Columns::ColumnId> (columnId)))
+{
+    // tests run for every row of a table, so do not look up the enum names each time
+    if (mHasEnums)
+    {
+        std::vector<std::pair<int,std::string>> enums =
+            CSMWorld::Columns::getEnums (static_cast<CSMWorld::Columns::ColumnId> (columnId));
+
+        mEnums.reserve (enums.size());
+        for (const std::pair<int,std::string>& value : enums)
+            mEnums.push_back (QString::fromUtf8 (value.second.c_str()));
+    }
+}
 
 bool CSMFilter::TextNode::test (const CSMWorld::IdTableBase& table, int row,
     const std::map<int, int>& columns) const
@@ -33,16 +46,12 @@ bool CSMFilter::TextNode::test (const CSMWorld::IdTableBase& table, int row,
     {
         string = data.toString();
     }
-    else if ((data.type()==QVariant::Int || data.type()==QVariant::UInt) &&
-        CSMWorld::Columns::hasEnums (static_cast<CSMWorld::Columns::ColumnId> (mColumnId)))
+    else if ((data.type()==QVariant::Int || data.type()==QVariant::UInt) && mHasEnums)
     {
         int value = data.toInt();
 
-        std::vector<std::pair<int,std::string>> enums =
-            CSMWorld::Columns::getEnums (static_cast<CSMWorld::Columns::ColumnId> (mColumnId));
-
-        if (value>=0 && value<static_cast<int> (enums.size()))
-            string = QString::fromUtf8 (enums[value].second.c_str());
+        if (value>=0 && value<static_cast<int> (mEnums.size()))
+            string = mEnums[value];
     }
     else if (data.type()==QVariant::Bool)
     {
@@ -53,10 +62,7 @@ bool CSMFilter::TextNode::test (const CSMWorld::IdTableBase& table, int row,
     else
         return false;
 
-    /// \todo make pattern syntax configurable
-    QRegExp regExp (QString::fromUtf8 (mText.c_str()), Qt::CaseInsensitive);
-
-    return regExp.exactMatch (string);
+    return mRegExp.exactMatch (string);
 }
 
 std::vector<int> CSMFilter::TextNode::getReferencedColumns() const
@@ -1,6 +1,11 @@
 #ifndef CSM_FILTER_TEXTNODE_H
 #define CSM_FILTER_TEXTNODE_H
 
+#include <vector>
+
+#include <QRegExp>
+#include <QString>
+
 #include "leafnode.hpp"
 
 namespace CSMFilter
@@ -9,6 +14,9 @@ namespace CSMFilter
     {
             int mColumnId;
             std::string mText;
+            mutable QRegExp mRegExp; ///< \todo make pattern syntax configurable
+            bool mHasEnums;
+            std::vector<QString> mEnums;
 
         public:
 
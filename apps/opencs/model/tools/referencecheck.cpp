@@ -89,3 +89,8 @@ int CSMTools::ReferenceCheckStage::setup()
 
     return mReferences.getSize();
 }
+
+bool CSMTools::ReferenceCheckStage::isParallel() const
+{
+    return true;
+}
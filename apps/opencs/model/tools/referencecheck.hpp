@@ -16,6 +16,7 @@ namespace CSMTools
 
             void perform(int stage, CSMDoc::Messages& messages) override;
             int setup() override;
+            bool isParallel() const override;
 
         private:
             const CSMWorld::RefCollection& mReferences;
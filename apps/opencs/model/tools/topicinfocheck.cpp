@@ -76,6 +76,11 @@ int CSMTools::TopicInfoCheckStage::setup()
     return mTopicInfos.getSize();
 }
 
+bool CSMTools::TopicInfoCheckStage::isParallel() const
+{
+    return true;
+}
+
 void CSMTools::TopicInfoCheckStage::perform(int stage, CSMDoc::Messages& messages)
 {
     const CSMWorld::Record<CSMWorld::Info>& infoRecord = mTopicInfos.getRecord(stage);
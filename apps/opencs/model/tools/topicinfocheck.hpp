@@ -46,6 +46,8 @@ namespace CSMTools
         void perform(int step, CSMDoc::Messages& messages) override;
         ///< Messages resulting from this stage will be appended to \a messages
 
+        bool isParallel() const override;
+
     private:
 
         const CSMWorld::InfoCollection& mTopicInfos;
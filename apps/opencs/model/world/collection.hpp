@@ -10,6 +10,9 @@
 #include <functional>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
 
 #include <QVariant>
 
@@ -87,9 +90,26 @@ namespace CSMWorld
         private:
 
             std::vector<std::unique_ptr<Record<ESXRecordT> > > mRecords;
-            std::map<std::string, int> mIndex;
             std::vector<Column<ESXRecordT> *> mColumns;
 
+            // Lower case IDs to records. Records keep their address when rows are inserted or
+            // removed, so only the entries of the records that are added or erased change.
+            std::unordered_map<std::string, Record<ESXRecordT> *> mIndex;
+
+            // Rows of the records in mIndex. Rows from mFirstStaleRow on may have moved and are
+            // only updated when a row is looked up, so bulk changes renumber the rows once.
+            // Lookups may happen from several threads at once (parallel verifier stages), so the
+            // renumbering is done under mRowsMutex.
+            mutable std::unordered_map<const Record<ESXRecordT> *, int> mRows;
+            mutable std::atomic<int> mFirstStaleRow;
+            mutable std::mutex mRowsMutex;
+
+            int getRow (const Record<ESXRecordT> *record) const;
+
+            void invalidateRows (int index);
+
+            void replaceIndexed (int index, std::unique_ptr<Record<ESXRecordT> > record);
+
             // not implemented
             Collection (const Collection&);
             Collection& operator= (const Collection&);
@@ -235,11 +255,7 @@ namespace CSMWorld
 
             std::move (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
 
-            // adjust index
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
-                 ++iter)
-                if (iter->second>=baseIndex && iter->second<baseIndex+size)
-                    iter->second = newOrder.at (iter->second-baseIndex)+baseIndex;
+            invalidateRows (baseIndex);
         }
 
         return true;
@@ -318,8 +334,61 @@ namespace CSMWorld
         return false;
     }
 
+    template<typename ESXRecordT, typename IdAccessorT>
+    int Collection<ESXRecordT, IdAccessorT>::getRow (const Record<ESXRecordT> *record) const
+    {
+        int size = static_cast<int> (mRecords.size());
+
+        if (mFirstStaleRow.load (std::memory_order_acquire)<size)
+        {
+            std::lock_guard<std::mutex> lock (mRowsMutex);
+
+            int row = mFirstStaleRow.load (std::memory_order_relaxed);
+            for (; row<size; ++row)
+                mRows[mRecords[row].get()] = row;
+
+            mFirstStaleRow.store (row, std::memory_order_release);
+        }
+
+        typename std::unordered_map<const Record<ESXRecordT> *, int>::const_iterator iter = mRows.find (record);
+
+        if (iter==mRows.end())
+            return -1;
+
+        return iter->second;
+    }
+
+    template<typename ESXRecordT, typename IdAccessorT>
+    void Collection<ESXRecordT, IdAccessorT>::invalidateRows (int index)
+    {
+        if (index<mFirstStaleRow)
+            mFirstStaleRow = index;
+    }
+
+    template<typename ESXRecordT, typename IdAccessorT>
+    void Collection<ESXRecordT, IdAccessorT>::replaceIndexed (int index,
+        std::unique_ptr<Record<ESXRecordT> > record)
+    {
+        std::unique_ptr<Record<ESXRecordT> >& current = mRecords.at (index);
+
+        typename std::unordered_map<std::string, Record<ESXRecordT> *>::iterator iter =
+            mIndex.find (Misc::StringUtils::lowerCase (IdAccessorT().getId (current->get())));
+
+        if (iter!=mIndex.end() && iter->second==current.get())
+        {
+            iter->second = record.get();
+            mRows.erase (current.get());
+
+            if (index<mFirstStaleRow)
+                mRows[record.get()] = index;
+        }
+
+        current = std::move (record);
+    }
+
     template<typename ESXRecordT, typename IdAccessorT>
     Collection<ESXRecordT, IdAccessorT>::Collection()
+    : mFirstStaleRow (0)
     {}
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -334,7 +403,7 @@ namespace CSMWorld
     {
         std::string id = Misc::StringUtils::lowerCase (IdAccessorT().getId (record));
 
-        std::map<std::string, int>::iterator iter = mIndex.find (id);
+        typename std::unordered_map<std::string, Record<ESXRecordT> *>::iterator iter = mIndex.find (id);
 
         if (iter==mIndex.end())
         {
@@ -346,7 +415,7 @@ namespace CSMWorld
         }
         else
         {
-            mRecords[iter->second]->setModified (record);
+            iter->second->setModified (record);
         }
     }
 
@@ -429,7 +498,14 @@ namespace CSMWorld
         while (i<static_cast<int> (mRecords.size()))
         {
             if (mRecords[i]->isErased())
-                removeRows (i, 1);
+            {
+                // remove consecutive erased records together
+                int count = 1;
+                while (i+count<static_cast<int> (mRecords.size()) && mRecords[i+count]->isErased())
+                    ++count;
+
+                removeRows (i, count);
+            }
             else
                 ++i;
         }
@@ -438,27 +514,22 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::removeRows (int index, int count)
     {
-        mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
+        for (int i=index; i<index+count; ++i)
+        {
+            const Record<ESXRecordT> *record = mRecords.at (i).get();
 
-        typename std::map<std::string, int>::iterator iter = mIndex.begin();
+            typename std::unordered_map<std::string, Record<ESXRecordT> *>::iterator iter =
+                mIndex.find (Misc::StringUtils::lowerCase (IdAccessorT().getId (record->get())));
 
-        while (iter!=mIndex.end())
-        {
-            if (iter->second>=index)
-            {
-                if (iter->second>=index+count)
-                {
-                    iter->second -= count;
-                    ++iter;
-                }
-                else
-                {
-                    mIndex.erase (iter++);
-                }
-            }
-            else
-                ++iter;
+            if (iter!=mIndex.end() && iter->second==record)
+                mIndex.erase (iter);
+
+            mRows.erase (record);
         }
+
+        mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
+
+        invalidateRows (index);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -481,19 +552,19 @@ namespace CSMWorld
     {
         std::string id2 = Misc::StringUtils::lowerCase(id);
 
-        std::map<std::string, int>::const_iterator iter = mIndex.find (id2);
+        typename std::unordered_map<std::string, Record<ESXRecordT> *>::const_iterator iter = mIndex.find (id2);
 
         if (iter==mIndex.end())
             return -1;
 
-        return iter->second;
+        return getRow (iter->second);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::replace (int index, std::unique_ptr<RecordBase> record)
     {
         std::unique_ptr<Record<ESXRecordT> > tmp(static_cast<Record<ESXRecordT>*>(record.release()));
-        mRecords.at (index) = std::move(tmp);
+        replaceIndexed (index, std::move(tmp));
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -515,15 +586,26 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     std::vector<std::string> Collection<ESXRecordT, IdAccessorT>::getIds (bool listDeleted) const
     {
-        std::vector<std::string> ids;
+        // sort by the lower case ID, like the IDs are ordered in the index
+        std::vector<std::pair<const std::string *, const Record<ESXRecordT> *> > records;
+        records.reserve (mIndex.size());
 
-        for (typename std::map<std::string, int>::const_iterator iter = mIndex.begin();
+        for (typename std::unordered_map<std::string, Record<ESXRecordT> *>::const_iterator iter = mIndex.begin();
             iter!=mIndex.end(); ++iter)
         {
-            if (listDeleted || !mRecords[iter->second]->isDeleted())
-                ids.push_back (IdAccessorT().getId (mRecords[iter->second]->get()));
+            if (listDeleted || !iter->second->isDeleted())
+                records.emplace_back (&iter->first, iter->second);
         }
 
+        std::sort (records.begin(), records.end(),
+            [] (const auto& left, const auto& right) { return *left.first < *right.first; });
+
+        std::vector<std::string> ids;
+        ids.reserve (records.size());
+
+        for (const auto& record : records)
+            ids.push_back (IdAccessorT().getId (record.second->get()));
+
         return ids;
     }
 
@@ -551,21 +633,14 @@ namespace CSMWorld
         std::unique_ptr<Record<ESXRecordT> > record2(static_cast<Record<ESXRecordT>*>(record.release()));
         std::string lowerId = Misc::StringUtils::lowerCase(IdAccessorT().getId(record2->get()));
 
+        mIndex.insert (std::make_pair (lowerId, record2.get()));
+
         if (index == size)
             mRecords.push_back (std::move(record2));
         else
             mRecords.insert (mRecords.begin()+index, std::move(record2));
 
-        if (index < size-1)
-        {
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end(); ++iter)
-            {
-                if (iter->second >= index)
-                    ++(iter->second);
-            }
-        }
-
-        mIndex.insert (std::make_pair (lowerId, index));
+        invalidateRows (index);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -576,7 +651,7 @@ namespace CSMWorld
             Misc::StringUtils::lowerCase (IdAccessorT().getId (record->get())))
             throw std::runtime_error ("attempt to change the ID of a record");
 
-        mRecords.at (index) = std::move(record);
+        replaceIndexed (index, std::move(record));
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -54,6 +54,9 @@ CSMWorld::IdTableProxyModel::IdTableProxyModel (QObject *parent)
       mSourceModel(nullptr)
 {
     setSortCaseSensitivity (Qt::CaseInsensitive);
+
+    // re-test only the rows that change
+    setDynamicSortFilter (true);
 }
 
 QModelIndex CSMWorld::IdTableProxyModel::getModelIndex (const std::string& id, int column) const
@@ -128,9 +131,11 @@ void CSMWorld::IdTableProxyModel::refreshFilter()
     }
 }
 
+// The filter only depends on the values of a row, so there is no need to invalidate it when
+// rows change. QSortFilterProxyModel already tests inserted and changed rows on its own.
+
 void CSMWorld::IdTableProxyModel::sourceRowsInserted(const QModelIndex &parent, int /*start*/, int end)
 {
-    refreshFilter();
     if (!parent.isValid())
     {
         emit rowAdded(getRecordId(end).toUtf8().constData());
@@ -139,10 +144,8 @@ void CSMWorld::IdTableProxyModel::sourceRowsInserted(const QModelIndex &parent,
 
 void CSMWorld::IdTableProxyModel::sourceRowsRemoved(const QModelIndex &/*parent*/, int /*start*/, int /*end*/)
 {
-    refreshFilter();
 }
 
 void CSMWorld::IdTableProxyModel::sourceDataChanged(const QModelIndex &/*topLeft*/, const QModelIndex &/*bottomRight*/)
 {
-    refreshFilter();
 }
@@ -69,31 +69,32 @@ std::map<std::string, CSVRender::Object *>::iterator CSVRender::Cell::removeObje
     return iter;
 }
 
-bool CSVRender::Cell::addObjects (int start, int end)
+bool CSVRender::Cell::addObject (int index)
 {
-    bool modified = false;
+    const CSMWorld::Record<CSMWorld::CellRef>& record = mData.getReferences().getRecord (index);
 
-    const CSMWorld::RefCollection& collection = mData.getReferences();
+    if (record.mState==CSMWorld::RecordBase::State_Deleted ||
+        !Misc::StringUtils::ciEqual (record.get().mCell, mId))
+        return false;
 
-    for (int i=start; i<=end; ++i)
-    {
-        std::string cell = Misc::StringUtils::lowerCase (collection.getRecord (i).get().mCell);
+    std::string id = Misc::StringUtils::lowerCase (record.get().mId);
 
-        CSMWorld::RecordBase::State state = collection.getRecord (i).mState;
+    std::unique_ptr<Object> object (new Object (mData, mCellNode, id, false));
 
-        if (cell==mId && state!=CSMWorld::RecordBase::State_Deleted)
-        {
-            std::string id = Misc::StringUtils::lowerCase (collection.getRecord (i).get().mId);
+    if (mSubModeElementMask & Mask_Reference)
+        object->setSubMode (mSubMode);
 
-            std::unique_ptr<Object> object (new Object (mData, mCellNode, id, false));
+    mObjects.insert (std::make_pair (id, object.release()));
+    return true;
+}
 
-            if (mSubModeElementMask & Mask_Reference)
-                object->setSubMode (mSubMode);
+bool CSVRender::Cell::addObjects (int start, int end)
+{
+    bool modified = false;
 
-            mObjects.insert (std::make_pair (id, object.release()));
+    for (int i=start; i<=end; ++i)
+        if (addObject (i))
             modified = true;
-        }
-    }
 
     return modified;
 }
@@ -157,7 +158,7 @@ void  CSVRender::Cell::unloadLand()
 }
 
 CSVRender::Cell::Cell (CSMWorld::Data& data, osg::Group* rootNode, const std::string& id,
-    bool deleted)
+    bool deleted, const std::vector<int> *references)
 : mData (data), mId (Misc::StringUtils::lowerCase (id)), mDeleted (deleted), mSubMode (0),
   mSubModeElementMask (0), mUpdateLand(true), mLandDeleted(false)
 {
@@ -177,12 +178,17 @@ CSVRender::Cell::Cell (CSMWorld::Data& data, osg::Group* rootNode, const std::st
 
     if (!mDeleted)
     {
-        CSMWorld::IdTable& references = dynamic_cast<CSMWorld::IdTable&> (
-            *mData.getTableModel (CSMWorld::UniversalId::Type_References));
-
-        int rows = references.rowCount();
+        if (references)
+        {
+            for (int index : *references)
+                addObject (index);
+        }
+        else
+        {
+            int rows = mData.getReferences().getSize();
 
-        addObjects (0, rows-1);
+            addObjects (0, rows-1);
+        }
 
         updateLand();
 
@@ -71,6 +71,11 @@ namespace CSVRender
             std::map<std::string, Object *>::iterator removeObject (
                 std::map<std::string, Object *>::iterator iter);
 
+            /// Add the object of a row of the reference table, if it is within this cell.
+            ///
+            /// \return Has the object been added?
+            bool addObject (int index);
+
             /// Add objects from reference table that are within this cell.
             ///
             /// \return Have any objects been added?
@@ -92,8 +97,11 @@ namespace CSVRender
 
             /// \note Deleted covers both cells that are deleted and cells that don't exist in
             /// the first place.
+            ///
+            /// \param references Rows of the reference table that belong to this cell, if the
+            /// caller already knows them. Otherwise the whole table is searched.
             Cell (CSMWorld::Data& data, osg::Group* rootNode, const std::string& id,
-                bool deleted = false);
+                bool deleted = false, const std::vector<int> *references = nullptr);
 
             ~Cell();
 
@@ -3,11 +3,14 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <QMouseEvent>
 #include <QApplication>
 
 #include <components/misc/constants.hpp>
+#include <components/misc/stringops.hpp>
 
 #include "../../model/prefs/shortcut.hpp"
 
@@ -79,15 +82,45 @@ bool CSVRender::PagedWorldspaceWidget::adjustCells()
     }
 
     // add
+    std::vector<CSMWorld::CellCoordinates> added;
+
     for (CSMWorld::CellSelection::Iterator iter (mSelection.begin()); iter!=mSelection.end();
         ++iter)
-    {
         if (mCells.find (*iter)==mCells.end())
+            added.push_back (*iter);
+
+    if (added.size()>1)
+    {
+        // Sort the references into the new cells with a single pass over the reference table,
+        // instead of each cell searching the whole table for its own references.
+        std::unordered_map<std::string, std::vector<int> > references;
+
+        for (const CSMWorld::CellCoordinates& coordinates : added)
+            references[Misc::StringUtils::lowerCase (coordinates.getId (mWorldspace))];
+
+        const CSMWorld::RefCollection& collection = mDocument.getData().getReferences();
+
+        for (int i=0; i<collection.getSize(); ++i)
         {
-            addCellToScene (*iter);
-            modified = true;
+            std::unordered_map<std::string, std::vector<int> >::iterator cellReferences =
+                references.find (Misc::StringUtils::lowerCase (collection.getRecord (i).get().mCell));
+
+            if (cellReferences!=references.end())
+                cellReferences->second.push_back (i);
         }
+
+        for (const CSMWorld::CellCoordinates& coordinates : added)
+            addCellToScene (coordinates,
+                &references[Misc::StringUtils::lowerCase (coordinates.getId (mWorldspace))]);
     }
+    else
+    {
+        for (const CSMWorld::CellCoordinates& coordinates : added)
+            addCellToScene (coordinates);
+    }
+
+    if (!added.empty())
+        modified = true;
 
     if (modified)
     {
@@ -434,7 +467,7 @@ std::string CSVRender::PagedWorldspaceWidget::getStartupInstruction()
 }
 
 void CSVRender::PagedWorldspaceWidget::addCellToScene (
-    const CSMWorld::CellCoordinates& coordinates)
+    const CSMWorld::CellCoordinates& coordinates, const std::vector<int> *references)
 {
     const CSMWorld::IdCollection<CSMWorld::Cell>& cells = mDocument.getData().getCells();
 
@@ -445,7 +478,7 @@ void CSVRender::PagedWorldspaceWidget::addCellToScene (
 
     std::unique_ptr<Cell> cell (
         new Cell (mDocument.getData(), mRootNode, coordinates.getId (mWorldspace),
-        deleted));
+        deleted, references));
     EditMode *editMode = getEditMode();
     cell->setSubMode (editMode->getSubMode(), editMode->getInteractionMask());
 
@@ -62,7 +62,10 @@ namespace CSVRender
             std::string getStartupInstruction() override;
 
             /// \note Does not update the view or any cell marker
-            void addCellToScene (const CSMWorld::CellCoordinates& coordinates);
+            ///
+            /// \param references Rows of the reference table that belong to the cell, if known.
+            void addCellToScene (const CSMWorld::CellCoordinates& coordinates,
+                const std::vector<int> *references = nullptr);
 
             /// \note Does not update the view or any cell marker
             ///
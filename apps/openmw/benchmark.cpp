@@ -0,0 +1,263 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include <osg/Camera>
+#include <osg/Math>
+#include <osg/Stats>
+
+#include <components/debug/debuglog.hpp>
+
+#include "mwbase/environment.hpp"
+#include "mwbase/statemanager.hpp"
+#include "mwbase/world.hpp"
+
+#include "mwworld/ptr.hpp"
+#include "mwworld/refdata.hpp"
+
+namespace OMW
+{
+    namespace
+    {
+        constexpr double sNoValue = std::numeric_limits<double>::quiet_NaN();
+
+        float interpolateAngle(float from, float to, float factor)
+        {
+            const float pi = static_cast<float>(osg::PI);
+            float difference = std::fmod(to - from, 2 * pi);
+            if (difference > pi)
+                difference -= 2 * pi;
+            else if (difference < -pi)
+                difference += 2 * pi;
+            return from + difference * factor;
+        }
+
+        double getAttribute(osg::Stats& stats, unsigned int frameNumber, const std::string& name)
+        {
+            double value = 0;
+            if (!stats.getAttribute(frameNumber, name, value))
+                return sNoValue;
+            return value;
+        }
+
+        double getCameraAttribute(const osgViewer::ViewerBase::Cameras& cameras, unsigned int frameNumber, const std::string& name)
+        {
+            double result = sNoValue;
+            for (osg::Camera* camera : cameras)
+            {
+                double value = 0;
+                if (camera->getStats() != nullptr && camera->getStats()->getAttribute(frameNumber, name, value))
+                    result = std::isnan(result) ? value : result + value;
+            }
+            return result;
+        }
+
+        double getPercentile(const std::vector<double>& sorted, double percentile)
+        {
+            const std::size_t rank = static_cast<std::size_t>(std::ceil(percentile / 100 * sorted.size()));
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        }
+    }
+
+    std::vector<PathPoint> readPath(const std::string& path)
+    {
+        std::ifstream stream(path);
+        if (!stream.is_open())
+            throw std::runtime_error("Failed to open path file \"" + path + "\"");
+
+        std::vector<PathPoint> result;
+        std::string line;
+        for (std::size_t lineNumber = 1; std::getline(stream, line); ++lineNumber)
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream lineStream(line);
+            PathPoint point;
+            lineStream >> point.mTime
+                >> point.mPosition.x() >> point.mPosition.y() >> point.mPosition.z()
+                >> point.mRotation.x() >> point.mRotation.y() >> point.mRotation.z();
+            if (lineStream.fail())
+                throw std::runtime_error("Invalid path point at " + path + ":" + std::to_string(lineNumber));
+            if (!result.empty() && point.mTime < result.back().mTime)
+                throw std::runtime_error("Path point goes back in time at " + path + ":" + std::to_string(lineNumber));
+            result.push_back(point);
+        }
+
+        if (result.empty())
+            throw std::runtime_error("Path file \"" + path + "\" has no points");
+
+        return result;
+    }
+
+    PathRecorder::PathRecorder(const std::string& path)
+        : mStream(path)
+    {
+        if (!mStream.is_open())
+            throw std::runtime_error("Failed to open path file \"" + path + "\" for writing");
+        mStream << "# time x y z rotation-x rotation-y rotation-z\n" << std::setprecision(9);
+        Log(Debug::Info) << "Player path will be written to: " << path;
+    }
+
+    void PathRecorder::update(double dt)
+    {
+        if (MWBase::Environment::get().getStateManager()->getState() != MWBase::StateManager::State_Running)
+            return;
+
+        const ESM::Position& position = MWBase::Environment::get().getWorld()->getPlayerPtr().getRefData().getPosition();
+        mTime += dt;
+        mStream << mTime
+            << ' ' << position.pos[0] << ' ' << position.pos[1] << ' ' << position.pos[2]
+            << ' ' << position.rot[0] << ' ' << position.rot[1] << ' ' << position.rot[2] << '\n';
+    }
+
+    Benchmark::Benchmark(std::vector<PathPoint> path, double timeStep, std::vector<std::string> subsystems)
+        : mPath(std::move(path))
+        , mTimeStep(timeStep)
+        , mSubsystems(std::move(subsystems))
+        , mColumns {"frame", "update", "cull", "draw", "gpu"}
+    {
+        mColumns.insert(mColumns.end(), mSubsystems.begin(), mSubsystems.end());
+        mValues.resize(mColumns.size());
+    }
+
+    bool Benchmark::isFinished() const
+    {
+        return mStarted && mPath.front().mTime + mSteps * mTimeStep > mPath.back().mTime;
+    }
+
+    void Benchmark::update(unsigned int frameNumber)
+    {
+        if (!mStarted)
+        {
+            mStarted = true;
+            mFirstFrame = frameNumber;
+            Log(Debug::Info) << "Benchmark started at frame " << frameNumber;
+        }
+
+        const double time = std::min(mPath.front().mTime + mSteps * mTimeStep, mPath.back().mTime);
+        while (mPoint + 1 < mPath.size() && mPath[mPoint + 1].mTime <= time)
+            ++mPoint;
+
+        const PathPoint& from = mPath[mPoint];
+        const PathPoint& to = mPath[std::min(mPoint + 1, mPath.size() - 1)];
+        const float factor = to.mTime > from.mTime ? static_cast<float>((time - from.mTime) / (to.mTime - from.mTime)) : 0.f;
+
+        osg::Vec3f rotation;
+        for (int i = 0; i < 3; ++i)
+            rotation[i] = interpolateAngle(from.mRotation[i], to.mRotation[i], factor);
+
+        MWBase::World& world = *MWBase::Environment::get().getWorld();
+        const MWWorld::Ptr player = world.moveObject(world.getPlayerPtr(), from.mPosition + (to.mPosition - from.mPosition) * factor);
+        world.rotateObject(player, rotation, MWBase::RotationFlag_none);
+
+        ++mSteps;
+    }
+
+    void Benchmark::collect(unsigned int frameNumber, osg::Stats& viewerStats, const osgViewer::ViewerBase::Cameras& cameras)
+    {
+        if (!mStarted || frameNumber < mFirstFrame)
+            return;
+
+        mFrames.push_back(frameNumber);
+        mValues[0].push_back(getAttribute(viewerStats, frameNumber, "Frame duration"));
+        mValues[1].push_back(getAttribute(viewerStats, frameNumber, "Update traversal time taken"));
+        mValues[2].push_back(getCameraAttribute(cameras, frameNumber, "Cull traversal time taken"));
+        mValues[3].push_back(getCameraAttribute(cameras, frameNumber, "Draw traversal time taken"));
+        mValues[4].push_back(getCameraAttribute(cameras, frameNumber, "GPU draw time taken"));
+        for (std::size_t i = 0; i < mSubsystems.size(); ++i)
+            mValues[5 + i].push_back(getAttribute(viewerStats, frameNumber, mSubsystems[i] + "_time_taken"));
+    }
+
+    void Benchmark::writeCsv(std::ostream& stream) const
+    {
+        stream << "frame number";
+        for (const std::string& column : mColumns)
+            stream << ',' << column;
+        stream << '\n' << std::fixed << std::setprecision(3);
+        for (std::size_t frame = 0; frame < mFrames.size(); ++frame)
+        {
+            stream << mFrames[frame];
+            for (const std::vector<double>& values : mValues)
+            {
+                stream << ',';
+                if (!std::isnan(values[frame]))
+                    stream << values[frame] * 1000;
+            }
+            stream << '\n';
+        }
+    }
+
+    void Benchmark::writeSummary(std::ostream& stream) const
+    {
+        stream << "Benchmark of " << mFrames.size() << " frames, times in milliseconds:" << std::fixed << std::setprecision(3);
+        for (std::size_t i = 0; i < mColumns.size(); ++i)
+        {
+            std::vector<double> values;
+            std::copy_if(mValues[i].begin(), mValues[i].end(), std::back_inserter(values),
+                         [] (double value) { return !std::isnan(value); });
+            if (values.empty())
+                continue;
+            std::sort(values.begin(), values.end());
+            const double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+            stream << "\n    " << std::setw(10) << std::left << mColumns[i] << std::right
+                   << " mean " << mean * 1000
+                   << " p50 " << getPercentile(values, 50) * 1000
+                   << " p95 " << getPercentile(values, 95) * 1000
+                   << " p99 " << getPercentile(values, 99) * 1000
+                   << " max " << values.back() * 1000;
+        }
+    }
+
+    void Benchmark::enableStats(osgViewer::ViewerBase& viewer)
+    {
+        viewer.getViewerStats()->collectStats("frame_rate", true);
+        viewer.getViewerStats()->collectStats("update", true);
+        viewer.getViewerStats()->collectStats("engine", true);
+        osgViewer::ViewerBase::Cameras cameras;
+        viewer.getCameras(cameras);
+        for (osg::Camera* camera : cameras)
+        {
+            camera->getStats()->collectStats("rendering", true);
+            camera->getStats()->collectStats("gpu", true);
+        }
+    }
+
+    SimulationThroughput::SimulationThroughput(std::chrono::steady_clock::duration reportInterval)
+        : mReportInterval(reportInterval)
+        , mStart(Clock::now())
+        , mLastReport(mStart)
+    {
+    }
+
+    void SimulationThroughput::update(double dt)
+    {
+        mSimulationTime += dt;
+        ++mSteps;
+
+        const Clock::time_point now = Clock::now();
+        if (now - mLastReport < mReportInterval)
+            return;
+
+        const double wallTime = std::chrono::duration<double>(now - mLastReport).count();
+        Log(Debug::Info) << "Headless: " << std::fixed << std::setprecision(2)
+            << (mSimulationTime - mLastReportSimulationTime) / wallTime << " simulated seconds per second, "
+            << mSimulationTime << " simulated seconds in total";
+        mLastReport = now;
+        mLastReportSimulationTime = mSimulationTime;
+    }
+
+    void SimulationThroughput::writeSummary(std::ostream& stream) const
+    {
+        const double wallTime = std::chrono::duration<double>(Clock::now() - mStart).count();
+        stream << "Headless run of " << mSteps << " steps: " << std::fixed << std::setprecision(2)
+               << mSimulationTime << " simulated seconds in " << wallTime << " seconds, "
+               << (wallTime > 0 ? mSimulationTime / wallTime : 0.0) << " simulated seconds per second";
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef GAME_BENCHMARK_H
+#define GAME_BENCHMARK_H
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <osg/Vec3f>
+#include <osgViewer/ViewerBase>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace OMW
+{
+    /// Position and rotation of the player at a point in time, one line of a path file.
+    struct PathPoint
+    {
+        double mTime;
+        osg::Vec3f mPosition;
+        osg::Vec3f mRotation;
+    };
+
+    /// Read a path written by PathRecorder, throws if it can't be read.
+    std::vector<PathPoint> readPath(const std::string& path);
+
+    /// Writes the position and rotation of the player for each frame of the running game.
+    class PathRecorder
+    {
+        public:
+            explicit PathRecorder(const std::string& path);
+
+            void update(double dt);
+
+        private:
+            std::ofstream mStream;
+            double mTime = 0;
+    };
+
+    /// Moves the player along a recorded path at a fixed time step and collects the timings of the frames.
+    class Benchmark
+    {
+        public:
+            /// @param subsystems prefixes of the engine stats of the frame phases, added as columns
+            Benchmark(std::vector<PathPoint> path, double timeStep, std::vector<std::string> subsystems);
+
+            double getTimeStep() const { return mTimeStep; }
+
+            bool isFinished() const;
+
+            /// Move the player to the point of the path at the current time and advance the time by one step.
+            void update(unsigned int frameNumber);
+
+            /// Collect the timings of a frame once all of them are available, i.e. two frames later.
+            void collect(unsigned int frameNumber, osg::Stats& viewerStats, const osgViewer::ViewerBase::Cameras& cameras);
+
+            /// Write the timings of all collected frames as CSV, one frame per line in milliseconds.
+            void writeCsv(std::ostream& stream) const;
+
+            /// Write the mean, percentiles and maximum of each column.
+            void writeSummary(std::ostream& stream) const;
+
+            /// Enable the stats collected by the viewer, which are disabled unless the profiler is shown.
+            static void enableStats(osgViewer::ViewerBase& viewer);
+
+        private:
+            const std::vector<PathPoint> mPath;
+            const double mTimeStep;
+            const std::vector<std::string> mSubsystems;
+            std::vector<std::string> mColumns;
+            std::size_t mSteps = 0;
+            std::size_t mPoint = 0;
+            unsigned int mFirstFrame = 0;
+            bool mStarted = false;
+            std::vector<unsigned int> mFrames;
+            std::vector<std::vector<double>> mValues;
+    };
+
+    /// Measures how fast a headless run advances the game, in simulated seconds per wall clock second.
+    class SimulationThroughput
+    {
+        public:
+            /// @param reportInterval wall clock time between two progress lines in the log
+            explicit SimulationThroughput(std::chrono::steady_clock::duration reportInterval);
+
+            double getSimulationTime() const { return mSimulationTime; }
+
+            /// Count a simulation step of the given duration, log the throughput since the last report when due.
+            void update(double dt);
+
+            /// Write the simulated time, the wall clock time and the throughput of the whole run.
+            void writeSummary(std::ostream& stream) const;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            const Clock::duration mReportInterval;
+            const Clock::time_point mStart;
+            Clock::time_point mLastReport;
+            double mSimulationTime = 0;
+            double mLastReportSimulationTime = 0;
+            std::size_t mSteps = 0;
+    };
+}
+
+#endif
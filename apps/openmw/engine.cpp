@@ -1,11 +1,16 @@
 #include "engine.hpp"
+#include "benchmark.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <chrono>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
 #include <boost/filesystem/fstream.hpp>
 
+#include <osg/GLExtensions>
 #include <osg/Version>
 
 #include <osgViewer/ViewerEventHandlers>
@@ -15,8 +20,14 @@
 
 #include <components/debug/debuglog.hpp>
 #include <components/debug/gldebug.hpp>
+#include <components/debug/tracing.hpp>
 
+#include <components/misc/hash.hpp>
 #include <components/misc/rng.hpp>
+#include <components/misc/stringops.hpp>
+#include <components/misc/threadbudget.hpp>
+
+#include <components/bsa/compressedbsafile.hpp>
 
 #include <components/vfs/manager.hpp>
 #include <components/vfs/registerarchives.hpp>
@@ -32,7 +43,10 @@
 
 #include <components/sceneutil/workqueue.hpp>
 
+#include <components/shader/shadermanager.hpp>
+
 #include <components/files/configurationmanager.hpp>
+#include <components/files/diskcache.hpp>
 
 #include <components/version/version.hpp>
 
@@ -80,12 +94,14 @@ namespace
     struct UserStats
     {
         const std::string mLabel;
+        const std::string mName;
         const std::string mBegin;
         const std::string mEnd;
         const std::string mTaken;
 
         UserStats(const std::string& label, const std::string& prefix)
             : mLabel(label),
+              mName(prefix),
               mBegin(prefix + "_time_begin"),
               mEnd(prefix + "_time_end"),
               mTaken(prefix + "_time_taken")
@@ -174,7 +190,8 @@ namespace
     {
         public:
             ScopedProfile(osg::Timer_t frameStart, unsigned int frameNumber, const osg::Timer& timer, osg::Stats& stats)
-                : mScopeStart(timer.tick()),
+                : mTrace(UserStatsValue<sType>::sValue.mName),
+                  mScopeStart(timer.tick()),
                   mFrameStart(frameStart),
                   mFrameNumber(frameNumber),
                   mTimer(timer),
@@ -198,6 +215,7 @@ namespace
             }
 
         private:
+            const Debug::ScopedTrace mTrace;
             const osg::Timer_t mScopeStart;
             const osg::Timer_t mFrameStart;
             const unsigned int mFrameNumber;
@@ -241,16 +259,46 @@ namespace
     class IdentifyOpenGLOperation : public osg::GraphicsOperation
     {
     public:
-        IdentifyOpenGLOperation() : GraphicsOperation("IdentifyOpenGLOperation", false)
+        IdentifyOpenGLOperation(std::string& programBinaryDriverId)
+            : GraphicsOperation("IdentifyOpenGLOperation", false)
+            , mProgramBinaryDriverId(programBinaryDriverId)
         {}
 
         void operator()(osg::GraphicsContext* graphicsContext) override
         {
-            Log(Debug::Info) << "OpenGL Vendor: " << glGetString(GL_VENDOR);
-            Log(Debug::Info) << "OpenGL Renderer: " << glGetString(GL_RENDERER);
-            Log(Debug::Info) << "OpenGL Version: " << glGetString(GL_VERSION);
+            const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+            const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+            const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+            Log(Debug::Info) << "OpenGL Vendor: " << vendor;
+            Log(Debug::Info) << "OpenGL Renderer: " << renderer;
+            Log(Debug::Info) << "OpenGL Version: " << version;
+
+            if (vendor && renderer && version
+                && osg::isGLExtensionOrVersionSupported(graphicsContext->getState()->getContextID(), "GL_ARB_get_program_binary", 4.1f))
+                mProgramBinaryDriverId = std::string(vendor) + '\n' + renderer + '\n' + version;
         }
+
+    private:
+        std::string& mProgramBinaryDriverId;
     };
+
+    /// Changes when content files are added, removed, reordered or modified
+    std::uint64_t getContentFilesKey(const Files::Collections& collections, const std::vector<std::string>& contentFiles)
+    {
+        std::uint64_t key = 0;
+        for (const std::string& file : contentFiles)
+        {
+            Misc::hashCombine(key, Misc::StringUtils::lowerCase(file));
+            const Files::MultiDirCollection& collection = collections.getCollection(boost::filesystem::path(file).extension().string());
+            if (!collection.doesExist(file))
+                continue;
+            const boost::filesystem::path path = collection.getPath(file);
+            boost::system::error_code error;
+            Misc::hashCombine(key, static_cast<std::uint64_t>(boost::filesystem::file_size(path, error)));
+            Misc::hashCombine(key, static_cast<std::int64_t>(boost::filesystem::last_write_time(path, error)));
+        }
+        return key;
+    }
 }
 
 void OMW::Engine::executeLocalScripts()
@@ -269,6 +317,9 @@ void OMW::Engine::executeLocalScripts()
 
 bool OMW::Engine::frame(float frametime)
 {
+    Debug::Tracer::instance().beginFrame();
+    const Debug::ScopedTrace trace("frame");
+
     try
     {
         const osg::Timer_t frameStart = mViewer->getStartTick();
@@ -281,7 +332,7 @@ bool OMW::Engine::frame(float frametime)
         // update input
         {
             ScopedProfile<UserStatsType::Input> profile(frameStart, frameNumber, *timer, *stats);
-            mEnvironment.getInputManager()->update(frametime, false);
+            mEnvironment.getInputManager()->update(frametime, !mBenchmarkPathFile.empty() || mHeadless);
         }
 
         // When the window is minimized, pause the game. Currently this *has* to be here to work around a MyGUI bug.
@@ -290,7 +341,7 @@ bool OMW::Engine::frame(float frametime)
         {
             ScopedProfile<UserStatsType::Sound> profile(frameStart, frameNumber, *timer, *stats);
 
-            if (!mEnvironment.getWindowManager()->isWindowVisible())
+            if (!mHeadless && !mEnvironment.getWindowManager()->isWindowVisible())
             {
                 mEnvironment.getSoundManager()->pausePlayback();
                 return false;
@@ -395,16 +446,21 @@ bool OMW::Engine::frame(float frametime)
 
             mResourceSystem->reportStats(frameNumber, stats);
 
-            stats->setAttribute(frameNumber, "WorkQueue", mWorkQueue->getNumItems());
-            stats->setAttribute(frameNumber, "WorkThread", mWorkQueue->getNumActiveThreads());
+            mWorkQueue->reportStats(frameNumber, *stats);
 
             mEnvironment.reportStats(frameNumber, *stats);
+
+            stats->setAttribute(frameNumber, "Frame Arena", mFrameArena.getUsed());
+            stats->setAttribute(frameNumber, "Frame Arena Peak", mFrameArena.getHighWaterMark());
+
+            Misc::ThreadBudget::instance().reportStats(frameNumber, *stats);
         }
     }
     catch (const std::exception& e)
     {
         Log(Debug::Error) << "Error in frame: " << e.what();
     }
+    mFrameArena.reset();
     return true;
 }
 
@@ -428,6 +484,11 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mFSStrict (false)
   , mScriptBlacklistUse (true)
   , mNewGame (false)
+  , mBenchmarkFps (60)
+  , mHeadless (false)
+  , mHeadlessTickRate (60)
+  , mHeadlessDuration (0)
+  , mHeadlessRealtime (false)
   , mCfgMgr(configurationManager)
 {
     SDL_SetHint(SDL_HINT_ACCELEROMETER_AS_JOYSTICK, "0"); // We use only gamepads
@@ -538,7 +599,10 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
     }
 
     Uint32 flags = SDL_WINDOW_OPENGL|SDL_WINDOW_SHOWN|SDL_WINDOW_RESIZABLE;
-    if(fullscreen)
+    if (mHeadless)
+        // The renderer still needs a GL context to set up, but nothing is ever drawn into the window
+        flags = SDL_WINDOW_OPENGL|SDL_WINDOW_HIDDEN;
+    else if(fullscreen)
         flags |= SDL_WINDOW_FULLSCREEN;
 
     // Allows for Windows snapping features to properly work in borderless window
@@ -635,7 +699,7 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
 
     osg::ref_ptr<SceneUtil::OperationSequence> realizeOperations = new SceneUtil::OperationSequence(false);
     mViewer->setRealizeOperation(realizeOperations);
-    realizeOperations->add(new IdentifyOpenGLOperation());
+    realizeOperations->add(new IdentifyOpenGLOperation(mProgramBinaryDriverId));
 
     if (Debug::shouldDebugOpenGL())
         realizeOperations->add(new Debug::EnableGLDebugOperation());
@@ -671,17 +735,35 @@ void OMW::Engine::setWindowIcon()
 
 void OMW::Engine::prepareEngine (Settings::Manager & settings)
 {
+    Misc::ThreadBudget::instance().configure(
+        static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("worker threads", "General"))),
+        Settings::Manager::getString("worker thread shares", "General"),
+        Settings::Manager::getBool("pin worker threads", "General"));
+
     mEnvironment.setStateManager (
         std::make_unique<MWState::StateManager> (mCfgMgr.getUserDataPath() / "saves", mContentFiles));
 
-    createWindow(settings);
+    {
+        const Debug::ScopedTrace trace("Create window");
+        createWindow(settings);
+    }
 
     osg::ref_ptr<osg::Group> rootNode (new osg::Group);
     mViewer->setSceneData(rootNode);
 
+    Bsa::CompressedBSAFile::setCacheSize(static_cast<std::size_t>(
+        std::max(0, Settings::Manager::getInt("compressed archive cache size", "General"))) * 1024 * 1024);
+
     mVFS = std::make_unique<VFS::Manager>(mFSStrict);
 
-    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true);
+    {
+        const Debug::ScopedTrace trace("VFS::registerArchives");
+        std::string indexCachePath;
+        if (Settings::Manager::getBool("file index cache", "General"))
+            indexCachePath = (mCfgMgr.getCachePath() / "vfs").string();
+        VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true,
+            Settings::Manager::getBool("memory map archives", "General"), indexCachePath);
+    }
 
     mResourceSystem = std::make_unique<Resource::ResourceSystem>(mVFS.get());
     mResourceSystem->getSceneManager()->setUnRefImageDataAfterApply(false); // keep to Off for now to allow better state sharing
@@ -691,11 +773,23 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    mDiskCache = std::make_unique<Files::DiskCache>(mCfgMgr.getCachePath().string(), static_cast<std::uint64_t>(
+        std::max(0, Settings::Manager::getInt("disk cache size", "General"))) * 1024 * 1024);
+    if (Settings::Manager::getBool("optimized model cache", "Models"))
+        mResourceSystem->getSceneManager()->setOptimizedModelCache(mDiskCache.get());
 
-    int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
-    if (numThreads <= 0)
-        throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
-    mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+    if (Settings::Manager::getBool("shader cache", "Shaders") && !mProgramBinaryDriverId.empty())
+    {
+        Shader::ShaderManager& shaderManager = mResourceSystem->getSceneManager()->getShaderManager();
+        shaderManager.setProgramBinaryCache((mCfgMgr.getCachePath() / "shaders").string(), mProgramBinaryDriverId);
+        rootNode->addChild(shaderManager.getProgramBinarySaver());
+    }
+
+    const std::size_t numThreads = Misc::ThreadBudget::instance().getThreadCount(Misc::ThreadGroup::Preload,
+        Settings::Manager::getInt("preload num threads", "Cells"));
+    if (numThreads == 0)
+        throw std::runtime_error("Invalid setting: 'preload num threads' must be >0 or -1");
+    mWorkQueue = new SceneUtil::WorkQueue(numThreads, Misc::ThreadGroup::Preload);
 
     mScreenCaptureOperation = new SceneUtil::AsyncScreenCaptureOperation(
         mWorkQueue,
@@ -789,7 +883,8 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     auto windowMgr = std::make_unique<MWGui::WindowManager>(mWindow, mViewer, guiRoot, mResourceSystem.get(), mWorkQueue.get(),
                 mCfgMgr.getLogPath().string() + std::string("/"), myguiResources,
                 mScriptConsoleMode, mTranslationDataStorage, mEncoding, mExportFonts,
-                Version::getOpenmwVersionDescription(mResDir.string()), mCfgMgr.getUserConfigPath().string(), shadersSupported);
+                Version::getOpenmwVersionDescription(mResDir.string()), mCfgMgr.getUserConfigPath().string(),
+                mCfgMgr.getCachePath().string(), shadersSupported);
     auto* windowMgrInternal = windowMgr.get();
     mEnvironment.setWindowManager (std::move(windowMgr));
 
@@ -797,7 +892,10 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mEnvironment.setInputManager (std::move(inputMgr));
 
     // Create sound system
-    mEnvironment.setSoundManager (std::make_unique<MWSound::SoundManager>(mVFS.get(), mUseSound));
+    {
+        const Debug::ScopedTrace trace("Create sound manager");
+        mEnvironment.setSoundManager (std::make_unique<MWSound::SoundManager>(mVFS.get(), mUseSound));
+    }
 
     if (!mSkipMenu)
     {
@@ -807,18 +905,27 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     }
 
     // Create the world
-    mEnvironment.setWorld(std::make_unique<MWWorld::World>(mViewer, rootNode, mResourceSystem.get(), mWorkQueue.get(),
-        mFileCollections, mContentFiles, mGroundcoverFiles, mEncoder, mActivationDistanceOverride, mCellName,
-        mStartupScript, mResDir.string(), mCfgMgr.getUserDataPath().string()));
-    mEnvironment.getWorld()->setupPlayer();
+    {
+        const Debug::ScopedTrace trace("Create world");
+        mEnvironment.setWorld(std::make_unique<MWWorld::World>(mViewer, rootNode, mResourceSystem.get(), mWorkQueue.get(),
+            mFileCollections, mContentFiles, mGroundcoverFiles, mEncoder, mActivationDistanceOverride, mCellName,
+            mStartupScript, mResDir.string(), mCfgMgr.getUserDataPath().string(), mCfgMgr.getCachePath().string()));
+        mEnvironment.getWorld()->setupPlayer();
+    }
 
-    windowMgrInternal->setStore(mEnvironment.getWorld()->getStore());
-    windowMgrInternal->initUI();
+    {
+        const Debug::ScopedTrace trace("Initialize UI");
+        windowMgrInternal->setStore(mEnvironment.getWorld()->getStore());
+        windowMgrInternal->initUI();
+    }
 
     //Load translation data
-    mTranslationDataStorage.setEncoder(mEncoder);
-    for (size_t i = 0; i < mContentFiles.size(); i++)
-      mTranslationDataStorage.loadTranslationData(mFileCollections, mContentFiles[i]);
+    {
+        const Debug::ScopedTrace trace("Load translation data");
+        mTranslationDataStorage.setEncoder(mEncoder);
+        for (size_t i = 0; i < mContentFiles.size(); i++)
+          mTranslationDataStorage.loadTranslationData(mFileCollections, mContentFiles[i]);
+    }
 
     Compiler::registerExtensions (mExtensions);
 
@@ -826,8 +933,13 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
-    mEnvironment.setScriptManager (std::make_unique<MWScript::ScriptManager>(mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+    auto scriptManager = std::make_unique<MWScript::ScriptManager>(mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>());
+    if (Settings::Manager::getBool("script bytecode cache", "General"))
+        scriptManager->setBytecodeCache((mCfgMgr.getCachePath() / "scripts").string(), getContentFilesKey(mFileCollections, mContentFiles));
+    scriptManager->getProfiler().setCsvPath((mCfgMgr.getUserDataPath() / "scriptprofile.csv").string());
+    scriptManager->getProfiler().setEnabled(Settings::Manager::getBool("script profiler", "General"));
+    mEnvironment.setScriptManager(std::move(scriptManager));
 
     // Create game mechanics system
     mEnvironment.setMechanicsManager (std::make_unique<MWMechanics::MechanicsManager>());
@@ -836,6 +948,7 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mEnvironment.setJournal (std::make_unique<MWDialogue::Journal>());
     mEnvironment.setDialogueManager (std::make_unique<MWDialogue::DialogueManager>(mExtensions, mTranslationDataStorage));
     mEnvironment.setResourceSystem(mResourceSystem.get());
+    mEnvironment.setFrameArena(&mFrameArena);
 
     // scripts
     if (mCompileAll)
@@ -857,8 +970,11 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
                 << "%)";
     }
 
-    mLuaManager->init();
-    mLuaManager->loadPermanentStorage(mCfgMgr.getUserConfigPath().string());
+    {
+        const Debug::ScopedTrace trace("Initialize Lua");
+        mLuaManager->init();
+        mLuaManager->loadPermanentStorage(mCfgMgr.getUserConfigPath().string());
+    }
 }
 
 class OMW::Engine::LuaWorker
@@ -918,6 +1034,7 @@ private:
 
     void threadBody()
     {
+        Debug::Tracer::instance().setThreadName("Lua");
         while (true)
         {
             std::unique_lock<std::mutex> lk(mMutex);
@@ -953,10 +1070,20 @@ void OMW::Engine::go()
 
     Misc::Rng::init(mRandomSeed);
 
+    Debug::Tracer::instance().setThreadName("Main");
+    if (!mTraceFile.empty())
+        Debug::Tracer::instance().enable();
+
     // Load settings
     Settings::Manager settings;
     std::string settingspath = settings.load(mCfgMgr);
 
+    if (const int traceFrames = Settings::Manager::getInt("trace frames", "General"); traceFrames > 0)
+    {
+        Debug::Tracer::instance().setMaxFrames(static_cast<std::size_t>(traceFrames));
+        Debug::Tracer::instance().enable();
+    }
+
     MWClass::registerClasses();
 
     // Create encoder
@@ -973,7 +1100,10 @@ void OMW::Engine::go()
 
     mEnvironment.setFrameRateLimit(Settings::Manager::getFloat("framerate limit", "Video"));
 
-    prepareEngine (settings);
+    {
+        const Debug::ScopedTrace trace("OMW::Engine::prepareEngine");
+        prepareEngine (settings);
+    }
 
     std::ofstream stats;
     if (const auto path = std::getenv("OPENMW_OSG_STATS_FILE"))
@@ -998,6 +1128,23 @@ void OMW::Engine::go()
     if (stats.is_open())
         Resource::CollectStatistics(mViewer);
 
+    std::unique_ptr<PathRecorder> pathRecorder;
+    if (!mRecordPathFile.empty())
+        pathRecorder = std::make_unique<PathRecorder>(mRecordPathFile);
+
+    std::unique_ptr<Benchmark> benchmark;
+    if (!mBenchmarkPathFile.empty())
+    {
+        std::vector<std::string> subsystems;
+        forEachUserStatsValue([&] (const UserStats& v) { subsystems.push_back(v.mName); });
+        benchmark = std::make_unique<Benchmark>(readPath(mBenchmarkPathFile), 1.0 / mBenchmarkFps, std::move(subsystems));
+        Benchmark::enableStats(*mViewer);
+    }
+
+    std::unique_ptr<SimulationThroughput> throughput;
+    if (mHeadless)
+        throughput = std::make_unique<SimulationThroughput>(std::chrono::seconds(10));
+
     // Start the game
     if (!mSaveGameFile.empty())
     {
@@ -1026,17 +1173,31 @@ void OMW::Engine::go()
 
     // Start the main rendering loop
     double simulationTime = 0.0;
-    Misc::FrameRateLimiter frameRateLimiter = Misc::makeFrameRateLimiter(mEnvironment.getFrameRateLimit());
+    // A realtime headless run keeps one step per tick of the simulation
+    Misc::FrameRateLimiter frameRateLimiter = Misc::makeFrameRateLimiter(
+        mHeadless ? static_cast<float>(mHeadlessTickRate) : mEnvironment.getFrameRateLimit());
     const std::chrono::steady_clock::duration maxSimulationInterval(std::chrono::milliseconds(200));
     while (!mViewer->done() && !mEnvironment.getStateManager()->hasQuitRequest())
     {
-        const double dt = std::chrono::duration_cast<std::chrono::duration<double>>(std::min(
-            frameRateLimiter.getLastFrameDuration(),
-            maxSimulationInterval
-        )).count();
+        // A benchmark advances the simulation by fixed steps to see the same frames on every run, a headless run
+        // to make the simulated time independent of how fast the steps are computed
+        double dt = 0;
+        if (benchmark != nullptr)
+            dt = benchmark->getTimeStep();
+        else if (mHeadless)
+            dt = 1.0 / mHeadlessTickRate;
+        else
+            dt = std::chrono::duration_cast<std::chrono::duration<double>>(std::min(
+                frameRateLimiter.getLastFrameDuration(),
+                maxSimulationInterval
+            )).count();
 
         mViewer->advance(simulationTime);
 
+        if (benchmark != nullptr && !benchmark->isFinished()
+            && mEnvironment.getStateManager()->getState() == MWState::StateManager::State_Running)
+            benchmark->update(mViewer->getFrameStamp()->getFrameNumber());
+
         if (!frame(dt))
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
@@ -1051,29 +1212,65 @@ void OMW::Engine::go()
 
             luaWorker.allowUpdate();  // if there is a separate Lua thread, it starts the update now
 
-            mViewer->renderingTraversals();
+            if (!mHeadless)
+                mViewer->renderingTraversals();
 
             luaWorker.finishUpdate();
 
             bool guiActive = mEnvironment.getWindowManager()->isGuiMode();
             if (!guiActive)
+            {
                 simulationTime += dt;
+                if (pathRecorder != nullptr)
+                    pathRecorder->update(dt);
+                if (throughput != nullptr
+                    && mEnvironment.getStateManager()->getState() == MWState::StateManager::State_Running)
+                    throughput->update(dt);
+            }
         }
 
-        if (stats)
+        const auto frameNumber = mViewer->getFrameStamp()->getFrameNumber();
+        if ((stats || benchmark != nullptr) && frameNumber >= 2)
         {
-            const auto frameNumber = mViewer->getFrameStamp()->getFrameNumber();
-            if (frameNumber >= 2)
+            osgViewer::Viewer::Cameras cameras;
+            mViewer->getCameras(cameras);
+            if (stats)
             {
                 mViewer->getViewerStats()->report(stats, frameNumber - 2);
-                osgViewer::Viewer::Cameras cameras;
-                mViewer->getCameras(cameras);
                 for (auto camera : cameras)
                     camera->getStats()->report(stats, frameNumber - 2);
             }
+            if (benchmark != nullptr)
+                benchmark->collect(frameNumber - 2, *mViewer->getViewerStats(), cameras);
+        }
+
+        if (benchmark != nullptr && benchmark->isFinished())
+        {
+            const std::string csvPath = (mCfgMgr.getUserDataPath() / "benchmark.csv").string();
+            std::ofstream csv(csvPath);
+            benchmark->writeCsv(csv);
+            if (csv)
+                Log(Debug::Info) << "Benchmark frames written to: " << csvPath;
+            else
+                Log(Debug::Error) << "Failed to write benchmark frames to: " << csvPath;
+            std::ostringstream summary;
+            benchmark->writeSummary(summary);
+            Log(Debug::Info) << summary.str();
+            mEnvironment.getStateManager()->requestQuit();
         }
 
-        frameRateLimiter.limit();
+        if (throughput != nullptr && mHeadlessDuration > 0 && throughput->getSimulationTime() >= mHeadlessDuration)
+            mEnvironment.getStateManager()->requestQuit();
+
+        if (benchmark == nullptr && (!mHeadless || mHeadlessRealtime))
+            frameRateLimiter.limit();
+    }
+
+    if (throughput != nullptr)
+    {
+        std::ostringstream summary;
+        throughput->writeSummary(summary);
+        Log(Debug::Info) << summary.str();
     }
 
     luaWorker.join();
@@ -1082,6 +1279,9 @@ void OMW::Engine::go()
     settings.saveUser(settingspath);
     mLuaManager->savePermanentStorage(mCfgMgr.getUserConfigPath().string());
 
+    if (!mTraceFile.empty())
+        Debug::Tracer::instance().write(mTraceFile);
+
     Log(Debug::Info) << "Quitting peacefully.";
 }
 
@@ -1149,3 +1349,32 @@ void OMW::Engine::setRandomSeed(unsigned int seed)
 {
     mRandomSeed = seed;
 }
+
+void OMW::Engine::setTraceFile(const std::string& path)
+{
+    mTraceFile = path;
+}
+
+void OMW::Engine::setRecordPathFile(const std::string& path)
+{
+    mRecordPathFile = path;
+}
+
+void OMW::Engine::setBenchmark(const std::string& pathFile, unsigned int fps)
+{
+    mBenchmarkPathFile = pathFile;
+    mBenchmarkFps = std::max(fps, 1u);
+}
+
+void OMW::Engine::setHeadless(bool headless, unsigned int tickRate, double duration, bool realtime)
+{
+    mHeadless = headless;
+    mHeadlessTickRate = std::max(tickRate, 1u);
+    mHeadlessDuration = std::max(duration, 0.0);
+    mHeadlessRealtime = realtime;
+    if (mHeadless)
+    {
+        mUseSound = false;
+        mGrab = false;
+    }
+}
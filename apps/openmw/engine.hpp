@@ -5,6 +5,7 @@
 #include <components/files/collections.hpp>
 #include <components/translation/translation.hpp>
 #include <components/settings/settings.hpp>
+#include <components/misc/framearena.hpp>
 
 #include <osgViewer/Viewer>
 #include <osgViewer/ViewerEventHandlers>
@@ -42,6 +43,7 @@ namespace MWLua
 namespace Files
 {
     struct ConfigurationManager;
+    class DiskCache;
 }
 
 namespace osgViewer
@@ -58,8 +60,10 @@ namespace OMW
     {
             SDL_Window* mWindow;
             std::unique_ptr<VFS::Manager> mVFS;
+            std::unique_ptr<Files::DiskCache> mDiskCache;
             std::unique_ptr<Resource::ResourceSystem> mResourceSystem;
             osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+            Misc::FrameArena mFrameArena;
             MWBase::Environment mEnvironment;
             ToUTF8::FromType mEncoding;
             ToUTF8::Utf8Encoder* mEncoder;
@@ -87,6 +91,16 @@ namespace OMW
 
             bool mExportFonts;
             unsigned int mRandomSeed;
+            std::string mTraceFile;
+            std::string mRecordPathFile;
+            std::string mBenchmarkPathFile;
+            unsigned int mBenchmarkFps;
+            bool mHeadless;
+            unsigned int mHeadlessTickRate;
+            double mHeadlessDuration;
+            bool mHeadlessRealtime;
+            // Vendor, renderer and version of the OpenGL driver, empty if it can't load program binaries
+            std::string mProgramBinaryDriverId;
 
             Compiler::Extensions mExtensions;
             Compiler::Context *mScriptContext;
@@ -191,6 +205,23 @@ namespace OMW
 
             void setRandomSeed(unsigned int seed);
 
+            /// Record the durations of loading phases and write them to the given file on exit.
+            void setTraceFile(const std::string& path);
+
+            /// Write the position of the player in each frame to the given file.
+            void setRecordPathFile(const std::string& path);
+
+            /// Follow the player path in the given file at a fixed number of steps per second, write the frame
+            /// timings to the user data directory and quit.
+            void setBenchmark(const std::string& pathFile, unsigned int fps);
+
+            /// Run the game without showing the window, playing sounds, reading the controls or rendering frames.
+            /// The game advances by fixed steps and the throughput is logged in simulated seconds per second.
+            /// @param tickRate number of simulation steps per simulated second
+            /// @param duration simulated seconds to run before quitting, 0 to run until the game quits
+            /// @param realtime wait between the steps to keep up with the wall clock instead of running at full speed
+            void setHeadless(bool headless, unsigned int tickRate, double duration, bool realtime);
+
         private:
             Files::ConfigurationManager& mCfgMgr;
             class LuaWorker;
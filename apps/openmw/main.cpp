@@ -152,6 +152,14 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     engine.setActivationDistanceOverride (variables["activate-dist"].as<int>());
     engine.enableFontExport(variables["export-fonts"].as<bool>());
     engine.setRandomSeed(variables["random-seed"].as<unsigned int>());
+    engine.setTraceFile(variables["trace-file"].as<Files::MaybeQuotedPath>().string());
+    engine.setRecordPathFile(variables["record-path"].as<Files::MaybeQuotedPath>().string());
+    engine.setBenchmark(variables["benchmark"].as<Files::MaybeQuotedPath>().string(), variables["benchmark-fps"].as<unsigned int>());
+    engine.setHeadless(variables["headless"].as<bool>(), variables["headless-tick-rate"].as<unsigned int>(),
+                       variables["headless-duration"].as<double>(), variables["headless-realtime"].as<bool>());
+    if (variables["headless"].as<bool>() && !variables["skip-menu"].as<bool>()
+        && variables["load-savegame"].as<Files::MaybeQuotedPath>().empty())
+        Log(Debug::Warning) << "Warning: headless used without skip-menu or load-savegame -> the game stays in the main menu";
 
     return true;
 }
@@ -83,6 +83,11 @@ void MWBase::Environment::setResourceSystem (Resource::ResourceSystem *resourceS
     mResourceSystem = resourceSystem;
 }
 
+void MWBase::Environment::setFrameArena (Misc::FrameArena *frameArena)
+{
+    mFrameArena = frameArena;
+}
+
 void MWBase::Environment::setFrameDuration (float duration)
 {
     mFrameDuration = duration;
@@ -163,6 +168,12 @@ Resource::ResourceSystem *MWBase::Environment::getResourceSystem() const
     return mResourceSystem;
 }
 
+Misc::FrameArena *MWBase::Environment::getFrameArena() const
+{
+    assert (mFrameArena);
+    return mFrameArena;
+}
+
 float MWBase::Environment::getFrameDuration() const
 {
     return mFrameDuration;
@@ -181,6 +192,7 @@ void MWBase::Environment::cleanup()
     mStateManager.reset();
     mLuaManager.reset();
     mResourceSystem = nullptr;
+    mFrameArena = nullptr;
 }
 
 const MWBase::Environment& MWBase::Environment::get()
@@ -193,4 +205,5 @@ void MWBase::Environment::reportStats(unsigned int frameNumber, osg::Stats& stat
 {
     mMechanicsManager->reportStats(frameNumber, stats);
     mWorld->reportStats(frameNumber, stats);
+    mSoundManager->reportStats(frameNumber, stats);
 }
@@ -13,6 +13,11 @@ namespace Resource
     class ResourceSystem;
 }
 
+namespace Misc
+{
+    class FrameArena;
+}
+
 namespace MWBase
 {
     class World;
@@ -45,6 +50,7 @@ namespace MWBase
             std::unique_ptr<StateManager> mStateManager;
             std::unique_ptr<LuaManager> mLuaManager;
             Resource::ResourceSystem* mResourceSystem{};
+            Misc::FrameArena* mFrameArena{};
             float mFrameDuration{};
             float mFrameRateLimit{};
 
@@ -82,6 +88,8 @@ namespace MWBase
 
             void setResourceSystem (Resource::ResourceSystem *resourceSystem);
 
+            void setFrameArena (Misc::FrameArena *frameArena);
+
             void setFrameDuration (float duration);
             ///< Set length of current frame in seconds.
 
@@ -110,6 +118,9 @@ namespace MWBase
 
             Resource::ResourceSystem *getResourceSystem() const;
 
+            Misc::FrameArena *getFrameArena() const;
+            ///< Memory for containers used only during the current frame of the main thread, freed at its end.
+
             float getFrameDuration() const;
 
             void cleanup();
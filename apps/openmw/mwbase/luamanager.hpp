@@ -1,6 +1,7 @@
 #ifndef GAME_MWBASE_LUAMANAGER_H
 #define GAME_MWBASE_LUAMANAGER_H
 
+#include <string>
 #include <variant>
 #include <SDL_events.h>
 
@@ -64,6 +65,9 @@ namespace MWBase
 
         virtual ActorControls* getActorControls(const MWWorld::Ptr&) const = 0;
 
+        // Per-script memory usage and handler timings as text, empty if the Lua profiler is disabled
+        virtual std::string getProfilerReport() const = 0;
+
         virtual void clear() = 0;
         virtual void setupPlayer(const MWWorld::Ptr&) = 0;
 
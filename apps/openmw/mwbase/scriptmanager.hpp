@@ -1,6 +1,7 @@
 #ifndef GAME_MWBASE_SCRIPTMANAGER_H
 #define GAME_MWBASE_SCRIPTMANAGER_H
 
+#include <optional>
 #include <string>
 
 namespace Interpreter
@@ -12,11 +13,13 @@ namespace Compiler
 {
     class Extensions;
     class Locals;
+    enum class EventGate;
 }
 
 namespace MWScript
 {
     class GlobalScripts;
+    class ScriptProfiler;
 }
 
 namespace MWBase
@@ -52,8 +55,13 @@ namespace MWBase
             virtual const Compiler::Locals& getLocals (const std::string& name) = 0;
             ///< Return locals for script \a name.
 
+            virtual std::optional<Compiler::EventGate> getEventGate (const std::string& name) const = 0;
+            ///< Return the condition script \a name is gated on, if it has been compiled already.
+
             virtual MWScript::GlobalScripts& getGlobalScripts() = 0;
 
+            virtual MWScript::ScriptProfiler& getProfiler() = 0;
+
             virtual const Compiler::Extensions& getExtensions() const = 0;
    };
 }
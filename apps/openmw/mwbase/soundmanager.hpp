@@ -8,6 +8,11 @@
 #include "../mwworld/ptr.hpp"
 #include "../mwsound/type.hpp"
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace MWWorld
 {
     class CellStore;
@@ -23,6 +28,24 @@ namespace MWSound
         MaxCount
     };
 
+    // Cost of the audio, for the stats overlay and Lua
+    struct SoundStats
+    {
+        std::size_t mSources = 0;
+        std::size_t mStolenSources = 0;
+        std::size_t mStreams = 0;
+        std::size_t mStreamUnderruns = 0;
+        std::size_t mBuffers = 0;
+        std::size_t mPendingBuffers = 0;
+        std::size_t mBufferMemory = 0;
+        // Seconds spent loading sound buffers on the main thread in the current frame
+        double mLoadTime = 0;
+        // Seconds spent decoding sound buffers in the background since the previous frame
+        double mDecodeTime = 0;
+        // Seconds spent in the last SoundManager::update
+        double mUpdateTime = 0;
+    };
+
     class Sound;
     class Stream;
     struct Sound_Decoder;
@@ -145,6 +168,9 @@ namespace MWBase
                                        PlayMode mode=PlayMode::Normal, float offset=0) = 0;
             ///< Play a 3D sound at \a initialPos. If the sound should be moving, it must be updated using Sound::setPosition.
 
+            virtual void preloadSound(const std::string& soundId) = 0;
+            ///< Start loading a sound in the background, so it doesn't stall the game when it is played.
+
             virtual void stopSound(Sound *sound) = 0;
             ///< Stop the given sound from playing
 
@@ -183,6 +209,10 @@ namespace MWBase
             virtual void updatePtr(const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated) = 0;
 
             virtual void clear() = 0;
+
+            virtual MWSound::SoundStats getStats() const = 0;
+
+            virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) const = 0;
     };
 }
 
@@ -57,6 +57,7 @@ namespace ESM
 namespace MWPhysics
 {
     class RayCastingInterface;
+    struct ExpensiveActor;
 }
 
 namespace MWRender
@@ -82,6 +83,7 @@ namespace MWWorld
     class LocalScripts;
     class TimeStamp;
     class ESMStore;
+    class Globals;
     class RefData;
 
     typedef std::vector<std::pair<MWWorld::Ptr,MWMechanics::Movement> > PtrMovementList;
@@ -124,6 +126,10 @@ namespace MWBase
             virtual void readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap) = 0;
 
+            virtual void readCellStates (const ESM::ESMReader& file, std::vector<std::vector<char>>& records,
+                const std::map<int, int>& contentFileMap) = 0;
+            ///< Read REC_CSTA records taken from \a file with ESMReader::getRecordData, parsing them in parallel.
+
             virtual MWWorld::CellStore *getExterior (int x, int y) = 0;
 
             virtual MWWorld::CellStore *getInterior (const std::string& name) = 0;
@@ -183,6 +189,8 @@ namespace MWBase
             virtual char getGlobalVariableType (const std::string& name) const = 0;
             ///< Return ' ', if there is no global variable with this name.
 
+            virtual const MWWorld::Globals& getGlobalVariables() const = 0;
+
             virtual std::string getCellName (const MWWorld::CellStore *cell = nullptr) const = 0;
             ///< Return name of the cell.
             ///
@@ -319,6 +327,9 @@ namespace MWBase
 
             virtual const MWPhysics::RayCastingInterface* getRayCasting() const = 0;
 
+            /// @return actors which were the most expensive to move during the last frame
+            virtual std::vector<MWPhysics::ExpensiveActor> getExpensivePhysicsActors(std::size_t count) const = 0;
+
             virtual bool castRay (float x1, float y1, float z1, float x2, float y2, float z2, int mask) = 0;
             ///< cast a Ray and return true if there is an object in the ray path.
 
@@ -500,6 +511,8 @@ namespace MWBase
 
             /// \todo this does not belong here
             virtual void screenshot (osg::Image* image, int w, int h) = 0;
+            ///< Read the largest part of the frame with the aspect ratio of \a w and \a h into \a image.
+            /// \note The image is not scaled to \a w x \a h, that can be done outside of the main thread.
             virtual bool screenshot360 (osg::Image* image) = 0;
 
             /// Find default position inside exterior cell specified by name
@@ -628,6 +641,9 @@ namespace MWBase
             /// Return terrain height at \a worldPos position.
             virtual float getTerrainHeightAt(const osg::Vec3f& worldPos) const = 0;
 
+            /// Return terrain heights at many positions at once, faster than single queries for nearby positions.
+            virtual void getTerrainHeightsAt(const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights) const = 0;
+
             /// Return physical or rendering half extents of the given actor.
             virtual osg::Vec3f getHalfExtents(const MWWorld::ConstPtr& actor, bool rendering=false) const = 0;
 
@@ -635,6 +651,9 @@ namespace MWBase
             /// \param ptr object to export scene graph for (if empty, export entire scene graph)
             virtual std::string exportSceneGraph(const MWWorld::Ptr& ptr) = 0;
 
+            /// Write the phase timings recorded for the last frames to a file and return the filename.
+            virtual std::string writeFrameTrace() const = 0;
+
             /// Preload VFX associated with this effect list
             virtual void preloadEffects(const ESM::EffectList* effectList) = 0;
 
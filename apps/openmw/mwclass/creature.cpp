@@ -162,7 +162,7 @@ namespace MWClass
             getContainerStore(ptr).fill(ref->mBase->mInventory, ptr.getCellRef().getRefId());
 
             if (hasInventory)
-                getInventoryStore(ptr).autoEquip(ptr);
+                getInventoryStore(ptr).autoEquipInitialItems(ptr);
         }
     }
 
@@ -593,6 +593,21 @@ namespace MWClass
         return (ref->mBase->mRecordFlags & ESM::FLAG_Persistent) != 0;
     }
 
+    void Creature::getSoundsToPreload(const MWWorld::Ptr &ptr, std::vector<std::string> &sounds) const
+    {
+        MWWorld::LiveCellRef<ESM::Creature>* ref = ptr.get<ESM::Creature>();
+
+        const std::string& ourId = (ref->mBase->mOriginal.empty()) ? ptr.getCellRef().getRefId() : ref->mBase->mOriginal;
+
+        // Only the sound generators of the creature itself, the generic ones are shared and likely loaded already
+        const MWWorld::ESMStore &store = MWBase::Environment::get().getWorld()->getStore();
+        for (const ESM::SoundGenerator& sound : store.get<ESM::SoundGenerator>())
+        {
+            if (!sound.mCreature.empty() && Misc::StringUtils::ciEqual(ourId, sound.mCreature))
+                sounds.push_back(sound.mSound);
+        }
+    }
+
     std::string Creature::getSoundIdFromSndGen(const MWWorld::Ptr &ptr, const std::string &name) const
     {
         int type = getSndGenTypeFromName(ptr, name);
@@ -101,6 +101,8 @@ namespace MWClass
             std::string getModel(const MWWorld::ConstPtr &ptr) const override;
 
             void getModelsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& models) const override;
+
+            void getSoundsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& sounds) const override;
             ///< Get a list of models to preload that this object may use (directly or indirectly). default implementation: list getModel().
 
             bool isBipedal (const MWWorld::ConstPtr &ptr) const override;
@@ -396,7 +396,7 @@ namespace MWClass
             // setting ownership is used to make the NPC auto-equip his initial equipment only, and not bartered items
             getInventoryStore(ptr).fill(ref->mBase->mInventory, ptr.getCellRef().getRefId());
 
-            getInventoryStore(ptr).autoEquip(ptr);
+            getInventoryStore(ptr).autoEquipInitialItems(ptr);
         }
     }
 
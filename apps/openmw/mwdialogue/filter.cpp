@@ -1,5 +1,8 @@
 #include "filter.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+
 #include <components/compiler/locals.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -21,7 +24,76 @@
 
 #include "selectwrapper.hpp"
 
-bool MWDialogue::Filter::testActor (const ESM::DialInfo& info) const
+namespace
+{
+    struct TopicIndex
+    {
+        std::vector<const ESM::DialInfo*> mInfos;
+        // Positions in mInfos of the infos restricted to a speaker, by lower case speaker ID
+        std::unordered_map<std::string, std::vector<std::size_t>> mBySpeaker;
+        // Positions in mInfos of the infos without a speaker
+        std::vector<std::size_t> mAnySpeaker;
+        // Infos that passed the speaker conditions, by lower case speaker ID
+        std::unordered_map<std::string, std::vector<MWDialogue::Filter::Candidate>> mCandidates;
+    };
+
+    struct TopicIndices
+    {
+        const MWWorld::ESMStore* mStore = nullptr;
+        unsigned int mRevision = 0;
+        std::unordered_map<const ESM::Dialogue*, TopicIndex> mTopics;
+    };
+
+    // Limits the number of speakers we keep candidates for per topic
+    constexpr std::size_t sMaxCachedSpeakers = 256;
+
+    TopicIndex& getTopicIndex(const ESM::Dialogue& dialogue)
+    {
+        static TopicIndices indices;
+
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        if (indices.mStore != &store || indices.mRevision != store.getRevision())
+        {
+            indices.mStore = &store;
+            indices.mRevision = store.getRevision();
+            indices.mTopics.clear();
+        }
+
+        auto it = indices.mTopics.find(&dialogue);
+        if (it != indices.mTopics.end())
+            return it->second;
+
+        TopicIndex& index = indices.mTopics[&dialogue];
+        for (const ESM::DialInfo& info : dialogue.mInfo)
+        {
+            const std::size_t position = index.mInfos.size();
+            index.mInfos.push_back(&info);
+            if (info.mActor.empty())
+                index.mAnySpeaker.push_back(position);
+            else
+                index.mBySpeaker[Misc::StringUtils::lowerCase(info.mActor)].push_back(position);
+        }
+        return index;
+    }
+
+    // Conditions that only depend on the records of the speaker
+    bool isSpeakerSelect(const MWDialogue::SelectWrapper& select)
+    {
+        switch (select.getFunction())
+        {
+            case MWDialogue::SelectWrapper::Function_False:
+            case MWDialogue::SelectWrapper::Function_NotId:
+            case MWDialogue::SelectWrapper::Function_NotFaction:
+            case MWDialogue::SelectWrapper::Function_NotClass:
+            case MWDialogue::SelectWrapper::Function_NotRace:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+bool MWDialogue::Filter::testSpeaker (const ESM::DialInfo& info) const
 {
     bool isCreature = (mActor.getType() != ESM::NPC::sRecordId);
 
@@ -77,20 +149,6 @@ bool MWDialogue::Filter::testActor (const ESM::DialInfo& info) const
 
         if (!Misc::StringUtils::ciEqual(mActor.getClass().getPrimaryFaction(mActor), info.mFaction))
             return false;
-
-        // check rank
-        if (mActor.getClass().getPrimaryFactionRank(mActor) < info.mData.mRank)
-            return false;
-    }
-    else if (info.mData.mRank != -1)
-    {
-        if (isCreature)
-            return true;
-
-        // Rank requirement, but no faction given. Use the actor's faction, if there is one.
-        // check rank
-        if (mActor.getClass().getPrimaryFactionRank(mActor) < info.mData.mRank)
-            return false;
     }
 
     // Gender
@@ -104,6 +162,15 @@ bool MWDialogue::Filter::testActor (const ESM::DialInfo& info) const
     return true;
 }
 
+bool MWDialogue::Filter::testFactionRank (const ESM::DialInfo& info) const
+{
+    if (mActor.getType() != ESM::NPC::sRecordId || info.mFactionLess || info.mData.mRank == -1)
+        return true;
+
+    // If no faction is given, use the actor's faction, if there is one.
+    return mActor.getClass().getPrimaryFactionRank(mActor) >= info.mData.mRank;
+}
+
 bool MWDialogue::Filter::testPlayer (const ESM::DialInfo& info) const
 {
     const MWWorld::Ptr player = MWMechanics::getPlayer();
@@ -152,12 +219,62 @@ bool MWDialogue::Filter::testSelectStructs (const ESM::DialInfo& info) const
 {
     for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
         iter != info.mSelects.end(); ++iter)
-        if (!testSelectStruct (*iter))
+    {
+        const SelectWrapper select (*iter);
+        if (!isSpeakerSelect (select) && !testSelectStruct (select))
+            return false;
+    }
+
+    return true;
+}
+
+bool MWDialogue::Filter::testSpeakerSelectStructs (const ESM::DialInfo& info) const
+{
+    for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
+        iter != info.mSelects.end(); ++iter)
+    {
+        const SelectWrapper select (*iter);
+        if (isSpeakerSelect (select) && !testSelectStruct (select))
             return false;
+    }
 
     return true;
 }
 
+const std::vector<MWDialogue::Filter::Candidate>& MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    TopicIndex& index = getTopicIndex (dialogue);
+
+    const std::string speaker = Misc::StringUtils::lowerCase (mActor.getCellRef().getRefId());
+    auto found = index.mCandidates.find (speaker);
+    if (found != index.mCandidates.end())
+        return found->second;
+
+    if (index.mCandidates.size() >= sMaxCachedSpeakers)
+        index.mCandidates.clear();
+
+    std::vector<std::size_t> positions;
+    auto bySpeaker = index.mBySpeaker.find (speaker);
+    if (bySpeaker != index.mBySpeaker.end())
+        positions = bySpeaker->second;
+    // Creatures must not have topics aside of those specific to their id
+    if (mActor.getType() == ESM::NPC::sRecordId)
+    {
+        const std::size_t count = positions.size();
+        positions.insert (positions.end(), index.mAnySpeaker.begin(), index.mAnySpeaker.end());
+        std::inplace_merge (positions.begin(), positions.begin() + count, positions.end());
+    }
+
+    std::vector<Candidate>& candidates = index.mCandidates[speaker];
+    for (std::size_t position : positions)
+    {
+        const ESM::DialInfo& info = *index.mInfos[position];
+        if (testSpeaker (info))
+            candidates.push_back ({&info, testSpeakerSelectStructs (info)});
+    }
+    return candidates;
+}
+
 bool MWDialogue::Filter::testDisposition (const ESM::DialInfo& info, bool invert) const
 {
     bool isCreature = (mActor.getType() != ESM::NPC::sRecordId);
@@ -622,10 +739,10 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (const Candidate& candidate : getCandidates (dialogue))
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testFactionRank (*candidate.mInfo))
+            infos.push_back(candidate.mInfo);
     }
     return infos;
 }
@@ -638,13 +755,13 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
     bool infoRefusal = false;
 
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const Candidate& candidate : getCandidates (dialogue))
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo* info = candidate.mInfo;
+        if (candidate.mSelectsMatch && testFactionRank (*info) && testPlayer (*info) && testSelectStructs (*info))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (*info, invertDisposition)) {
+                infos.push_back(info);
                 if (!searchAll)
                     break;
             }
@@ -663,13 +780,16 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        for (const Candidate& candidate : getCandidates (infoRefusalDialogue))
+        {
+            const ESM::DialInfo* info = candidate.mInfo;
+            if (candidate.mSelectsMatch && testFactionRank (*info) && testPlayer (*info) && testSelectStructs (*info)
+                && testDisposition(*info, invertDisposition)) {
+                infos.push_back(info);
                 if (!searchAll)
                     break;
             }
+        }
     }
 
     return infos;
@@ -17,18 +17,38 @@ namespace MWDialogue
 
     class Filter
     {
+        public:
+
+            struct Candidate
+            {
+                const ESM::DialInfo* mInfo;
+                bool mSelectsMatch; ///< Result of testSpeakerSelectStructs
+            };
+
+        private:
+
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
 
-            bool testActor (const ESM::DialInfo& info) const;
-            ///< Is this the right actor for this \a info?
+            bool testSpeaker (const ESM::DialInfo& info) const;
+            ///< Do the records of the actor match the speaker conditions of \a info?
+
+            bool testFactionRank (const ESM::DialInfo& info) const;
+            ///< Is the faction rank of the actor high enough for \a info?
+
+            bool testSpeakerSelectStructs (const ESM::DialInfo& info) const;
+            ///< Are all select structs that only depend on the records of the actor matching?
+
+            const std::vector<Candidate>& getCandidates (const ESM::Dialogue& dialogue) const;
+            ///< Infos of \a dialogue that pass testSpeaker for the actor, in order.
+            /// \note The result is cached per topic and actor ID until the content of the ESM store changes.
 
             bool testPlayer (const ESM::DialInfo& info) const;
             ///< Do the player and the cell the player is currently in match \a info?
 
             bool testSelectStructs (const ESM::DialInfo& info) const;
-            ///< Are all select structs matching?
+            ///< Are all select structs matching? Select structs covered by testSpeakerSelectStructs are skipped.
 
             bool testDisposition (const ESM::DialInfo& info, bool invert=false) const;
             ///< Is the actor disposition toward the player high enough (or low enough, if \a invert is true)?
@@ -1,17 +1,21 @@
 #ifndef GAME_MWDIALOGUE_KEYWORDSEARCH_H
 #define GAME_MWDIALOGUE_KEYWORDSEARCH_H
 
-#include <cctype>
-#include <map>
+#include <array>
+#include <cstdint>
 #include <stdexcept>
 #include <vector>
-#include <algorithm>    // std::reverse
+#include <algorithm>
 
 #include <components/misc/stringops.hpp>
 
 namespace MWDialogue
 {
 
+/// \brief Case-insensitive search for a set of keywords in a text
+///
+/// The keywords are stored in a left-child right-sibling trie that is turned into an Aho-Corasick automaton
+/// the first time the keywords are highlighted after seeding, so a text is scanned in a single pass.
 template <typename string_t, typename value_t>
 class KeywordSearch
 {
@@ -26,46 +30,53 @@ public:
         value_t mValue;
     };
 
+    KeywordSearch ()
+    {
+        clear ();
+    }
+
     void seed (string_t keyword, value_t value)
     {
         if (keyword.empty())
             return;
-        seed_impl  (std::move(keyword), std::move (value), 0, mRoot);
+
+        std::uint32_t node = 0;
+        for (typename string_t::const_iterator i = keyword.begin(); i != keyword.end(); ++i)
+            node = insertChild (node, key (*i));
+
+        if (mNodes[node].mKeyword != sNone)
+            throw std::runtime_error ("duplicate keyword inserted");
+
+        mNodes[node].mKeyword = static_cast<std::uint32_t> (mKeywords.size());
+        mKeywords.push_back (Keyword {std::move (keyword), std::move (value)});
+        mLinksBuilt = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mNodes.assign (1, Node());
+        mRootChildren.fill (0);
+        mKeywords.clear ();
+        mFail.clear ();
+        mOutput.clear ();
+        mLinksBuilt = false;
     }
 
-    bool containsKeyword (const string_t& keyword, value_t& value)
+    bool containsKeyword (const string_t& keyword, value_t& value) const
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
-
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
-            return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
+        std::uint32_t node = 0;
+        for (typename string_t::const_iterator i = keyword.begin(); i != keyword.end(); ++i)
         {
-            value = current->second.mValue;
-            return true;
-        }
-
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
-        {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
+            node = findChild (node, key (*i));
+            if (node == 0)
                 return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
         }
-        return false;
+
+        if (mNodes[node].mKeyword == sNone)
+            return false;
+
+        value = mKeywords[mNodes[node].mKeyword].mValue;
+        return true;
     }
 
 
@@ -76,76 +87,54 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out) const
     {
-        std::vector<Match> matches;
-        for (Point i = beg; i != end; ++i)
-        {
-            // check first character
-            typename Entry::childen_t::const_iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
-
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
-                continue;
+        buildLinks ();
 
-            // see how far the match goes
-            Point j = i;
+        // the longest keyword starting at each position of the text
+        std::vector<std::uint32_t> longest (end - beg, sNone);
+        bool found = false;
 
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::const_iterator> > candidates;
+        std::uint32_t state = 0;
+        for (Point i = beg; i != end; ++i)
+        {
+            const unsigned char ch = key (*i);
 
-            while ((j + 1) != end)
+            std::uint32_t next = findChild (state, ch);
+            while (next == 0 && state != 0)
             {
-                typename Entry::childen_t::const_iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
-
-                if (next == candidate->second.mChildren.end ())
-                {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
-                    break;
-                }
-
-                candidate = next;
-
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                state = mFail[state];
+                next = findChild (state, ch);
             }
+            state = next;
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::const_iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
+            // every keyword ending here is a suffix of the current state
+            std::uint32_t output = mNodes[state].mKeyword != sNone ? state : mOutput[state];
+            for (; output != 0; output = mOutput[output])
             {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
+                const std::uint32_t keyword = mNodes[output].mKeyword;
+                const std::size_t start = (i - beg) + 1 - mKeywords[keyword].mKeyword.size();
+                if (longest[start] == sNone || mKeywords[longest[start]].mKeyword.size() < mKeywords[keyword].mKeyword.size())
+                    longest[start] = keyword;
+                found = true;
+            }
+        }
 
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
+        if (!found)
+            return;
 
-                    ++k, ++t;
-                }
+        // found keywords, but there might still be longer keywords that start somewhere _within_ them
+        // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
+        std::vector<Match> matches;
+        for (std::size_t i = 0; i < longest.size(); ++i)
+        {
+            if (longest[i] == sNone)
+                continue;
 
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
-
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
-            }
+            const Keyword& keyword = mKeywords[longest[i]];
+            Match match;
+            match.mValue = keyword.mValue;
+            match.mBeg = beg + i;
+            match.mEnd = match.mBeg + keyword.mKeyword.size();
+            matches.push_back(match);
         }
 
         // resolve overlapping keywords
@@ -192,54 +181,114 @@ public:
 
 private:
 
-    struct Entry
-    {
-        typedef std::map <wchar_t, Entry> childen_t;
+    static constexpr std::uint32_t sNone = UINT32_MAX;
 
+    struct Keyword
+    {
         string_t mKeyword;
         value_t mValue;
-        childen_t mChildren;
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    // Node 0 is the root, which is never a child, so 0 also means "no node"
+    struct Node
+    {
+        std::uint32_t mFirstChild = 0;
+        std::uint32_t mNextSibling = 0;
+        std::uint32_t mKeyword = sNone;
+        unsigned char mChar = 0;
+    };
+
+    static unsigned char key (typename string_t::value_type ch)
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
+        return static_cast<unsigned char> (Misc::StringUtils::toLower (ch));
+    }
 
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+    std::uint32_t findChild (std::uint32_t node, unsigned char ch) const
+    {
+        if (node == 0)
+            return mRootChildren[ch];
 
-        if (j == entry.mChildren.end ())
+        // siblings are sorted by character
+        for (std::uint32_t child = mNodes[node].mFirstChild; child != 0; child = mNodes[child].mNextSibling)
         {
-            entry.mChildren [ch].mValue = std::move (value);
-            entry.mChildren [ch].mKeyword = std::move (keyword);
+            if (mNodes[child].mChar >= ch)
+                return mNodes[child].mChar == ch ? child : 0;
         }
+        return 0;
+    }
+
+    std::uint32_t insertChild (std::uint32_t node, unsigned char ch)
+    {
+        std::uint32_t previous = 0;
+        std::uint32_t child = mNodes[node].mFirstChild;
+        for (; child != 0 && mNodes[child].mChar < ch; child = mNodes[child].mNextSibling)
+            previous = child;
+
+        if (child != 0 && mNodes[child].mChar == ch)
+            return child;
+
+        const std::uint32_t created = static_cast<std::uint32_t> (mNodes.size());
+        Node newNode;
+        newNode.mChar = ch;
+        newNode.mNextSibling = child;
+        mNodes.push_back (newNode);
+
+        if (previous == 0)
+            mNodes[node].mFirstChild = created;
         else
-        {
-            if (j->second.mKeyword.size () > 0)
-            {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
+            mNodes[previous].mNextSibling = created;
 
-                value_t pushValue = j->second.mValue;
-                string_t pushKeyword = j->second.mKeyword;
+        if (node == 0)
+            mRootChildren[ch] = created;
 
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
+        return created;
+    }
 
-                if (depth+1 < pushKeyword.size())
+    void buildLinks () const
+    {
+        if (mLinksBuilt)
+            return;
+
+        mFail.assign (mNodes.size(), 0);
+        mOutput.assign (mNodes.size(), 0);
+
+        // breadth first, so the links of shorter prefixes are known first
+        std::vector<std::uint32_t> queue;
+        queue.reserve (mNodes.size());
+        for (std::uint32_t child = mNodes[0].mFirstChild; child != 0; child = mNodes[child].mNextSibling)
+            queue.push_back (child);
+
+        for (std::size_t i = 0; i < queue.size(); ++i)
+        {
+            const std::uint32_t node = queue[i];
+            for (std::uint32_t child = mNodes[node].mFirstChild; child != 0; child = mNodes[child].mNextSibling)
+            {
+                const unsigned char ch = mNodes[child].mChar;
+                std::uint32_t fail = mFail[node];
+                std::uint32_t next = findChild (fail, ch);
+                while (next == 0 && fail != 0)
                 {
-                    seed_impl (std::move (pushKeyword), std::move (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
+                    fail = mFail[fail];
+                    next = findChild (fail, ch);
                 }
+
+                mFail[child] = next;
+                mOutput[child] = mNodes[next].mKeyword != sNone ? next : mOutput[next];
+                queue.push_back (child);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (std::move (keyword), std::move (value), depth+1, j->second);
         }
 
+        mLinksBuilt = true;
     }
 
-    Entry mRoot;
+    std::vector<Node> mNodes;
+    std::array<std::uint32_t, 256> mRootChildren;
+    std::vector<Keyword> mKeywords;
+
+    // Aho-Corasick links, built on demand
+    mutable std::vector<std::uint32_t> mFail;
+    mutable std::vector<std::uint32_t> mOutput;
+    mutable bool mLinksBuilt = false;
 };
 
 }
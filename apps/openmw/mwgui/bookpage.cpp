@@ -249,6 +249,18 @@ struct TypesetBookImpl::Typesetter : BookTypesetter
     Book::Content const * mCurrentContent;
     Alignment mCurrentAlignment;
 
+    struct RewindPoint
+    {
+        size_t mSections;
+        size_t mContents;
+        size_t mStyles;
+        MyGUI::IntRect mRect;
+        Book::Content const * mCurrentContent;
+        Alignment mCurrentAlignment;
+    };
+
+    std::optional <RewindPoint> mRewindPoint;
+
     Typesetter (size_t width, size_t height) :
         mPageWidth (width), mPageHeight(height),
         mSection (nullptr), mLine (nullptr), mRun (nullptr),
@@ -391,6 +403,8 @@ struct TypesetBookImpl::Typesetter : BookTypesetter
 
         add_partial_text();
 
+        mBook->mPages.clear ();
+
         std::vector <Alignment>::iterator sa = mSectionAlignment.begin ();
         for (Sections::iterator i = mBook->mSections.begin (); i != mBook->mSections.end (); ++i, ++sa)
         {
@@ -479,6 +493,41 @@ struct TypesetBookImpl::Typesetter : BookTypesetter
         return mBook;
     }
 
+    void setRewindPoint () override
+    {
+        add_partial_text();
+
+        mRun = nullptr;
+        mLine = nullptr;
+        mSection = nullptr;
+
+        mRewindPoint = RewindPoint { mBook->mSections.size (), mBook->mContents.size (), mBook->mStyles.size (),
+                                     mBook->mRect, mCurrentContent, mCurrentAlignment };
+    }
+
+    void rewind () override
+    {
+        assert (mRewindPoint);
+
+        mPartialWhitespace.clear ();
+        mPartialWord.clear ();
+
+        mRun = nullptr;
+        mLine = nullptr;
+        mSection = nullptr;
+
+        // Nothing before the rewind point refers to the sections, contents or styles added after it
+        mBook->mSections.resize (mRewindPoint->mSections);
+        mSectionAlignment.resize (mRewindPoint->mSections);
+        mBook->mContents.erase (std::next (mBook->mContents.begin (), mRewindPoint->mContents), mBook->mContents.end ());
+        mBook->mStyles.erase (std::next (mBook->mStyles.begin (), mRewindPoint->mStyles), mBook->mStyles.end ());
+        mBook->mPages.clear ();
+        mBook->mRect = mRewindPoint->mRect;
+
+        mCurrentContent = mRewindPoint->mCurrentContent;
+        mCurrentAlignment = mRewindPoint->mCurrentAlignment;
+    }
+
     void writeImpl (StyleImpl * style, Utf8Stream::Point _begin, Utf8Stream::Point _end)
     {
         Utf8Stream stream (_begin, _end);
@@ -145,6 +145,15 @@ namespace MWGui
 
         /// Finalize the document layout, and return a pointer to it.
         virtual TypesetBook::Ptr complete () = 0;
+
+        /// Remember the current position in the document and end the current
+        /// section. Everything written after it can be dropped by rewind, so a
+        /// document can be extended without laying it out again.
+        virtual void setRewindPoint () = 0;
+
+        /// Drop everything written after the rewind point. The document returned
+        /// by complete is changed in place and has to be completed again.
+        virtual void rewind () = 0;
     };
 
     /// An interface to the BookPage widget.
@@ -7,6 +7,69 @@
 
 #include <LinearMath/btQuickprof.h>
 
+#include <iomanip>
+#include <sstream>
+
+#include "../mwbase/environment.hpp"
+#include "../mwbase/luamanager.hpp"
+#include "../mwbase/scriptmanager.hpp"
+#include "../mwbase/world.hpp"
+
+#include "../mwphysics/actorcost.hpp"
+
+#include "../mwscript/scriptprofiler.hpp"
+
+#include "../mwworld/cellref.hpp"
+
+namespace
+{
+    void setEditText(MyGUI::EditBox* edit, const std::string& text)
+    {
+        if (edit->isTextSelection()) // pause updating while user is trying to copy text
+            return;
+
+        size_t previousPos = edit->getVScrollPosition();
+        edit->setCaption(text);
+        edit->setVScrollPosition(std::min(previousPos, edit->getVScrollRange()-1));
+    }
+
+    void dumpExpensiveActors(std::stringstream& os)
+    {
+        constexpr std::size_t count = 20;
+        os << std::left << std::setw(32) << "Actor" << std::right
+           << std::setw(10) << "Time (ms)" << std::setw(12) << "Iterations"
+           << std::setw(8) << "Steps" << std::setw(10) << "Contacts" << '\n';
+        for (const auto& [ptr, cost] : MWBase::Environment::get().getWorld()->getExpensivePhysicsActors(count))
+        {
+            os << std::left << std::setw(32) << ptr.getCellRef().getRefId() << std::right << std::fixed << std::setprecision(3)
+               << std::setw(10) << cost.mTime * 1000 << std::setw(12) << cost.mSolverIterations
+               << std::setw(8) << cost.mStepAttempts << std::setw(10) << cost.mContacts << '\n';
+        }
+    }
+
+    void dumpScriptProfile(std::stringstream& os)
+    {
+        const MWScript::ScriptProfiler& profiler = MWBase::Environment::get().getScriptManager()->getProfiler();
+        if (!profiler.isEnabled())
+        {
+            os << "Script profiler is off, enable it with the console command ToggleScriptProfiler.\n";
+            return;
+        }
+        profiler.report(os, 50);
+    }
+
+    void dumpLuaProfile(std::stringstream& os)
+    {
+        const std::string report = MWBase::Environment::get().getLuaManager()->getProfilerReport();
+        if (report.empty())
+        {
+            os << "Lua profiler is off, enable it with the setting 'lua profiler' in section [Lua].\n";
+            return;
+        }
+        os << report;
+    }
+}
+
 #ifndef BT_NO_PROFILE
 
 namespace
@@ -93,6 +156,18 @@ namespace MWGui
         mBulletProfilerEdit = item->createWidgetReal<MyGUI::EditBox>
                 ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
 
+        item = mTabControl->addItem("Physics Actors");
+        mPhysicsActorsEdit = item->createWidgetReal<MyGUI::EditBox>
+                ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
+
+        item = mTabControl->addItem("Script Profiler");
+        mScriptProfilerEdit = item->createWidgetReal<MyGUI::EditBox>
+                ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
+
+        item = mTabControl->addItem("Lua Profiler");
+        mLuaProfilerEdit = item->createWidgetReal<MyGUI::EditBox>
+                ("LogEdit", MyGUI::FloatCoord(0,0,1,1), MyGUI::Align::Stretch);
+
         MyGUI::IntSize viewSize = MyGUI::RenderManager::getInstance().getViewSize();
         mMainWidget->setSize(viewSize);
 
@@ -101,7 +176,6 @@ namespace MWGui
 
     void DebugWindow::onFrame(float dt)
     {
-#ifndef BT_NO_PROFILE
         if (!isVisible())
             return;
 
@@ -112,15 +186,22 @@ namespace MWGui
             return;
         timer = 1;
 
-        std::stringstream stream;
-        bulletDumpAll(stream);
+        std::stringstream actorsStream;
+        dumpExpensiveActors(actorsStream);
+        setEditText(mPhysicsActorsEdit, actorsStream.str());
 
-        if (mBulletProfilerEdit->isTextSelection()) // pause updating while user is trying to copy text
-            return;
+        std::stringstream scriptsStream;
+        dumpScriptProfile(scriptsStream);
+        setEditText(mScriptProfilerEdit, scriptsStream.str());
+
+        std::stringstream luaStream;
+        dumpLuaProfile(luaStream);
+        setEditText(mLuaProfilerEdit, luaStream.str());
 
-        size_t previousPos = mBulletProfilerEdit->getVScrollPosition();
-        mBulletProfilerEdit->setCaption(stream.str());
-        mBulletProfilerEdit->setVScrollPosition(std::min(previousPos, mBulletProfilerEdit->getVScrollRange()-1));
+#ifndef BT_NO_PROFILE
+        std::stringstream stream;
+        bulletDumpAll(stream);
+        setEditText(mBulletProfilerEdit, stream.str());
 #endif
     }
 
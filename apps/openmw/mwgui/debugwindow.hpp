@@ -17,6 +17,9 @@ namespace MWGui
         MyGUI::TabControl* mTabControl;
 
         MyGUI::EditBox* mBulletProfilerEdit;
+        MyGUI::EditBox* mPhysicsActorsEdit;
+        MyGUI::EditBox* mScriptProfilerEdit;
+        MyGUI::EditBox* mLuaProfilerEdit;
     };
 
 }
@@ -338,6 +338,7 @@ namespace MWGui
         if (mCurrentWindowSize == _sender->getSize()) return;
 
         mTopicsList->adjustSize();
+        mHistoryTypesetter.reset();
         updateHistory();
         updateTopicFormat();
         mCurrentWindowSize = _sender->getSize();
@@ -485,6 +486,7 @@ namespace MWGui
         for (DialogueText* text : mHistoryContents)
             delete text;
         mHistoryContents.clear();
+        mHistoryTypesetter.reset();
     }
 
     bool DialogueWindow::setKeywords(const std::list<std::string>& keyWords)
@@ -504,6 +506,8 @@ namespace MWGui
             mDeleteLater.push_back(linkPair.second);
         mTopicLinks.clear();
         mKeywordSearch.clear();
+        // The history refers to the old topic links
+        mHistoryTypesetter.reset();
 
         int services = mPtr.getClass().getServices(mPtr);
 
@@ -575,10 +579,23 @@ namespace MWGui
             mScrollBar->setVisible(true);
         }
 
-        BookTypesetter::Ptr typesetter = BookTypesetter::create (mHistory->getWidth(), std::numeric_limits<int>::max());
+        if (!mHistoryTypesetter || mTypesetWidth != mHistory->getWidth())
+        {
+            mHistoryTypesetter = BookTypesetter::create (mHistory->getWidth(), std::numeric_limits<int>::max());
+            mTypesetWidth = mHistory->getWidth();
+            mTypesetHistorySize = 0;
+        }
+        else
+            mHistoryTypesetter->rewind();
 
-        for (DialogueText* text : mHistoryContents)
-            text->write(typesetter, &mKeywordSearch, mTopicLinks);
+        BookTypesetter::Ptr typesetter = mHistoryTypesetter;
+
+        for (std::size_t i = mTypesetHistorySize; i < mHistoryContents.size(); ++i)
+            mHistoryContents[i]->write(typesetter, &mKeywordSearch, mTopicLinks);
+        mTypesetHistorySize = mHistoryContents.size();
+
+        // The choices are laid out again on every update
+        typesetter->setRewindPoint();
 
         BookTypesetter::Style* body = typesetter->createStyle("", MyGUI::Colour::White, false);
 
@@ -614,10 +631,14 @@ namespace MWGui
         }
 
         TypesetBook::Ptr book = typesetter->complete();
+        // The book is changed in place, so the page has to forget it first
+        mHistory->showPage(TypesetBook::Ptr(), 0);
         mHistory->showPage(book, 0);
         size_t viewHeight = mHistory->getParent()->getHeight();
         if (!scrollbar && book->getSize().second > viewHeight)
             updateHistory(true);
+        else if (scrollbar && book->getSize().second <= viewHeight)
+            updateHistory(false);
         else if (scrollbar)
         {
             mHistory->setSize(MyGUI::IntSize(mHistory->getWidth(), book->getSize().second));
@@ -683,13 +704,14 @@ namespace MWGui
     void DialogueWindow::addResponse(const std::string &title, const std::string &text, bool needMargin)
     {
         mHistoryContents.push_back(new Response(text, title, needMargin));
-        updateHistory();
+        // The history only grows, so a visible scrollbar is still needed
+        updateHistory(mScrollBar->getVisible());
     }
 
     void DialogueWindow::addMessageBox(const std::string& text)
     {
         mHistoryContents.push_back(new Message(text));
-        updateHistory();
+        updateHistory(mScrollBar->getVisible());
     }
 
     void DialogueWindow::updateDisposition()
@@ -737,7 +759,7 @@ namespace MWGui
 
         if (mChoices != MWBase::Environment::get().getDialogueManager()->getChoices()
                 || mGoodbye != MWBase::Environment::get().getDialogueManager()->isGoodbye())
-            updateHistory();
+            updateHistory(mScrollBar->getVisible());
     }
 
     void DialogueWindow::updateTopicFormat()
@@ -159,6 +159,10 @@ namespace MWGui
         std::list<std::string> mKeywords;
 
         std::vector<DialogueText*> mHistoryContents;
+        // Keeps the layout of the history, so new texts are appended to it instead of laying out everything again
+        BookTypesetter::Ptr mHistoryTypesetter;
+        std::size_t mTypesetHistorySize = 0;
+        int mTypesetWidth = 0;
         std::vector<std::pair<std::string, int> > mChoices;
         bool mGoodbye;
 
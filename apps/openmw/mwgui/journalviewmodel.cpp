@@ -1,7 +1,11 @@
 #include "journalviewmodel.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <map>
+#include <set>
 #include <sstream>
+#include <vector>
 
 #include <MyGUI_LanguageManager.h>
 
@@ -26,6 +30,17 @@ struct JournalViewModelImpl : JournalViewModel
     mutable bool             mKeywordSearchLoaded;
     mutable KeywordSearchT mKeywordSearch;
 
+    /// Positions of the journal entries by quest and by word, extended with the entries added since the last query.
+    struct JournalIndex
+    {
+        std::size_t mNumEntries = 0;
+        std::string mLastInfoId;
+        std::map<std::string, std::vector<std::size_t>> mQuestEntries; // quest id -> entries
+        std::map<std::string, std::vector<std::size_t>> mWordEntries; // lower case word -> entries
+    };
+
+    mutable JournalIndex mIndex;
+
     JournalViewModelImpl ()
     {
         mKeywordSearchLoaded = false;
@@ -69,6 +84,53 @@ struct JournalViewModelImpl : JournalViewModel
         }
     }
 
+    /// Splits the text into lower case words. Multibyte characters are considered letters.
+    static std::vector<std::string> splitWords (const std::string& text)
+    {
+        std::vector<std::string> words;
+        std::string word;
+        for (char c : text)
+        {
+            c = Misc::StringUtils::toLower(c);
+            if (static_cast<unsigned char>(c) >= 0x80 || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))
+                word += c;
+            else if (!word.empty())
+            {
+                words.push_back(std::move(word));
+                word.clear();
+            }
+        }
+        if (!word.empty())
+            words.push_back(std::move(word));
+        return words;
+    }
+
+    void ensureIndexUpdated () const
+    {
+        MWBase::Journal * journal = MWBase::Environment::get().getJournal();
+
+        // The journal only grows until it's cleared for a new game or a loaded one
+        const std::size_t numEntries = static_cast<std::size_t>(journal->end() - journal->begin());
+        if (numEntries < mIndex.mNumEntries
+            || (mIndex.mNumEntries > 0 && (journal->begin() + (mIndex.mNumEntries - 1))->mInfoId != mIndex.mLastInfoId))
+            mIndex = JournalIndex();
+
+        for (std::size_t i = mIndex.mNumEntries; i < numEntries; ++i)
+        {
+            const MWDialogue::StampedJournalEntry& entry = *(journal->begin() + i);
+            mIndex.mQuestEntries[entry.mTopic].push_back(i);
+
+            std::vector<std::string> words = splitWords(entry.getText());
+            std::sort(words.begin(), words.end());
+            words.erase(std::unique(words.begin(), words.end()), words.end());
+            for (std::string& word : words)
+                mIndex.mWordEntries[std::move(word)].push_back(i);
+
+            mIndex.mLastInfoId = entry.mInfoId;
+        }
+        mIndex.mNumEntries = numEntries;
+    }
+
     bool isEmpty () const override
     {
         MWBase::Journal * journal = MWBase::Environment::get().getJournal();
@@ -196,21 +258,20 @@ struct JournalViewModelImpl : JournalViewModel
     {
         MWBase::Journal * journal = MWBase::Environment::get ().getJournal ();
 
-        std::set<std::string> visitedQuests;
-
         // Note that for purposes of the journal GUI, quests are identified by the name, not the ID, so several
         // different quest IDs can end up in the same quest log. A quest log should be considered finished
         // when any quest ID in that log is finished.
+        std::map<std::string, bool> finishedQuests;
+        for (MWBase::Journal::TQuestIter i = journal->questBegin (); i != journal->questEnd (); ++i)
+            finishedQuests[i->second.getName()] |= i->second.isFinished();
+
+        std::set<std::string> visitedQuests;
+
         for (MWBase::Journal::TQuestIter i = journal->questBegin (); i != journal->questEnd (); ++i)
         {
             const MWDialogue::Quest& quest = i->second;
 
-            bool isFinished = false;
-            for (MWBase::Journal::TQuestIter j = journal->questBegin (); j != journal->questEnd (); ++j)
-            {
-                if (quest.getName() == j->second.getName() && j->second.isFinished())
-                    isFinished = true;
-            }
+            bool isFinished = finishedQuests[quest.getName()];
 
             if (active_only && isFinished)
                 continue;
@@ -221,12 +282,10 @@ struct JournalViewModelImpl : JournalViewModel
             if (!quest.getName().empty())
             {
                 // Don't list the same quest name twice
-                if (visitedQuests.find(quest.getName()) != visitedQuests.end())
+                if (!visitedQuests.insert(quest.getName()).second)
                     continue;
 
                 visitor (quest.getName(), isFinished);
-
-                visitedQuests.insert(quest.getName());
             }
         }
     }
@@ -273,25 +332,21 @@ struct JournalViewModelImpl : JournalViewModel
 
         if (!questName.empty())
         {
-            std::vector<MWDialogue::Quest const*> quests;
+            ensureIndexUpdated ();
+
+            std::vector<std::size_t> entries;
             for (MWBase::Journal::TQuestIter questIt = journal->questBegin(); questIt != journal->questEnd(); ++questIt)
             {
-                if (Misc::StringUtils::ciEqual(questIt->second.getName(), questName))
-                    quests.push_back(&questIt->second);
+                if (!Misc::StringUtils::ciEqual(questIt->second.getName(), questName))
+                    continue;
+                const auto found = mIndex.mQuestEntries.find(questIt->first);
+                if (found != mIndex.mQuestEntries.end())
+                    entries.insert(entries.end(), found->second.begin(), found->second.end());
             }
+            std::sort(entries.begin(), entries.end());
 
-            for(MWBase::Journal::TEntryIter i = journal->begin(); i != journal->end (); ++i)
-            {
-                for (std::vector<MWDialogue::Quest const*>::iterator questIt = quests.begin(); questIt != quests.end(); ++questIt)
-                {
-                    MWDialogue::Quest const* quest = *questIt;
-                    for (MWDialogue::Topic::TEntryIter j = quest->begin (); j != quest->end (); ++j)
-                    {
-                        if (i->mInfoId == j->mInfoId)
-                            visitor (JournalEntryImpl <MWBase::Journal::TEntryIter> (this, i));
-                    }
-                }
-            }
+            for (std::size_t entry : entries)
+                visitor (JournalEntryImpl <MWBase::Journal::TEntryIter> (this, journal->begin() + entry));
         }
         else
         {
@@ -300,6 +355,45 @@ struct JournalViewModelImpl : JournalViewModel
         }
     }
 
+    void visitJournalEntriesContaining (const std::string& text, std::function <void (JournalEntry const &)> visitor) const override
+    {
+        MWBase::Journal * journal = MWBase::Environment::get().getJournal();
+
+        ensureIndexUpdated ();
+
+        const std::vector<std::string> words = splitWords(text);
+        if (words.empty())
+            return;
+
+        std::vector<std::size_t> entries;
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            // entries with any word starting with this one
+            std::vector<std::size_t> wordEntries;
+            for (auto it = mIndex.mWordEntries.lower_bound(words[i]);
+                 it != mIndex.mWordEntries.end() && it->first.compare(0, words[i].size(), words[i]) == 0; ++it)
+                wordEntries.insert(wordEntries.end(), it->second.begin(), it->second.end());
+            std::sort(wordEntries.begin(), wordEntries.end());
+            wordEntries.erase(std::unique(wordEntries.begin(), wordEntries.end()), wordEntries.end());
+
+            if (i == 0)
+                entries = std::move(wordEntries);
+            else
+            {
+                std::vector<std::size_t> both;
+                std::set_intersection(entries.begin(), entries.end(), wordEntries.begin(), wordEntries.end(),
+                    std::back_inserter(both));
+                entries = std::move(both);
+            }
+
+            if (entries.empty())
+                return;
+        }
+
+        for (std::size_t entry : entries)
+            visitor (JournalEntryImpl <MWBase::Journal::TEntryIter> (this, journal->begin() + entry));
+    }
+
     void visitTopicName (TopicId topicId, std::function <void (Utf8Span)> visitor) const override
     {
         MWDialogue::Topic const & topic = * reinterpret_cast <MWDialogue::Topic const *> (topicId);
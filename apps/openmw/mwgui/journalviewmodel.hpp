@@ -79,6 +79,9 @@ namespace MWGui
         /// If \a questName is empty, simply visits all journal entries
         virtual void visitJournalEntries (const std::string& questName, std::function <void (JournalEntry const &)> visitor) const = 0;
 
+        /// walks over the journal entries containing a word starting with each word of the text, ignoring case
+        virtual void visitJournalEntriesContaining (const std::string& text, std::function <void (JournalEntry const &)> visitor) const = 0;
+
         /// provides the name of the topic specified by its id
         virtual void visitTopicName (TopicId topicId, std::function <void (Utf8Span)> visitor) const = 0;
 
@@ -749,7 +749,8 @@ namespace MWGui
     }
 
     // ------------------------------------------------------------------------------------------
-    MapWindow::MapWindow(CustomMarkerCollection &customMarkers, DragAndDrop* drag, MWRender::LocalMap* localMapRender, SceneUtil::WorkQueue* workQueue)
+    MapWindow::MapWindow(CustomMarkerCollection &customMarkers, DragAndDrop* drag, MWRender::LocalMap* localMapRender, SceneUtil::WorkQueue* workQueue,
+                         const std::string& cachePath)
         : WindowPinnableBase("openmw_map_window.layout")
         , LocalMapBase(customMarkers, localMapRender)
         , NoDrop(drag, mMainWidget)
@@ -769,6 +770,9 @@ namespace MWGui
             registered = true;
         }
 
+        if (Settings::Manager::getBool("global map cache", "Map"))
+            mGlobalMapRender->setCachePath(cachePath + "/globalmap");
+
         mEditNoteDialog.setVisible(false);
         mEditNoteDialog.eventOkClicked += MyGUI::newDelegate(this, &MapWindow::onNoteEditOk);
         mEditNoteDialog.eventDeleteClicked += MyGUI::newDelegate(this, &MapWindow::onNoteEditDelete);
@@ -1109,6 +1113,7 @@ namespace MWGui
     void MapWindow::cellExplored(int x, int y)
     {
         mGlobalMapRender->cleanupCameras();
+        mLocalMapRender->flushExteriorMap(x, y);
         mGlobalMapRender->exploreCell(x, y, mLocalMapRender->getMapTexture(x, y));
     }
 
@@ -431,8 +431,10 @@ namespace MWGui
 
 
         // Decode screenshot
-        const std::vector<char>& data = mCurrentSlot->mProfile.mScreenshot;
-        Files::IMemStream instream (&data[0], data.size());
+        const std::vector<char> data = MWState::getScreenshot(*mCurrentSlot);
+        if (data.empty())
+            return;
+        Files::IMemStream instream (data.data(), data.size());
 
         osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
         if (!readerwriter)
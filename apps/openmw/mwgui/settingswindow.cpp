@@ -674,10 +674,11 @@ namespace MWGui
 
         mLightingMethodButton->removeAllItems();
 
-        std::array<SceneUtil::LightingMethod, 3> methods = {
+        std::array<SceneUtil::LightingMethod, 4> methods = {
             SceneUtil::LightingMethod::FFP,
             SceneUtil::LightingMethod::PerObjectUniform,
             SceneUtil::LightingMethod::SingleUBO,
+            SceneUtil::LightingMethod::Clustered,
         };
 
         for (const auto& method : methods)
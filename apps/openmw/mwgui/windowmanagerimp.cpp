@@ -127,7 +127,7 @@ namespace MWGui
     WindowManager::WindowManager(
             SDL_Window* window, osgViewer::Viewer* viewer, osg::Group* guiRoot, Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
             const std::string& logpath, const std::string& resourcePath, bool consoleOnlyScripts, Translation::Storage& translationDataStorage,
-            ToUTF8::FromType encoding, bool exportFonts, const std::string& versionDescription, const std::string& userDataPath, bool useShaders)
+            ToUTF8::FromType encoding, bool exportFonts, const std::string& versionDescription, const std::string& userDataPath, const std::string& cachePath, bool useShaders)
       : mOldUpdateMask(0)
       , mOldCullMask(0)
       , mStore(nullptr)
@@ -188,6 +188,7 @@ namespace MWGui
       , mShowOwned(0)
       , mEncoding(encoding)
       , mVersionDescription(versionDescription)
+      , mCachePath(cachePath)
       , mWindowVisible(true)
     {
         mScalingFactor = std::clamp(Settings::Manager::getFloat("scaling factor", "GUI"), 0.5f, 8.f);
@@ -202,7 +203,8 @@ namespace MWGui
         MyGUI::LanguageManager::getInstance().eventRequestTag = MyGUI::newDelegate(this, &WindowManager::onRetrieveTag);
 
         // Load fonts
-        mFontLoader.reset(new Gui::FontLoader(encoding, resourceSystem->getVFS(), userDataPath, mScalingFactor));
+        const std::string fontCachePath = Settings::Manager::getBool("font cache", "GUI") ? cachePath + "/fonts" : std::string();
+        mFontLoader.reset(new Gui::FontLoader(encoding, resourceSystem->getVFS(), userDataPath, fontCachePath, mScalingFactor));
         mFontLoader->loadBitmapFonts(exportFonts);
 
         //Register own widgets with MyGUI
@@ -310,7 +312,7 @@ namespace MWGui
         mWindows.push_back(menu);
 
         mLocalMapRender = new MWRender::LocalMap(mViewer->getSceneData()->asGroup());
-        mMap = new MapWindow(mCustomMarkers, mDragAndDrop, mLocalMapRender, mWorkQueue);
+        mMap = new MapWindow(mCustomMarkers, mDragAndDrop, mLocalMapRender, mWorkQueue, mCachePath);
         mWindows.push_back(mMap);
         mMap->renderGlobalMap();
         trackWindow(mMap, "map");
@@ -795,7 +797,7 @@ namespace MWGui
         return default_;
     }
 
-    void WindowManager::updateMap()
+    void WindowManager::updateMap(float dt)
     {
         if (!mLocalMapRender)
             return;
@@ -808,7 +810,7 @@ namespace MWGui
         osg::Vec3f playerdirection;
         int x,y;
         float u,v;
-        mLocalMapRender->updatePlayer(playerPosition, playerOrientation, u, v, x, y, playerdirection);
+        mLocalMapRender->updatePlayer(dt, playerPosition, playerOrientation, u, v, x, y, playerdirection);
 
         if (!player.getCell()->isExterior())
         {
@@ -830,7 +832,7 @@ namespace MWGui
             MWBase::StateManager::State_NoGame;
 
         if (gameRunning)
-            updateMap();
+            updateMap(frameDuration);
 
         if (!mGuiModes.empty())
         {
@@ -135,7 +135,7 @@ namespace MWGui
 
     WindowManager(SDL_Window* window, osgViewer::Viewer* viewer, osg::Group* guiRoot, Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
                   const std::string& logpath, const std::string& cacheDir, bool consoleOnlyScripts, Translation::Storage& translationDataStorage,
-                  ToUTF8::FromType encoding, bool exportFonts, const std::string& versionDescription, const std::string& localPath, bool useShaders);
+                  ToUTF8::FromType encoding, bool exportFonts, const std::string& versionDescription, const std::string& localPath, const std::string& cachePath, bool useShaders);
     virtual ~WindowManager();
 
     /// Set the ESMStore to use for retrieving of GUI-related strings.
@@ -514,7 +514,7 @@ namespace MWGui
 
     void updateVisible(); // Update visibility of all windows based on mode, shown and allowed settings
 
-    void updateMap();
+    void updateMap(float dt);
 
     int mShowOwned;
 
@@ -522,6 +522,8 @@ namespace MWGui
 
     std::string mVersionDescription;
 
+    std::string mCachePath;
+
     bool mWindowVisible;
 
     MWGui::TextColours mTextColours;
@@ -1,6 +1,7 @@
 #include "sensormanager.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/settings/settingvalue.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/inputmanager.hpp"
@@ -131,7 +132,8 @@ namespace MWInput
 
     void SensorManager::sensorUpdated(const SDL_SensorEvent &arg)
     {
-        if (!Settings::Manager::getBool("enable gyroscope", "Input"))
+        static const Settings::SettingValue<bool> enableGyroscope("enable gyroscope", "Input");
+        if (!enableGyroscope.get())
             return;
 
         SDL_Sensor *sensor = SDL_SensorFromInstanceID(arg.which);
@@ -74,6 +74,9 @@ namespace MWLua
     void SetEquipmentAction::apply(WorldView& worldView) const
     {
         MWWorld::Ptr actor = worldView.getObjectRegistry()->getPtr(mActor, false);
+        // The actor isn't necessarily in an active cell
+        if (actor.isInCell())
+            actor.getCell()->flagAsChanged();
         MWWorld::InventoryStore& store = actor.getClass().getInventoryStore(actor);
         std::array<bool, MWWorld::InventoryStore::Slots> usedSlots;
         std::fill(usedSlots.begin(), usedSlots.end(), false);
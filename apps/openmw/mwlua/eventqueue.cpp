@@ -11,13 +11,65 @@
 namespace MWLua
 {
 
+    template <class Event>
+    void EventQueue<Event>::push(const Event& event)
+    {
+        StoredEvent stored{event, mArena.size(), event.mEventName.size(), event.mEventData.size()};
+        stored.mEvent.mEventName = {};
+        stored.mEvent.mEventData = {};
+        mArena.append(event.mEventName);
+        mArena.append(event.mEventData);
+        mEvents.push_back(stored);
+    }
+
+    template <class Event>
+    void EventQueue<Event>::push(Event event, const sol::object& eventData, const LuaUtil::UserdataSerializer* serializer)
+    {
+        StoredEvent stored{event, mArena.size(), event.mEventName.size(), 0};
+        stored.mEvent.mEventName = {};
+        stored.mEvent.mEventData = {};
+        mArena.append(event.mEventName);
+        try
+        {
+            LuaUtil::serializeTo(mArena, eventData, serializer);
+        }
+        catch (...)
+        {
+            mArena.resize(stored.mOffset);
+            throw;
+        }
+        stored.mDataSize = mArena.size() - stored.mOffset - stored.mNameSize;
+        mEvents.push_back(stored);
+    }
+
+    template <class Event>
+    void EventQueue<Event>::append(const EventQueue& other)
+    {
+        mEvents.reserve(mEvents.size() + other.mEvents.size());
+        for (size_t i = 0; i < other.size(); ++i)
+            push(other[i]);
+    }
+
+    template <class Event>
+    Event EventQueue<Event>::operator[](size_t i) const
+    {
+        const StoredEvent& stored = mEvents[i];
+        Event event = stored.mEvent;
+        event.mEventName = std::string_view(mArena.data() + stored.mOffset, stored.mNameSize);
+        event.mEventData = std::string_view(mArena.data() + stored.mOffset + stored.mNameSize, stored.mDataSize);
+        return event;
+    }
+
+    template class EventQueue<GlobalEvent>;
+    template class EventQueue<LocalEvent>;
+
     template <typename Event>
     void saveEvent(ESM::ESMWriter& esm, const ObjectId& dest, const Event& event)
     {
-        esm.writeHNString("LUAE", event.mEventName);
+        esm.writeHNString("LUAE", std::string(event.mEventName));
         dest.save(esm, true);
         if (!event.mEventData.empty())
-            saveLuaBinaryData(esm, event.mEventData);
+            saveLuaBinaryData(esm, std::string(event.mEventData));
     }
 
     void loadEvents(sol::state& lua, ESM::ESMReader& esm, GlobalEventQueue& globalEvents, LocalEventQueue& localEvents,
@@ -42,10 +94,10 @@ namespace MWLua
                 auto it = contentFileMapping.find(dest.mContentFile);
                 if (it != contentFileMapping.end())
                     dest.mContentFile = it->second;
-                localEvents.push_back({dest, std::move(name), std::move(data)});
+                localEvents.push({dest, name, data});
             }
             else
-                globalEvents.push_back({std::move(name), std::move(data)});
+                globalEvents.push({name, data});
         }
     }
 
@@ -54,10 +106,10 @@ namespace MWLua
         ObjectId globalId;
         globalId.unset();  // Used as a marker of a global event.
 
-        for (const GlobalEvent& e : globalEvents)
-            saveEvent(esm, globalId, e);
-        for (const LocalEvent& e : localEvents)
-            saveEvent(esm, e.mDest, e);
+        for (size_t i = 0; i < globalEvents.size(); ++i)
+            saveEvent(esm, globalId, globalEvents[i]);
+        for (size_t i = 0; i < localEvents.size(); ++i)
+            saveEvent(esm, localEvents[i].mDest, localEvents[i]);
     }
 
 }
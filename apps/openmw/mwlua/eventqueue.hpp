@@ -1,6 +1,13 @@
 #ifndef MWLUA_EVENTQUEUE_H
 #define MWLUA_EVENTQUEUE_H
 
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sol/sol.hpp>
+
 #include "object.hpp"
 
 namespace ESM
@@ -14,26 +21,65 @@ namespace LuaUtil
     class UserdataSerializer;
 }
 
-namespace sol
-{
-    class state;
-}
-
 namespace MWLua
 {
+    // Name and data point to the arena of the queue; they are valid until the queue is cleared or modified.
     struct GlobalEvent
     {
-        std::string mEventName;
-        std::string mEventData;
+        std::string_view mEventName;
+        std::string_view mEventData;
     };
     struct LocalEvent
     {
         ObjectId mDest;
-        std::string mEventName;
-        std::string mEventData;
+        std::string_view mEventName;
+        std::string_view mEventData;
     };
-    using GlobalEventQueue = std::vector<GlobalEvent>;
-    using LocalEventQueue = std::vector<LocalEvent>;
+
+    // Names and serialized data of all events are stored in one buffer, that keeps its capacity
+    // when the queue is cleared. So sending events usually doesn't allocate memory.
+    template <class Event>
+    class EventQueue
+    {
+    public:
+        // Copies the name and the data of the event to the arena.
+        void push(const Event& event);
+
+        // Serializes `eventData` directly to the arena.
+        void push(Event event, const sol::object& eventData, const LuaUtil::UserdataSerializer* serializer);
+
+        void append(const EventQueue& other);
+
+        size_t size() const { return mEvents.size(); }
+        bool empty() const { return mEvents.empty(); }
+        Event operator[](size_t i) const;
+
+        void clear()
+        {
+            mEvents.clear();
+            mArena.clear();
+        }
+        void swap(EventQueue& other)
+        {
+            mEvents.swap(other.mEvents);
+            mArena.swap(other.mArena);
+        }
+
+    private:
+        struct StoredEvent
+        {
+            Event mEvent;  // without name and data
+            size_t mOffset;
+            size_t mNameSize;
+            size_t mDataSize;
+        };
+
+        std::vector<StoredEvent> mEvents;
+        std::string mArena;
+    };
+
+    using GlobalEventQueue = EventQueue<GlobalEvent>;
+    using LocalEventQueue = EventQueue<LocalEvent>;
 
     void loadEvents(sol::state& lua, ESM::ESMReader& esm, GlobalEventQueue&, LocalEventQueue&,
                     const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* serializer);
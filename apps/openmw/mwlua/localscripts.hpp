@@ -23,6 +23,7 @@ namespace MWLua
         LocalScripts(LuaUtil::LuaState* lua, const LObject& obj, ESM::LuaScriptCfg::Flags autoStartMode);
 
         MWBase::LuaManager::ActorControls* getActorControls() { return &mData.mControls; }
+        LuaUtil::LuaState* getLuaState() { return &mLua; }
 
         struct SelfObject : public LObject
         {
@@ -5,6 +5,7 @@
 #include <components/queries/luabindings.hpp>
 
 #include "../mwbase/environment.hpp"
+#include "../mwbase/soundmanager.hpp"
 #include "../mwbase/statemanager.hpp"
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/inventorystore.hpp"
@@ -49,15 +50,56 @@ namespace MWLua
     {
         auto* lua = context.mLua;
         sol::table api(lua->sol(), sol::create);
-        api["API_REVISION"] = 17;
+        api["API_REVISION"] = 19;
         api["quit"] = [lua]()
         {
             Log(Debug::Warning) << "Quit requested by a Lua script.\n" << lua->debugTraceback();
             MWBase::Environment::get().getStateManager()->requestQuit();
         };
-        api["sendGlobalEvent"] = [context](std::string eventName, const sol::object& eventData)
+        api["sendGlobalEvent"] = [context](std::string_view eventName, const sol::object& eventData)
         {
-            context.mGlobalEventQueue->push_back({std::move(eventName), LuaUtil::serialize(eventData, context.mSerializer)});
+            context.mGlobalEventQueue->push({eventName, {}}, eventData, context.mSerializer);
+        };
+        api["getScriptStats"] = [lua]()
+        {
+            sol::table res = lua->newTable();
+            const LuaUtil::ScriptsConfiguration& conf = lua->getConfiguration();
+            const std::vector<LuaUtil::LuaState::ScriptStats>& stats = lua->getScriptStats();
+            for (std::size_t i = 0; i < stats.size() && i < conf.size(); ++i)
+            {
+                if (stats[i].mHandlers.empty())
+                    continue;
+                sol::table handlers = lua->newTable();
+                for (const auto& [name, handler] : stats[i].mHandlers)
+                {
+                    sol::table handlerStats = lua->newTable();
+                    handlerStats["calls"] = handler.mCalls;
+                    handlerStats["totalTime"] = handler.mTotalTime;
+                    handlerStats["maxTime"] = handler.mMaxTime;
+                    handlers[name] = handlerStats;
+                }
+                sol::table script = lua->newTable();
+                script["memoryUsage"] = stats[i].mMemoryUsage;
+                script["handlers"] = handlers;
+                res[conf[static_cast<int>(i)].mScriptPath] = script;
+            }
+            return res;
+        };
+        api["getSoundStats"] = [lua]()
+        {
+            const MWSound::SoundStats stats = MWBase::Environment::get().getSoundManager()->getStats();
+            sol::table res = lua->newTable();
+            res["sources"] = stats.mSources;
+            res["stolenSources"] = stats.mStolenSources;
+            res["streams"] = stats.mStreams;
+            res["streamUnderruns"] = stats.mStreamUnderruns;
+            res["buffers"] = stats.mBuffers;
+            res["pendingBuffers"] = stats.mPendingBuffers;
+            res["bufferMemory"] = stats.mBufferMemory;
+            res["loadTime"] = stats.mLoadTime;
+            res["decodeTime"] = stats.mDecodeTime;
+            res["updateTime"] = stats.mUpdateTime;
+            return res;
         };
         addTimeBindings(api, context, false);
         api["OBJECT_TYPE"] = definitionList(*lua,
@@ -128,19 +170,7 @@ namespace MWLua
         api["activeActors"] = GObjectList{worldView->getActorsInScene()};
         api["selectObjects"] = [context](const Queries::Query& query)
         {
-            ObjectIdList list;
-            WorldView* worldView = context.mWorldView;
-            if (query.mQueryType == "activators")
-                list = worldView->getActivatorsInScene();
-            else if (query.mQueryType == "actors")
-                list = worldView->getActorsInScene();
-            else if (query.mQueryType == "containers")
-                list = worldView->getContainersInScene();
-            else if (query.mQueryType == "doors")
-                list = worldView->getDoorsInScene();
-            else if (query.mQueryType == "items")
-                list = worldView->getItemsInScene();
-            return GObjectList{selectObjectsFromList(query, list, context)};
+            return GObjectList{selectObjectsInScene(query, context)};
             // TODO: Use sqlite to search objects that are not in the scene
             // return GObjectList{worldView->selectObjects(query, false)};
         };
@@ -190,7 +220,10 @@ namespace MWLua
     sol::table initLocalStoragePackage(const Context& context, LuaUtil::LuaStorage* globalStorage)
     {
         sol::table res(context.mLua->sol(), sol::create);
-        res["globalSection"] = [globalStorage](std::string_view section) { return globalStorage->getReadOnlySection(section); };
+        res["globalSection"] = [globalStorage, lua = context.mLua->sol().lua_state()](std::string_view section)
+        {
+            return globalStorage->getReadOnlySection(section, lua);
+        };
         return LuaUtil::makeReadOnly(res);
     }
 
@@ -1,6 +1,10 @@
 #include "luamanagerimp.hpp"
 
+#include <algorithm>
 #include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 
 #include <components/debug/debuglog.hpp>
 
@@ -26,7 +30,21 @@
 namespace MWLua
 {
 
-    LuaManager::LuaManager(const VFS::Manager* vfs, const std::string& libsDir) : mLua(vfs, &mConfiguration), mI18n(vfs, &mLua)
+    namespace
+    {
+        LuaUtil::LuaStateSettings makeLuaStateSettings()
+        {
+            LuaUtil::LuaStateSettings settings;
+            settings.mProfilerEnabled = Settings::Manager::getBool("lua profiler", "Lua");
+            settings.mScriptMemoryLimit = std::int64_t(Settings::Manager::getInt("lua script memory limit", "Lua")) * 1024 * 1024;
+            settings.mScriptUpdateBudget = Settings::Manager::getFloat("lua script update budget", "Lua") / 1000.0;
+            return settings;
+        }
+    }
+
+    LuaManager::LuaManager(const VFS::Manager* vfs, const std::string& libsDir)
+        : mLua(vfs, &mConfiguration, makeLuaStateSettings())
+        , mI18n(vfs, &mLua)
     {
         Log(Debug::Info) << "Lua version: " << LuaUtil::getLuaVersion();
         mLua.addInternalLibSearchPath(libsDir);
@@ -37,6 +55,28 @@ namespace MWLua
         mLocalLoader = createUserdataSerializer(true, mWorldView.getObjectRegistry(), &mContentFileMapping);
 
         mGlobalScripts.setSerializer(mGlobalSerializer.get());
+
+        const int numThreads = Settings::Manager::getInt("lua num threads", "Lua");
+        if (numThreads > 1)
+        {
+            // The main state takes its share of local scripts too, so one state per thread
+            for (int i = 1; i < numThreads; ++i)
+            {
+                mLocalStates.push_back(std::make_unique<LocalState>(vfs, &mConfiguration, mLua.getSettings()));
+                mLocalStates.back()->mLua.addInternalLibSearchPath(libsDir);
+            }
+            mLocalScriptsWorkers = std::make_unique<MWMechanics::WorkerPool>(numThreads - 1);
+            Log(Debug::Info) << "Lua local scripts are processed in " << numThreads << " states";
+        }
+    }
+
+    LuaManager::~LuaManager()
+    {
+        if (!mLua.getSettings().mProfilerEnabled)
+            return;
+        std::ostringstream stream;
+        writeProfilerReport(stream);
+        Log(Debug::Info) << "Lua profiler report:\n" << stream.str();
     }
 
     void LuaManager::initConfiguration()
@@ -91,10 +131,42 @@ namespace MWLua
         mLocalStoragePackage = initLocalStoragePackage(localContext, &mGlobalStorage);
         mPlayerStoragePackage = initPlayerStoragePackage(localContext, &mGlobalStorage, &mPlayerStorage);
 
+        for (const auto& state : mLocalStates)
+            initLocalState(*state, preferredLanguages);
+
         initConfiguration();
         mInitialized = true;
     }
 
+    void LuaManager::initLocalState(LocalState& state, const std::vector<std::string>& preferredLanguages)
+    {
+        Context context;
+        context.mIsGlobal = false;
+        context.mLuaManager = this;
+        context.mLua = &state.mLua;
+        context.mI18n = &state.mI18n;
+        context.mWorldView = &mWorldView;
+        context.mLocalEventQueue = &state.mLocalEvents;
+        context.mGlobalEventQueue = &state.mGlobalEvents;
+        context.mSerializer = mLocalSerializer.get();
+
+        state.mI18n.init();
+        state.mI18n.setPreferredLanguages(preferredLanguages);
+
+        initObjectBindingsForLocalScripts(context);
+        initCellBindingsForLocalScripts(context);
+        LocalScripts::initializeSelfPackage(context);
+        LuaUtil::LuaStorage::initLuaBindings(state.mLua.sol());
+
+        state.mLua.addCommonPackage("openmw.async", getAsyncPackageInitializer(context));
+        state.mLua.addCommonPackage("openmw.util", LuaUtil::initUtilPackage(state.mLua.sol()));
+        state.mLua.addCommonPackage("openmw.core", initCorePackage(context));
+        state.mLua.addCommonPackage("openmw.query", initQueryPackage(context));
+        state.mNearbyPackage = initNearbyPackage(context);
+        state.mSettingsPackage = initGlobalSettingsPackage(context);
+        state.mStoragePackage = initLocalStoragePackage(context, &mGlobalStorage);
+    }
+
     void LuaManager::loadPermanentStorage(const std::string& userConfigPath)
     {
         auto globalPath = std::filesystem::path(userConfigPath) / "global_storage.bin";
@@ -108,8 +180,8 @@ namespace MWLua
     void LuaManager::savePermanentStorage(const std::string& userConfigPath)
     {
         std::filesystem::path confDir(userConfigPath);
-        mGlobalStorage.save((confDir / "global_storage.bin").string());
-        mPlayerStorage.save((confDir / "player_storage.bin").string());
+        mGlobalStorage.saveAsync((confDir / "global_storage.bin").string());
+        mPlayerStorage.saveAsync((confDir / "player_storage.bin").string());
     }
 
     void LuaManager::update()
@@ -132,10 +204,9 @@ namespace MWLua
 
         mWorldView.update();
 
-        std::vector<GlobalEvent> globalEvents = std::move(mGlobalEvents);
-        std::vector<LocalEvent> localEvents = std::move(mLocalEvents);
-        mGlobalEvents = std::vector<GlobalEvent>();
-        mLocalEvents = std::vector<LocalEvent>();
+        // Events sent during this frame go to the emptied queues; the arenas of both pairs of queues are reused.
+        mGlobalEvents.swap(mProcessedGlobalEvents);
+        mLocalEvents.swap(mProcessedLocalEvents);
 
         if (!mWorldView.isPaused())
         {  // Update time and process timers
@@ -144,22 +215,55 @@ namespace MWLua
             double gameTime = mWorldView.getGameTime();
 
             mGlobalScripts.processTimers(simulationTime, gameTime);
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->processTimers(simulationTime, gameTime);
+            forEachActiveLocalScripts([&](LocalScripts* scripts) { scripts->processTimers(simulationTime, gameTime); });
         }
 
         // Receive events
-        for (GlobalEvent& e : globalEvents)
+        for (size_t i = 0; i < mProcessedGlobalEvents.size(); ++i)
+        {
+            const GlobalEvent e = mProcessedGlobalEvents[i];
             mGlobalScripts.receiveEvent(e.mEventName, e.mEventData);
-        for (LocalEvent& e : localEvents)
+        }
+        mProcessedGlobalEvents.clear();
+
+        // Local events are grouped by destination, so every object is looked up only once.
+        // Events sent to the same object keep their order.
+        mLocalEventOrder.resize(mProcessedLocalEvents.size());
+        for (size_t i = 0; i < mLocalEventOrder.size(); ++i)
+            mLocalEventOrder[i] = i;
+        std::stable_sort(mLocalEventOrder.begin(), mLocalEventOrder.end(), [&](size_t a, size_t b)
         {
-            LObject obj(e.mDest, objectRegistry);
+            return mProcessedLocalEvents[a].mDest < mProcessedLocalEvents[b].mDest;
+        });
+        for (size_t begin = 0; begin < mLocalEventOrder.size();)
+        {
+            const ObjectId dest = mProcessedLocalEvents[mLocalEventOrder[begin]].mDest;
+            size_t end = begin + 1;
+            while (end < mLocalEventOrder.size() && mProcessedLocalEvents[mLocalEventOrder[end]].mDest == dest)
+                ++end;
+            LObject obj(dest, objectRegistry);
             LocalScripts* scripts = obj.isValid() ? obj.ptr().getRefData().getLuaScripts() : nullptr;
-            if (scripts)
-                scripts->receiveEvent(e.mEventName, e.mEventData);
-            else
-                Log(Debug::Debug) << "Ignored event " << e.mEventName << " to L" << idToString(e.mDest)
-                                  << ". Object not found or has no attached scripts";
+            for (; begin < end; ++begin)
+            {
+                const LocalEvent e = mProcessedLocalEvents[mLocalEventOrder[begin]];
+                if (scripts)
+                    scripts->receiveEvent(e.mEventName, e.mEventData);
+                else
+                    Log(Debug::Debug) << "Ignored event " << e.mEventName << " to L" << idToString(e.mDest)
+                                      << ". Object not found or has no attached scripts";
+            }
+        }
+        mProcessedLocalEvents.clear();
+
+        // Deliver the results of the casts submitted in `synchronizedUpdate`
+        if (mCastBatch != nullptr)
+        {
+            const MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
+            const std::vector<MWPhysics::RayCastingResult> results = *rayCasting->getCastResults(*mCastBatch, true);
+            mCastBatch = nullptr;
+            for (size_t i = 0; i < results.size(); ++i)
+                mCastBatchCallbacks[i](results[i]);
+            mCastBatchCallbacks.clear();
         }
 
         // Run queued callbacks
@@ -184,10 +288,7 @@ namespace MWLua
         mLocalEngineEvents.clear();
 
         if (!mWorldView.isPaused())
-        {
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->update(frameDuration);
-        }
+            forEachActiveLocalScripts([&](LocalScripts* scripts) { scripts->update(frameDuration); });
 
         // Engine handlers in global scripts
         if (mPlayerChanged)
@@ -213,6 +314,126 @@ namespace MWLua
 
         if (!mWorldView.isPaused())
             mGlobalScripts.update(frameDuration);
+
+        mergeLocalStateEvents();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (mLua.getSettings().mProfilerEnabled && now - mLastProfilerReport >= std::chrono::seconds(1))
+        {
+            mLastProfilerReport = now;
+            std::ostringstream stream;
+            writeProfilerReport(stream);
+            std::lock_guard lock(mProfilerReportMutex);
+            mProfilerReport = stream.str();
+        }
+    }
+
+    std::string LuaManager::getProfilerReport() const
+    {
+        std::lock_guard lock(mProfilerReportMutex);
+        return mProfilerReport;
+    }
+
+    void LuaManager::writeProfilerReport(std::ostream& stream) const
+    {
+        struct Script
+        {
+            std::int64_t mMemoryUsage = 0;
+            double mTotalTime = 0;
+            std::map<std::string_view, LuaUtil::LuaState::HandlerStats> mHandlers;
+        };
+
+        // Stats of the same script in different Lua states are summed up
+        std::vector<Script> scripts(mConfiguration.size());
+        std::int64_t totalMemoryUsage = 0;
+        auto addStats = [&](const LuaUtil::LuaState& lua)
+        {
+            totalMemoryUsage += lua.getTotalMemoryUsage();
+            const std::vector<LuaUtil::LuaState::ScriptStats>& stats = lua.getScriptStats();
+            for (std::size_t i = 0; i < stats.size() && i < scripts.size(); ++i)
+            {
+                scripts[i].mMemoryUsage += stats[i].mMemoryUsage;
+                for (const auto& [name, handler] : stats[i].mHandlers)
+                {
+                    LuaUtil::LuaState::HandlerStats& sum = scripts[i].mHandlers[name];
+                    sum.mCalls += handler.mCalls;
+                    sum.mTotalTime += handler.mTotalTime;
+                    sum.mMaxTime = std::max(sum.mMaxTime, handler.mMaxTime);
+                    scripts[i].mTotalTime += handler.mTotalTime;
+                }
+            }
+        };
+        addStats(mLua);
+        for (const auto& state : mLocalStates)
+            addStats(state->mLua);
+
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i < scripts.size(); ++i)
+        {
+            if (!scripts[i].mHandlers.empty())
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(),
+            [&](std::size_t l, std::size_t r) { return scripts[l].mTotalTime > scripts[r].mTotalTime; });
+
+        stream << "Lua memory: " << totalMemoryUsage / 1024 << " KiB\n";
+        stream << std::fixed << std::setprecision(3);
+        for (std::size_t i : order)
+        {
+            const Script& script = scripts[i];
+            stream << "\n" << mConfiguration[static_cast<int>(i)].mScriptPath << ": " << script.mMemoryUsage / 1024 << " KiB, "
+                   << script.mTotalTime * 1000 << " ms\n";
+            for (const auto& [name, handler] : script.mHandlers)
+            {
+                stream << "    " << std::left << std::setw(24) << name << std::right
+                       << " calls " << std::setw(8) << handler.mCalls
+                       << "  total " << std::setw(10) << handler.mTotalTime * 1000 << " ms"
+                       << "  avg " << std::setw(8) << handler.mTotalTime * 1000 / handler.mCalls << " ms"
+                       << "  max " << std::setw(8) << handler.mMaxTime * 1000 << " ms\n";
+            }
+        }
+    }
+
+    void LuaManager::forEachActiveLocalScripts(const std::function<void(LocalScripts*)>& fn)
+    {
+        if (mLocalStates.empty())
+        {
+            for (LocalScripts* scripts : mActiveLocalScripts)
+                fn(scripts);
+            return;
+        }
+
+        // Group 0 is the main state, scripts of one state must never run on two threads at once
+        mLocalScriptGroups.resize(mLocalStates.size() + 1);
+        for (std::vector<LocalScripts*>& group : mLocalScriptGroups)
+            group.clear();
+        for (LocalScripts* scripts : mActiveLocalScripts)
+        {
+            std::size_t group = 0;
+            for (std::size_t i = 0; i < mLocalStates.size(); ++i)
+            {
+                if (scripts->getLuaState() == &mLocalStates[i]->mLua)
+                    group = i + 1;
+            }
+            mLocalScriptGroups[group].push_back(scripts);
+        }
+
+        mLocalScriptsWorkers->run(mLocalScriptGroups.size(), [&](std::size_t group)
+        {
+            for (LocalScripts* scripts : mLocalScriptGroups[group])
+                fn(scripts);
+        });
+    }
+
+    void LuaManager::mergeLocalStateEvents()
+    {
+        for (const auto& state : mLocalStates)
+        {
+            mGlobalEvents.append(state->mGlobalEvents);
+            mLocalEvents.append(state->mLocalEvents);
+            state->mGlobalEvents.clear();
+            state->mLocalEvents.clear();
+        }
     }
 
     void LuaManager::synchronizedUpdate()
@@ -243,6 +464,17 @@ namespace MWLua
         if (mTeleportPlayerAction)
             mTeleportPlayerAction->safeApply(mWorldView);
         mTeleportPlayerAction.reset();
+
+        // Submit the casts of the last update here, the physics simulation of this frame runs them in the background.
+        // If the last batch wasn't delivered yet, the new casts wait for the next frame.
+        std::lock_guard lock(mQueueMutex);
+        if (!mQueuedCasts.empty() && mCastBatch == nullptr)
+        {
+            mCastBatch = MWBase::Environment::get().getWorld()->getRayCasting()->queueCasts(mQueuedCasts);
+            mCastBatchCallbacks = std::move(mQueuedCastCallbacks);
+            mQueuedCasts.clear();
+            mQueuedCastCallbacks.clear();
+        }
     }
 
     void LuaManager::clear()
@@ -251,9 +483,18 @@ namespace MWLua
         mActiveLocalScripts.clear();
         mLocalEvents.clear();
         mGlobalEvents.clear();
+        for (const auto& state : mLocalStates)
+        {
+            state->mLocalEvents.clear();
+            state->mGlobalEvents.clear();
+        }
         mInputEvents.clear();
         mActorAddedEvents.clear();
         mLocalEngineEvents.clear();
+        mQueuedCasts.clear();
+        mQueuedCastCallbacks.clear();
+        mCastBatch = nullptr;
+        mCastBatchCallbacks.clear();
         mNewGameStarted = false;
         mPlayerChanged = false;
         mWorldView.clear();
@@ -394,14 +635,28 @@ namespace MWLua
             scripts->addPackage("openmw.input", mInputPackage);
             scripts->addPackage("openmw.settings", mPlayerSettingsPackage);
             scripts->addPackage("openmw.storage", mPlayerStoragePackage);
+            scripts->addPackage("openmw.nearby", mNearbyPackage);
         }
         else
         {
-            scripts = std::make_shared<LocalScripts>(&mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()), flag);
-            scripts->addPackage("openmw.settings", mLocalSettingsPackage);
-            scripts->addPackage("openmw.storage", mLocalStoragePackage);
+            // Distribute local scripts between the Lua states, 0 stands for the main state
+            const std::size_t stateIndex = mNextLocalState++ % (mLocalStates.size() + 1);
+            if (stateIndex > 0)
+            {
+                LocalState& state = *mLocalStates[stateIndex - 1];
+                scripts = std::make_shared<LocalScripts>(&state.mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()), flag);
+                scripts->addPackage("openmw.settings", state.mSettingsPackage);
+                scripts->addPackage("openmw.storage", state.mStoragePackage);
+                scripts->addPackage("openmw.nearby", state.mNearbyPackage);
+            }
+            else
+            {
+                scripts = std::make_shared<LocalScripts>(&mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()), flag);
+                scripts->addPackage("openmw.settings", mLocalSettingsPackage);
+                scripts->addPackage("openmw.storage", mLocalStoragePackage);
+                scripts->addPackage("openmw.nearby", mNearbyPackage);
+            }
         }
-        scripts->addPackage("openmw.nearby", mNearbyPackage);
         scripts->setSerializer(mLocalSerializer.get());
 
         MWWorld::RefData& refData = ptr.getRefData();
@@ -411,6 +666,8 @@ namespace MWLua
 
     void LuaManager::write(ESM::ESMWriter& writer, Loading::Listener& progress)
     {
+        mergeLocalStateEvents();
+
         writer.startRecord(ESM::REC_LUAM);
 
         mWorldView.save(writer);
@@ -472,6 +729,8 @@ namespace MWLua
 
         LuaUi::clearUserInterface(); 
         mLua.dropScriptCache();
+        for (const auto& state : mLocalStates)
+            state->mLua.dropScriptCache();
         initConfiguration();
 
         {  // Reload global scripts
@@ -480,9 +739,11 @@ namespace MWLua
             mGlobalScripts.load(data);
         }
 
-        for (const auto& [id, ptr] : mWorldView.getObjectRegistry()->mObjectMapping)
+        for (const auto& slot : mWorldView.getObjectRegistry()->mSlots)
         {  // Reload local scripts
-            LocalScripts* scripts = ptr.getRefData().getLuaScripts();
+            if (slot.mPtr.isEmpty())
+                continue;
+            LocalScripts* scripts = slot.mPtr.getRefData().getLuaScripts();
             if (scripts == nullptr)
                 continue;
             ESM::LuaScripts data;
@@ -1,8 +1,13 @@
 #ifndef MWLUA_LUAMANAGERIMP_H
 #define MWLUA_LUAMANAGERIMP_H
 
+#include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #include <components/lua/i18n.hpp>
 #include <components/lua/luastate.hpp>
@@ -10,6 +15,10 @@
 
 #include "../mwbase/luamanager.hpp"
 
+#include "../mwmechanics/workerpool.hpp"
+
+#include "../mwphysics/raycasting.hpp"
+
 #include "actions.hpp"
 #include "object.hpp"
 #include "eventqueue.hpp"
@@ -25,6 +34,7 @@ namespace MWLua
     {
     public:
         LuaManager(const VFS::Manager* vfs, const std::string& libsDir);
+        ~LuaManager() override;
 
         // Called by engine.cpp when the environment is fully initialized.
         void init();
@@ -53,14 +63,29 @@ namespace MWLua
 
         MWBase::LuaManager::ActorControls* getActorControls(const MWWorld::Ptr&) const override;
 
+        std::string getProfilerReport() const override;
+
         void clear() override;  // should be called before loading game or starting a new game to reset internal state.
         void setupPlayer(const MWWorld::Ptr& ptr) override;  // Should be called once after each "clear".
 
         // Used only in Lua bindings
         void addCustomLocalScript(const MWWorld::Ptr&, int scriptId);
-        void addAction(std::unique_ptr<Action>&& action) { mActionQueue.push_back(std::move(action)); }
-        void addTeleportPlayerAction(std::unique_ptr<TeleportAction>&& action) { mTeleportPlayerAction = std::move(action); }
-        void addUIMessage(std::string_view message) { mUIMessages.emplace_back(message); }
+        // Thread safe, local scripts can call these while running in parallel Lua states.
+        void addAction(std::unique_ptr<Action>&& action)
+        {
+            std::lock_guard lock(mQueueMutex);
+            mActionQueue.push_back(std::move(action));
+        }
+        void addTeleportPlayerAction(std::unique_ptr<TeleportAction>&& action)
+        {
+            std::lock_guard lock(mQueueMutex);
+            mTeleportPlayerAction = std::move(action);
+        }
+        void addUIMessage(std::string_view message)
+        {
+            std::lock_guard lock(mQueueMutex);
+            mUIMessages.emplace_back(message);
+        }
 
         // Saving
         void write(ESM::ESMWriter& writer, Loading::Listener& progress) override;
@@ -77,9 +102,19 @@ namespace MWLua
         // Used to call Lua callbacks from C++
         void queueCallback(LuaUtil::Callback callback, sol::object arg)
         {
+            std::lock_guard lock(mQueueMutex);
             mQueuedCallbacks.push_back({std::move(callback), std::move(arg)});
         }
 
+        // Queues a physics cast, `callback` gets its RayCastingResult in the `update` of the next frame.
+        // Casts of a frame are submitted together in `synchronizedUpdate`, and run next to the physics simulation.
+        void queueCast(const MWPhysics::CastRequest& request, LuaUtil::Callback callback)
+        {
+            std::lock_guard lock(mQueueMutex);
+            mQueuedCasts.push_back(request);
+            mQueuedCastCallbacks.push_back(std::move(callback));
+        }
+
         // Wraps Lua callback into an std::function.
         // NOTE: Resulted function is not thread safe. Can not be used while LuaManager::update() or
         //       any other Lua-related function is running.
@@ -90,9 +125,33 @@ namespace MWLua
         }
 
     private:
+        // Lua state for a part of the local scripts, used if "lua num threads" is more than one.
+        // Scripts of different states are updated in parallel.
+        struct LocalState
+        {
+            LocalState(const VFS::Manager* vfs, const LuaUtil::ScriptsConfiguration* conf, const LuaUtil::LuaStateSettings& settings)
+                : mLua(vfs, conf, settings), mI18n(vfs, &mLua) {}
+
+            LuaUtil::LuaState mLua;
+            LuaUtil::I18nManager mI18n;
+            sol::table mNearbyPackage;
+            sol::table mSettingsPackage;
+            sol::table mStoragePackage;
+
+            // Events sent by the scripts of this state, moved to the main queues at the end of `update`
+            GlobalEventQueue mGlobalEvents;
+            LocalEventQueue mLocalEvents;
+        };
+
         void initConfiguration();
+        void initLocalState(LocalState& state, const std::vector<std::string>& preferredLanguages);
         LocalScripts* createLocalScripts(const MWWorld::Ptr& ptr, ESM::LuaScriptCfg::Flags);
 
+        // Calls `fn` for all active local scripts. Scripts of different Lua states are processed in parallel.
+        void forEachActiveLocalScripts(const std::function<void(LocalScripts*)>& fn);
+        void mergeLocalStateEvents();
+        void writeProfilerReport(std::ostream& stream) const;
+
         bool mInitialized = false;
         bool mGlobalScriptsStarted = false;
         LuaUtil::ScriptsConfiguration mConfiguration;
@@ -117,6 +176,10 @@ namespace MWLua
 
         GlobalEventQueue mGlobalEvents;
         LocalEventQueue mLocalEvents;
+        // Events that are being delivered, kept as members to reuse their memory.
+        GlobalEventQueue mProcessedGlobalEvents;
+        LocalEventQueue mProcessedLocalEvents;
+        std::vector<size_t> mLocalEventOrder;
 
         std::unique_ptr<LuaUtil::UserdataSerializer> mGlobalSerializer;
         std::unique_ptr<LuaUtil::UserdataSerializer> mLocalSerializer;
@@ -135,6 +198,13 @@ namespace MWLua
         };
         std::vector<CallbackWithData> mQueuedCallbacks;
 
+        // Casts queued during `update`, submitted in the next `synchronizedUpdate`.
+        std::vector<MWPhysics::CastRequest> mQueuedCasts;
+        std::vector<LuaUtil::Callback> mQueuedCastCallbacks;
+        // Submitted casts, their callbacks are called in the next `update`.
+        std::shared_ptr<MWPhysics::CastBatch> mCastBatch;
+        std::vector<LuaUtil::Callback> mCastBatchCallbacks;
+
         struct LocalEngineEvent
         {
             ObjectId mDest;
@@ -149,6 +219,17 @@ namespace MWLua
 
         LuaUtil::LuaStorage mGlobalStorage{mLua.sol()};
         LuaUtil::LuaStorage mPlayerStorage{mLua.sol()};
+
+        std::mutex mQueueMutex;
+        std::vector<std::unique_ptr<LocalState>> mLocalStates;
+        std::unique_ptr<MWMechanics::WorkerPool> mLocalScriptsWorkers;
+        std::size_t mNextLocalState = 0;
+        std::vector<std::vector<LocalScripts*>> mLocalScriptGroups;
+
+        // Rebuilt by `update` once a second if the profiler is enabled, read by the debug window from the main thread
+        std::string mProfilerReport;
+        mutable std::mutex mProfilerReportMutex;
+        std::chrono::steady_clock::time_point mLastProfilerReport;
     };
 
 }
@@ -5,8 +5,10 @@
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
+#include "../mwphysics/actorcost.hpp"
 #include "../mwphysics/raycasting.hpp"
 
+#include "luamanagerimp.hpp"
 #include "worldview.hpp"
 
 namespace sol
@@ -17,6 +19,29 @@ namespace sol
 
 namespace MWLua
 {
+    namespace
+    {
+        MWPhysics::CastRequest makeCastRequest(const osg::Vec3f& from, const osg::Vec3f& to, const sol::optional<sol::table>& options)
+        {
+            MWPhysics::CastRequest request;
+            request.mFrom = from;
+            request.mTo = to;
+            if (options)
+            {
+                sol::optional<LObject> ignoreObj = options->get<sol::optional<LObject>>("ignore");
+                if (ignoreObj) request.mIgnore = ignoreObj->ptr();
+                request.mMask = options->get<sol::optional<int>>("collisionType").value_or(request.mMask);
+                request.mRadius = options->get<sol::optional<float>>("radius").value_or(0);
+            }
+            if (request.mRadius > 0)
+            {
+                if (!request.mIgnore.isEmpty()) throw std::logic_error("Currently castRay doesn't support `ignore` when radius > 0");
+                request.mType = MWPhysics::CastRequest::Type::Sphere;
+            }
+            return request;
+        }
+    }
+
     sol::table initNearbyPackage(const Context& context)
     {
         sol::table api(context.mLua->sol(), sol::create);
@@ -59,39 +84,35 @@ namespace MWLua
 
         api["castRay"] = [](const osg::Vec3f& from, const osg::Vec3f& to, sol::optional<sol::table> options)
         {
-            MWWorld::Ptr ignore;
-            int collisionType = MWPhysics::CollisionType_Default;
-            float radius = 0;
-            if (options)
-            {
-                sol::optional<LObject> ignoreObj = options->get<sol::optional<LObject>>("ignore");
-                if (ignoreObj) ignore = ignoreObj->ptr();
-                collisionType = options->get<sol::optional<int>>("collisionType").value_or(collisionType);
-                radius = options->get<sol::optional<float>>("radius").value_or(0);
-            }
+            const MWPhysics::CastRequest request = makeCastRequest(from, to, options);
             const MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
-            if (radius <= 0)
-                return rayCasting->castRay(from, to, ignore, std::vector<MWWorld::Ptr>(), collisionType);
+            if (request.mType == MWPhysics::CastRequest::Type::Ray)
+                return rayCasting->castRay(from, to, request.mIgnore, std::vector<MWWorld::Ptr>(), request.mMask);
             else
+                return rayCasting->castSphere(from, to, request.mRadius, request.mMask);
+        };
+        api["asyncCastRay"] = [luaManager = context.mLuaManager](const LuaUtil::Callback& callback,
+            const osg::Vec3f& from, const osg::Vec3f& to, sol::optional<sol::table> options)
+        {
+            luaManager->queueCast(makeCastRequest(from, to, options), callback);
+        };
+        api["getExpensivePhysicsActors"] = [lua=context.mLua, worldView](sol::optional<std::size_t> count)
+        {
+            sol::table result(lua->sol(), sol::create);
+            const auto actors = MWBase::Environment::get().getWorld()->getExpensivePhysicsActors(count.value_or(10));
+            for (std::size_t i = 0; i < actors.size(); ++i)
             {
-                if (!ignore.isEmpty()) throw std::logic_error("Currently castRay doesn't support `ignore` when radius > 0");
-                return rayCasting->castSphere(from, to, radius, collisionType);
+                const auto& [ptr, cost] = actors[i];
+                sol::table entry(lua->sol(), sol::create);
+                entry["object"] = LObject(getId(ptr), worldView->getObjectRegistry());
+                entry["time"] = cost.mTime;
+                entry["solverIterations"] = cost.mSolverIterations;
+                entry["stepAttempts"] = cost.mStepAttempts;
+                entry["contacts"] = cost.mContacts;
+                result[i + 1] = entry;
             }
+            return result;
         };
-        // TODO: async raycasting
-        /*api["asyncCastRay"] = [luaManager = context.mLuaManager](
-            const Callback& luaCallback, const osg::Vec3f& from, const osg::Vec3f& to, sol::optional<sol::table> options)
-        {
-            std::function<void(MWPhysics::RayCastingResult)> callback =
-                luaManager->wrapLuaCallback<MWPhysics::RayCastingResult>(luaCallback);
-            MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
-
-            // Handle options the same way as in `castRay`.
-
-            // NOTE: `callback` is not thread safe. If MWPhysics works in separate thread, it must put results to a queue
-            //       and use this callback from the main thread at the beginning of the next frame processing.
-            rayCasting->asyncCastRay(callback, from, to, ignore, std::vector<MWWorld::Ptr>(), collisionType);
-        };*/
 
         api["activators"] = LObjectList{worldView->getActivatorsInScene()};
         api["actors"] = LObjectList{worldView->getActorsInScene()};
@@ -100,19 +121,7 @@ namespace MWLua
         api["items"] = LObjectList{worldView->getItemsInScene()};
         api["selectObjects"] = [context](const Queries::Query& query)
         {
-            ObjectIdList list;
-            WorldView* worldView = context.mWorldView;
-            if (query.mQueryType == "activators")
-                list = worldView->getActivatorsInScene();
-            else if (query.mQueryType == "actors")
-                list = worldView->getActorsInScene();
-            else if (query.mQueryType == "containers")
-                list = worldView->getContainersInScene();
-            else if (query.mQueryType == "doors")
-                list = worldView->getDoorsInScene();
-            else if (query.mQueryType == "items")
-                list = worldView->getItemsInScene();
-            return LObjectList{selectObjectsFromList(query, list, context)};
+            return LObjectList{selectObjectsInScene(query, context)};
             // TODO: Maybe use sqlite
             // return LObjectList{worldView->selectObjects(query, true)};
         };
@@ -127,7 +127,9 @@ namespace MWLua
 
     void ObjectRegistry::clear()
     {
-        mObjectMapping.clear();
+        mSlots.clear();
+        mFreeSlots.clear();
+        mSlotById.clear();
         mChanged = false;
         mUpdateCounter = 0;
         mLastAssignedId.unset();
@@ -135,10 +137,25 @@ namespace MWLua
 
     MWWorld::Ptr ObjectRegistry::getPtr(ObjectId id, bool local)
     {
+        ObjectHandle handle;
+        return getPtr(id, local, handle);
+    }
+
+    MWWorld::Ptr ObjectRegistry::getPtr(ObjectId id, bool local, ObjectHandle& handle)
+    {
+        std::lock_guard lock(mMutex);
         MWWorld::Ptr ptr;
-        auto it = mObjectMapping.find(id);
-        if (it != mObjectMapping.end())
-            ptr = it->second;
+        if (handle.mSlot < mSlots.size() && mSlots[handle.mSlot].mGeneration == handle.mGeneration)
+            ptr = mSlots[handle.mSlot].mPtr;
+        else
+        {
+            auto it = mSlotById.find(id);
+            if (it != mSlotById.end())
+            {
+                handle = ObjectHandle{it->second, mSlots[it->second].mGeneration};
+                ptr = mSlots[it->second].mPtr;
+            }
+        }
         if (local)
         {
             // TODO: Return ptr only if it is active or was active in the previous frame, otherwise return empty.
@@ -153,17 +170,41 @@ namespace MWLua
 
     ObjectId ObjectRegistry::registerPtr(const MWWorld::Ptr& ptr)
     {
+        std::lock_guard lock(mMutex);
         ObjectId id = ptr.getCellRef().getOrAssignRefNum(mLastAssignedId);
         mChanged = true;
-        mObjectMapping[id] = ptr;
+        auto [it, inserted] = mSlotById.emplace(id, 0);
+        if (inserted)
+        {
+            if (mFreeSlots.empty())
+            {
+                it->second = static_cast<uint32_t>(mSlots.size());
+                mSlots.emplace_back();
+            }
+            else
+            {
+                it->second = mFreeSlots.back();
+                mFreeSlots.pop_back();
+            }
+        }
+        mSlots[it->second].mPtr = ptr;
         return id;
     }
 
     ObjectId ObjectRegistry::deregisterPtr(const MWWorld::Ptr& ptr)
     {
+        std::lock_guard lock(mMutex);
         ObjectId id = getId(ptr);
         mChanged = true;
-        mObjectMapping.erase(id);
+        auto it = mSlotById.find(id);
+        if (it != mSlotById.end())
+        {
+            Slot& slot = mSlots[it->second];
+            slot.mPtr = MWWorld::Ptr();
+            slot.mGeneration++;
+            mFreeSlots.push_back(it->second);
+            mSlotById.erase(it);
+        }
         return id;
     }
 
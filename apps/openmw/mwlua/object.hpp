@@ -1,7 +1,10 @@
 #ifndef MWLUA_OBJECT_H
 #define MWLUA_OBJECT_H
 
+#include <mutex>
 #include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 #include <components/esm3/cellref.hpp>
 #include <components/esm/defs.hpp>
@@ -53,6 +56,22 @@ namespace MWLua
     // automatically attached. This function maps each object types to one of the flags. 
     ESM::LuaScriptCfg::Flags getLuaScriptFlag(const MWWorld::Ptr& ptr);
 
+    struct ObjectIdHash
+    {
+        size_t operator()(const ObjectId& id) const
+        {
+            return std::hash<uint64_t>()((static_cast<uint64_t>(static_cast<uint32_t>(id.mContentFile)) << 32) | id.mIndex);
+        }
+    };
+
+    // Position of an object in ObjectRegistry. Allows to find the object without a map lookup while the object
+    // stays registered. The generation of a slot is increased when the slot is freed, so outdated handles never match.
+    struct ObjectHandle
+    {
+        uint32_t mSlot = 0;
+        uint32_t mGeneration = 0;
+    };
+
     // Holds a mapping ObjectId -> MWWord::Ptr.
     class ObjectRegistry
     {
@@ -70,6 +89,9 @@ namespace MWLua
         // (i.e. is active or was active in the previous frame).
         MWWorld::Ptr getPtr(ObjectId id, bool local);
 
+        // Same as above, but checks `handle` first and updates it if the object was found by id.
+        MWWorld::Ptr getPtr(ObjectId id, bool local, ObjectHandle& handle);
+
         // Needed only for saving/loading.
         const ObjectId& getLastAssignedId() const { return mLastAssignedId; }
         void setLastAssignedId(ObjectId id) { mLastAssignedId = id; }
@@ -78,10 +100,20 @@ namespace MWLua
         friend class Object;
         friend class LuaManager;
 
+        struct Slot
+        {
+            MWWorld::Ptr mPtr;  // empty if the slot is free
+            uint32_t mGeneration = 1;
+        };
+
         bool mChanged = false;
         int64_t mUpdateCounter = 0;
-        std::map<ObjectId, MWWorld::Ptr> mObjectMapping;
+        std::vector<Slot> mSlots;
+        std::vector<uint32_t> mFreeSlots;
+        std::unordered_map<ObjectId, uint32_t, ObjectIdHash> mSlotById;
         ObjectId mLastAssignedId;
+        // Local scripts running in parallel Lua states can register objects concurrently
+        std::mutex mMutex;
     };
 
     // Lua scripts can't use MWWorld::Ptr directly, because lifetime of a script can be longer than lifetime of Ptr.
@@ -110,6 +142,7 @@ namespace MWLua
         ObjectRegistry* mObjectRegistry;
 
         mutable MWWorld::Ptr mPtr;
+        mutable ObjectHandle mHandle;
         mutable int64_t mLastUpdate = -1;
     };
 
@@ -117,14 +150,14 @@ namespace MWLua
     class LObject : public Object
     {
         using Object::Object;
-        void updatePtr() const final { mPtr = mObjectRegistry->getPtr(mId, true); }
+        void updatePtr() const final { mPtr = mObjectRegistry->getPtr(mId, true, mHandle); }
     };
 
     // Used only in global scripts
     class GObject : public Object
     {
         using Object::Object;
-        void updatePtr() const final { mPtr = mObjectRegistry->getPtr(mId, false); }
+        void updatePtr() const final { mPtr = mObjectRegistry->getPtr(mId, false, mHandle); }
     };
 
     using ObjectIdList = std::shared_ptr<std::vector<ObjectId>>;
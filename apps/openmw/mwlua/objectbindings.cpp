@@ -117,9 +117,9 @@ namespace MWLua
         objectT["count"] = sol::readonly_property([](const ObjectT& o) { return o.ptr().getRefData().getCount(); });
         objectT[sol::meta_function::equal_to] = [](const ObjectT& a, const ObjectT& b) { return a.id() == b.id(); };
         objectT[sol::meta_function::to_string] = &ObjectT::toString;
-        objectT["sendEvent"] = [context](const ObjectT& dest, std::string eventName, const sol::object& eventData)
+        objectT["sendEvent"] = [context](const ObjectT& dest, std::string_view eventName, const sol::object& eventData)
         {
-            context.mLocalEventQueue->push_back({dest.id(), std::move(eventName), LuaUtil::serialize(eventData, context.mSerializer)});
+            context.mLocalEventQueue->push({dest.id(), eventName, {}}, eventData, context.mSerializer);
         };
 
         objectT["canMove"] = [](const ObjectT& o)
@@ -169,6 +169,51 @@ namespace MWLua
         return res;
     }
 
+    // Query planner: returns the record id that every object matching the filter must have, if there is one.
+    // Only `recordId == value` conditions that are not under NOT or OR restrict the result.
+    static const std::string* findRequiredRecordId(const Queries::Filter& filter)
+    {
+        std::vector<const std::string*> stack;
+        for (const Queries::Operation& op : filter.mOperations)
+        {
+            switch(op.mType)
+            {
+                case Queries::Operation::PUSH:
+                {
+                    const Queries::Condition& cond = filter.mConditions[op.mConditionIndex];
+                    const std::vector<std::string>& path = cond.mField->path();
+                    if (cond.mType == Queries::Condition::EQUAL && path.size() == 1 && path[0] == "recordId")
+                        stack.push_back(std::get_if<std::string>(&cond.mValue));
+                    else
+                        stack.push_back(nullptr);
+                    break;
+                }
+                case Queries::Operation::NOT:
+                    stack.back() = nullptr;
+                    break;
+                case Queries::Operation::AND:
+                {
+                    const std::string* v = stack.back();
+                    stack.pop_back();
+                    if (stack.back() == nullptr)
+                        stack.back() = v;
+                    break;
+                }
+                case Queries::Operation::OR:
+                    stack.pop_back();
+                    stack.back() = nullptr;
+                    break;
+            }
+        }
+        return stack.empty() ? nullptr : stack.back();
+    }
+
+    ObjectIdList selectObjectsInScene(const Queries::Query& query, const Context& context)
+    {
+        const std::string* recordId = findRequiredRecordId(query.mFilter);
+        return selectObjectsFromList(query, context.mWorldView->getObjectsInScene(query.mQueryType, recordId), context);
+    }
+
     ObjectIdList selectObjectsFromCellStore(const Queries::Query& query, MWWorld::CellStore* store, const Context& context)
     {
         if (!query.mOrderBy.empty() || !query.mGroupBy.empty() || query.mOffset > 0)
@@ -32,6 +32,8 @@ namespace MWLua
     // TODO: Implement custom fields. QueryFieldGroup registerCustomFields(...);
 
     ObjectIdList selectObjectsFromList(const Queries::Query& query, const ObjectIdList& list, const Context&);
+    // Selects among the objects that are currently in the scene; uses the record id index of WorldView if possible.
+    ObjectIdList selectObjectsInScene(const Queries::Query& query, const Context&);
     ObjectIdList selectObjectsFromCellStore(const Queries::Query& query, MWWorld::CellStore* store, const Context&);
 
 }
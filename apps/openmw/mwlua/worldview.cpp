@@ -11,6 +11,8 @@
 #include "../mwworld/class.hpp"
 #include "../mwworld/timestamp.hpp"
 
+#include "query.hpp"
+
 namespace MWLua
 {
 
@@ -70,6 +72,29 @@ namespace MWLua
             removeFromGroup(*group, ptr);
     }
 
+    ObjectIdList WorldView::getObjectsInScene(std::string_view queryType, const std::string* recordId) const
+    {
+        const ObjectGroup* group = nullptr;
+        if (queryType == ObjectQueryTypes::ACTIVATORS)
+            group = &mActivatorsInScene;
+        else if (queryType == ObjectQueryTypes::ACTORS)
+            group = &mActorsInScene;
+        else if (queryType == ObjectQueryTypes::CONTAINERS)
+            group = &mContainersInScene;
+        else if (queryType == ObjectQueryTypes::DOORS)
+            group = &mDoorsInScene;
+        else if (queryType == ObjectQueryTypes::ITEMS)
+            group = &mItemsInScene;
+        else
+            return std::make_shared<std::vector<ObjectId>>();
+        if (recordId == nullptr)
+            return group->mList;
+        auto it = group->mListsByRecordId.find(*recordId);
+        if (it == group->mListsByRecordId.end())
+            return std::make_shared<std::vector<ObjectId>>();
+        return it->second;
+    }
+
     double WorldView::getGameTime() const
     {
         MWBase::World* world = MWBase::Environment::get().getWorld();
@@ -100,6 +125,18 @@ namespace MWLua
                 mList->push_back(id);
             mChanged = false;
         }
+        for (const std::string& recordId : mChangedRecordIds)
+        {
+            auto it = mSetsByRecordId.find(recordId);
+            if (it == mSetsByRecordId.end())
+            {
+                mListsByRecordId.erase(recordId);
+                continue;
+            }
+            ObjectIdList list = std::make_shared<std::vector<ObjectId>>(it->second.begin(), it->second.end());
+            mListsByRecordId[recordId] = std::move(list);
+        }
+        mChangedRecordIds.clear();
     }
 
     void WorldView::ObjectGroup::clear()
@@ -107,18 +144,32 @@ namespace MWLua
         mChanged = false;
         mList->clear();
         mSet.clear();
+        mSetsByRecordId.clear();
+        mListsByRecordId.clear();
+        mChangedRecordIds.clear();
     }
 
     void WorldView::addToGroup(ObjectGroup& group, const MWWorld::Ptr& ptr)
     {
         group.mSet.insert(getId(ptr));
         group.mChanged = true;
+        const std::string& recordId = ptr.getCellRef().getRefId();
+        group.mSetsByRecordId[recordId].insert(getId(ptr));
+        group.mChangedRecordIds.insert(recordId);
     }
 
     void WorldView::removeFromGroup(ObjectGroup& group, const MWWorld::Ptr& ptr)
     {
         group.mSet.erase(getId(ptr));
         group.mChanged = true;
+        const std::string& recordId = ptr.getCellRef().getRefId();
+        auto it = group.mSetsByRecordId.find(recordId);
+        if (it == group.mSetsByRecordId.end())
+            return;
+        it->second.erase(getId(ptr));
+        if (it->second.empty())
+            group.mSetsByRecordId.erase(it);
+        group.mChangedRecordIds.insert(recordId);
     }
 
     // TODO: If Lua scripts will use several threads at the same time, then `find*Cell` functions should have critical sections.
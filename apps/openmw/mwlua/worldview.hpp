@@ -1,6 +1,9 @@
 #ifndef MWLUA_WORLDVIEW_H
 #define MWLUA_WORLDVIEW_H
 
+#include <map>
+#include <string_view>
+
 #include "object.hpp"
 
 namespace ESM
@@ -39,6 +42,10 @@ namespace MWLua
         ObjectIdList getDoorsInScene() const { return mDoorsInScene.mList; }
         ObjectIdList getItemsInScene() const { return mItemsInScene.mList; }
 
+        // Objects of the given query type that are currently in the scene.
+        // If `recordId` is set, returns only the objects with this record id.
+        ObjectIdList getObjectsInScene(std::string_view queryType, const std::string* recordId = nullptr) const;
+
         ObjectRegistry* getObjectRegistry() { return &mObjectRegistry; }
 
         void objectUnloaded(const MWWorld::Ptr& ptr) { mObjectRegistry.deregisterPtr(ptr); }
@@ -66,6 +73,11 @@ namespace MWLua
             bool mChanged = false;
             ObjectIdList mList = std::make_shared<std::vector<ObjectId>>();
             std::set<ObjectId> mSet;
+
+            // Index for queries by record id. Lists are rebuilt by `updateList` only for the changed record ids.
+            std::map<std::string, std::set<ObjectId>, std::less<>> mSetsByRecordId;
+            std::map<std::string, ObjectIdList, std::less<>> mListsByRecordId;
+            std::set<std::string> mChangedRecordIds;
         };
 
         ObjectGroup* chooseGroup(const MWWorld::Ptr& ptr);
@@ -1,5 +1,6 @@
 #include "activespells.hpp"
 
+#include <algorithm>
 #include <optional>
 
 #include <components/debug/debuglog.hpp>
@@ -150,6 +151,10 @@ namespace MWMechanics
         const auto& creatureStats = ptr.getClass().getCreatureStats(ptr);
         assert(&creatureStats.getActiveSpells() == this);
         IterationGuard guard{*this};
+        const auto& spells = creatureStats.getSpells();
+        const bool syncSpells = mSpellsRemoved || !mQueue.empty() || mSpellsRevision != spells.getRevision();
+        mSpellsRevision = spells.getRevision();
+        mSpellsRemoved = false;
         // Erase no longer active spells and effects
         for(auto spellIt = mSpells.begin(); spellIt != mSpells.end();)
         {
@@ -188,11 +193,13 @@ namespace MWMechanics
         mQueue.clear();
 
         // Vanilla only does this on cell change I think
-        const auto& spells = creatureStats.getSpells();
-        for(const ESM::Spell* spell : spells)
+        if(syncSpells)
         {
-            if(spell->mData.mType != ESM::Spell::ST_Spell && spell->mData.mType != ESM::Spell::ST_Power && !isSpellActive(spell->mId))
-                mSpells.emplace_back(ActiveSpellParams{spell, ptr});
+            for(const ESM::Spell* spell : spells)
+            {
+                if(spell->mData.mType != ESM::Spell::ST_Spell && spell->mData.mType != ESM::Spell::ST_Power && !isSpellActive(spell->mId))
+                    mSpells.emplace_back(ActiveSpellParams{spell, ptr});
+            }
         }
 
         if(ptr.getClass().hasInventoryStore(ptr) && !(creatureStats.isDead() && !creatureStats.isDeathAnimationFinished()))
@@ -226,9 +233,17 @@ namespace MWMechanics
         }
 
         // Update effects
+        const auto& magicEffects = MWBase::Environment::get().getWorld()->getStore().get<ESM::MagicEffect>();
         for(auto spellIt = mSpells.begin(); spellIt != mSpells.end();)
         {
-            const auto caster = MWBase::Environment::get().getWorld()->searchPtrViaActorId(spellIt->mCasterActorId); //Maybe make this search outside active grid?
+            // Effects which were applied once only count down, looking up the caster is not needed for them
+            const bool needsCaster = std::any_of(spellIt->mEffects.begin(), spellIt->mEffects.end(), [&] (const ActiveEffect& effect)
+            {
+                if(!(effect.mFlags & ESM::ActiveEffect::Flag_Applied) || effect.mEffectId == ESM::MagicEffect::Corprus)
+                    return true;
+                return duration != 0.f && !(magicEffects.find(effect.mEffectId)->mData.mFlags & ESM::MagicEffect::Flags::AppliedOnce);
+            });
+            const auto caster = needsCaster ? MWBase::Environment::get().getWorld()->searchPtrViaActorId(spellIt->mCasterActorId) : MWWorld::Ptr(); //Maybe make this search outside active grid?
             bool removedSpell = false;
             std::optional<ActiveSpellParams> reflected;
             for(auto it = spellIt->mEffects.begin(); it != spellIt->mEffects.end();)
@@ -268,7 +283,7 @@ namespace MWMechanics
                 continue;
 
             bool remove = false;
-            if(spellIt->mType == ESM::ActiveSpells::Type_Ability || spellIt->mType == ESM::ActiveSpells::Type_Permanent)
+            if(syncSpells && (spellIt->mType == ESM::ActiveSpells::Type_Ability || spellIt->mType == ESM::ActiveSpells::Type_Permanent))
             {
                 try
                 {
@@ -320,7 +335,7 @@ namespace MWMechanics
         mSpells.emplace_back(spell);
     }
 
-    ActiveSpells::ActiveSpells() : mIterating(false)
+    ActiveSpells::ActiveSpells() : mIterating(false), mSpellsRevision(0), mSpellsRemoved(true)
     {}
 
     ActiveSpells::TIterator ActiveSpells::begin() const
@@ -392,6 +407,7 @@ namespace MWMechanics
                         {
                             auto params = *spellIt;
                             spellIt = mSpells.erase(spellIt);
+                            mSpellsRemoved = true;
                             if(isCurrentSpell)
                             {
                                 *currentSpell = spellIt;
@@ -487,5 +503,6 @@ namespace MWMechanics
             mSpells.emplace_back(ActiveSpellParams{spell});
         for(const ESM::ActiveSpells::ActiveSpellParams& spell : state.mQueue)
             mQueue.emplace_back(ActiveSpellParams{spell});
+        mSpellsRemoved = true;
     }
 }
@@ -107,6 +107,9 @@ namespace MWMechanics
             std::vector<ActiveSpellParams> mQueue;
             std::queue<Predicate> mPurges;
             bool mIterating;
+            // Abilities and permanent spells are only matched against the known spells after either changed
+            unsigned mSpellsRevision;
+            bool mSpellsRemoved;
 
             void addToSpells(const MWWorld::Ptr& ptr, const ActiveSpellParams& spell);
 
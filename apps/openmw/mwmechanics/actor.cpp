@@ -69,4 +69,14 @@ namespace MWMechanics
     {
         return mPositionAdjusted;
     }
+
+    std::size_t Actor::getSlot() const
+    {
+        return mSlot;
+    }
+
+    void Actor::setSlot(std::size_t slot)
+    {
+        mSlot = slot;
+    }
 }
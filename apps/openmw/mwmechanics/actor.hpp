@@ -1,6 +1,7 @@
 #ifndef OPENMW_MECHANICS_ACTOR_H
 #define OPENMW_MECHANICS_ACTOR_H
 
+#include <cstddef>
 #include <memory>
 
 #include "../mwmechanics/actorutil.hpp"
@@ -51,6 +52,10 @@ namespace MWMechanics
         void setPositionAdjusted(bool adjusted);
         bool getPositionAdjusted() const;
 
+        /// Index of the actor state in the dense storage of MWMechanics::Actors
+        std::size_t getSlot() const;
+        void setSlot(std::size_t slot);
+
     private:
         std::unique_ptr<CharacterController> mCharacterController;
         int mGreetingTimer{0};
@@ -59,6 +64,7 @@ namespace MWMechanics
         bool mIsTurningToPlayer{false};
         Misc::DeviatingPeriodicTimer mEngageCombat{1.0f, 0.25f, Misc::Rng::deviate(0, 0.25f)};
         bool mPositionAdjusted;
+        std::size_t mSlot{0};
     };
 
 }
@@ -1,5 +1,8 @@
 #include "actors.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <optional>
 
 #include <components/esm3/esmreader.hpp>
@@ -9,9 +12,13 @@
 #include <components/debug/debuglog.hpp>
 #include <components/misc/rng.hpp>
 #include <components/misc/mathutil.hpp>
+#include <components/misc/framearena.hpp>
+#include <components/misc/threadbudget.hpp>
 #include <components/settings/settings.hpp>
+#include <components/detournavigator/navigator.hpp>
 
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/gamesetting.hpp"
 #include "../mwworld/class.hpp"
 #include "../mwworld/inventorystore.hpp"
 #include "../mwworld/actionequip.hpp"
@@ -124,6 +131,25 @@ void forEachFollowingPackage(MWMechanics::Actors::PtrActorMap& actors, const MWW
     }
 }
 
+// Package making the actor side with its target, if there is one
+const MWMechanics::AiPackage* getSidingPackage(const MWMechanics::CreatureStats& stats)
+{
+    for (const auto& package : stats.getAiSequence())
+    {
+        if (package->sideWithTarget())
+            return package.get();
+        // Don't count "fake" package types
+        if (package->getTypeId() > MWMechanics::AiPackageTypeId::Wander && package->getTypeId() <= MWMechanics::AiPackageTypeId::Activate)
+            return nullptr;
+    }
+    return nullptr;
+}
+
+std::pair<int, int> getGridCell(const osg::Vec3f& position, float cellSize)
+{
+    return {static_cast<int>(std::floor(position.x() / cellSize)), static_cast<int>(std::floor(position.y() / cellSize))};
+}
+
 float getStuntedMagickaDuration(const MWWorld::Ptr& actor)
 {
     float remainingTime = 0.f;
@@ -215,6 +241,14 @@ void removeTemporaryEffects(const MWWorld::Ptr& ptr)
         return spell.getType() == ESM::ActiveSpells::Type_Consumable || spell.getType() == ESM::ActiveSpells::Type_Temporary;
     }, ptr);
 }
+
+bool isFollowing(const MWMechanics::AiSequence& sequence, const MWWorld::Ptr& target)
+{
+    return std::any_of(sequence.begin(), sequence.end(), [&] (const auto& package)
+    {
+        return package->followTargetThroughDoors() && package->getTarget() == target;
+    });
+}
 }
 
 namespace MWMechanics
@@ -374,8 +408,7 @@ namespace MWMechanics
             return;
 
         // Play a random voice greeting if the player gets too close
-        static int iGreetDistanceMultiplier = MWBase::Environment::get().getWorld()->getStore()
-            .get<ESM::GameSetting>().find("iGreetDistanceMultiplier")->mValue.getInteger();
+        static const MWWorld::GmstInt iGreetDistanceMultiplier("iGreetDistanceMultiplier");
 
         float helloDistance = static_cast<float>(stats.getAiSetting(CreatureStats::AI_Hello).getModified() * iGreetDistanceMultiplier);
 
@@ -457,7 +490,7 @@ namespace MWMechanics
         }
     }
 
-    void Actors::engageCombat (const MWWorld::Ptr& actor1, const MWWorld::Ptr& actor2, std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> >& cachedAllies, bool againstPlayer)
+    void Actors::engageCombat (const MWWorld::Ptr& actor1, const MWWorld::Ptr& actor2, bool againstPlayer)
     {
         // No combat for totally static creatures
         if (!actor1.getClass().isMobile(actor1))
@@ -483,9 +516,7 @@ namespace MWMechanics
 
         // Get actors allied with actor1. Includes those following or escorting actor1, actors following or escorting those actors, (recursive)
         // and any actor currently being followed or escorted by actor1
-        std::set<MWWorld::Ptr> allies1;
-
-        getActorsSidingWith(actor1, allies1, cachedAllies);
+        const std::set<MWWorld::Ptr>& allies1 = getAllies(actor1);
 
         // If an ally of actor1 has been attacked by actor2 or has attacked actor2, start combat between actor1 and actor2
         for (const MWWorld::Ptr &ally : allies1)
@@ -507,8 +538,7 @@ namespace MWMechanics
                 aggressive = true;
         }
 
-        std::set<MWWorld::Ptr> playerAllies;
-        getActorsSidingWith(MWMechanics::getPlayer(), playerAllies, cachedAllies);
+        const std::set<MWWorld::Ptr>& playerAllies = getAllies(MWMechanics::getPlayer());
 
         bool isPlayerFollowerOrEscorter = playerAllies.find(actor1) != playerAllies.end();
 
@@ -519,9 +549,7 @@ namespace MWMechanics
             // Check that actor2 is in combat with actor1
             if (actor2.getClass().getCreatureStats(actor2).getAiSequence().isInCombat(actor1))
             {
-                std::set<MWWorld::Ptr> allies2;
-
-                getActorsSidingWith(actor2, allies2, cachedAllies);
+                const std::set<MWWorld::Ptr>& allies2 = getAllies(actor2);
 
                 // Check that an ally of actor2 is also in combat with actor1
                 for (const MWWorld::Ptr &ally2 : allies2)
@@ -1007,7 +1035,37 @@ namespace MWMechanics
         }
     }
 
-    Actors::Actors() : mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
+    struct Actors::ActorSlot
+    {
+        MWWorld::Ptr mPtr;
+        // Null once the actor is removed, the slot is erased at the beginning of the next update
+        Actor* mActor = nullptr;
+        CharacterController* mCharacterController = nullptr;
+        CreatureStats* mStats = nullptr;
+        // Refreshed at the beginning of each update
+        osg::Vec3f mPosition;
+        float mDistanceToPlayer2 = 0;
+        bool mInProcessingRange = false;
+        // Used to find when the allies need to be updated, the target is resolved only then
+        const AiPackage* mSidingPackage = nullptr;
+        // Distant actors update their AI and animation every few frames, with the time elapsed since their last update
+        bool mLowDetail = false;
+        bool mUpdateThisFrame = true;
+        float mUpdateDuration = 0;
+        float mSkippedDuration = 0;
+        unsigned mLodPhase = 0;
+        // Actors not drawn in the last frame only run their character controller every few of their updates
+        bool mAnimateThisFrame = true;
+        float mAnimationDuration = 0;
+        float mSkippedAnimationDuration = 0;
+        // Distant actors reuse the poses evaluated by the other actors playing the same animations
+        bool mSharedAnimation = false;
+    };
+
+    Actors::Actors()
+        : mWorkers(Misc::ThreadBudget::instance().getThreadCount(Misc::ThreadGroup::Ai,
+            Settings::Manager::getInt("ai worker threads", "Game")))
+        , mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
     {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
 
@@ -1031,6 +1089,11 @@ namespace MWMechanics
         static const float minRange = maxRange / 2.f;
 
         mActorsProcessingRange = std::clamp(Settings::Manager::getFloat("actors processing range", "Game"), minRange, maxRange);
+        mLodDistance = std::max(0.f, Settings::Manager::getFloat("actors lod distance", "Game"));
+        mLodInterval = static_cast<unsigned>(std::max(1, Settings::Manager::getInt("actors lod update interval", "Game")));
+        mOffScreenAnimationInterval = static_cast<unsigned>(std::max(1, Settings::Manager::getInt("actors off screen animation interval", "Game")));
+        mSharedAnimationDistance = std::max(0.f, Settings::Manager::getFloat("actors shared animation distance", "Game"));
+        mImpostorDistance = std::max(0.f, Settings::Manager::getFloat("actors impostor distance", "Game"));
     }
 
     void Actors::addActor (const MWWorld::Ptr& ptr, bool updateImmediately)
@@ -1040,9 +1103,11 @@ namespace MWMechanics
         MWRender::Animation *anim = MWBase::Environment::get().getWorld()->getAnimation(ptr);
         if (!anim)
             return;
-        mActors.emplace(ptr, new Actor(ptr, anim));
+        Actor* actor = new Actor(ptr, anim);
+        mActors.emplace(ptr, actor);
+        addSlot(ptr, *actor);
 
-        CharacterController* ctrl = mActors[ptr]->getCharacterController();
+        CharacterController* ctrl = actor->getCharacterController();
         if (updateImmediately)
             ctrl->update(0);
 
@@ -1055,6 +1120,186 @@ namespace MWMechanics
         updateVisibility(ptr, ctrl);
     }
 
+    void Actors::addSlot(const MWWorld::Ptr& ptr, Actor& actor)
+    {
+        actor.setSlot(mSlots.size());
+        ActorSlot& slot = mSlots.emplace_back();
+        slot.mPtr = ptr;
+        slot.mActor = &actor;
+        slot.mCharacterController = actor.getCharacterController();
+        slot.mStats = &ptr.getClass().getCreatureStats(ptr);
+        slot.mPosition = ptr.getRefData().getPosition().asVec3();
+        // Spread the updates of distant actors evenly over the frames
+        slot.mLodPhase = mNextLodPhase++;
+        mAlliesDirty = true;
+    }
+
+    void Actors::removeSlot(const Actor& actor)
+    {
+        // Keep indices stable while update may be iterating over the slots
+        mSlots[actor.getSlot()].mActor = nullptr;
+        mHasRemovedSlots = true;
+        mAlliesDirty = true;
+    }
+
+    void Actors::compactSlots()
+    {
+        if (!mHasRemovedSlots)
+            return;
+        mSlots.erase(std::remove_if(mSlots.begin(), mSlots.end(), [] (const ActorSlot& slot) { return slot.mActor == nullptr; }),
+                     mSlots.end());
+        for (std::size_t i = 0; i < mSlots.size(); ++i)
+            mSlots[i].mActor->setSlot(i);
+        mHasRemovedSlots = false;
+    }
+
+    void Actors::refreshSlots(const MWWorld::Ptr& player)
+    {
+        const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
+        const float processingRange2 = mActorsProcessingRange * mActorsProcessingRange;
+        mSlotsGrid.clear();
+        for (std::size_t i = 0; i < mSlots.size(); ++i)
+        {
+            ActorSlot& slot = mSlots[i];
+            slot.mStats = &slot.mPtr.getClass().getCreatureStats(slot.mPtr);
+            slot.mPosition = slot.mPtr.getRefData().getPosition().asVec3();
+            slot.mDistanceToPlayer2 = (playerPos - slot.mPosition).length2();
+            slot.mInProcessingRange = slot.mDistanceToPlayer2 <= processingRange2;
+            // The player's packages don't make anyone side with them
+            const AiPackage* sidingPackage = slot.mPtr == player || slot.mStats->isDead() ? nullptr : getSidingPackage(*slot.mStats);
+            if (sidingPackage != slot.mSidingPackage)
+            {
+                slot.mSidingPackage = sidingPackage;
+                mAlliesDirty = true;
+            }
+            mSlotsGrid.emplace_back(getGridCell(slot.mPosition, mActorsProcessingRange), i);
+        }
+        std::sort(mSlotsGrid.begin(), mSlotsGrid.end());
+    }
+
+    void Actors::updateLod(const MWWorld::Ptr& player, float duration)
+    {
+        ++mLodFrame;
+        const float lodDistance2 = mLodDistance * mLodDistance;
+        const float sharedAnimationDistance2 = mSharedAnimationDistance * mSharedAnimationDistance;
+        for (ActorSlot& slot : mSlots)
+        {
+            if (slot.mActor == nullptr)
+                continue;
+            // Keep full updates for anything the player may be involved with
+            const AiSequence& seq = slot.mStats->getAiSequence();
+            const bool involved = slot.mPtr == player || seq.isInCombat() || seq.isInPursuit() || isFollowing(seq, player);
+            slot.mLowDetail = mLodDistance > 0 && mLodInterval > 1 && !involved && slot.mDistanceToPlayer2 > lodDistance2;
+            slot.mSkippedDuration += duration;
+            // Actors getting back to full detail are updated at once with the time they skipped
+            slot.mUpdateThisFrame = !slot.mLowDetail || (mLodFrame + slot.mLodPhase) % mLodInterval == 0;
+            if (slot.mUpdateThisFrame)
+            {
+                slot.mUpdateDuration = slot.mSkippedDuration;
+                slot.mSkippedDuration = 0;
+            }
+
+            // The animation time and the root motion keep accumulating while off screen, the skeleton is not updated anyway
+            const bool offScreen = mOffScreenAnimationInterval > 1 && !involved
+                && slot.mCharacterController->isOffScreen();
+            const unsigned interval = slot.mLowDetail ? mLodInterval * mOffScreenAnimationInterval : mOffScreenAnimationInterval;
+            slot.mAnimateThisFrame = slot.mUpdateThisFrame
+                && (!offScreen || (mLodFrame + slot.mLodPhase) % interval == 0);
+            if (slot.mUpdateThisFrame)
+                slot.mSkippedAnimationDuration += slot.mUpdateDuration;
+            if (slot.mAnimateThisFrame)
+            {
+                slot.mAnimationDuration = slot.mSkippedAnimationDuration;
+                slot.mSkippedAnimationDuration = 0;
+            }
+
+            const bool sharedAnimation = mSharedAnimationDistance > 0 && !involved
+                && slot.mDistanceToPlayer2 > sharedAnimationDistance2;
+            if (sharedAnimation != slot.mSharedAnimation)
+            {
+                slot.mSharedAnimation = sharedAnimation;
+                slot.mCharacterController->setSharedAnimation(sharedAnimation);
+            }
+        }
+    }
+
+    void Actors::getSlotsInRange(const osg::Vec3f& position, std::pmr::vector<std::size_t>& out) const
+    {
+        // Grid cells are as large as the processing range, so neighbouring cells contain all actors within it
+        out.clear();
+        const float processingRange2 = mActorsProcessingRange * mActorsProcessingRange;
+        const std::pair<int, int> center = getGridCell(position, mActorsProcessingRange);
+        for (int x = center.first - 1; x <= center.first + 1; ++x)
+        {
+            for (int y = center.second - 1; y <= center.second + 1; ++y)
+            {
+                const std::pair<int, int> cell(x, y);
+                auto it = std::lower_bound(mSlotsGrid.begin(), mSlotsGrid.end(), std::make_pair(cell, std::size_t(0)));
+                for (; it != mSlotsGrid.end() && it->first == cell; ++it)
+                    if ((mSlots[it->second].mPosition - position).length2() <= processingRange2)
+                        out.push_back(it->second);
+            }
+        }
+    }
+
+    void Actors::updateAllies()
+    {
+        if (!mAlliesDirty)
+            return;
+        mAlliesDirty = false;
+        mAllyGroupIndices.clear();
+        mAllyGroups.clear();
+
+        // Actors siding with each other are connected, allies are the connected components
+        std::vector<std::size_t> parents;
+        const auto getNode = [&] (const MWWorld::Ptr& ptr)
+        {
+            const auto it = mAllyGroupIndices.emplace(ptr, parents.size()).first;
+            if (it->second == parents.size())
+                parents.push_back(it->second);
+            return it->second;
+        };
+        const auto getRoot = [&] (std::size_t node)
+        {
+            while (parents[node] != node)
+                node = parents[node] = parents[parents[node]];
+            return node;
+        };
+        for (const ActorSlot& slot : mSlots)
+        {
+            if (slot.mActor == nullptr || slot.mSidingPackage == nullptr)
+                continue;
+            const MWWorld::Ptr target = slot.mSidingPackage->getTarget();
+            if (target.isEmpty())
+                continue;
+            const std::size_t actorRoot = getRoot(getNode(slot.mPtr));
+            const std::size_t targetRoot = getRoot(getNode(target));
+            parents[actorRoot] = targetRoot;
+        }
+
+        std::vector<std::size_t> groups(parents.size(), std::numeric_limits<std::size_t>::max());
+        for (auto& [ptr, index] : mAllyGroupIndices)
+        {
+            std::size_t& group = groups[getRoot(index)];
+            if (group == std::numeric_limits<std::size_t>::max())
+            {
+                group = mAllyGroups.size();
+                mAllyGroups.emplace_back();
+            }
+            mAllyGroups[group].insert(ptr);
+            index = group;
+        }
+    }
+
+    const std::set<MWWorld::Ptr>& Actors::getAllies(const MWWorld::Ptr& actor) const
+    {
+        static const std::set<MWWorld::Ptr> empty;
+        const auto it = mAllyGroupIndices.find(actor);
+        if (it == mAllyGroupIndices.end())
+            return empty;
+        return mAllyGroups[it->second];
+    }
+
     void Actors::updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl)
     {
         MWWorld::Ptr player = MWMechanics::getPlayer();
@@ -1081,6 +1326,10 @@ namespace MWMechanics
         visibilityRatio = std::min(1.f, visibilityRatio);
 
         ctrl->setVisibility(visibilityRatio);
+
+        // Switch back a bit closer than to the impostor, so actors walking along the distance don't flicker
+        const float impostorDistance = ctrl->hasImpostor() ? mImpostorDistance * 0.95f : mImpostorDistance;
+        ctrl->setImpostor(mImpostorDistance > 0 && dist > impostorDistance);
     }
 
     void Actors::removeActor (const MWWorld::Ptr& ptr, bool keepActive)
@@ -1090,6 +1339,7 @@ namespace MWMechanics
         {
             if(!keepActive)
                 removeTemporaryEffects(iter->first);
+            removeSlot(*iter->second);
             delete iter->second;
             mActors.erase(iter);
         }
@@ -1144,6 +1394,11 @@ namespace MWMechanics
 
             actor->updatePtr(ptr);
             mActors.insert(std::make_pair(ptr, actor));
+
+            ActorSlot& slot = mSlots[actor->getSlot()];
+            slot.mPtr = ptr;
+            slot.mStats = &ptr.getClass().getCreatureStats(ptr);
+            mAlliesDirty = true;
         }
     }
 
@@ -1155,6 +1410,7 @@ namespace MWMechanics
             if((iter->first.isInCell() && iter->first.getCell()==cellStore) && iter->first != ignore)
             {
                 removeTemporaryEffects(iter->first);
+                removeSlot(*iter->second);
                 delete iter->second;
                 mActors.erase(iter++);
             }
@@ -1166,20 +1422,18 @@ namespace MWMechanics
     void Actors::updateCombatMusic ()
     {
         MWWorld::Ptr player = getPlayer();
-        const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
         bool hasHostiles = false; // need to know this to play Battle music
         bool aiActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
 
         if (aiActive)
         {
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (const ActorSlot& slot : mSlots)
             {
-                if (iter->first == player) continue;
+                if (slot.mActor == nullptr || slot.mPtr == player) continue;
 
-                bool inProcessingRange = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
-                if (inProcessingRange)
+                if (slot.mInProcessingRange)
                 {
-                    MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                    const MWMechanics::CreatureStats& stats = *slot.mStats;
                     if (!stats.isDead() && stats.getAiSequence().isInCombat())
                     {
                         hasHostiles = true;
@@ -1219,9 +1473,13 @@ namespace MWMechanics
 
         MWWorld::Ptr player = getPlayer();
         MWBase::World* world = MWBase::Environment::get().getWorld();
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        for (const ActorSlot& slot : mSlots)
         {
-            const MWWorld::Ptr& ptr = iter->first;
+            if (slot.mActor == nullptr)
+                continue;
+            if (!slot.mUpdateThisFrame)
+                continue; // The movement is applied when the AI and animation are updated again.
+            const MWWorld::Ptr& ptr = slot.mPtr;
             if (ptr == player)
                 continue; // Don't interfere with player controls.
 
@@ -1242,7 +1500,7 @@ namespace MWMechanics
             bool shouldGiveWay = false;
             bool shouldTurnToApproachingActor = !isMoving;
             MWWorld::Ptr currentTarget; // Combat or pursue target (NPCs should not avoid collision with their targets).
-            const auto& aiSequence = ptr.getClass().getCreatureStats(ptr).getAiSequence();
+            const auto& aiSequence = slot.mStats->getAiSequence();
             for (const auto& package : aiSequence)
             {
                 if (package->getTypeId() == AiPackageTypeId::Follow)
@@ -1264,7 +1522,7 @@ namespace MWMechanics
                 continue;
 
             osg::Vec2f baseSpeed = origMovement * maxSpeed;
-            osg::Vec3f basePos = ptr.getRefData().getPosition().asVec3();
+            const osg::Vec3f& basePos = slot.mPosition;
             float baseRotZ = ptr.getRefData().getPosition().rot[2];
             const osg::Vec3f halfExtents = world->getHalfExtents(ptr);
             float maxDistToCheck = isMoving ? maxDistForPartialAvoiding : maxDistForStrictAvoiding;
@@ -1278,21 +1536,30 @@ namespace MWMechanics
             float angleToApproachingActor = 0;
 
             // Iterate through all other actors and predict collisions.
-            for(PtrActorMap::iterator otherIter(mActors.begin()); otherIter != mActors.end(); ++otherIter)
+            for (const ActorSlot& other : mSlots)
             {
-                const MWWorld::Ptr& otherPtr = otherIter->first;
+                if (other.mActor == nullptr)
+                    continue;
+                const MWWorld::Ptr& otherPtr = other.mPtr;
                 if (otherPtr == ptr || otherPtr == currentTarget)
                     continue;
 
-                const osg::Vec3f otherHalfExtents = world->getHalfExtents(otherPtr);
-                osg::Vec3f deltaPos = otherPtr.getRefData().getPosition().asVec3() - basePos;
+                const osg::Vec3f deltaPos = other.mPosition - basePos;
+                const float dist2 = deltaPos.length2();
+
+                // Ignore actors which are not close enough.
+                if (dist2 > maxDistToCheck * maxDistToCheck)
+                    continue;
+
                 osg::Vec2f relPos = Misc::rotateVec2f(osg::Vec2f(deltaPos.x(), deltaPos.y()), baseRotZ);
-                float dist = deltaPos.length();
+                float dist = std::sqrt(dist2);
 
-                // Ignore actors which are not close enough or come from behind.
-                if (dist > maxDistToCheck || relPos.y() < 0)
+                // Ignore actors which come from behind.
+                if (relPos.y() < 0)
                     continue;
 
+                const osg::Vec3f otherHalfExtents = world->getHalfExtents(otherPtr);
+
                 // Don't check for a collision if vertical distance is greater then the actor's height.
                 if (deltaPos.z() > halfExtents.z() * 2 || deltaPos.z() < -otherHalfExtents.z() * 2)
                     continue;
@@ -1328,7 +1595,7 @@ namespace MWMechanics
                 float coef = (posAtT.x() * relSpeed.x() + posAtT.y() * relSpeed.y()) / (collisionDist * collisionDist * maxSpeed);
                 coef *= std::clamp((maxDistForPartialAvoiding - dist) / (maxDistForPartialAvoiding - maxDistForStrictAvoiding), 0.f, 1.f);
                 movementCorrection = posAtT * coef;
-                if (otherPtr.getClass().getCreatureStats(otherPtr).isDead())
+                if (other.mStats->isDead())
                     // In case of dead body still try to go around (it looks natural), but reduce the correction twice.
                     movementCorrection.y() *= 0.5f;
             }
@@ -1350,10 +1617,35 @@ namespace MWMechanics
         }
     }
 
+    void Actors::prepareAi(const MWWorld::Ptr& player)
+    {
+        mAiSlots.clear();
+        for (std::size_t i = 0; i < mSlots.size(); ++i)
+        {
+            const ActorSlot& slot = mSlots[i];
+            if (slot.mActor == nullptr || !slot.mInProcessingRange || !slot.mUpdateThisFrame || slot.mPtr == player
+                || !isConscious(slot.mPtr))
+                continue;
+            if (slot.mStats->getAiSequence().collectCombatTargets())
+                mAiSlots.push_back(i);
+        }
+
+        mWorkers.run(mAiSlots.size(), [this] (std::size_t i)
+        {
+            const ActorSlot& slot = mSlots[mAiSlots[i]];
+            slot.mStats->getAiSequence().rateCombatTargets(slot.mPtr);
+        });
+    }
+
     void Actors::update (float duration, bool paused)
     {
+        compactSlots();
+        refreshSlots(getPlayer());
+
         if(!paused)
         {
+            updateLod(getPlayer(), duration);
+
             static float timerUpdateHeadTrack = 0;
             static float timerUpdateEquippedLight = 0;
             static float timerUpdateHello = 0;
@@ -1373,7 +1665,7 @@ namespace MWMechanics
 
             /// \todo move update logic to Actor class where appropriate
 
-            std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
+            std::pmr::vector<std::size_t> nearbySlots(MWBase::Environment::get().getFrameArena());
 
             bool aiActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
             int attackedByPlayerId = player.getClass().getCreatureStats(player).getHitAttemptActorId();
@@ -1386,43 +1678,53 @@ namespace MWMechanics
             }
             bool godmode = MWBase::Environment::get().getWorld()->getGodModeState();
 
+            // Decisions which only read the world are made for all actors at once, against the state
+            // at the beginning of the frame. Their results are applied one actor after another below.
+            if (aiActive)
+                prepareAi(player);
+
              // AI and magic effects update
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            // Slots are accessed by index since summoned actors may be added to them during the update
+            for (std::size_t i = 0; i < mSlots.size(); ++i)
             {
-                bool isPlayer = iter->first == player;
-                CharacterController* ctrl = iter->second->getCharacterController();
-                MWBase::LuaManager::ActorControls* luaControls =
-                    MWBase::Environment::get().getLuaManager()->getActorControls(iter->first);
+                if (mSlots[i].mActor == nullptr)
+                    continue;
 
-                float distSqr = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2();
+                const MWWorld::Ptr ptr = mSlots[i].mPtr; // make a copy to avoid it being invalidated when the player teleports
+                Actor& actorState = *mSlots[i].mActor;
+                CharacterController* ctrl = mSlots[i].mCharacterController;
+                CreatureStats& stats = *mSlots[i].mStats;
                 // AI processing is only done within given distance to the player.
-                bool inProcessingRange = distSqr <= mActorsProcessingRange*mActorsProcessingRange;
+                const bool inProcessingRange = mSlots[i].mInProcessingRange;
+                const bool lowDetail = mSlots[i].mLowDetail;
+                const bool updateAi = mSlots[i].mUpdateThisFrame;
+                const float aiDuration = mSlots[i].mUpdateDuration;
+                bool isPlayer = ptr == player;
+                MWBase::LuaManager::ActorControls* luaControls =
+                    MWBase::Environment::get().getLuaManager()->getActorControls(ptr);
 
                 // If dead or no longer in combat, no longer store any actors who attempted to hit us. Also remove for the player.
-                if (iter->first != player && (iter->first.getClass().getCreatureStats(iter->first).isDead()
-                    || !iter->first.getClass().getCreatureStats(iter->first).getAiSequence().isInCombat()
-                    || !inProcessingRange))
+                if (!isPlayer && (stats.isDead() || !stats.getAiSequence().isInCombat() || !inProcessingRange))
                 {
-                    iter->first.getClass().getCreatureStats(iter->first).setHitAttemptActorId(-1);
-                    if (player.getClass().getCreatureStats(player).getHitAttemptActorId() == iter->first.getClass().getCreatureStats(iter->first).getActorId())
+                    stats.setHitAttemptActorId(-1);
+                    if (player.getClass().getCreatureStats(player).getHitAttemptActorId() == stats.getActorId())
                         player.getClass().getCreatureStats(player).setHitAttemptActorId(-1);
                 }
 
-                const Misc::TimerStatus engageCombatTimerStatus = iter->second->updateEngageCombatTimer(duration);
+                const Misc::TimerStatus engageCombatTimerStatus = actorState.updateEngageCombatTimer(duration);
 
                 // For dead actors we need to update looping spell particles
-                if (iter->first.getClass().getCreatureStats(iter->first).isDead())
+                if (stats.isDead())
                 {
                     // They can be added during the death animation
-                    if (!iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished())
-                        adjustMagicEffects(iter->first, duration);
+                    if (!stats.isDeathAnimationFinished())
+                        adjustMagicEffects(ptr, duration);
                     ctrl->updateContinuousVfx();
                 }
                 else
                 {
                     bool cellChanged = world->hasCellChanged();
-                    MWWorld::Ptr actor = iter->first; // make a copy of the map key to avoid it being invalidated when the player teleports
-                    updateActor(actor, duration);
+                    updateActor(ptr, duration);
 
                     // Looping magic VFX update
                     // Note: we need to do this before any of the animations are updated.
@@ -1436,18 +1738,24 @@ namespace MWMechanics
                         return; // for now abort update of the old cell when cell changes by teleportation magic effect
                                 // a better solution might be to apply cell changes at the end of the frame
                     }
+                    // The actor may be removed by its own magic effects
+                    if (mSlots[i].mActor == nullptr)
+                        continue;
                     if (aiActive && inProcessingRange)
                     {
-                        if (engageCombatTimerStatus == Misc::TimerStatus::Elapsed)
+                        if (engageCombatTimerStatus == Misc::TimerStatus::Elapsed && !isPlayer) // player is not AI-controlled
                         {
-                            if (!isPlayer)
-                                adjustCommandedActor(iter->first);
+                            adjustCommandedActor(ptr);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            // Actors out of processing range can't be engaged, only the nearby ones are checked
+                            updateAllies();
+                            getSlotsInRange(mSlots[i].mPosition, nearbySlots);
+                            for (const std::size_t j : nearbySlots)
                             {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
+                                if (j == i || mSlots[j].mActor == nullptr)
                                     continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                const MWWorld::Ptr other = mSlots[j].mPtr;
+                                engageCombat(ptr, other, other == player);
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -1455,7 +1763,6 @@ namespace MWMechanics
                             float sqrHeadTrackDistance = std::numeric_limits<float>::max();
                             MWWorld::Ptr headTrackTarget;
 
-                            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
                             bool firstPersonPlayer = isPlayer && world->isFirstPerson();
                             bool inCombatOrPursue = stats.getAiSequence().isInCombat() || stats.getAiSequence().hasPackage(AiPackageTypeId::Pursue);
                             MWWorld::Ptr activePackageTarget;
@@ -1463,59 +1770,72 @@ namespace MWMechanics
                             // 1. Unconsious actor can not track target
                             // 2. Actors in combat and pursue mode do not bother to headtrack anyone except their target
                             // 3. Player character does not use headtracking in the 1st-person view
-                            if (!stats.getKnockedDown() && !firstPersonPlayer)
+                            // 4. Distant actors skip head tracking
+                            if (!stats.getKnockedDown() && !firstPersonPlayer && !lowDetail)
                             {
                                 if (inCombatOrPursue)
                                     activePackageTarget = stats.getAiSequence().getActivePackage().getTarget();
 
-                                for (PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                for (const ActorSlot& other : mSlots)
                                 {
-                                    if (it->first == iter->first)
+                                    if (other.mActor == nullptr || other.mPtr == ptr)
                                         continue;
 
-                                    if (inCombatOrPursue && it->first != activePackageTarget)
+                                    if (inCombatOrPursue && other.mPtr != activePackageTarget)
                                         continue;
 
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance, inCombatOrPursue);
+                                    updateHeadTracking(ptr, other.mPtr, headTrackTarget, sqrHeadTrackDistance, inCombatOrPursue);
                                 }
                             }
 
                             ctrl->setHeadTrackTarget(headTrackTarget);
                         }
 
-                        if (iter->first.getClass().isNpc() && iter->first != player)
-                            updateCrimePursuit(iter->first, duration);
+                        if (ptr.getClass().isNpc() && !isPlayer)
+                            updateCrimePursuit(ptr, duration);
 
-                        if (iter->first != player)
+                        if (!isPlayer)
                         {
-                            CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                            if (isConscious(iter->first) && !(luaControls && luaControls->mDisableAI))
+                            if (isConscious(ptr) && !(luaControls && luaControls->mDisableAI))
                             {
-                                stats.getAiSequence().execute(iter->first, *ctrl, duration);
-                                updateGreetingState(iter->first, *iter->second, timerUpdateHello > 0);
-                                playIdleDialogue(iter->first);
-                                updateMovementSpeed(iter->first);
+                                if (updateAi)
+                                {
+                                    stats.getAiSequence().execute(ptr, *ctrl, aiDuration);
+                                    // Navmesh around actors the player is likely to deal with is built first
+                                    if (stats.getAiSequence().isInCombat() || isFollowing(stats.getAiSequence(), player))
+                                    {
+                                        const osg::Vec3f position = ptr.getRefData().getPosition().asVec3();
+                                        world->getNavigator()->addDemand(world->getPathfindingHalfExtents(ptr),
+                                                                         position, position);
+                                    }
+                                }
+                                // Distant actors can't greet the player, but still finish a greeting they started
+                                if (!lowDetail || actorState.getGreetingState() != Greet_None)
+                                    updateGreetingState(ptr, actorState, timerUpdateHello > 0);
+                                if (updateAi)
+                                {
+                                    playIdleDialogue(ptr);
+                                    updateMovementSpeed(ptr);
+                                }
                             }
                         }
                     }
-                    else if (aiActive && iter->first != player && isConscious(iter->first) && !(luaControls && luaControls->mDisableAI))
+                    else if (aiActive && updateAi && !isPlayer && isConscious(ptr) && !(luaControls && luaControls->mDisableAI))
                     {
-                        CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                        stats.getAiSequence().execute(iter->first, *ctrl, duration, /*outOfRange*/true);
+                        stats.getAiSequence().execute(ptr, *ctrl, aiDuration, /*outOfRange*/true);
                     }
 
-                    if(inProcessingRange && iter->first.getClass().isNpc())
+                    if(inProcessingRange && ptr.getClass().isNpc())
                     {
                         // We can not update drowning state for actors outside of AI distance - they can not resurface to breathe
-                        updateDrowning(iter->first, duration, ctrl->isKnockedOut(), isPlayer);
+                        updateDrowning(ptr, duration, ctrl->isKnockedOut(), isPlayer);
                     }
-                    if(timerUpdateEquippedLight == 0 && iter->first.getClass().hasInventoryStore(iter->first))
-                        updateEquippedLight(iter->first, updateEquippedLightInterval, showTorches);
+                    if(timerUpdateEquippedLight == 0 && ptr.getClass().hasInventoryStore(ptr))
+                        updateEquippedLight(ptr, updateEquippedLightInterval, showTorches);
 
-                    if (luaControls && isConscious(iter->first))
+                    if (luaControls && isConscious(ptr))
                     {
-                        Movement& mov = iter->first.getClass().getMovementSettings(iter->first);
-                        CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                        Movement& mov = ptr.getClass().getMovementSettings(ptr);
                         float speedFactor = isPlayer ? 1.f : mov.mSpeedFactor;
                         osg::Vec2f movement = osg::Vec2f(mov.mPosition[0], mov.mPosition[1]) * speedFactor;
                         float rotationX = mov.mRotation[0];
@@ -1558,14 +1878,21 @@ namespace MWMechanics
 
             // Animation/movement update
             CharacterController* playerCharacter = nullptr;
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (std::size_t i = 0; i < mSlots.size(); ++i)
             {
-                const float dist = (playerPos - iter->first.getRefData().getPosition().asVec3()).length();
-                bool isPlayer = iter->first == player;
-                CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
+                if (mSlots[i].mActor == nullptr)
+                    continue;
+
+                const MWWorld::Ptr ptr = mSlots[i].mPtr;
+                Actor& actorState = *mSlots[i].mActor;
+                CharacterController* ctrl = mSlots[i].mCharacterController;
+                CreatureStats& stats = *mSlots[i].mStats;
+                // Actors can be moved by the AI, so the distance is not taken from the slot
+                const float dist = (playerPos - ptr.getRefData().getPosition().asVec3()).length();
+                bool isPlayer = ptr == player;
                 // Actors with active AI should be able to move.
                 bool alwaysActive = false;
-                if (!isPlayer && isConscious(iter->first) && !stats.isParalyzed())
+                if (!isPlayer && isConscious(ptr) && !stats.isParalyzed())
                 {
                     MWMechanics::AiSequence& seq = stats.getAiSequence();
                     alwaysActive = !seq.isEmpty() && seq.getActivePackage().alwaysActive();
@@ -1576,41 +1903,42 @@ namespace MWMechanics
                     activeFlag = 2;
                 int active = inRange ? activeFlag : 0;
 
-                CharacterController* ctrl = iter->second->getCharacterController();
                 ctrl->setActive(active);
 
                 if (!inRange)
                 {
-                    iter->first.getRefData().getBaseNode()->setNodeMask(0);
-                    world->setActorCollisionMode(iter->first, false, false);
+                    ptr.getRefData().getBaseNode()->setNodeMask(0);
+                    world->setActorCollisionMode(ptr, false, false);
                     continue;
                 }
                 else if (!isPlayer)
                 {
-                    iter->first.getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
-                    if (!iter->second->getPositionAdjusted())
+                    ptr.getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
+                    if (!actorState.getPositionAdjusted())
                     {
-                        iter->first.getClass().adjustPosition(iter->first, false);
-                        iter->second->setPositionAdjusted(true);
+                        ptr.getClass().adjustPosition(ptr, false);
+                        actorState.setPositionAdjusted(true);
                     }
                 }
 
-                const bool isDead = iter->first.getClass().getCreatureStats(iter->first).isDead();
-                if (!isDead && (!godmode || !isPlayer) && iter->first.getClass().getCreatureStats(iter->first).isParalyzed())
+                const bool isDead = stats.isDead();
+                if (!isDead && (!godmode || !isPlayer) && stats.isParalyzed())
                     ctrl->skipAnim();
 
                 // Handle player last, in case a cell transition occurs by casting a teleportation spell
-                // (would invalidate the iterator)
-                if (iter->first == getPlayer())
+                // (would invalidate the actors)
+                if (isPlayer)
                 {
                     playerCharacter = ctrl;
                     continue;
                 }
 
-                world->setActorCollisionMode(iter->first, true, !iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished());
-                ctrl->update(duration);
+                world->setActorCollisionMode(ptr, true, !stats.isDeathAnimationFinished());
+                // Between the updates of distant or off screen actors the physics keeps moving them with their last velocity
+                if (mSlots[i].mAnimateThisFrame)
+                    ctrl->update(mSlots[i].mAnimationDuration);
 
-                updateVisibility(iter->first, ctrl);
+                updateVisibility(ptr, ctrl);
             }
 
             if (playerCharacter)
@@ -1620,10 +1948,12 @@ namespace MWMechanics
                 playerCharacter->setVisibility(1.f);
             }
 
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (const ActorSlot& slot : mSlots)
             {
-                const MWWorld::Class &cls = iter->first.getClass();
-                CreatureStats &stats = cls.getCreatureStats(iter->first);
+                if (slot.mActor == nullptr)
+                    continue;
+
+                CreatureStats &stats = *slot.mStats;
 
                 //KnockedOutOneFrameLogic
                 //Used for "OnKnockedOut" command
@@ -1773,6 +2103,15 @@ namespace MWMechanics
         const MWWorld::Ptr player = MWBase::Environment::get().getWorld()->getPlayerPtr();
         const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
 
+        // Restoring only changes the stats of the actor itself, so it is done for all actors at once
+        std::vector<MWWorld::Ptr> restoring;
+        for (const auto& [ptr, actor] : mActors)
+        {
+            if ((!sleep || ptr == player) && !ptr.getClass().getCreatureStats(ptr).isDead())
+                restoring.push_back(ptr);
+        }
+        mWorkers.run(restoring.size(), [&] (std::size_t i) { restoreDynamicStats(restoring[i], hours, sleep); });
+
         for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
         {
             if (iter->first.getClass().getCreatureStats(iter->first).isDead())
@@ -1781,9 +2120,6 @@ namespace MWMechanics
                 continue;
             }
 
-            if (!sleep || iter->first == player)
-                restoreDynamicStats(iter->first, hours, sleep);
-
             if ((!iter->first.getRefData().getBaseNode()) ||
                     (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() > mActorsProcessingRange*mActorsProcessingRange)
                 continue;
@@ -1986,22 +2322,15 @@ namespace MWMechanics
 
             // An actor counts as siding with this actor if Follow or Escort is the current AI package, or there are only Wander packages before the Follow/Escort package
             // Actors that are targeted by this actor's Follow or Escort packages also side with them
-            for (const auto& package : stats.getAiSequence())
+            if (const AiPackage* package = getSidingPackage(stats))
             {
-                if (package->sideWithTarget() && !package->getTarget().isEmpty())
-                {
-                    if (sameActor)
-                    {
-                        list.push_back(package->getTarget());
-                    }
-                    else if (package->getTarget() == actor)
-                    {
-                        list.push_back(iteratedActor);
-                    }
-                    break;
-                }
-                else if (package->getTypeId() > AiPackageTypeId::Wander && package->getTypeId() <= AiPackageTypeId::Activate) // Don't count "fake" package types
-                    break;
+                const MWWorld::Ptr target = package->getTarget();
+                if (target.isEmpty())
+                    continue;
+                if (sameActor)
+                    list.push_back(target);
+                else if (target == actor)
+                    list.push_back(iteratedActor);
             }
         }
         return list;
@@ -2035,29 +2364,6 @@ namespace MWMechanics
                 getActorsSidingWith(follower, out);
     }
 
-    void Actors::getActorsSidingWith(const MWWorld::Ptr &actor, std::set<MWWorld::Ptr>& out, std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> >& cachedAllies) {
-        // If we have already found actor's allies, use the cache
-        std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> >::const_iterator search = cachedAllies.find(actor);
-        if (search != cachedAllies.end())
-            out.insert(search->second.begin(), search->second.end());
-        else
-        {
-            std::list<MWWorld::Ptr> followers = getActorsSidingWith(actor);
-            for (const MWWorld::Ptr &follower : followers)
-                if (out.insert(follower).second)
-                    getActorsSidingWith(follower, out, cachedAllies);
-
-            // Cache ptrs and their sets of allies
-            cachedAllies.insert(std::make_pair(actor, out));
-            for (const MWWorld::Ptr &iter : out)
-            {
-                search = cachedAllies.find(iter);
-                if (search == cachedAllies.end())
-                    cachedAllies.insert(std::make_pair(iter, out));
-            }
-        }
-    }
-
     std::list<int> Actors::getActorsFollowingIndices(const MWWorld::Ptr &actor)
     {
         std::list<int> list;
@@ -2172,6 +2478,12 @@ namespace MWMechanics
             it->second = nullptr;
         }
         mActors.clear();
+        mSlots.clear();
+        mSlotsGrid.clear();
+        mHasRemovedSlots = false;
+        mAllyGroupIndices.clear();
+        mAllyGroups.clear();
+        mAlliesDirty = true;
         mDeathCount.clear();
     }
 
@@ -6,8 +6,11 @@
 #include <string>
 #include <list>
 #include <map>
+#include <memory_resource>
+#include <utility>
 
 #include "../mwmechanics/actorutil.hpp"
+#include "../mwmechanics/workerpool.hpp"
 
 namespace ESM
 {
@@ -117,7 +120,7 @@ namespace MWMechanics
                 @Notes: If againstPlayer = true then actor2 should be the Player.
                         If one of the combatants is creature it should be actor1.
             */
-            void engageCombat(const MWWorld::Ptr& actor1, const MWWorld::Ptr& actor2, std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> >& cachedAllies, bool againstPlayer);
+            void engageCombat(const MWWorld::Ptr& actor1, const MWWorld::Ptr& actor2, bool againstPlayer);
 
             void playIdleDialogue(const MWWorld::Ptr& actor);
             void updateMovementSpeed(const MWWorld::Ptr& actor);
@@ -171,8 +174,6 @@ namespace MWMechanics
             void getActorsFollowing(const MWWorld::Ptr &actor, std::set<MWWorld::Ptr>& out);
             /// Recursive version of getActorsSidingWith
             void getActorsSidingWith(const MWWorld::Ptr &actor, std::set<MWWorld::Ptr>& out);
-            /// Recursive version of getActorsSidingWith that takes, adds to and returns a cache of actors mapped to their allies
-            void getActorsSidingWith(const MWWorld::Ptr &actor, std::set<MWWorld::Ptr>& out, std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> >& cachedAllies);
 
             /// Get the list of AiFollow::mFollowIndex for all actors following this target
             std::list<int> getActorsFollowingIndices(const MWWorld::Ptr& actor);
@@ -201,11 +202,50 @@ namespace MWMechanics
             bool isTurningToPlayer(const MWWorld::Ptr& ptr) const;
 
     private:
+        /// Per-frame state of an actor, stored contiguously to avoid walking the map in the hot loops
+        struct ActorSlot;
+
         void updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl);
 
+        void addSlot(const MWWorld::Ptr& ptr, Actor& actor);
+        void removeSlot(const Actor& actor);
+        void compactSlots();
+        void refreshSlots(const MWWorld::Ptr& player);
+
+        /// Chooses the actors whose AI and animation are updated this frame, from their distance and visibility
+        void updateLod(const MWWorld::Ptr& player, float duration);
+
+        /// Actors within processing range of the position, as of the last slots refresh
+        void getSlotsInRange(const osg::Vec3f& position, std::pmr::vector<std::size_t>& out) const;
+
+        /// Rates the combat targets of the actors in processing range on the worker threads
+        void prepareAi(const MWWorld::Ptr& player);
+
+        /// Rebuilds the allies if an actor or a package making actors side with each other changed
+        void updateAllies();
+        /// Same as the recursive getActorsSidingWith, from the allies built by updateAllies
+        const std::set<MWWorld::Ptr>& getAllies(const MWWorld::Ptr& actor) const;
+
         PtrActorMap mActors;
+        std::vector<ActorSlot> mSlots;
+        bool mHasRemovedSlots = false;
+        // Slot indices sorted by grid cell
+        std::vector<std::pair<std::pair<int, int>, std::size_t>> mSlotsGrid;
+        std::map<MWWorld::Ptr, std::size_t> mAllyGroupIndices;
+        std::vector<std::set<MWWorld::Ptr>> mAllyGroups;
+        bool mAlliesDirty = true;
+        // Slots prepared by prepareAi during the current update
+        std::vector<std::size_t> mAiSlots;
+        WorkerPool mWorkers;
         float mTimerDisposeSummonsCorpses;
         float mActorsProcessingRange;
+        float mLodDistance = 0;
+        unsigned mLodInterval = 1;
+        unsigned mLodFrame = 0;
+        unsigned mNextLodPhase = 0;
+        unsigned mOffScreenAnimationInterval = 1;
+        float mSharedAnimationDistance = 0;
+        float mImpostorDistance = 0;
 
         bool mSmoothMovement;
     };
@@ -9,6 +9,7 @@
 
 #include "../mwworld/class.hpp"
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/gamesetting.hpp"
 #include "../mwworld/inventorystore.hpp"
 #include "../mwworld/actionequip.hpp"
 #include "../mwworld/cellstore.hpp"
@@ -23,11 +24,11 @@ namespace MWMechanics
 {
     float suggestCombatRange(int rangeTypes)
     {
-        static const float fCombatDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fCombatDistance")->mValue.getFloat();
-        static float fHandToHandReach = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fHandToHandReach")->mValue.getFloat();
+        static const MWWorld::GmstFloat fCombatDistance("fCombatDistance");
+        static const MWWorld::GmstFloat fHandToHandReach("fHandToHandReach");
 
         // This distance is a possible distance of melee attack
-        static float distance = fCombatDistance * std::max(2.f, fHandToHandReach);
+        const float distance = fCombatDistance * std::max(2.f, fHandToHandReach.get());
 
         if (rangeTypes & RangeTypes::Touch)
         {
@@ -114,13 +115,12 @@ namespace MWMechanics
     {
         isRanged = false;
 
-        static const float fCombatDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fCombatDistance")->mValue.getFloat();
-        static const float fProjectileMaxSpeed = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fProjectileMaxSpeed")->mValue.getFloat();
+        static const MWWorld::GmstFloat fCombatDistance("fCombatDistance");
+        static const MWWorld::GmstFloat fProjectileMaxSpeed("fProjectileMaxSpeed");
 
         if (mWeapon.isEmpty())
         {
-            static float fHandToHandReach =
-                MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fHandToHandReach")->mValue.getFloat();
+            static const MWWorld::GmstFloat fHandToHandReach("fHandToHandReach");
             return fHandToHandReach * fCombatDistance;
         }
 
@@ -385,8 +385,8 @@ namespace MWMechanics
 
         dist = (dist > 0.f) ? dist : 1.0f;
 
-        static const float fCombatDistance = gmst.find("fCombatDistance")->mValue.getFloat();
-        static const float fCombatDistanceWerewolfMod = gmst.find("fCombatDistanceWerewolfMod")->mValue.getFloat();
+        static const MWWorld::GmstFloat fCombatDistance("fCombatDistance");
+        static const MWWorld::GmstFloat fCombatDistanceWerewolfMod("fCombatDistanceWerewolfMod");
 
         float combatDistance = fCombatDistance;
         if (actor.getClass().isNpc() && actor.getClass().getNpcStats(actor).isWerewolf())
@@ -270,7 +270,7 @@ void AiSequence::execute (const MWWorld::Ptr& actor, CharacterController& charac
             }
             else
             {
-                float rating = MWMechanics::getBestActionRating(actor, target);
+                float rating = getCombatTargetRating(actor, **it, target);
 
                 const ESM::Position &targetPos = target.getRefData().getPosition();
 
@@ -304,6 +304,7 @@ void AiSequence::execute (const MWWorld::Ptr& actor, CharacterController& charac
         package = packageIt->get();
         packageTypeId = package->getTypeId();
     }
+    mCombatTargetRatings.clear();
 
     try
     {
@@ -332,6 +333,36 @@ void AiSequence::execute (const MWWorld::Ptr& actor, CharacterController& charac
     }
 }
 
+bool AiSequence::collectCombatTargets()
+{
+    mCombatTargetRatings.clear();
+    for (const auto& package : mPackages)
+    {
+        if (package->getTypeId() != AiPackageTypeId::Combat)
+            break;
+        MWWorld::Ptr target = package->getTarget();
+        if (!target.isEmpty())
+            mCombatTargetRatings.push_back({package.get(), target, 0.f});
+    }
+    return !mCombatTargetRatings.empty();
+}
+
+void AiSequence::rateCombatTargets(const MWWorld::Ptr& actor)
+{
+    for (CombatTargetRating& rating : mCombatTargetRatings)
+        rating.mRating = MWMechanics::getBestActionRating(actor, rating.mTarget);
+}
+
+float AiSequence::getCombatTargetRating(const MWWorld::Ptr& actor, const AiPackage& package, const MWWorld::Ptr& target) const
+{
+    // Packages and targets may have changed since the ratings were made
+    const auto it = std::find_if(mCombatTargetRatings.begin(), mCombatTargetRatings.end(),
+        [&] (const CombatTargetRating& rating) { return rating.mPackage == &package && rating.mTarget == target; });
+    if (it != mCombatTargetRatings.end())
+        return it->mRating;
+    return MWMechanics::getBestActionRating(actor, target);
+}
+
 void AiSequence::clear()
 {
     mPackages.clear();
@@ -10,10 +10,7 @@
 
 #include <components/esm3/loadnpc.hpp>
 
-namespace MWWorld
-{
-    class Ptr;
-}
+#include "../mwworld/ptr.hpp"
 
 namespace ESM
 {
@@ -54,6 +51,18 @@ namespace MWMechanics
             AiPackageTypeId mLastAiPackage;
             AiState mAiState;
 
+            struct CombatTargetRating
+            {
+                const AiPackage* mPackage;
+                MWWorld::Ptr mTarget;
+                float mRating;
+            };
+
+            /// Ratings of the combat targets made by rateCombatTargets for the next execute
+            std::vector<CombatTargetRating> mCombatTargetRatings;
+
+            float getCombatTargetRating(const MWWorld::Ptr& actor, const AiPackage& package, const MWWorld::Ptr& target) const;
+
             void onPackageAdded(const AiPackage& package);
             void onPackageRemoved(const AiPackage& package);
 
@@ -150,6 +159,15 @@ namespace MWMechanics
             /// Execute current package, switching if needed.
             void execute (const MWWorld::Ptr& actor, CharacterController& characterController, float duration, bool outOfRange=false);
 
+            /// Resolve the targets of the combat packages to be rated by rateCombatTargets.
+            /** Looks actors up in the world, so it can't run concurrently with other updates.
+                \return true if there is any target to rate **/
+            bool collectCombatTargets();
+
+            /// Rate the targets collected by collectCombatTargets, to be used by the next execute.
+            /** Only reads the world, so it can run for the sequences of different actors at the same time. **/
+            void rateCombatTargets(const MWWorld::Ptr& actor);
+
             /// Simulate the passing of time using the currently active AI package
             void fastForward(const MWWorld::Ptr &actor);
 
@@ -25,7 +25,7 @@
 #include <components/misc/rng.hpp>
 #include <components/misc/stringops.hpp>
 
-#include <components/settings/settings.hpp>
+#include <components/settings/settingvalue.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 
@@ -1529,7 +1529,8 @@ bool CharacterController::updateState(CharacterState& idle)
                 {
                     if(mPtr == getPlayer())
                     {
-                        if (Settings::Manager::getBool("best attack", "Game"))
+                        static const Settings::SettingValue<bool> bestAttack("best attack", "Game");
+                        if (bestAttack.get())
                         {
                             if (isWeapon)
                             {
@@ -2807,6 +2808,26 @@ void CharacterController::setActive(int active)
     mAnimation->setActive(active);
 }
 
+bool CharacterController::isOffScreen() const
+{
+    return mAnimation->isOffScreen();
+}
+
+void CharacterController::setSharedAnimation(bool shared)
+{
+    mAnimation->setSharedAnimation(shared);
+}
+
+void CharacterController::setImpostor(bool enabled)
+{
+    mAnimation->setImpostor(enabled);
+}
+
+bool CharacterController::hasImpostor() const
+{
+    return mAnimation->hasImpostor();
+}
+
 void CharacterController::setHeadTrackTarget(const MWWorld::ConstPtr &target)
 {
     mHeadTrackTarget = target;
@@ -299,6 +299,16 @@ public:
     /// @see Animation::setActive
     void setActive(int active);
 
+    /// @see Animation::isOffScreen
+    bool isOffScreen() const;
+
+    /// @see Animation::setSharedAnimation
+    void setSharedAnimation(bool shared);
+
+    /// @see Animation::setImpostor
+    void setImpostor(bool enabled);
+    bool hasImpostor() const;
+
     /// Make this character turn its head towards \a target. To turn off head tracking, pass an empty Ptr.
     void setHeadTrackTarget(const MWWorld::ConstPtr& target);
 
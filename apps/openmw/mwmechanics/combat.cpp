@@ -1,7 +1,7 @@
 #include "combat.hpp"
 
 #include <components/misc/rng.hpp>
-#include <components/settings/settings.hpp>
+#include <components/settings/settingvalue.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 
@@ -14,6 +14,7 @@
 #include "../mwworld/class.hpp"
 #include "../mwworld/inventorystore.hpp"
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/globals.hpp"
 
 #include "npcstats.hpp"
 #include "movement.hpp"
@@ -159,7 +160,8 @@ namespace MWMechanics
         bool isMagical = flags & ESM::Weapon::Magical;
         bool isEnchanted = !weapon.getClass().getEnchantment(weapon).empty();
 
-        return !isSilver && !isMagical && (!isEnchanted || !Settings::Manager::getBool("enchanted weapons are magical", "Game"));
+        static const Settings::SettingValue<bool> enchantedWeaponsAreMagical("enchanted weapons are magical", "Game");
+        return !isSilver && !isMagical && (!isEnchanted || !enchantedWeaponsAreMagical.get());
     }
 
     void resistNormalWeapon(const MWWorld::Ptr &actor, const MWWorld::Ptr& attacker, const MWWorld::Ptr &weapon, float &damage)
@@ -228,7 +230,8 @@ namespace MWMechanics
             damage += attack[0] + ((attack[1] - attack[0]) * attackStrength);
 
             adjustWeaponDamage(damage, weapon, attacker);
-            if (weapon == projectile || Settings::Manager::getBool("only appropriate ammunition bypasses resistance", "Game") || isNormalWeapon(weapon))
+            static const Settings::SettingValue<bool> onlyAppropriateAmmunition("only appropriate ammunition bypasses resistance", "Game");
+            if (weapon == projectile || onlyAppropriateAmmunition.get() || isNormalWeapon(weapon))
                 resistNormalWeapon(victim, attacker, projectile, damage);
             applyWerewolfDamageMult(victim, projectile, damage);
 
@@ -423,7 +426,8 @@ namespace MWMechanics
         // 0 = Do not factor strength into hand-to-hand combat.
         // 1 = Factor into werewolf hand-to-hand combat.
         // 2 = Ignore werewolves.
-        int factorStrength = Settings::Manager::getInt("strength influences hand to hand", "Game");
+        static const Settings::SettingValue<int> strengthInfluencesHandToHand("strength influences hand to hand", "Game");
+        const int factorStrength = strengthInfluencesHandToHand.get();
         if (factorStrength == 1 || (factorStrength == 2 && !isWerewolf)) {
             damage *= attacker.getClass().getCreatureStats(attacker).getAttribute(ESM::Attribute::Strength).getModified() / 40.0f;
         }
@@ -432,7 +436,8 @@ namespace MWMechanics
         {
             healthdmg = true;
             // GLOB instead of GMST because it gets updated during a quest
-            damage *= MWBase::Environment::get().getWorld()->getGlobalFloat("werewolfclawmult");
+            static const MWWorld::GlobalFloat werewolfClawMult("werewolfclawmult");
+            damage *= werewolfClawMult;
         }
         if(healthdmg)
             damage *= store.get<ESM::GameSetting>().find("fHandtoHandHealthPer")->mValue.getFloat();
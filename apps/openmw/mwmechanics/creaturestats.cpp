@@ -8,6 +8,7 @@
 
 #include "../mwworld/class.hpp"
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/gamesetting.hpp"
 #include "../mwworld/player.hpp"
 
 #include "../mwbase/environment.hpp"
@@ -397,12 +398,15 @@ namespace MWMechanics
         auto world = MWBase::Environment::get().getWorld();
         float intelligence = getAttribute(ESM::Attribute::Intelligence).getModified();
 
+        static const MWWorld::GmstFloat fPCbaseMagickaMult("fPCbaseMagickaMult");
+        static const MWWorld::GmstFloat fNPCbaseMagickaMult("fNPCbaseMagickaMult");
+
         float base = 1.f;
         const auto& player = world->getPlayerPtr();
         if (this == &player.getClass().getCreatureStats(player))
-            base = world->getStore().get<ESM::GameSetting>().find("fPCbaseMagickaMult")->mValue.getFloat();
+            base = fPCbaseMagickaMult;
         else
-            base = world->getStore().get<ESM::GameSetting>().find("fNPCbaseMagickaMult")->mValue.getFloat();
+            base = fNPCbaseMagickaMult;
 
         double magickaFactor = base + mMagicEffects.get(EffectKey(ESM::MagicEffect::FortifyMaximumMagicka)).getMagnitude() * 0.1;
 
@@ -656,6 +660,11 @@ namespace MWMechanics
         return mActorId;
     }
 
+    bool CreatureStats::hasActorId() const
+    {
+        return mActorId!=-1;
+    }
+
     bool CreatureStats::matchesActorId (int id) const
     {
         return mActorId!=-1 && id==mActorId;
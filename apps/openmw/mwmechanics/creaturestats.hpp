@@ -286,6 +286,9 @@ namespace MWMechanics
         int getActorId();
         ///< Will generate an actor ID, if the actor does not have one yet.
 
+        bool hasActorId() const;
+        ///< Check if an actor ID has been assigned to *this.
+
         bool matchesActorId (int id) const;
         ///< Check if \a id matches the actor ID of *this (if the actor does not have an ID
         /// assigned this function will return false).
@@ -1,6 +1,6 @@
 #include "difficultyscaling.hpp"
 
-#include <components/settings/settings.hpp>
+#include <components/settings/settingvalue.hpp>
 
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
@@ -13,7 +13,8 @@ float scaleDamage(float damage, const MWWorld::Ptr& attacker, const MWWorld::Ptr
     const MWWorld::Ptr& player = MWMechanics::getPlayer();
 
     // [-500, 500]
-    const int difficultySetting = std::clamp(Settings::Manager::getInt("difficulty", "Game"), -500, 500);
+    static const Settings::SettingValue<int> difficulty("difficulty", "Game");
+    const int difficultySetting = std::clamp(difficulty.get(), -500, 500);
 
     static const float fDifficultyMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fDifficultyMult")->mValue.getFloat();
 
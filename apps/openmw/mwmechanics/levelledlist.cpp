@@ -0,0 +1,136 @@
+#include "levelledlist.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <components/esm3/loadlevlist.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    struct Candidate
+    {
+        std::string mId;
+        // Set if the candidate is another levelled list
+        const ESM::LevelledListBase* mList = nullptr;
+        bool mCreature = false;
+        bool mExists = false;
+    };
+
+    struct CompiledList
+    {
+        // Distinct levels of the items, in ascending order
+        std::vector<int> mLevels;
+        // Candidates for player levels from mLevels[i] up to the next level, in the order of the list
+        std::vector<std::vector<Candidate>> mBands;
+    };
+
+    Candidate resolveCandidate(const MWWorld::ESMStore& store, const std::string& id)
+    {
+        Candidate candidate;
+        candidate.mId = id;
+        const int type = store.find(Misc::StringUtils::lowerCase(id));
+        candidate.mExists = type != 0;
+        if (type == static_cast<int>(ESM::ItemLevList::sRecordId))
+            candidate.mList = store.get<ESM::ItemLevList>().find(id);
+        else if (type == static_cast<int>(ESM::CreatureLevList::sRecordId))
+        {
+            candidate.mList = store.get<ESM::CreatureLevList>().find(id);
+            candidate.mCreature = true;
+        }
+        return candidate;
+    }
+
+    CompiledList compile(const MWWorld::ESMStore& store, const ESM::LevelledListBase& list, bool creature)
+    {
+        // For levelled creatures, the flags are swapped. This file format just makes so much sense.
+        bool allLevels = (list.mFlags & ESM::ItemLevList::AllLevels) != 0;
+        if (creature)
+            allLevels = list.mFlags & ESM::CreatureLevList::AllLevels;
+
+        CompiledList result;
+        for (const auto& levelledItem : list.mList)
+            result.mLevels.push_back(levelledItem.mLevel);
+        std::sort(result.mLevels.begin(), result.mLevels.end());
+        result.mLevels.erase(std::unique(result.mLevels.begin(), result.mLevels.end()), result.mLevels.end());
+
+        std::unordered_map<std::string, Candidate> resolved;
+        result.mBands.resize(result.mLevels.size());
+        for (std::size_t i = 0; i < result.mLevels.size(); ++i)
+        {
+            const int bandLevel = result.mLevels[i];
+            const int highestLevel = std::max(0, bandLevel);
+            for (const auto& levelledItem : list.mList)
+            {
+                if (bandLevel >= levelledItem.mLevel && (allLevels || levelledItem.mLevel == highestLevel))
+                {
+                    auto it = resolved.find(levelledItem.mId);
+                    if (it == resolved.end())
+                        it = resolved.emplace(levelledItem.mId, resolveCandidate(store, levelledItem.mId)).first;
+                    result.mBands[i].push_back(it->second);
+                }
+            }
+        }
+        return result;
+    }
+
+    struct CompiledLists
+    {
+        const MWWorld::ESMStore* mStore = nullptr;
+        unsigned int mRevision = 0;
+        std::unordered_map<const ESM::LevelledListBase*, CompiledList> mLists;
+    };
+
+    const std::vector<Candidate>* getCandidates(const ESM::LevelledListBase& list, bool creature, int playerLevel)
+    {
+        static CompiledLists compiledLists;
+
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        if (compiledLists.mStore != &store || compiledLists.mRevision != store.getRevision())
+        {
+            compiledLists.mStore = &store;
+            compiledLists.mRevision = store.getRevision();
+            compiledLists.mLists.clear();
+        }
+
+        auto it = compiledLists.mLists.find(&list);
+        if (it == compiledLists.mLists.end())
+            it = compiledLists.mLists.emplace(&list, compile(store, list, creature)).first;
+
+        const CompiledList& compiled = it->second;
+        const auto band = std::upper_bound(compiled.mLevels.begin(), compiled.mLevels.end(), playerLevel);
+        if (band == compiled.mLevels.begin())
+            return nullptr;
+        return &compiled.mBands[static_cast<std::size_t>(band - compiled.mLevels.begin()) - 1];
+    }
+}
+
+namespace MWMechanics
+{
+    std::string getLevelledItem (const ESM::LevelledListBase* levItem, bool creature, Misc::Rng::Seed& seed)
+    {
+        const MWWorld::Ptr& player = getPlayer();
+        int playerLevel = player.getClass().getCreatureStats(player).getLevel();
+
+        if (Misc::Rng::roll0to99(seed) < levItem->mChanceNone)
+            return std::string();
+
+        const std::vector<Candidate>* candidates = getCandidates(*levItem, creature, playerLevel);
+        if (candidates == nullptr || candidates->empty())
+            return std::string();
+        const Candidate& item = (*candidates)[Misc::Rng::rollDice(candidates->size(), seed)];
+
+        // Vanilla doesn't fail on nonexistent items in levelled lists
+        if (!item.mExists)
+        {
+            Log(Debug::Warning) << "Warning: ignoring nonexistent item '" << item.mId << "' in levelled list '" << levItem->mId << "'";
+            return std::string();
+        }
+
+        // Is this another levelled item or a real item?
+        if (item.mList == nullptr)
+            return item.mId;
+        return getLevelledItem(item.mList, item.mCreature, seed);
+    }
+}
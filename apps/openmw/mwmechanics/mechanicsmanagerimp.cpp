@@ -12,6 +12,8 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 
 #include "../mwworld/esmstore.hpp"
+#include "../mwworld/gamesetting.hpp"
+#include "../mwworld/globals.hpp"
 #include "../mwworld/inventorystore.hpp"
 #include "../mwworld/class.hpp"
 #include "../mwworld/player.hpp"
@@ -1729,13 +1731,10 @@ namespace MWMechanics
 
         if (ptr.getClass().isNpc() && target.getClass().isNpc())
         {
-            if (target.getClass().getNpcStats(target).isWerewolf() ||
-                    (target == getPlayer() &&
-                     MWBase::Environment::get().getWorld()->getGlobalInt("pcknownwerewolf")))
-            {
-                const ESM::GameSetting * iWerewolfFightMod = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("iWerewolfFightMod");
-                fight += iWerewolfFightMod->mValue.getInteger();
-            }
+            static const MWWorld::GlobalInt pcKnownWerewolf("pcknownwerewolf");
+            static const MWWorld::GmstInt iWerewolfFightMod("iWerewolfFightMod");
+            if (target.getClass().getNpcStats(target).isWerewolf() || (target == getPlayer() && pcKnownWerewolf))
+                fight += iWerewolfFightMod;
         }
 
         return (fight >= 100);
@@ -231,12 +231,13 @@ namespace MWMechanics
         else
         {
             auto path = pathgridGraph.aStarSearch(startNode, endNode.first);
+            auto pathBegin = path.begin();
 
             // If nearest path node is in opposite direction from second, remove it from path.
             // Especially useful for wandering actors, if the nearest node is blocked for some reason.
             if (path.size() > 1)
             {
-                ESM::Pathgrid::Point secondNode = *(++path.begin());
+                ESM::Pathgrid::Point secondNode = path[1];
                 osg::Vec3f firstNodeVec3f = makeOsgVec3(pathgrid->mPoints[startNode]);
                 osg::Vec3f secondNodeVec3f = makeOsgVec3(secondNode);
                 osg::Vec3f toSecondNodeVec3f = secondNodeVec3f - firstNodeVec3f;
@@ -251,12 +252,12 @@ namespace MWMechanics
                     bool isPathClear = !MWBase::Environment::get().getWorld()->castRay(
                         startPoint.x(), startPoint.y(), startPoint.z() + 16, temp.mX, temp.mY, temp.mZ + 16, mask);
                     if (isPathClear)
-                        path.pop_front();
+                        ++pathBegin;
                 }
             }
 
             // convert supplied path to world coordinates
-            std::transform(path.begin(), path.end(), out,
+            std::transform(pathBegin, path.end(), out,
                 [&] (ESM::Pathgrid::Point& point)
                 {
                     converter.toWorld(point);
@@ -436,6 +437,7 @@ namespace MWMechanics
         const auto world = MWBase::Environment::get().getWorld();
         const auto stepSize = getPathStepSize(actor);
         const auto navigator = world->getNavigator();
+        navigator->addDemand(halfExtents, startPoint, endPoint);
         const auto status = DetourNavigator::findPath(*navigator, halfExtents, stepSize,
             startPoint, endPoint, flags, areaCosts, endTolerance, out);
 
@@ -469,6 +471,7 @@ namespace MWMechanics
         std::deque<osg::Vec3f> prePath;
         auto prePathInserter = std::back_inserter(prePath);
         const float endTolerance = 0;
+        navigator->addDemand(halfExtents, startPoint, mPath.front());
         const auto status = DetourNavigator::findPath(*navigator, halfExtents, stepSize,
             startPoint, mPath.front(), flags, areaCosts, endTolerance, prePathInserter);
 
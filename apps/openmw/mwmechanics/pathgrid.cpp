@@ -6,6 +6,9 @@
 #include "../mwworld/cellstore.hpp"
 #include "../mwworld/esmstore.hpp"
 
+#include <algorithm>
+#include <functional>
+
 namespace
 {
     // See https://theory.stanford.edu/~amitp/GameProgramming/Heuristics.html
@@ -230,111 +233,107 @@ namespace MWMechanics
 
     /*
      * NOTE: Based on buildPath2(), please check git history if interested
-     *       Should consider using a 3rd party library version (e.g. boost)
      *
      * Find the shortest path to the target goal using a well known algorithm.
      * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
      * that mGraph is already constructed.
      *
-     * Should be possible to make this MT safe.
+     * Edge costs and the heuristic are both Manhattan distances, so the heuristic
+     * never overestimates and A* finds the same shortest path as Dijkstra.  Small
+     * pathgrids use that to cache Dijkstra shortest path trees for each start point.
      *
      * Returns path which may be empty.  path contains pathgrid points in local
      * cell coordinates (indoors) or world coordinates (external).
      *
      * Input params:
      *   start, goal - pathgrid point indexes (for this cell)
-     *
-     * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
-     *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
-     *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
      */
-    std::deque<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start, const int goal) const
+    PathgridGraph::Path PathgridGraph::aStarSearch(const int start, const int goal) const
     {
-        std::deque<ESM::Pathgrid::Point> path;
+        Path path;
         if(!isPointConnected(start, goal))
         {
             return path; // there is no path, return an empty path
         }
 
-        int graphSize = static_cast<int> (mGraph.size());
-        std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
-        std::vector<int> graphParent (graphSize, -1);
-
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        const std::vector<int>& parents = getParents(start, goal);
 
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
+        // reconstruct path to return, using local coordinates
+        for (int current = goal; current != start; current = parents[current])
+        {
+            if (current == -1)
+                return Path(); // for some reason couldn't build a path
+            path.push_back(mPathgrid->mPoints[current]);
+        }
 
-        int current = -1;
+        // add first node to path explicitly
+        path.push_back(mPathgrid->mPoints[start]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
 
-        while(!openset.empty())
+    const std::vector<int>& PathgridGraph::getParents(int start, int goal) const
+    {
+        if (mGraph.size() > sMaxRoutesCachePoints)
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
-
-            if(current == goal)
-                break;
+            search(start, goal, mParents);
+            return mParents;
+        }
 
-            closedset.push_back(current); // remember we've been here
+        mRoutes.resize(mGraph.size());
+        std::vector<int>& route = mRoutes[start];
+        if (route.empty())
+            search(start, -1, route);
+        return route;
+    }
 
-            // check all edges for the current point index
-            for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
-            {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
-                {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
-            }
+    void PathgridGraph::search(int start, int goal, std::vector<int>& parents) const
+    {
+        const std::size_t graphSize = mGraph.size();
+        parents.resize(graphSize, -1);
+        mCosts.resize(graphSize);
+        if (mVisited.size() != graphSize || ++mSearchId == 0)
+        {
+            mVisited.assign(graphSize, 0);
+            mSearchId = 1;
         }
 
-        if(current != goal)
-            return path; // for some reason couldn't build a path
+        const auto heuristic = [&] (int index)
+        {
+            return goal < 0 ? 0.0f : costAStar(mPathgrid->mPoints[index], mPathgrid->mPoints[goal]);
+        };
+
+        // min-heap ordered by estimated total cost, points are pushed again when a cheaper path is found
+        const auto compare = std::greater<std::pair<float, int>>();
+        mOpenSet.clear();
+        mVisited[start] = mSearchId;
+        mCosts[start] = 0;
+        parents[start] = -1;
+        mOpenSet.emplace_back(heuristic(start), start);
 
-        // reconstruct path to return, using local coordinates
-        while(graphParent[current] != -1)
+        while (!mOpenSet.empty())
         {
-            path.push_front(mPathgrid->mPoints[current]);
-            current = graphParent[current];
-        }
+            std::pop_heap(mOpenSet.begin(), mOpenSet.end(), compare);
+            const auto [estimate, current] = mOpenSet.back();
+            mOpenSet.pop_back();
 
-        // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
-        return path;
+            if (estimate > mCosts[current] + heuristic(current))
+                continue; // outdated entry
+
+            if (current == goal)
+                return;
+
+            for (const ConnectedPoint& edge : mGraph[current].edges)
+            {
+                const float cost = mCosts[current] + edge.cost;
+                if (mVisited[edge.index] == mSearchId && cost >= mCosts[edge.index])
+                    continue;
+                mVisited[edge.index] = mSearchId;
+                mCosts[edge.index] = cost;
+                parents[edge.index] = current;
+                mOpenSet.emplace_back(cost + heuristic(edge.index), edge.index);
+                std::push_heap(mOpenSet.begin(), mOpenSet.end(), compare);
+            }
+        }
     }
 }
-
@@ -1,7 +1,8 @@
 #ifndef GAME_MWMECHANICS_PATHGRID_H
 #define GAME_MWMECHANICS_PATHGRID_H
 
-#include <deque>
+#include <utility>
+#include <vector>
 
 #include <components/esm3/loadpgrd.hpp>
 
@@ -17,9 +18,12 @@ namespace MWWorld
 
 namespace MWMechanics
 {
+    /// @note Searches reuse internal buffers, so the same graph must not be searched concurrently
     class PathgridGraph
     {
         public:
+            using Path = std::vector<ESM::Pathgrid::Point>;
+
             PathgridGraph(const MWWorld::CellStore* cell);
 
             bool load(const MWWorld::CellStore *cell);
@@ -37,8 +41,8 @@ namespace MWMechanics
             // the output list is in local (internal cells) or world (external
             // cells) coordinates
             //
-            // NOTE: if start equals end an empty path is returned
-            std::deque<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
+            // NOTE: if start equals end a path with only start point is returned
+            Path aStarSearch(const int start, const int end) const;
 
         private:
 
@@ -78,6 +82,28 @@ namespace MWMechanics
             // methods used to calculate connected components
             void recursiveStrongConnect(int v);
             void buildConnectedPoints();
+
+            // Pathgrids with up to this number of points keep the shortest path tree of every searched start
+            // point, so repeated queries from the same point don't search again. Interior pathgrids are usually
+            // that small.
+            static constexpr std::size_t sMaxRoutesCachePoints = 256;
+
+            // Parent point index for each point on the shortest paths from the start point used as index, empty
+            // when not searched yet
+            mutable std::vector<std::vector<int>> mRoutes;
+
+            // Buffers reused by searches over larger pathgrids
+            mutable std::vector<int> mParents;
+            mutable std::vector<float> mCosts;
+            mutable std::vector<unsigned> mVisited;
+            mutable unsigned mSearchId = 0;
+            mutable std::vector<std::pair<float, int>> mOpenSet;
+
+            const std::vector<int>& getParents(int start, int goal) const;
+
+            // Fills parents with predecessors on the shortest paths from start. With negative goal visits all
+            // reachable points, otherwise stops when goal is reached.
+            void search(int start, int goal, std::vector<int>& parents) const;
     };
 }
 
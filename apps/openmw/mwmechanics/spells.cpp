@@ -17,21 +17,30 @@
 #include "magiceffects.hpp"
 #include "stat.hpp"
 
+namespace
+{
+    unsigned makeRevision()
+    {
+        static unsigned revision = 0;
+        return ++revision;
+    }
+}
+
 namespace MWMechanics
 {
-    Spells::Spells()
+    Spells::Spells() : mRevision(makeRevision())
     {
     }
 
     Spells::Spells(const Spells& spells) : mSpellList(spells.mSpellList), mSpells(spells.mSpells),
-        mSelectedSpell(spells.mSelectedSpell), mUsedPowers(spells.mUsedPowers)
+        mSelectedSpell(spells.mSelectedSpell), mUsedPowers(spells.mUsedPowers), mRevision(makeRevision())
     {
         if(mSpellList)
             mSpellList->addListener(this);
     }
 
     Spells::Spells(Spells&& spells) : mSpellList(std::move(spells.mSpellList)), mSpells(std::move(spells.mSpells)),
-        mSelectedSpell(std::move(spells.mSelectedSpell)), mUsedPowers(std::move(spells.mUsedPowers))
+        mSelectedSpell(std::move(spells.mSelectedSpell)), mUsedPowers(std::move(spells.mUsedPowers)), mRevision(makeRevision())
     {
         if (mSpellList)
             mSpellList->updateListener(&spells, this);
@@ -70,7 +79,10 @@ namespace MWMechanics
     void Spells::addSpell(const ESM::Spell* spell)
     {
         if (!hasSpell(spell))
+        {
             mSpells.emplace_back(spell);
+            mRevision = makeRevision();
+        }
     }
 
     void Spells::remove (const std::string& spellId)
@@ -87,12 +99,16 @@ namespace MWMechanics
     {
         const auto it = std::find(mSpells.begin(), mSpells.end(), spell);
         if(it != mSpells.end())
+        {
             mSpells.erase(it);
+            mRevision = makeRevision();
+        }
     }
 
     void Spells::removeAllSpells()
     {
         mSpells.clear();
+        mRevision = makeRevision();
     }
 
     void Spells::clear(bool modifyBase)
@@ -148,7 +164,10 @@ namespace MWMechanics
                 ++iter;
         }
         if(!purged.empty())
+        {
+            mRevision = makeRevision();
             mSpellList->removeAll(purged);
+        }
     }
 
     void Spells::purgeCommonDisease()
@@ -36,6 +36,9 @@ namespace MWMechanics
 
             std::map<const ESM::Spell*, MWWorld::TimeStamp> mUsedPowers;
 
+            // Changed whenever mSpells changes, unique across all instances
+            unsigned mRevision;
+
             bool hasDisease(const ESM::Spell::SpellType type) const;
 
             using SpellFilter = bool (*)(const ESM::Spell*);
@@ -69,6 +72,9 @@ namespace MWMechanics
 
             std::vector<const ESM::Spell*>::const_iterator end() const;
 
+            /// Returns a value which changes whenever spells are added or removed
+            unsigned getRevision() const { return mRevision; }
+
             bool hasSpell(const std::string& spell) const;
             bool hasSpell(const ESM::Spell* spell) const;
 
@@ -0,0 +1,105 @@
+#include "workerpool.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/threadbudget.hpp>
+
+namespace
+{
+    void runJob(const std::function<void(std::size_t)>& func, std::size_t index)
+    {
+        try
+        {
+            func(index);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Error in mechanics job: " << e.what();
+        }
+    }
+}
+
+namespace MWMechanics
+{
+    WorkerPool::WorkerPool(std::size_t threads)
+    {
+        mThreads.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            mThreads.emplace_back([this] { threadBody(); });
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard lock(mMutex);
+            mQuit = true;
+        }
+        mHasJobs.notify_all();
+        for (std::thread& thread : mThreads)
+            thread.join();
+    }
+
+    void WorkerPool::run(std::size_t count, const std::function<void(std::size_t)>& func)
+    {
+        if (mThreads.empty() || count <= 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                runJob(func, i);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mMutex);
+            mFunc = &func;
+            mCount = count;
+            mNext = 0;
+            mBusyThreads = mThreads.size();
+            ++mGeneration;
+        }
+        mHasJobs.notify_all();
+
+        work(count, func);
+
+        std::unique_lock lock(mMutex);
+        mJobsDone.wait(lock, [&] { return mBusyThreads == 0; });
+        mFunc = nullptr;
+    }
+
+    void WorkerPool::work(std::size_t count, const std::function<void(std::size_t)>& func)
+    {
+        for (std::size_t i = mNext.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = mNext.fetch_add(1, std::memory_order_relaxed))
+            runJob(func, i);
+    }
+
+    void WorkerPool::threadBody()
+    {
+        const std::shared_ptr<Misc::ThreadUsage> usage
+            = Misc::ThreadBudget::instance().registerCurrentThread(Misc::ThreadGroup::Ai);
+        unsigned generation = 0;
+        while (true)
+        {
+            const std::function<void(std::size_t)>* func = nullptr;
+            std::size_t count = 0;
+            {
+                std::unique_lock lock(mMutex);
+                mHasJobs.wait(lock, [&] { return mQuit || mGeneration != generation; });
+                if (mQuit)
+                    return;
+                generation = mGeneration;
+                func = mFunc;
+                count = mCount;
+            }
+
+            {
+                const Misc::ScopedThreadBusy busy(usage.get());
+                work(count, *func);
+            }
+
+            {
+                std::lock_guard lock(mMutex);
+                --mBusyThreads;
+            }
+            mJobsDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef OPENMW_MECHANICS_WORKERPOOL_H
+#define OPENMW_MECHANICS_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWMechanics
+{
+    /// @brief Runs independent per-actor jobs of the mechanics update on background threads
+    class WorkerPool
+    {
+        public:
+            /// @param threads number of background threads, with 0 all jobs run on the calling thread
+            explicit WorkerPool(std::size_t threads);
+            ~WorkerPool();
+
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            /// Call func for every index in [0, count) and return when all calls are done.
+            /// The calling thread takes part in the work. Exceptions thrown by func are logged.
+            void run(std::size_t count, const std::function<void(std::size_t)>& func);
+
+            std::size_t getThreadCount() const { return mThreads.size(); }
+
+        private:
+            void work(std::size_t count, const std::function<void(std::size_t)>& func);
+            void threadBody();
+
+            std::vector<std::thread> mThreads;
+            std::mutex mMutex;
+            std::condition_variable mHasJobs;
+            std::condition_variable mJobsDone;
+            const std::function<void(std::size_t)>* mFunc = nullptr;
+            std::size_t mCount = 0;
+            std::atomic<std::size_t> mNext {0};
+            std::size_t mBusyThreads = 0;
+            unsigned mGeneration = 0;
+            bool mQuit = false;
+    };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 
+#include "actorcost.hpp"
 #include "ptrholder.hpp"
 
 #include <LinearMath/btTransform.h>
@@ -156,6 +157,15 @@ namespace MWPhysics
             mLastStuckPosition = position;
         }
 
+        const ActorCost& getCost() const
+        {
+            return mCost;
+        }
+        void setCost(const ActorCost& cost)
+        {
+            mCost = cost;
+        }
+
         bool canMoveToWaterSurface(float waterlevel, const btCollisionWorld* world) const;
 
         /// Returns the mesh translation, scaled and rotated as necessary
@@ -190,6 +200,7 @@ namespace MWPhysics
 
         unsigned int mStuckFrames;
         osg::Vec3f mLastStuckPosition;
+        ActorCost mCost;
 
         osg::Vec3f mForce;
         bool mOnGround;
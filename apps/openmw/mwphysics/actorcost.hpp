@@ -0,0 +1,26 @@
+#ifndef OPENMW_MWPHYSICS_ACTORCOST_H
+#define OPENMW_MWPHYSICS_ACTORCOST_H
+
+#include "../mwworld/ptr.hpp"
+
+namespace MWPhysics
+{
+    /// Work done by the movement solver for an actor during the last frame
+    struct ActorCost
+    {
+        unsigned int mSolverIterations = 0;
+        unsigned int mStepAttempts = 0;
+        /// Traces of the movement which hit something
+        unsigned int mContacts = 0;
+        /// In seconds, only measured when [Physics] actor cost stats is enabled
+        float mTime = 0;
+    };
+
+    struct ExpensiveActor
+    {
+        MWWorld::Ptr mPtr;
+        ActorCost mCost;
+    };
+}
+
+#endif
@@ -0,0 +1,282 @@
+#include "cellgridbroadphase.hpp"
+
+#include "collisiontype.hpp"
+
+#include <BulletCollision/BroadphaseCollision/btOverlappingPairCache.h>
+#include <LinearMath/btAabbUtil2.h>
+
+#include <cmath>
+
+namespace MWPhysics
+{
+    struct CellGridBroadphase::Proxy : btBroadphaseProxy
+    {
+        bool mDynamic = false;
+        btDbvtNode* mLeaf = nullptr;
+        // Null for dynamic and large proxies
+        Cell* mCell = nullptr;
+        // Position in the vector holding the proxy
+        std::size_t mIndex = 0;
+    };
+
+    namespace
+    {
+        template <class Callback>
+        struct ProcessLeaf : btDbvt::ICollide
+        {
+            Callback& mCallback;
+
+            explicit ProcessLeaf(Callback& callback) : mCallback(callback) {}
+
+            void Process(const btDbvtNode* leaf) override
+            {
+                mCallback.process(static_cast<btBroadphaseProxy*>(leaf->data));
+            }
+        };
+
+        template <class T>
+        void removeAt(std::vector<T*>& items, std::size_t index)
+        {
+            items[index] = items.back();
+            items[index]->mIndex = index;
+            items.pop_back();
+        }
+    }
+
+    CellGridBroadphase::CellGridBroadphase(float cellSize)
+        : mCellSize(cellSize)
+        , mPairCache(std::make_unique<btHashedOverlappingPairCache>())
+    {
+    }
+
+    CellGridBroadphase::~CellGridBroadphase() = default;
+
+    btBroadphaseProxy* CellGridBroadphase::createProxy(const btVector3& aabbMin, const btVector3& aabbMax,
+        int /*shapeType*/, void* userPtr, int collisionFilterGroup, int collisionFilterMask, btDispatcher* /*dispatcher*/)
+    {
+        auto proxy = std::make_unique<Proxy>();
+        proxy->m_clientObject = userPtr;
+        proxy->m_collisionFilterGroup = collisionFilterGroup;
+        proxy->m_collisionFilterMask = collisionFilterMask;
+        proxy->m_aabbMin = aabbMin;
+        proxy->m_aabbMax = aabbMax;
+        proxy->m_uniqueId = mNextUniqueId++;
+        proxy->mDynamic = (collisionFilterGroup & (CollisionType_Actor | CollisionType_Projectile)) != 0;
+        insert(*proxy);
+        return proxy.release();
+    }
+
+    void CellGridBroadphase::destroyProxy(btBroadphaseProxy* proxy, btDispatcher* dispatcher)
+    {
+        std::unique_ptr<Proxy> value(static_cast<Proxy*>(proxy));
+        remove(*value);
+        mPairCache->removeOverlappingPairsContainingProxy(proxy, dispatcher);
+    }
+
+    void CellGridBroadphase::setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin, const btVector3& aabbMax,
+                                     btDispatcher* /*dispatcher*/)
+    {
+        Proxy& value = *static_cast<Proxy*>(proxy);
+        value.m_aabbMin = aabbMin;
+        value.m_aabbMax = aabbMax;
+        if (value.mDynamic)
+        {
+            btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin, aabbMax);
+            mDynamicTree.update(value.mLeaf, volume);
+            return;
+        }
+        remove(value);
+        insert(value);
+    }
+
+    void CellGridBroadphase::getAabb(btBroadphaseProxy* proxy, btVector3& aabbMin, btVector3& aabbMax) const
+    {
+        aabbMin = proxy->m_aabbMin;
+        aabbMax = proxy->m_aabbMax;
+    }
+
+    void CellGridBroadphase::rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback,
+                                     const btVector3& aabbMin, const btVector3& aabbMax)
+    {
+        thread_local btAlignedObjectArray<const btDbvtNode*> stack;
+        ProcessLeaf<btBroadphaseRayCallback> processLeaf(rayCallback);
+        mDynamicTree.rayTestInternal(mDynamicTree.m_root, rayFrom, rayTo, rayCallback.m_rayDirectionInverse,
+            rayCallback.m_signs, rayCallback.m_lambda_max, aabbMin, aabbMax, stack, processLeaf);
+
+        const auto intersects = [&] (const btVector3& min, const btVector3& max)
+        {
+            // Same test as btDbvt, the bounds are extended by the swept shape
+            const btVector3 bounds[2] = {min - aabbMax, max - aabbMin};
+            btScalar tmin = 0;
+            return btRayAabb2(rayFrom, rayCallback.m_rayDirectionInverse, rayCallback.m_signs, bounds, tmin,
+                              0, rayCallback.m_lambda_max);
+        };
+
+        for (const auto& [position, cell] : mCells)
+            if (intersects(cell.mAabbMin, cell.mAabbMax))
+                for (Proxy* proxy : cell.mProxies)
+                    if (intersects(proxy->m_aabbMin, proxy->m_aabbMax))
+                        rayCallback.process(proxy);
+
+        for (Proxy* proxy : mLargeProxies)
+            if (intersects(proxy->m_aabbMin, proxy->m_aabbMax))
+                rayCallback.process(proxy);
+    }
+
+    void CellGridBroadphase::aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback)
+    {
+        ProcessLeaf<btBroadphaseAabbCallback> processLeaf(callback);
+        mDynamicTree.collideTV(mDynamicTree.m_root, btDbvtVolume::FromMM(aabbMin, aabbMax), processLeaf);
+
+        for (const auto& [position, cell] : mCells)
+            if (TestAabbAgainstAabb2(aabbMin, aabbMax, cell.mAabbMin, cell.mAabbMax))
+                for (Proxy* proxy : cell.mProxies)
+                    if (TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax))
+                        callback.process(proxy);
+
+        for (Proxy* proxy : mLargeProxies)
+            if (TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax))
+                callback.process(proxy);
+    }
+
+    void CellGridBroadphase::calculateOverlappingPairs(btDispatcher* dispatcher)
+    {
+        struct RemoveSeparated : btOverlapCallback
+        {
+            bool processOverlap(btBroadphasePair& pair) override
+            {
+                return !TestAabbAgainstAabb2(pair.m_pProxy0->m_aabbMin, pair.m_pProxy0->m_aabbMax,
+                                             pair.m_pProxy1->m_aabbMin, pair.m_pProxy1->m_aabbMax);
+            }
+        };
+
+        struct AddPairs : btBroadphaseAabbCallback
+        {
+            btOverlappingPairCache& mPairCache;
+            btBroadphaseProxy* mProxy = nullptr;
+
+            explicit AddPairs(btOverlappingPairCache& pairCache) : mPairCache(pairCache) {}
+
+            bool process(const btBroadphaseProxy* proxy) override
+            {
+                // The pair cache ignores pairs it already contains
+                if (proxy != mProxy)
+                    mPairCache.addOverlappingPair(mProxy, const_cast<btBroadphaseProxy*>(proxy));
+                return true;
+            }
+        };
+
+        RemoveSeparated removeSeparated;
+        mPairCache->processAllOverlappingPairs(&removeSeparated, dispatcher);
+
+        AddPairs addPairs(*mPairCache);
+        for (Proxy* proxy : mDynamicProxies)
+        {
+            addPairs.mProxy = proxy;
+            aabbTest(proxy->m_aabbMin, proxy->m_aabbMax, addPairs);
+        }
+    }
+
+    btOverlappingPairCache* CellGridBroadphase::getOverlappingPairCache()
+    {
+        return mPairCache.get();
+    }
+
+    const btOverlappingPairCache* CellGridBroadphase::getOverlappingPairCache() const
+    {
+        return mPairCache.get();
+    }
+
+    void CellGridBroadphase::getBroadphaseAabb(btVector3& aabbMin, btVector3& aabbMax) const
+    {
+        bool empty = true;
+        const auto merge = [&] (const btVector3& min, const btVector3& max)
+        {
+            if (empty)
+            {
+                aabbMin = min;
+                aabbMax = max;
+                empty = false;
+                return;
+            }
+            aabbMin.setMin(min);
+            aabbMax.setMax(max);
+        };
+
+        if (mDynamicTree.m_root != nullptr)
+            merge(mDynamicTree.m_root->volume.Mins(), mDynamicTree.m_root->volume.Maxs());
+        for (const auto& [position, cell] : mCells)
+            merge(cell.mAabbMin, cell.mAabbMax);
+        for (const Proxy* proxy : mLargeProxies)
+            merge(proxy->m_aabbMin, proxy->m_aabbMax);
+
+        if (empty)
+        {
+            aabbMin.setValue(0, 0, 0);
+            aabbMax.setValue(0, 0, 0);
+        }
+    }
+
+    void CellGridBroadphase::insert(Proxy& proxy)
+    {
+        if (proxy.mDynamic)
+        {
+            proxy.mLeaf = mDynamicTree.insert(btDbvtVolume::FromMM(proxy.m_aabbMin, proxy.m_aabbMax), &proxy);
+            proxy.mIndex = mDynamicProxies.size();
+            mDynamicProxies.push_back(&proxy);
+            return;
+        }
+
+        const btVector3 size = proxy.m_aabbMax - proxy.m_aabbMin;
+        // Also true for infinite and NaN bounds
+        if (!(size.x() <= mCellSize && size.y() <= mCellSize))
+        {
+            proxy.mCell = nullptr;
+            proxy.mIndex = mLargeProxies.size();
+            mLargeProxies.push_back(&proxy);
+            return;
+        }
+
+        const btVector3 center = (proxy.m_aabbMin + proxy.m_aabbMax) * btScalar(0.5);
+        const std::pair<int, int> position(static_cast<int>(std::floor(center.x() / mCellSize)),
+                                           static_cast<int>(std::floor(center.y() / mCellSize)));
+        Cell& cell = mCells[position];
+        if (cell.mProxies.empty())
+        {
+            cell.mPosition = position;
+            cell.mAabbMin = proxy.m_aabbMin;
+            cell.mAabbMax = proxy.m_aabbMax;
+        }
+        else
+        {
+            cell.mAabbMin.setMin(proxy.m_aabbMin);
+            cell.mAabbMax.setMax(proxy.m_aabbMax);
+        }
+        proxy.mCell = &cell;
+        proxy.mIndex = cell.mProxies.size();
+        cell.mProxies.push_back(&proxy);
+    }
+
+    void CellGridBroadphase::remove(Proxy& proxy)
+    {
+        if (proxy.mDynamic)
+        {
+            mDynamicTree.remove(proxy.mLeaf);
+            proxy.mLeaf = nullptr;
+            removeAt(mDynamicProxies, proxy.mIndex);
+            return;
+        }
+
+        if (proxy.mCell == nullptr)
+        {
+            removeAt(mLargeProxies, proxy.mIndex);
+            return;
+        }
+
+        Cell& cell = *proxy.mCell;
+        proxy.mCell = nullptr;
+        removeAt(cell.mProxies, proxy.mIndex);
+        if (cell.mProxies.empty())
+            mCells.erase(cell.mPosition);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef OPENMW_MWPHYSICS_CELLGRIDBROADPHASE_H
+#define OPENMW_MWPHYSICS_CELLGRIDBROADPHASE_H
+
+#include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class btHashedOverlappingPairCache;
+
+namespace MWPhysics
+{
+    /// Broadphase keeping actors and projectiles in a dynamic tree, and everything else in a grid aligned to the cell
+    /// grid. Static objects are grouped by the cell containing their center and are never rebalanced, moving them
+    /// only touches their cell.
+    /// @note Queries may run concurrently, changes need exclusive access like for btDbvtBroadphase.
+    class CellGridBroadphase : public btBroadphaseInterface
+    {
+    public:
+        explicit CellGridBroadphase(float cellSize);
+        ~CellGridBroadphase() override;
+
+        btBroadphaseProxy* createProxy(const btVector3& aabbMin, const btVector3& aabbMax, int shapeType, void* userPtr,
+                                       int collisionFilterGroup, int collisionFilterMask, btDispatcher* dispatcher) override;
+
+        void destroyProxy(btBroadphaseProxy* proxy, btDispatcher* dispatcher) override;
+
+        void setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin, const btVector3& aabbMax,
+                     btDispatcher* dispatcher) override;
+
+        void getAabb(btBroadphaseProxy* proxy, btVector3& aabbMin, btVector3& aabbMax) const override;
+
+        void rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback,
+                     const btVector3& aabbMin = btVector3(0, 0, 0), const btVector3& aabbMax = btVector3(0, 0, 0)) override;
+
+        void aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback) override;
+
+        /// Pairs between static proxies are never reported
+        void calculateOverlappingPairs(btDispatcher* dispatcher) override;
+
+        btOverlappingPairCache* getOverlappingPairCache() override;
+        const btOverlappingPairCache* getOverlappingPairCache() const override;
+
+        void getBroadphaseAabb(btVector3& aabbMin, btVector3& aabbMax) const override;
+
+        void resetPool(btDispatcher* /*dispatcher*/) override {}
+
+        void printStats() override {}
+
+    private:
+        struct Proxy;
+
+        struct Cell
+        {
+            std::pair<int, int> mPosition;
+            // Only grows until the cell is empty, which may make queries test a few more proxies
+            btVector3 mAabbMin;
+            btVector3 mAabbMax;
+            std::vector<Proxy*> mProxies;
+        };
+
+        const float mCellSize;
+        int mNextUniqueId = 1;
+        btDbvt mDynamicTree;
+        std::vector<Proxy*> mDynamicProxies;
+        std::map<std::pair<int, int>, Cell> mCells;
+        // Static proxies larger than a cell, such as water
+        std::vector<Proxy*> mLargeProxies;
+        std::unique_ptr<btHashedOverlappingPairCache> mPairCache;
+
+        void insert(Proxy& proxy);
+        void remove(Proxy& proxy);
+
+        CellGridBroadphase(const CellGridBroadphase&) = delete;
+        CellGridBroadphase& operator=(const CellGridBroadphase&) = delete;
+    };
+}
+
+#endif
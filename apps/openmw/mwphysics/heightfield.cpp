@@ -10,6 +10,9 @@
 
 #include <LinearMath/btTransform.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <type_traits>
 
 #if BT_BULLET_VERSION < 310
@@ -50,28 +53,57 @@ namespace
 }
 #endif
 
+namespace
+{
+    std::vector<short> quantizeHeights(const float* heights, int verts, btScalar heightScale)
+    {
+        constexpr float limit = std::numeric_limits<short>::max();
+        std::vector<short> result(static_cast<std::size_t>(verts * verts));
+        for (std::size_t i = 0; i < result.size(); ++i)
+            result[i] = static_cast<short>(std::clamp(std::round(heights[i] / heightScale), -limit, limit));
+        return result;
+    }
+}
+
 namespace MWPhysics
 {
-    HeightField::HeightField(const float* heights, int x, int y, int size, int verts, float minH, float maxH,
-                             const osg::Object* holdObject, PhysicsTaskScheduler* scheduler)
-        : mHoldObject(holdObject)
-#if BT_BULLET_VERSION < 310
-        , mHeights(makeHeights(heights, verts))
-#endif
-        , mTaskScheduler(scheduler)
+    HeightFieldShape::HeightFieldShape(const float* heights, int size, int verts, float minH, float maxH, bool quantize,
+                                       const osg::Object* holdObject)
+        : mHoldObject(quantize ? nullptr : holdObject)
+        , mSource(heights)
+        , mSourceObject(holdObject)
     {
+        if (quantize)
+        {
+            // Bullet multiplies the raw values by heightScale, so the quantisation step depends on the largest
+            // absolute height. The bounds are widened by a step to keep rounded values inside them.
+            const float maxAbsHeight = std::max(std::abs(minH), std::abs(maxH));
+            const btScalar heightScale = maxAbsHeight > 0 ? maxAbsHeight / std::numeric_limits<short>::max() : 1;
+            mQuantizedHeights = quantizeHeights(heights, verts, heightScale);
+            mShape = std::make_unique<btHeightfieldTerrainShape>(
+                verts, verts,
+                mQuantizedHeights.data(),
+                heightScale,
+                minH - heightScale, maxH + heightScale, 2,
+                PHY_SHORT, false
+            );
+        }
+        else
+        {
 #if BT_BULLET_VERSION < 310
-        mShape = std::make_unique<btHeightfieldTerrainShape>(
-            verts, verts,
-            getHeights(heights, mHeights),
-            1,
-            minH, maxH, 2,
-            PHY_FLOAT, false
-        );
+            mHeights = makeHeights(heights, verts);
+            mShape = std::make_unique<btHeightfieldTerrainShape>(
+                verts, verts,
+                getHeights(heights, mHeights),
+                1,
+                minH, maxH, 2,
+                PHY_FLOAT, false
+            );
 #else
-        mShape = std::make_unique<btHeightfieldTerrainShape>(
-            verts, verts, heights, minH, maxH, 2, false);
+            mShape = std::make_unique<btHeightfieldTerrainShape>(
+                verts, verts, heights, minH, maxH, 2, false);
 #endif
+        }
         mShape->setUseDiamondSubdivision(true);
 
         const float scaling = static_cast<float>(size) / static_cast<float>(verts - 1);
@@ -85,12 +117,25 @@ namespace MWPhysics
         // https://github.com/bulletphysics/bullet3/issues/3276
         mShape->buildAccelerator();
 #endif
+    }
+
+    HeightFieldShape::~HeightFieldShape() = default;
+
+    bool HeightFieldShape::isBuiltFrom(const float* heights, const osg::Object* holdObject) const
+    {
+        return mSource == heights && mSourceObject == holdObject;
+    }
 
+    HeightField::HeightField(std::shared_ptr<HeightFieldShape> shape, int x, int y, int size, float minH, float maxH,
+                             PhysicsTaskScheduler* scheduler)
+        : mShape(std::move(shape))
+        , mTaskScheduler(scheduler)
+    {
         const btTransform transform(btQuaternion::getIdentity(),
                                     BulletHelpers::getHeightfieldShift(x, y, size, minH, maxH));
 
         mCollisionObject = std::make_unique<btCollisionObject>();
-        mCollisionObject->setCollisionShape(mShape.get());
+        mCollisionObject->setCollisionShape(mShape->get());
         mCollisionObject->setWorldTransform(transform);
         mTaskScheduler->addCollisionObject(mCollisionObject.get(), CollisionType_HeightMap, CollisionType_Actor|CollisionType_Projectile);
     }
@@ -112,6 +157,6 @@ namespace MWPhysics
 
     const btHeightfieldTerrainShape* HeightField::getShape() const
     {
-        return mShape.get();
+        return mShape->get();
     }
 }
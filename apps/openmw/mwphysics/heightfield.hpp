@@ -20,24 +20,50 @@ namespace MWPhysics
 {
     class PhysicsTaskScheduler;
 
+    /// Collision shape of a cell's terrain. Can outlive the HeightField using it to be reused when the cell is loaded again.
+    class HeightFieldShape
+    {
+    public:
+        /// @param quantize Store the heights as 16-bit integers instead of using the given array, which then doesn't
+        /// need to be kept alive.
+        HeightFieldShape(const float* heights, int size, int verts, float minH, float maxH, bool quantize,
+                         const osg::Object* holdObject);
+        ~HeightFieldShape();
+
+        btHeightfieldTerrainShape* get() const { return mShape.get(); }
+
+        /// Whether the shape was built from the given data
+        bool isBuiltFrom(const float* heights, const osg::Object* holdObject) const;
+
+    private:
+        std::unique_ptr<btHeightfieldTerrainShape> mShape;
+        osg::ref_ptr<const osg::Object> mHoldObject;
+        const float* mSource;
+        const osg::Object* mSourceObject;
+        std::vector<short> mQuantizedHeights;
+#if BT_BULLET_VERSION < 310
+        std::vector<btScalar> mHeights;
+#endif
+
+        HeightFieldShape(const HeightFieldShape&) = delete;
+        HeightFieldShape& operator=(const HeightFieldShape&) = delete;
+    };
+
     class HeightField
     {
     public:
-        HeightField(const float* heights, int x, int y, int size, int verts, float minH, float maxH,
-                    const osg::Object* holdObject, PhysicsTaskScheduler* scheduler);
+        HeightField(std::shared_ptr<HeightFieldShape> shape, int x, int y, int size, float minH, float maxH,
+                    PhysicsTaskScheduler* scheduler);
         ~HeightField();
 
         btCollisionObject* getCollisionObject();
         const btCollisionObject* getCollisionObject() const;
         const btHeightfieldTerrainShape* getShape() const;
+        const std::shared_ptr<HeightFieldShape>& getSharedShape() const { return mShape; }
 
     private:
-        std::unique_ptr<btHeightfieldTerrainShape> mShape;
+        std::shared_ptr<HeightFieldShape> mShape;
         std::unique_ptr<btCollisionObject> mCollisionObject;
-        osg::ref_ptr<const osg::Object> mHoldObject;
-#if BT_BULLET_VERSION < 310
-        std::vector<btScalar> mHeights;
-#endif
 
         PhysicsTaskScheduler* mTaskScheduler;
 
@@ -189,6 +189,7 @@ namespace MWPhysics
 
         for (int iterations = 0; iterations < sMaxIterations && remainingTime > 0.0001f; ++iterations)
         {
+            ++actor.mCost.mSolverIterations;
             osg::Vec3f nextpos = newPosition + velocity * remainingTime;
             bool underwater = newPosition.z() < swimlevel;
 
@@ -212,6 +213,7 @@ namespace MWPhysics
                     newPosition = tracer.mEndPos; // ok to move, so set newPosition
                     break;
                 }
+                ++actor.mCost.mContacts;
             }
             else
             {
@@ -235,6 +237,7 @@ namespace MWPhysics
             {
                 // Try to step up onto it.
                 // NOTE: this modifies newPosition and velocity on its own if successful
+                ++actor.mCost.mStepAttempts;
                 usedStepLogic = stepper.step(newPosition, velocity, remainingTime, seenGround, iterations == 0);
             }
             if (usedStepLogic)
@@ -1,13 +1,21 @@
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <numeric>
 
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
 
+#include <osg/BoundingBox>
 #include <osg/Stats>
 
 #include "components/debug/debuglog.hpp"
+#include "components/debug/tracing.hpp"
 #include <components/misc/barrier.hpp>
+#include "components/misc/constants.hpp"
 #include "components/misc/convert.hpp"
+#include "components/misc/threadbudget.hpp"
 #include "components/settings/settings.hpp"
 #include "../mwmechanics/actorutil.hpp"
 #include "../mwmechanics/movement.hpp"
@@ -15,6 +23,8 @@
 #include "../mwworld/class.hpp"
 
 #include "actor.hpp"
+#include "closestnotmerayresultcallback.hpp"
+#include "constants.hpp"
 #include "contacttestwrapper.h"
 #include "movementsolver.hpp"
 #include "mtphysics.hpp"
@@ -218,9 +228,18 @@ namespace
             const float mPhysicsDt;
             const btCollisionWorld* mCollisionWorld;
             const MWPhysics::WorldFrameData& mWorldFrameData;
+            const bool mMeasureActorCost;
             void operator()(const LockedActorSimulation& sim) const
             {
+                if (!mMeasureActorCost)
+                {
+                    MWPhysics::MovementSolver::move(sim.second, mPhysicsDt, mCollisionWorld, mWorldFrameData);
+                    return;
+                }
+                const osg::Timer* timer = osg::Timer::instance();
+                const osg::Timer_t start = timer->tick();
                 MWPhysics::MovementSolver::move(sim.second, mPhysicsDt, mCollisionWorld, mWorldFrameData);
+                sim.second.get().mCost.mTime += static_cast<float>(timer->delta_s(start, timer->tick()));
             }
             void operator()(const LockedProjectileSimulation& sim) const
             {
@@ -228,6 +247,38 @@ namespace
             }
         };
 
+        /// @brief conservative bounds of a simulation over the given time, which can't interact with anything outside of them
+        struct SweptBounds
+        {
+            const float mTime;
+            std::optional<osg::BoundingBoxf> operator()(MWPhysics::ActorSimulation& sim) const
+            {
+                auto locked = sim.lock();
+                if (!locked.has_value())
+                    return std::nullopt;
+                auto& [actor, frameDataRef] = *locked;
+                const auto& frameData = frameDataRef.get();
+                // Account for falling, stepping down and unsticking on top of the intended movement
+                const float travel = (frameData.mMovement.length() + frameData.mInertia.length()) * mTime
+                    + 0.5f * Constants::GravityConst * Constants::UnitsPerMeter * mTime * mTime
+                    + MWPhysics::sStepSizeDown;
+                const osg::Vec3f extents = actor->getHalfExtents() * 2 + osg::Vec3f(travel, travel, travel);
+                return osg::BoundingBoxf(frameData.mPosition - extents, frameData.mPosition + extents);
+            }
+            std::optional<osg::BoundingBoxf> operator()(MWPhysics::ProjectileSimulation& sim) const
+            {
+                auto locked = sim.lock();
+                if (!locked.has_value())
+                    return std::nullopt;
+                const auto& frameData = locked->second.get();
+                const osg::Vec3f margin(MWPhysics::sStepSizeDown, MWPhysics::sStepSizeDown, MWPhysics::sStepSizeDown);
+                osg::BoundingBoxf bounds(frameData.mPosition - margin, frameData.mPosition + margin);
+                bounds.expandBy(frameData.mPosition + frameData.mMovement * mTime - margin);
+                bounds.expandBy(frameData.mPosition + frameData.mMovement * mTime + margin);
+                return bounds;
+            }
+        };
+
         struct Sync
         {
             const bool mAdvanceSimulation;
@@ -268,6 +319,7 @@ namespace
                     actor->setOnSlope(frameData.mIsOnSlope);
                     actor->setWalkingOnWater(frameData.mWalkingOnWater);
                     actor->setInertialForce(frameData.mInertia);
+                    actor->setCost(frameData.mCost);
                 }
             }
             void operator()(MWPhysics::ProjectileSimulation& sim) const
@@ -286,7 +338,8 @@ namespace
         /// @return either the number of thread as configured by the user, or 1 if Bullet doesn't support multithreading and user requested more than 1 background threads
         int computeNumThreads()
         {
-            int wantedThread = Settings::Manager::getInt("async num threads", "Physics");
+            const int wantedThread = static_cast<int>(Misc::ThreadBudget::instance().getThreadCount(
+                Misc::ThreadGroup::Physics, Settings::Manager::getInt("async num threads", "Physics")));
 
             auto broad = std::make_unique<btDbvtBroadphase>();
             auto maxSupportedThreads = broad->m_rayTestStacks.size();
@@ -296,7 +349,21 @@ namespace
                 Log(Debug::Warning) << "Bullet was not compiled with multithreading support, 1 async thread will be used";
                 return 1;
             }
-            return std::max(0, wantedThread);
+            return wantedThread;
+        }
+
+        bool computeIslandScheduling(int numThreads)
+        {
+            // Islands only pay off when several threads can simulate them
+            return Settings::Manager::getBool("async island scheduling", "Physics") && numThreads > 1;
+        }
+
+        /// @return the maximum number of steps per frame in fixed tick mode, or 0 to adapt the step time instead
+        int computeMaxFixedSteps()
+        {
+            if (!Settings::Manager::getBool("fixed tick", "Physics"))
+                return 0;
+            return std::max(1, Settings::Manager::getInt("fixed tick max steps", "Physics"));
         }
     }
 }
@@ -310,9 +377,15 @@ namespace MWPhysics
           , mCollisionWorld(collisionWorld)
           , mDebugDrawer(debugDrawer)
           , mNumThreads(Config::computeNumThreads())
+          , mIslandScheduling(Config::computeIslandScheduling(mNumThreads))
+          , mMaxFixedSteps(Config::computeMaxFixedSteps())
+          , mMeasureActorCost(Settings::Manager::getBool("actor cost stats", "Physics"))
           , mNumJobs(0)
           , mRemainingSteps(0)
           , mLOSCacheExpiry(Settings::Manager::getInt("lineofsight keep inactive cache", "Physics"))
+          , mLOSStationaryCacheExpiry(mLOSCacheExpiry < 0 ? mLOSCacheExpiry
+                : std::max(mLOSCacheExpiry, Settings::Manager::getInt("lineofsight keep stationary cache", "Physics")))
+          , mLOSInvalidationDistance2(std::pow(std::max(0.f, Settings::Manager::getFloat("lineofsight invalidation distance", "Physics")), 2.f))
           , mFrameCounter(0)
           , mAdvanceSimulation(false)
           , mQuit(false)
@@ -337,6 +410,7 @@ namespace MWPhysics
         else
         {
             mLOSCacheExpiry = 0;
+            mLOSStationaryCacheExpiry = 0;
         }
 
         mPreStepBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
@@ -362,6 +436,10 @@ namespace MWPhysics
 
     std::tuple<int, float> PhysicsTaskScheduler::calculateStepConfig(float timeAccum) const
     {
+        // the step time never changes, so interpolation stays smooth; time beyond the step limit is dropped
+        if (mMaxFixedSteps > 0)
+            return std::make_tuple(std::min(static_cast<int>(timeAccum / mDefaultPhysicsDt), mMaxFixedSteps), mDefaultPhysicsDt);
+
         int maxAllowedSteps = 2;
         int numSteps = timeAccum / mDefaultPhysicsDt;
 
@@ -430,6 +508,15 @@ namespace MWPhysics
         auto [numSteps, newDelta] = calculateStepConfig(timeAccum);
         timeAccum -= numSteps*newDelta;
 
+        if (mMaxFixedSteps > 0 && timeAccum >= mDefaultPhysicsDt)
+        {
+            // keep less than a step so the simulation can't fall further behind
+            const int droppedSteps = static_cast<int>(timeAccum / mDefaultPhysicsDt);
+            timeAccum -= droppedSteps * mDefaultPhysicsDt;
+            mDroppedSteps += droppedSteps;
+        }
+        mSteps += numSteps;
+
         // init
         const Visitors::InitPosition vis{mCollisionWorld};
         for (auto& sim : simulations)
@@ -533,6 +620,7 @@ namespace MWPhysics
     {
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
         collisionObject->getBroadphaseHandle()->m_collisionFilterMask = collisionFilterMask;
+        ++mLOSWorldRevision;
     }
 
     void PhysicsTaskScheduler::addCollisionObject(btCollisionObject* collisionObject, int collisionFilterGroup, int collisionFilterMask)
@@ -540,6 +628,8 @@ namespace MWPhysics
         mCollisionObjects.insert(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
         mCollisionWorld->addCollisionObject(collisionObject, collisionFilterGroup, collisionFilterMask);
+        if (collisionFilterGroup & ~CollisionType_Actor)
+            ++mLOSWorldRevision;
     }
 
     void PhysicsTaskScheduler::removeCollisionObject(btCollisionObject* collisionObject)
@@ -547,6 +637,7 @@ namespace MWPhysics
         mCollisionObjects.erase(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
         mCollisionWorld->removeCollisionObject(collisionObject);
+        ++mLOSWorldRevision;
     }
 
     void PhysicsTaskScheduler::updateSingleAabb(std::shared_ptr<PtrHolder> ptr, bool immediate)
@@ -567,15 +658,33 @@ namespace MWPhysics
         MaybeExclusiveLock lock(mLOSCacheMutex, mNumThreads);
 
         auto req = LOSRequest(actor1, actor2);
-        auto result = std::find(mLOSCache.begin(), mLOSCache.end(), req);
-        if (result == mLOSCache.end())
+        const auto it = mLOSCacheIndex.find(req.mRawActors);
+        // The address of a removed actor may be reused by a new one
+        if (it != mLOSCacheIndex.end() && !mLOSCache[it->second].mActors[0].expired() && !mLOSCache[it->second].mActors[1].expired())
         {
-            req.mResult = hasLineOfSight(actor1.get(), actor2.get());
+            ++mLOSCacheHits;
+            LOSRequest& cached = mLOSCache[it->second];
+            cached.mAge = 0;
+            return cached.mResult;
+        }
+
+        ++mLOSCacheMisses;
+        updateLineOfSight(req, *actor1, *actor2);
+        if (it != mLOSCacheIndex.end())
+            mLOSCache[it->second] = req;
+        else
+        {
+            mLOSCacheIndex.emplace(req.mRawActors, mLOSCache.size());
             mLOSCache.push_back(req);
-            return req.mResult;
         }
-        result->mAge = 0;
-        return result->mResult;
+        return req.mResult;
+    }
+
+    void PhysicsTaskScheduler::updateLineOfSight(LOSRequest& request, const Actor& actor1, const Actor& actor2)
+    {
+        request.mWorldRevision = mLOSWorldRevision.load(std::memory_order_relaxed);
+        request.mPositions = {actor1.getCollisionObjectPosition(), actor2.getCollisionObjectPosition()};
+        request.mResult = hasLineOfSight(&actor1, &actor2);
     }
 
     void PhysicsTaskScheduler::refreshLOSCache()
@@ -583,16 +692,31 @@ namespace MWPhysics
         MaybeSharedLock lock(mLOSCacheMutex, mNumThreads);
         int job = 0;
         int numLOS = mLOSCache.size();
+        const unsigned int worldRevision = mLOSWorldRevision.load(std::memory_order_relaxed);
         while ((job = mNextLOS.fetch_add(1, std::memory_order_relaxed)) < numLOS)
         {
             auto& req = mLOSCache[job];
             auto actorPtr1 = req.mActors[0].lock();
             auto actorPtr2 = req.mActors[1].lock();
 
-            if (req.mAge++ > mLOSCacheExpiry || !actorPtr1 || !actorPtr2)
+            if (!actorPtr1 || !actorPtr2)
+            {
                 req.mStale = true;
-            else
-                req.mResult = hasLineOfSight(actorPtr1.get(), actorPtr2.get());
+                continue;
+            }
+
+            // Only recompute when the result may have changed, unchanged pairs are cheap to keep around longer
+            const bool changed = req.mWorldRevision != worldRevision
+                || (actorPtr1->getCollisionObjectPosition() - req.mPositions[0]).length2() > mLOSInvalidationDistance2
+                || (actorPtr2->getCollisionObjectPosition() - req.mPositions[1]).length2() > mLOSInvalidationDistance2;
+
+            if (req.mAge++ > (changed ? mLOSCacheExpiry : mLOSStationaryCacheExpiry))
+                req.mStale = true;
+            else if (changed)
+            {
+                updateLineOfSight(req, *actorPtr1, *actorPtr2);
+                ++mLOSCacheUpdates;
+            }
         }
 
     }
@@ -617,6 +741,7 @@ namespace MWPhysics
         {
             object->commitPositionChange();
             mCollisionWorld->updateSingleAabb(object->getCollisionObject());
+            ++mLOSWorldRevision;
         }
         else if (const auto projectile = std::dynamic_pointer_cast<Projectile>(ptr))
         {
@@ -627,6 +752,9 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::worker()
     {
+        Debug::Tracer::instance().setThreadName("PhysicsWorker");
+        const std::shared_ptr<Misc::ThreadUsage> usage
+            = Misc::ThreadBudget::instance().registerCurrentThread(Misc::ThreadGroup::Physics);
         std::size_t lastFrame = 0;
         std::shared_lock lock(mSimulationMutex);
         while (!mQuit)
@@ -637,6 +765,8 @@ namespace MWPhysics
                 lastFrame = mFrameCounter;
             }
 
+            const Debug::ScopedTrace trace("MWPhysics::Simulation");
+            const Misc::ScopedThreadBusy busy(usage.get());
             doSimulation();
         }
     }
@@ -666,11 +796,30 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::doSimulation()
     {
+        if (mIslandScheduling)
+        {
+            mPreStepBarrier->wait([this] { afterPreSim(); });
+            // Islands don't interact during the frame, so each one runs all of its steps without waiting for the others
+            int job = 0;
+            const int numIslands = static_cast<int>(mIslands.size());
+            while ((job = mNextJob.fetch_add(1, std::memory_order_relaxed)) < numIslands)
+                simulateIsland(mIslands[job]);
+
+            // Threads running out of islands refresh the line of sight cache while the others are still busy
+            refreshLOSCache();
+            processCastBatches();
+            mPostSimBarrier->wait([this] {
+                mRemainingSteps = 0;
+                afterPostSim();
+            });
+            return;
+        }
+
         while (mRemainingSteps)
         {
             mPreStepBarrier->wait([this] { afterPreStep(); });
             int job = 0;
-            const Visitors::Move impl{mPhysicsDt, mCollisionWorld, *mWorldFrameData};
+            const Visitors::Move impl{mPhysicsDt, mCollisionWorld, *mWorldFrameData, mMeasureActorCost};
             const Visitors::WithLockedPtr<Visitors::Move, MaybeLock> vis{impl, mCollisionWorldMutex, mNumThreads};
             while ((job = mNextJob.fetch_add(1, std::memory_order_relaxed)) < mNumJobs)
                 std::visit(vis, mSimulations[job]);
@@ -679,6 +828,7 @@ namespace MWPhysics
         }
 
         refreshLOSCache();
+        processCastBatches();
         mPostSimBarrier->wait([this] { afterPostSim(); });
     }
 
@@ -697,6 +847,19 @@ namespace MWPhysics
         mFrameNumber = frameNumber;
     }
 
+    void PhysicsTaskScheduler::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        {
+            MaybeSharedLock lock(mLOSCacheMutex, mNumThreads);
+            stats.setAttribute(frameNumber, "Physics LOS Cache", mLOSCache.size());
+        }
+        stats.setAttribute(frameNumber, "Physics LOS Hits", mLOSCacheHits.exchange(0));
+        stats.setAttribute(frameNumber, "Physics LOS Misses", mLOSCacheMisses.exchange(0));
+        stats.setAttribute(frameNumber, "Physics LOS Updates", mLOSCacheUpdates.exchange(0));
+        stats.setAttribute(frameNumber, "Physics Steps", mSteps.exchange(0));
+        stats.setAttribute(frameNumber, "Physics Dropped Steps", mDroppedSteps.exchange(0));
+    }
+
     void PhysicsTaskScheduler::debugDraw()
     {
         MaybeSharedLock lock(mCollisionWorldMutex, mNumThreads);
@@ -719,6 +882,90 @@ namespace MWPhysics
         mUpdateAabb.clear();
     }
 
+    void PhysicsTaskScheduler::queueCasts(std::shared_ptr<CastBatch> batch)
+    {
+        if (mNumThreads == 0)
+        {
+            runCasts(*batch);
+            return;
+        }
+        std::lock_guard lock(mCastBatchesMutex);
+        mCastBatches.push_back(std::move(batch));
+    }
+
+    void PhysicsTaskScheduler::runCasts(CastBatch& batch)
+    {
+        if (batch.mClaimed.exchange(true))
+            return;
+        for (std::size_t i = 0; i < batch.mJobs.size(); ++i)
+        {
+            const CastBatch::Job& job = batch.mJobs[i];
+            CastBatch::Result& result = batch.mResults[i];
+            if (job.mResolved)
+                continue;
+            switch (job.mType)
+            {
+                case CastRequest::Type::Ray:
+                {
+                    ClosestNotMeRayResultCallback callback(job.mIgnore, job.mTargets, job.mFrom, job.mTo);
+                    callback.m_collisionFilterGroup = job.mGroup;
+                    callback.m_collisionFilterMask = job.mMask;
+                    rayTest(job.mFrom, job.mTo, callback);
+                    result.mHit = callback.hasHit();
+                    if (result.mHit)
+                    {
+                        result.mHitPos = callback.m_hitPointWorld;
+                        result.mHitNormal = callback.m_hitNormalWorld;
+                        result.mHitObject = callback.m_collisionObject;
+                    }
+                    break;
+                }
+                case CastRequest::Type::Sphere:
+                {
+                    btCollisionWorld::ClosestConvexResultCallback callback(job.mFrom, job.mTo);
+                    callback.m_collisionFilterGroup = job.mGroup;
+                    callback.m_collisionFilterMask = job.mMask;
+                    const btSphereShape shape(job.mRadius);
+                    const btTransform from(btQuaternion::getIdentity(), job.mFrom);
+                    const btTransform to(btQuaternion::getIdentity(), job.mTo);
+                    convexSweepTest(&shape, from, to, callback);
+                    result.mHit = callback.hasHit();
+                    if (result.mHit)
+                    {
+                        result.mHitPos = callback.m_hitPointWorld;
+                        result.mHitNormal = callback.m_hitNormalWorld;
+                        result.mHitObject = callback.m_hitCollisionObject;
+                    }
+                    break;
+                }
+                case CastRequest::Type::LineOfSight:
+                {
+                    const auto actor1 = job.mActors[0].lock();
+                    const auto actor2 = job.mActors[1].lock();
+                    result.mHit = !actor1 || !actor2 || !hasLineOfSight(actor1.get(), actor2.get());
+                    break;
+                }
+            }
+        }
+        batch.mPromise.set_value();
+    }
+
+    void PhysicsTaskScheduler::processCastBatches()
+    {
+        while (true)
+        {
+            std::shared_ptr<CastBatch> batch;
+            {
+                std::lock_guard lock(mCastBatchesMutex);
+                if (mCastBatches.empty())
+                    return;
+                batch = std::move(mCastBatches.front());
+                mCastBatches.pop_front();
+            }
+            runCasts(*batch);
+        }
+    }
+
     void PhysicsTaskScheduler::afterPreStep()
     {
         updateAabbs();
@@ -730,6 +977,85 @@ namespace MWPhysics
             std::visit(vis, sim);
     }
 
+    void PhysicsTaskScheduler::afterPreSim()
+    {
+        updateAabbs();
+        mIslands.clear();
+        if (mRemainingSteps)
+            buildIslands();
+        mNextJob.store(0, std::memory_order_release);
+    }
+
+    void PhysicsTaskScheduler::buildIslands()
+    {
+        // Group the simulations with overlapping swept bounds, sweeping along the x axis
+        const Visitors::SweptBounds vis{mPhysicsDt * mRemainingSteps};
+        std::vector<std::pair<osg::BoundingBoxf, std::size_t>> bounds;
+        bounds.reserve(mSimulations.size());
+        for (std::size_t i = 0; i < mSimulations.size(); ++i)
+            if (const auto simBounds = std::visit(vis, mSimulations[i]))
+                bounds.emplace_back(*simBounds, i);
+        std::sort(bounds.begin(), bounds.end(),
+            [] (const auto& lhs, const auto& rhs) { return lhs.first.xMin() < rhs.first.xMin(); });
+
+        std::vector<std::size_t> parents(bounds.size());
+        std::iota(parents.begin(), parents.end(), 0);
+        const auto findRoot = [&] (std::size_t i)
+        {
+            while (parents[i] != i)
+                i = parents[i] = parents[parents[i]];
+            return i;
+        };
+        for (std::size_t i = 0; i < bounds.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < bounds.size() && bounds[j].first.xMin() <= bounds[i].first.xMax(); ++j)
+            {
+                if (bounds[i].first.intersects(bounds[j].first))
+                    parents[findRoot(i)] = findRoot(j);
+            }
+        }
+
+        constexpr std::size_t noIsland = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> islandIndices(bounds.size(), noIsland);
+        for (std::size_t i = 0; i < bounds.size(); ++i)
+        {
+            std::size_t& island = islandIndices[findRoot(i)];
+            if (island == noIsland)
+            {
+                island = mIslands.size();
+                mIslands.emplace_back();
+            }
+            mIslands[island].push_back(bounds[i].second);
+        }
+
+        for (auto& island : mIslands)
+            std::sort(island.begin(), island.end());
+        // Hand out the largest islands first, so the small ones fill the gaps at the end
+        std::stable_sort(mIslands.begin(), mIslands.end(),
+            [] (const auto& lhs, const auto& rhs) { return lhs.size() > rhs.size(); });
+    }
+
+    void PhysicsTaskScheduler::simulateIsland(const std::vector<std::size_t>& island)
+    {
+        const Visitors::PreStep preStepImpl{mCollisionWorld};
+        const Visitors::WithLockedPtr<Visitors::PreStep, MaybeExclusiveLock> preStep{preStepImpl, mCollisionWorldMutex, mNumThreads};
+        const Visitors::Move moveImpl{mPhysicsDt, mCollisionWorld, *mWorldFrameData, mMeasureActorCost};
+        const Visitors::WithLockedPtr<Visitors::Move, MaybeLock> move{moveImpl, mCollisionWorldMutex, mNumThreads};
+        const Visitors::UpdatePosition updateImpl{mCollisionWorld};
+        const Visitors::WithLockedPtr<Visitors::UpdatePosition, MaybeExclusiveLock> update{updateImpl, mCollisionWorldMutex, mNumThreads};
+
+        // Same order as the global steps: every simulation of the island moves from the positions of the previous step
+        for (int step = 0; step < mRemainingSteps; ++step)
+        {
+            for (const std::size_t index : island)
+                std::visit(preStep, mSimulations[index]);
+            for (const std::size_t index : island)
+                std::visit(move, mSimulations[index]);
+            for (const std::size_t index : island)
+                std::visit(update, mSimulations[index]);
+        }
+    }
+
     void PhysicsTaskScheduler::afterPostStep()
     {
         if (mRemainingSteps)
@@ -744,10 +1070,15 @@ namespace MWPhysics
     {
         {
             MaybeExclusiveLock lock(mLOSCacheMutex, mNumThreads);
-            mLOSCache.erase(
-                    std::remove_if(mLOSCache.begin(), mLOSCache.end(),
-                        [](const LOSRequest& req) { return req.mStale; }),
-                    mLOSCache.end());
+            const auto end = std::remove_if(mLOSCache.begin(), mLOSCache.end(),
+                [](const LOSRequest& req) { return req.mStale; });
+            if (end != mLOSCache.end())
+            {
+                mLOSCache.erase(end, mLOSCache.end());
+                mLOSCacheIndex.clear();
+                for (std::size_t i = 0; i < mLOSCache.size(); ++i)
+                    mLOSCacheIndex.emplace(mLOSCache[i].mRawActors, i);
+            }
         }
         mTimeEnd = mTimer->tick();
 
@@ -1,11 +1,15 @@
 #ifndef OPENMW_MWPHYSICS_MTPHYSICS_H
 #define OPENMW_MWPHYSICS_MTPHYSICS_H
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <future>
 #include <optional>
 #include <shared_mutex>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <variant>
 
@@ -16,6 +20,7 @@
 #include "physicssystem.hpp"
 #include "ptrholder.hpp"
 #include "components/misc/budgetmeasurement.hpp"
+#include "components/misc/hash.hpp"
 
 namespace Misc
 {
@@ -29,6 +34,50 @@ namespace MWRender
 
 namespace MWPhysics
 {
+    struct LOSRequestHash
+    {
+        std::size_t operator()(const std::array<const Actor*, 2>& actors) const noexcept
+        {
+            std::size_t seed = 0;
+            Misc::hashCombine(seed, actors[0]);
+            Misc::hashCombine(seed, actors[1]);
+            return seed;
+        }
+    };
+
+    /// Casts queued through PhysicsSystem::queueCasts
+    struct CastBatch
+    {
+        struct Job
+        {
+            CastRequest::Type mType;
+            btVector3 mFrom;
+            btVector3 mTo;
+            float mRadius = 0;
+            const btCollisionObject* mIgnore = nullptr;
+            std::vector<const btCollisionObject*> mTargets;
+            int mMask = 0;
+            int mGroup = 0;
+            std::array<std::weak_ptr<Actor>, 2> mActors;
+            // The result was already known when queueing
+            bool mResolved = false;
+        };
+
+        struct Result
+        {
+            bool mHit = false;
+            btVector3 mHitPos;
+            btVector3 mHitNormal;
+            const btCollisionObject* mHitObject = nullptr;
+        };
+
+        std::vector<Job> mJobs;
+        std::vector<Result> mResults;
+        std::atomic_bool mClaimed {false};
+        std::promise<void> mPromise;
+        std::shared_future<void> mDone {mPromise.get_future().share()};
+    };
+
     class PhysicsTaskScheduler
     {
         public:
@@ -59,21 +108,32 @@ namespace MWPhysics
             void debugDraw();
             void* getUserPointer(const btCollisionObject* object) const;
             void releaseSharedStates(); // destroy all objects whose destructor can't be safely called from ~PhysicsTaskScheduler()
+            void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
+            /// Run the casts next to the background simulation, or immediately without background threads
+            void queueCasts(std::shared_ptr<CastBatch> batch);
+            /// Run the casts on the calling thread, unless another thread already took them
+            void runCasts(CastBatch& batch);
 
         private:
             void doSimulation();
             void worker();
             void updateActorsPositions();
             bool hasLineOfSight(const Actor* actor1, const Actor* actor2);
+            void updateLineOfSight(LOSRequest& request, const Actor& actor1, const Actor& actor2);
             void refreshLOSCache();
             void updateAabbs();
             void updatePtrAabb(const std::shared_ptr<PtrHolder>& ptr);
             void updateStats(osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats);
             std::tuple<int, float> calculateStepConfig(float timeAccum) const;
             void afterPreStep();
+            void afterPreSim();
+            void buildIslands();
+            void simulateIsland(const std::vector<std::size_t>& island);
             void afterPostStep();
             void afterPostSim();
             void syncWithMainThread();
+            void processCastBatches();
             void waitForWorkers();
 
             std::unique_ptr<WorldFrameData> mWorldFrameData;
@@ -85,6 +145,15 @@ namespace MWPhysics
             btCollisionWorld* mCollisionWorld;
             MWRender::DebugDrawer* mDebugDrawer;
             std::vector<LOSRequest> mLOSCache;
+            std::unordered_map<std::array<const Actor*, 2>, std::size_t, LOSRequestHash> mLOSCacheIndex;
+            // Changed whenever something that can block the line of sight moves
+            std::atomic_uint mLOSWorldRevision {0};
+            mutable std::atomic_uint mLOSCacheHits {0};
+            mutable std::atomic_uint mLOSCacheMisses {0};
+            mutable std::atomic_uint mLOSCacheUpdates {0};
+            // Counted since the last reportStats
+            mutable std::atomic_uint mSteps {0};
+            mutable std::atomic_uint mDroppedSteps {0};
             std::set<std::shared_ptr<PtrHolder>> mUpdateAabb;
 
             // TODO: use std::experimental::flex_barrier or std::barrier once it becomes a thing
@@ -93,9 +162,17 @@ namespace MWPhysics
             std::unique_ptr<Misc::Barrier> mPostSimBarrier;
 
             int mNumThreads;
+            // Move groups of simulations that can't interact with each other independently instead of in global steps
+            const bool mIslandScheduling;
+            std::vector<std::vector<std::size_t>> mIslands;
+            // Run at most this number of steps of mDefaultPhysicsDt per frame, 0 to fall back to delta time
+            const int mMaxFixedSteps;
+            const bool mMeasureActorCost;
             int mNumJobs;
             int mRemainingSteps;
             int mLOSCacheExpiry;
+            int mLOSStationaryCacheExpiry;
+            float mLOSInvalidationDistance2;
             std::size_t mFrameCounter;
             bool mAdvanceSimulation;
             bool mQuit;
@@ -111,6 +188,8 @@ namespace MWPhysics
             mutable std::shared_mutex mCollisionWorldMutex;
             mutable std::shared_mutex mLOSCacheMutex;
             mutable std::mutex mUpdateAabbMutex;
+            std::deque<std::shared_ptr<CastBatch>> mCastBatches;
+            std::mutex mCastBatchesMutex;
             std::condition_variable_any mHasJob;
 
             unsigned int mFrameNumber;
@@ -2,7 +2,10 @@
 
 #include <LinearMath/btIDebugDraw.h>
 #include <LinearMath/btVector3.h>
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <tuple>
 #include <osg/Group>
 #include <osg/Stats>
 #include <osg/Timer>
@@ -24,7 +27,9 @@
 #include <components/debug/debuglog.hpp>
 #include <components/esm3/loadgmst.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/misc/constants.hpp>
 #include <components/misc/convert.hpp>
+#include <components/settings/settings.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -57,6 +62,7 @@
 #include "projectileconvexcallback.hpp"
 #include "movementsolver.hpp"
 #include "mtphysics.hpp"
+#include "cellgridbroadphase.hpp"
 
 namespace
 {
@@ -102,13 +108,18 @@ namespace MWPhysics
         , mWaterHeight(0)
         , mWaterEnabled(false)
         , mParentNode(parentNode)
+        , mHeightFieldShapeCacheSize(std::max(0, Settings::Manager::getInt("heightfield cache size", "Physics")))
+        , mQuantizeHeightFields(Settings::Manager::getBool("quantize heightfields", "Physics"))
         , mPhysicsDt(1.f / 60.f)
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
         mCollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
         mDispatcher = std::make_unique<btCollisionDispatcher>(mCollisionConfiguration.get());
-        mBroadphase = std::make_unique<btDbvtBroadphase>();
+        if (Settings::Manager::getBool("cell grid broadphase", "Physics"))
+            mBroadphase = std::make_unique<CellGridBroadphase>(static_cast<float>(Constants::CellSizeInUnits));
+        else
+            mBroadphase = std::make_unique<btDbvtBroadphase>();
 
         mCollisionWorld = std::make_unique<btCollisionWorld>(mDispatcher.get(), mBroadphase.get(), mCollisionConfiguration.get());
 
@@ -116,6 +127,13 @@ namespace MWPhysics
         // Should a "static" object ever be moved, we have to update its AABB manually using DynamicsWorld::updateSingleAabb.
         mCollisionWorld->setForceUpdateAllAabbs(false);
 
+        if (Settings::Manager::getBool("fixed tick", "Physics"))
+        {
+            const float tickRate = Settings::Manager::getFloat("fixed tick rate", "Physics");
+            if (tickRate > 0)
+                mPhysicsDt = 1.f / tickRate;
+        }
+
         // Check if a user decided to override a physics system FPS
         const char* env = getenv("OPENMW_PHYSICS_FPS");
         if (env)
@@ -141,6 +159,7 @@ namespace MWPhysics
 
         mTaskScheduler->releaseSharedStates();
         mHeightFields.clear();
+        mHeightFieldShapeCache.clear();
         mObjects.clear();
         mActors.clear();
         mProjectiles.clear();
@@ -285,22 +304,9 @@ namespace MWPhysics
         btVector3 btFrom = Misc::Convert::toBullet(from);
         btVector3 btTo = Misc::Convert::toBullet(to);
 
-        const btCollisionObject* me = nullptr;
+        const btCollisionObject* me = findCollisionObject(ignore);
         std::vector<const btCollisionObject*> targetCollisionObjects;
 
-        if (!ignore.isEmpty())
-        {
-            const Actor* actor = getActor(ignore);
-            if (actor)
-                me = actor->getCollisionObject();
-            else
-            {
-                const Object* object = getObject(ignore);
-                if (object)
-                    me = object->getCollisionObject();
-            }
-        }
-
         if (!targets.empty())
         {
             for (const MWWorld::Ptr& target : targets)
@@ -367,6 +373,92 @@ namespace MWPhysics
         return mTaskScheduler->getLineOfSight(it1->second, it2->second);
     }
 
+    const btCollisionObject* PhysicsSystem::findCollisionObject(const MWWorld::ConstPtr& ptr) const
+    {
+        if (ptr.isEmpty())
+            return nullptr;
+        if (const Actor* actor = getActor(ptr))
+            return actor->getCollisionObject();
+        if (const Object* object = getObject(ptr))
+            return object->getCollisionObject();
+        return nullptr;
+    }
+
+    std::shared_ptr<CastBatch> PhysicsSystem::queueCasts(const std::vector<CastRequest>& requests) const
+    {
+        auto batch = std::make_shared<CastBatch>();
+        batch->mJobs.reserve(requests.size());
+        batch->mResults.resize(requests.size());
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            const CastRequest& request = requests[i];
+            CastBatch::Job& job = batch->mJobs.emplace_back();
+            job.mType = request.mType;
+            job.mFrom = Misc::Convert::toBullet(request.mFrom);
+            job.mTo = Misc::Convert::toBullet(request.mTo);
+            job.mRadius = request.mRadius;
+            job.mMask = request.mMask;
+            job.mGroup = request.mGroup;
+            switch (request.mType)
+            {
+                case CastRequest::Type::Ray:
+                    // same as castRay
+                    job.mResolved = request.mFrom == request.mTo;
+                    job.mIgnore = findCollisionObject(request.mIgnore);
+                    for (const MWWorld::Ptr& target : request.mTargets)
+                        if (const Actor* actor = getActor(target))
+                            job.mTargets.push_back(actor->getCollisionObject());
+                    break;
+                case CastRequest::Type::Sphere:
+                    break;
+                case CastRequest::Type::LineOfSight:
+                {
+                    // same as getLineOfSight
+                    const auto it1 = mActors.find(request.mActor1.mRef);
+                    const auto it2 = mActors.find(request.mActor2.mRef);
+                    if (request.mActor1 == request.mActor2 || it1 == mActors.end() || it2 == mActors.end())
+                    {
+                        job.mResolved = true;
+                        batch->mResults[i].mHit = request.mActor1 != request.mActor2;
+                    }
+                    else
+                        job.mActors = {it1->second, it2->second};
+                    break;
+                }
+            }
+        }
+        mTaskScheduler->queueCasts(batch);
+        return batch;
+    }
+
+    std::optional<std::vector<RayCastingResult>> PhysicsSystem::getCastResults(CastBatch& batch, bool wait) const
+    {
+        if (wait)
+        {
+            mTaskScheduler->runCasts(batch);
+            batch.mDone.wait();
+        }
+        else if (batch.mDone.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return std::nullopt;
+
+        std::vector<RayCastingResult> results;
+        results.reserve(batch.mResults.size());
+        for (const CastBatch::Result& castResult : batch.mResults)
+        {
+            RayCastingResult& result = results.emplace_back();
+            result.mHit = castResult.mHit;
+            if (!castResult.mHit)
+                continue;
+            result.mHitPos = Misc::Convert::toOsg(castResult.mHitPos);
+            result.mHitNormal = Misc::Convert::toOsg(castResult.mHitNormal);
+            // Only look up objects which still exist
+            if (castResult.mHitObject)
+                if (auto* ptrHolder = static_cast<PtrHolder*>(mTaskScheduler->getUserPointer(castResult.mHitObject)))
+                    result.mHitObject = ptrHolder->getPtr();
+        }
+        return results;
+    }
+
     bool PhysicsSystem::isOnGround(const MWWorld::Ptr &actor)
     {
         Actor* physactor = getActor(actor);
@@ -458,14 +550,35 @@ namespace MWPhysics
 
     void PhysicsSystem::addHeightField(const float* heights, int x, int y, int size, int verts, float minH, float maxH, const osg::Object* holdObject)
     {
-        mHeightFields[std::make_pair(x,y)] = std::make_unique<HeightField>(heights, x, y, size, verts, minH, maxH, holdObject, mTaskScheduler.get());
+        const auto key = std::make_pair(x, y);
+        std::shared_ptr<HeightFieldShape> shape;
+        const auto cached = std::find_if(mHeightFieldShapeCache.begin(), mHeightFieldShapeCache.end(),
+                                         [&] (const auto& v) { return v.first == key; });
+        if (cached != mHeightFieldShapeCache.end())
+        {
+            if (cached->second->isBuiltFrom(heights, holdObject))
+                shape = std::move(cached->second);
+            mHeightFieldShapeCache.erase(cached);
+        }
+        if (shape == nullptr)
+            shape = std::make_shared<HeightFieldShape>(heights, size, verts, minH, maxH, mQuantizeHeightFields, holdObject);
+        mHeightFields[key] = std::make_unique<HeightField>(std::move(shape), x, y, size, minH, maxH, mTaskScheduler.get());
     }
 
     void PhysicsSystem::removeHeightField (int x, int y)
     {
         HeightFieldMap::iterator heightfield = mHeightFields.find(std::make_pair(x,y));
         if(heightfield != mHeightFields.end())
+        {
+            // Keep the shape to not rebuild it when moving back and forth across cell borders
+            if (mHeightFieldShapeCacheSize > 0)
+            {
+                mHeightFieldShapeCache.emplace_front(heightfield->first, heightfield->second->getSharedShape());
+                if (mHeightFieldShapeCache.size() > mHeightFieldShapeCacheSize)
+                    mHeightFieldShapeCache.pop_back();
+            }
             mHeightFields.erase(heightfield);
+        }
     }
 
     const HeightField* PhysicsSystem::getHeightField(int x, int y) const
@@ -559,6 +672,23 @@ namespace MWPhysics
         return nullptr;
     }
 
+    std::vector<ExpensiveActor> PhysicsSystem::getMostExpensiveActors(std::size_t count) const
+    {
+        std::vector<ExpensiveActor> result;
+        result.reserve(mActors.size());
+        for (const auto& [ref, actor] : mActors)
+            result.push_back(ExpensiveActor {actor->getPtr(), actor->getCost()});
+        const auto key = [] (const ExpensiveActor& v)
+        {
+            return std::make_tuple(v.mCost.mTime, v.mCost.mSolverIterations, v.mCost.mStepAttempts, v.mCost.mContacts);
+        };
+        const auto middle = result.begin() + std::min(count, result.size());
+        std::partial_sort(result.begin(), middle, result.end(),
+            [&] (const ExpensiveActor& lhs, const ExpensiveActor& rhs) { return key(lhs) > key(rhs); });
+        result.erase(middle, result.end());
+        return result;
+    }
+
     Projectile* PhysicsSystem::getProjectile(int projectileId) const
     {
         ProjectileMap::const_iterator found = mProjectiles.find(projectileId);
@@ -647,7 +777,7 @@ namespace MWPhysics
 
         mProjectileId++;
 
-        auto projectile = std::make_shared<Projectile>(caster, position, radius, mTaskScheduler.get(), this);
+        auto projectile = std::make_shared<Projectile>(mProjectileId, caster, position, radius, mTaskScheduler.get(), this);
         mProjectiles.emplace(mProjectileId, std::move(projectile));
 
         return mProjectileId;
@@ -918,6 +1048,7 @@ namespace MWPhysics
         stats.setAttribute(frameNumber, "Physics Objects", mObjects.size());
         stats.setAttribute(frameNumber, "Physics Projectiles", mProjectiles.size());
         stats.setAttribute(frameNumber, "Physics HeightFields", mHeightFields.size());
+        mTaskScheduler->reportStats(frameNumber, stats);
     }
 
     void PhysicsSystem::reportCollision(const btVector3& position, const btVector3& normal)
@@ -926,6 +1057,24 @@ namespace MWPhysics
             mDebugDrawer->addCollision(position, normal);
     }
 
+    void PhysicsSystem::reportProjectileHit(int projectileId)
+    {
+        std::lock_guard lock(mProjectileHitsMutex);
+        mProjectileHits.push_back(projectileId);
+    }
+
+    std::vector<int> PhysicsSystem::takeProjectileHits()
+    {
+        std::vector<int> result;
+        {
+            std::lock_guard lock(mProjectileHitsMutex);
+            result.swap(mProjectileHits);
+        }
+        // Threads report the hits in any order, keep their effects deterministic
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
     ActorFrameData::ActorFrameData(Actor& actor, bool inert, bool waterCollision, float slowFall, float waterlevel)
         : mPosition()
         , mStandingOn(nullptr)
@@ -966,7 +1115,7 @@ namespace MWPhysics
     {}
 
     LOSRequest::LOSRequest(const std::weak_ptr<Actor>& a1, const std::weak_ptr<Actor>& a2)
-        : mResult(false), mStale(false), mAge(0)
+        : mWorldRevision(0), mResult(false), mStale(false), mAge(0)
     {
         // we use raw actor pointer pair to uniquely identify request
         // sort the pointer value in ascending order to not duplicate equivalent requests, eg. getLOS(A, B) and getLOS(B, A)
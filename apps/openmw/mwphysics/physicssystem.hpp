@@ -2,8 +2,10 @@
 #define OPENMW_MWPHYSICS_PHYSICSSYSTEM_H
 
 #include <array>
+#include <list>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <algorithm>
@@ -19,6 +21,7 @@
 #include "../mwworld/ptr.hpp"
 
 #include "collisiontype.hpp"
+#include "actorcost.hpp"
 #include "raycasting.hpp"
 
 namespace osg
@@ -50,6 +53,7 @@ class btVector3;
 namespace MWPhysics
 {
     class HeightField;
+    class HeightFieldShape;
     class Object;
     class Actor;
     class PhysicsTaskScheduler;
@@ -69,6 +73,9 @@ namespace MWPhysics
         LOSRequest(const std::weak_ptr<Actor>& a1, const std::weak_ptr<Actor>& a2);
         std::array<std::weak_ptr<Actor>, 2> mActors;
         std::array<const Actor*, 2> mRawActors;
+        // State the result was computed for
+        std::array<osg::Vec3f, 2> mPositions;
+        unsigned int mWorldRevision;
         bool mResult;
         bool mStale;
         int mAge;
@@ -100,6 +107,7 @@ namespace MWPhysics
         const bool mIsAquatic;
         const bool mWaterCollision;
         const bool mSkipCollisionDetection;
+        ActorCost mCost;
     };
 
     struct ProjectileFrameData
@@ -169,6 +177,13 @@ namespace MWPhysics
 
             Projectile* getProjectile(int projectileId) const;
 
+            /// Actors which took the most time to move during the last frame, or the most solver work without
+            /// [Physics] actor cost stats. Sorted from the most expensive.
+            std::vector<ExpensiveActor> getMostExpensiveActors(std::size_t count) const;
+
+            /// Projectiles which hit something since the last call, in the order they were added
+            std::vector<int> takeProjectileHits();
+
             // Object or Actor
             void remove (const MWWorld::Ptr& ptr);
 
@@ -218,6 +233,15 @@ namespace MWPhysics
             /// Return true if actor1 can see actor2.
             bool getLineOfSight(const MWWorld::ConstPtr& actor1, const MWWorld::ConstPtr& actor2) const override;
 
+            /// Queue casts to run on the physics threads next to the background simulation.
+            /// @note The casts run immediately if there are no background threads.
+            std::shared_ptr<CastBatch> queueCasts(const std::vector<CastRequest>& requests) const override;
+
+            /// @return the results in the order of the requests, or nothing if the casts are not done yet.
+            /// For line of sight requests mHit tells if the sight is blocked.
+            /// @param wait run the casts on the calling thread if no physics thread took them yet, and wait for them
+            std::optional<std::vector<RayCastingResult>> getCastResults(CastBatch& batch, bool wait = false) const override;
+
             bool isOnGround (const MWWorld::Ptr& actor);
 
             bool canMoveToWaterSurface (const MWWorld::ConstPtr &actor, const float waterlevel);
@@ -281,6 +305,8 @@ namespace MWPhysics
 
             void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
             void reportCollision(const btVector3& position, const btVector3& normal);
+            /// @note May be called from the physics threads
+            void reportProjectileHit(int projectileId);
 
         private:
 
@@ -288,6 +314,9 @@ namespace MWPhysics
 
             std::vector<Simulation> prepareSimulation(bool willSimulate);
 
+            /// @return the collision object of an actor or an object
+            const btCollisionObject* findCollisionObject(const MWWorld::ConstPtr& ptr) const;
+
             std::unique_ptr<btBroadphaseInterface> mBroadphase;
             std::unique_ptr<btDefaultCollisionConfiguration> mCollisionConfiguration;
             std::unique_ptr<btCollisionDispatcher> mDispatcher;
@@ -307,9 +336,17 @@ namespace MWPhysics
             using ProjectileMap = std::map<int, std::shared_ptr<Projectile>>;
             ProjectileMap mProjectiles;
 
+            std::mutex mProjectileHitsMutex;
+            std::vector<int> mProjectileHits;
+
             using HeightFieldMap = std::map<std::pair<int, int>, std::unique_ptr<HeightField>>;
             HeightFieldMap mHeightFields;
 
+            // Shapes of recently unloaded heightfields, most recent first
+            std::list<std::pair<std::pair<int, int>, std::shared_ptr<HeightFieldShape>>> mHeightFieldShapeCache;
+            std::size_t mHeightFieldShapeCacheSize;
+            bool mQuantizeHeightFields;
+
             bool mDebugDrawEnabled;
 
             float mTimeAccum;
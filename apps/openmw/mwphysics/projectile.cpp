@@ -8,6 +8,7 @@
 #include "../mwworld/class.hpp"
 
 #include "actor.hpp"
+#include "physicssystem.hpp"
 #include "collisiontype.hpp"
 #include "mtphysics.hpp"
 #include "object.hpp"
@@ -15,8 +16,9 @@
 
 namespace MWPhysics
 {
-Projectile::Projectile(const MWWorld::Ptr& caster, const osg::Vec3f& position, float radius, PhysicsTaskScheduler* scheduler, PhysicsSystem* physicssystem)
-    : mHitWater(false)
+Projectile::Projectile(int id, const MWWorld::Ptr& caster, const osg::Vec3f& position, float radius, PhysicsTaskScheduler* scheduler, PhysicsSystem* physicssystem)
+    : mId(id)
+    , mHitWater(false)
     , mActive(true)
     , mHitTarget(nullptr)
     , mPhysics(physicssystem)
@@ -65,6 +67,7 @@ void Projectile::hit(const btCollisionObject* target, btVector3 pos, btVector3 n
     mHitTarget = target;
     mHitPosition = pos;
     mHitNormal = normal;
+    mPhysics->reportProjectileHit(mId);
 }
 
 MWWorld::Ptr Projectile::getTarget() const
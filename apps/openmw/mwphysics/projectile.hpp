@@ -31,9 +31,11 @@ namespace MWPhysics
     class Projectile final : public PtrHolder
     {
     public:
-        Projectile(const MWWorld::Ptr& caster, const osg::Vec3f& position, float radius, PhysicsTaskScheduler* scheduler, PhysicsSystem* physicssystem);
+        Projectile(int id, const MWWorld::Ptr& caster, const osg::Vec3f& position, float radius, PhysicsTaskScheduler* scheduler, PhysicsSystem* physicssystem);
         ~Projectile() override;
 
+        int getId() const { return mId; }
+
         btConvexShape* getConvexShape() const { return mConvexShape; }
 
         void updateCollisionObjectPosition();
@@ -74,6 +76,7 @@ namespace MWPhysics
 
     private:
 
+        const int mId;
         std::unique_ptr<btCollisionShape> mShape;
         btConvexShape* mConvexShape;
 
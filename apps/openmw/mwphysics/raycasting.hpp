@@ -1,6 +1,10 @@
 #ifndef OPENMW_MWPHYSICS_RAYCASTING_H
 #define OPENMW_MWPHYSICS_RAYCASTING_H
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <osg/Vec3f>
 
 #include "../mwworld/ptr.hpp"
@@ -9,6 +13,8 @@
 
 namespace MWPhysics
 {
+    struct CastBatch;
+
     struct RayCastingResult
     {
         bool mHit;
@@ -17,6 +23,28 @@ namespace MWPhysics
         MWWorld::Ptr mHitObject;
     };
 
+    /// A cast to run on the physics threads, see PhysicsSystem::queueCasts
+    struct CastRequest
+    {
+        enum class Type
+        {
+            Ray,
+            Sphere,
+            LineOfSight
+        };
+
+        Type mType = Type::Ray;
+        osg::Vec3f mFrom;
+        osg::Vec3f mTo;
+        float mRadius = 0; // Sphere only
+        MWWorld::ConstPtr mIgnore; // Ray only
+        std::vector<MWWorld::Ptr> mTargets; // Ray only
+        int mMask = CollisionType_Default;
+        int mGroup = 0xff;
+        MWWorld::ConstPtr mActor1; // LineOfSight only
+        MWWorld::ConstPtr mActor2; // LineOfSight only
+    };
+
     class RayCastingInterface
     {
         public:
@@ -36,6 +64,13 @@ namespace MWPhysics
 
             /// Return true if actor1 can see actor2.
             virtual bool getLineOfSight(const MWWorld::ConstPtr& actor1, const MWWorld::ConstPtr& actor2) const = 0;
+
+            /// Queue casts to be run later, the results are available from getCastResults.
+            virtual std::shared_ptr<CastBatch> queueCasts(const std::vector<CastRequest>& requests) const = 0;
+
+            /// @return the results in the order of the requests, or nothing if the casts are not done yet.
+            /// @param wait finish the casts if they are not done yet
+            virtual std::optional<std::vector<RayCastingResult>> getCastResults(CastBatch& batch, bool wait = false) const = 0;
     };
 }
 
@@ -0,0 +1,232 @@
+#include "actorimpostor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <osg/BlendFunc>
+#include <osg/Billboard>
+#include <osg/Camera>
+#include <osg/Fog>
+#include <osg/Geometry>
+#include <osg/Material>
+#include <osg/MatrixTransform>
+#include <osg/Texture2D>
+
+#include <osgUtil/CullVisitor>
+#include <osgUtil/RenderStage>
+
+#include <components/resource/scenemanager.hpp>
+#include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/nodecallback.hpp>
+#include <components/sceneutil/rtt.hpp>
+#include <components/sceneutil/shadow.hpp>
+
+#include "vismask.hpp"
+
+namespace MWRender
+{
+    namespace
+    {
+        constexpr unsigned sTextureSize = 128;
+        constexpr double sUpdateInterval = 0.2;
+        const float sUpdateAngle = std::cos(osg::DegreesToRadians(5.f));
+
+        /// Places the actor in the world for the impostor camera, without becoming another parent of its node.
+        class ActorTransform : public osg::MatrixTransform
+        {
+        public:
+            ActorTransform(osg::Group* objectRoot)
+                : mObjectRoot(objectRoot)
+            {
+                setCullingActive(false);
+            }
+
+            void traverse(osg::NodeVisitor& nv) override
+            {
+                mObjectRoot->accept(nv);
+            }
+
+        private:
+            osg::ref_ptr<osg::Group> mObjectRoot;
+        };
+    }
+
+    class ImpostorRTT : public SceneUtil::RTTNode
+    {
+    public:
+        ImpostorRTT(osg::Group* objectRoot, const osg::Vec3f& center, float radius)
+            : RTTNode(sTextureSize, sTextureSize, 0, false)
+            , mTexture(new osg::Texture2D)
+            , mTransform(new ActorTransform(objectRoot))
+            , mCenter(center)
+            , mRadius(radius)
+        {
+            mTexture->setTextureSize(sTextureSize, sTextureSize);
+            mTexture->setInternalFormat(GL_RGBA);
+            mTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+            mTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+            mTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+            mTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+            setNodeMask(Mask_RenderToTexture);
+        }
+
+        osg::Texture2D* getTexture() const
+        {
+            return mTexture.get();
+        }
+
+        /// The camera rendering the texture, nullptr until it's culled for the first time.
+        const osg::Camera* getCamera() const
+        {
+            return mCamera;
+        }
+
+        void setDefaults(osg::Camera* camera) override
+        {
+            camera->setName("ImpostorCamera");
+            camera->setReferenceFrame(osg::Camera::ABSOLUTE_RF);
+            camera->setComputeNearFarMode(osg::Camera::DO_NOT_COMPUTE_NEAR_FAR);
+            camera->setClearColor(osg::Vec4f(0, 0, 0, 0));
+            camera->attach(osg::Camera::COLOR_BUFFER, mTexture);
+            camera->setNodeMask(Mask_RenderToTexture);
+
+            // The fog is applied to the quad
+            osg::ref_ptr<osg::Fog> fog(new osg::Fog);
+            fog->setStart(10000000);
+            fog->setEnd(10000000);
+            camera->getOrCreateStateSet()->setAttributeAndModes(fog, osg::StateAttribute::OFF | osg::StateAttribute::OVERRIDE);
+            SceneUtil::ShadowManager::disableShadowsForStateSet(camera->getOrCreateStateSet());
+
+            camera->addChild(mTransform);
+            mCamera = camera;
+        }
+
+        void apply(osg::Camera* camera) override
+        {
+            camera->setViewMatrix(mViewMatrix);
+            camera->setProjectionMatrix(mProjectionMatrix);
+            camera->setCullMask(mCullMask);
+        }
+
+        bool needsUpdate(osg::Camera* camera, osgUtil::CullVisitor* cv) override
+        {
+            if (cv->isCulled(osg::BoundingSphere(mCenter, mRadius)))
+                return false;
+
+            const osg::Matrix& viewMatrix = *cv->getCurrentRenderStage()->getInitialViewMatrix();
+            const osg::Matrix inverseViewMatrix = osg::Matrix::inverse(viewMatrix);
+            // the model view matrix of this node includes the transformation of the actor
+            const osg::Matrix localToWorld = *cv->getModelViewMatrix() * inverseViewMatrix;
+            const osg::Vec3f eyePoint = inverseViewMatrix.getTrans();
+            const osg::Vec3f center = mCenter * localToWorld;
+            osg::Vec3f direction = center - eyePoint;
+            const float distance = direction.normalize();
+            const double time = cv->getFrameStamp()->getSimulationTime();
+
+            if (mUpdated && time - mLastUpdateTime < sUpdateInterval && direction * mLastDirection >= sUpdateAngle)
+                return false;
+
+            mUpdated = true;
+            mLastUpdateTime = time;
+            mLastDirection = direction;
+
+            const osg::Vec3f up = std::abs(direction.z()) < 0.99f ? osg::Vec3f(0, 0, 1) : osg::Vec3f(0, 1, 0);
+            mViewMatrix = osg::Matrix::lookAt(eyePoint, center, up);
+
+            const float radius = mRadius * localToWorld.getScale().x();
+            const float nearPlane = std::max(1.f, distance - radius);
+            const float farPlane = distance + radius;
+            if (SceneUtil::AutoDepth::isReversed())
+                mProjectionMatrix = SceneUtil::getReversedZProjectionMatrixAsOrtho(-radius, radius, -radius, radius, nearPlane, farPlane);
+            else
+                mProjectionMatrix = osg::Matrix::ortho(-radius, radius, -radius, radius, nearPlane, farPlane);
+
+            mTransform->setMatrix(localToWorld);
+            mCullMask = cv->getTraversalMask();
+            return true;
+        }
+
+    private:
+        osg::ref_ptr<osg::Texture2D> mTexture;
+        osg::ref_ptr<ActorTransform> mTransform;
+        const osg::Camera* mCamera = nullptr;
+        const osg::Vec3f mCenter;
+        const float mRadius;
+        bool mUpdated = false;
+        double mLastUpdateTime = 0;
+        osg::Vec3f mLastDirection;
+        osg::Matrix mViewMatrix;
+        osg::Matrix mProjectionMatrix;
+        osg::Node::NodeMask mCullMask = ~0u;
+    };
+
+    namespace
+    {
+        /// Only lets the impostor camera see the actor.
+        class HideCallback : public SceneUtil::NodeCallback<HideCallback, osg::Node*, osgUtil::CullVisitor*>
+        {
+        public:
+            // The impostor removes the callback before it's destroyed
+            HideCallback(const ImpostorRTT* rtt)
+                : mRTT(rtt)
+            {
+            }
+
+            void operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+            {
+                if (cv->getCurrentCamera() == mRTT->getCamera())
+                    traverse(node, cv);
+            }
+
+        private:
+            const ImpostorRTT* mRTT;
+        };
+    }
+
+    ActorImpostor::ActorImpostor(osg::Group* parent, osg::Group* objectRoot, Resource::SceneManager* sceneManager)
+        : mParent(parent)
+        , mObjectRoot(objectRoot)
+    {
+        // Leave some room for the limbs, the bound is only computed once for the current pose
+        osg::BoundingSphere bound = objectRoot->getBound();
+        if (!bound.valid() || bound.radius() <= 0)
+            bound = osg::BoundingSphere(osg::Vec3f(0, 0, 64), 96);
+        const osg::Vec3f center = bound.center();
+        const float radius = bound.radius() * 1.25f;
+
+        mRTT = new ImpostorRTT(objectRoot, center, radius);
+
+        osg::ref_ptr<osg::Geometry> quad = osg::createTexturedQuadGeometry(osg::Vec3f(-radius, 0, -radius),
+            osg::Vec3f(2 * radius, 0, 0), osg::Vec3f(0, 0, 2 * radius));
+        mBillboard = new osg::Billboard;
+        mBillboard->setMode(osg::Billboard::POINT_ROT_WORLD);
+        mBillboard->addDrawable(quad, center);
+        mBillboard->setNodeMask(Mask_Effect);
+
+        osg::StateSet* stateset = mBillboard->getOrCreateStateSet();
+        stateset->setTextureAttributeAndModes(0, mRTT->getTexture(), osg::StateAttribute::ON);
+        // The texture is already lit
+        osg::ref_ptr<osg::Material> material(new osg::Material);
+        material->setColorMode(osg::Material::OFF);
+        material->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4f(0, 0, 0, 1));
+        material->setAmbient(osg::Material::FRONT_AND_BACK, osg::Vec4f(0, 0, 0, 1));
+        material->setEmission(osg::Material::FRONT_AND_BACK, osg::Vec4f(1, 1, 1, 1));
+        stateset->setAttributeAndModes(material, osg::StateAttribute::ON);
+        stateset->setAttributeAndModes(new osg::BlendFunc(osg::BlendFunc::SRC_ALPHA, osg::BlendFunc::ONE_MINUS_SRC_ALPHA), osg::StateAttribute::ON);
+        stateset->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+        SceneUtil::ShadowManager::disableShadowsForStateSet(stateset);
+        sceneManager->recreateShaders(mBillboard, "objects", true);
+
+        mHideCallback = new HideCallback(mRTT);
+        mObjectRoot->addCullCallback(mHideCallback);
+        mParent->addChild(mRTT);
+        mParent->addChild(mBillboard);
+    }
+
+    ActorImpostor::~ActorImpostor()
+    {
+        mObjectRoot->removeCullCallback(mHideCallback);
+        mParent->removeChild(mRTT);
+        mParent->removeChild(mBillboard);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef OPENMW_MWRENDER_ACTORIMPOSTOR_H
+#define OPENMW_MWRENDER_ACTORIMPOSTOR_H
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Billboard;
+    class Callback;
+    class Group;
+}
+
+namespace Resource
+{
+    class SceneManager;
+}
+
+namespace MWRender
+{
+    class ImpostorRTT;
+
+    /// Draws an actor as a camera facing quad, textured with a small render of the actor from the current point of view.
+    /// The render is only refreshed every few frames or when the direction to the actor changes noticeably, so the
+    /// skinned meshes of the actor are drawn a lot less often. The actor itself is only drawn into the texture.
+    /// @note The quad doesn't cast shadows.
+    class ActorImpostor
+    {
+    public:
+        /// @param parent the node the quad is attached to, usually the parent of objectRoot
+        /// @param objectRoot the node of the actor, hidden from all cameras but the one rendering the texture
+        ActorImpostor(osg::Group* parent, osg::Group* objectRoot, Resource::SceneManager* sceneManager);
+        ~ActorImpostor();
+
+        ActorImpostor(const ActorImpostor&) = delete;
+        ActorImpostor& operator=(const ActorImpostor&) = delete;
+
+    private:
+        osg::ref_ptr<osg::Group> mParent;
+        osg::ref_ptr<osg::Group> mObjectRoot;
+        osg::ref_ptr<ImpostorRTT> mRTT;
+        osg::ref_ptr<osg::Billboard> mBillboard;
+        osg::ref_ptr<osg::Callback> mHideCallback;
+    };
+}
+
+#endif
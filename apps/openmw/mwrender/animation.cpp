@@ -26,6 +26,7 @@
 #include <components/vfs/manager.hpp>
 
 #include <components/sceneutil/actorutil.hpp>
+#include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/sceneutil/lightmanager.hpp>
@@ -47,6 +48,8 @@
 #include "vismask.hpp"
 #include "util.hpp"
 #include "rotatecontroller.hpp"
+#include "effectpool.hpp"
+#include "actorimpostor.hpp"
 
 namespace
 {
@@ -148,7 +151,7 @@ namespace
         }
     };
 
-    float calcAnimVelocity(const SceneUtil::TextKeyMap& keys, SceneUtil::KeyframeController *nonaccumctrl,
+    float calcAnimVelocity(const SceneUtil::TextKeyMap& keys, const SceneUtil::KeyframeController *nonaccumctrl,
                            const osg::Vec3f& accum, const std::string &groupname)
     {
         const std::string start = groupname+": start";
@@ -220,13 +223,41 @@ namespace
         std::vector<std::pair<osg::Node*, osg::Group*> > mFoundBones;
     };
 
-    class RemoveFinishedCallbackVisitor : public SceneUtil::RemoveVisitor
+    /// Removes the transformation nodes of effects and keeps their instances in the pool.
+    class RemoveEffectsVisitor : public SceneUtil::RemoveVisitor
+    {
+    public:
+        void releaseEffects(MWRender::EffectPool* pool)
+        {
+            if (pool == nullptr)
+                return;
+
+            for (const auto& toRemove : mToRemove)
+            {
+                osg::Node* node = toRemove.first;
+                MWRender::UpdateVfxCallback* vfxCallback = dynamic_cast<MWRender::UpdateVfxCallback*>(node->getUpdateCallback());
+                osg::Group* trans = node->asGroup();
+                if (vfxCallback == nullptr || trans == nullptr || trans->getNumChildren() == 0)
+                    continue;
+
+                const MWRender::EffectParams& params = vfxCallback->mParams;
+                MWRender::EffectPool::Instance instance;
+                instance.mNode = trans->getChild(0);
+                instance.mAnimTime = params.mAnimTime;
+                instance.mMaxControllerLength = params.mMaxControllerLength;
+                pool->release(params.mModelName, params.mTextureOverride, MWRender::EffectPool::Setup::AttachedEffect,
+                              std::move(instance));
+            }
+        }
+    };
+
+    class RemoveFinishedCallbackVisitor : public RemoveEffectsVisitor
     {
     public:
         bool mHasMagicEffects;
 
         RemoveFinishedCallbackVisitor()
-            : RemoveVisitor()
+            : RemoveEffectsVisitor()
             , mHasMagicEffects(false)
         {
         }
@@ -265,20 +296,20 @@ namespace
         }
     };
 
-    class RemoveCallbackVisitor : public SceneUtil::RemoveVisitor
+    class RemoveCallbackVisitor : public RemoveEffectsVisitor
     {
     public:
         bool mHasMagicEffects;
 
         RemoveCallbackVisitor()
-            : RemoveVisitor()
+            : RemoveEffectsVisitor()
             , mHasMagicEffects(false)
             , mEffectId(-1)
         {
         }
 
         RemoveCallbackVisitor(int effectId)
-            : RemoveVisitor()
+            : RemoveEffectsVisitor()
             , mHasMagicEffects(false)
             , mEffectId(effectId)
         {
@@ -434,10 +465,14 @@ namespace MWRender
     struct Animation::AnimSource
     {
         osg::ref_ptr<const SceneUtil::KeyframeHolder> mKeyframes;
+        std::string mName;
+        std::string mBaseModel;
 
         typedef std::map<std::string, osg::ref_ptr<SceneUtil::KeyframeController> > ControllerMap;
 
+        /// Created when a group of the source is played for the first time, see Animation::createControllers.
         ControllerMap mControllerMap[Animation::sNumBlendMasks];
+        bool mControllersCreated = false;
 
         const SceneUtil::TextKeyMap& getTextKeys() const;
     };
@@ -518,6 +553,7 @@ namespace MWRender
         , mLegsYawRadians(0.f)
         , mBodyPitchRadians(0.f)
         , mHasMagicEffects(false)
+        , mEffectPool(nullptr)
         , mAlpha(1.f)
     {
         for(size_t i = 0;i < sNumBlendMasks;i++)
@@ -550,6 +586,32 @@ namespace MWRender
             mSkeleton->setActive(static_cast<SceneUtil::Skeleton::ActiveType>(active));
     }
 
+    bool Animation::isOffScreen() const
+    {
+        return mSkeleton && mSkeleton->isOffScreen();
+    }
+
+    void Animation::setSharedAnimation(bool shared)
+    {
+        for (size_t i = 0; i < sNumBlendMasks; ++i)
+            mAnimationTimePtr[i]->setShared(shared);
+    }
+
+    void Animation::setImpostor(bool enabled)
+    {
+        if (enabled == hasImpostor())
+            return;
+        if (enabled && mObjectRoot)
+            mImpostor = std::make_unique<ActorImpostor>(mInsert, mObjectRoot, mResourceSystem->getSceneManager());
+        else
+            mImpostor.reset();
+    }
+
+    bool Animation::hasImpostor() const
+    {
+        return mImpostor != nullptr;
+    }
+
     void Animation::updatePtr(const MWWorld::Ptr &ptr)
     {
         mPtr = ptr;
@@ -637,28 +699,11 @@ namespace MWRender
         if (!animsrc->mKeyframes || animsrc->mKeyframes->mTextKeys.empty() || animsrc->mKeyframes->mKeyframeControllers.empty())
             return;
 
+        animsrc->mName = kfname;
+        animsrc->mBaseModel = baseModel;
+
         const NodeMap& nodeMap = getNodeMap();
         const auto& controllerMap = animsrc->mKeyframes->mKeyframeControllers;
-        for (SceneUtil::KeyframeHolder::KeyframeControllerMap::const_iterator it = controllerMap.begin(); it != controllerMap.end(); ++it)
-        {
-            std::string bonename = Misc::StringUtils::lowerCase(it->first);
-            NodeMap::const_iterator found = nodeMap.find(bonename);
-            if (found == nodeMap.end())
-            {
-                Log(Debug::Warning) << "Warning: addAnimSource: can't find bone '" + bonename << "' in " << baseModel << " (referenced by " << kfname << ")";
-                continue;
-            }
-
-            osg::Node* node = found->second;
-
-            size_t blendMask = detectBlendMask(node);
-
-            // clone the controller, because each Animation needs its own ControllerSource
-            osg::ref_ptr<SceneUtil::KeyframeController> cloned = osg::clone(it->second.get(), osg::CopyOp::SHALLOW_COPY);
-            cloned->setSource(mAnimationTimePtr[blendMask]);
-
-            animsrc->mControllerMap[blendMask].insert(std::make_pair(bonename, cloned));
-        }
 
         mAnimSources.push_back(animsrc);
 
@@ -694,6 +739,33 @@ namespace MWRender
         }
     }
 
+    void Animation::createControllers(AnimSource& source)
+    {
+        source.mControllersCreated = true;
+
+        const NodeMap& nodeMap = getNodeMap();
+        for (const auto& [name, controller] : source.mKeyframes->mKeyframeControllers)
+        {
+            std::string bonename = Misc::StringUtils::lowerCase(name);
+            NodeMap::const_iterator found = nodeMap.find(bonename);
+            if (found == nodeMap.end())
+            {
+                Log(Debug::Warning) << "Warning: addAnimSource: can't find bone '" + bonename << "' in " << source.mBaseModel << " (referenced by " << source.mName << ")";
+                continue;
+            }
+
+            osg::Node* node = found->second;
+
+            size_t blendMask = detectBlendMask(node);
+
+            // clone the controller, because each Animation needs its own ControllerSource
+            osg::ref_ptr<SceneUtil::KeyframeController> cloned = osg::clone(controller.get(), osg::CopyOp::SHALLOW_COPY);
+            cloned->setSource(mAnimationTimePtr[blendMask]);
+
+            source.mControllerMap[blendMask].insert(std::make_pair(bonename, cloned));
+        }
+    }
+
     void Animation::clearAnimSources()
     {
         mStates.clear();
@@ -986,6 +1058,8 @@ namespace MWRender
             if (active != mStates.end())
             {
                 std::shared_ptr<AnimSource> animsrc = active->second.mSource;
+                if (!animsrc->mControllersCreated)
+                    createControllers(*animsrc);
 
                 for (AnimSource::ControllerMap::iterator it = animsrc->mControllerMap[blendMask].begin(); it != animsrc->mControllerMap[blendMask].end(); ++it)
                 {
@@ -1100,8 +1174,9 @@ namespace MWRender
         float velocity = 0.0f;
         const SceneUtil::TextKeyMap &keys = (*animsrc)->getTextKeys();
 
-        const AnimSource::ControllerMap& ctrls = (*animsrc)->mControllerMap[0];
-        for (AnimSource::ControllerMap::const_iterator it = ctrls.begin(); it != ctrls.end(); ++it)
+        // The velocity only depends on the keys, so the shared controllers are used, created or not for this object
+        const SceneUtil::KeyframeHolder::KeyframeControllerMap& ctrls = (*animsrc)->mKeyframes->mKeyframeControllers;
+        for (SceneUtil::KeyframeHolder::KeyframeControllerMap::const_iterator it = ctrls.begin(); it != ctrls.end(); ++it)
         {
             if (Misc::StringUtils::ciEqual(it->first, mAccumRoot->getName()))
             {
@@ -1121,8 +1196,8 @@ namespace MWRender
             {
                 const SceneUtil::TextKeyMap &keys2 = (*animiter)->getTextKeys();
 
-                const AnimSource::ControllerMap& ctrls2 = (*animiter)->mControllerMap[0];
-                for (AnimSource::ControllerMap::const_iterator it = ctrls2.begin(); it != ctrls2.end(); ++it)
+                const SceneUtil::KeyframeHolder::KeyframeControllerMap& ctrls2 = (*animiter)->mKeyframes->mKeyframeControllers;
+                for (SceneUtil::KeyframeHolder::KeyframeControllerMap::const_iterator it = ctrls2.begin(); it != ctrls2.end(); ++it)
                 {
                     if (Misc::StringUtils::ciEqual(it->first, mAccumRoot->getName()))
                     {
@@ -1364,6 +1439,9 @@ namespace MWRender
 
     void Animation::setObjectRoot(const std::string &model, bool forceskeleton, bool baseonly, bool isCreature)
     {
+        const bool impostor = hasImpostor();
+        mImpostor.reset();
+
         osg::ref_ptr<osg::StateSet> previousStateset;
         if (mObjectRoot)
         {
@@ -1459,11 +1537,20 @@ namespace MWRender
             removeTriBipVisitor.remove();
         }
 
+        static const bool skipInvisibleControllers = Settings::Manager::getBool("skip invisible controllers", "Cells");
+        if (skipInvisibleControllers)
+        {
+            SceneUtil::SkipInvisibleControllersVisitor skipInvisibleControllersVisitor;
+            mObjectRoot->accept(skipInvisibleControllersVisitor);
+        }
+
         if (!mLightListCallback)
             mLightListCallback = new SceneUtil::LightListCallback;
         mObjectRoot->addCullCallback(mLightListCallback);
         if (mTransparencyUpdater)
             mObjectRoot->addCullCallback(mTransparencyUpdater);
+
+        setImpostor(impostor);
     }
 
     osg::Group* Animation::getObjectRoot()
@@ -1560,36 +1647,50 @@ namespace MWRender
         }
         parentNode->addChild(trans);
 
-        osg::ref_ptr<osg::Node> node = mResourceSystem->getSceneManager()->getInstance(model, trans);
+        EffectPool::Instance instance;
+        if (mEffectPool != nullptr)
+            instance = mEffectPool->acquire(model, texture, EffectPool::Setup::AttachedEffect);
 
-        // Morrowind has a white ambient light attached to the root VFX node of the scenegraph
-        node->getOrCreateStateSet()->setAttributeAndModes(getVFXLightModelInstance(), osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE);
+        if (instance.mNode == nullptr)
+        {
+            instance.mNode = mResourceSystem->getSceneManager()->getInstance(model);
+
+            // Morrowind has a white ambient light attached to the root VFX node of the scenegraph
+            instance.mNode->getOrCreateStateSet()->setAttributeAndModes(getVFXLightModelInstance(), osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE);
+
+            SceneUtil::FindMaxControllerLengthVisitor findMaxLengthVisitor;
+            instance.mNode->accept(findMaxLengthVisitor);
+            instance.mMaxControllerLength = findMaxLengthVisitor.getMaxLength();
 
-        SceneUtil::FindMaxControllerLengthVisitor findMaxLengthVisitor;
-        node->accept(findMaxLengthVisitor);
+            instance.mNode->setNodeMask(Mask_Effect);
 
-        node->setNodeMask(Mask_Effect);
+            instance.mAnimTime = std::make_shared<EffectAnimationTime>();
 
-        params.mMaxControllerLength = findMaxLengthVisitor.getMaxLength();
+            SceneUtil::AssignControllerSourcesVisitor assignVisitor(instance.mAnimTime);
+            instance.mNode->accept(assignVisitor);
+
+            overrideFirstRootTexture(texture, mResourceSystem, instance.mNode);
+        }
+
+        trans->addChild(instance.mNode);
+
+        params.mTextureOverride = texture;
+        params.mMaxControllerLength = instance.mMaxControllerLength;
         params.mLoop = loop;
         params.mEffectId = effectId;
         params.mBoneName = bonename;
-        params.mAnimTime = std::shared_ptr<EffectAnimationTime>(new EffectAnimationTime);
+        params.mAnimTime = instance.mAnimTime;
         trans->addUpdateCallback(new UpdateVfxCallback(params));
 
-        SceneUtil::AssignControllerSourcesVisitor assignVisitor(std::shared_ptr<SceneUtil::ControllerSource>(params.mAnimTime));
-        node->accept(assignVisitor);
-
         // Notify that this animation has attached magic effects
         mHasMagicEffects = true;
-
-        overrideFirstRootTexture(texture, mResourceSystem, node);
     }
 
     void Animation::removeEffect(int effectId)
     {
         RemoveCallbackVisitor visitor(effectId);
         mInsert->accept(visitor);
+        visitor.releaseEffects(mEffectPool);
         visitor.remove();
         mHasMagicEffects = visitor.mHasMagicEffects;
     }
@@ -1627,6 +1728,7 @@ namespace MWRender
         // transformation nodes with finished callbacks
         RemoveFinishedCallbackVisitor visitor;
         mInsert->accept(visitor);
+        visitor.releaseEffects(mEffectPool);
         visitor.remove();
         mHasMagicEffects = visitor.mHasMagicEffects;
     }
@@ -9,6 +9,7 @@
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/misc/stringops.hpp>
 
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -35,6 +36,8 @@ namespace SceneUtil
 namespace MWRender
 {
 
+class ActorImpostor;
+class EffectPool;
 class ResetAccumRootCallback;
 class RotateController;
 class TransparencyUpdater;
@@ -77,6 +80,7 @@ typedef std::shared_ptr<PartHolder> PartHolderPtr;
 struct EffectParams
 {
     std::string mModelName; // Just here so we don't add the same effect twice
+    std::string mTextureOverride;
     std::shared_ptr<EffectAnimationTime> mAnimTime;
     float mMaxControllerLength;
     int mEffectId;
@@ -166,6 +170,7 @@ protected:
     {
     private:
         std::shared_ptr<float> mTimePtr;
+        bool mShared = false;
 
     public:
 
@@ -174,6 +179,11 @@ protected:
         std::shared_ptr<float> getTimePtr() const
         { return mTimePtr; }
 
+        void setShared(bool shared)
+        { mShared = shared; }
+        bool isShared() const override
+        { return mShared; }
+
         float getValue(osg::NodeVisitor* nv) override;
     };
 
@@ -277,6 +287,7 @@ protected:
     RotateController* addRotateController(const std::string& bone);
 
     bool mHasMagicEffects;
+    EffectPool* mEffectPool;
 
     osg::ref_ptr<SceneUtil::LightSource> mGlowLight;
     osg::ref_ptr<SceneUtil::GlowUpdater> mGlowUpdater;
@@ -289,6 +300,8 @@ protected:
 
     osg::ref_ptr<SceneUtil::LightListCallback> mLightListCallback;
 
+    std::unique_ptr<ActorImpostor> mImpostor;
+
     const NodeMap& getNodeMap() const;
 
     /* Sets the appropriate animations on the bone groups based on priority.
@@ -333,6 +346,10 @@ protected:
     void addAnimSource(const std::string &model, const std::string& baseModel);
     void addSingleAnimSource(const std::string &model, const std::string& baseModel);
 
+    /// Clone the keyframe controllers of an animation source for this object. Done when one of its groups is played
+    /// for the first time, as most sources of the shared animation files are never played by most objects.
+    void createControllers(AnimSource& source);
+
     /** Adds an additional light to the given node using the specified ESM record. */
     void addExtraLight(osg::ref_ptr<osg::Group> parent, const ESM::Light *light);
 
@@ -360,6 +377,22 @@ public:
     /// 0 = Inactive, 1 = Active in place, 2 = Active
     void setActive(int active);
 
+    /// Was the object skeleton not drawn in the last frame? False if there is no skeleton.
+    /// @see SceneUtil::Skeleton::isOffScreen
+    bool isOffScreen() const;
+
+    /// Let the keyframe controllers of the object reuse the poses other objects playing the same animations
+    /// evaluated at nearly the same time, instead of interpolating their own. Meant for distant actors.
+    /// @see SceneUtil::ControllerSource::isShared
+    void setSharedAnimation(bool shared);
+
+    /// Draw the object as a camera facing quad showing a render of it that is only refreshed every few frames.
+    /// Meant for distant actors. The impostor is recreated when the object root changes.
+    /// @see ActorImpostor
+    void setImpostor(bool enabled);
+
+    bool hasImpostor() const;
+
     osg::Group* getOrCreateObjectRoot();
 
     osg::Group* getObjectRoot();
@@ -379,6 +412,9 @@ public:
     void removeEffects ();
     void getLoopingEffects (std::vector<int>& out) const;
 
+    /// Keep the instances of removed effects in the pool and reuse them for new ones, nullptr disables it.
+    void setEffectPool(EffectPool* pool) { mEffectPool = pool; }
+
     // Add a spell casting glow to an object. From measuring video taken from the original engine,
     // the glow seems to be about 1.5 seconds except for telekinesis, which is 1 second.
     void addSpellCastGlow(const ESM::MagicEffect *effect, float glowDuration = 1.5);
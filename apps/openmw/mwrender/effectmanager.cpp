@@ -8,15 +8,17 @@
 #include <components/sceneutil/controller.hpp>
 
 #include "animation.hpp"
+#include "effectpool.hpp"
 #include "vismask.hpp"
 #include "util.hpp"
 
 namespace MWRender
 {
 
-EffectManager::EffectManager(osg::ref_ptr<osg::Group> parent, Resource::ResourceSystem* resourceSystem)
+EffectManager::EffectManager(osg::ref_ptr<osg::Group> parent, Resource::ResourceSystem* resourceSystem, EffectPool* pool)
     : mParentNode(parent)
     , mResourceSystem(resourceSystem)
+    , mPool(pool)
 {
 }
 
@@ -27,35 +29,62 @@ EffectManager::~EffectManager()
 
 void EffectManager::addEffect(const std::string &model, const std::string& textureOverride, const osg::Vec3f &worldPosition, float scale, bool isMagicVFX)
 {
-    osg::ref_ptr<osg::Node> node = mResourceSystem->getSceneManager()->getInstance(model);
+    const EffectPool::Setup setup = isMagicVFX ? EffectPool::Setup::MagicEffect : EffectPool::Setup::Effect;
+    EffectPool::Instance instance = mPool->acquire(model, textureOverride, setup);
 
-    node->setNodeMask(Mask_Effect);
+    if (instance.mNode == nullptr)
+    {
+        instance.mNode = mResourceSystem->getSceneManager()->getInstance(model);
 
-    Effect effect;
-    effect.mAnimTime.reset(new EffectAnimationTime);
+        instance.mNode->setNodeMask(Mask_Effect);
+
+        instance.mAnimTime.reset(new EffectAnimationTime);
+
+        SceneUtil::FindMaxControllerLengthVisitor findMaxLengthVisitor;
+        instance.mNode->accept(findMaxLengthVisitor);
+        instance.mMaxControllerLength = findMaxLengthVisitor.getMaxLength();
+
+        SceneUtil::AssignControllerSourcesVisitor assignVisitor(instance.mAnimTime);
+        instance.mNode->accept(assignVisitor);
+
+        if (isMagicVFX)
+            overrideFirstRootTexture(textureOverride, mResourceSystem, instance.mNode);
+        else
+            overrideTexture(textureOverride, mResourceSystem, instance.mNode);
+    }
 
-    SceneUtil::FindMaxControllerLengthVisitor findMaxLengthVisitor;
-    node->accept(findMaxLengthVisitor);
-    effect.mMaxControllerLength = findMaxLengthVisitor.getMaxLength();
+    Effect effect;
+    effect.mAnimTime = instance.mAnimTime;
+    effect.mMaxControllerLength = instance.mMaxControllerLength;
+    effect.mModel = model;
+    effect.mTextureOverride = textureOverride;
+    effect.mIsMagicVFX = isMagicVFX;
 
     osg::ref_ptr<osg::PositionAttitudeTransform> trans = new osg::PositionAttitudeTransform;
     trans->setPosition(worldPosition);
     trans->setScale(osg::Vec3f(scale, scale, scale));
-    trans->addChild(node);
-
-    SceneUtil::AssignControllerSourcesVisitor assignVisitor(effect.mAnimTime);
-    node->accept(assignVisitor);
-
-    if (isMagicVFX)
-        overrideFirstRootTexture(textureOverride, mResourceSystem, node);
-    else
-        overrideTexture(textureOverride, mResourceSystem, node);
+    trans->addChild(instance.mNode);
 
     mParentNode->addChild(trans);
 
     mEffects[trans] = effect;
 }
 
+void EffectManager::releaseEffect(osg::PositionAttitudeTransform* trans, Effect& effect)
+{
+    mParentNode->removeChild(trans);
+
+    if (trans->getNumChildren() == 0)
+        return;
+
+    EffectPool::Instance instance;
+    instance.mNode = trans->getChild(0);
+    instance.mAnimTime = std::move(effect.mAnimTime);
+    instance.mMaxControllerLength = effect.mMaxControllerLength;
+    const EffectPool::Setup setup = effect.mIsMagicVFX ? EffectPool::Setup::MagicEffect : EffectPool::Setup::Effect;
+    mPool->release(effect.mModel, effect.mTextureOverride, setup, std::move(instance));
+}
+
 void EffectManager::update(float dt)
 {
     for (EffectMap::iterator it = mEffects.begin(); it != mEffects.end(); )
@@ -64,7 +93,7 @@ void EffectManager::update(float dt)
 
         if (it->second.mAnimTime->getTime() >= it->second.mMaxControllerLength)
         {
-            mParentNode->removeChild(it->first);
+            releaseEffect(it->first, it->second);
             mEffects.erase(it++);
         }
         else
@@ -76,7 +105,7 @@ void EffectManager::clear()
 {
     for (EffectMap::iterator it = mEffects.begin(); it != mEffects.end(); ++it)
     {
-        mParentNode->removeChild(it->first);
+        releaseEffect(it->first, it->second);
     }
     mEffects.clear();
 }
@@ -22,13 +22,15 @@ namespace Resource
 namespace MWRender
 {
     class EffectAnimationTime;
+    class EffectPool;
 
     // Note: effects attached to another object should be managed by MWRender::Animation::addEffect.
     // This class manages "free" effects, i.e. attached to a dedicated scene node in the world.
     class EffectManager
     {
     public:
-        EffectManager(osg::ref_ptr<osg::Group> parent, Resource::ResourceSystem* resourceSystem);
+        /// @param pool keeps the instances of finished effects for reuse
+        EffectManager(osg::ref_ptr<osg::Group> parent, Resource::ResourceSystem* resourceSystem, EffectPool* pool);
         ~EffectManager();
 
         /// Add an effect. When it's finished playing, it will be removed automatically.
@@ -44,13 +46,19 @@ namespace MWRender
         {
             float mMaxControllerLength;
             std::shared_ptr<EffectAnimationTime> mAnimTime;
+            std::string mModel;
+            std::string mTextureOverride;
+            bool mIsMagicVFX;
         };
 
+        void releaseEffect(osg::PositionAttitudeTransform* trans, Effect& effect);
+
         typedef std::map<osg::ref_ptr<osg::PositionAttitudeTransform>, Effect> EffectMap;
         EffectMap mEffects;
 
         osg::ref_ptr<osg::Group> mParentNode;
         Resource::ResourceSystem* mResourceSystem;
+        EffectPool* mPool;
 
         EffectManager(const EffectManager&);
         void operator=(const EffectManager&);
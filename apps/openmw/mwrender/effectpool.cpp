@@ -0,0 +1,105 @@
+#include "effectpool.hpp"
+
+#include <osg/Group>
+#include <osg/NodeVisitor>
+#include <osg/Stats>
+
+#include <osgParticle/ParticleSystem>
+
+#include <components/nifosg/particle.hpp>
+
+#include "animation.hpp"
+
+namespace MWRender
+{
+    namespace
+    {
+        constexpr std::size_t sMaxInstancesPerEffect = 16;
+        constexpr std::size_t sMaxInstances = 512;
+
+        /// Removes the particles left from the last time the effect played.
+        class ResetParticlesVisitor : public osg::NodeVisitor
+        {
+        public:
+            ResetParticlesVisitor()
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            {
+            }
+
+            void apply(osg::Node& node) override
+            {
+                // The emitter wasn't updated while the effect was detached, so its next time step spans all that time
+                if (NifOsg::Emitter* emitter = dynamic_cast<NifOsg::Emitter*>(&node))
+                    emitter->skipNextEmission();
+
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                if (osgParticle::ParticleSystem* partsys = dynamic_cast<osgParticle::ParticleSystem*>(&drawable))
+                {
+                    for (int i = 0; i < partsys->numParticles(); ++i)
+                        partsys->getParticle(i)->kill();
+                }
+            }
+        };
+    }
+
+    EffectPool::Instance EffectPool::acquire(const std::string& model, const std::string& texture, Setup setup)
+    {
+        const auto it = mInstances.find(Key(model, texture, setup));
+        if (it == mInstances.end() || it->second.empty())
+        {
+            ++mMisses;
+            return Instance();
+        }
+
+        Instance instance = std::move(it->second.back());
+        it->second.pop_back();
+        --mNumInstances;
+        ++mHits;
+
+        instance.mAnimTime->resetTime(0);
+        ResetParticlesVisitor visitor;
+        instance.mNode->accept(visitor);
+
+        return instance;
+    }
+
+    void EffectPool::release(const std::string& model, const std::string& texture, Setup setup, Instance&& instance)
+    {
+        if (instance.mNode == nullptr)
+            return;
+
+        while (instance.mNode->getNumParents() > 0)
+            instance.mNode->getParent(0)->removeChild(instance.mNode);
+
+        std::vector<Instance>& instances = mInstances[Key(model, texture, setup)];
+        if (instances.size() >= sMaxInstancesPerEffect || mNumInstances >= sMaxInstances)
+        {
+            ++mDropped;
+            return;
+        }
+
+        instances.push_back(std::move(instance));
+        ++mNumInstances;
+    }
+
+    void EffectPool::clear()
+    {
+        mInstances.clear();
+        mNumInstances = 0;
+    }
+
+    void EffectPool::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        stats.setAttribute(frameNumber, "Effect Pool", mNumInstances);
+        stats.setAttribute(frameNumber, "Effect Pool Hits", mHits);
+        stats.setAttribute(frameNumber, "Effect Pool Misses", mMisses);
+        stats.setAttribute(frameNumber, "Effect Pool Dropped", mDropped);
+        mHits = 0;
+        mMisses = 0;
+        mDropped = 0;
+    }
+}
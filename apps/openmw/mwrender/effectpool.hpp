@@ -0,0 +1,66 @@
+#ifndef OPENMW_MWRENDER_EFFECTPOOL_H
+#define OPENMW_MWRENDER_EFFECTPOOL_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Node;
+    class Stats;
+}
+
+namespace MWRender
+{
+    class EffectAnimationTime;
+
+    /// Keeps the instances of finished effects, so playing an effect again doesn't need to clone its model.
+    /// An instance is only reused for the same model, texture override and setup, and is rewound to the start
+    /// of the effect with its particles removed.
+    class EffectPool
+    {
+    public:
+        /// How the caller prepared the instance, instances of different setups can't replace each other.
+        enum class Setup
+        {
+            Effect,
+            MagicEffect,
+            AttachedEffect,
+        };
+
+        struct Instance
+        {
+            osg::ref_ptr<osg::Node> mNode;
+            std::shared_ptr<EffectAnimationTime> mAnimTime;
+            float mMaxControllerLength = 0;
+        };
+
+        /// Take a kept instance of the effect, mNode is nullptr when there's none and the caller has to create it.
+        Instance acquire(const std::string& model, const std::string& texture, Setup setup);
+
+        /// Keep the instance of a finished effect and detach it from the scene graph. Once enough instances of
+        /// the effect are kept, further ones are dropped instead.
+        void release(const std::string& model, const std::string& texture, Setup setup, Instance&& instance);
+
+        /// Drop all kept instances.
+        void clear();
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
+    private:
+        using Key = std::tuple<std::string, std::string, Setup>;
+
+        std::map<Key, std::vector<Instance>> mInstances;
+        std::size_t mNumInstances = 0;
+        std::size_t mHits = 0;
+        std::size_t mMisses = 0;
+        std::size_t mDropped = 0;
+    };
+}
+
+#endif
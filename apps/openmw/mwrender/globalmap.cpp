@@ -1,5 +1,18 @@
 #include "globalmap.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
 #include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/Group>
@@ -10,6 +23,7 @@
 
 #include <components/settings/settings.hpp>
 #include <components/files/memorystream.hpp>
+#include <components/misc/hash.hpp>
 
 #include <components/debug/debuglog.hpp>
 
@@ -62,6 +76,60 @@ namespace
     }
 
 
+    const char baseMapMagic[] = {'O', 'M', 'W', 'G', 'M', 'A', 'P', '1'};
+
+    void writeBaseMap(const std::string& path, std::uint64_t hash, const osg::Image& image, const osg::Image& alphaImage)
+    {
+        const boost::filesystem::path tempPath = path + ".tmp";
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            const std::int32_t width = image.s();
+            const std::int32_t height = image.t();
+            stream.write(baseMapMagic, sizeof(baseMapMagic));
+            stream.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+            stream.write(reinterpret_cast<const char*>(&width), sizeof(width));
+            stream.write(reinterpret_cast<const char*>(&height), sizeof(height));
+            stream.write(reinterpret_cast<const char*>(image.data()), image.getTotalSizeInBytes());
+            stream.write(reinterpret_cast<const char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write global map cache " << path;
+                return;
+            }
+        }
+        boost::system::error_code error;
+        boost::filesystem::rename(tempPath, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to write global map cache " << path << ": " << error.message();
+    }
+
+    /// Read a base map written by writeBaseMap into the given images, which must already have the size of the map
+    bool readBaseMap(const std::string& path, std::uint64_t hash, osg::Image& image, osg::Image& alphaImage)
+    {
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+        char magic[sizeof(baseMapMagic)];
+        std::uint64_t fileHash = 0;
+        std::int32_t width = 0;
+        std::int32_t height = 0;
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+        stream.read(reinterpret_cast<char*>(&width), sizeof(width));
+        stream.read(reinterpret_cast<char*>(&height), sizeof(height));
+        if (!stream || !std::equal(magic, magic + sizeof(magic), baseMapMagic) || fileHash != hash
+                || width != image.s() || height != image.t())
+            return false;
+        stream.read(reinterpret_cast<char*>(image.data()), image.getTotalSizeInBytes());
+        stream.read(reinterpret_cast<char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+        if (!stream)
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid global map cache " << path;
+            return false;
+        }
+        return true;
+    }
+
     class CameraUpdateGlobalCallback : public SceneUtil::NodeCallback<CameraUpdateGlobalCallback, osg::Camera*>
     {
     public:
@@ -98,84 +166,192 @@ namespace
 namespace MWRender
 {
 
-    class CreateMapWorkItem : public SceneUtil::WorkItem
+    /// Base map images shared by the work items drawing them. The map is split into bands of cell columns,
+    /// and each band is drawn by whichever thread claims it first.
+    class BaseMapRaster : public osg::Referenced
     {
     public:
-        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore)
+        BaseMapRaster(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore)
             : mWidth(width), mHeight(height), mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mCellSize(cellSize), mLandStore(landStore)
+            , mNumBands((maxX - minX) / sColumnsPerBand + 1)
+            , mClaimed(new std::atomic_bool[mNumBands])
+            , mRemaining(mNumBands)
         {
+            for (int i = 0; i < mNumBands; ++i)
+                mClaimed[i] = false;
+
+            mImage = new osg::Image;
+            mImage->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
+
+            mAlphaImage = new osg::Image;
+            mAlphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
         }
 
-        void doWork() override
-        {
-            osg::ref_ptr<osg::Image> image = new osg::Image;
-            image->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
-            unsigned char* data = image->data();
+        int getNumBands() const { return mNumBands; }
 
-            osg::ref_ptr<osg::Image> alphaImage = new osg::Image;
-            alphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-            unsigned char* alphaData = alphaImage->data();
+        /// Draw the given band unless another thread has claimed it already
+        void drawBand(int band)
+        {
+            if (mClaimed[band].exchange(true))
+                return;
 
-            for (int x = mMinX; x <= mMaxX; ++x)
+            const int firstX = mMinX + band * sColumnsPerBand;
+            const int lastX = std::min(mMaxX, firstX + sColumnsPerBand - 1);
+            for (int x = firstX; x <= lastX; ++x)
             {
                 for (int y = mMinY; y <= mMaxY; ++y)
+                    drawCell(x, y);
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mRemaining == 0)
+                mCondition.notify_all();
+        }
+
+        /// Wait until all bands have been drawn
+        void waitTillDone()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [&] { return mRemaining == 0; });
+        }
+
+        osg::ref_ptr<osg::Image> mImage;
+        osg::ref_ptr<osg::Image> mAlphaImage;
+
+    private:
+        void drawCell(int x, int y)
+        {
+            unsigned char* data = mImage->data();
+            unsigned char* alphaData = mAlphaImage->data();
+
+            const ESM::Land* land = mLandStore.search (x,y);
+
+            for (int cellY=0; cellY<mCellSize; ++cellY)
+            {
+                for (int cellX=0; cellX<mCellSize; ++cellX)
                 {
-                    const ESM::Land* land = mLandStore.search (x,y);
+                    int vertexX = static_cast<int>(float(cellX) / float(mCellSize) * 9);
+                    int vertexY = static_cast<int>(float(cellY) / float(mCellSize) * 9);
+
+                    int texelX = (x-mMinX) * mCellSize + cellX;
+                    int texelY = (y-mMinY) * mCellSize + cellY;
+
+                    unsigned char r,g,b;
 
-                    for (int cellY=0; cellY<mCellSize; ++cellY)
+                    float y2 = 0;
+                    if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
+                        y2 = land->mWnam[vertexY * 9 + vertexX] / 128.f;
+                    else
+                        y2 = SCHAR_MIN / 128.f;
+                    if (y2 < 0)
                     {
-                        for (int cellX=0; cellX<mCellSize; ++cellX)
+                        r = static_cast<unsigned char>(14 * y2 + 38);
+                        g = static_cast<unsigned char>(20 * y2 + 56);
+                        b = static_cast<unsigned char>(18 * y2 + 51);
+                    }
+                    else if (y2 < 0.3f)
+                    {
+                        if (y2 < 0.1f)
+                            y2 *= 8.f;
+                        else
                         {
-                            int vertexX = static_cast<int>(float(cellX) / float(mCellSize) * 9);
-                            int vertexY = static_cast<int>(float(cellY) / float(mCellSize) * 9);
-
-                            int texelX = (x-mMinX) * mCellSize + cellX;
-                            int texelY = (y-mMinY) * mCellSize + cellY;
-
-                            unsigned char r,g,b;
-
-                            float y2 = 0;
-                            if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
-                                y2 = land->mWnam[vertexY * 9 + vertexX] / 128.f;
-                            else
-                                y2 = SCHAR_MIN / 128.f;
-                            if (y2 < 0)
-                            {
-                                r = static_cast<unsigned char>(14 * y2 + 38);
-                                g = static_cast<unsigned char>(20 * y2 + 56);
-                                b = static_cast<unsigned char>(18 * y2 + 51);
-                            }
-                            else if (y2 < 0.3f)
-                            {
-                                if (y2 < 0.1f)
-                                    y2 *= 8.f;
-                                else
-                                {
-                                    y2 -= 0.1f;
-                                    y2 += 0.8f;
-                                }
-                                r = static_cast<unsigned char>(66 - 32 * y2);
-                                g = static_cast<unsigned char>(48 - 23 * y2);
-                                b = static_cast<unsigned char>(33 - 16 * y2);
-                            }
-                            else
-                            {
-                                y2 -= 0.3f;
-                                y2 *= 1.428f;
-                                r = static_cast<unsigned char>(34 - 29 * y2);
-                                g = static_cast<unsigned char>(25 - 20 * y2);
-                                b = static_cast<unsigned char>(17 - 12 * y2);
-                            }
-
-                            data[texelY * mWidth * 3 + texelX * 3] = r;
-                            data[texelY * mWidth * 3 + texelX * 3+1] = g;
-                            data[texelY * mWidth * 3 + texelX * 3+2] = b;
-
-                            alphaData[texelY * mWidth+ texelX] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
+                            y2 -= 0.1f;
+                            y2 += 0.8f;
                         }
+                        r = static_cast<unsigned char>(66 - 32 * y2);
+                        g = static_cast<unsigned char>(48 - 23 * y2);
+                        b = static_cast<unsigned char>(33 - 16 * y2);
+                    }
+                    else
+                    {
+                        y2 -= 0.3f;
+                        y2 *= 1.428f;
+                        r = static_cast<unsigned char>(34 - 29 * y2);
+                        g = static_cast<unsigned char>(25 - 20 * y2);
+                        b = static_cast<unsigned char>(17 - 12 * y2);
                     }
+
+                    data[texelY * mWidth * 3 + texelX * 3] = r;
+                    data[texelY * mWidth * 3 + texelX * 3+1] = g;
+                    data[texelY * mWidth * 3 + texelX * 3+2] = b;
+
+                    alphaData[texelY * mWidth+ texelX] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
                 }
             }
+        }
+
+        static constexpr int sColumnsPerBand = 16;
+
+        int mWidth, mHeight;
+        int mMinX, mMinY, mMaxX, mMaxY;
+        int mCellSize;
+        const MWWorld::Store<ESM::Land>& mLandStore;
+
+        const int mNumBands;
+        std::unique_ptr<std::atomic_bool[]> mClaimed;
+        int mRemaining;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+    };
+
+    class DrawBaseMapBandWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        DrawBaseMapBandWorkItem(BaseMapRaster* raster, int band)
+            : mRaster(raster), mBand(band)
+        {
+        }
+
+        void doWork() override
+        {
+            mRaster->drawBand(mBand);
+        }
+
+    private:
+        osg::ref_ptr<BaseMapRaster> mRaster;
+        int mBand;
+    };
+
+    class CreateMapWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore,
+                          SceneUtil::WorkQueue* workQueue, const std::string& cachePath)
+            : mWidth(width), mHeight(height), mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mCellSize(cellSize), mLandStore(landStore)
+            , mWorkQueue(workQueue), mCachePath(cachePath)
+        {
+        }
+
+        void doWork() override
+        {
+            osg::ref_ptr<BaseMapRaster> raster = new BaseMapRaster(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, mLandStore);
+
+            std::string cacheFile;
+            std::size_t hash = 0;
+            if (!mCachePath.empty())
+            {
+                hash = getBaseMapHash();
+                std::ostringstream stream;
+                stream << mCachePath << "/" << std::hex << std::setfill('0') << std::setw(16) << hash << ".bin";
+                cacheFile = stream.str();
+            }
+
+            if (cacheFile.empty() || !readBaseMap(cacheFile, hash, *raster->mImage, *raster->mAlphaImage))
+            {
+                // Let idle worker threads help, then draw whatever bands they haven't claimed yet.
+                // Nothing waits for the queued items, so this can't deadlock when there is only one worker thread.
+                for (int band = 1; band < raster->getNumBands(); ++band)
+                    mWorkQueue->addWorkItem(new DrawBaseMapBandWorkItem(raster, band), SceneUtil::WorkPriority::Low);
+                for (int band = 0; band < raster->getNumBands(); ++band)
+                    raster->drawBand(band);
+                raster->waitTillDone();
+
+                if (!cacheFile.empty())
+                    writeBaseMap(cacheFile, hash, *raster->mImage, *raster->mAlphaImage);
+            }
+
+            osg::ref_ptr<osg::Image> image = raster->mImage;
+            osg::ref_ptr<osg::Image> alphaImage = raster->mAlphaImage;
 
             mBaseTexture = new osg::Texture2D;
             mBaseTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
@@ -213,12 +389,39 @@ namespace MWRender
         int mMinX, mMinY, mMaxX, mMaxY;
         int mCellSize;
         const MWWorld::Store<ESM::Land>& mLandStore;
+        SceneUtil::WorkQueue* mWorkQueue;
+        std::string mCachePath;
 
         osg::ref_ptr<osg::Texture2D> mBaseTexture;
         osg::ref_ptr<osg::Texture2D> mAlphaTexture;
 
         osg::ref_ptr<osg::Image> mOverlayImage;
         osg::ref_ptr<osg::Texture2D> mOverlayTexture;
+
+    private:
+        /// Everything the base map is drawn from: the map bounds, the cell size and the WNAM data of the land records
+        std::size_t getBaseMapHash() const
+        {
+            std::size_t seed = 0;
+            Misc::hashCombine(seed, mMinX);
+            Misc::hashCombine(seed, mMinY);
+            Misc::hashCombine(seed, mMaxX);
+            Misc::hashCombine(seed, mMaxY);
+            Misc::hashCombine(seed, mCellSize);
+            for (int x = mMinX; x <= mMaxX; ++x)
+            {
+                for (int y = mMinY; y <= mMaxY; ++y)
+                {
+                    const ESM::Land* land = mLandStore.search(x, y);
+                    if (!land || !(land->mDataTypes & ESM::Land::DATA_WNAM))
+                        continue;
+                    Misc::hashCombine(seed, x);
+                    Misc::hashCombine(seed, y);
+                    Misc::hashCombine(seed, std::string_view(reinterpret_cast<const char*>(land->mWnam), sizeof(land->mWnam)));
+                }
+            }
+            return seed;
+        }
     };
 
     GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue)
@@ -244,6 +447,22 @@ namespace MWRender
             mWorkItem->waitTillDone();
     }
 
+    void GlobalMap::setCachePath(const std::string& path)
+    {
+        mCachePath.clear();
+        if (path.empty())
+            return;
+
+        boost::system::error_code error;
+        boost::filesystem::create_directories(path, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to create global map cache directory " << path << ": " << error.message();
+            return;
+        }
+        mCachePath = path;
+    }
+
     void GlobalMap::render ()
     {
         const MWWorld::ESMStore &esmStore =
@@ -266,7 +485,8 @@ namespace MWRender
         mWidth = mCellSize*(mMaxX-mMinX+1);
         mHeight = mCellSize*(mMaxY-mMinY+1);
 
-        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>());
+        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>(),
+                                          mWorkQueue, mCachePath);
         mWorkQueue->addWorkItem(mWorkItem);
     }
 
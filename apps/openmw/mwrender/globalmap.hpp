@@ -36,6 +36,11 @@ namespace MWRender
         GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue);
         ~GlobalMap();
 
+        /// Keep generated base maps in the given directory and load them instead of generating them again.
+        /// Must be called before render().
+        void setCachePath(const std::string& path);
+
+        /// Start generating the base map on the work queue
         void render();
 
         int getWidth() const { return mWidth; }
@@ -122,6 +127,8 @@ namespace MWRender
         osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
         osg::ref_ptr<CreateMapWorkItem> mWorkItem;
 
+        std::string mCachePath;
+
         int mWidth;
         int mHeight;
 
@@ -31,9 +31,18 @@ namespace MWRender
 
         void apply(osg::Geometry& geom) override
         {
+            // The primitive sets are copies, which lose the buffer object of the prototype
+            osg::ref_ptr<osg::ElementBufferObject> elementBuffer;
             for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
             {
-                geom.getPrimitiveSet(i)->setNumInstances(mInstances.size());
+                osg::PrimitiveSet* primitiveSet = geom.getPrimitiveSet(i);
+                primitiveSet->setNumInstances(mInstances.size());
+                if (osg::DrawElements* elements = primitiveSet->getDrawElements(); elements && !elements->getElementBufferObject())
+                {
+                    if (!elementBuffer)
+                        elementBuffer = new osg::ElementBufferObject;
+                    elements->setElementBufferObject(elementBuffer);
+                }
             }
 
             osg::ref_ptr<osg::Vec4Array> transforms = new osg::Vec4Array(mInstances.size());
@@ -59,9 +68,11 @@ namespace MWRender
                 (*rotations)[i] = mInstances[i].mPos.asRotationVec3();
             }
 
-            // Display lists do not support instancing in OSG 3.4
-            geom.setUseDisplayList(false);
-            geom.setUseVertexBufferObjects(true);
+            // The other arrays are shared with the prototype and all other chunks, so the instance data must not be put
+            // into their buffer object
+            osg::ref_ptr<osg::VertexBufferObject> instanceBuffer = new osg::VertexBufferObject;
+            transforms->setVertexBufferObject(instanceBuffer);
+            rotations->setVertexBufferObject(instanceBuffer);
 
             geom.setVertexAttribArray(6, transforms.get(), osg::Array::BIND_PER_VERTEX);
             geom.setVertexAttribArray(7, rotations.get(), osg::Array::BIND_PER_VERTEX);
@@ -71,6 +82,21 @@ namespace MWRender
         osg::Vec3f mChunkPosition;
     };
 
+    /// Makes the geometry of a groundcover prototype ready to be shared by instanced copies.
+    class PrototypeVisitor : public osg::NodeVisitor
+    {
+    public:
+        PrototypeVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geometry& geom) override
+        {
+            // Display lists do not support instancing in OSG 3.4. Buffer objects have to be assigned to the shared
+            // arrays here, copies would assign them otherwise on several threads at once.
+            geom.setUseDisplayList(false);
+            geom.setUseVertexBufferObjects(true);
+        }
+    };
+
     class DensityCalculator
     {
     public:
@@ -224,11 +250,15 @@ namespace MWRender
         osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         for (auto& pair : instances)
         {
-            const osg::Node* temp = mSceneManager->getTemplate(pair.first);
-            osg::ref_ptr<osg::Node> node = static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES));
+            const osg::ref_ptr<const osg::Group> prototype = getPrototype(pair.first);
 
-            // Keep link to original mesh to keep it in cache
-            group->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(temp));
+            // Vertex arrays and state are shared with the prototype, only the primitives are copied to set the number
+            // of instances
+            osg::ref_ptr<osg::Group> node = new osg::Group;
+            node->setStateSet(const_cast<osg::StateSet*>(prototype->getStateSet()));
+            for (unsigned int i = 0; i < prototype->getNumChildren(); ++i)
+                node->addChild(static_cast<osg::Node*>(prototype->getChild(i)->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_PRIMITIVES)));
+            node->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(prototype));
 
             InstancingVisitor visitor(pair.second, worldCenter);
             node->accept(visitor);
@@ -240,16 +270,54 @@ namespace MWRender
         osg::BoundingBox box = cbv.getBoundingBox();
         group->addCullCallback(new ViewDistanceCallback(getViewDistance(), box));
 
-        group->setStateSet(mStateset);
         group->setNodeMask(Mask_Groundcover);
         if (mSceneManager->getLightingMethod() != SceneUtil::LightingMethod::FFP)
             group->addCullCallback(new SceneUtil::LightListCallback);
-        mSceneManager->recreateShaders(group, "groundcover", true, mProgramTemplate);
-        mSceneManager->shareState(group);
         group->getBound();
         return group;
     }
 
+    osg::ref_ptr<const osg::Group> Groundcover::getPrototype(const std::string& model)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mPrototypesMutex);
+            const auto found = mPrototypes.find(model);
+            if (found != mPrototypes.end())
+                return found->second;
+        }
+
+        const osg::Node* temp = mSceneManager->getTemplate(model);
+        osg::ref_ptr<osg::Group> prototype = new osg::Group;
+        prototype->setStateSet(mStateset);
+        prototype->addChild(static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES)));
+
+        // Keep link to original mesh to keep it in cache
+        prototype->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(temp));
+
+        mSceneManager->recreateShaders(prototype, "groundcover", true, mProgramTemplate);
+        mSceneManager->shareState(prototype);
+        PrototypeVisitor visitor;
+        prototype->accept(visitor);
+
+        std::lock_guard<std::mutex> lock(mPrototypesMutex);
+        return mPrototypes.emplace(model, std::move(prototype)).first->second;
+    }
+
+    void Groundcover::clearCache()
+    {
+        GenericResourceManager<GroundcoverChunkId>::clearCache();
+        std::lock_guard<std::mutex> lock(mPrototypesMutex);
+        mPrototypes.clear();
+    }
+
+    void Groundcover::releaseGLObjects(osg::State* state)
+    {
+        GenericResourceManager<GroundcoverChunkId>::releaseGLObjects(state);
+        std::lock_guard<std::mutex> lock(mPrototypesMutex);
+        for (const auto& [model, prototype] : mPrototypes)
+            prototype->releaseGLObjects(state);
+    }
+
     unsigned int Groundcover::getNodeMask()
     {
         return Mask_Groundcover;
@@ -258,5 +326,6 @@ namespace MWRender
     void Groundcover::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Groundcover Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Groundcover Chunk Memory", mCache->getMemoryUsage());
     }
 }
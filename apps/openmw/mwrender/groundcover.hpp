@@ -5,6 +5,9 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/esm3/loadcell.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace MWWorld
 {
     class ESMStore;
@@ -30,6 +33,10 @@ namespace MWRender
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
+        void clearCache() override;
+
+        void releaseGLObjects(osg::State* state) override;
+
         struct GroundcoverEntry
         {
             ESM::Position mPos;
@@ -46,9 +53,14 @@ namespace MWRender
         osg::ref_ptr<osg::Program> mProgramTemplate;
         const MWWorld::GroundcoverStore& mGroundcoverStore;
 
+        // Copies of the groundcover meshes with shaders, which share their arrays and state with all chunks
+        std::map<std::string, osg::ref_ptr<osg::Group>> mPrototypes;
+        std::mutex mPrototypesMutex;
+
         typedef std::map<std::string, std::vector<GroundcoverEntry>> InstanceMap;
         osg::ref_ptr<osg::Node> createChunk(InstanceMap& instances, const osg::Vec2f& center);
         void collectInstances(InstanceMap& instances, float size, const osg::Vec2f& center);
+        osg::ref_ptr<const osg::Group> getPrototype(const std::string& model);
     };
 }
 
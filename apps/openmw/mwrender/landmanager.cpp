@@ -14,6 +14,7 @@ namespace MWRender
 LandManager::LandManager(int loadFlags)
     : GenericResourceManager<std::pair<int, int> >(nullptr)
     , mLoadFlags(loadFlags)
+    , mHeightsCache(new CacheType)
 {
     mCache = new CacheType;
 }
@@ -23,20 +24,58 @@ osg::ref_ptr<ESMTerrain::LandObject> LandManager::getLand(int x, int y)
     osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(std::make_pair(x,y));
     if (obj)
         return static_cast<ESMTerrain::LandObject*>(obj.get());
-    else
-    {
-        const ESM::Land* land = MWBase::Environment::get().getWorld()->getStore().get<ESM::Land>().search(x,y);
-        if (!land)
-            return nullptr;
-        osg::ref_ptr<ESMTerrain::LandObject> landObj (new ESMTerrain::LandObject(land, mLoadFlags));
-        mCache->addEntryToObjectCache(std::make_pair(x,y), landObj.get());
-        return landObj;
-    }
+    return load(*mCache, x, y, mLoadFlags);
+}
+
+osg::ref_ptr<ESMTerrain::LandObject> LandManager::getLandHeights(int x, int y)
+{
+    if (osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(std::make_pair(x,y)))
+        return static_cast<ESMTerrain::LandObject*>(obj.get());
+    if (osg::ref_ptr<osg::Object> obj = mHeightsCache->getRefFromObjectCache(std::make_pair(x,y)))
+        return static_cast<ESMTerrain::LandObject*>(obj.get());
+    return load(*mHeightsCache, x, y, ESM::Land::DATA_VHGT);
+}
+
+osg::ref_ptr<ESMTerrain::LandObject> LandManager::load(CacheType& cache, int x, int y, int loadFlags)
+{
+    const ESM::Land* land = MWBase::Environment::get().getWorld()->getStore().get<ESM::Land>().search(x,y);
+    if (!land)
+        return nullptr;
+    osg::ref_ptr<ESMTerrain::LandObject> landObj (new ESMTerrain::LandObject(land, loadFlags));
+    cache.addEntryToObjectCache(std::make_pair(x,y), landObj.get(), 0.0, landObj->getMemoryUsage());
+    return landObj;
+}
+
+void LandManager::updateCache(double referenceTime)
+{
+    GenericResourceManager::updateCache(referenceTime);
+    mHeightsCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
+    mHeightsCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+}
+
+void LandManager::clearCache()
+{
+    GenericResourceManager::clearCache();
+    mHeightsCache->clear();
+}
+
+std::size_t LandManager::getMemoryUsage() const
+{
+    return mCache->getMemoryUsage() + mHeightsCache->getMemoryUsage();
+}
+
+void LandManager::collectEvictionCandidates(double referenceTime, std::vector<Resource::EvictionCandidate>& candidates)
+{
+    mCache->collectEvictionCandidates(referenceTime, candidates);
+    mHeightsCache->collectEvictionCandidates(referenceTime, candidates);
 }
 
 void LandManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
     stats->setAttribute(frameNumber, "Land", mCache->getCacheSize());
+    stats->setAttribute(frameNumber, "Land Memory", mCache->getMemoryUsage());
+    stats->setAttribute(frameNumber, "Land Heights", mHeightsCache->getCacheSize());
+    stats->setAttribute(frameNumber, "Land Heights Memory", mHeightsCache->getMemoryUsage());
 }
 
 
@@ -14,6 +14,9 @@ namespace ESM
 namespace MWRender
 {
 
+    /// Caches the land of each cell at two levels of data: all of it for the terrain near enough to be built,
+    /// and only the heights for physics, height queries and the bounds of distant terrain nodes.
+    /// Both levels count towards the cache memory budget.
     class LandManager : public Resource::GenericResourceManager<std::pair<int, int> >
     {
     public:
@@ -22,10 +25,25 @@ namespace MWRender
         /// @note Will return nullptr if not found.
         osg::ref_ptr<ESMTerrain::LandObject> getLand(int x, int y);
 
+        /// Get a land with at least the heights loaded, the full land if it's cached anyway.
+        /// @note Will return nullptr if not found.
+        osg::ref_ptr<ESMTerrain::LandObject> getLandHeights(int x, int y);
+
+        void updateCache(double referenceTime) override;
+
+        void clearCache() override;
+
+        std::size_t getMemoryUsage() const override;
+
+        void collectEvictionCandidates(double referenceTime, std::vector<Resource::EvictionCandidate>& candidates) override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
         int mLoadFlags;
+        osg::ref_ptr<CacheType> mHeightsCache;
+
+        osg::ref_ptr<ESMTerrain::LandObject> load(CacheType& cache, int x, int y, int loadFlags);
     };
 
 }
@@ -1,6 +1,9 @@
 #include "localmap.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <mutex>
 
 #include <osg/Fog>
 #include <osg/LightModel>
@@ -29,6 +32,7 @@
 #include "../mwbase/world.hpp"
 
 #include "../mwworld/cellstore.hpp"
+#include "../mwworld/ptr.hpp"
 
 #include "vismask.hpp"
 
@@ -83,12 +87,78 @@ namespace
 namespace MWRender
 {
 
+/// Uploads only the region of the fog of war image that changed since the last upload,
+/// instead of the whole image like osg::Image::dirty does.
+class FogOfWarSubloadCallback : public osg::Texture2D::SubloadCallback
+{
+public:
+    void setImage(osg::Image* image)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mImage = image;
+        mMinX = 0;
+        mMinY = 0;
+        mMaxX = image->s() - 1;
+        mMaxY = image->t() - 1;
+    }
+
+    void dirty(int minX, int minY, int maxX, int maxY)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMinX = std::min(mMinX, minX);
+        mMinY = std::min(mMinY, minY);
+        mMaxX = std::max(mMaxX, maxX);
+        mMaxY = std::max(mMaxY, maxY);
+    }
+
+    void load(const osg::Texture2D& texture, osg::State& state) const override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, mImage->getPacking());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mImage->s(), mImage->t(), 0,
+                     mImage->getPixelFormat(), mImage->getDataType(), mImage->data());
+        clear();
+    }
+
+    void subload(const osg::Texture2D& texture, osg::State& state) const override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mMaxX < mMinX || mMaxY < mMinY)
+            return;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, mImage->getPacking());
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, mImage->s());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, mMinX, mMinY, mMaxX - mMinX + 1, mMaxY - mMinY + 1,
+                        mImage->getPixelFormat(), mImage->getDataType(), mImage->data(mMinX, mMinY));
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        clear();
+    }
+
+private:
+    void clear() const
+    {
+        mMinX = std::numeric_limits<int>::max();
+        mMinY = std::numeric_limits<int>::max();
+        mMaxX = -1;
+        mMaxY = -1;
+    }
+
+    osg::ref_ptr<osg::Image> mImage;
+    mutable std::mutex mMutex;
+    mutable int mMinX = std::numeric_limits<int>::max();
+    mutable int mMinY = std::numeric_limits<int>::max();
+    mutable int mMaxX = -1;
+    mutable int mMaxY = -1;
+};
+
 LocalMap::LocalMap(osg::Group* root)
     : mRoot(root)
     , mMapResolution(Settings::Manager::getInt("local map resolution", "Map"))
+    , mMaxRendersPerFrame(std::max(0, Settings::Manager::getInt("local map max renders per frame", "Map")))
     , mMapWorldSize(Constants::CellSizeInUnits)
     , mCellDistance(Constants::CellGridRadius)
     , mAngle(0.f)
+    , mFogUpdateTimer(sFogOfWarUpdateInterval)
+    , mFogUpdateInterior(false)
     , mInterior(false)
 {
     // Increase map resolution, if use UI scaling
@@ -108,6 +178,8 @@ LocalMap::~LocalMap()
         removeCamera(camera);
     for (auto& camera : mCamerasPendingRemoval)
         removeCamera(camera);
+    for (auto& queued : mQueuedCameras)
+        removeCamera(queued.mCamera);
 }
 
 const osg::Vec2f LocalMap::rotatePoint(const osg::Vec2f& point, const osg::Vec2f& center, const float angle)
@@ -118,8 +190,14 @@ const osg::Vec2f LocalMap::rotatePoint(const osg::Vec2f& point, const osg::Vec2f
 
 void LocalMap::clear()
 {
+    for (auto& queued : mQueuedCameras)
+        removeCamera(queued.mCamera);
+    mQueuedCameras.clear();
+
     mExteriorSegments.clear();
     mInteriorSegments.clear();
+
+    mFogUpdateTimer = sFogOfWarUpdateInterval;
 }
 
 void LocalMap::saveFogOfWar(MWWorld::CellStore* cell)
@@ -237,7 +315,6 @@ osg::ref_ptr<osg::Camera> LocalMap::createOrthographicCamera(float x, float y, f
     camera->addChild(lightSource);
     camera->setStateSet(stateset);
     camera->setViewport(0, 0, mMapResolution, mMapResolution);
-    camera->setUpdateCallback(new CameraLocalUpdateCallback(this));
 
     return camera;
 }
@@ -254,14 +331,56 @@ void LocalMap::setupRenderToTexture(osg::ref_ptr<osg::Camera> camera, int x, int
 
     SceneUtil::attachAlphaToCoverageFriendlyFramebufferToCamera(camera, osg::Camera::COLOR_BUFFER, texture);
 
-    camera->addChild(mSceneRoot);
+    // The scene is only added once the render is started, until then the camera just clears the texture
     mRoot->addChild(camera);
-    mActiveCameras.push_back(camera);
+    mQueuedCameras.push_back({camera, std::make_pair(x, y), mInterior});
 
     MapSegment& segment = mInterior? mInteriorSegments[std::make_pair(x, y)] : mExteriorSegments[std::make_pair(x, y)];
     segment.mMapTexture = texture;
 }
 
+void LocalMap::startRender(osg::Camera* camera)
+{
+    camera->addChild(mSceneRoot);
+    camera->setUpdateCallback(new CameraLocalUpdateCallback(this));
+    mActiveCameras.push_back(camera);
+}
+
+std::vector<LocalMap::QueuedCamera>::iterator LocalMap::findQueuedExteriorCamera(int x, int y)
+{
+    return std::find_if(mQueuedCameras.begin(), mQueuedCameras.end(), [&] (const QueuedCamera& queued)
+    {
+        return !queued.mInterior && queued.mSegment == std::make_pair(x, y);
+    });
+}
+
+void LocalMap::discardQueuedCameras(bool interior)
+{
+    for (auto it = mQueuedCameras.begin(); it != mQueuedCameras.end();)
+    {
+        if (it->mInterior != interior)
+        {
+            ++it;
+            continue;
+        }
+
+        removeCamera(it->mCamera);
+
+        // The texture was never rendered, so it has to be requested again
+        if (!interior)
+        {
+            SegmentMap::iterator found = mExteriorSegments.find(it->mSegment);
+            if (found != mExteriorSegments.end())
+            {
+                found->second.mMapTexture = nullptr;
+                found->second.needUpdate = true;
+            }
+        }
+
+        it = mQueuedCameras.erase(it);
+    }
+}
+
 void LocalMap::requestMap(const MWWorld::CellStore* cell)
 {
     if (cell->isExterior())
@@ -290,6 +409,13 @@ void LocalMap::addCell(MWWorld::CellStore *cell)
 
 void LocalMap::removeExteriorCell(int x, int y)
 {
+    auto found = findQueuedExteriorCamera(x, y);
+    if (found != mQueuedCameras.end())
+    {
+        removeCamera(found->mCamera);
+        mQueuedCameras.erase(found);
+    }
+
     mExteriorSegments.erase({ x, y });
 }
 
@@ -321,6 +447,16 @@ osg::ref_ptr<osg::Texture2D> LocalMap::getFogOfWarTexture(int x, int y)
         return found->second.mFogOfWarTexture;
 }
 
+void LocalMap::flushExteriorMap(int x, int y)
+{
+    auto found = findQueuedExteriorCamera(x, y);
+    if (found != mQueuedCameras.end())
+    {
+        startRender(found->mCamera);
+        mQueuedCameras.erase(found);
+    }
+}
+
 void LocalMap::removeCamera(osg::Camera *cam)
 {
     cam->removeChildren(0, cam->getNumChildren());
@@ -341,22 +477,48 @@ void LocalMap::markForRemoval(osg::Camera *cam)
 
 void LocalMap::cleanupCameras()
 {
-    if (mCamerasPendingRemoval.empty())
-        return;
-
     for (auto& camera : mCamerasPendingRemoval)
         removeCamera(camera);
 
     mCamerasPendingRemoval.clear();
+
+    if (mQueuedCameras.empty())
+        return;
+
+    std::size_t count = mQueuedCameras.size();
+    if (mMaxRendersPerFrame > 0)
+        count = std::min(count, static_cast<std::size_t>(mMaxRendersPerFrame));
+
+    const auto distance = [&] (const QueuedCamera& queued)
+    {
+        return square(static_cast<float>(queued.mSegment.first - mPlayerSegment.first))
+            + square(static_cast<float>(queued.mSegment.second - mPlayerSegment.second));
+    };
+    std::partial_sort(mQueuedCameras.begin(), mQueuedCameras.begin() + count, mQueuedCameras.end(),
+        [&] (const QueuedCamera& left, const QueuedCamera& right) { return distance(left) < distance(right); });
+
+    for (std::size_t i = 0; i < count; ++i)
+        startRender(mQueuedCameras[i].mCamera);
+    mQueuedCameras.erase(mQueuedCameras.begin(), mQueuedCameras.begin() + count);
 }
 
 void LocalMap::requestExteriorMap(const MWWorld::CellStore* cell)
 {
+    discardQueuedCameras(true);
+
     mInterior = false;
 
     int x = cell->getCell()->getGridX();
     int y = cell->getCell()->getGridY();
 
+    // A render requested before the cell was reloaded would show outdated contents
+    auto found = findQueuedExteriorCamera(x, y);
+    if (found != mQueuedCameras.end())
+    {
+        removeCamera(found->mCamera);
+        mQueuedCameras.erase(found);
+    }
+
     osg::BoundingSphere bound = mSceneRoot->getBound();
     float zmin = bound.center().z() - bound.radius();
     float zmax = bound.center().z() + bound.radius();
@@ -377,6 +539,9 @@ void LocalMap::requestExteriorMap(const MWWorld::CellStore* cell)
 
 void LocalMap::requestInteriorMap(const MWWorld::CellStore* cell)
 {
+    discardQueuedCameras(true);
+    discardQueuedCameras(false);
+
     osg::ComputeBoundsVisitor computeBoundsVisitor;
     computeBoundsVisitor.setTraversalMask(Mask_Scene | Mask_Terrain | Mask_Object | Mask_Static);
     mSceneRoot->accept(computeBoundsVisitor);
@@ -483,6 +648,11 @@ void LocalMap::requestInteriorMap(const MWWorld::CellStore* cell)
         }
     }
 
+    // Render the segments around the player first
+    const osg::Vec3f playerPosition = MWBase::Environment::get().getWorld()->getPlayerPtr().getRefData().getPosition().asVec3();
+    float nX, nY;
+    worldToInteriorMapPosition(osg::Vec2f(playerPosition.x(), playerPosition.y()), nX, nY, mPlayerSegment.first, mPlayerSegment.second);
+
     osg::Vec2f min(mBounds.xMin(), mBounds.yMin());
 
     osg::Vec2f center(mBounds.center().x(), mBounds.center().y());
@@ -575,7 +745,7 @@ osg::Group* LocalMap::getRoot()
     return mRoot;
 }
 
-void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orientation,
+void LocalMap::updatePlayer (float dt, const osg::Vec3f& position, const osg::Quat& orientation,
                              float& u, float& v, int& x, int& y, osg::Vec3f& direction)
 {
     // retrieve the x,y grid coordinates the player is in
@@ -600,6 +770,16 @@ void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orient
         v = 1.0f-std::abs((pos.y() - (mMapWorldSize*y))/mMapWorldSize);
     }
 
+    mPlayerSegment = std::make_pair(x, y);
+
+    // coalesce fog of war changes, but reveal a new segment right away
+    mFogUpdateTimer += dt;
+    if (mFogUpdateTimer < sFogOfWarUpdateInterval && mFogUpdateSegment == mPlayerSegment && mFogUpdateInterior == mInterior)
+        return;
+    mFogUpdateTimer = 0.f;
+    mFogUpdateSegment = mPlayerSegment;
+    mFogUpdateInterior = mInterior;
+
     // explore radius (squared)
     const float exploreRadius = 0.17f * (sFogOfWarResolution-1); // explore radius from 0 to sFogOfWarResolution-1
     const float sqrExploreRadius = square(exploreRadius);
@@ -634,7 +814,10 @@ void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orient
                 continue;
 
             uint32_t* data = (uint32_t*)segment.mFogOfWarImage->data();
-            bool changed = false;
+            int minU = sFogOfWarResolution;
+            int minV = sFogOfWarResolution;
+            int maxU = -1;
+            int maxV = -1;
             for (int texV = 0; texV<sFogOfWarResolution; ++texV)
             {
                 for (int texU = 0; texU<sFogOfWarResolution; ++texU)
@@ -649,17 +832,20 @@ void LocalMap::updatePlayer (const osg::Vec3f& position, const osg::Quat& orient
                     if ( *data != val)
                     {
                         *data = val;
-                        changed = true;
+                        minU = std::min(minU, texU);
+                        minV = std::min(minV, texV);
+                        maxU = std::max(maxU, texU);
+                        maxV = std::max(maxV, texV);
                     }
 
                     ++data;
                 }
             }
 
-            if (changed)
+            if (maxU >= 0)
             {
                 segment.mHasFogState = true;
-                segment.mFogOfWarImage->dirty();
+                segment.dirtyFogOfWar(minU, minV, maxU, maxV);
             }
         }
     }
@@ -682,22 +868,35 @@ void LocalMap::MapSegment::createFogOfWarTexture()
     mFogOfWarTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
     mFogOfWarTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
     mFogOfWarTexture->setUnRefImageDataAfterApply(false);
+    mFogOfWarTexture->setInternalFormat(GL_RGBA);
+    mFogOfWarSubload = new FogOfWarSubloadCallback;
+    mFogOfWarTexture->setSubloadCallback(mFogOfWarSubload);
+}
+
+void LocalMap::MapSegment::setFogOfWarImage(osg::Image* image)
+{
+    mFogOfWarImage = image;
+    createFogOfWarTexture();
+    mFogOfWarTexture->setTextureSize(image->s(), image->t());
+    mFogOfWarSubload->setImage(image);
+}
+
+void LocalMap::MapSegment::dirtyFogOfWar(int minX, int minY, int maxX, int maxY)
+{
+    mFogOfWarSubload->dirty(minX, minY, maxX, maxY);
 }
 
 void LocalMap::MapSegment::initFogOfWar()
 {
-    mFogOfWarImage = new osg::Image;
-    // Assign a PixelBufferObject for asynchronous transfer of data to the GPU
-    mFogOfWarImage->setPixelBufferObject(new osg::PixelBufferObject);
-    mFogOfWarImage->allocateImage(sFogOfWarResolution, sFogOfWarResolution, 1, GL_RGBA, GL_UNSIGNED_BYTE);
-    assert(mFogOfWarImage->isDataContiguous());
+    osg::ref_ptr<osg::Image> image = new osg::Image;
+    image->allocateImage(sFogOfWarResolution, sFogOfWarResolution, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    assert(image->isDataContiguous());
     std::vector<uint32_t> data;
     data.resize(sFogOfWarResolution*sFogOfWarResolution, 0xff000000);
 
-    memcpy(mFogOfWarImage->data(), &data[0], data.size()*4);
+    memcpy(image->data(), &data[0], data.size()*4);
 
-    createFogOfWarTexture();
-    mFogOfWarTexture->setImage(mFogOfWarImage);
+    setFogOfWarImage(image);
 }
 
 void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
@@ -725,12 +924,10 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
         return;
     }
 
-    mFogOfWarImage = result.getImage();
-    mFogOfWarImage->flipVertical();
-    mFogOfWarImage->dirty();
+    osg::ref_ptr<osg::Image> image = result.getImage();
+    image->flipVertical();
 
-    createFogOfWarTexture();
-    mFogOfWarTexture->setImage(mFogOfWarImage);
+    setFogOfWarImage(image);
     mHasFogState = true;
 }
 
@@ -30,6 +30,8 @@ namespace osg
 
 namespace MWRender
 {
+    class FogOfWarSubloadCallback;
+
     ///
     /// \brief Local map rendering
     ///
@@ -46,6 +48,7 @@ namespace MWRender
 
         /**
          * Request a map render for the given cell. Render textures will be immediately created and can be retrieved with the getMapTexture function.
+         * The textures stay black until their render is started by cleanupCameras.
          */
         void requestMap (const MWWorld::CellStore* cell);
 
@@ -58,6 +61,12 @@ namespace MWRender
 
         osg::ref_ptr<osg::Texture2D> getFogOfWarTexture (int x, int y);
 
+        /**
+         * Start the render of the given exterior segment in this frame if it is still queued.
+         * Used when the texture contents are needed right away, e.g. to copy them to the global map.
+         */
+        void flushExteriorMap(int x, int y);
+
         void removeCamera(osg::Camera* cam);
 
         /**
@@ -69,15 +78,17 @@ namespace MWRender
          * Removes cameras that have already been rendered. Should be called every frame to ensure that
          * we do not render the same map more than once. Note, this cleanup is difficult to implement in an
          * automated fashion, since we can't alter the scene graph structure from within an update callback.
+         * Also starts the queued renders closest to the player, as many as the per frame limit allows.
          */
         void cleanupCameras();
 
         /**
          * Set the position & direction of the player, and returns the position in map space through the reference parameters.
          * @remarks This is used to draw a "fog of war" effect
-         * to hide areas on the map the player has not discovered yet.
+         * to hide areas on the map the player has not discovered yet. Fog of war changes are coalesced
+         * and applied at most every sFogOfWarUpdateInterval seconds, unless the player changes segment.
          */
-        void updatePlayer (const osg::Vec3f& position, const osg::Quat& orientation,
+        void updatePlayer (float dt, const osg::Vec3f& position, const osg::Quat& orientation,
                            float& u, float& v, int& x, int& y, osg::Vec3f& direction);
 
         /**
@@ -110,6 +121,23 @@ namespace MWRender
 
         CameraVector mCamerasPendingRemoval;
 
+        struct QueuedCamera
+        {
+            osg::ref_ptr<osg::Camera> mCamera;
+            std::pair<int, int> mSegment;
+            bool mInterior;
+        };
+
+        /// Cameras waiting for their render to start. Until then they only clear their texture.
+        std::vector<QueuedCamera> mQueuedCameras;
+
+        std::pair<int, int> mPlayerSegment;
+
+        /// Time since the fog of war was last updated, and the segment the player was in at that time.
+        float mFogUpdateTimer;
+        std::pair<int, int> mFogUpdateSegment;
+        bool mFogUpdateInterior;
+
         typedef std::set<std::pair<int, int> > Grid;
         Grid mCurrentGrid;
 
@@ -122,10 +150,13 @@ namespace MWRender
             void loadFogOfWar(const ESM::FogTexture& fog);
             void saveFogOfWar(ESM::FogTexture& fog) const;
             void createFogOfWarTexture();
+            void setFogOfWarImage(osg::Image* image);
+            void dirtyFogOfWar(int minX, int minY, int maxX, int maxY);
 
             osg::ref_ptr<osg::Texture2D> mMapTexture;
             osg::ref_ptr<osg::Texture2D> mFogOfWarTexture;
             osg::ref_ptr<osg::Image> mFogOfWarImage;
+            osg::ref_ptr<FogOfWarSubloadCallback> mFogOfWarSubload;
 
             bool needUpdate = true;
 
@@ -138,9 +169,14 @@ namespace MWRender
 
         int mMapResolution;
 
+        int mMaxRendersPerFrame;
+
         // the dynamic texture is a bottleneck, so don't set this too high
         static const int sFogOfWarResolution = 32;
 
+        // minimum time between fog of war updates, so walking around doesn't upload textures every frame
+        static constexpr float sFogOfWarUpdateInterval = 0.1f;
+
         // size of a map segment (for exteriors, 1 cell)
         float mMapWorldSize;
 
@@ -154,6 +190,9 @@ namespace MWRender
 
         osg::ref_ptr<osg::Camera> createOrthographicCamera(float left, float top, float width, float height, const osg::Vec3d& upVector, float zmin, float zmax);
         void setupRenderToTexture(osg::ref_ptr<osg::Camera> camera, int x, int y);
+        void startRender(osg::Camera* camera);
+        std::vector<QueuedCamera>::iterator findQueuedExteriorCamera(int x, int y);
+        void discardQueuedCameras(bool interior);
 
         bool mInterior;
         osg::BoundingBox mBounds;
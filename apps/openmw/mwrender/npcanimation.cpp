@@ -4,6 +4,9 @@
 #include <osg/MatrixTransform>
 #include <osg/Depth>
 
+#include <algorithm>
+#include <typeinfo>
+
 #include <osgUtil/RenderBin>
 #include <osgUtil/CullVisitor>
 
@@ -21,6 +24,8 @@
 #include <components/sceneutil/skeleton.hpp>
 #include <components/sceneutil/keyframe.hpp>
 #include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/mergerig.hpp>
+#include <components/sceneutil/riggeometry.hpp>
 
 #include <components/settings/settings.hpp>
 
@@ -672,6 +677,91 @@ void NpcAnimation::updateParts()
 
     if (wasArrowAttached)
         attachArrow();
+
+    mergeParts();
+}
+
+void NpcAnimation::setMergeParts(bool merge)
+{
+    if (merge == mMergeParts)
+        return;
+    mMergeParts = merge;
+    unmergeParts();
+    mergeParts();
+}
+
+void NpcAnimation::mergeParts()
+{
+    unmergeParts();
+    if (!mMergeParts || mViewMode != VM_Normal || !mObjectRoot)
+        return;
+
+    // Only skinned parts attached to the skeleton without any transform, state or controller of their own
+    std::vector<std::pair<ESM::PartReferenceType, SceneUtil::RigGeometry*>> candidates;
+    for (int i = 0; i < ESM::PRT_Count; ++i)
+    {
+        if (!mObjectParts[i])
+            continue;
+        osg::Node* node = mObjectParts[i]->getNode();
+        if (node->getUpdateCallback() != nullptr || node->getCullCallback() != nullptr)
+            continue;
+        const ESM::PartReferenceType type = static_cast<ESM::PartReferenceType>(i);
+        if (SceneUtil::RigGeometry* rig = dynamic_cast<SceneUtil::RigGeometry*>(node))
+            candidates.emplace_back(type, rig);
+        else if (typeid(*node) == typeid(osg::Group) && node->getStateSet() == nullptr)
+        {
+            osg::Group* group = node->asGroup();
+            for (unsigned int j = 0; j < group->getNumChildren(); ++j)
+                if (SceneUtil::RigGeometry* rig = dynamic_cast<SceneUtil::RigGeometry*>(group->getChild(j)))
+                    candidates.emplace_back(type, rig);
+        }
+    }
+
+    std::vector<std::vector<std::pair<ESM::PartReferenceType, SceneUtil::RigGeometry*>>> batches;
+    for (const auto& candidate : candidates)
+    {
+        auto batch = std::find_if(batches.begin(), batches.end(), [&] (const auto& v)
+            { return SceneUtil::canMergeRigGeometries(*v.front().second, *candidate.second); });
+        if (batch == batches.end())
+            batches.emplace_back(1, candidate);
+        else
+            batch->push_back(candidate);
+    }
+
+    for (const auto& batch : batches)
+    {
+        std::vector<SceneUtil::RigGeometry*> rigs;
+        for (const auto& [type, rig] : batch)
+            rigs.push_back(rig);
+        osg::ref_ptr<SceneUtil::RigGeometry> merged = SceneUtil::mergeRigGeometries(rigs);
+        if (merged == nullptr)
+            continue;
+
+        if (mMergedParts == nullptr)
+        {
+            mMergedParts = new osg::Group;
+            mObjectRoot->addChild(mMergedParts);
+        }
+        mMergedParts->addChild(merged);
+        for (const auto& [type, rig] : batch)
+        {
+            mHiddenParts.push_back(MergedPart {type, rig, rig->getNodeMask()});
+            rig->setNodeMask(0);
+        }
+    }
+}
+
+void NpcAnimation::unmergeParts()
+{
+    for (const MergedPart& part : mHiddenParts)
+        part.mNode->setNodeMask(part.mNodeMask);
+    mHiddenParts.clear();
+
+    if (mMergedParts == nullptr)
+        return;
+    while (mMergedParts->getNumParents() > 0)
+        mMergedParts->getParent(0)->removeChild(mMergedParts);
+    mMergedParts = nullptr;
 }
 
 
@@ -711,6 +801,10 @@ osg::Vec3f NpcAnimation::runAnimation(float timepassed)
 
 void NpcAnimation::removeIndividualPart(ESM::PartReferenceType type)
 {
+    // The merged drawables would keep drawing the part
+    if (std::any_of(mHiddenParts.begin(), mHiddenParts.end(), [&] (const MergedPart& v) { return v.mType == type; }))
+        unmergeParts();
+
     mPartPriorities[type] = 0;
     mPartslots[type] = -1;
 
@@ -9,6 +9,7 @@
 #include "weaponanimation.hpp"
 
 #include <array>
+#include <vector>
 
 namespace ESM
 {
@@ -78,8 +79,25 @@ private:
     bool mAccurateAiming;
     float mAimingFactor;
 
+    // Skinned parts drawn by one of the merged drawables, which are children of mMergedParts
+    struct MergedPart
+    {
+        ESM::PartReferenceType mType;
+        osg::ref_ptr<osg::Node> mNode;
+        osg::Node::NodeMask mNodeMask;
+    };
+
+    bool mMergeParts = false;
+    osg::ref_ptr<osg::Group> mMergedParts;
+    std::vector<MergedPart> mHiddenParts;
+
     void updateNpcBase();
 
+    /// Draw the skinned parts that have the same state with as few drawables as possible, the parts are hidden.
+    void mergeParts();
+    /// Show the parts hidden by mergeParts again.
+    void unmergeParts();
+
     NpcType getNpcType() const;
 
     PartHolderPtr insertBoundedPart(const std::string &model, const std::string &bonename,
@@ -153,6 +171,10 @@ public:
 
     void setViewMode(ViewMode viewMode);
 
+    /// Merge the skinned parts after every change of the equipment, in the normal view mode only.
+    /// Not meant for NpcAnimations whose parts are picked with getSlot.
+    void setMergeParts(bool merge);
+
     void updateParts();
 
     /// Rebuilds the NPC, updating their root model, animation sources, and equipment.
@@ -1,12 +1,19 @@
 #include "objectpaging.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <typeinfo>
 #include <unordered_map>
 
 #include <osg/Version>
+#include <osg/Geometry>
 #include <osg/LOD>
 #include <osg/Switch>
 #include <osg/MatrixTransform>
 #include <osg/Material>
+#include <osg/Program>
+#include <osg/VertexAttribDivisor>
 #include <osgUtil/IncrementalCompileOperation>
 
 #include <components/esm3/esmreader.hpp>
@@ -14,8 +21,11 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/sceneutil/optimizer.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/shadowproxy.hpp>
 #include <components/sceneutil/clone.hpp>
+#include <components/sceneutil/compilescheduler.hpp>
 #include <components/sceneutil/util.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/vfs/manager.hpp>
 
 #include <osgParticle/ParticleProcessor>
@@ -25,6 +35,7 @@
 #include <components/sceneutil/morphgeometry.hpp>
 #include <components/sceneutil/riggeometry.hpp>
 #include <components/settings/settings.hpp>
+#include <components/shader/shadermanager.hpp>
 #include <components/misc/rng.hpp>
 
 #include "apps/openmw/mwworld/esmstore.hpp"
@@ -342,6 +353,125 @@ namespace MWRender
         float mCurrentDistance;
     };
 
+    /// Checks whether a copy of a mesh can be drawn instanced, i.e. it has no transforms left after flattening them
+    /// and nothing that depends on the transform of each object.
+    class CanInstanceVisitor : public osg::NodeVisitor
+    {
+    public:
+        CanInstanceVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Node& node) override
+        {
+            if (!mResult || node.getCullCallback() || node.getUpdateCallback())
+            {
+                mResult = false;
+                return;
+            }
+            traverse(node);
+        }
+        void apply(osg::Transform& transform) override
+        {
+            const osg::MatrixTransform* matrixTransform = transform.asMatrixTransform();
+            if (!matrixTransform || !matrixTransform->getMatrix().isIdentity())
+            {
+                mResult = false;
+                return;
+            }
+            apply(static_cast<osg::Node&>(transform));
+        }
+        void apply(osg::Drawable& drawable) override
+        {
+            mResult = false;
+        }
+        void apply(osg::Geometry& geom) override
+        {
+            if (typeid(geom) != typeid(osg::Geometry) || geom.getCullCallback() || geom.getUpdateCallback()
+                || !geom.getVertexArray() || geom.getVertexAttribArray(6) || geom.getVertexAttribArray(7))
+                mResult = false;
+        }
+
+        bool mResult = true;
+    };
+
+    /// Draws each geometry once for each instance, transformed by the per-instance attributes of the objects shaders.
+    class SetupInstancingVisitor : public osg::NodeVisitor
+    {
+    public:
+        SetupInstancingVisitor(osg::Vec4Array* offsets, osg::Vec4Array* rotations)
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mOffsets(offsets)
+            , mRotations(rotations)
+        {}
+
+        void apply(osg::Geometry& geom) override
+        {
+            const osg::BoundingBox& geomBox = geom.getBoundingBox();
+            osg::BoundingBox box;
+            for (unsigned int i = 0; i < mOffsets->size(); ++i)
+            {
+                const osg::Vec4f& offset = (*mOffsets)[i];
+                const osg::Quat rotation((*mRotations)[i]);
+                const osg::Vec3f center = rotation * geomBox.center() * offset.w() + osg::Vec3f(offset.x(), offset.y(), offset.z());
+                box.expandBy(osg::BoundingSphere(center, geomBox.radius() * offset.w()));
+            }
+            geom.setInitialBound(box);
+
+            for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
+                geom.getPrimitiveSet(i)->setNumInstances(mOffsets->size());
+
+            // Display lists do not support instancing in OSG 3.4
+            geom.setUseDisplayList(false);
+            geom.setUseVertexBufferObjects(true);
+
+            geom.setVertexAttribArray(6, mOffsets, osg::Array::BIND_PER_VERTEX);
+            geom.setVertexAttribArray(7, mRotations, osg::Array::BIND_PER_VERTEX);
+        }
+
+    private:
+        osg::ref_ptr<osg::Vec4Array> mOffsets;
+        osg::ref_ptr<osg::Vec4Array> mRotations;
+    };
+
+    /// Copy a mesh once to draw all given instances of it, or return nullptr if the mesh can't be drawn instanced.
+    osg::ref_ptr<osg::Group> createInstancedCopy(CopyOp& copyop, const osg::Node* node,
+        const std::vector<const ESM::CellRef*>& instances, const osg::Vec3f& worldCenter)
+    {
+        osg::ref_ptr<osg::Group> copy = new osg::Group;
+        // Unlike for merged copies, the arrays have to be copied too because we add instance attributes
+        copyop.setCopyFlags(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES);
+        copyop.mOptimizeBillboards = false;
+        copyop.mNodePath.push_back(copy);
+        copyop.copy(node, copy);
+        copyop.mNodePath.pop_back();
+
+        // The instance transform is applied to the vertices, so transforms inside of the mesh have to be flattened into them
+        SceneUtil::Optimizer optimizer;
+        optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+        optimizer.optimize(copy, SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS|SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES);
+
+        CanInstanceVisitor canInstanceVisitor;
+        copy->accept(canInstanceVisitor);
+        if (!canInstanceVisitor.mResult)
+            return nullptr;
+
+        osg::ref_ptr<osg::Vec4Array> offsets = new osg::Vec4Array;
+        osg::ref_ptr<osg::Vec4Array> rotations = new osg::Vec4Array;
+        offsets->reserve(instances.size());
+        rotations->reserve(instances.size());
+        for (const ESM::CellRef* ref : instances)
+        {
+            const osg::Quat attitude = osg::Quat(ref->mPos.rot[2], osg::Vec3f(0,0,-1)) *
+                                       osg::Quat(ref->mPos.rot[1], osg::Vec3f(0,-1,0)) *
+                                       osg::Quat(ref->mPos.rot[0], osg::Vec3f(-1,0,0));
+            offsets->push_back(osg::Vec4f(ref->mPos.asVec3() - worldCenter, ref->mScale));
+            rotations->push_back(attitude.asVec4());
+        }
+
+        SetupInstancingVisitor setupInstancingVisitor(offsets, rotations);
+        copy->accept(setupInstancingVisitor);
+        return copy;
+    }
+
     class DebugVisitor : public osg::NodeVisitor
     {
     public:
@@ -379,10 +509,283 @@ namespace MWRender
         }
     };
 
-    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
+    /// Sorted and disjoint ranges of vertex indices, as begin and end
+    typedef std::vector<std::pair<unsigned int, unsigned int>> VertexRanges;
+
+    bool containsVertex(const VertexRanges& ranges, unsigned int index)
+    {
+        auto found = std::upper_bound(ranges.begin(), ranges.end(), index, [] (unsigned int value, const auto& range) { return value < range.second; });
+        return found != ranges.end() && found->first <= index;
+    }
+
+    unsigned int getVerticesPerPrimitive(GLenum mode)
+    {
+        switch (mode)
+        {
+            case GL_POINTS: return 1;
+            case GL_LINES: return 2;
+            case GL_TRIANGLES: return 3;
+            default: return 0;
+        }
+    }
+
+    template <class DrawElements>
+    osg::ref_ptr<osg::PrimitiveSet> hideElements(const DrawElements& elements, unsigned int verticesPerPrimitive, const VertexRanges& hidden)
+    {
+        osg::ref_ptr<DrawElements> result = new DrawElements(elements.getMode());
+        result->reserve(elements.size());
+        // A primitive never spans several objects, so its first vertex tells whose it is
+        for (std::size_t i = 0; i + verticesPerPrimitive <= elements.size(); i += verticesPerPrimitive)
+            if (!containsVertex(hidden, elements[i]))
+                result->insert(result->end(), elements.begin() + i, elements.begin() + i + verticesPerPrimitive);
+        return result;
+    }
+
+    /// Append to out what remains of the primitive set without the hidden vertices.
+    /// @return false if the primitive set can't be split between objects
+    bool hideVertices(const osg::PrimitiveSet& primitiveSet, const VertexRanges& hidden, osg::Geometry::PrimitiveSetList& out)
+    {
+        const unsigned int verticesPerPrimitive = getVerticesPerPrimitive(primitiveSet.getMode());
+        if (!verticesPerPrimitive || primitiveSet.getNumInstances())
+            return false;
+
+        if (const osg::DrawArrays* arrays = dynamic_cast<const osg::DrawArrays*>(&primitiveSet))
+        {
+            unsigned int begin = arrays->getFirst();
+            const unsigned int end = begin + arrays->getCount();
+            for (const auto& [hiddenBegin, hiddenEnd] : hidden)
+            {
+                if (hiddenEnd <= begin)
+                    continue;
+                if (hiddenBegin >= end)
+                    break;
+                if (hiddenBegin > begin)
+                    out.push_back(new osg::DrawArrays(arrays->getMode(), begin, hiddenBegin - begin));
+                begin = hiddenEnd;
+            }
+            if (begin < end)
+                out.push_back(new osg::DrawArrays(arrays->getMode(), begin, end - begin));
+            return true;
+        }
+        if (const osg::DrawElementsUByte* elements = dynamic_cast<const osg::DrawElementsUByte*>(&primitiveSet))
+            out.push_back(hideElements(*elements, verticesPerPrimitive, hidden));
+        else if (const osg::DrawElementsUShort* elements = dynamic_cast<const osg::DrawElementsUShort*>(&primitiveSet))
+            out.push_back(hideElements(*elements, verticesPerPrimitive, hidden));
+        else if (const osg::DrawElementsUInt* elements = dynamic_cast<const osg::DrawElementsUInt*>(&primitiveSet))
+            out.push_back(hideElements(*elements, verticesPerPrimitive, hidden));
+        else
+            return false;
+        return true;
+    }
+
+    /// Tells where the objects of a chunk ended up, so that one of them can be hidden or shown again without rebuilding the chunk.
+    class ChunkRefs : public osg::Object
+    {
+    public:
+        struct VertexRange
+        {
+            ESM::RefNum mRefnum;
+            unsigned int mFirst;
+            unsigned int mCount;
+        };
+
+        struct MergedGeometry
+        {
+            osg::ref_ptr<osg::Geometry> mGeometry;
+            /// The primitive sets as the chunk was built, with nothing hidden
+            osg::Geometry::PrimitiveSetList mPrimitiveSets;
+            /// Sorted by the first vertex
+            std::vector<VertexRange> mRanges;
+        };
+
+        enum class Update
+        {
+            None,
+            InPlace,
+            Rebuild
+        };
+
+        ChunkRefs() {}
+        ChunkRefs(const ChunkRefs& copy, const osg::CopyOp&)
+            : mNodes(copy.mNodes), mGeometries(copy.mGeometries), mGeometryIndices(copy.mGeometryIndices)
+            , mRebuildRefs(copy.mRebuildRefs), mMissingRefs(copy.mMissingRefs), mHidden(copy.mHidden), mViewPoint(copy.mViewPoint), mUpdatable(copy.mUpdatable) {}
+        META_Object(MWRender, ChunkRefs)
+
+        /// Transforms of the objects which were copied rather than merged
+        std::map<ESM::RefNum, std::vector<osg::ref_ptr<osg::Node>>> mNodes;
+        std::vector<MergedGeometry> mGeometries;
+        std::map<ESM::RefNum, std::vector<std::size_t>> mGeometryIndices;
+        /// Objects which can only be hidden or shown by rebuilding the chunk, e.g. instanced ones
+        std::set<ESM::RefNum> mRebuildRefs;
+        /// Objects left out because they were disabled when the chunk was built
+        std::set<ESM::RefNum> mMissingRefs;
+        std::set<ESM::RefNum> mHidden;
+        osg::Vec3f mViewPoint;
+        /// False if the chunk has parts which can't be updated in place, e.g. a shadow proxy
+        bool mUpdatable = true;
+
+        Update setHidden(const ESM::RefNum& refnum, bool hidden)
+        {
+            if (mRebuildRefs.count(refnum))
+                return Update::Rebuild;
+            if (mMissingRefs.count(refnum))
+                return hidden ? Update::None : Update::Rebuild;
+            const auto nodes = mNodes.find(refnum);
+            const auto geometries = mGeometryIndices.find(refnum);
+            if (nodes == mNodes.end() && geometries == mGeometryIndices.end())
+                return Update::None;
+            if (!mUpdatable)
+                return Update::Rebuild;
+            if (hidden ? !mHidden.insert(refnum).second : !mHidden.erase(refnum))
+                return Update::None;
+
+            if (nodes != mNodes.end())
+            {
+                for (const auto& node : nodes->second)
+                    node->setNodeMask(hidden ? 0 : ~0u);
+            }
+            if (geometries != mGeometryIndices.end())
+            {
+                for (std::size_t index : geometries->second)
+                    if (!updateGeometry(mGeometries[index]))
+                        return Update::Rebuild;
+            }
+            return Update::InPlace;
+        }
+
+    private:
+        bool updateGeometry(MergedGeometry& merged) const
+        {
+            VertexRanges hidden;
+            for (const VertexRange& range : merged.mRanges)
+                if (mHidden.count(range.mRefnum))
+                    hidden.emplace_back(range.mFirst, range.mFirst + range.mCount);
+
+            osg::Geometry::PrimitiveSetList primitiveSets;
+            if (hidden.empty())
+                primitiveSets = merged.mPrimitiveSets;
+            else
+            {
+                for (const auto& primitiveSet : merged.mPrimitiveSets)
+                    if (!hideVertices(*primitiveSet, hidden, primitiveSets))
+                        return false;
+            }
+
+            // The previous frame may still be drawing the geometry, so it is replaced with a copy sharing its arrays
+            osg::ref_ptr<osg::Geometry> geometry = osg::clone(merged.mGeometry.get(), osg::CopyOp::SHALLOW_COPY);
+            geometry->setShape(nullptr);
+            geometry->setPrimitiveSetList(primitiveSets);
+            const osg::Node::ParentList parents = merged.mGeometry->getParents();
+            for (osg::Group* parent : parents)
+                parent->replaceChild(merged.mGeometry, geometry);
+            merged.mGeometry = geometry;
+            return true;
+        }
+    };
+
+    /// Collects the vertex ranges of the objects merged into each geometry from their RefnumMarkers
+    class CollectMergedRefsVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectMergedRefsVisitor(ChunkRefs& refs, bool keepMarkers) : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), mRefs(refs), mKeepMarkers(keepMarkers) {}
+
+        void apply(osg::Geometry& geometry) override
+        {
+            osg::UserDataContainer* udc = geometry.getUserDataContainer();
+            if (!udc)
+                return;
+            ChunkRefs::MergedGeometry merged;
+            unsigned int numVertices = 0;
+            for (unsigned int i = 0; i < udc->getNumUserObjects();)
+            {
+                RefnumMarker* marker = dynamic_cast<RefnumMarker*>(udc->getUserObject(i));
+                if (!marker)
+                {
+                    ++i;
+                    continue;
+                }
+                merged.mRanges.push_back({marker->mRefnum, numVertices, marker->mNumVertices});
+                numVertices += marker->mNumVertices;
+                // Outside of the active grid the markers would make ray casts hit the objects of distant chunks
+                if (mKeepMarkers)
+                    ++i;
+                else
+                    udc->removeUserObject(i);
+            }
+            if (merged.mRanges.empty())
+                return;
+
+            const osg::Array* vertices = geometry.getVertexArray();
+            if (!vertices || vertices->getNumElements() != numVertices)
+            {
+                for (const ChunkRefs::VertexRange& range : merged.mRanges)
+                    mRefs.mRebuildRefs.insert(range.mRefnum);
+                return;
+            }
+
+            const std::size_t index = mRefs.mGeometries.size();
+            for (const ChunkRefs::VertexRange& range : merged.mRanges)
+            {
+                std::vector<std::size_t>& indices = mRefs.mGeometryIndices[range.mRefnum];
+                if (indices.empty() || indices.back() != index)
+                    indices.push_back(index);
+            }
+            merged.mGeometry = &geometry;
+            merged.mPrimitiveSets = geometry.getPrimitiveSetList();
+            mRefs.mGeometries.push_back(std::move(merged));
+        }
+
+    private:
+        ChunkRefs& mRefs;
+        bool mKeepMarkers;
+    };
+
+    ChunkRefs* getChunkRefs(osg::Object& chunk)
+    {
+        osg::UserDataContainer* udc = chunk.getUserDataContainer();
+        if (!udc)
+            return nullptr;
+        for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+            if (ChunkRefs* refs = dynamic_cast<ChunkRefs*>(udc->getUserObject(i)))
+                return refs;
+        return nullptr;
+    }
+
+    /// Rebuilds a chunk which was updated in place, so that it no longer carries the vertices of its hidden objects
+    class RebuildChunkWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        RebuildChunkWorkItem(ObjectPaging& objectPaging, const ChunkId& id, osg::Object* chunk, const osg::Vec3f& viewPoint, unsigned int revision)
+            : mObjectPaging(objectPaging), mId(id), mChunk(chunk), mViewPoint(viewPoint), mRevision(revision) {}
+
+        void doWork() override
+        {
+            if (mAborted)
+                return;
+            mResult = mObjectPaging.createChunk(std::get<1>(mId), std::get<0>(mId), std::get<2>(mId), mViewPoint, true);
+        }
+
+        void abort() override
+        {
+            mAborted = true;
+        }
+
+        ObjectPaging& mObjectPaging;
+        const ChunkId mId;
+        const osg::ref_ptr<osg::Object> mChunk;
+        const osg::Vec3f mViewPoint;
+        /// Revision of the disabled and blacklisted objects the rebuild has to match
+        const unsigned int mRevision;
+        osg::ref_ptr<osg::Node> mResult;
+        std::atomic_bool mAborted {false};
+    };
+
+    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager, SceneUtil::WorkQueue* workQueue)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
+         , mWorkQueue(workQueue)
          , mRefTrackerLocked(false)
+         , mRefTrackerRevision(0)
     {
         mActiveGrid = Settings::Manager::getBool("object paging active grid", "Terrain");
         mDebugBatches = Settings::Manager::getBool("debug chunks", "Terrain");
@@ -390,6 +793,29 @@ namespace MWRender
         mMinSize = Settings::Manager::getFloat("object paging min size", "Terrain");
         mMinSizeMergeFactor = Settings::Manager::getFloat("object paging min size merge factor", "Terrain");
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
+        mInstancing = Settings::Manager::getBool("object paging instancing", "Terrain");
+        mShadowProxies = Settings::Manager::getBool("object paging shadow proxies", "Terrain")
+            && Settings::Manager::getBool("enable shadows", "Shadows") && Settings::Manager::getBool("object shadows", "Shadows");
+
+        if (mInstancing)
+        {
+            mInstancingStateSet = new osg::StateSet;
+            mInstancingStateSet->setAttribute(new osg::VertexAttribDivisor(6, 1));
+            mInstancingStateSet->setAttribute(new osg::VertexAttribDivisor(7, 1));
+            // Makes the shadow casting shader apply the instance attributes
+            mInstancingStateSet->addUniform(new osg::Uniform("useInstancing", true));
+
+            const osg::Program* programTemplate = mSceneManager->getShaderManager().getProgramTemplate();
+            mInstancingProgramTemplate = programTemplate ? Shader::ShaderManager::cloneProgram(programTemplate) : osg::ref_ptr<osg::Program>(new osg::Program);
+            mInstancingProgramTemplate->addBindAttribLocation("aOffset", 6);
+            mInstancingProgramTemplate->addBindAttribLocation("aRotation", 7);
+        }
+    }
+
+    ObjectPaging::~ObjectPaging()
+    {
+        for (const auto& [id, rebuild] : mRebuilds)
+            rebuild->cancel();
     }
 
     osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
@@ -468,6 +894,8 @@ namespace MWRender
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
         NodeMap nodes;
         osg::ref_ptr<RefnumSet> refnumSet = activeGrid ? new RefnumSet : nullptr;
+        osg::ref_ptr<ChunkRefs> chunkRefs = new ChunkRefs;
+        chunkRefs->mViewPoint = viewPoint;
 
         // Mask_UpdateVisitor is used in such cases in NIF loader:
         // 1. For collision nodes, which is not supposed to be rendered.
@@ -480,6 +908,15 @@ namespace MWRender
         float minSize = mMinSize;
         if (mMinSizeMergeFactor)
             minSize *= mMinSizeMergeFactor;
+        // Request all templates before using any of them so they can be loaded by several worker threads at once
+        struct PendingRef
+        {
+            const std::pair<const ESM::RefNum, ESM::CellRef>* mRef;
+            float mDistance2;
+            std::string mModel;
+        };
+        std::vector<PendingRef> pendingRefs;
+        std::set<std::string> requestedModels;
         for (const auto& pair : refs)
         {
             const ESM::CellRef& ref = pair.second;
@@ -522,7 +959,19 @@ namespace MWRender
                 }
             }
 
-            osg::ref_ptr<const osg::Node> cnode = mSceneManager->getTemplate(model, false);
+            // Only prefetch, holding on to the request would keep an extra reference to the template
+            if (requestedModels.insert(model).second)
+                mSceneManager->getTemplateAsync(model, *mWorkQueue, false);
+            pendingRefs.push_back({&pair, dSqr, std::move(model)});
+        }
+
+        for (const PendingRef& pending : pendingRefs)
+        {
+            const auto& pair = *pending.mRef;
+            const ESM::CellRef& ref = pair.second;
+            const float dSqr = pending.mDistance2;
+
+            osg::ref_ptr<const osg::Node> cnode = mSceneManager->getTemplate(pending.mModel, false);
 
             if (activeGrid)
             {
@@ -535,7 +984,10 @@ namespace MWRender
             {
                 std::lock_guard<std::mutex> lock(mRefTrackerMutex);
                 if (getRefTracker().mDisabled.count(pair.first))
+                {
+                    chunkRefs->mMissingRefs.insert(pair.first);
                     continue;
+                }
             }
 
             float radius2 = cnode->getBound().radius2() * ref.mScale*ref.mScale;
@@ -580,13 +1032,60 @@ namespace MWRender
             if (minSizeMergeFactor2 > 0)
                 minSizeMerged *= minSizeMergeFactor2;
 
+            const auto isTooSmall = [&] (const ESM::CellRef& ref)
+            {
+                return !activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * ref.mScale*ref.mScale < (viewPoint-ref.mPos.asVec3()).length2()*minSizeMerged*minSizeMerged;
+            };
+
+            // Instancing needs a copy of the mesh anyway, so it only pays off for meshes repeated a few times.
+            // The active grid needs separate objects to be able to tell which object is hit.
+            constexpr std::size_t minInstances = 4;
+            if (mInstancing && !activeGrid && pair.second.mInstances.size() >= minInstances)
+            {
+                std::vector<const ESM::CellRef*> instances;
+                // Switches and LODs are resolved for the closest instance
+                copyop.mSqrDistance = std::numeric_limits<float>::max();
+                for (const ESM::CellRef* cref : pair.second.mInstances)
+                {
+                    if (isTooSmall(*cref))
+                        continue;
+                    instances.push_back(cref);
+                    copyop.mSqrDistance = std::min(copyop.mSqrDistance, (viewPoint - cref->mPos.asVec3()).length2());
+                }
+
+                osg::ref_ptr<osg::Group> instanced;
+                if (instances.size() >= minInstances)
+                    instanced = createInstancedCopy(copyop, cnode, instances, worldCenter);
+                if (instanced)
+                {
+                    instanced->setStateSet(mInstancingStateSet);
+                    mSceneManager->recreateShaders(instanced, "objects", true, mInstancingProgramTemplate, false, true);
+                    mSceneManager->shareState(instanced);
+                    if (mDebugBatches)
+                    {
+                        DebugVisitor dv;
+                        instanced->accept(dv);
+                    }
+                    group->addChild(instanced);
+                    templateRefs->addRef(cnode);
+                    for (const ESM::CellRef* cref : instances)
+                        chunkRefs->mRebuildRefs.insert(cref->mRefNum);
+                    if (pair.second.mNeedCompile)
+                    {
+                        stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES|osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
+                        instanced->accept(stateToCompile);
+                    }
+                    continue;
+                }
+            }
+
             unsigned int numinstances = 0;
             for (auto cref : pair.second.mInstances)
             {
                 const ESM::CellRef& ref = *cref;
                 osg::Vec3f pos = ref.mPos.asVec3();
 
-                if (!activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * cref->mScale*cref->mScale < (viewPoint-pos).length2()*minSizeMerged*minSizeMerged)
+                if (isTooSmall(ref))
                     continue;
 
                 osg::Vec3f nodePos = pos - worldCenter;
@@ -627,14 +1126,15 @@ namespace MWRender
                 copyop.copy(cnode, trans);
                 copyop.mNodePath.pop_back();
 
-                if (activeGrid)
+                if (merge)
                 {
-                    if (merge)
-                    {
-                        AddRefnumMarkerVisitor visitor(ref.mRefNum);
-                        trans->accept(visitor);
-                    }
-                    else
+                    AddRefnumMarkerVisitor visitor(ref.mRefNum);
+                    trans->accept(visitor);
+                }
+                else
+                {
+                    chunkRefs->mNodes[ref.mRefNum].push_back(trans);
+                    if (activeGrid)
                     {
                         osg::ref_ptr<RefnumMarker> marker = new RefnumMarker; marker->mRefnum = ref.mRefNum;
                         trans->getOrCreateUserDataContainer()->addUserObject(marker);
@@ -675,6 +1175,9 @@ namespace MWRender
 
             optimizer.optimize(mergeGroup, options);
 
+            CollectMergedRefsVisitor collectMergedRefs(*chunkRefs, activeGrid);
+            mergeGroup->accept(collectMergedRefs);
+
             group->addChild(mergeGroup);
 
             if (mDebugBatches)
@@ -689,9 +1192,37 @@ namespace MWRender
             }
         }
 
+        if (mShadowProxies)
+        {
+            // Shadow cameras draw the proxy instead of the chunk's content, which merges most casters into a few draws
+            osg::ref_ptr<osg::Group> content = new osg::Group;
+            for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+                content->addChild(group->getChild(i));
+
+            osg::ref_ptr<osg::Group> proxy = SceneUtil::createShadowProxy(*content, Mask_Static);
+            if (proxy)
+            {
+                content->addCullCallback(new SceneUtil::ShadowProxyCullCallback(Mask_ShadowProxy));
+                proxy->setNodeMask(Mask_ShadowProxy);
+                group->removeChildren(0, group->getNumChildren());
+                group->addChild(content);
+                group->addChild(proxy);
+                chunkRefs->mUpdatable = false;
+
+                if (compile)
+                {
+                    stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
+                    proxy->accept(stateToCompile);
+                }
+            }
+        }
+
         auto ico = mSceneManager->getIncrementalCompileOperation();
         if (!stateToCompile.empty() && ico)
         {
+            // Chunks near the viewer are compiled before the ones further away
+            if (auto scheduler = dynamic_cast<SceneUtil::CompileScheduler*>(ico))
+                scheduler->setPriority(group, (viewPoint - worldCenter).length());
             auto compileSet = new osgUtil::IncrementalCompileOperation::CompileSet(group);
             compileSet->buildCompileMap(ico->getContextSet(), stateToCompile);
             ico->add(compileSet, false);
@@ -706,6 +1237,7 @@ namespace MWRender
             group->addCullCallback(new SceneUtil::LightListCallback);
         }
         udc->addUserObject(templateRefs);
+        udc->addUserObject(chunkRefs);
 
         return group;
     }
@@ -720,7 +1252,7 @@ namespace MWRender
         void operator()(MWRender::ChunkId id, osg::Object* obj)
         {
             if (intersects(id, mPosition))
-                mToClear.insert(id);
+                mToClear.emplace(id, obj);
         }
         bool intersects(ChunkId id, osg::Vec3f pos)
         {
@@ -738,7 +1270,7 @@ namespace MWRender
         }
         osg::Vec3f mPosition;
         osg::Vec2i mCell;
-        std::set<MWRender::ChunkId> mToClear;
+        std::map<MWRender::ChunkId, osg::ref_ptr<osg::Object>> mToClear;
         bool mActiveGridOnly = false;
     };
 
@@ -747,21 +1279,22 @@ namespace MWRender
         if (!typeFilter(type, false))
             return false;
 
+        bool blacklisted;
+        unsigned int revision;
         {
             std::lock_guard<std::mutex> lock(mRefTrackerMutex);
             if (enabled && !getWritableRefTracker().mDisabled.erase(refnum)) return false;
             if (!enabled && !getWritableRefTracker().mDisabled.insert(refnum).second) return false;
             if (mRefTrackerLocked) return false;
+            blacklisted = getRefTracker().mBlacklist.count(refnum);
+            revision = ++mRefTrackerRevision;
         }
 
         ClearCacheFunctor ccf;
         ccf.mPosition = pos;
         ccf.mCell = cell;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return hideInChunks(ccf.mToClear, refnum, !enabled, !enabled || blacklisted, revision);
     }
 
     bool ObjectPaging::blacklistObject(int type, const ESM::RefNum & refnum, const osg::Vec3f& pos, const osg::Vec2i& cell)
@@ -769,10 +1302,12 @@ namespace MWRender
         if (!typeFilter(type, false))
             return false;
 
+        unsigned int revision;
         {
             std::lock_guard<std::mutex> lock(mRefTrackerMutex);
             if (!getWritableRefTracker().mBlacklist.insert(refnum).second) return false;
             if (mRefTrackerLocked) return false;
+            revision = ++mRefTrackerRevision;
         }
 
         ClearCacheFunctor ccf;
@@ -780,15 +1315,87 @@ namespace MWRender
         ccf.mCell = cell;
         ccf.mActiveGridOnly = true;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return hideInChunks(ccf.mToClear, refnum, true, true, revision);
+    }
+
+    bool ObjectPaging::hideInChunks(const ChunkMap& chunks, const ESM::RefNum& refnum, bool hidden, bool hiddenInActiveGrid, unsigned int revision)
+    {
+        bool needsRebuild = false;
+        for (const auto& [id, chunk] : chunks)
+        {
+            ChunkRefs* chunkRefs = getChunkRefs(*chunk);
+            const bool hide = std::get<2>(id) ? hiddenInActiveGrid : hidden;
+            switch (chunkRefs ? chunkRefs->setHidden(refnum, hide) : ChunkRefs::Update::Rebuild)
+            {
+                case ChunkRefs::Update::None:
+                    break;
+                case ChunkRefs::Update::InPlace:
+                    scheduleRebuild(id, chunk, chunkRefs->mViewPoint, revision);
+                    break;
+                case ChunkRefs::Update::Rebuild:
+                    if (const auto found = mRebuilds.find(id); found != mRebuilds.end())
+                    {
+                        found->second->cancel();
+                        mRebuilds.erase(found);
+                    }
+                    mCache->removeFromObjectCache(id);
+                    needsRebuild = true;
+                    break;
+            }
+        }
+        return needsRebuild;
+    }
+
+    void ObjectPaging::scheduleRebuild(const ChunkId& id, osg::Object* chunk, const osg::Vec3f& viewPoint, unsigned int revision)
+    {
+        osg::ref_ptr<SceneUtil::WorkItem>& rebuild = mRebuilds[id];
+        if (rebuild)
+            rebuild->cancel();
+        rebuild = new RebuildChunkWorkItem(*this, id, chunk, viewPoint, revision);
+        mWorkQueue->addWorkItem(rebuild, SceneUtil::WorkPriority::Low);
+    }
+
+    bool ObjectPaging::swapRebuiltChunks()
+    {
+        unsigned int revision;
+        {
+            std::lock_guard<std::mutex> lock(mRefTrackerMutex);
+            revision = mRefTrackerRevision;
+        }
+
+        bool swapped = false;
+        for (auto it = mRebuilds.begin(); it != mRebuilds.end();)
+        {
+            if (!it->second->isDone())
+            {
+                ++it;
+                continue;
+            }
+            osg::ref_ptr<RebuildChunkWorkItem> rebuild = static_cast<RebuildChunkWorkItem*>(it->second.get());
+            it = mRebuilds.erase(it);
+
+            // The chunk was rebuilt or dropped from the cache in the meantime
+            if (mCache->getRefFromObjectCache(rebuild->mId) != rebuild->mChunk)
+                continue;
+            // Objects were hidden or shown again while it was rebuilt, the rebuild may have missed some of them
+            if (rebuild->mRevision != revision || !rebuild->mResult)
+            {
+                scheduleRebuild(rebuild->mId, rebuild->mChunk, rebuild->mViewPoint, revision);
+                continue;
+            }
+            mCache->addEntryToObjectCache(rebuild->mId, rebuild->mResult.get());
+            swapped = true;
+        }
+        return swapped;
     }
 
 
     void ObjectPaging::clear()
     {
+        for (const auto& [id, rebuild] : mRebuilds)
+            rebuild->cancel();
+        mRebuilds.clear();
+
         std::lock_guard<std::mutex> lock(mRefTrackerMutex);
         mRefTrackerNew.mDisabled.clear();
         mRefTrackerNew.mBlacklist.clear();
@@ -842,6 +1449,7 @@ namespace MWRender
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Object Chunk Memory", mCache->getMemoryUsage());
     }
 
 }
@@ -5,8 +5,14 @@
 #include <components/resource/resourcemanager.hpp>
 #include <components/esm3/loadcell.hpp>
 
+#include <map>
 #include <mutex>
 
+namespace osg
+{
+    class Program;
+    class StateSet;
+}
 namespace Resource
 {
     class SceneManager;
@@ -15,6 +21,11 @@ namespace MWWorld
 {
     class ESMStore;
 }
+namespace SceneUtil
+{
+    class WorkItem;
+    class WorkQueue;
+}
 
 namespace MWRender
 {
@@ -24,8 +35,8 @@ namespace MWRender
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
-        ObjectPaging(Resource::SceneManager* sceneManager);
-        ~ObjectPaging() = default;
+        ObjectPaging(Resource::SceneManager* sceneManager, SceneUtil::WorkQueue* workQueue);
+        ~ObjectPaging();
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
@@ -39,6 +50,10 @@ namespace MWRender
         /// @return true if view needs rebuild
         bool blacklistObject(int type, const ESM::RefNum & refnum, const osg::Vec3f& pos, const osg::Vec2i& cell);
 
+        /// Replace chunks which were updated in place by their rebuilds, once those are done in the background.
+        /// @return true if view needs rebuild
+        bool swapRebuiltChunks();
+
         void clear();
 
         /// Must be called after clear() before rendering starts.
@@ -51,12 +66,17 @@ namespace MWRender
 
     private:
         Resource::SceneManager* mSceneManager;
+        SceneUtil::WorkQueue* mWorkQueue;
         bool mActiveGrid;
         bool mDebugBatches;
         float mMergeFactor;
         float mMinSize;
         float mMinSizeMergeFactor;
         float mMinSizeCostMultiplier;
+        bool mInstancing;
+        bool mShadowProxies;
+        osg::ref_ptr<osg::StateSet> mInstancingStateSet;
+        osg::ref_ptr<osg::Program> mInstancingProgramTemplate;
 
         std::mutex mRefTrackerMutex;
         struct RefTracker
@@ -68,6 +88,7 @@ namespace MWRender
         RefTracker mRefTracker;
         RefTracker mRefTrackerNew;
         bool mRefTrackerLocked;
+        unsigned int mRefTrackerRevision;
 
         const RefTracker& getRefTracker() const { return mRefTracker; }
         RefTracker& getWritableRefTracker() { return mRefTrackerLocked ? mRefTrackerNew : mRefTracker; }
@@ -75,6 +96,13 @@ namespace MWRender
         std::mutex mSizeCacheMutex;
         typedef std::map<ESM::RefNum, float> SizeCache;
         SizeCache mSizeCache;
+
+        typedef std::map<ChunkId, osg::ref_ptr<osg::Object>> ChunkMap;
+        std::map<ChunkId, osg::ref_ptr<SceneUtil::WorkItem>> mRebuilds;
+
+        /// @return true if view needs rebuild
+        bool hideInChunks(const ChunkMap& chunks, const ESM::RefNum& refnum, bool hidden, bool hiddenInActiveGrid, unsigned int revision);
+        void scheduleRebuild(const ChunkId& id, osg::Object* chunk, const osg::Vec3f& viewPoint, unsigned int revision);
     };
 
     class RefnumMarker : public osg::Object
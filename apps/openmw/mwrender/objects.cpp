@@ -4,6 +4,7 @@
 #include <osg/UserDataContainer>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/settings/settings.hpp>
 
 #include "../mwworld/ptr.hpp"
 #include "../mwworld/class.hpp"
@@ -17,9 +18,11 @@
 namespace MWRender
 {
 
-Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode)
+Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, EffectPool* effectPool)
     : mRootNode(rootNode)
     , mResourceSystem(resourceSystem)
+    , mEffectPool(effectPool)
+    , mMergeNpcParts(Settings::Manager::getBool("merge npc parts", "Game"))
 {
 }
 
@@ -72,6 +75,7 @@ void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool
     ptr.getRefData().getBaseNode()->setNodeMask(Mask_Object);
 
     osg::ref_ptr<ObjectAnimation> anim (new ObjectAnimation(ptr, mesh, mResourceSystem, animated, allowLight));
+    anim->setEffectPool(mEffectPool);
 
     mObjects.insert(std::make_pair(ptr, anim));
 }
@@ -88,6 +92,7 @@ void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, b
         anim = new CreatureWeaponAnimation(ptr, mesh, mResourceSystem);
     else
         anim = new CreatureAnimation(ptr, mesh, mResourceSystem);
+    anim->setEffectPool(mEffectPool);
 
     if (mObjects.insert(std::make_pair(ptr, anim)).second)
         ptr.getClass().getContainerStore(ptr).setContListener(static_cast<ActorAnimation*>(anim.get()));
@@ -99,6 +104,8 @@ void Objects::insertNPC(const MWWorld::Ptr &ptr)
     ptr.getRefData().getBaseNode()->setNodeMask(Mask_Actor);
 
     osg::ref_ptr<NpcAnimation> anim (new NpcAnimation(ptr, osg::ref_ptr<osg::Group>(ptr.getRefData().getBaseNode()), mResourceSystem));
+    anim->setEffectPool(mEffectPool);
+    anim->setMergeParts(mMergeNpcParts);
 
     if (mObjects.insert(std::make_pair(ptr, anim)).second)
     {
@@ -27,6 +27,7 @@ namespace MWWorld
 namespace MWRender{
 
 class Animation;
+class EffectPool;
 
 class PtrHolder : public osg::Object
 {
@@ -60,11 +61,14 @@ class Objects{
     osg::ref_ptr<osg::Group> mRootNode;
 
     Resource::ResourceSystem* mResourceSystem;
+    EffectPool* mEffectPool;
+    bool mMergeNpcParts;
 
     void insertBegin(const MWWorld::Ptr& ptr);
 
 public:
-    Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode);
+    /// @param effectPool given to the animations of the objects to reuse their effect instances
+    Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, EffectPool* effectPool);
     ~Objects();
 
     /// @param animated Attempt to load separate keyframes from a .kf file matching the model file?
@@ -1,5 +1,8 @@
 #include "postprocessor.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <SDL_opengl_glext.h>
 
 #include <osg/Group>
@@ -13,6 +16,7 @@
 #include <components/settings/settings.hpp>
 #include <components/sceneutil/depth.hpp>
 #include <components/sceneutil/nodecallback.hpp>
+#include <components/sceneutil/statesetupdater.hpp>
 #include <components/debug/debuglog.hpp>
 
 #include "vismask.hpp"
@@ -154,14 +158,52 @@ namespace
 
 namespace MWRender
 {
+    // Tells the fullscreen triangle which part of the scene texture the scene was rendered to.
+    class SceneScaleUpdater : public SceneUtil::StateSetUpdater
+    {
+    public:
+        void setScale(const osg::Vec2f& scale, const osg::Vec2f& maxUV)
+        {
+            mScale = scale;
+            mMaxUV = maxUV;
+        }
+
+    protected:
+        void setDefaults(osg::StateSet* stateset) override
+        {
+            stateset->addUniform(new osg::Uniform("sceneScale", osg::Vec2f(1.f, 1.f)));
+            stateset->addUniform(new osg::Uniform("sceneMaxUV", osg::Vec2f(1.f, 1.f)));
+        }
+
+        void apply(osg::StateSet* stateset, osg::NodeVisitor* nv) override
+        {
+            stateset->getUniform("sceneScale")->set(mScale);
+            stateset->getUniform("sceneMaxUV")->set(mMaxUV);
+        }
+
+    private:
+        osg::Vec2f mScale {1.f, 1.f};
+        osg::Vec2f mMaxUV {1.f, 1.f};
+    };
+
     PostProcessor::PostProcessor(osgViewer::Viewer* viewer, osg::Group* rootNode)
         : mViewer(viewer)
         , mRootNode(new osg::Group)
         , mDepthFormat(GL_DEPTH24_STENCIL8_EXT)
+        , mWidth(0)
+        , mHeight(0)
+        , mDynamicResolution(Settings::Manager::getBool("dynamic resolution", "Video"))
+        , mTargetFrameTime(std::max(1.f, Settings::Manager::getFloat("dynamic resolution target frame time", "Video")) / 1000.f)
+        , mMinResolutionScale(std::clamp(Settings::Manager::getFloat("dynamic resolution min scale", "Video"), 0.1f, 1.f))
+        , mMaxResolutionScale(std::clamp(Settings::Manager::getFloat("dynamic resolution max scale", "Video"), mMinResolutionScale, 1.f))
+        , mResolutionScale(1.f)
+        , mAverageFrameTime(mTargetFrameTime)
+        , mTimeSinceScaleChange(0.f)
+        , mSceneScaleUpdater(nullptr)
     {
         bool softParticles = Settings::Manager::getBool("soft particles", "Shaders");
 
-        if (!SceneUtil::AutoDepth::isReversed() && !softParticles)
+        if (!SceneUtil::AutoDepth::isReversed() && !softParticles && !mDynamicResolution)
             return;
 
         osg::GraphicsContext* gc = viewer->getCamera()->getGraphicsContext();
@@ -195,7 +237,7 @@ namespace MWRender
                 // benefits if no floating point depth formats are supported.
                 Log(Debug::Warning) << errPreamble << "'GL_ARB_depth_buffer_float' and 'GL_NV_depth_buffer_float' unsupported.";
 
-                if (!softParticles)
+                if (!softParticles && !mDynamicResolution)
                     return;
             }
         }
@@ -203,6 +245,9 @@ namespace MWRender
         int width = viewer->getCamera()->getViewport()->width();
         int height = viewer->getCamera()->getViewport()->height();
 
+        if (mDynamicResolution)
+            mResolutionScale = mMaxResolutionScale;
+
         createTexturesAndCamera(width, height);
         resize(width, height);
 
@@ -223,6 +268,9 @@ namespace MWRender
 
     void PostProcessor::resize(int width, int height)
     {
+        mWidth = width;
+        mHeight = height;
+
         mDepthTex->setTextureSize(width, height);
         mSceneTex->setTextureSize(width, height);
         mDepthTex->dirtyTextureObject();
@@ -260,6 +308,48 @@ namespace MWRender
 
         mViewer->getCamera()->resize(width, height);
         mHUDCamera->resize(width, height);
+
+        if (mDynamicResolution)
+            setResolutionScale(mResolutionScale);
+    }
+
+    void PostProcessor::update(float dt)
+    {
+        if (!mDynamicResolution || !mHUDCamera || dt <= 0.f)
+            return;
+
+        // smooth the frame time so single hitches don't change the resolution
+        mAverageFrameTime += (dt - mAverageFrameTime) * 0.1f;
+        mTimeSinceScaleChange += dt;
+        if (mTimeSinceScaleChange < 0.5f)
+            return;
+
+        // the cost of rendering the scene grows with the number of pixels, i.e. with the square of the scale
+        float scale = mResolutionScale * std::sqrt(mTargetFrameTime / mAverageFrameTime);
+        scale = std::clamp(std::round(scale * 20.f) / 20.f, mMinResolutionScale, mMaxResolutionScale);
+
+        // only go back up with some headroom, otherwise the scale would keep flipping between two steps
+        if (scale > mResolutionScale && mAverageFrameTime > mTargetFrameTime * 0.85f)
+            return;
+
+        if (scale != mResolutionScale)
+            setResolutionScale(scale);
+    }
+
+    void PostProcessor::setResolutionScale(float scale)
+    {
+        mResolutionScale = scale;
+        mTimeSinceScaleChange = 0.f;
+
+        // the textures keep the size of the window, the scene is drawn to their lower left corner
+        int width = std::max(1, static_cast<int>(std::lround(mWidth * scale)));
+        int height = std::max(1, static_cast<int>(std::lround(mHeight * scale)));
+        mViewer->getCamera()->getViewport()->setViewport(0, 0, width, height);
+
+        // keep the bilinear filter from reading beyond the rendered part of the texture
+        osg::Vec2f size(std::max(1, mWidth), std::max(1, mHeight));
+        mSceneScaleUpdater->setScale(osg::Vec2f(width / size.x(), height / size.y()),
+            osg::Vec2f((width - 0.5f) / size.x(), (height - 0.5f) / size.y()));
     }
 
     void PostProcessor::createTexturesAndCamera(int width, int height)
@@ -286,8 +376,10 @@ namespace MWRender
         mSceneTex->setSourceFormat(GL_RGB);
         mSceneTex->setSourceType(GL_UNSIGNED_BYTE);
         mSceneTex->setInternalFormat(GL_RGB);
-        mSceneTex->setFilter(osg::Texture2D::MIN_FILTER, osg::Texture2D::NEAREST);
-        mSceneTex->setFilter(osg::Texture2D::MAG_FILTER, osg::Texture2D::NEAREST);
+        // a scaled down scene has to be filtered when it is stretched over the window
+        const osg::Texture::FilterMode sceneFilter = mDynamicResolution ? osg::Texture2D::LINEAR : osg::Texture2D::NEAREST;
+        mSceneTex->setFilter(osg::Texture2D::MIN_FILTER, sceneFilter);
+        mSceneTex->setFilter(osg::Texture2D::MAG_FILTER, sceneFilter);
         mSceneTex->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
         mSceneTex->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
         mSceneTex->setResizeNonPowerOfTwoHint(false);
@@ -305,11 +397,12 @@ namespace MWRender
             #version 120
 
             varying vec2 uv;
+            uniform vec2 sceneScale;
 
             void main()
             {
                 gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
-                uv = gl_Position.xy * 0.5 + 0.5;
+                uv = (gl_Position.xy * 0.5 + 0.5) * sceneScale;
             }
         )GLSL";
 
@@ -318,10 +411,11 @@ namespace MWRender
 
             varying vec2 uv;
             uniform sampler2D sceneTex;
+            uniform vec2 sceneMaxUV;
 
             void main()
             {
-                gl_FragData[0] = texture2D(sceneTex, uv);
+                gl_FragData[0] = texture2D(sceneTex, min(uv, sceneMaxUV));
             }
         )GLSL";
 
@@ -332,7 +426,11 @@ namespace MWRender
         program->addShader(vertShader);
         program->addShader(fragShader);
 
-        mHUDCamera->addChild(createFullScreenTri());
+        osg::ref_ptr<osg::Geometry> fullScreenTri = createFullScreenTri();
+        osg::ref_ptr<SceneScaleUpdater> sceneScaleUpdater = new SceneScaleUpdater;
+        fullScreenTri->addUpdateCallback(sceneScaleUpdater);
+        mSceneScaleUpdater = sceneScaleUpdater;
+        mHUDCamera->addChild(fullScreenTri);
         mHUDCamera->setNodeMask(Mask_RenderToTexture);
 
         auto* stateset = mHUDCamera->getOrCreateStateSet();
@@ -14,6 +14,8 @@ namespace osgViewer
 
 namespace MWRender
 {
+    class SceneScaleUpdater;
+
     class PostProcessor : public osg::Referenced
     {
     public:
@@ -28,8 +30,16 @@ namespace MWRender
 
         void resize(int width, int height);
 
+        /// Adapt the resolution of the scene to the frame time if dynamic resolution is enabled.
+        /// @param dt duration of the last frame in seconds
+        void update(float dt);
+
+        /// Fraction of the window size the scene is rendered at.
+        float getResolutionScale() const { return mResolutionScale; }
+
     private:
         void createTexturesAndCamera(int width, int height);
+        void setResolutionScale(float scale);
 
         osgViewer::Viewer* mViewer;
         osg::ref_ptr<osg::Group> mRootNode;
@@ -44,6 +54,18 @@ namespace MWRender
         osg::ref_ptr<osg::Texture2D> mOpaqueDepthTex;
 
         int mDepthFormat;
+
+        int mWidth;
+        int mHeight;
+
+        bool mDynamicResolution;
+        float mTargetFrameTime;
+        float mMinResolutionScale;
+        float mMaxResolutionScale;
+        float mResolutionScale;
+        float mAverageFrameTime;
+        float mTimeSinceScaleChange;
+        SceneScaleUpdater* mSceneScaleUpdater;
     };
 }
 
@@ -30,10 +30,15 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/misc/threadbudget.hpp>
+
+#include <components/sceneutil/compilescheduler.hpp>
 #include <components/sceneutil/depth.hpp>
 #include <components/sceneutil/lightmanager.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/rtt.hpp>
+#include <components/sceneutil/vertexupdate.hpp>
 #include <components/sceneutil/workqueue.hpp>
 #include <components/sceneutil/writescene.hpp>
 #include <components/sceneutil/shadow.hpp>
@@ -53,6 +58,7 @@
 
 #include "sky.hpp"
 #include "effectmanager.hpp"
+#include "effectpool.hpp"
 #include "npcanimation.hpp"
 #include "vismask.hpp"
 #include "pathgrid.hpp"
@@ -291,7 +297,7 @@ namespace MWRender
 
     RenderingManager::RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                                        Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                                       const std::string& resourcePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore)
+                                       const std::string& resourcePath, const std::string& cachePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore)
         : mViewer(viewer)
         , mRootNode(rootNode)
         , mResourceSystem(resourceSystem)
@@ -328,6 +334,30 @@ namespace MWRender
         resourceSystem->getSceneManager()->setAutoUseSpecularMaps(Settings::Manager::getBool("auto use object specular maps", "Shaders"));
         resourceSystem->getSceneManager()->setSpecularMapPattern(Settings::Manager::getString("specular map pattern", "Shaders"));
         resourceSystem->getSceneManager()->setApplyLightingToEnvMaps(Settings::Manager::getBool("apply lighting to environment maps", "Shaders"));
+        resourceSystem->getSceneManager()->setGpuSkinning(Settings::Manager::getBool("gpu skinning", "Shaders"));
+
+        const std::size_t skinningThreads = Misc::ThreadBudget::instance().getThreadCount(Misc::ThreadGroup::Skinning,
+            Settings::Manager::getInt("skinning threads", "General"));
+        if (skinningThreads > 0)
+            SceneUtil::setVertexUpdateQueue(new SceneUtil::WorkQueue(skinningThreads, Misc::ThreadGroup::Skinning));
+
+        if (Settings::Manager::getBool("texture streaming", "General"))
+        {
+            Resource::ImageManager* imageManager = resourceSystem->getImageManager();
+            const int baseSize = std::max(1, Settings::Manager::getInt("texture streaming base size", "General"));
+            const int budget = std::max(0, Settings::Manager::getInt("texture streaming budget", "General"));
+            imageManager->setStreaming(mWorkQueue.get(), baseSize, static_cast<std::size_t>(budget) * 1024 * 1024);
+            mRootNode->addChild(imageManager->getStreamingDrawable());
+        }
+        if (Settings::Manager::getBool("deduplicate textures", "General"))
+        {
+            resourceSystem->getImageManager()->setDeduplication({
+                Settings::Manager::getString("normal map pattern", "Shaders"),
+                Settings::Manager::getString("normal height map pattern", "Shaders"),
+                Settings::Manager::getString("specular map pattern", "Shaders")
+            });
+            resourceSystem->getSceneManager()->setShareAttributes(true);
+        }
         resourceSystem->getSceneManager()->setConvertAlphaTestToAlphaToCoverage(Settings::Manager::getBool("antialias alpha test", "Shaders") && Settings::Manager::getInt("antialiasing", "Video") > 1);
 
         // Let LightManager choose which backend to use based on our hint. For methods besides legacy lighting, this depends on support for various OpenGL extensions.
@@ -350,11 +380,11 @@ namespace MWRender
 
         int indoorShadowCastingTraversalMask = shadowCastingTraversalMask;
         if (Settings::Manager::getBool("object shadows", "Shadows"))
-            shadowCastingTraversalMask |= (Mask_Object|Mask_Static);
+            shadowCastingTraversalMask |= (Mask_Object|Mask_Static|Mask_ShadowProxy);
         if (Settings::Manager::getBool("terrain shadows", "Shadows"))
             shadowCastingTraversalMask |= Mask_Terrain;
 
-        mShadowManager.reset(new SceneUtil::ShadowManager(sceneRoot, mRootNode, shadowCastingTraversalMask, indoorShadowCastingTraversalMask, Mask_Terrain|Mask_Object|Mask_Static, mResourceSystem->getSceneManager()->getShaderManager()));
+        mShadowManager.reset(new SceneUtil::ShadowManager(sceneRoot, mRootNode, shadowCastingTraversalMask, indoorShadowCastingTraversalMask, Mask_Terrain|Mask_Object|Mask_Static, Mask_Terrain|Mask_Static|Mask_ShadowProxy, mResourceSystem->getSceneManager()->getShaderManager()));
 
         Shader::ShaderManager::DefineMap shadowDefines = mShadowManager->getShadowDefines();
         Shader::ShaderManager::DefineMap lightDefines = sceneRoot->getLightDefines();
@@ -389,17 +419,20 @@ namespace MWRender
         mRecastMesh.reset(new RecastMesh(mRootNode, Settings::Manager::getBool("enable recast mesh render", "Navigator")));
         mPathgrid.reset(new Pathgrid(mRootNode));
 
-        mObjects.reset(new Objects(mResourceSystem, sceneRoot));
+        mEffectPool = std::make_unique<EffectPool>();
+        mObjects.reset(new Objects(mResourceSystem, sceneRoot, mEffectPool.get()));
 
         if (getenv("OPENMW_DONT_PRECOMPILE") == nullptr)
         {
-            mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
+            const std::size_t compileBudget = static_cast<std::size_t>(
+                std::max(0, Settings::Manager::getInt("compile budget", "Cells"))) * 1024;
+            mViewer->setIncrementalCompileOperation(new SceneUtil::CompileScheduler(compileBudget));
             mViewer->getIncrementalCompileOperation()->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
         }
 
         mResourceSystem->getSceneManager()->setIncrementalCompileOperation(mViewer->getIncrementalCompileOperation());
 
-        mEffectManager.reset(new EffectManager(sceneRoot, mResourceSystem));
+        mEffectManager.reset(new EffectManager(sceneRoot, mResourceSystem, mEffectPool.get()));
 
         const std::string normalMapPattern = Settings::Manager::getString("normal map pattern", "Shaders");
         const std::string heightMapPattern = Settings::Manager::getString("normal height map pattern", "Shaders");
@@ -425,9 +458,12 @@ namespace MWRender
             mTerrain.reset(new Terrain::QuadTreeWorld(
                 sceneRoot, mRootNode, mResourceSystem, mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug,
                 compMapResolution, compMapLevel, lodFactor, vertexLodMod, maxCompGeometrySize, debugChunks));
+            static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->setOcclusionCulling(Settings::Manager::getBool("occlusion culling", "Terrain"));
+            if (Settings::Manager::getBool("composite map cache", "Terrain"))
+                static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->setCompositeMapCache(cachePath + "/compositemaps", mWorkQueue.get());
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
-                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager()));
+                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager(), mWorkQueue.get()));
                 static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->addChunkManager(mObjectPaging.get());
                 mResourceSystem->addResourceManager(mObjectPaging.get());
             }
@@ -462,6 +498,13 @@ namespace MWRender
 
         // water goes after terrain for correct waterculling order
         mWater.reset(new Water(sceneRoot->getParent(0), sceneRoot, mResourceSystem, mViewer->getIncrementalCompileOperation(), resourcePath));
+        if (Settings::Manager::getBool("parallel cull", "Water"))
+        {
+            // one worker each for the reflection and refraction cameras
+            osg::ref_ptr<SceneUtil::RTTCullQueue> cullQueue = new SceneUtil::RTTCullQueue(2);
+            mRootNode->addCullCallback(cullQueue);
+            mWater->setCullQueue(cullQueue);
+        }
 
         mCamera.reset(new Camera(mViewer->getCamera()));
 
@@ -514,9 +557,10 @@ namespace MWRender
         mViewer->getCamera()->setComputeNearFarMode(osg::Camera::DO_NOT_COMPUTE_NEAR_FAR);
         mViewer->getCamera()->setCullingMode(cullingMode);
 
-        mViewer->getCamera()->setCullMask(~(Mask_UpdateVisitor|Mask_SimpleWater));
+        mViewer->getCamera()->setCullMask(~(Mask_UpdateVisitor|Mask_SimpleWater|Mask_ShadowProxy));
         NifOsg::Loader::setHiddenNodeMask(Mask_UpdateVisitor);
         NifOsg::Loader::setIntersectionDisabledNodeMask(Mask_Effect);
+        NifOsg::Loader::setFreezeInvisibleParticles(Settings::Manager::getBool("freeze invisible particles", "Cells"));
         Nif::NIFFile::setLoadUnsupportedFiles(Settings::Manager::getBool("load unsupported nif files", "Models"));
 
         mStateUpdater->setFogEnd(mViewDistance);
@@ -546,6 +590,7 @@ namespace MWRender
     {
         // let background loading thread finish before we delete anything else
         mWorkQueue = nullptr;
+        SceneUtil::setVertexUpdateQueue(nullptr);
     }
 
     osgUtil::IncrementalCompileOperation* RenderingManager::getIncrementalCompileOperation()
@@ -699,6 +744,8 @@ namespace MWRender
         {
             mTerrain->loadCell(store->getCell()->getGridX(), store->getCell()->getGridY());
         }
+
+        mShadowManager->dirtyStaticShadows();
     }
     void RenderingManager::removeCell(const MWWorld::CellStore *store)
     {
@@ -712,6 +759,8 @@ namespace MWRender
         }
 
         mWater->removeCell(store);
+
+        mShadowManager->dirtyStaticShadows();
     }
 
     void RenderingManager::enableTerrain(bool enable)
@@ -724,6 +773,7 @@ namespace MWRender
     void RenderingManager::setSkyEnabled(bool enabled)
     {
         mSky->setEnabled(enabled);
+        mWater->setSkyEnabled(enabled);
         if (enabled)
             mShadowManager->enableOutdoorMode();
         else
@@ -797,8 +847,11 @@ namespace MWRender
     {
         reportStats();
 
+        mPostProcessor->update(dt);
+
         float rainIntensity = mSky->getPrecipitationAlpha();
         mWater->setRainIntensity(rainIntensity);
+        mWater->addSkyChange(mSky->takeChange());
 
         if (!paused)
         {
@@ -817,6 +870,9 @@ namespace MWRender
         updateNavMesh();
         updateRecastMesh();
 
+        if (mObjectPaging && mObjectPaging->swapRebuiltChunks())
+            mTerrain->rebuildViews();
+
         mCamera->update(dt, paused);
 
         bool isUnderwater = mWater->isUnderwater(mCamera->getPosition());
@@ -1054,6 +1110,7 @@ namespace MWRender
         mSky->setMoonColour(false);
 
         notifyWorldSpaceChanged();
+        mEffectPool->clear();
         if (mObjectPaging)
             mObjectPaging->clear();
     }
@@ -1097,6 +1154,7 @@ namespace MWRender
     {
         mPlayerAnimation = new NpcAnimation(player, player.getRefData().getBaseNode(), mResourceSystem, 0, NpcAnimation::VM_Normal,
                                                 mFirstPersonFieldOfView);
+        mPlayerAnimation->setEffectPool(mEffectPool.get());
 
         mCamera->setAnimation(mPlayerAnimation.get());
         mCamera->attachTo(player);
@@ -1206,6 +1264,8 @@ namespace MWRender
         if (stats->collectStats("resource"))
         {
             mTerrain->reportStats(frameNumber, stats);
+            mEffectPool->reportStats(frameNumber, *stats);
+            stats->setAttribute(frameNumber, "Resolution Scale", mPostProcessor->getResolutionScale() * 100);
         }
     }
 
@@ -1290,6 +1350,11 @@ namespace MWRender
         return mTerrain->getHeightAt(pos);
     }
 
+    void RenderingManager::getTerrainHeightsAt(const std::vector<osg::Vec3f>& positions, std::vector<float>& heights)
+    {
+        mTerrain->getHeightsAt(positions, heights);
+    }
+
     void RenderingManager::overrideFieldOfView(float val)
     {
         if (mFieldOfViewOverridden != true || mFieldOfViewOverride != val)
@@ -1408,6 +1473,7 @@ namespace MWRender
         if (mObjectPaging->enableObject(type, ptr.getCellRef().getRefNum(), ptr.getCellRef().getPosition().asVec3(), osg::Vec2i(ptr.getCell()->getCell()->getGridX(), ptr.getCell()->getCell()->getGridY()), enabled))
         {
             mTerrain->rebuildViews();
+            mShadowManager->dirtyStaticShadows();
             return true;
         }
         return false;
@@ -1419,13 +1485,17 @@ namespace MWRender
         const ESM::RefNum & refnum = ptr.getCellRef().getRefNum();
         if (!refnum.hasContentFile()) return;
         if (mObjectPaging->blacklistObject(type, refnum, ptr.getCellRef().getPosition().asVec3(), osg::Vec2i(ptr.getCell()->getCell()->getGridX(), ptr.getCell()->getCell()->getGridY())))
+        {
             mTerrain->rebuildViews();
+            mShadowManager->dirtyStaticShadows();
+        }
     }
     bool RenderingManager::pagingUnlockCache()
     {
         if (mObjectPaging && mObjectPaging->unlockCache())
         {
             mTerrain->rebuildViews();
+            mShadowManager->dirtyStaticShadows();
             return true;
         }
         return false;
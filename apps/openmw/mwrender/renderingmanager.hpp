@@ -78,6 +78,7 @@ namespace MWRender
     class SharedUniformStateUpdater;
 
     class EffectManager;
+    class EffectPool;
     class ScreenshotManager;
     class FogManager;
     class SkyManager;
@@ -99,7 +100,7 @@ namespace MWRender
     public:
         RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                          Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                         const std::string& resourcePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore);
+                         const std::string& resourcePath, const std::string& cachePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore);
         ~RenderingManager();
 
         osgUtil::IncrementalCompileOperation* getIncrementalCompileOperation();
@@ -209,6 +210,8 @@ namespace MWRender
 
         float getTerrainHeightAt(const osg::Vec3f& pos);
 
+        void getTerrainHeightsAt(const std::vector<osg::Vec3f>& positions, std::vector<float>& heights);
+
         // camera stuff
         Camera* getCamera() { return mCamera.get(); }
 
@@ -272,6 +275,7 @@ namespace MWRender
         std::unique_ptr<ActorsPaths> mActorsPaths;
         std::unique_ptr<RecastMesh> mRecastMesh;
         std::unique_ptr<Pathgrid> mPathgrid;
+        std::unique_ptr<EffectPool> mEffectPool;
         std::unique_ptr<Objects> mObjects;
         std::unique_ptr<Water> mWater;
         std::unique_ptr<Terrain::World> mTerrain;
@@ -1,11 +1,15 @@
 #include "ripplesimulation.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <map>
 
 #include <osg/PolygonOffset>
 #include <osg/Texture2D>
 #include <osg/Material>
 #include <osg/Depth>
+#include <osg/Geometry>
 #include <osg/PositionAttitudeTransform>
 #include <osgParticle/ParticleSystem>
 #include <osgParticle/ParticleSystemUpdater>
@@ -17,6 +21,8 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/fallback/fallback.hpp>
 #include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/statesetupdater.hpp>
+#include <components/shader/shadermanager.hpp>
 
 #include "vismask.hpp"
 
@@ -77,13 +83,198 @@ namespace
 
         node->setStateSet(stateset);
     }
+
+    constexpr int sRippleMapResolution = 512;
+    constexpr float sRippleMapTexelSize = 4.f;
+    constexpr std::size_t sMaxRipplesPerStep = 32;
+    // the waves travel about 0.7 texels per step, so about 170 units per second
+    constexpr float sRippleStepInterval = 1.f / 60.f;
+    constexpr float sRippleDamping = 0.985f;
+    constexpr float sRippleRadius = 12.f;
+    constexpr float sRippleStrength = 1.f;
+
+    /// Applies the uniforms of the step queued in the RippleMap to the camera rendering it.
+    class RippleStepUpdater : public SceneUtil::StateSetUpdater
+    {
+    public:
+        RippleStepUpdater(const MWRender::RippleMap* rippleMap, osg::Texture2D* source)
+            : mRippleMap(rippleMap)
+            , mSource(source)
+        {
+        }
+
+    protected:
+        void setDefaults(osg::StateSet* stateset) override
+        {
+            stateset->setTextureAttributeAndModes(0, mSource, osg::StateAttribute::ON);
+            stateset->addUniform(new osg::Uniform("previousMap", 0));
+            stateset->addUniform(new osg::Uniform("texelSize", 1.f / sRippleMapResolution));
+            stateset->addUniform(new osg::Uniform("offset", osg::Vec2f()));
+            stateset->addUniform(new osg::Uniform("damping", 0.f));
+            stateset->addUniform(new osg::Uniform(osg::Uniform::FLOAT_VEC4, "ripples", sMaxRipplesPerStep));
+            stateset->addUniform(new osg::Uniform("numRipples", 0));
+        }
+
+        void apply(osg::StateSet* stateset, osg::NodeVisitor* /*nv*/) override
+        {
+            stateset->getUniform("offset")->set(mRippleMap->getStepOffset());
+            stateset->getUniform("damping")->set(mRippleMap->getStepDamping());
+            const std::vector<osg::Vec4f>& ripples = mRippleMap->getStepRipples();
+            osg::Uniform* ripplesUniform = stateset->getUniform("ripples");
+            for (std::size_t i = 0; i < ripples.size(); ++i)
+                ripplesUniform->setElement(i, ripples[i]);
+            stateset->getUniform("numRipples")->set(static_cast<int>(ripples.size()));
+        }
+
+    private:
+        const MWRender::RippleMap* mRippleMap;
+        osg::ref_ptr<osg::Texture2D> mSource;
+    };
 }
 
 namespace MWRender
 {
 
+RippleMap::RippleMap(Resource::ResourceSystem* resourceSystem)
+{
+    setName("Ripple Map");
+    setNodeMask(Mask_RenderToTexture);
+    setCullingActive(false);
+
+    std::map<std::string, std::string> defineMap;
+    defineMap["maxRipples"] = std::to_string(sMaxRipplesPerStep);
+    Shader::ShaderManager& shaderMgr = resourceSystem->getSceneManager()->getShaderManager();
+    osg::ref_ptr<osg::Shader> vertexShader(shaderMgr.getShader("ripples_vertex.glsl", defineMap, osg::Shader::VERTEX));
+    osg::ref_ptr<osg::Shader> fragmentShader(shaderMgr.getShader("ripples_fragment.glsl", defineMap, osg::Shader::FRAGMENT));
+    osg::ref_ptr<osg::Program> program = shaderMgr.getProgram(vertexShader, fragmentShader);
+
+    osg::ref_ptr<osg::Geometry> quad = osg::createTexturedQuadGeometry(osg::Vec3f(-1, -1, 0), osg::Vec3f(2, 0, 0), osg::Vec3f(0, 2, 0));
+    osg::StateSet* quadStateSet = quad->getOrCreateStateSet();
+    quadStateSet->setAttributeAndModes(program, osg::StateAttribute::ON);
+    quadStateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+    quadStateSet->setMode(GL_BLEND, osg::StateAttribute::OFF);
+    quadStateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+
+    for (osg::ref_ptr<osg::Texture2D>& texture : mTextures)
+    {
+        // red is the current height, green the height of the step before
+        texture = new osg::Texture2D;
+        texture->setTextureSize(sRippleMapResolution, sRippleMapResolution);
+        texture->setInternalFormat(GL_RGBA16F_ARB);
+        texture->setSourceFormat(GL_RGBA);
+        texture->setSourceType(GL_FLOAT);
+        texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+        texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    }
+
+    for (std::size_t i = 0; i < mCameras.size(); ++i)
+    {
+        osg::ref_ptr<osg::Camera> camera = new osg::Camera;
+        camera->setName("RippleCamera");
+        camera->setRenderOrder(osg::Camera::PRE_RENDER);
+        camera->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);
+        camera->setReferenceFrame(osg::Camera::ABSOLUTE_RF);
+        camera->setViewMatrix(osg::Matrix::identity());
+        camera->setProjectionMatrix(osg::Matrix::identity());
+        camera->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR);
+        camera->setCullingMode(osg::CullSettings::NO_CULLING);
+        camera->setViewport(0, 0, sRippleMapResolution, sRippleMapResolution);
+        camera->setClearMask(0);
+        camera->setImplicitBufferAttachmentMask(0, 0);
+        camera->attach(osg::Camera::COLOR_BUFFER, mTextures[i]);
+        camera->addUpdateCallback(new RippleStepUpdater(this, mTextures[1 - i]));
+        camera->addChild(quad);
+        mCameras[i] = camera;
+        addChild(camera);
+    }
+}
+
+void RippleMap::addRipple(const osg::Vec2f& position)
+{
+    if (mRipples.size() >= sMaxRipplesPerStep)
+        return;
+
+    const osg::Vec2f coords = (position - mOrigins[mTarget]) / getSize();
+    if (coords.x() < 0 || coords.y() < 0 || coords.x() > 1 || coords.y() > 1)
+        return;
+
+    mRipples.emplace_back(coords.x(), coords.y(), sRippleRadius / getSize(), sRippleStrength);
+}
+
+void RippleMap::update(float dt, const osg::Vec2f& center)
+{
+    mStepQueued = false;
+    mTimeSinceStep += dt;
+    if (mTimeSinceStep < sRippleStepInterval)
+        return;
+    // don't catch up on missed steps, the ripples just move slower at low frame rates
+    mTimeSinceStep = std::min(mTimeSinceStep - sRippleStepInterval, sRippleStepInterval);
+
+    const osg::Vec2f& previousOrigin = mOrigins[mTarget];
+    const osg::Vec2f origin(std::floor(center.x() / sRippleMapTexelSize) * sRippleMapTexelSize - getSize() / 2,
+                            std::floor(center.y() / sRippleMapTexelSize) * sRippleMapTexelSize - getSize() / 2);
+
+    // ripples were queued relative to the previous origin
+    const osg::Vec2f offset = (origin - previousOrigin) / getSize();
+    mStepRipples.clear();
+    for (const osg::Vec4f& ripple : mRipples)
+        mStepRipples.emplace_back(ripple.x() - offset.x(), ripple.y() - offset.y(), ripple.z(), ripple.w());
+    mRipples.clear();
+
+    mStepOffset = offset;
+    mStepDamping = (mClear || !mHasResult) ? 0.f : sRippleDamping;
+    mClear = false;
+
+    if (mHasResult)
+        mTarget = 1 - mTarget;
+    mOrigins[mTarget] = origin;
+    mHasResult = true;
+    mStepQueued = true;
+}
+
+void RippleMap::clear()
+{
+    mClear = true;
+    mRipples.clear();
+}
+
+void RippleMap::traverse(osg::NodeVisitor& nv)
+{
+    if (nv.getVisitorType() != osg::NodeVisitor::CULL_VISITOR)
+    {
+        osg::Group::traverse(nv);
+        return;
+    }
+
+    // every view culls the map, but each step must be simulated once
+    const unsigned int frame = nv.getTraversalNumber();
+    if (!mStepQueued || frame == mLastCullFrame)
+        return;
+    mLastCullFrame = frame;
+
+    mCameras[mTarget]->accept(nv);
+}
+
+osg::Texture2D* RippleMap::getTexture() const
+{
+    return mHasResult ? mTextures[mTarget].get() : nullptr;
+}
+
+float RippleMap::getSize()
+{
+    return sRippleMapResolution * sRippleMapTexelSize;
+}
+
+int RippleMap::getResolution()
+{
+    return sRippleMapResolution;
+}
+
 RippleSimulation::RippleSimulation(osg::Group *parent, Resource::ResourceSystem* resourceSystem)
     : mParent(parent)
+    , mResourceSystem(resourceSystem)
 {
     mParticleSystem = new osgParticle::ParticleSystem;
 
@@ -117,11 +308,39 @@ RippleSimulation::RippleSimulation(osg::Group *parent, Resource::ResourceSystem*
 RippleSimulation::~RippleSimulation()
 {
     mParent->removeChild(mParticleNode);
+    if (mRippleMap)
+        mParent->removeChild(mRippleMap);
+}
+
+void RippleSimulation::setUseRippleMap(bool enabled)
+{
+    if (enabled == (mRippleMap != nullptr))
+        return;
+
+    if (enabled)
+    {
+        clear();
+        mRippleMap = new RippleMap(mResourceSystem);
+        mParent->addChild(mRippleMap);
+        mParticleNode->setNodeMask(0);
+    }
+    else
+    {
+        mParent->removeChild(mRippleMap);
+        mRippleMap = nullptr;
+        mParticleNode->setNodeMask(Mask_Water);
+    }
 }
 
 void RippleSimulation::update(float dt)
 {
     const MWBase::World* world = MWBase::Environment::get().getWorld();
+    if (mRippleMap)
+    {
+        const osg::Vec3f playerPos = world->getPlayerConstPtr().getRefData().getPosition().asVec3();
+        mRippleMap->update(dt, osg::Vec2f(playerPos.x(), playerPos.y()));
+    }
+
     for (Emitter& emitter : mEmitters)
     {
         MWWorld::ConstPtr& ptr = emitter.mPtr;
@@ -141,7 +360,7 @@ void RippleSimulation::update(float dt)
 
             currentPos.z() = mParticleNode->getPosition().z();
 
-            if (mParticleSystem->numParticles()-mParticleSystem->numDeadParticles() > 500)
+            if (!mRippleMap && mParticleSystem->numParticles()-mParticleSystem->numDeadParticles() > 500)
                 continue; // TODO: remove the oldest particle to make room?
 
             emitRipple(currentPos);
@@ -201,6 +420,12 @@ void RippleSimulation::emitRipple(const osg::Vec3f &pos)
 {
     if (std::abs(pos.z() - mParticleNode->getPosition().z()) < 20)
     {
+        if (mRippleMap)
+        {
+            mRippleMap->addRipple(osg::Vec2f(pos.x(), pos.y()));
+            return;
+        }
+
         osgParticle::ParticleSystem::ScopedWriteLock lock(*mParticleSystem->getReadWriteMutex());
         osgParticle::Particle* p = mParticleSystem->createParticle(nullptr);
         p->setPosition(osg::Vec3f(pos.x(), pos.y(), 0.f));
@@ -217,6 +442,8 @@ void RippleSimulation::clear()
 {
     for (int i=0; i<mParticleSystem->numParticles(); ++i)
         mParticleSystem->destroyParticle(i);
+    if (mRippleMap)
+        mRippleMap->clear();
 }
 
 
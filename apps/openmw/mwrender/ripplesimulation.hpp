@@ -1,14 +1,21 @@
 #ifndef OPENMW_MWRENDER_RIPPLESIMULATION_H
 #define OPENMW_MWRENDER_RIPPLESIMULATION_H
 
+#include <array>
+#include <vector>
+
+#include <osg/Group>
 #include <osg/ref_ptr>
+#include <osg/Vec2f>
+#include <osg/Vec4f>
 
 #include "../mwworld/ptr.hpp"
 
 namespace osg
 {
-    class Group;
+    class Camera;
     class PositionAttitudeTransform;
+    class Texture2D;
 }
 
 namespace osgParticle
@@ -37,6 +44,61 @@ namespace MWRender
         float mForce;
     };
 
+    /// @brief Simulates the heights of ripples on the water around a position on the GPU, for the water shader to sample.
+    /// @par Each step renders the next state into one of two textures, reading the last state from the other one, so the cost
+    ///     doesn't depend on the number of ripples. Ripples are started by impulses queued between the steps.
+    /// @par The map moves along with its center in whole texels, the state is shifted to stay in place in the world.
+    class RippleMap : public osg::Group
+    {
+    public:
+        RippleMap(Resource::ResourceSystem* resourceSystem);
+
+        /// Queue an impulse for the next step, dropped if too many are queued or the position is outside the map.
+        void addRipple(const osg::Vec2f& position);
+
+        /// Move the map along with the center and queue a step if enough time has passed since the last one.
+        void update(float dt, const osg::Vec2f& center);
+
+        /// Remove all ripples in the next step.
+        void clear();
+
+        /// Culls the camera of the queued step, only in the first cull traversal of a frame.
+        void traverse(osg::NodeVisitor& nv) override;
+
+        /// The result of the last step, nullptr if there was none yet.
+        osg::Texture2D* getTexture() const;
+
+        /// World position of the texture coordinates (0, 0) of the result of the last step.
+        const osg::Vec2f& getOrigin() const { return mOrigins[mTarget]; }
+
+        /// Width and height of the map in world units.
+        static float getSize();
+
+        /// Width and height of the map in texels.
+        static int getResolution();
+
+        /// Uniforms of the queued step, used by the cameras.
+        const osg::Vec2f& getStepOffset() const { return mStepOffset; }
+        const std::vector<osg::Vec4f>& getStepRipples() const { return mStepRipples; }
+        float getStepDamping() const { return mStepDamping; }
+
+    private:
+        std::array<osg::ref_ptr<osg::Texture2D>, 2> mTextures;
+        std::array<osg::ref_ptr<osg::Camera>, 2> mCameras;
+        std::array<osg::Vec2f, 2> mOrigins;
+        std::size_t mTarget = 0;
+        bool mHasResult = false;
+        bool mStepQueued = false;
+        bool mClear = true;
+        float mTimeSinceStep = 0;
+        unsigned int mLastCullFrame = ~0u;
+
+        std::vector<osg::Vec4f> mRipples;
+        std::vector<osg::Vec4f> mStepRipples;
+        osg::Vec2f mStepOffset;
+        float mStepDamping = 0;
+    };
+
     class RippleSimulation
     {
     public:
@@ -46,6 +108,12 @@ namespace MWRender
         /// @param dt Time since the last frame
         void update(float dt);
 
+        /// Simulate the ripples in a RippleMap for the water shader instead of drawing them as particles.
+        void setUseRippleMap(bool enabled);
+
+        /// nullptr unless the ripples are simulated in a RippleMap.
+        RippleMap* getRippleMap() { return mRippleMap; }
+
         /// adds an emitter, position will be tracked automatically
         void addEmitter (const MWWorld::ConstPtr& ptr, float scale = 1.f, float force = 1.f);
         void removeEmitter (const MWWorld::ConstPtr& ptr);
@@ -62,6 +130,9 @@ namespace MWRender
 
     private:
         osg::ref_ptr<osg::Group> mParent;
+        Resource::ResourceSystem* mResourceSystem;
+
+        osg::ref_ptr<RippleMap> mRippleMap;
 
         osg::ref_ptr<osgParticle::ParticleSystem> mParticleSystem;
         osg::ref_ptr<osg::PositionAttitudeTransform> mParticleNode;
@@ -105,8 +105,8 @@ namespace MWRender
                 }
             }
 
+            // Scaling is left to the caller, so it doesn't delay the frame
             mImage->readPixels(leftPadding, topPadding, width, height, GL_RGB, GL_UNSIGNED_BYTE);
-            mImage->scaleImage(mWidth, mHeight, 1);
         }
     private:
         int mWidth;
@@ -24,6 +24,8 @@ namespace MWRender
         ScreenshotManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode, osg::ref_ptr<osg::Group> sceneRoot, Resource::ResourceSystem* resourceSystem, Water* water);
         ~ScreenshotManager();
 
+        /// Read the largest part of the frame with the aspect ratio of \a w and \a h into \a image.
+        /// \note The image is not scaled to \a w x \a h.
         void screenshot(osg::Image* image, int w, int h);
         bool screenshot360(osg::Image* image);
 
@@ -1,6 +1,10 @@
 #include "sky.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <osg/Depth>
+#include <osg/Geometry>
 #include <osg/PositionAttitudeTransform>
 
 #include <osgParticle/Operator>
@@ -9,7 +13,7 @@
 #include <osgParticle/ModularProgram>
 #include <osgParticle/ParticleSystemUpdater>
 
-#include <components/settings/settings.hpp>
+#include <components/settings/settingvalue.hpp>
 
 #include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/shadow.hpp>
@@ -38,6 +42,44 @@
 
 namespace
 {
+    constexpr float rainAlphaThreshold = 0.6f; // Rain_Threshold?
+
+    // Quads for the shader-driven rain. Each drop gets a random position in the unit cube, which the vertex shader
+    // scales to the rain range, and the random spin and size the RainShooter and particle template would give it.
+    osg::ref_ptr<osg::Geometry> createRaindrops(unsigned int count)
+    {
+        osg::ref_ptr<osg::Vec3Array> positions = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec2Array> corners = new osg::Vec2Array;
+        osg::ref_ptr<osg::Vec3Array> drops = new osg::Vec3Array;
+        positions->reserve(count * 4);
+        corners->reserve(count * 4);
+        drops->reserve(count * 4);
+
+        static const osg::Vec2f quadCorners[4] = { {0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f} };
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            osg::Vec3f position(Misc::Rng::rollProbability(), Misc::Rng::rollProbability(), Misc::Rng::rollProbability());
+            osg::Vec3f drop((Misc::Rng::rollProbability() * 2 - 1) * osg::PI, 5.f + Misc::Rng::rollProbability() * 10.f, static_cast<float>(i));
+            for (const osg::Vec2f& corner : quadCorners)
+            {
+                positions->push_back(position);
+                corners->push_back(corner);
+                drops->push_back(drop);
+            }
+        }
+
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        geometry->setVertexArray(positions);
+        geometry->setTexCoordArray(0, corners, osg::Array::BIND_PER_VERTEX);
+        geometry->setTexCoordArray(1, drops, osg::Array::BIND_PER_VERTEX);
+        geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, count * 4));
+        geometry->setUseDisplayList(false);
+        geometry->setUseVertexBufferObjects(true);
+        // the vertex shader moves the drops around the camera, so the vertices don't give the real bounds
+        geometry->setCullingActive(false);
+        return geometry;
+    }
+
     class WrapAroundOperator : public osgParticle::Operator
     {
     public:
@@ -136,8 +178,7 @@ namespace
 
         void operate(osgParticle::Particle *particle, double dt) override
         {
-            constexpr float rainThreshold = 0.6f; // Rain_Threshold?
-            float alpha = mIsRain ? mAlpha * rainThreshold : mAlpha;
+            float alpha = mIsRain ? mAlpha * rainAlphaThreshold : mAlpha;
             particle->setAlphaRange(osgParticle::rangef(alpha, alpha));
         }
 
@@ -222,6 +263,9 @@ namespace MWRender
         : mSceneManager(sceneManager)
         , mCamera(nullptr)
         , mAtmosphereNightRoll(0.f)
+        , mRainCapacity(0)
+        , mRainLighting(1.f, 1.f, 1.f)
+        , mGpuRain(sceneManager->getForceShaders() && Settings::Manager::getBool("gpu rain", "Shaders"))
         , mCreated(false)
         , mIsStorm(false)
         , mDay(0)
@@ -249,6 +293,7 @@ namespace MWRender
         , mSunEnabled(true)
         , mPrecipitationAlpha(0.f)
         , mDirtyParticlesEffect(false)
+        , mChange(0.f)
     {
         osg::ref_ptr<CameraRelativeTransform> skyroot = new CameraRelativeTransform;
         skyroot->setName("Sky Root");
@@ -360,10 +405,16 @@ namespace MWRender
         if (mRainNode)
             return;
 
+        if (mGpuRain)
+        {
+            createGpuRain();
+            return;
+        }
+
         mRainNode = new osg::Group;
 
         mRainParticleSystem = new NifOsg::ParticleSystem;
-        osg::Vec3 rainRange = osg::Vec3(mRainDiameter, mRainDiameter, (mRainMinHeight+mRainMaxHeight)/2.f);
+        osg::Vec3 rainRange = getRainRange();
 
         mRainParticleSystem->setParticleAlignment(osgParticle::ParticleSystem::FIXED);
         mRainParticleSystem->setAlignVectorX(osg::Vec3f(0.1,0,0));
@@ -437,6 +488,39 @@ namespace MWRender
         mRootNode->addChild(mRainNode);
     }
 
+    void SkyManager::createGpuRain()
+    {
+        mRainNode = new osg::Group;
+        mRainCapacity = 0;
+        mRainOffset = osg::Vec3f();
+        mRainCameraPosition = mCamera->getInverseViewMatrix().getTrans();
+
+        osg::ref_ptr<osg::StateSet> stateset = mRainNode->getOrCreateStateSet();
+
+        osg::ref_ptr<osg::Texture2D> raindropTex = new osg::Texture2D(mSceneManager->getImageManager()->getImage("textures/tx_raindrop_01.dds"));
+        raindropTex->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        raindropTex->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+
+        stateset->setTextureAttributeAndModes(0, raindropTex);
+        stateset->addUniform(new osg::Uniform("diffuseMap", 0));
+        stateset->setNestRenderBins(false);
+        stateset->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+        stateset->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+        stateset->setMode(GL_BLEND, osg::StateAttribute::ON);
+
+        auto vertex = mSceneManager->getShaderManager().getShader("rain_vertex.glsl", {}, osg::Shader::VERTEX);
+        auto fragment = mSceneManager->getShaderManager().getShader("rain_fragment.glsl", {}, osg::Shader::FRAGMENT);
+        stateset->setAttributeAndModes(mSceneManager->getShaderManager().getProgram(vertex, fragment));
+
+        mRainUpdater = new RainUpdater;
+        mRainNode->addUpdateCallback(mRainUpdater);
+
+        mRainNode->addCullCallback(mUnderwaterSwitch);
+        mRainNode->setNodeMask(Mask_WeatherParticles);
+
+        mRootNode->addChild(mRainNode);
+    }
+
     void SkyManager::destroyRain()
     {
         if (!mRainNode)
@@ -448,6 +532,13 @@ namespace MWRender
         mCounter = nullptr;
         mRainParticleSystem = nullptr;
         mRainShooter = nullptr;
+        mRainGeometry = nullptr;
+        mRainUpdater = nullptr;
+    }
+
+    osg::Vec3f SkyManager::getRainRange() const
+    {
+        return osg::Vec3f(mRainDiameter, mRainDiameter, (mRainMinHeight+mRainMaxHeight)/2.f);
     }
 
     SkyManager::~SkyManager()
@@ -496,18 +587,24 @@ namespace MWRender
 
         switchUnderwaterRain();
 
+        if (mRainUpdater)
+            updateGpuRain(duration);
+
         if (mIsStorm && mParticleNode)
         {
             osg::Quat quat;
             quat.makeRotate(MWWorld::Weather::defaultDirection(), mStormParticleDirection);
             // Morrowind deliberately rotates the blizzard mesh, so so should we.
-            if (mCurrentParticleEffect == Settings::Manager::getString("weatherblizzard", "Models"))
+            static const Settings::SettingValue<std::string> blizzardModel("weatherblizzard", "Models");
+            if (mCurrentParticleEffect == blizzardModel.get())
                 quat.makeRotate(osg::Vec3f(-1,0,0), mStormParticleDirection);
             mParticleNode->setAttitude(quat);
         }
 
         // UV Scroll the clouds
-        mCloudAnimationTimer += duration * mCloudSpeed * 0.003;
+        const float cloudScroll = duration * mCloudSpeed * 0.003;
+        mCloudAnimationTimer += cloudScroll;
+        mChange += cloudScroll;
         mNextCloudUpdater->setTextureCoord(mCloudAnimationTimer);
         mCloudUpdater->setTextureCoord(mCloudAnimationTimer);
 
@@ -558,7 +655,7 @@ namespace MWRender
             mRainShooter->setVelocity(osg::Vec3f(0, mRainSpeed*std::sin(angle), -mRainSpeed/std::cos(angle)));
             mRainShooter->setAngle(angle);
 
-            osg::Vec3 rainRange = osg::Vec3(mRainDiameter, mRainDiameter, (mRainMinHeight+mRainMaxHeight)/2.f);
+            osg::Vec3 rainRange = getRainRange();
 
             mPlacer->setXRange(-rainRange.x() / 2, rainRange.x() / 2);
             mPlacer->setYRange(-rainRange.y() / 2, rainRange.y() / 2);
@@ -566,6 +663,54 @@ namespace MWRender
 
             mCounter->setNumberOfParticlesPerSecondToCreate(mRainMaxRaindrops/mRainEntranceSpeed*20);
         }
+        else if (mRainUpdater)
+        {
+            float angle = -std::atan(mWindSpeed/50.f);
+            mRainVelocity = osg::Vec3f(0, mRainSpeed*std::sin(angle), -mRainSpeed/std::cos(angle));
+
+            // The particles live for one second, so the emission rate is also the number of drops in the air
+            unsigned int count = static_cast<unsigned int>(std::max(0.f, mRainMaxRaindrops/mRainEntranceSpeed*20));
+            if (count > mRainCapacity)
+            {
+                osg::ref_ptr<osg::Geometry> geometry = createRaindrops(count);
+                if (mRainGeometry)
+                    mRainNode->replaceChild(mRainGeometry, geometry);
+                else
+                    mRainNode->addChild(geometry);
+                mRainGeometry = geometry;
+                mRainCapacity = count;
+            }
+
+            mRainUpdater->setRange(getRainRange());
+            mRainUpdater->setAngle(angle);
+            mRainUpdater->setCount(static_cast<int>(count));
+            mRainUpdater->setLighting(mRainLighting);
+        }
+    }
+
+    void SkyManager::updateGpuRain(float duration)
+    {
+        osg::Vec3f cameraPosition = mCamera->getInverseViewMatrix().getTrans();
+
+        // limit the time step like RainCounter does, and stop the rain like the frozen particle system underwater
+        if (!mUnderwaterSwitch->isUnderwater())
+            mRainOffset += mRainVelocity * std::min(duration, 0.2f);
+        mRainOffset -= cameraPosition - mRainCameraPosition;
+        mRainCameraPosition = cameraPosition;
+
+        // keep the offset inside the rain volume so it doesn't lose precision over time
+        const osg::Vec3f range = getRainRange();
+        for (int i = 0; i < 3; ++i)
+        {
+            if (range[i] <= 0.f)
+                continue;
+            mRainOffset[i] = std::fmod(mRainOffset[i], range[i]);
+            if (mRainOffset[i] < 0.f)
+                mRainOffset[i] += range[i];
+        }
+
+        mRainUpdater->setOffset(mRainOffset);
+        mRainUpdater->setAlpha(mPrecipitationAlpha * rainAlphaThreshold);
     }
 
     void SkyManager::switchUnderwaterRain()
@@ -581,6 +726,12 @@ namespace MWRender
     {
         if (!mCreated) return;
 
+        mChange += (weather.mSkyColor - mSkyColour).length() + (weather.mFogColor - mFogColour).length()
+            + std::abs(weather.mCloudBlendFactor - mCloudBlendFactor)
+            + (weather.mNight ? std::abs(weather.mNightFade * weather.mGlareView - mStarsOpacity) : 0.f);
+        if (weather.mCloudTexture != mClouds || weather.mNextCloudTexture != mNextClouds)
+            mChange += 1.f;
+
         mRainEntranceSpeed = weather.mRainEntranceSpeed;
         mRainMaxRaindrops = weather.mRainMaxRaindrops;
         mRainDiameter = weather.mRainDiameter;
@@ -589,6 +740,9 @@ namespace MWRender
         mRainSpeed = weather.mRainSpeed;
         mWindSpeed = weather.mWindSpeed;
         mBaseWindSpeed = weather.mBaseWindSpeed;
+        // approximates the sun-only lighting of the particle system, whose drops face random directions
+        mRainLighting = osg::Vec3f(weather.mAmbientColor.x(), weather.mAmbientColor.y(), weather.mAmbientColor.z())
+                      + osg::Vec3f(weather.mSunColor.x(), weather.mSunColor.y(), weather.mSunColor.z()) * 0.5f;
 
         if (mRainEffect != weather.mRainEffect)
         {
@@ -773,6 +927,13 @@ namespace MWRender
         return mBaseWindSpeed;
     }
 
+    float SkyManager::takeChange()
+    {
+        const float change = mChange;
+        mChange = 0.f;
+        return change;
+    }
+
     void SkyManager::sunEnable()
     {
         if (!mCreated) return;
@@ -797,6 +958,12 @@ namespace MWRender
         if (!mCreated) return;
 
         mSun->setDirection(direction);
+
+        if (direction.length2() == 0.f)
+            return;
+        const osg::Vec3f normalizedDirection = direction / direction.length();
+        mChange += std::acos(std::clamp(normalizedDirection * mSunDirection, -1.f, 1.f));
+        mSunDirection = normalizedDirection;
     }
 
     void SkyManager::setMasserState(const MoonState& state)
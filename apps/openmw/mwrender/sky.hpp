@@ -17,6 +17,7 @@ namespace osg
     class Material;
     class PositionAttitudeTransform;
     class Camera;
+    class Geometry;
 }
 
 namespace osgParticle
@@ -96,14 +97,21 @@ namespace MWRender
 
         float getBaseWindSpeed() const;
 
+        /// How much the look of the sky changed since the last call, as a rough sum of colour differences,
+        /// sun movement in radians and cloud scrolling in texture coordinates.
+        float takeChange();
+
     private:
         void create();
         ///< no need to call this, automatically done on first enable()
 
         void createRain();
+        void createGpuRain();
         void destroyRain();
         void switchUnderwaterRain();
         void updateRainParameters();
+        void updateGpuRain(float duration);
+        osg::Vec3f getRainRange() const;
 
         Resource::SceneManager* mSceneManager;
 
@@ -141,6 +149,16 @@ namespace MWRender
         osg::ref_ptr<RainCounter> mCounter;
         osg::ref_ptr<RainShooter> mRainShooter;
 
+        // shader-driven rain, used instead of the particle system with 'gpu rain'
+        osg::ref_ptr<osg::Geometry> mRainGeometry;
+        osg::ref_ptr<RainUpdater> mRainUpdater;
+        unsigned int mRainCapacity;
+        osg::Vec3f mRainOffset;
+        osg::Vec3f mRainVelocity;
+        osg::Vec3f mRainCameraPosition;
+        osg::Vec3f mRainLighting;
+        bool mGpuRain;
+
         bool mCreated;
 
         bool mIsStorm;
@@ -189,6 +207,9 @@ namespace MWRender
         bool mDirtyParticlesEffect;
 
         osg::Vec4f mMoonScriptColor;
+
+        osg::Vec3f mSunDirection;
+        float mChange;
     };
 }
 
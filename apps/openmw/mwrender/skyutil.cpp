@@ -1089,6 +1089,63 @@ namespace MWRender
         return new RainShooter(*this);
     }
 
+    RainUpdater::RainUpdater()
+        : mAngle(0.f)
+        , mCount(0)
+        , mAlpha(0.f)
+        , mLighting(1.f, 1.f, 1.f)
+    { }
+
+    void RainUpdater::setOffset(const osg::Vec3f& offset)
+    {
+        mOffset = offset;
+    }
+
+    void RainUpdater::setRange(const osg::Vec3f& range)
+    {
+        mRange = range;
+    }
+
+    void RainUpdater::setAngle(float angle)
+    {
+        mAngle = angle;
+    }
+
+    void RainUpdater::setCount(int count)
+    {
+        mCount = count;
+    }
+
+    void RainUpdater::setAlpha(float alpha)
+    {
+        mAlpha = alpha;
+    }
+
+    void RainUpdater::setLighting(const osg::Vec3f& lighting)
+    {
+        mLighting = lighting;
+    }
+
+    void RainUpdater::setDefaults(osg::StateSet *stateset)
+    {
+        stateset->addUniform(new osg::Uniform("rainOffset", osg::Vec3f()));
+        stateset->addUniform(new osg::Uniform("rainRange", osg::Vec3f(1.f, 1.f, 1.f)));
+        stateset->addUniform(new osg::Uniform("rainAngle", 0.f));
+        stateset->addUniform(new osg::Uniform("rainCount", 0));
+        stateset->addUniform(new osg::Uniform("rainAlpha", 0.f));
+        stateset->addUniform(new osg::Uniform("rainLighting", osg::Vec3f(1.f, 1.f, 1.f)));
+    }
+
+    void RainUpdater::apply(osg::StateSet *stateset, osg::NodeVisitor *nv)
+    {
+        stateset->getUniform("rainOffset")->set(mOffset);
+        stateset->getUniform("rainRange")->set(mRange);
+        stateset->getUniform("rainAngle")->set(mAngle);
+        stateset->getUniform("rainCount")->set(mCount);
+        stateset->getUniform("rainAlpha")->set(mAlpha);
+        stateset->getUniform("rainLighting")->set(mLighting);
+    }
+
     ModVertexAlphaVisitor::ModVertexAlphaVisitor(ModVertexAlphaVisitor::MeshType type)
         : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
         , mType(type)
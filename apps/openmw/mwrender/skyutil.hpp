@@ -321,6 +321,34 @@ namespace MWRender
         float mAngle;
     };
 
+    /// Sets the uniforms of the shader-driven rain, which animates every raindrop in rain_vertex.glsl
+    /// from a single offset instead of simulating them as particles.
+    class RainUpdater : public SceneUtil::StateSetUpdater
+    {
+    public:
+        RainUpdater();
+
+        /// @param offset Distance the rain has moved relative to the camera, wrapped to the rain range
+        void setOffset(const osg::Vec3f& offset);
+        void setRange(const osg::Vec3f& range);
+        void setAngle(float angle);
+        void setCount(int count);
+        void setAlpha(float alpha);
+        void setLighting(const osg::Vec3f& lighting);
+
+    protected:
+        void setDefaults(osg::StateSet *stateset) override;
+        void apply(osg::StateSet *stateset, osg::NodeVisitor *nv) override;
+
+    private:
+        osg::Vec3f mOffset;
+        osg::Vec3f mRange;
+        float mAngle;
+        int mCount;
+        float mAlpha;
+        osg::Vec3f mLighting;
+    };
+
     class ModVertexAlphaVisitor : public osg::NodeVisitor
     {
     public:
@@ -69,6 +69,11 @@ namespace MWRender
         return mLandManager->getLand(cellX, cellY);
     }
 
+    osg::ref_ptr<const ESMTerrain::LandObject> TerrainStorage::getLandHeights(int cellX, int cellY)
+    {
+        return mLandManager->getLandHeights(cellX, cellY);
+    }
+
     const ESM::LandTexture* TerrainStorage::getLandTexture(int index, short plugin)
     {
         const MWWorld::ESMStore &esmStore =
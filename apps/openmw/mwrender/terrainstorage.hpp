@@ -21,6 +21,7 @@ namespace MWRender
         ~TerrainStorage();
 
         osg::ref_ptr<const ESMTerrain::LandObject> getLand (int cellX, int cellY) override;
+        osg::ref_ptr<const ESMTerrain::LandObject> getLandHeights (int cellX, int cellY) override;
         const ESM::LandTexture* getLandTexture(int index, short plugin) override;
 
         bool hasData(int cellX, int cellY) override;
@@ -56,6 +56,9 @@ namespace MWRender
         Mask_Lighting = (1<<19),
 
         Mask_Groundcover = (1<<20),
+
+        // Shadow-only stand-ins for paged objects, drawn by shadow cameras instead of the originals
+        Mask_ShadowProxy = (1<<21),
     };
 
     // Defines masks to remove when using ToggleWorld command
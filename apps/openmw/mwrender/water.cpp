@@ -1,6 +1,8 @@
 #include "water.hpp"
 
+#include <array>
 #include <iomanip>
+#include <iterator>
 
 #include <osg/Fog>
 #include <osg/Depth>
@@ -10,6 +12,7 @@
 #include <osg/PositionAttitudeTransform>
 #include <osg/ClipNode>
 #include <osg/FrontFace>
+#include <osg/TextureCubeMap>
 
 #include <osgDB/ReadFile>
 
@@ -42,6 +45,8 @@
 
 #include <components/fallback/fallback.hpp>
 
+#include <components/settings/settingvalue.hpp>
+
 #include "../mwworld/cellstore.hpp"
 
 #include "vismask.hpp"
@@ -331,14 +336,203 @@ private:
     static constexpr unsigned int sDefaultCullMask = Mask_Effect | Mask_Scene | Mask_Object | Mask_Static | Mask_Terrain | Mask_Actor | Mask_ParticleSystem | Mask_Sky | Mask_Sun | Mask_Player | Mask_Lighting | Mask_Groundcover;
 };
 
+/// Renders the sky into a cubemap, which the reflection samples instead of drawing the sky itself.
+/// The cubemap is only rendered again once the sky changed noticeably, see addChange.
+class SkyCubemap : public osg::Group
+{
+public:
+    SkyCubemap(unsigned int size, float changeThreshold)
+        : mTexture(new osg::TextureCubeMap)
+        , mChangeThreshold(changeThreshold)
+    {
+        mTexture->setTextureSize(size, size);
+        mTexture->setInternalFormat(GL_RGB);
+        mTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        mTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+        mTexture->setWrap(osg::Texture::WRAP_R, osg::Texture::CLAMP_TO_EDGE);
+        mTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        mTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+
+        const double nearClip = 1.0;
+        const double farClip = 100000.0;
+        const osg::Matrix projection = SceneUtil::AutoDepth::isReversed()
+            ? SceneUtil::getReversedZProjectionMatrixAsPerspective(90.0, 1.0, nearClip, farClip)
+            : osg::Matrix::perspective(90.0, 1.0, nearClip, farClip);
+
+        for (unsigned int face = 0; face < 6; ++face)
+        {
+            osg::ref_ptr<osg::Camera> camera(new osg::Camera);
+            camera->setName("SkyCubemapCamera");
+            camera->setRenderOrder(osg::Camera::PRE_RENDER, -1);
+            camera->setRenderTargetImplementation(osg::Camera::FRAME_BUFFER_OBJECT);
+            camera->setReferenceFrame(osg::Camera::ABSOLUTE_RF);
+            camera->setComputeNearFarMode(osg::Camera::DO_NOT_COMPUTE_NEAR_FAR);
+            camera->setViewport(0, 0, size, size);
+            camera->setClearMask(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            camera->setClearColor(osg::Vec4f(0, 0, 0, 1));
+            SceneUtil::setCameraClearDepth(camera);
+            camera->setProjectionMatrix(projection);
+            camera->setCullMask(Mask_Sky);
+            camera->attach(osg::Camera::COLOR_BUFFER, mTexture, 0, face);
+            SceneUtil::ShadowManager::disableShadowsForStateSet(camera->getOrCreateStateSet());
+            addChild(camera);
+        }
+
+        setNodeMask(Mask_RenderToTexture);
+        setCullingActive(false);
+    }
+
+    osg::TextureCubeMap* getTexture() const
+    {
+        return mTexture.get();
+    }
+
+    void setScene(osg::Node* scene)
+    {
+        for (unsigned int i = 0; i < getNumChildren(); ++i)
+        {
+            osg::Camera* camera = getChild(i)->asCamera();
+            camera->removeChildren(0, camera->getNumChildren());
+            camera->addChild(scene);
+        }
+    }
+
+    /// @param change How much the look of the sky changed, see SkyManager::takeChange.
+    void addChange(float change)
+    {
+        mChange += change;
+        if (mChange >= mChangeThreshold)
+            dirty();
+    }
+
+    void dirty()
+    {
+        mChange = 0.f;
+        mDirty = true;
+    }
+
+    void traverse(osg::NodeVisitor& nv) override
+    {
+        if (nv.getVisitorType() != osg::NodeVisitor::CULL_VISITOR)
+        {
+            osg::Group::traverse(nv);
+            return;
+        }
+
+        // the first view to be culled in a frame decides, the cubemap is the same for all of them
+        osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(&nv);
+        const unsigned int frame = cv->getTraversalNumber();
+        if (frame != mLastCheckFrame)
+        {
+            mLastCheckFrame = frame;
+            if (mDirty)
+            {
+                mDirty = false;
+                mLastUpdateFrame = frame;
+                // the sky is relative to the eye, but parts of it are hidden when the eye is under water
+                updateViewMatrices(cv->getEyePoint());
+            }
+        }
+
+        if (frame == mLastUpdateFrame)
+            osg::Group::traverse(nv);
+    }
+
+private:
+    void updateViewMatrices(const osg::Vec3f& eyePoint)
+    {
+        // the directions and up vectors of the faces in the order of osg::TextureCubeMap::Face
+        static const std::array<std::pair<osg::Vec3f, osg::Vec3f>, 6> faces = {{
+            { osg::Vec3f(1, 0, 0), osg::Vec3f(0, -1, 0) },
+            { osg::Vec3f(-1, 0, 0), osg::Vec3f(0, -1, 0) },
+            { osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1) },
+            { osg::Vec3f(0, -1, 0), osg::Vec3f(0, 0, -1) },
+            { osg::Vec3f(0, 0, 1), osg::Vec3f(0, -1, 0) },
+            { osg::Vec3f(0, 0, -1), osg::Vec3f(0, -1, 0) },
+        }};
+
+        for (unsigned int i = 0; i < getNumChildren(); ++i)
+            getChild(i)->asCamera()->setViewMatrixAsLookAt(eyePoint, eyePoint + faces[i].first, faces[i].second);
+    }
+
+    osg::ref_ptr<osg::TextureCubeMap> mTexture;
+    const float mChangeThreshold;
+    float mChange = 0.f;
+    bool mDirty = true;
+    unsigned int mLastCheckFrame = ~0u;
+    unsigned int mLastUpdateFrame = ~0u;
+};
+
+/// Draws the sky cubemap behind everything else, as a cube centered on the eye.
+osg::ref_ptr<osg::Node> createSkyCubemapBox(osg::TextureCubeMap* texture, Shader::ShaderManager& shaderManager)
+{
+    osg::ref_ptr<osg::Vec3Array> vertices(new osg::Vec3Array);
+    for (int i = 0; i < 8; ++i)
+        vertices->push_back(osg::Vec3f(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1));
+
+    static const GLushort indices[] = {
+        0, 2, 1, 1, 2, 3, // -z
+        4, 5, 6, 5, 7, 6, // +z
+        0, 1, 4, 1, 5, 4, // -y
+        2, 6, 3, 3, 6, 7, // +y
+        0, 4, 2, 2, 4, 6, // -x
+        1, 3, 5, 3, 7, 5, // +x
+    };
+
+    osg::ref_ptr<osg::Geometry> geometry(new osg::Geometry);
+    geometry->setVertexArray(vertices);
+    geometry->addPrimitiveSet(new osg::DrawElementsUShort(osg::PrimitiveSet::TRIANGLES, std::size(indices), indices));
+    // the vertex shader moves the cube to the eye
+    geometry->setCullingActive(false);
+
+    osg::StateSet* stateset = geometry->getOrCreateStateSet();
+    std::map<std::string, std::string> defineMap;
+    osg::ref_ptr<osg::Shader> vertexShader(shaderManager.getShader("sky_cubemap_vertex.glsl", defineMap, osg::Shader::VERTEX));
+    osg::ref_ptr<osg::Shader> fragmentShader(shaderManager.getShader("sky_cubemap_fragment.glsl", defineMap, osg::Shader::FRAGMENT));
+    stateset->setAttributeAndModes(shaderManager.getProgram(vertexShader, fragmentShader), osg::StateAttribute::ON);
+    stateset->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+    stateset->addUniform(new osg::Uniform("skyCubemap", 0));
+    stateset->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+    stateset->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+    stateset->setMode(GL_CLIP_PLANE0, osg::StateAttribute::OFF);
+    stateset->setRenderBinDetails(RenderBin_Sky, "RenderBin");
+    return geometry;
+}
+
 class Reflection : public SceneUtil::RTTNode
 {
 public:
-    Reflection(uint32_t rttSize, bool isInterior)
+    Reflection(uint32_t rttSize, bool isInterior, Shader::ShaderManager& shaderManager)
         : RTTNode(rttSize, rttSize, 0, false)
+        , mReflectionDetail(Settings::Manager::getInt("reflection detail", "Water"))
+        , mUpdateInterval(std::max(1, Settings::Manager::getInt("reflection update interval", "Water")))
+        , mUpdateDistance(std::max(0.f, Settings::Manager::getFloat("reflection update distance", "Water")))
+        , mUpdateAngle(std::cos(osg::DegreesToRadians(std::clamp(Settings::Manager::getFloat("reflection update angle", "Water"), 0.f, 180.f))))
+        , mDetailDistance(std::max(0.f, Settings::Manager::getFloat("reflection detail distance", "Water")))
     {
         setInterior(isInterior);
         mClipCullNode = new ClipCullNode;
+
+        const int skyCubemapSize = Settings::Manager::getInt("sky cubemap size", "Water");
+        if (skyCubemapSize > 0)
+        {
+            mSkyCubemap = new SkyCubemap(skyCubemapSize,
+                std::max(0.f, Settings::Manager::getFloat("sky cubemap update threshold", "Water")));
+            mSkyCubemapBox = createSkyCubemapBox(mSkyCubemap->getTexture(), shaderManager);
+        }
+    }
+
+    /// Renders the sky the reflection samples, nullptr when the reflection draws the sky itself.
+    SkyCubemap* getSkyCubemap() const
+    {
+        return mSkyCubemap;
+    }
+
+    /// Whether the reflection may be reused for several frames, in which case the water shader has to reproject it.
+    static bool isReprojected()
+    {
+        static const Settings::SettingValue<int> updateInterval("reflection update interval", "Water");
+        return updateInterval.get() > 1;
     }
 
     void setDefaults(osg::Camera* camera) override
@@ -354,6 +548,8 @@ public:
         camera->getOrCreateStateSet()->setAttributeAndModes(frontFace, osg::StateAttribute::ON);
 
         camera->addChild(mClipCullNode);
+        if (mSkyCubemapBox)
+            camera->addChild(mSkyCubemapBox);
         camera->setNodeMask(Mask_RenderToTexture);
 
         SceneUtil::ShadowManager::disableShadowsForStateSet(camera->getOrCreateStateSet());
@@ -365,16 +561,64 @@ public:
         camera->setCullMask(mNodeMask);
     }
 
+    bool needsUpdate(osg::Camera* camera, osgUtil::CullVisitor* cv) override
+    {
+        return update(cv);
+    }
+
+    /// Decide whether the reflection is rendered in the frame of the visitor. The first view to be culled in a frame decides.
+    /// @note The water surface may be culled before the reflection, so both have to call this.
+    bool update(osgUtil::CullVisitor* cv)
+    {
+        const unsigned int frame = cv->getTraversalNumber();
+        if (frame == mLastCheckFrame)
+            return frame == mLastUpdateFrame;
+        mLastCheckFrame = frame;
+
+        // the model view matrix of the water surface includes its position
+        const osg::Matrix& viewMatrix = *cv->getCurrentRenderStage()->getInitialViewMatrix();
+        const osg::Matrix viewProjection = viewMatrix * *cv->getProjectionMatrix();
+        const osg::Vec3f eyePoint = osg::Matrix::inverse(viewMatrix).getTrans();
+        const osg::Vec3f viewDirection(-viewMatrix(0, 2), -viewMatrix(1, 2), -viewMatrix(2, 2));
+
+        const unsigned int nodeMask = calcNodeMask(eyePoint.z() - mWaterLevel);
+        if (nodeMask != mNodeMask)
+        {
+            mNodeMask = nodeMask;
+            mDirty = true;
+        }
+
+        if (!mDirty && frame - mLastUpdateFrame < mUpdateInterval
+            && (mUpdateDistance == 0.f || (eyePoint - mLastEyePoint).length() < mUpdateDistance)
+            && viewDirection * mLastViewDirection >= mUpdateAngle)
+            return false;
+
+        mDirty = false;
+        mLastUpdateFrame = frame;
+        mLastEyePoint = eyePoint;
+        mLastViewDirection = viewDirection;
+        mViewProjectionMatrix = viewProjection;
+        return true;
+    }
+
+    /// The view projection matrix of the view the reflection was last rendered for.
+    const osg::Matrixf& getViewProjectionMatrix() const
+    {
+        return mViewProjectionMatrix;
+    }
+
     void setInterior(bool isInterior)
     {
         mInterior = isInterior;
-        mNodeMask = calcNodeMask();
+        mDirty = true;
     }
 
     void setWaterLevel(float waterLevel)
     {
+        mWaterLevel = waterLevel;
         mViewMatrix = osg::Matrix::scale(1, 1, -1) * osg::Matrix::translate(0, 0, 2 * waterLevel);
         mClipCullNode->setPlane(osg::Plane(osg::Vec3d(0, 0, 1), osg::Vec3d(0, 0, waterLevel)));
+        mDirty = true;
     }
 
     void setScene(osg::Node* scene)
@@ -383,21 +627,35 @@ public:
             mClipCullNode->removeChild(mScene);
         mScene = scene;
         mClipCullNode->addChild(scene);
+        if (mSkyCubemap)
+            mSkyCubemap->setScene(scene);
     }
 
     void showWorld(bool show)
     {
-        if (show)
-            mNodeMask = calcNodeMask();
-        else
-            mNodeMask = calcNodeMask() & ~sToggleWorldMask;
+        mShowWorld = show;
+        mDirty = true;
+    }
+
+    void setSkyEnabled(bool enabled)
+    {
+        if (!mSkyCubemapBox)
+            return;
+        if (enabled && mSkyCubemapBox->getNodeMask() == 0)
+            mSkyCubemap->dirty();
+        mSkyCubemapBox->setNodeMask(enabled ? ~0u : 0u);
+        mSkyCubemap->setNodeMask(enabled ? Mask_RenderToTexture : 0u);
     }
 
 private:
 
-    unsigned int calcNodeMask()
+    /// @param height The height of the eye above the water.
+    unsigned int calcNodeMask(float height) const
     {
-        int reflectionDetail = Settings::Manager::getInt("reflection detail", "Water");
+        int reflectionDetail = mReflectionDetail;
+        // every tier of distance from the water drops one level of detail
+        if (mDetailDistance > 0.f)
+            reflectionDetail -= static_cast<int>(std::min(std::abs(height) / mDetailDistance, 5.f));
         reflectionDetail = std::clamp(reflectionDetail, mInterior ? 2 : 0, 5);
         unsigned int extraMask = 0;
         if(reflectionDetail >= 1) extraMask |= Mask_Terrain;
@@ -405,14 +663,37 @@ private:
         if(reflectionDetail >= 3) extraMask |= Mask_Effect | Mask_ParticleSystem | Mask_Object;
         if(reflectionDetail >= 4) extraMask |= Mask_Player | Mask_Actor;
         if(reflectionDetail >= 5) extraMask |= Mask_Groundcover;
-        return Mask_Scene | Mask_Sky | Mask_Lighting | extraMask;
+        unsigned int mask = Mask_Scene | Mask_Sky | Mask_Lighting | extraMask;
+        if (mSkyCubemap)
+            mask &= ~Mask_Sky;
+        if (!mShowWorld)
+            mask &= ~sToggleWorldMask;
+        return mask;
     }
 
     osg::ref_ptr<ClipCullNode> mClipCullNode;
     osg::ref_ptr<osg::Node> mScene;
-    osg::Node::NodeMask mNodeMask;
+    osg::ref_ptr<SkyCubemap> mSkyCubemap;
+    osg::ref_ptr<osg::Node> mSkyCubemapBox;
+    osg::Node::NodeMask mNodeMask = 0;
     osg::Matrix mViewMatrix{ osg::Matrix::identity() };
+    float mWaterLevel = 0.f;
     bool mInterior;
+    bool mShowWorld = true;
+
+    const int mReflectionDetail;
+    // the reflection is reused until any of these limits is exceeded
+    const unsigned int mUpdateInterval;
+    const float mUpdateDistance;
+    const float mUpdateAngle;
+    const float mDetailDistance;
+
+    bool mDirty = true;
+    unsigned int mLastCheckFrame = ~0u;
+    unsigned int mLastUpdateFrame = 0;
+    osg::Vec3f mLastEyePoint;
+    osg::Vec3f mLastViewDirection;
+    osg::Matrixf mViewProjectionMatrix;
 };
 
 /// DepthClampCallback enables GL_DEPTH_CLAMP for the current draw, if supported.
@@ -449,6 +730,7 @@ Water::Water(osg::Group *parent, osg::Group* sceneRoot, Resource::ResourceSystem
     , mTop(0)
     , mInterior(false)
     , mShowWorld(true)
+    , mSkyEnabled(true)
     , mCullCallback(nullptr)
     , mShaderWaterStateSetUpdater(nullptr)
 {
@@ -503,6 +785,16 @@ void Water::setCullCallback(osg::Callback* callback)
     }
 }
 
+void Water::setCullQueue(SceneUtil::RTTCullQueue* queue)
+{
+    mCullQueue = queue;
+
+    if (mReflection)
+        mReflection->setCullQueue(queue);
+    if (mRefraction)
+        mRefraction->setCullQueue(queue);
+}
+
 void Water::updateWaterMaterial()
 {
     if (mShaderWaterStateSetUpdater)
@@ -513,6 +805,7 @@ void Water::updateWaterMaterial()
     if (mReflection)
     {
         mParent->removeChild(mReflection);
+        mParent->removeChild(mReflection->getSkyCubemap());
         mReflection = nullptr;
     }
     if (mRefraction)
@@ -529,18 +822,23 @@ void Water::updateWaterMaterial()
     {
         unsigned int rttSize = Settings::Manager::getInt("rtt size", "Water");
 
-        mReflection = new Reflection(rttSize, mInterior);
+        mReflection = new Reflection(rttSize, mInterior, mResourceSystem->getSceneManager()->getShaderManager());
         mReflection->setWaterLevel(mTop);
         mReflection->setScene(mSceneRoot);
+        mReflection->setSkyEnabled(mSkyEnabled);
+        mReflection->setCullQueue(mCullQueue);
         if (mCullCallback)
             mReflection->addCullCallback(mCullCallback);
         mParent->addChild(mReflection);
+        if (SkyCubemap* skyCubemap = mReflection->getSkyCubemap())
+            mParent->addChild(skyCubemap);
 
         if (Settings::Manager::getBool("refraction", "Water"))
         {
             mRefraction = new Refraction(rttSize);
             mRefraction->setWaterLevel(mTop);
             mRefraction->setScene(mSceneRoot);
+            mRefraction->setCullQueue(mCullQueue);
             if (mCullCallback)
                 mRefraction->addCullCallback(mCullCallback);
             mParent->addChild(mRefraction);
@@ -548,10 +846,15 @@ void Water::updateWaterMaterial()
 
         showWorld(mShowWorld);
 
+        mSimulation->setUseRippleMap(Settings::Manager::getBool("ripple map", "Water"));
+
         createShaderWaterStateSet(mWaterNode, mReflection, mRefraction);
     }
     else
+    {
+        mSimulation->setUseRippleMap(false);
         createSimpleWaterStateSet(mWaterGeom, Fallback::Map::getFloat("Water_World_Alpha"));
+    }
 
     updateVisible();
 }
@@ -616,10 +919,11 @@ void Water::createSimpleWaterStateSet(osg::Node* node, float alpha)
 class ShaderWaterStateSetUpdater : public SceneUtil::StateSetUpdater
 {
 public:
-    ShaderWaterStateSetUpdater(Water* water, Reflection* reflection, Refraction* refraction, osg::ref_ptr<osg::Program> program, osg::ref_ptr<osg::Texture2D> normalMap)
+    ShaderWaterStateSetUpdater(Water* water, Reflection* reflection, Refraction* refraction, RippleMap* rippleMap, osg::ref_ptr<osg::Program> program, osg::ref_ptr<osg::Texture2D> normalMap)
         : mWater(water)
         , mReflection(reflection)
         , mRefraction(refraction)
+        , mRippleMap(rippleMap)
         , mProgram(program)
         , mNormalMap(normalMap)
     {
@@ -633,6 +937,8 @@ public:
         stateset->setAttributeAndModes(mProgram, osg::StateAttribute::ON);
 
         stateset->addUniform(new osg::Uniform("reflectionMap", 1));
+        if (Reflection::isReprojected())
+            stateset->addUniform(new osg::Uniform("reflectionViewProjection", mReflection->getViewProjectionMatrix()));
         if (mRefraction)
         {
             stateset->addUniform(new osg::Uniform("refractionMap", 2));
@@ -648,12 +954,23 @@ public:
             stateset->setAttributeAndModes(depth, osg::StateAttribute::ON);
         }
         stateset->addUniform(new osg::Uniform("nodePosition", osg::Vec3f(mWater->getPosition())));
+        if (mRippleMap)
+        {
+            stateset->addUniform(new osg::Uniform("rippleMap", 4));
+            stateset->addUniform(new osg::Uniform("rippleMapOrigin", osg::Vec2f()));
+            stateset->addUniform(new osg::Uniform("rippleMapSize", 0.f));
+        }
     }
 
     void apply(osg::StateSet* stateset, osg::NodeVisitor* nv) override
     {
         osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(nv);
         stateset->setTextureAttributeAndModes(1, mReflection->getColorTexture(cv), osg::StateAttribute::ON);
+        if (osg::Uniform* reflectionViewProjection = stateset->getUniform("reflectionViewProjection"))
+        {
+            mReflection->update(cv);
+            reflectionViewProjection->set(mReflection->getViewProjectionMatrix());
+        }
 
         if (mRefraction)
         {
@@ -661,12 +978,22 @@ public:
             stateset->setTextureAttributeAndModes(3, mRefraction->getDepthTexture(cv), osg::StateAttribute::ON);
         }
         stateset->getUniform("nodePosition")->set(osg::Vec3f(mWater->getPosition()));
+
+        if (mRippleMap)
+        {
+            osg::Texture2D* rippleTexture = mRippleMap->getTexture();
+            if (rippleTexture)
+                stateset->setTextureAttributeAndModes(4, rippleTexture, osg::StateAttribute::ON);
+            stateset->getUniform("rippleMapOrigin")->set(mRippleMap->getOrigin());
+            stateset->getUniform("rippleMapSize")->set(rippleTexture ? RippleMap::getSize() : 0.f);
+        }
     }
 
 private:
     Water* mWater;
     Reflection* mReflection;
     Refraction* mRefraction;
+    RippleMap* mRippleMap;
     osg::ref_ptr<osg::Program> mProgram;
     osg::ref_ptr<osg::Texture2D> mNormalMap;
 };
@@ -678,6 +1005,10 @@ void Water::createShaderWaterStateSet(osg::Node* node, Reflection* reflection, R
     defineMap["refraction_enabled"] = std::string(mRefraction ? "1" : "0");
     const auto rippleDetail = std::clamp(Settings::Manager::getInt("rain ripple detail", "Water"), 0, 2);
     defineMap["rain_ripple_detail"] = std::to_string(rippleDetail);
+    defineMap["reflection_reprojection"] = Reflection::isReprojected() ? "1" : "0";
+    RippleMap* rippleMap = mSimulation->getRippleMap();
+    defineMap["ripple_map"] = rippleMap ? "1" : "0";
+    defineMap["rippleMapResolution"] = std::to_string(RippleMap::getResolution());
 
 
     Shader::ShaderManager& shaderMgr = mResourceSystem->getSceneManager()->getShaderManager();
@@ -698,7 +1029,7 @@ void Water::createShaderWaterStateSet(osg::Node* node, Reflection* reflection, R
     mRainIntensityUpdater = new RainIntensityUpdater();
     node->setUpdateCallback(mRainIntensityUpdater);
 
-    mShaderWaterStateSetUpdater = new ShaderWaterStateSetUpdater(this, mReflection, mRefraction, program, normalMap);
+    mShaderWaterStateSetUpdater = new ShaderWaterStateSetUpdater(this, mReflection, mRefraction, rippleMap, program, normalMap);
     node->addCullCallback(mShaderWaterStateSetUpdater);
 }
 
@@ -714,6 +1045,7 @@ Water::~Water()
     if (mReflection)
     {
         mParent->removeChild(mReflection);
+        mParent->removeChild(mReflection->getSkyCubemap());
         mReflection = nullptr;
     }
     if (mRefraction)
@@ -786,6 +1118,19 @@ void Water::update(float dt)
     mSimulation->update(dt);
 }
 
+void Water::addSkyChange(float change)
+{
+    if (mReflection && mReflection->getSkyCubemap())
+        mReflection->getSkyCubemap()->addChange(change);
+}
+
+void Water::setSkyEnabled(bool enabled)
+{
+    mSkyEnabled = enabled;
+    if (mReflection)
+        mReflection->setSkyEnabled(enabled);
+}
+
 void Water::updateVisible()
 {
     bool visible = mEnabled && mToggled;
@@ -29,6 +29,11 @@ namespace Resource
     class ResourceSystem;
 }
 
+namespace SceneUtil
+{
+    class RTTCullQueue;
+}
+
 namespace MWWorld
 {
     class CellStore;
@@ -72,9 +77,11 @@ namespace MWRender
         float mTop;
         bool mInterior;
         bool mShowWorld;
+        bool mSkyEnabled;
 
         osg::Callback* mCullCallback;
         osg::ref_ptr<osg::Callback> mShaderWaterStateSetUpdater;
+        osg::ref_ptr<SceneUtil::RTTCullQueue> mCullQueue;
 
         osg::Vec3f getSceneNodeCoordinates(int gridX, int gridY);
         void updateVisible();
@@ -95,6 +102,10 @@ namespace MWRender
 
         void setCullCallback(osg::Callback* callback);
 
+        /// Cull the reflection and refraction cameras on the workers of the queue.
+        /// @param queue May be nullptr to cull them on the cull thread.
+        void setCullQueue(SceneUtil::RTTCullQueue* queue);
+
         void listAssetsToPreload(std::vector<std::string>& textures);
 
         void setEnabled(bool enabled);
@@ -119,6 +130,12 @@ namespace MWRender
 
         void update(float dt);
 
+        /// Refresh the sky cubemap of the reflection once the sky changed enough, see SkyManager::takeChange.
+        void addSkyChange(float change);
+
+        /// Whether the reflection shows the sky cubemap, mirrors SkyManager::setEnabled.
+        void setSkyEnabled(bool enabled);
+
         osg::Node* getReflectionNode();
         osg::Node* getRefractionNode();
 
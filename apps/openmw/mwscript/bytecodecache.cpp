@@ -0,0 +1,184 @@
+#include "bytecodecache.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/hash.hpp>
+
+namespace MWScript
+{
+    namespace
+    {
+        const char bytecodeCacheMagic[] = {'O', 'M', 'W', 'S', 'C', 'R', 'C', '1'};
+
+        // Longest string accepted while reading, anything longer means the file is broken
+        constexpr std::uint32_t sMaxStringSize = 1 << 16;
+
+        const char localTypes[] = {'s', 'l', 'f'};
+
+        void writeSize(std::ostream& stream, std::size_t size)
+        {
+            const std::uint32_t value = static_cast<std::uint32_t>(size);
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void writeString(std::ostream& stream, const std::string& value)
+        {
+            writeSize(stream, value.size());
+            stream.write(value.data(), value.size());
+        }
+
+        bool readSize(std::istream& stream, std::uint32_t& size, std::uint32_t maxSize)
+        {
+            stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+            return stream && size <= maxSize;
+        }
+
+        bool readString(std::istream& stream, std::string& value)
+        {
+            std::uint32_t size = 0;
+            if (!readSize(stream, size, sMaxStringSize))
+                return false;
+            value.resize(size);
+            stream.read(value.data(), size);
+            return static_cast<bool>(stream);
+        }
+    }
+
+    BytecodeCache::BytecodeCache(const std::string& directory, std::uint64_t key)
+        : mKey(key)
+    {
+        boost::system::error_code error;
+        boost::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to create script cache directory " << directory << ": " << error.message();
+            return;
+        }
+
+        std::ostringstream stream;
+        stream << directory << "/" << std::hex << std::setfill('0') << std::setw(16) << key << ".bin";
+        mPath = stream.str();
+
+        read();
+    }
+
+    bool BytecodeCache::get(const std::string& name, const std::string& source,
+        std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const
+    {
+        const auto found = mScripts.find(name);
+        if (found == mScripts.end() || found->second.mSourceHash != Files::getHash(source))
+            return false;
+        code = found->second.mCode;
+        locals = found->second.mLocals;
+        return true;
+    }
+
+    void BytecodeCache::put(const std::string& name, const std::string& source,
+        const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals)
+    {
+        mScripts[name] = Script {Files::getHash(source), code, locals};
+        mModified = true;
+    }
+
+    void BytecodeCache::write()
+    {
+        if (mPath.empty() || !mModified)
+            return;
+
+        const boost::filesystem::path tempPath = mPath + ".tmp";
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            stream.write(bytecodeCacheMagic, sizeof(bytecodeCacheMagic));
+            stream.write(reinterpret_cast<const char*>(&mKey), sizeof(mKey));
+            writeSize(stream, mScripts.size());
+            for (const auto& [name, script] : mScripts)
+            {
+                writeString(stream, name);
+                stream.write(reinterpret_cast<const char*>(script.mSourceHash.data()), sizeof(script.mSourceHash));
+                writeSize(stream, script.mCode.size());
+                stream.write(reinterpret_cast<const char*>(script.mCode.data()), script.mCode.size() * sizeof(Interpreter::Type_Code));
+                for (char type : localTypes)
+                {
+                    const std::vector<std::string>& names = script.mLocals.get(type);
+                    writeSize(stream, names.size());
+                    for (const std::string& local : names)
+                        writeString(stream, local);
+                }
+            }
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write script cache " << mPath;
+                return;
+            }
+        }
+
+        boost::system::error_code error;
+        boost::filesystem::rename(tempPath, mPath, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to write script cache " << mPath << ": " << error.message();
+            return;
+        }
+        mModified = false;
+    }
+
+    void BytecodeCache::read()
+    {
+        boost::filesystem::ifstream stream(mPath, std::ios::binary);
+        if (!stream)
+            return;
+
+        char magic[sizeof(bytecodeCacheMagic)];
+        std::uint64_t key = 0;
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&key), sizeof(key));
+        if (!stream || !std::equal(magic, magic + sizeof(magic), bytecodeCacheMagic) || key != mKey)
+            return;
+
+        const auto fail = [&]
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid script cache " << mPath;
+            mScripts.clear();
+        };
+
+        std::uint32_t count = 0;
+        if (!readSize(stream, count, UINT32_MAX))
+            return fail();
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            std::string name;
+            Script script;
+            std::uint32_t codeSize = 0;
+            if (!readString(stream, name))
+                return fail();
+            stream.read(reinterpret_cast<char*>(script.mSourceHash.data()), sizeof(script.mSourceHash));
+            if (!readSize(stream, codeSize, sMaxStringSize * 16))
+                return fail();
+            script.mCode.resize(codeSize);
+            stream.read(reinterpret_cast<char*>(script.mCode.data()), codeSize * sizeof(Interpreter::Type_Code));
+            // Compiled code always has its header
+            if (!stream || codeSize < 4)
+                return fail();
+            for (char type : localTypes)
+            {
+                std::uint32_t localCount = 0;
+                if (!readSize(stream, localCount, sMaxStringSize))
+                    return fail();
+                for (std::uint32_t local = 0; local < localCount; ++local)
+                {
+                    std::string localName;
+                    if (!readString(stream, localName))
+                        return fail();
+                    script.mLocals.declare(type, localName);
+                }
+            }
+            mScripts.emplace(std::move(name), std::move(script));
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef GAME_SCRIPT_BYTECODECACHE_H
+#define GAME_SCRIPT_BYTECODECACHE_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <components/compiler/locals.hpp>
+#include <components/interpreter/types.hpp>
+
+namespace MWScript
+{
+    /// \brief Compiled scripts of one set of content files, stored in a file of the cache directory
+    class BytecodeCache
+    {
+        public:
+
+            /// Load the scripts cached for \a key in \a directory, if any.
+            /// \param key Identifies the content files and the compiler that produced the scripts
+            BytecodeCache (const std::string& directory, std::uint64_t key);
+
+            /// Get the code of the script \a name if it was compiled from \a source.
+            bool get (const std::string& name, const std::string& source,
+                std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const;
+
+            void put (const std::string& name, const std::string& source,
+                const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals);
+
+            /// Write the cache file, if scripts were added since it was loaded or last written.
+            void write();
+
+        private:
+
+            struct Script
+            {
+                std::array<std::uint64_t, 2> mSourceHash;
+                std::vector<Interpreter::Type_Code> mCode;
+                Compiler::Locals mLocals;
+            };
+
+            void read();
+
+            std::string mPath;
+            std::uint64_t mKey;
+            std::map<std::string, Script> mScripts;
+            bool mModified = false;
+    };
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <components/esm3/esmwriter.hpp>
 #include <components/esm3/globalscript.hpp>
 
+#include "../mwworld/cellstore.hpp"
 #include "../mwworld/class.hpp"
 #include "../mwworld/esmstore.hpp"
 
@@ -122,6 +123,9 @@ namespace MWScript
     {
         MWWorld::Ptr ptr = boost::apply_visitor(PtrResolvingVisitor(), mTarget);
         mTarget = ptr;
+        // The cached Ptr bypasses the CellStore accessors that keep track of changes
+        if (ptr.isInCell())
+            ptr.getCell()->flagAsChanged();
         return ptr;
     }
 
@@ -8,6 +8,7 @@
 #include <components/compiler/locals.hpp>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 
 #include <components/interpreter/interpreter.hpp>
 #include <components/interpreter/runtime.hpp>
@@ -47,6 +48,7 @@
 
 #include "interpretercontext.hpp"
 #include "ref.hpp"
+#include "scriptprofiler.hpp"
 
 namespace
 {
@@ -1614,6 +1616,59 @@ namespace MWScript
                 }
         };
 
+        class OpToggleScriptProfiler : public Interpreter::Opcode0
+        {
+            public:
+
+                void execute (Interpreter::Runtime& runtime) override
+                {
+                    bool enabled = MWBase::Environment::get().getScriptManager()->getProfiler().toggle();
+
+                    runtime.getContext().report (enabled ? "Script Profiler -> On" : "Script Profiler -> Off");
+                }
+        };
+
+        class OpScriptProfile : public Interpreter::Opcode0
+        {
+            public:
+
+                void execute (Interpreter::Runtime& runtime) override
+                {
+                    const MWScript::ScriptProfiler& profiler = MWBase::Environment::get().getScriptManager()->getProfiler();
+
+                    std::stringstream message;
+                    profiler.report (message, 10);
+                    if (profiler.writeCsv())
+                        message << "\nAll scripts written to " << profiler.getCsvPath();
+                    runtime.getContext().report (message.str());
+                }
+        };
+
+        class OpTraceFrames : public Interpreter::Opcode0
+        {
+            public:
+
+                void execute (Interpreter::Runtime& runtime) override
+                {
+                    Debug::Tracer& tracer = Debug::Tracer::instance();
+
+                    if (!tracer.isEnabled())
+                    {
+                        tracer.setMaxFrames (sDefaultTraceFrames);
+                        tracer.enable();
+                        runtime.getContext().report ("Recording the last " + std::to_string (sDefaultTraceFrames)
+                            + " frames, use TraceFrames again to write them");
+                        return;
+                    }
+
+                    const std::string filename = MWBase::Environment::get().getWorld()->writeFrameTrace();
+                    runtime.getContext().report ("Frame trace written to " + filename);
+                }
+
+            private:
+                static constexpr std::size_t sDefaultTraceFrames = 300;
+        };
+
         void installOpcodes (Interpreter::Interpreter& interpreter)
         {
             interpreter.installSegment5<OpMenuMode>(Compiler::Misc::opcodeMenuMode);
@@ -1735,6 +1790,9 @@ namespace MWScript
             interpreter.installSegment5<OpToggleRecastMesh>(Compiler::Misc::opcodeToggleRecastMesh);
             interpreter.installSegment5<OpHelp>(Compiler::Misc::opcodeHelp);
             interpreter.installSegment5<OpReloadLua>(Compiler::Misc::opcodeReloadLua);
+            interpreter.installSegment5<OpToggleScriptProfiler>(Compiler::Misc::opcodeToggleScriptProfiler);
+            interpreter.installSegment5<OpScriptProfile>(Compiler::Misc::opcodeScriptProfile);
+            interpreter.installSegment5<OpTraceFrames>(Compiler::Misc::opcodeTraceFrames);
         }
     }
 }
@@ -1,14 +1,18 @@
 #include "scriptmanagerimp.hpp"
 
 #include <cassert>
+#include <atomic>
+#include <chrono>
 #include <sstream>
 #include <exception>
 #include <algorithm>
+#include <thread>
 
 #include <components/debug/debuglog.hpp>
 
 #include <components/esm3/loadscpt.hpp>
 
+#include <components/misc/hash.hpp>
 #include <components/misc/stringops.hpp>
 
 #include <components/compiler/scanner.hpp>
@@ -18,9 +22,16 @@
 
 #include "../mwworld/esmstore.hpp"
 
+#include "bytecodecache.hpp"
 #include "extensions.hpp"
 #include "interpretercontext.hpp"
 
+namespace
+{
+    // Has to be increased on any change of the code the compiler generates
+    constexpr int sBytecodeFormat = 1;
+}
+
 namespace MWScript
 {
     ScriptManager::ScriptManager (const MWWorld::ESMStore& store,
@@ -28,7 +39,7 @@ namespace MWScript
         const std::vector<std::string>& scriptBlacklist)
     : mErrorHandler(), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mWarningsMode (warningsMode), mGlobalScripts (store)
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -39,6 +50,20 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
+    ScriptManager::~ScriptManager()
+    {
+        if (mBytecodeCache)
+            mBytecodeCache->write();
+    }
+
+    void ScriptManager::setBytecodeCache (const std::string& directory, std::uint64_t contentKey)
+    {
+        std::uint64_t key = contentKey;
+        Misc::hashCombine (key, sBytecodeFormat);
+        Misc::hashCombine (key, mCompilerContext.getExtensions()->getHash());
+        mBytecodeCache = std::make_unique<BytecodeCache> (directory, key);
+    }
+
     bool ScriptManager::compile (const std::string& name)
     {
         mParser.reset();
@@ -46,6 +71,18 @@ namespace MWScript
 
         if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
         {
+            const std::string cacheName = Misc::StringUtils::lowerCase (name);
+            if (mBytecodeCache)
+            {
+                std::vector<Interpreter::Type_Code> code;
+                Compiler::Locals locals;
+                if (mBytecodeCache->get (cacheName, script->mScriptText, code, locals))
+                {
+                    mScripts.emplace (name, CompiledScript (code, locals));
+                    return true;
+                }
+            }
+
             mErrorHandler.setContext(name);
 
             bool Success = true;
@@ -81,6 +118,8 @@ namespace MWScript
                 std::vector<Interpreter::Type_Code> code;
                 mParser.getCode(code);
                 mScripts.emplace(name, CompiledScript(code, mParser.getLocals()));
+                if (mBytecodeCache)
+                    mBytecodeCache->put (cacheName, script->mScriptText, code, mParser.getLocals());
 
                 return true;
             }
@@ -119,7 +158,22 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.mByteCode[0], iter->second.mByteCode.size(), interpreterContext);
+                CompiledScript& script = iter->second;
+                if (script.mInstructions.size() != script.mByteCode[0])
+                    script.mInstructions = mInterpreter.decode (&script.mByteCode[0], script.mByteCode.size());
+
+                if (!mProfiler.isEnabled())
+                {
+                    mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(), script.mInstructions, interpreterContext);
+                    return true;
+                }
+
+                // Scripts run from within this one are included in its time
+                const auto start = std::chrono::steady_clock::now();
+                const std::uint64_t instructions = mInterpreter.getInstructionCount();
+                mInterpreter.run (&script.mByteCode[0], script.mByteCode.size(), script.mInstructions, interpreterContext);
+                const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+                mProfiler.record (name, time.count(), mInterpreter.getInstructionCount() - instructions);
                 return true;
             }
             catch (const MissingImplicitRefError& e)
@@ -147,28 +201,112 @@ namespace MWScript
 
     std::pair<int, int> ScriptManager::compileAll()
     {
-        int count = 0;
-        int success = 0;
-
+        struct Job
+        {
+            const ESM::Script* mScript;
+            std::string mCacheName;
+            bool mCached = false;
+            bool mSuccess = false;
+            std::vector<Interpreter::Type_Code> mCode;
+            Compiler::Locals mLocals;
+            Compiler::StreamErrorHandler::Messages mMessages;
+        };
+
+        std::vector<Job> jobs;
         for (auto& script : mStore.get<ESM::Script>())
         {
-            if (!std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(),
-                Misc::StringUtils::lowerCase(script.mId)))
+            std::string cacheName = Misc::StringUtils::lowerCase(script.mId);
+            if (std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(), cacheName))
+                continue;
+
+            Job& job = jobs.emplace_back();
+            job.mScript = &script;
+            job.mCacheName = std::move(cacheName);
+            if (mBytecodeCache)
+                job.mCached = job.mSuccess = mBytecodeCache->get (job.mCacheName, script.mScriptText, job.mCode, job.mLocals);
+        }
+
+        // Each thread has its own parser, the context only reads the store and the locals of other scripts
+        std::atomic<std::size_t> next {0};
+        const auto work = [&]
+        {
+            Compiler::StreamErrorHandler errorHandler;
+            errorHandler.setWarningsMode (mWarningsMode);
+            Compiler::FileParser parser (errorHandler, mCompilerContext);
+
+            for (std::size_t i = next++; i < jobs.size(); i = next++)
             {
-                ++count;
+                Job& job = jobs[i];
+                if (job.mCached)
+                    continue;
 
-                if (compile(script.mId))
-                    ++success;
+                parser.reset();
+                errorHandler.reset();
+                errorHandler.setContext (job.mScript->mId);
+                errorHandler.setBuffer (&job.mMessages);
+
+                try
+                {
+                    std::istringstream input (job.mScript->mScriptText);
+                    Compiler::Scanner scanner (errorHandler, input, mCompilerContext.getExtensions());
+                    scanner.scan (parser);
+                    job.mSuccess = errorHandler.isGood();
+                }
+                catch (const Compiler::SourceException&)
+                {
+                    // error has already been reported via error handler
+                }
+                catch (const std::exception& error)
+                {
+                    job.mMessages.emplace_back(Debug::Error, std::string("Error: An exception has been thrown: ") + error.what());
+                }
+
+                if (job.mSuccess)
+                {
+                    parser.getCode (job.mCode);
+                    job.mLocals = parser.getLocals();
+                }
+            }
+        };
+
+        const std::size_t threads = std::min<std::size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < threads; ++i)
+            workers.emplace_back(work);
+        work();
+        for (std::thread& worker : workers)
+            worker.join();
+
+        int success = 0;
+        for (Job& job : jobs)
+        {
+            for (const auto& [level, message] : job.mMessages)
+                Log(level) << message;
+
+            if (!job.mSuccess)
+            {
+                Log(Debug::Error) << "Error: script compiling failed: " << job.mScript->mId;
+                continue;
             }
+
+            ++success;
+            if (mBytecodeCache && !job.mCached)
+                mBytecodeCache->put (job.mCacheName, job.mScript->mScriptText, job.mCode, job.mLocals);
+            mScripts.emplace (job.mScript->mId, CompiledScript (job.mCode, job.mLocals));
         }
 
-        return std::make_pair (count, success);
+        if (mBytecodeCache)
+            mBytecodeCache->write();
+
+        return std::make_pair (static_cast<int>(jobs.size()), success);
     }
 
     const Compiler::Locals& ScriptManager::getLocals (const std::string& name)
     {
         std::string name2 = Misc::StringUtils::lowerCase (name);
 
+        const std::lock_guard<std::recursive_mutex> lock(mLocalsMutex);
+
         {
             auto iter = mScripts.find (name2);
 
@@ -215,11 +353,24 @@ namespace MWScript
         throw std::logic_error ("script " + name + " does not exist");
     }
 
+    std::optional<Compiler::EventGate> ScriptManager::getEventGate (const std::string& name) const
+    {
+        ScriptCollection::const_iterator iter = mScripts.find (name);
+        if (iter == mScripts.end())
+            return {};
+        return iter->second.mEventGate;
+    }
+
     GlobalScripts& ScriptManager::getGlobalScripts()
     {
         return mGlobalScripts;
     }
 
+    ScriptProfiler& ScriptManager::getProfiler()
+    {
+        return mProfiler;
+    }
+
     const Compiler::Extensions& ScriptManager::getExtensions() const
     {
         return *mCompilerContext.getExtensions();
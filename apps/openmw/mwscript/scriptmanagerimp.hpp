@@ -1,10 +1,14 @@
 #ifndef GAME_SCRIPT_SCRIPTMANAGER_H
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
+#include <components/compiler/eventgate.hpp>
 #include <components/compiler/streamerrorhandler.hpp>
 #include <components/compiler/fileparser.hpp>
 
@@ -14,6 +18,7 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "globalscripts.hpp"
+#include "scriptprofiler.hpp"
 
 namespace MWWorld
 {
@@ -33,6 +38,8 @@ namespace Interpreter
 
 namespace MWScript
 {
+    class BytecodeCache;
+
     class ScriptManager : public MWBase::ScriptManager
     {
             Compiler::StreamErrorHandler mErrorHandler;
@@ -41,15 +48,19 @@ namespace MWScript
             Compiler::FileParser mParser;
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
+            int mWarningsMode;
 
             struct CompiledScript
             {
                 std::vector<Interpreter::Type_Code> mByteCode;
+                // Decoded on the first run
+                std::vector<Interpreter::Instruction> mInstructions;
                 Compiler::Locals mLocals;
                 std::set<std::string> mInactive;
+                Compiler::EventGate mEventGate;
 
                 CompiledScript(const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals):
-                    mByteCode(code), mLocals(locals)
+                    mByteCode(code), mLocals(locals), mEventGate(Compiler::getEventGate(code))
                 {}
             };
 
@@ -58,7 +69,11 @@ namespace MWScript
             ScriptCollection mScripts;
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
+            // compileAll looks up the locals of other scripts from several threads
+            std::recursive_mutex mLocalsMutex;
             std::vector<std::string> mScriptBlacklist;
+            std::unique_ptr<BytecodeCache> mBytecodeCache;
+            ScriptProfiler mProfiler;
 
         public:
 
@@ -66,6 +81,12 @@ namespace MWScript
                 Compiler::Context& compilerContext, int warningsMode,
                 const std::vector<std::string>& scriptBlacklist);
 
+            ~ScriptManager() override;
+
+            void setBytecodeCache (const std::string& directory, std::uint64_t contentKey);
+            ///< Store compiled scripts in \a directory and reuse them while \a contentKey and the extensions
+            /// stay the same. \a contentKey has to identify the loaded content files.
+
             void clear() override;
 
             bool run (const std::string& name, Interpreter::Context& interpreterContext) override;
@@ -76,14 +97,19 @@ namespace MWScript
             /// \return Success?
 
             std::pair<int, int> compileAll() override;
-            ///< Compile all scripts
+            ///< Compile all scripts, on as many threads as there are cores. Errors are logged in the order of the scripts.
             /// \return count, success
 
             const Compiler::Locals& getLocals (const std::string& name) override;
             ///< Return locals for script \a name.
 
+            std::optional<Compiler::EventGate> getEventGate (const std::string& name) const override;
+            ///< Return the condition script \a name is gated on, if it has been compiled already.
+
             GlobalScripts& getGlobalScripts() override;
 
+            ScriptProfiler& getProfiler() override;
+
             const Compiler::Extensions& getExtensions() const override;
     };
 }
@@ -0,0 +1,87 @@
+#include "scriptprofiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <components/debug/debuglog.hpp>
+
+namespace MWScript
+{
+    void ScriptProfiler::setEnabled (bool enabled)
+    {
+        if (enabled && !mEnabled)
+            mStats.clear();
+        mEnabled = enabled;
+    }
+
+    bool ScriptProfiler::toggle()
+    {
+        setEnabled (!mEnabled);
+        return mEnabled;
+    }
+
+    void ScriptProfiler::record (const std::string& name, double time, std::uint64_t instructions)
+    {
+        auto it = mStats.find (name);
+        if (it == mStats.end())
+        {
+            it = mStats.emplace (name, Stats()).first;
+            it->second.mName = name;
+        }
+
+        Stats& stats = it->second;
+        ++stats.mCalls;
+        stats.mTotalTime += time;
+        stats.mMaxTime = std::max (stats.mMaxTime, time);
+        stats.mInstructions += instructions;
+    }
+
+    std::vector<ScriptProfiler::Stats> ScriptProfiler::getStats() const
+    {
+        std::vector<Stats> result;
+        result.reserve (mStats.size());
+        for (const auto& [name, stats] : mStats)
+            result.push_back (stats);
+        std::sort (result.begin(), result.end(),
+            [] (const Stats& left, const Stats& right) { return left.mTotalTime > right.mTotalTime; });
+        return result;
+    }
+
+    void ScriptProfiler::report (std::ostream& stream, std::size_t count) const
+    {
+        const std::vector<Stats> stats = getStats();
+        stream << std::left << std::setw(32) << "Script" << std::right
+               << std::setw(10) << "Calls" << std::setw(12) << "Total (ms)" << std::setw(10) << "Max (ms)"
+               << std::setw(14) << "Instructions" << '\n';
+        for (std::size_t i = 0; i < std::min (count, stats.size()); ++i)
+        {
+            stream << std::left << std::setw(32) << stats[i].mName << std::right << std::fixed << std::setprecision(3)
+                   << std::setw(10) << stats[i].mCalls << std::setw(12) << stats[i].mTotalTime * 1000
+                   << std::setw(10) << stats[i].mMaxTime * 1000 << std::setw(14) << stats[i].mInstructions << '\n';
+        }
+    }
+
+    bool ScriptProfiler::writeCsv() const
+    {
+        if (mCsvPath.empty())
+            return false;
+
+        boost::filesystem::ofstream stream (mCsvPath);
+        stream << "Script,Calls,Total time (ms),Max time (ms),Instructions\n";
+        stream << std::fixed << std::setprecision(6);
+        for (const Stats& stats : getStats())
+        {
+            stream << '"' << stats.mName << "\"," << stats.mCalls << ',' << stats.mTotalTime * 1000 << ','
+                   << stats.mMaxTime * 1000 << ',' << stats.mInstructions << '\n';
+        }
+
+        if (!stream)
+        {
+            Log(Debug::Warning) << "Warning: Unable to write script profile " << mCsvPath;
+            return false;
+        }
+        return true;
+    }
+}
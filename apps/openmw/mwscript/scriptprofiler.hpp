@@ -0,0 +1,58 @@
+#ifndef GAME_SCRIPT_SCRIPTPROFILER_H
+#define GAME_SCRIPT_SCRIPTPROFILER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MWScript
+{
+    /// \brief Time spent in each script, collected while the profiler is enabled
+    class ScriptProfiler
+    {
+        public:
+
+            struct Stats
+            {
+                std::string mName;
+                std::uint64_t mCalls = 0;
+                // In seconds
+                double mTotalTime = 0;
+                double mMaxTime = 0;
+                std::uint64_t mInstructions = 0;
+            };
+
+            bool isEnabled() const { return mEnabled; }
+
+            void setEnabled (bool enabled);
+            ///< Enabling the profiler discards the stats collected before.
+
+            bool toggle();
+            ///< \return Is the profiler enabled now?
+
+            void record (const std::string& name, double time, std::uint64_t instructions);
+
+            std::vector<Stats> getStats() const;
+            ///< Sorted by total time, the most expensive script first.
+
+            void report (std::ostream& stream, std::size_t count) const;
+            ///< Print a table of the \a count most expensive scripts.
+
+            void setCsvPath (const std::string& path) { mCsvPath = path; }
+
+            const std::string& getCsvPath() const { return mCsvPath; }
+
+            bool writeCsv() const;
+            ///< Write the stats of all scripts to the CSV path.
+
+        private:
+
+            bool mEnabled = false;
+            std::unordered_map<std::string, Stats> mStats;
+            std::string mCsvPath;
+    };
+}
+
+#endif
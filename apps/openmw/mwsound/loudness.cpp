@@ -9,9 +9,9 @@
 namespace MWSound
 {
 
-void Sound_Loudness::analyzeLoudness(const std::vector< char >& data)
+void Sound_Loudness::analyzeLoudness(const char* data, std::size_t size)
 {
-    mQueue.insert( mQueue.end(), data.begin(), data.end() );
+    mQueue.insert( mQueue.end(), data, data + size );
     if (!mQueue.size())
         return;
 
@@ -68,4 +68,35 @@ float Sound_Loudness::getLoudnessAtTime(float sec) const
     return mSamples[index];
 }
 
+
+std::shared_ptr<const Sound_Loudness> Sound_LoudnessCache::get(const std::string& name)
+{
+    const auto it = mIndex.find(name);
+    if (it == mIndex.end())
+        return nullptr;
+
+    mEntries.splice(mEntries.begin(), mEntries, it->second);
+    return it->second->second;
+}
+
+void Sound_LoudnessCache::insert(const std::string& name, std::shared_ptr<const Sound_Loudness> loudness)
+{
+    const auto it = mIndex.find(name);
+    if (it != mIndex.end())
+    {
+        it->second->second = std::move(loudness);
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return;
+    }
+
+    if (mEntries.size() >= mMaxSize && !mEntries.empty())
+    {
+        mIndex.erase(mEntries.back().first);
+        mEntries.pop_back();
+    }
+
+    mEntries.emplace_front(name, std::move(loudness));
+    mIndex.emplace(name, mEntries.begin());
+}
+
 }
@@ -3,6 +3,10 @@
 
 #include <vector>
 #include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 #include "sound_decoder.hpp"
 
@@ -43,8 +47,9 @@ public:
      * If the size of \a data does not exactly fit a number of loudness samples, the remainder
      * will be kept in the mQueue and used in the next call to analyzeLoudness.
      * @param data the sound buffer to analyze, containing raw samples
+     * @param size the size of \a data in bytes
      */
-    void analyzeLoudness(const std::vector<char>& data);
+    void analyzeLoudness(const char* data, std::size_t size);
 
     /**
      * Get loudness at a particular time. Before calling this, the stream has to be analyzed up to that point in time (see analyzeLoudness()).
@@ -52,6 +57,26 @@ public:
     float getLoudnessAtTime(float sec) const;
 };
 
+/// Keeps the loudness of the most recently played sounds, so they don't have to be analyzed again.
+class Sound_LoudnessCache {
+    typedef std::pair<std::string, std::shared_ptr<const Sound_Loudness>> Entry;
+
+    std::size_t mMaxSize;
+
+    // NOTE: entries are stored in front-newest order.
+    std::list<Entry> mEntries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+
+public:
+    explicit Sound_LoudnessCache(std::size_t maxSize) : mMaxSize(maxSize) { }
+
+    /// @return the loudness of a completely analyzed sound, or nullptr if it is not cached.
+    std::shared_ptr<const Sound_Loudness> get(const std::string& name);
+
+    /// @param loudness the loudness of the whole sound, evicts the least recently used one if the cache is full
+    void insert(const std::string& name, std::shared_ptr<const Sound_Loudness> loudness);
+};
+
 }
 
 #endif /* GAME_SOUND_LOUDNESS_H */
@@ -35,6 +35,7 @@ namespace
 {
 
 const int sLoudnessFPS = 20; // loudness values per second of audio
+const std::size_t sLoudnessCacheSize = 256; // voices whose loudness is kept after they finish
 
 ALCenum checkALCError(ALCdevice *device, const char *func, int line)
 {
@@ -274,11 +275,20 @@ private:
     ALuint mFrameSize;
     ALint mSilence;
 
+    // Decoded audio for the whole buffer queue, allocated once and reused for every refill
+    std::vector<char> mData;
+
     DecoderPtr mDecoder;
 
-    std::unique_ptr<Sound_Loudness> mLoudnessAnalyzer;
+    // The loudness used for lip sync, either cached or being analyzed by mLoudnessAnalyzer
+    std::shared_ptr<const Sound_Loudness> mLoudness;
+    std::shared_ptr<Sound_Loudness> mLoudnessAnalyzer;
+    // The whole stream was decoded, so the analyzed loudness is complete
+    bool mDecodedAll;
 
     std::atomic<bool> mIsFinished;
+    // The source was played, so it stopping before the end is an underrun
+    bool mStarted;
 
     void updateAll(bool local);
 
@@ -291,7 +301,7 @@ public:
     OpenAL_SoundStream(ALuint src, DecoderPtr decoder);
     ~OpenAL_SoundStream();
 
-    bool init(bool getLoudnessData=false);
+    bool init(bool getLoudnessData=false, std::shared_ptr<const Sound_Loudness> loudness=nullptr);
 
     bool isPlaying();
     double getStreamDelay() const;
@@ -299,7 +309,7 @@ public:
 
     float getCurrentLoudness() const;
 
-    bool process();
+    bool process(std::atomic<std::size_t>& underruns);
     ALint refillQueue();
 };
 const ALfloat OpenAL_SoundStream::sBufferLength = 0.125f;
@@ -314,12 +324,14 @@ struct OpenAL_Output::StreamThread
     StreamVec mStreams;
 
     std::atomic<bool> mQuitNow;
+    std::atomic<std::size_t> mUnderruns;
     std::mutex mMutex;
     std::condition_variable mCondVar;
     std::thread mThread;
 
     StreamThread()
       : mQuitNow(false)
+      , mUnderruns(0)
       , mThread([this] { run(); })
     {
     }
@@ -340,7 +352,7 @@ struct OpenAL_Output::StreamThread
             StreamVec::iterator iter = mStreams.begin();
             while(iter != mStreams.end())
             {
-                if((*iter)->process() == false)
+                if((*iter)->process(mUnderruns) == false)
                     iter = mStreams.erase(iter);
                 else
                     ++iter;
@@ -382,7 +394,7 @@ private:
 OpenAL_SoundStream::OpenAL_SoundStream(ALuint src, DecoderPtr decoder)
   : mSource(src), mCurrentBufIdx(0), mFormat(AL_NONE), mSampleRate(0)
   , mBufferSize(0), mFrameSize(0), mSilence(0), mDecoder(std::move(decoder))
-  , mLoudnessAnalyzer(nullptr), mIsFinished(true)
+  , mDecodedAll(false), mIsFinished(true), mStarted(false)
 {
     mBuffers.fill(0);
 }
@@ -396,7 +408,7 @@ OpenAL_SoundStream::~OpenAL_SoundStream()
     mDecoder->close();
 }
 
-bool OpenAL_SoundStream::init(bool getLoudnessData)
+bool OpenAL_SoundStream::init(bool getLoudnessData, std::shared_ptr<const Sound_Loudness> loudness)
 {
     alGenBuffers(mBuffers.size(), mBuffers.data());
     ALenum err = getALError();
@@ -426,9 +438,15 @@ bool OpenAL_SoundStream::init(bool getLoudnessData)
     mFrameSize = framesToBytes(1, chans, type);
     mBufferSize = static_cast<ALuint>(sBufferLength*mSampleRate);
     mBufferSize *= mFrameSize;
+    mData.resize(mBufferSize * mBuffers.size());
 
-    if (getLoudnessData)
-        mLoudnessAnalyzer.reset(new Sound_Loudness(sLoudnessFPS, mSampleRate, chans, type));
+    if (loudness)
+        mLoudness = std::move(loudness);
+    else if (getLoudnessData)
+    {
+        mLoudnessAnalyzer = std::make_shared<Sound_Loudness>(sLoudnessFPS, mSampleRate, chans, type);
+        mLoudness = mLoudnessAnalyzer;
+    }
 
     mIsFinished = false;
     return true;
@@ -494,14 +512,14 @@ double OpenAL_SoundStream::getStreamOffset() const
 
 float OpenAL_SoundStream::getCurrentLoudness() const
 {
-    if (!mLoudnessAnalyzer.get())
+    if (!mLoudness)
         return 0.f;
 
     float time = getStreamOffset();
-    return mLoudnessAnalyzer->getLoudnessAtTime(time);
+    return mLoudness->getLoudnessAtTime(time);
 }
 
-bool OpenAL_SoundStream::process()
+bool OpenAL_SoundStream::process(std::atomic<std::size_t>& underruns)
 {
     try {
         if(refillQueue() > 0)
@@ -513,6 +531,9 @@ bool OpenAL_SoundStream::process()
                 // Ensure all processed buffers are removed so we don't replay them.
                 refillQueue();
 
+                if(mStarted)
+                    ++underruns;
+                mStarted = true;
                 alSourcePlay(mSource);
             }
         }
@@ -539,24 +560,30 @@ ALint OpenAL_SoundStream::refillQueue()
     alGetSourcei(mSource, AL_BUFFERS_QUEUED, &queued);
     if(!mIsFinished && (ALuint)queued < mBuffers.size())
     {
-        std::vector<char> data(mBufferSize);
-        for(;!mIsFinished && (ALuint)queued < mBuffers.size();++queued)
+        // Decode all the free buffers in one batch, so the decoder isn't restarted for every buffer
+        const size_t wanted = (mBuffers.size() - queued) * mBufferSize;
+        size_t got = mDecoder->read(mData.data(), wanted);
+        if(got < wanted)
         {
-            size_t got = mDecoder->read(data.data(), data.size());
-            if(got < data.size())
-            {
-                mIsFinished = true;
-                std::fill(data.begin()+got, data.end(), mSilence);
-            }
-            if(got > 0)
-            {
-                if (mLoudnessAnalyzer.get())
-                    mLoudnessAnalyzer->analyzeLoudness(data);
+            mIsFinished = true;
+            mDecodedAll = true;
+            // Pad the last partial buffer with silence
+            const size_t padded = std::min((got + mBufferSize - 1) / mBufferSize * mBufferSize, wanted);
+            std::fill(mData.begin()+got, mData.begin()+padded, mSilence);
+            got = padded;
+        }
+        if(got > 0)
+        {
+            if (mLoudnessAnalyzer.get())
+                mLoudnessAnalyzer->analyzeLoudness(mData.data(), got);
 
+            for(size_t offset = 0;offset < got;offset += mBufferSize)
+            {
                 ALuint bufid = mBuffers[mCurrentBufIdx];
-                alBufferData(bufid, mFormat, data.data(), data.size(), mSampleRate);
+                alBufferData(bufid, mFormat, mData.data() + offset, mBufferSize, mSampleRate);
                 alSourceQueueBuffers(mSource, 1, &bufid);
                 mCurrentBufIdx = (mCurrentBufIdx+1) % mBuffers.size();
+                ++queued;
             }
         }
     }
@@ -722,6 +749,7 @@ bool OpenAL_Output::init(const std::string &devname, const std::string &hrtfname
         return false;
     }
     Log(Debug::Info) << "Allocated " << mFreeSources.size() << " sound sources";
+    mSourceCount = mFreeSources.size();
 
     if(ALC.EXT_EFX)
     {
@@ -836,6 +864,7 @@ void OpenAL_Output::deinit()
     for(ALuint source : mFreeSources)
         alDeleteSources(1, &source);
     mFreeSources.clear();
+    mSourceCount = 0;
 
     if(mEffectSlot)
         alDeleteAuxiliaryEffectSlots(1, &mEffectSlot);
@@ -943,31 +972,36 @@ void OpenAL_Output::setHrtf(const std::string &hrtfname, HrtfMode hrtfmode)
 }
 
 
-std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const std::string &fname)
+DecodedSound OpenAL_Output::decodeSound(const std::string &fname)
 {
-    getALError();
-
-    std::vector<char> data;
-    ALenum format = AL_NONE;
-    int srate = 0;
+    DecodedSound sound;
 
     try
     {
         DecoderPtr decoder = mManager.getDecoder();
         decoder->open(Misc::ResourceHelpers::correctSoundPath(fname, decoder->mResourceMgr));
 
-        ChannelConfig chans;
-        SampleType type;
-        decoder->getInfo(&srate, &chans, &type);
-        format = getALFormat(chans, type);
-        if(format) decoder->readAll(data);
+        decoder->getInfo(&sound.mSampleRate, &sound.mChannels, &sound.mType);
+        decoder->readAll(sound.mData);
     }
     catch(std::exception &e)
     {
         Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
+        sound.mData.clear();
     }
 
-    if(data.empty())
+    return sound;
+}
+
+std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(DecodedSound&& sound)
+{
+    getALError();
+
+    std::vector<char> data = std::move(sound.mData);
+    int srate = sound.mSampleRate;
+    ALenum format = data.empty() ? AL_NONE : getALFormat(sound.mChannels, sound.mType);
+
+    if(format == AL_NONE)
     {
         // If we failed to get any usable audio, substitute with silence.
         format = AL_FORMAT_MONO8;
@@ -1115,11 +1149,48 @@ void OpenAL_Output::updateCommon(ALuint source, const osg::Vec3f& pos, ALfloat m
 }
 
 
+float OpenAL_Output::getAudibility(const SoundBase &sound) const
+{
+    const float gain = sound.getRealVolume();
+    if(!sound.getIs3D())
+        return gain;
+
+    // Matches AL_INVERSE_DISTANCE_CLAMPED with a rolloff factor of 1
+    const float minDist = sound.getMinDistance();
+    const float dist = std::max(std::min((sound.getPosition() - mListenerPos).length(), sound.getMaxDistance()), minDist);
+    return dist > 0.0f ? gain * minDist / dist : gain;
+}
+
+bool OpenAL_Output::stealSource(const SoundBase &sound)
+{
+    // Looping sounds are not restarted once stopped, so only one-shot sounds are given up
+    Sound *victim = nullptr;
+    float victimAudibility = getAudibility(sound);
+    for(Sound *active : mActiveSounds)
+    {
+        if(active->getIsLooping())
+            continue;
+        const float audibility = getAudibility(*active);
+        if(audibility < victimAudibility)
+        {
+            victim = active;
+            victimAudibility = audibility;
+        }
+    }
+    if(!victim)
+        return false;
+
+    // The sound manager drops the sound on its next update, as it's no longer playing
+    finishSound(victim);
+    ++mStolenSources;
+    return true;
+}
+
 bool OpenAL_Output::playSound(Sound *sound, Sound_Handle data, float offset)
 {
     ALuint source;
 
-    if(mFreeSources.empty())
+    if(mFreeSources.empty() && !stealSource(*sound))
     {
         Log(Debug::Warning) << "No free sources!";
         return false;
@@ -1158,7 +1229,7 @@ bool OpenAL_Output::playSound3D(Sound *sound, Sound_Handle data, float offset)
 {
     ALuint source;
 
-    if(mFreeSources.empty())
+    if(mFreeSources.empty() && !stealSource(*sound))
     {
         Log(Debug::Warning) << "No free sources!";
         return false;
@@ -1235,7 +1306,7 @@ void OpenAL_Output::updateSound(Sound *sound)
 
 bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudnessData)
 {
-    if(mFreeSources.empty())
+    if(mFreeSources.empty() && !stealSource(*sound))
     {
         Log(Debug::Warning) << "No free sources!";
         return false;
@@ -1250,8 +1321,12 @@ bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudn
     if(getALError() != AL_NO_ERROR)
         return false;
 
+    std::shared_ptr<const Sound_Loudness> loudness;
+    if(getLoudnessData)
+        loudness = mLoudnessCache.get(decoder->getName());
+
     OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder));
-    if(!stream->init(getLoudnessData))
+    if(!stream->init(getLoudnessData, std::move(loudness)))
     {
         delete stream;
         return false;
@@ -1266,7 +1341,7 @@ bool OpenAL_Output::streamSound(DecoderPtr decoder, Stream *sound, bool getLoudn
 
 bool OpenAL_Output::streamSound3D(DecoderPtr decoder, Stream *sound, bool getLoudnessData)
 {
-    if(mFreeSources.empty())
+    if(mFreeSources.empty() && !stealSource(*sound))
     {
         Log(Debug::Warning) << "No free sources!";
         return false;
@@ -1281,8 +1356,12 @@ bool OpenAL_Output::streamSound3D(DecoderPtr decoder, Stream *sound, bool getLou
     if(getALError() != AL_NO_ERROR)
         return false;
 
+    std::shared_ptr<const Sound_Loudness> loudness;
+    if(getLoudnessData)
+        loudness = mLoudnessCache.get(decoder->getName());
+
     OpenAL_SoundStream *stream = new OpenAL_SoundStream(source, std::move(decoder));
-    if(!stream->init(getLoudnessData))
+    if(!stream->init(getLoudnessData, std::move(loudness)))
     {
         delete stream;
         return false;
@@ -1304,6 +1383,9 @@ void OpenAL_Output::finishStream(Stream *sound)
     sound->mHandle = nullptr;
     mStreamThread->remove(stream);
 
+    if(stream->mLoudnessAnalyzer && stream->mDecodedAll)
+        mLoudnessCache.insert(stream->mDecoder->getName(), std::move(stream->mLoudnessAnalyzer));
+
     // Rewind the stream to put the source back into an AL_INITIAL state, for
     // the next time it's used.
     alSourceRewind(source);
@@ -1472,6 +1554,14 @@ void OpenAL_Output::resumeActiveDevice()
     alListenerf(AL_GAIN, 1.0f);
 }
 
+void OpenAL_Output::getStats(SoundStats& stats) const
+{
+    stats.mSources = mSourceCount - mFreeSources.size();
+    stats.mStolenSources = mStolenSources;
+    stats.mStreams = mActiveStreams.size();
+    stats.mStreamUnderruns = mStreamThread->mUnderruns;
+}
+
 void OpenAL_Output::resumeSounds(int types)
 {
     std::vector<ALuint> sources;
@@ -1502,6 +1592,7 @@ OpenAL_Output::OpenAL_Output(SoundManager &mgr)
   , mListenerPos(0.0f, 0.0f, 0.0f), mListenerEnv(Env_Normal)
   , mWaterFilter(0), mWaterEffect(0), mDefaultEffect(0), mEffectSlot(0)
   , mStreamThread(new StreamThread)
+  , mLoudnessCache(sLoudnessCacheSize)
 {
 }
 
@@ -11,10 +11,12 @@
 #include "alext.h"
 
 #include "sound_output.hpp"
+#include "loudness.hpp"
 
 namespace MWSound
 {
     class SoundManager;
+    class SoundBase;
     class Sound;
     class Stream;
 
@@ -50,11 +52,21 @@ namespace MWSound
         struct StreamThread;
         std::unique_ptr<StreamThread> mStreamThread;
 
+        // Loudness of the voices that played to the end, for lip sync when they are said again
+        Sound_LoudnessCache mLoudnessCache;
+
+        std::size_t mSourceCount = 0;
+        std::size_t mStolenSources = 0;
+
         void initCommon2D(ALuint source, const osg::Vec3f &pos, ALfloat gain, ALfloat pitch, bool loop, bool useenv);
         void initCommon3D(ALuint source, const osg::Vec3f &pos, ALfloat mindist, ALfloat maxdist, ALfloat gain, ALfloat pitch, bool loop, bool useenv);
 
         void updateCommon(ALuint source, const osg::Vec3f &pos, ALfloat maxdist, ALfloat gain, ALfloat pitch, bool useenv);
 
+        float getAudibility(const SoundBase &sound) const;
+        /// Free the source of the least audible sound if it is less audible than \a sound.
+        bool stealSource(const SoundBase &sound);
+
         OpenAL_Output& operator=(const OpenAL_Output &rhs);
         OpenAL_Output(const OpenAL_Output &rhs);
 
@@ -66,7 +78,8 @@ namespace MWSound
         std::vector<std::string> enumerateHrtf() override;
         void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) override;
 
-        std::pair<Sound_Handle,size_t> loadSound(const std::string &fname) override;
+        DecodedSound decodeSound(const std::string &fname) override;
+        std::pair<Sound_Handle,size_t> loadSound(DecodedSound&& sound) override;
         size_t unloadSound(Sound_Handle data) override;
 
         bool playSound(Sound *sound, Sound_Handle data, float offset) override;
@@ -95,6 +108,8 @@ namespace MWSound
         void pauseActiveDevice() override;
         void resumeActiveDevice() override;
 
+        void getStats(SoundStats& stats) const override;
+
         OpenAL_Output(SoundManager &mgr);
         virtual ~OpenAL_Output();
     };
@@ -9,6 +9,7 @@
 #include <components/vfs/manager.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 namespace MWSound
@@ -39,12 +40,19 @@ namespace MWSound
         mVfs(&vfs),
         mOutput(&output),
         mBufferCacheMax(std::max(Settings::Manager::getInt("buffer cache max", "Sound"), 1) * 1024 * 1024),
-        mBufferCacheMin(std::min(static_cast<std::size_t>(std::max(Settings::Manager::getInt("buffer cache min", "Sound"), 1)) * 1024 * 1024, mBufferCacheMax))
+        mBufferCacheMin(std::min(static_cast<std::size_t>(std::max(Settings::Manager::getInt("buffer cache min", "Sound"), 1)) * 1024 * 1024, mBufferCacheMax)),
+        mThread([this] { decode(); })
     {
     }
 
     SoundBufferPool::~SoundBufferPool()
     {
+        {
+            std::lock_guard lock(mMutex);
+            mQuit = true;
+        }
+        mHasRequests.notify_all();
+        mThread.join();
         clear();
     }
 
@@ -60,7 +68,7 @@ namespace MWSound
         return nullptr;
     }
 
-    Sound_Buffer* SoundBufferPool::load(const std::string& soundId)
+    Sound_Buffer* SoundBufferPool::find(const std::string& soundId)
     {
         if (mBufferNameMap.empty())
         {
@@ -68,41 +76,161 @@ namespace MWSound
                 insertSound(Misc::StringUtils::lowerCase(sound.mId), sound);
         }
 
-        Sound_Buffer* sfx;
         const auto it = mBufferNameMap.find(soundId);
         if (it != mBufferNameMap.end())
-            sfx = it->second;
-        else
+            return it->second;
+
+        const ESM::Sound *sound = MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>().search(soundId);
+        if (sound == nullptr)
+            return nullptr;
+        return insertSound(soundId, *sound);
+    }
+
+    Sound_Buffer* SoundBufferPool::load(const std::string& soundId, bool wait)
+    {
+        Sound_Buffer* const sfx = find(soundId);
+        if (sfx == nullptr)
+            return nullptr;
+
+        if (sfx->getHandle() == nullptr && sfx->mPending)
+            update();
+
+        if (sfx->getHandle() != nullptr)
+            return sfx;
+
+        if (!wait)
         {
-            const ESM::Sound *sound = MWBase::Environment::get().getWorld()->getStore().get<ESM::Sound>().search(soundId);
-            if (sound == nullptr)
-                return {};
-            sfx = insertSound(soundId, *sound);
+            preload(soundId);
+            return nullptr;
         }
 
-        if (sfx->getHandle() == nullptr)
+        if (sfx->mPending)
         {
-            auto [handle, size] = mOutput->loadSound(sfx->getResourceName());
-            if (handle == nullptr)
-                return {};
-
-            sfx->mHandle = handle;
-
-            mBufferCacheSize += size;
-            if (mBufferCacheSize > mBufferCacheMax)
+            std::unique_lock lock(mMutex);
+            const auto request = std::find(mRequests.begin(), mRequests.end(), sfx);
+            if (request != mRequests.end())
             {
-                unloadUnused();
-                if (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMax)
-                    Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+                // The background thread didn't get to it yet, decoding it here is faster than waiting
+                mRequests.erase(request);
+                lock.unlock();
+                sfx->mPending = false;
+            }
+            else
+            {
+                mDecodedChanged.wait(lock, [&] { return mDecoding != sfx; });
+                lock.unlock();
+                update();
+                return sfx->getHandle() != nullptr ? sfx : nullptr;
             }
-            mUnusedBuffers.push_front(sfx);
         }
 
-        return sfx;
+        const auto start = std::chrono::steady_clock::now();
+        auto [handle, size] = mOutput->loadSound(mOutput->decodeSound(sfx->getResourceName()));
+        addLoaded(*sfx, handle, size);
+        mLoadTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return sfx->getHandle() != nullptr ? sfx : nullptr;
+    }
+
+    void SoundBufferPool::preload(const std::string& soundId)
+    {
+        Sound_Buffer* const sfx = find(soundId);
+        if (sfx == nullptr || sfx->getHandle() != nullptr || sfx->mPending)
+            return;
+
+        sfx->mPending = true;
+        {
+            std::lock_guard lock(mMutex);
+            mRequests.push_back(sfx);
+        }
+        mHasRequests.notify_all();
+    }
+
+    void SoundBufferPool::update()
+    {
+        mLoadTime = 0;
+
+        std::vector<std::pair<Sound_Buffer*, DecodedSound>> decoded;
+        {
+            std::lock_guard lock(mMutex);
+            mLastDecodeTime = mDecodeTime;
+            mDecodeTime = 0;
+            if (mDecoded.empty())
+                return;
+            decoded.swap(mDecoded);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& [sfx, sound] : decoded)
+        {
+            sfx->mPending = false;
+            auto [handle, size] = mOutput->loadSound(std::move(sound));
+            addLoaded(*sfx, handle, size);
+        }
+        mLoadTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void SoundBufferPool::addLoaded(Sound_Buffer& sfx, Sound_Handle handle, std::size_t size)
+    {
+        if (handle == nullptr)
+            return;
+
+        sfx.mHandle = handle;
+        ++mLoadedBuffers;
+
+        mBufferCacheSize += size;
+        if (mBufferCacheSize > mBufferCacheMax)
+        {
+            unloadUnused();
+            if (!mUnusedBuffers.empty() && mBufferCacheSize > mBufferCacheMax)
+                Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+        }
+        mUnusedBuffers.push_front(&sfx);
+    }
+
+    void SoundBufferPool::cancelPending()
+    {
+        {
+            std::unique_lock lock(mMutex);
+            mRequests.clear();
+            mDecodedChanged.wait(lock, [&] { return mDecoding == nullptr; });
+            mDecoded.clear();
+        }
+        for (auto& sfx : mSoundBuffers)
+            sfx.mPending = false;
+    }
+
+    void SoundBufferPool::decode()
+    {
+        std::unique_lock lock(mMutex);
+        while (true)
+        {
+            mHasRequests.wait(lock, [&] { return mQuit || !mRequests.empty(); });
+            if (mQuit)
+                return;
+
+            Sound_Buffer* const sfx = mRequests.front();
+            mRequests.pop_front();
+            mDecoding = sfx;
+            // The resource name doesn't change after the buffer is inserted
+            const std::string& resourceName = sfx->getResourceName();
+            lock.unlock();
+
+            const auto start = std::chrono::steady_clock::now();
+            DecodedSound sound = mOutput->decodeSound(resourceName);
+            const auto end = std::chrono::steady_clock::now();
+
+            lock.lock();
+            mDecodeTime += std::chrono::duration<double>(end - start).count();
+            mDecoded.emplace_back(sfx, std::move(sound));
+            mDecoding = nullptr;
+            mDecodedChanged.notify_all();
+        }
     }
 
     void SoundBufferPool::clear()
     {
+        cancelPending();
+
         for (auto &sfx : mSoundBuffers)
         {
             if(sfx.mHandle)
@@ -110,6 +238,19 @@ namespace MWSound
             sfx.mHandle = nullptr;
         }
         mUnusedBuffers.clear();
+        mBufferCacheSize = 0;
+        mLoadedBuffers = 0;
+    }
+
+    void SoundBufferPool::getStats(SoundStats& stats) const
+    {
+        stats.mBuffers = mLoadedBuffers;
+        stats.mBufferMemory = mBufferCacheSize;
+        stats.mLoadTime = mLoadTime;
+
+        std::lock_guard lock(mMutex);
+        stats.mPendingBuffers = mRequests.size() + mDecoded.size() + (mDecoding != nullptr ? 1 : 0);
+        stats.mDecodeTime = mLastDecodeTime;
     }
 
     Sound_Buffer* SoundBufferPool::insertSound(const std::string& soundId, const ESM::Sound& sound)
@@ -145,6 +286,7 @@ namespace MWSound
 
             mBufferCacheSize -= mOutput->unloadSound(unused->getHandle());
             unused->mHandle = nullptr;
+            --mLoadedBuffers;
 
             mUnusedBuffers.pop_back();
         }
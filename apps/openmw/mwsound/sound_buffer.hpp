@@ -2,9 +2,14 @@
 #define GAME_SOUND_SOUND_BUFFER_H
 
 #include <algorithm>
-#include <string>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "sound_output.hpp"
 
@@ -47,6 +52,8 @@ namespace MWSound
             float mMaxDist;
             Sound_Handle mHandle = nullptr;
             std::size_t mUses = 0;
+            // Queued for decoding or decoded, but not loaded by the output yet
+            bool mPending = false;
 
             friend class SoundBufferPool;
     };
@@ -66,7 +73,15 @@ namespace MWSound
 
             /// Lookup a soundId for its sound data (resource name, local volume,
             /// minRange, and maxRange), and ensure it's ready for use.
-            Sound_Buffer* load(const std::string& soundId);
+            /// \param wait If the sound is not loaded yet, load it before returning. Otherwise it is decoded in
+            /// the background and nullptr is returned until it is loaded.
+            Sound_Buffer* load(const std::string& soundId, bool wait = true);
+
+            /// Start decoding a sound in the background, so it is ready when it is played.
+            void preload(const std::string& soundId);
+
+            /// Load the sounds decoded in the background. To be called once per frame.
+            void update();
 
             void use(Sound_Buffer& sfx)
             {
@@ -84,8 +99,12 @@ namespace MWSound
                     mUnusedBuffers.push_front(&sfx);
             }
 
+            /// \note Drops the sounds that are still being decoded.
             void clear();
 
+            /// Fill in the stats of the buffers.
+            void getStats(SoundStats& stats) const;
+
         private:
             const VFS::Manager* const mVfs;
             Sound_Output* mOutput;
@@ -94,11 +113,35 @@ namespace MWSound
             std::size_t mBufferCacheMax;
             std::size_t mBufferCacheMin;
             std::size_t mBufferCacheSize = 0;
+            std::size_t mLoadedBuffers = 0;
+            // Time spent loading buffers on the main thread since the last update()
+            double mLoadTime = 0;
             // NOTE: unused buffers are stored in front-newest order.
             std::deque<Sound_Buffer*> mUnusedBuffers;
 
+            // Guards the decoding queue shared with mThread
+            mutable std::mutex mMutex;
+            std::condition_variable mHasRequests;
+            std::condition_variable mDecodedChanged;
+            std::deque<Sound_Buffer*> mRequests;
+            std::vector<std::pair<Sound_Buffer*, DecodedSound>> mDecoded;
+            Sound_Buffer* mDecoding = nullptr;
+            // Time spent by mThread decoding since the last update(), and in the frame before that
+            double mDecodeTime = 0;
+            double mLastDecodeTime = 0;
+            bool mQuit = false;
+            std::thread mThread;
+
+            Sound_Buffer* find(const std::string& soundId);
+
             inline Sound_Buffer* insertSound(const std::string& soundId, const ESM::Sound& sound);
 
+            void addLoaded(Sound_Buffer& sfx, Sound_Handle handle, std::size_t size);
+
+            void cancelPending();
+
+            void decode();
+
             inline void unloadUnused();
     };
 }
@@ -7,6 +7,8 @@
 
 #include "../mwbase/soundmanager.hpp"
 
+#include "sound_decoder.hpp"
+
 namespace MWSound
 {
     class SoundManager;
@@ -31,6 +33,15 @@ namespace MWSound
         Env_Underwater
     };
 
+    // Audio data of a sound file that is not loaded by the output yet
+    struct DecodedSound
+    {
+        std::vector<char> mData;
+        int mSampleRate = 0;
+        ChannelConfig mChannels = ChannelConfig_Mono;
+        SampleType mType = SampleType_UInt8;
+    };
+
     class Sound_Output
     {
         SoundManager &mManager;
@@ -42,7 +53,9 @@ namespace MWSound
         virtual std::vector<std::string> enumerateHrtf() = 0;
         virtual void setHrtf(const std::string &hrtfname, HrtfMode hrtfmode) = 0;
 
-        virtual std::pair<Sound_Handle,size_t> loadSound(const std::string &fname) = 0;
+        /// Decode a sound file for loadSound. Can be called from any thread.
+        virtual DecodedSound decodeSound(const std::string &fname) = 0;
+        virtual std::pair<Sound_Handle,size_t> loadSound(DecodedSound&& sound) = 0;
         virtual size_t unloadSound(Sound_Handle data) = 0;
 
         virtual bool playSound(Sound *sound, Sound_Handle data, float offset) = 0;
@@ -71,6 +84,9 @@ namespace MWSound
         virtual void pauseActiveDevice() = 0;
         virtual void resumeActiveDevice() = 0;
 
+        /// Fill in the stats of the sources and streams.
+        virtual void getStats(SoundStats& stats) const = 0;
+
         Sound_Output& operator=(const Sound_Output &rhs);
         Sound_Output(const Sound_Output &rhs);
 
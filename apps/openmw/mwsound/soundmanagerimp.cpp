@@ -1,10 +1,12 @@
 #include "soundmanagerimp.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <numeric>
 
 #include <osg/Matrixf>
+#include <osg/Stats>
 
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/rng.hpp>
@@ -68,6 +70,12 @@ namespace MWSound
 
             return 1.0;
         }
+
+        // Playing these late is worse than not playing them at all, so they are skipped while loading
+        bool waitForSound(Type type)
+        {
+            return type != Type::Foot;
+        }
     }
 
     // For combining PlayMode and Type flags
@@ -494,7 +502,7 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return nullptr;
 
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId), waitForSound(type));
         if(!sfx) return nullptr;
 
         // Only one copy of given sound can be played at time, so stop previous copy
@@ -531,7 +539,7 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId), waitForSound(type));
         if(!sfx) return nullptr;
 
         // Only one copy of given sound can be played at time on ptr, so stop previous copy
@@ -584,7 +592,7 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = mSoundBuffers.load(Misc::StringUtils::lowerCase(soundId), waitForSound(type));
         if(!sfx) return nullptr;
 
         const float squaredDist = (mListenerPos - initialPos).length2();
@@ -611,6 +619,14 @@ namespace MWSound
         return result;
     }
 
+    void SoundManager::preloadSound(const std::string& soundId)
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        mSoundBuffers.preload(Misc::StringUtils::lowerCase(soundId));
+    }
+
     void SoundManager::stopSound(Sound *sound)
     {
         if(sound)
@@ -1025,16 +1041,25 @@ namespace MWSound
 
     void SoundManager::update(float duration)
     {
-        if(!mOutput->isInitialized() || mPlaybackPaused)
+        if(!mOutput->isInitialized())
             return;
 
-        updateSounds(duration);
-        if (MWBase::Environment::get().getStateManager()->getState()!=
-            MWBase::StateManager::State_NoGame)
+        const auto start = std::chrono::steady_clock::now();
+
+        mSoundBuffers.update();
+
+        if(!mPlaybackPaused)
         {
-            updateRegionSound(duration);
-            updateWaterSound();
+            updateSounds(duration);
+            if (MWBase::Environment::get().getStateManager()->getState()!=
+                MWBase::StateManager::State_NoGame)
+            {
+                updateRegionSound(duration);
+                updateWaterSound();
+            }
         }
+
+        mUpdateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
 
 
@@ -1212,4 +1237,33 @@ namespace MWSound
         mPlaybackPaused = false;
         std::fill(std::begin(mPausedSoundTypes), std::end(mPausedSoundTypes), 0);
     }
+
+    SoundStats SoundManager::getStats() const
+    {
+        SoundStats result;
+        if(!mOutput->isInitialized())
+            return result;
+
+        mOutput->getStats(result);
+        mSoundBuffers.getStats(result);
+        result.mUpdateTime = mUpdateTime;
+        return result;
+    }
+
+    void SoundManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        const SoundStats result = getStats();
+        stats.setAttribute(frameNumber, "Sound Sources", result.mSources);
+        stats.setAttribute(frameNumber, "Sound Sources Stolen", result.mStolenSources);
+        stats.setAttribute(frameNumber, "Sound Streams", result.mStreams);
+        stats.setAttribute(frameNumber, "Sound Stream Underruns", result.mStreamUnderruns);
+        stats.setAttribute(frameNumber, "Sound Buffers", result.mBuffers);
+        stats.setAttribute(frameNumber, "Sound Buffers Pending", result.mPendingBuffers);
+        stats.setAttribute(frameNumber, "Sound Buffer Memory", result.mBufferMemory);
+        stats.setAttribute(frameNumber, "Sound Load Time", result.mLoadTime);
+        stats.setAttribute(frameNumber, "Sound Decode Time", result.mDecodeTime);
+    }
 }
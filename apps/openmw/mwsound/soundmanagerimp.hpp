@@ -94,6 +94,8 @@ namespace MWSound
 
         float mTimePassed;
 
+        double mUpdateTime = 0;
+
         const ESM::Cell *mLastCell;
 
         Sound* mCurrentRegionSound;
@@ -213,6 +215,9 @@ namespace MWSound
         ///< Play a 3D sound at \a initialPos. If the sound should be moving, it must be updated using Sound::setPosition.
         ///< @param offset Number of seconds into the sound to start playback.
 
+        void preloadSound(const std::string& soundId) override;
+        ///< Start loading a sound in the background, so it doesn't stall the game when it is played.
+
         void stopSound(Sound *sound) override;
         ///< Stop the given sound from playing
         /// @note no-op if \a sound is null
@@ -251,6 +256,10 @@ namespace MWSound
         void updatePtr (const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated) override;
 
         void clear() override;
+
+        SoundStats getStats() const override;
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const override;
     };
 }
 
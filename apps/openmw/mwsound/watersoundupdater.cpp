@@ -8,6 +8,9 @@
 
 #include <osg/Vec3f>
 
+#include <algorithm>
+#include <vector>
+
 namespace MWSound
 {
     WaterSoundUpdater::WaterSoundUpdater(const WaterSoundUpdaterSettings& settings)
@@ -45,21 +48,22 @@ namespace MWSound
 
             const float step = mSettings.mNearWaterRadius * 2.0f / (mSettings.mNearWaterPoints - 1);
 
-            int underwaterPoints = 0;
-
+            std::vector<osg::Vec3f> points;
+            points.reserve(static_cast<std::size_t>(mSettings.mNearWaterPoints * mSettings.mNearWaterPoints));
             for (int x = 0; x < mSettings.mNearWaterPoints; x++)
             {
                 for (int y = 0; y < mSettings.mNearWaterPoints; y++)
                 {
                     const float terrainX = pos.x() - mSettings.mNearWaterRadius + x * step;
                     const float terrainY = pos.y() - mSettings.mNearWaterRadius + y * step;
-                    const float height = world.getTerrainHeightAt(osg::Vec3f(terrainX, terrainY, 0.0f));
-
-                    if (height < 0)
-                        underwaterPoints++;
+                    points.emplace_back(terrainX, terrainY, 0.0f);
                 }
             }
 
+            std::vector<float> heights;
+            world.getTerrainHeightsAt(points, heights);
+            const auto underwaterPoints = std::count_if(heights.begin(), heights.end(), [] (float height) { return height < 0; });
+
             return underwaterPoints * 2.0f / (mSettings.mNearWaterPoints * mSettings.mNearWaterPoints);
         }
 
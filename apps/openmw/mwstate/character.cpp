@@ -1,15 +1,152 @@
 #include "character.hpp"
 
+#include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <sstream>
 
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
+#include <components/debug/debuglog.hpp>
+#include <components/esm3/compressedsavedgame.hpp>
 #include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
 #include <components/esm/defs.hpp>
 
 #include <components/misc/utf8stream.hpp>
 
+#include "fileoperations.hpp"
+
+namespace
+{
+    const char slotIndexMagic[] = {'O', 'M', 'W', 'S', 'L', 'O', 'T', '1'};
+
+    // Profiles of the saved games in the directory of a character, so their headers don't have to be read at startup
+    const char slotIndexFileName[] = "slots.cache";
+
+    // Longest profile accepted while reading, anything longer means the file is broken
+    constexpr std::uint32_t sMaxRecordSize = 1 << 20;
+
+    struct IndexedSlot
+    {
+        std::uint64_t mFileSize;
+        std::int64_t mTimeStamp;
+        ESM::SavedGame mProfile;
+    };
+
+    using SlotIndex = std::map<std::string, IndexedSlot>;
+
+    template <class T>
+    void writeValue(std::ostream& stream, T value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        writeValue(stream, static_cast<std::uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    template <class T>
+    bool readValue(std::istream& stream, T& value)
+    {
+        stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return static_cast<bool>(stream);
+    }
+
+    bool readString(std::istream& stream, std::string& value)
+    {
+        std::uint32_t size = 0;
+        if (!readValue(stream, size) || size > sMaxRecordSize)
+            return false;
+        value.resize(size);
+        stream.read(value.data(), size);
+        return static_cast<bool>(stream);
+    }
+
+    SlotIndex readSlotIndex(const boost::filesystem::path& path)
+    {
+        SlotIndex index;
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return index;
+
+        char magic[sizeof(slotIndexMagic)];
+        stream.read(magic, sizeof(magic));
+        if (!stream || !std::equal(magic, magic + sizeof(magic), slotIndexMagic))
+            return index;
+
+        try
+        {
+            std::uint32_t count = 0;
+            if (!readValue(stream, count))
+                throw std::runtime_error("unexpected end of file");
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                std::string name;
+                std::string record;
+                IndexedSlot slot;
+                if (!readString(stream, name) || !readValue(stream, slot.mFileSize)
+                    || !readValue(stream, slot.mTimeStamp) || !readString(stream, record))
+                    throw std::runtime_error("unexpected end of file");
+
+                ESM::ESMReader reader;
+                reader.openRaw(std::make_shared<std::istringstream>(std::move(record)), path.string());
+                if (reader.getRecName() != ESM::REC_SAVE)
+                    throw std::runtime_error("invalid record");
+                reader.getRecHeader();
+                slot.mProfile.load(reader);
+
+                index.emplace(std::move(name), std::move(slot));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid saved game index " << path << ": " << e.what();
+            index.clear();
+        }
+        return index;
+    }
+
+    void writeSlotIndex(const boost::filesystem::path& path, const SlotIndex& index)
+    {
+        const boost::filesystem::path tempPath = path.string() + ".tmp";
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            stream.write(slotIndexMagic, sizeof(slotIndexMagic));
+            writeValue(stream, static_cast<std::uint32_t>(index.size()));
+            for (const auto& [name, slot] : index)
+            {
+                std::ostringstream record;
+                ESM::ESMWriter writer;
+                writer.saveRecords(record);
+                writer.startRecord(ESM::REC_SAVE);
+                slot.mProfile.save(writer);
+                writer.endRecord(ESM::REC_SAVE);
+
+                writeString(stream, name);
+                writeValue(stream, slot.mFileSize);
+                writeValue(stream, slot.mTimeStamp);
+                writeString(stream, record.str());
+            }
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write saved game index " << path;
+                return;
+            }
+        }
+
+        boost::system::error_code error;
+        boost::filesystem::rename(tempPath, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to write saved game index " << path << ": " << error.message();
+    }
+}
+
 bool MWState::operator< (const Slot& left, const Slot& right)
 {
     return left.mTimeStamp<right.mTimeStamp;
@@ -25,26 +162,60 @@ std::string MWState::getFirstGameFile(const std::vector<std::string>& contentFil
     return "";
 }
 
-void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game)
+std::vector<char> MWState::getScreenshot (const Slot& slot)
+{
+    if (!slot.mProfile.mScreenshot.empty() || !boost::filesystem::exists(slot.mPath))
+        return slot.mProfile.mScreenshot;
+
+    try
+    {
+        ESM::ESMReader reader;
+        reader.open (ESM::openSavedGame(slot.mPath.string(), true), slot.mPath.string());
+        if (reader.getRecName()!=ESM::REC_SAVE)
+            return {};
+        reader.getRecHeader();
+
+        ESM::SavedGame profile;
+        profile.load (reader);
+        return std::move(profile.mScreenshot);
+    }
+    catch (const std::exception& e)
+    {
+        Log(Debug::Warning) << "Warning: Unable to read the screenshot of " << slot.mPath << ": " << e.what();
+        return {};
+    }
+}
+
+void MWState::Character::addSlot (const boost::filesystem::path& path, const std::string& game, const ESM::SavedGame& profile)
 {
+    if (!Misc::StringUtils::ciEqual(getFirstGameFile(profile.mContentFiles), game))
+        return; // this file is for a different game -> ignore
+
     Slot slot;
     slot.mPath = path;
     slot.mTimeStamp = boost::filesystem::last_write_time (path);
+    slot.mProfile = profile;
+
+    mSlots.push_back (slot);
+}
 
+bool MWState::Character::readProfile (const boost::filesystem::path& path, ESM::SavedGame& profile)
+{
+    // Only the header is read, compressed saved games don't need to be decompressed completely for it
     ESM::ESMReader reader;
-    reader.open (slot.mPath.string());
+    reader.open (ESM::openSavedGame(path.string(), true), path.string());
 
     if (reader.getRecName()!=ESM::REC_SAVE)
-        return; // invalid save file -> ignore
+        return false; // invalid save file -> ignore
 
     reader.getRecHeader();
 
-    slot.mProfile.load (reader);
-
-    if (!Misc::StringUtils::ciEqual(getFirstGameFile(slot.mProfile.mContentFiles), game))
-        return; // this file is for a different game -> ignore
+    profile.load (reader);
 
-    mSlots.push_back (slot);
+    // The screenshot is only read when the saved game dialog shows it
+    profile.mScreenshot.clear();
+    profile.mScreenshot.shrink_to_fit();
+    return true;
 }
 
 void MWState::Character::addSlot (const ESM::SavedGame& profile)
@@ -81,8 +252,9 @@ void MWState::Character::addSlot (const ESM::SavedGame& profile)
     mSlots.push_back (slot);
 }
 
-MWState::Character::Character (const boost::filesystem::path& saves, const std::string& game)
-: mPath (saves)
+MWState::Character::Character (const boost::filesystem::path& saves, const std::string& game,
+    FileOperations& fileOperations)
+: mPath (saves), mFileOperations (&fileOperations)
 {
     if (!boost::filesystem::is_directory (mPath))
     {
@@ -90,18 +262,47 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
     }
     else
     {
+        const boost::filesystem::path indexPath = mPath / slotIndexFileName;
+        const SlotIndex oldIndex = readSlotIndex(indexPath);
+        SlotIndex index;
+        bool indexChanged = false;
+
         for (boost::filesystem::directory_iterator iter (mPath);
             iter!=boost::filesystem::directory_iterator(); ++iter)
         {
             boost::filesystem::path slotPath = *iter;
 
+            // Left over by a saved game that was still being written
+            if (slotPath.extension() == ".tmp" || slotPath.filename() == slotIndexFileName)
+                continue;
+
             try
             {
-                addSlot (slotPath, game);
+                IndexedSlot indexed;
+                indexed.mFileSize = boost::filesystem::file_size(slotPath);
+                indexed.mTimeStamp = boost::filesystem::last_write_time(slotPath);
+
+                const std::string name = slotPath.filename().string();
+                const auto found = oldIndex.find(name);
+                if (found != oldIndex.end() && found->second.mFileSize == indexed.mFileSize
+                    && found->second.mTimeStamp == indexed.mTimeStamp)
+                    indexed.mProfile = found->second.mProfile;
+                else
+                {
+                    indexChanged = true;
+                    if (!readProfile(slotPath, indexed.mProfile))
+                        continue;
+                }
+
+                addSlot (slotPath, game, indexed.mProfile);
+                index.emplace(name, std::move(indexed));
             }
             catch (...) {} // ignoring bad saved game files for now
         }
 
+        if (indexChanged || index.size() != oldIndex.size())
+            writeSlotIndex(indexPath, index);
+
         std::sort (mSlots.begin(), mSlots.end());
     }
 }
@@ -110,14 +311,21 @@ void MWState::Character::cleanup()
 {
     if (mSlots.size() == 0)
     {
-        // All slots are gone, no need to keep the empty directory
-        if (boost::filesystem::is_directory (mPath))
+        // All slots are gone, no need to keep the empty directory. Runs after the slot files queued for deletion
+        // are gone.
+        mFileOperations->push([path = mPath]
         {
+            if (!boost::filesystem::is_directory (path))
+                return;
+
+            boost::system::error_code error;
+            boost::filesystem::remove(path / slotIndexFileName, error);
+
             // Extra safety check to make sure the directory is empty (e.g. slots failed to parse header)
-            boost::filesystem::directory_iterator it(mPath);
+            boost::filesystem::directory_iterator it(path);
             if (it == boost::filesystem::directory_iterator())
-                boost::filesystem::remove_all(mPath);
-        }
+                boost::filesystem::remove_all(path);
+        });
     }
 }
 
@@ -138,7 +346,13 @@ void MWState::Character::deleteSlot (const Slot *slot)
         throw std::logic_error ("slot not found");
     }
 
-    boost::filesystem::remove(slot->mPath);
+    mFileOperations->push([path = slot->mPath]
+    {
+        boost::system::error_code error;
+        boost::filesystem::remove(path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to delete saved game " << path << ": " << error.message();
+    });
 
     mSlots.erase (mSlots.begin()+index);
 }
@@ -164,6 +378,19 @@ const MWState::Slot *MWState::Character::updateSlot (const Slot *slot, const ESM
     return &mSlots.back();
 }
 
+void MWState::Character::setScreenshot (const Slot *slot, std::vector<char> screenshot)
+{
+    int index = slot - &mSlots[0];
+
+    if (index<0 || index>=static_cast<int> (mSlots.size()))
+    {
+        // sanity check; not entirely reliable
+        throw std::logic_error ("slot not found");
+    }
+
+    mSlots[index].mProfile.mScreenshot = std::move(screenshot);
+}
+
 MWState::Character::SlotIterator MWState::Character::begin() const
 {
     return mSlots.rbegin();
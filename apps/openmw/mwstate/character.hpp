@@ -7,6 +7,8 @@
 
 namespace MWState
 {
+    class FileOperations;
+
     struct Slot
     {
         boost::filesystem::path mPath;
@@ -18,6 +20,9 @@ namespace MWState
 
     std::string getFirstGameFile(const std::vector<std::string>& contentFiles);
 
+    std::vector<char> getScreenshot(const Slot& slot);
+    ///< Get the screenshot of \a slot, which is read from its file if it wasn't loaded with the slot.
+
     class Character
     {
         public:
@@ -28,24 +33,31 @@ namespace MWState
 
             boost::filesystem::path mPath;
             std::vector<Slot> mSlots;
+            FileOperations* mFileOperations;
 
-            void addSlot (const boost::filesystem::path& path, const std::string& game);
+            void addSlot (const boost::filesystem::path& path, const std::string& game, const ESM::SavedGame& profile);
+
+            static bool readProfile (const boost::filesystem::path& path, ESM::SavedGame& profile);
+            ///< Read the header of a saved game file without the screenshot.
 
             void addSlot (const ESM::SavedGame& profile);
 
         public:
 
-            Character (const boost::filesystem::path& saves, const std::string& game);
+            Character (const boost::filesystem::path& saves, const std::string& game, FileOperations& fileOperations);
 
             void cleanup();
             ///< Delete the directory we used, if it is empty
+            ///
+            /// \note The directory is deleted in the background.
 
             const Slot *createSlot (const ESM::SavedGame& profile);
             ///< Create new slot.
             ///
             /// \attention The ownership of the slot is not transferred.
 
-            /// \note Slot must belong to this character.
+            /// \note Slot must belong to this character. It is removed from the slots right away, its file is
+            /// deleted in the background.
             ///
             /// \attention The \a slot pointer will be invalidated by this call.
             void deleteSlot (const Slot *slot);
@@ -55,6 +67,11 @@ namespace MWState
             ///
             /// \attention The \a slot pointer will be invalidated by this call.
 
+            void setScreenshot (const Slot *slot, std::vector<char> screenshot);
+            ///< Set the screenshot of a slot that was created before its screenshot was encoded.
+            ///
+            /// \note Slot must belong to this character.
+
             SlotIterator begin() const;
             ///<  Any call to createSlot and updateSlot can invalidate the returned iterator.
 
@@ -24,7 +24,7 @@ MWState::CharacterManager::CharacterManager (const boost::filesystem::path& save
 
             if (boost::filesystem::is_directory (characterDir))
             {
-                Character character (characterDir, mGame);
+                Character character (characterDir, mGame, mFileOperations);
 
                 if (character.begin()!=character.end())
                     mCharacters.push_back (character);
@@ -81,7 +81,7 @@ MWState::Character* MWState::CharacterManager::createCharacter(const std::string
            path = mPath / test.str();
     }
 
-    mCharacters.emplace_back(path, mGame);
+    mCharacters.emplace_back(path, mGame, mFileOperations);
     return &mCharacters.back();
 }
 
@@ -110,7 +110,6 @@ void MWState::CharacterManager::setCurrentCharacter (const Character *character)
     }
 }
 
-
 std::list<MWState::Character>::const_iterator MWState::CharacterManager::begin() const
 {
     return mCharacters.begin();
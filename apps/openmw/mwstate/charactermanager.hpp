@@ -4,6 +4,7 @@
 #include <boost/filesystem/path.hpp>
 
 #include "character.hpp"
+#include "fileoperations.hpp"
 
 namespace MWState
 {
@@ -11,6 +12,9 @@ namespace MWState
     {
             boost::filesystem::path mPath;
 
+            // Declared before the characters, so the operations they pushed are done when they are gone
+            FileOperations mFileOperations;
+
             // Uses std::list, so that mCurrent stays valid when characters are deleted
             std::list<Character> mCharacters;
 
@@ -0,0 +1,66 @@
+#include "fileoperations.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+namespace MWState
+{
+    FileOperations::FileOperations()
+        : mThread([this] { threadBody(); })
+    {
+    }
+
+    FileOperations::~FileOperations()
+    {
+        {
+            std::lock_guard lock(mMutex);
+            mQuit = true;
+        }
+        mHasOperations.notify_all();
+        mThread.join();
+    }
+
+    void FileOperations::push(std::function<void()> operation)
+    {
+        {
+            std::lock_guard lock(mMutex);
+            mOperations.push_back(std::move(operation));
+        }
+        mHasOperations.notify_all();
+    }
+
+    void FileOperations::wait()
+    {
+        std::unique_lock lock(mMutex);
+        mOperationsDone.wait(lock, [&] { return mOperations.empty() && !mBusy; });
+    }
+
+    void FileOperations::threadBody()
+    {
+        std::unique_lock lock(mMutex);
+        while (true)
+        {
+            mHasOperations.wait(lock, [&] { return mQuit || !mOperations.empty(); });
+            if (mOperations.empty())
+                return;
+
+            std::function<void()> operation = std::move(mOperations.front());
+            mOperations.pop_front();
+            mBusy = true;
+            lock.unlock();
+
+            try
+            {
+                operation();
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "Error in saved game file operation: " << e.what();
+            }
+
+            lock.lock();
+            mBusy = false;
+            if (mOperations.empty())
+                mOperationsDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef GAME_STATE_FILEOPERATIONS_H
+#define GAME_STATE_FILEOPERATIONS_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace MWState
+{
+    /// @brief Runs file system operations on saved games, like deleting slots, on a background thread
+    ///
+    /// Operations run one after another in the order they were pushed, so an operation can rely on the ones
+    /// pushed before it being done.
+    class FileOperations
+    {
+        public:
+            FileOperations();
+            ///< Runs the remaining operations before returning.
+            ~FileOperations();
+
+            FileOperations(const FileOperations&) = delete;
+            FileOperations& operator=(const FileOperations&) = delete;
+
+            /// Exceptions thrown by \a operation are logged.
+            void push(std::function<void()> operation);
+
+            /// Wait until all operations pushed so far are done.
+            void wait();
+
+        private:
+            void threadBody();
+
+            std::mutex mMutex;
+            std::condition_variable mHasOperations;
+            std::condition_variable mOperationsDone;
+            std::deque<std::function<void()>> mOperations;
+            bool mBusy = false;
+            bool mQuit = false;
+            std::thread mThread;
+    };
+}
+
+#endif
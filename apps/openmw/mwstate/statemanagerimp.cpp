@@ -1,10 +1,13 @@
 #include "statemanagerimp.hpp"
 
+#include <chrono>
+
 #include <components/debug/debuglog.hpp>
 
 #include <components/esm3/esmwriter.hpp>
 #include <components/esm3/esmreader.hpp>
 #include <components/esm3/cellid.hpp>
+#include <components/esm3/compressedsavedgame.hpp>
 #include <components/esm3/loadcell.hpp>
 
 #include <components/loadinglistener/loadinglistener.hpp>
@@ -94,6 +97,67 @@ MWState::StateManager::StateManager (const boost::filesystem::path& saves, const
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    if (mPendingSave.valid())
+    {
+        try
+        {
+            mPendingSave.get();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to save game: " << e.what();
+        }
+    }
+}
+
+void MWState::StateManager::finishPendingSave()
+{
+    if (!mPendingSave.valid())
+        return;
+
+    try
+    {
+        std::vector<char> screenshot = mPendingSave.get();
+        for (const Slot& slot : *mPendingSaveCharacter)
+        {
+            if (slot.mPath == mPendingSavePath)
+            {
+                mPendingSaveCharacter->setScreenshot(&slot, std::move(screenshot));
+                break;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream error;
+        error << "Failed to save game: " << e.what();
+
+        Log(Debug::Error) << error.str();
+
+        std::vector<std::string> buttons;
+        buttons.emplace_back("#{sOk}");
+        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+
+        // If no file was written, clean up the slot
+        if (!boost::filesystem::exists(mPendingSavePath))
+        {
+            for (const Slot& slot : *mPendingSaveCharacter)
+            {
+                if (slot.mPath == mPendingSavePath)
+                {
+                    mPendingSaveCharacter->deleteSlot(&slot);
+                    mPendingSaveCharacter->cleanup();
+                    break;
+                }
+            }
+        }
+    }
+
+    mPendingSaveCharacter = nullptr;
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -184,6 +248,9 @@ void MWState::StateManager::resumeGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // The new slot must not get the name of a file that is still being written
+    finishPendingSave();
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -220,7 +287,7 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         profile.mDescription = description;
 
         Log(Debug::Info) << "Making a screenshot for saved game '" << description << "'";
-        writeScreenshot(profile.mScreenshot);
+        osg::ref_ptr<osg::Image> screenshot = makeScreenshot();
 
         if (!slot)
             slot = character->createSlot (profile);
@@ -261,6 +328,8 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         writer.setRecordCount (recordCount);
 
         writer.save (stream);
+        // The REC_SAVE record with the screenshot is written in the background and inserted here
+        const std::size_t fileHeaderSize = static_cast<std::size_t>(stream.tellp());
 
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         // Using only Cells for progress information, since they typically have the largest records by far
@@ -269,10 +338,6 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Loading::ScopedLoad load(&listener);
 
-        writer.startRecord (ESM::REC_SAVE);
-        slot->mProfile.save (writer);
-        writer.endRecord (ESM::REC_SAVE);
-
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
         // LuaManager::write should be called before World::write because world also saves
@@ -285,20 +350,55 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getInputManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount();
+        if (writer.getRecordCount() != recordCount) // 1 extra for TES3 record, REC_SAVE is written later
+            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount << ", written: " << writer.getRecordCount();
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
+        // All good, write to file in the background. The file is replaced at once, so a crash during the write
+        // doesn't lose the saved game that is overwritten.
+        mPendingSaveCharacter = character;
+        mPendingSavePath = slot->mPath;
+        const bool compress = Settings::Manager::getBool("compress saves", "Saves");
+        mPendingSave = std::async(std::launch::async, [stream = std::move(stream), path = slot->mPath, profile = slot->mProfile,
+            screenshot, fileHeaderSize, compress] () mutable
+        {
+            encodeScreenshot(*screenshot, profile.mScreenshot);
+
+            std::ostringstream profileStream;
+            ESM::ESMWriter profileWriter;
+            profileWriter.saveRecords (profileStream);
+            profileWriter.startRecord (ESM::REC_SAVE);
+            profile.save (profileWriter);
+            profileWriter.endRecord (ESM::REC_SAVE);
+
+            std::string data = stream.str();
+            data.insert(fileHeaderSize, profileStream.str());
+            const std::size_t headerSize = fileHeaderSize + static_cast<std::size_t>(profileStream.tellp());
 
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+            boost::filesystem::path tempPath = path;
+            tempPath += ".tmp";
+            {
+                boost::filesystem::ofstream filestream (tempPath, std::ios::binary);
+                if (compress)
+                    ESM::writeCompressedSavedGame(filestream, data, headerSize);
+                else
+                    filestream.write(data.data(), data.size());
+
+                if (filestream.fail())
+                {
+                    filestream.close();
+                    boost::system::error_code error;
+                    boost::filesystem::remove(tempPath, error);
+                    throw std::runtime_error("Write operation failed (file stream)");
+                }
+            }
+            boost::filesystem::rename(tempPath, path);
+            return std::move(profile.mScreenshot);
+        });
 
         Settings::Manager::setString ("character", "Saves",
             slot->mPath.parent_path().filename().string());
@@ -375,6 +475,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishPendingSave();
+
     try
     {
         cleanup();
@@ -382,7 +484,7 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
         Log(Debug::Info) << "Reading save file " << boost::filesystem::path(filepath).filename().string();
 
         ESM::ESMReader reader;
-        reader.open (filepath);
+        reader.open (ESM::openSavedGame(filepath), filepath);
 
         if (reader.getFormat() > ESM::SavedGame::sCurrentFormat)
             throw std::runtime_error("This save file was created using a newer version of OpenMW and is thus not supported. Please upgrade to the newest OpenMW version to load this file.");
@@ -401,11 +503,23 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
 
         size_t total = reader.getFileSize();
         int currentPercent = 0;
+
+        // Cell states are written one after another, so they are collected and parsed in parallel
+        std::vector<std::vector<char>> cellStates;
+        const auto readCellStates = [&]
+        {
+            if (!cellStates.empty())
+                MWBase::Environment::get().getWorld()->readCellStates(reader, cellStates, contentFileMap);
+        };
+
         while (reader.hasMoreRecs())
         {
             ESM::NAME n = reader.getRecName();
             reader.getRecHeader();
 
+            if (n.toInt() != ESM::REC_CSTA)
+                readCellStates();
+
             switch (n.toInt())
             {
                 case ESM::REC_SAVE:
@@ -446,7 +560,6 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                 case ESM::REC_WEAP:
                 case ESM::REC_GLOB:
                 case ESM::REC_PLAY:
-                case ESM::REC_CSTA:
                 case ESM::REC_WTHR:
                 case ESM::REC_DYNA:
                 case ESM::REC_ACTC:
@@ -460,6 +573,11 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                     MWBase::Environment::get().getWorld()->readRecord(reader, n.toInt(), contentFileMap);
                     break;
 
+                case ESM::REC_CSTA:
+                    cellStates.emplace_back();
+                    reader.getRecordData(cellStates.back());
+                    break;
+
                 case ESM::REC_CAM_:
                     reader.getHNT(firstPersonCam, "FIRS");
                     break;
@@ -504,6 +622,7 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                 currentPercent = progressPercent;
             }
         }
+        readCellStates();
 
         mCharacterManager.setCurrentCharacter(character);
 
@@ -589,6 +708,7 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    finishPendingSave();
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -611,6 +731,9 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    if (mPendingSave.valid() && mPendingSave.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        finishPendingSave();
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -658,13 +781,26 @@ bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
     return true;
 }
 
-void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
+namespace
 {
-    int screenshotW = 259*2, screenshotH = 133*2; // *2 to get some nice antialiasing
+    const int sScreenshotWidth = 259*2, sScreenshotHeight = 133*2; // *2 to get some nice antialiasing
+}
 
+osg::ref_ptr<osg::Image> MWState::StateManager::makeScreenshot() const
+{
     osg::ref_ptr<osg::Image> screenshot (new osg::Image);
 
-    MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), screenshotW, screenshotH);
+    MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), sScreenshotWidth, sScreenshotHeight);
+
+    return screenshot;
+}
+
+void MWState::StateManager::encodeScreenshot(osg::Image& screenshot, std::vector<char> &imageData)
+{
+    if (screenshot.data() == nullptr)
+        return;
+
+    screenshot.scaleImage(sScreenshotWidth, sScreenshotHeight, 1);
 
     osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
     if (!readerwriter)
@@ -674,7 +810,7 @@ void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
     }
 
     std::ostringstream ostream;
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*screenshot, ostream);
+    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(screenshot, ostream);
     if (!result.success())
     {
         Log(Debug::Error) << "Error: Unable to write screenshot: " << result.message() << " code " << result.status();
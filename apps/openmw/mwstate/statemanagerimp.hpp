@@ -1,7 +1,11 @@
 #ifndef GAME_STATE_STATEMANAGER_H
 #define GAME_STATE_STATEMANAGER_H
 
+#include <future>
 #include <map>
+#include <vector>
+
+#include <osg/ref_ptr>
 
 #include "../mwbase/statemanager.hpp"
 
@@ -9,6 +13,11 @@
 
 #include "charactermanager.hpp"
 
+namespace osg
+{
+    class Image;
+}
+
 namespace MWState
 {
     class StateManager : public MWBase::StateManager
@@ -19,13 +28,25 @@ namespace MWState
             CharacterManager mCharacterManager;
             double mTimePlayed;
 
+            // The file of the last saved game is written by a background thread, which also encodes the screenshot
+            std::future<std::vector<char>> mPendingSave;
+            Character* mPendingSaveCharacter = nullptr;
+            boost::filesystem::path mPendingSavePath;
+
         private:
 
+            void finishPendingSave();
+            ///< Wait until the pending saved game is written and report an error, if any.
+
             void cleanup (bool force = false);
 
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
-            void writeScreenshot (std::vector<char>& imageData) const;
+            osg::ref_ptr<osg::Image> makeScreenshot() const;
+            ///< Read the current view for a saved game, it still has to be scaled and encoded with encodeScreenshot.
+
+            static void encodeScreenshot (osg::Image& image, std::vector<char>& imageData);
+            ///< Thread safe.
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
@@ -33,6 +54,8 @@ namespace MWState
 
             StateManager (const boost::filesystem::path& saves, const std::vector<std::string>& contentFiles);
 
+            ~StateManager() override;
+
             void requestQuit() override;
 
             bool hasQuitRequest() const override;
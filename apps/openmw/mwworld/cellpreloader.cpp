@@ -3,7 +3,10 @@
 #include <atomic>
 #include <limits>
 
+#include <osg/Stats>
+
 #include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/bulletshapemanager.hpp>
@@ -15,6 +18,9 @@
 #include <components/esm3/loadcell.hpp>
 #include <components/loadinglistener/reporter.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/soundmanager.hpp"
+
 #include "../mwrender/landmanager.hpp"
 
 #include "cellstore.hpp"
@@ -48,14 +54,16 @@ namespace MWWorld
 
     struct ListModelsVisitor
     {
-        ListModelsVisitor(std::vector<std::string>& out)
+        ListModelsVisitor(std::vector<std::string>& out, std::vector<std::string>& sounds)
             : mOut(out)
+            , mSounds(sounds)
         {
         }
 
         virtual bool operator()(const MWWorld::Ptr& ptr)
         {
             ptr.getClass().getModelsToPreload(ptr, mOut);
+            ptr.getClass().getSoundsToPreload(ptr, mSounds);
 
             return true;
         }
@@ -63,6 +71,7 @@ namespace MWWorld
         virtual ~ListModelsVisitor() = default;
 
         std::vector<std::string>& mOut;
+        std::vector<std::string>& mSounds;
     };
 
     /// Worker thread item: preload models in a cell.
@@ -70,7 +79,7 @@ namespace MWWorld
     {
     public:
         /// Constructor to be called from the main thread.
-        PreloadItem(MWWorld::CellStore* cell, Resource::SceneManager* sceneManager, Resource::BulletShapeManager* bulletShapeManager, Resource::KeyframeManager* keyframeManager, Terrain::World* terrain, MWRender::LandManager* landManager, bool preloadInstances)
+        PreloadItem(MWWorld::CellStore* cell, Resource::SceneManager* sceneManager, Resource::BulletShapeManager* bulletShapeManager, Resource::KeyframeManager* keyframeManager, Terrain::World* terrain, MWRender::LandManager* landManager, SceneUtil::WorkQueue* workQueue, bool preloadInstances)
             : mIsExterior(cell->getCell()->isExterior())
             , mX(cell->getCell()->getGridX())
             , mY(cell->getCell()->getGridY())
@@ -79,13 +88,20 @@ namespace MWWorld
             , mKeyframeManager(keyframeManager)
             , mTerrain(terrain)
             , mLandManager(landManager)
+            , mWorkQueue(workQueue)
             , mPreloadInstances(preloadInstances)
             , mAbort(false)
         {
             mTerrainView = mTerrain->createView();
 
-            ListModelsVisitor visitor (mMeshes);
+            std::vector<std::string> sounds;
+            ListModelsVisitor visitor (mMeshes, sounds);
             cell->forEach(visitor);
+
+            // Sounds are decoded by the sound manager's own thread
+            MWBase::SoundManager* soundManager = MWBase::Environment::get().getSoundManager();
+            for (const std::string& sound : sounds)
+                soundManager->preloadSound(sound);
         }
 
         void abort() override
@@ -96,6 +112,8 @@ namespace MWWorld
         /// Preload work to be called from the worker thread.
         void doWork() override
         {
+            const Debug::ScopedTrace trace("Preload cell");
+
             if (mIsExterior)
             {
                 try
@@ -108,15 +126,26 @@ namespace MWWorld
                 }
             }
 
+            // Queue all templates first so that other worker threads can load them while we wait for the first one
+            std::vector<Resource::TemplateRequest> templates;
+            templates.reserve(mMeshes.size());
             for (std::string& mesh: mMeshes)
+            {
+                if (mAbort)
+                    return;
+
+                mesh = Misc::ResourceHelpers::correctActorModelPath(mesh, mSceneManager->getVFS());
+                templates.push_back(mSceneManager->getTemplateAsync(mesh, *mWorkQueue));
+            }
+
+            for (std::size_t i = 0; i < mMeshes.size(); ++i)
             {
                 if (mAbort)
                     break;
 
+                std::string& mesh = mMeshes[i];
                 try
                 {
-                    mesh = Misc::ResourceHelpers::correctActorModelPath(mesh, mSceneManager->getVFS());
-
                     size_t slashpos = mesh.find_last_of("/\\");
                     if (slashpos != std::string::npos && slashpos != mesh.size()-1)
                     {
@@ -132,7 +161,7 @@ namespace MWWorld
                             }
                         }
                     }
-                    mPreloadedObjects.insert(mSceneManager->getTemplate(mesh));
+                    mPreloadedObjects.insert(templates[i].get());
                     if (mPreloadInstances)
                         mPreloadedObjects.insert(mBulletShapeManager->cacheInstance(mesh));
                     else
@@ -158,6 +187,7 @@ namespace MWWorld
         Resource::KeyframeManager* mKeyframeManager;
         Terrain::World* mTerrain;
         MWRender::LandManager* mLandManager;
+        SceneUtil::WorkQueue* mWorkQueue;
         bool mPreloadInstances;
 
         std::atomic<bool> mAbort;
@@ -181,6 +211,8 @@ namespace MWWorld
 
         void doWork() override
         {
+            const Debug::ScopedTrace trace("Preload terrain");
+
             for (unsigned int i=0; i<mTerrainViews.size() && i<mPreloadPositions.size() && !mAbort; ++i)
             {
                 mTerrainViews[i]->reset();
@@ -245,7 +277,7 @@ namespace MWWorld
     {
         if (mTerrainPreloadItem)
         {
-            mTerrainPreloadItem->abort();
+            mTerrainPreloadItem->cancel();
             mTerrainPreloadItem->waitTillDone();
             mTerrainPreloadItem = nullptr;
         }
@@ -257,7 +289,7 @@ namespace MWWorld
         }
 
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
-            it->second.mWorkItem->abort();
+            it->second.mWorkItem->cancel();
 
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
             it->second.mWorkItem->waitTillDone();
@@ -265,7 +297,12 @@ namespace MWWorld
         mPreloadCells.clear();
     }
 
-    void CellPreloader::preload(CellStore *cell, double timestamp)
+    double CellPreloader::getScore(const PreloadEntry& entry, double timestamp)
+    {
+        return entry.mTimeToArrival + (timestamp - entry.mTimeStamp);
+    }
+
+    void CellPreloader::preload(CellStore *cell, double timestamp, float timeToArrival, PreloadReason reason)
     {
         if (!mWorkQueue)
         {
@@ -281,39 +318,45 @@ namespace MWWorld
         PreloadMap::iterator found = mPreloadCells.find(cell);
         if (found != mPreloadCells.end())
         {
-            // already preloaded, nothing to do other than updating the timestamp
+            // already preloaded, nothing to do other than updating the timestamp and the estimate
+            // a cell requested for several reasons in one frame keeps the most urgent estimate
+            if (found->second.mTimeStamp != timestamp || timeToArrival < found->second.mTimeToArrival)
+            {
+                found->second.mTimeToArrival = timeToArrival;
+                found->second.mReason = reason;
+            }
             found->second.mTimeStamp = timestamp;
             return;
         }
 
         while (mPreloadCells.size() >= mMaxCacheSize)
         {
-            // throw out oldest cell to make room
-            PreloadMap::iterator oldestCell = mPreloadCells.begin();
-            double oldestTimestamp = std::numeric_limits<double>::max();
-            double threshold = 1.0; // seconds
+            // throw out the cell that is expected to be needed last to make room
+            PreloadMap::iterator worstCell = mPreloadCells.begin();
+            double worstScore = std::numeric_limits<double>::lowest();
             for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end(); ++it)
             {
-                if (it->second.mTimeStamp < oldestTimestamp)
+                const double score = getScore(it->second, timestamp);
+                if (score > worstScore)
                 {
-                    oldestTimestamp = it->second.mTimeStamp;
-                    oldestCell = it;
+                    worstScore = score;
+                    worstCell = it;
                 }
             }
 
-            if (oldestTimestamp + threshold < timestamp)
-            {
-                oldestCell->second.mWorkItem->abort();
-                mPreloadCells.erase(oldestCell);
-            }
-            else
+            if (worstCell == mPreloadCells.end() || worstScore <= timeToArrival)
                 return;
+
+            if (worstCell->second.mWorkItem)
+                worstCell->second.mWorkItem->cancel();
+            mPreloadCells.erase(worstCell);
+            ++mEvictions;
         }
 
-        osg::ref_ptr<PreloadItem> item (new PreloadItem(cell, mResourceSystem->getSceneManager(), mBulletShapeManager, mResourceSystem->getKeyframeManager(), mTerrain, mLandManager, mPreloadInstances));
-        mWorkQueue->addWorkItem(item);
+        osg::ref_ptr<PreloadItem> item (new PreloadItem(cell, mResourceSystem->getSceneManager(), mBulletShapeManager, mResourceSystem->getKeyframeManager(), mTerrain, mLandManager, mWorkQueue.get(), mPreloadInstances));
+        mWorkQueue->addWorkItem(item, SceneUtil::WorkPriority::High);
 
-        mPreloadCells[cell] = PreloadEntry(timestamp, item);
+        mPreloadCells[cell] = PreloadEntry(timestamp, item, timeToArrival, reason);
     }
 
     void CellPreloader::notifyLoaded(CellStore *cell)
@@ -323,12 +366,28 @@ namespace MWWorld
         {
             if (found->second.mWorkItem)
             {
-                found->second.mWorkItem->abort();
+                if (found->second.mWorkItem->isDone())
+                    ++mHits[static_cast<int>(found->second.mReason)];
+                else
+                    ++mMisses;
+                found->second.mWorkItem->cancel();
                 found->second.mWorkItem = nullptr;
             }
 
             mPreloadCells.erase(found);
         }
+        else
+            ++mMisses;
+    }
+
+    void CellPreloader::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        stats.setAttribute(frameNumber, "Preload Cells", mPreloadCells.size());
+        stats.setAttribute(frameNumber, "Preload Grid Hits", mHits[static_cast<int>(PreloadReason::ExteriorGrid)]);
+        stats.setAttribute(frameNumber, "Preload Door Hits", mHits[static_cast<int>(PreloadReason::Door)]);
+        stats.setAttribute(frameNumber, "Preload Travel Hits", mHits[static_cast<int>(PreloadReason::FastTravel)]);
+        stats.setAttribute(frameNumber, "Preload Misses", mMisses);
+        stats.setAttribute(frameNumber, "Preload Evictions", mEvictions);
     }
 
     void CellPreloader::clear()
@@ -337,7 +396,7 @@ namespace MWWorld
         {
             if (it->second.mWorkItem)
             {
-                it->second.mWorkItem->abort();
+                it->second.mWorkItem->cancel();
                 it->second.mWorkItem = nullptr;
             }
 
@@ -353,7 +412,7 @@ namespace MWWorld
             {
                 if (it->second.mWorkItem)
                 {
-                    it->second.mWorkItem->abort();
+                    it->second.mWorkItem->cancel();
                     it->second.mWorkItem = nullptr;
                 }
                 mPreloadCells.erase(it++);
@@ -366,7 +425,7 @@ namespace MWWorld
         {
             // the resource cache is cleared from the worker thread so that we're not holding up the main thread with delete operations
             mUpdateCacheItem = new UpdateCacheItem(mResourceSystem, timestamp);
-            mWorkQueue->addWorkItem(mUpdateCacheItem, true);
+            mWorkQueue->addWorkItem(mUpdateCacheItem, SceneUtil::WorkPriority::Normal, true);
             mLastResourceCacheUpdate = timestamp;
         }
 
@@ -428,7 +487,7 @@ namespace MWWorld
             return;
         if (mTerrainPreloadItem && !mTerrainPreloadItem->isDone())
         {
-            mTerrainPreloadItem->abort();
+            mTerrainPreloadItem->cancel();
             mTerrainPreloadItem->waitTillDone();
         }
         setTerrainPreloadPositions(std::vector<CellPreloader::PositionCellGrid>());
@@ -7,6 +7,11 @@
 #include <osg/Vec4i>
 #include <components/sceneutil/workqueue.hpp>
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace Resource
 {
     class ResourceSystem;
@@ -34,6 +39,15 @@ namespace MWWorld
     class CellStore;
     class TerrainPreloadItem;
 
+    /// Why a cell is expected to be needed soon, used for hit/miss statistics.
+    enum class PreloadReason
+    {
+        ExteriorGrid,
+        Door,
+        FastTravel,
+        Count
+    };
+
     class CellPreloader
     {
     public:
@@ -41,8 +55,11 @@ namespace MWWorld
         ~CellPreloader();
 
         /// Ask a background thread to preload rendering meshes and collision shapes for objects in this cell.
+        /// @param timeToArrival Estimated time in seconds until the cell is needed, lower values are kept in the cache
+        /// in favour of higher ones when it's full.
         /// @note The cell itself must be in State_Loaded or State_Preloaded.
-        void preload(MWWorld::CellStore* cell, double timestamp);
+        void preload(MWWorld::CellStore* cell, double timestamp, float timeToArrival = 0,
+                     PreloadReason reason = PreloadReason::ExteriorGrid);
 
         void notifyLoaded(MWWorld::CellStore* cell);
 
@@ -74,6 +91,8 @@ namespace MWWorld
         void abortTerrainPreloadExcept(const PositionCellGrid *exceptPos);
         bool isTerrainLoaded(const CellPreloader::PositionCellGrid &position, double referenceTime) const;
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
     private:
         Resource::ResourceSystem* mResourceSystem;
         Resource::BulletShapeManager* mBulletShapeManager;
@@ -89,19 +108,28 @@ namespace MWWorld
 
         struct PreloadEntry
         {
-            PreloadEntry(double timestamp, osg::ref_ptr<SceneUtil::WorkItem> workItem)
+            PreloadEntry(double timestamp, osg::ref_ptr<SceneUtil::WorkItem> workItem, float timeToArrival, PreloadReason reason)
                 : mTimeStamp(timestamp)
                 , mWorkItem(workItem)
+                , mTimeToArrival(timeToArrival)
+                , mReason(reason)
             {
             }
             PreloadEntry()
                 : mTimeStamp(0.0)
+                , mTimeToArrival(0.f)
+                , mReason(PreloadReason::ExteriorGrid)
             {
             }
 
             double mTimeStamp;
             osg::ref_ptr<SceneUtil::WorkItem> mWorkItem;
+            float mTimeToArrival;
+            PreloadReason mReason;
         };
+
+        /// Estimated time until the cell is needed; the estimate gets older as long as the cell is not requested again.
+        static double getScore(const PreloadEntry& entry, double timestamp);
         typedef std::map<const MWWorld::CellStore*, PreloadEntry> PreloadMap;
 
         // Cells that are currently being preloaded, or have already finished preloading
@@ -114,6 +142,13 @@ namespace MWWorld
 
         std::vector<PositionCellGrid> mLoadedTerrainPositions;
         double mLoadedTerrainTimestamp;
+
+        // Cells that finished preloading before they were loaded, per reason
+        unsigned int mHits[static_cast<int>(PreloadReason::Count)] = {};
+        // Cells loaded without a finished preload
+        unsigned int mMisses = 0;
+        // Preloaded cells thrown out to make room for more urgent ones
+        unsigned int mEvictions = 0;
     };
 
 }
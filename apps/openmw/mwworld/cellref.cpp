@@ -7,10 +7,99 @@
 
 namespace MWWorld
 {
+    namespace
+    {
+        const ESM::Position emptyPosition {{0, 0, 0}, {0, 0, 0}};
+
+        const std::string emptyString;
+    }
+
+    CellRef::CellRef(const ESM::CellRef& ref)
+        : mRefNum(ref.mRefNum)
+        , mRefId(ref.mRefID)
+        , mPos(ref.mPos)
+        , mScale(ref.mScale)
+        , mOwner(ref.mOwner)
+        , mFaction(ref.mFaction)
+        , mFactionRank(ref.mFactionRank)
+        , mChargeInt(ref.mChargeInt)
+        , mChargeIntRemainder(ref.mChargeIntRemainder)
+        , mEnchantmentCharge(ref.mEnchantmentCharge)
+        , mGoldValue(ref.mGoldValue)
+        , mLockLevel(ref.mLockLevel)
+        , mReferenceBlocked(ref.mReferenceBlocked)
+        , mChanged(false)
+    {
+        if (ref.mTeleport || !ref.mDestCell.empty() || !ref.mGlobalVariable.empty() || !ref.mSoul.empty()
+            || !ref.mKey.empty() || !ref.mTrap.empty())
+        {
+            mRare = std::make_unique<RareFields>(RareFields {ref.mTeleport, ref.mDoorDest,
+                Misc::InternedString(ref.mDestCell), Misc::InternedString(ref.mGlobalVariable),
+                Misc::InternedString(ref.mSoul), Misc::InternedString(ref.mKey), Misc::InternedString(ref.mTrap)});
+        }
+    }
+
+    CellRef::CellRef(const CellRef& other)
+        : mRefNum(other.mRefNum)
+        , mRefId(other.mRefId)
+        , mPos(other.mPos)
+        , mScale(other.mScale)
+        , mOwner(other.mOwner)
+        , mFaction(other.mFaction)
+        , mFactionRank(other.mFactionRank)
+        , mChargeInt(other.mChargeInt)
+        , mChargeIntRemainder(other.mChargeIntRemainder)
+        , mEnchantmentCharge(other.mEnchantmentCharge)
+        , mGoldValue(other.mGoldValue)
+        , mLockLevel(other.mLockLevel)
+        , mRare(other.mRare == nullptr ? nullptr : std::make_unique<RareFields>(*other.mRare))
+        , mReferenceBlocked(other.mReferenceBlocked)
+        , mChanged(other.mChanged)
+    {
+    }
+
+    CellRef& CellRef::operator=(const CellRef& other)
+    {
+        if (this != &other)
+            *this = CellRef(other);
+        return *this;
+    }
+
+    CellRef::~CellRef() = default;
+
+    const ESM::Position& CellRef::getDoorDest() const
+    {
+        return mRare == nullptr ? emptyPosition : mRare->mDoorDest;
+    }
+
+    const std::string& CellRef::getDestCell() const
+    {
+        return mRare == nullptr ? emptyString : mRare->mDestCell.get();
+    }
+
+    const std::string& CellRef::getGlobalVariable() const
+    {
+        return mRare == nullptr ? emptyString : mRare->mGlobalVariable.get();
+    }
+
+    const std::string& CellRef::getSoul() const
+    {
+        return mRare == nullptr ? emptyString : mRare->mSoul.get();
+    }
+
+    const std::string& CellRef::getKey() const
+    {
+        return mRare == nullptr ? emptyString : mRare->mKey.get();
+    }
+
+    const std::string& CellRef::getTrap() const
+    {
+        return mRare == nullptr ? emptyString : mRare->mTrap.get();
+    }
 
     const ESM::RefNum& CellRef::getOrAssignRefNum(ESM::RefNum& lastAssignedRefNum)
     {
-        if (!mCellRef.mRefNum.isSet())
+        if (!mRefNum.isSet())
         {
             // Generated RefNums have negative mContentFile
             assert(lastAssignedRefNum.mContentFile < 0);
@@ -22,30 +111,30 @@ namespace MWWorld
                 else
                     Log(Debug::Error) << "RefNum counter overflow in CellRef::getOrAssignRefNum";
             }
-            mCellRef.mRefNum = lastAssignedRefNum;
+            mRefNum = lastAssignedRefNum;
             mChanged = true;
         }
-        return mCellRef.mRefNum;
+        return mRefNum;
     }
 
     void CellRef::unsetRefNum()
     {
-        mCellRef.mRefNum.unset();
+        mRefNum.unset();
     }
 
     void CellRef::setScale(float scale)
     {
-        if (scale != mCellRef.mScale)
+        if (scale != mScale)
         {
             mChanged = true;
-            mCellRef.mScale = scale;
+            mScale = scale;
         }
     }
 
     void CellRef::setPosition(const ESM::Position &position)
     {
         mChanged = true;
-        mCellRef.mPos = position;
+        mPos = position;
     }
 
     float CellRef::getNormalizedEnchantmentCharge(int maxCharge) const
@@ -54,112 +143,112 @@ namespace MWWorld
         {
             return 0;
         }
-        else if (mCellRef.mEnchantmentCharge == -1)
+        else if (mEnchantmentCharge == -1)
         {
             return 1;
         }
         else
         {
-            return mCellRef.mEnchantmentCharge / static_cast<float>(maxCharge);
+            return mEnchantmentCharge / static_cast<float>(maxCharge);
         }
     }
 
     void CellRef::setEnchantmentCharge(float charge)
     {
-        if (charge != mCellRef.mEnchantmentCharge)
+        if (charge != mEnchantmentCharge)
         {
             mChanged = true;
-            mCellRef.mEnchantmentCharge = charge;
+            mEnchantmentCharge = charge;
         }
     }
 
     void CellRef::setCharge(int charge)
     {
-        if (charge != mCellRef.mChargeInt)
+        if (charge != mChargeInt)
         {
             mChanged = true;
-            mCellRef.mChargeInt = charge;
+            mChargeInt = charge;
         }
     }
 
     void CellRef::applyChargeRemainderToBeSubtracted(float chargeRemainder)
     {
-        mCellRef.mChargeIntRemainder += std::abs(chargeRemainder);
-        if (mCellRef.mChargeIntRemainder > 1.0f)
+        mChargeIntRemainder += std::abs(chargeRemainder);
+        if (mChargeIntRemainder > 1.0f)
         {
-            float newChargeRemainder = (mCellRef.mChargeIntRemainder - std::floor(mCellRef.mChargeIntRemainder));
-            if (mCellRef.mChargeInt <= static_cast<int>(mCellRef.mChargeIntRemainder))
+            float newChargeRemainder = (mChargeIntRemainder - std::floor(mChargeIntRemainder));
+            if (mChargeInt <= static_cast<int>(mChargeIntRemainder))
             {
-                mCellRef.mChargeInt = 0;
+                mChargeInt = 0;
             }
             else
             {
-                mCellRef.mChargeInt -= static_cast<int>(mCellRef.mChargeIntRemainder);
+                mChargeInt -= static_cast<int>(mChargeIntRemainder);
             }
-            mCellRef.mChargeIntRemainder = newChargeRemainder;
+            mChargeIntRemainder = newChargeRemainder;
         }
     }
 
     void CellRef::setChargeFloat(float charge)
     {
-        if (charge != mCellRef.mChargeFloat)
+        if (charge != mChargeFloat)
         {
             mChanged = true;
-            mCellRef.mChargeFloat = charge;
+            mChargeFloat = charge;
         }
     }
 
     void CellRef::resetGlobalVariable()
     {
-        if (!mCellRef.mGlobalVariable.empty())
+        if (mRare != nullptr && !mRare->mGlobalVariable.empty())
         {
             mChanged = true;
-            mCellRef.mGlobalVariable.erase();
+            mRare->mGlobalVariable = Misc::InternedString();
         }
     }
 
     void CellRef::setFactionRank(int factionRank)
     {
-        if (factionRank != mCellRef.mFactionRank)
+        if (factionRank != mFactionRank)
         {
             mChanged = true;
-            mCellRef.mFactionRank = factionRank;
+            mFactionRank = factionRank;
         }
     }
 
     void CellRef::setOwner(const std::string &owner)
     {
-        if (owner != mCellRef.mOwner)
+        if (owner != mOwner.get())
         {
             mChanged = true;
-            mCellRef.mOwner = owner;
+            mOwner = Misc::InternedString(owner);
         }
     }
 
     void CellRef::setSoul(const std::string &soul)
     {
-        if (soul != mCellRef.mSoul)
+        if (soul != getSoul())
         {
             mChanged = true;
-            mCellRef.mSoul = soul;
+            getOrCreateRare().mSoul = Misc::InternedString(soul);
         }
     }
 
     void CellRef::setFaction(const std::string &faction)
     {
-        if (faction != mCellRef.mFaction)
+        if (faction != mFaction.get())
         {
             mChanged = true;
-            mCellRef.mFaction = faction;
+            mFaction = Misc::InternedString(faction);
         }
     }
 
     void CellRef::setLockLevel(int lockLevel)
     {
-        if (lockLevel != mCellRef.mLockLevel)
+        if (lockLevel != mLockLevel)
         {
             mChanged = true;
-            mCellRef.mLockLevel = lockLevel;
+            mLockLevel = lockLevel;
         }
     }
 
@@ -173,30 +262,61 @@ namespace MWWorld
 
     void CellRef::unlock()
     {
-        setLockLevel(-abs(mCellRef.mLockLevel)); //Makes lockLevel negative
+        setLockLevel(-abs(mLockLevel)); //Makes lockLevel negative
     }
 
     void CellRef::setTrap(const std::string& trap)
     {
-        if (trap != mCellRef.mTrap)
+        if (trap != getTrap())
         {
             mChanged = true;
-            mCellRef.mTrap = trap;
+            getOrCreateRare().mTrap = Misc::InternedString(trap);
         }
     }
 
     void CellRef::setGoldValue(int value)
     {
-        if (value != mCellRef.mGoldValue)
+        if (value != mGoldValue)
         {
             mChanged = true;
-            mCellRef.mGoldValue = value;
+            mGoldValue = value;
         }
     }
 
     void CellRef::writeState(ESM::ObjectState &state) const
     {
-        state.mRef = mCellRef;
+        ESM::CellRef& ref = state.mRef;
+        ref.blank();
+        ref.mRefNum = mRefNum;
+        ref.mRefID = mRefId.get();
+        ref.mScale = mScale;
+        ref.mOwner = mOwner.get();
+        ref.mFaction = mFaction.get();
+        ref.mFactionRank = mFactionRank;
+        ref.mChargeInt = mChargeInt;
+        ref.mChargeIntRemainder = mChargeIntRemainder;
+        ref.mEnchantmentCharge = mEnchantmentCharge;
+        ref.mGoldValue = mGoldValue;
+        ref.mLockLevel = mLockLevel;
+        ref.mReferenceBlocked = mReferenceBlocked;
+        ref.mPos = mPos;
+        if (mRare != nullptr)
+        {
+            ref.mTeleport = mRare->mTeleport;
+            ref.mDoorDest = mRare->mDoorDest;
+            ref.mDestCell = mRare->mDestCell.get();
+            ref.mGlobalVariable = mRare->mGlobalVariable.get();
+            ref.mSoul = mRare->mSoul.get();
+            ref.mKey = mRare->mKey.get();
+            ref.mTrap = mRare->mTrap.get();
+        }
+    }
+
+    CellRef::RareFields& CellRef::getOrCreateRare()
+    {
+        if (mRare == nullptr)
+            mRare = std::make_unique<RareFields>(RareFields {false, getDoorDest(), {}, {}, {}, {}, {}});
+        return *mRare;
     }
 
 }
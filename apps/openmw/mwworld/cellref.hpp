@@ -2,6 +2,9 @@
 #define OPENMW_MWWORLD_CELLREF_H
 
 #include <components/esm3/cellref.hpp>
+#include <components/misc/internedstring.hpp>
+
+#include <memory>
 
 namespace ESM
 {
@@ -12,18 +15,26 @@ namespace MWWorld
 {
 
     /// \brief Encapsulated variant of ESM::CellRef with change tracking
+    /// \note Stores ids as interned strings and the fields most references don't use separately,
+    /// so a reference takes a fraction of the size of an ESM::CellRef.
     class CellRef
     {
     public:
 
-        CellRef (const ESM::CellRef& ref)
-            : mCellRef(ref)
-        {
-            mChanged = false;
-        }
+        CellRef (const ESM::CellRef& ref);
+
+        CellRef (const CellRef& other);
+
+        CellRef& operator= (const CellRef& other);
+
+        CellRef (CellRef&& other) = default;
+
+        CellRef& operator= (CellRef&& other) = default;
+
+        ~CellRef();
 
         // Note: Currently unused for items in containers
-        const ESM::RefNum& getRefNum() const { return mCellRef.mRefNum; }
+        const ESM::RefNum& getRefNum() const { return mRefNum; }
 
         // Returns RefNum.
         // If RefNum is not set, assigns a generated one and changes the "lastAssignedRefNum" counter.
@@ -33,32 +44,32 @@ namespace MWWorld
         void unsetRefNum();
 
         /// Does the RefNum have a content file?
-        bool hasContentFile() const { return mCellRef.mRefNum.hasContentFile(); }
+        bool hasContentFile() const { return mRefNum.hasContentFile(); }
 
         // Id of object being referenced
-        const std::string& getRefId() const { return mCellRef.mRefID; }
+        const std::string& getRefId() const { return mRefId.get(); }
 
         // For doors - true if this door teleports to somewhere else, false
         // if it should open through animation.
-        bool getTeleport() const { return mCellRef.mTeleport; }
+        bool getTeleport() const { return mRare != nullptr && mRare->mTeleport; }
 
         // Teleport location for the door, if this is a teleporting door.
-        const ESM::Position& getDoorDest() const { return mCellRef.mDoorDest; }
+        const ESM::Position& getDoorDest() const;
 
         // Destination cell for doors (optional)
-        const std::string& getDestCell() const { return mCellRef.mDestCell; }
+        const std::string& getDestCell() const;
 
         // Scale applied to mesh
-        float getScale() const { return mCellRef.mScale; }
+        float getScale() const { return mScale; }
         void setScale(float scale);
 
         // The *original* position and rotation as it was given in the Construction Set.
         // Current position and rotation of the object is stored in RefData.
-        const ESM::Position& getPosition() const { return mCellRef.mPos; }
+        const ESM::Position& getPosition() const { return mPos; }
         void setPosition (const ESM::Position& position);
 
         // Remaining enchantment charge. This could be -1 if the charge was not touched yet (i.e. full).
-        float getEnchantmentCharge() const { return mCellRef.mEnchantmentCharge; }
+        float getEnchantmentCharge() const { return mEnchantmentCharge; }
 
         // Remaining enchantment charge rescaled to the supplied maximum charge (such as one of the enchantment).
         float getNormalizedEnchantmentCharge(int maxCharge) const;
@@ -68,50 +79,50 @@ namespace MWWorld
         // For weapon or armor, this is the remaining item health.
         // For tools (lockpicks, probes, repair hammer) it is the remaining uses.
         // If this returns int(-1) it means full health.
-        int getCharge() const { return mCellRef.mChargeInt; }
-        float getChargeFloat() const { return mCellRef.mChargeFloat; } // Implemented as union with int charge
+        int getCharge() const { return mChargeInt; }
+        float getChargeFloat() const { return mChargeFloat; } // Implemented as union with int charge
         void setCharge(int charge);
         void setChargeFloat(float charge);
         void applyChargeRemainderToBeSubtracted(float chargeRemainder); // Stores remainders and applies if > 1
 
         // The NPC that owns this object (and will get angry if you steal it)
-        const std::string& getOwner() const { return mCellRef.mOwner; }
+        const std::string& getOwner() const { return mOwner.get(); }
         void setOwner(const std::string& owner);
 
         // Name of a global variable. If the global variable is set to '1', using the object is temporarily allowed
         // even if it has an Owner field.
         // Used by bed rent scripts to allow the player to use the bed for the duration of the rent.
-        const std::string& getGlobalVariable() const { return mCellRef.mGlobalVariable; }
+        const std::string& getGlobalVariable() const;
 
         void resetGlobalVariable();
 
         // ID of creature trapped in this soul gem
-        const std::string& getSoul() const { return mCellRef.mSoul; }
+        const std::string& getSoul() const;
         void setSoul(const std::string& soul);
 
         // The faction that owns this object (and will get angry if
         // you take it and are not a faction member)
-        const std::string& getFaction() const { return mCellRef.mFaction; }
+        const std::string& getFaction() const { return mFaction.get(); }
         void setFaction (const std::string& faction);
 
         // PC faction rank required to use the item. Sometimes is -1, which means "any rank".
         void setFactionRank(int factionRank);
-        int getFactionRank() const { return mCellRef.mFactionRank; }
+        int getFactionRank() const { return mFactionRank; }
 
         // Lock level for doors and containers
         // Positive for a locked door. 0 for a door that was never locked.
         // For an unlocked door, it is set to -(previous locklevel)
-        int getLockLevel() const { return mCellRef.mLockLevel; }
+        int getLockLevel() const { return mLockLevel; }
         void setLockLevel(int lockLevel);
         void lock(int lockLevel);
         void unlock();
          // Key and trap ID names, if any
-        const std::string& getKey() const { return mCellRef.mKey; }
-        const std::string& getTrap() const { return mCellRef.mTrap; }
+        const std::string& getKey() const;
+        const std::string& getTrap() const;
         void setTrap(const std::string& trap);
 
         // This is 5 for Gold_005 references, 100 for Gold_100 and so on.
-        int getGoldValue() const { return mCellRef.mGoldValue; }
+        int getGoldValue() const { return mGoldValue; }
         void setGoldValue(int value);
 
         // Write the content of this CellRef into the given ObjectState
@@ -121,8 +132,39 @@ namespace MWWorld
         bool hasChanged() const { return mChanged; }
 
     private:
+        // Only doors, soul gems, locked or trapped objects and rented beds need these
+        struct RareFields
+        {
+            bool mTeleport = false;
+            ESM::Position mDoorDest;
+            Misc::InternedString mDestCell;
+            Misc::InternedString mGlobalVariable;
+            Misc::InternedString mSoul;
+            Misc::InternedString mKey;
+            Misc::InternedString mTrap;
+        };
+
+        ESM::RefNum mRefNum;
+        Misc::InternedString mRefId;
+        ESM::Position mPos;
+        float mScale;
+        Misc::InternedString mOwner;
+        Misc::InternedString mFaction;
+        int mFactionRank;
+        union
+        {
+            int mChargeInt;
+            float mChargeFloat;
+        };
+        float mChargeIntRemainder;
+        float mEnchantmentCharge;
+        int mGoldValue;
+        int mLockLevel;
+        std::unique_ptr<RareFields> mRare;
+        signed char mReferenceBlocked;
         bool mChanged;
-        ESM::CellRef mCellRef;
+
+        RareFields& getOrCreateRare();
     };
 
 }
@@ -1,8 +1,7 @@
 #ifndef GAME_MWWORLD_CELLREFLIST_H
 #define GAME_MWWORLD_CELLREFLIST_H
 
-#include <list>
-
+#include "chunkedlist.hpp"
 #include "livecellref.hpp"
 
 namespace MWWorld
@@ -12,7 +11,7 @@ namespace MWWorld
     struct CellRefList
     {
         typedef LiveCellRef<X> LiveRef;
-        typedef std::list<LiveRef> List;
+        typedef ChunkedList<LiveRef> List;
         List mList;
 
         /// Search for the given reference in the given reclist from
@@ -31,12 +30,13 @@ namespace MWWorld
         }
 
         /// Remove all references with the given refNum from this list.
+        /// \note Only used while loading references, before pointers to them are handed out.
         void remove (const ESM::RefNum &refNum)
         {
             for (typename List::iterator it = mList.begin(); it != mList.end();)
             {
                 if (*it == refNum)
-                    mList.erase(it++);
+                    it = mList.erase(it);
                 else
                     ++it;
             }
@@ -1,13 +1,20 @@
 #include "cells.hpp"
 
+#include <atomic>
+#include <optional>
+#include <sstream>
+#include <thread>
+
 #include <components/debug/debuglog.hpp>
 #include <components/esm3/esmreader.hpp>
 #include <components/esm3/esmwriter.hpp>
 #include <components/esm/defs.hpp>
 #include <components/esm3/cellstate.hpp>
 #include <components/esm3/cellref.hpp>
+#include <components/esm3/fogstate.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/settings/settings.hpp>
+#include <components/to_utf8/to_utf8.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -96,6 +103,7 @@ void MWWorld::Cells::clear()
     mExteriors.clear();
     std::fill(mIdCache.begin(), mIdCache.end(), std::make_pair("", (MWWorld::CellStore*)nullptr));
     mIdCacheIndex = 0;
+    mSavedCells.clear();
 }
 
 MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore& cellStore)
@@ -115,6 +123,13 @@ MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore&
 
 void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
 {
+    auto saved = mSavedCells.find(&cell);
+    if (saved != mSavedCells.end() && saved->second.mChangeCounter == cell.getChangeCounter())
+    {
+        writer.writeRecord(saved->second.mRecord);
+        return;
+    }
+
     if (cell.getState()!=CellStore::State_Loaded)
         cell.load ();
 
@@ -122,12 +137,24 @@ void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
 
     cell.saveState (cellState);
 
-    writer.startRecord (ESM::REC_CSTA);
-    cellState.mId.save (writer);
-    cellState.save (writer);
-    cell.writeFog(writer);
-    cell.writeReferences (writer);
-    writer.endRecord (ESM::REC_CSTA);
+    std::ostringstream stream;
+    ESM::ESMWriter cellWriter;
+    cellWriter.setEncoder(writer.getEncoder());
+    cellWriter.setVersion(writer.getVersion());
+    cellWriter.saveRecords(stream);
+
+    cellWriter.startRecord (ESM::REC_CSTA);
+    cellState.mId.save (cellWriter);
+    cellState.save (cellWriter);
+    cell.writeFog(cellWriter);
+    cell.writeReferences (cellWriter);
+    cellWriter.endRecord (ESM::REC_CSTA);
+
+    // Writing the references goes through the accessors that count as a change, so take the counter afterwards
+    SavedCell& savedCell = mSavedCells[&cell];
+    savedCell.mChangeCounter = cell.getChangeCounter();
+    savedCell.mRecord = stream.str();
+    writer.writeRecord(savedCell.mRecord);
 }
 
 MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader)
@@ -339,7 +366,7 @@ MWWorld::Ptr MWWorld::Cells::getPtr(CellStore& cellStore, const std::string& id,
         cellStore.preload();
     if (cellStore.getState() == CellStore::State_Preloaded)
     {
-        if (cellStore.hasId(id))
+        if (cellStore.hasRef(id, refNum))
             cellStore.load();
         else
             return Ptr();
@@ -482,3 +509,100 @@ bool MWWorld::Cells::readRecord (ESM::ESMReader& reader, uint32_t type,
 
     return false;
 }
+
+namespace
+{
+    struct ParsedCellState
+    {
+        ESM::CellState mState;
+        bool mHasId = false;
+        std::unique_ptr<ESM::FogState> mFog;
+        MWWorld::CellStore::SavedReferences mReferences;
+        std::string mError;
+    };
+
+    void parseCellState (ESM::ESMReader& reader, ParsedCellState& parsed)
+    {
+        try
+        {
+            parsed.mState.mId.load (reader);
+            parsed.mHasId = true;
+            parsed.mState.load (reader);
+            if (parsed.mState.mHasFogOfWar)
+            {
+                parsed.mFog = std::make_unique<ESM::FogState>();
+                parsed.mFog->load (reader);
+            }
+            MWWorld::CellStore::parseReferences (reader, parsed.mReferences);
+        }
+        catch (const std::exception& e)
+        {
+            parsed.mError = e.what();
+        }
+    }
+}
+
+void MWWorld::Cells::readCellStates (const ESM::ESMReader& file, std::vector<std::vector<char>>& records,
+    const std::map<int, int>& contentFileMap)
+{
+    std::vector<ParsedCellState> parsed(records.size());
+    std::atomic_size_t next {0};
+    const auto work = [&]
+    {
+        // Encoders keep an internal buffer, so each thread needs its own one
+        std::optional<ToUTF8::Utf8Encoder> encoder;
+        if (file.getEncoder() != nullptr)
+            encoder.emplace(*file.getEncoder());
+
+        ESM::ESMReader reader;
+        for (std::size_t i = next++; i < records.size(); i = next++)
+        {
+            reader.openRecord (std::move(records[i]), file);
+            reader.setEncoder (encoder.has_value() ? &*encoder : nullptr);
+            parseCellState (reader, parsed[i]);
+        }
+    };
+
+    const std::size_t threads = std::min<std::size_t>(records.size(), std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers)
+        worker.join();
+    records.clear();
+
+    GetCellStoreCallback callback(*this);
+
+    for (ParsedCellState& cellState : parsed)
+    {
+        if (!cellState.mHasId)
+            throw std::runtime_error (cellState.mError);
+
+        CellStore *cellStore = nullptr;
+
+        try
+        {
+            cellStore = getCell (cellState.mState.mId);
+        }
+        catch (...)
+        {
+            // silently drop cells that don't exist anymore
+            Log(Debug::Warning) << "Warning: Dropping state for cell " << cellState.mState.mId.mWorldspace << " (cell no longer exists)";
+            continue;
+        }
+
+        if (!cellState.mError.empty())
+            throw std::runtime_error (cellState.mError);
+
+        cellStore->loadState (cellState.mState);
+
+        if (cellState.mFog)
+            cellStore->setFog (cellState.mFog.release());
+
+        if (cellStore->getState()!=CellStore::State_Loaded)
+            cellStore->load ();
+
+        cellStore->readReferences (cellState.mReferences, contentFileMap, &callback);
+    }
+}
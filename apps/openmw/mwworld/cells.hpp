@@ -4,6 +4,7 @@
 #include <map>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "ptr.hpp"
 
@@ -36,6 +37,15 @@ namespace MWWorld
             IdCache mIdCache;
             std::size_t mIdCacheIndex;
 
+            struct SavedCell
+            {
+                unsigned int mChangeCounter;
+                std::string mRecord;
+            };
+
+            // Records written for the cells by the last save, reused while a cell does not change
+            mutable std::map<const CellStore*, SavedCell> mSavedCells;
+
             Cells (const Cells&);
             Cells& operator= (const Cells&);
 
@@ -89,6 +99,11 @@ namespace MWWorld
 
             bool readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap);
+
+            void readCellStates (const ESM::ESMReader& file, std::vector<std::vector<char>>& records,
+                const std::map<int, int>& contentFileMap);
+            ///< Parse REC_CSTA records taken from \a file with ESMReader::getRecordData in parallel, then
+            /// apply them in order.
     };
 }
 
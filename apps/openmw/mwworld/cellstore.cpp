@@ -2,6 +2,9 @@
 #include "magiceffects.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
 
 #include <components/debug/debuglog.hpp>
 
@@ -17,6 +20,7 @@
 #include <components/esm3/fogstate.hpp>
 #include <components/esm3/creaturelevliststate.hpp>
 #include <components/esm3/doorstate.hpp>
+#include <components/misc/stringops.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/luamanager.hpp"
@@ -146,15 +150,22 @@ namespace
         fixRestockingImpl(base, state);
     }
 
+    template<typename RecordType>
+    std::unique_ptr<ESM::ObjectState> readObjectState (ESM::ESMReader& reader, const ESM::CellRef& cref)
+    {
+        auto state = std::make_unique<RecordType>();
+        state->mRef = cref;
+        state->load(reader);
+        return state;
+    }
+
     template<typename RecordType, typename T>
-    void readReferenceCollection (ESM::ESMReader& reader,
-        MWWorld::CellRefList<T>& collection, const ESM::CellRef& cref, const std::map<int, int>& contentFileMap, MWWorld::CellStore* cellstore)
+    void readReferenceCollection (ESM::ObjectState& objectState,
+        MWWorld::CellRefList<T>& collection, const std::map<int, int>& contentFileMap, MWWorld::CellStore* cellstore)
     {
         const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
 
-        RecordType state;
-        state.mRef = cref;
-        state.load(reader);
+        RecordType& state = static_cast<RecordType&>(objectState);
 
         // If the reference came from a content file, make sure this content file is loaded
         if (state.mRef.mRefNum.hasContentFile())
@@ -234,7 +245,7 @@ namespace MWWorld
 
         if (const X *ptr = store.search (ref.mRefID))
         {
-            typename std::list<LiveRef>::iterator iter =
+            typename List::iterator iter =
                 std::find(mList.begin(), mList.end(), ref.mRefNum);
 
             LiveRef liveCellRef (ref, ptr);
@@ -273,7 +284,7 @@ namespace MWWorld
         if (mState != State_Loaded)
             load();
 
-        mHasState = true;
+        flagAsChanged();
         MovedRefTracker::iterator found = mMovedToAnotherCell.find(object.getBase());
         if (found != mMovedToAnotherCell.end())
         {
@@ -383,7 +394,7 @@ namespace MWWorld
     }
 
     CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList)
-        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0), mRechargingItemsUpToDate(false)
+        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mChangeCounter (0), mLastRespawn(0,0), mRechargingItemsUpToDate(false)
     {
         mWaterLevel = cell->mWater;
     }
@@ -398,14 +409,20 @@ namespace MWWorld
         return mState;
     }
 
-    const std::vector<std::string> &CellStore::getPreloadedIds() const
+    bool CellStore::hasState() const
+    {
+        return mHasState;
+    }
+
+    unsigned int CellStore::getChangeCounter() const
     {
-        return mIds;
+        return mChangeCounter;
     }
 
-    bool CellStore::hasState() const
+    void CellStore::flagAsChanged()
     {
-        return mHasState;
+        mHasState = true;
+        ++mChangeCounter;
     }
 
     bool CellStore::hasId (const std::string& id) const
@@ -414,11 +431,35 @@ namespace MWWorld
             return false;
 
         if (mState==State_Preloaded)
-            return std::binary_search (mIds.begin(), mIds.end(), id);
+        {
+            const std::size_t hash = Misc::StringUtils::CiHash()(id);
+            const auto it = findPreloadedRef(hash);
+            return it != mPreloadedRefs.end() && it->mIdHash == hash;
+        }
 
         return searchConst (id).isEmpty();
     }
 
+    std::vector<CellStore::PreloadedRef>::const_iterator CellStore::findPreloadedRef (std::size_t idHash) const
+    {
+        return std::lower_bound(mPreloadedRefs.begin(), mPreloadedRefs.end(), idHash,
+            [] (const PreloadedRef& ref, std::size_t value) { return ref.mIdHash < value; });
+    }
+
+    bool CellStore::hasRef (const std::string& id, const ESM::RefNum& refNum) const
+    {
+        if (mState!=State_Preloaded)
+            return hasId (id);
+
+        const std::size_t hash = Misc::StringUtils::CiHash()(id);
+        for (auto it = findPreloadedRef(hash); it != mPreloadedRefs.end() && it->mIdHash == hash; ++it)
+        {
+            if (it->mRefNum == refNum)
+                return true;
+        }
+        return false;
+    }
+
     template <typename PtrType>
     struct SearchVisitor
     {
@@ -453,6 +494,9 @@ namespace MWWorld
 
     Ptr CellStore::searchViaActorId (int id)
     {
+        // The actor may be changed through the returned Ptr
+        ++mChangeCounter;
+
         if (Ptr ptr = ::searchViaActorId (mNpcs, id, this, mMovedToAnotherCell))
             return ptr;
 
@@ -507,7 +551,7 @@ namespace MWWorld
     void CellStore::setWaterLevel (float level)
     {
         mWaterLevel = level;
-        mHasState = true;
+        flagAsChanged();
     }
 
     std::size_t CellStore::count() const
@@ -520,7 +564,10 @@ namespace MWWorld
         if (mState!=State_Loaded)
         {
             if (mState==State_Preloaded)
-                mIds.clear();
+            {
+                mPreloadedRefs.clear();
+                mPreloadedRefs.shrink_to_fit();
+            }
 
             loadRefs ();
 
@@ -575,8 +622,7 @@ namespace MWWorld
                         continue;
                     }
 
-                    Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
-                    mIds.push_back(std::move(ref.mRefID));
+                    mPreloadedRefs.push_back({Misc::StringUtils::CiHash()(ref.mRefID), ref.mRefNum});
                 }
             }
             catch (std::exception& e)
@@ -589,10 +635,11 @@ namespace MWWorld
         for (const auto& [ref, deleted]: mCell->mLeasedRefs)
         {
             if (!deleted)
-                mIds.push_back(Misc::StringUtils::lowerCase(ref.mRefID));
+                mPreloadedRefs.push_back({Misc::StringUtils::CiHash()(ref.mRefID), ref.mRefNum});
         }
 
-        std::sort (mIds.begin(), mIds.end());
+        std::sort (mPreloadedRefs.begin(), mPreloadedRefs.end(),
+            [] (const PreloadedRef& left, const PreloadedRef& right) { return left.mIdHash < right.mIdHash; });
     }
 
     void CellStore::loadRefs()
@@ -604,44 +651,103 @@ namespace MWWorld
         if (mCell->mContextList.empty())
             return; // this is a dynamically generated cell -> skipping.
 
-        std::map<ESM::RefNum, std::string> refNumToID; // used to detect refID modifications
+        // Contexts of the same content file share a reader, so they are parsed by the same thread
+        std::vector<std::vector<std::size_t>> contextsByReader;
+        std::map<int, std::size_t> readerGroups;
+        for (std::size_t i = 0; i < mCell->mContextList.size(); ++i)
+        {
+            const auto group = readerGroups.emplace(mCell->mContextList[i].index, contextsByReader.size()).first;
+            if (group->second == contextsByReader.size())
+                contextsByReader.emplace_back();
+            contextsByReader[group->second].push_back(i);
+        }
 
-        // Load references from all plugins that do something with this cell.
-        for (size_t i = 0; i < mCell->mContextList.size(); i++)
+        std::vector<ParsedRefs> parsed(mCell->mContextList.size());
+        const auto parseGroup = [&] (const std::vector<std::size_t>& contexts)
         {
-            try
+            for (std::size_t i : contexts)
             {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList[i].index;
-                mCell->restore (esm[index], i);
-
-                ESM::CellRef ref;
-                ref.mRefNum.unset();
-
-                // Get each reference in turn
-                ESM::MovedCellRef cMRef;
-                cMRef.mRefNum.mIndex = 0;
-                bool deleted = false;
-                bool moved = false;
-                while(mCell->getNextRef(esm[index], ref, deleted, cMRef, moved))
+                ParsedRefs& refs = parsed[i];
+                try
                 {
-                    if (moved)
-                        continue;
+                    // Reopen the ESM reader and seek to the right position.
+                    int index = mCell->mContextList[i].index;
+                    mCell->restore (esm[index], i);
+
+                    ESM::CellRef ref;
+                    ref.mRefNum.unset();
+
+                    // Get each reference in turn
+                    ESM::MovedCellRef cMRef;
+                    cMRef.mRefNum.mIndex = 0;
+                    bool deleted = false;
+                    bool moved = false;
+                    while(mCell->getNextRef(esm[index], ref, deleted, cMRef, moved))
+                    {
+                        if (moved)
+                            continue;
 
-                    // Don't load reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
+                        // Don't load reference if it was moved to a different cell.
+                        ESM::MovedCellRefTracker::const_iterator iter =
+                            std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
+                        if (iter != mCell->mMovedRefs.end()) {
+                            continue;
+                        }
 
-                    loadRef (ref, deleted, refNumToID);
+                        refs.mRefs.emplace_back(ref, deleted);
+                    }
+                }
+                catch (std::exception& e)
+                {
+                    refs.mError = e.what();
                 }
             }
-            catch (std::exception& e)
+        };
+
+        // Heavily edited cells get references from many content files, parse them in parallel
+        const std::size_t threads = std::min<std::size_t>(contextsByReader.size(), std::thread::hardware_concurrency());
+        if (threads > 1)
+        {
+            std::atomic_size_t next {1};
+            const auto work = [&]
             {
-                Log(Debug::Error) << "An error occurred loading references for cell " << getCell()->getDescription() << ": " << e.what();
-            }
+                for (std::size_t group = next++; group < contextsByReader.size(); group = next++)
+                {
+                    // Encoders keep an internal buffer, so each thread needs its own one
+                    ESM::ESMReader& reader = esm[mCell->mContextList[contextsByReader[group].front()].index];
+                    ToUTF8::Utf8Encoder* const sharedEncoder = reader.getEncoder();
+                    std::optional<ToUTF8::Utf8Encoder> encoder;
+                    if (sharedEncoder != nullptr)
+                        encoder.emplace(*sharedEncoder);
+                    reader.setEncoder(encoder.has_value() ? &*encoder : nullptr);
+                    parseGroup(contextsByReader[group]);
+                    reader.setEncoder(sharedEncoder);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (std::size_t i = 1; i < threads; ++i)
+                workers.emplace_back(work);
+            // The first content file is parsed here with the shared encoder
+            parseGroup(contextsByReader.front());
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+        else
+        {
+            for (const std::vector<std::size_t>& contexts : contextsByReader)
+                parseGroup(contexts);
+        }
+
+        std::map<ESM::RefNum, std::string> refNumToID; // used to detect refID modifications
+
+        // Load references from all plugins that do something with this cell, in the order of the content files.
+        for (ParsedRefs& refs : parsed)
+        {
+            for (auto& [ref, deleted] : refs.mRefs)
+                loadRef (ref, deleted, refNumToID);
+            if (!refs.mError.empty())
+                Log(Debug::Error) << "An error occurred loading references for cell " << getCell()->getDescription() << ": " << refs.mError;
         }
 
         // Load moved references, from separately tracked list.
@@ -665,7 +771,7 @@ namespace MWWorld
     {
         bool oldState = mHasState;
 
-        mHasState = true;
+        flagAsChanged();
 
         if (Ptr ptr = searchInContainerList (mContainers, id))
             return ptr;
@@ -758,7 +864,7 @@ namespace MWWorld
 
     void CellStore::loadState (const ESM::CellState& state)
     {
-        mHasState = true;
+        flagAsChanged();
 
         if (mCell->mData.mFlags & ESM::Cell::Interior && mCell->mData.mFlags & ESM::Cell::HasWater)
             mWaterLevel = state.mWaterLevel;
@@ -827,7 +933,14 @@ namespace MWWorld
 
     void CellStore::readReferences (ESM::ESMReader& reader, const std::map<int, int>& contentFileMap, GetCellStoreCallback* callback)
     {
-        mHasState = true;
+        SavedReferences references;
+        parseReferences (reader, references);
+        readReferences (references, contentFileMap, callback);
+    }
+
+    void CellStore::parseReferences (ESM::ESMReader& reader, SavedReferences& references)
+    {
+        const MWWorld::ESMStore& esmStore = MWBase::Environment::get().getWorld()->getStore();
 
         while (reader.isNextSub ("OBJE"))
         {
@@ -838,10 +951,13 @@ namespace MWWorld
             ESM::CellRef cref;
             cref.loadId(reader, true);
 
-            int type = MWBase::Environment::get().getWorld()->getStore().find(cref.mRefID);
+            int type = esmStore.find(cref.mRefID);
             if (type == 0)
             {
-                Log(Debug::Warning) << "Dropping reference to '" << cref.mRefID << "' (object no longer exists)";
+                // Keep the ID for the warning in readReferences
+                auto state = std::make_unique<ESM::ObjectState>();
+                state->mRef = cref;
+                references.mObjects.emplace_back(type, std::move(state));
                 // Skip until the next OBJE or MVRF
                 while(reader.hasMoreSubs() && !reader.peekNextSub("OBJE") && !reader.peekNextSub("MVRF"))
                 {
@@ -855,107 +971,107 @@ namespace MWWorld
             {
                 case ESM::REC_ACTI:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mActivators, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_ALCH:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mPotions, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_APPA:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mAppas, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_ARMO:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mArmors, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_BOOK:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mBooks, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_CLOT:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mClothes, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_CONT:
 
-                    readReferenceCollection<ESM::ContainerState> (reader, mContainers, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ContainerState> (reader, cref));
                     break;
 
                 case ESM::REC_CREA:
 
-                    readReferenceCollection<ESM::CreatureState> (reader, mCreatures, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::CreatureState> (reader, cref));
                     break;
 
                 case ESM::REC_DOOR:
 
-                    readReferenceCollection<ESM::DoorState> (reader, mDoors, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::DoorState> (reader, cref));
                     break;
 
                 case ESM::REC_INGR:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mIngreds, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_LEVC:
 
-                    readReferenceCollection<ESM::CreatureLevListState> (reader, mCreatureLists, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::CreatureLevListState> (reader, cref));
                     break;
 
                 case ESM::REC_LEVI:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mItemLists, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_LIGH:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mLights, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_LOCK:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mLockpicks, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_MISC:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mMiscItems, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_NPC_:
 
-                    readReferenceCollection<ESM::NpcState> (reader, mNpcs, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::NpcState> (reader, cref));
                     break;
 
                 case ESM::REC_PROB:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mProbes, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_REPA:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mRepairs, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_STAT:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mStatics, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_WEAP:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mWeapons, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 case ESM::REC_BODY:
 
-                    readReferenceCollection<ESM::ObjectState> (reader, mBodyParts, cref, contentFileMap, this);
+                    references.mObjects.emplace_back(type, readObjectState<ESM::ObjectState> (reader, cref));
                     break;
 
                 default:
@@ -964,10 +1080,6 @@ namespace MWWorld
             }
         }
 
-        // Do another update here to make sure objects referred to by MVRF tags can be found
-        // This update is only needed for old saves that used the old copy&delete way of moving objects
-        updateMergedRefs();
-
         while (reader.isNextSub("MVRF"))
         {
             reader.cacheSubName();
@@ -975,7 +1087,140 @@ namespace MWWorld
             ESM::CellId movedTo;
             refnum.load(reader, true, "MVRF");
             movedTo.load(reader);
+            references.mMovedRefs.emplace_back(refnum, std::move(movedTo));
+        }
+    }
+
+    void CellStore::readReferences (SavedReferences& references, const std::map<int, int>& contentFileMap, GetCellStoreCallback* callback)
+    {
+        flagAsChanged();
+
+        for (const auto& [type, state] : references.mObjects)
+        {
+            switch (type)
+            {
+                case 0:
+
+                    Log(Debug::Warning) << "Dropping reference to '" << state->mRef.mRefID << "' (object no longer exists)";
+                    break;
+
+                case ESM::REC_ACTI:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mActivators, contentFileMap, this);
+                    break;
+
+                case ESM::REC_ALCH:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mPotions, contentFileMap, this);
+                    break;
+
+                case ESM::REC_APPA:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mAppas, contentFileMap, this);
+                    break;
+
+                case ESM::REC_ARMO:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mArmors, contentFileMap, this);
+                    break;
+
+                case ESM::REC_BOOK:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mBooks, contentFileMap, this);
+                    break;
+
+                case ESM::REC_CLOT:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mClothes, contentFileMap, this);
+                    break;
+
+                case ESM::REC_CONT:
+
+                    readReferenceCollection<ESM::ContainerState> (*state, mContainers, contentFileMap, this);
+                    break;
+
+                case ESM::REC_CREA:
+
+                    readReferenceCollection<ESM::CreatureState> (*state, mCreatures, contentFileMap, this);
+                    break;
+
+                case ESM::REC_DOOR:
+
+                    readReferenceCollection<ESM::DoorState> (*state, mDoors, contentFileMap, this);
+                    break;
+
+                case ESM::REC_INGR:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mIngreds, contentFileMap, this);
+                    break;
+
+                case ESM::REC_LEVC:
+
+                    readReferenceCollection<ESM::CreatureLevListState> (*state, mCreatureLists, contentFileMap, this);
+                    break;
+
+                case ESM::REC_LEVI:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mItemLists, contentFileMap, this);
+                    break;
 
+                case ESM::REC_LIGH:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mLights, contentFileMap, this);
+                    break;
+
+                case ESM::REC_LOCK:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mLockpicks, contentFileMap, this);
+                    break;
+
+                case ESM::REC_MISC:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mMiscItems, contentFileMap, this);
+                    break;
+
+                case ESM::REC_NPC_:
+
+                    readReferenceCollection<ESM::NpcState> (*state, mNpcs, contentFileMap, this);
+                    break;
+
+                case ESM::REC_PROB:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mProbes, contentFileMap, this);
+                    break;
+
+                case ESM::REC_REPA:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mRepairs, contentFileMap, this);
+                    break;
+
+                case ESM::REC_STAT:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mStatics, contentFileMap, this);
+                    break;
+
+                case ESM::REC_WEAP:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mWeapons, contentFileMap, this);
+                    break;
+
+                case ESM::REC_BODY:
+
+                    readReferenceCollection<ESM::ObjectState> (*state, mBodyParts, contentFileMap, this);
+                    break;
+
+                default:
+
+                    throw std::runtime_error ("unknown type in cell reference section");
+            }
+        }
+
+        // Do another update here to make sure objects referred to by MVRF tags can be found
+        // This update is only needed for old saves that used the old copy&delete way of moving objects
+        updateMergedRefs();
+
+        for (auto [refnum, movedTo] : references.mMovedRefs)
+        {
             if (refnum.hasContentFile())
             {
                 auto iter = contentFileMap.find(refnum.mContentFile);
@@ -1051,6 +1296,7 @@ namespace MWWorld
     {
         if (mState == State_Loaded)
         {
+            ++mChangeCounter;
             for (CellRefList<ESM::Creature>::List::iterator it (mCreatures.mList.begin()); it!=mCreatures.mList.end(); ++it)
             {
                 Ptr ptr = getCurrentPtr(&*it);
@@ -1077,6 +1323,7 @@ namespace MWWorld
 
         if (mState == State_Loaded)
         {
+            ++mChangeCounter;
             for (CellRefList<ESM::Creature>::List::iterator it (mCreatures.mList.begin()); it!=mCreatures.mList.end(); ++it)
             {
                 Ptr ptr = getCurrentPtr(&*it);
@@ -1111,6 +1358,7 @@ namespace MWWorld
     {
         if (mState == State_Loaded)
         {
+            ++mChangeCounter;
             static const int iMonthsToRespawn = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("iMonthsToRespawn")->mValue.getInteger();
             if (MWBase::Environment::get().getWorld()->getTimeStamp() - mLastRespawn > 24*30*iMonthsToRespawn)
             {
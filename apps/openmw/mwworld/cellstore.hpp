@@ -7,6 +7,7 @@
 #include <typeinfo>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "livecellref.hpp"
 #include "cellreflist.hpp"
@@ -31,6 +32,9 @@
 #include <components/esm3/loadnpc.hpp>
 #include <components/esm3/loadmisc.hpp>
 #include <components/esm3/loadbody.hpp>
+#include <components/esm3/cellid.hpp>
+#include <components/esm3/cellref.hpp>
+#include <components/esm3/objectstate.hpp>
 
 #include "timestamp.hpp"
 #include "ptr.hpp"
@@ -71,7 +75,17 @@ namespace MWWorld
             const ESM::Cell *mCell;
             State mState;
             bool mHasState;
-            std::vector<std::string> mIds;
+            unsigned int mChangeCounter;
+
+            struct PreloadedRef
+            {
+                std::size_t mIdHash;
+                ESM::RefNum mRefNum;
+            };
+
+            // Index of the references listed in State_Preloaded, sorted by mIdHash. Much smaller than the references
+            // themselves, so cells that are only searched don't have to keep all of their ids around.
+            std::vector<PreloadedRef> mPreloadedRefs;
             float mWaterLevel;
 
             MWWorld::TimeStamp mLastRespawn;
@@ -203,7 +217,7 @@ namespace MWWorld
             template <typename T>
             LiveCellRefBase* insert(const LiveCellRef<T>* ref)
             {
-                mHasState = true;
+                flagAsChanged();
                 CellRefList<T>& list = get<T>();
                 LiveCellRefBase* ret = &list.insert(*ref);
                 updateMergedRefs();
@@ -219,17 +233,25 @@ namespace MWWorld
 
             State getState() const;
 
-            const std::vector<std::string>& getPreloadedIds() const;
-            ///< Get Ids of objects in this cell, only valid in State_Preloaded
-
             bool hasState() const;
             ///< Does this cell have state that needs to be stored in a saved game file?
 
+            unsigned int getChangeCounter() const;
+            ///< Increased by every access that may change the state of the cell, so the state written to a
+            /// saved game file is still up to date as long as this value stays the same.
+
+            void flagAsChanged();
+            ///< Set the hasState flag and increase the change counter.
+
             bool hasId (const std::string& id) const;
             ///< May return true for deleted IDs when in preload state. Will return false, if cell is
             /// unloaded.
             /// @note Will not account for moved references which may exist in Loaded state. Use search() instead if the cell is loaded.
 
+            bool hasRef (const std::string& id, const ESM::RefNum& refNum) const;
+            ///< Like hasId, but in preload state also requires a reference with \a refNum, so searching
+            /// for a specific reference doesn't load every cell that has an object with the same ID.
+
             Ptr search (const std::string& id);
             ///< Will return an empty Ptr if cell is not loaded. Does not check references in
             /// containers.
@@ -283,7 +305,7 @@ namespace MWWorld
                 if (mMergedRefs.empty())
                     return true;
 
-                mHasState = true;
+                flagAsChanged();
 
                 for (unsigned int i=0; i<mMergedRefs.size(); ++i)
                 {
@@ -333,7 +355,7 @@ namespace MWWorld
                 if (mMergedRefs.empty())
                     return true;
 
-                mHasState = true;
+                flagAsChanged();
 
                 CellRefList<T>& list = get<T>();
 
@@ -394,6 +416,21 @@ namespace MWWorld
             /// @param callback to use for retrieving of additional CellStore objects by ID (required for resolving moved references)
             void readReferences (ESM::ESMReader& reader, const std::map<int, int>& contentFileMap, GetCellStoreCallback* callback);
 
+            /// \brief References of a cell as read from a saved game, before they are added to the cell
+            struct SavedReferences
+            {
+                // Record type of the object, or 0 if it doesn't exist anymore, and its state
+                std::vector<std::pair<int, std::unique_ptr<ESM::ObjectState>>> mObjects;
+                std::vector<std::pair<ESM::RefNum, ESM::CellId>> mMovedRefs;
+            };
+
+            static void parseReferences (ESM::ESMReader& reader, SavedReferences& references);
+            ///< Read the references written by writeReferences without changing any CellStore, so several
+            /// cells can be read in parallel.
+
+            void readReferences (SavedReferences& references, const std::map<int, int>& contentFileMap, GetCellStoreCallback* callback);
+            ///< Add references read with parseReferences.
+
             void respawn ();
             ///< Check mLastRespawn and respawn references if necessary. This is a no-op if the cell is not loaded.
 
@@ -401,9 +438,19 @@ namespace MWWorld
 
         private:
 
-            /// Run through references and store IDs
+            /// Run through references and index their IDs and RefNums
             void listRefs();
 
+            std::vector<PreloadedRef>::const_iterator findPreloadedRef (std::size_t idHash) const;
+            ///< First entry of mPreloadedRefs with \a idHash or a greater one.
+
+            struct ParsedRefs
+            {
+                // (reference, deleted)
+                std::vector<std::pair<ESM::CellRef, bool>> mRefs;
+                std::string mError;
+            };
+
             void loadRefs();
 
             void loadRef (ESM::CellRef& ref, bool deleted, std::map<ESM::RefNum, std::string>& refNumToID);
@@ -415,147 +462,147 @@ namespace MWWorld
     template<>
     inline CellRefList<ESM::Activator>& CellStore::get<ESM::Activator>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mActivators;
     }
 
     template<>
     inline CellRefList<ESM::Potion>& CellStore::get<ESM::Potion>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mPotions;
     }
 
     template<>
     inline CellRefList<ESM::Apparatus>& CellStore::get<ESM::Apparatus>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mAppas;
     }
 
     template<>
     inline CellRefList<ESM::Armor>& CellStore::get<ESM::Armor>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mArmors;
     }
 
     template<>
     inline CellRefList<ESM::Book>& CellStore::get<ESM::Book>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mBooks;
     }
 
     template<>
     inline CellRefList<ESM::Clothing>& CellStore::get<ESM::Clothing>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mClothes;
     }
 
     template<>
     inline CellRefList<ESM::Container>& CellStore::get<ESM::Container>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mContainers;
     }
 
     template<>
     inline CellRefList<ESM::Creature>& CellStore::get<ESM::Creature>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mCreatures;
     }
 
     template<>
     inline CellRefList<ESM::Door>& CellStore::get<ESM::Door>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mDoors;
     }
 
     template<>
     inline CellRefList<ESM::Ingredient>& CellStore::get<ESM::Ingredient>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mIngreds;
     }
 
     template<>
     inline CellRefList<ESM::CreatureLevList>& CellStore::get<ESM::CreatureLevList>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mCreatureLists;
     }
 
     template<>
     inline CellRefList<ESM::ItemLevList>& CellStore::get<ESM::ItemLevList>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mItemLists;
     }
 
     template<>
     inline CellRefList<ESM::Light>& CellStore::get<ESM::Light>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mLights;
     }
 
     template<>
     inline CellRefList<ESM::Lockpick>& CellStore::get<ESM::Lockpick>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mLockpicks;
     }
 
     template<>
     inline CellRefList<ESM::Miscellaneous>& CellStore::get<ESM::Miscellaneous>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mMiscItems;
     }
 
     template<>
     inline CellRefList<ESM::NPC>& CellStore::get<ESM::NPC>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mNpcs;
     }
 
     template<>
     inline CellRefList<ESM::Probe>& CellStore::get<ESM::Probe>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mProbes;
     }
 
     template<>
     inline CellRefList<ESM::Repair>& CellStore::get<ESM::Repair>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mRepairs;
     }
 
     template<>
     inline CellRefList<ESM::Static>& CellStore::get<ESM::Static>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mStatics;
     }
 
     template<>
     inline CellRefList<ESM::Weapon>& CellStore::get<ESM::Weapon>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mWeapons;
     }
 
     template<>
     inline CellRefList<ESM::BodyPart>& CellStore::get<ESM::BodyPart>()
     {
-        mHasState = true;
+        flagAsChanged();
         return mBodyParts;
     }
 
@@ -0,0 +1,179 @@
+#ifndef GAME_MWWORLD_CHUNKEDLIST_H
+#define GAME_MWWORLD_CHUNKEDLIST_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MWWorld
+{
+    /// \brief Sequence that stores its elements in fixed size chunks
+    ///
+    /// Appending never moves the elements or invalidates iterators, so pointers to the elements can be kept like with
+    /// std::list, but neighbouring elements are next to each other in memory and a chunk is allocated only once for
+    /// \a ChunkSize elements.
+    ///
+    /// \note erase moves the following elements, which invalidates pointers to them.
+    template <class T, std::size_t ChunkSize = 32>
+    class ChunkedList
+    {
+            using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+            template <class List, class Value>
+            class Iterator
+            {
+                public:
+                    using iterator_category = std::bidirectional_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = Value*;
+                    using reference = Value&;
+
+                    Iterator() = default;
+
+                    Iterator(List* list, std::size_t index) : mList(list), mIndex(index) {}
+
+                    template <class OtherList, class OtherValue,
+                              class = std::enable_if_t<std::is_convertible_v<OtherValue*, Value*>>>
+                    Iterator(const Iterator<OtherList, OtherValue>& other) : mList(other.mList), mIndex(other.mIndex) {}
+
+                    reference operator*() const { return (*mList)[mIndex]; }
+
+                    pointer operator->() const { return &(*mList)[mIndex]; }
+
+                    Iterator& operator++() { ++mIndex; return *this; }
+
+                    Iterator operator++(int) { Iterator result = *this; ++mIndex; return result; }
+
+                    Iterator& operator--() { --mIndex; return *this; }
+
+                    Iterator operator--(int) { Iterator result = *this; --mIndex; return result; }
+
+                    friend bool operator==(const Iterator& left, const Iterator& right)
+                    {
+                        return left.mIndex == right.mIndex && left.mList == right.mList;
+                    }
+
+                    friend bool operator!=(const Iterator& left, const Iterator& right) { return !(left == right); }
+
+                private:
+                    template <class, class>
+                    friend class Iterator;
+                    friend class ChunkedList;
+
+                    List* mList = nullptr;
+                    std::size_t mIndex = 0;
+            };
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using reference = T&;
+            using const_reference = const T&;
+            using iterator = Iterator<ChunkedList, T>;
+            using const_iterator = Iterator<const ChunkedList, const T>;
+
+            ChunkedList() = default;
+
+            ChunkedList(const ChunkedList& other)
+            {
+                for (const T& value : other)
+                    push_back(value);
+            }
+
+            ChunkedList(ChunkedList&& other) noexcept
+                : mChunks(std::move(other.mChunks)), mSize(std::exchange(other.mSize, 0)) {}
+
+            ~ChunkedList() { clear(); }
+
+            ChunkedList& operator=(const ChunkedList& other)
+            {
+                if (this != &other)
+                {
+                    clear();
+                    for (const T& value : other)
+                        push_back(value);
+                }
+                return *this;
+            }
+
+            ChunkedList& operator=(ChunkedList&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    clear();
+                    mChunks = std::move(other.mChunks);
+                    mSize = std::exchange(other.mSize, 0);
+                }
+                return *this;
+            }
+
+            T& operator[](std::size_t index)
+            {
+                return *std::launder(reinterpret_cast<T*>(&mChunks[index / ChunkSize][index % ChunkSize]));
+            }
+
+            const T& operator[](std::size_t index) const
+            {
+                return *std::launder(reinterpret_cast<const T*>(&mChunks[index / ChunkSize][index % ChunkSize]));
+            }
+
+            std::size_t size() const { return mSize; }
+
+            bool empty() const { return mSize == 0; }
+
+            iterator begin() { return iterator(this, 0); }
+            iterator end() { return iterator(this, mSize); }
+            const_iterator begin() const { return const_iterator(this, 0); }
+            const_iterator end() const { return const_iterator(this, mSize); }
+            const_iterator cbegin() const { return begin(); }
+            const_iterator cend() const { return end(); }
+
+            T& front() { return (*this)[0]; }
+            const T& front() const { return (*this)[0]; }
+            T& back() { return (*this)[mSize - 1]; }
+            const T& back() const { return (*this)[mSize - 1]; }
+
+            template <class ... Args>
+            T& emplace_back(Args&& ... args)
+            {
+                if (mSize == mChunks.size() * ChunkSize)
+                    mChunks.push_back(std::make_unique<Storage[]>(ChunkSize));
+                T* value = new (&mChunks[mSize / ChunkSize][mSize % ChunkSize]) T(std::forward<Args>(args)...);
+                ++mSize;
+                return *value;
+            }
+
+            void push_back(const T& value) { emplace_back(value); }
+
+            void push_back(T&& value) { emplace_back(std::move(value)); }
+
+            iterator erase(const_iterator position)
+            {
+                const std::size_t index = position.mIndex;
+                for (std::size_t i = index + 1; i < mSize; ++i)
+                    (*this)[i - 1] = std::move((*this)[i]);
+                back().~T();
+                --mSize;
+                return iterator(this, index);
+            }
+
+            /// Destroy all elements, the chunks are kept for reuse.
+            void clear()
+            {
+                for (std::size_t i = 0; i < mSize; ++i)
+                    (*this)[i].~T();
+                mSize = 0;
+            }
+
+        private:
+            std::vector<std::unique_ptr<Storage[]>> mChunks;
+            std::size_t mSize = 0;
+    };
+}
+
+#endif
@@ -277,6 +277,9 @@ namespace MWWorld
             virtual void getModelsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& models) const;
             ///< Get a list of models to preload that this object may use (directly or indirectly). default implementation: list getModel().
 
+            virtual void getSoundsToPreload(const MWWorld::Ptr& ptr, std::vector<std::string>& sounds) const;
+            ///< Get a list of sound ids to preload that this object may play. default implementation: none.
+
             virtual std::string applyEnchantment(const MWWorld::ConstPtr &ptr, const std::string& enchId, int enchCharge, const std::string& newName) const;
             ///< Creates a new record using \a ptr as template, with the given name and the given enchantment applied to it.
 
@@ -142,6 +142,7 @@ MWWorld::ContainerStore::ContainerStore()
     , mRechargingItemsUpToDate(false)
     , mCachedWeight (0)
     , mWeightUpToDate (false)
+    , mCountsUpToDate (false)
     , mModified(false)
     , mResolved(false)
     , mSeed()
@@ -181,11 +182,19 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::end()
 
 int MWWorld::ContainerStore::count(const std::string &id) const
 {
-    int total=0;
+    updateCachedCounts();
+    const auto found = mCachedCounts.find(id);
+    return found == mCachedCounts.end() ? 0 : found->second;
+}
+
+void MWWorld::ContainerStore::updateCachedCounts() const
+{
+    if (mCountsUpToDate)
+        return;
+    mCachedCounts.clear();
     for (const auto&& iter : *this)
-        if (Misc::StringUtils::ciEqual(iter.getCellRef().getRefId(), id))
-            total += iter.getRefData().getCount();
-    return total;
+        mCachedCounts[iter.getCellRef().getRefId()] += iter.getRefData().getCount();
+    mCountsUpToDate = true;
 }
 
 MWWorld::ContainerStoreListener* MWWorld::ContainerStore::getContListener() const
@@ -236,6 +245,7 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::restack(const MWWorld::
         {
             iter->getRefData().setCount(addItems(iter->getRefData().getCount(false), item.getRefData().getCount(false)));
             item.getRefData().setCount(0);
+            flagAsModified();
             retval = iter;
             break;
         }
@@ -350,6 +360,22 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
 {
     if(markModified)
         resolve();
+
+    // Only the count of the added record ID changes, so the cached counts can be updated instead of rebuilt
+    const bool countsUpToDate = mCountsUpToDate;
+    const int added = std::abs(ptr.getClass().isGold(ptr) ? count * ptr.getClass().getValue(ptr) : count);
+    ContainerStoreIterator it = stackOrAddNew(ptr, count);
+    if (countsUpToDate)
+    {
+        if (added != 0)
+            mCachedCounts[it->getCellRef().getRefId()] += added;
+        mCountsUpToDate = true;
+    }
+    return it;
+}
+
+MWWorld::ContainerStoreIterator MWWorld::ContainerStore::stackOrAddNew (const Ptr& ptr, int count)
+{
     int type = getType(ptr);
 
     const MWWorld::ESMStore &esmStore =
@@ -375,6 +401,10 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
         return addNewStack(ref.getPtr(), realCount);
     }
 
+    // nothing to stack onto if there are no items with this ID
+    if (mCountsUpToDate && mCachedCounts.find(ptr.getCellRef().getRefId()) == mCachedCounts.end())
+        return addNewStack(ptr, count);
+
     // determine whether to stack or not
     for (MWWorld::ContainerStoreIterator iter (begin(type)); iter!=end(); ++iter)
     {
@@ -605,6 +635,7 @@ void MWWorld::ContainerStore::clear()
 void MWWorld::ContainerStore::flagAsModified()
 {
     mWeightUpToDate = false;
+    mCountsUpToDate = false;
     mRechargingItemsUpToDate = false;
 }
 
@@ -619,6 +650,7 @@ void MWWorld::ContainerStore::resolve()
     {
         for(const auto&& ptr : *this)
             ptr.getRefData().setCount(0);
+        flagAsModified();
         Misc::Rng::Seed seed{mSeed};
         fill(mPtr.get<ESM::Container>()->mBase->mInventory, "", seed);
         addScripts(*this, mPtr.mCell);
@@ -640,6 +672,7 @@ MWWorld::ResolutionHandle MWWorld::ContainerStore::resolveTemporarily()
     {
         for(const auto&& ptr : *this)
             ptr.getRefData().setCount(0);
+        flagAsModified();
         Misc::Rng::Seed seed{mSeed};
         fill(mPtr.get<ESM::Container>()->mBase->mInventory, "", seed);
         addScripts(*this, mPtr.mCell);
@@ -656,6 +689,7 @@ void MWWorld::ContainerStore::unresolve()
     {
         for(const auto&& ptr : *this)
             ptr.getRefData().setCount(0);
+        flagAsModified();
         fillNonRandom(mPtr.get<ESM::Container>()->mBase->mInventory, "", mSeed);
         addScripts(*this, mPtr.mCell);
         mResolved = false;
@@ -904,6 +938,7 @@ void MWWorld::ContainerStore::readState (const ESM::InventoryState& inventory)
                 break;
         }
     }
+    flagAsModified();
 }
 
 template<class PtrType>
@@ -4,6 +4,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include <components/esm3/loadalch.hpp>
@@ -20,6 +21,7 @@
 #include <components/esm3/loadweap.hpp>
 
 #include <components/misc/rng.hpp>
+#include <components/misc/stringops.hpp>
 
 #include "ptr.hpp"
 #include "cellreflist.hpp"
@@ -119,6 +121,10 @@ namespace MWWorld
             mutable float mCachedWeight;
             mutable bool mWeightUpToDate;
 
+            // Total count of the items with each record ID, only IDs with a non-empty stack are listed
+            mutable std::unordered_map<std::string, int, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> mCachedCounts;
+            mutable bool mCountsUpToDate;
+
             bool mModified;
             bool mResolved;
             unsigned int mSeed;
@@ -126,6 +132,8 @@ namespace MWWorld
             std::weak_ptr<ResolutionListener> mResolutionListener;
 
             ContainerStoreIterator addImp (const Ptr& ptr, int count, bool markModified = true);
+            ContainerStoreIterator stackOrAddNew (const Ptr& ptr, int count);
+            void updateCachedCounts() const;
             void addInitialItem (const std::string& id, const std::string& owner, int count, Misc::Rng::Seed* seed, bool topLevel=true);
             void addInitialItemImp (const MWWorld::Ptr& ptr, const std::string& owner, int count, Misc::Rng::Seed* seed, bool topLevel=true);
 
@@ -1,6 +1,11 @@
 #include "esmloader.hpp"
 #include "esmstore.hpp"
 
+#include <atomic>
+#include <optional>
+
+#include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 #include <components/esm3/esmreader.hpp>
 
 namespace MWWorld
@@ -14,15 +19,107 @@ EsmLoader::EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& read
 {
 }
 
+EsmLoader::~EsmLoader()
+{
+    for (std::thread& thread : mThreads)
+        thread.join();
+}
+
+void EsmLoader::preload(const std::vector<std::pair<boost::filesystem::path, int>>& files, std::size_t threads)
+{
+    if (!mPreloadJobs.empty())
+        throw std::logic_error("Content files are already preloaded");
+
+    // Readers have to be opened in the load order to resolve parent file indices
+    mPreloadJobs.reserve(files.size());
+    for (const auto& [filepath, index] : files)
+    {
+        PreloadJob& job = mPreloadJobs.emplace_back(PreloadJob {index, false, {}});
+        mPreloaded.emplace(index, job.mResult.get_future());
+        try
+        {
+            ESM::ESMReader& reader = mEsm[index];
+            reader.setEncoder(mEncoder);
+            reader.setIndex(index);
+            reader.open(filepath.string());
+            reader.resolveParentFileIndices(mEsm);
+            job.mOpened = true;
+        }
+        catch (...)
+        {
+            job.mResult.set_exception(std::current_exception());
+        }
+    }
+
+    threads = std::min(threads, mPreloadJobs.size());
+    Log(Debug::Info) << "Parsing " << mPreloadJobs.size() << " content files using " << threads << " threads";
+
+    auto next = std::make_shared<std::atomic_size_t>(0);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        mThreads.emplace_back([this, next]
+        {
+            // Encoders keep an internal buffer, so each thread needs its own one
+            std::optional<ToUTF8::Utf8Encoder> encoder;
+            if (mEncoder != nullptr)
+                encoder.emplace(*mEncoder);
+
+            for (std::size_t i = (*next)++; i < mPreloadJobs.size(); i = (*next)++)
+            {
+                PreloadJob& job = mPreloadJobs[i];
+                if (!job.mOpened)
+                    continue; // The error is reported by load()
+
+                ESM::ESMReader& reader = mEsm[job.mIndex];
+                reader.setEncoder(encoder.has_value() ? &*encoder : nullptr);
+                std::optional<ESMStore::ParsedContent> content;
+                std::exception_ptr error;
+                try
+                {
+                    const Debug::ScopedTrace trace("Parse " + reader.getName());
+                    content = mStore.parse(reader);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                // The reader is used by the main thread as soon as the result is set
+                reader.setEncoder(mEncoder);
+                if (error != nullptr)
+                    job.mResult.set_exception(error);
+                else
+                    job.mResult.set_value(std::move(*content));
+            }
+        });
+    }
+}
+
 void EsmLoader::load(const boost::filesystem::path& filepath, int& index, Loading::Listener* listener)
 {
+    const Debug::ScopedTrace trace("Load " + filepath.filename().string());
+
+    const auto preloaded = mPreloaded.find(index);
+    if (preloaded != mPreloaded.end())
+    {
+        ESMStore::ParsedContent content = preloaded->second.get();
+        mPreloaded.erase(preloaded);
+        mStore.load(mEsm[index], content, listener);
+        mDeferredRuns[index] = std::move(content.mDeferred);
+        return;
+    }
+
     ESM::ESMReader lEsm;
     lEsm.setEncoder(mEncoder);
     lEsm.setIndex(index);
     lEsm.open(filepath.string());
     lEsm.resolveParentFileIndices(mEsm);
     mEsm[index] = lEsm;
-    mStore.load(mEsm[index], listener);
+
+    const auto snapshotRuns = mSnapshotRuns.find(index);
+    if (snapshotRuns != mSnapshotRuns.end())
+        mStore.loadDeferred(mEsm[index], snapshotRuns->second, listener);
+    else
+        mStore.load(mEsm[index], listener);
 }
 
 } /* namespace MWWorld */
@@ -1,9 +1,15 @@
 #ifndef ESMLOADER_HPP
 #define ESMLOADER_HPP
 
+#include <future>
+#include <map>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "contentloader.hpp"
+#include "esmstore.hpp"
+#include "esmstoresnapshot.hpp"
 
 namespace ToUTF8
 {
@@ -18,19 +24,43 @@ namespace ESM
 namespace MWWorld
 {
 
-class ESMStore;
-
 struct EsmLoader : public ContentLoader
 {
     EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
         ToUTF8::Utf8Encoder* encoder);
 
+    ~EsmLoader();
+
+    /// Open the given content files and parse their records on the given number of worker threads, so that
+    /// load() only has to merge them into the store.
+    /// @param files Paths of the content files with their indices in the load order.
+    void preload(const std::vector<std::pair<boost::filesystem::path, int>>& files, std::size_t threads);
+
+    /// Load only the given runs of records from the content files, the other records are already loaded
+    /// from a snapshot.
+    void setSnapshotRuns(DeferredRuns&& runs) { mSnapshotRuns = std::move(runs); }
+
+    /// Runs of records of the content files loaded after preload(), as required by writeESMStoreSnapshot().
+    const DeferredRuns& getDeferredRuns() const { return mDeferredRuns; }
+
     void load(const boost::filesystem::path& filepath, int& index, Loading::Listener* listener) override;
 
     private:
+        struct PreloadJob
+        {
+            int mIndex;
+            bool mOpened;
+            std::promise<ESMStore::ParsedContent> mResult;
+        };
+
         std::vector<ESM::ESMReader>& mEsm;
         MWWorld::ESMStore& mStore;
         ToUTF8::Utf8Encoder* mEncoder;
+        std::vector<PreloadJob> mPreloadJobs;
+        std::map<int, std::future<ESMStore::ParsedContent>> mPreloaded;
+        std::vector<std::thread> mThreads;
+        DeferredRuns mDeferredRuns;
+        DeferredRuns mSnapshotRuns;
 };
 
 } /* namespace MWWorld */
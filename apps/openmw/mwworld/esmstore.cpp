@@ -143,6 +143,66 @@ static bool isCacheableRecord(int id)
     return false;
 }
 
+void ESMStore::loadRecord(ESM::ESMReader& esm, ESM::Dialogue*& dialogue)
+{
+    ESM::NAME n = esm.getRecName();
+    esm.getRecHeader();
+
+    // Look up the record type.
+    std::map<int, StoreBase *>::iterator it = mStores.find(n.toInt());
+
+    if (it == mStores.end()) {
+        if (n.toInt() == ESM::REC_INFO) {
+            if (dialogue)
+            {
+                dialogue->readInfo(esm, esm.getIndex() != 0);
+            }
+            else
+            {
+                Log(Debug::Error) << "Error: info record without dialog";
+                esm.skipRecord();
+            }
+        } else if (n.toInt() == ESM::REC_MGEF) {
+            mMagicEffects.load (esm);
+        } else if (n.toInt() == ESM::REC_SKIL) {
+            mSkills.load (esm);
+        }
+        else if (n.toInt() == ESM::REC_FILT || n.toInt() == ESM::REC_DBGP)
+        {
+            // ignore project file only records
+            esm.skipRecord();
+        }
+        else if (n.toInt() == ESM::REC_LUAL)
+        {
+            ESM::LuaScriptsCfg cfg;
+            cfg.load(esm);
+            // TODO: update refnums in cfg.mScripts[].mInitializationData according to load order
+            mLuaContent.push_back(std::move(cfg));
+        }
+        else {
+            throw std::runtime_error("Unknown record: " + n.toString());
+        }
+    } else {
+        RecordId id = it->second->load(esm);
+        if (id.mIsDeleted)
+        {
+            it->second->eraseStatic(id.mId);
+            return;
+        }
+
+        if (n.toInt() == ESM::REC_DIAL) {
+            dialogue = const_cast<ESM::Dialogue*>(mDialogs.find(id.mId));
+        } else {
+            dialogue = nullptr;
+        }
+    }
+}
+
+void ESMStore::setLazyLoading(const ToUTF8::Utf8Encoder* encoder)
+{
+    mBooks.setLazyLoader(std::make_shared<LazyRecordLoader>(encoder));
+}
+
 void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
 {
     listener->setProgressRange(1000);
@@ -157,61 +217,130 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
     // Loop through all records
     while(esm.hasMoreRecs())
     {
-        ESM::NAME n = esm.getRecName();
+        loadRecord(esm, dialogue);
+        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+    }
+}
+
+ESMStore::ParsedContent ESMStore::parse(ESM::ESMReader &esm) const
+{
+    ParsedContent result;
+
+    // Records which can't be parsed independently are grouped into runs, so only the position of the first one
+    // has to be saved.
+    bool inDeferredRun = false;
+
+    while (esm.hasMoreRecs())
+    {
+        const std::size_t filePos = esm.getFileOffset();
+        const ESM::NAME n = esm.getRecName();
         esm.getRecHeader();
 
-        // Look up the record type.
-        std::map<int, StoreBase *>::iterator it = mStores.find(n.toInt());
+        const auto it = mStores.find(n.toInt());
+        if (it != mStores.end() && it->second->isParseable())
+        {
+            result.mEntries.push_back(ParsedContent::Entry {it->second, it->second->parse(esm)});
+            inDeferredRun = false;
+            continue;
+        }
 
-        if (it == mStores.end()) {
-            if (n.toInt() == ESM::REC_INFO) {
-                if (dialogue)
-                {
-                    dialogue->readInfo(esm, esm.getIndex() != 0);
-                }
-                else
-                {
-                    Log(Debug::Error) << "Error: info record without dialog";
-                    esm.skipRecord();
-                }
-            } else if (n.toInt() == ESM::REC_MGEF) {
-                mMagicEffects.load (esm);
-            } else if (n.toInt() == ESM::REC_SKIL) {
-                mSkills.load (esm);
-            }
-            else if (n.toInt() == ESM::REC_FILT || n.toInt() == ESM::REC_DBGP)
-            {
-                // ignore project file only records
-                esm.skipRecord();
-            }
-            else if (n.toInt() == ESM::REC_LUAL)
-            {
-                ESM::LuaScriptsCfg cfg;
-                cfg.load(esm);
-                // TODO: update refnums in cfg.mScripts[].mInitializationData according to load order
-                mLuaContent.push_back(std::move(cfg));
-            }
-            else {
-                throw std::runtime_error("Unknown record: " + n.toString());
-            }
-        } else {
-            RecordId id = it->second->load(esm);
-            if (id.mIsDeleted)
-            {
-                it->second->eraseStatic(id.mId);
-                continue;
-            }
+        if (!inDeferredRun)
+        {
+            result.mEntries.push_back(ParsedContent::Entry {nullptr, nullptr});
+            result.mDeferred.push_back(ParsedContent::DeferredRun {filePos, 0});
+            inDeferredRun = true;
+        }
+        ++result.mDeferred.back().mCount;
+        esm.skipRecord();
+    }
+
+    return result;
+}
+
+void ESMStore::load(ESM::ESMReader &esm, ParsedContent& content, Loading::Listener* listener)
+{
+    listener->setProgressRange(1000);
+
+    ESM::Dialogue *dialogue = nullptr;
+
+    mLandTextures.resize(esm.getIndex()+1);
 
-            if (n.toInt() == ESM::REC_DIAL) {
-                dialogue = const_cast<ESM::Dialogue*>(mDialogs.find(id.mId));
-            } else {
+    std::size_t deferred = 0;
+    bool resetDialogue = false;
+    for (std::size_t i = 0; i < content.mEntries.size(); ++i)
+    {
+        ParsedContent::Entry& entry = content.mEntries[i];
+        if (entry.mStore != nullptr)
+        {
+            const RecordId id = entry.mStore->merge(*entry.mRecord);
+            entry.mRecord.reset();
+            if (id.mIsDeleted)
+                entry.mStore->eraseStatic(id.mId);
+            else
+                resetDialogue = true;
+        }
+        else
+        {
+            ParsedContent::DeferredRun& run = content.mDeferred[deferred++];
+            run.mResetDialogue = resetDialogue;
+            if (resetDialogue)
                 dialogue = nullptr;
-            }
+            resetDialogue = false;
+            loadRecords(esm, run.mFilePos, run.mCount, dialogue);
         }
-        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+        listener->setProgress(static_cast<size_t>((i + 1) / static_cast<float>(content.mEntries.size()) * 1000));
     }
 }
 
+void ESMStore::loadDeferred(ESM::ESMReader &esm, const std::vector<ParsedContent::DeferredRun>& runs,
+    Loading::Listener* listener)
+{
+    listener->setProgressRange(1000);
+
+    ESM::Dialogue *dialogue = nullptr;
+
+    mLandTextures.resize(esm.getIndex()+1);
+
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        if (runs[i].mResetDialogue)
+            dialogue = nullptr;
+        loadRecords(esm, runs[i].mFilePos, runs[i].mCount, dialogue);
+        listener->setProgress(static_cast<size_t>((i + 1) / static_cast<float>(runs.size()) * 1000));
+    }
+}
+
+void ESMStore::loadRecords(ESM::ESMReader& esm, std::size_t filePos, std::size_t count, ESM::Dialogue*& dialogue)
+{
+    // The position is at a record boundary, so the rest of the context is the same as for any other record
+    ESM::ESM_Context context = esm.getContext();
+    context.filePos = filePos;
+    context.leftFile = esm.getFileSize() - filePos;
+    context.leftRec = 0;
+    context.leftSub = 0;
+    context.subCached = false;
+    esm.restoreContext(context);
+
+    for (std::size_t i = 0; i < count; ++i)
+        loadRecord(esm, dialogue);
+}
+
+void ESMStore::writeStatic(ESM::ESMWriter& writer) const
+{
+    for (const auto& [type, store] : mStores)
+        if (store->isParseable())
+            store->writeStatic(writer);
+}
+
+std::size_t ESMStore::getStaticSize() const
+{
+    std::size_t result = 0;
+    for (const auto& [type, store] : mStores)
+        if (store->isParseable())
+            result += store->getSize();
+    return result;
+}
+
 ESM::LuaScriptsCfg ESMStore::getLuaScriptsCfg() const
 {
     ESM::LuaScriptsCfg cfg;
@@ -240,6 +369,7 @@ ESM::LuaScriptsCfg ESMStore::getLuaScriptsCfg() const
 
 void ESMStore::setUp(bool validateRecords)
 {
+    ++mRevision;
     mIds.clear();
 
     std::map<int, StoreBase *>::iterator storeIt = mStores.begin();
@@ -472,11 +602,13 @@ void ESMStore::removeMissingObjects(Store<T>& store)
             case ESM::REC_WEAP:
             case ESM::REC_LEVI:
             case ESM::REC_LEVC:
+                ++mRevision;
                 mStores[type]->read (reader);
                 return true;
             case ESM::REC_NPC_:
             case ESM::REC_CREA:
             case ESM::REC_CONT:
+                ++mRevision;
                 mStores[type]->read (reader, true);
                 return true;
 
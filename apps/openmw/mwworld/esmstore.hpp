@@ -85,6 +85,9 @@ namespace MWWorld
 
         unsigned int mDynamicCount;
 
+        // Changed whenever records are added, replaced or removed
+        unsigned int mRevision;
+
         mutable std::unordered_map<std::string, std::weak_ptr<MWMechanics::SpellList>, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> mSpellListCache;
 
         /// Validate entries in store after setup
@@ -92,6 +95,10 @@ namespace MWWorld
 
         void countAllCellRefs();
 
+        void loadRecord(ESM::ESMReader& esm, ESM::Dialogue*& dialogue);
+
+        void loadRecords(ESM::ESMReader& esm, std::size_t filePos, std::size_t count, ESM::Dialogue*& dialogue);
+
         template<class T>
         void removeMissingObjects(Store<T>& store);
 
@@ -101,6 +108,28 @@ namespace MWWorld
         std::vector<LuaContent> mLuaContent;
 
     public:
+        /// Records of a content file parsed by parse(), in the order they appear in the file.
+        struct ParsedContent
+        {
+            /// Parsed record, or a run of records which have to be loaded in order if mStore is nullptr.
+            struct Entry
+            {
+                StoreBase* mStore;
+                std::unique_ptr<ParsedRecord> mRecord;
+            };
+
+            struct DeferredRun
+            {
+                std::size_t mFilePos;
+                std::size_t mCount;
+                /// A record loaded before the run ends a dialogue, so the following infos don't belong to it
+                bool mResetDialogue = false;
+            };
+
+            std::vector<Entry> mEntries;
+            std::vector<DeferredRun> mDeferred;
+        };
+
         void addOMWScripts(std::string filePath) { mLuaContent.push_back(std::move(filePath)); }
         ESM::LuaScriptsCfg getLuaScriptsCfg() const;
 
@@ -135,6 +164,7 @@ namespace MWWorld
 
         ESMStore()
           : mDynamicCount(0)
+          , mRevision(0)
         {
             mStores[ESM::REC_ACTI] = &mActivators;
             mStores[ESM::REC_ALCH] = &mPotions;
@@ -181,6 +211,7 @@ namespace MWWorld
 
         void clearDynamic ()
         {
+            ++mRevision;
             for (std::map<int, StoreBase *>::iterator it = mStores.begin(); it != mStores.end(); ++it)
                 it->second->clearDynamic();
 
@@ -196,8 +227,32 @@ namespace MWWorld
         /// Validate entries in store after loading a save
         void validateDynamic();
 
+        /// Leave the rarely used parts of records, like the text of books, in the content files until the records
+        /// are looked up. Affects the records loaded afterwards.
+        void setLazyLoading(const ToUTF8::Utf8Encoder* encoder);
+
         void load(ESM::ESMReader &esm, Loading::Listener* listener);
 
+        /// Parse the records of the given content file which don't depend on the load order, without modifying
+        /// the store. The remaining records are skipped and loaded by load(esm, content, listener).
+        /// @note Thread safe, as long as each call uses its own reader and encoder.
+        ParsedContent parse(ESM::ESMReader &esm) const;
+
+        /// Merge records parsed by parse() into the store, with the same result as load(esm, listener).
+        /// @note Fills ParsedContent::DeferredRun::mResetDialogue.
+        void load(ESM::ESMReader &esm, ParsedContent& content, Loading::Listener* listener);
+
+        /// Load only the records of the given runs, the other records of the content file are expected to be
+        /// loaded from a snapshot written by writeStatic().
+        void loadDeferred(ESM::ESMReader &esm, const std::vector<ParsedContent::DeferredRun>& runs,
+            Loading::Listener* listener);
+
+        /// Write the records of all stores supporting parse(), in load order.
+        void writeStatic(ESM::ESMWriter& writer) const;
+
+        /// Number of records written by writeStatic().
+        std::size_t getStaticSize() const;
+
         template <class T>
         const Store<T> &get() const {
             throw std::runtime_error("Storage for this type not exist");
@@ -219,6 +274,7 @@ namespace MWWorld
 
             record.mId = id;
 
+            ++mRevision;
             T *ptr = store.insert(record);
             for (iterator it = mStores.begin(); it != mStores.end(); ++it) {
                 if (it->second == &store) {
@@ -233,6 +289,7 @@ namespace MWWorld
         const T *overrideRecord(const T &x) {
             Store<T> &store = const_cast<Store<T> &>(get<T>());
 
+            ++mRevision;
             T *ptr = store.insert(x);
             for (iterator it = mStores.begin(); it != mStores.end(); ++it) {
                 if (it->second == &store) {
@@ -255,6 +312,7 @@ namespace MWWorld
             }
             T record = x;
 
+            ++mRevision;
             T *ptr = store.insertStatic(record);
             for (iterator it = mStores.begin(); it != mStores.end(); ++it) {
                 if (it->second == &store) {
@@ -268,6 +326,10 @@ namespace MWWorld
         //  from the outside, so it must be public.
         void setUp(bool validateRecords = false);
 
+        /// Returns a value which changes whenever records are added, replaced or removed.
+        /// Allows to invalidate data derived from the records.
+        unsigned int getRevision() const { return mRevision; }
+
         int countSavedGameRecords() const;
 
         void write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
@@ -309,6 +371,7 @@ namespace MWWorld
 
         record.mId = id;
 
+        ++mRevision;
         ESM::NPC *ptr = mNpcs.insert(record);
         mIds[ptr->mId] = ESM::REC_NPC_;
         return ptr;
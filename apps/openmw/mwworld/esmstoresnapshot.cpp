@@ -0,0 +1,202 @@
+#include "esmstoresnapshot.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/files/hash.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+
+namespace MWWorld
+{
+    namespace
+    {
+        constexpr std::uint32_t sSnapshotRecord = ESM::FourCC<'S','N','A','P'>::value;
+
+        // Has to be increased on any change of the snapshot layout or of the format of the records stored in it
+        constexpr std::int32_t sSnapshotFormat = 1;
+
+#pragma pack(push)
+#pragma pack(1)
+        struct SnapshotRun
+        {
+            std::uint64_t mFilePos;
+            std::uint32_t mCount;
+            std::uint32_t mResetDialogue;
+        };
+#pragma pack(pop)
+
+        /// Records are stored after the conversion from the legacy encoding, so the snapshot is only valid for
+        /// the encoding it was written with.
+        std::string getEncodingProbe(ToUTF8::Utf8Encoder* encoder)
+        {
+            std::string probe;
+            for (int c = 0x80; c <= 0xff; ++c)
+                probe.push_back(static_cast<char>(c));
+            if (encoder == nullptr)
+                return probe;
+            return std::string(encoder->getUtf8(probe));
+        }
+
+        bool readKeys(ESM::ESMReader& reader, const std::vector<ContentFileKey>& keys,
+            ToUTF8::Utf8Encoder* encoder, DeferredRuns& deferredRuns)
+        {
+            const std::vector<ESM::Header::MasterData>& masters = reader.getGameFiles();
+            if (masters.size() != keys.size())
+                return false;
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                if (masters[i].name != keys[i].mName || masters[i].size != keys[i].mSize)
+                    return false;
+
+            if (!reader.hasMoreRecs() || reader.getRecName() != sSnapshotRecord)
+                return false;
+            reader.getRecHeader();
+
+            std::int32_t format = 0;
+            reader.getHNT(format, "FORM");
+            if (format != sSnapshotFormat)
+                return false;
+            if (reader.getHNString("ENCD") != getEncodingProbe(encoder))
+                return false;
+
+            for (const ContentFileKey& key : keys)
+            {
+                std::int32_t index = 0;
+                reader.getHNT(index, "INDX");
+                std::array<std::uint64_t, 2> hash {0, 0};
+                reader.getHNT(hash, "HASH");
+                if (index != key.mIndex || hash != key.mHash)
+                    return false;
+
+                std::vector<ESMStore::ParsedContent::DeferredRun>& runs = deferredRuns[index];
+                while (reader.isNextSub("RUNS"))
+                {
+                    SnapshotRun run;
+                    reader.getHT(run);
+                    runs.push_back(ESMStore::ParsedContent::DeferredRun {
+                        static_cast<std::size_t>(run.mFilePos), run.mCount, run.mResetDialogue != 0});
+                }
+            }
+
+            return true;
+        }
+    }
+
+    ContentFileKey makeContentFileKey(const boost::filesystem::path& path, int index)
+    {
+        boost::filesystem::ifstream stream(path, std::ios_base::binary);
+        if (!stream.is_open())
+            throw std::runtime_error("Failed to open content file: " + path.string());
+        return ContentFileKey {
+            index,
+            path.filename().string(),
+            static_cast<std::uint64_t>(boost::filesystem::file_size(path)),
+            Files::getHash(path.string(), stream),
+        };
+    }
+
+    void writeESMStoreSnapshot(const boost::filesystem::path& path, const std::vector<ContentFileKey>& keys,
+        ToUTF8::Utf8Encoder* encoder, const DeferredRuns& deferredRuns, const ESMStore& store)
+    {
+        Log(Debug::Info) << "Writing ESM store snapshot to " << path;
+
+        // Write to a temporary file first so an interrupted write doesn't leave a broken snapshot behind
+        const boost::filesystem::path tempPath = path.string() + ".tmp";
+        try
+        {
+            boost::filesystem::create_directories(path.parent_path());
+
+            boost::filesystem::ofstream stream(tempPath, std::ios_base::binary);
+            stream.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+
+            ESM::ESMWriter writer;
+            writer.setFormat(ESM::Header::CurrentFormat);
+            writer.setAuthor("OpenMW");
+            writer.setDescription("ESM store snapshot");
+            writer.setRecordCount(static_cast<int>(store.getStaticSize() + 1));
+            for (const ContentFileKey& key : keys)
+                writer.addMaster(key.mName, key.mSize);
+            writer.save(stream);
+
+            writer.startRecord(sSnapshotRecord);
+            writer.writeHNT("FORM", sSnapshotFormat);
+            writer.writeHNString("ENCD", getEncodingProbe(encoder));
+            for (const ContentFileKey& key : keys)
+            {
+                writer.writeHNT("INDX", static_cast<std::int32_t>(key.mIndex));
+                writer.writeHNT("HASH", key.mHash);
+                const auto runs = deferredRuns.find(key.mIndex);
+                if (runs == deferredRuns.end())
+                    continue;
+                for (const ESMStore::ParsedContent::DeferredRun& run : runs->second)
+                {
+                    const SnapshotRun value {
+                        static_cast<std::uint64_t>(run.mFilePos),
+                        static_cast<std::uint32_t>(run.mCount),
+                        run.mResetDialogue ? 1u : 0u,
+                    };
+                    writer.writeHNT("RUNS", value);
+                }
+            }
+            writer.endRecord(sSnapshotRecord);
+
+            store.writeStatic(writer);
+
+            writer.close();
+            stream.close();
+
+            boost::filesystem::rename(tempPath, path);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to write ESM store snapshot to " << path << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove(tempPath, ec);
+        }
+    }
+
+    std::optional<DeferredRuns> readESMStoreSnapshot(const boost::filesystem::path& path,
+        const std::vector<ContentFileKey>& keys, ToUTF8::Utf8Encoder* encoder, ESMStore& store,
+        Loading::Listener* listener)
+    {
+        if (!boost::filesystem::exists(path))
+            return std::nullopt;
+
+        ESM::ESMReader reader;
+        DeferredRuns deferredRuns;
+        try
+        {
+            reader.open(path.string());
+            if (!readKeys(reader, keys, encoder, deferredRuns))
+            {
+                Log(Debug::Info) << "ESM store snapshot " << path << " is outdated";
+                return std::nullopt;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to read ESM store snapshot " << path << ": " << e.what();
+            return std::nullopt;
+        }
+
+        Log(Debug::Info) << "Loading ESM store snapshot " << path;
+
+        try
+        {
+            store.load(reader, listener);
+        }
+        catch (const std::exception& e)
+        {
+            // The store is partially loaded at this point, so there is no way to fall back to the content files
+            reader.close();
+            boost::system::error_code ec;
+            boost::filesystem::remove(path, ec);
+            throw std::runtime_error("Failed to load ESM store snapshot " + path.string() + ": " + e.what()
+                + ". The snapshot has been removed, it will be rebuilt on the next start.");
+        }
+
+        return deferredRuns;
+    }
+}
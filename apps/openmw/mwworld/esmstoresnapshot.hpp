@@ -0,0 +1,54 @@
+#ifndef GAME_MWWORLD_ESMSTORESNAPSHOT_H
+#define GAME_MWWORLD_ESMSTORESNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+#include "esmstore.hpp"
+
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
+namespace Loading
+{
+    class Listener;
+}
+
+namespace MWWorld
+{
+    /// Identifies the content of a content file.
+    struct ContentFileKey
+    {
+        int mIndex;
+        std::string mName;
+        std::uint64_t mSize;
+        std::array<std::uint64_t, 2> mHash;
+    };
+
+    /// Runs of records which are loaded from the content file itself, by index of the content file.
+    using DeferredRuns = std::map<int, std::vector<ESMStore::ParsedContent::DeferredRun>>;
+
+    ContentFileKey makeContentFileKey(const boost::filesystem::path& path, int index);
+
+    /// Write the records of the store supporting ESMStore::parse() along with the layout of the content files
+    /// they were loaded from, so that they can be restored without parsing the content files again.
+    void writeESMStoreSnapshot(const boost::filesystem::path& path, const std::vector<ContentFileKey>& keys,
+        ToUTF8::Utf8Encoder* encoder, const DeferredRuns& deferredRuns, const ESMStore& store);
+
+    /// Load the records of the snapshot into the store if it was written for the same content files and encoding.
+    /// @return Runs of records which have to be loaded from the content files, std::nullopt if the snapshot is
+    /// missing or outdated. The store is not modified in this case.
+    std::optional<DeferredRuns> readESMStoreSnapshot(const boost::filesystem::path& path,
+        const std::vector<ContentFileKey>& keys, ToUTF8::Utf8Encoder* encoder, ESMStore& store,
+        Loading::Listener* listener);
+}
+
+#endif
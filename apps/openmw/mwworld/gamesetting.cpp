@@ -0,0 +1,33 @@
+#include "gamesetting.hpp"
+
+#include <components/esm3/loadgmst.hpp>
+
+#include "../mwbase/environment.hpp"
+#include "../mwbase/world.hpp"
+
+#include "esmstore.hpp"
+
+namespace MWWorld
+{
+    const ESM::Variant& GmstHandle::getValue() const
+    {
+        const ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+        if (mRecord == nullptr || mStore != &store || mRevision != store.getRevision())
+        {
+            mRecord = store.get<ESM::GameSetting>().find(mId);
+            mStore = &store;
+            mRevision = store.getRevision();
+        }
+        return mRecord->mValue;
+    }
+
+    float GmstFloat::get() const
+    {
+        return getValue().getFloat();
+    }
+
+    int GmstInt::get() const
+    {
+        return getValue().getInteger();
+    }
+}
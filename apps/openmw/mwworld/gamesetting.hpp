@@ -0,0 +1,59 @@
+#ifndef GAME_MWWORLD_GAMESETTING_H
+#define GAME_MWWORLD_GAMESETTING_H
+
+#include <string>
+
+namespace ESM
+{
+    struct GameSetting;
+    class Variant;
+}
+
+namespace MWWorld
+{
+    class ESMStore;
+
+    /// \brief Game setting that is looked up once and again only after records were added to the store
+    ///
+    /// Meant to be kept as a static or member, so code running every frame doesn't have to look up the setting by
+    /// its name each time.
+    class GmstHandle
+    {
+        public:
+            explicit GmstHandle(std::string id) : mId(std::move(id)) {}
+
+            const std::string& getId() const { return mId; }
+
+        protected:
+            const ESM::Variant& getValue() const;
+            ///< \note Throws an exception if the game setting doesn't exist.
+
+        private:
+            std::string mId;
+            mutable const ESM::GameSetting* mRecord = nullptr;
+            mutable const ESMStore* mStore = nullptr;
+            mutable unsigned int mRevision = 0;
+    };
+
+    class GmstFloat : public GmstHandle
+    {
+        public:
+            using GmstHandle::GmstHandle;
+
+            float get() const;
+
+            operator float() const { return get(); }
+    };
+
+    class GmstInt : public GmstHandle
+    {
+        public:
+            using GmstHandle::GmstHandle;
+
+            int get() const;
+
+            operator int() const { return get(); }
+    };
+}
+
+#endif
@@ -6,6 +6,9 @@
 #include <components/esm3/esmreader.hpp>
 #include <components/misc/stringops.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/world.hpp"
+
 #include "esmstore.hpp"
 
 namespace MWWorld
@@ -33,6 +36,7 @@ namespace MWWorld
     void Globals::fill (const MWWorld::ESMStore& store)
     {
         mVariables.clear();
+        ++mRevision;
 
         const MWWorld::Store<ESM::Global>& globals = store.get<ESM::Global>();
 
@@ -105,4 +109,16 @@ namespace MWWorld
 
         return false;
     }
+
+    const ESM::Variant& GlobalHandle::getValue() const
+    {
+        const Globals& globals = MWBase::Environment::get().getWorld()->getGlobalVariables();
+        if (mValue == nullptr || mGlobals != &globals || mRevision != globals.getRevision())
+        {
+            mValue = &globals[mName];
+            mGlobals = &globals;
+            mRevision = globals.getRevision();
+        }
+        return *mValue;
+    }
 }
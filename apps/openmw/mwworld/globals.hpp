@@ -31,6 +31,7 @@ namespace MWWorld
             typedef std::map<std::string, ESM::Global> Collection;
 
             Collection mVariables; // type, value
+            unsigned int mRevision = 0;
 
             Collection::const_iterator find (const std::string& name) const;
 
@@ -48,6 +49,9 @@ namespace MWWorld
             void fill (const MWWorld::ESMStore& store);
             ///< Replace variables with variables from \a store with default values.
 
+            unsigned int getRevision() const { return mRevision; }
+            ///< Changes when the variables are replaced by fill().
+
             int countSavedGameRecords() const;
 
             void write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
@@ -58,6 +62,45 @@ namespace MWWorld
             /// \return Known type?
 
     };
+
+    /// \brief Global variable of the world that is looked up again only after the variables were replaced
+    class GlobalHandle
+    {
+        public:
+            explicit GlobalHandle(std::string name) : mName(std::move(name)) {}
+
+            const std::string& getName() const { return mName; }
+
+        protected:
+            const ESM::Variant& getValue() const;
+            ///< \note Throws an exception if the global variable doesn't exist.
+
+        private:
+            std::string mName;
+            mutable const ESM::Variant* mValue = nullptr;
+            mutable const Globals* mGlobals = nullptr;
+            mutable unsigned int mRevision = 0;
+    };
+
+    class GlobalFloat : public GlobalHandle
+    {
+        public:
+            using GlobalHandle::GlobalHandle;
+
+            float get() const { return getValue().getFloat(); }
+
+            operator float() const { return get(); }
+    };
+
+    class GlobalInt : public GlobalHandle
+    {
+        public:
+            using GlobalHandle::GlobalHandle;
+
+            int get() const { return getValue().getInteger(); }
+
+            operator int() const { return get(); }
+    };
 }
 
 #endif
@@ -2,9 +2,15 @@
 
 #include <iterator>
 #include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
 
 #include <components/debug/debuglog.hpp>
+#include <components/esm3/loadcrea.hpp>
 #include <components/esm3/loadench.hpp>
+#include <components/esm3/loadnpc.hpp>
+#include <components/esm3/loadskil.hpp>
 #include <components/esm3/inventorystate.hpp>
 #include <components/misc/rng.hpp>
 
@@ -96,6 +102,37 @@ void MWWorld::InventoryStore::readEquipmentState(const MWWorld::ContainerStoreIt
     }
 }
 
+namespace
+{
+    template <class T>
+    void appendValue(std::string& key, const T& value)
+    {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    struct AutoEquipCache
+    {
+        std::mutex mMutex;
+        const MWWorld::ESMStore* mStore = nullptr;
+        unsigned int mRevision = 0;
+        // Index of the item in each slot, in the order of the inventory, or -1 for an empty slot
+        std::map<std::string, std::array<int, MWWorld::InventoryStore::Slots>> mSlots;
+    };
+
+    AutoEquipCache sAutoEquipCache;
+
+    // Must be called with the cache locked
+    void validateAutoEquipCache(const MWWorld::ESMStore& store)
+    {
+        if (sAutoEquipCache.mStore != &store || sAutoEquipCache.mRevision != store.getRevision())
+        {
+            sAutoEquipCache.mStore = &store;
+            sAutoEquipCache.mRevision = store.getRevision();
+            sAutoEquipCache.mSlots.clear();
+        }
+    }
+}
+
 MWWorld::InventoryStore::InventoryStore()
  : ContainerStore()
  , mInventoryListener(nullptr)
@@ -531,6 +568,13 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
     autoEquipWeapon(actor, slots_);
     autoEquipArmor(actor, slots_);
 
+    mUpdatesEnabled = true;
+
+    setAutoEquippedSlots(actor, slots_);
+}
+
+void MWWorld::InventoryStore::setAutoEquippedSlots(const MWWorld::Ptr& actor, TSlots& slots_)
+{
     bool changed = false;
 
     for (std::size_t i=0; i<slots_.size(); ++i)
@@ -541,7 +585,6 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
             break;
         }
     }
-    mUpdatesEnabled = true;
 
     if (changed)
     {
@@ -551,6 +594,74 @@ void MWWorld::InventoryStore::autoEquip (const MWWorld::Ptr& actor)
     }
 }
 
+void MWWorld::InventoryStore::autoEquipInitialItems (const MWWorld::Ptr& actor)
+{
+    // The choice depends on the actor's record, skills and items, and on records that only change with the store revision
+    std::string key;
+    if (actor.getType() == ESM::NPC::sRecordId)
+        appendValue(key, static_cast<const void*>(actor.get<ESM::NPC>()->mBase));
+    else if (actor.getType() == ESM::Creature::sRecordId)
+        appendValue(key, static_cast<const void*>(actor.get<ESM::Creature>()->mBase));
+    else
+        return autoEquip(actor);
+
+    for (int skill = 0; skill < ESM::Skill::Length; ++skill)
+        appendValue(key, actor.getClass().getSkill(actor, skill));
+
+    std::vector<ContainerStoreIterator> items;
+    for (ContainerStoreIterator iter (begin()); iter != end(); ++iter)
+    {
+        items.push_back(iter);
+        const MWWorld::CellRef& cellRef = iter->getCellRef();
+        key += cellRef.getRefId();
+        key += '\0';
+        key += cellRef.getSoul();
+        key += '\0';
+        appendValue(key, iter->getRefData().getCount(false));
+        appendValue(key, cellRef.getCharge());
+        appendValue(key, cellRef.getEnchantmentCharge());
+    }
+
+    const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+    {
+        std::lock_guard lock(sAutoEquipCache.mMutex);
+        validateAutoEquipCache(store);
+        const auto found = sAutoEquipCache.mSlots.find(key);
+        if (found != sAutoEquipCache.mSlots.end())
+        {
+            TSlots slots_;
+            initSlots (slots_);
+            for (std::size_t i = 0; i < slots_.size(); ++i)
+            {
+                if (found->second[i] >= 0)
+                    slots_[i] = items[found->second[i]];
+            }
+            setAutoEquippedSlots(actor, slots_);
+            return;
+        }
+    }
+
+    autoEquip(actor);
+
+    // An item that was unstacked to be equipped can't be found by its index again
+    std::size_t count = 0;
+    for (ContainerStoreIterator iter (begin()); iter != end(); ++iter)
+        ++count;
+    if (count != items.size())
+        return;
+
+    std::array<int, Slots> slots;
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+        const auto item = std::find(items.begin(), items.end(), mSlots[i]);
+        slots[i] = item == items.end() ? -1 : static_cast<int>(item - items.begin());
+    }
+
+    std::lock_guard lock(sAutoEquipCache.mMutex);
+    validateAutoEquipCache(store);
+    sAutoEquipCache.mSlots.emplace(std::move(key), slots);
+}
+
 MWWorld::ContainerStoreIterator MWWorld::InventoryStore::getPreferredShield(const MWWorld::Ptr& actor)
 {
     TSlots slots;
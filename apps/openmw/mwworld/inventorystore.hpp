@@ -74,6 +74,7 @@ namespace MWWorld
             void autoEquipWeapon(const MWWorld::Ptr& actor, TSlots& slots_);
             void autoEquipArmor(const MWWorld::Ptr& actor, TSlots& slots_);
             void autoEquipShield(const MWWorld::Ptr& actor, TSlots& slots_);
+            void setAutoEquippedSlots(const MWWorld::Ptr& actor, TSlots& slots_);
 
             // selected magic item (for using enchantments of type "Cast once" or "Cast when used")
             ContainerStoreIterator mSelectedEnchantItem;
@@ -135,6 +136,10 @@ namespace MWWorld
             void autoEquip (const MWWorld::Ptr& actor);
             ///< Auto equip items according to stats and item value.
 
+            void autoEquipInitialItems (const MWWorld::Ptr& actor);
+            ///< Auto equip the items an actor was created with. Actors with the same record, stats and items
+            /// get the same equipment, so the choice made for the first one is reused for the others.
+
             bool stacks (const ConstPtr& ptr1, const ConstPtr& ptr2) const override;
             ///< @return true if the two specified objects can stack with each other
 
@@ -1,7 +1,14 @@
 #include "localscripts.hpp"
 
+#include <algorithm>
+
+#include <components/compiler/eventgate.hpp>
 #include <components/debug/debuglog.hpp>
 
+#include "../mwbase/environment.hpp"
+#include "../mwbase/scriptmanager.hpp"
+#include "../mwbase/windowmanager.hpp"
+
 #include "esmstore.hpp"
 #include "cellstore.hpp"
 #include "class.hpp"
@@ -64,22 +71,61 @@ namespace
 
 }
 
-MWWorld::LocalScripts::LocalScripts (const MWWorld::ESMStore& store) : mStore (store)
+MWWorld::LocalScripts::LocalScripts (const MWWorld::ESMStore& store) : mIndex (0), mRemoved (0), mStore (store) {}
+
+bool MWWorld::LocalScripts::isIdle (Script& script)
 {
-    mIter = mScripts.end();
+    if (!script.mEventGate)
+    {
+        script.mEventGate = MWBase::Environment::get().getScriptManager()->getEventGate (script.mName);
+        if (!script.mEventGate)
+            return false;
+    }
+
+    switch (*script.mEventGate)
+    {
+        case Compiler::EventGate::OnActivate:
+
+            return script.mPtr.getRefData().isWaitingForActivation();
+
+        case Compiler::EventGate::MenuMode:
+
+            return !MWBase::Environment::get().getWindowManager()->isGuiMode();
+
+        case Compiler::EventGate::NotMenuMode:
+
+            return MWBase::Environment::get().getWindowManager()->isGuiMode();
+
+        case Compiler::EventGate::None:
+
+            break;
+    }
+    return false;
 }
 
 void MWWorld::LocalScripts::startIteration()
 {
-    mIter = mScripts.begin();
+    if (mRemoved > 0)
+    {
+        mScripts.erase (std::remove_if (mScripts.begin(), mScripts.end(),
+            [] (const Script& script) { return script.mPtr.isEmpty(); }), mScripts.end());
+        mIndices.clear();
+        for (std::size_t i = 0; i < mScripts.size(); ++i)
+            mIndices.emplace (&mScripts[i].mPtr.getRefData(), i);
+        mRemoved = 0;
+    }
+    mIndex = 0;
 }
 
 bool MWWorld::LocalScripts::getNext(std::pair<std::string, Ptr>& script)
 {
-    if (mIter!=mScripts.end())
+    while (mIndex < mScripts.size())
     {
-        std::list<std::pair<std::string, Ptr> >::iterator iter = mIter++;
-        script = *iter;
+        Script& next = mScripts[mIndex++];
+        if (next.mPtr.isEmpty() || isIdle (next))
+            continue;
+        script.first = next.mName;
+        script.second = next.mPtr;
         return true;
     }
     return false;
@@ -93,15 +139,14 @@ void MWWorld::LocalScripts::add (const std::string& scriptName, const Ptr& ptr)
         {
             ptr.getRefData().setLocals (*script);
 
-            for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin(); iter!=mScripts.end(); ++iter)
-                if (iter->second==ptr)
-                {
-                    Log(Debug::Warning) << "Error: tried to add local script twice for " << ptr.getCellRef().getRefId();
-                    remove(ptr);
-                    break;
-                }
+            if (mIndices.find (&ptr.getRefData()) != mIndices.end())
+            {
+                Log(Debug::Warning) << "Error: tried to add local script twice for " << ptr.getCellRef().getRefId();
+                remove(ptr);
+            }
 
-            mScripts.emplace_back (scriptName, ptr);
+            mIndices[&ptr.getRefData()] = mScripts.size();
+            mScripts.push_back (Script {scriptName, ptr, {}});
         }
         catch (const std::exception& exception)
         {
@@ -130,50 +175,36 @@ void MWWorld::LocalScripts::addCell (CellStore *cell)
 void MWWorld::LocalScripts::clear()
 {
     mScripts.clear();
+    mIndices.clear();
+    mIndex = 0;
+    mRemoved = 0;
 }
 
 void MWWorld::LocalScripts::clearCell (CellStore *cell)
 {
-    std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
-
-    while (iter!=mScripts.end())
+    for (std::size_t i = 0; i < mScripts.size(); ++i)
     {
-        if (iter->second.mCell==cell)
-        {
-            if (iter==mIter)
-               ++mIter;
-
-            mScripts.erase (iter++);
-        }
-        else
-            ++iter;
+        if (!mScripts[i].mPtr.isEmpty() && mScripts[i].mPtr.mCell == cell)
+            remove (i);
     }
 }
 
-void MWWorld::LocalScripts::remove (RefData *ref)
+void MWWorld::LocalScripts::remove (std::size_t index)
 {
-    for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
-        iter!=mScripts.end(); ++iter)
-        if (&(iter->second.getRefData()) == ref)
-        {
-            if (iter==mIter)
-                ++mIter;
+    mIndices.erase (&mScripts[index].mPtr.getRefData());
+    mScripts[index].mPtr = Ptr();
+    ++mRemoved;
+}
 
-            mScripts.erase (iter);
-            break;
-        }
+void MWWorld::LocalScripts::remove (RefData *ref)
+{
+    const auto it = mIndices.find (ref);
+    if (it != mIndices.end())
+        remove (it->second);
 }
 
 void MWWorld::LocalScripts::remove (const Ptr& ptr)
 {
-    for (std::list<std::pair<std::string, Ptr> >::iterator iter = mScripts.begin();
-        iter!=mScripts.end(); ++iter)
-        if (iter->second==ptr)
-        {
-            if (iter==mIter)
-                ++mIter;
-
-            mScripts.erase (iter);
-            break;
-        }
+    if (!ptr.isEmpty())
+        remove (&ptr.getRefData());
 }
@@ -1,11 +1,18 @@
 #ifndef GAME_MWWORLD_LOCALSCRIPTS_H
 #define GAME_MWWORLD_LOCALSCRIPTS_H
 
-#include <list>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "ptr.hpp"
 
+namespace Compiler
+{
+    enum class EventGate;
+}
+
 namespace MWWorld
 {
     class ESMStore;
@@ -15,10 +22,26 @@ namespace MWWorld
     /// \brief List of active local scripts
     class LocalScripts
     {
-            std::list<std::pair<std::string, Ptr> > mScripts;
-            std::list<std::pair<std::string, Ptr> >::iterator mIter;
+            struct Script
+            {
+                std::string mName;
+                // Empty once the script has been removed, until the entry is dropped at the next iteration
+                Ptr mPtr;
+                // Unknown until the script has been compiled
+                std::optional<Compiler::EventGate> mEventGate;
+            };
+
+            std::vector<Script> mScripts;
+            std::unordered_map<const RefData*, std::size_t> mIndices;
+            std::size_t mIndex;
+            std::size_t mRemoved;
             const MWWorld::ESMStore& mStore;
 
+            bool isIdle (Script& script);
+            ///< Is the script waiting for the event it is gated on?
+
+            void remove (std::size_t index);
+
         public:
 
             LocalScripts (const MWWorld::ESMStore& store);
@@ -27,7 +50,7 @@ namespace MWWorld
             ///< Set the iterator to the begin of the script list.
 
             bool getNext(std::pair<std::string, Ptr>& script);
-            ///< Get next local script
+            ///< Get next local script, skipping scripts that wait for an event
             /// @return Did we get a script?
 
             void add (const std::string& scriptName, const Ptr& ptr);
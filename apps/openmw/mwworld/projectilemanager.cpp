@@ -496,65 +496,29 @@ namespace MWWorld
             if (projectileState.mToDelete)
                 continue;
 
-            auto* projectile = mPhysics->getProjectile(projectileState.mProjectileId);
-
-            const auto pos = projectile->getSimulationPosition();
-            projectileState.mNode->setPosition(pos);
-
-            if (projectile->isActive())
-                continue;
-
-            const auto target = projectile->getTarget();
-            auto caster = projectileState.getCaster();
-            assert(target != caster);
-
-            if (caster.isEmpty())
-                caster = target;
-
-            // Try to get a Ptr to the bow that was used. It might no longer exist.
-            MWWorld::ManualRef projectileRef(MWBase::Environment::get().getWorld()->getStore(), projectileState.mIdArrow);
-            MWWorld::Ptr bow = projectileRef.getPtr();
-            if (!caster.isEmpty() && projectileState.mIdArrow != projectileState.mBowId)
-            {
-                MWWorld::InventoryStore& inv = caster.getClass().getInventoryStore(caster);
-                MWWorld::ContainerStoreIterator invIt = inv.getSlot(MWWorld::InventoryStore::Slot_CarriedRight);
-                if (invIt != inv.end() && Misc::StringUtils::ciEqual(invIt->getCellRef().getRefId(), projectileState.mBowId))
-                    bow = *invIt;
-            }
-            if (projectile->getHitWater())
-                mRendering->emitWaterRipple(pos);
-
-            MWMechanics::projectileHit(caster, target, bow, projectileRef.getPtr(), pos, projectileState.mAttackStrength);
-            projectileState.mToDelete = true;
+            const auto* projectile = mPhysics->getProjectile(projectileState.mProjectileId);
+            projectileState.mNode->setPosition(projectile->getSimulationPosition());
         }
         for (auto& magicBoltState : mMagicBolts)
         {
             if (magicBoltState.mToDelete)
                 continue;
 
-            auto* projectile = mPhysics->getProjectile(magicBoltState.mProjectileId);
-
+            const auto* projectile = mPhysics->getProjectile(magicBoltState.mProjectileId);
             const auto pos = projectile->getSimulationPosition();
             magicBoltState.mNode->setPosition(pos);
             for (const auto& sound : magicBoltState.mSounds)
                 sound->setPosition(pos);
+        }
 
-            if (projectile->isActive())
-                continue;
-
-            const auto target = projectile->getTarget();
-            const auto caster = magicBoltState.getCaster();
-            assert(target != caster);
-
-            MWMechanics::CastSpell cast(caster, target);
-            cast.mHitPosition = pos;
-            cast.mId = magicBoltState.mSpellId;
-            cast.mSourceName = magicBoltState.mSourceName;
-            cast.mSlot = magicBoltState.mSlot;
-            cast.inflict(target, caster, magicBoltState.mEffects, ESM::RT_Target, true);
-
-            MWBase::Environment::get().getWorld()->explodeSpell(pos, magicBoltState.mEffects, caster, target, ESM::RT_Target, magicBoltState.mSpellId, magicBoltState.mSourceName, false, magicBoltState.mSlot);
-            magicBoltState.mToDelete = true;
+        // Only the projectiles reported by the physics threads have to be checked
+        for (const int projectileId : mPhysics->takeProjectileHits())
+        {
+            const auto hasId = [&] (const State& state) { return !state.mToDelete && state.mProjectileId == projectileId; };
+            if (const auto projectile = std::find_if(mProjectiles.begin(), mProjectiles.end(), hasId); projectile != mProjectiles.end())
+                processProjectileHit(*projectile);
+            else if (const auto magicBolt = std::find_if(mMagicBolts.begin(), mMagicBolts.end(), hasId); magicBolt != mMagicBolts.end())
+                processMagicBoltHit(*magicBolt);
         }
 
         for (auto& projectileState : mProjectiles)
@@ -574,6 +538,53 @@ namespace MWWorld
                 mMagicBolts.end());
     }
 
+    void ProjectileManager::processProjectileHit(ProjectileState& projectileState)
+    {
+        const auto* projectile = mPhysics->getProjectile(projectileState.mProjectileId);
+        const auto pos = projectile->getSimulationPosition();
+        const auto target = projectile->getTarget();
+        auto caster = projectileState.getCaster();
+        assert(target != caster);
+
+        if (caster.isEmpty())
+            caster = target;
+
+        // Try to get a Ptr to the bow that was used. It might no longer exist.
+        MWWorld::ManualRef projectileRef(MWBase::Environment::get().getWorld()->getStore(), projectileState.mIdArrow);
+        MWWorld::Ptr bow = projectileRef.getPtr();
+        if (!caster.isEmpty() && projectileState.mIdArrow != projectileState.mBowId)
+        {
+            MWWorld::InventoryStore& inv = caster.getClass().getInventoryStore(caster);
+            MWWorld::ContainerStoreIterator invIt = inv.getSlot(MWWorld::InventoryStore::Slot_CarriedRight);
+            if (invIt != inv.end() && Misc::StringUtils::ciEqual(invIt->getCellRef().getRefId(), projectileState.mBowId))
+                bow = *invIt;
+        }
+        if (projectile->getHitWater())
+            mRendering->emitWaterRipple(pos);
+
+        MWMechanics::projectileHit(caster, target, bow, projectileRef.getPtr(), pos, projectileState.mAttackStrength);
+        projectileState.mToDelete = true;
+    }
+
+    void ProjectileManager::processMagicBoltHit(MagicBoltState& magicBoltState)
+    {
+        const auto* projectile = mPhysics->getProjectile(magicBoltState.mProjectileId);
+        const auto pos = projectile->getSimulationPosition();
+        const auto target = projectile->getTarget();
+        const auto caster = magicBoltState.getCaster();
+        assert(target != caster);
+
+        MWMechanics::CastSpell cast(caster, target);
+        cast.mHitPosition = pos;
+        cast.mId = magicBoltState.mSpellId;
+        cast.mSourceName = magicBoltState.mSourceName;
+        cast.mSlot = magicBoltState.mSlot;
+        cast.inflict(target, caster, magicBoltState.mEffects, ESM::RT_Target, true);
+
+        MWBase::Environment::get().getWorld()->explodeSpell(pos, magicBoltState.mEffects, caster, target, ESM::RT_Target, magicBoltState.mSpellId, magicBoltState.mSourceName, false, magicBoltState.mSlot);
+        magicBoltState.mToDelete = true;
+    }
+
     void ProjectileManager::cleanupProjectile(ProjectileManager::ProjectileState& state)
     {
         mParent->removeChild(state.mNode);
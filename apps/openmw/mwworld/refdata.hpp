@@ -145,6 +145,9 @@ namespace MWWorld
 
             bool onActivate();
 
+            bool isWaitingForActivation() const;
+            ///< Would onActivate return false without changing anything?
+
             bool activateByScript();
 
             bool hasChanged() const;
@@ -33,6 +33,8 @@
 #include "../mwphysics/object.hpp"
 #include "../mwphysics/heightfield.hpp"
 
+#include "../mwmechanics/creaturestats.hpp"
+
 #include "player.hpp"
 #include "localscripts.hpp"
 #include "esmstore.hpp"
@@ -236,6 +238,14 @@ namespace
         }
     }
 
+    // Speed (in units per second) assumed towards the direction the player is facing, so that cells in front
+    // are preferred while standing still
+    constexpr float facingSpeed = 100.f;
+    // Keeps estimates finite for cells the player is neither facing nor moving to
+    constexpr float minApproachSpeed = 10.f;
+    // Getting to fast travel destinations requires a dialogue first
+    constexpr float fastTravelTimeToArrival = 10.f;
+
     int getCellPositionDistanceToOrigin(const std::pair<int, int>& cellPosition)
     {
         return std::abs(cellPosition.first) + std::abs(cellPosition.second);
@@ -298,10 +308,30 @@ namespace MWWorld
     {
         mPreloader->updateCache(mRendering.getReferenceTime());
         preloadCells(duration);
+        loadPendingCells();
 
         mRendering.update (duration, paused);
     }
 
+    void Scene::loadPendingCells()
+    {
+        if (mPendingCells.empty())
+            return;
+
+        // At least one cell is loaded every frame, so the grid always gets complete
+        const auto start = std::chrono::steady_clock::now();
+        const auto budget = std::chrono::duration<float>(mCellActivationBudget);
+        const osg::Vec3f playerPos = MWBase::Environment::get().getWorld()->getPlayerPtr().getRefData().getPosition().asVec3();
+        do
+        {
+            const auto [x, y] = mPendingCells.front();
+            mPendingCells.pop_front();
+            if (!isCellInCollection(x, y, mActiveCells))
+                loadCell(MWBase::Environment::get().getWorld()->getExterior(x, y), nullptr, mPendingCellsRespawn, playerPos);
+        }
+        while (!mPendingCells.empty() && std::chrono::steady_clock::now() - start < budget);
+    }
+
     void Scene::unloadCell(CellStore* cell)
     {
         if (mActiveCells.find(cell) == mActiveCells.end())
@@ -328,6 +358,7 @@ namespace MWWorld
                 mPhysics->remove(ptr);
             }
             MWBase::Environment::get().getLuaManager()->objectRemovedFromScene(ptr);
+            unindexObject(ptr);
         }
 
         const auto cellX = cell->getCell()->getGridX();
@@ -378,13 +409,13 @@ namespace MWWorld
 
         if (cell->getCell()->isExterior())
         {
-            osg::ref_ptr<const ESMTerrain::LandObject> land = mRendering.getLandManager()->getLand(cellX, cellY);
-            const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VHGT) : nullptr;
+            osg::ref_ptr<const ESMTerrain::LandObject> land = mRendering.getLandManager()->getLandHeights(cellX, cellY);
+            const float* landHeights = land ? land->getHeights() : nullptr;
             const int verts = ESM::Land::LAND_SIZE;
             const int worldsize = ESM::Land::REAL_SIZE;
-            if (data)
+            if (landHeights)
             {
-                mPhysics->addHeightField(data->mHeights, cellX, cellY, worldsize, verts, data->mMinHeight, data->mMaxHeight, land.get());
+                mPhysics->addHeightField(landHeights, cellX, cellY, worldsize, verts, land->getMinHeight(), land->getMaxHeight(), land.get());
             }
             else
             {
@@ -399,17 +430,17 @@ namespace MWWorld
                 const osg::Vec3f shift(origin.x(), origin.y(), origin.z());
                 const HeightfieldShape shape = [&] () -> HeightfieldShape
                 {
-                    if (data == nullptr)
+                    if (landHeights == nullptr)
                     {
                         return DetourNavigator::HeightfieldPlane {static_cast<float>(ESM::Land::DEFAULT_HEIGHT)};
                     }
                     else
                     {
                         DetourNavigator::HeightfieldSurface heights;
-                        heights.mHeights = data->mHeights;
+                        heights.mHeights = landHeights;
                         heights.mSize = static_cast<std::size_t>(ESM::Land::LAND_SIZE);
-                        heights.mMinHeight = data->mMinHeight;
-                        heights.mMaxHeight = data->mMaxHeight;
+                        heights.mMinHeight = land->getMinHeight();
+                        heights.mMaxHeight = land->getMaxHeight();
                         return heights;
                     }
                 } ();
@@ -477,6 +508,9 @@ namespace MWWorld
             unloadCell (cell);
         }
         assert(mActiveCells.empty());
+        mObjectsByRefNum.clear();
+        mActorsById.clear();
+        mPendingCells.clear();
         mCurrentCell = nullptr;
 
         mPreloader->clear();
@@ -515,11 +549,13 @@ namespace MWWorld
 
         osg::Vec2i newCell = getNewGridCenter(pos, &mCurrentGridCenter);
         if (newCell != mCurrentGridCenter)
-            changeCellGrid(pos, newCell.x(), newCell.y());
+            changeCellGrid(pos, newCell.x(), newCell.y(), true, mCellActivationBudget > 0);
     }
 
-    void Scene::changeCellGrid (const osg::Vec3f &pos, int playerCellX, int playerCellY, bool changeEvent)
+    void Scene::changeCellGrid (const osg::Vec3f &pos, int playerCellX, int playerCellY, bool changeEvent, bool staged)
     {
+        mPendingCells.clear();
+
         for (auto iter = mActiveCells.begin(); iter != mActiveCells.end(); )
         {
             auto* cell = *iter++;
@@ -584,12 +620,6 @@ namespace MWWorld
 
         auto cellsPositionsToLoad = cellsToLoad(mActiveCells,mHalfGridSize);
 
-        Loading::Listener* loadingListener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
-        Loading::ScopedLoad load(loadingListener);
-        std::string loadingExteriorText = "#{sLoadingMessage3}";
-        loadingListener->setLabel(loadingExteriorText);
-        loadingListener->setProgressRange(refsToLoad);
-
         const auto getDistanceToPlayerCell = [&] (const std::pair<int, int>& cellPosition)
         {
             return std::abs(cellPosition.first - playerCellX) + std::abs(cellPosition.second - playerCellY);
@@ -605,6 +635,25 @@ namespace MWWorld
                 return getCellPositionPriority(lhs) < getCellPositionPriority(rhs);
             });
 
+        if (staged)
+        {
+            // Only the cell the player enters is needed right away, so its physics are present on this frame
+            mPendingCellsRespawn = changeEvent;
+            const auto firstPending = std::stable_partition(cellsPositionsToLoad.begin(), cellsPositionsToLoad.end(),
+                [&] (const std::pair<int, int>& cellPosition) { return getDistanceToPlayerCell(cellPosition) == 0; });
+            mPendingCells.assign(firstPending, cellsPositionsToLoad.end());
+            cellsPositionsToLoad.erase(firstPending, cellsPositionsToLoad.end());
+            refsToLoad = 0;
+            for (const auto& [x, y] : cellsPositionsToLoad)
+                refsToLoad += MWBase::Environment::get().getWorld()->getExterior(x, y)->count();
+        }
+
+        Loading::Listener* loadingListener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
+        Loading::ScopedLoad load(loadingListener);
+        std::string loadingExteriorText = "#{sLoadingMessage3}";
+        loadingListener->setLabel(loadingExteriorText);
+        loadingListener->setProgressRange(refsToLoad);
+
         for (const auto& [x,y] : cellsPositionsToLoad)
         {
             if (!isCellInCollection(x, y, mActiveCells))
@@ -756,11 +805,14 @@ namespace MWWorld
     , mPreloadDoors(Settings::Manager::getBool("preload doors", "Cells"))
     , mPreloadFastTravel(Settings::Manager::getBool("preload fast travel", "Cells"))
     , mPredictionTime(Settings::Manager::getFloat("prediction time", "Cells"))
+    , mCellActivationBudget(std::max(0.f, Settings::Manager::getFloat("cell activation time budget", "Cells")) / 1000.f)
     {
         mPreloader.reset(new CellPreloader(rendering.getResourceSystem(), physics->getShapeManager(), rendering.getTerrain(), rendering.getLandManager()));
         mPreloader->setWorkQueue(mRendering.getWorkQueue());
 
         rendering.getResourceSystem()->setExpiryDelay(Settings::Manager::getFloat("cache expiry delay", "Cells"));
+        rendering.getResourceSystem()->setMemoryBudget(
+            static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("cache memory budget", "Cells"))) * 1024 * 1024);
 
         mPreloader->setExpiryDelay(Settings::Manager::getFloat("preload cell expiry delay", "Cells"));
         mPreloader->setMinCacheSize(Settings::Manager::getInt("preload cell cache min", "Cells"));
@@ -771,7 +823,7 @@ namespace MWWorld
     Scene::~Scene()
     {
         for (const osg::ref_ptr<SceneUtil::WorkItem>& v : mWorkItems)
-            v->abort();
+            v->cancel();
 
         for (const osg::ref_ptr<SceneUtil::WorkItem>& v : mWorkItems)
             v->waitTillDone();
@@ -820,6 +872,7 @@ namespace MWWorld
             unloadCell(cellToUnload);
         }
         assert(mActiveCells.empty());
+        mPendingCells.clear();
 
         loadingListener->setProgressRange(cell->count());
 
@@ -881,12 +934,16 @@ namespace MWWorld
     {
         InsertVisitor insertVisitor(cell, loadingListener);
         cell.forEach (insertVisitor);
+        // Disabled objects can still be found by their RefNum, so everything visited is indexed
+        for (const MWWorld::Ptr& ptr : insertVisitor.mToInsert)
+            indexObject(ptr);
         insertVisitor.insert([&] (const MWWorld::Ptr& ptr) { addObject(ptr, *mPhysics, mRendering, mPagedRefs); });
         insertVisitor.insert([&] (const MWWorld::Ptr& ptr) { addObject(ptr, *mPhysics, mNavigator); });
     }
 
     void Scene::addObjectToScene (const Ptr& ptr)
     {
+        indexObject(ptr);
         try
         {
             addObject(ptr, *mPhysics, mRendering, mPagedRefs);
@@ -909,6 +966,7 @@ namespace MWWorld
         MWBase::Environment::get().getMechanicsManager()->remove (ptr, keepActive);
         MWBase::Environment::get().getSoundManager()->stopSound3D (ptr);
         MWBase::Environment::get().getLuaManager()->objectRemovedFromScene(ptr);
+        unindexObject(ptr);
         if (const auto object = mPhysics->getObject(ptr))
         {
             mNavigator.removeObject(DetourNavigator::ObjectId(object));
@@ -941,13 +999,79 @@ namespace MWWorld
         return false;
     }
 
+    void Scene::indexObject(const Ptr& ptr)
+    {
+        const ESM::RefNum& refNum = ptr.getCellRef().getRefNum();
+        if (refNum.isSet())
+            mObjectsByRefNum[refNum] = ptr;
+
+        if (ptr.getClass().isActor())
+        {
+            MWMechanics::CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+            if (stats.hasActorId())
+                mActorsById[stats.getActorId()] = ptr;
+        }
+    }
+
+    void Scene::unindexObject(const Ptr& ptr)
+    {
+        // Only drop entries still pointing at this reference, a moved object may already be indexed in its new cell
+        const auto refNumIt = mObjectsByRefNum.find(ptr.getCellRef().getRefNum());
+        if (refNumIt != mObjectsByRefNum.end() && refNumIt->second.mRef == ptr.mRef)
+            mObjectsByRefNum.erase(refNumIt);
+
+        if (ptr.getClass().isActor())
+        {
+            MWMechanics::CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+            if (stats.hasActorId())
+            {
+                const auto actorIt = mActorsById.find(stats.getActorId());
+                if (actorIt != mActorsById.end() && actorIt->second.mRef == ptr.mRef)
+                    mActorsById.erase(actorIt);
+            }
+        }
+    }
+
+    void Scene::updatePtr(const Ptr& old, const Ptr& newPtr)
+    {
+        unindexObject(old);
+        indexObject(newPtr);
+    }
+
     Ptr Scene::searchPtrViaActorId (int actorId)
     {
+        const auto found = mActorsById.find(actorId);
+        if (found != mActorsById.end())
+        {
+            const Ptr& ptr = found->second;
+            if (mActiveCells.count(ptr.getCell()) && ptr.getRefData().getCount() > 0
+                && ptr.getClass().getCreatureStats(ptr).matchesActorId(actorId))
+                return ptr;
+            mActorsById.erase(found);
+        }
+
         for (CellStoreCollection::const_iterator iter (mActiveCells.begin());
             iter!=mActiveCells.end(); ++iter)
             if (Ptr ptr = (*iter)->searchViaActorId (actorId))
+            {
+                mActorsById[actorId] = ptr;
                 return ptr;
+            }
+
+        return Ptr();
+    }
 
+    Ptr Scene::searchPtrViaRefNum (const ESM::RefNum& refNum)
+    {
+        const auto found = mObjectsByRefNum.find(refNum);
+        if (found == mObjectsByRefNum.end())
+            return Ptr();
+
+        const Ptr& ptr = found->second;
+        if (mActiveCells.count(ptr.getCell()) && ptr.getCellRef().getRefNum() == refNum
+            && CellStore::isAccessible(ptr.getRefData(), ptr.getCellRef()))
+            return ptr;
+        mObjectsByRefNum.erase(found);
         return Ptr();
     }
 
@@ -1009,6 +1133,9 @@ namespace MWWorld
         osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
         osg::Vec3f moved = playerPos - mLastPlayerPos;
         osg::Vec3f predictedPos = playerPos + moved / dt * mPredictionTime;
+        mPlayerVelocity = moved / dt;
+        const float yaw = player.getRefData().getPosition().rot[2];
+        mPlayerFacing = osg::Vec3f(std::sin(yaw), std::cos(yaw), 0.f);
 
         if (mCurrentCell->isExterior())
             exteriorPositions.emplace_back(predictedPos, gridCenterToBounds(getNewGridCenter(predictedPos, &mCurrentGridCenter)));
@@ -1055,13 +1182,16 @@ namespace MWWorld
                 try
                 {
                     if (!door.getCellRef().getDestCell().empty())
-                        preloadCell(MWBase::Environment::get().getWorld()->getInterior(door.getCellRef().getDestCell()));
+                    const float timeToArrival = estimateTimeToArrival(door.getRefData().getPosition().asVec3());
+                    if (!door.getCellRef().getDestCell().empty())
+                        preloadCell(MWBase::Environment::get().getWorld()->getInterior(door.getCellRef().getDestCell()),
+                                    false, timeToArrival, PreloadReason::Door);
                     else
                     {
                         osg::Vec3f pos = door.getCellRef().getDoorDest().asVec3();
                         int x,y;
                         MWBase::Environment::get().getWorld()->positionToIndex (pos.x(), pos.y(), x, y);
-                        preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
+                        preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true, timeToArrival, PreloadReason::Door);
                         exteriorPositions.emplace_back(pos, gridCenterToBounds(getNewGridCenter(pos)));
                     }
                 }
@@ -1102,12 +1232,28 @@ namespace MWWorld
                 float loadDist = Constants::CellSizeInUnits / 2 + Constants::CellSizeInUnits - mCellLoadingThreshold + mPreloadDistance;
 
                 if (dist < loadDist)
-                    preloadCell(MWBase::Environment::get().getWorld()->getExterior(cellX+dx, cellY+dy));
+                {
+                    // The player needs the cell when getting into the loading distance of its grid
+                    osg::Vec3f cellCenter(thisCellCenterX, thisCellCenterY, playerPos.z());
+                    const float timeToArrival = estimateTimeToArrival(cellCenter) * (dist - Constants::CellSizeInUnits / 2) / dist;
+                    preloadCell(MWBase::Environment::get().getWorld()->getExterior(cellX+dx, cellY+dy), false,
+                                std::max(0.f, timeToArrival), PreloadReason::ExteriorGrid);
+                }
             }
         }
     }
 
-    void Scene::preloadCell(CellStore *cell, bool preloadSurrounding)
+    float Scene::estimateTimeToArrival(const osg::Vec3f& pos) const
+    {
+        osg::Vec3f direction = pos - mLastPlayerPos;
+        direction.z() = 0;
+        const float distance = direction.normalize();
+        const float speed = std::max(0.f, mPlayerVelocity * direction)
+            + facingSpeed * std::max(0.f, mPlayerFacing * direction) + minApproachSpeed;
+        return distance / speed;
+    }
+
+    void Scene::preloadCell(CellStore *cell, bool preloadSurrounding, float timeToArrival, PreloadReason reason)
     {
         if (preloadSurrounding && cell->isExterior())
         {
@@ -1118,14 +1264,20 @@ namespace MWWorld
             {
                 for (int dy = -mHalfGridSize; dy <= mHalfGridSize; ++dy)
                 {
-                    mPreloader->preload(MWBase::Environment::get().getWorld()->getExterior(x+dx, y+dy), mRendering.getReferenceTime());
+                    mPreloader->preload(MWBase::Environment::get().getWorld()->getExterior(x+dx, y+dy), mRendering.getReferenceTime(),
+                                        timeToArrival, reason);
                     if (++numpreloaded >= mPreloader->getMaxCacheSize())
                         break;
                 }
             }
         }
         else
-            mPreloader->preload(cell, mRendering.getReferenceTime());
+            mPreloader->preload(cell, mRendering.getReferenceTime(), timeToArrival, reason);
+    }
+
+    void Scene::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        mPreloader->reportStats(frameNumber, stats);
     }
 
     void Scene::preloadTerrain(const osg::Vec3f &pos, bool sync)
@@ -1193,13 +1345,15 @@ namespace MWWorld
         for (ESM::Transport::Dest& dest : listVisitor.mList)
         {
             if (!dest.mCellName.empty())
-                preloadCell(MWBase::Environment::get().getWorld()->getInterior(dest.mCellName));
+                preloadCell(MWBase::Environment::get().getWorld()->getInterior(dest.mCellName), false,
+                            fastTravelTimeToArrival, PreloadReason::FastTravel);
             else
             {
                 osg::Vec3f pos = dest.mPos.asVec3();
                 int x,y;
                 MWBase::Environment::get().getWorld()->positionToIndex( pos.x(), pos.y(), x, y);
-                preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
+                preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true,
+                            fastTravelTimeToArrival, PreloadReason::FastTravel);
                 exteriorPositions.emplace_back(pos, gridCenterToBounds(getNewGridCenter(pos)));
             }
         }
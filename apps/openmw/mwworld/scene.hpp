@@ -7,7 +7,10 @@
 
 #include "ptr.hpp"
 #include "globals.hpp"
+#include "cellpreloader.hpp"
 
+#include <deque>
+#include <map>
 #include <set>
 #include <memory>
 #include <unordered_map>
@@ -18,6 +21,7 @@
 namespace osg
 {
     class Vec3f;
+    class Stats;
 }
 
 namespace ESM
@@ -60,7 +64,6 @@ namespace MWWorld
 {
     class Player;
     class CellStore;
-    class CellPreloader;
 
     enum class RotationOrder
     {
@@ -90,20 +93,35 @@ namespace MWWorld
             bool mPreloadDoors;
             bool mPreloadFastTravel;
             float mPredictionTime;
+            float mCellActivationBudget;
+
+            // Exterior cells of the grid that are activated over the next frames, nearest first
+            std::deque<std::pair<int, int>> mPendingCells;
+            bool mPendingCellsRespawn = false;
 
             static const int mHalfGridSize = Constants::CellGridRadius;
 
             osg::Vec3f mLastPlayerPos;
+            osg::Vec3f mPlayerVelocity;
+            osg::Vec3f mPlayerFacing;
 
             std::set<ESM::RefNum> mPagedRefs;
 
+            // Objects of the active cells, so they can be found without visiting every reference.
+            // Entries are checked on lookup, actors that get an ID later on are added when they are first searched.
+            std::map<ESM::RefNum, Ptr> mObjectsByRefNum;
+            std::unordered_map<int, Ptr> mActorsById;
+
             std::vector<osg::ref_ptr<SceneUtil::WorkItem>> mWorkItems;
 
             void insertCell(CellStore &cell, Loading::Listener* loadingListener);
             osg::Vec2i mCurrentGridCenter;
 
             // Load and unload cells as necessary to create a cell grid with "X" and "Y" in the center
-            void changeCellGrid (const osg::Vec3f &pos, int playerCellX, int playerCellY, bool changeEvent = true);
+            // If \a staged is set, only the cell of the player is loaded immediately, the other cells are loaded
+            // by update() within the "cell activation time budget".
+            void changeCellGrid (const osg::Vec3f &pos, int playerCellX, int playerCellY, bool changeEvent = true, bool staged = false);
+            void loadPendingCells();
 
             typedef std::pair<osg::Vec3f, osg::Vec4i> PositionCellGrid;
 
@@ -112,6 +130,9 @@ namespace MWWorld
             void preloadExteriorGrid(const osg::Vec3f& playerPos, const osg::Vec3f& predictedPos);
             void preloadFastTravelDestinations(const osg::Vec3f& playerPos, const osg::Vec3f& predictedPos, std::vector<PositionCellGrid>& exteriorPositions);
 
+            /// Estimated time in seconds the player needs to get to \a pos, based on the velocity and the facing of the player.
+            float estimateTimeToArrival(const osg::Vec3f& pos) const;
+
             osg::Vec4i gridCenterToBounds(const osg::Vec2i &centerCell) const;
             osg::Vec2i getNewGridCenter(const osg::Vec3f &pos, const osg::Vec2i *currentGridCenter = nullptr) const;
 
@@ -125,7 +146,8 @@ namespace MWWorld
 
             ~Scene();
 
-            void preloadCell(MWWorld::CellStore* cell, bool preloadSurrounding=false);
+            void preloadCell(MWWorld::CellStore* cell, bool preloadSurrounding=false, float timeToArrival=0,
+                             PreloadReason reason=PreloadReason::ExteriorGrid);
             void preloadTerrain(const osg::Vec3f& pos, bool sync=false);
             void reloadTerrain();
 
@@ -163,6 +185,9 @@ namespace MWWorld
 
             void removeFromPagedRefs(const Ptr &ptr);
 
+            void indexObject(const Ptr& ptr);
+            void unindexObject(const Ptr& ptr);
+
             void updateObjectRotation(const Ptr& ptr, RotationOrder order);
             void updateObjectScale(const Ptr& ptr);
             void updateObjectPosition(const Ptr &ptr, const osg::Vec3f &pos, bool movePhysics);
@@ -171,8 +196,16 @@ namespace MWWorld
 
             Ptr searchPtrViaActorId (int actorId);
 
+            /// Find an object of the active cells. Returns an empty Ptr if it is not in the scene.
+            Ptr searchPtrViaRefNum (const ESM::RefNum& refNum);
+
+            /// Update the index after an object was moved between two active cells.
+            void updatePtr (const Ptr& old, const Ptr& newPtr);
+
             void preload(const std::string& mesh, bool useAnim=false);
 
+            void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
             void testExteriorCells();
             void testInteriorCells();
     };
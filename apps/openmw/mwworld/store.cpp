@@ -10,6 +10,25 @@
 
 #include <iterator>
 #include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+    // The maps are keyed by std::string, reusing a buffer avoids an allocation for each lookup with a std::string_view
+    const std::string& getLookupKey(std::string_view id)
+    {
+        thread_local std::string key;
+        key.assign(id.data(), id.size());
+        return key;
+    }
+
+    template <class T>
+    struct ParsedStoreRecord : MWWorld::ParsedRecord
+    {
+        T mValue;
+        bool mIsDeleted = false;
+    };
+}
 
 namespace MWWorld
 {
@@ -17,6 +36,35 @@ namespace MWWorld
         : mId(id), mIsDeleted(isDeleted)
     {}
 
+    LazyRecordLoader::LazyRecordLoader(const ToUTF8::Utf8Encoder* encoder)
+    {
+        if (encoder != nullptr)
+            mEncoder.emplace(*encoder);
+    }
+
+    void LazyRecordLoader::load(ESM::Book& record)
+    {
+        std::lock_guard lock(mMutex);
+        record.loadText(mEncoder ? &*mEncoder : nullptr);
+    }
+
+    template<typename T>
+    void Store<T>::loadRecord(T& record, ESM::ESMReader& esm, bool& isDeleted) const
+    {
+        if constexpr (std::is_same_v<T, ESM::Book>)
+            record.load(esm, isDeleted, mLazyLoader != nullptr);
+        else
+            record.load(esm, isDeleted);
+    }
+
+    template<typename T>
+    void Store<T>::loadLazyData(const T* record) const
+    {
+        // Records are never const in the store, only the access to them is
+        if (record != nullptr && mLazyLoader != nullptr)
+            mLazyLoader->load(const_cast<T&>(*record));
+    }
+
     template<typename T>
     IndexedStore<T>::IndexedStore()
     {
@@ -83,6 +131,7 @@ namespace MWWorld
     template<typename T>
     Store<T>::Store(const Store<T>& orig)
         : mStatic(orig.mStatic)
+        , mLazyLoader(orig.mLazyLoader)
     {
     }
 
@@ -96,32 +145,42 @@ namespace MWWorld
     }
 
     template<typename T>
-    const T *Store<T>::search(const std::string &id) const
+    const T *Store<T>::search(std::string_view id) const
     {
-        typename Dynamic::const_iterator dit = mDynamic.find(id);
+        const std::string& key = getLookupKey(id);
+        typename Dynamic::const_iterator dit = mDynamic.find(key);
         if (dit != mDynamic.end())
+        {
+            loadLazyData(&dit->second);
             return &dit->second;
+        }
 
-        typename Static::const_iterator it = mStatic.find(id);
+        typename Static::const_iterator it = mStatic.find(key);
         if (it != mStatic.end())
+        {
+            loadLazyData(&it->second);
             return &(it->second);
+        }
 
         return nullptr;
     }
     template<typename T>
-    const T *Store<T>::searchStatic(const std::string &id) const
+    const T *Store<T>::searchStatic(std::string_view id) const
     {
-        typename Static::const_iterator it = mStatic.find(id);
+        typename Static::const_iterator it = mStatic.find(getLookupKey(id));
         if (it != mStatic.end())
+        {
+            loadLazyData(&it->second);
             return &(it->second);
+        }
 
         return nullptr;
     }
 
     template<typename T>
-    bool Store<T>::isDynamic(const std::string &id) const
+    bool Store<T>::isDynamic(std::string_view id) const
     {
-        typename Dynamic::const_iterator dit = mDynamic.find(id);
+        typename Dynamic::const_iterator dit = mDynamic.find(getLookupKey(id));
         return (dit != mDynamic.end());
     }
     template<typename T>
@@ -134,11 +193,15 @@ namespace MWWorld
                     return Misc::StringUtils::ciCompareLen(id, item->mId, id.size()) == 0;
                 });
         if(!results.empty())
-            return results[Misc::Rng::rollDice(results.size())];
+        {
+            const T* result = results[Misc::Rng::rollDice(results.size())];
+            loadLazyData(result);
+            return result;
+        }
         return nullptr;
     }
     template<typename T>
-    const T *Store<T>::find(const std::string &id) const
+    const T *Store<T>::find(std::string_view id) const
     {
         const T *ptr = search(id);
         if (ptr == nullptr)
@@ -155,7 +218,7 @@ namespace MWWorld
         T record;
         bool isDeleted = false;
 
-        record.load(esm, isDeleted);
+        loadRecord(record, esm, isDeleted);
         Misc::StringUtils::lowerCaseInPlace(record.mId); // TODO: remove this line once we have ported our remaining code base to lowercase on lookup
 
         std::pair<typename Static::iterator, bool> inserted = mStatic.insert_or_assign(record.mId, record);
@@ -165,6 +228,27 @@ namespace MWWorld
         return RecordId(record.mId, isDeleted);
     }
     template<typename T>
+    std::unique_ptr<ParsedRecord> Store<T>::parse(ESM::ESMReader &esm) const
+    {
+        auto result = std::make_unique<ParsedStoreRecord<T>>();
+
+        loadRecord(result->mValue, esm, result->mIsDeleted);
+        Misc::StringUtils::lowerCaseInPlace(result->mValue.mId);
+
+        return result;
+    }
+    template<typename T>
+    RecordId Store<T>::merge(ParsedRecord &record)
+    {
+        auto& parsed = static_cast<ParsedStoreRecord<T>&>(record);
+
+        std::pair<typename Static::iterator, bool> inserted = mStatic.insert_or_assign(parsed.mValue.mId, std::move(parsed.mValue));
+        if (inserted.second)
+            mShared.push_back(&inserted.first->second);
+
+        return RecordId(inserted.first->second.mId, parsed.mIsDeleted);
+    }
+    template<typename T>
     void Store<T>::setUp()
     {
     }
@@ -278,6 +362,25 @@ namespace MWWorld
         }
     }
     template<typename T>
+    void Store<T>::writeStatic(ESM::ESMWriter& writer) const
+    {
+        assert(mShared.size() >= mStatic.size());
+        for (auto it = mShared.begin(); it != mShared.begin() + mStatic.size(); ++it)
+        {
+            writer.startRecord(T::sRecordId);
+            if (mLazyLoader != nullptr)
+            {
+                // Don't keep the lazy data in memory only to write it
+                T record = **it;
+                mLazyLoader->load(record);
+                record.save(writer);
+            }
+            else
+                (*it)->save(writer);
+            writer.endRecord(T::sRecordId);
+        }
+    }
+    template<typename T>
     RecordId Store<T>::read(ESM::ESMReader& reader, bool overrideOnly)
     {
         T record;
@@ -5,11 +5,14 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <set>
 
 #include <components/esm/records.hpp>
 #include <components/misc/stringops.hpp>
+#include <components/to_utf8/to_utf8.hpp>
 
 #include "../mwdialogue/keywordsearch.hpp"
 
@@ -33,6 +36,30 @@ namespace MWWorld
         RecordId(const std::string &id = "", bool isDeleted = false);
     };
 
+    /// A record parsed by StoreBase::parse() which is not inserted into the store yet.
+    struct ParsedRecord
+    {
+        virtual ~ParsedRecord() = default;
+    };
+
+    /// Reads the parts of records which are left in the content files until the records are looked up, e.g. the
+    /// text of books. Lookups can happen on several threads, so the records are completed under a lock.
+    class LazyRecordLoader
+    {
+    public:
+        explicit LazyRecordLoader(const ToUTF8::Utf8Encoder* encoder);
+
+        template <class T>
+        void load(T& record) {}
+
+        void load(ESM::Book& record);
+
+    private:
+        std::mutex mMutex;
+        // The encoder of the content files is not thread safe, so keep a copy of it.
+        std::optional<ToUTF8::Utf8Encoder> mEncoder;
+    };
+
     class StoreBase
     {
     public:
@@ -47,6 +74,21 @@ namespace MWWorld
         virtual int getDynamicSize() const { return 0; }
         virtual RecordId load(ESM::ESMReader &esm) = 0;
 
+        /// Can records of this store be parsed independently of the load order with parse()?
+        virtual bool isParseable() const { return false; }
+
+        /// Parse the current record without modifying the store. Records parsed this way can be inserted later
+        /// with merge(), which allows parsing content files concurrently.
+        /// @note Thread safe. Only supported if isParseable() returns true.
+        virtual std::unique_ptr<ParsedRecord> parse(ESM::ESMReader &esm) const { return nullptr; }
+
+        /// Insert a record parsed by parse(), with the same result as loading it with load().
+        virtual RecordId merge(ParsedRecord &record) { return RecordId(); }
+
+        /// Write the static records in the order they were loaded, so that loading them gives the same store.
+        /// @note Only supported if isParseable() returns true.
+        virtual void writeStatic(ESM::ESMWriter& writer) const {}
+
         virtual bool eraseStatic(const std::string &id) {return false;}
         virtual void clearDynamic() {}
 
@@ -159,31 +201,39 @@ namespace MWWorld
         std::vector<T*> mShared;
         typedef std::unordered_map<std::string, T, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> Dynamic;
         Dynamic mDynamic;
+        std::shared_ptr<LazyRecordLoader> mLazyLoader;
 
         friend class ESMStore;
 
+        void loadRecord(T& record, ESM::ESMReader& esm, bool& isDeleted) const;
+        void loadLazyData(const T* record) const;
+
     public:
         Store();
         Store(const Store<T> &orig);
 
+        /// Leave parts of the records loaded afterwards in the content files until they are looked up with search()
+        /// or find(). Iterating the store gives records without these parts.
+        void setLazyLoader(std::shared_ptr<LazyRecordLoader> loader) { mLazyLoader = std::move(loader); }
+
         typedef SharedIterator<T> iterator;
 
         // setUp needs to be called again after
         void clearDynamic() override;
         void setUp() override;
 
-        const T *search(const std::string &id) const;
-        const T *searchStatic(const std::string &id) const;
+        const T *search(std::string_view id) const;
+        const T *searchStatic(std::string_view id) const;
 
         /**
          * Does the record with this ID come from the dynamic store?
          */
-        bool isDynamic(const std::string &id) const;
+        bool isDynamic(std::string_view id) const;
 
         /** Returns a random record that starts with the named ID, or nullptr if not found. */
         const T *searchRandom(const std::string &id) const;
 
-        const T *find(const std::string &id) const;
+        const T *find(std::string_view id) const;
 
         iterator begin() const;
         iterator end() const;
@@ -202,6 +252,10 @@ namespace MWWorld
         bool erase(const T &item);
 
         RecordId load(ESM::ESMReader &esm) override;
+        bool isParseable() const override { return true; }
+        std::unique_ptr<ParsedRecord> parse(ESM::ESMReader &esm) const override;
+        RecordId merge(ParsedRecord &record) override;
+        void writeStatic(ESM::ESMWriter& writer) const override;
         void write(ESM::ESMWriter& writer, Loading::Listener& progress) const override;
         RecordId read(ESM::ESMReader& reader, bool overrideOnly = false) override;
     };
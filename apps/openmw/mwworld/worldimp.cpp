@@ -10,6 +10,7 @@
 #include <MyGUI_TextIterator.h>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 
 #include <components/esm3/esmreader.hpp>
 #include <components/esm3/esmwriter.hpp>
@@ -25,6 +26,7 @@
 #include <components/files/collections.hpp>
 
 #include <components/resource/bulletshape.hpp>
+#include <components/resource/bulletshapemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
@@ -78,6 +80,7 @@
 
 #include "contentloader.hpp"
 #include "esmloader.hpp"
+#include "esmstoresnapshot.hpp"
 
 namespace MWWorld
 {
@@ -141,7 +144,7 @@ namespace MWWorld
         const std::vector<std::string>& groundcoverFiles,
         ToUTF8::Utf8Encoder* encoder, int activationDistanceOverride,
         const std::string& startCell, const std::string& startupScript,
-        const std::string& resourcePath, const std::string& userDataPath)
+        const std::string& resourcePath, const std::string& userDataPath, const std::string& cachePath)
     : mResourceSystem(resourceSystem), mLocalScripts (mStore),
       mCells (mStore, mEsm), mSky (true),
       mGodMode(false), mScriptsEnabled(true), mDiscardMovements(true), mContentFiles (contentFiles),
@@ -157,8 +160,11 @@ namespace MWWorld
         Loading::Listener* listener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         listener->loadingOn();
 
-        loadContentFiles(fileCollections, contentFiles, mStore, mEsm, encoder, listener);
-        loadGroundcoverFiles(fileCollections, groundcoverFiles, encoder);
+        {
+            const Debug::ScopedTrace trace("Load content files");
+            loadContentFiles(fileCollections, contentFiles, mStore, mEsm, encoder, listener);
+            loadGroundcoverFiles(fileCollections, groundcoverFiles, encoder);
+        }
 
         listener->loadingOff();
 
@@ -176,12 +182,20 @@ namespace MWWorld
 
         fillGlobalVariables();
 
-        mStore.setUp(true);
-        mStore.movePlayerRecord();
+        {
+            const Debug::ScopedTrace trace("MWWorld::ESMStore::setUp");
+            mStore.setUp(true);
+            mStore.movePlayerRecord();
+        }
 
         mSwimHeightScale = mStore.get<ESM::GameSetting>().find("fSwimHeightScale")->mValue.getFloat();
 
         mPhysics.reset(new MWPhysics::PhysicsSystem(resourceSystem, rootNode));
+        if (Settings::Manager::getBool("collision shape cache", "Models"))
+            mPhysics->getShapeManager()->setShapeCachePath(cachePath + "/shapes");
+        mPhysics->getShapeManager()->setCollisionSimplification(
+            Settings::Manager::getFloat("collision simplification error", "Models"),
+            Settings::Manager::getInt("collision simplification min triangles", "Models"));
 
         if (Settings::Manager::getBool("enable", "Navigator"))
         {
@@ -194,9 +208,15 @@ namespace MWWorld
             mNavigator = DetourNavigator::makeNavigatorStub();
         }
 
-        mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, *mNavigator, mGroundcoverStore));
+        {
+            const Debug::ScopedTrace trace("Create rendering manager");
+            mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, cachePath, *mNavigator, mGroundcoverStore));
+        }
         mProjectileManager.reset(new ProjectileManager(mRendering->getLightRoot(), resourceSystem, mRendering.get(), mPhysics.get()));
-        mRendering->preloadCommonAssets();
+        {
+            const Debug::ScopedTrace trace("Preload common assets");
+            mRendering->preloadCommonAssets();
+        }
 
         mWeatherManager.reset(new MWWorld::WeatherManager(*mRendering, mStore));
 
@@ -342,6 +362,8 @@ namespace MWWorld
         for (CellStore* cellstore : mWorldScene->getActiveCells())
         {
             MWBase::Environment::get().getWindowManager()->writeFog(cellstore);
+            // Objects of active cells are changed without going through the CellStore
+            cellstore->flagAsChanged();
         }
 
         MWMechanics::CreatureStats::writeActorIdCounter(writer);
@@ -400,6 +422,12 @@ namespace MWWorld
         }
     }
 
+    void World::readCellStates (const ESM::ESMReader& file, std::vector<std::vector<char>>& records,
+        const std::map<int, int>& contentFileMap)
+    {
+        mCells.readCellStates(file, records, contentFileMap);
+    }
+
     void World::validateMasterFiles(const std::vector<ESM::ESMReader>& readers)
     {
         for (const auto& esm : readers)
@@ -667,6 +695,11 @@ namespace MWWorld
         return mGlobalVariables.getType (name);
     }
 
+    const MWWorld::Globals& World::getGlobalVariables() const
+    {
+        return mGlobalVariables;
+    }
+
     std::string World::getMonthName (int month) const
     {
         return mCurrentDate->getMonthName(month);
@@ -762,6 +795,8 @@ namespace MWWorld
 
     Ptr World::searchPtrViaRefNum (const std::string& id, const ESM::RefNum& refNum)
     {
+        if (Ptr ptr = mWorldScene->searchPtrViaRefNum (refNum))
+            return ptr;
         return mCells.getPtr (id, refNum);
     }
 
@@ -1215,6 +1250,7 @@ namespace MWWorld
                     mRendering->updatePtr(ptr, newPtr);
                     MWBase::Environment::get().getSoundManager()->updatePtr (ptr, newPtr);
                     mPhysics->updatePtr(ptr, newPtr);
+                    mWorldScene->updatePtr(ptr, newPtr);
 
                     MWBase::MechanicsManager *mechMgr = MWBase::Environment::get().getMechanicsManager();
                     mechMgr->updateCell(ptr, newPtr);
@@ -1525,16 +1561,21 @@ namespace MWWorld
 
     void World::updateNavigator()
     {
+        // Submitted at once, so the navigator can skip the objects that barely moved and lock its tiles only once
+        std::vector<DetourNavigator::ObjectUpdate> updates;
+
         mPhysics->forEachAnimatedObject([&] (const auto& pair)
         {
             const auto [object, changed] = pair;
             if (changed)
-                updateNavigatorObject(*object);
+                updates.push_back(makeNavigatorObjectUpdate(*object));
         });
 
         for (const auto& door : mDoorStates)
             if (const auto object = mPhysics->getObject(door.first))
-                updateNavigatorObject(*object);
+                updates.push_back(makeNavigatorObjectUpdate(*object));
+
+        mShouldUpdateNavigator = mNavigator->updateObjects(updates) || mShouldUpdateNavigator;
 
         auto player = getPlayerPtr();
         if (mShouldUpdateNavigator && player.getCell() != nullptr)
@@ -1542,6 +1583,16 @@ namespace MWWorld
             mNavigator->update(player.getRefData().getPosition().asVec3());
             mShouldUpdateNavigator = false;
         }
+
+        mNavigator->updateDemand();
+    }
+
+    DetourNavigator::ObjectUpdate World::makeNavigatorObjectUpdate(const MWPhysics::Object& object) const
+    {
+        const MWWorld::Ptr ptr = object.getPtr();
+        const DetourNavigator::ObjectShapes shapes(object.getShapeInstance(),
+            DetourNavigator::ObjectTransform {ptr.getRefData().getPosition(), ptr.getCellRef().getScale()});
+        return DetourNavigator::ObjectUpdate {DetourNavigator::ObjectId(&object), shapes, object.getTransform()};
     }
 
     void World::updateNavigatorObject(const MWPhysics::Object& object)
@@ -1558,6 +1609,11 @@ namespace MWWorld
         return mPhysics.get();
     }
 
+    std::vector<MWPhysics::ExpensiveActor> World::getExpensivePhysicsActors(std::size_t count) const
+    {
+        return mPhysics->getMostExpensiveActors(count);
+    }
+
     bool World::castRay (float x1, float y1, float z1, float x2, float y2, float z2)
     {
         int mask = MWPhysics::CollisionType_World | MWPhysics::CollisionType_Door;
@@ -2965,6 +3021,44 @@ namespace MWWorld
         OMWScriptsLoader omwScriptsLoader(store);
         gameContentLoader.addLoader(".omwscripts", omwScriptsLoader);
 
+        const int numThreads = Settings::Manager::getInt("content loading threads", "General");
+        const bool useSnapshot = Settings::Manager::getBool("content snapshot", "General");
+
+        if (Settings::Manager::getBool("lazy record loading", "General"))
+            store.setLazyLoading(encoder);
+
+        std::vector<std::pair<boost::filesystem::path, int>> esmFiles;
+        if (numThreads > 1 || useSnapshot)
+        {
+            const std::set<std::string> esmExtensions {".esm", ".esp", ".omwgame", ".omwaddon", ".project"};
+            for (std::size_t i = 0; i < content.size(); ++i)
+            {
+                const boost::filesystem::path filename(content[i]);
+                if (esmExtensions.count(Misc::StringUtils::lowerCase(filename.extension().string())) == 0)
+                    continue;
+                const Files::MultiDirCollection& col = fileCollections.getCollection(filename.extension().string());
+                if (col.doesExist(content[i]))
+                    esmFiles.emplace_back(col.getPath(content[i]), static_cast<int>(i));
+            }
+        }
+
+        const boost::filesystem::path snapshotPath = boost::filesystem::path(mUserDataPath) / "esmstore.snapshot";
+        std::vector<ContentFileKey> contentFileKeys;
+        bool loadedSnapshot = false;
+        if (useSnapshot)
+        {
+            for (const auto& [path, index] : esmFiles)
+                contentFileKeys.push_back(makeContentFileKey(path, index));
+            if (std::optional<DeferredRuns> runs = readESMStoreSnapshot(snapshotPath, contentFileKeys, encoder, store, listener))
+            {
+                esmLoader.setSnapshotRuns(std::move(*runs));
+                loadedSnapshot = true;
+            }
+        }
+
+        if (!loadedSnapshot && (numThreads > 1 || useSnapshot))
+            esmLoader.preload(esmFiles, static_cast<std::size_t>(std::max(numThreads, 1)));
+
         int idx = 0;
         for (const std::string &file : content)
         {
@@ -2981,6 +3075,9 @@ namespace MWWorld
             }
             idx++;
         }
+
+        if (useSnapshot && !loadedSnapshot)
+            writeESMStoreSnapshot(snapshotPath, contentFileKeys, encoder, esmLoader.getDeferredRuns(), store);
     }
 
     void World::loadGroundcoverFiles(const Files::Collections& fileCollections, const std::vector<std::string>& groundcoverFiles, ToUTF8::Utf8Encoder* encoder)
@@ -3678,6 +3775,11 @@ namespace MWWorld
         return mRendering->getTerrainHeightAt(worldPos);
     }
 
+    void World::getTerrainHeightsAt(const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights) const
+    {
+        mRendering->getTerrainHeightsAt(worldPositions, heights);
+    }
+
     osg::Vec3f World::getHalfExtents(const ConstPtr& object, bool rendering) const
     {
         if (!object.getClass().isActor())
@@ -3702,6 +3804,13 @@ namespace MWWorld
         return file;
     }
 
+    std::string World::writeFrameTrace() const
+    {
+        std::string file = mUserDataPath + "/frametrace.json";
+        Debug::Tracer::instance().write(file);
+        return file;
+    }
+
     void World::spawnRandomCreature(const std::string &creatureList)
     {
         const ESM::CreatureLevList* list = mStore.get<ESM::CreatureLevList>().find(creatureList);
@@ -3987,6 +4096,7 @@ namespace MWWorld
     {
         mNavigator->reportStats(frameNumber, stats);
         mPhysics->reportStats(frameNumber, stats);
+        mWorldScene->reportStats(frameNumber, stats);
     }
 
     void World::updateSkyDate()
@@ -43,6 +43,11 @@ namespace ESM
     struct Position;
 }
 
+namespace DetourNavigator
+{
+    struct ObjectUpdate;
+}
+
 namespace Files
 {
     class Collections;
@@ -158,6 +163,8 @@ namespace MWWorld
 
             void updateNavigatorObject(const MWPhysics::Object& object);
 
+            DetourNavigator::ObjectUpdate makeNavigatorObjectUpdate(const MWPhysics::Object& object) const;
+
             void ensureNeededRecords();
             void validateMasterFiles(const std::vector<ESM::ESMReader>& readers);
 
@@ -189,7 +196,7 @@ namespace MWWorld
                 const std::vector<std::string>& groundcoverFiles,
                 ToUTF8::Utf8Encoder* encoder, int activationDistanceOverride,
                 const std::string& startCell, const std::string& startupScript,
-                const std::string& resourcePath, const std::string& userDataPath);
+                const std::string& resourcePath, const std::string& userDataPath, const std::string& cachePath);
 
             virtual ~World();
 
@@ -206,6 +213,9 @@ namespace MWWorld
             void readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap) override;
 
+            void readCellStates (const ESM::ESMReader& file, std::vector<std::vector<char>>& records,
+                const std::map<int, int>& contentFileMap) override;
+
             CellStore *getExterior (int x, int y) override;
 
             CellStore *getInterior (const std::string& name) override;
@@ -268,6 +278,8 @@ namespace MWWorld
             char getGlobalVariableType (const std::string& name) const override;
             ///< Return ' ', if there is no global variable with this name.
 
+            const MWWorld::Globals& getGlobalVariables() const override;
+
             std::string getCellName (const MWWorld::CellStore *cell = nullptr) const override;
             ///< Return name of the cell.
             ///
@@ -409,6 +421,8 @@ namespace MWWorld
 
             const MWPhysics::RayCastingInterface* getRayCasting() const override;
 
+            std::vector<MWPhysics::ExpensiveActor> getExpensivePhysicsActors(std::size_t count) const override;
+
             bool castRay (float x1, float y1, float z1, float x2, float y2, float z2, int mask) override;
             ///< cast a Ray and return true if there is an object in the ray path.
 
@@ -706,6 +720,8 @@ namespace MWWorld
             /// Return terrain height at \a worldPos position.
             float getTerrainHeightAt(const osg::Vec3f& worldPos) const override;
 
+            void getTerrainHeightsAt(const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights) const override;
+
             /// Return physical or rendering half extents of the given actor.
             osg::Vec3f getHalfExtents(const MWWorld::ConstPtr& actor, bool rendering=false) const override;
 
@@ -713,6 +729,8 @@ namespace MWWorld
             /// \param ptr object to export scene graph for (if empty, export entire scene graph)
             std::string exportSceneGraph(const MWWorld::Ptr& ptr) override;
 
+            std::string writeFrameTrace() const override;
+
             /// Preload VFX associated with this effect list
             void preloadEffects(const ESM::EffectList* effectList) override;
 
@@ -105,6 +105,33 @@ namespace OpenMW
             ("random-seed", bpo::value <unsigned int> ()
                 ->default_value(Misc::Rng::generateDefaultSeed()),
                 "seed value for random number generator")
+
+            ("trace-file", bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), ""),
+                "record the durations of loading phases and write them to the given file on exit "
+                "(Chrome trace event format, open it with chrome://tracing or https://ui.perfetto.dev)")
+
+            ("record-path", bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), ""),
+                "write the position of the player in each frame of the running game to the given file, to be followed with --benchmark")
+
+            ("benchmark", bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), ""),
+                "move the player along the path in the given file once the game runs, write the timings of the frames "
+                "to benchmark.csv in the user data directory and quit, use with --load-savegame or --skip-menu and --start")
+
+            ("benchmark-fps", bpo::value<unsigned int>()->default_value(60),
+                "number of simulation steps per second of the path followed by --benchmark, independent of the real frame rate")
+
+            ("headless", bpo::value<bool>()->implicit_value(true)
+                ->default_value(false), "run the game without showing the window, playing sounds, reading the controls or "
+                "rendering, log the throughput in simulated seconds per second, use with --load-savegame or --skip-menu")
+
+            ("headless-tick-rate", bpo::value<unsigned int>()->default_value(60),
+                "number of simulation steps per simulated second of a --headless run")
+
+            ("headless-duration", bpo::value<double>()->default_value(0),
+                "simulated seconds to run with --headless before quitting, 0 to run until the game quits")
+
+            ("headless-realtime", bpo::value<bool>()->implicit_value(true)
+                ->default_value(false), "keep a --headless run in step with the wall clock instead of running at full speed")
         ;
 
         return desc;
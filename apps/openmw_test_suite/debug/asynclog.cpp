@@ -0,0 +1,92 @@
+#include <components/debug/asynclog.hpp>
+#include <components/debug/debuglog.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace Debug;
+
+    struct DebugAsyncLogTest : ::testing::Test
+    {
+        std::ostringstream mOutput;
+        std::streambuf* const mCoutBuffer = std::cout.rdbuf(mOutput.rdbuf());
+
+        ~DebugAsyncLogTest()
+        {
+            std::cout.rdbuf(mCoutBuffer);
+        }
+
+        std::vector<std::string> getLines() const
+        {
+            std::vector<std::string> result;
+            std::istringstream stream(mOutput.str());
+            for (std::string line; std::getline(stream, line);)
+                result.push_back(line);
+            return result;
+        }
+    };
+
+    TEST_F(DebugAsyncLogTest, shouldWriteSynchronouslyWithoutAsyncLog)
+    {
+        Log(Debug::Error) << "message " << 42;
+        EXPECT_EQ(mOutput.str(), "message 42\n");
+    }
+
+    TEST_F(DebugAsyncLogTest, shouldWriteAllMessagesInOrderOfEachThread)
+    {
+        constexpr int threads = 4;
+        constexpr int messages = 100;
+        {
+            const AsyncLog asyncLog(threads * messages);
+            std::vector<std::thread> producers;
+            for (int thread = 0; thread < threads; ++thread)
+                producers.emplace_back([thread] {
+                    for (int i = 0; i < messages; ++i)
+                        Log(Debug::Error) << thread << ' ' << i;
+                });
+            for (std::thread& producer : producers)
+                producer.join();
+        }
+        std::vector<int> next(threads, 0);
+        for (const std::string& line : getLines())
+        {
+            std::istringstream stream(line);
+            int thread = 0;
+            int i = 0;
+            stream >> thread >> i;
+            ASSERT_FALSE(stream.fail()) << line;
+            EXPECT_EQ(i, next[thread]);
+            next[thread] = i + 1;
+        }
+        EXPECT_EQ(next, std::vector<int>(threads, messages));
+    }
+
+    TEST_F(DebugAsyncLogTest, shouldReportDroppedMessages)
+    {
+        constexpr int messages = 10000;
+        std::size_t dropped = 0;
+        {
+            const AsyncLog asyncLog(2);
+            for (int i = 0; i < messages; ++i)
+                Log(Debug::Error) << "message";
+            dropped = getDroppedLogMessages();
+        }
+        std::size_t written = 0;
+        std::size_t reported = 0;
+        for (const std::string& line : getLines())
+        {
+            if (line == "message")
+                ++written;
+            else
+                reported += std::stoul(line);
+        }
+        EXPECT_EQ(written + reported, static_cast<std::size_t>(messages));
+        EXPECT_GE(reported, dropped);
+    }
+}
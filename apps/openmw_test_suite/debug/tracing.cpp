@@ -0,0 +1,56 @@
+#include <components/debug/tracing.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    using namespace Debug;
+
+    TEST(DebugTracerTest, shouldWriteNestedEventsInChromeTraceFormat)
+    {
+        Tracer& tracer = Tracer::instance();
+        tracer.enable();
+        {
+            const ScopedTrace outer("outer");
+            const ScopedTrace inner("inner \"quoted\"");
+        }
+        std::thread([&] {
+            tracer.setThreadName("worker");
+            const ScopedTrace trace("on worker");
+        }).join();
+
+        std::ostringstream stream;
+        tracer.write(stream);
+        const std::string trace = stream.str();
+        EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+        EXPECT_NE(trace.find("{\"name\":\"outer\",\"ph\":\"X\",\"pid\":1,\"tid\":"), std::string::npos);
+        EXPECT_NE(trace.find("{\"name\":\"inner \\\"quoted\\\"\",\"ph\":\"X\""), std::string::npos);
+        EXPECT_NE(trace.find("{\"name\":\"on worker\",\"ph\":\"X\""), std::string::npos);
+        EXPECT_NE(trace.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"), std::string::npos);
+        EXPECT_NE(trace.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+        EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    }
+
+    TEST(DebugTracerTest, shouldKeepOnlyEventsOfLastFrames)
+    {
+        Tracer& tracer = Tracer::instance();
+        tracer.enable();
+        tracer.setMaxFrames(2);
+        for (const char* name : {"first frame", "second frame", "third frame"})
+        {
+            tracer.beginFrame();
+            const ScopedTrace trace(name);
+        }
+        tracer.setMaxFrames(0);
+
+        std::ostringstream stream;
+        tracer.write(stream);
+        const std::string trace = stream.str();
+        EXPECT_EQ(trace.find("\"first frame\""), std::string::npos);
+        EXPECT_NE(trace.find("\"second frame\""), std::string::npos);
+        EXPECT_NE(trace.find("\"third frame\""), std::string::npos);
+    }
+}
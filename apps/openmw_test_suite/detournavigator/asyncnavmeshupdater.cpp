@@ -79,6 +79,25 @@ namespace
         EXPECT_NE(navMeshCacheItem->lockConst()->getImpl().getTileRefAt(0, 0, 0), 0);
     }
 
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, post_for_evicted_tile_should_remove_it_from_navmesh)
+    {
+        mRecastMeshManager.setWorldspace(mWorldspace);
+        addHeightFieldPlane(mRecastMeshManager);
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, nullptr);
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(makeEmptyNavMesh(mSettings), 1);
+        const std::map<TilePosition, ChangeType> changedTiles {{TilePosition {0, 0}, ChangeType::add}};
+        updater.post(mAgentHalfExtents, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(mListener, WaitConditionType::allJobsDone);
+        ASSERT_EQ(navMeshCacheItem->lockConst()->getUsedTilesCount(), 1);
+        ASSERT_GT(navMeshCacheItem->lockConst()->getUsedTilesSize(), 0);
+        updater.setEvictedTiles(mAgentHalfExtents, {TilePosition {0, 0}});
+        updater.post(mAgentHalfExtents, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(mListener, WaitConditionType::allJobsDone);
+        EXPECT_EQ(navMeshCacheItem->lockConst()->getImpl().getTileRefAt(0, 0, 0), 0);
+        EXPECT_EQ(navMeshCacheItem->lockConst()->getUsedTilesCount(), 0);
+        EXPECT_EQ(navMeshCacheItem->lockConst()->getUsedTilesSize(), 0);
+    }
+
     TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, repeated_post_should_lead_to_cache_hit)
     {
         mRecastMeshManager.setWorldspace(mWorldspace);
@@ -239,4 +258,25 @@ namespace
         updater.wait(mListener, WaitConditionType::allJobsDone);
         EXPECT_EQ(navMeshCacheItem->lockConst()->getImpl().getTileRefAt(0, 0, 0), 0);
     }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, set_demanded_tiles_should_mark_waiting_jobs_for_these_tiles)
+    {
+        mSettings.mAsyncNavMeshUpdaterThreads = 0;
+        mRecastMeshManager.setWorldspace(mWorldspace);
+        addHeightFieldPlane(mRecastMeshManager);
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, nullptr);
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(makeEmptyNavMesh(mSettings), 1);
+        const std::map<TilePosition, ChangeType> changedTiles {
+            {TilePosition {0, 0}, ChangeType::add},
+            {TilePosition {1, 0}, ChangeType::add},
+        };
+        updater.post(mAgentHalfExtents, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        EXPECT_EQ(updater.getStats().mDemanded, 0);
+        updater.setDemandedTiles(mAgentHalfExtents, {TilePosition {1, 0}});
+        const auto stats = updater.getStats();
+        EXPECT_EQ(stats.mWaiting, 2);
+        EXPECT_EQ(stats.mDemanded, 1);
+        updater.setDemandedTiles(mAgentHalfExtents, {});
+        EXPECT_EQ(updater.getStats().mDemanded, 0);
+    }
 }
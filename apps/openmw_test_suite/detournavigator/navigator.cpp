@@ -1006,6 +1006,42 @@ namespace
         ASSERT_EQ(navMeshes.begin()->second->lockConst()->getVersion(), expectedVersion);
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, update_objects_should_skip_object_moved_less_than_cell_size)
+    {
+        CollisionShapeInstance box(std::make_unique<btBoxShape>(btVector3(20, 20, 20)));
+        const ObjectId id(&box.shape());
+        const ObjectShapes shapes(box.instance(), mObjectTransform);
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addObject(id, shapes, mTransform);
+
+        const btTransform nearTransform(btMatrix3x3::getIdentity(), mTransform.getOrigin() + btVector3(1, 0, 0));
+        EXPECT_FALSE(mNavigator->updateObjects({ObjectUpdate {id, shapes, nearTransform}}));
+
+        const btTransform farTransform(btMatrix3x3::getIdentity(), mTransform.getOrigin() + btVector3(100, 0, 0));
+        EXPECT_TRUE(mNavigator->updateObjects({ObjectUpdate {id, shapes, farTransform}}));
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, update_should_keep_only_tiles_within_resident_tiles_radius)
+    {
+        const HeightfieldPlane plane {100};
+        const int cellSize = ESM::Land::REAL_SIZE;
+
+        mSettings.mResidentTilesRadius = 1;
+        mNavigator.reset(new NavigatorImpl(mSettings, std::make_unique<NavMeshDb>(":memory:")));
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addHeightfield(mCellPosition, cellSize, plane);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        const auto navMesh = mNavigator->getNavMesh(mAgentHalfExtents);
+        ASSERT_NE(navMesh, nullptr);
+        const std::size_t usedTiles = navMesh->lockConst()->getUsedTilesCount();
+        EXPECT_GT(usedTiles, 0);
+        EXPECT_LE(usedTiles, 5);
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, should_provide_path_over_flat_heightfield)
     {
         const HeightfieldPlane plane {100};
@@ -1144,4 +1180,53 @@ namespace
         EXPECT_TRUE(mNavigator->addWater(mCellPosition, cellSize1, level1));
         EXPECT_FALSE(mNavigator->addWater(mCellPosition, cellSize2, level2));
     }
+
+    TEST_F(DetourNavigatorNavigatorTest, find_path_with_path_cache_should_reuse_path_until_tile_is_changed)
+    {
+        const std::array<float, 5 * 5> heightfieldData {{
+            0,   0,    0,    0,    0,
+            0, -25,  -25,  -25,  -25,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+        }};
+        const HeightfieldSurface surface = makeSquareHeightfieldSurface(heightfieldData);
+        const int cellSize = mHeightfieldTileSize * (surface.mSize - 1);
+
+        CollisionShapeInstance compound(std::make_unique<btCompoundShape>());
+        compound.shape().addChildShape(btTransform(btMatrix3x3::getIdentity(), btVector3(0, 0, 0)), new btBoxShape(btVector3(20, 20, 100)));
+
+        mSettings.mEnablePathCache = true;
+        mSettings.mMaxPathCacheSize = 16;
+        mSettings.mPathCachePositionQuantum = 32;
+        mNavigator.reset(new NavigatorImpl(mSettings, std::make_unique<NavMeshDb>(":memory:")));
+        ASSERT_NE(mNavigator->getPathCache(), nullptr);
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addHeightfield(mCellPosition, cellSize, surface);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        ASSERT_EQ(findPath(*mNavigator, mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
+                  Status::Success);
+        const std::deque<osg::Vec3f> path = mPath;
+        ASSERT_FALSE(path.empty());
+
+        mPath.clear();
+        mOut = std::back_inserter(mPath);
+        const osg::Vec3f closeStart = mStart + osg::Vec3f(1, 1, 0);
+        EXPECT_EQ(findPath(*mNavigator, mAgentHalfExtents, mStepSize, closeStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
+                  Status::Success);
+        EXPECT_EQ(mPath, path);
+
+        mNavigator->addObject(ObjectId(&compound.shape()), ObjectShapes(compound.instance(), mObjectTransform), mTransform);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        mPath.clear();
+        mOut = std::back_inserter(mPath);
+        EXPECT_EQ(findPath(*mNavigator, mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mEndTolerance, mOut),
+                  Status::Success);
+        EXPECT_NE(mPath, path);
+    }
 }
@@ -109,4 +109,69 @@ namespace
         EXPECT_THROW(mDb.insertTile(tileId, worldspace, tilePosition, version, input, data), std::runtime_error);
         EXPECT_NO_THROW(insertTile(TileId {54}, version));
     }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tiles_should_return_tiles_after_given_id_ordered_by_id)
+    {
+        const TileVersion version {1};
+        const Tile first = insertTile(TileId {7}, version);
+        const Tile second = insertTile(TileId {3}, version);
+        const std::vector<DbTile> tiles = mDb.getTiles(TileId {0}, 1);
+        ASSERT_EQ(tiles.size(), 1);
+        EXPECT_EQ(tiles[0].mTileId, TileId {3});
+        EXPECT_EQ(tiles[0].mWorldspace, second.mWorldspace);
+        EXPECT_EQ(tiles[0].mTilePosition, second.mTilePosition);
+        EXPECT_EQ(tiles[0].mVersion, version);
+        EXPECT_EQ(tiles[0].mInput, second.mInput);
+        EXPECT_EQ(tiles[0].mData, second.mData);
+        const std::vector<DbTile> next = mDb.getTiles(TileId {3}, 10);
+        ASSERT_EQ(next.size(), 1);
+        EXPECT_EQ(next[0].mTileId, TileId {7});
+        EXPECT_EQ(next[0].mInput, first.mInput);
+        EXPECT_TRUE(mDb.getTiles(TileId {7}, 10).empty());
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_shapes_should_return_inserted_shapes)
+    {
+        const std::string name = "test1";
+        const std::vector<std::byte> hash = generateData();
+        const Sqlite3::ConstBlob blob {reinterpret_cast<const char*>(hash.data()), static_cast<int>(hash.size())};
+        ASSERT_EQ(mDb.insertShape(ShapeId {42}, name, ShapeType::Avoid, blob), 1);
+        const std::vector<DbShape> shapes = mDb.getShapes();
+        ASSERT_EQ(shapes.size(), 1);
+        EXPECT_EQ(shapes[0].mShapeId, ShapeId {42});
+        EXPECT_EQ(shapes[0].mName, name);
+        EXPECT_EQ(shapes[0].mType, ShapeType::Avoid);
+        EXPECT_EQ(shapes[0].mHash, hash);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tile_portals_should_return_last_inserted_portals_for_worldspace_tiles)
+    {
+        const Tile tile = insertTile(TileId {5}, TileVersion {1});
+        ASSERT_EQ(mDb.insertTilePortals(TileId {5}, 3), 1);
+        ASSERT_EQ(mDb.insertTilePortals(TileId {5}, 12), 1);
+        const std::vector<DbTilePortals> portals = mDb.getTilePortals(tile.mWorldspace);
+        ASSERT_EQ(portals.size(), 1);
+        EXPECT_EQ(portals[0].mTilePosition, tile.mTilePosition);
+        EXPECT_EQ(portals[0].mPortals, 12);
+        EXPECT_TRUE(mDb.getTilePortals("other").empty());
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, tiles_compressed_with_previous_dictionary_should_stay_readable)
+    {
+        EXPECT_EQ(mDb.getTileDataDictionary(), nullptr);
+        const Tile first = insertTile(TileId {1}, TileVersion {1});
+        const std::int64_t firstDictionaryId = mDb.insertTileDataDictionary(generateData());
+        const Tile second = insertTile(TileId {2}, TileVersion {1});
+        const std::int64_t secondDictionaryId = mDb.insertTileDataDictionary(generateData());
+        EXPECT_EQ(firstDictionaryId, 1);
+        EXPECT_EQ(secondDictionaryId, 2);
+        ASSERT_NE(mDb.getTileDataDictionary(), nullptr);
+        EXPECT_EQ(mDb.getTileDataDictionary()->mId, secondDictionaryId);
+        const Tile third = insertTile(TileId {3}, TileVersion {1});
+        const std::vector<DbTile> tiles = mDb.getTiles(TileId {0}, 10);
+        ASSERT_EQ(tiles.size(), 3);
+        EXPECT_EQ(tiles[0].mData, first.mData);
+        EXPECT_EQ(tiles[1].mData, second.mData);
+        EXPECT_EQ(tiles[2].mData, third.mData);
+    }
 }
@@ -380,4 +380,41 @@ namespace
         EXPECT_FALSE(cache.set(mAgentHalfExtents, mTilePosition, anotherRecastMesh, std::move(anotherData)));
         EXPECT_TRUE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh));
     }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_with_multiple_shards_should_return_value_set_for_the_same_key)
+    {
+        const std::size_t maxSize = 8 * (mRecastMeshWithWaterSize + mPreparedNavMeshDataSize);
+        NavMeshTilesCache cache(maxSize, 4);
+        const TilePosition anotherTilePosition(1, 1);
+        auto anotherData = makePeparedNavMeshData(3);
+        const auto copy = clone(*mPreparedNavMeshData);
+        const auto anotherCopy = clone(*anotherData);
+
+        ASSERT_TRUE(cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData)));
+        ASSERT_TRUE(cache.set(mAgentHalfExtents, anotherTilePosition, mRecastMesh, std::move(anotherData)));
+
+        const auto value = cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh);
+        ASSERT_TRUE(value);
+        EXPECT_EQ(value.get(), *copy);
+        const auto anotherValue = cache.get(mAgentHalfExtents, anotherTilePosition, mRecastMesh);
+        ASSERT_TRUE(anotherValue);
+        EXPECT_EQ(anotherValue.get(), *anotherCopy);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_stats_should_count_hits_over_all_shards)
+    {
+        const std::size_t maxSize = 4 * (mRecastMeshWithWaterSize + mPreparedNavMeshDataSize);
+        NavMeshTilesCache cache(maxSize, 4);
+        const TilePosition anotherTilePosition(1, 1);
+
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        EXPECT_TRUE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh));
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, anotherTilePosition, mRecastMesh));
+
+        const NavMeshTilesCache::Stats stats = cache.getStats();
+        EXPECT_EQ(stats.mGetCount, 2);
+        EXPECT_EQ(stats.mHitCount, 1);
+        EXPECT_EQ(stats.mCachedNavMeshTiles, 1);
+        EXPECT_EQ(stats.mUsedNavMeshTiles, 0);
+    }
 }
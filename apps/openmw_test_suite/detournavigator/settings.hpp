@@ -42,6 +42,7 @@ namespace DetourNavigator
             result.mMaxTilesNumber = 512;
             result.mMinUpdateInterval = std::chrono::milliseconds(50);
             result.mWriteToNavMeshDb = true;
+            result.mNavMeshDbWritesPerTransaction = 100;
             return result;
         }
     }
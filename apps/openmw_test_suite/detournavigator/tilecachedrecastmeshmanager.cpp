@@ -127,6 +127,43 @@ namespace
         ));
     }
 
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, update_objects_should_return_changed_objects)
+    {
+        TileCachedRecastMeshManager manager(mSettings);
+        const btBoxShape boxShape(btVector3(20, 20, 100));
+        const btBoxShape otherBoxShape(btVector3(20, 20, 100));
+        const btTransform transform(btMatrix3x3::getIdentity(), btVector3(getTileSize(mSettings) / mSettings.mRecastScaleFactor, 0, 0));
+        const CollisionShape shape(mInstance, boxShape, mObjectTransform);
+        const CollisionShape otherShape(mInstance, otherBoxShape, mObjectTransform);
+        manager.addObject(ObjectId(&boxShape), shape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto) {});
+        manager.addObject(ObjectId(&otherBoxShape), otherShape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto) {});
+        const std::vector<RecastMeshObjectUpdate> updates {
+            RecastMeshObjectUpdate {ObjectId(&boxShape), shape, transform, AreaType::AreaType_ground},
+            RecastMeshObjectUpdate {ObjectId(&otherBoxShape), otherShape, btTransform::getIdentity(), AreaType::AreaType_ground},
+        };
+        EXPECT_THAT(manager.updateObjects(updates, [] (auto, auto) {}), ElementsAre(true, false));
+    }
+
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_object_transform_for_changed_object_should_return_new_transform)
+    {
+        TileCachedRecastMeshManager manager(mSettings);
+        const btBoxShape boxShape(btVector3(20, 20, 100));
+        const btTransform transform(btMatrix3x3::getIdentity(), btVector3(getTileSize(mSettings) / mSettings.mRecastScaleFactor, 0, 0));
+        const CollisionShape shape(mInstance, boxShape, mObjectTransform);
+        manager.addObject(ObjectId(&boxShape), shape, btTransform::getIdentity(), AreaType::AreaType_ground, [] (auto) {});
+        manager.updateObject(ObjectId(&boxShape), shape, transform, AreaType::AreaType_ground, [] (auto, auto) {});
+        const btTransform* const result = manager.getObjectTransform(ObjectId(&boxShape));
+        ASSERT_NE(result, nullptr);
+        EXPECT_EQ(*result, transform);
+    }
+
+    TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, get_object_transform_for_absent_object_should_return_nullptr)
+    {
+        const TileCachedRecastMeshManager manager(mSettings);
+        const btBoxShape boxShape(btVector3(20, 20, 100));
+        EXPECT_EQ(manager.getObjectTransform(ObjectId(&boxShape)), nullptr);
+    }
+
     TEST_F(DetourNavigatorTileCachedRecastMeshManagerTest, update_object_for_not_changed_object_should_return_empty)
     {
         TileCachedRecastMeshManager manager(mSettings);
@@ -0,0 +1,46 @@
+#include <components/detournavigator/tilegraph.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    constexpr TilePortals allPortals = TilePortal_xMin | TilePortal_yMax | TilePortal_xMax | TilePortal_yMin;
+
+    TEST(DetourNavigatorTileGraphTest, find_path_for_unknown_tile_should_return_empty)
+    {
+        TileGraph graph;
+        graph.add(TilePosition(0, 0), allPortals);
+        EXPECT_THAT(graph.findPath(TilePosition(0, 0), TilePosition(1, 0), 100), IsEmpty());
+    }
+
+    TEST(DetourNavigatorTileGraphTest, find_path_for_same_start_and_end_should_return_this_tile)
+    {
+        TileGraph graph;
+        graph.add(TilePosition(0, 0), TilePortal_none);
+        EXPECT_THAT(graph.findPath(TilePosition(0, 0), TilePosition(0, 0), 100), ElementsAre(TilePosition(0, 0)));
+    }
+
+    TEST(DetourNavigatorTileGraphTest, find_path_should_use_only_sides_with_portals_on_both_tiles)
+    {
+        TileGraph graph;
+        graph.add(TilePosition(0, 0), TilePortal_xMax | TilePortal_yMax);
+        graph.add(TilePosition(1, 0), TilePortal_yMax);
+        graph.add(TilePosition(0, 1), TilePortal_yMin | TilePortal_xMax);
+        graph.add(TilePosition(1, 1), TilePortal_xMin | TilePortal_yMin);
+        EXPECT_THAT(graph.findPath(TilePosition(0, 0), TilePosition(1, 0), 100),
+                    ElementsAre(TilePosition(0, 0), TilePosition(0, 1), TilePosition(1, 1), TilePosition(1, 0)));
+    }
+
+    TEST(DetourNavigatorTileGraphTest, find_path_should_return_empty_when_max_nodes_is_reached)
+    {
+        TileGraph graph;
+        for (int x = 0; x < 10; ++x)
+            graph.add(TilePosition(x, 0), allPortals);
+        EXPECT_THAT(graph.findPath(TilePosition(0, 0), TilePosition(9, 0), 5), IsEmpty());
+        EXPECT_EQ(graph.findPath(TilePosition(0, 0), TilePosition(9, 0), 10).size(), 10);
+    }
+}
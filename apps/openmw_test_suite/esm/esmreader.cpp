@@ -0,0 +1,101 @@
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+
+    struct ESMReaderTest : Test
+    {
+        std::shared_ptr<std::stringstream> mStream = std::make_shared<std::stringstream>();
+        ESM::ESMReader mReader;
+
+        ESMReaderTest()
+        {
+            ESM::ESMWriter writer;
+            writer.setFormat(0);
+            writer.save(*mStream);
+            writer.startRecord("TEST");
+            writer.writeHNString("NAME", "first");
+            writer.writeHNT("DATA", 42);
+            writer.writeHNString("TEXT", "text");
+            writer.endRecord("TEST");
+            writer.startRecord("TEST");
+            writer.writeHNString("NAME", "second");
+            writer.endRecord("TEST");
+            mReader.open(mStream, "test");
+        }
+    };
+
+    TEST_F(ESMReaderTest, should_read_subrecords_of_consecutive_records)
+    {
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        EXPECT_EQ(mReader.getHNString("NAME"), "first");
+        int data = 0;
+        mReader.getHNT(data, "DATA");
+        EXPECT_EQ(data, 42);
+        EXPECT_EQ(mReader.getHNString("TEXT"), "text");
+        EXPECT_FALSE(mReader.hasMoreSubs());
+
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        EXPECT_EQ(mReader.getHNString("NAME"), "second");
+        EXPECT_FALSE(mReader.hasMoreRecs());
+    }
+
+    TEST_F(ESMReaderTest, get_file_offset_should_match_stream_position_after_skipped_record)
+    {
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        mReader.skipRecord();
+        const std::size_t offset = mReader.getFileOffset();
+        EXPECT_EQ(offset, static_cast<std::size_t>(mStream->tellg()));
+    }
+
+    TEST_F(ESMReaderTest, restore_context_should_continue_in_the_middle_of_a_record)
+    {
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        EXPECT_EQ(mReader.getHNString("NAME"), "first");
+        const ESM::ESM_Context context = mReader.getContext();
+        mReader.skipRecord();
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        mReader.skipRecord();
+
+        mReader.restoreContext(context);
+        int data = 0;
+        mReader.getHNT(data, "DATA");
+        EXPECT_EQ(data, 42);
+        mReader.getSubNameIs("TEXT");
+        EXPECT_EQ(mReader.getHStringView(), "text");
+        EXPECT_FALSE(mReader.hasMoreSubs());
+    }
+
+    TEST_F(ESMReaderTest, open_record_should_read_data_taken_with_get_record_data)
+    {
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        EXPECT_EQ(mReader.getHNString("NAME"), "first");
+        std::vector<char> data;
+        mReader.getRecordData(data);
+
+        ASSERT_EQ(mReader.getRecName(), "TEST");
+        mReader.getRecHeader();
+        EXPECT_EQ(mReader.getHNString("NAME"), "second");
+
+        ESM::ESMReader recordReader;
+        recordReader.openRecord(std::move(data), mReader);
+        int value = 0;
+        recordReader.getHNT(value, "DATA");
+        EXPECT_EQ(value, 42);
+        EXPECT_EQ(recordReader.getHNString("TEXT"), "text");
+        EXPECT_FALSE(recordReader.hasMoreSubs());
+        EXPECT_FALSE(recordReader.hasMoreRecs());
+    }
+}
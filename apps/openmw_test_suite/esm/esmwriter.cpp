@@ -0,0 +1,57 @@
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+
+    TEST(ESMWriterTest, should_write_record_to_stream_when_it_is_complete)
+    {
+        const auto stream = std::make_shared<std::stringstream>();
+        ESM::ESMWriter writer;
+        writer.setFormat(0);
+        writer.save(*stream);
+        const std::string header = stream->str();
+
+        writer.startRecord("TEST");
+        writer.writeHNString("NAME", "name");
+        EXPECT_EQ(stream->str(), header);
+        writer.endRecord("TEST");
+        EXPECT_GT(stream->str().size(), header.size());
+    }
+
+    TEST(ESMWriterTest, should_write_sizes_of_nested_sub_records)
+    {
+        const auto stream = std::make_shared<std::stringstream>();
+        ESM::ESMWriter writer;
+        writer.setFormat(0);
+        writer.save(*stream);
+        writer.startRecord("TEST");
+        writer.startSubRecord("DATA");
+        writer.writeT(42);
+        writer.writeT(13);
+        writer.endRecord("DATA");
+        writer.writeHNString("NAME", "name");
+        writer.endRecord("TEST");
+        writer.close();
+
+        ESM::ESMReader reader;
+        reader.open(stream, "test");
+        ASSERT_EQ(reader.getRecName(), "TEST");
+        reader.getRecHeader();
+        reader.getSubNameIs("DATA");
+        reader.getSubHeader();
+        EXPECT_EQ(reader.getSubSize(), 2 * sizeof(int));
+        int values[2] = {0, 0};
+        reader.getExact(values, sizeof(values));
+        EXPECT_EQ(values[0], 42);
+        EXPECT_EQ(values[1], 13);
+        EXPECT_EQ(reader.getHNString("NAME"), "name");
+        EXPECT_FALSE(reader.hasMoreSubs());
+        EXPECT_FALSE(reader.hasMoreRecs());
+    }
+}
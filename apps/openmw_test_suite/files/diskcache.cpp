@@ -0,0 +1,118 @@
+#include <components/files/diskcache.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    using namespace testing;
+    using namespace Files;
+
+    struct FilesDiskCacheTest : Test
+    {
+        const std::filesystem::path mRoot = std::filesystem::temp_directory_path()
+            / (std::string("openmw-disk-cache-test-") + UnitTest::GetInstance()->current_test_info()->name());
+        const DiskCache::Key mKey = DiskCache::makeKey("key");
+        const DiskCache::Key mOtherKey = DiskCache::makeKey("other key");
+
+        FilesDiskCacheTest()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(mRoot, error);
+        }
+
+        ~FilesDiskCacheTest()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(mRoot, error);
+        }
+    };
+
+    TEST_F(FilesDiskCacheTest, read_should_miss_for_unknown_namespace)
+    {
+        DiskCache cache(mRoot, 0);
+        cache.write("models", mKey, "data");
+        EXPECT_EQ(cache.read("models", mKey), std::nullopt);
+    }
+
+    TEST_F(FilesDiskCacheTest, read_should_return_queued_entry)
+    {
+        DiskCache cache(mRoot, 0);
+        ASSERT_TRUE(cache.addNamespace("models", 1));
+        cache.write("models", mKey, "data");
+        EXPECT_EQ(cache.read("models", mKey), "data");
+        EXPECT_EQ(cache.read("models", mOtherKey), std::nullopt);
+    }
+
+    TEST_F(FilesDiskCacheTest, read_should_return_entry_written_by_previous_session)
+    {
+        {
+            DiskCache cache(mRoot, 0);
+            ASSERT_TRUE(cache.addNamespace("models", 1));
+            cache.write("models", mKey, "data");
+        }
+        DiskCache cache(mRoot, 0);
+        ASSERT_TRUE(cache.addNamespace("models", 1));
+        EXPECT_EQ(cache.read("models", mKey), "data");
+        EXPECT_EQ(cache.getSize(), 4);
+    }
+
+    TEST_F(FilesDiskCacheTest, add_namespace_should_remove_entries_of_other_versions)
+    {
+        {
+            DiskCache cache(mRoot, 0);
+            ASSERT_TRUE(cache.addNamespace("models", 1));
+            ASSERT_TRUE(cache.addNamespace("shaders", 1));
+            cache.write("models", mKey, "data");
+            cache.write("shaders", mKey, "data");
+        }
+        DiskCache cache(mRoot, 0);
+        ASSERT_TRUE(cache.addNamespace("models", 2));
+        ASSERT_TRUE(cache.addNamespace("shaders", 1));
+        EXPECT_EQ(cache.read("models", mKey), std::nullopt);
+        EXPECT_EQ(cache.read("shaders", mKey), "data");
+        EXPECT_FALSE(std::filesystem::exists(mRoot / "models" / "1"));
+    }
+
+    TEST_F(FilesDiskCacheTest, write_should_replace_entry)
+    {
+        DiskCache cache(mRoot, 0);
+        ASSERT_TRUE(cache.addNamespace("models", 1));
+        cache.write("models", mKey, "data");
+        cache.flush();
+        cache.write("models", mKey, "new data");
+        cache.flush();
+        EXPECT_EQ(cache.read("models", mKey), "new data");
+        EXPECT_EQ(cache.getSize(), 8);
+    }
+
+    TEST_F(FilesDiskCacheTest, write_should_evict_least_recently_used_entries)
+    {
+        DiskCache cache(mRoot, 8);
+        ASSERT_TRUE(cache.addNamespace("models", 1));
+        const DiskCache::Key thirdKey = DiskCache::makeKey("third key");
+        cache.write("models", mKey, "aaaa");
+        cache.write("models", mOtherKey, "bbbb");
+        cache.flush();
+        EXPECT_EQ(cache.read("models", mKey), "aaaa");
+        cache.write("models", thirdKey, "cccc");
+        cache.flush();
+        EXPECT_EQ(cache.read("models", mKey), "aaaa");
+        EXPECT_EQ(cache.read("models", mOtherKey), std::nullopt);
+        EXPECT_EQ(cache.read("models", thirdKey), "cccc");
+        EXPECT_EQ(cache.getSize(), 8);
+    }
+
+    TEST_F(FilesDiskCacheTest, add_namespace_should_remove_interrupted_writes)
+    {
+        std::filesystem::create_directories(mRoot / "models" / "1");
+        std::ofstream(mRoot / "models" / "1" / "entry.tmp") << "data";
+        DiskCache cache(mRoot, 0);
+        ASSERT_TRUE(cache.addNamespace("models", 1));
+        EXPECT_EQ(cache.getSize(), 0);
+        EXPECT_FALSE(std::filesystem::exists(mRoot / "models" / "1" / "entry.tmp"));
+    }
+}
@@ -185,6 +185,30 @@ return {
                                                  "Test[test2.lua]:\t update 1.5\n");
     }
 
+    TEST_F(LuaScriptsContainerTest, ProfilerStats)
+    {
+        LuaUtil::LuaStateSettings settings;
+        settings.mProfilerEnabled = true;
+        LuaUtil::LuaState lua(mVFS.get(), &mCfg, settings);
+        {
+            LuaUtil::ScriptsContainer scripts(&lua, "Test");
+            testing::internal::CaptureStdout();
+            EXPECT_TRUE(scripts.addCustomScript(*mCfg.findId("test1.lua")));
+            scripts.update(1.5f);
+            scripts.update(1.5f);
+            testing::internal::GetCapturedStdout();
+        }
+
+        const int id = *mCfg.findId("test1.lua");
+        const std::vector<LuaUtil::LuaState::ScriptStats>& stats = lua.getScriptStats();
+        ASSERT_LT(static_cast<std::size_t>(id), stats.size());
+        auto it = stats[id].mHandlers.find("onUpdate");
+        ASSERT_NE(it, stats[id].mHandlers.end());
+        EXPECT_EQ(it->second.mCalls, 2u);
+        EXPECT_GE(it->second.mTotalTime, it->second.mMaxTime);
+        EXPECT_EQ(stats[id].mHandlers.count("(start)"), 1u);
+    }
+
     TEST_F(LuaScriptsContainerTest, CallEvent)
     {
         LuaUtil::ScriptsContainer scripts(&mLua, "Test");
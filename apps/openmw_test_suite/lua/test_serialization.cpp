@@ -173,7 +173,7 @@ namespace
         table[2] = osg::Vec2f(2, 1);
 
         std::string serialized = LuaUtil::serialize(table);
-        EXPECT_EQ(serialized.size(), 139);
+        EXPECT_EQ(serialized.size(), 125);
         sol::table res_table = LuaUtil::deserialize(lua, serialized);
         sol::table res_readonly_table = LuaUtil::deserialize(lua, serialized, nullptr, true);
 
@@ -196,6 +196,31 @@ namespace
         EXPECT_ERROR(lua.safe_script("ro_t.nested.x = 5"), "userdata value");
     }
 
+    TEST(LuaSerializationTest, ArrayTable)
+    {
+        sol::state lua;
+        sol::table array = lua.safe_script("return {1, 2, 3}");
+        std::string serialized = LuaUtil::serialize(array);
+        EXPECT_EQ(serialized.size(), 34);  // version, array start, 32bit size, 3 numbers, table end
+        sol::table res = LuaUtil::deserialize(lua, serialized);
+        EXPECT_EQ(res.size(), 3);
+        EXPECT_EQ(res.get<int>(3), 3);
+
+        sol::table mixed = lua.safe_script("return {'a', 'b', x = 'c', [5] = 'd', [1.5] = 'e'}");
+        res = LuaUtil::deserialize(lua, LuaUtil::serialize(mixed));
+        EXPECT_EQ(res.get<std::string>(1), "a");
+        EXPECT_EQ(res.get<std::string>(2), "b");
+        EXPECT_EQ(res.get<std::string>("x"), "c");
+        EXPECT_EQ(res.get<std::string>(5), "d");
+        EXPECT_EQ(res.get<std::string>(1.5), "e");
+
+        sol::table withHoles = lua.safe_script("return {1, nil, 3}");
+        res = LuaUtil::deserialize(lua, LuaUtil::serialize(withHoles));
+        EXPECT_EQ(res.get<int>(1), 1);
+        EXPECT_EQ(res.get<sol::object>(2), sol::nil);
+        EXPECT_EQ(res.get<int>(3), 3);
+    }
+
     struct TestStruct1 { double a, b; };
     struct TestStruct2 { int a, b; };
 
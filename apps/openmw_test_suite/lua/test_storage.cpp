@@ -64,6 +64,27 @@ namespace
         EXPECT_EQ(get<std::string>(mLua, "ro:get('x').y"), "abc");
     }
 
+    TEST(LuaUtilStorageTest, ReadOnlySectionInAnotherState)
+    {
+        sol::state mLua;
+        sol::state otherLua;
+        LuaUtil::LuaStorage::initLuaBindings(mLua);
+        LuaUtil::LuaStorage::initLuaBindings(otherLua);
+        LuaUtil::LuaStorage storage(mLua);
+        mLua["mutable"] = storage.getMutableSection("test");
+        otherLua["ro"] = storage.getReadOnlySection("test", otherLua);
+
+        mLua.safe_script("mutable:set('x', { y = 'abc', z = 7 })");
+        EXPECT_EQ(get<int>(otherLua, "ro:get('x').z"), 7);
+        EXPECT_EQ(get<std::string>(otherLua, "ro:asTable().x.y"), "abc");
+        EXPECT_THROW(otherLua.safe_script("ro:get('x').z = 3"), std::exception);
+        EXPECT_TRUE(get<bool>(otherLua, "ro:wasChanged()"));
+
+        mLua.safe_script("mutable:set('x', 5)");
+        EXPECT_EQ(get<int>(otherLua, "ro:get('x')"), 5);
+        EXPECT_TRUE(get<bool>(otherLua, "ro:get('w') == nil"));
+    }
+
     TEST(LuaUtilStorageTest, Saving)
     {
         sol::state mLua;
@@ -100,4 +121,31 @@ namespace
         EXPECT_TRUE(get<bool>(mLua, "temporary:get('y') == nil"));
     }
 
+    TEST(LuaUtilStorageTest, SavingAsyncShouldWriteChangesSinceLastSave)
+    {
+        sol::state mLua;
+        LuaUtil::LuaStorage::initLuaBindings(mLua);
+        LuaUtil::LuaStorage storage(mLua);
+
+        mLua["first"] = storage.getMutableSection("first");
+        mLua["second"] = storage.getMutableSection("second");
+        mLua.safe_script("first:set('x', 1)");
+        mLua.safe_script("second:set('y', {a = 'b'})");
+
+        std::string tmpFile = (std::filesystem::temp_directory_path() / "test_storage_async.bin").string();
+        storage.saveAsync(tmpFile);
+        mLua.safe_script("second:set('y', 2)");
+        mLua.safe_script("second:set('z', nil)");
+        storage.saveAsync(tmpFile);
+        storage.waitForSave();
+
+        LuaUtil::LuaStorage storage2(mLua);
+        storage2.load(tmpFile);
+        mLua["first"] = storage2.getMutableSection("first");
+        mLua["second"] = storage2.getMutableSection("second");
+        EXPECT_EQ(get<int>(mLua, "first:get('x')"), 1);
+        EXPECT_EQ(get<int>(mLua, "second:get('y')"), 2);
+        EXPECT_TRUE(get<bool>(mLua, "second:get('z') == nil"));
+    }
+
 }
@@ -28,4 +28,16 @@ namespace
         const std::vector<std::byte> decompressed = decompress(compressed);
         EXPECT_EQ(decompressed, data);
     }
+
+    TEST(MiscCompressionTest, decompressWithDictionaryIsInverseToCompressWithDictionary)
+    {
+        std::vector<std::byte> data(1024);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::byte>(i * 7 % 251);
+        const std::vector<std::byte> dictionary(data.begin(), data.begin() + 512);
+        const std::vector<std::byte> compressed = compress(data, dictionary);
+        EXPECT_LT(compressed.size(), compress(data).size());
+        const std::vector<std::byte> decompressed = decompress(compressed, dictionary);
+        EXPECT_EQ(decompressed, data);
+    }
 }
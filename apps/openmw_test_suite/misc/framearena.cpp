@@ -0,0 +1,65 @@
+#include <components/misc/framearena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscFrameArenaTest, allocateShouldReturnAlignedMemory)
+    {
+        FrameArena arena(64);
+        EXPECT_NE(arena.allocate(1, 1), nullptr);
+        void* const pointer = arena.allocate(8, 8);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pointer) % 8, 0u);
+        void* const overAligned = arena.allocate(16, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(overAligned) % 64, 0u);
+    }
+
+    TEST(MiscFrameArenaTest, allocateShouldSupportSizeGreaterThanBlockSize)
+    {
+        FrameArena arena(16);
+        std::pmr::vector<int> values(&arena);
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i);
+        EXPECT_EQ(values.back(), 999);
+        EXPECT_GE(arena.getUsed(), 1000 * sizeof(int));
+    }
+
+    TEST(MiscFrameArenaTest, resetShouldKeepHighWaterMark)
+    {
+        FrameArena arena(64);
+        EXPECT_NE(arena.allocate(100, 1), nullptr);
+        arena.reset();
+        EXPECT_EQ(arena.getUsed(), 0u);
+        EXPECT_NE(arena.allocate(10, 1), nullptr);
+        EXPECT_EQ(arena.getUsed(), 10u);
+        EXPECT_EQ(arena.getHighWaterMark(), 100u);
+    }
+
+    TEST(MiscFrameArenaTest, resetShouldMergeBlocksToFitNextFrame)
+    {
+        FrameArena arena(64);
+        for (int i = 0; i < 10; ++i)
+            EXPECT_NE(arena.allocate(48, 1), nullptr);
+        const std::size_t capacity = arena.getCapacity();
+        arena.reset();
+        EXPECT_EQ(arena.getCapacity(), capacity);
+        for (int i = 0; i < 10; ++i)
+            EXPECT_NE(arena.allocate(48, 1), nullptr);
+        EXPECT_EQ(arena.getCapacity(), capacity);
+    }
+
+    TEST(MiscFrameArenaTest, resetShouldReuseMemory)
+    {
+        FrameArena arena(64);
+        void* const first = arena.allocate(32, 8);
+        arena.reset();
+        EXPECT_EQ(arena.allocate(32, 8), first);
+    }
+}
@@ -0,0 +1,44 @@
+#include <components/misc/internedstring.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscInternedStringTest, defaultConstructedShouldBeEmpty)
+    {
+        const InternedString value;
+        EXPECT_TRUE(value.empty());
+        EXPECT_EQ(value.get(), "");
+    }
+
+    TEST(MiscInternedStringTest, constructedFromEmptyStringShouldBeEqualToDefault)
+    {
+        EXPECT_EQ(InternedString(""), InternedString());
+    }
+
+    TEST(MiscInternedStringTest, equalStringsShouldShareStorage)
+    {
+        const std::string first = "misc_interned_string_test";
+        const std::string second = first;
+        const InternedString lhs(first);
+        const InternedString rhs(second);
+        EXPECT_EQ(lhs, rhs);
+        EXPECT_EQ(&lhs.get(), &rhs.get());
+        EXPECT_EQ(lhs.get(), first);
+    }
+
+    TEST(MiscInternedStringTest, differentStringsShouldNotBeEqual)
+    {
+        EXPECT_NE(InternedString("misc_interned_string_test_a"), InternedString("misc_interned_string_test_b"));
+    }
+
+    TEST(MiscInternedStringTest, comparisonShouldBeCaseSensitive)
+    {
+        EXPECT_NE(InternedString("Misc_Interned_String_Test"), InternedString("misc_interned_string_test"));
+    }
+}
@@ -5,6 +5,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 
 struct PartialBinarySearchTest : public ::testing::Test
 {
@@ -145,4 +146,48 @@ namespace
     {
         EXPECT_FALSE(StringUtils::ciEqual(std::string("a"), std::string("aa")));
     }
+
+    TEST(MiscStringUtilsCiHashTest, should_ignore_case)
+    {
+        EXPECT_EQ(StringUtils::CiHash{}("Ald-ruhn"), StringUtils::CiHash{}(std::string("ALD-RUHN")));
+        EXPECT_NE(StringUtils::CiHash{}("Ald-ruhn"), StringUtils::CiHash{}("Ald-ruhm"));
+    }
+
+    TEST(MiscStringUtilsCiHashTest, should_ignore_case_for_strings_longer_than_word)
+    {
+        EXPECT_EQ(StringUtils::CiHash{}("Meshes\\x\\Ex_Hlaalu_B_01.NIF"), StringUtils::CiHash{}("meshes\\x\\ex_hlaalu_b_01.nif"));
+        EXPECT_NE(StringUtils::CiHash{}("meshes\\x\\ex_hlaalu_b_01.nif"), StringUtils::CiHash{}("meshes\\x\\ex_hlaalu_b_02.nif"));
+    }
+
+    TEST(MiscStringUtilsCiEqualTest, should_compare_strings_longer_than_word)
+    {
+        EXPECT_TRUE(StringUtils::ciEqual(std::string("Meshes\\x\\Ex_Hlaalu_B_01.NIF"), std::string("meshes\\x\\ex_hlaalu_b_01.nif")));
+        EXPECT_FALSE(StringUtils::ciEqual(std::string("meshes\\x\\ex_hlaalu_b_01.nif"), std::string("meshes\\x\\ex_hlaalu_b_02.nif")));
+    }
+
+    TEST(MiscStringUtilsCiEqualTest, should_not_change_case_of_non_ascii_characters)
+    {
+        EXPECT_FALSE(StringUtils::ciEqual(std::string("\xC0\xC1\xC2\xC3\xC4\xC5\xC6\xC7\xDA"), std::string("\xE0\xE1\xE2\xE3\xE4\xE5\xE6\xE7\xFA")));
+        EXPECT_FALSE(StringUtils::ciEqual(std::string("@[`{@[`{@"), std::string("`{@[`{@[`")));
+    }
+
+    TEST(MiscStringUtilsLowerCaseTest, should_lower_case_only_ascii_letters)
+    {
+        EXPECT_EQ(StringUtils::lowerCase("ABCDEFGHIJKLMNOPQRSTUVWXYZ@[`{\xC0\xDA"), "abcdefghijklmnopqrstuvwxyz@[`{\xC0\xDA");
+    }
+
+    TEST(MiscStringUtilsCiLessTest, should_order_strings_longer_than_word)
+    {
+        EXPECT_TRUE(StringUtils::ciLess("Meshes\\x\\Ex_Hlaalu_A", "meshes\\x\\ex_hlaalu_b"));
+        EXPECT_FALSE(StringUtils::ciLess("meshes\\x\\ex_hlaalu_b", "Meshes\\x\\Ex_Hlaalu_A"));
+        EXPECT_TRUE(StringUtils::ciLess("meshes\\x\\ex", "Meshes\\x\\Ex_Hlaalu"));
+        EXPECT_FALSE(StringUtils::ciLess("MESHES\\X\\EX_HLAALU", "meshes\\x\\ex_hlaalu"));
+    }
+
+    TEST(MiscStringUtilsCiHashTest, unordered_map_lookup_should_ignore_case)
+    {
+        std::unordered_map<std::string, int, StringUtils::CiHash, StringUtils::CiEqual> map {{"fPCbaseMagickaMult", 1}};
+        EXPECT_EQ(map.count("fpcbasemagickamult"), 1);
+        EXPECT_EQ(map.count("fPCbaseMagicka"), 0);
+    }
 }
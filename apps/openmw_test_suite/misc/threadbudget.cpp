@@ -0,0 +1,67 @@
+#include <components/misc/threadbudget.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    struct MiscThreadBudgetTest : Test
+    {
+        ThreadBudget& mBudget = ThreadBudget::instance();
+
+        ~MiscThreadBudgetTest() override
+        {
+            mBudget.configure(0, "", false);
+        }
+    };
+
+    TEST_F(MiscThreadBudgetTest, getThreadCountShouldReturnConfiguredValueWhenNotMinusOne)
+    {
+        mBudget.configure(8, "", false);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Physics, 3), 3u);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Physics, 0), 0u);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Physics, -2), 0u);
+    }
+
+    TEST_F(MiscThreadBudgetTest, getThreadCountShouldSplitTotalByShares)
+    {
+        mBudget.configure(8, "physics 2 navigator 1 preload 1 ai 0 skinning 0", false);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Physics, -1), 4u);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Navigator, -1), 2u);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Preload, -1), 2u);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Ai, -1), 0u);
+    }
+
+    TEST_F(MiscThreadBudgetTest, getThreadCountShouldGiveAtLeastOneThreadForNonZeroShare)
+    {
+        mBudget.configure(1, "physics 100 navigator 1", false);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Navigator, -1), 1u);
+    }
+
+    TEST_F(MiscThreadBudgetTest, configureShouldIgnoreUnknownSubsystems)
+    {
+        mBudget.configure(4, "unknown 5 physics 1 navigator 0 preload 0 ai 0 skinning 0", false);
+        EXPECT_EQ(mBudget.getThreadCount(ThreadGroup::Physics, -1), 4u);
+    }
+
+    TEST_F(MiscThreadBudgetTest, registerCurrentThreadShouldReturnNullptrWithoutGroup)
+    {
+        EXPECT_EQ(mBudget.registerCurrentThread(std::nullopt), nullptr);
+    }
+
+    TEST_F(MiscThreadBudgetTest, scopedThreadBusyShouldAddBusyTime)
+    {
+        const std::shared_ptr<ThreadUsage> usage = mBudget.registerCurrentThread(ThreadGroup::Preload);
+        ASSERT_NE(usage, nullptr);
+        {
+            const ScopedThreadBusy busy(usage.get());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_GE(usage->mBusyNs.load(), 1000000);
+    }
+}
@@ -134,3 +134,37 @@ TEST_F(KeywordSearchTest, keyword_test_russian_ascii_before)
     EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Доложить Каю Косадесу");
 }
 
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_of_existing_keyword)
+{
+    // Keywords that are a prefix of a previously seeded keyword must still be found
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer ruins", 1);
+    search.seed("dwemer", 2);
+
+    std::string text = "Dwemer spheres guard the dwemer ruins";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    EXPECT_EQ(matches.size(), 2);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Dwemer");
+    EXPECT_EQ(matches[0].mValue, 2);
+    EXPECT_EQ(std::string(matches[1].mBeg, matches[1].mEnd), "dwemer ruins");
+    EXPECT_EQ(matches[1].mValue, 1);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_contains_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("latest rumors", 1);
+    search.seed("latest", 2);
+
+    int value = 0;
+    EXPECT_TRUE(search.containsKeyword("Latest Rumors", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(search.containsKeyword("latest", value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(search.containsKeyword("latest rumor", value));
+    EXPECT_FALSE(search.containsKeyword("rumors", value));
+}
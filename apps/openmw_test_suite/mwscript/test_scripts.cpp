@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <sstream>
 
+#include <components/compiler/eventgate.hpp>
+
 #include "test_utils.hpp"
 
 namespace
@@ -49,6 +51,18 @@ namespace
             mInterpreter.run(&script.mByteCode[0], static_cast<int>(script.mByteCode.size()), context);
         }
 
+        void runDecoded(const CompiledScript& script, TestInterpreterContext& context)
+        {
+            const int codeSize = static_cast<int>(script.mByteCode.size());
+            const auto instructions = mInterpreter.decode(&script.mByteCode[0], codeSize);
+            mInterpreter.run(&script.mByteCode[0], codeSize, instructions, context);
+        }
+
+        std::uint64_t getInstructionCount() const
+        {
+            return mInterpreter.getInstructionCount();
+        }
+
         template<typename T, typename ...TArgs>
         void installOpcode(int code, TArgs&& ...args)
         {
@@ -439,6 +453,53 @@ messagebox,"this is a %g",a
 
 ,End,)mwscript";
 
+    const std::string sOnActivateGate = R"mwscript(Begin onactivategate
+
+short counter
+
+if ( OnActivate == 1 )
+    set counter to ( counter + 1 )
+    if ( counter > 3 )
+        return
+    endif
+endif
+
+End)mwscript";
+
+    const std::string sOnActivateElse = R"mwscript(Begin onactivateelse
+
+short counter
+
+if ( OnActivate )
+    set counter to 1
+else
+    set counter to 2
+endif
+
+End)mwscript";
+
+    const std::string sMenuModeGate = R"mwscript(Begin menumodegate
+
+short counter
+
+if ( MenuMode == 0 )
+    set counter to ( counter + 1 )
+endif
+
+End)mwscript";
+
+    const std::string sTrailingCode = R"mwscript(Begin trailingcode
+
+short counter
+
+if ( MenuMode )
+    set counter to 1
+endif
+
+set counter to 2
+
+End)mwscript";
+
     TEST_F(MWScriptTest, mwscript_test_invalid)
     {
         EXPECT_THROW(compile("this is not a valid script", true), Compiler::SourceException);
@@ -529,6 +590,79 @@ messagebox,"this is a %g",a
         }
     }
 
+    TEST_F(MWScriptTest, mwscript_test_decoded_math)
+    {
+        if(const auto script = compile(sScript3))
+        {
+            TestInterpreterContext expected;
+            TestInterpreterContext context;
+            for(int i = 1; i < 100; ++i)
+            {
+                expected.setLocalShort(0, i);
+                context.setLocalShort(0, i);
+                run(*script, expected);
+                runDecoded(*script, context);
+                for(int local = 0; local < 5; ++local)
+                    EXPECT_EQ(expected.getLocalShort(local), context.getLocalShort(local));
+            }
+        }
+        else
+        {
+            FAIL();
+        }
+    }
+
+    TEST_F(MWScriptTest, mwscript_test_decoded_unknown_opcode)
+    {
+        registerExtensions();
+        if(const auto script = compile(sScript2))
+        {
+            // AddTopic is not installed, which must only fail once it is executed
+            TestInterpreterContext context;
+            EXPECT_THROW(runDecoded(*script, context), std::runtime_error);
+        }
+        else
+        {
+            FAIL();
+        }
+    }
+
+    TEST_F(MWScriptTest, mwscript_test_instruction_count)
+    {
+        if(const auto script = compile(sScript3))
+        {
+            TestInterpreterContext context;
+            context.setLocalShort(0, 10);
+            const std::uint64_t start = getInstructionCount();
+            run(*script, context);
+            const std::uint64_t executed = getInstructionCount() - start;
+            EXPECT_GT(executed, 0u);
+            context.setLocalShort(0, 10);
+            runDecoded(*script, context);
+            EXPECT_EQ(getInstructionCount() - start, 2 * executed);
+        }
+        else
+        {
+            FAIL();
+        }
+    }
+
+    TEST_F(MWScriptTest, mwscript_test_event_gate)
+    {
+        registerExtensions();
+        const auto getGate = [&] (const std::string& source)
+        {
+            const auto script = compile(source);
+            EXPECT_TRUE(script);
+            return script ? Compiler::getEventGate(script->mByteCode) : Compiler::EventGate::None;
+        };
+        EXPECT_EQ(getGate(sOnActivateGate), Compiler::EventGate::OnActivate);
+        EXPECT_EQ(getGate(sOnActivateElse), Compiler::EventGate::None);
+        EXPECT_EQ(getGate(sMenuModeGate), Compiler::EventGate::NotMenuMode);
+        EXPECT_EQ(getGate(sTrailingCode), Compiler::EventGate::None);
+        EXPECT_EQ(getGate(sScript3), Compiler::EventGate::None);
+    }
+
     TEST_F(MWScriptTest, mwscript_test_forum_thread)
     {
         registerExtensions();
@@ -311,3 +311,120 @@ TEST_F(StoreTest, overwrite_test)
 
     ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
 }
+
+/// Tests that merging parsed content gives the same result as loading it in order.
+TEST_F(StoreTest, parse_and_merge_test)
+{
+    ESM::Apparatus apparatus;
+    apparatus.blank();
+    apparatus.mId = "Foobar";
+    apparatus.mModel = "the_model";
+
+    ESM::Dialogue dialogue;
+    dialogue.blank();
+    dialogue.mId = "topic";
+    dialogue.mType = ESM::Dialogue::Topic;
+
+    ESM::ESMWriter writer;
+    auto* stream = new std::stringstream;
+    writer.setFormat(0);
+    writer.save(*stream);
+    writer.startRecord(ESM::Apparatus::sRecordId);
+    apparatus.save(writer);
+    writer.endRecord(ESM::Apparatus::sRecordId);
+    writer.startRecord(ESM::Dialogue::sRecordId);
+    dialogue.save(writer);
+    writer.endRecord(ESM::Dialogue::sRecordId);
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(stream), "filename");
+    MWWorld::ESMStore::ParsedContent content = mEsmStore.parse(reader);
+
+    ASSERT_EQ(content.mEntries.size(), 2);
+    ASSERT_EQ(content.mDeferred.size(), 1);
+    EXPECT_EQ(content.mDeferred.front().mCount, 1);
+    EXPECT_EQ(mEsmStore.get<ESM::Apparatus>().getSize(), 0);
+
+    mEsmStore.load(reader, content, &dummyListener);
+    mEsmStore.setUp();
+
+    const ESM::Apparatus* loaded = mEsmStore.get<ESM::Apparatus>().search("foobar");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->mModel, "the_model");
+    EXPECT_NE(mEsmStore.get<ESM::Dialogue>().search("topic"), nullptr);
+}
+
+/// Tests that loading records written by writeStatic restores the store.
+TEST_F(StoreTest, write_static_test)
+{
+    ESM::Apparatus first;
+    first.blank();
+    first.mId = "first";
+    first.mModel = "first_model";
+    ESM::Apparatus second = first;
+    second.mId = "second";
+    second.mModel = "second_model";
+
+    ESM::ESMReader reader;
+    reader.open(getEsmFile(first, false), "first");
+    mEsmStore.load(reader, &dummyListener);
+    reader.open(getEsmFile(second, false), "second");
+    mEsmStore.load(reader, &dummyListener);
+
+    ESM::ESMWriter writer;
+    auto* stream = new std::stringstream;
+    writer.setFormat(0);
+    writer.save(*stream);
+    mEsmStore.writeStatic(writer);
+    EXPECT_EQ(mEsmStore.getStaticSize(), 2);
+
+    MWWorld::ESMStore restored;
+    reader.open(Files::IStreamPtr(stream), "snapshot");
+    restored.load(reader, &dummyListener);
+    restored.setUp();
+
+    const MWWorld::Store<ESM::Apparatus>& store = restored.get<ESM::Apparatus>();
+    ASSERT_EQ(store.getSize(), 2);
+    auto it = store.begin();
+    EXPECT_EQ(it->mId, "first");
+    EXPECT_EQ(it->mModel, "first_model");
+    ++it;
+    EXPECT_EQ(it->mModel, "second_model");
+}
+
+/// Tests that the text of books is read from the content file when the book is looked up.
+TEST_F(StoreTest, lazy_loading_test)
+{
+    ESM::Book book;
+    book.blank();
+    book.mId = "book";
+    book.mModel = "book_model";
+    book.mText = "The text of the book";
+
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%.esp");
+    {
+        Files::IStreamPtr file = getEsmFile(book, false);
+        boost::filesystem::ofstream stream(path, std::ios::binary);
+        stream << file->rdbuf();
+    }
+
+    mEsmStore.setLazyLoading(nullptr);
+    ESM::ESMReader reader;
+    reader.open(path.string());
+    mEsmStore.load(reader, &dummyListener);
+    reader.close();
+    mEsmStore.setUp();
+
+    const MWWorld::Store<ESM::Book>& store = mEsmStore.get<ESM::Book>();
+    ASSERT_EQ(store.getSize(), 1);
+    EXPECT_EQ(store.begin()->mModel, "book_model");
+    EXPECT_FALSE(store.begin()->isTextLoaded());
+
+    const ESM::Book* loaded = store.search("book");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(loaded->isTextLoaded());
+    EXPECT_EQ(loaded->mText, "The text of the book");
+
+    boost::filesystem::remove(path);
+}
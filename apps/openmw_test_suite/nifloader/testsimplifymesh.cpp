@@ -0,0 +1,89 @@
+#include <components/nifbullet/simplifymesh.hpp>
+
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace NifBullet;
+
+    std::vector<btVector3> getVertices(const btTriangleMesh& mesh)
+    {
+        std::vector<btVector3> result;
+        const unsigned char* vertexBase = nullptr;
+        int numVertices = 0;
+        PHY_ScalarType vertexType = PHY_FLOAT;
+        int vertexStride = 0;
+        const unsigned char* indexBase = nullptr;
+        int indexStride = 0;
+        int numFaces = 0;
+        PHY_ScalarType indexType = PHY_INTEGER;
+        mesh.getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType, vertexStride,
+                                              &indexBase, indexStride, numFaces, indexType, 0);
+        for (int i = 0; i < numVertices; ++i)
+        {
+            const btScalar* vertex = reinterpret_cast<const btScalar*>(vertexBase + i * vertexStride);
+            result.emplace_back(vertex[0], vertex[1], vertex[2]);
+        }
+        mesh.unLockReadOnlyVertexBase(0);
+        return result;
+    }
+
+    // A 10x10 grid of quads with a small bump in every vertex
+    std::unique_ptr<btTriangleMesh> makeBumpyPlane()
+    {
+        std::unique_ptr<btTriangleMesh> mesh(new btTriangleMesh);
+        const auto vertex = [] (int x, int y) { return btVector3(x * 10, y * 10, (x + y) % 2 == 0 ? 0 : 0.5f); };
+        for (int x = 0; x < 10; ++x)
+            for (int y = 0; y < 10; ++y)
+            {
+                mesh->addTriangle(vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1), true);
+                mesh->addTriangle(vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1), true);
+            }
+        return mesh;
+    }
+
+    TEST(NifBulletSimplifyTriangleMeshTest, should_return_nullptr_for_zero_error)
+    {
+        const std::unique_ptr<btTriangleMesh> mesh = makeBumpyPlane();
+        EXPECT_EQ(simplifyTriangleMesh(*mesh, 0), nullptr);
+    }
+
+    TEST(NifBulletSimplifyTriangleMeshTest, should_return_nullptr_when_no_vertices_are_merged)
+    {
+        const std::unique_ptr<btTriangleMesh> mesh = makeBumpyPlane();
+        EXPECT_EQ(simplifyTriangleMesh(*mesh, 1), nullptr);
+    }
+
+    TEST(NifBulletSimplifyTriangleMeshTest, should_reduce_triangles_for_error_above_detail_size)
+    {
+        const std::unique_ptr<btTriangleMesh> mesh = makeBumpyPlane();
+        const std::unique_ptr<btTriangleMesh> result = simplifyTriangleMesh(*mesh, 30);
+        ASSERT_NE(result, nullptr);
+        EXPECT_GT(result->getNumTriangles(), 0);
+        EXPECT_LT(result->getNumTriangles(), mesh->getNumTriangles());
+    }
+
+    TEST(NifBulletSimplifyTriangleMeshTest, should_not_move_vertices_further_than_error)
+    {
+        const std::unique_ptr<btTriangleMesh> mesh = makeBumpyPlane();
+        const float maxError = 30;
+        const std::unique_ptr<btTriangleMesh> result = simplifyTriangleMesh(*mesh, maxError);
+        ASSERT_NE(result, nullptr);
+        const std::vector<btVector3> original = getVertices(*mesh);
+        for (const btVector3& vertex : getVertices(*result))
+        {
+            btScalar nearest = std::numeric_limits<btScalar>::max();
+            for (const btVector3& v : original)
+                nearest = std::min(nearest, vertex.distance(v));
+            EXPECT_LE(nearest, maxError);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include <components/nifosg/controller.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace
+{
+    using namespace testing;
+    using namespace NifOsg;
+
+    std::shared_ptr<Nif::FloatKeyMap> makeKeys(unsigned int interpolationType)
+    {
+        auto keys = std::make_shared<Nif::FloatKeyMap>();
+        keys->mInterpolationType = interpolationType;
+        keys->mKeys[0.f] = Nif::FloatKey {0.f, 0.f, 0.f};
+        keys->mKeys[1.f] = Nif::FloatKey {10.f, 0.f, 0.f};
+        keys->mKeys[3.f] = Nif::FloatKey {20.f, 0.f, 0.f};
+        return keys;
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_return_default_value_without_keys)
+    {
+        const FloatInterpolator interpolator(Nif::FloatKeyMapPtr(), 42.f);
+        EXPECT_TRUE(interpolator.empty());
+        EXPECT_EQ(interpolator.interpKey(1.f), 42.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_clamp_to_first_and_last_key)
+    {
+        const FloatInterpolator interpolator(makeKeys(Nif::InterpolationType_Linear));
+        EXPECT_EQ(interpolator.interpKey(-1.f), 0.f);
+        EXPECT_EQ(interpolator.interpKey(3.f), 20.f);
+        EXPECT_EQ(interpolator.interpKey(5.f), 20.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_interpolate_linearly_forward_and_backward)
+    {
+        const FloatInterpolator interpolator(makeKeys(Nif::InterpolationType_Linear));
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.5f), 5.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(1.f), 10.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.f), 15.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.25f), 2.5f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.5f), 17.5f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_pick_nearest_key_for_constant_interpolation)
+    {
+        const FloatInterpolator interpolator(makeKeys(Nif::InterpolationType_Constant));
+        EXPECT_EQ(interpolator.interpKey(0.4f), 0.f);
+        EXPECT_EQ(interpolator.interpKey(0.6f), 10.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, copies_should_sample_independently)
+    {
+        const FloatInterpolator interpolator(makeKeys(Nif::InterpolationType_Linear));
+        const FloatInterpolator copy = interpolator;
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.f), 15.f);
+        EXPECT_FLOAT_EQ(copy.interpKey(0.5f), 5.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.5f), 17.5f);
+    }
+}
@@ -0,0 +1,113 @@
+#include <components/resource/bulletshape.hpp>
+#include <components/resource/bulletshapeserialization.hpp>
+
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    std::unique_ptr<TriangleMeshShape> makeTriangleMeshShape(bool use32BitIndices)
+    {
+        auto mesh = std::make_unique<btTriangleMesh>(use32BitIndices);
+        mesh->addTriangle(btVector3(0, 0, 0), btVector3(1, 0, 0), btVector3(1, 1, 0));
+        mesh->addTriangle(btVector3(0, 0, 0), btVector3(1, 1, 0), btVector3(0, 1, 1));
+        auto shape = std::make_unique<TriangleMeshShape>(mesh.get(), true);
+        mesh.release();
+        return shape;
+    }
+
+    void collectVertices(const btCollisionShape& shape, std::vector<btVector3>& result)
+    {
+        struct Callback : btTriangleCallback
+        {
+            std::vector<btVector3>& mResult;
+
+            explicit Callback(std::vector<btVector3>& result) : mResult(result) {}
+
+            void processTriangle(btVector3* triangle, int, int) override
+            {
+                mResult.insert(mResult.end(), triangle, triangle + 3);
+            }
+        };
+
+        Callback callback(result);
+        const btVector3 aabbMax(1e6f, 1e6f, 1e6f);
+        static_cast<const btConcaveShape&>(shape).processAllTriangles(&callback, -aabbMax, aabbMax);
+    }
+
+    TEST(ResourceBulletShapeSerializationTest, should_restore_compound_shape_with_box_and_triangle_mesh)
+    {
+        osg::ref_ptr<BulletShape> source(new BulletShape);
+        std::unique_ptr<btCompoundShape, DeleteCollisionShape> compound(new btCompoundShape);
+        const btTransform boxTransform(btQuaternion(btVector3(0, 0, 1), 0.5f), btVector3(1, 2, 3));
+        compound->addChildShape(boxTransform, new btBoxShape(btVector3(4, 5, 6)));
+        compound->addChildShape(btTransform::getIdentity(), makeTriangleMeshShape(true).release());
+        source->mCollisionShape = std::move(compound);
+        source->mAvoidCollisionShape.reset(makeTriangleMeshShape(false).release());
+        source->mCollisionBox.mExtents = osg::Vec3f(1, 2, 3);
+        source->mCollisionBox.mCenter = osg::Vec3f(4, 5, 6);
+        source->mAnimatedShapes = {{3, 1}};
+        source->mFileName = "meshes/test.nif";
+        source->mFileHash = "hash";
+
+        const std::vector<std::byte> data = serializeBulletShape(*source);
+        ASSERT_FALSE(data.empty());
+        const osg::ref_ptr<BulletShape> result = deserializeBulletShape(data.data(), data.size());
+
+        ASSERT_NE(result->mCollisionShape, nullptr);
+        ASSERT_TRUE(result->mCollisionShape->isCompound());
+        const btCompoundShape& resultCompound = static_cast<const btCompoundShape&>(*result->mCollisionShape);
+        ASSERT_EQ(resultCompound.getNumChildShapes(), 2);
+
+        ASSERT_EQ(resultCompound.getChildShape(0)->getShapeType(), BOX_SHAPE_PROXYTYPE);
+        const btBoxShape& box = static_cast<const btBoxShape&>(*resultCompound.getChildShape(0));
+        EXPECT_EQ(box.getHalfExtentsWithMargin(), btVector3(4, 5, 6));
+        EXPECT_EQ(resultCompound.getChildTransform(0).getOrigin(), boxTransform.getOrigin());
+        EXPECT_EQ(resultCompound.getChildTransform(0).getBasis(), boxTransform.getBasis());
+
+        ASSERT_EQ(resultCompound.getChildShape(1)->getShapeType(), TRIANGLE_MESH_SHAPE_PROXYTYPE);
+        const auto* mesh = dynamic_cast<const TriangleMeshShape*>(resultCompound.getChildShape(1));
+        ASSERT_NE(mesh, nullptr);
+        EXPECT_TRUE(mesh->usesQuantizedAabbCompression());
+        EXPECT_FALSE(mesh->getOwnsBvh());
+        std::vector<btVector3> sourceVertices;
+        collectVertices(*static_cast<const btCompoundShape&>(*source->mCollisionShape).getChildShape(1), sourceVertices);
+        std::vector<btVector3> resultVertices;
+        collectVertices(*mesh, resultVertices);
+        EXPECT_EQ(resultVertices, sourceVertices);
+
+        ASSERT_NE(result->mAvoidCollisionShape, nullptr);
+        EXPECT_EQ(result->mAvoidCollisionShape->getShapeType(), TRIANGLE_MESH_SHAPE_PROXYTYPE);
+        EXPECT_EQ(result->mCollisionBox.mExtents, source->mCollisionBox.mExtents);
+        EXPECT_EQ(result->mCollisionBox.mCenter, source->mCollisionBox.mCenter);
+        EXPECT_EQ(result->mAnimatedShapes, source->mAnimatedShapes);
+        EXPECT_EQ(result->mFileName, source->mFileName);
+        EXPECT_EQ(result->mFileHash, source->mFileHash);
+    }
+
+    TEST(ResourceBulletShapeSerializationTest, should_not_serialize_unsupported_shape)
+    {
+        osg::ref_ptr<BulletShape> source(new BulletShape);
+        source->mCollisionShape.reset(new btSphereShape(1));
+        EXPECT_TRUE(serializeBulletShape(*source).empty());
+    }
+
+    TEST(ResourceBulletShapeSerializationTest, should_throw_on_truncated_data)
+    {
+        osg::ref_ptr<BulletShape> source(new BulletShape);
+        source->mCollisionShape.reset(makeTriangleMeshShape(true).release());
+        const std::vector<std::byte> data = serializeBulletShape(*source);
+        ASSERT_FALSE(data.empty());
+        EXPECT_THROW(deserializeBulletShape(data.data(), data.size() / 2), std::runtime_error);
+    }
+}
@@ -0,0 +1,58 @@
+#include <components/resource/objectcache.hpp>
+
+#include <osg/Image>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    osg::ref_ptr<osg::Image> makeImage(int size)
+    {
+        osg::ref_ptr<osg::Image> image = new osg::Image;
+        image->allocateImage(size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+        return image;
+    }
+
+    TEST(ResourceObjectCacheTest, shouldTrackEstimatedMemoryUsage)
+    {
+        osg::ref_ptr<ObjectCache> cache = new ObjectCache;
+        cache->addEntryToObjectCache("a", makeImage(16));
+        cache->addEntryToObjectCache("b", makeImage(8));
+        EXPECT_EQ(cache->getMemoryUsage(), 16u * 16 * 4 + 8 * 8 * 4);
+
+        cache->addEntryToObjectCache("a", makeImage(4));
+        EXPECT_EQ(cache->getMemoryUsage(), 4u * 4 * 4 + 8 * 8 * 4);
+
+        cache->removeFromObjectCache("b");
+        EXPECT_EQ(cache->getMemoryUsage(), 4u * 4 * 4);
+
+        cache->clear();
+        EXPECT_EQ(cache->getMemoryUsage(), 0u);
+    }
+
+    TEST(ResourceObjectCacheTest, shouldEvictOnlyObjectsWithoutExternalReferences)
+    {
+        osg::ref_ptr<ObjectCache> cache = new ObjectCache;
+        const osg::ref_ptr<osg::Image> referenced = makeImage(16);
+        cache->addEntryToObjectCache("referenced", referenced, 1.0);
+        cache->addEntryToObjectCache("large", makeImage(16), 1.0);
+        cache->addEntryToObjectCache("small", makeImage(8), 1.0);
+
+        std::vector<EvictionCandidate> candidates;
+        cache->collectEvictionCandidates(2.0, candidates);
+        ASSERT_EQ(candidates.size(), 2u);
+        std::sort(candidates.begin(), candidates.end(),
+                  [] (const EvictionCandidate& lhs, const EvictionCandidate& rhs) { return lhs.mCost > rhs.mCost; });
+
+        EXPECT_EQ(candidates[0].mEvict(), 16u * 16 * 4);
+        EXPECT_EQ(cache->getRefFromObjectCache("large").get(), nullptr);
+        EXPECT_NE(cache->getRefFromObjectCache("small").get(), nullptr);
+        EXPECT_NE(cache->getRefFromObjectCache("referenced").get(), nullptr);
+        EXPECT_EQ(cache->getMemoryUsage(), 16u * 16 * 4 + 8 * 8 * 4);
+    }
+}
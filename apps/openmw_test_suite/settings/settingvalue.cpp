@@ -0,0 +1,58 @@
+#include <components/settings/settingvalue.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace Settings;
+
+    struct SettingsSettingValueTest : Test
+    {
+        SettingsSettingValueTest()
+        {
+            Manager::mDefaultSettings[{"Category", "int"}] = "42";
+            Manager::mDefaultSettings[{"Category", "bool"}] = "true";
+            Manager::mDefaultSettings[{"Category", "vector"}] = "1 2 3";
+        }
+
+        ~SettingsSettingValueTest()
+        {
+            Manager().clear();
+        }
+    };
+
+    TEST_F(SettingsSettingValueTest, get_should_return_parsed_default_value)
+    {
+        const SettingValue<int> intValue("int", "Category");
+        EXPECT_EQ(intValue.get(), 42);
+        const SettingValue<bool> boolValue("bool", "Category");
+        EXPECT_TRUE(boolValue.get());
+        const SettingValue<osg::Vec3f> vectorValue("vector", "Category");
+        EXPECT_EQ(vectorValue.get(), osg::Vec3f(1, 2, 3));
+    }
+
+    TEST_F(SettingsSettingValueTest, get_should_return_value_changed_through_manager)
+    {
+        const SettingValue<int> value("int", "Category");
+        EXPECT_EQ(value.get(), 42);
+        Manager::setInt("int", "Category", 13);
+        EXPECT_EQ(value.get(), 13);
+    }
+
+    TEST_F(SettingsSettingValueTest, set_should_change_value_of_other_handles)
+    {
+        const SettingValue<bool> first("bool", "Category");
+        const SettingValue<bool> second("bool", "Category");
+        EXPECT_TRUE(second.get());
+        first.set(false);
+        EXPECT_FALSE(second.get());
+        EXPECT_FALSE(Manager::getBool("bool", "Category"));
+    }
+
+    TEST_F(SettingsSettingValueTest, get_should_throw_for_missing_setting)
+    {
+        const SettingValue<float> value("missing", "Category");
+        EXPECT_THROW(value.get(), std::runtime_error);
+    }
+}
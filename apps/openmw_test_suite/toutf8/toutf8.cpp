@@ -82,6 +82,34 @@ namespace
         EXPECT_EQ(result, expected);
     }
 
+    TEST(Utf8EncoderTest, getUtf8ShouldConvertLongMostlyAsciiInput)
+    {
+        const std::string input("\x93Hello, outlander.\x94 \x93What brings you to Balmora?\x94");
+        Utf8Encoder encoder(FromType::WINDOWS_1252);
+        const std::string_view result = encoder.getUtf8(input);
+        EXPECT_EQ(result, "\xe2\x80\x9cHello, outlander.\xe2\x80\x9d \xe2\x80\x9cWhat brings you to Balmora?\xe2\x80\x9d");
+    }
+
+    TEST(Utf8EncoderTest, getUtf8ShouldConvertIntoGivenBuffer)
+    {
+        const std::string input("Caf\xe9 and caf\xe9s");
+        const Utf8Encoder encoder(FromType::WINDOWS_1252);
+        std::string buffer;
+        const std::string_view result = encoder.getUtf8(input, buffer);
+        EXPECT_EQ(result, "Caf\xc3\xa9 and caf\xc3\xa9s");
+        EXPECT_EQ(result.data(), buffer.data());
+    }
+
+    TEST(Utf8EncoderTest, getLegacyEncShouldConvertIntoGivenBuffer)
+    {
+        const std::string input("Caf\xc3\xa9 \xe2\x80\x9c");
+        const Utf8Encoder encoder(FromType::WINDOWS_1252);
+        std::string buffer;
+        const std::string_view result = encoder.getLegacyEnc(input, buffer);
+        EXPECT_EQ(result, "Caf\xe9 \x93");
+        EXPECT_EQ(result.data(), buffer.data());
+    }
+
     TEST(Utf8EncoderTest, getLegacyEncShouldReturnEmptyAsIs)
     {
         Utf8Encoder encoder(FromType::CP437);
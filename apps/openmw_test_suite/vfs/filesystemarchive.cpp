@@ -0,0 +1,95 @@
+#include <components/vfs/filesystemarchive.hpp>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <ctime>
+
+namespace
+{
+    using namespace testing;
+
+    char normalize(char c)
+    {
+        if (c == '\\')
+            return '/';
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    struct VFSFileSystemArchiveTest : Test
+    {
+        const boost::filesystem::path mRoot = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw-vfs-test-%%%%-%%%%");
+        const boost::filesystem::path mData = mRoot / "data";
+        const boost::filesystem::path mCache = mRoot / "cache";
+        // Time stamps older than the delay the cache waits for to trust them
+        const std::time_t mPast = std::time(nullptr) - 60;
+
+        VFSFileSystemArchiveTest()
+        {
+            boost::filesystem::create_directories(mData / "Meshes");
+            boost::filesystem::create_directories(mCache);
+            boost::filesystem::ofstream(mData / "Meshes" / "A.nif") << "a";
+            boost::filesystem::ofstream(mData / "b.esp") << "b";
+            boost::filesystem::last_write_time(mData / "Meshes", mPast);
+            boost::filesystem::last_write_time(mData, mPast);
+        }
+
+        ~VFSFileSystemArchiveTest()
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove_all(mRoot, error);
+        }
+
+        std::vector<std::string> list(const std::string& cachePath)
+        {
+            VFS::FileSystemArchive archive(mData.string(), cachePath);
+            std::map<std::string, VFS::File*> files;
+            archive.listResources(files, &normalize);
+            std::vector<std::string> result;
+            for (const auto& [name, file] : files)
+                result.push_back(name);
+            return result;
+        }
+    };
+
+    TEST_F(VFSFileSystemArchiveTest, should_list_files_without_cache)
+    {
+        EXPECT_THAT(list(std::string()), ElementsAre("b.esp", "meshes/a.nif"));
+        EXPECT_TRUE(boost::filesystem::is_empty(mCache));
+    }
+
+    TEST_F(VFSFileSystemArchiveTest, should_list_same_files_from_cache)
+    {
+        EXPECT_THAT(list(mCache.string()), ElementsAre("b.esp", "meshes/a.nif"));
+        EXPECT_FALSE(boost::filesystem::is_empty(mCache));
+        EXPECT_THAT(list(mCache.string()), ElementsAre("b.esp", "meshes/a.nif"));
+    }
+
+    TEST_F(VFSFileSystemArchiveTest, should_use_cache_while_directory_times_are_unchanged)
+    {
+        list(mCache.string());
+        boost::filesystem::ofstream(mData / "Meshes" / "c.nif") << "c";
+        boost::filesystem::last_write_time(mData / "Meshes", mPast);
+        EXPECT_THAT(list(mCache.string()), ElementsAre("b.esp", "meshes/a.nif"));
+    }
+
+    TEST_F(VFSFileSystemArchiveTest, should_scan_again_when_directory_is_modified)
+    {
+        list(mCache.string());
+        boost::filesystem::ofstream(mData / "Meshes" / "c.nif") << "c";
+        boost::filesystem::last_write_time(mData / "Meshes", mPast + 1);
+        EXPECT_THAT(list(mCache.string()), ElementsAre("b.esp", "meshes/a.nif", "meshes/c.nif"));
+    }
+
+    TEST_F(VFSFileSystemArchiveTest, should_not_write_cache_for_recently_modified_directories)
+    {
+        boost::filesystem::last_write_time(mData, std::time(nullptr));
+        list(mCache.string());
+        EXPECT_TRUE(boost::filesystem::is_empty(mCache));
+    }
+}
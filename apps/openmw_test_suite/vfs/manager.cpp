@@ -0,0 +1,117 @@
+#include <components/vfs/archive.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+
+    struct File : VFS::File
+    {
+        explicit File(std::string content) : mContent(std::move(content)) {}
+
+        Files::IStreamPtr open() override
+        {
+            return std::make_shared<std::stringstream>(mContent, std::ios_base::in);
+        }
+
+        void prefetch() override
+        {
+            ++mPrefetched;
+        }
+
+        std::string mContent;
+        int mPrefetched = 0;
+    };
+
+    struct Archive : VFS::Archive
+    {
+        std::map<std::string, File> mFiles;
+
+        explicit Archive(std::map<std::string, File> files) : mFiles(std::move(files)) {}
+
+        void listResources(std::map<std::string, VFS::File*>& out, char (*normalize)(char)) override
+        {
+            for (auto& [name, file] : mFiles)
+            {
+                std::string normalized = name;
+                std::transform(normalized.begin(), normalized.end(), normalized.begin(), normalize);
+                out[normalized] = &file;
+            }
+        }
+
+        bool contains(const std::string& file, char (*normalize)(char)) const override
+        {
+            return mFiles.count(file) != 0;
+        }
+
+        std::string getDescription() const override { return "Archive"; }
+    };
+
+    std::string read(const Files::IStreamPtr& stream)
+    {
+        return std::string(std::istreambuf_iterator<char>(*stream), {});
+    }
+
+    struct VFSManagerTest : Test
+    {
+        VFS::Manager mManager {false};
+        Archive* mFirst = new Archive({{"meshes/a.nif", File("a")}, {"Textures/B.dds", File("b")}});
+        Archive* mSecond = new Archive({{"textures\\b.dds", File("b2")}, {"textures/c.dds", File("c")}});
+
+        VFSManagerTest()
+        {
+            mManager.addArchive(mFirst);
+            mManager.addArchive(mSecond);
+            mManager.buildIndex();
+        }
+    };
+
+    TEST_F(VFSManagerTest, exists_should_ignore_case_and_separators)
+    {
+        EXPECT_TRUE(mManager.exists("meshes/a.nif"));
+        EXPECT_TRUE(mManager.exists("MESHES\\A.NIF"));
+        EXPECT_FALSE(mManager.exists("meshes/b.nif"));
+        EXPECT_FALSE(mManager.exists("meshes/a.ni"));
+    }
+
+    TEST_F(VFSManagerTest, exists_should_support_precomputed_hash)
+    {
+        const std::size_t hash = mManager.getNameHash("Textures/C.dds");
+        EXPECT_EQ(hash, mManager.getNameHash("textures\\c.dds"));
+        EXPECT_TRUE(mManager.exists("Textures/C.dds", hash));
+    }
+
+    TEST_F(VFSManagerTest, get_should_prefer_last_added_archive)
+    {
+        EXPECT_EQ(read(mManager.get("textures/b.dds")), "b2");
+        EXPECT_EQ(read(mManager.get("meshes\\A.nif")), "a");
+    }
+
+    TEST_F(VFSManagerTest, get_should_throw_for_missing_file)
+    {
+        EXPECT_THROW(mManager.get("textures/d.dds"), std::runtime_error);
+    }
+
+    TEST_F(VFSManagerTest, recursive_directory_iterator_should_return_files_with_prefix)
+    {
+        std::vector<std::string> files;
+        for (const std::string& file : mManager.getRecursiveDirectoryIterator("Textures"))
+            files.push_back(file);
+        EXPECT_THAT(files, ElementsAre("textures/b.dds", "textures/c.dds"));
+    }
+
+    TEST_F(VFSManagerTest, prefetch_should_prefetch_existing_files_once)
+    {
+        mManager.prefetch({"meshes/a.nif", "Textures/B.dds", "textures/c.dds", "textures/d.dds"}, 2);
+        EXPECT_EQ(mFirst->mFiles.at("meshes/a.nif").mPrefetched, 1);
+        EXPECT_EQ(mFirst->mFiles.at("Textures/B.dds").mPrefetched, 0);
+        EXPECT_EQ(mSecond->mFiles.at("textures\\b.dds").mPrefetched, 1);
+        EXPECT_EQ(mSecond->mFiles.at("textures/c.dds").mPrefetched, 1);
+    }
+}
@@ -28,9 +28,28 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <components/files/memorystream.hpp>
 
 using namespace Bsa;
 
+namespace
+{
+    /// A stream reading straight from a mapped archive, keeping the mapping alive while it is used.
+    struct MappedFileStream : Files::IMemStream
+    {
+        MappedFileStream(std::shared_ptr<const boost::iostreams::mapped_file_source> mapping, size_t offset, size_t length)
+            : Files::MemBuf(mapping->data() + offset, length)
+            , Files::IMemStream(mapping->data() + offset, length)
+            , mMapping(std::move(mapping))
+        {
+        }
+
+        std::shared_ptr<const boost::iostreams::mapped_file_source> mMapping;
+    };
+}
+
 
 /// Error handling
 [[noreturn]] void BSAFile::fail(const std::string &msg)
@@ -255,9 +274,45 @@ void Bsa::BSAFile::close()
 
     mFiles.clear();
     mStringBuf.clear();
+    mMapping.reset();
     mIsLoaded = false;
 }
 
+void Bsa::BSAFile::mapIntoMemory()
+{
+    if (!mIsLoaded)
+        fail("Unable to map the archive into memory, it is not opened");
+    if (mMapping != nullptr)
+        return;
+    if (boost::filesystem::file_size(mFilename) == 0)
+        return;
+    try
+    {
+        mMapping = std::make_shared<boost::iostreams::mapped_file_source>(mFilename);
+    }
+    catch (const std::exception& e)
+    {
+        fail(std::string("Failed to map the archive into memory: ") + e.what());
+    }
+}
+
+Files::IStreamPtr Bsa::BSAFile::openRegion(size_t offset, size_t length) const
+{
+    if (mMapping == nullptr)
+        return Files::openConstrainedFileStream(mFilename.c_str(), offset, length);
+    if (offset > mMapping->size())
+        throw std::runtime_error("BSA Error: region offset is outside of the archive\nArchive: " + mFilename);
+    length = std::min(length, mMapping->size() - offset);
+    return std::make_shared<MappedFileStream>(mMapping, offset, length);
+}
+
+std::optional<std::string_view> Bsa::BSAFile::getFileView(const FileStruct *file) const
+{
+    if (mMapping == nullptr)
+        return std::nullopt;
+    return std::string_view(mMapping->data() + file->offset, file->fileSize);
+}
+
 void Bsa::BSAFile::addFile(const std::string& filename, std::istream& file)
 {
     if (!mIsLoaded)
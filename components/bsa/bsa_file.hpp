@@ -25,11 +25,18 @@
 #define BSA_BSA_FILE_H
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <components/files/constrainedfilestream.hpp>
 
+namespace boost::iostreams
+{
+    class mapped_file_source;
+}
 
 namespace Bsa
 {
@@ -88,9 +95,15 @@ protected:
     /// Used for error messages
     std::string mFilename;
 
+    /// Read-only mapping of the whole archive, if mapIntoMemory() was called
+    std::shared_ptr<const boost::iostreams::mapped_file_source> mMapping;
+
     /// Error handling
     [[noreturn]] void fail(const std::string &msg);
 
+    /// Open a stream over the given region of the archive, reading from the mapping if there is one.
+    Files::IStreamPtr openRegion(size_t offset, size_t length) const;
+
     /// Read header information from the input source
     virtual void readHeader();
     virtual void writeHeader();
@@ -115,6 +128,13 @@ public:
 
     void close();
 
+    /// Map the whole archive into the address space, so that file data is served from the page cache
+    /// instead of being read through a file stream.
+    /// @note Must be called after open() and before any getFile() call.
+    void mapIntoMemory();
+
+    bool isMemoryMapped() const { return mMapping != nullptr; }
+
     /* -----------------------------------
      * Archive file routines
      * -----------------------------------
@@ -125,9 +145,16 @@ public:
     */
     Files::IStreamPtr getFile(const FileStruct *file)
     {
-        return Files::openConstrainedFileStream (mFilename.c_str (), file->offset, file->fileSize);
+        return openRegion(file->offset, file->fileSize);
     }
 
+    /** Get a read-only view of the file data inside the mapped archive, without copying it.
+     * @note Returns std::nullopt if the archive is not memory mapped.
+     * @note The view is valid until the archive is closed.
+     * @note Thread safe.
+    */
+    std::optional<std::string_view> getFileView(const FileStruct *file) const;
+
     virtual void addFile(const std::string& filename, std::istream& file);
 
     /// Get a list of all files
@@ -24,8 +24,11 @@
  */
 #include "compressedbsafile.hpp"
 
+#include <atomic>
 #include <stdexcept>
 #include <cassert>
+#include <list>
+#include <mutex>
 
 #include <lz4frame.h>
 
@@ -46,11 +49,121 @@
 #endif
 
 #include <boost/iostreams/device/array.hpp>
-#include <components/bsa/memorystream.hpp>
+#include <components/files/memorystream.hpp>
 #include <components/misc/stringops.hpp>
 
 namespace Bsa
 {
+namespace
+{
+    using Blob = std::shared_ptr<const std::vector<char>>;
+
+    /// A stream reading a decompressed file, keeping the data alive while it is used.
+    struct BlobStream : Files::IMemStream
+    {
+        explicit BlobStream(Blob blob)
+            : Files::MemBuf(blob->data(), blob->size())
+            , Files::IMemStream(blob->data(), blob->size())
+            , mBlob(std::move(blob))
+        {
+        }
+
+        Blob mBlob;
+    };
+
+    /// Least recently used decompressed files of all compressed archives, bounded by a total size in bytes.
+    class DecompressedCache
+    {
+    public:
+        static DecompressedCache& instance()
+        {
+            static DecompressedCache cache;
+            return cache;
+        }
+
+        bool isEnabled() const
+        {
+            return mCapacity > 0;
+        }
+
+        void setCapacity(std::size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCapacity = capacity;
+            trim();
+        }
+
+        Blob get(const CompressedBSAFile* archive, std::uint32_t offset)
+        {
+            if (!isEnabled())
+                return nullptr;
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mIndex.find(Key {archive, offset});
+            if (it == mIndex.end())
+                return nullptr;
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            return it->second->mBlob;
+        }
+
+        void insert(const CompressedBSAFile* archive, std::uint32_t offset, Blob blob)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (blob->size() > mCapacity)
+                return;
+            const Key key {archive, offset};
+            // Another thread may have decompressed the same file meanwhile
+            if (mIndex.count(key) != 0)
+                return;
+            mSize += blob->size();
+            mEntries.push_front(Entry {key, std::move(blob)});
+            mIndex.emplace(key, mEntries.begin());
+            trim();
+        }
+
+        void erase(const CompressedBSAFile* archive)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto it = mEntries.begin(); it != mEntries.end();)
+            {
+                if (it->mKey.first == archive)
+                {
+                    mSize -= it->mBlob->size();
+                    mIndex.erase(it->mKey);
+                    it = mEntries.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+
+    private:
+        using Key = std::pair<const CompressedBSAFile*, std::uint32_t>;
+
+        struct Entry
+        {
+            Key mKey;
+            Blob mBlob;
+        };
+
+        std::mutex mMutex;
+        std::atomic<std::size_t> mCapacity {0};
+        std::size_t mSize = 0;
+        // Most recently used first
+        std::list<Entry> mEntries;
+        std::map<Key, std::list<Entry>::iterator> mIndex;
+
+        void trim()
+        {
+            while (mSize > mCapacity)
+            {
+                mSize -= mEntries.back().mBlob->size();
+                mIndex.erase(mEntries.back().mKey);
+                mEntries.pop_back();
+            }
+        }
+    };
+}
+
 //special marker for invalid records,
 //equal to max uint32_t value
 const uint32_t CompressedBSAFile::sInvalidOffset = std::numeric_limits<uint32_t>::max();
@@ -112,7 +225,10 @@ CompressedBSAFile::CompressedBSAFile()
     : mCompressedByDefault(false), mEmbeddedFileNames(false)
 { }
 
-CompressedBSAFile::~CompressedBSAFile() = default;
+CompressedBSAFile::~CompressedBSAFile()
+{
+    DecompressedCache::instance().erase(this);
+}
 
 /// Read header information from the input source
 void CompressedBSAFile::readHeader()
@@ -351,11 +467,40 @@ Files::IStreamPtr CompressedBSAFile::getFile(const char* file)
 }
 
 Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
+{
+    DecompressedCache& cache = DecompressedCache::instance();
+    Blob blob = cache.get(this, fileRecord.offset);
+    if (blob == nullptr)
+    {
+        blob = decompress(fileRecord);
+        cache.insert(this, fileRecord.offset, blob);
+    }
+    return std::make_shared<BlobStream>(std::move(blob));
+}
+
+void CompressedBSAFile::prefetch(const FileStruct* file)
+{
+    DecompressedCache& cache = DecompressedCache::instance();
+    if (!cache.isEnabled())
+        return;
+    FileRecord fileRec = getFileRecord(file->name());
+    if (!fileRec.isValid())
+        fail("File not found: " + std::string(file->name()));
+    if (cache.get(this, fileRec.offset) == nullptr)
+        cache.insert(this, fileRec.offset, decompress(fileRec));
+}
+
+void CompressedBSAFile::setCacheSize(std::size_t bytes)
+{
+    DecompressedCache::instance().setCapacity(bytes);
+}
+
+std::shared_ptr<const std::vector<char>> CompressedBSAFile::decompress(const FileRecord& fileRecord)
 {
     size_t size = fileRecord.getSizeWithoutCompressionFlag();
     size_t uncompressedSize = size;
     bool compressed = fileRecord.isCompressed(mCompressedByDefault);
-    Files::IStreamPtr streamPtr = Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, size);
+    Files::IStreamPtr streamPtr = openRegion(fileRecord.offset, size);
     std::istream* fileStream = streamPtr.get();
     if (mEmbeddedFileNames)
     {
@@ -370,7 +515,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
         fileStream->read(reinterpret_cast<char*>(&uncompressedSize), sizeof(uint32_t));
         size -= sizeof(uint32_t);
     }
-    std::shared_ptr<Bsa::MemoryInputStream> memoryStreamPtr = std::make_shared<MemoryInputStream>(uncompressedSize);
+    auto data = std::make_shared<std::vector<char>>(uncompressedSize);
 
     if (compressed)
     {
@@ -380,7 +525,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
             inputStreamBuf.push(boost::iostreams::zlib_decompressor());
             inputStreamBuf.push(*fileStream);
 
-            boost::iostreams::basic_array_sink<char> sr(memoryStreamPtr->getRawData(), uncompressedSize);
+            boost::iostreams::basic_array_sink<char> sr(data->data(), uncompressedSize);
             boost::iostreams::copy(inputStreamBuf, sr);
         }
         else // SSE: lz4
@@ -390,7 +535,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
             LZ4F_decompressionContext_t context = nullptr;
             LZ4F_createDecompressionContext(&context, LZ4F_VERSION);
             LZ4F_decompressOptions_t options = {};
-            LZ4F_errorCode_t errorCode = LZ4F_decompress(context, memoryStreamPtr->getRawData(), &uncompressedSize, buffer.get(), &size, &options);
+            LZ4F_errorCode_t errorCode = LZ4F_decompress(context, data->data(), &uncompressedSize, buffer.get(), &size, &options);
             if (LZ4F_isError(errorCode))
                 fail("LZ4 decompression error (file " + mFilename + "): " + LZ4F_getErrorName(errorCode));
             errorCode = LZ4F_freeDecompressionContext(context);
@@ -400,10 +545,10 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
     }
     else
     {
-        fileStream->read(memoryStreamPtr->getRawData(), size);
+        fileStream->read(data->data(), size);
     }
 
-    return std::shared_ptr<std::istream>(memoryStreamPtr, (std::istream*)memoryStreamPtr.get());
+    return data;
 }
 
 BsaVersion CompressedBSAFile::detectVersion(const std::string& filePath)
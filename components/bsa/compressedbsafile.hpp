@@ -27,6 +27,8 @@
 #define BSA_COMPRESSED_BSA_FILE_H
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <components/bsa/bsa_file.hpp>
 
@@ -84,6 +86,7 @@ namespace Bsa
         /// \brief Normalizes given filename or folder and generates format-compatible hash. See https://en.uesp.net/wiki/Tes4Mod:Hash_Calculation.
         static std::uint64_t generateHash(std::string stem, std::string extension) ;
         Files::IStreamPtr getFile(const FileRecord& fileRecord);
+        std::shared_ptr<const std::vector<char>> decompress(const FileRecord& fileRecord);
     public:
         CompressedBSAFile();
         virtual ~CompressedBSAFile();
@@ -96,6 +99,14 @@ namespace Bsa
        
         Files::IStreamPtr getFile(const char* filePath);
         Files::IStreamPtr getFile(const FileStruct* fileStruct);
+
+        /// Decompress the given file into the cache ahead of time, does nothing if the cache is disabled.
+        /// @note May be called from several threads at once.
+        void prefetch(const FileStruct* fileStruct);
+
+        /// Set the total size in bytes of decompressed files kept in memory by all compressed archives, 0 disables caching.
+        static void setCacheSize(std::size_t bytes);
+
         void addFile(const std::string& filename, std::istream& file) override;
     };
 }
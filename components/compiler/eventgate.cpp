@@ -0,0 +1,73 @@
+#include "eventgate.hpp"
+
+#include "generator.hpp"
+#include "opcodes.hpp"
+
+namespace
+{
+    // Opcodes of the generator used by the conditions of if blocks
+    const Interpreter::Type_Code opFetchIntLiteral = Compiler::Generator::segment5 (4);
+    const Interpreter::Type_Code opSkipOnNonZero = Compiler::Generator::segment5 (25);
+    const Interpreter::Type_Code opEqualInt = Compiler::Generator::segment5 (26);
+    const Interpreter::Type_Code opNonEqualInt = Compiler::Generator::segment5 (27);
+
+    bool isSegment0 (Interpreter::Type_Code code, unsigned int opcode)
+    {
+        return (code >> 30) == 0 && (code >> 24) == opcode;
+    }
+}
+
+namespace Compiler
+{
+    EventGate getEventGate (const std::vector<Interpreter::Type_Code>& code)
+    {
+        if (code.size() < 4)
+            return EventGate::None;
+
+        const std::size_t opcodes = code[0];
+        const std::size_t intLiterals = code[1];
+        if (code.size() < 4 + opcodes + intLiterals)
+            return EventGate::None;
+
+        const Interpreter::Type_Code* block = code.data() + 4;
+
+        // if ( function ) or if ( function == literal ), followed by a skip over the jump past the block
+        std::size_t conditionSize = 0;
+        if (opcodes >= 3 && block[1] == opSkipOnNonZero)
+            conditionSize = 1;
+        else if (opcodes >= 6 && block[4] == opSkipOnNonZero)
+            conditionSize = 4;
+        else
+            return EventGate::None;
+
+        // the block has to reach the end of the script, so there is no else branch and no code after it
+        const Interpreter::Type_Code jump = block[conditionSize + 1];
+        if (!isSegment0 (jump, 1) || conditionSize + 1 + (jump & 0xffffff) < opcodes)
+            return EventGate::None;
+
+        bool expected = true;
+        if (conditionSize == 4)
+        {
+            if (!isSegment0 (block[1], 0) || block[2] != opFetchIntLiteral
+                || (block[3] != opEqualInt && block[3] != opNonEqualInt))
+                return EventGate::None;
+
+            const std::size_t literal = block[1] & 0xffffff;
+            if (literal >= intLiterals)
+                return EventGate::None;
+
+            const int value = static_cast<int> (block[opcodes + literal]);
+            if (value != 0 && value != 1)
+                return EventGate::None;
+
+            expected = (value == 1) == (block[3] == opEqualInt);
+        }
+
+        if (block[0] == Generator::segment5 (Misc::opcodeOnActivate))
+            return expected ? EventGate::OnActivate : EventGate::None;
+        if (block[0] == Generator::segment5 (Misc::opcodeMenuMode))
+            return expected ? EventGate::MenuMode : EventGate::NotMenuMode;
+
+        return EventGate::None;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef COMPILER_EVENTGATE_H_INCLUDED
+#define COMPILER_EVENTGATE_H_INCLUDED
+
+#include <vector>
+
+#include <components/interpreter/types.hpp>
+
+namespace Compiler
+{
+    /// \brief Condition all of the code of a script depends on
+    ///
+    /// A script whose body is a single if block on one of these conditions doesn't do anything while the condition
+    /// doesn't hold, so it doesn't have to run until the condition changes.
+    enum class EventGate
+    {
+        None,
+        OnActivate, ///< if ( OnActivate ) / if ( OnActivate == 1 )
+        MenuMode, ///< if ( MenuMode ) / if ( MenuMode == 1 )
+        NotMenuMode ///< if ( MenuMode == 0 )
+    };
+
+    EventGate getEventGate (const std::vector<Interpreter::Type_Code>& code);
+    ///< Find the condition the compiled script \a code is gated on.
+}
+
+#endif
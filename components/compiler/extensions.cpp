@@ -3,6 +3,8 @@
 #include <cassert>
 #include <stdexcept>
 
+#include <components/misc/hash.hpp>
+
 #include "generator.hpp"
 #include "literals.hpp"
 
@@ -207,4 +209,32 @@ namespace Compiler
         for (const auto & mKeyword : mKeywords)
             keywords.push_back (mKeyword.first);
     }
+
+    std::size_t Extensions::getHash() const
+    {
+        std::size_t hash = 0;
+        for (const auto& [keyword, index] : mKeywords)
+        {
+            Misc::hashCombine (hash, keyword);
+            Misc::hashCombine (hash, index);
+        }
+        for (const auto& [index, function] : mFunctions)
+        {
+            Misc::hashCombine (hash, index);
+            Misc::hashCombine (hash, function.mReturn);
+            Misc::hashCombine (hash, function.mArguments);
+            Misc::hashCombine (hash, function.mCode);
+            Misc::hashCombine (hash, function.mCodeExplicit);
+            Misc::hashCombine (hash, function.mSegment);
+        }
+        for (const auto& [index, instruction] : mInstructions)
+        {
+            Misc::hashCombine (hash, index);
+            Misc::hashCombine (hash, instruction.mArguments);
+            Misc::hashCombine (hash, instruction.mCode);
+            Misc::hashCombine (hash, instruction.mCodeExplicit);
+            Misc::hashCombine (hash, instruction.mSegment);
+        }
+        return hash;
+    }
 }
@@ -109,6 +109,9 @@ namespace Compiler
 
             void listKeywords (std::vector<std::string>& keywords) const;
             ///< Append all known keywords to \a kaywords.
+
+            std::size_t getHash() const;
+            ///< Hash of all registered keywords, functions and instructions, changes when the generated code would.
     };
 }
 
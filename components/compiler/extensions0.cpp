@@ -339,6 +339,10 @@ namespace Compiler
             extensions.registerInstruction ("togglerecastmesh", "", opcodeToggleRecastMesh);
             extensions.registerInstruction ("help", "", opcodeHelp);
             extensions.registerInstruction ("reloadlua", "", opcodeReloadLua);
+            extensions.registerInstruction ("togglescriptprofiler", "", opcodeToggleScriptProfiler);
+            extensions.registerInstruction ("tsp", "", opcodeToggleScriptProfiler);
+            extensions.registerInstruction ("scriptprofile", "", opcodeScriptProfile);
+            extensions.registerInstruction ("traceframes", "", opcodeTraceFrames);
         }
     }
 
@@ -30,7 +30,10 @@ namespace Compiler
         text << "line " << loc.mLine+1 << ", column " << loc.mColumn+1
              << " (" << loc.mLiteral << "): " << message;
 
-        Log(logLevel) << text.str();
+        if (mBuffer != nullptr)
+            mBuffer->emplace_back(logLevel, text.str());
+        else
+            Log(logLevel) << text.str();
     }
 
     // Report a file related error
@@ -53,7 +56,10 @@ namespace Compiler
 
         text << "file: " << message << std::endl;
 
-        Log(logLevel) << text.str();
+        if (mBuffer != nullptr)
+            mBuffer->emplace_back(logLevel, text.str());
+        else
+            Log(logLevel) << text.str();
     }
 
     void StreamErrorHandler::setContext(const std::string &context)
@@ -61,6 +67,11 @@ namespace Compiler
         mContext = context;
     }
 
+    void StreamErrorHandler::setBuffer(Messages* buffer)
+    {
+        mBuffer = buffer;
+    }
+
     StreamErrorHandler::StreamErrorHandler() = default;
 
     ContextOverride::ContextOverride(StreamErrorHandler& handler, const std::string& context) : mHandler(handler), mContext(handler.mContext)
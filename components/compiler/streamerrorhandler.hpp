@@ -2,6 +2,11 @@
 #define COMPILER_STREAMERRORHANDLER_H_INCLUDED
 
 #include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <components/debug/debuglog.hpp>
 
 #include "errorhandler.hpp"
 
@@ -12,7 +17,14 @@ namespace Compiler
 
     class StreamErrorHandler : public ErrorHandler
     {
+        public:
+
+            typedef std::vector<std::pair<Debug::Level, std::string>> Messages;
+
+        private:
+
             std::string mContext;
+            Messages* mBuffer = nullptr;
 
             friend class ContextOverride;
         // not implemented
@@ -30,6 +42,9 @@ namespace Compiler
 
             void setContext(const std::string& context);
 
+            void setBuffer(Messages* buffer);
+            ///< Keep the messages in \a buffer instead of logging them, nullptr to log them again.
+
         // constructors
 
             StreamErrorHandler ();
@@ -14,6 +14,7 @@
 #include <stdbool.h>
 #include <sys/ptrace.h>
 
+#include <components/debug/asynclog.hpp>
 #include <components/debug/debuglog.hpp>
 
 #include <boost/filesystem/fstream.hpp>
@@ -249,6 +250,9 @@ static void crash_catcher(int signum, siginfo_t *siginfo, void *context)
         return;
     }
 
+    // Best effort to write the messages logged right before the crash, they are the most useful ones
+    Debug::flushLog();
+
     safe_write(STDERR_FILENO, fatal_err, sizeof(fatal_err)-1);
     if(pipe(fd) == -1)
     {
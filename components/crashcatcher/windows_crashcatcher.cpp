@@ -6,6 +6,8 @@
 #include <sstream>
 #include <thread>
 
+#include <components/debug/asynclog.hpp>
+
 #include "windows_crashmonitor.hpp"
 #include "windows_crashshm.hpp"
 #include <SDL_messagebox.h>
@@ -184,6 +186,8 @@ namespace Crash
 
     void CrashCatcher::handleVectoredException(PEXCEPTION_POINTERS info)
     {
+        Debug::flushLog();
+
         shmLock();
 
         mShm->mEvent = CrashSHM::Event::Crashed;
@@ -0,0 +1,197 @@
+#include "asynclog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "debuglog.hpp"
+
+namespace Debug
+{
+    /// Bounded multi-producer multi-consumer queue by Dmitry Vyukov. Each cell has a sequence number telling whether
+    /// it is ready to be written or read at the given position, so producers only compete for the position.
+    struct AsyncLog::Queue
+    {
+        struct Cell
+        {
+            std::atomic<std::size_t> mSequence;
+            std::string mMessage;
+        };
+
+        const std::size_t mMask;
+        std::unique_ptr<Cell[]> mCells;
+        alignas(64) std::atomic<std::size_t> mEnqueuePosition {0};
+        alignas(64) std::atomic<std::size_t> mDequeuePosition {0};
+        alignas(64) std::atomic<std::size_t> mDropped {0};
+        std::size_t mReportedDropped = 0;
+        std::atomic_bool mStopping {false};
+        std::mutex mMutex;
+        std::condition_variable mHasMessages;
+        std::mutex mWriteMutex;
+        std::thread mThread;
+
+        explicit Queue(std::size_t capacity)
+            : mMask(capacity - 1)
+            , mCells(new Cell[capacity])
+        {
+            for (std::size_t i = 0; i < capacity; ++i)
+                mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool push(std::string&& message)
+        {
+            std::size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true)
+            {
+                cell = &mCells[position & mMask];
+                const std::size_t sequence = cell->mSequence.load(std::memory_order_acquire);
+                const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (difference == 0)
+                {
+                    if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                    position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+            cell->mMessage = std::move(message);
+            cell->mSequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(std::string& message)
+        {
+            std::size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true)
+            {
+                cell = &mCells[position & mMask];
+                const std::size_t sequence = cell->mSequence.load(std::memory_order_acquire);
+                const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+                if (difference == 0)
+                {
+                    if (mDequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = mDequeuePosition.load(std::memory_order_relaxed);
+            }
+            message = std::move(cell->mMessage);
+            cell->mMessage.clear();
+            cell->mSequence.store(position + mMask + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool isEmpty() const
+        {
+            return mDequeuePosition.load(std::memory_order_relaxed) == mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+
+        /// Writes all the queued messages, only one thread at a time writes to keep their order.
+        void write()
+        {
+            const std::lock_guard<std::mutex> lock(mWriteMutex);
+            writeUnlocked();
+        }
+
+        void writeUnlocked()
+        {
+            // Each message is flushed on its own, the output expects the level marker at the beginning of a write
+            std::string message;
+            while (pop(message))
+                std::cout << message << std::flush;
+            const std::size_t dropped = mDropped.load(std::memory_order_relaxed);
+            if (dropped != mReportedDropped)
+            {
+                if (CurrentDebugLevel != NoLevel)
+                    std::cout << static_cast<unsigned char>(Warning);
+                std::cout << dropped - mReportedDropped << " log messages were dropped because the log queue was full\n" << std::flush;
+                mReportedDropped = dropped;
+            }
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                write();
+                if (mStopping.load(std::memory_order_acquire) && isEmpty())
+                    break;
+                std::unique_lock<std::mutex> lock(mMutex);
+                // Producers don't lock the mutex, the timeout covers a notification sent before waiting
+                mHasMessages.wait_for(lock, std::chrono::milliseconds(10),
+                    [&] { return !isEmpty() || mStopping.load(std::memory_order_acquire); });
+            }
+        }
+    };
+
+    namespace
+    {
+        std::atomic<AsyncLog::Queue*> sQueue {nullptr};
+    }
+
+    AsyncLog::AsyncLog(std::size_t capacity)
+    {
+        std::size_t powerOfTwo = 2;
+        while (powerOfTwo < capacity)
+            powerOfTwo *= 2;
+        mQueue = std::make_unique<Queue>(powerOfTwo);
+        AsyncLog::Queue* expected = nullptr;
+        if (!sQueue.compare_exchange_strong(expected, mQueue.get()))
+            throw std::logic_error("Only one AsyncLog may exist at a time");
+        mQueue->mThread = std::thread([queue = mQueue.get()] { queue->run(); });
+    }
+
+    AsyncLog::~AsyncLog()
+    {
+        sQueue.store(nullptr);
+        mQueue->mStopping.store(true, std::memory_order_release);
+        mQueue->mHasMessages.notify_one();
+        mQueue->mThread.join();
+        // Messages pushed by threads which have seen the queue before it was unset. Threads still logging at this
+        // point are expected to be joined already.
+        mQueue->write();
+    }
+
+    bool writeAsyncLog(std::string&& message)
+    {
+        AsyncLog::Queue* const queue = sQueue.load(std::memory_order_acquire);
+        if (queue == nullptr)
+            return false;
+        if (queue->push(std::move(message)))
+            queue->mHasMessages.notify_one();
+        return true;
+    }
+
+    void flushLog()
+    {
+        if (AsyncLog::Queue* const queue = sQueue.load(std::memory_order_acquire))
+        {
+            // The writer thread may be the crashed one holding the lock, write anyway then
+            const std::unique_lock<std::mutex> lock(queue->mWriteMutex, std::try_to_lock);
+            queue->writeUnlocked();
+        }
+        else
+            std::cout.flush();
+    }
+
+    std::size_t getDroppedLogMessages()
+    {
+        if (AsyncLog::Queue* const queue = sQueue.load(std::memory_order_acquire))
+            return queue->mDropped.load(std::memory_order_relaxed);
+        return 0;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef DEBUG_ASYNCLOG_H
+#define DEBUG_ASYNCLOG_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace Debug
+{
+    /// While alive, log messages are put into a bounded lock-free queue and written to std::cout by a background
+    /// thread, so logging threads don't wait for each other or for the output. Messages not fitting into the queue
+    /// are dropped and the number of dropped ones is logged. Without an instance Log writes synchronously.
+    /// @note Only one instance may exist at a time.
+    class AsyncLog
+    {
+    public:
+        explicit AsyncLog(std::size_t capacity = 8192);
+
+        AsyncLog(const AsyncLog&) = delete;
+
+        AsyncLog& operator=(const AsyncLog&) = delete;
+
+        /// Writes the remaining messages and stops the thread.
+        ~AsyncLog();
+
+        struct Queue;
+
+    private:
+        std::unique_ptr<Queue> mQueue;
+    };
+
+    /// Puts a complete message into the queue of the running AsyncLog. Returns false if there is none.
+    bool writeAsyncLog(std::string&& message);
+
+    /// Writes the queued messages from the calling thread, for the crash handlers to not lose the last messages.
+    void flushLog();
+
+    /// Number of messages dropped because the queue was full.
+    std::size_t getDroppedLogMessages();
+}
+
+#endif
@@ -6,6 +6,8 @@
 
 #include <components/crashcatcher/crashcatcher.hpp>
 
+#include "asynclog.hpp"
+
 #ifdef _WIN32
 #   include <components/crashcatcher/windows_crashcatcher.hpp>
 #   undef WIN32_LEAN_AND_MEAN
@@ -197,6 +199,9 @@ int wrapApplication(int (*innerApplication)(int argc, char *argv[]), int argc, c
             setupLogging(cfgMgr.getLogPath().string(), appName, mode);
         }
 
+        // Logging threads only queue their messages from now on, they are written until the application returns
+        const Debug::AsyncLog asyncLog;
+
 #if defined(_WIN32)
         const std::string crashLogName = Misc::StringUtils::lowerCase(appName) + "-crash.dmp";
         Crash::CrashCatcher crashy(argc, argv, (cfgMgr.getLogPath() / crashLogName).make_preferred().string());
@@ -1,8 +1,23 @@
 #include "debuglog.hpp"
 
+#include <mutex>
+
+#include "asynclog.hpp"
+
 namespace Debug
 {
     Level CurrentDebugLevel = Level::NoLevel;
-}
 
-std::mutex Log::sLock;
+    namespace
+    {
+        std::mutex sLock;
+    }
+
+    void writeLog(std::string&& message)
+    {
+        if (writeAsyncLog(std::move(message)))
+            return;
+        const std::lock_guard<std::mutex> lock(sLock);
+        std::cout << message << std::flush;
+    }
+}
@@ -1,8 +1,11 @@
 #ifndef DEBUG_LOG_H
 #define DEBUG_LOG_H
 
-#include <mutex>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
 
 namespace Debug
 {
@@ -19,50 +22,52 @@ namespace Debug
     };
 
     extern Level CurrentDebugLevel;
+
+    /// Writes a complete message, through the queue of the AsyncLog if there is one.
+    void writeLog(std::string&& message);
 }
 
 class Log
 {
-    static std::mutex sLock;
-
-    std::unique_lock<std::mutex> mLock;
 public:
     explicit Log(Debug::Level level)
         : mShouldLog(level <= Debug::CurrentDebugLevel)
     {
-        // No need to hold the lock if there will be no logging anyway
+        // No need to format anything if there will be no logging anyway
         if (!mShouldLog)
             return;
 
-        // Locks a global lock while the object is alive
-        mLock = std::unique_lock<std::mutex>(sLock);
+        mStream.emplace();
 
         // If the app has no logging system enabled, log level is not specified.
         // Show all messages without marker - we just use the plain cout in this case.
         if (Debug::CurrentDebugLevel == Debug::NoLevel)
             return;
 
-        std::cout << static_cast<unsigned char>(level);
+        *mStream << static_cast<unsigned char>(level);
     }
 
-    // Perfect forwarding wrappers to give the chain of objects to cout
+    // Perfect forwarding wrappers to give the chain of objects to the message
     template<typename T>
     Log& operator<<(T&& rhs)
     {
         if (mShouldLog)
-            std::cout << std::forward<T>(rhs);
+            *mStream << std::forward<T>(rhs);
 
         return *this;
     }
 
     ~Log()
     {
-        if (mShouldLog)
-            std::cout << std::endl;
+        if (!mShouldLog)
+            return;
+        *mStream << '\n';
+        Debug::writeLog(mStream->str());
     }
 
 private:
     const bool mShouldLog;
+    std::optional<std::ostringstream> mStream;
 };
 
 #endif
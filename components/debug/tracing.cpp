@@ -0,0 +1,153 @@
+#include "tracing.hpp"
+
+#include <fstream>
+#include <ostream>
+
+#include "debuglog.hpp"
+
+namespace Debug
+{
+    namespace
+    {
+        std::size_t getThreadIndex()
+        {
+            static std::atomic_size_t nextIndex {1};
+            thread_local const std::size_t index = nextIndex++;
+            return index;
+        }
+
+        void writeString(std::ostream& stream, std::string_view value)
+        {
+            static const char hexDigits[] = "0123456789abcdef";
+            stream << '"';
+            for (const char c : value)
+            {
+                switch (c)
+                {
+                    case '"': stream << "\\\""; break;
+                    case '\\': stream << "\\\\"; break;
+                    case '\n': stream << "\\n"; break;
+                    case '\t': stream << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20)
+                            stream << "\\u00" << hexDigits[c >> 4] << hexDigits[c & 0xf];
+                        else
+                            stream << c;
+                }
+            }
+            stream << '"';
+        }
+
+        long long toMicroseconds(std::chrono::steady_clock::duration value)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(value).count();
+        }
+    }
+
+    Tracer& Tracer::instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void Tracer::enable(std::size_t maxEvents)
+    {
+        {
+            std::lock_guard lock(mMutex);
+            mMaxEvents = maxEvents;
+        }
+        mEnabled = true;
+    }
+
+    void Tracer::setMaxFrames(std::size_t frames)
+    {
+        std::lock_guard lock(mMutex);
+        mMaxFrames = frames;
+        mFrameStarts.clear();
+    }
+
+    std::size_t Tracer::getMaxFrames() const
+    {
+        std::lock_guard lock(mMutex);
+        return mMaxFrames;
+    }
+
+    void Tracer::beginFrame()
+    {
+        if (!isEnabled())
+            return;
+        std::lock_guard lock(mMutex);
+        if (mMaxFrames == 0)
+            return;
+        mFrameStarts.push_back(mEvents.size());
+        if (mFrameStarts.size() <= mMaxFrames)
+            return;
+        mFrameStarts.pop_front();
+        const std::size_t dropped = mFrameStarts.front();
+        mEvents.erase(mEvents.begin(), mEvents.begin() + static_cast<std::ptrdiff_t>(dropped));
+        for (std::size_t& start : mFrameStarts)
+            start -= dropped;
+    }
+
+    void Tracer::addEvent(std::string_view name, Clock::time_point begin, Clock::time_point end)
+    {
+        const std::size_t thread = getThreadIndex();
+        std::lock_guard lock(mMutex);
+        if (mEvents.size() >= mMaxEvents)
+        {
+            ++mDroppedEvents;
+            return;
+        }
+        mEvents.push_back(Event {std::string(name), begin, end - begin, thread});
+    }
+
+    void Tracer::setThreadName(std::string_view name)
+    {
+        const std::size_t thread = getThreadIndex();
+        std::lock_guard lock(mMutex);
+        mThreadNames.emplace_back(thread, name);
+    }
+
+    void Tracer::write(std::ostream& stream) const
+    {
+        std::lock_guard lock(mMutex);
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto& [thread, name] : mThreadNames)
+        {
+            if (!first)
+                stream << ',';
+            first = false;
+            stream << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":";
+            writeString(stream, name);
+            stream << "}}";
+        }
+        for (const Event& event : mEvents)
+        {
+            if (!first)
+                stream << ',';
+            first = false;
+            stream << "\n{\"name\":";
+            writeString(stream, event.mName);
+            stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.mThread
+                   << ",\"ts\":" << toMicroseconds(event.mBegin - mStart)
+                   << ",\"dur\":" << toMicroseconds(event.mDuration) << '}';
+        }
+        stream << "\n]}\n";
+    }
+
+    void Tracer::write(const std::string& path) const
+    {
+        std::ofstream stream(path);
+        write(stream);
+        if (!stream)
+        {
+            Log(Debug::Error) << "Failed to write trace to \"" << path << "\"";
+            return;
+        }
+        std::lock_guard lock(mMutex);
+        Log(Debug::Info) << "Trace with " << mEvents.size() << " events written to \"" << path << "\"";
+        if (mDroppedEvents > 0)
+            Log(Debug::Warning) << mDroppedEvents << " trace events were dropped";
+    }
+}
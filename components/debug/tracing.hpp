@@ -0,0 +1,98 @@
+#ifndef DEBUG_TRACING_H
+#define DEBUG_TRACING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Debug
+{
+    /// Records the durations of nested phases of the program on all threads. The trace is written in the Chrome
+    /// trace event format, which can be opened with chrome://tracing or https://ui.perfetto.dev.
+    /// @note Thread safe. Recording does nothing but check a flag until the tracer is enabled.
+    class Tracer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static Tracer& instance();
+
+        /// Start recording. Events beyond maxEvents are dropped, to bound the memory used by long sessions.
+        void enable(std::size_t maxEvents = 1000000);
+
+        bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+        /// Keep only the events of the last given number of frames, 0 keeps all of them.
+        void setMaxFrames(std::size_t frames);
+
+        std::size_t getMaxFrames() const;
+
+        /// Start the next frame, dropping the events of the oldest frame beyond the maximum number of frames.
+        void beginFrame();
+
+        void addEvent(std::string_view name, Clock::time_point begin, Clock::time_point end);
+
+        /// Name the calling thread in the trace.
+        void setThreadName(std::string_view name);
+
+        void write(std::ostream& stream) const;
+
+        /// Write the trace to the given file, logging an error if it can't be written.
+        void write(const std::string& path) const;
+
+    private:
+        struct Event
+        {
+            std::string mName;
+            Clock::time_point mBegin;
+            Clock::duration mDuration;
+            std::size_t mThread;
+        };
+
+        std::atomic_bool mEnabled {false};
+        const Clock::time_point mStart = Clock::now();
+        mutable std::mutex mMutex;
+        std::size_t mMaxEvents = 0;
+        std::size_t mDroppedEvents = 0;
+        std::size_t mMaxFrames = 0;
+        std::deque<Event> mEvents;
+        std::deque<std::size_t> mFrameStarts;
+        std::vector<std::pair<std::size_t, std::string>> mThreadNames;
+
+        Tracer() = default;
+    };
+
+    /// Record the time between construction and destruction as a phase.
+    class ScopedTrace
+    {
+    public:
+        explicit ScopedTrace(std::string_view name)
+        {
+            if (!Tracer::instance().isEnabled())
+                return;
+            mName = name;
+            mBegin = Tracer::Clock::now();
+        }
+
+        ~ScopedTrace()
+        {
+            if (mBegin != Tracer::Clock::time_point())
+                Tracer::instance().addEvent(mName, mBegin, Tracer::Clock::now());
+        }
+
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    private:
+        std::string mName;
+        Tracer::Clock::time_point mBegin;
+    };
+}
+
+#endif
@@ -8,7 +8,8 @@
 #include "dbrefgeometryobject.hpp"
 
 #include <components/debug/debuglog.hpp>
-#include <components/misc/thread.hpp>
+#include <components/debug/tracing.hpp>
+#include <components/misc/threadbudget.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 
 #include <DetourNavMesh.h>
@@ -43,7 +44,8 @@ namespace DetourNavigator
         auto getPriority(const Job& job) noexcept
         {
             return std::make_tuple(-static_cast<std::underlying_type_t<JobState>>(job.mState), job.mProcessTime,
-                                   job.mChangeType, job.mTryNumber, job.mDistanceToPlayer, job.mDistanceToOrigin);
+                                   !job.mDemanded, job.mChangeType, job.mTryNumber, job.mDistanceToPlayer,
+                                   job.mDistanceToOrigin);
         }
 
         struct LessByJobPriority
@@ -62,7 +64,7 @@ namespace DetourNavigator
 
         auto getDbPriority(const Job& job) noexcept
         {
-            return std::make_tuple(static_cast<std::underlying_type_t<JobState>>(job.mState),
+            return std::make_tuple(static_cast<std::underlying_type_t<JobState>>(job.mState), !job.mDemanded,
                                    job.mChangeType, job.mDistanceToPlayer, job.mDistanceToOrigin);
         }
 
@@ -90,7 +92,8 @@ namespace DetourNavigator
             if (db == nullptr)
                 return nullptr;
             return std::make_unique<DbWorker>(updater, std::move(db), TileVersion(settings.mNavMeshVersion),
-                                              settings.mRecast, settings.mWriteToNavMeshDb);
+                                              settings.mRecast, settings.mWriteToNavMeshDb,
+                                              settings.mNavMeshDbWritesPerTransaction);
         }
 
         void updateJobs(std::deque<JobIt>& jobs, TilePosition playerTile, int maxTiles)
@@ -103,6 +106,20 @@ namespace DetourNavigator
             }
         }
 
+        bool isDemanded(const osg::Vec3f& agentHalfExtents, const TilePosition& tile,
+                        const std::map<osg::Vec3f, std::set<TilePosition>>& demandedTiles)
+        {
+            const auto it = demandedTiles.find(agentHalfExtents);
+            return it != demandedTiles.end() && it->second.count(tile) > 0;
+        }
+
+        void updateLatency(double latency, double& value)
+        {
+            // Exponential moving average, reacts within a few dozens of jobs
+            constexpr double weight = 0.05;
+            value = value * (1 - weight) + latency * weight;
+        }
+
         std::size_t getNextJobId()
         {
             static std::atomic_size_t nextJobId {1};
@@ -119,6 +136,7 @@ namespace DetourNavigator
         , mWorldspace(worldspace)
         , mChangedTile(changedTile)
         , mProcessTime(processTime)
+        , mPostTime(std::chrono::steady_clock::now())
         , mChangeType(changeType)
         , mDistanceToPlayer(distanceToPlayer)
         , mDistanceToOrigin(getManhattanDistance(changedTile, TilePosition {0, 0}))
@@ -131,7 +149,7 @@ namespace DetourNavigator
         , mRecastMeshManager(recastMeshManager)
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
-        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize, settings.mAsyncNavMeshUpdaterThreads)
         , mDbWorker(makeDbWorker(*this, std::move(db), mSettings))
     {
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
@@ -184,6 +202,8 @@ namespace DetourNavigator
                 const JobIt it = mJobs.emplace(mJobs.end(), agentHalfExtents, navMeshCacheItem, worldspace,
                     changedTile, changeType, getManhattanDistance(changedTile, playerTile), processTime);
 
+                it->mDemanded = isDemanded(agentHalfExtents, changedTile, mDemandedTiles);
+
                 Log(Debug::Debug) << "Post job " << it->mId << " for agent=(" << it->mAgentHalfExtents << ")"
                     << " changedTile=(" << it->mChangedTile << ")";
 
@@ -208,6 +228,38 @@ namespace DetourNavigator
             mDbWorker->updateJobs(playerTile, maxTiles);
     }
 
+    void AsyncNavMeshUpdater::setDemandedTiles(const osg::Vec3f& agentHalfExtents, std::set<TilePosition>&& tiles)
+    {
+        const std::lock_guard lock(mMutex);
+
+        auto& demanded = mDemandedTiles[agentHalfExtents];
+        if (demanded == tiles)
+            return;
+        demanded = std::move(tiles);
+
+        bool changed = false;
+        for (JobIt job : mWaiting)
+        {
+            if (job->mAgentHalfExtents != agentHalfExtents)
+                continue;
+            const bool value = demanded.count(job->mChangedTile) > 0;
+            changed = changed || value != job->mDemanded;
+            job->mDemanded = value;
+        }
+
+        if (changed)
+            std::sort(mWaiting.begin(), mWaiting.end(), LessByJobPriority {});
+    }
+
+    void AsyncNavMeshUpdater::setEvictedTiles(const osg::Vec3f& agentHalfExtents, std::set<TilePosition>&& tiles)
+    {
+        const auto locked = mEvictedTiles.lock();
+        if (tiles.empty())
+            locked->erase(agentHalfExtents);
+        else
+            (*locked)[agentHalfExtents] = std::move(tiles);
+    }
+
     void AsyncNavMeshUpdater::wait(Loading::Listener& listener, WaitConditionType waitConditionType)
     {
         if (mSettings.get().mWaitUntilMinDistanceToPlayer == 0)
@@ -291,6 +343,10 @@ namespace DetourNavigator
             result.mJobs = mJobs.size();
             result.mWaiting = mWaiting.size();
             result.mPushed = mPushed.size();
+            result.mDemanded = static_cast<std::size_t>(std::count_if(mWaiting.begin(), mWaiting.end(),
+                [] (JobIt job) { return job->mDemanded; }));
+            result.mQueueLatency = mQueueLatency;
+            result.mDemandedQueueLatency = mDemandedQueueLatency;
         }
         result.mProcessing = mProcessingTiles.lockConst()->size();
         if (mDbWorker != nullptr)
@@ -306,6 +362,9 @@ namespace DetourNavigator
         out.setAttribute(frameNumber, "NavMesh Waiting", static_cast<double>(stats.mWaiting));
         out.setAttribute(frameNumber, "NavMesh Pushed", static_cast<double>(stats.mPushed));
         out.setAttribute(frameNumber, "NavMesh Processing", static_cast<double>(stats.mProcessing));
+        out.setAttribute(frameNumber, "NavMesh Demanded", static_cast<double>(stats.mDemanded));
+        out.setAttribute(frameNumber, "NavMesh Latency", stats.mQueueLatency * 1000.0);
+        out.setAttribute(frameNumber, "NavMesh DemandLatency", stats.mDemandedQueueLatency * 1000.0);
 
         if (stats.mDb.has_value())
         {
@@ -322,20 +381,23 @@ namespace DetourNavigator
     void AsyncNavMeshUpdater::process() noexcept
     {
         Log(Debug::Debug) << "Start process navigator jobs by thread=" << std::this_thread::get_id();
-        Misc::setCurrentThreadIdlePriority();
+        const std::shared_ptr<Misc::ThreadUsage> usage
+            = Misc::ThreadBudget::instance().registerCurrentThread(Misc::ThreadGroup::Navigator);
+        Debug::Tracer::instance().setThreadName("Navigator");
         while (!mShouldStop)
         {
             try
             {
                 if (JobIt job = getNextJob(); job != mJobs.end())
                 {
+                    const Misc::ScopedThreadBusy busy(usage.get());
                     const JobStatus status = processJob(*job);
                     Log(Debug::Debug) << "Processed job " << job->mId << " with status=" << status;
                     switch (status)
                     {
                         case JobStatus::Done:
                             unlockTile(job->mAgentHalfExtents, job->mChangedTile);
-                            if (job->mGeneratedNavMeshData != nullptr)
+                            if (!job->mGeneratedNavMeshData.mData.empty())
                                 mDbWorker->enqueueJob(job);
                             else
                                 removeJob(job);
@@ -363,6 +425,7 @@ namespace DetourNavigator
 
     JobStatus AsyncNavMeshUpdater::processJob(Job& job)
     {
+        const Debug::ScopedTrace trace("DetourNavigator::Job");
         Log(Debug::Debug) << "Processing job " << job.mId << " by thread=" << std::this_thread::get_id();
 
         const auto navMeshCacheItem = job.mNavMeshCacheItem.lock();
@@ -380,6 +443,13 @@ namespace DetourNavigator
             return JobStatus::Done;
         }
 
+        if (isEvictedTile(job.mAgentHalfExtents, job.mChangedTile))
+        {
+            Log(Debug::Debug) << "Ignore add tile by job " << job.mId << ": evicted";
+            navMeshCacheItem->lock()->removeTile(job.mChangedTile);
+            return JobStatus::Done;
+        }
+
         switch (job.mState)
         {
             case JobState::Initial:
@@ -498,7 +568,13 @@ namespace DetourNavigator
 
         if (result == JobStatus::Done && job.mChangeType != ChangeType::update
                 && mDbWorker != nullptr && mSettings.get().mWriteToNavMeshDb && generatedNavMeshData)
-            job.mGeneratedNavMeshData = std::make_unique<PreparedNavMeshData>(*preparedNavMeshDataPtr);
+        {
+            job.mGeneratedTileId = job.mCachedTileData.has_value() ? job.mCachedTileData->mTileId
+                                                                   : mDbWorker->reserveTileId();
+            PreparedNavMeshData data(*preparedNavMeshDataPtr);
+            data.mUserId = static_cast<unsigned>(job.mGeneratedTileId);
+            job.mGeneratedNavMeshData = compressTileData(serialize(data), mDbWorker->getTileDataDictionary());
+        }
 
         return result;
     }
@@ -564,10 +640,20 @@ namespace DetourNavigator
             return mJobs.end();
         }
 
+        const auto now = std::chrono::steady_clock::now();
+
         if (job->mChangeType == ChangeType::update)
-            mLastUpdates[getAgentAndTile(*job)] = std::chrono::steady_clock::now();
+            mLastUpdates[getAgentAndTile(*job)] = now;
         mPushed.erase(getAgentAndTile(*job));
 
+        if (!job->mStarted)
+        {
+            job->mStarted = true;
+            // Time spent waiting for the minimal update interval is intended and not counted
+            const auto queued = now - std::max(job->mPostTime, job->mProcessTime);
+            updateLatency(std::chrono::duration<double>(queued).count(), job->mDemanded ? mDemandedQueueLatency : mQueueLatency);
+        }
+
         return job;
     }
 
@@ -614,6 +700,13 @@ namespace DetourNavigator
         mJobs.erase(job);
     }
 
+    bool AsyncNavMeshUpdater::isEvictedTile(const osg::Vec3f& agentHalfExtents, const TilePosition& tile) const
+    {
+        const auto locked = mEvictedTiles.lockConst();
+        const auto it = locked->find(agentHalfExtents);
+        return it != locked->end() && it->second.count(tile) > 0;
+    }
+
     bool AsyncNavMeshUpdater::lockTile(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile)
     {
         Log(Debug::Debug) << "Locking tile agent=(" << agentHalfExtents << ") changedTile=(" << changedTile << ")";
@@ -705,12 +798,14 @@ namespace DetourNavigator
     }
 
     DbWorker::DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db,
-        TileVersion version, const RecastSettings& recastSettings, bool writeToDb)
+        TileVersion version, const RecastSettings& recastSettings, bool writeToDb, std::size_t writesPerTransaction)
         : mUpdater(updater)
         , mRecastSettings(recastSettings)
         , mDb(std::move(db))
         , mVersion(version)
         , mWriteToDb(writeToDb)
+        , mWritesPerTransaction(writesPerTransaction)
+        , mTileDataDictionary(mDb->getTileDataDictionary())
         , mNextTileId(mDb->getMaxTileId() + 1)
         , mNextShapeId(mDb->getMaxShapeId() + 1)
         , mThread([this] { run(); })
@@ -745,7 +840,7 @@ namespace DetourNavigator
 
     void DbWorker::run() noexcept
     {
-        constexpr std::size_t writesPerTransaction = 100;
+        Debug::Tracer::instance().setThreadName("NavigatorDb");
         auto transaction = mDb->startTransaction();
         while (!mShouldStop)
         {
@@ -753,7 +848,7 @@ namespace DetourNavigator
             {
                 if (const auto job = mQueue.pop())
                     processJob(*job);
-                if (mWrites > writesPerTransaction)
+                if (mWrites >= mWritesPerTransaction)
                 {
                     mWrites = 0;
                     transaction.commit();
@@ -770,6 +865,7 @@ namespace DetourNavigator
 
     void DbWorker::processJob(JobIt job)
     {
+        const Debug::ScopedTrace trace("DetourNavigator::DbJob");
         const auto process = [&] (auto f)
         {
             try
@@ -782,7 +878,7 @@ namespace DetourNavigator
             }
         };
 
-        if (job->mGeneratedNavMeshData != nullptr)
+        if (!job->mGeneratedNavMeshData.mData.empty())
         {
             process([&] (JobIt job) { processWritingJob(job); });
             mUpdater.removeJob(job);
@@ -838,11 +934,10 @@ namespace DetourNavigator
             job->mInput = serialize(mRecastSettings, *job->mRecastMesh, objects);
         }
 
-        if (const auto& cachedTileData = job->mCachedTileData)
+        if (job->mCachedTileData.has_value())
         {
             Log(Debug::Debug) << "Update db tile by job " << job->mId;
-            job->mGeneratedNavMeshData->mUserId = cachedTileData->mTileId;
-            mDb->updateTile(cachedTileData->mTileId, mVersion, serialize(*job->mGeneratedNavMeshData));
+            mDb->updateCompressedTile(job->mGeneratedTileId, mVersion, job->mGeneratedNavMeshData);
             return;
         }
 
@@ -853,10 +948,8 @@ namespace DetourNavigator
             return;
         }
 
-        job->mGeneratedNavMeshData->mUserId = mNextTileId;
         Log(Debug::Debug) << "Insert db tile by job " << job->mId;
-        mDb->insertTile(mNextTileId, job->mWorldspace, job->mChangedTile,
-                        mVersion, job->mInput, serialize(*job->mGeneratedNavMeshData));
-        ++mNextTileId.t;
+        mDb->insertCompressedTile(job->mGeneratedTileId, job->mWorldspace, job->mChangedTile,
+                                  mVersion, job->mInput, job->mGeneratedNavMeshData);
     }
 }
@@ -47,7 +47,11 @@ namespace DetourNavigator
         const std::string mWorldspace;
         const TilePosition mChangedTile;
         const std::chrono::steady_clock::time_point mProcessTime;
+        const std::chrono::steady_clock::time_point mPostTime;
         unsigned mTryNumber = 0;
+        // Needed by an actor, see AsyncNavMeshUpdater::setDemandedTiles
+        bool mDemanded = false;
+        bool mStarted = false;
         ChangeType mChangeType;
         int mDistanceToPlayer;
         const int mDistanceToOrigin;
@@ -55,7 +59,9 @@ namespace DetourNavigator
         std::vector<std::byte> mInput;
         std::shared_ptr<RecastMesh> mRecastMesh;
         std::optional<TileData> mCachedTileData;
-        std::unique_ptr<PreparedNavMeshData> mGeneratedNavMeshData;
+        // Serialized and compressed by the generating thread to keep this work off the db thread
+        CompressedTileData mGeneratedNavMeshData;
+        TileId mGeneratedTileId {0};
 
         Job(const osg::Vec3f& agentHalfExtents, std::weak_ptr<GuardedNavMeshCacheItem> navMeshCacheItem,
             std::string_view worldspace, const TilePosition& changedTile, ChangeType changeType, int distanceToPlayer,
@@ -114,7 +120,7 @@ namespace DetourNavigator
         };
 
         DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db,
-            TileVersion version, const RecastSettings& recastSettings, bool writeToDb);
+            TileVersion version, const RecastSettings& recastSettings, bool writeToDb, std::size_t writesPerTransaction);
 
         ~DbWorker();
 
@@ -122,6 +128,12 @@ namespace DetourNavigator
 
         void enqueueJob(JobIt job);
 
+        /// Returns id for a new tile, can be called from any thread
+        TileId reserveTileId() { return TileId {mNextTileId.fetch_add(1)}; }
+
+        /// Returns dictionary to compress new tiles, can be called from any thread
+        const TileDataDictionary* getTileDataDictionary() const { return mTileDataDictionary.get(); }
+
         void updateJobs(TilePosition playerTile, int maxTiles) { mQueue.update(playerTile, maxTiles); }
 
         void stop();
@@ -132,7 +144,9 @@ namespace DetourNavigator
         const std::unique_ptr<NavMeshDb> mDb;
         const TileVersion mVersion;
         const bool mWriteToDb;
-        TileId mNextTileId;
+        const std::size_t mWritesPerTransaction;
+        const std::shared_ptr<const TileDataDictionary> mTileDataDictionary;
+        std::atomic<std::int64_t> mNextTileId;
         ShapeId mNextShapeId;
         DbJobQueue mQueue;
         std::atomic_bool mShouldStop {false};
@@ -159,6 +173,10 @@ namespace DetourNavigator
             std::size_t mPushed = 0;
             std::size_t mProcessing = 0;
             std::size_t mDbGetTileHits = 0;
+            std::size_t mDemanded = 0;
+            // Smoothed time between posting a job and starting to process it, in seconds
+            double mQueueLatency = 0;
+            double mDemandedQueueLatency = 0;
             std::optional<DbWorker::Stats> mDb;
             NavMeshTilesCache::Stats mCache;
         };
@@ -171,6 +189,12 @@ namespace DetourNavigator
             const TilePosition& playerTile, std::string_view worldspace,
             const std::map<TilePosition, ChangeType>& changedTiles);
 
+        /// Process the jobs for these tiles before the others with the same change type, replaces the previous demand
+        void setDemandedTiles(const osg::Vec3f& agentHalfExtents, std::set<TilePosition>&& tiles);
+
+        /// Jobs for these tiles remove them from the navmesh instead of building them, replaces the previous set
+        void setEvictedTiles(const osg::Vec3f& agentHalfExtents, std::set<TilePosition>&& tiles);
+
         void wait(Loading::Listener& listener, WaitConditionType waitConditionType);
 
         Stats getStats() const;
@@ -196,6 +220,10 @@ namespace DetourNavigator
         Misc::ScopeGuarded<std::set<std::tuple<osg::Vec3f, TilePosition>>> mProcessingTiles;
         std::map<std::tuple<osg::Vec3f, TilePosition>, std::chrono::steady_clock::time_point> mLastUpdates;
         std::set<std::tuple<osg::Vec3f, TilePosition>> mPresentTiles;
+        std::map<osg::Vec3f, std::set<TilePosition>> mDemandedTiles;
+        Misc::ScopeGuarded<std::map<osg::Vec3f, std::set<TilePosition>>> mEvictedTiles;
+        double mQueueLatency = 0;
+        double mDemandedQueueLatency = 0;
         std::vector<std::thread> mThreads;
         std::unique_ptr<DbWorker> mDbWorker;
         std::atomic_size_t mDbGetTileHits {0};
@@ -219,6 +247,8 @@ namespace DetourNavigator
 
         void repost(JobIt job);
 
+        bool isEvictedTile(const osg::Vec3f& agentHalfExtents, const TilePosition& tile) const;
+
         bool lockTile(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile);
 
         void unlockTile(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile);
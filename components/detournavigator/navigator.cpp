@@ -3,6 +3,8 @@
 #include "navigatorstub.hpp"
 #include "recastglobalallocator.hpp"
 
+#include <components/debug/tracing.hpp>
+
 namespace DetourNavigator
 {
     std::unique_ptr<Navigator> makeNavigator(const Settings& settings, const std::string& userDataPath)
@@ -11,7 +13,10 @@ namespace DetourNavigator
 
         std::unique_ptr<NavMeshDb> db;
         if (settings.mEnableNavMeshDiskCache)
-            db = std::make_unique<NavMeshDb>(userDataPath + "/navmesh.db");
+        {
+            const Debug::ScopedTrace trace("Open navmesh database");
+            db = std::make_unique<NavMeshDb>(userDataPath + "/navmesh.db", settings.mNavMeshDbCacheSize);
+        }
 
         return std::make_unique<NavigatorImpl>(settings, std::move(db));
     }
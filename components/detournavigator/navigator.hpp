@@ -11,6 +11,7 @@
 #include <components/resource/bulletshape.hpp>
 
 #include <string_view>
+#include <vector>
 
 namespace ESM
 {
@@ -26,6 +27,7 @@ namespace Loading
 namespace DetourNavigator
 {
     struct Settings;
+    class PathCache;
 
     struct ObjectShapes
     {
@@ -53,6 +55,13 @@ namespace DetourNavigator
         {}
     };
 
+    struct ObjectUpdate
+    {
+        ObjectId mId;
+        ObjectShapes mShapes;
+        btTransform mTransform;
+    };
+
     /**
      * @brief Top level interface of detournavigator component. Navigator allows to build a scene with navmesh and find
      * a path for an agent there. Scene contains agents, geometry objects and water. Agent are distinguished only by
@@ -125,6 +134,15 @@ namespace DetourNavigator
          */
         virtual bool updateObject(const ObjectId id, const DoorShapes& shapes, const btTransform& transform) = 0;
 
+        /**
+         * @brief updateObjects replaces geometry of several objects at once, e.g. of all objects moved in a frame.
+         * Objects moved by less than a recast cell since they were last changed are skipped, they wouldn't change
+         * the navmesh. When an object is given more than once, only its last update is used.
+         * @param updates shape members must live until object is updated by another shape or removed from Navigator.
+         * @return true if any object is updated.
+         */
+        virtual bool updateObjects(const std::vector<ObjectUpdate>& updates) = 0;
+
         /**
          * @brief removeObject to make it no more available at the scene.
          * @param id is used to find object.
@@ -170,6 +188,19 @@ namespace DetourNavigator
          */
         virtual void updatePlayerPosition(const osg::Vec3f& playerPosition) = 0;
 
+        /**
+         * @brief addDemand raises build priority of the tiles on and next to the segment until the next updateDemand call.
+         * Use the same start and end for a single position.
+         * @param agentHalfExtents allows to setup bounding cylinder for each agent, for each different half extents
+         * there is different navmesh.
+         */
+        virtual void addDemand(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end) = 0;
+
+        /**
+         * @brief updateDemand passes the demand added since the last call to the background update and resets it.
+         */
+        virtual void updateDemand() = 0;
+
         /**
          * @brief disable navigator updates
          */
@@ -200,6 +231,12 @@ namespace DetourNavigator
         virtual RecastMeshTiles getRecastMeshTiles() const = 0;
 
         virtual float getMaxNavmeshAreaRealRadius() const = 0;
+
+        /**
+         * @brief getPathCache returns cache shared by all findPath calls
+         * @return nullptr when path cache is disabled
+         */
+        virtual PathCache* getPathCache() const = 0;
     };
 
     std::unique_ptr<Navigator> makeNavigator(const Settings& settings, const std::string& userDataPath);
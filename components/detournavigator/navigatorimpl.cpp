@@ -7,13 +7,34 @@
 #include <components/misc/coordinateconverter.hpp>
 #include <components/misc/convert.hpp>
 
+#include <cmath>
+#include <optional>
+#include <unordered_set>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        /// Upper bound of the distance any point of the shape moves between the transforms
+        btScalar getMaxDisplacement(const btCollisionShape& shape, const btTransform& from, const btTransform& to)
+        {
+            btVector3 center;
+            btScalar radius;
+            shape.getBoundingSphere(center, radius);
+            btScalar basisDelta = 0;
+            for (int i = 0; i < 3; ++i)
+                basisDelta += (to.getBasis()[i] - from.getBasis()[i]).length2();
+            return (to.getOrigin() - from.getOrigin()).length() + std::sqrt(basisDelta) * (center.length() + radius);
+        }
+    }
+
     NavigatorImpl::NavigatorImpl(const Settings& settings, std::unique_ptr<NavMeshDb>&& db)
         : mSettings(settings)
         , mNavMeshManager(mSettings, std::move(db))
         , mUpdatesEnabled(true)
     {
+        if (mSettings.mEnablePathCache)
+            mPathCache = std::make_unique<PathCache>(mSettings.mMaxPathCacheSize, mSettings.mPathCachePositionQuantum);
     }
 
     void NavigatorImpl::addAgent(const osg::Vec3f& agentHalfExtents)
@@ -95,6 +116,50 @@ namespace DetourNavigator
         return updateObject(id, static_cast<const ObjectShapes&>(shapes), transform);
     }
 
+    bool NavigatorImpl::updateObjects(const std::vector<ObjectUpdate>& updates)
+    {
+        // Moving an object by less than a voxel doesn't change the navmesh
+        const float minDistance = mSettings.mRecast.mCellSize / mSettings.mRecast.mRecastScaleFactor;
+
+        std::vector<RecastMeshObjectUpdate> meshUpdates;
+        // for the updates of avoid shapes, the id of their object
+        std::vector<std::optional<ObjectId>> avoidOwners;
+        std::unordered_set<ObjectId> ids;
+        for (auto it = updates.rbegin(); it != updates.rend(); ++it)
+        {
+            const ObjectUpdate& update = *it;
+            if (!ids.insert(update.mId).second)
+                continue;
+            const btCollisionShape& shape = *update.mShapes.mShapeInstance->mCollisionShape;
+            const btTransform* const transform = mNavMeshManager.getObjectTransform(update.mId);
+            if (transform != nullptr && getMaxDisplacement(shape, *transform, update.mTransform) < minDistance)
+                continue;
+            meshUpdates.push_back(RecastMeshObjectUpdate {update.mId,
+                CollisionShape(update.mShapes.mShapeInstance, shape, update.mShapes.mTransform), update.mTransform,
+                AreaType_ground});
+            avoidOwners.push_back(std::nullopt);
+            if (const btCollisionShape* const avoidShape = update.mShapes.mShapeInstance->mAvoidCollisionShape.get())
+            {
+                meshUpdates.push_back(RecastMeshObjectUpdate {ObjectId(avoidShape),
+                    CollisionShape(update.mShapes.mShapeInstance, *avoidShape, update.mShapes.mTransform), update.mTransform,
+                    AreaType_null});
+                avoidOwners.push_back(update.mId);
+            }
+        }
+
+        const std::vector<bool> changed = mNavMeshManager.updateObjects(meshUpdates);
+        bool result = false;
+        for (std::size_t i = 0; i < meshUpdates.size(); ++i)
+        {
+            if (!changed[i])
+                continue;
+            if (avoidOwners[i].has_value())
+                updateAvoidShapeId(*avoidOwners[i], meshUpdates[i].mId);
+            result = true;
+        }
+        return result;
+    }
+
     bool NavigatorImpl::removeObject(const ObjectId id)
     {
         bool result = mNavMeshManager.removeObject(id);
@@ -168,6 +233,20 @@ namespace DetourNavigator
         mLastPlayerPosition = tilePosition;
     }
 
+    void NavigatorImpl::addDemand(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end)
+    {
+        if (mAgents.find(agentHalfExtents) == mAgents.end())
+            return;
+        mNavMeshManager.addDemand(agentHalfExtents, start, end);
+    }
+
+    void NavigatorImpl::updateDemand()
+    {
+        if (!mUpdatesEnabled)
+            return;
+        mNavMeshManager.updateDemand();
+    }
+
     void NavigatorImpl::setUpdatesEnabled(bool enabled)
     {
         mUpdatesEnabled = enabled;
@@ -239,4 +318,9 @@ namespace DetourNavigator
         const auto& settings = getSettings();
         return getRealTileSize(settings.mRecast) * getMaxNavmeshAreaRadius(settings);
     }
+
+    PathCache* NavigatorImpl::getPathCache() const
+    {
+        return mPathCache.get();
+    }
 }
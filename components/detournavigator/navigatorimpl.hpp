@@ -3,6 +3,7 @@
 
 #include "navigator.hpp"
 #include "navmeshmanager.hpp"
+#include "pathcache.hpp"
 
 #include <set>
 #include <memory>
@@ -34,6 +35,8 @@ namespace DetourNavigator
 
         bool updateObject(const ObjectId id, const DoorShapes& shapes, const btTransform& transform) override;
 
+        bool updateObjects(const std::vector<ObjectUpdate>& updates) override;
+
         bool removeObject(const ObjectId id) override;
 
         bool addWater(const osg::Vec2i& cellPosition, int cellSize, float level) override;
@@ -52,6 +55,10 @@ namespace DetourNavigator
 
         void updatePlayerPosition(const osg::Vec3f& playerPosition) override;
 
+        void addDemand(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end) override;
+
+        void updateDemand() override;
+
         void setUpdatesEnabled(bool enabled) override;
 
         void wait(Loading::Listener& listener, WaitConditionType waitConditionType) override;
@@ -68,11 +75,14 @@ namespace DetourNavigator
 
         float getMaxNavmeshAreaRealRadius() const override;
 
+        PathCache* getPathCache() const override;
+
     private:
         Settings mSettings;
         NavMeshManager mNavMeshManager;
         bool mUpdatesEnabled;
         std::optional<TilePosition> mLastPlayerPosition;
+        std::unique_ptr<PathCache> mPathCache;
         std::map<osg::Vec3f, std::size_t> mAgents;
         std::unordered_map<ObjectId, ObjectId> mAvoidIds;
         std::unordered_map<ObjectId, ObjectId> mWaterIds;
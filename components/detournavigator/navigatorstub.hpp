@@ -41,6 +41,11 @@ namespace DetourNavigator
             return false;
         }
 
+        bool updateObjects(const std::vector<ObjectUpdate>& /*updates*/) override
+        {
+            return false;
+        }
+
         bool removeObject(const ObjectId /*id*/) override
         {
             return false;
@@ -76,6 +81,10 @@ namespace DetourNavigator
 
         void updatePlayerPosition(const osg::Vec3f& /*playerPosition*/) override {};
 
+        void addDemand(const osg::Vec3f& /*agentHalfExtents*/, const osg::Vec3f& /*start*/, const osg::Vec3f& /*end*/) override {}
+
+        void updateDemand() override {}
+
         void setUpdatesEnabled(bool /*enabled*/) override {}
 
         void wait(Loading::Listener& /*listener*/, WaitConditionType /*waitConditionType*/) override {}
@@ -107,6 +116,11 @@ namespace DetourNavigator
             return std::numeric_limits<float>::max();
         }
 
+        PathCache* getPathCache() const override
+        {
+            return nullptr;
+        }
+
     private:
         Settings mDefaultSettings {};
         SharedNavMeshCacheItem mEmptyNavMeshCacheItem;
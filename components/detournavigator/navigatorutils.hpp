@@ -5,7 +5,10 @@
 #include "flags.hpp"
 #include "settings.hpp"
 #include "navigator.hpp"
+#include "pathcache.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <optional>
 
 namespace DetourNavigator
@@ -37,9 +40,28 @@ namespace DetourNavigator
         if (navMesh == nullptr)
             return Status::NavMeshNotFound;
         const auto settings = navigator.getSettings();
-        return findSmoothPath(navMesh->lockConst()->getImpl(), toNavMeshCoordinates(settings.mRecast, agentHalfExtents),
+        PathCache* const pathCache = navigator.getPathCache();
+        if (pathCache == nullptr)
+            return findSmoothPath(navMesh->lockConst()->getImpl(), toNavMeshCoordinates(settings.mRecast, agentHalfExtents),
+                toNavMeshCoordinates(settings.mRecast, stepSize), toNavMeshCoordinates(settings.mRecast, start),
+                toNavMeshCoordinates(settings.mRecast, end), includeFlags, areaCosts, settings, endTolerance, out);
+        const PathCacheKey key = pathCache->makeKey(agentHalfExtents, stepSize, start, end, includeFlags, areaCosts,
+                                                    endTolerance);
+        const auto locked = navMesh->lockConst();
+        if (const auto cached = pathCache->get(key, *locked))
+        {
+            out = std::copy(cached->mPoints.begin(), cached->mPoints.end(), out);
+            return cached->mStatus;
+        }
+        CachedPath path;
+        auto pathOut = std::back_inserter(path.mPoints);
+        path.mStatus = findSmoothPath(locked->getImpl(), toNavMeshCoordinates(settings.mRecast, agentHalfExtents),
             toNavMeshCoordinates(settings.mRecast, stepSize), toNavMeshCoordinates(settings.mRecast, start),
-            toNavMeshCoordinates(settings.mRecast, end), includeFlags, areaCosts, settings, endTolerance, out);
+            toNavMeshCoordinates(settings.mRecast, end), includeFlags, areaCosts, settings, endTolerance, pathOut);
+        if (path.mStatus == Status::Success || path.mStatus == Status::PartialPath)
+            pathCache->set(key, *locked, settings.mRecast, start, end, path);
+        out = std::copy(path.mPoints.begin(), path.mPoints.end(), out);
+        return path.mStatus;
     }
 
     /**
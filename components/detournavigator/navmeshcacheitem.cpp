@@ -56,6 +56,7 @@ namespace DetourNavigator
         if (dtStatusSucceed(addStatus))
         {
             auto tile = mUsedTiles.find(position);
+            mUsedTilesSize += static_cast<std::size_t>(navMeshData.mSize);
             if (tile == mUsedTiles.end())
             {
                 mUsedTiles.emplace_hint(tile, position,
@@ -64,6 +65,7 @@ namespace DetourNavigator
             else
             {
                 ++tile->second.mVersion.mRevision;
+                mUsedTilesSize -= static_cast<std::size_t>(tile->second.mData.mSize);
                 tile->second.mCached = std::move(cached);
                 tile->second.mData = std::move(navMeshData);
             }
@@ -74,7 +76,7 @@ namespace DetourNavigator
         {
             if (removed)
             {
-                mUsedTiles.erase(position);
+                eraseUsedTile(position);
                 ++mVersion.mRevision;
             }
             return UpdateNavMeshStatusBuilder().removed(removed).failed((addStatus & DT_OUT_OF_MEMORY) != 0).getResult();
@@ -87,7 +89,7 @@ namespace DetourNavigator
         removed = mEmptyTiles.erase(position) > 0 || removed;
         if (removed)
         {
-            mUsedTiles.erase(position);
+            eraseUsedTile(position);
             ++mVersion.mRevision;
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
@@ -99,12 +101,21 @@ namespace DetourNavigator
         removed = mEmptyTiles.insert(position).second || removed;
         if (removed)
         {
-            mUsedTiles.erase(position);
+            eraseUsedTile(position);
             ++mVersion.mRevision;
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
     }
 
+    void NavMeshCacheItem::eraseUsedTile(const TilePosition& position)
+    {
+        const auto it = mUsedTiles.find(position);
+        if (it == mUsedTiles.end())
+            return;
+        mUsedTilesSize -= static_cast<std::size_t>(it->second.mData.mSize);
+        mUsedTiles.erase(it);
+    }
+
     bool NavMeshCacheItem::isEmptyTile(const TilePosition& position) const
     {
         return mEmptyTiles.find(position) != mEmptyTiles.end();
@@ -11,6 +11,7 @@
 #include <components/misc/guarded.hpp>
 
 #include <map>
+#include <optional>
 #include <ostream>
 #include <set>
 
@@ -152,6 +153,27 @@ namespace DetourNavigator
 
         bool isEmptyTile(const TilePosition& position) const;
 
+        std::optional<Version> getTileVersion(const TilePosition& position) const
+        {
+            const auto it = mUsedTiles.find(position);
+            if (it == mUsedTiles.end())
+                return {};
+            return it->second.mVersion;
+        }
+
+        std::size_t getUsedTilesCount() const { return mUsedTiles.size(); }
+
+        /// Total size of the tiles data in bytes
+        std::size_t getUsedTilesSize() const { return mUsedTilesSize; }
+
+        std::optional<std::size_t> getTileSize(const TilePosition& position) const
+        {
+            const auto it = mUsedTiles.find(position);
+            if (it == mUsedTiles.end())
+                return {};
+            return static_cast<std::size_t>(it->second.mData.mSize);
+        }
+
         template <class Function>
         void forEachUsedTile(Function&& function) const
         {
@@ -171,7 +193,10 @@ namespace DetourNavigator
         NavMeshPtr mImpl;
         Version mVersion;
         std::map<TilePosition, Tile> mUsedTiles;
+        std::size_t mUsedTilesSize = 0;
         std::set<TilePosition> mEmptyTiles;
+
+        void eraseUsedTile(const TilePosition& position);
     };
 
     using GuardedNavMeshCacheItem = Misc::ScopeGuarded<NavMeshCacheItem>;
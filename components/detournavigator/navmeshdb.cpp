@@ -9,8 +9,12 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
+#include <limits>
 #include <string>
+#include <tuple>
 #include <string_view>
 #include <vector>
 
@@ -18,6 +22,15 @@ namespace DetourNavigator
 {
     namespace
     {
+        // Tiles are a few kilobytes each, large pages keep most of them out of overflow pages. Applies only to new
+        // databases. The database is a cache and can be regenerated so it's fine to lose the last transactions on
+        // power loss.
+        constexpr std::string_view pragmas = R"(
+            PRAGMA page_size = 16384;
+            PRAGMA journal_mode = WAL;
+            PRAGMA synchronous = NORMAL;
+        )";
+
         constexpr const char schema[] = R"(
             BEGIN TRANSACTION;
 
@@ -29,12 +42,24 @@ namespace DetourNavigator
                 tile_position_y INTEGER NOT NULL,
                 version INTEGER NOT NULL,
                 input BLOB,
-                data BLOB
+                data BLOB,
+                data_format INTEGER NOT NULL DEFAULT 1,
+                dictionary_id INTEGER NOT NULL DEFAULT 0
             );
 
             CREATE UNIQUE INDEX IF NOT EXISTS index_unique_tiles_by_worldspace_and_tile_position_and_input
                 ON tiles (worldspace, tile_position_x, tile_position_y, input);
 
+            CREATE TABLE IF NOT EXISTS tile_portals (
+                tile_id INTEGER PRIMARY KEY,
+                portals INTEGER NOT NULL
+            );
+
+            CREATE TABLE IF NOT EXISTS tile_data_dictionaries (
+                dictionary_id INTEGER PRIMARY KEY,
+                data BLOB NOT NULL
+            );
+
             CREATE TABLE IF NOT EXISTS shapes (
                 shape_id INTEGER PRIMARY KEY,
                 name TEXT NOT NULL,
@@ -48,6 +73,57 @@ namespace DetourNavigator
             COMMIT;
         )";
 
+        std::string makeSchema(std::size_t cacheSize)
+        {
+            std::string result(pragmas);
+            if (cacheSize > 0)
+                // Negative value is a size in KiB
+                result += "PRAGMA cache_size = -" + std::to_string(std::max<std::size_t>(cacheSize / 1024, 1)) + ";\n";
+            result += schema;
+            return result;
+        }
+
+        void executeQuery(sqlite3& db, const char* query)
+        {
+            if (sqlite3_exec(&db, query, nullptr, nullptr, nullptr) != SQLITE_OK)
+                throw std::runtime_error("Failed to execute \"" + std::string(query) + "\": " + sqlite3_errmsg(&db));
+        }
+
+        bool hasColumn(sqlite3& db, std::string_view table, std::string_view column)
+        {
+            bool result = false;
+            const std::string query = "SELECT 1 FROM pragma_table_info('" + std::string(table) + "') WHERE name = '"
+                + std::string(column) + "'";
+            const auto callback = [] (void* found, int, char**, char**)
+            {
+                *static_cast<bool*>(found) = true;
+                return 0;
+            };
+            if (sqlite3_exec(&db, query.c_str(), callback, &result, nullptr) != SQLITE_OK)
+                throw std::runtime_error("Failed to get table info: " + std::string(sqlite3_errmsg(&db)));
+            return result;
+        }
+
+        // Databases created before tile data formats were introduced have only LZ4 compressed data
+        void migrate(sqlite3& db)
+        {
+            if (hasColumn(db, "tiles", "data_format"))
+                return;
+            executeQuery(db, R"(
+                BEGIN TRANSACTION;
+                ALTER TABLE tiles ADD COLUMN data_format INTEGER NOT NULL DEFAULT 1;
+                ALTER TABLE tiles ADD COLUMN dictionary_id INTEGER NOT NULL DEFAULT 0;
+                COMMIT;
+            )");
+        }
+
+        Sqlite3::Db makeNavMeshDb(std::string_view path, std::size_t cacheSize)
+        {
+            Sqlite3::Db result = Sqlite3::makeDb(path, makeSchema(cacheSize).c_str());
+            migrate(*result);
+            return result;
+        }
+
         constexpr std::string_view getMaxTileIdQuery = R"(
             SELECT max(tile_id) FROM tiles
         )";
@@ -62,7 +138,7 @@ namespace DetourNavigator
         )";
 
         constexpr std::string_view getTileDataQuery = R"(
-            SELECT tile_id, version, data
+            SELECT tile_id, version, data_format, dictionary_id, data
               FROM tiles
              WHERE worldspace = :worldspace
                AND tile_position_x = :tile_position_x
@@ -71,18 +147,55 @@ namespace DetourNavigator
         )";
 
         constexpr std::string_view insertTileQuery = R"(
-            INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data)
-                   VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data)
+            INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data,
+                                data_format,  dictionary_id)
+                   VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data,
+                               :data_format, :dictionary_id)
         )";
 
         constexpr std::string_view updateTileQuery = R"(
             UPDATE tiles
                SET version = :version,
                    data = :data,
+                   data_format = :data_format,
+                   dictionary_id = :dictionary_id,
                    revision = revision + 1
              WHERE tile_id = :tile_id
         )";
 
+        constexpr std::string_view getTilesQuery = R"(
+            SELECT tile_id, worldspace, tile_position_x, tile_position_y, version, input, data_format, dictionary_id, data
+              FROM tiles
+             WHERE tile_id > :tile_id
+             ORDER BY tile_id
+             LIMIT :limit
+        )";
+
+        constexpr std::string_view insertTilePortalsQuery = R"(
+            INSERT OR REPLACE INTO tile_portals ( tile_id,  portals)
+                               VALUES           (:tile_id, :portals)
+        )";
+
+        constexpr std::string_view getTilePortalsQuery = R"(
+            SELECT tiles.tile_position_x, tiles.tile_position_y, tile_portals.portals
+              FROM tiles
+              JOIN tile_portals ON tile_portals.tile_id = tiles.tile_id
+             WHERE tiles.worldspace = :worldspace
+        )";
+
+        constexpr std::string_view getMaxTileDataDictionaryIdQuery = R"(
+            SELECT max(dictionary_id) FROM tile_data_dictionaries
+        )";
+
+        constexpr std::string_view getTileDataDictionaryQuery = R"(
+            SELECT data FROM tile_data_dictionaries WHERE dictionary_id = :dictionary_id
+        )";
+
+        constexpr std::string_view insertTileDataDictionaryQuery = R"(
+            INSERT INTO tile_data_dictionaries ( dictionary_id,  data)
+                   VALUES                      (:dictionary_id, :data)
+        )";
+
         constexpr std::string_view getMaxShapeIdQuery = R"(
             SELECT max(shape_id) FROM shapes
         )";
@@ -99,6 +212,10 @@ namespace DetourNavigator
             INSERT INTO shapes ( shape_id,  name,  type,  hash)
                    VALUES      (:shape_id, :name, :type, :hash)
         )";
+
+        constexpr std::string_view getShapesQuery = R"(
+            SELECT shape_id, name, type, hash FROM shapes
+        )";
     }
 
     std::ostream& operator<<(std::ostream& stream, ShapeType value)
@@ -111,17 +228,58 @@ namespace DetourNavigator
         return stream << "unknown shape type (" << static_cast<std::underlying_type_t<ShapeType>>(value) << ")";
     }
 
-    NavMeshDb::NavMeshDb(std::string_view path)
-        : mDb(Sqlite3::makeDb(path, schema))
+    CompressedTileData compressTileData(const std::vector<std::byte>& data, const TileDataDictionary* dictionary)
+    {
+        if (dictionary == nullptr)
+            return CompressedTileData {TileDataFormat::Lz4, 0, Misc::compress(data)};
+        return CompressedTileData {TileDataFormat::Lz4WithDictionary, dictionary->mId,
+                                   Misc::compress(data, dictionary->mData)};
+    }
+
+    std::vector<std::byte> makeTileDataDictionary(const std::vector<std::vector<std::byte>>& samples,
+        std::size_t maxSize)
+    {
+        std::vector<std::byte> result;
+        if (samples.empty() || maxSize == 0)
+            return result;
+        result.reserve(maxSize);
+        const std::size_t prefixSize = std::max<std::size_t>(maxSize / samples.size(), 1);
+        for (const std::vector<std::byte>& sample : samples)
+        {
+            const std::size_t size = std::min({prefixSize, sample.size(), maxSize - result.size()});
+            result.insert(result.end(), sample.begin(), sample.begin() + static_cast<std::ptrdiff_t>(size));
+            if (result.size() >= maxSize)
+                break;
+        }
+        return result;
+    }
+
+    NavMeshDb::NavMeshDb(std::string_view path, std::size_t cacheSize)
+        : mDb(makeNavMeshDb(path, cacheSize))
         , mGetMaxTileId(*mDb, DbQueries::GetMaxTileId {})
         , mFindTile(*mDb, DbQueries::FindTile {})
         , mGetTileData(*mDb, DbQueries::GetTileData {})
         , mInsertTile(*mDb, DbQueries::InsertTile {})
         , mUpdateTile(*mDb, DbQueries::UpdateTile {})
+        , mGetTiles(*mDb, DbQueries::GetTiles {})
+        , mInsertTilePortals(*mDb, DbQueries::InsertTilePortals {})
+        , mGetTilePortals(*mDb, DbQueries::GetTilePortals {})
+        , mGetMaxTileDataDictionaryId(*mDb, DbQueries::GetMaxTileDataDictionaryId {})
+        , mGetTileDataDictionary(*mDb, DbQueries::GetTileDataDictionary {})
+        , mInsertTileDataDictionary(*mDb, DbQueries::InsertTileDataDictionary {})
         , mGetMaxShapeId(*mDb, DbQueries::GetMaxShapeId {})
         , mFindShapeId(*mDb, DbQueries::FindShapeId {})
         , mInsertShape(*mDb, DbQueries::InsertShape {})
+        , mGetShapes(*mDb, DbQueries::GetShapes {})
     {
+        std::int64_t dictionaryId = 0;
+        request(*mDb, mGetMaxTileDataDictionaryId, &dictionaryId, 1);
+        if (dictionaryId == 0)
+            return;
+        std::vector<std::byte> data;
+        request(*mDb, mGetTileDataDictionary, &data, 1, dictionaryId);
+        mTileDataDictionary = std::make_shared<const TileDataDictionary>(TileDataDictionary {dictionaryId, data});
+        mTileDataDictionaries.emplace(dictionaryId, std::move(data));
     }
 
     Sqlite3::Transaction NavMeshDb::startTransaction()
@@ -151,26 +309,103 @@ namespace DetourNavigator
         const TilePosition& tilePosition, const std::vector<std::byte>& input)
     {
         TileData result;
-        auto row = std::tie(result.mTileId, result.mVersion, result.mData);
+        TileDataFormat format;
+        std::int64_t dictionaryId;
+        auto row = std::tie(result.mTileId, result.mVersion, format, dictionaryId, result.mData);
         const std::vector<std::byte> compressedInput = Misc::compress(input);
         if (&row == request(*mDb, mGetTileData, &row, 1, worldspace, tilePosition, compressedInput))
             return {};
-        result.mData = Misc::decompress(result.mData);
+        result.mData = decompressTileData(format, dictionaryId, result.mData);
         return result;
     }
 
     int NavMeshDb::insertTile(TileId tileId, const std::string& worldspace, const TilePosition& tilePosition,
         TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data)
+    {
+        return insertCompressedTile(tileId, worldspace, tilePosition, version, input,
+                                    compressTileData(data, mTileDataDictionary.get()));
+    }
+
+    int NavMeshDb::insertCompressedTile(TileId tileId, const std::string& worldspace, const TilePosition& tilePosition,
+        TileVersion version, const std::vector<std::byte>& input, const CompressedTileData& data)
     {
         const std::vector<std::byte> compressedInput = Misc::compress(input);
-        const std::vector<std::byte> compressedData = Misc::compress(data);
-        return execute(*mDb, mInsertTile, tileId, worldspace, tilePosition, version, compressedInput, compressedData);
+        return execute(*mDb, mInsertTile, tileId, worldspace, tilePosition, version, compressedInput, data);
     }
 
     int NavMeshDb::updateTile(TileId tileId, TileVersion version, const std::vector<std::byte>& data)
     {
-        const std::vector<std::byte> compressedData = Misc::compress(data);
-        return execute(*mDb, mUpdateTile, tileId, version, compressedData);
+        return updateCompressedTile(tileId, version, compressTileData(data, mTileDataDictionary.get()));
+    }
+
+    int NavMeshDb::updateCompressedTile(TileId tileId, TileVersion version, const CompressedTileData& data)
+    {
+        return execute(*mDb, mUpdateTile, tileId, version, data);
+    }
+
+    std::vector<DbTile> NavMeshDb::getTiles(TileId after, std::size_t limit)
+    {
+        std::vector<std::tuple<TileId, std::string, int, int, TileVersion, std::vector<std::byte>, TileDataFormat,
+            std::int64_t, std::vector<std::byte>>> rows;
+        request(*mDb, mGetTiles, std::back_inserter(rows), limit, after, limit);
+        std::vector<DbTile> result;
+        result.reserve(rows.size());
+        for (auto& [tileId, worldspace, x, y, version, input, format, dictionaryId, data] : rows)
+            result.push_back(DbTile {tileId, std::move(worldspace), TilePosition(x, y), version,
+                                     Misc::decompress(input), decompressTileData(format, dictionaryId, data)});
+        return result;
+    }
+
+    std::int64_t NavMeshDb::insertTileDataDictionary(const std::vector<std::byte>& data)
+    {
+        std::int64_t dictionaryId = 0;
+        request(*mDb, mGetMaxTileDataDictionaryId, &dictionaryId, 1);
+        ++dictionaryId;
+        execute(*mDb, mInsertTileDataDictionary, dictionaryId, data);
+        mTileDataDictionary = std::make_shared<const TileDataDictionary>(TileDataDictionary {dictionaryId, data});
+        mTileDataDictionaries.emplace(dictionaryId, data);
+        return dictionaryId;
+    }
+
+    std::vector<std::byte> NavMeshDb::decompressTileData(TileDataFormat format, std::int64_t dictionaryId,
+        const std::vector<std::byte>& data)
+    {
+        switch (format)
+        {
+            case TileDataFormat::Lz4:
+                return Misc::decompress(data);
+            case TileDataFormat::Lz4WithDictionary:
+            {
+                auto it = mTileDataDictionaries.find(dictionaryId);
+                if (it == mTileDataDictionaries.end())
+                {
+                    std::vector<std::byte> dictionary;
+                    if (&dictionary == request(*mDb, mGetTileDataDictionary, &dictionary, 1, dictionaryId))
+                        throw std::runtime_error("Tile data dictionary " + std::to_string(dictionaryId)
+                                                 + " is not found");
+                    it = mTileDataDictionaries.emplace(dictionaryId, std::move(dictionary)).first;
+                }
+                return Misc::decompress(data, it->second);
+            }
+        }
+        throw std::runtime_error("Unsupported tile data format: "
+                                 + std::to_string(static_cast<std::underlying_type_t<TileDataFormat>>(format)));
+    }
+
+    int NavMeshDb::insertTilePortals(TileId tileId, unsigned portals)
+    {
+        return execute(*mDb, mInsertTilePortals, tileId, portals);
+    }
+
+    std::vector<DbTilePortals> NavMeshDb::getTilePortals(const std::string& worldspace)
+    {
+        std::vector<std::tuple<int, int, std::int64_t>> rows;
+        request(*mDb, mGetTilePortals, std::back_inserter(rows), std::numeric_limits<std::size_t>::max(), worldspace);
+        std::vector<DbTilePortals> result;
+        result.reserve(rows.size());
+        for (const auto& [x, y, portals] : rows)
+            result.push_back(DbTilePortals {TilePosition(x, y), static_cast<unsigned>(portals)});
+        return result;
     }
 
     ShapeId NavMeshDb::getMaxShapeId()
@@ -195,6 +430,17 @@ namespace DetourNavigator
         return execute(*mDb, mInsertShape, shapeId, name, type, hash);
     }
 
+    std::vector<DbShape> NavMeshDb::getShapes()
+    {
+        std::vector<std::tuple<ShapeId, std::string, ShapeType, std::vector<std::byte>>> rows;
+        request(*mDb, mGetShapes, std::back_inserter(rows), std::numeric_limits<std::size_t>::max());
+        std::vector<DbShape> result;
+        result.reserve(rows.size());
+        for (auto& [shapeId, name, type, hash] : rows)
+            result.push_back(DbShape {shapeId, std::move(name), type, std::move(hash)});
+        return result;
+    }
+
     namespace DbQueries
     {
         std::string_view GetMaxTileId::text() noexcept
@@ -237,7 +483,7 @@ namespace DetourNavigator
 
         void InsertTile::bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, const std::string& worldspace,
             const TilePosition& tilePosition, TileVersion version, const std::vector<std::byte>& input,
-            const std::vector<std::byte>& data)
+            const CompressedTileData& data)
         {
             Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
             Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
@@ -245,7 +491,9 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":tile_position_y", tilePosition.y());
             Sqlite3::bindParameter(db, statement, ":version", version);
             Sqlite3::bindParameter(db, statement, ":input", input);
-            Sqlite3::bindParameter(db, statement, ":data", data);
+            Sqlite3::bindParameter(db, statement, ":data", data.mData);
+            Sqlite3::bindParameter(db, statement, ":data_format", static_cast<int>(data.mFormat));
+            Sqlite3::bindParameter(db, statement, ":dictionary_id", data.mDictionaryId);
         }
 
         std::string_view UpdateTile::text() noexcept
@@ -254,10 +502,71 @@ namespace DetourNavigator
         }
 
         void UpdateTile::bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, TileVersion version,
-            const std::vector<std::byte>& data)
+            const CompressedTileData& data)
         {
             Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
             Sqlite3::bindParameter(db, statement, ":version", version);
+            Sqlite3::bindParameter(db, statement, ":data", data.mData);
+            Sqlite3::bindParameter(db, statement, ":data_format", static_cast<int>(data.mFormat));
+            Sqlite3::bindParameter(db, statement, ":dictionary_id", data.mDictionaryId);
+        }
+
+        std::string_view GetTiles::text() noexcept
+        {
+            return getTilesQuery;
+        }
+
+        void GetTiles::bind(sqlite3& db, sqlite3_stmt& statement, TileId after, std::size_t limit)
+        {
+            Sqlite3::bindParameter(db, statement, ":tile_id", after);
+            Sqlite3::bindParameter(db, statement, ":limit", static_cast<std::int64_t>(limit));
+        }
+
+        std::string_view InsertTilePortals::text() noexcept
+        {
+            return insertTilePortalsQuery;
+        }
+
+        void InsertTilePortals::bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, unsigned portals)
+        {
+            Sqlite3::bindParameter(db, statement, ":tile_id", tileId);
+            Sqlite3::bindParameter(db, statement, ":portals", static_cast<int>(portals));
+        }
+
+        std::string_view GetTilePortals::text() noexcept
+        {
+            return getTilePortalsQuery;
+        }
+
+        void GetTilePortals::bind(sqlite3& db, sqlite3_stmt& statement, const std::string& worldspace)
+        {
+            Sqlite3::bindParameter(db, statement, ":worldspace", worldspace);
+        }
+
+        std::string_view GetMaxTileDataDictionaryId::text() noexcept
+        {
+            return getMaxTileDataDictionaryIdQuery;
+        }
+
+        std::string_view GetTileDataDictionary::text() noexcept
+        {
+            return getTileDataDictionaryQuery;
+        }
+
+        void GetTileDataDictionary::bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t dictionaryId)
+        {
+            Sqlite3::bindParameter(db, statement, ":dictionary_id", dictionaryId);
+        }
+
+        std::string_view InsertTileDataDictionary::text() noexcept
+        {
+            return insertTileDataDictionaryQuery;
+        }
+
+        void InsertTileDataDictionary::bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t dictionaryId,
+            const std::vector<std::byte>& data)
+        {
+            Sqlite3::bindParameter(db, statement, ":dictionary_id", dictionaryId);
             Sqlite3::bindParameter(db, statement, ":data", data);
         }
 
@@ -292,5 +601,10 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":type", static_cast<int>(type));
             Sqlite3::bindParameter(db, statement, ":hash", hash);
         }
+
+        std::string_view GetShapes::text() noexcept
+        {
+            return getShapesQuery;
+        }
     }
 }
@@ -13,6 +13,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -51,6 +52,56 @@ namespace DetourNavigator
         Avoid = 2,
     };
 
+    struct DbTile
+    {
+        TileId mTileId;
+        std::string mWorldspace;
+        TilePosition mTilePosition;
+        TileVersion mVersion;
+        std::vector<std::byte> mInput;
+        std::vector<std::byte> mData;
+    };
+
+    struct DbShape
+    {
+        ShapeId mShapeId;
+        std::string mName;
+        ShapeType mType;
+        std::vector<std::byte> mHash;
+    };
+
+    enum class TileDataFormat
+    {
+        Lz4 = 1,
+        Lz4WithDictionary = 2,
+    };
+
+    struct TileDataDictionary
+    {
+        std::int64_t mId = 0;
+        std::vector<std::byte> mData;
+    };
+
+    struct CompressedTileData
+    {
+        TileDataFormat mFormat = TileDataFormat::Lz4;
+        std::int64_t mDictionaryId = 0;
+        std::vector<std::byte> mData;
+    };
+
+    /// Compresses with dictionary when it's not null, does not access db so can be called from any thread
+    CompressedTileData compressTileData(const std::vector<std::byte>& data, const TileDataDictionary* dictionary);
+
+    /// Makes dictionary from beginnings of samples, data is similar there due to serialization format
+    std::vector<std::byte> makeTileDataDictionary(const std::vector<std::vector<std::byte>>& samples,
+        std::size_t maxSize);
+
+    struct DbTilePortals
+    {
+        TilePosition mTilePosition;
+        unsigned mPortals;
+    };
+
     std::ostream& operator<<(std::ostream& stream, ShapeType value);
 
     namespace DbQueries
@@ -80,13 +131,50 @@ namespace DetourNavigator
             static std::string_view text() noexcept;
             static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, const std::string& worldspace,
                 const TilePosition& tilePosition, TileVersion version, const std::vector<std::byte>& input,
-                const std::vector<std::byte>& data);
+                const CompressedTileData& data);
         };
 
         struct UpdateTile
         {
             static std::string_view text() noexcept;
             static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, TileVersion version,
+                const CompressedTileData& data);
+        };
+
+        struct GetTiles
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId after, std::size_t limit);
+        };
+
+        struct InsertTilePortals
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId tileId, unsigned portals);
+        };
+
+        struct GetTilePortals
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, const std::string& worldspace);
+        };
+
+        struct GetMaxTileDataDictionaryId
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
+        struct GetTileDataDictionary
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t dictionaryId);
+        };
+
+        struct InsertTileDataDictionary
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, std::int64_t dictionaryId,
                 const std::vector<std::byte>& data);
         };
 
@@ -109,12 +197,19 @@ namespace DetourNavigator
             static void bind(sqlite3& db, sqlite3_stmt& statement, ShapeId shapeId, const std::string& name,
                 ShapeType type, const Sqlite3::ConstBlob& hash);
         };
+
+        struct GetShapes
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
     }
 
     class NavMeshDb
     {
     public:
-        explicit NavMeshDb(std::string_view path);
+        /// @param cacheSize SQLite page cache size in bytes, 0 keeps the default
+        explicit NavMeshDb(std::string_view path, std::size_t cacheSize = 0);
 
         Sqlite3::Transaction startTransaction();
 
@@ -131,12 +226,36 @@ namespace DetourNavigator
 
         int updateTile(TileId tileId, TileVersion version, const std::vector<std::byte>& data);
 
+        /// Same as insertTile but data is already compressed by compressTileData
+        int insertCompressedTile(TileId tileId, const std::string& worldspace, const TilePosition& tilePosition,
+            TileVersion version, const std::vector<std::byte>& input, const CompressedTileData& data);
+
+        /// Same as updateTile but data is already compressed by compressTileData
+        int updateCompressedTile(TileId tileId, TileVersion version, const CompressedTileData& data);
+
+        /// Returns up to limit tiles ordered by id starting after the given one
+        std::vector<DbTile> getTiles(TileId after, std::size_t limit);
+
+        /// Replaces portals stored for the tile, see TilePortals
+        int insertTilePortals(TileId tileId, unsigned portals);
+
+        /// Returns portals for all tiles of the worldspace having them, a position may be repeated
+        std::vector<DbTilePortals> getTilePortals(const std::string& worldspace);
+
+        /// Returns dictionary used to compress new tiles, nullptr if there is none
+        std::shared_ptr<const TileDataDictionary> getTileDataDictionary() const { return mTileDataDictionary; }
+
+        /// Adds dictionary to compress new tiles, tiles compressed with previous ones stay readable
+        std::int64_t insertTileDataDictionary(const std::vector<std::byte>& data);
+
         ShapeId getMaxShapeId();
 
         std::optional<ShapeId> findShapeId(const std::string& name, ShapeType type, const Sqlite3::ConstBlob& hash);
 
         int insertShape(ShapeId shapeId, const std::string& name, ShapeType type, const Sqlite3::ConstBlob& hash);
 
+        std::vector<DbShape> getShapes();
+
     private:
         Sqlite3::Db mDb;
         Sqlite3::Statement<DbQueries::GetMaxTileId> mGetMaxTileId;
@@ -144,9 +263,21 @@ namespace DetourNavigator
         Sqlite3::Statement<DbQueries::GetTileData> mGetTileData;
         Sqlite3::Statement<DbQueries::InsertTile> mInsertTile;
         Sqlite3::Statement<DbQueries::UpdateTile> mUpdateTile;
+        Sqlite3::Statement<DbQueries::GetTiles> mGetTiles;
+        Sqlite3::Statement<DbQueries::InsertTilePortals> mInsertTilePortals;
+        Sqlite3::Statement<DbQueries::GetTilePortals> mGetTilePortals;
+        Sqlite3::Statement<DbQueries::GetMaxTileDataDictionaryId> mGetMaxTileDataDictionaryId;
+        Sqlite3::Statement<DbQueries::GetTileDataDictionary> mGetTileDataDictionary;
+        Sqlite3::Statement<DbQueries::InsertTileDataDictionary> mInsertTileDataDictionary;
         Sqlite3::Statement<DbQueries::GetMaxShapeId> mGetMaxShapeId;
         Sqlite3::Statement<DbQueries::FindShapeId> mFindShapeId;
         Sqlite3::Statement<DbQueries::InsertShape> mInsertShape;
+        Sqlite3::Statement<DbQueries::GetShapes> mGetShapes;
+        std::shared_ptr<const TileDataDictionary> mTileDataDictionary;
+        std::map<std::int64_t, std::vector<std::byte>> mTileDataDictionaries;
+
+        std::vector<std::byte> decompressTileData(TileDataFormat format, std::int64_t dictionaryId,
+            const std::vector<std::byte>& data);
     };
 }
 
@@ -13,7 +13,10 @@
 
 #include <DetourNavMesh.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <limits>
 
 namespace
 {
@@ -44,6 +47,15 @@ namespace DetourNavigator
 {
     namespace
     {
+        // Actors usually look for a path again well before this, so their tiles don't get evicted in the meantime
+        constexpr std::chrono::seconds sActiveTileTimeout(30);
+
+        int getSquaredDistance(const TilePosition& lhs, const TilePosition& rhs)
+        {
+            const TilePosition d = lhs - rhs;
+            return d.x() * d.x() + d.y() * d.y();
+        }
+
         TileBounds makeBounds(const RecastSettings& settings, const osg::Vec2f& center, int maxTiles)
         {
             const float radius = fromNavMeshCoordinates(settings, std::ceil(std::sqrt(static_cast<float>(maxTiles) / osg::PIf) + 1) * getTileSize(settings));
@@ -68,6 +80,7 @@ namespace DetourNavigator
         mRecastMeshManager.setWorldspace(worldspace);
         for (auto& [agent, cache] : mCache)
             cache = std::make_shared<GuardedNavMeshCacheItem>(makeEmptyNavMesh(mSettings), ++mGenerationCounter);
+        mActiveTiles.clear();
         mWorldspace = worldspace;
     }
 
@@ -104,6 +117,17 @@ namespace DetourNavigator
             [&] (const TilePosition& tile, ChangeType changeType) { addChangedTile(tile, changeType); });
     }
 
+    std::vector<bool> NavMeshManager::updateObjects(const std::vector<RecastMeshObjectUpdate>& updates)
+    {
+        return mRecastMeshManager.updateObjects(updates,
+            [&] (const TilePosition& tile, ChangeType changeType) { addChangedTile(tile, changeType); });
+    }
+
+    const btTransform* NavMeshManager::getObjectTransform(const ObjectId id) const
+    {
+        return mRecastMeshManager.getObjectTransform(id);
+    }
+
     bool NavMeshManager::removeObject(const ObjectId id)
     {
         const auto object = mRecastMeshManager.removeObject(id);
@@ -172,6 +196,10 @@ namespace DetourNavigator
         mChangedTiles.erase(agentHalfExtents);
         mPlayerTile.erase(agentHalfExtents);
         mLastRecastMeshManagerRevision.erase(agentHalfExtents);
+        mActiveTiles.erase(agentHalfExtents);
+        mActiveTilesChanged.erase(agentHalfExtents);
+        mEvictedTiles.erase(agentHalfExtents);
+        mAsyncNavMeshUpdater.setEvictedTiles(agentHalfExtents, {});
         return true;
     }
 
@@ -201,8 +229,9 @@ namespace DetourNavigator
         auto& lastRevision = mLastRecastMeshManagerRevision[agentHalfExtents];
         auto lastPlayerTile = mPlayerTile.find(agentHalfExtents);
         if (lastRevision == mRecastMeshManager.getRevision() && lastPlayerTile != mPlayerTile.end()
-                && lastPlayerTile->second == playerTile)
+                && lastPlayerTile->second == playerTile && mActiveTilesChanged.count(agentHalfExtents) == 0)
             return;
+        mActiveTilesChanged.erase(agentHalfExtents);
         lastRevision = mRecastMeshManager.getRevision();
         if (lastPlayerTile == mPlayerTile.end())
             lastPlayerTile = mPlayerTile.insert(std::make_pair(agentHalfExtents, playerTile)).first;
@@ -233,19 +262,30 @@ namespace DetourNavigator
                     }
             }
             const auto maxTiles = std::min(mSettings.mMaxTilesNumber, navMesh.getParams()->maxTiles);
+            std::set<TilePosition> evictedTiles = getEvictedTiles(agentHalfExtents, playerTile, maxTiles, *locked);
+            std::set<TilePosition>& lastEvictedTiles = mEvictedTiles[agentHalfExtents];
             mRecastMeshManager.forEachTile([&] (const TilePosition& tile, CachedRecastMeshManager& recastMeshManager)
             {
                 if (tilesToPost.count(tile))
                     return;
-                const auto shouldAdd = shouldAddTile(tile, playerTile, maxTiles);
+                const auto shouldAdd = shouldAddTile(tile, playerTile, maxTiles) && evictedTiles.count(tile) == 0;
                 const auto presentInNavMesh = bool(navMesh.getTileAt(tile.x(), tile.y(), 0));
                 if (shouldAdd && !presentInNavMesh)
+                {
                     tilesToPost.insert(std::make_pair(tile, locked->isEmptyTile(tile) ? ChangeType::update : ChangeType::add));
+                    if (lastEvictedTiles.count(tile) > 0)
+                        ++mReloads;
+                }
                 else if (!shouldAdd && presentInNavMesh)
                     tilesToPost.insert(std::make_pair(tile, ChangeType::mixed));
                 else
                     recastMeshManager.reportNavMeshChange(recastMeshManager.getVersion(), Version {0, 0});
             });
+            if (evictedTiles != lastEvictedTiles)
+            {
+                lastEvictedTiles = evictedTiles;
+                mAsyncNavMeshUpdater.setEvictedTiles(agentHalfExtents, std::move(evictedTiles));
+            }
         }
         mAsyncNavMeshUpdater.post(agentHalfExtents, cached, playerTile, mRecastMeshManager.getWorldspace(), tilesToPost);
         if (changedTiles != mChangedTiles.end())
@@ -255,6 +295,42 @@ namespace DetourNavigator
             " recastMeshManagerRevision=" << lastRevision;
     }
 
+    void NavMeshManager::addDemand(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end)
+    {
+        const TilePosition startTile = getTilePosition(mSettings.mRecast, toNavMeshCoordinates(mSettings.mRecast, start));
+        const TilePosition endTile = getTilePosition(mSettings.mRecast, toNavMeshCoordinates(mSettings.mRecast, end));
+        // Longer corridors can't fit into the navmesh anyway
+        const int steps = std::min(std::max(std::abs(endTile.x() - startTile.x()), std::abs(endTile.y() - startTile.y())),
+                                   mSettings.mMaxTilesNumber);
+        auto& tiles = mDemandedTiles[agentHalfExtents];
+        for (int i = 0; i <= steps; ++i)
+        {
+            const float ratio = steps == 0 ? 0.0f : static_cast<float>(i) / static_cast<float>(steps);
+            const TilePosition tile(startTile.x() + static_cast<int>(std::lround((endTile.x() - startTile.x()) * ratio)),
+                                    startTile.y() + static_cast<int>(std::lround((endTile.y() - startTile.y()) * ratio)));
+            // Neighbours too, the agent may leave the straight line a bit
+            for (int x = -1; x <= 1; ++x)
+                for (int y = -1; y <= 1; ++y)
+                    tiles.emplace(tile.x() + x, tile.y() + y);
+        }
+    }
+
+    void NavMeshManager::updateDemand()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto& [agentHalfExtents, cached] : mCache)
+        {
+            auto it = mDemandedTiles.find(agentHalfExtents);
+            std::set<TilePosition> tiles;
+            if (it != mDemandedTiles.end())
+                tiles.swap(it->second);
+            if (isEvictionEnabled())
+                updateActiveTiles(agentHalfExtents, tiles, now);
+            mAsyncNavMeshUpdater.setDemandedTiles(agentHalfExtents, std::move(tiles));
+        }
+        mDemandedTiles.clear();
+    }
+
     void NavMeshManager::wait(Loading::Listener& listener, WaitConditionType waitConditionType)
     {
         mAsyncNavMeshUpdater.wait(listener, waitConditionType);
@@ -273,6 +349,18 @@ namespace DetourNavigator
     void NavMeshManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
     {
         DetourNavigator::reportStats(mAsyncNavMeshUpdater.getStats(), frameNumber, stats);
+
+        std::size_t residentTiles = 0;
+        std::size_t residentSize = 0;
+        for (const auto& [agentHalfExtents, cached] : mCache)
+        {
+            const auto locked = cached->lockConst();
+            residentTiles += locked->getUsedTilesCount();
+            residentSize += locked->getUsedTilesSize();
+        }
+        stats.setAttribute(frameNumber, "NavMesh ResidentTiles", static_cast<double>(residentTiles));
+        stats.setAttribute(frameNumber, "NavMesh ResidentSize", static_cast<double>(residentSize));
+        stats.setAttribute(frameNumber, "NavMesh Reloads", static_cast<double>(mReloads));
     }
 
     RecastMeshTiles NavMeshManager::getRecastMeshTiles() const
@@ -288,6 +376,81 @@ namespace DetourNavigator
         return result;
     }
 
+    bool NavMeshManager::isEvictionEnabled() const
+    {
+        return mSettings.mResidentTilesRadius > 0 || mSettings.mMaxResidentNavMeshSize > 0;
+    }
+
+    void NavMeshManager::updateActiveTiles(const osg::Vec3f& agentHalfExtents, const std::set<TilePosition>& demandedTiles,
+                                           std::chrono::steady_clock::time_point now)
+    {
+        auto& activeTiles = mActiveTiles[agentHalfExtents];
+        bool changed = false;
+        for (const TilePosition& tile : demandedTiles)
+            changed = activeTiles.insert_or_assign(tile, now).second || changed;
+        for (auto it = activeTiles.begin(); it != activeTiles.end();)
+        {
+            if (now - it->second > sActiveTileTimeout)
+            {
+                it = activeTiles.erase(it);
+                changed = true;
+            }
+            else
+                ++it;
+        }
+        if (changed)
+            mActiveTilesChanged.insert(agentHalfExtents);
+    }
+
+    std::set<TilePosition> NavMeshManager::getEvictedTiles(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& playerTile, int maxTiles, const NavMeshCacheItem& navMesh) const
+    {
+        std::set<TilePosition> result;
+        if (!isEvictionEnabled())
+            return result;
+
+        std::vector<TilePosition> activeTiles {playerTile};
+        if (const auto it = mActiveTiles.find(agentHalfExtents); it != mActiveTiles.end())
+            for (const auto& [tile, time] : it->second)
+                activeTiles.push_back(tile);
+
+        const int radius = mSettings.mResidentTilesRadius;
+        // Squared distance to the closest active tile
+        std::vector<std::pair<int, TilePosition>> residentTiles;
+        mRecastMeshManager.forEachTile([&] (const TilePosition& tile, const CachedRecastMeshManager&)
+        {
+            if (!shouldAddTile(tile, playerTile, maxTiles))
+                return;
+            int distance = std::numeric_limits<int>::max();
+            for (const TilePosition& activeTile : activeTiles)
+                distance = std::min(distance, getSquaredDistance(tile, activeTile));
+            if (radius > 0 && distance > radius * radius)
+                result.insert(tile);
+            else
+                residentTiles.emplace_back(distance, tile);
+        });
+
+        const std::size_t maxSize = mSettings.mMaxResidentNavMeshSize;
+        if (maxSize == 0)
+            return result;
+
+        std::sort(residentTiles.begin(), residentTiles.end());
+        // Tiles not built yet are assumed to be as large as the average present one
+        const std::size_t usedTiles = navMesh.getUsedTilesCount();
+        const std::size_t averageSize = usedTiles == 0 ? 0 : navMesh.getUsedTilesSize() / usedTiles;
+        std::size_t size = 0;
+        for (const auto& [distance, tile] : residentTiles)
+        {
+            const std::size_t tileSize = navMesh.isEmptyTile(tile) ? 0 : navMesh.getTileSize(tile).value_or(averageSize);
+            if (size > 0 && size + tileSize > maxSize)
+                result.insert(tile);
+            else
+                size += tileSize;
+        }
+
+        return result;
+    }
+
     void NavMeshManager::addChangedTiles(const btCollisionShape& shape, const btTransform& transform,
             const ChangeType changeType)
     {
@@ -12,8 +12,11 @@
 
 #include <osg/Vec3f>
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <set>
+#include <vector>
 
 class dtNavMesh;
 
@@ -34,6 +37,10 @@ namespace DetourNavigator
         bool updateObject(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
                           const AreaType areaType);
 
+        std::vector<bool> updateObjects(const std::vector<RecastMeshObjectUpdate>& updates);
+
+        const btTransform* getObjectTransform(const ObjectId id) const;
+
         bool removeObject(const ObjectId id);
 
         void addAgent(const osg::Vec3f& agentHalfExtents);
@@ -54,6 +61,10 @@ namespace DetourNavigator
 
         void update(const osg::Vec3f& playerPosition, const osg::Vec3f& agentHalfExtents);
 
+        void addDemand(const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start, const osg::Vec3f& end);
+
+        void updateDemand();
+
         void wait(Loading::Listener& listener, WaitConditionType waitConditionType);
 
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& agentHalfExtents) const;
@@ -75,6 +86,20 @@ namespace DetourNavigator
         std::size_t mGenerationCounter = 0;
         std::map<osg::Vec3f, TilePosition> mPlayerTile;
         std::map<osg::Vec3f, std::size_t> mLastRecastMeshManagerRevision;
+        std::map<osg::Vec3f, std::set<TilePosition>> mDemandedTiles;
+        // Tiles recently demanded by actors and the last time they were demanded
+        std::map<osg::Vec3f, std::map<TilePosition, std::chrono::steady_clock::time_point>> mActiveTiles;
+        std::set<osg::Vec3f> mActiveTilesChanged;
+        std::map<osg::Vec3f, std::set<TilePosition>> mEvictedTiles;
+        std::size_t mReloads = 0;
+
+        bool isEvictionEnabled() const;
+
+        void updateActiveTiles(const osg::Vec3f& agentHalfExtents, const std::set<TilePosition>& demandedTiles,
+                               std::chrono::steady_clock::time_point now);
+
+        std::set<TilePosition> getEvictedTiles(const osg::Vec3f& agentHalfExtents, const TilePosition& playerTile,
+                                               int maxTiles, const NavMeshCacheItem& navMesh) const;
 
         void addChangedTiles(const btCollisionShape& shape, const btTransform& transform, const ChangeType changeType);
 
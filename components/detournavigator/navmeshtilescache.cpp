@@ -1,31 +1,198 @@
 #include "navmeshtilescache.hpp"
 
+#include <components/misc/hash.hpp>
+
 #include <osg/Stats>
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 namespace DetourNavigator
 {
-    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
-        : mMaxNavMeshDataSize(maxNavMeshDataSize), mUsedNavMeshDataSize(0), mFreeNavMeshDataSize(0),
-          mHitCount(0), mGetCount(0) {}
+    struct NavMeshTilesCache::Shard
+    {
+        mutable std::mutex mMutex;
+        std::size_t mMaxNavMeshDataSize;
+        std::size_t mUsedNavMeshDataSize = 0;
+        std::size_t mFreeNavMeshDataSize = 0;
+        std::list<Item> mBusyItems;
+        std::list<Item> mFreeItems;
+        std::unordered_multimap<std::size_t, ItemIterator> mValues;
+
+        explicit Shard(std::size_t maxNavMeshDataSize)
+            : mMaxNavMeshDataSize(maxNavMeshDataSize) {}
+
+        void removeLeastRecentlyUsed()
+        {
+            const auto& item = mFreeItems.back();
+
+            const auto range = mValues.equal_range(item.mHash);
+            const auto value = std::find_if(range.first, range.second,
+                [&] (const auto& v) { return &*v.second == &item; });
+            if (value == range.second)
+                return;
+
+            mUsedNavMeshDataSize -= item.mSize;
+            mFreeNavMeshDataSize -= item.mSize;
+
+            mValues.erase(value);
+            mFreeItems.pop_back();
+        }
+
+        void acquireItemUnsafe(ItemIterator iterator)
+        {
+            if (++iterator->mUseCount > 1)
+                return;
+
+            mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
+            mFreeNavMeshDataSize -= iterator->mSize;
+        }
+    };
+
+    namespace
+    {
+        template <class Iterator>
+        void hashRange(std::size_t& seed, Iterator begin, Iterator end)
+        {
+            Misc::hashCombine(seed, static_cast<std::size_t>(end - begin));
+            for (auto it = begin; it != end; ++it)
+                Misc::hashCombine(seed, *it);
+        }
+
+        void hashCombine(std::size_t& seed, const osg::Vec2i& value)
+        {
+            Misc::hashCombine(seed, value.x());
+            Misc::hashCombine(seed, value.y());
+        }
+
+        std::size_t getTileHash(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile)
+        {
+            std::size_t seed = 0;
+            Misc::hashCombine(seed, agentHalfExtents.x());
+            Misc::hashCombine(seed, agentHalfExtents.y());
+            Misc::hashCombine(seed, agentHalfExtents.z());
+            hashCombine(seed, changedTile);
+            return seed;
+        }
+
+        std::size_t getHash(std::size_t tileHash, const RecastMesh& recastMesh)
+        {
+            std::size_t seed = tileHash;
+            const Mesh& mesh = recastMesh.getMesh();
+            hashRange(seed, mesh.getIndices().begin(), mesh.getIndices().end());
+            hashRange(seed, mesh.getVertices().begin(), mesh.getVertices().end());
+            hashRange(seed, mesh.getAreaTypes().begin(), mesh.getAreaTypes().end());
+            Misc::hashCombine(seed, recastMesh.getWater().size());
+            for (const CellWater& v : recastMesh.getWater())
+            {
+                hashCombine(seed, v.mCellPosition);
+                Misc::hashCombine(seed, v.mWater.mCellSize);
+                Misc::hashCombine(seed, v.mWater.mLevel);
+            }
+            Misc::hashCombine(seed, recastMesh.getHeightfields().size());
+            for (const Heightfield& v : recastMesh.getHeightfields())
+            {
+                hashCombine(seed, v.mCellPosition);
+                Misc::hashCombine(seed, v.mCellSize);
+                Misc::hashCombine(seed, v.mMinX);
+                Misc::hashCombine(seed, v.mMinY);
+                hashRange(seed, v.mHeights.begin(), v.mHeights.end());
+            }
+            Misc::hashCombine(seed, recastMesh.getFlatHeightfields().size());
+            for (const FlatHeightfield& v : recastMesh.getFlatHeightfields())
+            {
+                hashCombine(seed, v.mCellPosition);
+                Misc::hashCombine(seed, v.mCellSize);
+                Misc::hashCombine(seed, v.mHeight);
+            }
+            return seed;
+        }
+
+        bool isEqual(const Mesh& lhs, const Mesh& rhs)
+        {
+            return lhs.getIndices() == rhs.getIndices()
+                && lhs.getVertices() == rhs.getVertices()
+                && lhs.getAreaTypes() == rhs.getAreaTypes();
+        }
+
+        bool isEqual(const CellWater& lhs, const CellWater& rhs)
+        {
+            return std::tie(lhs.mCellPosition, lhs.mWater.mCellSize, lhs.mWater.mLevel)
+                == std::tie(rhs.mCellPosition, rhs.mWater.mCellSize, rhs.mWater.mLevel);
+        }
+
+        bool isEqual(const Heightfield& lhs, const Heightfield& rhs)
+        {
+            return makeTuple(lhs) == makeTuple(rhs);
+        }
+
+        bool isEqual(const FlatHeightfield& lhs, const FlatHeightfield& rhs)
+        {
+            return std::tie(lhs.mCellPosition, lhs.mCellSize, lhs.mHeight)
+                == std::tie(rhs.mCellPosition, rhs.mCellSize, rhs.mHeight);
+        }
+
+        template <class T>
+        bool isEqual(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                              [] (const T& l, const T& r) { return isEqual(l, r); });
+        }
+
+        bool isEqual(const NavMeshTilesCache::Item& item, const osg::Vec3f& agentHalfExtents,
+            const TilePosition& changedTile, const RecastMesh& recastMesh)
+        {
+            return item.mAgentHalfExtents == agentHalfExtents
+                && item.mChangedTile == changedTile
+                && isEqual(item.mRecastMeshData.mMesh, recastMesh.getMesh())
+                && isEqual(item.mRecastMeshData.mWater, recastMesh.getWater())
+                && isEqual(item.mRecastMeshData.mHeightfields, recastMesh.getHeightfields())
+                && isEqual(item.mRecastMeshData.mFlatHeightfields, recastMesh.getFlatHeightfields());
+        }
+
+        template <class Values>
+        auto findItem(Values& values, std::size_t hash, const osg::Vec3f& agentHalfExtents,
+            const TilePosition& changedTile, const RecastMesh& recastMesh)
+        {
+            const auto range = values.equal_range(hash);
+            const auto it = std::find_if(range.first, range.second, [&] (const auto& v)
+                { return isEqual(*v.second, agentHalfExtents, changedTile, recastMesh); });
+            return it == range.second ? values.end() : it;
+        }
+    }
+
+    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize, std::size_t shards)
+    {
+        shards = std::max<std::size_t>(1, shards);
+        mShards.reserve(shards);
+        for (std::size_t i = 0; i < shards; ++i)
+            mShards.push_back(std::make_unique<Shard>(maxNavMeshDataSize / shards));
+    }
+
+    NavMeshTilesCache::~NavMeshTilesCache() = default;
 
     NavMeshTilesCache::Value NavMeshTilesCache::get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
         const RecastMesh& recastMesh)
     {
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const std::size_t tileHash = getTileHash(agentHalfExtents, changedTile);
+        const std::size_t hash = getHash(tileHash, recastMesh);
+        Shard& shard = *mShards[tileHash % mShards.size()];
 
-        ++mGetCount;
+        mGetCount.fetch_add(1, std::memory_order_relaxed);
 
-        const auto tile = mValues.find(std::make_tuple(agentHalfExtents, changedTile, recastMesh));
-        if (tile == mValues.end())
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
+
+        const auto tile = findItem(shard.mValues, hash, agentHalfExtents, changedTile, recastMesh);
+        if (tile == shard.mValues.end())
             return Value();
 
-        acquireItemUnsafe(tile->second);
+        shard.acquireItemUnsafe(tile->second);
 
-        ++mHitCount;
+        mHitCount.fetch_add(1, std::memory_order_relaxed);
 
-        return Value(*this, tile->second);
+        return Value(shard, tile->second);
     }
 
     NavMeshTilesCache::Value NavMeshTilesCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
@@ -33,49 +200,53 @@ namespace DetourNavigator
     {
         const auto itemSize = sizeof(RecastMesh) + getSize(recastMesh)
             + (value == nullptr ? 0 : sizeof(PreparedNavMeshData) + getSize(*value));
+        const std::size_t tileHash = getTileHash(agentHalfExtents, changedTile);
+        const std::size_t hash = getHash(tileHash, recastMesh);
+        Shard& shard = *mShards[tileHash % mShards.size()];
 
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
 
-        if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
+        if (itemSize > shard.mFreeNavMeshDataSize + (shard.mMaxNavMeshDataSize - shard.mUsedNavMeshDataSize))
             return Value();
 
-        while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
-            removeLeastRecentlyUsed();
+        const auto existing = findItem(shard.mValues, hash, agentHalfExtents, changedTile, recastMesh);
+        if (existing != shard.mValues.end())
+        {
+            shard.acquireItemUnsafe(existing->second);
+            mGetCount.fetch_add(1, std::memory_order_relaxed);
+            mHitCount.fetch_add(1, std::memory_order_relaxed);
+            return Value(shard, existing->second);
+        }
+
+        while (!shard.mFreeItems.empty() && shard.mUsedNavMeshDataSize + itemSize > shard.mMaxNavMeshDataSize)
+            shard.removeLeastRecentlyUsed();
 
         RecastMeshData key {recastMesh.getMesh(), recastMesh.getWater(),
                     recastMesh.getHeightfields(), recastMesh.getFlatHeightfields()};
 
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, std::move(key), itemSize);
-        const auto emplaced = mValues.emplace(std::make_tuple(agentHalfExtents, changedTile, std::cref(iterator->mRecastMeshData)), iterator);
-
-        if (!emplaced.second)
-        {
-            mFreeItems.erase(iterator);
-            acquireItemUnsafe(emplaced.first->second);
-            ++mGetCount;
-            ++mHitCount;
-            return Value(*this, emplaced.first->second);
-        }
+        const auto iterator = shard.mBusyItems.emplace(shard.mBusyItems.end(), agentHalfExtents, changedTile,
+                                                       std::move(key), hash, itemSize);
+        shard.mValues.emplace(hash, iterator);
 
         iterator->mPreparedNavMeshData = std::move(value);
         ++iterator->mUseCount;
-        mUsedNavMeshDataSize += itemSize;
-        mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
+        shard.mUsedNavMeshDataSize += itemSize;
 
-        return Value(*this, iterator);
+        return Value(shard, iterator);
     }
 
     NavMeshTilesCache::Stats NavMeshTilesCache::getStats() const
     {
-        Stats result;
+        Stats result {};
+        for (const auto& shard : mShards)
         {
-            const std::lock_guard<std::mutex> lock(mMutex);
-            result.mNavMeshCacheSize = mUsedNavMeshDataSize;
-            result.mUsedNavMeshTiles = mBusyItems.size();
-            result.mCachedNavMeshTiles = mFreeItems.size();
-            result.mHitCount = mHitCount;
-            result.mGetCount = mGetCount;
+            const std::lock_guard<std::mutex> lock(shard->mMutex);
+            result.mNavMeshCacheSize += shard->mUsedNavMeshDataSize;
+            result.mUsedNavMeshTiles += shard->mBusyItems.size();
+            result.mCachedNavMeshTiles += shard->mFreeItems.size();
         }
+        result.mHitCount = mHitCount.load(std::memory_order_relaxed);
+        result.mGetCount = mGetCount.load(std::memory_order_relaxed);
         return result;
     }
 
@@ -88,38 +259,14 @@ namespace DetourNavigator
             out.setAttribute(frameNumber, "NavMesh CacheHitRate", static_cast<double>(stats.mHitCount) / stats.mGetCount * 100.0);
     }
 
-    void NavMeshTilesCache::removeLeastRecentlyUsed()
-    {
-        const auto& item = mFreeItems.back();
-
-        const auto value = mValues.find(std::make_tuple(item.mAgentHalfExtents, item.mChangedTile, std::cref(item.mRecastMeshData)));
-        if (value == mValues.end())
-            return;
-
-        mUsedNavMeshDataSize -= item.mSize;
-        mFreeNavMeshDataSize -= item.mSize;
-
-        mValues.erase(value);
-        mFreeItems.pop_back();
-    }
-
-    void NavMeshTilesCache::acquireItemUnsafe(ItemIterator iterator)
-    {
-        if (++iterator->mUseCount > 1)
-            return;
-
-        mBusyItems.splice(mBusyItems.end(), mFreeItems, iterator);
-        mFreeNavMeshDataSize -= iterator->mSize;
-    }
-
-    void NavMeshTilesCache::releaseItem(ItemIterator iterator)
+    void NavMeshTilesCache::releaseItem(Shard& shard, ItemIterator iterator)
     {
         if (--iterator->mUseCount > 0)
             return;
 
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const std::lock_guard<std::mutex> lock(shard.mMutex);
 
-        mFreeItems.splice(mFreeItems.begin(), mBusyItems, iterator);
-        mFreeNavMeshDataSize += iterator->mSize;
+        shard.mFreeItems.splice(shard.mFreeItems.begin(), shard.mBusyItems, iterator);
+        shard.mFreeNavMeshDataSize += iterator->mSize;
     }
 }
@@ -6,11 +6,10 @@
 #include "tileposition.hpp"
 
 #include <atomic>
-#include <map>
 #include <list>
-#include <mutex>
 #include <cassert>
 #include <cstring>
+#include <memory>
 #include <vector>
 
 namespace osg
@@ -48,6 +47,8 @@ namespace DetourNavigator
 
     class NavMeshTilesCache
     {
+        struct Shard;
+
     public:
         struct Item
         {
@@ -55,15 +56,17 @@ namespace DetourNavigator
             osg::Vec3f mAgentHalfExtents;
             TilePosition mChangedTile;
             RecastMeshData mRecastMeshData;
+            std::size_t mHash;
             std::unique_ptr<PreparedNavMeshData> mPreparedNavMeshData;
             std::size_t mSize;
 
             Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
-                 RecastMeshData&& recastMeshData, std::size_t size)
+                 RecastMeshData&& recastMeshData, std::size_t hash, std::size_t size)
                 : mUseCount(0)
                 , mAgentHalfExtents(agentHalfExtents)
                 , mChangedTile(changedTile)
                 , mRecastMeshData(std::move(recastMeshData))
+                , mHash(hash)
                 , mSize(size)
             {}
         };
@@ -74,38 +77,38 @@ namespace DetourNavigator
         {
         public:
             Value()
-                : mOwner(nullptr), mIterator() {}
+                : mShard(nullptr), mIterator() {}
 
-            Value(NavMeshTilesCache& owner, ItemIterator iterator)
-                : mOwner(&owner), mIterator(iterator)
+            Value(Shard& shard, ItemIterator iterator)
+                : mShard(&shard), mIterator(iterator)
             {
             }
 
             Value(const Value& other) = delete;
 
             Value(Value&& other)
-                : mOwner(other.mOwner), mIterator(other.mIterator)
+                : mShard(other.mShard), mIterator(other.mIterator)
             {
-                other.mOwner = nullptr;
+                other.mShard = nullptr;
             }
 
             ~Value()
             {
-                if (mOwner)
-                    mOwner->releaseItem(mIterator);
+                if (mShard)
+                    releaseItem(*mShard, mIterator);
             }
 
             Value& operator =(const Value& other) = delete;
 
             Value& operator =(Value&& other)
             {
-                if (mOwner)
-                    mOwner->releaseItem(mIterator);
+                if (mShard)
+                    releaseItem(*mShard, mIterator);
 
-                mOwner = other.mOwner;
+                mShard = other.mShard;
                 mIterator = other.mIterator;
 
-                other.mOwner = nullptr;
+                other.mShard = nullptr;
 
                 return *this;
             }
@@ -117,11 +120,11 @@ namespace DetourNavigator
 
             operator bool() const
             {
-                return mOwner;
+                return mShard;
             }
 
         private:
-            NavMeshTilesCache* mOwner;
+            Shard* mShard;
             ItemIterator mIterator;
         };
 
@@ -134,7 +137,11 @@ namespace DetourNavigator
             std::size_t mGetCount;
         };
 
-        NavMeshTilesCache(const std::size_t maxNavMeshDataSize);
+        /// Each shard has its own lock, LRU lists and an equal part of maxNavMeshDataSize. All items for the same
+        /// agent and tile go to the same shard.
+        explicit NavMeshTilesCache(const std::size_t maxNavMeshDataSize, std::size_t shards = 1);
+
+        ~NavMeshTilesCache();
 
         Value get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
             const RecastMesh& recastMesh);
@@ -145,21 +152,13 @@ namespace DetourNavigator
         Stats getStats() const;
 
     private:
-        mutable std::mutex mMutex;
-        std::size_t mMaxNavMeshDataSize;
-        std::size_t mUsedNavMeshDataSize;
-        std::size_t mFreeNavMeshDataSize;
-        std::size_t mHitCount;
-        std::size_t mGetCount;
-        std::list<Item> mBusyItems;
-        std::list<Item> mFreeItems;
-        std::map<std::tuple<osg::Vec3f, TilePosition, std::reference_wrapper<const RecastMeshData>>, ItemIterator, std::less<>> mValues;
-
-        void removeLeastRecentlyUsed();
+        std::vector<std::unique_ptr<Shard>> mShards;
+        std::atomic<std::size_t> mHitCount {0};
+        std::atomic<std::size_t> mGetCount {0};
 
-        void acquireItemUnsafe(ItemIterator iterator);
+        Shard& getShard(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile);
 
-        void releaseItem(ItemIterator iterator);
+        static void releaseItem(Shard& shard, ItemIterator iterator);
     };
 
     void reportStats(const NavMeshTilesCache::Stats& stats, unsigned int frameNumber, osg::Stats& out);
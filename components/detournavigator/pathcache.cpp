@@ -0,0 +1,99 @@
+#include "pathcache.hpp"
+#include "navmeshcacheitem.hpp"
+#include "settings.hpp"
+#include "settingsutils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        osg::Vec3i quantize(const osg::Vec3f& position, float quantum)
+        {
+            return osg::Vec3i(static_cast<int>(std::floor(position.x() / quantum)),
+                              static_cast<int>(std::floor(position.y() / quantum)),
+                              static_cast<int>(std::floor(position.z() / quantum)));
+        }
+    }
+
+    PathCache::PathCache(std::size_t maxSize, float positionQuantum)
+        : mMaxSize(maxSize)
+        , mPositionQuantum(std::max(positionQuantum, 1.0f))
+    {
+    }
+
+    PathCacheKey PathCache::makeKey(const osg::Vec3f& agentHalfExtents, float stepSize, const osg::Vec3f& start,
+        const osg::Vec3f& end, Flags includeFlags, const AreaCosts& areaCosts, float endTolerance) const
+    {
+        return PathCacheKey {agentHalfExtents, stepSize, quantize(start, mPositionQuantum),
+            quantize(end, mPositionQuantum), includeFlags, areaCosts, endTolerance};
+    }
+
+    std::optional<CachedPath> PathCache::get(const PathCacheKey& key, const NavMeshCacheItem& navMesh)
+    {
+        const std::lock_guard lock(mMutex);
+
+        const auto it = mEntries.find(key);
+        if (it == mEntries.end())
+            return {};
+
+        const Entry& entry = it->second;
+        const bool valid = entry.mNavMeshGeneration == navMesh.getVersion().mGeneration
+            && std::all_of(entry.mTiles.begin(), entry.mTiles.end(),
+                [&] (const auto& tile) { return navMesh.getTileVersion(tile.first) == tile.second; });
+        if (!valid)
+        {
+            erase(it);
+            return {};
+        }
+
+        mLastUsed.splice(mLastUsed.begin(), mLastUsed, entry.mLastUsed);
+
+        return entry.mPath;
+    }
+
+    void PathCache::set(const PathCacheKey& key, const NavMeshCacheItem& navMesh, const RecastSettings& settings,
+        const osg::Vec3f& start, const osg::Vec3f& end, const CachedPath& path)
+    {
+        if (mMaxSize == 0)
+            return;
+
+        std::vector<TilePosition> positions;
+        positions.reserve(path.mPoints.size() + 2);
+        const auto addTile = [&] (const osg::Vec3f& position)
+        {
+            positions.push_back(getTilePosition(settings, toNavMeshCoordinates(settings, position)));
+        };
+        addTile(start);
+        addTile(end);
+        std::for_each(path.mPoints.begin(), path.mPoints.end(), addTile);
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+        Entry entry;
+        entry.mPath = path;
+        entry.mNavMeshGeneration = navMesh.getVersion().mGeneration;
+        entry.mTiles.reserve(positions.size());
+        for (const TilePosition& position : positions)
+            entry.mTiles.emplace_back(position, navMesh.getTileVersion(position));
+
+        const std::lock_guard lock(mMutex);
+
+        if (const auto it = mEntries.find(key); it != mEntries.end())
+            erase(it);
+
+        while (mEntries.size() >= mMaxSize)
+            erase(mEntries.find(mLastUsed.back()));
+
+        entry.mLastUsed = mLastUsed.insert(mLastUsed.begin(), key);
+        mEntries.emplace(key, std::move(entry));
+    }
+
+    void PathCache::erase(Entries::iterator it)
+    {
+        mLastUsed.erase(it->second.mLastUsed);
+        mEntries.erase(it);
+    }
+}
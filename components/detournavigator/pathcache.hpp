@@ -0,0 +1,93 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_PATHCACHE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_PATHCACHE_H
+
+#include "areatype.hpp"
+#include "flags.hpp"
+#include "status.hpp"
+#include "tileposition.hpp"
+#include "version.hpp"
+
+#include <osg/Vec3f>
+#include <osg/Vec3i>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class NavMeshCacheItem;
+    struct RecastSettings;
+
+    struct PathCacheKey
+    {
+        osg::Vec3f mAgentHalfExtents;
+        float mStepSize;
+        osg::Vec3i mStart;
+        osg::Vec3i mEnd;
+        Flags mIncludeFlags;
+        AreaCosts mAreaCosts;
+        float mEndTolerance;
+
+        friend inline auto tie(const PathCacheKey& value)
+        {
+            return std::tie(value.mAgentHalfExtents, value.mStepSize, value.mStart, value.mEnd, value.mIncludeFlags,
+                value.mAreaCosts.mWater, value.mAreaCosts.mDoor, value.mAreaCosts.mPathgrid, value.mAreaCosts.mGround,
+                value.mEndTolerance);
+        }
+
+        friend inline bool operator<(const PathCacheKey& lhs, const PathCacheKey& rhs)
+        {
+            return tie(lhs) < tie(rhs);
+        }
+    };
+
+    struct CachedPath
+    {
+        Status mStatus;
+        std::vector<osg::Vec3f> mPoints;
+    };
+
+    /// Keeps recently found paths for requests with close start and end positions. A path is valid while the navmesh
+    /// generation and versions of all tiles it goes through, including ones containing start and end, are the same.
+    class PathCache
+    {
+    public:
+        PathCache(std::size_t maxSize, float positionQuantum);
+
+        PathCacheKey makeKey(const osg::Vec3f& agentHalfExtents, float stepSize, const osg::Vec3f& start,
+            const osg::Vec3f& end, Flags includeFlags, const AreaCosts& areaCosts, float endTolerance) const;
+
+        std::optional<CachedPath> get(const PathCacheKey& key, const NavMeshCacheItem& navMesh);
+
+        void set(const PathCacheKey& key, const NavMeshCacheItem& navMesh, const RecastSettings& settings,
+            const osg::Vec3f& start, const osg::Vec3f& end, const CachedPath& path);
+
+    private:
+        struct Entry
+        {
+            CachedPath mPath;
+            std::size_t mNavMeshGeneration;
+            std::vector<std::pair<TilePosition, std::optional<Version>>> mTiles;
+            std::list<PathCacheKey>::iterator mLastUsed;
+        };
+
+        using Entries = std::map<PathCacheKey, Entry>;
+
+        const std::size_t mMaxSize;
+        const float mPositionQuantum;
+        std::mutex mMutex;
+        Entries mEntries;
+        // Most recently used first
+        std::list<PathCacheKey> mLastUsed;
+
+        void erase(Entries::iterator it);
+    };
+}
+
+#endif
@@ -3,7 +3,9 @@
 
 #include "recasttempallocator.hpp"
 
+#include <cstddef>
 #include <cstdlib>
+#include <new>
 
 namespace DetourNavigator
 {
@@ -65,6 +67,44 @@ namespace DetourNavigator
             return getPermPtrDataPtr(ptr);
         }
     };
+
+    /// Allocator for standard containers taking memory from the thread local temp stack shared with Recast and
+    /// falling back to heap when it's exhausted. Memory is reused across tiles, so it fits short living buffers
+    /// allocated and released by the same thread.
+    template <class T>
+    struct RecastTempStdAllocator
+    {
+        static_assert(alignof(T) <= alignof(std::size_t));
+
+        using value_type = T;
+
+        RecastTempStdAllocator() = default;
+
+        template <class U>
+        RecastTempStdAllocator(const RecastTempStdAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            if (void* const result = RecastGlobalAllocator::alloc(n * sizeof(T), RC_ALLOC_TEMP))
+                return static_cast<T*>(result);
+            throw std::bad_alloc();
+        }
+
+        void deallocate(T* ptr, std::size_t /*n*/) noexcept
+        {
+            RecastGlobalAllocator::free(ptr);
+        }
+
+        friend bool operator==(const RecastTempStdAllocator&, const RecastTempStdAllocator&) noexcept
+        {
+            return true;
+        }
+
+        friend bool operator!=(const RecastTempStdAllocator&, const RecastTempStdAllocator&) noexcept
+        {
+            return false;
+        }
+    };
 }
 
 #endif
@@ -1,6 +1,7 @@
 #include "recastmeshbuilder.hpp"
 #include "debug.hpp"
 #include "exceptions.hpp"
+#include "recastglobalallocator.hpp"
 
 #include <components/bullethelpers/transformboundingbox.hpp>
 #include <components/bullethelpers/processtrianglecallback.hpp>
@@ -12,6 +13,8 @@
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
 #include <BulletCollision/CollisionShapes/btConcaveShape.h>
 #include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+#include <BulletCollision/CollisionShapes/btTriangleMeshShape.h>
 #include <LinearMath/btTransform.h>
 #include <LinearMath/btAabbUtil2.h>
 
@@ -21,6 +24,7 @@
 #include <vector>
 #include <sstream>
 #include <cmath>
+#include <utility>
 
 namespace DetourNavigator
 {
@@ -42,6 +46,29 @@ namespace DetourNavigator
             return static_cast<float>(cellSize) / (dataSize - 1);
         }
 
+        std::size_t getMaxTrianglesNumber(const btConcaveShape& shape)
+        {
+            if (shape.getShapeType() != TRIANGLE_MESH_SHAPE_PROXYTYPE)
+                return 0;
+            const auto* const meshInterface = dynamic_cast<const btTriangleIndexVertexArray*>(
+                static_cast<const btTriangleMeshShape&>(shape).getMeshInterface());
+            if (meshInterface == nullptr)
+                return 0;
+            std::size_t result = 0;
+            const IndexedMeshArray& meshes = meshInterface->getIndexedMeshArray();
+            for (int i = 0; i < meshes.size(); ++i)
+                result += static_cast<std::size_t>(meshes[i].m_numTriangles);
+            return result;
+        }
+
+        template <class T>
+        void reserveMore(std::vector<T>& values, std::size_t count)
+        {
+            const std::size_t required = values.size() + count;
+            if (required > values.capacity())
+                values.reserve(std::max(required, 2 * values.capacity()));
+        }
+
         bool isNan(const RecastMeshTriangle& triangle)
         {
             for (std::size_t i = 0; i < 3; ++i)
@@ -55,46 +82,53 @@ namespace DetourNavigator
 
     Mesh makeMesh(std::vector<RecastMeshTriangle>&& triangles, const osg::Vec3f& shift)
     {
-        std::vector<osg::Vec3f> uniqueVertices;
-        uniqueVertices.reserve(3 * triangles.size());
+        // Each vertex with its position in the triangles, a single sort groups equal vertices in the same order
+        // as they appear in the result
+        using Slot = std::pair<osg::Vec3f, std::size_t>;
+        std::vector<Slot, RecastTempStdAllocator<Slot>> slots;
+        slots.reserve(3 * triangles.size());
 
         for (const RecastMeshTriangle& triangle : triangles)
             for (const osg::Vec3f& vertex : triangle.mVertices)
-                uniqueVertices.push_back(vertex);
+                slots.emplace_back(vertex, slots.size());
 
-        std::sort(uniqueVertices.begin(), uniqueVertices.end());
-        uniqueVertices.erase(std::unique(uniqueVertices.begin(), uniqueVertices.end()), uniqueVertices.end());
+        std::sort(slots.begin(), slots.end(),
+            [] (const Slot& lhs, const Slot& rhs) { return lhs.first < rhs.first; });
 
-        std::vector<int> indices;
-        indices.reserve(3 * triangles.size());
-        std::vector<AreaType> areaTypes;
-        areaTypes.reserve(triangles.size());
+        std::vector<int> indices(slots.size());
+        std::size_t uniqueVertices = 0;
 
-        for (const RecastMeshTriangle& triangle : triangles)
+        for (std::size_t i = 0; i < slots.size(); ++i)
         {
-            areaTypes.push_back(triangle.mAreaType);
-
-            for (const osg::Vec3f& vertex : triangle.mVertices)
-            {
-                const auto it = std::lower_bound(uniqueVertices.begin(), uniqueVertices.end(), vertex);
-                assert(it != uniqueVertices.end());
-                assert(*it == vertex);
-                indices.push_back(static_cast<int>(it - uniqueVertices.begin()));
-            }
+            if (i > 0 && slots[i - 1].first != slots[i].first)
+                ++uniqueVertices;
+            indices[slots[i].second] = static_cast<int>(uniqueVertices);
         }
 
-        triangles.clear();
+        if (!slots.empty())
+            ++uniqueVertices;
 
         std::vector<float> vertices;
-        vertices.reserve(3 * uniqueVertices.size());
+        vertices.reserve(3 * uniqueVertices);
 
-        for (const osg::Vec3f& vertex : uniqueVertices)
+        for (std::size_t i = 0; i < slots.size(); ++i)
         {
+            if (i > 0 && slots[i - 1].first == slots[i].first)
+                continue;
+            const osg::Vec3f& vertex = slots[i].first;
             vertices.push_back(vertex.x() + shift.x());
             vertices.push_back(vertex.y() + shift.y());
             vertices.push_back(vertex.z() + shift.z());
         }
 
+        std::vector<AreaType> areaTypes;
+        areaTypes.reserve(triangles.size());
+
+        for (const RecastMeshTriangle& triangle : triangles)
+            areaTypes.push_back(triangle.mAreaType);
+
+        triangles.clear();
+
         return Mesh(std::move(indices), std::move(vertices), std::move(areaTypes));
     }
 
@@ -177,6 +211,7 @@ namespace DetourNavigator
     void RecastMeshBuilder::addObject(const btConcaveShape& shape, const btTransform& transform,
                                       const AreaType areaType)
     {
+        reserveMore(mTriangles, getMaxTrianglesNumber(shape));
         return addObject(shape, transform, makeProcessTriangleCallback([&] (btVector3* vertices, int, int)
         {
             RecastMeshTriangle triangle = makeRecastMeshTriangle(vertices, areaType);
@@ -211,6 +246,8 @@ namespace DetourNavigator
             4, 5, 7,
         }};
 
+        reserveMore(mTriangles, indices.size() / 3);
+
         for (std::size_t i = 0; i < indices.size(); i += 3)
         {
             std::array<btVector3, 3> vertices;
@@ -11,8 +11,11 @@
 #include <components/serialization/format.hpp>
 #include <components/serialization/sizeaccumulator.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <functional>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
@@ -20,45 +23,61 @@ namespace DetourNavigator
 {
 namespace
 {
+    // Same layout as the input serialized from RecastMesh
+    struct RecastMeshInput
+    {
+        RecastSettings mSettings;
+        std::vector<CellWater> mWater;
+        std::vector<Heightfield> mHeightfields;
+        std::vector<FlatHeightfield> mFlatHeightfields;
+        std::vector<DbRefGeometryObject> mDbRefGeometryObjects;
+    };
+
     template <Serialization::Mode mode>
     struct Format : Serialization::Format<mode, Format<mode>>
     {
         using Serialization::Format<mode, Format<mode>>::operator();
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const osg::Vec2i& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, osg::Vec2i>>
         {
             visitor(*this, value.ptr(), 2);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const osg::Vec2f& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, osg::Vec2f>>
         {
             visitor(*this, value.ptr(), 2);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const osg::Vec3f& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, osg::Vec3f>>
         {
             visitor(*this, value.ptr(), 3);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const Water& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, Water>>
         {
             visitor(*this, value.mCellSize);
             visitor(*this, value.mLevel);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const CellWater& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, CellWater>>
         {
             visitor(*this, value.mCellPosition);
             visitor(*this, value.mWater);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const RecastSettings& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, RecastSettings>>
         {
             visitor(*this, value.mCellHeight);
             visitor(*this, value.mCellSize);
@@ -77,15 +96,17 @@ namespace
             visitor(*this, value.mTileSize);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const TileBounds& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, TileBounds>>
         {
             visitor(*this, value.mMin);
             visitor(*this, value.mMax);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const Heightfield& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, Heightfield>>
         {
             visitor(*this, value.mCellPosition);
             visitor(*this, value.mCellSize);
@@ -98,8 +119,9 @@ namespace
             visitor(*this, value.mMinY);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const FlatHeightfield& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, FlatHeightfield>>
         {
             visitor(*this, value.mCellPosition);
             visitor(*this, value.mCellSize);
@@ -114,22 +136,25 @@ namespace
             visitor(*this, value.getFlatHeightfields());
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const ESM::Position& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, ESM::Position>>
         {
             visitor(*this, value.pos);
             visitor(*this, value.rot);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const ObjectTransform& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, ObjectTransform>>
         {
             visitor(*this, value.mPosition);
             visitor(*this, value.mScale);
         }
 
-        template <class Visitor>
-        void operator()(Visitor&& visitor, const DbRefGeometryObject& value) const
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, DbRefGeometryObject>>
         {
             visitor(*this, value.mShapeId);
             visitor(*this, value.mObjectTransform);
@@ -146,6 +171,34 @@ namespace
             visitor(*this, dbRefGeometryObjects);
         }
 
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, RecastMeshInput>>
+        {
+            if constexpr (mode == Serialization::Mode::Write)
+            {
+                visitor(*this, DetourNavigator::recastMeshMagic);
+                visitor(*this, DetourNavigator::recastMeshVersion);
+            }
+            else
+            {
+                static_assert(mode == Serialization::Mode::Read);
+                char magic[std::size(DetourNavigator::recastMeshMagic)];
+                visitor(*this, magic);
+                if (std::memcmp(magic, DetourNavigator::recastMeshMagic, sizeof(magic)) != 0)
+                    throw std::runtime_error("Bad RecastMesh magic");
+                std::uint32_t version = 0;
+                visitor(*this, version);
+                if (version != DetourNavigator::recastMeshVersion)
+                    throw std::runtime_error("Bad RecastMesh version");
+            }
+            visitor(*this, value.mSettings);
+            visitor(*this, value.mWater);
+            visitor(*this, value.mHeightfields);
+            visitor(*this, value.mFlatHeightfields);
+            visitor(*this, value.mDbRefGeometryObjects);
+        }
+
         template <class Visitor, class T>
         auto operator()(Visitor&& visitor, T& value) const
             -> std::enable_if_t<std::is_same_v<std::decay_t<T>, rcPolyMesh>>
@@ -256,6 +309,30 @@ namespace DetourNavigator
         return result;
     }
 
+    bool replaceShapeIds(std::vector<std::byte>& input, const std::function<std::int64_t (std::int64_t)>& getShapeId)
+    {
+        RecastMeshInput value;
+        try
+        {
+            constexpr Format<Serialization::Mode::Read> format;
+            format(Serialization::BinaryReader(input.data(), input.data() + input.size()), value);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        for (DbRefGeometryObject& object : value.mDbRefGeometryObjects)
+            object.mShapeId = getShapeId(object.mShapeId);
+        // Keep the order makeDbRefGeometryObjects produces for the new ids
+        std::sort(value.mDbRefGeometryObjects.begin(), value.mDbRefGeometryObjects.end());
+        constexpr Format<Serialization::Mode::Write> format;
+        Serialization::SizeAccumulator sizeAccumulator;
+        format(sizeAccumulator, value);
+        input.resize(sizeAccumulator.value());
+        format(Serialization::BinaryWriter(input.data(), input.data() + input.size()), value);
+        return true;
+    }
+
     bool deserialize(const std::vector<std::byte>& data, PreparedNavMeshData& value)
     {
         try
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 namespace DetourNavigator
@@ -24,6 +25,9 @@ namespace DetourNavigator
     std::vector<std::byte> serialize(const PreparedNavMeshData& value);
 
     bool deserialize(const std::vector<std::byte>& data, PreparedNavMeshData& value);
+
+    /// Replaces shape ids referenced by input serialized from RecastMesh, returns false for malformed input
+    bool replaceShapeIds(std::vector<std::byte>& input, const std::function<std::int64_t (std::int64_t)>& getShapeId);
 }
 
 #endif
@@ -2,6 +2,7 @@
 
 #include <components/settings/settings.hpp>
 #include <components/misc/constants.hpp>
+#include <components/misc/threadbudget.hpp>
 
 #include <algorithm>
 
@@ -51,8 +52,11 @@ namespace DetourNavigator
         result.mRecast = makeRecastSettingsFromSettingsManager();
         result.mDetour = makeDetourSettingsFromSettingsManager();
         result.mMaxTilesNumber = std::max(0, ::Settings::Manager::getInt("max tiles number", "Navigator"));
+        result.mResidentTilesRadius = std::max(0, ::Settings::Manager::getInt("resident tiles radius", "Navigator"));
+        result.mMaxResidentNavMeshSize = static_cast<std::size_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("max resident nav mesh size", "Navigator")));
         result.mWaitUntilMinDistanceToPlayer = ::Settings::Manager::getInt("wait until min distance to player", "Navigator");
-        result.mAsyncNavMeshUpdaterThreads = static_cast<std::size_t>(std::max(0, ::Settings::Manager::getInt("async nav mesh updater threads", "Navigator")));
+        result.mAsyncNavMeshUpdaterThreads = Misc::ThreadBudget::instance().getThreadCount(Misc::ThreadGroup::Navigator,
+            ::Settings::Manager::getInt("async nav mesh updater threads", "Navigator"));
         result.mMaxNavMeshTilesCacheSize = static_cast<std::size_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("max nav mesh tiles cache size", "Navigator")));
         result.mEnableWriteRecastMeshToFile = ::Settings::Manager::getBool("enable write recast mesh to file", "Navigator");
         result.mEnableWriteNavMeshToFile = ::Settings::Manager::getBool("enable write nav mesh to file", "Navigator");
@@ -64,6 +68,11 @@ namespace DetourNavigator
         result.mNavMeshVersion = ::Settings::Manager::getInt("nav mesh version", "Navigator");
         result.mEnableNavMeshDiskCache = ::Settings::Manager::getBool("enable nav mesh disk cache", "Navigator");
         result.mWriteToNavMeshDb = ::Settings::Manager::getBool("write to navmeshdb", "Navigator");
+        result.mNavMeshDbCacheSize = static_cast<std::size_t>(std::max(std::int64_t {0}, ::Settings::Manager::getInt64("navmeshdb cache size", "Navigator")));
+        result.mNavMeshDbWritesPerTransaction = static_cast<std::size_t>(std::max(1, ::Settings::Manager::getInt("navmeshdb writes per transaction", "Navigator")));
+        result.mEnablePathCache = ::Settings::Manager::getBool("enable path cache", "Navigator");
+        result.mMaxPathCacheSize = static_cast<std::size_t>(std::max(0, ::Settings::Manager::getInt("max path cache size", "Navigator")));
+        result.mPathCachePositionQuantum = std::max(1.0f, ::Settings::Manager::getFloat("path cache position quantum", "Navigator"));
 
         return result;
     }
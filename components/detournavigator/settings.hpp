@@ -41,12 +41,19 @@ namespace DetourNavigator
         bool mEnableNavMeshFileNameRevision = false;
         bool mEnableNavMeshDiskCache = false;
         bool mWriteToNavMeshDb = false;
+        bool mEnablePathCache = false;
         RecastSettings mRecast;
         DetourSettings mDetour;
         int mWaitUntilMinDistanceToPlayer = 0;
         int mMaxTilesNumber = 0;
+        int mResidentTilesRadius = 0;
         std::size_t mAsyncNavMeshUpdaterThreads = 0;
         std::size_t mMaxNavMeshTilesCacheSize = 0;
+        std::size_t mNavMeshDbCacheSize = 0;
+        std::size_t mNavMeshDbWritesPerTransaction = 0;
+        std::size_t mMaxResidentNavMeshSize = 0;
+        std::size_t mMaxPathCacheSize = 0;
+        float mPathCachePositionQuantum = 0;
         std::string mRecastMeshPathPrefix;
         std::string mNavMeshPathPrefix;
         std::chrono::milliseconds mMinUpdateInterval;
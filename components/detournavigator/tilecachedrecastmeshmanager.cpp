@@ -124,6 +124,14 @@ namespace DetourNavigator
         return result;
     }
 
+    const btTransform* TileCachedRecastMeshManager::getObjectTransform(const ObjectId id) const
+    {
+        const auto object = mObjects.find(id);
+        if (object == mObjects.end())
+            return nullptr;
+        return &object->second.mTransform;
+    }
+
     bool TileCachedRecastMeshManager::addWater(const osg::Vec2i& cellPosition, int cellSize, float level)
     {
         const auto it = mWaterTilesPositions.find(cellPosition);
@@ -19,6 +19,14 @@
 
 namespace DetourNavigator
 {
+    struct RecastMeshObjectUpdate
+    {
+        ObjectId mId;
+        CollisionShape mShape;
+        btTransform mTransform;
+        AreaType mAreaType;
+    };
+
     class TileCachedRecastMeshManager
     {
     public:
@@ -62,52 +70,33 @@ namespace DetourNavigator
         bool updateObject(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
             const AreaType areaType, OnChangedTile&& onChangedTile)
         {
-            const auto object = mObjects.find(id);
-            if (object == mObjects.end())
+            if (mObjects.find(id) == mObjects.end())
                 return false;
-            auto& data = object->second;
-            bool changed = false;
-            std::set<TilePosition> newTiles;
-            {
-                const TilesPositionsRange objectRange = makeTilesPositionsRange(shape.getShape(), transform, mSettings);
-                const TilesPositionsRange range = getIntersection(mRange, objectRange);
-                const auto locked = mWorldspaceTiles.lock();
-                const auto onTilePosition = [&] (const TilePosition& tilePosition)
-                {
-                    if (data.mTiles.find(tilePosition) != data.mTiles.end())
-                    {
-                        newTiles.insert(tilePosition);
-                        if (updateTile(id, transform, areaType, tilePosition, locked->mTiles))
-                        {
-                            onChangedTile(tilePosition, ChangeType::update);
-                            changed = true;
-                        }
-                    }
-                    else if (addTile(id, shape, transform, areaType, tilePosition, locked->mTiles))
-                    {
-                        newTiles.insert(tilePosition);
-                        onChangedTile(tilePosition, ChangeType::add);
-                        changed = true;
-                    }
-                };
-                getTilesPositions(range, onTilePosition);
-                for (const auto& tile : data.mTiles)
-                {
-                    if (newTiles.find(tile) == newTiles.end() && removeTile(id, tile, locked->mTiles))
-                    {
-                        onChangedTile(tile, ChangeType::remove);
-                        changed = true;
-                    }
-                }
-            }
-            if (changed)
+            const auto locked = mWorldspaceTiles.lock();
+            return updateObject(id, shape, transform, areaType, onChangedTile, locked->mTiles);
+        }
+
+        /// Same as updateObject for each of the objects, but locks the tiles only once.
+        /// @return whether each of the objects changed
+        template <class OnChangedTile>
+        std::vector<bool> updateObjects(const std::vector<RecastMeshObjectUpdate>& updates, OnChangedTile&& onChangedTile)
+        {
+            std::vector<bool> result(updates.size(), false);
+            if (updates.empty())
+                return result;
+            const auto locked = mWorldspaceTiles.lock();
+            for (std::size_t i = 0; i < updates.size(); ++i)
             {
-                data.mTiles = std::move(newTiles);
-                ++mRevision;
+                const RecastMeshObjectUpdate& update = updates[i];
+                result[i] = updateObject(update.mId, update.mShape, update.mTransform, update.mAreaType, onChangedTile,
+                                         locked->mTiles);
             }
-            return changed;
+            return result;
         }
 
+        /// The transform the object was last added or updated with, nullptr if there is no object with the id.
+        const btTransform* getObjectTransform(const ObjectId id) const;
+
         std::optional<RemovedRecastMeshObject> removeObject(const ObjectId id);
 
         bool addWater(const osg::Vec2i& cellPosition, int cellSize, float level);
@@ -142,8 +131,8 @@ namespace DetourNavigator
         struct ObjectData
         {
             const CollisionShape mShape;
-            const btTransform mTransform;
-            const AreaType mAreaType;
+            btTransform mTransform;
+            AreaType mAreaType;
             std::set<TilePosition> mTiles;
         };
 
@@ -163,6 +152,58 @@ namespace DetourNavigator
         std::size_t mRevision = 0;
         std::size_t mTilesGeneration = 0;
 
+        template <class OnChangedTile>
+        bool updateObject(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
+            const AreaType areaType, OnChangedTile& onChangedTile, TilesMap& tiles)
+        {
+            const auto object = mObjects.find(id);
+            if (object == mObjects.end())
+                return false;
+            auto& data = object->second;
+            bool changed = false;
+            std::set<TilePosition> newTiles;
+            {
+                const TilesPositionsRange objectRange = makeTilesPositionsRange(shape.getShape(), transform, mSettings);
+                const TilesPositionsRange range = getIntersection(mRange, objectRange);
+                const auto onTilePosition = [&] (const TilePosition& tilePosition)
+                {
+                    if (data.mTiles.find(tilePosition) != data.mTiles.end())
+                    {
+                        newTiles.insert(tilePosition);
+                        if (updateTile(id, transform, areaType, tilePosition, tiles))
+                        {
+                            onChangedTile(tilePosition, ChangeType::update);
+                            changed = true;
+                        }
+                    }
+                    else if (addTile(id, shape, transform, areaType, tilePosition, tiles))
+                    {
+                        newTiles.insert(tilePosition);
+                        onChangedTile(tilePosition, ChangeType::add);
+                        changed = true;
+                    }
+                };
+                getTilesPositions(range, onTilePosition);
+                for (const auto& tile : data.mTiles)
+                {
+                    if (newTiles.find(tile) == newTiles.end() && removeTile(id, tile, tiles))
+                    {
+                        onChangedTile(tile, ChangeType::remove);
+                        changed = true;
+                    }
+                }
+            }
+            if (changed)
+            {
+                data.mTiles = std::move(newTiles);
+                // tiles added later, e.g. by setBounds, need the current transform
+                data.mTransform = transform;
+                data.mAreaType = areaType;
+                ++mRevision;
+            }
+            return changed;
+        }
+
         bool addTile(const ObjectId id, const CollisionShape& shape, const btTransform& transform,
                 const AreaType areaType, const TilePosition& tilePosition, TilesMap& tiles);
 
@@ -0,0 +1,131 @@
+#include "tilegraph.hpp"
+#include "preparednavmeshdata.hpp"
+
+#include <Recast.h>
+
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        struct Neighbour
+        {
+            TilePortal mSide;
+            TilePosition mShift;
+            TilePortal mOppositeSide;
+        };
+
+        constexpr unsigned short portalFlag = 0x8000;
+        constexpr unsigned short portalSideMask = 0xf;
+
+        const Neighbour neighbours[] = {
+            {TilePortal_xMin, TilePosition(-1, 0), TilePortal_xMax},
+            {TilePortal_yMax, TilePosition(0, 1), TilePortal_yMin},
+            {TilePortal_xMax, TilePosition(1, 0), TilePortal_xMin},
+            {TilePortal_yMin, TilePosition(0, -1), TilePortal_yMax},
+        };
+
+        int getDistance(const TilePosition& lhs, const TilePosition& rhs)
+        {
+            return std::abs(lhs.x() - rhs.x()) + std::abs(lhs.y() - rhs.y());
+        }
+    }
+
+    TilePortals getTilePortals(const PreparedNavMeshData& data)
+    {
+        const rcPolyMesh& mesh = data.mPolyMesh;
+        TilePortals result = TilePortal_none;
+        for (int i = 0; i < mesh.npolys; ++i)
+        {
+            if (mesh.flags[i] == 0)
+                continue;
+            const unsigned short* const poly = mesh.polys + static_cast<std::ptrdiff_t>(i * 2 * mesh.nvp);
+            for (int j = 0; j < mesh.nvp; ++j)
+            {
+                if (poly[j] == RC_MESH_NULL_IDX)
+                    break;
+                const unsigned short neighbour = poly[mesh.nvp + j];
+                if (neighbour != RC_MESH_NULL_IDX && (neighbour & portalFlag) != 0)
+                    result |= 1u << (neighbour & portalSideMask);
+            }
+        }
+        return result;
+    }
+
+    void TileGraph::add(const TilePosition& position, TilePortals portals)
+    {
+        mTiles[position] |= portals;
+    }
+
+    TilePortals TileGraph::getPortals(const TilePosition& position) const
+    {
+        const auto it = mTiles.find(position);
+        if (it == mTiles.end())
+            return TilePortal_none;
+        return it->second;
+    }
+
+    std::vector<TilePosition> TileGraph::findPath(const TilePosition& start, const TilePosition& end,
+        std::size_t maxNodes) const
+    {
+        if (mTiles.find(start) == mTiles.end() || mTiles.find(end) == mTiles.end())
+            return {};
+
+        struct Node
+        {
+            int mCost;
+            TilePosition mParent;
+        };
+
+        using Item = std::tuple<int, int, TilePosition>;
+
+        std::map<TilePosition, Node> nodes;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+        nodes.emplace(start, Node {0, start});
+        open.emplace(getDistance(start, end), 0, start);
+        std::size_t expanded = 0;
+
+        while (!open.empty())
+        {
+            const auto [estimate, cost, position] = open.top();
+            open.pop();
+
+            if (position == end)
+            {
+                std::vector<TilePosition> result;
+                for (TilePosition v = end; v != start; v = nodes.find(v)->second.mParent)
+                    result.push_back(v);
+                result.push_back(start);
+                return std::vector<TilePosition>(result.rbegin(), result.rend());
+            }
+
+            if (cost > nodes.find(position)->second.mCost)
+                continue;
+
+            if (++expanded > maxNodes)
+                break;
+
+            const TilePortals portals = getPortals(position);
+            for (const Neighbour& neighbour : neighbours)
+            {
+                if ((portals & neighbour.mSide) == 0)
+                    continue;
+                const TilePosition next = position + neighbour.mShift;
+                if ((getPortals(next) & neighbour.mOppositeSide) == 0)
+                    continue;
+                const int nextCost = cost + 1;
+                const auto it = nodes.find(next);
+                if (it != nodes.end() && it->second.mCost <= nextCost)
+                    continue;
+                nodes.insert_or_assign(next, Node {nextCost, position});
+                open.emplace(nextCost + getDistance(next, end), nextCost, next);
+            }
+        }
+
+        return {};
+    }
+}
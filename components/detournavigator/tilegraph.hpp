@@ -0,0 +1,55 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+
+#include "tileposition.hpp"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace DetourNavigator
+{
+    struct PreparedNavMeshData;
+
+    /// Tile sides having walkable polygons touching the neighbour tile. Same order as portal edges in rcPolyMesh.
+    enum TilePortal : unsigned
+    {
+        TilePortal_none = 0,
+        TilePortal_xMin = 1 << 0,
+        TilePortal_yMax = 1 << 1,
+        TilePortal_xMax = 1 << 2,
+        TilePortal_yMin = 1 << 3,
+    };
+
+    using TilePortals = unsigned;
+
+    TilePortals getTilePortals(const PreparedNavMeshData& data);
+
+    /**
+     * @brief TileGraph is a coarse connectivity of navmesh tiles to plan long routes over tiles which are not loaded.
+     * Neighbour tiles are connected when both have portals on the shared side. Connectivity between portals inside
+     * a tile is not checked so a route may need local refinement or replanning.
+     */
+    class TileGraph
+    {
+    public:
+        void add(const TilePosition& position, TilePortals portals);
+
+        TilePortals getPortals(const TilePosition& position) const;
+
+        std::size_t size() const { return mTiles.size(); }
+
+        /**
+         * @brief findPath finds a route over connected tiles using A*.
+         * @param maxNodes limits number of expanded tiles.
+         * @return tiles from start to end including both or empty vector if route is not found.
+         */
+        std::vector<TilePosition> findPath(const TilePosition& start, const TilePosition& end,
+            std::size_t maxNodes) const;
+
+    private:
+        std::map<TilePosition, TilePortals> mTiles;
+    };
+}
+
+#endif
@@ -46,7 +46,9 @@ void ESM::CellRef::loadId (ESMReader& esm, bool wideRefNum)
 
     mRefNum.load (esm, wideRefNum);
 
-    mRefID = esm.getHNOString ("NAME");
+    // Reuse the buffers of a reference that is loaded repeatedly
+    if (esm.isNextSub("NAME"))
+        mRefID.assign(esm.getHStringView());
     if (mRefID.empty())
     {
         Log(Debug::Warning) << "Warning: got CellRef with empty RefId in " << esm.getName() << " 0x" << std::hex << esm.getFileOffset();
@@ -71,16 +73,16 @@ void ESM::CellRef::loadData(ESMReader &esm, bool &isDeleted)
                 mScale = std::clamp(mScale, 0.5f, 2.0f);
                 break;
             case ESM::FourCC<'A','N','A','M'>::value:
-                mOwner = esm.getHString();
+                mOwner.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'B','N','A','M'>::value:
-                mGlobalVariable = esm.getHString();
+                mGlobalVariable.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'X','S','O','L'>::value:
-                mSoul = esm.getHString();
+                mSoul.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'C','N','A','M'>::value:
-                mFaction = esm.getHString();
+                mFaction.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'I','N','D','X'>::value:
                 esm.getHT(mFactionRank);
@@ -99,16 +101,16 @@ void ESM::CellRef::loadData(ESMReader &esm, bool &isDeleted)
                 mTeleport = true;
                 break;
             case ESM::FourCC<'D','N','A','M'>::value:
-                mDestCell = esm.getHString();
+                mDestCell.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'F','L','T','V'>::value:
                 esm.getHT(mLockLevel);
                 break;
             case ESM::FourCC<'K','N','A','M'>::value:
-                mKey = esm.getHString();
+                mKey.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'T','N','A','M'>::value:
-                mTrap = esm.getHString();
+                mTrap.assign(esm.getHStringView());
                 break;
             case ESM::FourCC<'D','A','T','A'>::value:
                 esm.getHT(mPos, 24);
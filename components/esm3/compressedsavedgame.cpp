@@ -0,0 +1,159 @@
+#include "compressedsavedgame.hpp"
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <components/files/memorystream.hpp>
+
+namespace ESM
+{
+    namespace
+    {
+        const char compressedSavedGameMagic[] = {'O', 'M', 'W', 'S', 'A', 'V', 'Z', '1'};
+
+        // Uncompressed size of a frame, small enough to give every loading thread some frames
+        constexpr std::size_t sFrameSize = 1 << 20;
+
+        // Largest frame accepted while reading, the header frame holds the screenshot so it may be bigger than the others
+        constexpr std::uint32_t sMaxFrameSize = 64 << 20;
+
+        struct Frame
+        {
+            std::uint32_t mSize = 0;
+            std::vector<char> mData;
+        };
+
+        void writeValue(std::ostream& stream, std::uint32_t value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        std::uint32_t readValue(std::istream& stream)
+        {
+            std::uint32_t value = 0;
+            stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+            if (!stream)
+                throw std::runtime_error("Unexpected end of compressed saved game");
+            return value;
+        }
+
+        void writeFrame(std::ostream& stream, std::string_view data)
+        {
+            std::vector<char> compressed(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(data.size()))));
+            const int size = LZ4_compress_default(data.data(), compressed.data(), static_cast<int>(data.size()),
+                                                  static_cast<int>(compressed.size()));
+            if (size <= 0)
+                throw std::runtime_error("Failed to compress saved game");
+            writeValue(stream, static_cast<std::uint32_t>(data.size()));
+            writeValue(stream, static_cast<std::uint32_t>(size));
+            stream.write(compressed.data(), size);
+        }
+
+        /// A stream reading the decompressed saved game, keeping the data alive while it is used.
+        struct DecompressedStream : Files::IMemStream
+        {
+            explicit DecompressedStream(std::vector<char> data)
+                : Files::MemBuf(data.data(), data.size())
+                , Files::IMemStream(data.data(), data.size())
+                , mData(std::move(data))
+            {
+            }
+
+            std::vector<char> mData;
+        };
+
+        void decompressFrame(const Frame& frame, char* out)
+        {
+            const int size = LZ4_decompress_safe(frame.mData.data(), out, static_cast<int>(frame.mData.size()),
+                                                 static_cast<int>(frame.mSize));
+            if (size < 0 || static_cast<std::uint32_t>(size) != frame.mSize)
+                throw std::runtime_error("Failed to decompress saved game");
+        }
+    }
+
+    void writeCompressedSavedGame(std::ostream& stream, std::string_view data, std::size_t headerSize)
+    {
+        headerSize = std::min(headerSize, data.size());
+        const std::size_t frames = 1 + (data.size() - headerSize + sFrameSize - 1) / sFrameSize;
+
+        stream.write(compressedSavedGameMagic, sizeof(compressedSavedGameMagic));
+        writeValue(stream, static_cast<std::uint32_t>(frames));
+        writeFrame(stream, data.substr(0, headerSize));
+        for (std::size_t offset = headerSize; offset < data.size(); offset += sFrameSize)
+            writeFrame(stream, data.substr(offset, sFrameSize));
+    }
+
+    Files::IStreamPtr openSavedGame(const std::string& path, bool headerOnly)
+    {
+        Files::IStreamPtr file = Files::openConstrainedFileStream(path.c_str());
+
+        char magic[sizeof(compressedSavedGameMagic)];
+        file->read(magic, sizeof(magic));
+        if (!*file || !std::equal(magic, magic + sizeof(magic), compressedSavedGameMagic))
+        {
+            file->clear();
+            file->seekg(0);
+            return file;
+        }
+
+        std::size_t frameCount = readValue(*file);
+        if (headerOnly)
+            frameCount = std::min<std::size_t>(frameCount, 1);
+
+        std::vector<Frame> frames(frameCount);
+        std::vector<std::size_t> offsets(frameCount);
+        std::size_t totalSize = 0;
+        for (std::size_t i = 0; i < frameCount; ++i)
+        {
+            Frame& frame = frames[i];
+            frame.mSize = readValue(*file);
+            const std::uint32_t compressedSize = readValue(*file);
+            if (frame.mSize > sMaxFrameSize || compressedSize > static_cast<std::uint32_t>(LZ4_compressBound(sMaxFrameSize)))
+                throw std::runtime_error("Invalid frame in compressed saved game " + path);
+            frame.mData.resize(compressedSize);
+            file->read(frame.mData.data(), frame.mData.size());
+            if (!*file)
+                throw std::runtime_error("Unexpected end of compressed saved game " + path);
+            offsets[i] = totalSize;
+            totalSize += frame.mSize;
+        }
+
+        std::vector<char> data(totalSize);
+        std::atomic_size_t next {0};
+        std::atomic_bool failed {false};
+        const auto work = [&]
+        {
+            for (std::size_t i = next++; i < frames.size(); i = next++)
+            {
+                try
+                {
+                    decompressFrame(frames[i], data.data() + offsets[i]);
+                }
+                catch (const std::exception&)
+                {
+                    failed = true;
+                }
+            }
+        };
+
+        const std::size_t threads = std::min<std::size_t>(frames.size(), std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < threads; ++i)
+            workers.emplace_back(work);
+        work();
+        for (std::thread& worker : workers)
+            worker.join();
+
+        if (failed)
+            throw std::runtime_error("Failed to decompress saved game " + path);
+
+        return std::make_shared<DecompressedStream>(std::move(data));
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef OPENMW_ESM_COMPRESSEDSAVEDGAME_H
+#define OPENMW_ESM_COMPRESSEDSAVEDGAME_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include <components/files/constrainedfilestream.hpp>
+
+namespace ESM
+{
+    /// \brief Container for saved games that stores the record stream as independently compressed LZ4 frames
+    ///
+    /// The first frame ends after the saved game header, so the save list only decompresses that one. The other
+    /// frames are decompressed in parallel when the game is loaded. Files that don't start with the magic of the
+    /// container are read as they are, so saved games without compression stay readable.
+
+    /// Write \a data, the first \a headerSize bytes of it in a frame of their own.
+    void writeCompressedSavedGame(std::ostream& stream, std::string_view data, std::size_t headerSize);
+
+    /// Open a saved game, compressed or not, for reading through an ESMReader.
+    /// \param headerOnly Only the data up to the end of the saved game header is needed.
+    Files::IStreamPtr openSavedGame(const std::string& path, bool headerOnly = false);
+}
+
+#endif
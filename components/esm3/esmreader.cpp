@@ -3,6 +3,8 @@
 #include <boost/filesystem/path.hpp>
 #include <components/misc/stringops.hpp>
 
+#include <algorithm>
+#include <sstream>
 #include <stdexcept>
 
 namespace ESM
@@ -13,7 +15,7 @@ using namespace Misc;
 ESM_Context ESMReader::getContext()
 {
     // Update the file position before returning
-    mCtx.filePos = mEsm->tellg();
+    mCtx.filePos = getFileOffset();
     return mCtx;
 }
 
@@ -37,12 +39,16 @@ void ESMReader::restoreContext(const ESM_Context &rc)
     mCtx = rc;
 
     // Make sure we seek to the right place
+    clearRecordBuffer();
     mEsm->seekg(mCtx.filePos);
+    if (mCtx.leftRec > 0)
+        bufferRecord(mCtx.leftRec);
 }
 
 void ESMReader::close()
 {
     mEsm.reset();
+    clearRecordBuffer();
     clearCtx();
     mHeader.blank();
 }
@@ -127,6 +133,11 @@ std::string ESMReader::getHNString(const char* name)
 }
 
 std::string ESMReader::getHString()
+{
+    return std::string(getHStringView());
+}
+
+std::string_view ESMReader::getHStringView()
 {
     getSubHeader();
 
@@ -135,16 +146,16 @@ std::string ESMReader::getHString()
     // them. For some reason, they break the rules, and contain a byte
     // (value 0) even if the header says there is no data. If
     // Morrowind accepts it, so should we.
-    if (mCtx.leftSub == 0 && hasMoreSubs() && !mEsm->peek())
+    if (mCtx.leftSub == 0 && hasMoreSubs() && !peekByte())
     {
         // Skip the following zero byte
         mCtx.leftRec--;
         char c;
         getT(c);
-        return std::string();
+        return std::string_view();
     }
 
-    return getString(mCtx.leftSub);
+    return getStringView(mCtx.leftSub);
 }
 
 void ESMReader::getHExact(void*p, int size)
@@ -267,6 +278,18 @@ NAME ESMReader::getRecName()
     return mCtx.recName;
 }
 
+void ESMReader::skip(int bytes)
+{
+    if (mRecordSize - mRecordPos >= static_cast<size_t>(bytes))
+    {
+        mRecordPos += bytes;
+        return;
+    }
+    const size_t offset = getFileOffset() + bytes;
+    clearRecordBuffer();
+    mEsm->seekg(offset);
+}
+
 void ESMReader::skipRecord()
 {
     skip(mCtx.leftRec);
@@ -274,6 +297,29 @@ void ESMReader::skipRecord()
     mCtx.subCached = false;
 }
 
+void ESMReader::getRecordData(std::vector<char>& data)
+{
+    data.resize(mCtx.leftRec);
+    getExact(data.data(), static_cast<int>(mCtx.leftRec));
+    mCtx.leftRec = 0;
+    mCtx.subCached = false;
+}
+
+void ESMReader::openRecord(std::vector<char> data, const ESMReader& file)
+{
+    close();
+    // Nothing but the record itself can be read
+    mEsm = std::make_shared<std::istringstream>();
+    mCtx.filename = file.mCtx.filename;
+    mCtx.recName = file.mCtx.recName;
+    mHeader = file.mHeader;
+    mFileSize = data.size();
+    mCtx.leftRec = static_cast<uint32_t>(data.size());
+    mRecordOffset = 0;
+    mRecordSize = data.size();
+    mRecordData = std::move(data);
+}
+
 void ESMReader::getRecHeader(uint32_t &flags)
 {
     // General error checking
@@ -293,6 +339,8 @@ void ESMReader::getRecHeader(uint32_t &flags)
 
     // Adjust number of bytes mCtx.left in file
     mCtx.leftFile -= mCtx.leftRec;
+
+    bufferRecord(mCtx.leftRec);
 }
 
 /*************************************************************************
@@ -303,26 +351,65 @@ void ESMReader::getRecHeader(uint32_t &flags)
 
 std::string ESMReader::getString(int size)
 {
-    size_t s = size;
-    if (mBuffer.size() <= s)
-        // Add some extra padding to reduce the chance of having to resize
-        // again later.
-        mBuffer.resize(3*s);
-
-    // And make sure the string is zero terminated
-    mBuffer[s] = 0;
+    return std::string(getStringView(size));
+}
 
-    // read ESM data
-    char *ptr = mBuffer.data();
-    getExact(ptr, size);
+std::string_view ESMReader::getStringView(int size)
+{
+    size_t s = size;
+    const char* ptr = nullptr;
+    if (mRecordSize - mRecordPos >= s)
+    {
+        // Use the string in place
+        ptr = mRecordData.data() + mRecordPos;
+        mRecordPos += s;
+    }
+    else
+    {
+        if (mBuffer.size() <= s)
+            // Add some extra padding to reduce the chance of having to resize
+            // again later.
+            mBuffer.resize(3*s);
+
+        // read ESM data
+        getExact(mBuffer.data(), size);
+        ptr = mBuffer.data();
+    }
 
     size = static_cast<int>(strnlen(ptr, size));
 
     // Convert to UTF8 and return
     if (mEncoder)
-        return std::string(mEncoder->getUtf8(std::string_view(ptr, size)));
+        return mEncoder->getUtf8(std::string_view(ptr, size));
 
-    return std::string (ptr, size);
+    return std::string_view(ptr, size);
+}
+
+void ESMReader::getExactUnbuffered(void* x, int size)
+{
+    // Whatever is left of the record buffer precedes the current stream position
+    const size_t buffered = std::min(mRecordSize - mRecordPos, static_cast<size_t>(size));
+    std::memcpy(x, mRecordData.data() + mRecordPos, buffered);
+    clearRecordBuffer();
+    mEsm->read(static_cast<char*>(x) + buffered, size - buffered);
+}
+
+void ESMReader::bufferRecord(size_t size)
+{
+    clearRecordBuffer();
+    const size_t offset = mEsm->tellg();
+    if (mRecordData.size() < size)
+        mRecordData.resize(size);
+    mEsm->read(mRecordData.data(), size);
+    mRecordOffset = offset;
+    mRecordSize = static_cast<size_t>(mEsm->gcount());
+}
+
+char ESMReader::peekByte()
+{
+    if (mRecordPos < mRecordSize)
+        return mRecordData[mRecordPos];
+    return static_cast<char>(mEsm->peek());
 }
 
 [[noreturn]] void ESMReader::fail(const std::string &msg)
@@ -334,7 +421,7 @@ std::string ESMReader::getString(int size)
     ss << "\n  Record: " << mCtx.recName.toStringView();
     ss << "\n  Subrecord: " << mCtx.subName.toStringView();
     if (mEsm.get())
-        ss << "\n  Offset: 0x" << std::hex << mEsm->tellg();
+        ss << "\n  Offset: 0x" << std::hex << getFileOffset();
     throw std::runtime_error(ss.str());
 }
 
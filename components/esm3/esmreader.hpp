@@ -3,8 +3,10 @@
 
 #include <cstdint>
 #include <cassert>
+#include <cstring>
 #include <vector>
 #include <sstream>
+#include <string_view>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -73,7 +75,7 @@ public:
   void openRaw(const std::string &filename);
 
   /// Get the current position in the file. Make sure that the file has been opened!
-  size_t getFileOffset() const { return mEsm->tellg(); };
+  size_t getFileOffset() const { return mRecordSize != 0 ? mRecordOffset + mRecordPos : static_cast<size_t>(mEsm->tellg()); };
 
   // This is a quick hack for multiple esm/esp files. Each plugin introduces its own
   //  terrain palette, but ESMReader does not pass a reference to the correct plugin
@@ -158,6 +160,10 @@ public:
   // Read a string, including the sub-record header (but not the name)
   std::string getHString();
 
+  // Same as getHString, but returns a view into the reader's buffers instead of a copy.
+  // The view is only valid until the next read from this reader.
+  std::string_view getHStringView();
+
   // Read the given number of bytes from a subrecord
   void getHExact(void*p, int size);
 
@@ -217,6 +223,14 @@ public:
   // already been read
   void skipRecord();
 
+  // Move the rest of this record into data, for reading it later with
+  // openRecord. Assumes the name and header have already been read
+  void getRecordData(std::vector<char>& data);
+
+  // Read the subrecords of a record taken from file with getRecordData,
+  // e.g. in another thread. The encoder of file is not copied.
+  void openRecord(std::vector<char> data, const ESMReader& file);
+
   /* Read record header. This updatesleftFile BEYOND the data that
      follows the header, ie beyond the entire record. You should use
      leftRec to orient yourself inside the record itself.
@@ -237,7 +251,17 @@ public:
   template <typename X>
   void getT(X &x) { getExact(&x, sizeof(X)); }
 
-  void getExact(void* x, int size) { mEsm->read((char*)x, size); }
+  void getExact(void* x, int size)
+  {
+      // Records are read at once, so subrecords are usually served from memory
+      if (mRecordSize - mRecordPos >= static_cast<size_t>(size))
+      {
+          std::memcpy(x, mRecordData.data() + mRecordPos, size);
+          mRecordPos += size;
+      }
+      else
+          getExactUnbuffered(x, size);
+  }
   void getName(NAME &name) { getT(name); }
   void getUint(uint32_t &u) { getT(u); }
 
@@ -245,7 +269,10 @@ public:
   // them from native encoding to UTF8 in the process.
   std::string getString(int size);
 
-  void skip(int bytes) { mEsm->seekg(getFileOffset()+bytes); };
+  // Same as getString, but returns a view into the reader's buffers which is only valid until the next read.
+  std::string_view getStringView(int size);
+
+  void skip(int bytes);
 
   /// Used for error handling
   [[noreturn]] void fail(const std::string &msg);
@@ -253,6 +280,8 @@ public:
   /// Sets font encoder for ESM strings
   void setEncoder(ToUTF8::Utf8Encoder* encoder) { mEncoder = encoder; };
 
+  ToUTF8::Utf8Encoder* getEncoder() const { return mEncoder; }
+
   /// Get record flags of last record
   unsigned int getRecordFlags() { return mRecordFlags; }
 
@@ -268,8 +297,24 @@ private:
 
   void clearCtx();
 
+  void getExactUnbuffered(void* x, int size);
+
+  // Read the given number of bytes from the current file position into the record buffer
+  void bufferRecord(size_t size);
+
+  void clearRecordBuffer() { mRecordPos = mRecordSize = 0; }
+
+  char peekByte();
+
   Files::IStreamPtr mEsm;
 
+  // The remainder of the current record, read from the file at once to avoid a stream read per subrecord.
+  // mRecordData is reused for all records.
+  std::vector<char> mRecordData;
+  size_t mRecordOffset = 0;
+  size_t mRecordPos = 0;
+  size_t mRecordSize = 0;
+
   ESM_Context mCtx;
 
   unsigned int mRecordFlags;
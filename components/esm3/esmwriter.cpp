@@ -1,6 +1,7 @@
 #include "esmwriter.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 
@@ -11,10 +12,8 @@ namespace ESM
     ESMWriter::ESMWriter()
         : mRecords()
         , mStream(nullptr)
-        , mHeaderPos()
         , mEncoder(nullptr)
         , mRecordCount(0)
-        , mCounting(true)
         , mHeader()
     {}
 
@@ -68,10 +67,7 @@ namespace ESM
 
     void ESMWriter::save(std::ostream& file)
     {
-        mRecordCount = 0;
-        mRecords.clear();
-        mCounting = true;
-        mStream = &file;
+        saveRecords(file);
 
         startRecord("TES3", 0);
 
@@ -80,6 +76,23 @@ namespace ESM
         endRecord("TES3");
     }
 
+    void ESMWriter::saveRecords(std::ostream& file)
+    {
+        mRecordCount = 0;
+        mRecords.clear();
+        mBuffer.clear();
+        mStream = &file;
+    }
+
+    void ESMWriter::writeRecord(std::string_view record)
+    {
+        if (!mRecords.empty())
+            throw std::runtime_error ("Unclosed record remaining");
+
+        mRecordCount++;
+        write(record.data(), record.size());
+    }
+
     void ESMWriter::close()
     {
         if (!mRecords.empty())
@@ -90,17 +103,14 @@ namespace ESM
     {
         mRecordCount++;
 
-        writeName(name);
-        RecordData rec;
+        RecordData& rec = mRecords.emplace_back();
         rec.name = name;
-        rec.position = mStream->tellp();
-        rec.size = 0;
+        writeName(name);
+        rec.sizePosition = mBuffer.size();
         writeT<uint32_t>(0); // Size goes here
         writeT<uint32_t>(0); // Unused header?
         writeT(flags);
-        mRecords.push_back(rec);
-
-        assert(mRecords.back().size == 0);
+        rec.dataStart = mBuffer.size();
     }
 
     void ESMWriter::startRecord (uint32_t name, uint32_t flags)
@@ -118,31 +128,28 @@ namespace ESM
         // Sub-record hierarchies are not properly supported in ESMReader. This should be fixed later.
         assert (mRecords.size() <= 1);
 
-        writeName(name);
-        RecordData rec;
+        RecordData& rec = mRecords.emplace_back();
         rec.name = name;
-        rec.position = mStream->tellp();
-        rec.size = 0;
+        writeName(name);
+        rec.sizePosition = mBuffer.size();
         writeT<uint32_t>(0); // Size goes here
-        mRecords.push_back(rec);
-
-        assert(mRecords.back().size == 0);
+        rec.dataStart = mBuffer.size();
     }
 
     void ESMWriter::endRecord(const std::string& name)
     {
-        RecordData rec = mRecords.back();
+        const RecordData rec = mRecords.back();
         assert(rec.name == name);
         mRecords.pop_back();
 
-        mStream->seekp(rec.position);
-
-        mCounting = false;
-        write (reinterpret_cast<const char*> (&rec.size), sizeof(uint32_t));
-        mCounting = true;
-
-        mStream->seekp(0, std::ios::end);
+        const uint32_t size = static_cast<uint32_t>(mBuffer.size() - rec.dataStart);
+        std::memcpy(&mBuffer[rec.sizePosition], &size, sizeof(size));
 
+        if (mRecords.empty())
+        {
+            mStream->write(mBuffer.data(), mBuffer.size());
+            mBuffer.clear();
+        }
     }
 
     void ESMWriter::endRecord (uint32_t name)
@@ -214,13 +221,10 @@ namespace ESM
 
     void ESMWriter::write(const char* data, size_t size)
     {
-        if (mCounting && !mRecords.empty())
-        {
-            for (std::list<RecordData>::iterator it = mRecords.begin(); it != mRecords.end(); ++it)
-                it->size += static_cast<uint32_t>(size);
-        }
-
-        mStream->write(data, size);
+        if (mRecords.empty())
+            mStream->write(data, size);
+        else
+            mBuffer.append(data, size);
     }
 
     void ESMWriter::setEncoder(ToUTF8::Utf8Encoder* encoder)
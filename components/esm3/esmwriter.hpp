@@ -2,8 +2,10 @@
 #define OPENMW_ESM_WRITER_H
 
 #include <iosfwd>
-#include <list>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include "components/esm/esmcommon.hpp"
 #include "loadtes3.hpp"
@@ -15,13 +17,16 @@ namespace ToUTF8
 
 namespace ESM {
 
+/// \note Records are assembled in memory and written to the stream at once when they are complete, so their
+/// sizes are filled in without seeking in the stream.
 class ESMWriter
 {
         struct RecordData
         {
             std::string name;
-            std::streampos position;
-            uint32_t size;
+            // Offsets in mBuffer
+            std::size_t sizePosition;
+            std::size_t dataStart;
         };
 
     public:
@@ -35,6 +40,7 @@ class ESMWriter
         void setVersion(unsigned int ver = 0x3fa66666);
         void setType(int type);
         void setEncoder(ToUTF8::Utf8Encoder *encoding);
+        ToUTF8::Utf8Encoder* getEncoder() const { return mEncoder; }
         void setAuthor(const std::string& author);
         void setDescription(const std::string& desc);
 
@@ -53,6 +59,13 @@ class ESMWriter
         void save(std::ostream& file);
         ///< Start saving a file by writing the TES3 header.
 
+        void saveRecords(std::ostream& file);
+        ///< Start writing records to \a file without a TES3 header, so they can be copied into a file
+        /// with writeRecord later.
+
+        void writeRecord(std::string_view record);
+        ///< Copy a complete record written by another ESMWriter.
+
         void close();
         ///< \note Does not close the stream.
 
@@ -142,12 +155,12 @@ class ESMWriter
         void write(const char* data, size_t size);
 
     private:
-        std::list<RecordData> mRecords;
+        std::vector<RecordData> mRecords;
+        // The unfinished top level record, reused for the following records
+        std::string mBuffer;
         std::ostream* mStream;
-        std::streampos mHeaderPos;
         ToUTF8::Utf8Encoder* mEncoder;
         int mRecordCount;
-        bool mCounting;
 
         Header mHeader;
     };
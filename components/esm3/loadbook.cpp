@@ -8,10 +8,11 @@ namespace ESM
 {
     unsigned int Book::sRecordId = REC_BOOK;
 
-    void Book::load(ESMReader &esm, bool &isDeleted)
+    void Book::load(ESMReader &esm, bool &isDeleted, bool skipText)
     {
         isDeleted = false;
         mRecordFlags = esm.getRecordFlags();
+        mTextContext.filename.clear();
 
         bool hasName = false;
         bool hasData = false;
@@ -44,7 +45,14 @@ namespace ESM
                     mEnchant = esm.getHString();
                     break;
                 case ESM::FourCC<'T','E','X','T'>::value:
-                    mText = esm.getHString();
+                    if (skipText)
+                    {
+                        mText.clear();
+                        mTextContext = esm.getContext();
+                        esm.skipHSub();
+                    }
+                    else
+                        mText = esm.getHString();
                     break;
                 case ESM::SREC_DELE:
                     esm.skipHSub();
@@ -80,6 +88,18 @@ namespace ESM
         esm.writeHNOCString("ENAM", mEnchant);
     }
 
+    void Book::loadText(ToUTF8::Utf8Encoder* encoder)
+    {
+        if (isTextLoaded())
+            return;
+
+        ESMReader reader;
+        reader.setEncoder(encoder);
+        reader.restoreContext(mTextContext);
+        mText = reader.getHString();
+        mTextContext.filename.clear();
+    }
+
     void Book::blank()
     {
         mData.mWeight = 0;
@@ -93,5 +113,6 @@ namespace ESM
         mScript.clear();
         mEnchant.clear();
         mText.clear();
+        mTextContext.filename.clear();
     }
 }
@@ -3,6 +3,13 @@
 
 #include <string>
 
+#include "components/esm/esmcommon.hpp"
+
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
 namespace ESM
 {
 /*
@@ -29,9 +36,18 @@ struct Book
     unsigned int mRecordFlags;
     std::string mId;
 
-    void load(ESMReader &esm, bool &isDeleted);
+    /// Location of the TEXT subrecord if load() skipped it. The filename is empty when mText is loaded.
+    ESM_Context mTextContext;
+
+    /// @param skipText Only remember where the text is, so that loadText() can read it when it's needed.
+    void load(ESMReader &esm, bool &isDeleted, bool skipText = false);
     void save(ESMWriter &esm, bool isDeleted = false) const;
 
+    bool isTextLoaded() const { return mTextContext.filename.empty(); }
+
+    /// Read the text skipped by load() from the content file. Does nothing if the text is loaded already.
+    void loadText(ToUTF8::Utf8Encoder* encoder);
+
     void blank();
     ///< Set record to default state (does not touch the ID).
 };
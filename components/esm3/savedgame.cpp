@@ -48,6 +48,6 @@ void ESM::SavedGame::save (ESMWriter &esm) const
          esm.writeHNString ("DEPE", *iter);
 
     esm.startSubRecord("SCRN");
-    esm.write(&mScreenshot[0], mScreenshot.size());
+    esm.write(mScreenshot.data(), mScreenshot.size());
     esm.endRecord("SCRN");
 }
@@ -1,11 +1,12 @@
 #include "storage.hpp"
 
+#include <iterator>
 #include <set>
 
 #include <osg/Image>
-#include <osg/Plane>
 
 #include <components/debug/debuglog.hpp>
+#include <components/misc/hash.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/stringops.hpp>
 #include <components/vfs/manager.hpp>
@@ -18,6 +19,39 @@ namespace ESMTerrain
     public:
         typedef std::map<std::pair<int, int>, osg::ref_ptr<const LandObject> > Map;
         Map mMap;
+
+        struct Slot
+        {
+            osg::ref_ptr<const LandObject> mLand;
+            bool mLoaded = false;
+        };
+
+        /// Look up the cells of the rectangle in a flat array instead of mMap. They are still only loaded on first use.
+        void setGrid(int minX, int minY, int maxX, int maxY)
+        {
+            mGridX = minX;
+            mGridY = minY;
+            mGridWidth = maxX - minX + 1;
+            mGridHeight = maxY - minY + 1;
+            mGrid.assign(static_cast<std::size_t>(mGridWidth * mGridHeight), Slot());
+        }
+
+        /// nullptr for cells outside the grid
+        Slot* getSlot(int cellX, int cellY)
+        {
+            const int x = cellX - mGridX;
+            const int y = cellY - mGridY;
+            if (x < 0 || y < 0 || x >= mGridWidth || y >= mGridHeight)
+                return nullptr;
+            return &mGrid[static_cast<std::size_t>(y * mGridWidth + x)];
+        }
+
+    private:
+        std::vector<Slot> mGrid;
+        int mGridX = 0;
+        int mGridY = 0;
+        int mGridWidth = 0;
+        int mGridHeight = 0;
     };
 
     LandObject::LandObject()
@@ -30,7 +64,28 @@ namespace ESMTerrain
         : mLand(land)
         , mLoadFlags(loadFlags)
     {
-        mLand->loadData(mLoadFlags, &mData);
+        if (mLoadFlags == ESM::Land::DATA_VHGT)
+        {
+            const auto data = std::make_unique<ESM::Land::LandData>();
+            mLand->loadData(mLoadFlags, data.get());
+            if (data->mDataLoaded & ESM::Land::DATA_VHGT)
+            {
+                mCompactHeights.assign(std::begin(data->mHeights), std::end(data->mHeights));
+                mHeights = mCompactHeights.data();
+                mMinHeight = data->mMinHeight;
+                mMaxHeight = data->mMaxHeight;
+            }
+            return;
+        }
+
+        mData = std::make_unique<ESM::Land::LandData>();
+        mLand->loadData(mLoadFlags, mData.get());
+        if (mData->mDataLoaded & ESM::Land::DATA_VHGT)
+        {
+            mHeights = mData->mHeights;
+            mMinHeight = mData->mMinHeight;
+            mMaxHeight = mData->mMaxHeight;
+        }
     }
 
     LandObject::LandObject(const LandObject &copy, const osg::CopyOp &copyop)
@@ -43,6 +98,14 @@ namespace ESMTerrain
     {
     }
 
+    std::size_t LandObject::getMemoryUsage() const
+    {
+        std::size_t result = sizeof(LandObject) + mCompactHeights.capacity() * sizeof(float);
+        if (mData != nullptr)
+            result += sizeof(ESM::Land::LandData);
+        return result;
+    }
+
     const float defaultHeight = ESM::Land::DEFAULT_HEIGHT;
 
     Storage::Storage(const VFS::Manager *vfs, const std::string& normalMapPattern, const std::string& normalHeightMapPattern, bool autoUseNormalMaps, const std::string& specularMapPattern, bool autoUseSpecularMaps)
@@ -70,9 +133,9 @@ namespace ESMTerrain
         int endRow = startRow + size * (ESM::Land::LAND_SIZE-1) + 1;
         int endColumn = startColumn + size * (ESM::Land::LAND_SIZE-1) + 1;
 
-        osg::ref_ptr<const LandObject> land = getLand (cellX, cellY);
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VHGT) : nullptr;
-        if (data)
+        osg::ref_ptr<const LandObject> land = getLandHeights(cellX, cellY);
+        const float* heights = land ? land->getHeights() : nullptr;
+        if (heights)
         {
             min = std::numeric_limits<float>::max();
             max = -std::numeric_limits<float>::max();
@@ -80,7 +143,7 @@ namespace ESMTerrain
             {
                 for (int col=startColumn; col<endColumn; ++col)
                 {
-                    float h = data->mHeights[col*ESM::Land::LAND_SIZE+row];
+                    float h = heights[col*ESM::Land::LAND_SIZE+row];
                     if (h > max)
                         max = h;
                     if (h < min)
@@ -171,9 +234,19 @@ namespace ESMTerrain
         }
     }
 
+    namespace
+    {
+        osg::Vec3b packNormal(const osg::Vec3f& normal)
+        {
+            return osg::Vec3b(static_cast<signed char>(std::round(normal.x() * 127.f)),
+                              static_cast<signed char>(std::round(normal.y() * 127.f)),
+                              static_cast<signed char>(std::round(normal.z() * 127.f)));
+        }
+    }
+
     void Storage::fillVertexBuffers (int lodLevel, float size, const osg::Vec2f& center,
                                             osg::ref_ptr<osg::Vec3Array> positions,
-                                            osg::ref_ptr<osg::Vec3Array> normals,
+                                            osg::ref_ptr<osg::Vec3bArray> normals,
                                             osg::ref_ptr<osg::Vec4ubArray> colours)
     {
         // LOD level n means every 2^n-th vertex is kept
@@ -196,15 +269,19 @@ namespace ESMTerrain
         float vertY = 0;
         float vertX = 0;
 
+        const int numCells = static_cast<int>(std::ceil(size));
+
+        // The chunk cells and their neighbours, which the normals and colours at the cell borders are taken from
         LandCache cache;
+        cache.setGrid(startCellX - 1, startCellY - 1, startCellX + numCells, startCellY + numCells);
 
         bool alteration = useAlteration();
 
         float vertY_ = 0; // of current cell corner
-        for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+        for (int cellY = startCellY; cellY < startCellY + numCells; ++cellY)
         {
             float vertX_ = 0; // of current cell corner
-            for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
+            for (int cellX = startCellX; cellX < startCellX + numCells; ++cellX)
             {
                 const LandObject* land = getLand(cellX, cellY, cache);
                 const ESM::Land::LandData *heightData = nullptr;
@@ -236,70 +313,66 @@ namespace ESMTerrain
                 vertY = vertY_;
                 for (int col=colStart; col<colEnd; col += increment)
                 {
+                    // Everything shared by the vertices of a row is looked up once per row
+                    const float* rowHeights = heightData ? heightData->mHeights + col*ESM::Land::LAND_SIZE : nullptr;
+                    const ESM::Land::VNML* rowNormals = normalData ? normalData->mNormals + col*ESM::Land::LAND_SIZE*3 : nullptr;
+                    const unsigned char* rowColours = colourData ? colourData->mColours + col*ESM::Land::LAND_SIZE*3 : nullptr;
+                    const bool borderCol = col == ESM::Land::LAND_SIZE-1;
+                    const bool cornerCol = col == 0 || col == ESM::Land::LAND_SIZE-1;
+                    const float posY = (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits;
+
+                    assert(col >= 0 && col < ESM::Land::LAND_SIZE);
+                    assert (vertY < numVerts);
+
                     vertX = vertX_;
                     for (int row=rowStart; row<rowEnd; row += increment)
                     {
-                        int srcArrayIndex = col*ESM::Land::LAND_SIZE*3+row*3;
-
                         assert(row >= 0 && row < ESM::Land::LAND_SIZE);
-                        assert(col >= 0 && col < ESM::Land::LAND_SIZE);
-
                         assert (vertX < numVerts);
-                        assert (vertY < numVerts);
 
-                        float height = defaultHeight;
-                        if (heightData)
-                            height = heightData->mHeights[col*ESM::Land::LAND_SIZE + row];
+                        const unsigned int index = static_cast<unsigned int>(vertX*numVerts + vertY);
+
+                        float height = rowHeights ? rowHeights[row] : defaultHeight;
                         if (alteration)
                             height += getAlteredHeight(col, row);
-                        (*positions)[static_cast<unsigned int>(vertX*numVerts + vertY)]
-                            = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         height);
+                        (*positions)[index] = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits, posY, height);
 
-                        if (normalData)
+                        if (rowNormals)
                         {
-                            for (int i=0; i<3; ++i)
-                                normal[i] = normalData->mNormals[srcArrayIndex+i];
-
+                            normal.set(rowNormals[row*3], rowNormals[row*3+1], rowNormals[row*3+2]);
                             normal.normalize();
                         }
                         else
                             normal = osg::Vec3f(0,0,1);
 
+                        const bool border = borderCol || row == ESM::Land::LAND_SIZE-1;
+
                         // Normals apparently don't connect seamlessly between cells
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
+                        if (border)
                             fixNormal(normal, cellX, cellY, col, row, cache);
 
                         // some corner normals appear to be complete garbage (z < 0)
-                        if ((row == 0 || row == ESM::Land::LAND_SIZE-1) && (col == 0 || col == ESM::Land::LAND_SIZE-1))
+                        if (cornerCol && (row == 0 || row == ESM::Land::LAND_SIZE-1))
                             averageNormal(normal, cellX, cellY, col, row, cache);
 
                         assert(normal.z() > 0);
 
-                        (*normals)[static_cast<unsigned int>(vertX*numVerts + vertY)] = normal;
+                        (*normals)[index] = packNormal(normal);
 
-                        if (colourData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                color[i] = colourData->mColours[srcArrayIndex+i];
-                        }
+                        if (rowColours)
+                            color.set(rowColours[row*3], rowColours[row*3+1], rowColours[row*3+2], 255);
                         else
-                        {
-                            color.r() = 255;
-                            color.g() = 255;
-                            color.b() = 255;
-                        }
+                            color.set(255, 255, 255, 255);
                         if (alteration)
                             adjustColor(col, row, heightData, color); //Does nothing by default, override in OpenMW-CS
 
                         // Unlike normals, colors mostly connect seamlessly between cells, but not always...
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
+                        if (border)
                             fixColour(color, cellX, cellY, col, row, cache);
 
                         color.a() = 255;
 
-                        (*colours)[static_cast<unsigned int>(vertX*numVerts + vertY)] = color;
+                        (*colours)[index] = color;
 
                         ++vertX;
                     }
@@ -439,92 +512,114 @@ namespace ESMTerrain
             blendmaps.clear(); // If a single texture fills the whole terrain, there is no need to blend
     }
 
+    std::size_t Storage::getBlendmapHash(float chunkSize, const osg::Vec2f &chunkCenter)
+    {
+        // Walk the same texels as getBlendmaps, but only hash the diffuse map each one resolves to
+        osg::Vec2f origin = chunkCenter - osg::Vec2f(chunkSize/2.f, chunkSize/2.f);
+        int cellX = static_cast<int>(std::floor(origin.x()));
+        int cellY = static_cast<int>(std::floor(origin.y()));
+
+        int realTextureSize = ESM::Land::LAND_TEXTURE_SIZE+1;
+
+        int rowStart = (origin.x() - cellX) * realTextureSize;
+        int colStart = (origin.y() - cellY) * realTextureSize;
+
+        const int blendmapSize = (realTextureSize-1) * chunkSize + 1;
+
+        LandCache cache;
+        std::map<UniqueTextureId, std::size_t> textureHashes;
+        std::size_t seed = 0;
+
+        for (int y=0; y<blendmapSize; y++)
+        {
+            for (int x=0; x<blendmapSize; x++)
+            {
+                UniqueTextureId id = getVtexIndexAt(cellX, cellY, x+rowStart, y+colStart, cache);
+                auto found = textureHashes.find(id);
+                if (found == textureHashes.end())
+                    found = textureHashes.emplace(id, std::hash<std::string>()(getLayerInfo(getTextureName(id)).mDiffuseMap)).first;
+                Misc::hashCombine(seed, found->second);
+            }
+        }
+        return seed;
+    }
+
     float Storage::getHeightAt(const osg::Vec3f &worldPos)
     {
-        int cellX = static_cast<int>(std::floor(worldPos.x() / float(Constants::CellSizeInUnits)));
-        int cellY = static_cast<int>(std::floor(worldPos.y() / float(Constants::CellSizeInUnits)));
+        const int cellX = static_cast<int>(std::floor(worldPos.x() / float(Constants::CellSizeInUnits)));
+        const int cellY = static_cast<int>(std::floor(worldPos.y() / float(Constants::CellSizeInUnits)));
 
-        osg::ref_ptr<const LandObject> land = getLand(cellX, cellY);
-        if (!land)
-            return defaultHeight;
+        osg::ref_ptr<const LandObject> land = getLandHeights(cellX, cellY);
+        return getHeightInCell(land.get(), cellX, cellY, worldPos);
+    }
 
-        const ESM::Land::LandData* data = land->getData(ESM::Land::DATA_VHGT);
-        if (!data)
-            return defaultHeight;
+    void Storage::getHeightsAt(const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights)
+    {
+        heights.resize(worldPositions.size());
+        // Nearby positions mostly share a cell, so each land is looked up once
+        LandCache cache;
+        for (std::size_t i = 0; i < worldPositions.size(); ++i)
+        {
+            const osg::Vec3f& worldPos = worldPositions[i];
+            const int cellX = static_cast<int>(std::floor(worldPos.x() / float(Constants::CellSizeInUnits)));
+            const int cellY = static_cast<int>(std::floor(worldPos.y() / float(Constants::CellSizeInUnits)));
+            auto found = cache.mMap.find(std::make_pair(cellX, cellY));
+            if (found == cache.mMap.end())
+                found = cache.mMap.emplace(std::make_pair(cellX, cellY), getLandHeights(cellX, cellY)).first;
+            heights[i] = getHeightInCell(found->second.get(), cellX, cellY, worldPos);
+        }
+    }
 
-        // Mostly lifted from Ogre::Terrain::getHeightAtTerrainPosition
+    float Storage::getHeightInCell(const LandObject* land, int cellX, int cellY, const osg::Vec3f& worldPos)
+    {
+        const float* heights = land ? land->getHeights() : nullptr;
+        if (!heights)
+            return defaultHeight;
 
         // Normalized position in the cell
-        float nX = (worldPos.x() - (cellX * Constants::CellSizeInUnits)) / float(Constants::CellSizeInUnits);
-        float nY = (worldPos.y() - (cellY * Constants::CellSizeInUnits)) / float(Constants::CellSizeInUnits);
+        const float nX = (worldPos.x() - (cellX * Constants::CellSizeInUnits)) / float(Constants::CellSizeInUnits);
+        const float nY = (worldPos.y() - (cellY * Constants::CellSizeInUnits)) / float(Constants::CellSizeInUnits);
 
         // get left / bottom points (rounded down)
-        float factor = ESM::Land::LAND_SIZE - 1.0f;
-        float invFactor = 1.0f / factor;
-
-        int startX = static_cast<int>(nX * factor);
-        int startY = static_cast<int>(nY * factor);
-        int endX = startX + 1;
-        int endY = startY + 1;
-
-        endX = std::min(endX, ESM::Land::LAND_SIZE-1);
-        endY = std::min(endY, ESM::Land::LAND_SIZE-1);
+        const float factor = ESM::Land::LAND_SIZE - 1.0f;
 
-        // now get points in terrain space (effectively rounding them to boundaries)
-        float startXTS = startX * invFactor;
-        float startYTS = startY * invFactor;
-        float endXTS = endX * invFactor;
-        float endYTS = endY * invFactor;
+        const int startX = std::min(static_cast<int>(nX * factor), ESM::Land::LAND_SIZE - 1);
+        const int startY = std::min(static_cast<int>(nY * factor), ESM::Land::LAND_SIZE - 1);
+        const int endX = std::min(startX + 1, ESM::Land::LAND_SIZE - 1);
+        const int endY = std::min(startY + 1, ESM::Land::LAND_SIZE - 1);
 
         // get parametric from start coord to next point
-        float xParam = (nX - startXTS) * factor;
-        float yParam = (nY - startYTS) * factor;
-
-        /* For even / odd tri strip rows, triangles are this shape:
-        even     odd
-        3---2   3---2
-        | / |   | \ |
-        0---1   0---1
-        */
+        const float xParam = nX * factor - startX;
+        const float yParam = nY * factor - startY;
 
-        // Build all 4 positions in normalized cell space, using point-sampled height
-        osg::Vec3f v0 (startXTS, startYTS, getVertexHeight(data, startX, startY) / float(Constants::CellSizeInUnits));
-        osg::Vec3f v1 (endXTS, startYTS, getVertexHeight(data, endX, startY) / float(Constants::CellSizeInUnits));
-        osg::Vec3f v2 (endXTS, endYTS, getVertexHeight(data, endX, endY) / float(Constants::CellSizeInUnits));
-        osg::Vec3f v3 (startXTS, endYTS, getVertexHeight(data, startX, endY) / float(Constants::CellSizeInUnits));
-        // define this plane in terrain space
-        osg::Plane plane;
-        // FIXME: deal with differing triangle alignment
-        if (true)
-        {
-            // odd row
-            bool secondTri = ((1.0 - yParam) > xParam);
-            if (secondTri)
-                plane = osg::Plane(v0, v1, v3);
-            else
-                plane = osg::Plane(v1, v2, v3);
-        }
-        /*
-        else
-        {
-            // even row
-            bool secondTri = (yParam > xParam);
-            if (secondTri)
-                plane.redefine(v0, v2, v3);
-            else
-                plane.redefine(v0, v1, v2);
-        }
+        /* Triangles of a quad are this shape:
+        3---2
+        | \ |
+        0---1
         */
-
-        // Solve plane equation for z
-        return (-plane.getNormal().x() * nX
-                -plane.getNormal().y() * nY
-                - plane[3]) / plane.getNormal().z() * Constants::CellSizeInUnits;
-
+        const float h0 = heights[startY * ESM::Land::LAND_SIZE + startX];
+        const float h1 = heights[startY * ESM::Land::LAND_SIZE + endX];
+        const float h2 = heights[endY * ESM::Land::LAND_SIZE + endX];
+        const float h3 = heights[endY * ESM::Land::LAND_SIZE + startX];
+
+        // Interpolate linearly within the triangle, the same as the plane through its vertices
+        if ((1.0f - yParam) > xParam)
+            return h0 + (h1 - h0) * xParam + (h3 - h0) * yParam;
+        return h2 + (h3 - h2) * (1.0f - xParam) + (h1 - h2) * (1.0f - yParam);
     }
 
     const LandObject* Storage::getLand(int cellX, int cellY, LandCache& cache)
     {
+        if (LandCache::Slot* slot = cache.getSlot(cellX, cellY))
+        {
+            if (!slot->mLoaded)
+            {
+                slot->mLand = getLand(cellX, cellY);
+                slot->mLoaded = true;
+            }
+            return slot->mLand.get();
+        }
+
         LandCache::Map::iterator found = cache.mMap.find(std::make_pair(cellX, cellY));
         if (found != cache.mMap.end())
             return found->second;
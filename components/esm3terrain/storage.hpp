@@ -2,7 +2,9 @@
 #define COMPONENTS_ESM_TERRAIN_STORAGE_H
 
 #include <cassert>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <components/terrain/storage.hpp>
 
@@ -24,6 +26,8 @@ namespace ESMTerrain
     {
     public:
         LandObject();
+        /// @param loadFlags With only ESM::Land::DATA_VHGT, just the heights are kept in a compact array and
+        /// getData returns nullptr, the heights are available from getHeights.
         LandObject(const ESM::Land* land, int loadFlags);
         LandObject(const LandObject& copy, const osg::CopyOp& copyop);
         virtual ~LandObject();
@@ -32,17 +36,31 @@ namespace ESMTerrain
 
         inline const ESM::Land::LandData* getData(int flags) const
         {
-            if ((mData.mDataLoaded & flags) != flags)
+            if (mData == nullptr || (mData->mDataLoaded & flags) != flags)
                 return nullptr;
-            return &mData;
+            return mData.get();
         }
         inline int getPlugin() const { return mLand->getPlugin(); }
 
+        /// Heights of the LAND_SIZE * LAND_SIZE vertices, nullptr if the land has none.
+        const float* getHeights() const { return mHeights; }
+        float getMinHeight() const { return mMinHeight; }
+        float getMaxHeight() const { return mMaxHeight; }
+
+        int getLoadFlags() const { return mLoadFlags; }
+
+        /// Memory used by the loaded data in bytes.
+        std::size_t getMemoryUsage() const;
+
     private:
         const ESM::Land* mLand;
         int mLoadFlags;
 
-        ESM::Land::LandData mData;
+        std::unique_ptr<ESM::Land::LandData> mData;
+        std::vector<float> mCompactHeights;
+        const float* mHeights = nullptr;
+        float mMinHeight = 0;
+        float mMaxHeight = 0;
     };
 
     /// @brief Feeds data from ESM terrain records (ESM::Land, ESM::LandTexture)
@@ -54,6 +72,8 @@ namespace ESMTerrain
 
         // Not implemented in this class, because we need different Store implementations for game and editor
         virtual osg::ref_ptr<const LandObject> getLand (int cellX, int cellY)= 0;
+        /// Get a land with at least the heights loaded, for queries that need nothing else.
+        virtual osg::ref_ptr<const LandObject> getLandHeights (int cellX, int cellY) { return getLand(cellX, cellY); }
         virtual const ESM::LandTexture* getLandTexture(int index, short plugin) = 0;
         /// Get bounds of the whole terrain in cell units
         void getBounds(float& minX, float& maxX, float& minY, float& maxY) override = 0;
@@ -80,7 +100,7 @@ namespace ESMTerrain
         /// @param colours buffer to write vertex colours
         void fillVertexBuffers (int lodLevel, float size, const osg::Vec2f& center,
                                 osg::ref_ptr<osg::Vec3Array> positions,
-                                osg::ref_ptr<osg::Vec3Array> normals,
+                                osg::ref_ptr<osg::Vec3bArray> normals,
                                 osg::ref_ptr<osg::Vec4ubArray> colours) override;
 
         /// Create textures holding layer blend values for a terrain chunk.
@@ -94,8 +114,12 @@ namespace ESMTerrain
         void getBlendmaps (float chunkSize, const osg::Vec2f& chunkCenter, ImageVector& blendmaps,
                                std::vector<Terrain::LayerInfo>& layerList) override;
 
+        std::size_t getBlendmapHash (float chunkSize, const osg::Vec2f& chunkCenter) override;
+
         float getHeightAt (const osg::Vec3f& worldPos) override;
 
+        void getHeightsAt (const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights) override;
+
         /// Get the transformation factor for mapping cell units to world units.
         float getCellWorldSize() override;
 
@@ -120,6 +144,8 @@ namespace ESMTerrain
 
         inline const LandObject* getLand(int cellX, int cellY, LandCache& cache);
 
+        float getHeightInCell(const LandObject* land, int cellX, int cellY, const osg::Vec3f& worldPos);
+
         virtual bool useAlteration() const { return false; }
         virtual void adjustColor(int col, int row, const ESM::Land::LandData *heightData, osg::Vec4ub& color) const;
         virtual float getAlteredHeight(int col, int row) const;
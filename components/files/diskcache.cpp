@@ -0,0 +1,297 @@
+#include "diskcache.hpp"
+
+#include "hash.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace Files
+{
+    namespace
+    {
+        const std::string sTemporaryExtension = ".tmp";
+
+        std::filesystem::file_time_type now()
+        {
+            return std::filesystem::file_time_type::clock::now();
+        }
+    }
+
+    DiskCache::DiskCache(const std::filesystem::path& path, std::uint64_t maxSize)
+        : mPath(path)
+        , mMaxSize(maxSize)
+        , mThread([this] { run(); })
+    {
+    }
+
+    DiskCache::~DiskCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mHasWrites.notify_all();
+        mThread.join();
+    }
+
+    DiskCache::Key DiskCache::makeKey(std::string_view data)
+    {
+        return getHash(data);
+    }
+
+    bool DiskCache::addNamespace(const std::string& name, std::uint32_t version)
+    {
+        const std::filesystem::path directory = mPath / name;
+        const std::filesystem::path versionDirectory = directory / std::to_string(version);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mNamespaces.find(name);
+            if (it != mNamespaces.end() && it->second == versionDirectory)
+                return true;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(versionDirectory, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to create cache directory " << versionDirectory << ": " << error.message();
+            return false;
+        }
+
+        std::vector<std::filesystem::path> otherVersions;
+        for (const auto& item : std::filesystem::directory_iterator(directory, error))
+        {
+            if (item.path() != versionDirectory)
+                otherVersions.push_back(item.path());
+        }
+        for (const std::filesystem::path& path : otherVersions)
+            std::filesystem::remove_all(path, error);
+
+        std::vector<std::pair<std::filesystem::path, Entry>> entries;
+        for (const auto& item : std::filesystem::directory_iterator(versionDirectory, error))
+        {
+            if (!item.is_regular_file(error))
+                continue;
+            // Left behind by an interrupted write
+            if (item.path().extension() == sTemporaryExtension)
+            {
+                std::filesystem::remove(item.path(), error);
+                continue;
+            }
+            const std::uint64_t size = item.file_size(error);
+            if (error)
+                continue;
+            const std::filesystem::file_time_type lastUse = item.last_write_time(error);
+            if (error)
+                continue;
+            entries.emplace_back(item.path(), Entry {size, lastUse});
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mEntries.begin(); it != mEntries.end();)
+        {
+            if (it->first.parent_path().parent_path() == directory && it->first.parent_path() != versionDirectory)
+            {
+                mPending.erase(it->first);
+                mSize -= it->second.mSize;
+                it = mEntries.erase(it);
+            }
+            else
+                ++it;
+        }
+        mNamespaces[name] = versionDirectory;
+        for (const auto& [file, entry] : entries)
+        {
+            if (mEntries.emplace(file, entry).second)
+                mSize += entry.mSize;
+        }
+        evict();
+        return true;
+    }
+
+    std::optional<std::string> DiskCache::read(const std::string& name, const Key& key)
+    {
+        std::filesystem::path file;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::optional<std::filesystem::path> found = getFile(name, key);
+            if (!found)
+                return {};
+            file = std::move(*found);
+            const auto pending = mPending.find(file);
+            if (pending != mPending.end())
+                return *pending->second;
+            const auto entry = mEntries.find(file);
+            if (entry == mEntries.end())
+                return {};
+            entry->second.mLastUse = now();
+        }
+
+        std::ifstream stream(file, std::ios::binary);
+        if (stream)
+        {
+            std::string data(std::istreambuf_iterator<char>(stream), {});
+            // The modification time keeps the order of use for later sessions
+            std::error_code error;
+            std::filesystem::last_write_time(file, now(), error);
+            return data;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto entry = mEntries.find(file);
+        if (entry != mEntries.end() && mPending.find(file) == mPending.end())
+        {
+            mSize -= entry->second.mSize;
+            mEntries.erase(entry);
+        }
+        return {};
+    }
+
+    void DiskCache::write(const std::string& name, const Key& key, std::string data)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        std::optional<std::filesystem::path> file = getFile(name, key);
+        if (!file)
+            return;
+
+        const std::uint64_t size = data.size();
+        const auto [entry, inserted] = mEntries.emplace(*file, Entry {size, now()});
+        if (!inserted)
+        {
+            mSize -= entry->second.mSize;
+            entry->second = Entry {size, now()};
+        }
+        mSize += size;
+
+        // A file queued twice is only written once, with the latest data
+        mPending.insert_or_assign(*file, std::make_shared<const std::string>(std::move(data)));
+        mQueue.push_back(*file);
+        evict();
+        lock.unlock();
+        mHasWrites.notify_one();
+    }
+
+    void DiskCache::flush()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [&] { return mQueue.empty() && !mWriting; });
+    }
+
+    std::uint64_t DiskCache::getSize() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSize;
+    }
+
+    void DiskCache::run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasWrites.wait(lock, [&] { return mStop || !mQueue.empty(); });
+            if (mQueue.empty())
+                break;
+
+            const std::filesystem::path file = std::move(mQueue.front());
+            mQueue.pop_front();
+            const auto pending = mPending.find(file);
+            if (pending == mPending.end())
+            {
+                mDone.notify_all();
+                continue;
+            }
+            const std::shared_ptr<const std::string> data = pending->second;
+            mWriting = true;
+
+            lock.unlock();
+            const bool written = writeEntry(file, *data);
+            lock.lock();
+
+            mWriting = false;
+            const auto current = mPending.find(file);
+            if (current == mPending.end())
+            {
+                // Evicted while it was written
+                std::error_code error;
+                std::filesystem::remove(file, error);
+            }
+            else if (current->second == data)
+            {
+                mPending.erase(current);
+                if (!written)
+                {
+                    const auto entry = mEntries.find(file);
+                    mSize -= entry->second.mSize;
+                    mEntries.erase(entry);
+                }
+            }
+            mDone.notify_all();
+        }
+    }
+
+    bool DiskCache::writeEntry(const std::filesystem::path& file, const std::string& data)
+    {
+        std::filesystem::path temporary = file;
+        temporary += sTemporaryExtension;
+        {
+            std::ofstream stream(temporary, std::ios::binary);
+            stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write cache file " << file;
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, file, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to write cache file " << file << ": " << error.message();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    void DiskCache::evict()
+    {
+        if (mMaxSize == 0 || mSize <= mMaxSize)
+            return;
+
+        std::vector<std::map<std::filesystem::path, Entry>::iterator> entries;
+        entries.reserve(mEntries.size());
+        for (auto it = mEntries.begin(); it != mEntries.end(); ++it)
+            entries.push_back(it);
+        std::sort(entries.begin(), entries.end(),
+            [] (const auto& lhs, const auto& rhs) { return lhs->second.mLastUse < rhs->second.mLastUse; });
+
+        for (const auto& entry : entries)
+        {
+            if (mSize <= mMaxSize)
+                break;
+            // A queued entry is skipped by the writer, one being written is removed once it's done
+            mPending.erase(entry->first);
+            std::error_code error;
+            std::filesystem::remove(entry->first, error);
+            mSize -= entry->second.mSize;
+            mEntries.erase(entry);
+        }
+    }
+
+    std::optional<std::filesystem::path> DiskCache::getFile(const std::string& name, const Key& key) const
+    {
+        const auto it = mNamespaces.find(name);
+        if (it == mNamespaces.end())
+            return {};
+        std::ostringstream stream;
+        stream << std::hex << std::setfill('0') << std::setw(16) << key[0] << std::setw(16) << key[1];
+        return it->second / stream.str();
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef COMPONENTS_FILES_DISKCACHE_H
+#define COMPONENTS_FILES_DISKCACHE_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Files
+{
+    /// Persistent cache of binary entries in a directory, usually the user cache path of the ConfigurationManager.
+    /// Entries are grouped in namespaces, one sub-directory each, and found by a key, usually a hash of everything
+    /// the entry was made from, see makeKey. Each namespace has a version, entries of other versions are removed
+    /// when it's added, so a format change only needs a version bump.
+    /// Entries are written by a background thread to a temporary file first and then renamed, so an entry is either
+    /// complete or missing. When the entries take more than the size limit, the least recently used ones are removed.
+    /// @note All methods are thread safe.
+    class DiskCache
+    {
+    public:
+        using Key = std::array<std::uint64_t, 2>;
+
+        /// @param maxSize size in bytes of all entries of the added namespaces, 0 for no limit
+        DiskCache(const std::filesystem::path& path, std::uint64_t maxSize);
+
+        /// Waits for the pending writes.
+        ~DiskCache();
+
+        DiskCache(const DiskCache&) = delete;
+        DiskCache& operator=(const DiskCache&) = delete;
+
+        static Key makeKey(std::string_view data);
+
+        /// Start using the namespace, removing its entries of other versions.
+        /// @return false when its directory can't be created, all reads then miss and writes are dropped
+        bool addNamespace(const std::string& name, std::uint32_t version);
+
+        std::optional<std::string> read(const std::string& name, const Key& key);
+
+        /// Queue the entry to be written in the background, it's returned by read right away.
+        void write(const std::string& name, const Key& key, std::string data);
+
+        /// Wait until the queued entries are written.
+        void flush();
+
+        /// Size in bytes of the entries of the added namespaces, including the queued ones.
+        std::uint64_t getSize() const;
+
+    private:
+        struct Entry
+        {
+            std::uint64_t mSize;
+            std::filesystem::file_time_type mLastUse;
+        };
+
+        void run();
+        bool writeEntry(const std::filesystem::path& file, const std::string& data);
+        /// Remove the least recently used entries until they fit the size limit, needs mMutex to be locked.
+        void evict();
+        std::optional<std::filesystem::path> getFile(const std::string& name, const Key& key) const;
+
+        const std::filesystem::path mPath;
+        const std::uint64_t mMaxSize;
+        mutable std::mutex mMutex;
+        std::condition_variable mHasWrites;
+        std::condition_variable mDone;
+        std::map<std::string, std::filesystem::path, std::less<>> mNamespaces;
+        std::map<std::filesystem::path, Entry> mEntries;
+        std::uint64_t mSize = 0;
+        std::map<std::filesystem::path, std::shared_ptr<const std::string>> mPending;
+        std::deque<std::filesystem::path> mQueue;
+        bool mWriting = false;
+        bool mStop = false;
+        std::thread mThread;
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <extern/smhasher/MurmurHash3.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <istream>
@@ -38,4 +39,18 @@ namespace Files
         }
         return hash;
     }
+
+    std::array<std::uint64_t, 2> getHash(std::string_view data)
+    {
+        std::array<std::uint64_t, 2> hash {0, 0};
+        // Hash in the same blocks as the stream overload to get identical results
+        for (std::size_t offset = 0; offset < data.size(); offset += 4096)
+        {
+            const std::size_t size = std::min<std::size_t>(4096, data.size() - offset);
+            std::array<std::uint64_t, 2> blockHash {0, 0};
+            MurmurHash3_x64_128(data.data() + offset, static_cast<int>(size), hash.data(), blockHash.data());
+            hash = blockHash;
+        }
+        return hash;
+    }
 }
@@ -3,14 +3,24 @@
 #include <stdexcept>
 #include <string_view>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include <boost/filesystem/fstream.hpp>
 
 #include <osg/Image>
+#include <osg/Texture2D>
 
 #include <osgDB/WriteFile>
 
 #include <MyGUI_ResourceManager.h>
 #include <MyGUI_FontManager.h>
 #include <MyGUI_ResourceManualFont.h>
+#include <MyGUI_ResourceTrueTypeFont.h>
+#include <MyGUI_DataManager.h>
 #include <MyGUI_XmlDocument.h>
 #include <MyGUI_FactoryManager.h>
 #include <MyGUI_RenderManager.h>
@@ -19,6 +29,7 @@
 
 #include <components/vfs/manager.hpp>
 
+#include <components/misc/hash.hpp>
 #include <components/misc/pathhelpers.hpp>
 #include <components/misc/stringops.hpp>
 
@@ -144,12 +155,111 @@ namespace
         throw std::runtime_error(error.str());
     }
 
+    const char fontCacheMagic[] = {'O', 'M', 'W', 'F', 'O', 'N', 'T', '1'};
+
+    /// Glyph metrics as stored in the font cache. Coordinates are in pixels of the font texture.
+    struct CachedGlyph
+    {
+        std::uint32_t mCodePoint;
+        float mLeft;
+        float mTop;
+        float mWidth;
+        float mHeight;
+        float mAdvance;
+        float mBearingX;
+        float mBearingY;
+        float mGlyphWidth;
+        float mGlyphHeight;
+    };
+
+    std::size_t getBytesPerPixel(MyGUI::PixelFormat format)
+    {
+        switch (format.getValue())
+        {
+            case MyGUI::PixelFormat::L8: return 1;
+            case MyGUI::PixelFormat::L8A8: return 2;
+            case MyGUI::PixelFormat::R8G8B8: return 3;
+            case MyGUI::PixelFormat::R8G8B8A8: return 4;
+            default: return 0;
+        }
+    }
+
+    MyGUI::PixelFormat getPixelFormat(const osg::Image& image)
+    {
+        if (image.getDataType() != GL_UNSIGNED_BYTE)
+            return MyGUI::PixelFormat::Unknow;
+        switch (image.getPixelFormat())
+        {
+            case GL_LUMINANCE: return MyGUI::PixelFormat::L8;
+            case GL_LUMINANCE_ALPHA: return MyGUI::PixelFormat::L8A8;
+            case GL_RGB: return MyGUI::PixelFormat::R8G8B8;
+            case GL_RGBA: return MyGUI::PixelFormat::R8G8B8A8;
+            default: return MyGUI::PixelFormat::Unknow;
+        }
+    }
+
+    void hashElement(std::size_t& seed, MyGUI::xml::ElementPtr element)
+    {
+        Misc::hashCombine(seed, element->getName());
+        for (const auto& attribute : element->getAttributes())
+        {
+            Misc::hashCombine(seed, attribute.first);
+            Misc::hashCombine(seed, attribute.second);
+        }
+        MyGUI::xml::ElementEnumerator child = element->getElementEnumerator();
+        while (child.next())
+            hashElement(seed, child.current());
+    }
+
+    /// Hash everything a TrueType font is rasterized from: its XML description and the font file.
+    bool getTrueTypeFontHash(MyGUI::xml::ElementPtr resource, std::size_t& hash)
+    {
+        std::string source;
+        MyGUI::xml::ElementEnumerator property = resource->getElementEnumerator();
+        while (property.next("Property"))
+        {
+            std::string key;
+            if (property->findAttribute("key", key) && key == "Source")
+                property->findAttribute("value", source);
+        }
+
+        const std::string& path = MyGUI::DataManager::getInstance().getDataPath(source);
+        if (source.empty() || path.empty())
+            return false;
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+        const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (stream.bad())
+            return false;
+
+        hash = 0;
+        Misc::hashCombine(hash, data);
+        hashElement(hash, resource);
+        return true;
+    }
+
+    void addCode(MyGUI::xml::ElementPtr codes, const CachedGlyph& glyph)
+    {
+        MyGUI::xml::ElementPtr code = codes->createChild("Code");
+        code->addAttribute("index", glyph.mCodePoint);
+        code->addAttribute("coord", MyGUI::utility::toString(std::lround(glyph.mLeft)) + " "
+                                    + MyGUI::utility::toString(std::lround(glyph.mTop)) + " "
+                                    + MyGUI::utility::toString(std::lround(glyph.mWidth)) + " "
+                                    + MyGUI::utility::toString(std::lround(glyph.mHeight)));
+        code->addAttribute("advance", glyph.mAdvance);
+        code->addAttribute("bearing", MyGUI::utility::toString(glyph.mBearingX) + " "
+                           + MyGUI::utility::toString(glyph.mBearingY));
+        code->addAttribute("size", MyGUI::IntSize(static_cast<int>(std::lround(glyph.mGlyphWidth)),
+                                                  static_cast<int>(std::lround(glyph.mGlyphHeight))));
+    }
+
 }
 
 namespace Gui
 {
 
-    FontLoader::FontLoader(ToUTF8::FromType encoding, const VFS::Manager* vfs, const std::string& userDataPath, float scalingFactor)
+    FontLoader::FontLoader(ToUTF8::FromType encoding, const VFS::Manager* vfs, const std::string& userDataPath, const std::string& cachePath, float scalingFactor)
         : mVFS(vfs)
         , mUserDataPath(userDataPath)
         , mFontHeight(std::clamp(Settings::Manager::getInt("font size", "GUI"), 12, 20))
@@ -162,6 +272,16 @@ namespace Gui
 
         MyGUI::ResourceManager::getInstance().unregisterLoadXmlDelegate("Resource");
         MyGUI::ResourceManager::getInstance().registerLoadXmlDelegate("Resource") = MyGUI::newDelegate(this, &FontLoader::loadFontFromXml);
+
+        if (!cachePath.empty())
+        {
+            boost::system::error_code error;
+            boost::filesystem::create_directories(cachePath, error);
+            if (error)
+                Log(Debug::Warning) << "Warning: Unable to create font cache directory " << cachePath << ": " << error.message();
+            else
+                mCachePath = cachePath;
+        }
     }
 
     FontLoader::~FontLoader()
@@ -573,11 +693,10 @@ namespace Gui
             }
         }
 
-        MyGUI::ResourceManager::getInstance().loadFromXmlNode(_node, _file, _version);
-
+        std::unique_ptr<MyGUI::xml::Element> copy;
         if (createCopy)
         {
-            std::unique_ptr<MyGUI::xml::Element> copy{_node->createCopy()};
+            copy.reset(_node->createCopy());
 
             MyGUI::xml::ElementEnumerator copyFont = copy->getElementEnumerator();
             while (copyFont.next("Resource"))
@@ -612,9 +731,213 @@ namespace Gui
                     copyFont->setAttribute("name", "Journalbook " + name);
                 }
             }
+        }
+
+        loadResources(_node, _file, _version);
+        if (copy)
+            loadResources(copy.get(), _file, _version);
+    }
 
-            MyGUI::ResourceManager::getInstance().loadFromXmlNode(copy.get(), _file, _version);
+    void FontLoader::loadResources(MyGUI::xml::ElementPtr node, const std::string& file, MyGUI::Version version)
+    {
+        std::vector<MyGUI::xml::ElementPtr> cached;
+        std::vector<std::pair<std::string, std::size_t>> uncached;
+        if (!mCachePath.empty())
+        {
+            MyGUI::xml::ElementEnumerator resourceNode = node->getElementEnumerator();
+            while (resourceNode.next("Resource"))
+            {
+                std::string type, name;
+                resourceNode->findAttribute("type", type);
+                resourceNode->findAttribute("name", name);
+
+                std::size_t hash;
+                if (name.empty() || !Misc::StringUtils::ciEqual(type, "ResourceTrueTypeFont")
+                        || !getTrueTypeFontHash(resourceNode.current(), hash))
+                    continue;
+
+                if (loadCachedFont(name, hash))
+                    cached.push_back(resourceNode.current());
+                else
+                    uncached.emplace_back(name, hash);
+            }
+        }
+
+        for (MyGUI::xml::ElementPtr resource : cached)
+            node->removeChild(resource);
+
+        MyGUI::ResourceManager::getInstance().loadFromXmlNode(node, file, version);
+
+        for (const auto& [name, hash] : uncached)
+            saveCachedFont(name, hash);
+    }
+
+    std::string FontLoader::getCacheFile(std::size_t hash) const
+    {
+        std::ostringstream stream;
+        stream << mCachePath << "/" << std::hex << std::setfill('0') << std::setw(16) << hash << ".bin";
+        return stream.str();
+    }
+
+    bool FontLoader::loadCachedFont(const std::string& name, std::size_t hash)
+    {
+        const std::string path = getCacheFile(hash);
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+
+        char magic[sizeof(fontCacheMagic)];
+        std::uint64_t fileHash = 0;
+        std::int32_t width = 0;
+        std::int32_t height = 0;
+        std::int32_t format = 0;
+        std::int32_t defaultHeight = 0;
+        std::uint32_t glyphCount = 0;
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+        stream.read(reinterpret_cast<char*>(&width), sizeof(width));
+        stream.read(reinterpret_cast<char*>(&height), sizeof(height));
+        stream.read(reinterpret_cast<char*>(&format), sizeof(format));
+        stream.read(reinterpret_cast<char*>(&defaultHeight), sizeof(defaultHeight));
+        stream.read(reinterpret_cast<char*>(&glyphCount), sizeof(glyphCount));
+        const std::size_t bytesPerPixel = getBytesPerPixel(MyGUI::PixelFormat(static_cast<MyGUI::PixelFormat::Enum>(format)));
+        if (!stream || !std::equal(magic, magic + sizeof(magic), fontCacheMagic) || fileHash != hash
+                || width <= 0 || height <= 0 || bytesPerPixel == 0 || glyphCount > 0x110000)
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid font cache " << path;
+            return false;
+        }
+
+        std::vector<CachedGlyph> glyphs(glyphCount);
+        stream.read(reinterpret_cast<char*>(glyphs.data()), glyphs.size() * sizeof(CachedGlyph));
+        std::vector<char> textureData(static_cast<std::size_t>(width) * height * bytesPerPixel);
+        stream.read(textureData.data(), textureData.size());
+        if (!stream)
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid font cache " << path;
+            return false;
+        }
+
+        const std::string textureName = "Fonts/Cache/" + name;
+        MyGUI::ITexture* tex = MyGUI::RenderManager::getInstance().createTexture(textureName);
+        tex->createManual(width, height, MyGUI::TextureUsage::Write, static_cast<MyGUI::PixelFormat::Enum>(format));
+        unsigned char* texData = reinterpret_cast<unsigned char*>(tex->lock(MyGUI::TextureUsage::Write));
+        memcpy(texData, textureData.data(), textureData.size());
+        tex->unlock();
+
+        // We need to emulate loading from XML because the data members are private as of mygui 3.2.0
+        MyGUI::xml::Document xmlDocument;
+        MyGUI::xml::ElementPtr root = xmlDocument.createRoot("ResourceManualFont");
+        root->addAttribute("name", name);
+
+        MyGUI::xml::ElementPtr defaultHeightNode = root->createChild("Property");
+        defaultHeightNode->addAttribute("key", "DefaultHeight");
+        defaultHeightNode->addAttribute("value", defaultHeight);
+        MyGUI::xml::ElementPtr source = root->createChild("Property");
+        source->addAttribute("key", "Source");
+        source->addAttribute("value", textureName);
+        MyGUI::xml::ElementPtr codes = root->createChild("Codes");
+        for (const CachedGlyph& glyph : glyphs)
+            addCode(codes, glyph);
+
+        MyGUI::ResourceManualFont* font = static_cast<MyGUI::ResourceManualFont*>(
+                    MyGUI::FactoryManager::getInstance().createObject("Resource", "ResourceManualFont"));
+        font->deserialization(root, MyGUI::Version(3,2,0));
+
+        for (std::vector<MyGUI::ResourceManualFont*>::iterator it = mFonts.begin(); it != mFonts.end();)
+        {
+            if ((*it)->getResourceName() == name)
+                it = mFonts.erase(it);
+            else
+                ++it;
+        }
+        if (MyGUI::ResourceManager::getInstance().isExist(name))
+            MyGUI::ResourceManager::getInstance().removeByName(name);
+
+        mFonts.push_back(font);
+        MyGUI::ResourceManager::getInstance().addResource(font);
+        return true;
+    }
+
+    void FontLoader::saveCachedFont(const std::string& name, std::size_t hash)
+    {
+        MyGUI::ResourceTrueTypeFont* font = dynamic_cast<MyGUI::ResourceTrueTypeFont*>(
+                    MyGUI::ResourceManager::getInstance().findByName(name));
+        if (!font)
+            return;
+        osgMyGUI::OSGTexture* texture = dynamic_cast<osgMyGUI::OSGTexture*>(font->getTextureFont());
+        if (!texture || !texture->getTexture())
+            return;
+        osg::ref_ptr<const osg::Image> image = texture->getTexture()->getImage();
+        if (!image)
+            return;
+        const MyGUI::PixelFormat format = getPixelFormat(*image);
+        if (getBytesPerPixel(format) == 0 || !image->isDataContiguous())
+            return;
+
+        // OSGTexture::unlock flips the image, so flip it back to get the data MyGUI wrote
+        osg::ref_ptr<osg::Image> textureData = new osg::Image(*image, osg::CopyOp::DEEP_COPY_ALL);
+        textureData->flipVertical();
+
+        const float textureWidth = static_cast<float>(image->s());
+        const float textureHeight = static_cast<float>(image->t());
+        std::vector<CachedGlyph> glyphs;
+        const auto addGlyph = [&] (MyGUI::Char codePoint)
+        {
+            const MyGUI::GlyphInfo* info = font->getGlyphInfo(codePoint);
+            if (!info)
+                return;
+            CachedGlyph glyph;
+            glyph.mCodePoint = codePoint;
+            glyph.mLeft = info->uvRect.left * textureWidth;
+            glyph.mTop = info->uvRect.top * textureHeight;
+            glyph.mWidth = (info->uvRect.right - info->uvRect.left) * textureWidth;
+            glyph.mHeight = (info->uvRect.bottom - info->uvRect.top) * textureHeight;
+            glyph.mAdvance = info->advance;
+            glyph.mBearingX = info->bearingX;
+            glyph.mBearingY = info->bearingY;
+            glyph.mGlyphWidth = info->width;
+            glyph.mGlyphHeight = info->height;
+            glyphs.push_back(glyph);
+        };
+        for (const auto& [first, last] : font->getCodePointRanges())
+        {
+            for (MyGUI::Char codePoint = first; codePoint <= last && codePoint >= first; ++codePoint)
+                addGlyph(codePoint);
+        }
+        for (MyGUI::Char codePoint : {MyGUI::FontCodeType::Tab, MyGUI::FontCodeType::Space, MyGUI::FontCodeType::Cursor,
+                                      MyGUI::FontCodeType::Selected, MyGUI::FontCodeType::SelectedBack, MyGUI::FontCodeType::NotDefined})
+            addGlyph(codePoint);
+
+        const std::string path = getCacheFile(hash);
+        const boost::filesystem::path tempPath = path + ".tmp";
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            const std::uint64_t fileHash = hash;
+            const std::int32_t width = image->s();
+            const std::int32_t height = image->t();
+            const std::int32_t pixelFormat = format.getValue();
+            const std::int32_t defaultHeight = font->getDefaultHeight();
+            const std::uint32_t glyphCount = static_cast<std::uint32_t>(glyphs.size());
+            stream.write(fontCacheMagic, sizeof(fontCacheMagic));
+            stream.write(reinterpret_cast<const char*>(&fileHash), sizeof(fileHash));
+            stream.write(reinterpret_cast<const char*>(&width), sizeof(width));
+            stream.write(reinterpret_cast<const char*>(&height), sizeof(height));
+            stream.write(reinterpret_cast<const char*>(&pixelFormat), sizeof(pixelFormat));
+            stream.write(reinterpret_cast<const char*>(&defaultHeight), sizeof(defaultHeight));
+            stream.write(reinterpret_cast<const char*>(&glyphCount), sizeof(glyphCount));
+            stream.write(reinterpret_cast<const char*>(glyphs.data()), glyphs.size() * sizeof(CachedGlyph));
+            stream.write(reinterpret_cast<const char*>(textureData->data()), textureData->getTotalSizeInBytes());
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write font cache " << path;
+                return;
+            }
         }
+        boost::system::error_code error;
+        boost::filesystem::rename(tempPath, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to write font cache " << path << ": " << error.message();
     }
 
     int FontLoader::getFontHeight()
@@ -27,7 +27,8 @@ namespace Gui
     class FontLoader
     {
     public:
-        FontLoader (ToUTF8::FromType encoding, const VFS::Manager* vfs, const std::string& userDataPath, float scalingFactor);
+        /// @param cachePath directory to store rasterized TrueType fonts in, or empty to not cache them
+        FontLoader (ToUTF8::FromType encoding, const VFS::Manager* vfs, const std::string& userDataPath, const std::string& cachePath, float scalingFactor);
         ~FontLoader();
 
         /// @param exportToFile export the converted fonts (Images and XML with glyph metrics) to files?
@@ -42,6 +43,7 @@ namespace Gui
         ToUTF8::FromType mEncoding;
         const VFS::Manager* mVFS;
         std::string mUserDataPath;
+        std::string mCachePath;
         int mFontHeight;
         float mScalingFactor;
 
@@ -51,6 +53,14 @@ namespace Gui
         /// @param exportToFile export the converted font (Image and XML with glyph metrics) to files?
         void loadBitmapFont (const std::string& fileName, bool exportToFile);
 
+        /// Load the resources of an XML node. TrueType fonts found in the cache are loaded from there instead
+        /// of being rasterized by MyGUI, the others are added to the cache once MyGUI created them.
+        void loadResources(MyGUI::xml::ElementPtr node, const std::string& file, MyGUI::Version version);
+
+        bool loadCachedFont(const std::string& name, std::size_t hash);
+        void saveCachedFont(const std::string& name, std::size_t hash);
+        std::string getCacheFile(std::size_t hash) const;
+
         FontLoader(const FontLoader&);
         void operator=(const FontLoader&);
     };
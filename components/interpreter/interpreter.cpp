@@ -20,37 +20,30 @@ namespace Interpreter
     }
 
     template<typename T>
-    auto& getDispatcher(const T& segment, unsigned int seg, int opcode)
+    auto* findOpcode(const T& segment, int opcode)
     {
         auto it = segment.find(opcode);
-        if (it == segment.end())
-        {
-            abortUnknownCode(seg, opcode);
-        }
-        return it->second;
+        return it == segment.end() ? nullptr : it->second.get();
     }
 
-    void Interpreter::execute (Type_Code code)
+    Instruction Interpreter::decode (Type_Code code) const
     {
+        Instruction instruction;
         unsigned int segSpec = code >> 30;
 
         switch (segSpec)
         {
             case 0:
-            {
-                const int opcode = code >> 24;
-                const unsigned int arg0 = code & 0xffffff;
 
-                return getDispatcher(mSegment0, 0, opcode)->execute(mRuntime, arg0);
-            }
+                instruction.mOpcode1 = findOpcode(mSegment0, code >> 24);
+                instruction.mArg0 = code & 0xffffff;
+                return instruction;
 
             case 2:
-            {
-                const int opcode = (code >> 20) & 0x3ff;
-                const unsigned int arg0 = code & 0xfffff;
 
-                return getDispatcher(mSegment2, 2, opcode)->execute(mRuntime, arg0);
-            }
+                instruction.mOpcode1 = findOpcode(mSegment2, (code >> 20) & 0x3ff);
+                instruction.mArg0 = code & 0xfffff;
+                return instruction;
         }
 
         segSpec = code >> 26;
@@ -58,24 +51,47 @@ namespace Interpreter
         switch (segSpec)
         {
             case 0x30:
-            {
-                const int opcode = (code >> 8) & 0x3ffff;
-                const unsigned int arg0 = code & 0xff;
 
-                return getDispatcher(mSegment3, 3, opcode)->execute(mRuntime, arg0);
-            }
+                instruction.mOpcode1 = findOpcode(mSegment3, (code >> 8) & 0x3ffff);
+                instruction.mArg0 = code & 0xff;
+                return instruction;
 
             case 0x32:
-            {
-                const int opcode = code & 0x3ffffff;
 
-                return getDispatcher(mSegment5, 5, opcode)->execute(mRuntime);
-            }
+                instruction.mOpcode0 = findOpcode(mSegment5, code & 0x3ffffff);
+                return instruction;
+        }
+
+        return instruction;
+    }
+
+    void Interpreter::abortUnknown (Type_Code code) const
+    {
+        switch (code >> 30)
+        {
+            case 0: abortUnknownCode(0, code >> 24);
+            case 2: abortUnknownCode(2, (code >> 20) & 0x3ff);
+        }
+
+        switch (code >> 26)
+        {
+            case 0x30: abortUnknownCode(3, (code >> 8) & 0x3ffff);
+            case 0x32: abortUnknownCode(5, code & 0x3ffffff);
         }
 
         abortUnknownSegment (code);
     }
 
+    void Interpreter::execute (const Instruction& instruction, Type_Code code)
+    {
+        if (instruction.mOpcode1)
+            instruction.mOpcode1->execute(mRuntime, instruction.mArg0);
+        else if (instruction.mOpcode0)
+            instruction.mOpcode0->execute(mRuntime);
+        else
+            abortUnknown(code);
+    }
+
     void Interpreter::begin()
     {
         if (mRunning)
@@ -103,10 +119,11 @@ namespace Interpreter
         }
     }
 
-    Interpreter::Interpreter() : mRunning (false)
+    Interpreter::Interpreter() : mRunning (false), mInstructionCount (0)
     {}
 
-    void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    template<typename TExecute>
+    void Interpreter::run (const Type_Code *code, int codeSize, Context& context, TExecute&& execute)
     {
         assert (codeSize>=4);
 
@@ -122,9 +139,10 @@ namespace Interpreter
 
             while (mRuntime.getPC()>=0 && mRuntime.getPC()<opcodes)
             {
-                Type_Code runCode = codeBlock[mRuntime.getPC()];
-                mRuntime.setPC (mRuntime.getPC()+1);
-                execute (runCode);
+                const int pc = mRuntime.getPC();
+                mRuntime.setPC (pc+1);
+                ++mInstructionCount;
+                execute (pc, codeBlock[pc]);
             }
         }
         catch (...)
@@ -135,4 +153,31 @@ namespace Interpreter
 
         end();
     }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
+    {
+        run (code, codeSize, context, [this] (int, Type_Code runCode) { execute (decode (runCode), runCode); });
+    }
+
+    std::vector<Instruction> Interpreter::decode (const Type_Code *code, int codeSize) const
+    {
+        assert (codeSize>=4);
+
+        const int opcodes = static_cast<int> (code[0]);
+        const Type_Code *codeBlock = code + 4;
+
+        std::vector<Instruction> instructions;
+        instructions.reserve (opcodes);
+        for (int i = 0; i < opcodes; ++i)
+            instructions.push_back (decode (codeBlock[i]));
+        return instructions;
+    }
+
+    void Interpreter::run (const Type_Code *code, int codeSize, const std::vector<Instruction>& instructions,
+        Context& context)
+    {
+        assert (instructions.size() == code[0]);
+
+        run (code, codeSize, context, [&] (int pc, Type_Code runCode) { execute (instructions[pc], runCode); });
+    }
 }
@@ -5,7 +5,9 @@
 #include <stack>
 #include <memory>
 #include <cassert>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "runtime.hpp"
 #include "types.hpp"
@@ -13,11 +15,20 @@
 
 namespace Interpreter
 {
+    /// Instruction of a script with its opcode resolved, see Interpreter::decode
+    struct Instruction
+    {
+        Opcode0* mOpcode0 = nullptr;
+        Opcode1* mOpcode1 = nullptr;
+        unsigned int mArg0 = 0;
+    };
+
     class Interpreter
     {
             std::stack<Runtime> mCallstack;
             bool mRunning;
             Runtime mRuntime;
+            std::uint64_t mInstructionCount;
             std::map<int, std::unique_ptr<Opcode1>> mSegment0;
             std::map<int, std::unique_ptr<Opcode1>> mSegment2;
             std::map<int, std::unique_ptr<Opcode1>> mSegment3;
@@ -27,7 +38,14 @@ namespace Interpreter
             Interpreter (const Interpreter&);
             Interpreter& operator= (const Interpreter&);
 
-            void execute (Type_Code code);
+            Instruction decode (Type_Code code) const;
+
+            [[noreturn]] void abortUnknown (Type_Code code) const;
+
+            void execute (const Instruction& instruction, Type_Code code);
+
+            template<typename TExecute>
+            void run (const Type_Code *code, int codeSize, Context& context, TExecute&& execute);
 
             void begin();
 
@@ -69,6 +87,16 @@ namespace Interpreter
             }
 
             void run (const Type_Code *code, int codeSize, Context& context);
+
+            std::vector<Instruction> decode (const Type_Code *code, int codeSize) const;
+            ///< Resolve the opcodes of \a code once for repeated runs.
+            /// \note Opcodes that are not installed are only reported when they are executed.
+
+            void run (const Type_Code *code, int codeSize, const std::vector<Instruction>& instructions, Context& context);
+            ///< Same as run, but with the opcodes resolved by decode. Opcodes must not be reinstalled in between.
+
+            std::uint64_t getInstructionCount() const { return mInstructionCount; }
+            ///< Number of instructions executed by all runs so far, including nested ones.
     };
 }
 
@@ -4,6 +4,8 @@
 #include <luajit.h>
 #endif // NO_LUAJIT
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 
 #include <components/debug/debuglog.hpp>
@@ -49,7 +51,126 @@ namespace LuaUtil
         "type", "unpack", "xpcall", "rawequal", "rawget", "rawset", "getmetatable", "setmetatable"};
     static const std::string safePackages[] = {"coroutine", "math", "string", "table"};
 
-    LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf) : mConf(conf), mVFS(vfs)
+    namespace
+    {
+        // Every block allocated by the tracking allocator starts with this header
+        struct alignas(std::max_align_t) AllocationHeader
+        {
+            int mScriptId;
+        };
+
+        void* plainAllocator(void*, void* ptr, std::size_t, std::size_t nsize)
+        {
+            if (nsize == 0)
+            {
+                std::free(ptr);
+                return nullptr;
+            }
+            return std::realloc(ptr, nsize);
+        }
+
+        bool isCustomAllocatorSupported()
+        {
+            // LuaJIT refuses custom allocators on 64-bit platforms unless it is built with LJ_GC64
+            static const bool supported = []
+            {
+                lua_State* L = lua_newstate(&plainAllocator, nullptr);
+                if (L == nullptr)
+                    return false;
+                lua_close(L);
+                return true;
+            }();
+            return supported;
+        }
+    }
+
+    void* LuaState::trackingAllocator(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
+    {
+        LuaState* self = static_cast<LuaState*>(ud);
+        AllocationHeader* header = ptr ? static_cast<AllocationHeader*>(ptr) - 1 : nullptr;
+        // If ptr is null, osize encodes the type of the object instead of the size
+        const std::int64_t oldSize = ptr ? static_cast<std::int64_t>(osize) : 0;
+        // Memory stays attributed to the script that allocated it, even if it is freed by another one
+        const int scriptId = header ? header->mScriptId : self->mActiveScriptId;
+
+        void* result = nullptr;
+        if (nsize == 0)
+            std::free(header);
+        else
+        {
+            void* block = std::realloc(header, sizeof(AllocationHeader) + nsize);
+            if (block == nullptr)
+                return nullptr;  // Lua keeps the old block in this case
+            header = static_cast<AllocationHeader*>(block);
+            header->mScriptId = scriptId;
+            result = header + 1;
+        }
+
+        const std::int64_t delta = static_cast<std::int64_t>(nsize) - oldSize;
+        self->mTotalMemoryUsage += delta;
+        if (scriptId >= 0)
+            self->mScriptStats[scriptId].mMemoryUsage += delta;
+        return result;
+    }
+
+    sol::state LuaState::createSolState(LuaState* luaState)
+    {
+        if (luaState->mSettings.mProfilerEnabled)
+        {
+            if (isCustomAllocatorSupported())
+                return sol::state(sol::default_at_panic, &trackingAllocator, luaState);
+            Log(Debug::Warning) << "Warning: Lua memory usage can not be tracked with this build of LuaJIT, "
+                                   "the Lua profiler shows only timings";
+        }
+        return sol::state();
+    }
+
+    LuaState::ScriptCall::ScriptCall(LuaState& lua, int scriptId, std::string_view handlerName)
+        : mScriptId(scriptId)
+        , mHandlerName(handlerName)
+    {
+        if (!lua.mSettings.mProfilerEnabled || scriptId < 0)
+            return;
+        mLua = &lua;
+        if (lua.mScriptStats.size() <= static_cast<std::size_t>(scriptId))
+            lua.mScriptStats.resize(scriptId + 1);
+        mPreviousScriptId = lua.mActiveScriptId;
+        lua.mActiveScriptId = scriptId;
+        mStart = std::chrono::steady_clock::now();
+    }
+
+    LuaState::ScriptCall::~ScriptCall()
+    {
+        if (mLua == nullptr)
+            return;
+        const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+        mLua->mActiveScriptId = mPreviousScriptId;
+
+        ScriptStats& stats = mLua->mScriptStats[mScriptId];
+        auto it = stats.mHandlers.find(mHandlerName);
+        if (it == stats.mHandlers.end())
+            it = stats.mHandlers.emplace(std::string(mHandlerName), HandlerStats()).first;
+        HandlerStats& handler = it->second;
+        ++handler.mCalls;
+        handler.mTotalTime += time;
+        handler.mMaxTime = std::max(handler.mMaxTime, time);
+
+        const std::int64_t limit = mLua->mSettings.mScriptMemoryLimit;
+        if (limit > 0 && stats.mMemoryUsage > limit && !stats.mMemoryWarningShown)
+        {
+            stats.mMemoryWarningShown = true;
+            const ScriptsConfiguration& conf = mLua->getConfiguration();
+            const std::string path = static_cast<std::size_t>(mScriptId) < conf.size() ? conf[mScriptId].mScriptPath : std::string();
+            Log(Debug::Warning) << "Warning: Lua script " << path << " uses " << stats.mMemoryUsage / 1024
+                                << " KiB, which is more than the limit of " << limit / 1024 << " KiB";
+        }
+    }
+
+    LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf, const LuaStateSettings& settings)
+        : mSettings(settings)
+        , mLua(createSolState(this))
+        , mConf(conf)
+        , mVFS(vfs)
     {
         mLua.open_libraries(sol::lib::base, sol::lib::coroutine, sol::lib::math,
                             sol::lib::string, sol::lib::table, sol::lib::os, sol::lib::debug);
@@ -1,7 +1,10 @@
 #ifndef COMPONENTS_LUA_LUASTATE_H
 #define COMPONENTS_LUA_LUASTATE_H
 
+#include <chrono>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 #include <sol/sol.hpp>
 
@@ -14,6 +17,18 @@ namespace LuaUtil
 
     std::string getLuaVersion();
 
+    struct LuaStateSettings
+    {
+        // Collect memory usage and handler timings of every script, see LuaState::getScriptStats.
+        bool mProfilerEnabled = false;
+        // Soft limit in bytes, a warning is printed once for every script that uses more. 0 means no limit.
+        // Works only if the profiler is enabled.
+        std::int64_t mScriptMemoryLimit = 0;
+        // Time in seconds a script may spend in `onUpdate` per frame; scripts exceeding it are called less often
+        // with accumulated `dt`. 0 means no limit.
+        double mScriptUpdateBudget = 0;
+    };
+
     // Holds Lua state.
     // Provides additional features:
     //   - Load scripts from the virtual filesystem;
@@ -29,9 +44,50 @@ namespace LuaUtil
     class LuaState
     {
     public:
-        explicit LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf);
+        explicit LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf,
+                          const LuaStateSettings& settings = LuaStateSettings());
         ~LuaState();
 
+        const LuaStateSettings& getSettings() const { return mSettings; }
+
+        struct HandlerStats
+        {
+            std::uint64_t mCalls = 0;
+            double mTotalTime = 0;  // in seconds
+            double mMaxTime = 0;
+        };
+        struct ScriptStats
+        {
+            // Lua memory allocated while the script was running and not freed yet, in bytes
+            std::int64_t mMemoryUsage = 0;
+            std::map<std::string, HandlerStats, std::less<>> mHandlers;
+            bool mMemoryWarningShown = false;
+        };
+
+        // Indexed by script id in ScriptsConfiguration. Empty if the profiler is disabled.
+        const std::vector<ScriptStats>& getScriptStats() const { return mScriptStats; }
+        // Memory used by the whole Lua state, in bytes. 0 if the profiler is disabled.
+        std::int64_t getTotalMemoryUsage() const { return mTotalMemoryUsage; }
+
+        // While it exists, Lua allocations are attributed to the script and the time is added to the stats
+        // of the handler. Does nothing if the profiler is disabled.
+        class ScriptCall
+        {
+        public:
+            ScriptCall(LuaState& lua, int scriptId, std::string_view handlerName);
+            ~ScriptCall();
+
+            ScriptCall(const ScriptCall&) = delete;
+            ScriptCall& operator=(const ScriptCall&) = delete;
+
+        private:
+            LuaState* mLua = nullptr;
+            int mScriptId;
+            int mPreviousScriptId;
+            std::string_view mHandlerName;
+            std::chrono::steady_clock::time_point mStart;
+        };
+
         // Returns underlying sol::state.
         sol::state& sol() { return mLua; }
 
@@ -89,6 +145,15 @@ namespace LuaUtil
 
         sol::function loadScriptAndCache(const std::string& path);
 
+        static void* trackingAllocator(void* ud, void* ptr, std::size_t osize, std::size_t nsize);
+        static sol::state createSolState(LuaState* luaState);
+
+        // Used by the tracking allocator, so declared before mLua
+        const LuaStateSettings mSettings;
+        std::vector<ScriptStats> mScriptStats;
+        std::int64_t mTotalMemoryUsage = 0;
+        int mActiveScriptId = -1;
+
         sol::state mLua;
         const ScriptsConfiguration* mConf;
         sol::table mSandboxEnv;
@@ -1,5 +1,8 @@
 #include "scriptscontainer.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 #include <components/esm/luascripts.hpp>
 
 namespace LuaUtil
@@ -15,6 +18,13 @@ namespace LuaUtil
     static constexpr std::string_view HANDLER_LOAD = "onLoad";
     static constexpr std::string_view HANDLER_INTERFACE_OVERRIDE = "onInterfaceOverride";
 
+    // Names used in the profiler stats for code that is not an engine or event handler
+    static constexpr std::string_view PROFILE_SCRIPT_START = "(start)";
+    static constexpr std::string_view PROFILE_TIMER = "(timer)";
+
+    // A script that exceeded the update budget skips at most this many frames in a row
+    static constexpr int MAX_SKIPPED_FRAMES = 30;
+
     ScriptsContainer::ScriptsContainer(LuaUtil::LuaState* lua, std::string_view namePrefix, ESM::LuaScriptCfg::Flags autoStartMode)
         : mNamePrefix(namePrefix), mLua(*lua), mAutoStartMode(autoStartMode)
     {
@@ -74,7 +84,11 @@ namespace LuaUtil
 
         try
         {
-            sol::object scriptOutput = mLua.runInNewSandbox(path, mNamePrefix, mAPI, script.mHiddenData);
+            sol::object scriptOutput = [&]() -> sol::object
+            {
+                LuaState::ScriptCall scriptCall(mLua, scriptId, PROFILE_SCRIPT_START);
+                return mLua.runInNewSandbox(path, mNamePrefix, mAPI, script.mHiddenData);
+            }();
             if (scriptOutput == sol::nil)
                 return true;
             sol::object engineHandlers = sol::nil, eventHandlers = sol::nil;
@@ -244,8 +258,7 @@ namespace LuaUtil
             list[pos] = std::move(list[pos - 1]);
             pos--;
         }
-        list[pos].mScriptId = scriptId;
-        list[pos].mFn = std::move(fn);
+        list[pos] = Handler{scriptId, std::move(fn)};
     }
 
     void ScriptsContainer::removeHandler(std::vector<Handler>& list, int scriptId)
@@ -276,6 +289,7 @@ namespace LuaUtil
         EventHandlerList& list = it->second;
         for (int i = list.size() - 1; i >= 0; --i)
         {
+            LuaState::ScriptCall scriptCall(mLua, list[i].mScriptId, eventName);
             try
             {
                 sol::object res = LuaUtil::call(list[i].mFn, data);
@@ -290,6 +304,46 @@ namespace LuaUtil
         }
     }
 
+    void ScriptsContainer::update(float dt)
+    {
+        const double budget = mLua.getSettings().mScriptUpdateBudget;
+        for (Handler& handler : mUpdateHandlers.mList)
+        {
+            if (handler.mSkippedFrames > 0)
+            {
+                handler.mSkippedFrames--;
+                handler.mSkippedTime += dt;
+                continue;
+            }
+            const float handlerDt = dt + handler.mSkippedTime;
+            handler.mSkippedTime = 0;
+
+            const auto start = std::chrono::steady_clock::now();
+            {
+                LuaState::ScriptCall scriptCall(mLua, handler.mScriptId, mUpdateHandlers.mName);
+                try { LuaUtil::call(handler.mFn, handlerDt); }
+                catch (std::exception& e)
+                {
+                    Log(Debug::Error) << mNamePrefix << "[" << scriptPath(handler.mScriptId) << "] "
+                                      << mUpdateHandlers.mName << " failed. " << e.what();
+                }
+            }
+            if (budget <= 0)
+                continue;
+
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (time <= budget)
+                continue;
+            handler.mSkippedFrames = std::min(static_cast<int>(time / budget), MAX_SKIPPED_FRAMES);
+            if (!handler.mBudgetWarningShown)
+            {
+                handler.mBudgetWarningShown = true;
+                Log(Debug::Warning) << "Warning: " << mNamePrefix << "[" << scriptPath(handler.mScriptId) << "] onUpdate took "
+                                    << time * 1000 << " ms, it will be called less often to stay within the update budget";
+            }
+        }
+    }
+
     void ScriptsContainer::registerEngineHandlers(std::initializer_list<EngineHandlerList*> handlers)
     {
         for (EngineHandlerList* h : handlers)
@@ -301,6 +355,7 @@ namespace LuaUtil
         try
         {
             const std::string& data = mLua.getConfiguration()[scriptId].mInitializationData;
+            LuaState::ScriptCall scriptCall(mLua, scriptId, HANDLER_INIT);
             LuaUtil::call(onInit, deserialize(mLua.sol(), data, mSerializer));
         }
         catch (std::exception& e) { printError(scriptId, "onInit failed", e); }
@@ -335,6 +390,7 @@ namespace LuaUtil
             {
                 try
                 {
+                    LuaState::ScriptCall scriptCall(mLua, scriptId, HANDLER_SAVE);
                     sol::object state = LuaUtil::call(*script.mOnSave);
                     savedScript.mData = serialize(state, mSerializer);
                 }
@@ -386,6 +442,7 @@ namespace LuaUtil
             {
                 try
                 {
+                    LuaState::ScriptCall scriptCall(mLua, scriptId, HANDLER_LOAD);
                     sol::object state = deserialize(mLua.sol(), savedScript->mData, mSerializer);
                     sol::object initializationData =
                         deserialize(mLua.sol(), mLua.getConfiguration()[scriptId].mInitializationData, mSerializer);
@@ -490,6 +547,7 @@ namespace LuaUtil
 
     void ScriptsContainer::callTimer(const Timer& t)
     {
+        LuaState::ScriptCall scriptCall(mLua, t.mScriptId, PROFILE_TIMER);
         try
         {
             Script& script = getScript(t.mScriptId);
@@ -103,7 +103,8 @@ namespace LuaUtil
 
         // Calls `onUpdate` (if present) for every script in the container.
         // Handlers are called in the same order as scripts were added.
-        void update(float dt) { callEngineHandlers(mUpdateHandlers, dt); }
+        // Scripts exceeding LuaStateSettings::mScriptUpdateBudget skip frames and get the accumulated `dt` later.
+        void update(float dt);
 
         // Calls event handlers `eventName` (if present) for every script.
         // If several scripts register handlers for `eventName`, they are called in reverse order.
@@ -150,6 +151,10 @@ namespace LuaUtil
         {
             int mScriptId;
             sol::function mFn;
+            // Used only by `onUpdate` handlers to stay within the update budget
+            int mSkippedFrames = 0;
+            float mSkippedTime = 0;
+            bool mBudgetWarningShown = false;
         };
 
         struct EngineHandlerList
@@ -167,6 +172,7 @@ namespace LuaUtil
         {
             for (Handler& handler : handlers.mList)
             {
+                LuaState::ScriptCall scriptCall(mLua, handler.mScriptId, handlers.mName);
                 try { LuaUtil::call(handler.mFn, args...); }
                 catch (std::exception& e)
                 {
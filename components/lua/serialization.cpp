@@ -24,6 +24,7 @@ namespace LuaUtil
         BOOLEAN =      0x2,
         TABLE_START =  0x3,
         TABLE_END =    0x4,
+        ARRAY_START =  0x5,  // 32bit array size, array values, then other keys and values as in TABLE_START
 
         VEC2 =         0x10,
         VEC3 =         0x11,
@@ -158,41 +159,106 @@ namespace LuaUtil
             throw std::runtime_error("Value is not serializable.");
     }
 
-    static void serialize(BinaryData& out, const sol::object& obj, const UserdataSerializer* customSerializer, int recursionCounter)
+    static void serialize(BinaryData& out, lua_State* lua, int index, const UserdataSerializer* customSerializer, int recursionCounter);
+
+    // Returns the size of the array part if all values from 1 to #table are set, otherwise 0.
+    static size_t getArraySize(lua_State* lua, int index)
     {
-        if (obj.get_type() == sol::type::lightuserdata)
-            throw std::runtime_error("Light userdata is not allowed to be serialized.");
-        if (obj.is<sol::function>())
-            throw std::runtime_error("Functions are not allowed to be serialized.");
-        else if (obj.is<sol::userdata>())
-            serializeUserdata(out, obj, customSerializer);
-        else if (obj.is<sol::lua_table>())
+        const size_t size = lua_rawlen(lua, index);
+        for (size_t i = 1; i <= size; ++i)
+        {
+            lua_rawgeti(lua, index, static_cast<int>(i));
+            const bool isNil = lua_isnil(lua, -1);
+            lua_pop(lua, 1);
+            if (isNil)
+                return 0;
+        }
+        return size;
+    }
+
+    static bool isArrayKey(lua_State* lua, int index, size_t arraySize)
+    {
+        if (lua_type(lua, index) != LUA_TNUMBER)
+            return false;
+        const lua_Number key = lua_tonumber(lua, index);
+        return key >= 1 && key <= arraySize && key == static_cast<lua_Number>(static_cast<size_t>(key));
+    }
+
+    static void serializeTable(BinaryData& out, lua_State* lua, int index, const UserdataSerializer* customSerializer, int recursionCounter)
+    {
+        if (recursionCounter >= 32)
+            throw std::runtime_error("Can not serialize more than 32 nested tables. Likely the table contains itself.");
+        if (!lua_checkstack(lua, 3))
+            throw std::runtime_error("Lua stack overflow during serialization.");
+        const size_t arraySize = getArraySize(lua, index);
+        if (arraySize > 0)
         {
-            if (recursionCounter >= 32)
-                throw std::runtime_error("Can not serialize more than 32 nested tables. Likely the table contains itself.");
-            sol::table table = obj;
+            // Fast path for array-like tables: values are written without keys.
+            appendType(out, SerializedType::ARRAY_START);
+            appendValue<uint32_t>(out, arraySize);
+            for (size_t i = 1; i <= arraySize; ++i)
+            {
+                lua_rawgeti(lua, index, static_cast<int>(i));
+                serialize(out, lua, lua_gettop(lua), customSerializer, recursionCounter + 1);
+                lua_pop(lua, 1);
+            }
+        }
+        else
             appendType(out, SerializedType::TABLE_START);
-            for (auto& [key, value] : table)
+        lua_pushnil(lua);
+        while (lua_next(lua, index))
+        {
+            const int top = lua_gettop(lua);
+            if (!isArrayKey(lua, top - 1, arraySize))
             {
-                serialize(out, key, customSerializer, recursionCounter + 1);
-                serialize(out, value, customSerializer, recursionCounter + 1);
+                serialize(out, lua, top - 1, customSerializer, recursionCounter + 1);
+                serialize(out, lua, top, customSerializer, recursionCounter + 1);
             }
-            appendType(out, SerializedType::TABLE_END);
+            lua_pop(lua, 1);
         }
-        else if (obj.is<double>())
+        appendType(out, SerializedType::TABLE_END);
+    }
+
+    // Works directly with the Lua stack, `index` should be an absolute stack index.
+    static void serialize(BinaryData& out, lua_State* lua, int index, const UserdataSerializer* customSerializer, int recursionCounter)
+    {
+        switch (lua_type(lua, index))
         {
-            appendType(out, SerializedType::NUMBER);
-            appendValue<double>(out, obj.as<double>());
+            case LUA_TNUMBER:
+                appendType(out, SerializedType::NUMBER);
+                appendValue<double>(out, lua_tonumber(lua, index));
+                return;
+            case LUA_TSTRING:
+            {
+                size_t size = 0;
+                const char* str = lua_tolstring(lua, index, &size);
+                appendString(out, std::string_view(str, size));
+                return;
+            }
+            case LUA_TBOOLEAN:
+                appendType(out, SerializedType::BOOLEAN);
+                out.push_back(lua_toboolean(lua, index) ? 1 : 0);
+                return;
+            case LUA_TLIGHTUSERDATA:
+                throw std::runtime_error("Light userdata is not allowed to be serialized.");
+            case LUA_TFUNCTION:
+                throw std::runtime_error("Functions are not allowed to be serialized.");
+            case LUA_TTABLE:
+            case LUA_TUSERDATA:
+                break;
+            default:
+                throw std::runtime_error("Unknown Lua type.");
         }
-        else if (obj.is<std::string_view>())
-            appendString(out, obj.as<std::string_view>());
-        else if (obj.is<bool>())
+        // Callable tables and userdata are treated as functions.
+        if (luaL_getmetafield(lua, index, "__call"))
         {
-            char v = obj.as<bool>() ? 1 : 0;
-            appendType(out, SerializedType::BOOLEAN);
-            out.push_back(v);
-        } else
-            throw std::runtime_error("Unknown Lua type.");
+            lua_pop(lua, 1);
+            throw std::runtime_error("Functions are not allowed to be serialized.");
+        }
+        if (lua_type(lua, index) == LUA_TUSERDATA)
+            serializeUserdata(out, sol::userdata(lua, index), customSerializer);
+        else
+            serializeTable(out, lua, index, customSerializer, recursionCounter);
     }
 
     static void deserializeImpl(lua_State* lua, std::string_view& binaryData,
@@ -225,7 +291,9 @@ namespace LuaUtil
         if (type & SHORT_STRING_FLAG)
         {
             size_t size = type & 0x1f;
-            sol::stack::push<std::string_view>(lua, binaryData.substr(0, size));
+            if (binaryData.size() < size)
+                throw std::runtime_error("Unexpected end of serialized data.");
+            lua_pushlstring(lua, binaryData.data(), size);
             binaryData = binaryData.substr(size);
             return;
         }
@@ -240,18 +308,36 @@ namespace LuaUtil
             case SerializedType::LONG_STRING:
             {
                 uint32_t size = getValue<uint32_t>(binaryData);
-                sol::stack::push<std::string_view>(lua, binaryData.substr(0, size));
+                if (binaryData.size() < size)
+                    throw std::runtime_error("Unexpected end of serialized data.");
+                lua_pushlstring(lua, binaryData.data(), size);
                 binaryData = binaryData.substr(size);
                 return;
             }
             case SerializedType::TABLE_START:
+            case SerializedType::ARRAY_START:
             {
-                lua_createtable(lua, 0, 0);
+                if (!lua_checkstack(lua, 3))
+                    throw std::runtime_error("Lua stack overflow during deserialization.");
+                uint32_t arraySize = 0;
+                if (static_cast<SerializedType>(type) == SerializedType::ARRAY_START)
+                {
+                    arraySize = getValue<uint32_t>(binaryData);
+                    // Every value takes at least one byte
+                    if (arraySize > binaryData.size())
+                        throw std::runtime_error("Unexpected end of serialized data.");
+                }
+                lua_createtable(lua, static_cast<int>(arraySize), 0);
+                for (uint32_t i = 1; i <= arraySize; ++i)
+                {
+                    deserializeImpl(lua, binaryData, customSerializer, readOnly);
+                    lua_rawseti(lua, -2, static_cast<int>(i));
+                }
                 while (!binaryData.empty() && binaryData[0] != char(SerializedType::TABLE_END))
                 {
                     deserializeImpl(lua, binaryData, customSerializer, readOnly);
                     deserializeImpl(lua, binaryData, customSerializer, readOnly);
-                    lua_settable(lua, -3);
+                    lua_rawset(lua, -3);
                 }
                 if (binaryData.empty())
                     throw std::runtime_error("Unexpected end of serialized data.");
@@ -316,14 +402,52 @@ namespace LuaUtil
         throw std::runtime_error("Unknown type in serialized data: " + std::to_string(type));
     }
 
-    BinaryData serialize(const sol::object& obj, const UserdataSerializer* customSerializer)
+    void serializeTo(BinaryData& out, const sol::object& obj, const UserdataSerializer* customSerializer)
     {
         if (obj == sol::nil)
-            return "";
-        BinaryData res;
-        res.push_back(FORMAT_VERSION);
-        serialize(res, obj, customSerializer, 0);
-        return res;
+            return;
+        lua_State* lua = obj.lua_state();
+        const int top = lua_gettop(lua);
+        obj.push(lua);
+        out.push_back(FORMAT_VERSION);
+        try
+        {
+            serialize(out, lua, top + 1, customSerializer, 0);
+        }
+        catch (...)
+        {
+            lua_settop(lua, top);
+            throw;
+        }
+        lua_settop(lua, top);
+    }
+
+    BinaryData serialize(const sol::object& obj, const UserdataSerializer* customSerializer)
+    {
+        // The buffer is reused between calls, so only the result is allocated.
+        thread_local BinaryData buffer;
+        buffer.clear();
+        serializeTo(buffer, obj, customSerializer);
+        return BinaryData(buffer);
+    }
+
+    BinaryData serializeTable(const std::vector<std::pair<std::string_view, std::string_view>>& fields)
+    {
+        BinaryData out;
+        out.push_back(FORMAT_VERSION);
+        appendType(out, SerializedType::TABLE_START);
+        for (const auto& [key, value] : fields)
+        {
+            if (value.empty())
+                continue;
+            if (value[0] != FORMAT_VERSION)
+                throw std::runtime_error("Incorrect version of Lua serialization format: " +
+                                         std::to_string(static_cast<unsigned>(value[0])));
+            appendString(out, key);
+            out.append(value.data() + 1, value.size() - 1);
+        }
+        appendType(out, SerializedType::TABLE_END);
+        return out;
     }
 
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
@@ -1,6 +1,10 @@
 #ifndef COMPONENTS_LUA_SERIALIZATION_H
 #define COMPONENTS_LUA_SERIALIZATION_H
 
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include <sol/sol.hpp>
 
 namespace LuaUtil
@@ -27,9 +31,15 @@ namespace LuaUtil
     };
 
     BinaryData serialize(const sol::object&, const UserdataSerializer* customSerializer = nullptr);
+    // Same as `serialize`, but appends the result to the end of `out`. An empty string is appended for nil.
+    void serializeTo(BinaryData& out, const sol::object&, const UserdataSerializer* customSerializer = nullptr);
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
                             const UserdataSerializer* customSerializer = nullptr, bool readOnly = false);
 
+    // Serializes a table with string keys from values that are already serialized, without a Lua state.
+    // Fields with an empty value (serialized nil) are skipped.
+    BinaryData serializeTable(const std::vector<std::pair<std::string_view, std::string_view>>& fields);
+
 }
 
 #endif // COMPONENTS_LUA_SERIALIZATION_H
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <vector>
 
 #include <components/debug/debuglog.hpp>
 
@@ -29,6 +30,13 @@ namespace LuaUtil
         return mReadOnlyValue;
     }
 
+    sol::object LuaStorage::Value::getReadOnlyUncached(lua_State* L) const
+    {
+        if (mSerializedValue.empty())
+            return sol::nil;
+        return deserialize(L, mSerializedValue, nullptr, true);
+    }
+
     const LuaStorage::Value& LuaStorage::Section::get(std::string_view key) const
     {
         auto it = mValues.find(key);
@@ -53,14 +61,28 @@ namespace LuaUtil
         return res;
     }
 
-    sol::table LuaStorage::Section::asTable()
+    sol::table LuaStorage::Section::asTable(lua_State* L)
     {
-        sol::table res(mStorage->mLua, sol::create);
+        sol::table res(L, sol::create);
         for (const auto& [k, v] : mValues)
-            res[k] = v.getCopy(mStorage->mLua);
+            res[k] = v.getCopy(L);
         return res;
     }
 
+    const std::string& LuaStorage::Section::getSerialized() const
+    {
+        if (mSerializedCounter != mChangeCounter)
+        {
+            std::vector<std::pair<std::string_view, std::string_view>> fields;
+            fields.reserve(mValues.size());
+            for (const auto& [k, v] : mValues)
+                fields.emplace_back(k, v.getSerialized());
+            mSerialized = serializeTable(fields);
+            mSerializedCounter = mChangeCounter;
+        }
+        return mSerialized;
+    }
+
     void LuaStorage::initLuaBindings(lua_State* L)
     {
         sol::state_view lua(L);
@@ -68,14 +90,15 @@ namespace LuaUtil
         sol::usertype<SectionMutableView> mutableView = lua.new_usertype<SectionMutableView>("MutableSection");
         roView["get"] = [](sol::this_state s, SectionReadOnlyView& section, std::string_view key)
         {
-            return section.mSection->get(key).getReadOnly(s);
+            const Value& value = section.mSection->get(key);
+            return section.mForeign ? value.getReadOnlyUncached(s) : value.getReadOnly(s);
         };
         roView["getCopy"] = [](sol::this_state s, SectionReadOnlyView& section, std::string_view key)
         {
             return section.mSection->get(key).getCopy(s);
         };
         roView["wasChanged"] = [](SectionReadOnlyView& section) { return section.mSection->wasChanged(section.mLastCheck); };
-        roView["asTable"] = [](SectionReadOnlyView& section) { return section.mSection->asTable(); };
+        roView["asTable"] = [](sol::this_state s, SectionReadOnlyView& section) { return section.mSection->asTable(s); };
         mutableView["get"] = [](sol::this_state s, SectionMutableView& section, std::string_view key)
         {
             return section.mSection->get(key).getReadOnly(s);
@@ -85,7 +108,7 @@ namespace LuaUtil
             return section.mSection->get(key).getCopy(s);
         };
         mutableView["wasChanged"] = [](SectionMutableView& section) { return section.mSection->wasChanged(section.mLastCheck); };
-        mutableView["asTable"] = [](SectionMutableView& section) { return section.mSection->asTable(); };
+        mutableView["asTable"] = [](sol::this_state s, SectionMutableView& section) { return section.mSection->asTable(s); };
         mutableView["reset"] = [](SectionMutableView& section, sol::optional<sol::table> newValues)
         {
             section.mSection->mValues.clear();
@@ -152,23 +175,58 @@ namespace LuaUtil
         }
     }
 
-    void LuaStorage::save(const std::string& path) const
+    LuaStorage::~LuaStorage()
+    {
+        waitForSave();
+    }
+
+    std::string LuaStorage::serializePermanent() const
     {
-        sol::table data(mLua, sol::create);
+        // Sections keep their values serialized, so the file is assembled from them without going through Lua.
+        std::vector<std::pair<std::string_view, std::string_view>> sections;
         for (const auto& [sectionName, section] : mData)
         {
             if (section->mPermanent)
-                data[sectionName] = section->asTable();
+                sections.emplace_back(sectionName, section->getSerialized());
         }
-        std::string serializedData = serialize(data);
+        return serializeTable(sections);
+    }
+
+    void LuaStorage::write(const std::string& path, const std::string& serializedData)
+    {
         Log(Debug::Info) << "Saving Lua storage \"" << path << "\" (" << serializedData.size() << " bytes)";
-        std::ofstream fout(path, std::fstream::binary);
+        const std::string tmpPath = path + ".tmp";
+        std::ofstream fout(tmpPath, std::fstream::binary);
         fout.write(serializedData.data(), serializedData.size());
         fout.close();
+        std::error_code ec;
+        if (fout)
+            std::filesystem::rename(tmpPath, path, ec);
+        if (!fout || ec)
+            Log(Debug::Error) << "Can not write \"" << path << "\"" << (ec ? ": " + ec.message() : std::string());
+    }
+
+    void LuaStorage::save(const std::string& path)
+    {
+        waitForSave();
+        write(path, serializePermanent());
+    }
+
+    void LuaStorage::saveAsync(const std::string& path)
+    {
+        waitForSave();
+        mPendingSave = std::async(std::launch::async, [path, data = serializePermanent()] { write(path, data); });
+    }
+
+    void LuaStorage::waitForSave()
+    {
+        if (mPendingSave.valid())
+            mPendingSave.get();
     }
 
     const std::shared_ptr<LuaStorage::Section>& LuaStorage::getSection(std::string_view sectionName)
     {
+        std::lock_guard lock(mMutex);
         auto it = mData.find(sectionName);
         if (it != mData.end())
             return it->second;
@@ -178,10 +236,12 @@ namespace LuaUtil
         return newIt->second;
     }
 
-    sol::object LuaStorage::getReadOnlySection(std::string_view sectionName)
+    sol::object LuaStorage::getReadOnlySection(std::string_view sectionName, lua_State* lua)
     {
+        if (lua == nullptr)
+            lua = mLua;
         const std::shared_ptr<Section>& section = getSection(sectionName);
-        return sol::make_object<SectionReadOnlyView>(mLua, SectionReadOnlyView{section, section->mChangeCounter});
+        return sol::make_object<SectionReadOnlyView>(lua, SectionReadOnlyView{section, section->mChangeCounter, lua != mLua});
     }
 
     sol::object LuaStorage::getMutableSection(std::string_view sectionName)
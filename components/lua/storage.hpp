@@ -1,7 +1,9 @@
 #ifndef COMPONENTS_LUA_STORAGE_H
 #define COMPONENTS_LUA_STORAGE_H
 
+#include <future>
 #include <map>
+#include <mutex>
 #include <sol/sol.hpp>
 
 #include "serialization.hpp"
@@ -15,12 +17,19 @@ namespace LuaUtil
         static void initLuaBindings(lua_State*);
 
         explicit LuaStorage(lua_State* lua) : mLua(lua) {}
+        ~LuaStorage();
 
         void clearTemporary();
         void load(const std::string& path);
-        void save(const std::string& path) const;
-
-        sol::object getReadOnlySection(std::string_view sectionName);
+        void save(const std::string& path);
+        // Same as `save`, but the file is written by a background thread. Waits for the previous write if it
+        // is still running.
+        void saveAsync(const std::string& path);
+        void waitForSave();
+
+        // If `lua` is another Lua state than the one of the storage, values are deserialized into `lua`
+        // on every access instead of being cached.
+        sol::object getReadOnlySection(std::string_view sectionName, lua_State* lua = nullptr);
         sol::object getMutableSection(std::string_view sectionName);
         sol::table getAllSections();
 
@@ -37,6 +46,8 @@ namespace LuaUtil
             Value(const sol::object& value) : mSerializedValue(serialize(value)) {}
             sol::object getCopy(lua_State* L) const;
             sol::object getReadOnly(lua_State* L) const;
+            sol::object getReadOnlyUncached(lua_State* L) const;
+            const std::string& getSerialized() const { return mSerializedValue; }
 
         private:
             std::string mSerializedValue;
@@ -49,13 +60,17 @@ namespace LuaUtil
             const Value& get(std::string_view key) const;
             void set(std::string_view key, const sol::object& value);
             bool wasChanged(int64_t& lastCheck);
-            sol::table asTable();
+            sol::table asTable(lua_State* L);
+            const std::string& getSerialized() const;
 
             LuaStorage* mStorage;
             std::string mSectionName;
             std::map<std::string, Value, std::less<>> mValues;
             bool mPermanent = true;
             int64_t mChangeCounter = 0;
+            // Serialized values as they were saved, rebuilt only if the section was changed since then
+            mutable std::string mSerialized;
+            mutable int64_t mSerializedCounter = -1;
             static Value sEmpty;
         };
         struct SectionMutableView
@@ -67,13 +82,19 @@ namespace LuaUtil
         {
             std::shared_ptr<Section> mSection = nullptr;
             int64_t mLastCheck = 0;
+            bool mForeign = false;
         };
 
         const std::shared_ptr<Section>& getSection(std::string_view sectionName);
+        std::string serializePermanent() const;
+        static void write(const std::string& path, const std::string& serializedData);
 
         lua_State* mLua;
         std::map<std::string_view, std::shared_ptr<Section>> mData;
         std::optional<ListenerFn> mListener;
+        // Guards mData, sections can be requested by local scripts running in parallel
+        std::mutex mMutex;
+        std::future<void> mPendingSave;
     };
 
 }
@@ -77,7 +77,7 @@ namespace LuaUi
         // \todo remove when none of the widgets require this workaround
         sol::object skin = LuaUtil::getFieldOrNil(templateLayout, "skin");
         if (skin.is<std::string>())
-            ext->widget()->changeWidgetSkin(skin.as<std::string>());
+            ext->setTemplateSkin(skin.as<std::string>());
 
         sol::object props = LuaUtil::getFieldOrNil(templateLayout, LayoutKeys::props);
         ext->setTemplateProperties(props);
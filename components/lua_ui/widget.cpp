@@ -16,6 +16,7 @@ namespace LuaUi
         , mLayout(sol::nil)
         , mProperties(sol::nil)
         , mTemplateProperties(sol::nil)
+        , mTemplatePropertiesChanged(false)
         , mExternal(sol::nil)
         , mParent(nullptr)
     {}
@@ -153,6 +154,9 @@ namespace LuaUi
 
     void WidgetExtension::setChildren(const std::vector<WidgetExtension*>& children)
     {
+        // the children are already attached in this order and the container layout tracks their coord changes
+        if (children == mChildren)
+            return;
         mChildren.resize(children.size());
         for (size_t i = 0; i < children.size(); ++i)
         {
@@ -164,25 +168,28 @@ namespace LuaUi
 
     void WidgetExtension::setTemplateChildren(const std::vector<WidgetExtension*>& children)
     {
-        mTemplateChildren.resize(children.size());
-        for (size_t i = 0; i < children.size(); ++i)
+        if (children != mTemplateChildren)
         {
-            mTemplateChildren[i] = children[i];
-            attachTemplate(mTemplateChildren[i]);
+            mTemplateChildren.resize(children.size());
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                mTemplateChildren[i] = children[i];
+                attachTemplate(mTemplateChildren[i]);
+            }
         }
         updateTemplate();
     }
 
     void WidgetExtension::updateTemplate()
     {
-        WidgetExtension* oldSlot = mSlot;
         WidgetExtension* slot = findDeepInTemplates("slot");
         if (slot == nullptr)
             mSlot = this;
         else
             mSlot = slot->mSlot;
-        if (mSlot != oldSlot)
-            for (WidgetExtension* w : mChildren)
+        // the slot is reset on every update, so compare with the widget the children are actually attached to
+        for (WidgetExtension* w : mChildren)
+            if (w->widget()->getParent() != mSlot->widget())
                 attach(w);
     }
 
@@ -224,13 +231,53 @@ namespace LuaUi
             mOnCoordChange.value()(this, newCoord);
     }
 
+    bool WidgetExtension::updateSnapshot(const sol::object& props, std::optional<PropertiesSnapshot>& snapshot) const
+    {
+        PropertiesSnapshot result {sol::table(mLua, sol::create), 0};
+        bool changed = !snapshot.has_value();
+        if (props.is<sol::table>())
+        {
+            props.as<sol::table>().for_each([&](const sol::object& key, const sol::object& value)
+            {
+                result.mValues.raw_set(key, value);
+                ++result.mSize;
+                // userdata values like vectors are compared with their __eq metamethod
+                if (!changed && snapshot->mValues.raw_get<sol::object>(key) != value)
+                    changed = true;
+            });
+        }
+        changed = changed || snapshot->mSize != result.mSize;
+        snapshot = std::move(result);
+        return changed;
+    }
+
     void WidgetExtension::setProperties(sol::object props)
     {
+        const bool changed = updateSnapshot(props, mPropertiesSnapshot);
         mProperties = props;
+        if (!changed && !mTemplatePropertiesChanged)
+            return;
+        mTemplatePropertiesChanged = false;
         updateProperties();
         updateCoord();
     }
 
+    void WidgetExtension::setTemplateProperties(sol::object props)
+    {
+        mTemplatePropertiesChanged = updateSnapshot(props, mTemplatePropertiesSnapshot) || mTemplatePropertiesChanged;
+        mTemplateProperties = props;
+    }
+
+    void WidgetExtension::setTemplateSkin(const std::string& skin)
+    {
+        if (skin == mTemplateSkin)
+            return;
+        mWidget->changeWidgetSkin(skin);
+        mTemplateSkin = skin;
+        // the new skin doesn't know the current state of the widget
+        mTemplatePropertiesChanged = true;
+    }
+
     void WidgetExtension::updateProperties()
     {
         mAbsoluteCoord = propertyValue("position", MyGUI::IntPoint());
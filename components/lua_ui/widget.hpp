@@ -3,6 +3,7 @@
 
 #include <map>
 #include <functional>
+#include <optional>
 
 #include <MyGUI_Widget.h>
 #include <sol/sol.hpp>
@@ -38,8 +39,12 @@ namespace LuaUi
         void setCallback(const std::string&, const LuaUtil::Callback&);
         void clearCallbacks();
 
+        // only updates the widget when some of the properties or the template properties changed
         void setProperties(sol::object);
-        void setTemplateProperties(sol::object props) { mTemplateProperties = props; }
+        void setTemplateProperties(sol::object);
+
+        // does nothing if the template already applied the same skin
+        void setTemplateSkin(const std::string& skin);
 
         void setExternal(sol::object external) { mExternal = external; }
 
@@ -102,6 +107,13 @@ namespace LuaUi
         MyGUI::FloatSize mAnchor;
 
     private:
+        // shallow copy of a properties table, to tell if its values changed since the last update
+        struct PropertiesSnapshot
+        {
+            sol::table mValues;
+            std::size_t mSize;
+        };
+
         // use lua_State* instead of sol::state_view because MyGUI requires a default constructor
         lua_State* mLua;
         MyGUI::Widget* mWidget;
@@ -112,12 +124,18 @@ namespace LuaUi
         sol::table mLayout;
         sol::object mProperties;
         sol::object mTemplateProperties;
+        std::optional<PropertiesSnapshot> mPropertiesSnapshot;
+        std::optional<PropertiesSnapshot> mTemplatePropertiesSnapshot;
+        bool mTemplatePropertiesChanged;
+        std::string mTemplateSkin;
         sol::object mExternal;
         WidgetExtension* mParent;
 
         void attach(WidgetExtension* ext);
         void attachTemplate(WidgetExtension* ext);
 
+        bool updateSnapshot(const sol::object& props, std::optional<PropertiesSnapshot>& snapshot) const;
+
         WidgetExtension* findDeep(std::string_view name);
         void findAll(std::string_view flagName, std::vector<WidgetExtension*>& result);
 
@@ -4,6 +4,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -45,4 +46,52 @@ namespace Misc
                                      + ") doesn't match stored (" + std::to_string(originalSize) + ")");
         return result;
     }
+
+    std::vector<std::byte> compress(const std::vector<std::byte>& data, const std::vector<std::byte>& dictionary)
+    {
+        if (dictionary.empty())
+            return compress(data);
+        const std::unique_ptr<LZ4_stream_t, int (*)(LZ4_stream_t*)> stream(LZ4_createStream(), &LZ4_freeStream);
+        if (stream == nullptr)
+            throw std::runtime_error("Failed to create compression stream");
+        LZ4_loadDict(stream.get(), reinterpret_cast<const char*>(dictionary.data()), static_cast<int>(dictionary.size()));
+        const std::size_t originalSize = data.size();
+        std::vector<std::byte> result(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(originalSize)) + sizeof(originalSize)));
+        const int size = LZ4_compress_fast_continue(
+            stream.get(),
+            reinterpret_cast<const char*>(data.data()),
+            reinterpret_cast<char*>(result.data()) + sizeof(originalSize),
+            static_cast<int>(data.size()),
+            static_cast<int>(result.size() - sizeof(originalSize)),
+            1
+        );
+        if (size == 0)
+            throw std::runtime_error("Failed to compress");
+        std::memcpy(result.data(), &originalSize, sizeof(originalSize));
+        result.resize(static_cast<std::size_t>(size) + sizeof(originalSize));
+        return result;
+    }
+
+    std::vector<std::byte> decompress(const std::vector<std::byte>& data, const std::vector<std::byte>& dictionary)
+    {
+        if (dictionary.empty())
+            return decompress(data);
+        std::size_t originalSize;
+        std::memcpy(&originalSize, data.data(), sizeof(originalSize));
+        std::vector<std::byte> result(originalSize);
+        const int size = LZ4_decompress_safe_usingDict(
+            reinterpret_cast<const char*>(data.data()) + sizeof(originalSize),
+            reinterpret_cast<char*>(result.data()),
+            static_cast<int>(data.size() - sizeof(originalSize)),
+            static_cast<int>(result.size()),
+            reinterpret_cast<const char*>(dictionary.data()),
+            static_cast<int>(dictionary.size())
+        );
+        if (size < 0)
+            throw std::runtime_error("Failed to decompress");
+        if (originalSize != static_cast<std::size_t>(size))
+            throw std::runtime_error("Size of decompressed data (" + std::to_string(size)
+                                     + ") doesn't match stored (" + std::to_string(originalSize) + ")");
+        return result;
+    }
 }
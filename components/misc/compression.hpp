@@ -9,6 +9,11 @@ namespace Misc
     std::vector<std::byte> compress(const std::vector<std::byte>& data);
 
     std::vector<std::byte> decompress(const std::vector<std::byte>& data);
+
+    /// Uses up to last 64 KiB of dictionary, same one is required to decompress
+    std::vector<std::byte> compress(const std::vector<std::byte>& data, const std::vector<std::byte>& dictionary);
+
+    std::vector<std::byte> decompress(const std::vector<std::byte>& data, const std::vector<std::byte>& dictionary);
 }
 
 #endif
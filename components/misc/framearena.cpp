@@ -0,0 +1,55 @@
+#include "framearena.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Misc
+{
+    FrameArena::FrameArena(std::size_t blockSize)
+        : mBlockSize(std::max<std::size_t>(blockSize, 1))
+    {
+    }
+
+    void FrameArena::reset()
+    {
+        if (mBlocks.size() > 1)
+        {
+            const std::size_t capacity = getCapacity();
+            mBlocks.clear();
+            mBlocks.push_back(Block {std::unique_ptr<std::byte[]>(new std::byte[capacity]), capacity});
+        }
+        mCurrentBlock = 0;
+        mOffset = 0;
+        mUsed = 0;
+    }
+
+    std::size_t FrameArena::getCapacity() const
+    {
+        return std::accumulate(mBlocks.begin(), mBlocks.end(), std::size_t(0),
+                               [] (std::size_t sum, const Block& block) { return sum + block.mSize; });
+    }
+
+    void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        while (true)
+        {
+            for (; mCurrentBlock < mBlocks.size(); ++mCurrentBlock, mOffset = 0)
+            {
+                Block& block = mBlocks[mCurrentBlock];
+                void* pointer = block.mData.get() + mOffset;
+                std::size_t space = block.mSize - mOffset;
+                if (std::align(alignment, bytes, pointer, space) == nullptr)
+                    continue;
+                mOffset = block.mSize - space + bytes;
+                mUsed += bytes;
+                mHighWaterMark = std::max(mHighWaterMark, mUsed);
+                return pointer;
+            }
+
+            const std::size_t size = std::max(mBlockSize, bytes + alignment);
+            mBlocks.push_back(Block {std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+            mCurrentBlock = mBlocks.size() - 1;
+            mOffset = 0;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef OPENMW_COMPONENTS_MISC_FRAMEARENA_H
+#define OPENMW_COMPONENTS_MISC_FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Misc
+{
+    /// Linear allocator for containers living no longer than a frame, e.g. std::pmr::vector<T> container(&arena).
+    /// Deallocation does nothing, the memory is reused after reset(). Not thread safe.
+    class FrameArena final : public std::pmr::memory_resource
+    {
+        public:
+            explicit FrameArena(std::size_t blockSize = 256 * 1024);
+
+            FrameArena(const FrameArena&) = delete;
+
+            FrameArena& operator=(const FrameArena&) = delete;
+
+            /// Makes all the memory available again. Everything allocated from the arena has to be destroyed before.
+            /// If the frame needed more than one block they are merged into one, so the next frames fit into it.
+            void reset();
+
+            /// Bytes allocated since the last reset
+            std::size_t getUsed() const { return mUsed; }
+
+            /// Maximum of the bytes allocated between two resets
+            std::size_t getHighWaterMark() const { return mHighWaterMark; }
+
+            /// Bytes held by the blocks
+            std::size_t getCapacity() const;
+
+        private:
+            struct Block
+            {
+                std::unique_ptr<std::byte[]> mData;
+                std::size_t mSize;
+            };
+
+            const std::size_t mBlockSize;
+            std::vector<Block> mBlocks;
+            std::size_t mCurrentBlock = 0;
+            std::size_t mOffset = 0;
+            std::size_t mUsed = 0;
+            std::size_t mHighWaterMark = 0;
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+            void do_deallocate(void* /*pointer*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "internedstring.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace Misc
+{
+    namespace
+    {
+        struct Storage
+        {
+            std::mutex mMutex;
+            // Nodes are never moved, so the pointers to the values stay valid
+            std::unordered_set<std::string> mValues;
+        };
+
+        Storage& getStorage()
+        {
+            static Storage storage;
+            return storage;
+        }
+    }
+
+    InternedString::InternedString(std::string_view value)
+    {
+        if (value.empty())
+            return;
+        Storage& storage = getStorage();
+        const std::lock_guard lock(storage.mMutex);
+        mValue = &*storage.mValues.emplace(value).first;
+    }
+}
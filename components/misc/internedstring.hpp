@@ -0,0 +1,35 @@
+#ifndef OPENMW_COMPONENTS_MISC_INTERNEDSTRING_H
+#define OPENMW_COMPONENTS_MISC_INTERNEDSTRING_H
+
+#include <string>
+#include <string_view>
+
+namespace Misc
+{
+    /// Pointer sized handle to a string stored once for the whole process. Equal strings share the same storage,
+    /// so copies and comparisons are cheap. The storage is never freed, only use it for values from a small set,
+    /// e.g. record ids. Thread safe.
+    class InternedString
+    {
+        public:
+            InternedString() = default;
+
+            explicit InternedString(std::string_view value);
+
+            const std::string& get() const { return mValue == nullptr ? sEmpty : *mValue; }
+
+            bool empty() const { return mValue == nullptr; }
+
+            friend bool operator==(InternedString lhs, InternedString rhs) { return lhs.mValue == rhs.mValue; }
+
+            friend bool operator!=(InternedString lhs, InternedString rhs) { return lhs.mValue != rhs.mValue; }
+
+        private:
+            inline static const std::string sEmpty;
+
+            // nullptr for the empty string
+            const std::string* mValue = nullptr;
+    };
+}
+
+#endif
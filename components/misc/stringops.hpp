@@ -2,11 +2,14 @@
 #define MISC_STRINGOPS_H
 
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <string_view>
 #include <iterator>
 #include <functional>
+#include <type_traits>
 
 namespace Misc
 {
@@ -19,6 +22,50 @@ class StringUtils
         }
     };
 
+    static constexpr std::uint64_t sOnes = 0x0101010101010101ull;
+
+    static std::uint64_t loadWord(const char* data)
+    {
+        std::uint64_t result;
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    /// Loads less than a word, the missing bytes are zero
+    static std::uint64_t loadPartialWord(const char* data, std::size_t size)
+    {
+        std::uint64_t result = 0;
+        std::memcpy(&result, data, size);
+        return result;
+    }
+
+    /// Lower-cases eight characters at once, same as toLower for each byte of the word.
+    /// The high bit of a byte is set by the addition for ASCII characters from 'A' and above 'Z' respectively,
+    /// the sum never carries into the next byte because it's done on the lower seven bits only.
+    static std::uint64_t toLowerWord(std::uint64_t word)
+    {
+        const std::uint64_t heptets = word & (0x7F * sOnes);
+        const std::uint64_t fromA = heptets + (0x80 - 'A') * sOnes;
+        const std::uint64_t aboveZ = heptets + (0x7F - 'Z') * sOnes;
+        const std::uint64_t upper = fromA & ~aboveZ & ~word & (0x80 * sOnes);
+        return word | (upper >> 2);
+    }
+
+    static bool ciEqualData(const char* x, const char* y, std::size_t size)
+    {
+        constexpr std::size_t wordSize = sizeof(std::uint64_t);
+        for (; size >= wordSize; x += wordSize, y += wordSize, size -= wordSize)
+        {
+            const std::uint64_t left = loadWord(x);
+            const std::uint64_t right = loadWord(y);
+            if (left != right && toLowerWord(left) != toLowerWord(right))
+                return false;
+        }
+        if (size == 0)
+            return true;
+        return toLowerWord(loadPartialWord(x, size)) == toLowerWord(loadPartialWord(y, size));
+    }
+
     // Allow to convert complex arguments to C-style strings for format() function
     template <typename T>
     static T argument(T value) noexcept
@@ -43,8 +90,15 @@ public:
         return (c >= 'A' && c <= 'Z') ? c + 'a' - 'A' : c;
     }
 
-    static bool ciLess(const std::string &x, const std::string &y) {
-        return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end(), ci());
+    static bool ciLess(std::string_view x, std::string_view y)
+    {
+        // Skip the common prefix a word at a time, the first different word is ordered character by character
+        constexpr std::size_t wordSize = sizeof(std::uint64_t);
+        const std::size_t size = std::min(x.size(), y.size());
+        std::size_t offset = 0;
+        while (offset + wordSize <= size && toLowerWord(loadWord(x.data() + offset)) == toLowerWord(loadWord(y.data() + offset)))
+            offset += wordSize;
+        return std::lexicographical_compare(x.begin() + offset, x.end(), y.begin() + offset, y.end(), ci());
     }
 
     template <class X, class Y>
@@ -52,8 +106,11 @@ public:
     {
         if (std::size(x) != std::size(y))
             return false;
-        return std::equal(std::begin(x), std::end(x), std::begin(y),
-                          [] (char l, char r) { return toLower(l) == toLower(r); });
+        if constexpr (std::is_convertible_v<const X&, std::string_view> && std::is_convertible_v<const Y&, std::string_view>)
+            return ciEqualData(std::string_view(x).data(), std::string_view(y).data(), std::size(x));
+        else
+            return std::equal(std::begin(x), std::end(x), std::begin(y),
+                              [] (char l, char r) { return toLower(l) == toLower(r); });
     }
 
     template <std::size_t n>
@@ -106,7 +163,14 @@ public:
 
     /// Transforms input string to lower case w/o copy
     static void lowerCaseInPlace(std::string &inout) {
-        for (unsigned int i=0; i<inout.size(); ++i)
+        constexpr std::size_t wordSize = sizeof(std::uint64_t);
+        std::size_t i = 0;
+        for (; i + wordSize <= inout.size(); i += wordSize)
+        {
+            const std::uint64_t word = toLowerWord(loadWord(inout.data() + i));
+            std::memcpy(inout.data() + i, &word, wordSize);
+        }
+        for (; i < inout.size(); ++i)
             inout[i] = toLower(inout[i]);
     }
 
@@ -120,17 +184,42 @@ public:
 
     struct CiEqual
     {
-        bool operator()(const std::string& left, const std::string& right) const
+        using is_transparent = void;
+
+        bool operator()(std::string_view left, std::string_view right) const
         {
             return ciEqual(left, right);
         }
     };
     struct CiHash
     {
-        std::size_t operator()(std::string str) const
+        using is_transparent = void;
+
+        /// Hashes the lower-cased characters a word at a time, so no lower-case copy is needed.
+        /// The value depends on the byte order and is not meant to be stored.
+        std::size_t operator()(std::string_view str) const
         {
-            lowerCaseInPlace(str);
-            return std::hash<std::string>{}(str);
+            constexpr std::size_t wordSize = sizeof(std::uint64_t);
+            constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+            std::uint64_t hash = 14695981039346656037ull ^ str.size();
+            std::size_t i = 0;
+            for (; i + wordSize <= str.size(); i += wordSize)
+            {
+                hash = (hash ^ toLowerWord(loadWord(str.data() + i))) * multiplier;
+                hash ^= hash >> 29;
+            }
+            if (i < str.size())
+            {
+                hash = (hash ^ toLowerWord(loadPartialWord(str.data() + i, str.size() - i))) * multiplier;
+                hash ^= hash >> 29;
+            }
+            // Final mix of MurmurHash3 so the low bits used by the buckets depend on all the characters
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ull;
+            hash ^= hash >> 33;
+            return static_cast<std::size_t>(hash);
         }
     };
     struct CiComp
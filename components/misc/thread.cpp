@@ -21,6 +21,18 @@ namespace Misc
         else
             Log(Debug::Warning) << "Failed to set idle priority for thread=" << std::this_thread::get_id() << ": " << std::strerror(errno);
     }
+
+    void setCurrentThreadAffinity(std::size_t core)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        const int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result == 0)
+            Log(Debug::Verbose) << "Using core " << core << " for thread=" << std::this_thread::get_id();
+        else
+            Log(Debug::Warning) << "Failed to set affinity to core " << core << " for thread=" << std::this_thread::get_id() << ": " << std::strerror(result);
+    }
 }
 
 #elif defined(WIN32)
@@ -39,6 +51,15 @@ namespace Misc
         else
             Log(Debug::Warning) << "Failed to set idle priority for thread=" << std::this_thread::get_id() << ": " << GetLastError();
     }
+
+    void setCurrentThreadAffinity(std::size_t core)
+    {
+        const DWORD_PTR mask = DWORD_PTR(1) << (core % (sizeof(DWORD_PTR) * 8));
+        if (SetThreadAffinityMask(GetCurrentThread(), mask) != 0)
+            Log(Debug::Verbose) << "Using core " << core << " for thread=" << std::this_thread::get_id();
+        else
+            Log(Debug::Warning) << "Failed to set affinity to core " << core << " for thread=" << std::this_thread::get_id() << ": " << GetLastError();
+    }
 }
 
 #elif defined(__FreeBSD__)
@@ -58,6 +79,11 @@ namespace Misc
         else
             Log(Debug::Warning) << "Failed to set idle priority for thread=" << std::this_thread::get_id() << ": " << std::strerror(errno);
     }
+
+    void setCurrentThreadAffinity(std::size_t /*core*/)
+    {
+        Log(Debug::Warning) << "Thread affinity is not supported on this system";
+    }
 }
 
 #else
@@ -68,6 +94,11 @@ namespace Misc
     {
         Log(Debug::Warning) << "Idle thread priority is not supported on this system";
     }
+
+    void setCurrentThreadAffinity(std::size_t /*core*/)
+    {
+        Log(Debug::Warning) << "Thread affinity is not supported on this system";
+    }
 }
 
 #endif
@@ -1,11 +1,14 @@
 #ifndef OPENMW_COMPONENTS_MISC_THREAD_H
 #define OPENMW_COMPONENTS_MISC_THREAD_H
 
+#include <cstddef>
 #include <thread>
 
 namespace Misc
 {
     void setCurrentThreadIdlePriority();
+
+    void setCurrentThreadAffinity(std::size_t core);
 }
 
 #endif
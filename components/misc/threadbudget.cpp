@@ -0,0 +1,158 @@
+#include "threadbudget.hpp"
+
+#include "thread.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <osg/Stats>
+
+namespace Misc
+{
+    namespace
+    {
+        constexpr std::array<std::string_view, sThreadGroupCount> sGroupNames {
+            "physics",
+            "navigator",
+            "preload",
+            "ai",
+            "skinning",
+        };
+
+        constexpr std::array<unsigned, sThreadGroupCount> sDefaultShares {2, 1, 2, 1, 1};
+
+        const std::array<std::string, sThreadGroupCount> sStatNames {
+            "Physics Threads Busy",
+            "Navigator Threads Busy",
+            "Preload Threads Busy",
+            "AI Threads Busy",
+            "Skinning Threads Busy",
+        };
+
+        /// Main and draw thread
+        constexpr std::size_t sReservedCores = 2;
+
+        std::size_t getDefaultTotalThreads()
+        {
+            const std::size_t cores = std::thread::hardware_concurrency();
+            return cores > sReservedCores ? cores - sReservedCores : 1;
+        }
+
+        bool hasIdlePriority(ThreadGroup group)
+        {
+            // Navigation meshes are built ahead of time and must not take time from the frame
+            return group == ThreadGroup::Navigator;
+        }
+    }
+
+    ThreadBudget& ThreadBudget::instance()
+    {
+        static ThreadBudget budget;
+        return budget;
+    }
+
+    ThreadBudget::ThreadBudget()
+        : mTotalThreads(getDefaultTotalThreads())
+        , mShares(sDefaultShares)
+        , mLastReport(std::chrono::steady_clock::now())
+    {
+    }
+
+    void ThreadBudget::configure(std::size_t totalThreads, std::string_view shares, bool pinThreads)
+    {
+        mTotalThreads = totalThreads == 0 ? getDefaultTotalThreads() : totalThreads;
+        mShares = sDefaultShares;
+        mPinThreads = pinThreads;
+
+        std::istringstream stream {std::string(shares)};
+        std::string name;
+        unsigned weight = 0;
+        while (stream >> name >> weight)
+        {
+            const auto it = std::find(sGroupNames.begin(), sGroupNames.end(), name);
+            if (it == sGroupNames.end())
+            {
+                Log(Debug::Warning) << "Unknown subsystem in worker thread shares: " << name;
+                continue;
+            }
+            mShares[static_cast<std::size_t>(it - sGroupNames.begin())] = weight;
+        }
+        if (!stream.eof())
+            Log(Debug::Warning) << "Invalid worker thread shares: \"" << shares << "\"";
+
+        Log(Debug::Info) << "Using " << mTotalThreads << " worker threads";
+    }
+
+    std::size_t ThreadBudget::getThreadCount(ThreadGroup group, int configured) const
+    {
+        if (configured != -1)
+            return static_cast<std::size_t>(std::max(0, configured));
+        const unsigned total = std::accumulate(mShares.begin(), mShares.end(), 0u);
+        const unsigned share = mShares[static_cast<std::size_t>(group)];
+        if (share == 0)
+            return 0;
+        return std::max<std::size_t>(1, (mTotalThreads * share + total / 2) / total);
+    }
+
+    std::shared_ptr<ThreadUsage> ThreadBudget::registerCurrentThread(std::optional<ThreadGroup> group)
+    {
+        if (!group.has_value())
+            return nullptr;
+
+        if (hasIdlePriority(*group))
+            setCurrentThreadIdlePriority();
+
+        auto usage = std::make_shared<ThreadUsage>(*group);
+        bool pin = false;
+        std::size_t index = 0;
+        {
+            const std::lock_guard lock(mMutex);
+            mThreads.push_back(usage);
+            pin = mPinThreads;
+            index = mNextCore++;
+        }
+
+        const std::size_t cores = std::thread::hardware_concurrency();
+        if (pin && cores > 0)
+        {
+            const std::size_t reserved = cores > sReservedCores ? sReservedCores : 0;
+            setCurrentThreadAffinity(reserved + index % (cores - reserved));
+        }
+
+        return usage;
+    }
+
+    void ThreadBudget::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const std::int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mLastReport).count();
+        mLastReport = now;
+        if (elapsed <= 0)
+            return;
+
+        std::array<std::int64_t, sThreadGroupCount> busy {};
+        std::array<std::size_t, sThreadGroupCount> threads {};
+        {
+            const std::lock_guard lock(mMutex);
+            // Threads that have exited hold no reference anymore
+            mThreads.erase(std::remove_if(mThreads.begin(), mThreads.end(),
+                [] (const std::shared_ptr<ThreadUsage>& v) { return v.use_count() == 1; }), mThreads.end());
+            for (const std::shared_ptr<ThreadUsage>& usage : mThreads)
+            {
+                const std::size_t group = static_cast<std::size_t>(usage->mGroup);
+                busy[group] += usage->mBusyNs.exchange(0, std::memory_order_relaxed);
+                ++threads[group];
+            }
+        }
+
+        for (std::size_t i = 0; i < sThreadGroupCount; ++i)
+            if (threads[i] > 0)
+                stats.setAttribute(frameNumber, sStatNames[i],
+                                   std::min(100.0, 100.0 * busy[i] / (static_cast<double>(elapsed) * threads[i])));
+    }
+}
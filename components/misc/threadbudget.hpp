@@ -0,0 +1,110 @@
+#ifndef OPENMW_COMPONENTS_MISC_THREADBUDGET_H
+#define OPENMW_COMPONENTS_MISC_THREADBUDGET_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace Misc
+{
+    /// Subsystems running their work on background threads.
+    enum class ThreadGroup
+    {
+        Physics,
+        Navigator,
+        Preload,
+        Ai,
+        Skinning,
+    };
+
+    constexpr std::size_t sThreadGroupCount = 5;
+
+    /// Time a worker thread spent on jobs since the last report, written by the thread itself.
+    struct ThreadUsage
+    {
+        const ThreadGroup mGroup;
+        std::atomic<std::int64_t> mBusyNs {0};
+
+        explicit ThreadUsage(ThreadGroup group) : mGroup(group) {}
+    };
+
+    /// Adds the time until destruction to the busy time of a worker thread, does nothing for nullptr.
+    class ScopedThreadBusy
+    {
+        public:
+            explicit ScopedThreadBusy(ThreadUsage* usage)
+                : mUsage(usage)
+            {
+                if (mUsage != nullptr)
+                    mStart = std::chrono::steady_clock::now();
+            }
+
+            ~ScopedThreadBusy()
+            {
+                if (mUsage == nullptr)
+                    return;
+                const auto duration = std::chrono::steady_clock::now() - mStart;
+                mUsage->mBusyNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                          std::memory_order_relaxed);
+            }
+
+            ScopedThreadBusy(const ScopedThreadBusy&) = delete;
+            ScopedThreadBusy& operator=(const ScopedThreadBusy&) = delete;
+
+        private:
+            ThreadUsage* const mUsage;
+            std::chrono::steady_clock::time_point mStart;
+    };
+
+    /// Splits the worker threads of the engine between the subsystems using them, applies the thread affinity
+    /// and priority of each subsystem and keeps track of how busy the threads are.
+    /// A subsystem only takes a share of the budget when its own thread count setting is -1.
+    class ThreadBudget
+    {
+        public:
+            static ThreadBudget& instance();
+
+            /// @param totalThreads worker threads shared by the subsystems, 0 uses all cores but two for the main
+            /// and draw threads
+            /// @param shares weights of the subsystems as "name weight" pairs, e.g. "physics 2 navigator 1",
+            /// subsystems not listed keep their default weight
+            /// @param pinThreads bind each worker thread to a single core the main and draw threads don't use
+            /// @note Call before any of the subsystems start their threads.
+            void configure(std::size_t totalThreads, std::string_view shares, bool pinThreads);
+
+            /// Returns configured unless it's -1, then the share of the group, which is at least 1 unless its
+            /// weight is 0.
+            std::size_t getThreadCount(ThreadGroup group, int configured) const;
+
+            /// Register the calling thread as worker of the group and apply its priority and affinity.
+            /// The thread has to keep the result until it exits, for std::nullopt it's nullptr.
+            std::shared_ptr<ThreadUsage> registerCurrentThread(std::optional<ThreadGroup> group);
+
+            /// Report how busy the threads of each group were since the last report, in percent.
+            void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
+        private:
+            ThreadBudget();
+
+            std::size_t mTotalThreads;
+            std::array<unsigned, sThreadGroupCount> mShares;
+            bool mPinThreads = false;
+            std::mutex mMutex;
+            std::vector<std::shared_ptr<ThreadUsage>> mThreads;
+            std::size_t mNextCore = 0;
+            std::chrono::steady_clock::time_point mLastReport;
+    };
+}
+
+#endif
@@ -143,7 +143,7 @@ public:
                 glTexCoordPointer(2, GL_FLOAT, sizeof(MyGUI::Vertex), (char*)vbo->getArray(0)->getDataPointer() + 16);
             }
 
-            glDrawArrays(GL_TRIANGLES, 0, batch.mVertexCount);
+            glDrawArrays(GL_TRIANGLES, batch.mFirstVertex, batch.mVertexCount);
 
             if (batch.mStateSet)
             {
@@ -189,6 +189,8 @@ public:
         mDummyTexture->setInternalFormat(GL_RGB);
         mDummyTexture->setTextureSize(1,1);
 
+        createMergedBuffers();
+
         // need to flip tex coords since MyGUI uses DirectX convention of top left image origin
         osg::Matrix flipMat;
         flipMat.preMultTranslate(osg::Vec3f(0,1,0));
@@ -203,6 +205,7 @@ public:
         , mReadFrom(0)
         , mDummyTexture(copy.mDummyTexture)
     {
+        createMergedBuffers();
     }
 
     // Defines the necessary information for a draw call
@@ -218,18 +221,50 @@ public:
         // optional
         osg::ref_ptr<osg::StateSet> mStateSet;
 
+        size_t mFirstVertex = 0;
         size_t mVertexCount;
     };
 
+    /// Adds a draw call. If it uses the same texture and state as the previous one, the two are merged
+    /// into a single draw call by copying their vertices into this frame's merged vertex buffer.
     void addBatch(const Batch& batch)
     {
-        mBatchVector[mWriteTo].push_back(batch);
+        std::vector<Batch>& batches = mBatchVector[mWriteTo];
+        if (batches.empty() || !canMerge(batches.back(), batch))
+        {
+            batches.push_back(batch);
+            return;
+        }
+
+        Batch& last = batches.back();
+        osg::UByteArray* merged = mMergedArray[mWriteTo];
+        if (last.mArray != merged)
+        {
+            size_t firstVertex = merged->size() / sizeof(MyGUI::Vertex);
+            appendVertices(*merged, *last.mArray, last.mFirstVertex, last.mVertexCount);
+            last.mArray = merged;
+            last.mVertexBuffer = mMergedBuffer[mWriteTo];
+            last.mFirstVertex = firstVertex;
+        }
+        appendVertices(*merged, *batch.mArray, batch.mFirstVertex, batch.mVertexCount);
+        last.mVertexCount += batch.mVertexCount;
     }
 
     void clear()
     {
         mWriteTo = (mWriteTo+1)%sNumBuffers;
         mBatchVector[mWriteTo].clear();
+        mMergedArray[mWriteTo]->clear();
+    }
+
+    /// Called once all draw calls of the frame were added.
+    void finish()
+    {
+        if (!mMergedArray[mWriteTo]->empty())
+        {
+            mMergedArray[mWriteTo]->dirty();
+            mMergedBuffer[mWriteTo]->dirty();
+        }
     }
 
     osg::StateSet* getDrawableStateSet()
@@ -246,10 +281,39 @@ private:
     // double buffering approach, to avoid the need for synchronization with the draw thread
     std::vector<Batch> mBatchVector[sNumBuffers];
 
+    // vertices of merged draw calls, rebuilt every frame
+    osg::ref_ptr<osg::UByteArray> mMergedArray[sNumBuffers];
+    osg::ref_ptr<osg::VertexBufferObject> mMergedBuffer[sNumBuffers];
+
     int mWriteTo;
     mutable int mReadFrom;
 
     osg::ref_ptr<osg::Texture2D> mDummyTexture;
+
+    void createMergedBuffers()
+    {
+        for (int i = 0; i < sNumBuffers; ++i)
+        {
+            mMergedArray[i] = new osg::UByteArray;
+            mMergedBuffer[i] = new osg::VertexBufferObject;
+            mMergedBuffer[i]->setDataVariance(osg::Object::DYNAMIC);
+            mMergedBuffer[i]->setUsage(GL_DYNAMIC_DRAW);
+            // NB mMergedBuffer does not own the array
+            mMergedBuffer[i]->setArray(0, mMergedArray[i].get());
+        }
+    }
+
+    static bool canMerge(const Batch& first, const Batch& second)
+    {
+        return first.mTexture == second.mTexture && first.mStateSet == second.mStateSet
+            && first.mArray && second.mArray;
+    }
+
+    static void appendVertices(osg::UByteArray& dest, const osg::Array& src, size_t first, size_t count)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(src.getDataPointer()) + first * sizeof(MyGUI::Vertex);
+        dest.insert(dest.end(), data, data + count * sizeof(MyGUI::Vertex));
+    }
 };
 
 class OSGVertexBuffer : public MyGUI::IVertexBuffer
@@ -482,6 +546,7 @@ void RenderManager::setInjectState(osg::StateSet* stateSet)
 
 void RenderManager::end()
 {
+    mDrawable->finish();
 }
 
 void RenderManager::update()
@@ -15,7 +15,29 @@ namespace Nif
 NIFFile::NIFFile(Files::IStreamPtr stream, const std::string &name)
     : filename(name)
 {
-    parse(stream);
+    // Decoding from one contiguous buffer is much cheaper than issuing a stream read per value
+    std::vector<char> buffer;
+    const auto start = stream->tellg();
+    if (start >= 0 && stream->seekg(0, std::ios_base::end))
+    {
+        const auto end = stream->tellg();
+        if (end > start)
+            buffer.reserve(static_cast<std::size_t>(end - start));
+        stream->seekg(start);
+    }
+    stream->clear();
+    std::array<char, 65536> chunk;
+    while (stream->read(chunk.data(), chunk.size()) || stream->gcount() > 0)
+        buffer.insert(buffer.end(), chunk.data(), chunk.data() + stream->gcount());
+    if (stream->bad())
+        fail("Failed to read file");
+    parse(std::string_view(buffer.data(), buffer.size()));
+}
+
+NIFFile::NIFFile(std::string_view data, const std::string &name)
+    : filename(name)
+{
+    parse(data);
 }
 
 template <typename NodeType, RecordType recordType>
@@ -168,12 +190,12 @@ std::string NIFFile::printVersion(unsigned int version)
     return stream.str();
 }
 
-void NIFFile::parse(Files::IStreamPtr stream)
+void NIFFile::parse(std::string_view data)
 {
-    const std::array<std::uint64_t, 2> fileHash = Files::getHash(filename, *stream);
+    const std::array<std::uint64_t, 2> fileHash = Files::getHash(data);
     hash.append(reinterpret_cast<const char*>(fileHash.data()), fileHash.size() * sizeof(std::uint64_t));
 
-    NIFStream nif (this, stream);
+    NIFStream nif (this, data);
 
     // Check the header string
     std::string head = nif.getVersionString();
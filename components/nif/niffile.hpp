@@ -4,6 +4,7 @@
 #define OPENMW_COMPONENTS_NIF_NIFFILE_HPP
 
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 #include <atomic>
 
@@ -69,7 +70,7 @@ class NIFFile final : public File
     static std::atomic_bool sLoadUnsupportedFiles;
 
     /// Parse the file
-    void parse(Files::IStreamPtr stream);
+    void parse(std::string_view data);
 
     /// Get the file's version in a human readable form
     ///\returns A string containing a human readable NIF version number
@@ -109,6 +110,10 @@ public:
     /// Open a NIF stream. The name is used for error messages.
     NIFFile(Files::IStreamPtr stream, const std::string &name);
 
+    /// Parse a NIF file already held in memory, e.g. a memory-mapped archive view.
+    /// The data only needs to stay valid for the duration of the call.
+    NIFFile(std::string_view data, const std::string &name);
+
     /// Get a given record
     Record *getRecord(size_t index) const override
     {
@@ -3,14 +3,17 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stdint.h>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <typeinfo>
 #include <type_traits>
 
-#include <components/files/constrainedfilestream.hpp>
 #include <components/misc/endianness.hpp>
 
 #include <osg/Vec3f>
@@ -24,103 +27,98 @@ namespace Nif
 
 class NIFFile;
 
-template <std::size_t numInstances, typename T> inline void readLittleEndianBufferOfType(Files::IStreamPtr &pIStream, T* dest)
+class NIFStream
 {
-    static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
-    pIStream->read((char*)dest, numInstances * sizeof(T));
-    if (pIStream->bad())
-        throw std::runtime_error("Failed to read little endian typed (" + std::string(typeid(T).name()) + ") buffer of "
-                                 + std::to_string(numInstances) + " instances");
-    if constexpr (Misc::IS_BIG_ENDIAN)
-        for (std::size_t i = 0; i < numInstances; i++)
-            Misc::swapEndiannessInplace(dest[i]);
-}
+    /// Contents of the file being decoded
+    std::string_view mData;
+    /// Current read position in mData
+    std::size_t mPos = 0;
 
-template <typename T> inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr &pIStream, T* dest, std::size_t numInstances)
-{
-    static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
-    pIStream->read((char*)dest, numInstances * sizeof(T));
-    if (pIStream->bad())
-        throw std::runtime_error("Failed to read little endian dynamic buffer of " + std::to_string(numInstances) + " instances");
-    if constexpr (Misc::IS_BIG_ENDIAN)
-        for (std::size_t i = 0; i < numInstances; i++)
-            Misc::swapEndiannessInplace(dest[i]);
-}
-template<typename type> type inline readLittleEndianType(Files::IStreamPtr &pIStream)
-{
-    type val;
-    readLittleEndianBufferOfType<1, type>(pIStream, &val);
-    return val;
-}
+    template <typename T> void readLittleEndianBufferOfType(T* dest, std::size_t numInstances)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
+        const std::size_t size = numInstances * sizeof(T);
+        if (size > mData.size() - mPos)
+            throw std::runtime_error("Failed to read little endian typed (" + std::string(typeid(T).name()) + ") buffer of "
+                                     + std::to_string(numInstances) + " instances");
+        std::memcpy(dest, mData.data() + mPos, size);
+        mPos += size;
+        if constexpr (Misc::IS_BIG_ENDIAN)
+            for (std::size_t i = 0; i < numInstances; i++)
+                Misc::swapEndiannessInplace(dest[i]);
+    }
 
-class NIFStream
-{
-    /// Input stream
-    Files::IStreamPtr inp;
+    template <typename T> T readLittleEndianType()
+    {
+        T val;
+        readLittleEndianBufferOfType<T>(&val, 1);
+        return val;
+    }
 
 public:
 
     NIFFile * const file;
 
-    NIFStream (NIFFile * file, Files::IStreamPtr inp): inp (inp), file (file) {}
+    /// @note The data must outlive the stream.
+    NIFStream (NIFFile * file, std::string_view data): mData (data), file (file) {}
 
-    void skip(size_t size) { inp->ignore(size); }
+    void skip(size_t size) { mPos += std::min(size, mData.size() - mPos); }
 
     char getChar()
     {
-        return readLittleEndianType<char>(inp);
+        return readLittleEndianType<char>();
     }
 
     short getShort()
     {
-        return readLittleEndianType<short>(inp);
+        return readLittleEndianType<short>();
     }
 
     unsigned short getUShort()
     {
-        return readLittleEndianType<unsigned short>(inp);
+        return readLittleEndianType<unsigned short>();
     }
 
     int getInt()
     {
-        return readLittleEndianType<int>(inp);
+        return readLittleEndianType<int>();
     }
 
     unsigned int getUInt()
     {
-        return readLittleEndianType<unsigned int>(inp);
+        return readLittleEndianType<unsigned int>();
     }
 
     float getFloat()
     {
-        return readLittleEndianType<float>(inp);
+        return readLittleEndianType<float>();
     }
 
     osg::Vec2f getVector2()
     {
         osg::Vec2f vec;
-        readLittleEndianBufferOfType<2,float>(inp, vec._v);
+        readLittleEndianBufferOfType<float>(vec._v, 2);
         return vec;
     }
 
     osg::Vec3f getVector3()
     {
         osg::Vec3f vec;
-        readLittleEndianBufferOfType<3, float>(inp, vec._v);
+        readLittleEndianBufferOfType<float>(vec._v, 3);
         return vec;
     }
 
     osg::Vec4f getVector4()
     {
         osg::Vec4f vec;
-        readLittleEndianBufferOfType<4, float>(inp, vec._v);
+        readLittleEndianBufferOfType<float>(vec._v, 4);
         return vec;
     }
 
     Matrix3 getMatrix3()
     {
         Matrix3 mat;
-        readLittleEndianBufferOfType<9, float>(inp, (float*)&mat.mValues);
+        readLittleEndianBufferOfType<float>((float*)&mat.mValues, 9);
         return mat;
     }
 
@@ -145,94 +143,95 @@ public:
     ///Read in a string of the given length
     std::string getSizedString(size_t length)
     {
-        std::string str(length, '\0');
-        inp->read(str.data(), length);
-        if (inp->bad())
+        if (length > mData.size() - mPos)
             throw std::runtime_error("Failed to read sized string of " + std::to_string(length) + " chars");
-        size_t end = str.find('\0');
-        if (end != std::string::npos)
-            str.erase(end);
-        return str;
+        std::string_view str = mData.substr(mPos, length);
+        mPos += length;
+        return std::string(str.substr(0, str.find('\0')));
     }
     ///Read in a string of the length specified in the file
     std::string getSizedString()
     {
-        size_t size = readLittleEndianType<uint32_t>(inp);
+        size_t size = readLittleEndianType<uint32_t>();
         return getSizedString(size);
     }
 
     ///Specific to Bethesda headers, uses a byte for length
     std::string getExportString()
     {
-        size_t size = static_cast<size_t>(readLittleEndianType<uint8_t>(inp));
+        size_t size = static_cast<size_t>(readLittleEndianType<uint8_t>());
         return getSizedString(size);
     }
 
     ///This is special since the version string doesn't start with a number, and ends with "\n"
     std::string getVersionString()
     {
-        std::string result;
-        std::getline(*inp, result);
-        if (inp->bad())
-            throw std::runtime_error("Failed to read version string");
-        return result;
+        const std::string_view rest = mData.substr(mPos);
+        const std::size_t end = rest.find('\n');
+        if (end == std::string_view::npos)
+        {
+            mPos = mData.size();
+            return std::string(rest);
+        }
+        mPos += end + 1;
+        return std::string(rest.substr(0, end));
     }
 
     void getChars(std::vector<char> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<char>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<char>(vec.data(), size);
     }
 
     void getUChars(std::vector<unsigned char> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned char>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<unsigned char>(vec.data(), size);
     }
 
     void getUShorts(std::vector<unsigned short> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned short>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<unsigned short>(vec.data(), size);
     }
 
     void getFloats(std::vector<float> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<float>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<float>(vec.data(), size);
     }
 
     void getInts(std::vector<int> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<int>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<int>(vec.data(), size);
     }
 
     void getUInts(std::vector<unsigned int> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned int>(inp, vec.data(), size);
+        readLittleEndianBufferOfType<unsigned int>(vec.data(), size);
     }
 
     void getVector2s(std::vector<osg::Vec2f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec2f is 2 floats exactly */
-        readLittleEndianDynamicBufferOfType<float>(inp,(float*)vec.data(), size*2);
+        readLittleEndianBufferOfType<float>((float*)vec.data(), size*2);
     }
 
     void getVector3s(std::vector<osg::Vec3f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec3f is 3 floats exactly */
-        readLittleEndianDynamicBufferOfType<float>(inp, (float*)vec.data(), size*3);
+        readLittleEndianBufferOfType<float>((float*)vec.data(), size*3);
     }
 
     void getVector4s(std::vector<osg::Vec4f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec4f is 4 floats exactly */
-        readLittleEndianDynamicBufferOfType<float>(inp, (float*)vec.data(), size*4);
+        readLittleEndianBufferOfType<float>((float*)vec.data(), size*4);
     }
 
     void getQuaternions(std::vector<osg::Quat> &quat, size_t size)
@@ -17,6 +17,8 @@
 #include <components/nif/extra.hpp>
 #include <components/nif/parent.hpp>
 
+#include "simplifymesh.hpp"
+
 namespace
 {
 
@@ -212,12 +214,26 @@ osg::ref_ptr<Resource::BulletShape> BulletNifLoader::load(const Nif::File& nif)
 
     // If there's no bounding box, we'll have to generate a Bullet collision shape
     // from the collision data present in every root node.
+    bool allAutogenerated = true;
     for (const Nif::Node* node : roots)
     {
         bool autogenerated = hasAutoGeneratedCollision(*node);
+        allAutogenerated = allAutogenerated && autogenerated;
         handleNode(filename, *node, nullptr, 0, autogenerated, isAnimated, autogenerated);
     }
 
+    // Meshes made for rendering carry a lot more detail than collisions need, authored collision is left alone
+    if (allAutogenerated && mSimplificationMaxError > 0 && mStaticMesh != nullptr
+        && mStaticMesh->getNumTriangles() >= mSimplificationMinTriangles)
+    {
+        if (std::unique_ptr<btTriangleMesh> simplified = simplifyTriangleMesh(*mStaticMesh, mSimplificationMaxError))
+        {
+            Log(Debug::Verbose) << "Simplified the collision of " << filename << " from " << mStaticMesh->getNumTriangles()
+                << " to " << simplified->getNumTriangles() << " triangles";
+            mStaticMesh = std::move(simplified);
+        }
+    }
+
     if (mCompoundShape)
     {
         if (mStaticMesh != nullptr && mStaticMesh->getNumTriangles() > 0)
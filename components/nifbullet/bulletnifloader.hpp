@@ -53,6 +53,15 @@ public:
 
     osg::ref_ptr<Resource::BulletShape> load(const Nif::File& file);
 
+    /// Simplify the static collision meshes generated from the rendered geometry of files without a collision node,
+    /// see simplifyTriangleMesh. Meshes with less than minTriangles triangles are kept as they are.
+    /// @param maxError greatest distance a vertex may be moved by, 0 disables the simplification
+    void setCollisionSimplification(float maxError, int minTriangles)
+    {
+        mSimplificationMaxError = maxError;
+        mSimplificationMinTriangles = minTriangles;
+    }
+
 private:
     bool findBoundingBox(const Nif::Node& node, const std::string& filename);
 
@@ -74,6 +83,10 @@ private:
     std::unique_ptr<btTriangleMesh> mAvoidStaticMesh;
 
     osg::ref_ptr<Resource::BulletShape> mShape;
+
+    float mSimplificationMaxError = 0;
+
+    int mSimplificationMinTriangles = 0;
 };
 
 }
@@ -0,0 +1,130 @@
+#include "simplifymesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+namespace NifBullet
+{
+    namespace
+    {
+        using Cell = std::tuple<std::int64_t, std::int64_t, std::int64_t>;
+
+        struct Cluster
+        {
+            btVector3 mSum {0, 0, 0};
+            int mCount = 0;
+            int mIndex = -1;
+        };
+
+        bool readTriangles(const btTriangleMesh& mesh, std::vector<btVector3>& vertices, std::vector<int>& indices)
+        {
+            const unsigned char* vertexBase = nullptr;
+            int numVertices = 0;
+            PHY_ScalarType vertexType = PHY_FLOAT;
+            int vertexStride = 0;
+            const unsigned char* indexBase = nullptr;
+            int indexStride = 0;
+            int numFaces = 0;
+            PHY_ScalarType indexType = PHY_INTEGER;
+            mesh.getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType, vertexStride,
+                                                  &indexBase, indexStride, numFaces, indexType, 0);
+
+            const bool supported = vertexType == (std::is_same_v<btScalar, float> ? PHY_FLOAT : PHY_DOUBLE)
+                && (indexType == PHY_SHORT || indexType == PHY_INTEGER);
+            if (supported)
+            {
+                vertices.reserve(static_cast<std::size_t>(numVertices));
+                for (int i = 0; i < numVertices; ++i)
+                {
+                    const btScalar* vertex = reinterpret_cast<const btScalar*>(vertexBase + i * vertexStride);
+                    vertices.emplace_back(vertex[0], vertex[1], vertex[2]);
+                }
+
+                indices.reserve(static_cast<std::size_t>(numFaces) * 3);
+                for (int i = 0; i < numFaces; ++i)
+                {
+                    const unsigned char* face = indexBase + i * indexStride;
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        if (indexType == PHY_SHORT)
+                            indices.push_back(reinterpret_cast<const unsigned short*>(face)[j]);
+                        else
+                            indices.push_back(static_cast<int>(reinterpret_cast<const unsigned int*>(face)[j]));
+                    }
+                }
+            }
+
+            mesh.unLockReadOnlyVertexBase(0);
+            return supported;
+        }
+    }
+
+    std::unique_ptr<btTriangleMesh> simplifyTriangleMesh(const btTriangleMesh& mesh, float maxError)
+    {
+        if (!(maxError > 0))
+            return nullptr;
+
+        std::vector<btVector3> vertices;
+        std::vector<int> indices;
+        if (!readTriangles(mesh, vertices, indices) || indices.empty())
+            return nullptr;
+
+        // The average of the vertices in a cell stays within the cell, so it's at most a cell diagonal away from any of them
+        const btScalar cellSize = static_cast<btScalar>(maxError / std::sqrt(3.0f));
+        std::map<Cell, Cluster> clusters;
+        std::vector<Cluster*> vertexClusters;
+        vertexClusters.reserve(vertices.size());
+        for (const btVector3& vertex : vertices)
+        {
+            const Cell cell(static_cast<std::int64_t>(std::floor(vertex.x() / cellSize)),
+                            static_cast<std::int64_t>(std::floor(vertex.y() / cellSize)),
+                            static_cast<std::int64_t>(std::floor(vertex.z() / cellSize)));
+            Cluster& cluster = clusters[cell];
+            cluster.mSum += vertex;
+            ++cluster.mCount;
+            vertexClusters.push_back(&cluster);
+        }
+
+        std::unique_ptr<btTriangleMesh> result(new btTriangleMesh);
+        std::set<std::array<int, 3>> added;
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            std::array<Cluster*, 3> triangle;
+            for (std::size_t j = 0; j < 3; ++j)
+                triangle[j] = vertexClusters[static_cast<std::size_t>(indices[i + j])];
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+                continue;
+
+            std::array<int, 3> triangleIndices;
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                Cluster& cluster = *triangle[j];
+                if (cluster.mIndex < 0)
+                    cluster.mIndex = result->findOrAddVertex(cluster.mSum / static_cast<btScalar>(cluster.mCount), false);
+                triangleIndices[j] = cluster.mIndex;
+            }
+
+            // Faces in both directions are kept, only the same face twice is dropped
+            std::array<int, 3> key = triangleIndices;
+            std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+            if (!added.insert(key).second)
+                continue;
+
+            result->addTriangleIndices(triangleIndices[0], triangleIndices[1], triangleIndices[2]);
+        }
+
+        if (result->getNumTriangles() == 0 || result->getNumTriangles() >= mesh.getNumTriangles())
+            return nullptr;
+
+        return result;
+    }
+}
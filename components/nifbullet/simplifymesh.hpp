@@ -0,0 +1,17 @@
+#ifndef OPENMW_COMPONENTS_NIFBULLET_SIMPLIFYMESH_HPP
+#define OPENMW_COMPONENTS_NIFBULLET_SIMPLIFYMESH_HPP
+
+#include <memory>
+
+class btTriangleMesh;
+
+namespace NifBullet
+{
+    /// Build a coarser collision mesh by merging the vertices within each cell of a grid into their average, dropping
+    /// the triangles that collapse and the duplicates. No vertex moves by more than maxError, so the surface stays
+    /// within that distance of the original one, while the detail smaller than it is removed.
+    /// @return nullptr when the mesh can't be read or doesn't get smaller.
+    std::unique_ptr<btTriangleMesh> simplifyTriangleMesh(const btTriangleMesh& mesh, float maxError);
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "controller.hpp"
 
+#include <cmath>
+#include <limits>
+
 #include <osg/MatrixTransform>
 #include <osg/TexMat>
 #include <osg/Material>
@@ -79,10 +82,12 @@ KeyframeController::KeyframeController(const KeyframeController &copy, const osg
     , mZRotations(copy.mZRotations)
     , mTranslations(copy.mTranslations)
     , mScales(copy.mScales)
+    , mSharedSamples(copy.mSharedSamples)
 {
 }
 
 KeyframeController::KeyframeController(const Nif::NiKeyframeController *keyctrl)
+    : mSharedSamples(std::make_shared<SharedSamples>())
 {
     if (!keyctrl->interpolator.empty())
     {
@@ -137,6 +142,51 @@ osg::Vec3f KeyframeController::getTranslation(float time) const
     return osg::Vec3f();
 }
 
+std::size_t KeyframeController::getMemoryUsage() const
+{
+    return sizeof(*this) + mRotations.getMemoryUsage() + mXRotations.getMemoryUsage() + mYRotations.getMemoryUsage()
+        + mZRotations.getMemoryUsage() + mTranslations.getMemoryUsage() + mScales.getMemoryUsage();
+}
+
+bool KeyframeController::hasRotation() const
+{
+    return !mRotations.empty() || !mXRotations.empty() || !mYRotations.empty() || !mZRotations.empty();
+}
+
+osg::Quat KeyframeController::getRotation(float time) const
+{
+    if (!mRotations.empty())
+        return mRotations.interpKey(time);
+    return getXYZRotation(time);
+}
+
+const KeyframeController::Sample& KeyframeController::getSharedSample(float time)
+{
+    // 30 poses per second are shared, an actor far enough for sharing doesn't show the difference
+    constexpr float sampleRate = 30.f;
+    constexpr std::size_t maxSamples = 16;
+
+    std::vector<Sample>& samples = mSharedSamples->mSamples;
+    if (samples.empty())
+        samples.resize(maxSamples);
+
+    const int step = static_cast<int>(std::round(time * sampleRate));
+    const int index = step % static_cast<int>(maxSamples);
+    Sample& sample = samples[static_cast<std::size_t>(index < 0 ? index + static_cast<int>(maxSamples) : index)];
+    if (sample.mStep == step)
+        return sample;
+
+    const float sampleTime = step / sampleRate;
+    sample.mStep = step;
+    if (hasRotation())
+        sample.mRotation = getRotation(sampleTime);
+    if (!mScales.empty())
+        sample.mScale = mScales.interpKey(sampleTime);
+    if (!mTranslations.empty())
+        sample.mTranslation = mTranslations.interpKey(sampleTime);
+    return sample;
+}
+
 void KeyframeController::operator() (NifOsg::MatrixTransform* node, osg::NodeVisitor* nv)
 {
     if (hasInput())
@@ -145,17 +195,17 @@ void KeyframeController::operator() (NifOsg::MatrixTransform* node, osg::NodeVis
 
         float time = getInputValue(nv);
 
+        // The keys are interpolated once for all the actors playing the track at about the same time
+        const Sample* sample = nullptr;
+        if (mSharedSamples != nullptr && isInputShared())
+            sample = &getSharedSample(time);
+
         Nif::Matrix3& rot = node->mRotationScale;
 
         bool setRot = false;
-        if(!mRotations.empty())
-        {
-            mat.setRotate(mRotations.interpKey(time));
-            setRot = true;
-        }
-        else if (!mXRotations.empty() || !mYRotations.empty() || !mZRotations.empty())
+        if (hasRotation())
         {
-            mat.setRotate(getXYZRotation(time));
+            mat.setRotate(sample != nullptr ? sample->mRotation : getRotation(time));
             setRot = true;
         }
         else
@@ -173,14 +223,14 @@ void KeyframeController::operator() (NifOsg::MatrixTransform* node, osg::NodeVis
 
         float& scale = node->mScale;
         if(!mScales.empty())
-            scale = mScales.interpKey(time);
+            scale = sample != nullptr ? sample->mScale : mScales.interpKey(time);
 
         for (int i=0;i<3;++i)
             for (int j=0;j<3;++j)
                 mat(i,j) *= scale;
 
         if(!mTranslations.empty())
-            mat.setTrans(mTranslations.interpKey(time));
+            mat.setTrans(sample != nullptr ? sample->mTranslation : mTranslations.interpKey(time));
 
         node->setMatrix(mat);
     }
@@ -276,6 +326,8 @@ void UVController::setDefaults(osg::StateSet *stateset)
 
 void UVController::apply(osg::StateSet* stateset, osg::NodeVisitor* nv)
 {
+    if (isSkipped(nv))
+        return;
     if (hasInput())
     {
         float value = getInputValue(nv);
@@ -414,6 +466,8 @@ void AlphaController::setDefaults(osg::StateSet *stateset)
 
 void AlphaController::apply(osg::StateSet *stateset, osg::NodeVisitor *nv)
 {
+    if (isSkipped(nv))
+        return;
     if (hasInput())
     {
         float value = mData.interpKey(getInputValue(nv));
@@ -457,6 +511,8 @@ void MaterialColorController::setDefaults(osg::StateSet *stateset)
 
 void MaterialColorController::apply(osg::StateSet *stateset, osg::NodeVisitor *nv)
 {
+    if (isSkipped(nv))
+        return;
     if (hasInput())
     {
         osg::Vec3f value = mData.interpKey(getInputValue(nv));
@@ -523,6 +579,8 @@ FlipController::FlipController(const FlipController &copy, const osg::CopyOp &co
 
 void FlipController::apply(osg::StateSet* stateset, osg::NodeVisitor* nv)
 {
+    if (isSkipped(nv))
+        return;
     if (hasInput() && !mTextures.empty())
     {
         int curTexture = 0;
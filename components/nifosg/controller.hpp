@@ -10,8 +10,12 @@
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <set>
 #include <type_traits>
+#include <vector>
 
 #include <osg/Texture2D>
 
@@ -36,32 +40,71 @@ namespace NifOsg
 
     class MatrixTransform;
 
-    // interpolation of keyframes
-    template <typename MapT>
-    class ValueInterpolator
+    /// Keys of a track stored contiguously, a time lookup only touches the array of times.
+    template <typename ValueT>
+    struct KeyTrack
     {
-        typename MapT::MapType::const_iterator retrieveKey(float time) const
+        std::vector<float> mTimes;
+        std::vector<ValueT> mValues;
+        // Only used by quadratic interpolation
+        std::vector<ValueT> mInTans;
+        std::vector<ValueT> mOutTans;
+        unsigned int mInterpolationType = Nif::InterpolationType_Unknown;
+
+        template <typename MapT>
+        explicit KeyTrack(const MapT& keys)
+            : mInterpolationType(keys.mInterpolationType)
         {
-            // retrieve the current position in the map, optimized for the most common case
-            // where time moves linearly along the keyframe track
-            if (mLastHighKey != mKeys->mKeys.end())
+            const bool tangents = mInterpolationType == Nif::InterpolationType_Quadratic
+                && !std::is_same_v<ValueT, osg::Quat>;
+            mTimes.reserve(keys.mKeys.size());
+            mValues.reserve(keys.mKeys.size());
+            for (const auto& [time, key] : keys.mKeys)
             {
-                if (time > mLastHighKey->first)
+                mTimes.push_back(time);
+                mValues.push_back(key.mValue);
+                if (tangents)
                 {
-                    // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
+                    mInTans.push_back(key.mInTan);
+                    mOutTans.push_back(key.mOutTan);
                 }
-                if (mLastHighKey != mKeys->mKeys.end() && time >= mLastLowKey->first && time <= mLastHighKey->first)
-                    return mLastHighKey;
             }
+        }
 
-            return mKeys->mKeys.lower_bound(time);
+        std::size_t getMemoryUsage() const
+        {
+            return sizeof(*this) + mTimes.capacity() * sizeof(float)
+                + (mValues.capacity() + mInTans.capacity() + mOutTans.capacity()) * sizeof(ValueT);
         }
+    };
 
+    // interpolation of keyframes
+    template <typename MapT>
+    class ValueInterpolator
+    {
     public:
         using ValueT = typename MapT::ValueType;
 
+    private:
+        /// @return the index of the first key after the given time, which must be within the track
+        std::size_t retrieveKey(float time) const
+        {
+            // optimized for the most common case where time moves linearly along the keyframe track
+            const std::vector<float>& times = mTrack->mTimes;
+            std::size_t high = mLastHighKey;
+            if (high > 0 && high < times.size())
+            {
+                // try if we're there by incrementing one
+                if (time > times[high] && high + 1 < times.size())
+                    ++high;
+                if (times[high - 1] <= time && time <= times[high])
+                    return mLastHighKey = high;
+            }
+
+            return mLastHighKey = static_cast<std::size_t>(std::lower_bound(times.begin(), times.end(), time) - times.begin());
+        }
+
+    public:
         ValueInterpolator() = default;
 
         template<
@@ -83,23 +126,13 @@ namespace NifOsg
         {
             if (interpolator->data.empty())
                 return;
-            mKeys = interpolator->data->mKeyList;
-            if (mKeys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
+            compile(interpolator->data->mKeyList.get());
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
-            : mKeys(keys)
-            , mDefaultVal(defaultVal)
+            : mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
+            compile(keys.get());
         }
 
         ValueT interpKey(float time) const
@@ -107,41 +140,51 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType & keys = mKeys->mKeys;
-
-            if(time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            const KeyTrack<ValueT>& track = *mTrack;
 
-            typename MapT::MapType::const_iterator it = retrieveKey(time);
+            if (time <= track.mTimes.front())
+                return track.mValues.front();
 
-            // now do the actual interpolation
-            if (it != keys.end())
-            {
-                // cache for next time
-                mLastHighKey = it;
-                mLastLowKey = --it;
+            if (time >= track.mTimes.back())
+                return track.mValues.back();
 
-                float a = (time - mLastLowKey->first) / (mLastHighKey->first - mLastLowKey->first);
+            // now do the actual interpolation, the key is never the first one as the time is after it
+            const std::size_t high = retrieveKey(time);
+            const std::size_t low = high - 1;
 
-                return interpolate(mLastLowKey->second, mLastHighKey->second, a, mKeys->mInterpolationType);
-            }
+            const float a = (time - track.mTimes[low]) / (track.mTimes[high] - track.mTimes[low]);
 
-            return keys.rbegin()->second.mValue;
+            return interpolate(track, low, high, a);
         }
 
         bool empty() const
         {
-            return !mKeys || mKeys->mKeys.empty();
+            return !mTrack;
+        }
+
+        /// Memory used by the compiled track, which is shared by the copies of the interpolator.
+        std::size_t getMemoryUsage() const
+        {
+            return mTrack ? mTrack->getMemoryUsage() : 0;
         }
 
     private:
+        void compile(const MapT* keys)
+        {
+            // Copies of the interpolator share the compiled track
+            if (keys && !keys->mKeys.empty())
+                mTrack = std::make_shared<const KeyTrack<ValueT>>(*keys);
+        }
+
         template <typename ValueType>
-        ValueType interpolate(const Nif::KeyT<ValueType>& a, const Nif::KeyT<ValueType>& b, float fraction, unsigned int type) const
+        static ValueType interpolate(const KeyTrack<ValueType>& track, std::size_t low, std::size_t high, float fraction)
         {
-            switch (type)
+            const ValueType& a = track.mValues[low];
+            const ValueType& b = track.mValues[high];
+            switch (track.mInterpolationType)
             {
                 case Nif::InterpolationType_Constant:
-                    return fraction > 0.5f ? b.mValue : a.mValue;
+                    return fraction > 0.5f ? b : a;
                 case Nif::InterpolationType_Quadratic:
                 {
                     // Using a cubic Hermite spline.
@@ -157,33 +200,34 @@ namespace NifOsg
                     const float b2 = -2.f * t3 + 3.f * t2;
                     const float b3 = t3 - 2.f * t2 + t;
                     const float b4 = t3 - t2;
-                    return a.mValue * b1 + b.mValue * b2 + a.mOutTan * b3 + b.mInTan * b4;
+                    return a * b1 + b * b2 + track.mOutTans[low] * b3 + track.mInTans[high] * b4;
                 }
                 // TODO: Implement TBC interpolation
                 default:
-                    return a.mValue + ((b.mValue - a.mValue) * fraction);
+                    return a + ((b - a) * fraction);
             }
         }
-        osg::Quat interpolate(const Nif::KeyT<osg::Quat>& a, const Nif::KeyT<osg::Quat>& b, float fraction, unsigned int type) const
+        static osg::Quat interpolate(const KeyTrack<osg::Quat>& track, std::size_t low, std::size_t high, float fraction)
         {
-            switch (type)
+            const osg::Quat& a = track.mValues[low];
+            const osg::Quat& b = track.mValues[high];
+            switch (track.mInterpolationType)
             {
                 case Nif::InterpolationType_Constant:
-                    return fraction > 0.5f ? b.mValue : a.mValue;
+                    return fraction > 0.5f ? b : a;
                 // TODO: Implement Quadratic and TBC interpolation
                 default:
                 {
                     osg::Quat result;
-                    result.slerp(fraction, a.mValue, b.mValue);
+                    result.slerp(fraction, a, b);
                     return result;
                 }
             }
         }
 
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        mutable std::size_t mLastHighKey = 0;
 
-        std::shared_ptr<const MapT> mKeys;
+        std::shared_ptr<const KeyTrack<ValueT>> mTrack;
 
         ValueT mDefaultVal = ValueT();
     };
@@ -242,6 +286,7 @@ namespace NifOsg
 
         osg::Vec3f getTranslation(float time) const override;
         osg::Callback* getAsCallback() override { return this; }
+        std::size_t getMemoryUsage() const override;
 
         void operator() (NifOsg::MatrixTransform*, osg::NodeVisitor*);
 
@@ -255,7 +300,28 @@ namespace NifOsg
         Vec3Interpolator mTranslations;
         FloatInterpolator mScales;
 
+        /// Interpolated keys at a quantised time
+        struct Sample
+        {
+            int mStep = std::numeric_limits<int>::min();
+            osg::Quat mRotation;
+            osg::Vec3f mTranslation;
+            float mScale = 1.f;
+        };
+
+        /// Samples evaluated by any of the copies of the controller with a shared input, filled on first use.
+        /// Copies of the same template evaluating their track at nearby times reuse them.
+        struct SharedSamples
+        {
+            std::vector<Sample> mSamples;
+        };
+
+        std::shared_ptr<SharedSamples> mSharedSamples;
+
         osg::Quat getXYZRotation(float time) const;
+        bool hasRotation() const;
+        osg::Quat getRotation(float time) const;
+        const Sample& getSharedSample(float time);
     };
 
     class UVController : public SceneUtil::StateSetUpdater, public SceneUtil::Controller
@@ -270,6 +336,8 @@ namespace NifOsg
         void setDefaults(osg::StateSet* stateset) override;
         void apply(osg::StateSet *stateset, osg::NodeVisitor *nv) override;
 
+        bool isSkippableWhenInvisible() const override { return true; }
+
     private:
         FloatInterpolator mUTrans;
         FloatInterpolator mVTrans;
@@ -328,6 +396,8 @@ namespace NifOsg
 
         void apply(osg::StateSet* stateset, osg::NodeVisitor* nv) override;
 
+        bool isSkippableWhenInvisible() const override { return true; }
+
         META_Object(NifOsg, AlphaController)
     };
 
@@ -352,6 +422,8 @@ namespace NifOsg
 
         void apply(osg::StateSet* stateset, osg::NodeVisitor* nv) override;
 
+        bool isSkippableWhenInvisible() const override { return true; }
+
     private:
         Vec3Interpolator mData;
         TargetColor mTargetColor = Ambient;
@@ -377,6 +449,8 @@ namespace NifOsg
         std::vector<osg::ref_ptr<osg::Texture2D> >& getTextures() { return mTextures; }
 
         void apply(osg::StateSet *stateset, osg::NodeVisitor *nv) override;
+
+        bool isSkippableWhenInvisible() const override { return true; }
     };
 
     class ParticleSystemController : public SceneUtil::NodeCallback<ParticleSystemController, osgParticle::ParticleProcessor*>, public SceneUtil::Controller
@@ -201,6 +201,18 @@ namespace NifOsg
         return sIntersectionDisabledNodeMask;
     }
 
+    bool Loader::sFreezeInvisibleParticles = false;
+
+    void Loader::setFreezeInvisibleParticles(bool freeze)
+    {
+        sFreezeInvisibleParticles = freeze;
+    }
+
+    bool Loader::getFreezeInvisibleParticles()
+    {
+        return sFreezeInvisibleParticles;
+    }
+
     class LoaderImpl
     {
     public:
@@ -893,7 +905,7 @@ namespace NifOsg
 
         void handleParticlePrograms(Nif::NiParticleModifierPtr affectors, Nif::NiParticleModifierPtr colliders, osg::Group *attachTo, osgParticle::ParticleSystem* partsys, osgParticle::ParticleProcessor::ReferenceFrame rf)
         {
-            osgParticle::ModularProgram* program = new osgParticle::ModularProgram;
+            osgParticle::ModularProgram* program = new ParticleProgram;
             attachTo->addChild(program);
             program->setParticleSystem(partsys);
             program->setReferenceFrame(rf);
@@ -1068,6 +1080,7 @@ namespace NifOsg
         {
             osg::ref_ptr<ParticleSystem> partsys (new ParticleSystem);
             partsys->setSortMode(osgParticle::ParticleSystem::SORT_BACK_TO_FRONT);
+            partsys->setFreezeWhenInvisible(Loader::getFreezeInvisibleParticles());
 
             const Nif::NiParticleSystemController* partctrl = nullptr;
             for (Nif::ControllerPtr ctrl = nifNode->controller; !ctrl.empty(); ctrl = ctrl->next)
@@ -51,10 +51,16 @@ namespace NifOsg
         static void setIntersectionDisabledNodeMask(unsigned int mask);
         static unsigned int getIntersectionDisabledNodeMask();
 
+        /// Set whether particle systems stop simulating their particles while they aren't drawn.
+        /// Default: false.
+        static void setFreezeInvisibleParticles(bool freeze);
+        static bool getFreezeInvisibleParticles();
+
     private:
         static unsigned int sHiddenNodeMask;
         static unsigned int sIntersectionDisabledNodeMask;
         static bool sShowMarkers;
+        static bool sFreezeInvisibleParticles;
     };
 
 }
@@ -73,6 +73,7 @@ ParticleSystem::ParticleSystem()
 ParticleSystem::ParticleSystem(const ParticleSystem &copy, const osg::CopyOp &copyop)
     : osgParticle::ParticleSystem(copy, copyop)
     , mQuota(copy.mQuota)
+    , mFreezeWhenInvisible(copy.mFreezeWhenInvisible)
 {
     mNormalArray = new osg::Vec3Array(1);
     mNormalArray->setBinding(osg::Array::BIND_OVERALL);
@@ -95,9 +96,32 @@ osgParticle::Particle* ParticleSystem::createParticle(const osgParticle::Particl
     return nullptr;
 }
 
+void ParticleSystem::update(double dt, osg::NodeVisitor& nv)
+{
+    mFrozenWhileInvisible = false;
+    if (mFreezeWhenInvisible && nv.getFrameStamp() != nullptr && numParticles() > numDeadParticles())
+    {
+        const unsigned int frame = nv.getFrameStamp()->getFrameNumber();
+        unsigned int lastDrawnFrame = mLastDrawnFrame.load(std::memory_order_relaxed);
+        // Not drawn yet, give it a chance to be culled in
+        if (lastDrawnFrame == sNeverDrawn)
+        {
+            lastDrawnFrame = frame;
+            mLastDrawnFrame.store(frame, std::memory_order_relaxed);
+        }
+        // The previous frame may still be drawing
+        mFrozenWhileInvisible = lastDrawnFrame + 2 < frame;
+    }
+
+    if (!mFrozenWhileInvisible)
+        osgParticle::ParticleSystem::update(dt, nv);
+}
+
 void ParticleSystem::drawImplementation(osg::RenderInfo& renderInfo) const
 {
     osg::State & state = *renderInfo.getState();
+    if (state.getFrameStamp() != nullptr)
+        mLastDrawnFrame.store(state.getFrameStamp()->getFrameNumber(), std::memory_order_relaxed);
 #if OSG_MIN_VERSION_REQUIRED(3, 5, 6)
     if(state.useVertexArrayObject(getUseVertexArrayObject()))
     {
@@ -114,6 +138,55 @@ void ParticleSystem::drawImplementation(osg::RenderInfo& renderInfo) const
      osgParticle::ParticleSystem::drawImplementation(renderInfo);
 }
 
+namespace
+{
+    bool isFrozenWhileInvisible(const osgParticle::ParticleSystem* partsys)
+    {
+        const ParticleSystem* nifPartsys = dynamic_cast<const ParticleSystem*>(partsys);
+        return nifPartsys != nullptr && nifPartsys->isFrozenWhileInvisible();
+    }
+}
+
+ParticleProgram::ParticleProgram(const ParticleProgram& copy, const osg::CopyOp& copyop)
+    : osgParticle::ModularProgram(copy, copyop)
+{
+}
+
+void ParticleProgram::execute(double dt)
+{
+    osgParticle::ParticleSystem* partsys = getParticleSystem();
+    if (isFrozenWhileInvisible(partsys))
+        return;
+
+    mEnabledOperators.clear();
+    for (int i = 0; i < numOperators(); ++i)
+    {
+        osgParticle::Operator* op = getOperator(i);
+        if (!op->isEnabled())
+            continue;
+        op->beginOperate(this);
+        mEnabledOperators.push_back(op);
+    }
+
+    if (!mEnabledOperators.empty())
+    {
+        const int count = partsys->numParticles();
+        for (int i = 0; i < count; ++i)
+        {
+            osgParticle::Particle* particle = partsys->getParticle(i);
+            for (osgParticle::Operator* op : mEnabledOperators)
+            {
+                if (!particle->isAlive())
+                    break;
+                op->operate(particle, dt);
+            }
+        }
+    }
+
+    for (osgParticle::Operator* op : mEnabledOperators)
+        op->endOperate();
+}
+
 void InverseWorldMatrix::operator()(osg::MatrixTransform *node, osg::NodeVisitor *nv)
 {
     osg::NodePath path = nv->getNodePath();
@@ -312,6 +385,7 @@ Emitter::Emitter()
     : osgParticle::Emitter()
     , mUseGeometryEmitter(false)
     , mGeometryEmitterTarget(std::nullopt)
+    , mSkipNextEmission(false)
 {
 }
 
@@ -325,6 +399,7 @@ Emitter::Emitter(const Emitter &copy, const osg::CopyOp &copyop)
     , mUseGeometryEmitter(copy.mUseGeometryEmitter)
     , mGeometryEmitterTarget(copy.mGeometryEmitterTarget)
     , mCachedGeometryEmitter(copy.mCachedGeometryEmitter)
+    , mSkipNextEmission(false)
 {
 }
 
@@ -332,11 +407,21 @@ Emitter::Emitter(const std::vector<int> &targets)
     : mTargets(targets)
     , mUseGeometryEmitter(false)
     , mGeometryEmitterTarget(std::nullopt)
+    , mSkipNextEmission(false)
 {
 }
 
 void Emitter::emitParticles(double dt)
 {
+    if (mSkipNextEmission)
+    {
+        mSkipNextEmission = false;
+        return;
+    }
+
+    if (isFrozenWhileInvisible(getParticleSystem()))
+        return;
+
     int n = mCounter->numParticlesToCreate(dt);
     if (n == 0)
         return;
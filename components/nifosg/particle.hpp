@@ -1,7 +1,9 @@
 #ifndef OPENMW_COMPONENTS_NIFOSG_PARTICLE_H
 #define OPENMW_COMPONENTS_NIFOSG_PARTICLE_H
 
+#include <atomic>
 #include <optional>
+#include <vector>
 
 #include <osgParticle/Particle>
 #include <osgParticle/Shooter>
@@ -9,6 +11,7 @@
 #include <osgParticle/Emitter>
 #include <osgParticle/Placer>
 #include <osgParticle/Counter>
+#include <osgParticle/ModularProgram>
 
 #include <components/sceneutil/nodecallback.hpp>
 
@@ -38,11 +41,42 @@ namespace NifOsg
 
         void setQuota(int quota);
 
+        /// Stop simulating live particles while the particle system isn't drawn, they continue where they left off once
+        /// it's drawn again. A particle system without live particles is always simulated, so new particles give it a bound.
+        void setFreezeWhenInvisible(bool freeze) { mFreezeWhenInvisible = freeze; }
+
+        /// Did the last update skip the particles? Emitters and programs of the particle system don't run while it did.
+        bool isFrozenWhileInvisible() const { return mFrozenWhileInvisible; }
+
+        void update(double dt, osg::NodeVisitor& nv) override;
+
         void drawImplementation(osg::RenderInfo& renderInfo) const override;
 
     private:
+        static constexpr unsigned int sNeverDrawn = ~0u;
+
         int mQuota;
         osg::ref_ptr<osg::Vec3Array> mNormalArray;
+        bool mFreezeWhenInvisible = false;
+        bool mFrozenWhileInvisible = false;
+        mutable std::atomic<unsigned int> mLastDrawnFrame {sNeverDrawn};
+    };
+
+    // Runs all operators on each particle in one pass over the particles, instead of one pass per operator.
+    // Operators only see live particles, an operator overriding operateParticles is not supported.
+    class ParticleProgram : public osgParticle::ModularProgram
+    {
+    public:
+        ParticleProgram() = default;
+        ParticleProgram(const ParticleProgram& copy, const osg::CopyOp& copyop);
+
+        META_Object(NifOsg, ParticleProgram)
+
+    protected:
+        void execute(double dt) override;
+
+    private:
+        std::vector<osgParticle::Operator*> mEnabledOperators;
     };
 
     // HACK: Particle doesn't allow setting the initial age, but we need this for loading the particle system state
@@ -242,6 +276,9 @@ namespace NifOsg
         void setUseGeometryEmitter(bool useGeometryEmitter) { mUseGeometryEmitter = useGeometryEmitter; }
         void setGeometryEmitterTarget(std::optional<int> recIndex) { mGeometryEmitterTarget = recIndex; }
 
+        /// Don't emit on the next update, its time step spans the time the emitter was detached from the scene.
+        void skipNextEmission() { mSkipNextEmission = true; }
+
     private:
         // NIF Record indices
         std::vector<int> mTargets;
@@ -253,6 +290,8 @@ namespace NifOsg
         bool mUseGeometryEmitter;
         std::optional<int> mGeometryEmitterTarget;
         osg::observer_ptr<osg::Vec3Array> mCachedGeometryEmitter;
+
+        bool mSkipNextEmission;
     };
 
 }
@@ -10,6 +10,7 @@
 #include <osg/Vec3f>
 
 #include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
 
 class btCollisionShape;
 
@@ -85,11 +86,27 @@ namespace Resource
         {
         }
 
+        /// Use a BVH deserialized in place. The shape takes ownership of the buffer, which must be allocated with
+        /// btAlignedAlloc.
+        void setSerializedBvh(btOptimizedBvh* bvh, void* buffer)
+        {
+            setOptimizedBvh(bvh);
+            mBvhBuffer = buffer;
+        }
+
         virtual ~TriangleMeshShape()
         {
             delete getTriangleInfoMap();
             delete m_meshInterface;
+            if (mBvhBuffer != nullptr)
+            {
+                getOptimizedBvh()->~btOptimizedBvh();
+                btAlignedFree(mBvhBuffer);
+            }
         }
+
+    private:
+        void* mBvhBuffer = nullptr;
     };
 
 
@@ -1,6 +1,11 @@
 #include "bulletshapemanager.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 #include <osg/NodeVisitor>
 #include <osg/TriangleFunctor>
@@ -9,6 +14,9 @@
 
 #include <BulletCollision/CollisionShapes/btTriangleMesh.h>
 
+#include <components/debug/debuglog.hpp>
+#include <components/files/hash.hpp>
+#include <components/misc/hash.hpp>
 #include <components/misc/pathhelpers.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/vfs/manager.hpp>
@@ -17,6 +25,7 @@
 #include <components/nifbullet/bulletnifloader.hpp>
 
 #include "bulletshape.hpp"
+#include "bulletshapeserialization.hpp"
 #include "scenemanager.hpp"
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
@@ -119,6 +128,152 @@ BulletShapeManager::~BulletShapeManager()
 
 }
 
+namespace
+{
+    // Change when the loaders produce different shapes for the same files
+    constexpr int sShapeCacheVersion = 1;
+
+    osg::ref_ptr<BulletShape> readCachedShape(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+            return nullptr;
+        std::vector<std::byte> data(static_cast<std::size_t>(stream.tellg()));
+        stream.seekg(0);
+        stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!stream)
+            return nullptr;
+        try
+        {
+            return deserializeBulletShape(data.data(), data.size());
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Warning: Ignoring invalid collision shape cache " << path << ": " << e.what();
+            return nullptr;
+        }
+    }
+
+    void writeCachedShape(const std::string& path, const BulletShape& shape)
+    {
+        const std::vector<std::byte> data = serializeBulletShape(shape);
+        if (data.empty())
+            return;
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream stream(tempPath, std::ios::binary);
+            stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write collision shape cache " << path;
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to write collision shape cache " << path << ": " << error.message();
+    }
+}
+
+void BulletShapeManager::setShapeCachePath(const std::string& path)
+{
+    mShapeCachePath.clear();
+    if (path.empty())
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error)
+    {
+        Log(Debug::Warning) << "Warning: Unable to create collision shape cache directory " << path << ": " << error.message();
+        return;
+    }
+    mShapeCachePath = path;
+}
+
+void BulletShapeManager::setCollisionSimplification(float maxError, int minTriangles)
+{
+    mSimplificationMaxError = std::max(maxError, 0.f);
+    mSimplificationMinTriangles = std::max(minTriangles, 0);
+}
+
+std::string BulletShapeManager::getShapeCacheFile(const std::string& normalized) const
+{
+    std::size_t hash = 0;
+    Misc::hashCombine(hash, sShapeCacheVersion);
+    Misc::hashCombine(hash, BT_BULLET_VERSION);
+    Misc::hashCombine(hash, sizeof(btScalar));
+    Misc::hashCombine(hash, normalized);
+    if (mSimplificationMaxError > 0)
+    {
+        Misc::hashCombine(hash, mSimplificationMaxError);
+        Misc::hashCombine(hash, mSimplificationMinTriangles);
+    }
+    try
+    {
+        // Hash the content rather than a time stamp as archives don't provide them
+        const std::array<std::uint64_t, 2> fileHash = Files::getHash(normalized, *mVFS->get(normalized));
+        Misc::hashCombine(hash, fileHash[0]);
+        Misc::hashCombine(hash, fileHash[1]);
+    }
+    catch (const std::exception&)
+    {
+        // loading reports the error
+        return {};
+    }
+
+    std::ostringstream stream;
+    stream << mShapeCachePath << "/" << std::hex << std::setfill('0') << std::setw(16) << hash << ".shape";
+    return stream.str();
+}
+
+osg::ref_ptr<BulletShape> BulletShapeManager::loadShape(const std::string& normalized)
+{
+    if (Misc::getFileExtension(normalized) == "nif")
+    {
+        NifBullet::BulletNifLoader loader;
+        loader.setCollisionSimplification(mSimplificationMaxError, mSimplificationMinTriangles);
+        return loader.load(*mNifFileManager->get(normalized));
+    }
+
+    // TODO: support .bullet shape files
+
+    osg::ref_ptr<const osg::Node> constNode (mSceneManager->getTemplate(normalized));
+    osg::ref_ptr<osg::Node> node (const_cast<osg::Node*>(constNode.get())); // const-trickery required because there is no const version of NodeVisitor
+
+    osg::ref_ptr<BulletShape> shape;
+
+    // Check first if there's a custom collision node
+    unsigned int visitAllNodesMask = 0xffffffff;
+    SceneUtil::FindByNameVisitor nameFinder("Collision");
+    nameFinder.setTraversalMask(visitAllNodesMask);
+    nameFinder.setNodeMaskOverride(visitAllNodesMask);
+    node->accept(nameFinder);
+    if (nameFinder.mFoundNode)
+    {
+        NodeToShapeVisitor visitor;
+        visitor.setTraversalMask(visitAllNodesMask);
+        visitor.setNodeMaskOverride(visitAllNodesMask);
+        nameFinder.mFoundNode->accept(visitor);
+        shape = visitor.getShape();
+    }
+
+    // Generate a collision shape from the mesh
+    if (!shape)
+    {
+        NodeToShapeVisitor visitor;
+        node->accept(visitor);
+        shape = visitor.getShape();
+        if (!shape)
+            return osg::ref_ptr<BulletShape>();
+    }
+
+    shape->mFileName = normalized;
+    constNode->getUserValue(Misc::OsgUserValues::sFileHash, shape->mFileHash);
+    return shape;
+}
+
 osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &name)
 {
     const std::string normalized = mVFS->normalizeFilename(name);
@@ -129,48 +284,20 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
         shape = osg::ref_ptr<BulletShape>(static_cast<BulletShape*>(obj.get()));
     else
     {
-        if (Misc::getFileExtension(normalized) == "nif")
-        {
-            NifBullet::BulletNifLoader loader;
-            shape = loader.load(*mNifFileManager->get(normalized));
-        }
-        else
-        {
-            // TODO: support .bullet shape files
-
-            osg::ref_ptr<const osg::Node> constNode (mSceneManager->getTemplate(normalized));
-            osg::ref_ptr<osg::Node> node (const_cast<osg::Node*>(constNode.get())); // const-trickery required because there is no const version of NodeVisitor
-
-            // Check first if there's a custom collision node
-            unsigned int visitAllNodesMask = 0xffffffff;
-            SceneUtil::FindByNameVisitor nameFinder("Collision");
-            nameFinder.setTraversalMask(visitAllNodesMask);
-            nameFinder.setNodeMaskOverride(visitAllNodesMask);
-            node->accept(nameFinder);
-            if (nameFinder.mFoundNode)
-            {
-                NodeToShapeVisitor visitor;
-                visitor.setTraversalMask(visitAllNodesMask);
-                visitor.setNodeMaskOverride(visitAllNodesMask);
-                nameFinder.mFoundNode->accept(visitor);
-                shape = visitor.getShape();
-            }
+        std::string cacheFile;
+        if (!mShapeCachePath.empty())
+            cacheFile = getShapeCacheFile(normalized);
 
-            // Generate a collision shape from the mesh
-            if (!shape)
-            {
-                NodeToShapeVisitor visitor;
-                node->accept(visitor);
-                shape = visitor.getShape();
-                if (!shape)
-                    return osg::ref_ptr<BulletShape>();
-            }
+        if (!cacheFile.empty())
+            shape = readCachedShape(cacheFile);
 
-            if (shape != nullptr)
-            {
-                shape->mFileName = normalized;
-                constNode->getUserValue(Misc::OsgUserValues::sFileHash, shape->mFileHash);
-            }
+        if (!shape)
+        {
+            shape = loadShape(normalized);
+            if (!shape)
+                return osg::ref_ptr<BulletShape>();
+            if (!cacheFile.empty())
+                writeCachedShape(cacheFile, *shape);
         }
 
         mCache->addEntryToObjectCache(normalized, shape);
@@ -44,14 +44,30 @@ namespace Resource
 
         void clearCache() override;
 
+        /// Store the shapes loaded from files in the given directory, to not rebuild their BVHs on next load.
+        /// @note Not thread safe, should be called before loading any shapes.
+        void setShapeCachePath(const std::string& path);
+
+        /// Simplify the collision generated from the rendered geometry of NIF files, see
+        /// NifBullet::BulletNifLoader::setCollisionSimplification.
+        /// @note Not thread safe, should be called before loading any shapes.
+        void setCollisionSimplification(float maxError, int minTriangles);
+
         void reportStats(unsigned int frameNumber, osg::Stats *stats) const override;
 
     private:
         osg::ref_ptr<BulletShapeInstance> createInstance(const std::string& name);
 
+        osg::ref_ptr<BulletShape> loadShape(const std::string& normalized);
+
+        std::string getShapeCacheFile(const std::string& normalized) const;
+
         osg::ref_ptr<MultiObjectCache> mInstanceCache;
         SceneManager* mSceneManager;
         NifFileManager* mNifFileManager;
+        std::string mShapeCachePath;
+        float mSimplificationMaxError = 0;
+        int mSimplificationMinTriangles = 0;
     };
 
 }
@@ -0,0 +1,389 @@
+#include "bulletshapeserialization.hpp"
+
+#include "bulletshape.hpp"
+
+#include <components/serialization/binaryreader.hpp>
+#include <components/serialization/binarywriter.hpp>
+#include <components/serialization/format.hpp>
+#include <components/serialization/sizeaccumulator.hpp>
+
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Resource
+{
+namespace
+{
+    constexpr char bulletShapeMagic[] = {'B', 'S', 'H', 'P'};
+    constexpr std::uint32_t bulletShapeVersion = 1;
+
+    enum class ShapeType : std::uint8_t
+    {
+        Compound,
+        Box,
+        TriangleMesh,
+    };
+
+    struct AlignedFree
+    {
+        void operator()(void* ptr) const { btAlignedFree(ptr); }
+    };
+
+    using AlignedBuffer = std::unique_ptr<void, AlignedFree>;
+
+    // Collision shapes are stored in pre-order, compound shapes are followed by their children
+    struct ShapeData
+    {
+        ShapeType mType = ShapeType::Box;
+        std::uint32_t mNumChildren = 0;
+        // Transform in the parent compound shape: basis rows, then origin
+        btScalar mTransform[12] = {};
+        // Half extents with margin, then margin
+        btScalar mBox[4] = {};
+        std::uint8_t mUse32BitIndices = 0;
+        std::uint8_t mUse4ComponentVertices = 0;
+        std::uint8_t mUseQuantizedAabbCompression = 0;
+        std::vector<btScalar> mVertices;
+        std::vector<std::uint32_t> mIndices;
+        // btOptimizedBvh serialized in place
+        std::vector<std::byte> mBvh;
+    };
+
+    struct BulletShapeData
+    {
+        std::vector<ShapeData> mCollisionShape;
+        std::vector<ShapeData> mAvoidCollisionShape;
+        osg::Vec3f mCollisionBoxExtents;
+        osg::Vec3f mCollisionBoxCenter;
+        // Pairs of record index and child shape index
+        std::vector<std::int32_t> mAnimatedShapes;
+        std::vector<char> mFileName;
+        std::vector<char> mFileHash;
+    };
+
+    template <Serialization::Mode mode>
+    struct Format : Serialization::Format<mode, Format<mode>>
+    {
+        using Serialization::Format<mode, Format<mode>>::operator();
+
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, ShapeData>>
+        {
+            visitor(*this, value.mType);
+            visitor(*this, value.mNumChildren);
+            visitor(*this, value.mTransform);
+            visitor(*this, value.mBox);
+            visitor(*this, value.mUse32BitIndices);
+            visitor(*this, value.mUse4ComponentVertices);
+            visitor(*this, value.mUseQuantizedAabbCompression);
+            visitor(*this, value.mVertices);
+            visitor(*this, value.mIndices);
+            visitor(*this, value.mBvh);
+        }
+
+        template <class Visitor, class T>
+        auto operator()(Visitor&& visitor, T& value) const
+            -> std::enable_if_t<std::is_same_v<std::decay_t<T>, BulletShapeData>>
+        {
+            // The serialized BVH depends on the Bullet build
+            const std::uint8_t scalarSize = sizeof(btScalar);
+            if constexpr (mode == Serialization::Mode::Write)
+            {
+                visitor(*this, bulletShapeMagic);
+                visitor(*this, bulletShapeVersion);
+                visitor(*this, scalarSize);
+            }
+            else
+            {
+                static_assert(mode == Serialization::Mode::Read);
+                char magic[std::size(bulletShapeMagic)];
+                visitor(*this, magic);
+                if (std::memcmp(magic, bulletShapeMagic, sizeof(magic)) != 0)
+                    throw std::runtime_error("Bad BulletShape magic");
+                std::uint32_t version = 0;
+                visitor(*this, version);
+                if (version != bulletShapeVersion)
+                    throw std::runtime_error("Bad BulletShape version");
+                std::uint8_t readScalarSize = 0;
+                visitor(*this, readScalarSize);
+                if (readScalarSize != scalarSize)
+                    throw std::runtime_error("Bad BulletShape scalar size");
+            }
+            visitor(*this, value.mCollisionShape);
+            visitor(*this, value.mAvoidCollisionShape);
+            visitor(*this, value.mCollisionBoxExtents.ptr(), 3);
+            visitor(*this, value.mCollisionBoxCenter.ptr(), 3);
+            visitor(*this, value.mAnimatedShapes);
+            visitor(*this, value.mFileName);
+            visitor(*this, value.mFileHash);
+        }
+    };
+
+    void writeTransform(const btTransform& transform, btScalar (&result)[12])
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                result[i * 3 + j] = transform.getBasis()[i][j];
+        for (int i = 0; i < 3; ++i)
+            result[9 + i] = transform.getOrigin()[i];
+    }
+
+    btTransform readTransform(const btScalar (&value)[12])
+    {
+        const btMatrix3x3 basis(value[0], value[1], value[2],
+                                value[3], value[4], value[5],
+                                value[6], value[7], value[8]);
+        return btTransform(basis, btVector3(value[9], value[10], value[11]));
+    }
+
+    bool writeTriangleMesh(const btTriangleMesh& mesh, ShapeData& result)
+    {
+        const unsigned char* vertexBase = nullptr;
+        int numVertices = 0;
+        PHY_ScalarType vertexType = PHY_FLOAT;
+        int vertexStride = 0;
+        const unsigned char* indexBase = nullptr;
+        int indexStride = 0;
+        int numFaces = 0;
+        PHY_ScalarType indexType = PHY_INTEGER;
+        mesh.getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType, vertexStride,
+                                              &indexBase, indexStride, numFaces, indexType, 0);
+
+        const bool supported = vertexType == (std::is_same_v<btScalar, float> ? PHY_FLOAT : PHY_DOUBLE)
+            && (indexType == PHY_SHORT || indexType == PHY_INTEGER);
+        if (supported)
+        {
+            result.mVertices.reserve(static_cast<std::size_t>(numVertices) * 3);
+            for (int i = 0; i < numVertices; ++i)
+            {
+                const btScalar* vertex = reinterpret_cast<const btScalar*>(vertexBase + i * vertexStride);
+                result.mVertices.insert(result.mVertices.end(), vertex, vertex + 3);
+            }
+
+            result.mIndices.reserve(static_cast<std::size_t>(numFaces) * 3);
+            for (int i = 0; i < numFaces; ++i)
+            {
+                const unsigned char* face = indexBase + i * indexStride;
+                if (indexType == PHY_SHORT)
+                {
+                    const unsigned short* indices = reinterpret_cast<const unsigned short*>(face);
+                    result.mIndices.insert(result.mIndices.end(), indices, indices + 3);
+                }
+                else
+                {
+                    const unsigned int* indices = reinterpret_cast<const unsigned int*>(face);
+                    result.mIndices.insert(result.mIndices.end(), indices, indices + 3);
+                }
+            }
+        }
+
+        mesh.unLockReadOnlyVertexBase(0);
+        return supported;
+    }
+
+    bool writeBvh(const btOptimizedBvh& bvh, std::vector<std::byte>& result)
+    {
+        const unsigned size = bvh.calculateSerializeBufferSize();
+        // Bullet requires a 16 byte aligned buffer
+        AlignedBuffer buffer(btAlignedAlloc(size, 16));
+        if (buffer == nullptr || !bvh.serializeInPlace(buffer.get(), size, false))
+            return false;
+        const std::byte* const data = static_cast<const std::byte*>(buffer.get());
+        result.assign(data, data + size);
+        return true;
+    }
+
+    bool writeShape(const btCollisionShape& shape, const btTransform& transform, std::vector<ShapeData>& result)
+    {
+        // Shapes of templates are never scaled, only their instances are
+        if (shape.getLocalScaling() != btVector3(1, 1, 1))
+            return false;
+
+        ShapeData& data = result.emplace_back();
+        writeTransform(transform, data.mTransform);
+
+        if (shape.isCompound())
+        {
+            const btCompoundShape& compound = static_cast<const btCompoundShape&>(shape);
+            data.mType = ShapeType::Compound;
+            data.mNumChildren = static_cast<std::uint32_t>(compound.getNumChildShapes());
+            // data is invalidated by adding the children
+            for (int i = 0, n = compound.getNumChildShapes(); i < n; ++i)
+                if (!writeShape(*compound.getChildShape(i), compound.getChildTransform(i), result))
+                    return false;
+            return true;
+        }
+
+        if (shape.getShapeType() == BOX_SHAPE_PROXYTYPE)
+        {
+            const btBoxShape& box = static_cast<const btBoxShape&>(shape);
+            const btVector3 halfExtents = box.getHalfExtentsWithMargin();
+            data.mType = ShapeType::Box;
+            data.mBox[0] = halfExtents.x();
+            data.mBox[1] = halfExtents.y();
+            data.mBox[2] = halfExtents.z();
+            data.mBox[3] = box.getMargin();
+            return true;
+        }
+
+        if (shape.getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        {
+            const TriangleMeshShape* meshShape = dynamic_cast<const TriangleMeshShape*>(&shape);
+            if (meshShape == nullptr || meshShape->getTriangleInfoMap() != nullptr)
+                return false;
+            const btTriangleMesh* mesh = dynamic_cast<const btTriangleMesh*>(meshShape->getMeshInterface());
+            if (mesh == nullptr || mesh->getNumSubParts() != 1)
+                return false;
+            const btOptimizedBvh* bvh = const_cast<TriangleMeshShape*>(meshShape)->getOptimizedBvh();
+            if (bvh == nullptr)
+                return false;
+            data.mType = ShapeType::TriangleMesh;
+            data.mUse32BitIndices = mesh->getUse32bitIndices();
+            data.mUse4ComponentVertices = mesh->getUse4componentVertices();
+            data.mUseQuantizedAabbCompression = meshShape->usesQuantizedAabbCompression();
+            return writeTriangleMesh(*mesh, data) && writeBvh(*bvh, data.mBvh);
+        }
+
+        return false;
+    }
+
+    CollisionShapePtr readTriangleMesh(const ShapeData& data)
+    {
+        if (data.mVertices.size() % 3 != 0 || data.mIndices.size() % 3 != 0)
+            throw std::runtime_error("Bad BulletShape triangle mesh size");
+        const std::size_t numVertices = data.mVertices.size() / 3;
+        for (const std::uint32_t index : data.mIndices)
+            if (index >= numVertices)
+                throw std::runtime_error("Bad BulletShape triangle mesh index");
+
+        auto mesh = std::make_unique<btTriangleMesh>(data.mUse32BitIndices != 0, data.mUse4ComponentVertices != 0);
+        mesh->preallocateVertices(static_cast<int>(numVertices));
+        mesh->preallocateIndices(static_cast<int>(data.mIndices.size()));
+        for (std::size_t i = 0; i < data.mVertices.size(); i += 3)
+            mesh->findOrAddVertex(btVector3(data.mVertices[i], data.mVertices[i + 1], data.mVertices[i + 2]), false);
+        for (std::size_t i = 0; i < data.mIndices.size(); i += 3)
+            mesh->addTriangleIndices(data.mIndices[i], data.mIndices[i + 1], data.mIndices[i + 2]);
+
+        AlignedBuffer buffer(btAlignedAlloc(data.mBvh.size(), 16));
+        if (buffer == nullptr)
+            throw std::runtime_error("Failed to allocate BulletShape BVH");
+        std::memcpy(buffer.get(), data.mBvh.data(), data.mBvh.size());
+        btOptimizedBvh* const bvh = btOptimizedBvh::deSerializeInPlace(buffer.get(),
+            static_cast<unsigned>(data.mBvh.size()), false);
+        const bool useQuantizedAabbCompression = data.mUseQuantizedAabbCompression != 0;
+        if (bvh == nullptr || bvh->isQuantized() != useQuantizedAabbCompression)
+            throw std::runtime_error("Bad BulletShape BVH");
+
+        auto shape = std::make_unique<TriangleMeshShape>(mesh.get(), useQuantizedAabbCompression, false);
+        mesh.release();
+        shape->setSerializedBvh(bvh, buffer.release());
+        return CollisionShapePtr(shape.release());
+    }
+
+    CollisionShapePtr readShape(const std::vector<ShapeData>& shapes, std::size_t& index, btTransform& transform)
+    {
+        if (index >= shapes.size())
+            throw std::runtime_error("Bad BulletShape child count");
+        const ShapeData& data = shapes[index++];
+        transform = readTransform(data.mTransform);
+
+        switch (data.mType)
+        {
+            case ShapeType::Compound:
+            {
+                std::unique_ptr<btCompoundShape, DeleteCollisionShape> compound(new btCompoundShape);
+                for (std::uint32_t i = 0; i < data.mNumChildren; ++i)
+                {
+                    btTransform childTransform;
+                    CollisionShapePtr child = readShape(shapes, index, childTransform);
+                    compound->addChildShape(childTransform, child.get());
+                    child.release();
+                }
+                return compound;
+            }
+            case ShapeType::Box:
+            {
+                std::unique_ptr<btBoxShape, DeleteCollisionShape> box(
+                    new btBoxShape(btVector3(data.mBox[0], data.mBox[1], data.mBox[2])));
+                box->setMargin(data.mBox[3]);
+                return box;
+            }
+            case ShapeType::TriangleMesh:
+                return readTriangleMesh(data);
+        }
+
+        throw std::runtime_error("Bad BulletShape shape type");
+    }
+
+    CollisionShapePtr readShape(const std::vector<ShapeData>& shapes)
+    {
+        if (shapes.empty())
+            return nullptr;
+        std::size_t index = 0;
+        btTransform transform;
+        CollisionShapePtr result = readShape(shapes, index, transform);
+        if (index != shapes.size())
+            throw std::runtime_error("Bad BulletShape shape count");
+        return result;
+    }
+}
+
+    std::vector<std::byte> serializeBulletShape(const BulletShape& shape)
+    {
+        BulletShapeData data;
+        if (shape.mCollisionShape != nullptr
+                && !writeShape(*shape.mCollisionShape, btTransform::getIdentity(), data.mCollisionShape))
+            return {};
+        if (shape.mAvoidCollisionShape != nullptr
+                && !writeShape(*shape.mAvoidCollisionShape, btTransform::getIdentity(), data.mAvoidCollisionShape))
+            return {};
+        data.mCollisionBoxExtents = shape.mCollisionBox.mExtents;
+        data.mCollisionBoxCenter = shape.mCollisionBox.mCenter;
+        for (const auto& [recordIndex, shapeIndex] : shape.mAnimatedShapes)
+        {
+            data.mAnimatedShapes.push_back(recordIndex);
+            data.mAnimatedShapes.push_back(shapeIndex);
+        }
+        data.mFileName.assign(shape.mFileName.begin(), shape.mFileName.end());
+        data.mFileHash.assign(shape.mFileHash.begin(), shape.mFileHash.end());
+
+        constexpr Format<Serialization::Mode::Write> format;
+        Serialization::SizeAccumulator sizeAccumulator;
+        format(sizeAccumulator, data);
+        std::vector<std::byte> result(sizeAccumulator.value());
+        format(Serialization::BinaryWriter(result.data(), result.data() + result.size()), data);
+        return result;
+    }
+
+    osg::ref_ptr<BulletShape> deserializeBulletShape(const std::byte* data, std::size_t size)
+    {
+        BulletShapeData value;
+        constexpr Format<Serialization::Mode::Read> format;
+        format(Serialization::BinaryReader(data, data + size), value);
+
+        if (value.mAnimatedShapes.size() % 2 != 0)
+            throw std::runtime_error("Bad BulletShape animated shapes size");
+
+        osg::ref_ptr<BulletShape> shape(new BulletShape);
+        shape->mCollisionShape = readShape(value.mCollisionShape);
+        shape->mAvoidCollisionShape = readShape(value.mAvoidCollisionShape);
+        shape->mCollisionBox.mExtents = value.mCollisionBoxExtents;
+        shape->mCollisionBox.mCenter = value.mCollisionBoxCenter;
+        for (std::size_t i = 0; i < value.mAnimatedShapes.size(); i += 2)
+            shape->mAnimatedShapes.emplace(value.mAnimatedShapes[i], value.mAnimatedShapes[i + 1]);
+        shape->mFileName.assign(value.mFileName.begin(), value.mFileName.end());
+        shape->mFileHash.assign(value.mFileHash.begin(), value.mFileHash.end());
+        return shape;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_BULLETSHAPESERIALIZATION_H
+#define OPENMW_COMPONENTS_RESOURCE_BULLETSHAPESERIALIZATION_H
+
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <vector>
+
+namespace Resource
+{
+    class BulletShape;
+
+    /// Serialize the collision shapes along with their BVHs, so loading them again doesn't need to rebuild the trees.
+    /// The result is only valid for the same Bullet build.
+    /// @return Empty buffer if the shape contains collision shapes which can't be serialized.
+    std::vector<std::byte> serializeBulletShape(const BulletShape& shape);
+
+    /// @throw std::runtime_error if the data is invalid
+    osg::ref_ptr<BulletShape> deserializeBulletShape(const std::byte* data, std::size_t size);
+}
+
+#endif
@@ -1,10 +1,22 @@
 #include "imagemanager.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string_view>
+
+#include <osg/Drawable>
 #include <osgDB/Registry>
 
 #include <components/debug/debuglog.hpp>
+#include <components/misc/endianness.hpp>
+#include <components/misc/hash.hpp>
 #include <components/misc/pathhelpers.hpp>
+#include <components/misc/stringops.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/vfs/manager.hpp>
 
 #include "objectcache.hpp"
@@ -40,6 +52,29 @@ namespace
         return warningImage;
     }
 
+    std::uint64_t hashImage(const osg::Image& image)
+    {
+        std::uint64_t hash = std::hash<std::string_view>()(std::string_view(
+            reinterpret_cast<const char*>(image.data()), image.getTotalSizeInBytesIncludingMipmaps()));
+        Misc::hashCombine(hash, image.s());
+        Misc::hashCombine(hash, image.t());
+        Misc::hashCombine(hash, image.r());
+        Misc::hashCombine(hash, image.getPixelFormat());
+        return hash;
+    }
+
+    bool isSameImage(const osg::Image& first, const osg::Image& second)
+    {
+        const std::size_t size = first.getTotalSizeInBytesIncludingMipmaps();
+        return first.s() == second.s() && first.t() == second.t() && first.r() == second.r()
+            && first.getPixelFormat() == second.getPixelFormat() && first.getDataType() == second.getDataType()
+            && first.getInternalTextureFormat() == second.getInternalTextureFormat()
+            && first.getPacking() == second.getPacking() && first.getOrigin() == second.getOrigin()
+            && first.getMipmapLevels() == second.getMipmapLevels()
+            && size == second.getTotalSizeInBytesIncludingMipmaps()
+            && std::memcmp(first.data(), second.data(), size) == 0;
+    }
+
 }
 
 namespace Resource
@@ -49,12 +84,25 @@ namespace Resource
         : ResourceManager(vfs)
         , mWarningImage(createWarningImage())
         , mOptions(new osgDB::Options("dds_flip dds_dxt1_detect_rgba ignoreTga2Fields"))
+        , mSwapper(new ImageSwapper)
+        , mStreamingBaseSize(0)
+        , mStreamingBudget(0)
+        , mStreamedSize(0)
+        , mNumStreamed(0)
+        , mDeduplicate(false)
+        , mNumDuplicates(0)
+        , mDuplicateSize(0)
     {
     }
 
     ImageManager::~ImageManager()
     {
-
+        if (mDeduplicate)
+        {
+            std::ostringstream report;
+            writeDuplicatesReport(report, 20);
+            Log(Debug::Info) << report.str();
+        }
     }
 
     bool checkSupported(osg::Image* image, const std::string& filename)
@@ -82,25 +130,21 @@ namespace Resource
         return true;
     }
 
-    osg::ref_ptr<osg::Image> ImageManager::getImage(const std::string &filename)
+    namespace
     {
-        const std::string normalized = mVFS->normalizeFilename(filename);
-
-        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
-        if (obj)
-            return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
-        else
+        /// @return nullptr if the image can't be loaded
+        osg::ref_ptr<osg::Image> readImage(const VFS::Manager& vfs, const osgDB::Options* options,
+                                           const std::string& normalized, const std::string& filename)
         {
             Files::IStreamPtr stream;
             try
             {
-                stream = mVFS->get(normalized);
+                stream = vfs.get(normalized);
             }
             catch (std::exception& e)
             {
                 Log(Debug::Error) << "Failed to open image: " << e.what();
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
+                return nullptr;
             }
 
             const std::string ext(Misc::getFileExtension(normalized));
@@ -108,8 +152,7 @@ namespace Resource
             if (!reader)
             {
                 Log(Debug::Error) << "Error loading " << filename << ": no readerwriter for '" << ext << "' found";
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
+                return nullptr;
             }
 
             bool killAlpha = false;
@@ -121,8 +164,7 @@ namespace Resource
                 if (stream->gcount() != 18)
                 {
                     Log(Debug::Error) << "Error loading " << filename << ": couldn't read TGA header";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
+                    return nullptr;
                 }
                 int type = header[2];
                 int depth;
@@ -135,12 +177,11 @@ namespace Resource
                 stream->seekg(0);
             }
 
-            osgDB::ReaderWriter::ReadResult result = reader->readImage(*stream, mOptions);
+            osgDB::ReaderWriter::ReadResult result = reader->readImage(*stream, options);
             if (!result.success())
             {
                 Log(Debug::Error) << "Error loading " << filename << ": " << result.message() << " code " << result.status();
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
+                return nullptr;
             }
 
             osg::ref_ptr<osg::Image> image = result.getImage();
@@ -152,8 +193,7 @@ namespace Resource
                 if (!uncompress)
                 {
                     Log(Debug::Error) << "Error loading " << filename << ": no S3TC texture compression support installed";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
+                    return nullptr;
                 }
                 else
                 {
@@ -182,9 +222,237 @@ namespace Resource
                 image = newImage;
             }
 
-            mCache->addEntryToObjectCache(normalized, image);
             return image;
         }
+
+        constexpr std::uint32_t makeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8)
+                | (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+        }
+
+        // Offsets of the DDS_HEADER fields we need, in 32 bit words after the magic number
+        constexpr std::size_t ddsHeaderWords = 31;
+        constexpr std::size_t ddsHeight = 2;
+        constexpr std::size_t ddsWidth = 3;
+        constexpr std::size_t ddsMipMapCount = 6;
+        constexpr std::size_t ddsPixelFormatFlags = 19;
+        constexpr std::size_t ddsFourCC = 20;
+        constexpr std::size_t ddsCaps2 = 27;
+        constexpr std::uint32_t ddsPixelFormatFourCC = 0x4;
+        constexpr std::uint32_t ddsCaps2CubeMapOrVolume = 0x200 | 0x200000;
+
+        /// A DXT1 block uses its transparent colour if colour 0 <= colour 1 and one of its texels has index 3
+        bool hasDXT1Alpha(const unsigned char* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i + 8 <= size; i += 8)
+            {
+                const unsigned int color0 = data[i] | (data[i + 1] << 8);
+                const unsigned int color1 = data[i + 2] | (data[i + 3] << 8);
+                if (color0 > color1)
+                    continue;
+                for (std::size_t j = 4; j < 8; ++j)
+                {
+                    const unsigned char indices = data[i + j];
+                    for (int k = 0; k < 8; k += 2)
+                        if (((indices >> k) & 3) == 3)
+                            return true;
+                }
+            }
+            return false;
+        }
+
+        /// Move the pixels and mipmaps of source into target, leaving source without data.
+        void moveImageData(osg::Image& target, osg::Image& source)
+        {
+            target.setImage(source.s(), source.t(), source.r(), source.getInternalTextureFormat(), source.getPixelFormat(),
+                            source.getDataType(), source.data(), source.getAllocationMode(), source.getPacking(),
+                            source.getRowLength());
+            target.setMipmapLevels(source.getMipmapLevels());
+            target.dirty();
+            source.setAllocationMode(osg::Image::NO_DELETE);
+        }
+    }
+
+    /// Changes the data of streamed images on the draw thread, so that it can't be touched while a texture is being uploaded.
+    class ImageSwapper : public osg::Drawable
+    {
+    public:
+        ImageSwapper()
+        {
+            setSupportsDisplayList(false);
+            setCullingActive(false);
+        }
+
+        void swap(osg::ref_ptr<osg::Image> target, osg::ref_ptr<osg::Image> source)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.emplace_back(std::move(target), std::move(source));
+        }
+
+        void drawImplementation(osg::RenderInfo& renderInfo) const override
+        {
+            std::vector<std::pair<osg::ref_ptr<osg::Image>, osg::ref_ptr<osg::Image>>> pending;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                pending.swap(mPending);
+            }
+            for (const auto& [target, source] : pending)
+                moveImageData(*target, *source);
+        }
+
+    private:
+        mutable std::vector<std::pair<osg::ref_ptr<osg::Image>, osg::ref_ptr<osg::Image>>> mPending;
+        mutable std::mutex mMutex;
+    };
+
+    class LoadImageWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        LoadImageWorkItem(const VFS::Manager& vfs, const osgDB::Options* options, const std::string& normalized)
+            : mVFS(vfs)
+            , mOptions(options)
+            , mNormalized(normalized)
+        {
+        }
+
+        void doWork() override
+        {
+            mImage = readImage(mVFS, mOptions, mNormalized, mNormalized);
+        }
+
+        osg::ref_ptr<osg::Image> mImage;
+
+    private:
+        const VFS::Manager& mVFS;
+        osg::ref_ptr<const osgDB::Options> mOptions;
+        std::string mNormalized;
+    };
+
+    osg::ref_ptr<osg::Image> ImageManager::getImage(const std::string &filename)
+    {
+        const std::string normalized = mVFS->normalizeFilename(filename);
+
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
+
+        osg::ref_ptr<osg::Image> image;
+        if (mWorkQueue)
+            image = loadBaseMipmaps(normalized);
+        if (!image)
+        {
+            image = readImage(*mVFS, mOptions, normalized, filename);
+            if (image && mDeduplicate)
+                image = deduplicate(normalized, image);
+        }
+        if (!image)
+            image = mWarningImage;
+
+        mCache->addEntryToObjectCache(normalized, image);
+        return image;
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::loadBaseMipmaps(const std::string& normalized)
+    {
+        if (Misc::getFileExtension(normalized) != "dds")
+            return nullptr;
+
+        Files::IStreamPtr stream;
+        try
+        {
+            stream = mVFS->get(normalized);
+        }
+        catch (std::exception&)
+        {
+            return nullptr; // Reported by the regular loading path
+        }
+
+        std::uint32_t magic = 0;
+        std::uint32_t header[ddsHeaderWords];
+        stream->read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        stream->read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!stream->good() || Misc::fromLittleEndian(magic) != makeFourCC('D', 'D', 'S', ' '))
+            return nullptr;
+        for (std::uint32_t& word : header)
+            word = Misc::fromLittleEndian(word);
+
+        // Only block compressed 2D textures with mipmaps are streamed, everything else is loaded as usual
+        if (!(header[ddsPixelFormatFlags] & ddsPixelFormatFourCC) || (header[ddsCaps2] & ddsCaps2CubeMapOrVolume))
+            return nullptr;
+        GLenum pixelFormat;
+        unsigned int blockSize = 16;
+        switch (header[ddsFourCC])
+        {
+            case makeFourCC('D', 'X', 'T', '1'):
+                pixelFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                blockSize = 8;
+                break;
+            case makeFourCC('D', 'X', 'T', '3'):
+                pixelFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                break;
+            case makeFourCC('D', 'X', 'T', '5'):
+                pixelFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                break;
+            default:
+                return nullptr;
+        }
+
+        const unsigned int width = header[ddsWidth];
+        const unsigned int height = header[ddsHeight];
+        const unsigned int numLevels = header[ddsMipMapCount];
+        if (numLevels <= 1 || std::max(width, height) <= mStreamingBaseSize)
+            return nullptr;
+
+        std::size_t skippedSize = 0;
+        std::size_t baseSize = 0;
+        unsigned int firstLevel = 0;
+        std::vector<unsigned int> mipmapOffsets;
+        for (unsigned int level = 0; level < numLevels; ++level)
+        {
+            const unsigned int levelWidth = std::max(width >> level, 1u);
+            const unsigned int levelHeight = std::max(height >> level, 1u);
+            const std::size_t levelSize = static_cast<std::size_t>((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * blockSize;
+            if (std::max(levelWidth, levelHeight) > mStreamingBaseSize)
+            {
+                skippedSize += levelSize;
+                firstLevel = level + 1;
+                continue;
+            }
+            if (level > firstLevel)
+                mipmapOffsets.push_back(static_cast<unsigned int>(baseSize));
+            baseSize += levelSize;
+        }
+        if (baseSize == 0)
+            return nullptr;
+
+        stream->seekg(skippedSize, std::ios::cur);
+        std::unique_ptr<unsigned char[]> data(new unsigned char[baseSize]);
+        stream->read(reinterpret_cast<char*>(data.get()), baseSize);
+        if (static_cast<std::size_t>(stream->gcount()) != baseSize)
+            return nullptr;
+
+        if (pixelFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT && hasDXT1Alpha(data.get(), baseSize))
+            pixelFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+
+        osg::ref_ptr<osg::Image> image = new osg::Image;
+        image->setFileName(normalized);
+        image->setImage(std::max(width >> firstLevel, 1u), std::max(height >> firstLevel, 1u), 1, pixelFormat, pixelFormat,
+                        GL_UNSIGNED_BYTE, data.release(), osg::Image::USE_NEW_DELETE);
+        image->setMipmapLevels(mipmapOffsets);
+        // Match the dds_flip option of the regular loading path
+        image->flipVertical();
+        if (!checkSupported(image, normalized))
+            return nullptr;
+
+        StreamedImage streamed;
+        streamed.mImage = image;
+        streamed.mBase = new osg::Image(*image, osg::CopyOp::DEEP_COPY_ALL);
+        streamed.mExtraSize = skippedSize;
+
+        std::lock_guard<std::mutex> lock(mStreamingMutex);
+        mStreamedImages.push_back(std::move(streamed));
+        return image;
     }
 
     osg::Image *ImageManager::getWarningImage()
@@ -192,9 +460,165 @@ namespace Resource
         return mWarningImage;
     }
 
+    void ImageManager::setStreaming(SceneUtil::WorkQueue* workQueue, unsigned int baseSize, std::size_t budget)
+    {
+        std::lock_guard<std::mutex> lock(mStreamingMutex);
+        mWorkQueue = workQueue;
+        mStreamingBaseSize = baseSize;
+        mStreamingBudget = budget;
+    }
+
+    osg::Drawable* ImageManager::getStreamingDrawable()
+    {
+        return mSwapper;
+    }
+
+    void ImageManager::updateCache(double referenceTime)
+    {
+        ResourceManager::updateCache(referenceTime);
+
+        updateStreaming();
+    }
+
+    void ImageManager::updateStreaming()
+    {
+        std::lock_guard<std::mutex> lock(mStreamingMutex);
+
+        mNumStreamed = 0;
+        for (auto it = mStreamedImages.begin(); it != mStreamedImages.end();)
+        {
+            osg::ref_ptr<osg::Image> image;
+            if (!it->mImage.lock(image))
+            {
+                if (it->mFull || it->mLoading)
+                    mStreamedSize -= it->mExtraSize;
+                it = mStreamedImages.erase(it);
+                continue;
+            }
+
+            // Anything beyond the reference held by the object cache means a texture or a scene still uses the image
+            const bool inUse = image->referenceCount() > 2;
+
+            if (it->mLoading && it->mLoading->isDone())
+            {
+                osg::ref_ptr<osg::Image> full = it->mLoading->mImage;
+                it->mLoading = nullptr;
+                if (full && full->s() > image->s())
+                {
+                    full->setFileName(image->getFileName());
+                    mSwapper->swap(image, full);
+                    it->mFull = true;
+                }
+                else
+                {
+                    mStreamedSize -= it->mExtraSize;
+                    it->mFailed = true;
+                }
+            }
+            else if (it->mFull && !inUse)
+            {
+                mSwapper->swap(image, new osg::Image(*it->mBase, osg::CopyOp::DEEP_COPY_ALL));
+                it->mFull = false;
+                mStreamedSize -= it->mExtraSize;
+            }
+            else if (!it->mFull && !it->mLoading && !it->mFailed && inUse
+                     && mStreamedSize + it->mExtraSize <= mStreamingBudget)
+            {
+                it->mLoading = new LoadImageWorkItem(*mVFS, mOptions, image->getFileName());
+                mWorkQueue->addWorkItem(it->mLoading);
+                mStreamedSize += it->mExtraSize;
+            }
+
+            if (it->mFull)
+                ++mNumStreamed;
+            ++it;
+        }
+    }
+
+    void ImageManager::setDeduplication(const std::vector<std::string>& companionPatterns)
+    {
+        mDeduplicate = true;
+        mCompanionPatterns = companionPatterns;
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::deduplicate(const std::string& normalized, osg::ref_ptr<osg::Image> image)
+    {
+        if (!image->isDataContiguous())
+            return image;
+        for (const std::string& pattern : mCompanionPatterns)
+        {
+            std::string companion = normalized;
+            Misc::StringUtils::replaceLast(companion, ".", pattern + ".");
+            if (mVFS->exists(companion))
+                return image;
+        }
+
+        const std::uint64_t hash = hashImage(*image);
+        const std::size_t size = image->getTotalSizeInBytesIncludingMipmaps();
+
+        std::lock_guard<std::mutex> lock(mDeduplicationMutex);
+        std::vector<ImageContent>& contents = mImageContents[hash];
+        for (ImageContent& content : contents)
+        {
+            osg::ref_ptr<osg::Image> existing;
+            if (!content.mImage.lock(existing))
+            {
+                // The image was unloaded, this one takes its place
+                if (content.mSize != size)
+                    continue;
+                content.mImage = image;
+                content.mPaths.insert(normalized);
+                return image;
+            }
+            if (!isSameImage(*existing, *image))
+                continue;
+            content.mPaths.insert(normalized);
+            ++mNumDuplicates;
+            mDuplicateSize += size;
+            return existing;
+        }
+        contents.push_back(ImageContent {image, size, {normalized}});
+        return image;
+    }
+
+    void ImageManager::writeDuplicatesReport(std::ostream& stream, std::size_t count) const
+    {
+        std::lock_guard<std::mutex> lock(mDeduplicationMutex);
+        std::vector<const ImageContent*> duplicates;
+        for (const auto& [hash, contents] : mImageContents)
+            for (const ImageContent& content : contents)
+                if (content.mPaths.size() > 1)
+                    duplicates.push_back(&content);
+        const auto wasted = [] (const ImageContent* content) { return content->mSize * (content->mPaths.size() - 1); };
+        std::sort(duplicates.begin(), duplicates.end(), [&] (const ImageContent* a, const ImageContent* b) { return wasted(a) > wasted(b); });
+        if (duplicates.size() > count)
+            duplicates.resize(count);
+
+        stream << mNumDuplicates << " duplicate image loads avoided, " << mDuplicateSize / 1024 << " KiB\n";
+        for (const ImageContent* content : duplicates)
+        {
+            stream << wasted(content) / 1024 << " KiB in " << content->mPaths.size() << " copies:";
+            for (const std::string& path : content->mPaths)
+                stream << ' ' << path;
+            stream << '\n';
+        }
+    }
+
     void ImageManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Image", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Image Memory", mCache->getMemoryUsage());
+        if (mDeduplicate)
+        {
+            std::lock_guard<std::mutex> lock(mDeduplicationMutex);
+            stats->setAttribute(frameNumber, "Image Duplicates", mNumDuplicates);
+            stats->setAttribute(frameNumber, "Image Duplicate Memory", mDuplicateSize);
+        }
+        if (mWorkQueue)
+        {
+            std::lock_guard<std::mutex> lock(mStreamingMutex);
+            stats->setAttribute(frameNumber, "Image Streamed", mNumStreamed);
+        }
     }
 
 }
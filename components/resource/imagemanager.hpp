@@ -1,10 +1,17 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <osg/ref_ptr>
+#include <osg/observer_ptr>
 #include <osg/Image>
 #include <osg/Texture2D>
 
@@ -15,8 +22,20 @@ namespace osgDB
     class Options;
 }
 
+namespace osg
+{
+    class Drawable;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Resource
 {
+    class ImageSwapper;
+    class LoadImageWorkItem;
 
     /// @brief Handles loading/caching of Images.
     /// @note May be used from any thread.
@@ -32,12 +51,71 @@ namespace Resource
 
         osg::Image* getWarningImage();
 
+        /// Load only the mipmaps up to baseSize of larger DDS textures at first, and load their full mipmap chains
+        /// on the work queue while they are in use, as long as the larger mipmaps fit into the budget (in bytes).
+        /// Images that are no longer in use are returned to their base mipmaps.
+        /// @note Images can only be changed safely between draws, so the drawable returned by getStreamingDrawable()
+        /// has to be part of the rendered scene.
+        void setStreaming(SceneUtil::WorkQueue* workQueue, unsigned int baseSize, std::size_t budget);
+
+        osg::Drawable* getStreamingDrawable();
+
+        /// Return the same image for files with identical content, so their textures and state can be shared.
+        /// Images with companion maps, e.g. normal maps found through one of the given patterns, are left alone,
+        /// because the companions are looked up by the file name of the image. Streamed images are left alone too.
+        void setDeduplication(const std::vector<std::string>& companionPatterns);
+
+        /// Write the images that were loaded from the most different files, by the memory they would have taken.
+        void writeDuplicatesReport(std::ostream& stream, std::size_t count) const;
+
+        void updateCache(double referenceTime) override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
+        osg::ref_ptr<osg::Image> loadBaseMipmaps(const std::string& normalized);
+
+        void updateStreaming();
+
+        osg::ref_ptr<osg::Image> deduplicate(const std::string& normalized, osg::ref_ptr<osg::Image> image);
+
+        struct StreamedImage
+        {
+            osg::observer_ptr<osg::Image> mImage;
+            osg::ref_ptr<osg::Image> mBase;
+            std::size_t mExtraSize;
+            osg::ref_ptr<LoadImageWorkItem> mLoading;
+            bool mFull = false;
+            bool mFailed = false;
+        };
+
         osg::ref_ptr<osg::Image> mWarningImage;
         osg::ref_ptr<osgDB::Options> mOptions;
 
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        osg::ref_ptr<ImageSwapper> mSwapper;
+        unsigned int mStreamingBaseSize;
+        std::size_t mStreamingBudget;
+        std::size_t mStreamedSize;
+        unsigned int mNumStreamed;
+        std::vector<StreamedImage> mStreamedImages;
+        mutable std::mutex mStreamingMutex;
+
+        struct ImageContent
+        {
+            osg::observer_ptr<osg::Image> mImage;
+            std::size_t mSize;
+            std::set<std::string> mPaths;
+        };
+
+        bool mDeduplicate;
+        std::vector<std::string> mCompanionPatterns;
+        // Images by a hash of their content, several for colliding hashes
+        std::unordered_map<std::uint64_t, std::vector<ImageContent>> mImageContents;
+        unsigned int mNumDuplicates;
+        std::size_t mDuplicateSize;
+        mutable std::mutex mDeduplicationMutex;
+
         ImageManager(const ImageManager&);
         void operator = (const ImageManager&);
     };
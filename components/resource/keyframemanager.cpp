@@ -12,6 +12,7 @@
 #include <components/sceneutil/osgacontroller.hpp>
 #include <components/misc/pathhelpers.hpp>
 #include <components/misc/stringops.hpp>
+#include <components/debug/debuglog.hpp>
 
 #include "animation.hpp"
 #include "objectcache.hpp"
@@ -145,7 +146,9 @@ namespace Resource
             osg::ref_ptr<SceneUtil::KeyframeHolder> loaded (new SceneUtil::KeyframeHolder);
             if (Misc::getFileExtension(normalized) == "kf")
             {
-                NifOsg::Loader::loadKf(Nif::NIFFilePtr(new Nif::NIFFile(mVFS->getNormalized(normalized), normalized)), *loaded.get());
+                const std::optional<std::string_view> view = mVFS->getView(normalized);
+                Nif::NIFFilePtr file (view ? new Nif::NIFFile(*view, normalized) : new Nif::NIFFile(mVFS->getNormalized(normalized), normalized));
+                NifOsg::Loader::loadKf(file, *loaded.get());
             }
             else
             {
@@ -157,7 +160,15 @@ namespace Resource
                     scene->accept(rav);
                 }
             }
-            mCache->addEntryToObjectCache(normalized, loaded);
+            std::size_t memoryUsage = sizeof(SceneUtil::KeyframeHolder);
+            for (const auto& [name, controller] : loaded->mKeyframeControllers)
+                memoryUsage += name.capacity() + controller->getMemoryUsage();
+            for (const auto& [time, key] : loaded->mTextKeys)
+                memoryUsage += sizeof(time) + key.capacity();
+            Log(Debug::Verbose) << "Loaded " << loaded->mKeyframeControllers.size() << " animation tracks and "
+                << loaded->mTextKeys.size() << " text keys from " << normalized << ", " << memoryUsage / 1024 << " KiB";
+
+            mCache->addEntryToObjectCache(normalized, loaded, 0.0, memoryUsage);
             return loaded;
         }
     }
@@ -165,6 +176,7 @@ namespace Resource
     void KeyframeManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Keyframe", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Keyframe Memory", mCache->getMemoryUsage());
     }
 
 
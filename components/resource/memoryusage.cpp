@@ -0,0 +1,79 @@
+#include "memoryusage.hpp"
+
+#include <unordered_set>
+
+#include <osg/Geometry>
+#include <osg/Image>
+#include <osg/NodeVisitor>
+#include <osg/Texture>
+
+namespace Resource
+{
+    namespace
+    {
+        class MemoryUsageVisitor : public osg::NodeVisitor
+        {
+        public:
+            MemoryUsageVisitor()
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            {
+            }
+
+            void apply(osg::Geometry& geometry) override
+            {
+                osg::Geometry::ArrayList arrays;
+                geometry.getArrayList(arrays);
+                for (const osg::ref_ptr<osg::Array>& array : arrays)
+                    add(array.get());
+
+                osg::Geometry::DrawElementsList elements;
+                geometry.getDrawElementsList(elements);
+                for (const osg::DrawElements* element : elements)
+                    add(element);
+            }
+
+            std::size_t mSize = 0;
+
+        private:
+            // Arrays may be shared between the geometries of a node
+            std::unordered_set<const osg::BufferData*> mVisited;
+
+            void add(const osg::BufferData* data)
+            {
+                if (data != nullptr && mVisited.insert(data).second)
+                    mSize += data->getTotalDataSize();
+            }
+        };
+
+        std::size_t getImageSize(const osg::Image* image)
+        {
+            if (image == nullptr)
+                return 0;
+            return image->getTotalSizeInBytesIncludingMipmaps();
+        }
+    }
+
+    std::size_t estimateMemoryUsage(const osg::Object& object)
+    {
+        if (const auto image = dynamic_cast<const osg::Image*>(&object))
+            return getImageSize(image);
+
+        if (const auto texture = dynamic_cast<const osg::Texture*>(&object))
+        {
+            std::size_t result = 0;
+            for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                result += getImageSize(texture->getImage(i));
+            return result;
+        }
+
+        if (const auto node = dynamic_cast<const osg::Node*>(&object))
+        {
+            MemoryUsageVisitor visitor;
+            // Visiting doesn't change the node, but osg::NodeVisitor only accepts mutable ones
+            const_cast<osg::Node*>(node)->accept(visitor);
+            return visitor.mSize;
+        }
+
+        return 0;
+    }
+}
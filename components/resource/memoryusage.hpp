@@ -0,0 +1,29 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_MEMORYUSAGE_H
+#define OPENMW_COMPONENTS_RESOURCE_MEMORYUSAGE_H
+
+#include <cstddef>
+#include <functional>
+
+namespace osg
+{
+    class Object;
+}
+
+namespace Resource
+{
+    /// Estimate the memory used by the data of a cached object in bytes, 0 if unknown.
+    /// @note Counts images and textures, and the vertex and index arrays of nodes. Images referenced by nodes are
+    /// not included, they are counted by the cache of the ImageManager.
+    std::size_t estimateMemoryUsage(const osg::Object& object);
+
+    /// A cached object without external references, which can be removed to stay within the memory budget.
+    struct EvictionCandidate
+    {
+        /// Seconds since the last use times the size, larger values are evicted first.
+        double mCost;
+        /// Remove the object if it still has no external references and return the number of bytes released.
+        std::function<std::size_t()> mEvict;
+    };
+}
+
+#endif
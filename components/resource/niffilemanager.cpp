@@ -49,7 +49,8 @@ namespace Resource
             return static_cast<NifFileHolder*>(obj.get())->mNifFile;
         else
         {
-            Nif::NIFFilePtr file (new Nif::NIFFile(mVFS->get(name), name));
+            const std::optional<std::string_view> view = mVFS->getView(name);
+            Nif::NIFFilePtr file (view ? new Nif::NIFFile(*view, name) : new Nif::NIFFile(mVFS->get(name), name));
             obj = new NifFileHolder(file);
             mCache->addEntryToObjectCache(name, obj);
             return file;
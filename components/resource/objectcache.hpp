@@ -3,6 +3,9 @@
 // - removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
 // - template allows customized KeyType.
 // - objects with uninitialized time stamp are not removed.
+// - entries keep an estimate of their memory usage for the memory budget of the ResourceSystem.
+// - objects are kept in hash maps split into shards with a shared lock each, so threads looking up different
+//   objects rarely wait for each other and walking the cache only locks one shard at a time.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -23,10 +26,21 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 #include <osg/Node>
+#include <osg/Vec2f>
 
-#include <string>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "memoryusage.hpp"
 
 namespace osg
 {
@@ -37,6 +51,43 @@ namespace osg
 
 namespace Resource {
 
+/// Hash for the keys of the object caches: strings, chunk positions and tuples or pairs of them.
+struct CacheKeyHash
+{
+    template <class T>
+    std::size_t operator()(const T& value) const
+    {
+        return std::hash<T>()(value);
+    }
+
+    std::size_t operator()(const osg::Vec2f& value) const
+    {
+        return combine(operator()(value.x()), operator()(value.y()));
+    }
+
+    template <class First, class Second>
+    std::size_t operator()(const std::pair<First, Second>& value) const
+    {
+        return combine(operator()(value.first), operator()(value.second));
+    }
+
+    template <class ... Args>
+    std::size_t operator()(const std::tuple<Args ...>& value) const
+    {
+        return std::apply([this] (const auto& ... args)
+        {
+            std::size_t seed = 0;
+            ((seed = combine(seed, operator()(args))), ...);
+            return seed;
+        }, value);
+    }
+
+    static std::size_t combine(std::size_t seed, std::size_t hash)
+    {
+        return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+};
+
 template <typename KeyType>
 class GenericObjectCache : public osg::Referenced
 {
@@ -54,13 +105,17 @@ class GenericObjectCache : public osg::Referenced
         void updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime)
         {
             // look for objects with external references and update their time stamp.
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr=_objectCache.begin(); itr!=_objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                // If ref count is greater than 1, the object has an external reference.
-                // If the timestamp is yet to be initialized, it needs to be updated too.
-                if (itr->second.first->referenceCount()>1 || itr->second.second == 0.0)
-                    itr->second.second = referenceTime;
+                // time stamps are atomic, so looking at the objects is enough
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                for (auto& [key, entry] : shard.mObjects)
+                {
+                    // If ref count is greater than 1, the object has an external reference.
+                    // If the timestamp is yet to be initialized, it needs to be updated too.
+                    if (entry.mObject->referenceCount()>1 || entry.mTimeStamp.load(std::memory_order_relaxed) == 0.0)
+                        entry.mTimeStamp.store(referenceTime, std::memory_order_relaxed);
+                }
             }
         }
 
@@ -71,16 +126,18 @@ class GenericObjectCache : public osg::Referenced
         void removeExpiredObjectsInCache(double expiryTime)
         {
             std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+            for (Shard& shard : _shards)
             {
-                std::lock_guard<std::mutex> lock(_objectCacheMutex);
+                std::lock_guard<std::shared_mutex> lock(shard.mMutex);
                 // Remove expired entries from object cache
-                typename ObjectCacheMap::iterator oitr = _objectCache.begin();
-                while(oitr != _objectCache.end())
+                auto oitr = shard.mObjects.begin();
+                while(oitr != shard.mObjects.end())
                 {
-                    if (oitr->second.second<=expiryTime)
+                    if (oitr->second.mTimeStamp.load(std::memory_order_relaxed)<=expiryTime)
                     {
-                        objectsToRemove.push_back(oitr->second.first);
-                        _objectCache.erase(oitr++);
+                        objectsToRemove.push_back(std::move(oitr->second.mObject));
+                        _memoryUsage -= oitr->second.mMemoryUsage;
+                        oitr = shard.mObjects.erase(oitr);
                     }
                     else
                         ++oitr;
@@ -93,43 +150,69 @@ class GenericObjectCache : public osg::Referenced
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear()
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache.clear();
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::shared_mutex> lock(shard.mMutex);
+                for (const auto& [key, entry] : shard.mObjects)
+                    _memoryUsage -= entry.mMemoryUsage;
+                shard.mObjects.clear();
+            }
         }
 
         /** Add a key,object,timestamp triple to the Registry::ObjectCache.*/
         void addEntryToObjectCache(const KeyType& key, osg::Object* object, double timestamp = 0.0)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache[key]=ObjectTimeStampPair(object,timestamp);
+            addEntryToObjectCache(key, object, timestamp, object != nullptr ? estimateMemoryUsage(*object) : 0);
+        }
+
+        /** Add an object whose memory usage is known to the caller, which estimateMemoryUsage can't tell.*/
+        void addEntryToObjectCache(const KeyType& key, osg::Object* object, double timestamp, std::size_t memoryUsage)
+        {
+            osg::ref_ptr<osg::Object> replaced;
+            Shard& shard = getShard(key);
+            std::lock_guard<std::shared_mutex> lock(shard.mMutex);
+            CacheEntry& entry = shard.mObjects[key];
+            _memoryUsage += memoryUsage - entry.mMemoryUsage;
+            replaced = std::exchange(entry.mObject, object);
+            entry.mTimeStamp.store(timestamp, std::memory_order_relaxed);
+            entry.mMemoryUsage = memoryUsage;
         }
 
         /** Remove Object from cache.*/
         void removeFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end()) _objectCache.erase(itr);
+            osg::ref_ptr<osg::Object> object;
+            Shard& shard = getShard(key);
+            std::lock_guard<std::shared_mutex> lock(shard.mMutex);
+            const auto itr = shard.mObjects.find(key);
+            if (itr!=shard.mObjects.end())
+            {
+                _memoryUsage -= itr->second.mMemoryUsage;
+                object = std::move(itr->second.mObject);
+                shard.mObjects.erase(itr);
+            }
         }
 
         /** Get an ref_ptr<Object> from the object cache*/
         osg::ref_ptr<osg::Object> getRefFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
-                return itr->second.first;
+            const Shard& shard = getShard(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+            const auto itr = shard.mObjects.find(key);
+            if (itr!=shard.mObjects.end())
+                return itr->second.mObject;
             else return nullptr;
         }
 
         /** Check if an object is in the cache, and if it is, update its usage time stamp. */
         bool checkInObjectCache(const KeyType& key, double timeStamp)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
+            Shard& shard = getShard(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+            const auto itr = shard.mObjects.find(key);
+            if (itr!=shard.mObjects.end())
             {
-                itr->second.second = timeStamp;
+                itr->second.mTimeStamp.store(timeStamp, std::memory_order_relaxed);
                 return true;
             }
             else return false;
@@ -138,26 +221,29 @@ class GenericObjectCache : public osg::Referenced
         /** call releaseGLObjects on all objects attached to the object cache.*/
         void releaseGLObjects(osg::State* state)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                object->releaseGLObjects(state);
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                for (const auto& [key, entry] : shard.mObjects)
+                    entry.mObject->releaseGLObjects(state);
             }
         }
 
         /** call node->accept(nv); for all nodes in the objectCache. */
         void accept(osg::NodeVisitor& nv)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                if (object)
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                for (const auto& [key, entry] : shard.mObjects)
                 {
-                    osg::Node* node = dynamic_cast<osg::Node*>(object);
-                    if (node)
-                        node->accept(nv);
+                    osg::Object* object = entry.mObject.get();
+                    if (object)
+                    {
+                        osg::Node* node = dynamic_cast<osg::Node*>(object);
+                        if (node)
+                            node->accept(nv);
+                    }
                 }
             }
         }
@@ -166,27 +252,97 @@ class GenericObjectCache : public osg::Referenced
         template <class Functor>
         void call(Functor& f)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for (typename ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->first, it->second.first.get());
+            for (Shard& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                for (const auto& [key, entry] : shard.mObjects)
+                    f(key, entry.mObject.get());
+            }
         }
 
         /** Get the number of objects in the cache. */
         unsigned int getCacheSize() const
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            return _objectCache.size();
+            std::size_t result = 0;
+            for (const Shard& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                result += shard.mObjects.size();
+            }
+            return static_cast<unsigned int>(result);
+        }
+
+        /** Get the estimated memory used by the objects in the cache in bytes. */
+        std::size_t getMemoryUsage() const
+        {
+            return _memoryUsage.load(std::memory_order_relaxed);
+        }
+
+        /** Add the objects without external references and with a known size to the candidates for eviction. */
+        void collectEvictionCandidates(double referenceTime, std::vector<EvictionCandidate>& candidates)
+        {
+            const osg::ref_ptr<GenericObjectCache> cache(this);
+            for (Shard& shard : _shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+                for (const auto& [key, entry] : shard.mObjects)
+                {
+                    const double timeStamp = entry.mTimeStamp.load(std::memory_order_relaxed);
+                    if (entry.mMemoryUsage == 0 || entry.mObject->referenceCount() > 1 || timeStamp == 0.0)
+                        continue;
+                    const double age = std::max(referenceTime - timeStamp, 0.0) + 1.0;
+                    candidates.push_back(EvictionCandidate {age * entry.mMemoryUsage,
+                        [cache, key = key] { return cache->removeUnreferencedFromObjectCache(key); }});
+                }
+            }
+        }
+
+        /** Remove Object from cache unless it has an external reference, return the estimated memory released.*/
+        std::size_t removeUnreferencedFromObjectCache(const KeyType& key)
+        {
+            osg::ref_ptr<osg::Object> object;
+            Shard& shard = getShard(key);
+            std::lock_guard<std::shared_mutex> lock(shard.mMutex);
+            const auto itr = shard.mObjects.find(key);
+            if (itr == shard.mObjects.end() || itr->second.mObject->referenceCount() > 1)
+                return 0;
+            const std::size_t memoryUsage = itr->second.mMemoryUsage;
+            _memoryUsage -= memoryUsage;
+            // note, actual unref happens outside of the lock
+            object = std::move(itr->second.mObject);
+            shard.mObjects.erase(itr);
+            return memoryUsage;
         }
 
     protected:
 
         virtual ~GenericObjectCache() {}
 
-        typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<KeyType, ObjectTimeStampPair >             ObjectCacheMap;
+        struct CacheEntry
+        {
+            osg::ref_ptr<osg::Object> mObject;
+            // Updated by lookups holding a shared lock only
+            std::atomic<double> mTimeStamp {0.0};
+            std::size_t mMemoryUsage = 0;
+        };
 
-        ObjectCacheMap                          _objectCache;
-        mutable std::mutex                      _objectCacheMutex;
+        struct Shard
+        {
+            std::unordered_map<KeyType, CacheEntry, CacheKeyHash> mObjects;
+            mutable std::shared_mutex mMutex;
+        };
+
+        static constexpr std::size_t sNumShards = 16;
+
+        std::array<Shard, sNumShards> _shards;
+        std::atomic<std::size_t> _memoryUsage {0};
+
+        Shard& getShard(const KeyType& key)
+        {
+            const std::size_t hash = CacheKeyHash()(key);
+            // The low bits also select the bucket within the shard
+            return _shards[(hash ^ (hash >> 16)) % sNumShards];
+        }
 
 };
 
@@ -28,6 +28,9 @@ namespace Resource
         virtual void setExpiryDelay(double expiryDelay) {}
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const {}
         virtual void releaseGLObjects(osg::State* state) {}
+        /// Estimated memory used by the cached objects in bytes.
+        virtual std::size_t getMemoryUsage() const { return 0; }
+        virtual void collectEvictionCandidates(double referenceTime, std::vector<EvictionCandidate>& candidates) {}
     };
 
     /// @brief Base class for managers that require a virtual file system and object cache.
@@ -67,6 +70,13 @@ namespace Resource
 
         void releaseGLObjects(osg::State* state) override { mCache->releaseGLObjects(state); }
 
+        std::size_t getMemoryUsage() const override { return mCache->getMemoryUsage(); }
+
+        void collectEvictionCandidates(double referenceTime, std::vector<EvictionCandidate>& candidates) override
+        {
+            mCache->collectEvictionCandidates(referenceTime, candidates);
+        }
+
     protected:
         const VFS::Manager* mVFS;
         osg::ref_ptr<CacheType> mCache;
@@ -2,6 +2,10 @@
 
 #include <algorithm>
 
+#include <osg/Stats>
+
+#include "memoryusage.hpp"
+
 #include "scenemanager.hpp"
 #include "imagemanager.hpp"
 #include "niffilemanager.hpp"
@@ -62,10 +66,44 @@ namespace Resource
         mNifFileManager->setExpiryDelay(0.0);
     }
 
+    void ResourceSystem::setMemoryBudget(std::size_t bytes)
+    {
+        mMemoryBudget = bytes;
+    }
+
     void ResourceSystem::updateCache(double referenceTime)
     {
         for (std::vector<BaseResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
             (*it)->updateCache(referenceTime);
+
+        if (mMemoryBudget != 0)
+            evictToMemoryBudget(referenceTime);
+    }
+
+    void ResourceSystem::evictToMemoryBudget(double referenceTime)
+    {
+        std::size_t memoryUsage = 0;
+        for (const BaseResourceManager* manager : mResourceManagers)
+            memoryUsage += manager->getMemoryUsage();
+        if (memoryUsage <= mMemoryBudget)
+            return;
+
+        std::vector<EvictionCandidate> candidates;
+        for (BaseResourceManager* manager : mResourceManagers)
+            manager->collectEvictionCandidates(referenceTime, candidates);
+        std::sort(candidates.begin(), candidates.end(),
+                  [] (const EvictionCandidate& lhs, const EvictionCandidate& rhs) { return lhs.mCost > rhs.mCost; });
+
+        for (const EvictionCandidate& candidate : candidates)
+        {
+            if (memoryUsage <= mMemoryBudget)
+                break;
+            const std::size_t released = candidate.mEvict();
+            if (released == 0)
+                continue;
+            memoryUsage -= std::min(released, memoryUsage);
+            ++mEvictions;
+        }
     }
 
     void ResourceSystem::clearCache()
@@ -93,8 +131,14 @@ namespace Resource
 
     void ResourceSystem::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
+        std::size_t memoryUsage = 0;
         for (std::vector<BaseResourceManager*>::const_iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
+        {
             (*it)->reportStats(frameNumber, stats);
+            memoryUsage += (*it)->getMemoryUsage();
+        }
+        stats->setAttribute(frameNumber, "Resource Memory", memoryUsage);
+        stats->setAttribute(frameNumber, "Resource Evictions", mEvictions.load());
     }
 
     void ResourceSystem::releaseGLObjects(osg::State *state)
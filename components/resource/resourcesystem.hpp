@@ -1,6 +1,8 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 #define OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -56,6 +58,10 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay(double expiryDelay);
 
+        /// Evict cached objects without external references before their expiry delay while the estimated memory
+        /// used by all caches exceeds the budget, preferring large objects unused for a long time. 0 disables it.
+        void setMemoryBudget(std::size_t bytes);
+
         /// @note May be called from any thread.
         const VFS::Manager* getVFS() const;
 
@@ -76,6 +82,11 @@ namespace Resource
 
         const VFS::Manager* mVFS;
 
+        std::size_t mMemoryBudget = 0;
+        std::atomic<std::size_t> mEvictions {0};
+
+        void evictToMemoryBudget(double referenceTime);
+
         ResourceSystem(const ResourceSystem&);
         void operator = (const ResourceSystem&);
     };
@@ -1,11 +1,17 @@
 #include "scenemanager.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <future>
+#include <set>
+#include <sstream>
 
 #include <osg/AlphaFunc>
 #include <osg/Node>
 #include <osg/UserDataContainer>
+#include <osg/Version>
 
 #include <osgParticle/ParticleSystem>
 
@@ -25,20 +31,25 @@
 #include <components/misc/algorithm.hpp>
 #include <components/misc/errorMarker.hpp>
 #include <components/misc/osguservalues.hpp>
+#include <components/misc/hash.hpp>
 
 #include <components/vfs/manager.hpp>
 
 #include <components/sceneutil/clone.hpp>
+#include <components/sceneutil/compilescheduler.hpp>
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/optimizer.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/sceneutil/lightmanager.hpp>
 #include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/workqueue.hpp>
+#include <components/sceneutil/serialize.hpp>
 
 #include <components/shader/shadervisitor.hpp>
 #include <components/shader/shadermanager.hpp>
 
+#include <components/files/diskcache.hpp>
 #include <components/files/hash.hpp>
 #include <components/files/memorystream.hpp>
 
@@ -138,12 +149,104 @@ namespace Resource
             return _sharedStateSetList.size();
         }
 
+        unsigned int getNumSharedAttributes() const
+        {
+            return mSharedAttributes.size();
+        }
+
+        unsigned int getNumDuplicateAttributes() const
+        {
+            return mNumDuplicateAttributes;
+        }
+
+        /// Replace equal state attributes other than textures, e.g. materials, with a single instance.
+        /// Equal state sets then hold the same attributes, which is what share() compares them by.
+        void shareAttributes(osg::Node* node)
+        {
+            ShareAttributesVisitor visitor(*this);
+            node->accept(visitor);
+        }
+
+        void pruneAttributes()
+        {
+            for (auto it = mSharedAttributes.begin(); it != mSharedAttributes.end();)
+            {
+                if ((*it)->referenceCount() <= 1)
+                    it = mSharedAttributes.erase(it);
+                else
+                    ++it;
+            }
+        }
+
         void clearCache()
         {
-            std::lock_guard<OpenThreads::Mutex> lock(_listMutex);
-            _sharedTextureList.clear();
-            _sharedStateSetList.clear();
+            {
+                std::lock_guard<OpenThreads::Mutex> lock(_listMutex);
+                _sharedTextureList.clear();
+                _sharedStateSetList.clear();
+            }
+            mSharedAttributes.clear();
+        }
+
+    private:
+        class ShareAttributesVisitor : public osg::NodeVisitor
+        {
+        public:
+            ShareAttributesVisitor(SharedStateManager& manager)
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+                , mManager(manager)
+            {
+            }
+
+            void apply(osg::Node& node) override
+            {
+                if (node.getStateSet())
+                    mManager.shareAttributes(*node.getStateSet());
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                if (drawable.getStateSet())
+                    mManager.shareAttributes(*drawable.getStateSet());
+            }
+
+        private:
+            SharedStateManager& mManager;
+        };
+
+        struct CompareAttributes
+        {
+            bool operator()(const osg::ref_ptr<osg::StateAttribute>& lhs, const osg::ref_ptr<osg::StateAttribute>& rhs) const
+            {
+                return *lhs < *rhs;
+            }
+        };
+
+        void shareAttributes(osg::StateSet& stateset)
+        {
+            // Controllers and callbacks modify their state, it must stay unique
+            if (stateset.getDataVariance() == osg::Object::DYNAMIC || stateset.getUpdateCallback() || stateset.getEventCallback())
+                return;
+
+            std::vector<std::pair<osg::ref_ptr<osg::StateAttribute>, osg::StateAttribute::OverrideValue>> replaced;
+            for (const auto& [type, attribute] : stateset.getAttributeList())
+            {
+                osg::StateAttribute* current = attribute.first.get();
+                if (current->getDataVariance() == osg::Object::DYNAMIC || current->getUpdateCallback() || current->getEventCallback())
+                    continue;
+                const auto [it, inserted] = mSharedAttributes.insert(current);
+                if (inserted || *it == current)
+                    continue;
+                ++mNumDuplicateAttributes;
+                replaced.emplace_back(*it, attribute.second);
+            }
+            for (const auto& [attribute, value] : replaced)
+                stateset.setAttribute(attribute, value);
         }
+
+        std::set<osg::ref_ptr<osg::StateAttribute>, CompareAttributes> mSharedAttributes;
+        unsigned int mNumDuplicateAttributes = 0;
     };
 
     /// Set texture filtering settings on textures contained in a FlipController.
@@ -316,10 +419,13 @@ namespace Resource
         , mAutoUseNormalMaps(false)
         , mAutoUseSpecularMaps(false)
         , mApplyLightingToEnvMaps(false)
+        , mGpuSkinning(false)
         , mLightingMethod(SceneUtil::LightingMethod::FFP)
         , mConvertAlphaTestToAlphaToCoverage(false)
         , mDepthFormat(0)
         , mSharedStateManager(new SharedStateManager)
+        , mShareAttributes(false)
+        , mOptimizedModelCache(nullptr)
         , mImageManager(imageManager)
         , mNifFileManager(nifFileManager)
         , mMinFilter(osg::Texture::LINEAR_MIPMAP_LINEAR)
@@ -340,11 +446,12 @@ namespace Resource
         return mForceShaders;
     }
 
-    void SceneManager::recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix, bool forceShadersForNode, const osg::Program* programTemplate, bool disableSoftParticles)
+    void SceneManager::recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix, bool forceShadersForNode, const osg::Program* programTemplate, bool disableSoftParticles, bool instancing)
     {
         osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor(createShaderVisitor(shaderPrefix));
         shaderVisitor->setAllowedToModifyStateSets(false);
         shaderVisitor->setProgramTemplate(programTemplate);
+        shaderVisitor->setInstancing(instancing);
         if (forceShadersForNode)
             shaderVisitor->setForceShaders(true);
         if (disableSoftParticles)
@@ -403,11 +510,21 @@ namespace Resource
         mSpecularMapPattern = pattern;
     }
 
+    void SceneManager::setShareAttributes(bool share)
+    {
+        mShareAttributes = share;
+    }
+
     void SceneManager::setApplyLightingToEnvMaps(bool apply)
     {
         mApplyLightingToEnvMaps = apply;
     }
 
+    void SceneManager::setGpuSkinning(bool skinning)
+    {
+        mGpuSkinning = skinning;
+    }
+
     void SceneManager::setSupportedLightingMethods(const SceneUtil::LightManager::SupportedMethods& supported)
     {
         mSupportedLightingMethods = supported;
@@ -422,7 +539,7 @@ namespace Resource
     {
         mLightingMethod = method;
 
-        if (mLightingMethod == SceneUtil::LightingMethod::SingleUBO)
+        if (mLightingMethod == SceneUtil::LightingMethod::SingleUBO || mLightingMethod == SceneUtil::LightingMethod::Clustered)
         {
             osg::ref_ptr<osg::Program> program = new osg::Program;
             program->addBindUniformBlock("LightBufferBinding", static_cast<int>(UBOBinding::LightBuffer));
@@ -658,12 +775,147 @@ namespace Resource
         return options;
     }
 
+    namespace
+    {
+        // Change when the loaders or the optimizer produce different scene graphs for the same files
+        constexpr int sOptimizedModelCacheVersion = 2;
+        const std::string sOptimizedModelNamespace = "models";
+
+        osg::ref_ptr<osg::Node> readOptimizedModel(const std::string& data, Resource::ImageManager* imageManager)
+        {
+            if (!SceneUtil::canDeserialize())
+                return nullptr;
+            osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+            if (!reader)
+                return nullptr;
+            SceneUtil::registerSerializers();
+
+            osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+            // Images are referenced by their file names to share them with other models through the image manager
+            options->setReadFileCallback(new ImageReadCallback(imageManager));
+            Files::IMemStream stream(data.data(), data.size());
+            osgDB::ReaderWriter::ReadResult result = reader->readNode(stream, options);
+            if (!result.success() || !result.getNode())
+            {
+                Log(Debug::Warning) << "Warning: Ignoring invalid optimized model cache entry: " << result.message();
+                return nullptr;
+            }
+            return result.getNode();
+        }
+
+        std::optional<std::string> writeOptimizedModel(const osg::Node& node)
+        {
+            osgDB::ReaderWriter* writer = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+            if (!writer)
+                return {};
+            SceneUtil::registerSerializers();
+
+            osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+            options->setPluginStringData("WriteImageHint", "UseExternal");
+            std::ostringstream stream(std::ios::binary);
+            const osgDB::ReaderWriter::WriteResult result = writer->writeNode(node, stream, options);
+            if (!result.success() || !stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write optimized model cache entry: " << result.message();
+                return {};
+            }
+            return stream.str();
+        }
+    }
+
+    void SceneManager::setOptimizedModelCache(Files::DiskCache* cache)
+    {
+        mOptimizedModelCache = nullptr;
+        if (cache == nullptr)
+            return;
+        if (cache->addNamespace(sOptimizedModelNamespace, sOptimizedModelCacheVersion))
+            mOptimizedModelCache = cache;
+    }
+
+    std::optional<std::array<std::uint64_t, 2>> SceneManager::getOptimizedModelCacheKey(const std::string& normalized, unsigned int options) const
+    {
+        std::size_t hash = 0;
+        Misc::hashCombine(hash, std::string_view(osgGetVersion()));
+        Misc::hashCombine(hash, normalized);
+        Misc::hashCombine(hash, options);
+        Misc::hashCombine(hash, NifOsg::Loader::getShowMarkers());
+        Misc::hashCombine(hash, NifOsg::Loader::getHiddenNodeMask());
+        Misc::hashCombine(hash, NifOsg::Loader::getIntersectionDisabledNodeMask());
+        try
+        {
+            // Hash the content rather than a time stamp as archives don't provide them
+            const std::array<std::uint64_t, 2> fileHash = Files::getHash(normalized, *mVFS->get(normalized));
+            Misc::hashCombine(hash, fileHash[0]);
+            return Files::DiskCache::Key {hash, fileHash[1]};
+        }
+        catch (const std::exception&)
+        {
+            // loading reports the error
+            return {};
+        }
+    }
+
     void SceneManager::shareState(osg::ref_ptr<osg::Node> node) {
         mSharedStateMutex.lock();
         mSharedStateManager->share(node.get());
         mSharedStateMutex.unlock();
     }
 
+    struct PendingTemplate
+    {
+        explicit PendingTemplate(bool compile)
+            : mCompile(compile)
+            , mResult(mPromise.get_future().share())
+        {}
+
+        const bool mCompile;
+        std::atomic_bool mClaimed {false};
+        std::promise<osg::ref_ptr<const osg::Node>> mPromise;
+        std::shared_future<osg::ref_ptr<const osg::Node>> mResult;
+    };
+
+    osg::ref_ptr<const osg::Node> TemplateRequest::get() const
+    {
+        return mSceneManager->resolveTemplate(mName, *mPending);
+    }
+
+    bool TemplateRequest::isReady() const
+    {
+        return mPending->mResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// Worker thread item: load a scene template requested through getTemplateAsync.
+    class LoadTemplateItem : public SceneUtil::WorkItem
+    {
+    public:
+        LoadTemplateItem(SceneManager& sceneManager, const std::string& normalized, const std::shared_ptr<PendingTemplate>& pending)
+            : mSceneManager(sceneManager)
+            , mNormalized(normalized)
+            , mPending(pending)
+        {}
+
+        void doWork() override
+        {
+            // Don't extend the lifetime of the result, the pending load is owned by the scene manager until it's done
+            const std::shared_ptr<PendingTemplate> pending = mPending.lock();
+            if (!pending)
+                return;
+            try
+            {
+                mSceneManager.resolveTemplate(mNormalized, *pending);
+            }
+            catch (const std::exception&)
+            {
+                // reported to whoever waits for the request
+            }
+        }
+
+    private:
+        SceneManager& mSceneManager;
+        std::string mNormalized;
+        std::weak_ptr<PendingTemplate> mPending;
+    };
+
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name, bool compile)
     {
         std::string normalized = mVFS->normalizeFilename(name);
@@ -671,9 +923,87 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
+
+        return resolveTemplate(normalized, *getPendingTemplate(normalized, compile));
+    }
+
+    TemplateRequest SceneManager::getTemplateAsync(const std::string& name, SceneUtil::WorkQueue& workQueue, bool compile)
+    {
+        TemplateRequest request;
+        request.mSceneManager = this;
+        request.mName = mVFS->normalizeFilename(name);
+        request.mPending = getPendingTemplate(request.mName, compile);
+        if (!request.mPending->mClaimed)
+            workQueue.addWorkItem(new LoadTemplateItem(*this, request.mName, request.mPending));
+        return request;
+    }
+
+    std::shared_ptr<PendingTemplate> SceneManager::getPendingTemplate(const std::string& normalized, bool compile)
+    {
+        std::lock_guard<std::mutex> lock(mPendingTemplatesMutex);
+        const auto it = mPendingTemplates.find(normalized);
+        if (it != mPendingTemplates.end())
+            return it->second;
+
+        // A load may have completed since the caller checked the cache, the entry is added before the pending one is removed
+        auto pending = std::make_shared<PendingTemplate>(compile);
+        if (osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized))
+        {
+            pending->mClaimed = true;
+            pending->mPromise.set_value(osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get())));
+        }
         else
+            mPendingTemplates.emplace(normalized, pending);
+        return pending;
+    }
+
+    osg::ref_ptr<const osg::Node> SceneManager::resolveTemplate(const std::string& normalized, PendingTemplate& pending)
+    {
+        // Whoever gets here first does the actual loading, everyone else waits for the result
+        if (!pending.mClaimed.exchange(true))
+        {
+            try
+            {
+                osg::ref_ptr<osg::Node> loaded = loadTemplate(normalized, pending.mCompile);
+                mCache->addEntryToObjectCache(normalized, loaded);
+                {
+                    std::lock_guard<std::mutex> lock(mPendingTemplatesMutex);
+                    mPendingTemplates.erase(normalized);
+                }
+                pending.mPromise.set_value(loaded);
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mPendingTemplatesMutex);
+                    mPendingTemplates.erase(normalized);
+                }
+                pending.mPromise.set_exception(std::current_exception());
+            }
+        }
+        return pending.mResult.get();
+    }
+
+    osg::ref_ptr<osg::Node> SceneManager::loadTemplate(std::string normalized, bool compile)
+    {
+        const std::string name = normalized;
+
+        static const unsigned int options = getOptimizationOptions()|SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
+
+        std::optional<Files::DiskCache::Key> cacheKey;
+        if (mOptimizedModelCache && canOptimize(normalized))
+            cacheKey = getOptimizedModelCacheKey(normalized, options);
+
+        osg::ref_ptr<osg::Node> loaded;
+        if (cacheKey)
+        {
+            if (const std::optional<std::string> data = mOptimizedModelCache->read(sOptimizedModelNamespace, *cacheKey))
+                loaded = readOptimizedModel(*data, mImageManager);
+        }
+        const bool cached = loaded != nullptr;
+
+        if (!cached)
         {
-            osg::ref_ptr<osg::Node> loaded;
             try
             {
                 loaded = load(normalized, mVFS, mImageManager, mNifFileManager);
@@ -695,41 +1025,69 @@ namespace Resource
 
                 Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error instead";
                 loaded = static_cast<osg::Node*>(errorMarkerNode->clone(osg::CopyOp::DEEP_COPY_ALL));
+                cacheKey.reset();
             }
 
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
-
-            SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
-            loaded->accept(replaceDepthVisitor);
-
-            osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
-            loaded->accept(*shaderVisitor);
-
-            if (canOptimize(normalized))
+            if (cacheKey)
             {
+                // The structural passes don't depend on the shaders, so run them first to cache their result.
+                // State is only shared within the model until it's final.
+                osg::ref_ptr<osgDB::SharedStateManager> modelState = new osgDB::SharedStateManager;
                 SceneUtil::Optimizer optimizer;
-                optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
+                optimizer.setSharedStateManager(modelState, nullptr);
                 optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
-
-                static const unsigned int options = getOptimizationOptions()|SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
-
                 optimizer.optimize(loaded, options);
+
+                if (SceneUtil::canSerialize(*loaded))
+                {
+                    if (std::optional<std::string> data = writeOptimizedModel(*loaded))
+                        mOptimizedModelCache->write(sOptimizedModelNamespace, *cacheKey, std::move(*data));
+                }
             }
-            else
-                shareState(loaded);
+        }
+
+        // set filtering settings
+        SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsVisitor);
+        SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsControllerVisitor);
+
+        SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
+        loaded->accept(replaceDepthVisitor);
+
+        osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
+        if (cacheKey)
+        {
+            // Equal state of the model was merged before the shader visitor, which must not assume it to be used by a single node
+            shaderVisitor->setAllowedToModifyStateSets(false);
+        }
+        loaded->accept(*shaderVisitor);
+
+        if (mShareAttributes)
+        {
+            std::lock_guard<std::mutex> lock(mSharedStateMutex);
+            mSharedStateManager->shareAttributes(loaded);
+        }
 
-            if (compile && mIncrementalCompileOperation)
-                mIncrementalCompileOperation->add(loaded);
-            else
-                loaded->getBound();
+        if (cacheKey)
+            shareState(loaded);
+        else if (canOptimize(normalized))
+        {
+            SceneUtil::Optimizer optimizer;
+            optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
 
-            mCache->addEntryToObjectCache(normalized, loaded);
-            return loaded;
+            optimizer.optimize(loaded, options);
         }
+        else
+            shareState(loaded);
+
+        if (compile && mIncrementalCompileOperation)
+            mIncrementalCompileOperation->add(loaded);
+        else
+            loaded->getBound();
+
+        return loaded;
     }
 
     osg::ref_ptr<osg::Node> SceneManager::getInstance(const std::string& name)
@@ -873,6 +1231,7 @@ namespace Resource
 
         mSharedStateMutex.lock();
         mSharedStateManager->prune();
+        mSharedStateManager->pruneAttributes();
         mSharedStateMutex.unlock();
 
         if (mIncrementalCompileOperation)
@@ -909,14 +1268,22 @@ namespace Resource
             std::lock_guard<OpenThreads::Mutex> lock(*mIncrementalCompileOperation->getToCompiledMutex());
             stats->setAttribute(frameNumber, "Compiling", mIncrementalCompileOperation->getToCompile().size());
         }
+        if (auto scheduler = dynamic_cast<SceneUtil::CompileScheduler*>(mIncrementalCompileOperation.get()))
+            scheduler->reportStats(frameNumber, *stats);
 
         {
             std::lock_guard<std::mutex> lock(mSharedStateMutex);
             stats->setAttribute(frameNumber, "Texture", mSharedStateManager->getNumSharedTextures());
             stats->setAttribute(frameNumber, "StateSet", mSharedStateManager->getNumSharedStateSets());
+            if (mShareAttributes)
+            {
+                stats->setAttribute(frameNumber, "StateAttribute", mSharedStateManager->getNumSharedAttributes());
+                stats->setAttribute(frameNumber, "StateAttribute Duplicates", mSharedStateManager->getNumDuplicateAttributes());
+            }
         }
 
         stats->setAttribute(frameNumber, "Node", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Node Memory", mCache->getMemoryUsage());
     }
 
     Shader::ShaderVisitor *SceneManager::createShaderVisitor(const std::string& shaderPrefix)
@@ -929,6 +1296,7 @@ namespace Resource
         shaderVisitor->setAutoUseSpecularMaps(mAutoUseSpecularMaps);
         shaderVisitor->setSpecularMapPattern(mSpecularMapPattern);
         shaderVisitor->setApplyLightingToEnvMaps(mApplyLightingToEnvMaps);
+        shaderVisitor->setGpuSkinning(mGpuSkinning);
         shaderVisitor->setConvertAlphaTestToAlphaToCoverage(mConvertAlphaTestToAlphaToCoverage);
         shaderVisitor->setOpaqueDepthTex(mOpaqueDepthTex);
         return shaderVisitor;
@@ -1,10 +1,13 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_SCENEMANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_SCENEMANAGER_H
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <osg/ref_ptr>
 #include <osg/Node>
@@ -20,6 +23,9 @@ namespace Resource
     class ImageManager;
     class NifFileManager;
     class SharedStateManager;
+    class SceneManager;
+    class LoadTemplateItem;
+    struct PendingTemplate;
 }
 
 namespace osgUtil
@@ -32,12 +38,22 @@ namespace osgDB
     class SharedStateManager;
 }
 
+namespace Files
+{
+    class DiskCache;
+}
+
 namespace Shader
 {
     class ShaderManager;
     class ShaderVisitor;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Resource
 {
     class TemplateRef : public osg::Object
@@ -66,6 +82,28 @@ namespace Resource
         std::vector<osg::ref_ptr<const Object>> mObjects;
     };
 
+    /// @brief Handle to a scene template that may still be loading.
+    /// @see SceneManager::getTemplateAsync
+    class TemplateRequest
+    {
+    public:
+        /// Wait for the template. If no thread has started loading it yet, it is loaded on the calling thread,
+        /// so waiting on a request from a work queue thread can not dead lock.
+        /// @note Thread safe.
+        osg::ref_ptr<const osg::Node> get() const;
+
+        bool isReady() const;
+
+        const std::string& getName() const { return mName; }
+
+    private:
+        friend class SceneManager;
+
+        SceneManager* mSceneManager = nullptr;
+        std::string mName;
+        std::shared_ptr<PendingTemplate> mPending;
+    };
+
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
     class SceneManager : public ResourceManager
@@ -77,7 +115,8 @@ namespace Resource
         Shader::ShaderManager& getShaderManager();
 
         /// Re-create shaders for this node, need to call this if alpha testing, texture stages or vertex color mode have changed.
-        void recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix = "objects", bool forceShadersForNode = false, const osg::Program* programTemplate = nullptr, bool disableSoftParticles = false);
+        /// @param instancing Use shaders for geometry drawn instanced, see Shader::ShaderVisitor::setInstancing.
+        void recreateShaders(osg::ref_ptr<osg::Node> node, const std::string& shaderPrefix = "objects", bool forceShadersForNode = false, const osg::Program* programTemplate = nullptr, bool disableSoftParticles = false, bool instancing = false);
 
         /// Applying shaders to a node may replace some fixed-function state.
         /// This restores it.
@@ -107,8 +146,14 @@ namespace Resource
 
         void setSpecularMapPattern(const std::string& pattern);
 
+        /// Share equal state attributes, e.g. materials, between all loaded scenes, so more of their state sets can be shared.
+        void setShareAttributes(bool share);
+
         void setApplyLightingToEnvMaps(bool apply);
 
+        /// Skin RigGeometry rendered with shaders in the vertex shader rather than on the CPU.
+        void setGpuSkinning(bool skinning);
+
         void setSupportedLightingMethods(const SceneUtil::LightManager::SupportedMethods& supported);
         bool isSupportedLightingMethod(SceneUtil::LightingMethod method) const;
 
@@ -126,6 +171,11 @@ namespace Resource
 
         void setShaderPath(const std::string& path);
 
+        /// Cache the optimized scene graphs of models in the "models" namespace of the disk cache to skip optimizing them
+        /// on later loads. The cache must outlive the scene manager, nullptr disables it.
+        /// @note Only models that survive a round trip through serialization are cached, see SceneUtil::canSerialize.
+        void setOptimizedModelCache(Files::DiskCache* cache);
+
         /// Check if a given scene is loaded and if so, update its usage timestamp to prevent it from being unloaded
         bool checkLoaded(const std::string& name, double referenceTime);
 
@@ -133,8 +183,16 @@ namespace Resource
         /// @note If the given filename does not exist or fails to load, an error marker mesh will be used instead.
         ///  If even the error marker mesh can not be found, an exception is thrown.
         /// @note Thread safe.
+        /// @note Concurrent requests for the same scene wait for a single load.
         osg::ref_ptr<const osg::Node> getTemplate(const std::string& name, bool compile=true);
 
+        /// Queue loading of a scene template on the given work queue and return without waiting for it.
+        /// The returned request may be discarded to only prefetch the template, a later getTemplate
+        /// call waits for the queued load instead of starting another one.
+        /// @see getTemplate
+        /// @note Thread safe.
+        TemplateRequest getTemplateAsync(const std::string& name, SceneUtil::WorkQueue& workQueue, bool compile=true);
+
         /// Clone osg::Node safely.
         /// @note Thread safe.
         static osg::ref_ptr<osg::Node> cloneNode(const osg::Node* base);
@@ -196,9 +254,16 @@ namespace Resource
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
+        friend class TemplateRequest;
+        friend class LoadTemplateItem;
 
         Shader::ShaderVisitor* createShaderVisitor(const std::string& shaderPrefix = "objects");
 
+        std::shared_ptr<PendingTemplate> getPendingTemplate(const std::string& normalized, bool compile);
+        osg::ref_ptr<const osg::Node> resolveTemplate(const std::string& normalized, PendingTemplate& pending);
+        osg::ref_ptr<osg::Node> loadTemplate(std::string normalized, bool compile);
+        std::optional<std::array<std::uint64_t, 2>> getOptimizedModelCacheKey(const std::string& normalized, unsigned int options) const;
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -208,6 +273,7 @@ namespace Resource
         bool mAutoUseSpecularMaps;
         std::string mSpecularMapPattern;
         bool mApplyLightingToEnvMaps;
+        bool mGpuSkinning;
         SceneUtil::LightingMethod mLightingMethod;
         SceneUtil::LightManager::SupportedMethods mSupportedLightingMethods;
         bool mConvertAlphaTestToAlphaToCoverage;
@@ -216,6 +282,12 @@ namespace Resource
 
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable std::mutex mSharedStateMutex;
+        bool mShareAttributes;
+
+        Files::DiskCache* mOptimizedModelCache;
+
+        std::map<std::string, std::shared_ptr<PendingTemplate>> mPendingTemplates;
+        std::mutex mPendingTemplatesMutex;
 
         Resource::ImageManager* mImageManager;
         Resource::NifFileManager* mNifFileManager;
@@ -369,36 +369,78 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "FrameNumber",
             "",
             "Compiling",
+            "Compiling Bytes",
+            "Compiling Latency",
             "UnrefQueue",
             "WorkQueue",
             "WorkThread",
+            "WorkQueue High Latency",
+            "WorkQueue Normal Latency",
+            "WorkQueue Low Latency",
+            "Frame Arena",
+            "Frame Arena Peak",
+            "Physics Threads Busy",
+            "Navigator Threads Busy",
+            "Preload Threads Busy",
+            "AI Threads Busy",
+            "Skinning Threads Busy",
             "",
             "Texture",
             "StateSet",
+            "StateAttribute",
+            "StateAttribute Duplicates",
             "Node",
+            "Node Memory",
             "Shape",
             "Shape Instance",
             "Image",
+            "Image Memory",
+            "Image Streamed",
+            "Image Duplicates",
+            "Image Duplicate Memory",
             "Nif",
             "Keyframe",
+            "Keyframe Memory",
+            "Resource Memory",
+            "Resource Evictions",
             "",
             "Groundcover Chunk",
+            "Groundcover Chunk Memory",
             "Object Chunk",
+            "Object Chunk Memory",
             "Terrain Chunk",
+            "Terrain Chunk Memory",
             "Terrain Texture",
+            "Terrain Texture Memory",
             "Land",
+            "Land Memory",
+            "Land Heights",
+            "Land Heights Memory",
             "Composite",
+            "Occlusion Tested",
+            "Occlusion Culled",
+            "Resolution Scale",
+            "Effect Pool",
+            "Effect Pool Hits",
+            "Effect Pool Misses",
+            "Effect Pool Dropped",
             "",
             "NavMesh Jobs",
             "NavMesh Waiting",
             "NavMesh Pushed",
             "NavMesh Processing",
+            "NavMesh Demanded",
+            "NavMesh Latency",
+            "NavMesh DemandLatency",
             "NavMesh DbJobs",
             "NavMesh DbCacheHitRate",
             "NavMesh CacheSize",
             "NavMesh UsedTiles",
             "NavMesh CachedTiles",
             "NavMesh CacheHitRate",
+            "NavMesh ResidentTiles",
+            "NavMesh ResidentSize",
+            "NavMesh Reloads",
             "",
             "Mechanics Actors",
             "Mechanics Objects",
@@ -407,6 +449,29 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "Physics Objects",
             "Physics Projectiles",
             "Physics HeightFields",
+            "Physics LOS Cache",
+            "Physics LOS Hits",
+            "Physics LOS Misses",
+            "Physics LOS Updates",
+            "Physics Steps",
+            "Physics Dropped Steps",
+            "",
+            "Preload Cells",
+            "Preload Grid Hits",
+            "Preload Door Hits",
+            "Preload Travel Hits",
+            "Preload Misses",
+            "Preload Evictions",
+            "",
+            "Sound Sources",
+            "Sound Sources Stolen",
+            "Sound Streams",
+            "Sound Stream Underruns",
+            "Sound Buffers",
+            "Sound Buffers Pending",
+            "Sound Buffer Memory",
+            "Sound Load Time",
+            "Sound Decode Time",
         });
 
         static const auto longest = std::max_element(statNames.begin(), statNames.end(),
@@ -0,0 +1,183 @@
+#include "compilescheduler.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+#include <osg/Geometry>
+#include <osg/Stats>
+#include <osg/Texture>
+
+namespace SceneUtil
+{
+    namespace
+    {
+        /// Estimates the bytes compiling a subgraph uploads, textures shared between subgraphs are counted by each.
+        class UploadSizeVisitor : public osg::NodeVisitor
+        {
+        public:
+            UploadSizeVisitor()
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            {
+                setTraversalMask(~0u);
+                setNodeMaskOverride(~0u);
+            }
+
+            void apply(osg::Node& node) override
+            {
+                applyStateSet(node.getStateSet());
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                applyStateSet(drawable.getStateSet());
+                if (const osg::Geometry* geometry = drawable.asGeometry())
+                {
+                    osg::Geometry::ArrayList arrays;
+                    geometry->getArrayList(arrays);
+                    for (const osg::ref_ptr<osg::Array>& array : arrays)
+                        if (array != nullptr && mVisited.insert(array.get()).second)
+                            mBytes += array->getTotalDataSize();
+                    for (unsigned int i = 0; i < geometry->getNumPrimitiveSets(); ++i)
+                        if (const osg::DrawElements* elements = geometry->getPrimitiveSet(i)->getDrawElements())
+                            if (mVisited.insert(elements).second)
+                                mBytes += elements->getTotalDataSize();
+                }
+            }
+
+            std::size_t mBytes = 0;
+
+        private:
+            std::set<const osg::Object*> mVisited;
+
+            void applyStateSet(const osg::StateSet* stateset)
+            {
+                if (stateset == nullptr)
+                    return;
+                for (unsigned int unit = 0; unit < stateset->getNumTextureAttributeLists(); ++unit)
+                {
+                    const osg::Texture* texture = static_cast<const osg::Texture*>(
+                        stateset->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+                    if (texture == nullptr || !mVisited.insert(texture).second)
+                        continue;
+                    for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                        if (const osg::Image* image = texture->getImage(i))
+                            mBytes += image->getTotalSizeInBytesIncludingMipmaps();
+                }
+            }
+        };
+
+        std::size_t estimateUploadSize(osg::Node& subgraph)
+        {
+            UploadSizeVisitor visitor;
+            subgraph.accept(visitor);
+            return visitor.mBytes;
+        }
+    }
+
+    CompileScheduler::CompileScheduler(std::size_t byteBudget)
+        : mByteBudget(byteBudget)
+    {
+    }
+
+    void CompileScheduler::setPriority(const osg::Node* subgraph, float priority)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPriorities[subgraph] = priority;
+    }
+
+    void CompileScheduler::updateEntries(const CompileSets& sets, Clock::time_point now)
+    {
+        std::set<const CompileSet*> pending;
+        for (const osg::ref_ptr<CompileSet>& set : sets)
+            pending.insert(set.get());
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto it = mEntries.begin(); it != mEntries.end();)
+        {
+            if (pending.count(it->first.get()) != 0)
+            {
+                ++it;
+                continue;
+            }
+            mPendingBytes -= it->second.mBytes;
+            mLatencySum += std::chrono::duration<double>(now - it->second.mAdded).count();
+            ++mNumCompiled;
+            it = mEntries.erase(it);
+        }
+
+        for (const osg::ref_ptr<CompileSet>& set : sets)
+        {
+            auto [it, inserted] = mEntries.emplace(set, Entry());
+            if (!inserted)
+                continue;
+            Entry& entry = it->second;
+            entry.mAdded = now;
+            if (set->_subgraphToCompile != nullptr)
+            {
+                entry.mBytes = estimateUploadSize(*set->_subgraphToCompile);
+                const auto priority = mPriorities.find(set->_subgraphToCompile.get());
+                if (priority != mPriorities.end())
+                {
+                    entry.mPriority = priority->second;
+                    mPriorities.erase(priority);
+                }
+            }
+            mPendingBytes += entry.mBytes;
+        }
+    }
+
+    void CompileScheduler::operator()(osg::GraphicsContext* context)
+    {
+        CompileSets postponed;
+        {
+            std::lock_guard<OpenThreads::Mutex> lock(*getToCompiledMutex());
+            CompileSets& sets = getToCompile();
+            updateEntries(sets, Clock::now());
+
+            sets.sort([&] (const osg::ref_ptr<CompileSet>& lhs, const osg::ref_ptr<CompileSet>& rhs)
+            {
+                const Entry& left = mEntries[lhs];
+                const Entry& right = mEntries[rhs];
+                if (left.mPriority != right.mPriority)
+                    return left.mPriority < right.mPriority;
+                return left.mAdded < right.mAdded;
+            });
+
+            // Everything is compiled at once while a loading screen asks for it
+            const bool compileAll = _compileAllTillFrameNumber > _currentFrameNumber;
+            if (mByteBudget > 0 && !compileAll)
+            {
+                std::size_t bytes = 0;
+                auto it = sets.begin();
+                for (; it != sets.end(); ++it)
+                {
+                    bytes += mEntries[*it].mBytes;
+                    if (bytes > mByteBudget && it != sets.begin())
+                        break;
+                }
+                postponed.splice(postponed.end(), sets, it, sets.end());
+            }
+        }
+
+        osgUtil::IncrementalCompileOperation::operator()(context);
+
+        if (!postponed.empty())
+        {
+            std::lock_guard<OpenThreads::Mutex> lock(*getToCompiledMutex());
+            getToCompile().splice(getToCompile().end(), postponed);
+        }
+    }
+
+    void CompileScheduler::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        stats.setAttribute(frameNumber, "Compiling Bytes", mPendingBytes);
+        if (mNumCompiled > 0)
+            stats.setAttribute(frameNumber, "Compiling Latency", mLatencySum / mNumCompiled * 1000);
+        mLatencySum = 0;
+        mNumCompiled = 0;
+    }
+}
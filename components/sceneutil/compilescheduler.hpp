@@ -0,0 +1,65 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_COMPILESCHEDULER_H
+#define OPENMW_COMPONENTS_SCENEUTIL_COMPILESCHEDULER_H
+
+#include <osgUtil/IncrementalCompileOperation>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace SceneUtil
+{
+    /// @brief Compiles the pending objects in the order of their priority, with a limit on the bytes uploaded per frame.
+    /// @par The time spent per frame is limited by the target frame rate as with any IncrementalCompileOperation. On
+    /// top of that, only the objects fitting into the byte budget are offered to each frame, but at least one.
+    /// Objects are compiled by increasing priority value, e.g. the distance to the viewer, then by age.
+    class CompileScheduler : public osgUtil::IncrementalCompileOperation
+    {
+    public:
+        /// @param byteBudget estimated bytes of textures and vertex data to compile per frame, 0 for no limit
+        explicit CompileScheduler(std::size_t byteBudget);
+
+        /// Set the priority of a subgraph added afterwards, lower values are compiled first. Subgraphs without a
+        /// priority get 0.
+        /// @note May be called from any thread.
+        void setPriority(const osg::Node* subgraph, float priority);
+
+        void operator()(osg::GraphicsContext* context) override;
+
+        /// Report the pending bytes and the mean time objects waited to be compiled since the last report.
+        /// @note May be called from any thread.
+        void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry
+        {
+            float mPriority = 0;
+            std::size_t mBytes = 0;
+            Clock::time_point mAdded;
+        };
+
+        const std::size_t mByteBudget;
+        // Holds a reference to the compile sets, so a new one never gets the address of a finished one
+        std::map<osg::ref_ptr<CompileSet>, Entry> mEntries;
+
+        std::mutex mMutex;
+        std::map<const osg::Node*, float> mPriorities;
+        std::size_t mPendingBytes = 0;
+        double mLatencySum = 0;
+        std::size_t mNumCompiled = 0;
+
+        /// Track the sets added and removed since the last frame.
+        /// @note Called with the compile list locked.
+        void updateEntries(const CompileSets& sets, Clock::time_point now);
+    };
+}
+
+#endif
@@ -9,14 +9,43 @@
 #include <osg/MatrixTransform>
 #include <osg/NodeCallback>
 
+#include <osgUtil/CullVisitor>
+
 namespace SceneUtil
 {
 
 
+    void CullFrameCallback::operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+    {
+        // Drawables run their cull callbacks before they are tested against the frustum
+        if (!cv->isCulled(*node))
+            mLastFrame.store(cv->getTraversalNumber(), std::memory_order_relaxed);
+        traverse(node, cv);
+    }
+
+    bool CullFrameCallback::wasVisible(const osg::NodeVisitor* nv)
+    {
+        const unsigned int frame = nv->getTraversalNumber();
+        const unsigned int lastFrame = mLastFrame.load(std::memory_order_relaxed);
+        if (lastFrame == sNever)
+        {
+            if (mFirstFrame == sNever)
+                mFirstFrame = frame;
+            return frame == mFirstFrame;
+        }
+        return lastFrame + 1 >= frame;
+    }
+
     Controller::Controller()
     {
     }
 
+    Controller::Controller(const Controller& copy)
+        : mSource(copy.mSource)
+        , mFunction(copy.mFunction)
+    {
+    }
+
     bool Controller::hasInput() const
     {
         return mSource.get() != nullptr;
@@ -30,6 +59,11 @@ namespace SceneUtil
             return mSource->getValue(nv);
     }
 
+    bool Controller::isInputShared() const
+    {
+        return mSource != nullptr && mSource->isShared();
+    }
+
     void Controller::setSource(std::shared_ptr<ControllerSource> source)
     {
         mSource = source;
@@ -50,6 +84,16 @@ namespace SceneUtil
         return mFunction;
     }
 
+    void Controller::setCullFrameCallback(osg::ref_ptr<CullFrameCallback> callback)
+    {
+        mCullFrameCallback = callback;
+    }
+
+    bool Controller::isSkipped(const osg::NodeVisitor* nv) const
+    {
+        return mCullFrameCallback != nullptr && !mCullFrameCallback->wasVisible(nv);
+    }
+
     FrameTimeSource::FrameTimeSource()
     {
     }
@@ -136,6 +180,22 @@ namespace SceneUtil
         ctrl.setSource(mToAssign);
     }
 
+    void SkipInvisibleControllersVisitor::visit(osg::Node& node, Controller& ctrl)
+    {
+        if (!ctrl.isSkippableWhenInvisible())
+            return;
+
+        osg::ref_ptr<CullFrameCallback> callback;
+        for (osg::Callback* cb = node.getCullCallback(); cb != nullptr && callback == nullptr; cb = cb->getNestedCallback())
+            callback = dynamic_cast<CullFrameCallback*>(cb);
+        if (callback == nullptr)
+        {
+            callback = new CullFrameCallback;
+            node.addCullCallback(callback);
+        }
+        ctrl.setCullFrameCallback(callback);
+    }
+
     FindMaxControllerLengthVisitor::FindMaxControllerLengthVisitor()
         : SceneUtil::ControllerVisitor()
         , mMaxLength(0)
@@ -1,8 +1,18 @@
 #ifndef OPENMW_COMPONENTS_SCENEUTIL_CONTROLLER_H
 #define OPENMW_COMPONENTS_SCENEUTIL_CONTROLLER_H
 
+#include <atomic>
 #include <memory>
+
 #include <osg/NodeVisitor>
+#include <osg/ref_ptr>
+
+#include "nodecallback.hpp"
+
+namespace osgUtil
+{
+    class CullVisitor;
+}
 
 namespace SceneUtil
 {
@@ -12,6 +22,10 @@ namespace SceneUtil
     public:
         virtual ~ControllerSource() { }
         virtual float getValue(osg::NodeVisitor* nv) = 0;
+
+        /// May controllers driven by this source reuse the results of other controllers cloned from the same
+        /// template at a nearby value? Their output is then only approximately the one for the current value.
+        virtual bool isShared() const { return false; }
     };
 
     class FrameTimeSource : public ControllerSource
@@ -34,25 +48,58 @@ namespace SceneUtil
         virtual float getMaximum() const = 0;
     };
 
+    /// Remembers the last frame in which the node it's attached to was culled.
+    class CullFrameCallback : public NodeCallback<CullFrameCallback, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv);
+
+        /// Was the node culled in the previous or the current frame? A node that was never culled counts as visible,
+        /// so new objects are updated until their first cull.
+        bool wasVisible(const osg::NodeVisitor* nv);
+
+    private:
+        static constexpr unsigned int sNever = ~0u;
+        std::atomic<unsigned int> mLastFrame {sNever};
+        unsigned int mFirstFrame = sNever;
+    };
+
     class Controller
     {
     public:
         Controller();
+        /// Does not copy the CullFrameCallback, it belongs to the node of the original.
+        Controller(const Controller& copy);
         virtual ~Controller() {}
 
         bool hasInput() const;
 
         float getInputValue(osg::NodeVisitor* nv);
 
+        /// @see ControllerSource::isShared
+        bool isInputShared() const;
+
         void setSource(std::shared_ptr<ControllerSource> source);
         void setFunction(std::shared_ptr<ControllerFunction> function);
 
         std::shared_ptr<ControllerSource> getSource() const;
         std::shared_ptr<ControllerFunction> getFunction() const;
 
+        /// Can the controller stop updating while its node is not visible? It has to compute its output from the
+        /// current input alone and must not affect whether the node is culled.
+        virtual bool isSkippableWhenInvisible() const { return false; }
+
+        /// Skip updates while the node the callback is attached to is not culled, see SkipInvisibleControllersVisitor.
+        void setCullFrameCallback(osg::ref_ptr<CullFrameCallback> callback);
+
+        /// Should the update of this frame be skipped?
+        bool isSkipped(const osg::NodeVisitor* nv) const;
+
     private:
         std::shared_ptr<ControllerSource> mSource;
 
+        osg::ref_ptr<CullFrameCallback> mCullFrameCallback;
+
         // The source value gets passed through this function before it's passed on to the DestValue.
         std::shared_ptr<ControllerFunction> mFunction;
     };
@@ -99,6 +146,15 @@ namespace SceneUtil
         void visit(osg::Node& node, Controller& ctrl) override;
     };
 
+    /// Makes the controllers that support it skip their updates while their node was not culled in the last frame.
+    /// They catch up with the current input once the node is visible again, one frame late.
+    /// @note Run on an instance, the controllers remember the nodes they were attached to.
+    class SkipInvisibleControllersVisitor : public ControllerVisitor
+    {
+    public:
+        void visit(osg::Node& node, Controller& ctrl) override;
+    };
+
     /// Finds the maximum of all controller functions in the given scene graph
     class FindMaxControllerLengthVisitor : public ControllerVisitor
     {
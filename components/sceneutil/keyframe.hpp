@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_SCENEUTIL_KEYFRAME_HPP
 #define OPENMW_COMPONENTS_SCENEUTIL_KEYFRAME_HPP
 
+#include <cstddef>
 #include <map>
 
 #include <osg/Object>
@@ -23,6 +24,9 @@ namespace SceneUtil
 
         virtual osg::Vec3f getTranslation(float time) const  { return osg::Vec3f(); }
 
+        /// Approximate memory used by the controller and its keys, 0 if unknown.
+        virtual std::size_t getMemoryUsage() const { return 0; }
+
         /// @note We could drop this function in favour of osg::Object::asCallback from OSG 3.6 on.
         virtual osg::Callback* getAsCallback() = 0;
     };
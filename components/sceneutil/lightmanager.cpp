@@ -3,6 +3,7 @@
 #include <array>
 #include <cstring>
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 
 #include <osg/BufferObject>
@@ -10,6 +11,7 @@
 #include <osg/Endian>
 #include <osg/Version>
 #include <osg/ValueObject>
+#include <osg/Vec3i>
 
 #include <osgUtil/CullVisitor>
 
@@ -29,6 +31,53 @@ namespace
         return left->mViewBound.center().length2() - left->mViewBound.radius2()*illuminationBias < right->mViewBound.center().length2() - right->mViewBound.radius2()*illuminationBias;
     }
 
+    // below this many lights in view, testing all of them is cheaper than the grid
+    constexpr std::size_t sMinLightsForGrid = 16;
+    constexpr std::int64_t sMaxCellsPerLight = 64;
+    constexpr std::int64_t sMaxCellsPerQuery = 64;
+    constexpr int sMaxCellCoordinate = 1 << 20;
+
+    struct CellRange
+    {
+        osg::Vec3i mMin;
+        osg::Vec3i mMax;
+
+        std::int64_t getNumCells() const
+        {
+            return std::int64_t(mMax.x() - mMin.x() + 1) * (mMax.y() - mMin.y() + 1) * (mMax.z() - mMin.z() + 1);
+        }
+    };
+
+    int getCellCoordinate(float value, float cellSize)
+    {
+        return static_cast<int>(std::clamp(std::floor(value / cellSize), float(-sMaxCellCoordinate), float(sMaxCellCoordinate - 1)));
+    }
+
+    CellRange getCellRange(const osg::BoundingSphere& bound, float cellSize)
+    {
+        const osg::Vec3f radius(bound.radius(), bound.radius(), bound.radius());
+        const osg::Vec3f min = bound.center() - radius;
+        const osg::Vec3f max = bound.center() + radius;
+        return CellRange {
+            osg::Vec3i(getCellCoordinate(min.x(), cellSize), getCellCoordinate(min.y(), cellSize), getCellCoordinate(min.z(), cellSize)),
+            osg::Vec3i(getCellCoordinate(max.x(), cellSize), getCellCoordinate(max.y(), cellSize), getCellCoordinate(max.z(), cellSize)),
+        };
+    }
+
+    std::int64_t getCellKey(int x, int y, int z)
+    {
+        return (std::int64_t(x + sMaxCellCoordinate) << 42) | (std::int64_t(y + sMaxCellCoordinate) << 21) | std::int64_t(z + sMaxCellCoordinate);
+    }
+
+    template <class Function>
+    void forEachCell(const CellRange& range, Function&& function)
+    {
+        for (int x = range.mMin.x(); x <= range.mMax.x(); ++x)
+            for (int y = range.mMin.y(); y <= range.mMax.y(); ++y)
+                for (int z = range.mMin.z(); z <= range.mMax.z(); ++z)
+                    function(getCellKey(x, y, z));
+    }
+
     void configurePosition(osg::Matrixf& mat, const osg::Vec4& pos)
     {
         mat(0, 0) = pos.x();
@@ -278,6 +327,7 @@ namespace SceneUtil
                 break;
             }
         case LightingMethod::SingleUBO:
+        case LightingMethod::Clustered:
             {
                 osg::ref_ptr<LightBuffer> buffer = new LightBuffer(lightManager->getMaxLightsInScene());
 
@@ -598,8 +648,9 @@ namespace SceneUtil
         {
             osg::ref_ptr<osg::StateSet> stateset = new osg::StateSet;
 
-            if (node->getLightingMethod() == LightingMethod::SingleUBO)
+            if (node->getLightingMethod() == LightingMethod::SingleUBO || node->getLightingMethod() == LightingMethod::Clustered)
             {
+                std::unique_lock<std::mutex> lock(node->getCullMutex());
                 auto buffer = node->getUBOManager()->getLightBuffer(cv->getTraversalNumber());
 
 #if OSG_VERSION_GREATER_OR_EQUAL(3,5,7)
@@ -616,6 +667,10 @@ namespace SceneUtil
                     buffer->setDiffuse(0, sun->getDiffuse());
                     buffer->setSpecular(0, sun->getSpecular());
                 }
+                lock.unlock();
+
+                if (node->getLightingMethod() == LightingMethod::Clustered)
+                    node->updateClusters(cv, *stateset);
             }
             else if (node->getLightingMethod() == LightingMethod::PerObjectUniform)
             {
@@ -626,6 +681,7 @@ namespace SceneUtil
                     configureAmbient(lightMat, sun->getAmbient());
                     configureDiffuse(lightMat, sun->getDiffuse());
                     configureSpecular(lightMat, sun->getSpecular());
+                    std::lock_guard<std::mutex> lock(node->getCullMutex());
                     node->setSunlightBuffer(lightMat, cv->getTraversalNumber());
                     stateset->addUniform(node->generateLightBufferUniform(lightMat));
                 }
@@ -756,6 +812,7 @@ namespace SceneUtil
          {"legacy", LightingMethod::FFP}
         ,{"shaders compatibility", LightingMethod::PerObjectUniform}
         ,{"shaders", LightingMethod::SingleUBO}
+        ,{"clustered", LightingMethod::Clustered}
     };
 
     LightingMethod LightManager::getLightingMethodFromString(const std::string& value)
@@ -792,6 +849,7 @@ namespace SceneUtil
         mSupported[static_cast<int>(LightingMethod::FFP)] = true;
         mSupported[static_cast<int>(LightingMethod::PerObjectUniform)] = true;
         mSupported[static_cast<int>(LightingMethod::SingleUBO)] = supportsUBO && supportsGPU4;
+        mSupported[static_cast<int>(LightingMethod::Clustered)] = supportsUBO && supportsGPU4;
 
         setUpdateCallback(new LightManagerUpdateCallback);
 
@@ -806,7 +864,7 @@ namespace SceneUtil
 
         static bool hasLoggedWarnings = false;
 
-        if (lightingMethod == LightingMethod::SingleUBO && !hasLoggedWarnings)
+        if ((lightingMethod == LightingMethod::SingleUBO || lightingMethod == LightingMethod::Clustered) && !hasLoggedWarnings)
         {
             if (!supportsUBO)
                 Log(Debug::Warning) << "GL_ARB_uniform_buffer_object not supported: switching to shader compatibility lighting mode";
@@ -819,6 +877,8 @@ namespace SceneUtil
 
         if (!supportsUBO || !supportsGPU4 || lightingMethod == LightingMethod::PerObjectUniform)
             initPerObjectUniform(targetLights);
+        else if (lightingMethod == LightingMethod::Clustered)
+            initClustered(targetLights);
         else
             initSingleUBO(targetLights);
 
@@ -876,13 +936,19 @@ namespace SceneUtil
         defines["maxLightsInScene"] = std::to_string(getMaxLightsInScene());
         defines["lightingMethodFFP"] = getLightingMethod() == LightingMethod::FFP ? "1" : "0";
         defines["lightingMethodPerObjectUniform"] = getLightingMethod() == LightingMethod::PerObjectUniform ? "1" : "0";
-        defines["lightingMethodUBO"] = getLightingMethod() == LightingMethod::SingleUBO ? "1" : "0";
-        defines["useUBO"] = std::to_string(getLightingMethod() == LightingMethod::SingleUBO);
-        // exposes bitwise operators
-        defines["useGPUShader4"] = std::to_string(getLightingMethod() == LightingMethod::SingleUBO);
+        // the clustered method shares the light buffer of the single UBO method
+        const bool useUBO = getLightingMethod() == LightingMethod::SingleUBO || getLightingMethod() == LightingMethod::Clustered;
+        defines["lightingMethodUBO"] = useUBO ? "1" : "0";
+        defines["lightingMethodClustered"] = getLightingMethod() == LightingMethod::Clustered ? "1" : "0";
+        defines["useUBO"] = std::to_string(useUBO);
+        // exposes bitwise operators and texelFetch
+        defines["useGPUShader4"] = std::to_string(useUBO);
         defines["getLight"] = getLightingMethod() == LightingMethod::FFP ? "gl_LightSource" : "LightBuffer";
-        defines["startLight"] =  getLightingMethod() == LightingMethod::SingleUBO ? "0" : "1";
+        defines["startLight"] =  useUBO ? "0" : "1";
         defines["endLight"] = getLightingMethod() == LightingMethod::FFP ? defines["maxLights"] : "PointLightCount";
+        defines["clusterGridX"] = std::to_string(mClusterGridX);
+        defines["clusterGridY"] = std::to_string(mClusterGridY);
+        defines["clusterGridZ"] = std::to_string(mClusterGridZ);
 
         return defines;
     }
@@ -950,6 +1016,12 @@ namespace SceneUtil
         getOrCreateStateSet()->setAttributeAndModes(mUBOManager);
     }
 
+    void LightManager::initClustered(int targetLights)
+    {
+        initSingleUBO(targetLights);
+        setLightingMethod(LightingMethod::Clustered);
+    }
+
     void LightManager::setLightingMethod(LightingMethod method)
     {
         mLightingMethod = method;
@@ -959,6 +1031,7 @@ namespace SceneUtil
             mStateSetGenerator = std::make_unique<StateSetGeneratorFFP>();
             break;
         case LightingMethod::SingleUBO:
+        case LightingMethod::Clustered:
             mStateSetGenerator = std::make_unique<StateSetGeneratorSingleUBO>();
             break;
         case LightingMethod::PerObjectUniform:
@@ -1005,6 +1078,14 @@ namespace SceneUtil
         mLights.clear();
         mLightsInViewSpace.clear();
 
+        for (auto it = mClusterBuffers.begin(); it != mClusterBuffers.end();)
+        {
+            if (!it->first.valid())
+                it = mClusterBuffers.erase(it);
+            else
+                ++it;
+        }
+
         // Do an occasional cleanup for orphaned lights.
         for (int i = 0; i < 2; ++i)
         {
@@ -1046,6 +1127,8 @@ namespace SceneUtil
 
     osg::ref_ptr<osg::StateSet> LightManager::getLightListStateSet(const LightList& lightList, size_t frameNum, const osg::RefMatrix* viewMatrix)
     {
+        std::lock_guard<std::mutex> lock(mCullMutex);
+
         if (getLightingMethod() == LightingMethod::PerObjectUniform)
         {
             mStateSetGenerator->mViewMatrix = *viewMatrix;
@@ -1087,6 +1170,55 @@ namespace SceneUtil
     }
 
     const std::vector<LightManager::LightSourceViewBound>& LightManager::getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum)
+    {
+        // the collection is only written on the first lookup by its camera, so the reference stays valid after unlocking
+        std::lock_guard<std::mutex> lock(mCullMutex);
+        return collectLightsInViewSpace(cv, viewMatrix, frameNum).mLights;
+    }
+
+    void LightManager::getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum, const osg::BoundingSphere& viewBound, LightList& lightList)
+    {
+        const LightSourceViewBoundCollection* collection;
+        {
+            std::lock_guard<std::mutex> lock(mCullMutex);
+            collection = &collectLightsInViewSpace(cv, viewMatrix, frameNum);
+        }
+        const std::vector<LightSourceViewBound>& lights = collection->mLights;
+        const LightGrid& grid = collection->mGrid;
+
+        if (!viewBound.valid())
+            return;
+
+        const CellRange range = grid.mCellSize != 0 ? getCellRange(viewBound, grid.mCellSize) : CellRange();
+        if (grid.mCellSize == 0 || range.getNumCells() > sMaxCellsPerQuery)
+        {
+            for (const LightSourceViewBound& light : lights)
+            {
+                if (light.mViewBound.intersects(viewBound))
+                    lightList.push_back(&light);
+            }
+            return;
+        }
+
+        std::vector<unsigned> candidates = grid.mLargeLights;
+        forEachCell(range, [&] (std::int64_t key)
+        {
+            auto it = std::lower_bound(grid.mCells.begin(), grid.mCells.end(), std::make_pair(key, 0u));
+            for (; it != grid.mCells.end() && it->first == key; ++it)
+                candidates.push_back(it->second);
+        });
+        // keep the order of the lights, the light lists are cached by it
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (unsigned index : candidates)
+        {
+            if (lights[index].mViewBound.intersects(viewBound))
+                lightList.push_back(&lights[index]);
+        }
+    }
+
+    const LightManager::LightSourceViewBoundCollection& LightManager::collectLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum)
     {
         osg::Camera* camera = cv->getCurrentCamera();
 
@@ -1131,23 +1263,173 @@ namespace SceneUtil
                 LightSourceViewBound l;
                 l.mLightSource = transform.mLightSource;
                 l.mViewBound = viewBound;
-                it->second.push_back(l);
+                it->second.mLights.push_back(l);
+            }
+
+            std::vector<LightSourceViewBound>& lights = it->second.mLights;
+            if (getLightingMethod() == LightingMethod::SingleUBO || getLightingMethod() == LightingMethod::Clustered)
+            {
+                if (lights.size() > static_cast<size_t>(getMaxLightsInScene() - 1))
+                {
+                    auto sorter = [] (const LightSourceViewBound& left, const LightSourceViewBound& right) {
+                        return left.mViewBound.center().length2() - left.mViewBound.radius2() < right.mViewBound.center().length2() - right.mViewBound.radius2();
+                    };
+                    std::sort(lights.begin() + 1, lights.end(), sorter);
+                    lights.erase((lights.begin() + 1) + (getMaxLightsInScene() - 2), lights.end());
+                }
+            }
+
+            if (lights.size() >= sMinLightsForGrid)
+            {
+                LightGrid& grid = it->second.mGrid;
+                float radiusSum = 0;
+                for (const LightSourceViewBound& light : lights)
+                    radiusSum += light.mViewBound.radius();
+                // cells about the size of a light, so most lights only overlap a few of them
+                grid.mCellSize = std::max(64.f, 2 * radiusSum / lights.size());
+
+                for (unsigned i = 0; i < lights.size(); ++i)
+                {
+                    const CellRange range = getCellRange(lights[i].mViewBound, grid.mCellSize);
+                    if (range.getNumCells() > sMaxCellsPerLight)
+                        grid.mLargeLights.push_back(i);
+                    else
+                        forEachCell(range, [&] (std::int64_t key) { grid.mCells.emplace_back(key, i); });
+                }
+                std::sort(grid.mCells.begin(), grid.mCells.end());
             }
         }
 
-        if (getLightingMethod() == LightingMethod::SingleUBO)
+        return it->second;
+    }
+
+    void LightManager::updateClusters(osgUtil::CullVisitor* cv, osg::StateSet& stateset)
+    {
+        const size_t frameNum = cv->getTraversalNumber();
+        const osg::RefMatrix* viewMatrix = cv->getCurrentRenderStage()->getInitialViewMatrix();
+        const osg::Matrix& projection = *cv->getProjectionMatrix();
+
+        std::lock_guard<std::mutex> lock(mCullMutex);
+
+        LightList lights;
+        for (const auto& light : collectLightsInViewSpace(cv, viewMatrix, frameNum).mLights)
+            lights.push_back(&light);
+        // clusters keep the lights closest to the camera when they exceed the light limit
+        std::sort(lights.begin(), lights.end(), sortLights);
+
+        // Each column of the texture holds one (x, y) cell of the grid. Every depth slice of a cell takes maxLights + 1
+        // rows, the first one holding the light count followed by the light buffer indices.
+        const int slotsPerCluster = getMaxLights() + 1;
+        const int width = mClusterGridX * mClusterGridY;
+        const int height = mClusterGridZ * slotsPerCluster;
+
+        ClusterBuffer& buffer = mClusterBuffers[osg::observer_ptr<osg::Camera>(cv->getCurrentCamera())][frameNum % 2];
+        if (!buffer.mImage || buffer.mImage->t() != height)
+        {
+            buffer.mImage = new osg::Image;
+            buffer.mImage->allocateImage(width, height, 1, GL_RED, GL_FLOAT);
+            buffer.mTexture = new osg::Texture2D(buffer.mImage);
+            buffer.mTexture->setInternalFormat(GL_R32F);
+            buffer.mTexture->setSourceFormat(GL_RED);
+            buffer.mTexture->setSourceType(GL_FLOAT);
+            buffer.mTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::NEAREST);
+            buffer.mTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::NEAREST);
+            buffer.mTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+            buffer.mTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+            buffer.mTexture->setResizeNonPowerOfTwoHint(false);
+        }
+
+        float* data = reinterpret_cast<float*>(buffer.mImage->data());
+        for (int z = 0; z < mClusterGridZ; ++z)
+            std::fill_n(data + z * slotsPerCluster * width, width, 0.f);
+
+        double left, right, bottom, top, zNear, zFar;
+        if (!projection.getFrustum(left, right, bottom, top, zNear, zFar) && !projection.getOrtho(left, right, bottom, top, zNear, zFar))
+        {
+            zNear = 1.0;
+            zFar = 1e5;
+        }
+        const float clusterNear = std::max(1.f, static_cast<float>(zNear));
+        const float clusterFar = std::max(clusterNear * 2.f, static_cast<float>(zFar));
+        const float sliceScale = mClusterGridZ / std::log(clusterFar / clusterNear);
+
+        const auto getSlice = [&] (float depth)
+        {
+            return std::clamp(static_cast<int>(std::log(std::max(depth, clusterNear) / clusterNear) * sliceScale), 0, mClusterGridZ - 1);
+        };
+        const auto getCell = [] (float ndc, int count)
+        {
+            return std::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * count), 0, count - 1);
+        };
+
+        auto& indexMap = getLightIndexMap(frameNum);
+        for (const LightSourceViewBound* light : lights)
         {
-            if (it->second.size() > static_cast<size_t>(getMaxLightsInScene() - 1))
+            const osg::Vec3f& center = light->mViewBound.center();
+            const float radius = light->mViewBound.radius();
+            const float nearDepth = -center.z() - radius;
+            const float farDepth = -center.z() + radius;
+            if (farDepth < 0.f)
+                continue;
+
+            int x0 = 0, x1 = mClusterGridX - 1, y0 = 0, y1 = mClusterGridY - 1;
+            if (nearDepth > clusterNear)
+            {
+                // the bounds are entirely in front of the camera, so their projected corners enclose the light on screen
+                osg::Vec2f ndcMin(1.f, 1.f);
+                osg::Vec2f ndcMax(-1.f, -1.f);
+                for (int i = 0; i < 8; ++i)
+                {
+                    const osg::Vec3f corner = center + osg::Vec3f(i & 1 ? radius : -radius, i & 2 ? radius : -radius, i & 4 ? radius : -radius);
+                    const osg::Vec3f ndc = corner * projection;
+                    ndcMin = osg::Vec2f(std::min(ndcMin.x(), ndc.x()), std::min(ndcMin.y(), ndc.y()));
+                    ndcMax = osg::Vec2f(std::max(ndcMax.x(), ndc.x()), std::max(ndcMax.y(), ndc.y()));
+                }
+                if (ndcMax.x() < -1.f || ndcMin.x() > 1.f || ndcMax.y() < -1.f || ndcMin.y() > 1.f)
+                    continue;
+                x0 = getCell(ndcMin.x(), mClusterGridX);
+                x1 = getCell(ndcMax.x(), mClusterGridX);
+                y0 = getCell(ndcMin.y(), mClusterGridY);
+                y1 = getCell(ndcMax.y(), mClusterGridY);
+            }
+
+            // the light buffer is shared by all cameras, the first camera to see a light in this frame uploads it
+            const int id = light->mLightSource->getId();
+            auto found = indexMap.find(id);
+            if (found == indexMap.end())
             {
-                auto sorter = [] (const LightSourceViewBound& left, const LightSourceViewBound& right) {
-                    return left.mViewBound.center().length2() - left.mViewBound.radius2() < right.mViewBound.center().length2() - right.mViewBound.radius2();
-                };
-                std::sort(it->second.begin() + 1, it->second.end(), sorter);
-                it->second.erase((it->second.begin() + 1) + (getMaxLightsInScene() - 2), it->second.end());
+                const int index = static_cast<int>(indexMap.size()) + 1;
+                if (index >= getMaxLightsInScene())
+                    continue;
+                updateGPUPointLight(index, light->mLightSource, frameNum, viewMatrix);
+                found = indexMap.emplace(id, index).first;
+            }
+            const float index = static_cast<float>(found->second);
+
+            for (int z = getSlice(nearDepth), z1 = getSlice(farDepth); z <= z1; ++z)
+            {
+                float* slice = data + z * slotsPerCluster * width;
+                for (int y = y0; y <= y1; ++y)
+                {
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        const int column = x + y * mClusterGridX;
+                        float& count = slice[column];
+                        if (count >= getMaxLights())
+                            continue;
+                        count += 1.f;
+                        slice[static_cast<int>(count) * width + column] = index;
+                    }
+                }
             }
         }
 
-        return it->second;
+        buffer.mImage->dirty();
+
+        stateset.setTextureAttribute(mClusterTextureUnit, buffer.mTexture, osg::StateAttribute::ON);
+        stateset.addUniform(new osg::Uniform("clusterMap", mClusterTextureUnit));
+        stateset.addUniform(new osg::Uniform("clusterProjection", osg::Matrixf(projection)));
+        stateset.addUniform(new osg::Uniform("clusterDepthRange", osg::Vec2f(clusterNear, sliceScale)));
     }
 
     void LightManager::updateGPUPointLight(int index, LightSource* lightSource, size_t frameNum,const osg::RefMatrix* viewMatrix)
@@ -1199,25 +1481,26 @@ namespace SceneUtil
 
     bool LightListCallback::pushLightState(osg::Node *node, osgUtil::CullVisitor *cv)
     {
-        if (!mLightManager)
+        LightManager* lightManager = mLightManager;
+        if (!lightManager)
         {
-            mLightManager = findLightManager(cv->getNodePath());
-            if (!mLightManager)
+            lightManager = findLightManager(cv->getNodePath());
+            if (!lightManager)
                 return false;
+            mLightManager = lightManager;
         }
 
-        if (!(cv->getTraversalMask() & mLightManager->getLightingMask()))
+        if (!(cv->getTraversalMask() & lightManager->getLightingMask()))
             return false;
 
-        // Possible optimizations:
-        // - organize lights in a quad tree
-
+        // lights are looked up per fragment from the cluster grid
+        if (lightManager->getLightingMethod() == LightingMethod::Clustered)
+            return false;
 
-        mLastFrameNumber = cv->getTraversalNumber();
+        const size_t frameNum = cv->getTraversalNumber();
 
         // Don't use Camera::getViewMatrix, that one might be relative to another camera!
         const osg::RefMatrix* viewMatrix = cv->getCurrentRenderStage()->getInitialViewMatrix();
-        const std::vector<LightManager::LightSourceViewBound>& lights = mLightManager->getLightsInViewSpace(cv, viewMatrix, mLastFrameNumber);
 
         // get the node bounds in view space
         // NB do not node->getBound() * modelView, that would apply the node's transformation twice
@@ -1233,29 +1516,23 @@ namespace SceneUtil
         osg::Matrixf mat = *cv->getModelViewMatrix();
         transformBoundingSphere(mat, nodeBound);
 
-        mLightList.clear();
-        for (size_t i = 0; i < lights.size(); ++i)
+        // local, since the same node may be culled by several cameras at once
+        LightManager::LightList lightList;
+        lightManager->getLightsInViewSpace(cv, viewMatrix, frameNum, nodeBound, lightList);
+        if (!mIgnoredLightSources.empty())
         {
-            const LightManager::LightSourceViewBound& l = lights[i];
-
-            if (mIgnoredLightSources.count(l.mLightSource))
-                continue;
-
-            if (l.mViewBound.intersects(nodeBound))
-                mLightList.push_back(&l);
+            lightList.erase(std::remove_if(lightList.begin(), lightList.end(),
+                [this] (const LightManager::LightSourceViewBound* l) { return mIgnoredLightSources.count(l->mLightSource) != 0; }),
+                lightList.end());
         }
 
-        if (!mLightList.empty())
+        if (!lightList.empty())
         {
-            size_t maxLights = mLightManager->getMaxLights() - mLightManager->getStartLight();
+            size_t maxLights = lightManager->getMaxLights() - lightManager->getStartLight();
 
-            osg::ref_ptr<osg::StateSet> stateset = nullptr;
-
-            if (mLightList.size() > maxLights)
+            if (lightList.size() > maxLights)
             {
-                LightManager::LightList lightList = mLightList;
-
-                if (mLightManager->usingFFP())
+                if (lightManager->usingFFP())
                 {
                     for (auto it = lightList.begin(); it != lightList.end() && lightList.size() > maxLights;)
                     {
@@ -1272,11 +1549,9 @@ namespace SceneUtil
                 std::sort(lightList.begin(), lightList.end(), sortLights);
                 while (lightList.size() > maxLights)
                     lightList.pop_back();
-                stateset = mLightManager->getLightListStateSet(lightList, cv->getTraversalNumber(), cv->getCurrentRenderStage()->getInitialViewMatrix());
             }
-            else
-                stateset = mLightManager->getLightListStateSet(mLightList, cv->getTraversalNumber(), cv->getCurrentRenderStage()->getInitialViewMatrix());
 
+            osg::ref_ptr<osg::StateSet> stateset = lightManager->getLightListStateSet(lightList, frameNum, viewMatrix);
 
             cv->pushStateSet(stateset);
             return true;
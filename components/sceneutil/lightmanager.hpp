@@ -5,10 +5,14 @@
 #include <unordered_map>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 
 #include <osg/Light>
 #include <osg/Group>
 #include <osg/NodeVisitor>
+#include <osg/Texture2D>
 #include <osg/observer_ptr>
 
 #include <components/shader/shadermanager.hpp>
@@ -31,6 +35,7 @@ namespace SceneUtil
         FFP,
         PerObjectUniform,
         SingleUBO,
+        Clustered,
     };
 
     /// LightSource managed by a LightManager.
@@ -167,7 +172,7 @@ namespace SceneUtil
         };
 
         using LightList = std::vector<const LightSourceViewBound*>;
-        using SupportedMethods = std::array<bool, 3>;
+        using SupportedMethods = std::array<bool, 4>;
 
         META_Node(SceneUtil, LightManager)
 
@@ -192,8 +197,16 @@ namespace SceneUtil
         /// Internal use only, called automatically by the LightSource's UpdateCallback
         void addLight(LightSource* lightSource, const osg::Matrixf& worldMat, size_t frameNum);
 
+        /// Internal use only, called by the LightManager's cull callback when using the clustered lighting method.
+        /// Assigns the lights in view to light buffer slots and bins them into the cluster grid of the current camera.
+        void updateClusters(osgUtil::CullVisitor* cv, osg::StateSet& stateset);
+
         const std::vector<LightSourceViewBound>& getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum);
 
+        /// Add the lights in view intersecting the view space bound to the list, in the same order as getLightsInViewSpace.
+        /// When there are many lights in view, only those sharing a cell of a view space grid with the bound are tested.
+        void getLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum, const osg::BoundingSphere& viewBound, LightList& lightList);
+
         osg::ref_ptr<osg::StateSet> getLightListStateSet(const LightList& lightList, size_t frameNum, const osg::RefMatrix* viewMatrix);
 
         void setSunlight(osg::ref_ptr<osg::Light> sun);
@@ -227,10 +240,14 @@ namespace SceneUtil
 
         osg::ref_ptr<osg::Uniform> generateLightBufferUniform(const osg::Matrixf& sun);
 
+        /// Guards the per frame light buffers, which are shared by the cull traversals of all cameras.
+        std::mutex& getCullMutex() { return mCullMutex; }
+
     private:
         void initFFP(int targetLights);
         void initPerObjectUniform(int targetLights);
         void initSingleUBO(int targetLights);
+        void initClustered(int targetLights);
 
         void updateSettings();
 
@@ -239,9 +256,31 @@ namespace SceneUtil
 
         void updateGPUPointLight(int index, LightSource* lightSource, size_t frameNum, const osg::RefMatrix* viewMatrix);
 
+        /// Uniform grid of the lights in view of a camera, in view space.
+        struct LightGrid
+        {
+            /// 0 when there are too few lights for the grid to be worth it
+            float mCellSize = 0;
+            /// Key of a cell and index of a light overlapping it, sorted by key
+            std::vector<std::pair<std::int64_t, unsigned>> mCells;
+            /// Lights overlapping too many cells to be put into them
+            std::vector<unsigned> mLargeLights;
+        };
+
+        struct LightSourceViewBoundCollection
+        {
+            std::vector<LightSourceViewBound> mLights;
+            LightGrid mGrid;
+        };
+
+        /// @note mCullMutex must be locked by the caller.
+        const LightSourceViewBoundCollection& collectLightsInViewSpace(osgUtil::CullVisitor* cv, const osg::RefMatrix* viewMatrix, size_t frameNum);
+
         std::vector<LightSourceTransform> mLights;
 
-        using LightSourceViewBoundCollection = std::vector<LightSourceViewBound>;
+        // cameras may be culled concurrently, see SceneUtil::RTTCullQueue
+        std::mutex mCullMutex;
+
         std::map<osg::observer_ptr<osg::Camera>, LightSourceViewBoundCollection> mLightsInViewSpace;
 
         using LightIdList = std::vector<int>;
@@ -280,10 +319,25 @@ namespace SceneUtil
 
         SupportedMethods mSupported;
 
+        // double buffered light index lists of the view space clusters, since one of them may be in use by the draw thread
+        struct ClusterBuffer
+        {
+            osg::ref_ptr<osg::Image> mImage;
+            osg::ref_ptr<osg::Texture2D> mTexture;
+        };
+        std::map<osg::observer_ptr<osg::Camera>, std::array<ClusterBuffer, 2>> mClusterBuffers;
+
         static constexpr auto mMaxLightsLowerLimit = 2;
         static constexpr auto mMaxLightsUpperLimit = 64;
         static constexpr auto mFFPMaxLights = 8;
 
+        // view space cluster grid, the depth slices are distributed exponentially between the near and far planes
+        static constexpr int mClusterGridX = 16;
+        static constexpr int mClusterGridY = 8;
+        static constexpr int mClusterGridZ = 24;
+        // texture unit of the cluster light lists, above the range used by shadow maps and not enabled for fixed function
+        static constexpr int mClusterTextureUnit = 15;
+
         static const std::unordered_map<std::string, LightingMethod> mLightingMethodSettingMap;
     };
 
@@ -294,19 +348,16 @@ namespace SceneUtil
     /// light lists can result in degraded performance. Too coarse grained light lists can result in lights no longer
     /// rendering when the size of a light list exceeds the OpenGL limit on the number of concurrent lights (8). A good
     /// starting point is to attach a LightListCallback to each game object's base node.
-    /// @note Not thread safe for CullThreadPerCamera threading mode.
     /// @note Due to lack of OSG support, the callback does not work on Drawables.
     class LightListCallback : public SceneUtil::NodeCallback<LightListCallback, osg::Node*, osgUtil::CullVisitor*>
     {
     public:
         LightListCallback()
             : mLightManager(nullptr)
-            , mLastFrameNumber(0)
         {}
         LightListCallback(const LightListCallback& copy, const osg::CopyOp& copyop)
             : osg::Object(copy, copyop), SceneUtil::NodeCallback<LightListCallback, osg::Node*, osgUtil::CullVisitor*>(copy, copyop)
-            , mLightManager(copy.mLightManager)
-            , mLastFrameNumber(0)
+            , mLightManager(copy.mLightManager.load())
             , mIgnoredLightSources(copy.mIgnoredLightSources)
         {}
 
@@ -319,9 +370,7 @@ namespace SceneUtil
         std::set<SceneUtil::LightSource*>& getIgnoredLightSources() { return mIgnoredLightSources; }
 
     private:
-        LightManager* mLightManager;
-        size_t mLastFrameNumber;
-        LightManager::LightList mLightList;
+        std::atomic<LightManager*> mLightManager;
         std::set<SceneUtil::LightSource*> mIgnoredLightSources;
     };
 
@@ -0,0 +1,254 @@
+#include "mergerig.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <osg/Geometry>
+#include <osg/TriangleIndexFunctor>
+
+#include "riggeometry.hpp"
+
+namespace SceneUtil
+{
+    namespace
+    {
+        struct CollectTriangles
+        {
+            osg::DrawElementsUShort* mElements = nullptr;
+            unsigned int mOffset = 0;
+
+            void operator()(unsigned int i1, unsigned int i2, unsigned int i3)
+            {
+                mElements->push_back(static_cast<unsigned short>(mOffset + i1));
+                mElements->push_back(static_cast<unsigned short>(mOffset + i2));
+                mElements->push_back(static_cast<unsigned short>(mOffset + i3));
+            }
+        };
+
+        /// Per-vertex arrays in a fixed order: vertices, normals, colors and the texture coordinates of each unit
+        std::vector<const osg::Array*> getArrays(const osg::Geometry& geometry)
+        {
+            std::vector<const osg::Array*> arrays {geometry.getVertexArray(), geometry.getNormalArray(), geometry.getColorArray()};
+            for (unsigned int i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+                arrays.push_back(geometry.getTexCoordArray(i));
+            while (!arrays.empty() && arrays.back() == nullptr)
+                arrays.pop_back();
+            return arrays;
+        }
+
+        bool isSupportedArray(const osg::Array& array)
+        {
+            switch (array.getType())
+            {
+                case osg::Array::Vec2ArrayType:
+                case osg::Array::Vec3ArrayType:
+                case osg::Array::Vec4ArrayType:
+                case osg::Array::Vec4ubArrayType:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        template <class ArrayType>
+        osg::ref_ptr<osg::Array> concatenate(const std::vector<const osg::Array*>& arrays)
+        {
+            osg::ref_ptr<ArrayType> result (new ArrayType);
+            for (const osg::Array* array : arrays)
+            {
+                const ArrayType& typed = static_cast<const ArrayType&>(*array);
+                result->insert(result->end(), typed.begin(), typed.end());
+            }
+            result->setNormalize(arrays.front()->getNormalize());
+            return result;
+        }
+
+        osg::ref_ptr<osg::Array> concatenate(const std::vector<const osg::Array*>& arrays)
+        {
+            switch (arrays.front()->getType())
+            {
+                case osg::Array::Vec2ArrayType:
+                    return concatenate<osg::Vec2Array>(arrays);
+                case osg::Array::Vec3ArrayType:
+                    return concatenate<osg::Vec3Array>(arrays);
+                case osg::Array::Vec4ArrayType:
+                    return concatenate<osg::Vec4Array>(arrays);
+                case osg::Array::Vec4ubArrayType:
+                    return concatenate<osg::Vec4ubArray>(arrays);
+                default:
+                    return nullptr;
+            }
+        }
+
+        bool isTriangles(const osg::PrimitiveSet& primitiveSet)
+        {
+            switch (primitiveSet.getMode())
+            {
+                case osg::PrimitiveSet::TRIANGLES:
+                case osg::PrimitiveSet::TRIANGLE_STRIP:
+                case osg::PrimitiveSet::TRIANGLE_FAN:
+                    return primitiveSet.getNumInstances() == 0;
+                default:
+                    return false;
+            }
+        }
+
+        bool isMergeable(const osg::Drawable& drawable, const osg::Geometry& source)
+        {
+            if (drawable.getUpdateCallback() != nullptr || drawable.getCullCallback() != nullptr
+                || drawable.getEventCallback() != nullptr || drawable.getDrawCallback() != nullptr)
+                return false;
+            if (drawable.getStateSet() != nullptr
+                && (drawable.getStateSet()->getRenderingHint() == osg::StateSet::TRANSPARENT_BIN
+                    || drawable.getStateSet()->getUpdateCallback() != nullptr))
+                return false;
+            if (source.getVertexArray() == nullptr || source.getNumVertexAttribArrays() > 0
+                || source.getSecondaryColorArray() != nullptr || source.getFogCoordArray() != nullptr)
+                return false;
+
+            const unsigned int numVertices = source.getVertexArray()->getNumElements();
+            for (const osg::Array* array : getArrays(source))
+            {
+                if (array == nullptr)
+                    continue;
+                if (!isSupportedArray(*array) || array->getBinding() != osg::Array::BIND_PER_VERTEX
+                    || array->getNumElements() != numVertices)
+                    return false;
+            }
+
+            for (unsigned int i = 0; i < source.getNumPrimitiveSets(); ++i)
+                if (!isTriangles(*source.getPrimitiveSet(i)))
+                    return false;
+
+            return true;
+        }
+
+        bool isSameState(const osg::StateSet* first, const osg::StateSet* second)
+        {
+            if (first == second)
+                return true;
+            if (first == nullptr || second == nullptr)
+                return false;
+            return first->compare(*second, true) == 0;
+        }
+    }
+
+    bool canMergeRigGeometries(const RigGeometry& first, const RigGeometry& second)
+    {
+        const osg::ref_ptr<osg::Geometry> firstSource = first.getSourceGeometry();
+        const osg::ref_ptr<osg::Geometry> secondSource = second.getSourceGeometry();
+        if (firstSource == nullptr || secondSource == nullptr || first.getInfluenceMap() == nullptr
+            || second.getInfluenceMap() == nullptr)
+            return false;
+        if (first.getGpuSkinning() != second.getGpuSkinning() || first.getNodeMask() != second.getNodeMask())
+            return false;
+        if (!isMergeable(first, *firstSource) || !isMergeable(second, *secondSource))
+            return false;
+        if (!isSameState(first.getStateSet(), second.getStateSet())
+            || !isSameState(firstSource->getStateSet(), secondSource->getStateSet()))
+            return false;
+
+        const std::vector<const osg::Array*> firstArrays = getArrays(*firstSource);
+        const std::vector<const osg::Array*> secondArrays = getArrays(*secondSource);
+        if (firstArrays.size() != secondArrays.size())
+            return false;
+        for (std::size_t i = 0; i < firstArrays.size(); ++i)
+        {
+            if ((firstArrays[i] == nullptr) != (secondArrays[i] == nullptr))
+                return false;
+            if (firstArrays[i] != nullptr && (firstArrays[i]->getType() != secondArrays[i]->getType()
+                                              || firstArrays[i]->getNormalize() != secondArrays[i]->getNormalize()))
+                return false;
+        }
+
+        return true;
+    }
+
+    osg::ref_ptr<RigGeometry> mergeRigGeometries(const std::vector<RigGeometry*>& rigs)
+    {
+        if (rigs.size() < 2)
+            return nullptr;
+
+        std::size_t numVertices = 0;
+        for (const RigGeometry* rig : rigs)
+            numVertices += rig->getSourceGeometry()->getVertexArray()->getNumElements();
+        // The influences index vertices with unsigned short
+        if (numVertices > static_cast<std::size_t>(std::numeric_limits<unsigned short>::max()) + 1)
+            return nullptr;
+
+        RigGeometry& first = *rigs.front();
+        const osg::ref_ptr<osg::Geometry> firstSource = first.getSourceGeometry();
+
+        osg::ref_ptr<osg::Geometry> geometry (new osg::Geometry);
+        geometry->setStateSet(firstSource->getStateSet());
+        geometry->setUseDisplayList(false);
+        geometry->setUseVertexBufferObjects(true);
+
+        const std::size_t numArrays = getArrays(*firstSource).size();
+        for (std::size_t i = 0; i < numArrays; ++i)
+        {
+            std::vector<const osg::Array*> arrays;
+            for (const RigGeometry* rig : rigs)
+                arrays.push_back(getArrays(*rig->getSourceGeometry())[i]);
+            if (arrays.front() == nullptr)
+                continue;
+
+            const osg::ref_ptr<osg::Array> array = concatenate(arrays);
+            if (i == 0)
+                geometry->setVertexArray(array);
+            else if (i == 1)
+                geometry->setNormalArray(array, osg::Array::BIND_PER_VERTEX);
+            else if (i == 2)
+                geometry->setColorArray(array, osg::Array::BIND_PER_VERTEX);
+            else
+                geometry->setTexCoordArray(static_cast<unsigned int>(i - 3), array, osg::Array::BIND_PER_VERTEX);
+        }
+
+        osg::ref_ptr<osg::DrawElementsUShort> elements (new osg::DrawElementsUShort(osg::PrimitiveSet::TRIANGLES));
+        osg::ref_ptr<RigGeometry::InfluenceMap> influences (new RigGeometry::InfluenceMap);
+        unsigned int offset = 0;
+        for (const RigGeometry* rig : rigs)
+        {
+            const osg::Geometry& source = *rig->getSourceGeometry();
+
+            osg::TriangleIndexFunctor<CollectTriangles> functor;
+            functor.mElements = elements;
+            functor.mOffset = offset;
+            for (unsigned int i = 0; i < source.getNumPrimitiveSets(); ++i)
+                source.getPrimitiveSet(i)->accept(functor);
+
+            for (const auto& [boneName, influence] : rig->getInfluenceMap()->mData)
+            {
+                auto found = std::find_if(influences->mData.begin(), influences->mData.end(),
+                    [&boneName = boneName, &influence = influence] (const auto& v)
+                    { return v.first == boneName && v.second.mInvBindMatrix == influence.mInvBindMatrix; });
+                if (found == influences->mData.end())
+                {
+                    influences->mData.emplace_back(boneName, RigGeometry::BoneInfluence());
+                    found = influences->mData.end() - 1;
+                    found->second.mInvBindMatrix = influence.mInvBindMatrix;
+                    found->second.mBoundSphere = influence.mBoundSphere;
+                }
+                else
+                    found->second.mBoundSphere.expandBy(influence.mBoundSphere);
+
+                for (const auto& [vertex, weight] : influence.mWeights)
+                    found->second.mWeights.emplace_back(static_cast<unsigned short>(offset + vertex), weight);
+            }
+
+            offset += source.getVertexArray()->getNumElements();
+        }
+        geometry->addPrimitiveSet(elements);
+
+        osg::ref_ptr<RigGeometry> result (new RigGeometry);
+        result->setName(first.getName());
+        result->setNodeMask(first.getNodeMask());
+        result->setStateSet(first.getStateSet());
+        result->setInfluenceMap(influences);
+        result->setSourceGeometry(geometry);
+        if (first.getGpuSkinning() && !result->setGpuSkinning(true))
+            return nullptr;
+
+        return result;
+    }
+}
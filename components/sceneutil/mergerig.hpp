@@ -0,0 +1,25 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_MERGERIG_H
+#define OPENMW_COMPONENTS_SCENEUTIL_MERGERIG_H
+
+#include <osg/ref_ptr>
+
+#include <vector>
+
+namespace SceneUtil
+{
+    class RigGeometry;
+
+    /// Can the two skinned drawables be drawn as one? They need the same state, vertex layout and skinning method,
+    /// no callbacks and only triangles. Transparent drawables are never merged, their draw order would be lost.
+    /// @note Does not check the number of vertices or bones of the result, mergeRigGeometries does.
+    bool canMergeRigGeometries(const RigGeometry& first, const RigGeometry& second);
+
+    /// Combine skinned drawables of the same skeleton into a single one with all their vertices and influences.
+    /// Influences of the same bone with the same bind matrix are combined.
+    /// @param rigs drawables that can be merged with the first one, see canMergeRigGeometries
+    /// @return nullptr when there are less than two drawables, more vertices than the influences can index,
+    /// or when the inputs are skinned on the GPU and the result has too many bones for that.
+    osg::ref_ptr<RigGeometry> mergeRigGeometries(const std::vector<RigGeometry*>& rigs);
+}
+
+#endif
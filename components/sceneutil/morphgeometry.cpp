@@ -5,6 +5,8 @@
 
 #include <osg/Version>
 
+#include "vertexupdate.hpp"
+
 namespace SceneUtil
 {
 
@@ -47,6 +49,7 @@ void MorphGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeom)
         to.setSupportsDisplayList(false);
         to.setUseVertexBufferObjects(true);
         to.setCullingActive(false); // make sure to disable culling since that's handled by this class
+        to.setDrawCallback(new VertexUpdateCallback);
 
         // vertices are modified every frame, so we need to deep copy them.
         // assign a dedicated VBO to make sure that modifications don't interfere with source geometry's VBO.
@@ -98,7 +101,9 @@ void MorphGeometry::accept(osg::NodeVisitor &nv)
 
 void MorphGeometry::accept(osg::PrimitiveFunctor& func) const
 {
-    getGeometry(mLastFrameNumber)->accept(func);
+    const osg::Geometry* geom = getGeometry(mLastFrameNumber);
+    static_cast<const VertexUpdateCallback*>(geom->getDrawCallback())->wait();
+    geom->accept(func);
 }
 
 osg::BoundingBox MorphGeometry::computeBoundingBox() const
@@ -158,6 +163,7 @@ osg::BoundingBox MorphGeometry::computeBoundingBox() const
 
 void MorphGeometry::cull(osg::NodeVisitor *nv)
 {
+    std::lock_guard<std::mutex> lock(mCullMutex);
     if (mLastFrameNumber == nv->getTraversalNumber() || !mDirty || mMorphTargets.size() == 0)
     {
         osg::Geometry& geom = *getGeometry(mLastFrameNumber);
@@ -171,22 +177,31 @@ void MorphGeometry::cull(osg::NodeVisitor *nv)
     mLastFrameNumber = nv->getTraversalNumber();
     osg::Geometry& geom = *getGeometry(mLastFrameNumber);
 
-    const osg::Vec3Array* positionSrc = mMorphTargets[0].getOffsets();
-    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
-    assert(positionSrc->size() == positionDst->size());
-    for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
-        (*positionDst)[vertex] = (*positionSrc)[vertex];
-
+    // The weights are animated by the update traversal, so the update gets a copy of them
+    std::vector<std::pair<osg::ref_ptr<const osg::Vec3Array>, float>> offsets;
     for (unsigned int i=1; i<mMorphTargets.size(); ++i)
     {
         float weight = mMorphTargets[i].getWeight();
-        if (weight == 0.f)
-            continue;
-        const osg::Vec3Array* offsets = mMorphTargets[i].getOffsets();
-        for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
-            (*positionDst)[vertex] += (*offsets)[vertex] * weight;
+        if (weight != 0.f)
+            offsets.emplace_back(mMorphTargets[i].getOffsets(), weight);
     }
 
+    osg::ref_ptr<const osg::Vec3Array> positionSrc = mMorphTargets[0].getOffsets();
+    osg::ref_ptr<osg::Vec3Array> positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
+    assert(positionSrc->size() == positionDst->size());
+    static_cast<VertexUpdateCallback*>(geom.getDrawCallback())->run([positionSrc, positionDst, offsets = std::move(offsets)]
+    {
+        for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
+            (*positionDst)[vertex] = (*positionSrc)[vertex];
+
+        for (const auto& [offset, weight] : offsets)
+        {
+            for (unsigned int vertex=0; vertex<positionSrc->size(); ++vertex)
+                (*positionDst)[vertex] += (*offset)[vertex] * weight;
+        }
+    });
+
+    // The array is uploaded when drawing, which waits for the update
     positionDst->dirty();
 
 #if OSG_MIN_VERSION_REQUIRED(3, 5, 10)
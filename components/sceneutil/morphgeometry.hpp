@@ -3,6 +3,8 @@
 
 #include <osg/Geometry>
 
+#include <mutex>
+
 namespace SceneUtil
 {
 
@@ -78,6 +80,9 @@ namespace SceneUtil
         unsigned int mLastFrameNumber;
         bool mDirty; // Have any morph targets changed?
 
+        // the same geometry may be culled by several cameras at once
+        std::mutex mCullMutex;
+
         mutable bool mMorphedBoundingBox;
     };
 
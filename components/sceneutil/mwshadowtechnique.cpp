@@ -24,9 +24,11 @@
 #include <osg/io_utils>
 #include <osg/Depth>
 #include <osg/ClipControl>
+#include <osg/FrameBufferObject>
 
 #include <sstream>
 
+#include "riggeometry.hpp"
 #include "shadowsbin.hpp"
 
 namespace {
@@ -244,12 +246,57 @@ class VDSMCameraCullCallback : public osg::NodeCallback
         osg::RefMatrix* getProjectionMatrix() { return _projectionMatrix.get(); }
         osgUtil::RenderStage* getRenderStage() { return _renderStage.get(); }
 
+        /// Drawable added to the camera before the shadow casters, e.g. to restore cached depth
+        void setInitialDrawable(osg::Drawable* drawable) { _initialDrawable = drawable; }
+
     protected:
 
         MWShadowTechnique*                      _vdsm;
         osg::ref_ptr<osg::RefMatrix>            _projectionMatrix;
         osg::ref_ptr<osgUtil::RenderStage>      _renderStage;
         osg::Polytope                           _polytope;
+        osg::ref_ptr<osg::Drawable>             _initialDrawable;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// StaticDepthCopy
+//
+// Copies the cached depth of the static shadow casters into the shadow map the dynamic casters are drawn into
+class StaticDepthCopy : public osg::Drawable
+{
+    public:
+
+        StaticDepthCopy(osg::FrameBufferObject* source, int width, int height):
+            _source(source),
+            _width(width),
+            _height(height)
+        {
+            setCullingActive(false);
+            setSupportsDisplayList(false);
+            // draw before the casters
+            getOrCreateStateSet()->setRenderBinDetails(-100, "RenderBin");
+        }
+
+        void drawImplementation(osg::RenderInfo& renderInfo) const override
+        {
+            osg::State& state = *renderInfo.getState();
+            osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+            if (!ext->isFrameBufferObjectSupported || !ext->glBlitFramebuffer)
+                return;
+
+            GLint drawFramebuffer = 0;
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING_EXT, &drawFramebuffer);
+            _source->apply(state, osg::FrameBufferObject::READ_FRAMEBUFFER);
+            ext->glBlitFramebuffer(0, 0, _width, _height, 0, 0, _width, _height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            ext->glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, drawFramebuffer);
+        }
+
+    protected:
+
+        osg::ref_ptr<osg::FrameBufferObject>    _source;
+        int                                     _width;
+        int                                     _height;
 };
 
 VDSMCameraCullCallback::VDSMCameraCullCallback(MWShadowTechnique* vdsm, osg::Polytope& polytope):
@@ -276,6 +323,9 @@ void VDSMCameraCullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
         cv->pushCullingSet();
     }
 #endif
+    if (_initialDrawable)
+        _initialDrawable->accept(*cv);
+
     // bin has to go inside camera cull or the rendertexture stage will override it
     cv->pushStateSet(_vdsm->getOrCreateShadowsBinStateSet());
     if (_vdsm->getShadowedScene())
@@ -624,6 +674,29 @@ void MWShadowTechnique::ShadowData::releaseGLObjects(osg::State* state) const
     OSG_INFO<<"MWShadowTechnique::ShadowData::releaseGLObjects"<<std::endl;
     _texture->releaseGLObjects(state);
     _camera->releaseGLObjects(state);
+    if (_staticCamera)
+    {
+        _staticTexture->releaseGLObjects(state);
+        _staticCamera->releaseGLObjects(state);
+        _staticDepthCopy->releaseGLObjects(state);
+    }
+}
+
+void MWShadowTechnique::ShadowData::createStaticCache()
+{
+    _staticTexture = new osg::Texture2D(*_texture, osg::CopyOp::SHALLOW_COPY);
+
+    _staticCamera = new osg::Camera(*_camera, osg::CopyOp::SHALLOW_COPY);
+    _staticCamera->setName("StaticShadowCamera");
+    _staticCamera->setCullCallback(nullptr);
+    _staticCamera->setRenderingCache(nullptr);
+    // render before the camera of the dynamic casters
+    _staticCamera->setRenderOrder(osg::Camera::PRE_RENDER, -1);
+    _staticCamera->attach(osg::Camera::DEPTH_BUFFER, _staticTexture.get());
+
+    osg::ref_ptr<osg::FrameBufferObject> fbo = new osg::FrameBufferObject;
+    fbo->setAttachment(osg::Camera::DEPTH_BUFFER, osg::FrameBufferAttachment(_staticTexture.get()));
+    _staticDepthCopy = new StaticDepthCopy(fbo, _texture->getTextureWidth(), _texture->getTextureHeight());
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -798,6 +871,9 @@ MWShadowTechnique::MWShadowTechnique(const MWShadowTechnique& vdsm, const osg::C
     _shadowRecievingPlaceholderStateSet = new osg::StateSet;
     _enableShadows = vdsm._enableShadows;
     mSetDummyStateWhenDisabled = vdsm.mSetDummyStateWhenDisabled;
+    _useStaticShadowCache = vdsm._useStaticShadowCache;
+    _staticCastingMask = vdsm._staticCastingMask;
+    _staticCacheAngleCos = vdsm._staticCacheAngleCos;
 }
 
 MWShadowTechnique::~MWShadowTechnique()
@@ -871,6 +947,19 @@ void SceneUtil::MWShadowTechnique::setShadowFadeStart(float shadowFadeStart)
     _shadowFadeStart = shadowFadeStart;
 }
 
+void SceneUtil::MWShadowTechnique::enableStaticShadowCache(unsigned int staticCastingMask, float angleThreshold)
+{
+    _useStaticShadowCache = true;
+    _staticCastingMask = staticCastingMask;
+    _staticCacheAngleCos = std::cos(osg::DegreesToRadians(static_cast<double>(angleThreshold)));
+    dirtyStaticShadowCache();
+}
+
+void SceneUtil::MWShadowTechnique::disableStaticShadowCache()
+{
+    _useStaticShadowCache = false;
+}
+
 void SceneUtil::MWShadowTechnique::enableFrontFaceCulling()
 {
     _useFrontFaceCulling = true;
@@ -897,13 +986,17 @@ void SceneUtil::MWShadowTechnique::setupCastingShader(Shader::ShaderManager & sh
 {
     // This can't be part of the constructor as OSG mandates that there be a trivial constructor available
 
-    osg::ref_ptr<osg::Shader> castingVertexShader = shaderManager.getShader("shadowcasting_vertex.glsl", {}, osg::Shader::VERTEX);
+    osg::ref_ptr<osg::Shader> castingVertexShader = shaderManager.getShader("shadowcasting_vertex.glsl", { {"maxBones", std::to_string(RigGeometry::sMaxGpuSkinningBones)} }, osg::Shader::VERTEX);
     osg::ref_ptr<osg::GLExtensions> exts = osg::GLExtensions::Get(0, false);
     std::string useGPUShader4 = exts && exts->isGpuShader4Supported ? "1" : "0";
     for (int alphaFunc = GL_NEVER; alphaFunc <= GL_ALWAYS; ++alphaFunc)
     {
         auto& program = _castingPrograms[alphaFunc - GL_NEVER];
         program = new osg::Program();
+        program->addBindAttribLocation("aOffset", 6);
+        program->addBindAttribLocation("aRotation", 7);
+        program->addBindAttribLocation("aBoneIndices", 4);
+        program->addBindAttribLocation("aBoneWeights", 5);
         program->addShader(castingVertexShader);
         program->addShader(shaderManager.getShader("shadowcasting_fragment.glsl", { {"alphaFunc", std::to_string(alphaFunc)},
                                                                                     {"alphaToCoverage", "0"},
@@ -1384,19 +1477,44 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
             else
                 cropShadowCameraToMainFrustum(frustum, camera, reducedNear, reducedFar, extraPlanes);
 
+            const bool useStaticCache = _useStaticShadowCache && !settings->getDebugDraw();
+            if (useStaticCache)
+                updateStaticShadowCache(*sd);
+
             osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback = new VDSMCameraCullCallback(this, local_polytope);
             camera->setCullCallback(vdsmCallback.get());
+            if (useStaticCache)
+                vdsmCallback->setInitialDrawable(sd->_staticDepthCopy);
+            // the cached depth replaces the whole shadow map, so there is nothing to clear
+            camera->setClearMask(useStaticCache ? 0 : GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
             // 4.3 traverse RTT camera
             //
 
             cv.pushStateSet(_shadowCastingStateSet.get());
 
-            cullShadowCastingScene(&cv, camera.get());
+            if (useStaticCache && sd->_staticDirty)
+            {
+                // The cached area is larger than the one needed this frame, so cull against the whole shadow map and
+                // keep the casters between the light and the near plane, which are depth clamped.
+                osg::Polytope staticPolytope;
+                for (osg::Plane plane : { osg::Plane(1.0, 0.0, 0.0, 1.0), osg::Plane(-1.0, 0.0, 0.0, 1.0), osg::Plane(0.0, 1.0, 0.0, 1.0), osg::Plane(0.0, -1.0, 0.0, 1.0) })
+                {
+                    plane.transformProvidingInverse(sd->_staticProjectionMatrix);
+                    staticPolytope.add(plane);
+                }
+                staticPolytope.setupMask();
+
+                sd->_staticCamera->setCullCallback(new VDSMCameraCullCallback(this, staticPolytope));
+                cullShadowCastingScene(&cv, sd->_staticCamera.get(), _staticCastingMask);
+                sd->_staticDirty = false;
+            }
+
+            cullShadowCastingScene(&cv, camera.get(), useStaticCache ? ~_staticCastingMask : ~0u);
 
             cv.popStateSet();
 
-            if (!orthographicViewFrustum && settings->getShadowMapProjectionHint()==ShadowSettings::PERSPECTIVE_SHADOW_MAP)
+            if (!useStaticCache && !orthographicViewFrustum && settings->getShadowMapProjectionHint()==ShadowSettings::PERSPECTIVE_SHADOW_MAP)
             {
                 {
                     osg::Matrix validRegionMatrix = cv.getCurrentCamera()->getInverseViewMatrix() *  camera->getViewMatrix() * camera->getProjectionMatrix();
@@ -1648,6 +1766,8 @@ void MWShadowTechnique::createShaders()
     _shadowCastingStateSet->setTextureAttributeAndModes(0, _fallbackBaseTexture.get(), osg::StateAttribute::ON);
     _shadowCastingStateSet->addUniform(new osg::Uniform("useDiffuseMapForShadowAlpha", true));
     _shadowCastingStateSet->addUniform(new osg::Uniform("alphaTestShadows", false));
+    _shadowCastingStateSet->addUniform(new osg::Uniform("useInstancing", false));
+    _shadowCastingStateSet->addUniform(new osg::Uniform("useSkinning", false));
     osg::ref_ptr<osg::Depth> depth = new osg::Depth;
     depth->setWriteMask(true);
     osg::ref_ptr<osg::ClipControl> clipcontrol = new osg::ClipControl(osg::ClipControl::LOWER_LEFT, osg::ClipControl::NEGATIVE_ONE_TO_ONE);
@@ -3024,14 +3144,14 @@ void MWShadowTechnique::cullShadowReceivingScene(osgUtil::CullVisitor* cv) const
     return;
 }
 
-void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera) const
+void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera, unsigned int castsShadowMask) const
 {
     OSG_INFO<<"cullShadowCastingScene()"<<std::endl;
 
     // record the traversal mask on entry so we can reapply it later.
     unsigned int traversalMask = cv->getTraversalMask();
 
-    cv->setTraversalMask( traversalMask & _shadowedScene->getShadowSettings()->getCastsShadowTraversalMask() );
+    cv->setTraversalMask( traversalMask & _shadowedScene->getShadowSettings()->getCastsShadowTraversalMask() & castsShadowMask );
 
         if (camera) camera->accept(*cv);
 
@@ -3040,6 +3160,52 @@ void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Ca
     return;
 }
 
+void MWShadowTechnique::updateStaticShadowCache(ShadowData& sd) const
+{
+    // fraction of the shadow map the area needed this frame may move into before the static casters are rendered again
+    static constexpr double margin = 0.25;
+
+    if (!sd._staticCamera)
+        sd.createStaticCache();
+
+    osg::Camera& camera = *sd._camera;
+    const osg::Matrixd viewMatrix = camera.getViewMatrix();
+    const osg::Matrixd projectionMatrix = camera.getProjectionMatrix();
+
+    bool valid = sd._staticGeneration == _staticCacheGeneration;
+    if (valid)
+    {
+        const osg::Vec3d cachedLightDir(sd._staticViewMatrix(0,2), sd._staticViewMatrix(1,2), sd._staticViewMatrix(2,2));
+        const osg::Vec3d lightDir(viewMatrix(0,2), viewMatrix(1,2), viewMatrix(2,2));
+        valid = cachedLightDir * lightDir >= _staticCacheAngleCos;
+    }
+    if (valid)
+    {
+        // the needed area has to be inside the cached one without leaving most of the cached resolution unused
+        const osg::Matrixd toCached = osg::Matrixd::inverse(viewMatrix * projectionMatrix) * sd._staticViewMatrix * sd._staticProjectionMatrix;
+        osg::BoundingBoxd bounds;
+        for (unsigned int i = 0; i < 8; ++i)
+            bounds.expandBy(osg::Vec3d(i & 1 ? 1.0 : -1.0, i & 2 ? 1.0 : -1.0, i & 4 ? 1.0 : -1.0) * toCached);
+        const double minSize = 2.0 / ((1.0 + margin) * (1.0 + margin));
+        valid = bounds.xMin() >= -1.0 && bounds.xMax() <= 1.0 && bounds.yMin() >= -1.0 && bounds.yMax() <= 1.0
+            && bounds.zMin() >= -1.0 && bounds.zMax() <= 1.0
+            && bounds.xMax() - bounds.xMin() >= minSize && bounds.yMax() - bounds.yMin() >= minSize;
+    }
+
+    if (!valid)
+    {
+        sd._staticViewMatrix = viewMatrix;
+        sd._staticProjectionMatrix = projectionMatrix * osg::Matrixd::scale(osg::Vec3d(1.0, 1.0, 1.0) / (1.0 + margin));
+        sd._staticGeneration = _staticCacheGeneration;
+        sd._staticDirty = true;
+        sd._staticCamera->setViewMatrix(sd._staticViewMatrix);
+        sd._staticCamera->setProjectionMatrix(sd._staticProjectionMatrix);
+    }
+
+    camera.setViewMatrix(sd._staticViewMatrix);
+    camera.setProjectionMatrix(sd._staticProjectionMatrix);
+}
+
 osg::StateSet* MWShadowTechnique::prepareStateSetForRenderingShadow(ViewDependentData& vdd, unsigned int traversalNumber) const
 {
     OSG_INFO<<"   prepareStateSetForRenderingShadow() "<<vdd.getStateSet(traversalNumber)<<std::endl;
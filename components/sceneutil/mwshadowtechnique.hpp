@@ -20,10 +20,12 @@
 #define COMPONENTS_SCENEUTIL_MWSHADOWTECHNIQUE_H 1
 
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <string>
 
 #include <osg/Camera>
+#include <osg/Drawable>
 #include <osg/Material>
 #include <osg/MatrixTransform>
 #include <osg/LightSource>
@@ -81,6 +83,16 @@ namespace SceneUtil {
 
         virtual void setShadowFadeStart(float shadowFadeStart);
 
+        /** Keep the depth of the static casters selected by staticCastingMask per shadow map, and only render them again when the
+         * light direction turns by more than angleThreshold degrees or the shadow map moves past its cached margin. The remaining
+         * casters are drawn on top of the cached depth every frame. Disables perspective shadow map warping.*/
+        virtual void enableStaticShadowCache(unsigned int staticCastingMask, float angleThreshold);
+
+        virtual void disableStaticShadowCache();
+
+        /** Render the static casters again, e.g. because static objects were added or removed. */
+        void dirtyStaticShadowCache() { ++_staticCacheGeneration; }
+
         virtual void enableFrontFaceCulling();
 
         virtual void disableFrontFaceCulling();
@@ -177,6 +189,17 @@ namespace SceneUtil {
             osg::ref_ptr<osg::Texture2D>        _texture;
             osg::ref_ptr<osg::TexGen>           _texgen;
             osg::ref_ptr<osg::Camera>           _camera;
+
+            // static caster cache, see enableStaticShadowCache
+            void createStaticCache();
+
+            osg::ref_ptr<osg::Texture2D>        _staticTexture;
+            osg::ref_ptr<osg::Camera>           _staticCamera;
+            osg::ref_ptr<osg::Drawable>         _staticDepthCopy;
+            osg::Matrixd                        _staticViewMatrix;
+            osg::Matrixd                        _staticProjectionMatrix;
+            unsigned int                        _staticGeneration = ~0u;
+            bool                                _staticDirty = true;
         };
 
         typedef std::list< osg::ref_ptr<ShadowData> > ShadowDataList;
@@ -230,7 +253,10 @@ namespace SceneUtil {
 
         virtual void cullShadowReceivingScene(osgUtil::CullVisitor* cv) const;
 
-        virtual void cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera) const;
+        virtual void cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera, unsigned int castsShadowMask = ~0u) const;
+
+        /** Freeze the shadow camera to the cached static caster matrices, or start a new cache if they no longer cover its area.*/
+        virtual void updateStaticShadowCache(ShadowData& sd) const;
 
         virtual osg::StateSet* prepareStateSetForRenderingShadow(ViewDependentData& vdd, unsigned int traversalNumber) const;
 
@@ -273,6 +299,11 @@ namespace SceneUtil {
 
         unsigned int                            _worldMask = ~0u;
 
+        bool                                    _useStaticShadowCache = false;
+        unsigned int                            _staticCastingMask = 0;
+        double                                  _staticCacheAngleCos = 1.0;
+        std::atomic<unsigned int>               _staticCacheGeneration {0};
+
         class DebugHUD final : public osg::Referenced
         {
         public:
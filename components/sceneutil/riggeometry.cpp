@@ -8,6 +8,7 @@
 
 #include "skeleton.hpp"
 #include "util.hpp"
+#include "vertexupdate.hpp"
 
 namespace
 {
@@ -38,7 +39,8 @@ namespace SceneUtil
 {
 
 RigGeometry::RigGeometry()
-    : mSkeleton(nullptr)
+    : mGpuSkinning(false)
+    , mSkeleton(nullptr)
     , mLastFrameNumber(0)
     , mBoundsFirstFrame(true)
 {
@@ -48,6 +50,9 @@ RigGeometry::RigGeometry()
 
 RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
     : Drawable(copy, copyop)
+    , mGpuSkinning(copy.mGpuSkinning)
+    , mBoneIndices(copy.mBoneIndices)
+    , mBoneWeights(copy.mBoneWeights)
     , mSkeleton(nullptr)
     , mInfluenceMap(copy.mInfluenceMap)
     , mBone2VertexVector(copy.mBone2VertexVector)
@@ -62,10 +67,45 @@ RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
 void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
 {
     for (unsigned int i=0; i<2; ++i)
+    {
         mGeometry[i] = nullptr;
+        mBoneMatrices[i] = nullptr;
+    }
 
     mSourceGeometry = sourceGeometry;
 
+    if (mGpuSkinning)
+    {
+        mSourceTangents = nullptr;
+        for (unsigned int i=0; i<2; ++i)
+        {
+            const osg::Geometry& from = *sourceGeometry;
+
+            // All arrays are shared with the source geometry, only the bone matrices are updated every frame.
+            mGeometry[i] = new osg::Geometry(from, osg::CopyOp::SHALLOW_COPY);
+            mGeometry[i]->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(mSourceGeometry));
+
+            osg::Geometry& to = *mGeometry[i];
+            to.setSupportsDisplayList(false);
+            to.setUseVertexBufferObjects(true);
+            to.setCullingActive(false); // make sure to disable culling since that's handled by this class
+            to.setComputeBoundingBoxCallback(new CopyBoundingBoxCallback());
+            to.setComputeBoundingSphereCallback(new CopyBoundingSphereCallback());
+            // Locations 4 and 5 alias the unused secondary color and fog coordinate arrays on drivers following
+            // NVIDIA's attribute aliasing, and do not collide with the instancing attributes of the shadow shader
+            to.setVertexAttribArray(4, mBoneIndices, osg::Array::BIND_PER_VERTEX);
+            to.setVertexAttribArray(5, mBoneWeights, osg::Array::BIND_PER_VERTEX);
+
+            // The uniforms are double buffered together with the geometry
+            osg::ref_ptr<osg::StateSet> stateset = from.getStateSet() ? new osg::StateSet(*from.getStateSet(), osg::CopyOp::SHALLOW_COPY) : new osg::StateSet;
+            mBoneMatrices[i] = new osg::Uniform(osg::Uniform::FLOAT_MAT4, "boneMatrices", mInfluenceMap->mData.size());
+            stateset->addUniform(mBoneMatrices[i]);
+            stateset->addUniform(new osg::Uniform("useSkinning", true));
+            to.setStateSet(stateset);
+        }
+        return;
+    }
+
     for (unsigned int i=0; i<2; ++i)
     {
         const osg::Geometry& from = *sourceGeometry;
@@ -83,6 +123,7 @@ void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
         to.setCullingActive(false); // make sure to disable culling since that's handled by this class
         to.setComputeBoundingBoxCallback(new CopyBoundingBoxCallback());
         to.setComputeBoundingSphereCallback(new CopyBoundingSphereCallback());
+        to.setDrawCallback(new VertexUpdateCallback);
 
         // vertices and normals are modified every frame, so we need to deep copy them.
         // assign a dedicated VBO to make sure that modifications don't interfere with source geometry's VBO.
@@ -123,6 +164,52 @@ osg::ref_ptr<osg::Geometry> RigGeometry::getSourceGeometry() const
     return mSourceGeometry;
 }
 
+bool RigGeometry::setGpuSkinning(bool enabled)
+{
+    if (enabled && !mBoneIndices && !createGpuSkinningArrays())
+        enabled = false;
+    if (enabled == mGpuSkinning)
+        return enabled;
+    mGpuSkinning = enabled;
+    if (mSourceGeometry)
+        setSourceGeometry(mSourceGeometry);
+    return enabled;
+}
+
+bool RigGeometry::createGpuSkinningArrays()
+{
+    if (!mSourceGeometry || !mSourceGeometry->getVertexArray() || !mInfluenceMap)
+        return false;
+    if (mInfluenceMap->mData.empty() || mInfluenceMap->mData.size() > sMaxGpuSkinningBones)
+        return false;
+
+    const unsigned int numVertices = mSourceGeometry->getVertexArray()->getNumElements();
+    osg::ref_ptr<osg::Vec4Array> indices (new osg::Vec4Array(numVertices));
+    osg::ref_ptr<osg::Vec4Array> weights (new osg::Vec4Array(numVertices));
+    std::vector<unsigned char> numInfluences(numVertices, 0);
+    for (std::size_t bone = 0; bone < mInfluenceMap->mData.size(); ++bone)
+    {
+        for (const auto& [vertex, weight] : mInfluenceMap->mData[bone].second.mWeights)
+        {
+            if (vertex >= numVertices)
+                continue;
+            unsigned char& influence = numInfluences[vertex];
+            if (influence == 4)
+                return false;
+            (*indices)[vertex][influence] = static_cast<float>(bone);
+            (*weights)[vertex][influence] = weight;
+            ++influence;
+        }
+    }
+
+    osg::ref_ptr<osg::VertexBufferObject> vbo (new osg::VertexBufferObject);
+    indices->setVertexBufferObject(vbo);
+    weights->setVertexBufferObject(vbo);
+    mBoneIndices = indices;
+    mBoneWeights = weights;
+    return true;
+}
+
 bool RigGeometry::initFromParentSkeleton(osg::NodeVisitor* nv)
 {
     const osg::NodePath& path = nv->getNodePath();
@@ -195,6 +282,7 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
             return;
     }
 
+    std::lock_guard<std::mutex> lock(mCullMutex);
     unsigned int traversalNumber = nv->getTraversalNumber();
     if (mLastFrameNumber == traversalNumber || (mLastFrameNumber != 0 && !mSkeleton->getActive()))
     {
@@ -209,15 +297,34 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
 
     mSkeleton->updateBoneMatrices(traversalNumber);
 
-    // skinning
-    const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
-    const osg::Vec3Array* normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
-    const osg::Vec4Array* tangentSrc = mSourceTangents;
+    if (mGpuSkinning)
+    {
+        osg::Uniform& boneMatrices = *mBoneMatrices[mLastFrameNumber%2];
+        for (std::size_t i = 0; i < mInfluenceMap->mData.size(); ++i)
+        {
+            // Missing bones do not contribute, like on the CPU
+            osg::Matrixf matrix (0, 0, 0, 0,
+                                 0, 0, 0, 0,
+                                 0, 0, 0, 0,
+                                 0, 0, 0, 0);
+            if (Bone* bone = mBoneNodesVector[i])
+            {
+                matrix = mInfluenceMap->mData[i].second.mInvBindMatrix * bone->mMatrixInSkeletonSpace;
+                if (mGeomToSkelMatrix)
+                    matrix *= (*mGeomToSkelMatrix);
+            }
+            boneMatrices.setElement(i, matrix);
+        }
 
-    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
-    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
-    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
+        nv->pushOntoNodePath(&geom);
+        nv->apply(geom);
+        nv->popFromNodePath();
+        return;
+    }
 
+    // Bone matrices are combined here, the skeleton is not safe to access from the update
+    std::vector<osg::Matrixf> matrices;
+    matrices.reserve(mBone2VertexVector->mData.size());
     int index = mBoneSphereVector->mData.size();
     for (auto &pair : mBone2VertexVector->mData)
     {
@@ -239,21 +346,40 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
         if (mGeomToSkelMatrix)
             resultMat *= (*mGeomToSkelMatrix);
 
-        for (auto &vertex : pair.second)
-        {
-            (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
-            if (normalDst)
-                (*normalDst)[vertex] = osg::Matrixf::transform3x3((*normalSrc)[vertex], resultMat);
+        matrices.push_back(resultMat);
+    }
+
+    // skinning
+    osg::ref_ptr<const osg::Vec3Array> positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
+    osg::ref_ptr<const osg::Vec3Array> normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
+    osg::ref_ptr<const osg::Vec4Array> tangentSrc = mSourceTangents;
+
+    osg::ref_ptr<osg::Vec3Array> positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
+    osg::ref_ptr<osg::Vec3Array> normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
+    osg::ref_ptr<osg::Vec4Array> tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
 
-            if (tangentDst)
+    static_cast<VertexUpdateCallback*>(geom.getDrawCallback())->run([=, bone2Vertex = osg::ref_ptr<const Bone2VertexVector>(mBone2VertexVector), matrices = std::move(matrices)]
+    {
+        for (std::size_t i = 0; i < matrices.size(); ++i)
+        {
+            const osg::Matrixf& resultMat = matrices[i];
+            for (auto &vertex : bone2Vertex->mData[i].second)
             {
-                const osg::Vec4f& srcTangent = (*tangentSrc)[vertex];
-                osg::Vec3f transformedTangent = osg::Matrixf::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
-                (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
+                (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
+                if (normalDst)
+                    (*normalDst)[vertex] = osg::Matrixf::transform3x3((*normalSrc)[vertex], resultMat);
+
+                if (tangentDst)
+                {
+                    const osg::Vec4f& srcTangent = (*tangentSrc)[vertex];
+                    osg::Vec3f transformedTangent = osg::Matrixf::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
+                    (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
+                }
             }
         }
-    }
+    });
 
+    // The arrays are uploaded when drawing, which waits for the update
     positionDst->dirty();
     if (normalDst)
         normalDst->dirty();
@@ -381,6 +507,15 @@ void RigGeometry::setInfluenceMap(osg::ref_ptr<InfluenceMap> influenceMap)
 
     mBone2VertexVector->mData.reserve(bone2VertexMap.size());
     mBone2VertexVector->mData.assign(bone2VertexMap.begin(), bone2VertexMap.end());
+
+    mBoneIndices = nullptr;
+    mBoneWeights = nullptr;
+    if (mGpuSkinning)
+    {
+        mGpuSkinning = createGpuSkinningArrays();
+        if (mSourceGeometry)
+            setSourceGeometry(mSourceGeometry);
+    }
 }
 
 void RigGeometry::accept(osg::NodeVisitor &nv)
@@ -402,7 +537,10 @@ void RigGeometry::accept(osg::NodeVisitor &nv)
 
 void RigGeometry::accept(osg::PrimitiveFunctor& func) const
 {
-    getGeometry(mLastFrameNumber)->accept(func);
+    const osg::Geometry* geom = getGeometry(mLastFrameNumber);
+    if (const auto* callback = static_cast<const VertexUpdateCallback*>(geom->getDrawCallback()))
+        callback->wait();
+    geom->accept(func);
 }
 
 osg::Geometry* RigGeometry::getGeometry(unsigned int frame) const
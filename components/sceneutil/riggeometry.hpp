@@ -4,6 +4,8 @@
 #include <osg/Geometry>
 #include <osg/Matrixf>
 
+#include <mutex>
+
 namespace SceneUtil
 {
     class Skeleton;
@@ -47,12 +49,25 @@ namespace SceneUtil
 
         void setInfluenceMap(osg::ref_ptr<InfluenceMap> influenceMap);
 
+        osg::ref_ptr<const InfluenceMap> getInfluenceMap() const { return mInfluenceMap; }
+
         /// Initialize this geometry from the source geometry.
         /// @note The source geometry will not be modified.
         void setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeom);
 
         osg::ref_ptr<osg::Geometry> getSourceGeometry() const;
 
+        /// The highest number of bones a RigGeometry can have to be skinned on the GPU.
+        static constexpr unsigned int sMaxGpuSkinningBones = 48;
+
+        /// Skin the geometry in the vertex shader instead of on the CPU. The shader has to apply the aBoneIndices and
+        /// aBoneWeights attributes (at locations 4 and 5) and the boneMatrices uniform, see the skinning define of
+        /// objects_vertex.glsl.
+        /// @return If GPU skinning is used, which is not possible for geometry with more than four influences per
+        /// vertex or too many bones.
+        bool setGpuSkinning(bool enabled);
+        bool getGpuSkinning() const { return mGpuSkinning; }
+
         void accept(osg::NodeVisitor &nv) override;
         bool supports(const osg::PrimitiveFunctor&) const override{ return true; }
         void accept(osg::PrimitiveFunctor&) const override;
@@ -78,6 +93,14 @@ namespace SceneUtil
         osg::ref_ptr<osg::Geometry> mGeometry[2];
         osg::Geometry* getGeometry(unsigned int frame) const;
 
+        bool mGpuSkinning;
+        // Bone indices and weights of up to four influences per vertex, shared by all copies
+        osg::ref_ptr<osg::Vec4Array> mBoneIndices;
+        osg::ref_ptr<osg::Vec4Array> mBoneWeights;
+        osg::ref_ptr<osg::Uniform> mBoneMatrices[2];
+
+        bool createGpuSkinningArrays();
+
         osg::ref_ptr<osg::Geometry> mSourceGeometry;
         osg::ref_ptr<const osg::Vec4Array> mSourceTangents;
         Skeleton* mSkeleton;
@@ -110,6 +133,9 @@ namespace SceneUtil
         unsigned int mLastFrameNumber;
         bool mBoundsFirstFrame;
 
+        // the same geometry may be culled by several cameras at once
+        std::mutex mCullMutex;
+
         bool initFromParentSkeleton(osg::NodeVisitor* nv);
 
         void updateGeomToSkelMatrix(const osg::NodePath& nodePath);
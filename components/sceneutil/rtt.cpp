@@ -5,10 +5,15 @@
 #include <osg/NodeVisitor>
 #include <osg/Texture2D>
 #include <osgUtil/CullVisitor>
+#include <osgUtil/RenderStage>
+#include <osgUtil/StateGraph>
+
+#include <algorithm>
 
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/settings/settings.hpp>
 #include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 namespace SceneUtil
 {
@@ -39,8 +44,18 @@ namespace SceneUtil
     void RTTNode::cull(osgUtil::CullVisitor* cv)
     {
         auto* vdd = getViewDependentData(cv);
+        if (!needsUpdate(vdd->mCamera, cv))
+            return;
         apply(vdd->mCamera);
-        vdd->mCamera->accept(*cv);
+        if (mCullQueue)
+            mCullQueue->cull(vdd->mCamera, cv);
+        else
+            vdd->mCamera->accept(*cv);
+    }
+
+    void RTTNode::setCullQueue(RTTCullQueue* queue)
+    {
+        mCullQueue = queue;
     }
 
     osg::Texture* RTTNode::getColorTexture(osgUtil::CullVisitor* cv)
@@ -60,6 +75,8 @@ namespace SceneUtil
             // This is safe since the visitor is never dereferenced.
             cv = nullptr;
 
+        std::lock_guard<std::mutex> lock(mViewDependentDataMutex);
+
         if (mViewDependentDataMap.count(cv) == 0)
         {
             auto camera = new osg::Camera();
@@ -105,4 +122,161 @@ namespace SceneUtil
 
         return mViewDependentDataMap[cv].get();
     }
+
+    class RTTCullQueue::Job : public osg::Referenced
+    {
+    public:
+        void setup(osg::Camera* camera, osgUtil::CullVisitor* cv)
+        {
+            if (!mCullVisitor)
+            {
+                mCullVisitor = cv->clone();
+                mStateGraph = new osgUtil::StateGraph;
+            }
+
+            mCullVisitor->setCullSettings(*cv);
+            mCullVisitor->setTraversalMask(cv->getTraversalMask());
+            mCullVisitor->setFrameStamp(const_cast<osg::FrameStamp*>(cv->getFrameStamp()));
+            mCullVisitor->setTraversalNumber(cv->getTraversalNumber());
+            mCullVisitor->setRenderInfo(cv->getRenderInfo());
+            mCullVisitor->setDatabaseRequestHandler(cv->getDatabaseRequestHandler());
+            mCullVisitor->setImageRequestHandler(cv->getImageRequestHandler());
+
+            mCamera = camera;
+            mTargetStage = cv->getCurrentRenderBin()->getStage();
+            mRenderStage = new osgUtil::RenderStage;
+            // Positional state of the view, like the sun, is inherited by the camera's stage
+            mRenderStage->setPositionalStateContainer(mTargetStage->getPositionalStateContainer());
+            mViewport = cv->getViewport();
+            mProjectionMatrix = new osg::RefMatrix(*cv->getProjectionMatrix());
+            mModelViewMatrix = new osg::RefMatrix(*cv->getModelViewMatrix());
+
+            mStateSets.clear();
+            for (const osgUtil::StateGraph* stateGraph = cv->getCurrentStateGraph(); stateGraph; stateGraph = stateGraph->_parent)
+            {
+                if (stateGraph->_stateset)
+                    mStateSets.emplace_back(stateGraph->_stateset);
+            }
+            std::reverse(mStateSets.begin(), mStateSets.end());
+        }
+
+        void cull()
+        {
+            osgUtil::CullVisitor& cv = *mCullVisitor;
+            cv.reset();
+            mStateGraph->clean();
+            cv.setStateGraph(mStateGraph);
+            cv.setRenderStage(mRenderStage);
+
+            cv.pushViewport(mViewport);
+            cv.pushProjectionMatrix(mProjectionMatrix);
+            cv.pushModelViewMatrix(mModelViewMatrix, osg::Transform::ABSOLUTE_RF);
+            for (const auto& stateSet : mStateSets)
+                cv.pushStateSet(stateSet);
+
+            mCamera->accept(cv);
+
+            for (std::size_t i = 0; i < mStateSets.size(); ++i)
+                cv.popStateSet();
+            cv.popModelViewMatrix();
+            cv.popProjectionMatrix();
+            cv.popViewport();
+
+            mStateGraph->prune();
+        }
+
+        /// Hand the camera's stage over to the stage it would have been culled into.
+        void finish()
+        {
+            for (const auto& [order, stage] : mRenderStage->getPreRenderList())
+                mTargetStage->addPreRenderStage(stage, order);
+            for (const auto& [order, stage] : mRenderStage->getPostRenderList())
+                mTargetStage->addPostRenderStage(stage, order);
+
+            mCamera = nullptr;
+            mTargetStage = nullptr;
+            mRenderStage = nullptr;
+            mStateSets.clear();
+        }
+
+    private:
+        osg::ref_ptr<osgUtil::CullVisitor> mCullVisitor;
+        osg::ref_ptr<osgUtil::StateGraph> mStateGraph;
+        osg::ref_ptr<osg::Camera> mCamera;
+        osg::ref_ptr<osgUtil::RenderStage> mTargetStage;
+        osg::ref_ptr<osgUtil::RenderStage> mRenderStage;
+        osg::ref_ptr<osg::Viewport> mViewport;
+        osg::ref_ptr<osg::RefMatrix> mProjectionMatrix;
+        osg::ref_ptr<osg::RefMatrix> mModelViewMatrix;
+        std::vector<osg::ref_ptr<const osg::StateSet>> mStateSets;
+    };
+
+    class RTTCullQueue::CullWorkItem : public WorkItem
+    {
+    public:
+        CullWorkItem(Job* job)
+            : mJob(job)
+        {
+        }
+
+        void doWork() override
+        {
+            mJob->cull();
+        }
+
+    private:
+        osg::ref_ptr<Job> mJob;
+    };
+
+    RTTCullQueue::RTTCullQueue(std::size_t workerThreads)
+        : mWorkQueue(new WorkQueue(workerThreads))
+    {
+    }
+
+    RTTCullQueue::~RTTCullQueue()
+    {
+    }
+
+    void RTTCullQueue::operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+    {
+        traverse(node, cv);
+        finish(cv);
+    }
+
+    void RTTCullQueue::cull(osg::Camera* camera, osgUtil::CullVisitor* cv)
+    {
+        PendingJobs* pending;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            pending = &mPendingJobs[cv];
+        }
+
+        if (pending->mNumPending == pending->mJobs.size())
+            pending->mJobs.push_back(new Job);
+        osg::ref_ptr<Job> job = pending->mJobs[pending->mNumPending++];
+
+        job->setup(camera, cv);
+        pending->mWorkItems.emplace_back(new CullWorkItem(job));
+        mWorkQueue->addWorkItem(pending->mWorkItems.back());
+    }
+
+    void RTTCullQueue::finish(osgUtil::CullVisitor* cv)
+    {
+        PendingJobs* pending;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto found = mPendingJobs.find(cv);
+            if (found == mPendingJobs.end())
+                return;
+            pending = &found->second;
+        }
+
+        for (std::size_t i = 0; i < pending->mNumPending; ++i)
+        {
+            pending->mWorkItems[i]->waitTillDone();
+            pending->mJobs[i]->finish();
+        }
+        pending->mWorkItems.clear();
+        pending->mNumPending = 0;
+    }
 }
@@ -3,8 +3,12 @@
 
 #include <osg/Node>
 
+#include <components/sceneutil/nodecallback.hpp>
+
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace osg
 {
@@ -19,6 +23,10 @@ namespace osgUtil
 
 namespace SceneUtil
 {
+    class WorkItem;
+    class WorkQueue;
+    class RTTCullQueue;
+
     /// @brief Implements per-view RTT operations.
     /// @par With a naive RTT implementation, subsequent views of multiple views will overwrite the results of the previous views, leading to
     ///     the results of the last view being broadcast to all views. An error in all cases where the RTT result depends on the view.
@@ -47,8 +55,16 @@ namespace SceneUtil
         /// Set default settings - optionally override in derived classes
         virtual void apply(osg::Camera* camera) {};
 
+        /// Whether to render the camera in this frame - optionally override in derived classes
+        /// @par When skipping a frame, the textures keep the results of the last render of the camera.
+        virtual bool needsUpdate(osg::Camera* camera, osgUtil::CullVisitor* cv) { return true; }
+
         void cull(osgUtil::CullVisitor* cv);
 
+        /// Cull the camera on the worker threads of the given queue instead of the cull thread.
+        /// @param queue May be nullptr to cull on the cull thread.
+        void setCullQueue(RTTCullQueue* queue);
+
     private:
         struct ViewDependentData
         {
@@ -59,10 +75,47 @@ namespace SceneUtil
 
         typedef std::map< osgUtil::CullVisitor*, std::unique_ptr<ViewDependentData> >  ViewDependentDataMap;
         ViewDependentDataMap mViewDependentDataMap;
+        std::mutex mViewDependentDataMutex;
+        osg::ref_ptr<RTTCullQueue> mCullQueue;
         uint32_t mTextureWidth;
         uint32_t mTextureHeight;
         int mRenderOrderNum;
         bool mDoPerViewMapping;
     };
+
+    /// @brief Culls the cameras of RTTNodes on worker threads, concurrently with the rest of the cull traversal.
+    /// @par Must be added as a cull callback to a node above all RTTNodes using the queue. The traversal of that node waits for
+    ///     the workers and adds the render stages they produced to the stages the cameras would have been culled into.
+    /// @par Each worker culls with its own CullVisitor and StateGraph, one per view and camera, so that they are double buffered
+    ///     the same way as the CullVisitors of the view.
+    /// @note Everything visible to the cameras is culled concurrently with the view, so the cull callbacks in their subgraphs have to be thread safe.
+    class RTTCullQueue : public SceneUtil::NodeCallback<RTTCullQueue, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        RTTCullQueue(std::size_t workerThreads);
+        ~RTTCullQueue();
+
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv);
+
+        /// Start culling the camera on a worker, with the current state of the visitor.
+        void cull(osg::Camera* camera, osgUtil::CullVisitor* cv);
+
+    private:
+        class Job;
+        class CullWorkItem;
+
+        void finish(osgUtil::CullVisitor* cv);
+
+        struct PendingJobs
+        {
+            std::vector<osg::ref_ptr<Job>> mJobs;
+            std::vector<osg::ref_ptr<WorkItem>> mWorkItems;
+            std::size_t mNumPending = 0;
+        };
+
+        osg::ref_ptr<WorkQueue> mWorkQueue;
+        std::mutex mMutex;
+        std::map<osgUtil::CullVisitor*, PendingJobs> mPendingJobs;
+    };
 }
 #endif
@@ -148,7 +148,7 @@ namespace SceneUtil
     void AsyncScreenCaptureOperation::stop()
     {
         for (const osg::ref_ptr<SceneUtil::WorkItem>& item : *mWorkItems.lockConst())
-            item->abort();
+            item->cancel();
 
         for (const osg::ref_ptr<SceneUtil::WorkItem>& item : *mWorkItems.lockConst())
             item->waitTillDone();
@@ -157,7 +157,7 @@ namespace SceneUtil
     void AsyncScreenCaptureOperation::operator()(const osg::Image& image, const unsigned int context_id)
     {
         osg::ref_ptr<SceneUtil::WorkItem> item(new ScreenCaptureWorkItem(mImpl, image, context_id));
-        mQueue->addWorkItem(item);
+        mQueue->addWorkItem(item, SceneUtil::WorkPriority::Low);
         const auto isDone = [] (const osg::ref_ptr<SceneUtil::WorkItem>& v) { return v->isDone(); };
         const auto workItems = mWorkItems.lock();
         workItems->erase(std::remove_if(workItems->begin(), workItems->end(), isDone), workItems->end());
@@ -1,5 +1,14 @@
 #include "serialize.hpp"
 
+#include <atomic>
+#include <string_view>
+
+#include <osg/Drawable>
+#include <osg/Image>
+#include <osg/NodeVisitor>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+
 #include <osgDB/ObjectWrapper>
 #include <osgDB/Registry>
 
@@ -99,11 +108,11 @@ public:
     }
 };
 
+static std::atomic_bool sSkipGeometryData {false};
+
 void registerSerializers()
 {
-    static bool done = false;
-    if (!done)
-    {
+    static const bool done = [] {
         osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
         mgr->addWrapper(new PositionAttitudeTransformSerializer);
         mgr->addWrapper(new SkeletonSerializer);
@@ -113,10 +122,6 @@ void registerSerializers()
         mgr->addWrapper(new CameraRelativeTransformSerializer);
         mgr->addWrapper(new MatrixTransformSerializer);
 
-        // Don't serialize Geometry data as we are more interested in the overall structure rather than tons of vertex data that would make the file large and hard to read.
-        mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
-        mgr->addWrapper(new GeometrySerializer);
-
         // ignore the below for now to avoid warning spam
         const char* ignore[] = {
             "MWRender::PtrHolder",
@@ -160,9 +165,135 @@ void registerSerializers()
             mgr->addWrapper(makeDummySerializer(ignore[i]));
         }
 
+        return true;
+    }();
+    static_cast<void>(done);
+}
+
+void skipGeometryDataSerialization()
+{
+    registerSerializers();
+    if (sSkipGeometryData.exchange(true))
+        return;
+
+    // Don't serialize Geometry data as we are more interested in the overall structure rather than tons of vertex data that would make the file large and hard to read.
+    osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
+    mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
+    mgr->addWrapper(new GeometrySerializer);
+}
 
-        done = true;
+bool canDeserialize()
+{
+    return !sSkipGeometryData;
+}
+
+namespace
+{
+    bool isSerializable(const osg::Object& object)
+    {
+        // The wrappers registered above don't store the data of most classes from outside of osg
+        const std::string_view library = object.libraryName();
+        return library == "osg" || (library == "SceneUtil" && std::string_view(object.className()) == "PositionAttitudeTransform");
     }
+
+    bool isSerializable(const osg::UserDataContainer* userData)
+    {
+        if (!userData)
+            return true;
+        if (!isSerializable(*userData))
+            return false;
+        for (unsigned int i = 0; i < userData->getNumUserObjects(); ++i)
+        {
+            const osg::Object* object = userData->getUserObject(i);
+            if (object && !isSerializable(*object))
+                return false;
+        }
+        return true;
+    }
+
+    bool isSerializable(const osg::StateAttribute& attribute)
+    {
+        if (!isSerializable(static_cast<const osg::Object&>(attribute)) || attribute.getUpdateCallback()
+                || attribute.getEventCallback() || !isSerializable(attribute.getUserDataContainer()))
+            return false;
+        if (const osg::Texture* texture = attribute.asTexture())
+        {
+            // Images are written as references to be read back through the image manager
+            for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+            {
+                const osg::Image* image = texture->getImage(i);
+                if (image && image->getFileName().empty())
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool isSerializable(const osg::StateSet::AttributeList& attributes)
+    {
+        for (const auto& [type, attribute] : attributes)
+            if (!isSerializable(*attribute.first))
+                return false;
+        return true;
+    }
+
+    bool isSerializable(const osg::StateSet& stateset)
+    {
+        if (stateset.getUpdateCallback() || stateset.getEventCallback() || !isSerializable(stateset.getUserDataContainer())
+                || !isSerializable(stateset.getAttributeList()))
+            return false;
+        for (const auto& attributes : stateset.getTextureAttributeList())
+            if (!isSerializable(attributes))
+                return false;
+        for (const auto& [name, uniform] : stateset.getUniformList())
+            if (uniform.first->getUpdateCallback() || uniform.first->getEventCallback())
+                return false;
+        return true;
+    }
+
+    class CanSerializeVisitor : public osg::NodeVisitor
+    {
+    public:
+        CanSerializeVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (!mResult)
+                return;
+            if (!isSerializable(node) || node.getUpdateCallback() || node.getEventCallback() || node.getCullCallback()
+                    || !isSerializable(node.getUserDataContainer())
+                    || (node.getStateSet() && !isSerializable(*node.getStateSet())))
+            {
+                mResult = false;
+                return;
+            }
+            traverse(node);
+        }
+
+        void apply(osg::Drawable& drawable) override
+        {
+            if (drawable.getDrawCallback() || drawable.getComputeBoundingBoxCallback() || drawable.getShape())
+            {
+                mResult = false;
+                return;
+            }
+            apply(static_cast<osg::Node&>(drawable));
+        }
+
+        bool mResult = true;
+    };
+}
+
+bool canSerialize(osg::Node& node)
+{
+    if (!canDeserialize())
+        return false;
+    CanSerializeVisitor visitor;
+    node.accept(visitor);
+    return visitor.mResult;
 }
 
 }
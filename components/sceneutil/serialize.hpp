@@ -1,12 +1,29 @@
 #ifndef OPENMW_COMPONENTS_SCENEUTIL_SERIALIZE_H
 #define OPENMW_COMPONENTS_SCENEUTIL_SERIALIZE_H
 
+namespace osg
+{
+    class Node;
+}
+
 namespace SceneUtil
 {
 
     /// Register osg node serializers for certain SceneUtil classes if not already done so
+    /// @note Thread safe.
     void registerSerializers();
 
+    /// Stop serializing the vertex data of osg::Geometry, to write the overall structure of a scene graph in a compact
+    /// and readable form. Scene graphs serialized afterwards can't be read back completely.
+    void skipGeometryDataSerialization();
+
+    /// Check if the scene graph survives a round trip through serialization, i.e. it only consists of classes whose
+    /// serializers store all of their data, references images by file name and has no callbacks attached.
+    bool canSerialize(osg::Node& node);
+
+    /// @return false once the vertex data of osg::Geometry is no longer serialized
+    bool canDeserialize();
+
 }
 
 #endif
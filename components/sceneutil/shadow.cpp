@@ -66,6 +66,11 @@ namespace SceneUtil
         else
             mShadowSettings->setMultipleShadowMapHint(osgShadow::ShadowSettings::PARALLEL_SPLIT);
 
+        if (Settings::Manager::getBool("static shadow cache", "Shadows"))
+            mShadowTechnique->enableStaticShadowCache(mStaticShadowCastingMask, Settings::Manager::getFloat("static shadow cache angle", "Shadows"));
+        else
+            mShadowTechnique->disableStaticShadowCache();
+
         if (Settings::Manager::getBool("enable debug hud", "Shadows"))
             mShadowTechnique->enableDebugHUD();
         else
@@ -95,10 +100,11 @@ namespace SceneUtil
         }
     }
 
-    ShadowManager::ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, Shader::ShaderManager &shaderManager) : mShadowedScene(new osgShadow::ShadowedScene),
+    ShadowManager::ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, unsigned int staticShadowCastingMask, Shader::ShaderManager &shaderManager) : mShadowedScene(new osgShadow::ShadowedScene),
         mShadowTechnique(new MWShadowTechnique),
         mOutdoorShadowCastingMask(outdoorShadowCastingMask),
-        mIndoorShadowCastingMask(indoorShadowCastingMask)
+        mIndoorShadowCastingMask(indoorShadowCastingMask),
+        mStaticShadowCastingMask(staticShadowCastingMask)
     {
         mShadowedScene->setShadowTechnique(mShadowTechnique);
 
@@ -180,6 +186,11 @@ namespace SceneUtil
             mShadowTechnique->disableShadows(true);
     }
 
+    void ShadowManager::dirtyStaticShadows()
+    {
+        mShadowTechnique->dirtyStaticShadowCache();
+    }
+
     void ShadowManager::enableOutdoorMode()
     {
         if (mEnableShadows)
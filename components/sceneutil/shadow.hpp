@@ -24,7 +24,7 @@ namespace SceneUtil
 
         static Shader::ShaderManager::DefineMap getShadowsDisabledDefines();
 
-        ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, Shader::ShaderManager &shaderManager);
+        ShadowManager(osg::ref_ptr<osg::Group> sceneRoot, osg::ref_ptr<osg::Group> rootNode, unsigned int outdoorShadowCastingMask, unsigned int indoorShadowCastingMask, unsigned int worldMask, unsigned int staticShadowCastingMask, Shader::ShaderManager &shaderManager);
         ~ShadowManager();
 
         void setupShadowSettings();
@@ -34,6 +34,9 @@ namespace SceneUtil
         void enableIndoorMode();
 
         void enableOutdoorMode();
+
+        /// Render the cached static shadow casters again, after static objects were added or removed.
+        void dirtyStaticShadows();
     protected:
         bool mEnableShadows;
 
@@ -43,6 +46,7 @@ namespace SceneUtil
 
         unsigned int mOutdoorShadowCastingMask;
         unsigned int mIndoorShadowCastingMask;
+        unsigned int mStaticShadowCastingMask;
     };
 }
 
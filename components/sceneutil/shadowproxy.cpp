@@ -0,0 +1,233 @@
+#include "shadowproxy.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/Switch>
+#include <osg/LOD>
+#include <osg/Billboard>
+#include <osg/TriangleIndexFunctor>
+
+#include "shadowsbin.hpp"
+
+namespace
+{
+    struct CollectTriangles
+    {
+        std::vector<unsigned int>* mIndices = nullptr;
+        unsigned int mOffset = 0;
+        bool mFlipWinding = false;
+
+        void operator()(unsigned int i1, unsigned int i2, unsigned int i3)
+        {
+            if (mFlipWinding)
+                std::swap(i2, i3);
+            mIndices->push_back(mOffset + i1);
+            mIndices->push_back(mOffset + i2);
+            mIndices->push_back(mOffset + i3);
+        }
+    };
+
+    struct MergedCasters
+    {
+        osg::ref_ptr<osg::Vec3Array> mVertices = new osg::Vec3Array;
+        std::vector<unsigned int> mIndices;
+
+        void add(const osg::Geometry& geometry, const osg::Vec3Array& vertices, const osg::Matrix& matrix)
+        {
+            const unsigned int offset = mVertices->size();
+            mVertices->reserve(offset + vertices.size());
+            for (const osg::Vec3f& vertex : vertices)
+                mVertices->push_back(vertex * matrix);
+
+            osg::TriangleIndexFunctor<CollectTriangles> functor;
+            functor.mIndices = &mIndices;
+            functor.mOffset = offset;
+            // a mirroring transform turns the front faces of the original around
+            functor.mFlipWinding = isMirrored(matrix);
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+                geometry.getPrimitiveSet(i)->accept(functor);
+        }
+
+        static bool isMirrored(const osg::Matrix& matrix)
+        {
+            const osg::Vec3f x(matrix(0, 0), matrix(0, 1), matrix(0, 2));
+            const osg::Vec3f y(matrix(1, 0), matrix(1, 1), matrix(1, 2));
+            const osg::Vec3f z(matrix(2, 0), matrix(2, 1), matrix(2, 2));
+            return (x ^ y) * z < 0;
+        }
+
+        osg::ref_ptr<osg::Geometry> createGeometry() const
+        {
+            if (mIndices.empty())
+                return nullptr;
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+            geometry->setVertexArray(mVertices);
+            geometry->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, mIndices.begin(), mIndices.end()));
+            geometry->setUseDisplayList(false);
+            geometry->setUseVertexBufferObjects(true);
+            geometry->setDataVariance(osg::Object::STATIC);
+            return geometry;
+        }
+    };
+
+    class ShadowProxyVisitor : public osg::NodeVisitor
+    {
+    public:
+        ShadowProxyVisitor(unsigned int castsShadowMask)
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mCastsShadowMask(castsShadowMask)
+            , mProxy(new osg::Group)
+        {
+            mMatrices.emplace_back();
+            mStates.emplace_back();
+            mTwoSided.push_back(false);
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (!(node.getNodeMask() & mCastsShadowMask))
+                return;
+
+            // anything that can change during the frame or depends on the camera has to stay as it is
+            if (node.getCullCallback() || node.getUpdateCallback() || node.asSwitch() || dynamic_cast<osg::LOD*>(&node)
+                || dynamic_cast<osg::Billboard*>(&node))
+            {
+                keep(node);
+                return;
+            }
+
+            pushState(node.getStateSet());
+            if (osg::Drawable* drawable = node.asDrawable())
+                applyDrawable(*drawable);
+            else if (osg::Transform* transform = node.asTransform())
+            {
+                osg::Matrix matrix = mMatrices.back();
+                transform->computeLocalToWorldMatrix(matrix, this);
+                mMatrices.push_back(matrix);
+                traverse(node);
+                mMatrices.pop_back();
+            }
+            else
+                traverse(node);
+            popState(node.getStateSet());
+        }
+
+        osg::ref_ptr<osg::Group> getProxy()
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                osg::ref_ptr<osg::Geometry> geometry = mMerged[i].createGeometry();
+                if (!geometry)
+                    continue;
+                if (i == 1)
+                    geometry->getOrCreateStateSet()->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+                mProxy->addChild(geometry);
+            }
+            if (!mProxy->getNumChildren())
+                return nullptr;
+            return mProxy;
+        }
+
+    private:
+        void applyDrawable(osg::Drawable& drawable)
+        {
+            const SceneUtil::ShadowsBin::State& state = mStates.back();
+            if (!state.needShadows())
+                return;
+
+            osg::Geometry* geometry = drawable.asGeometry();
+            const osg::Vec3Array* vertices = geometry ? dynamic_cast<const osg::Vec3Array*>(geometry->getVertexArray()) : nullptr;
+            if (!vertices || state.needTexture() || state.mImportantState || geometry->getNumPrimitiveSets() == 0
+                || geometry->className() != std::string("Geometry") || isInstanced(*geometry))
+            {
+                keepDrawable(drawable);
+                return;
+            }
+
+            mMerged[mTwoSided.back() ? 1 : 0].add(*geometry, *vertices, mMatrices.back());
+        }
+
+        static bool isInstanced(const osg::Geometry& geometry)
+        {
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+                if (geometry.getPrimitiveSet(i)->getNumInstances() > 0)
+                    return true;
+            return false;
+        }
+
+        void pushState(const osg::StateSet* stateSet)
+        {
+            if (!stateSet)
+                return;
+            SceneUtil::ShadowsBin::State state = mStates.back();
+            state.accumulate(*stateSet, false);
+            mStates.push_back(state);
+            mStateSets.push_back(stateSet);
+
+            bool twoSided = mTwoSided.back();
+            const unsigned int cullFace = stateSet->getMode(GL_CULL_FACE);
+            if (cullFace != osg::StateAttribute::INHERIT)
+                twoSided = !(cullFace & osg::StateAttribute::ON);
+            mTwoSided.push_back(twoSided);
+        }
+
+        void popState(const osg::StateSet* stateSet)
+        {
+            if (!stateSet)
+                return;
+            mStates.pop_back();
+            mStateSets.pop_back();
+            mTwoSided.pop_back();
+        }
+
+        // Share the node with the proxy under its statesets and transform, excluding the stateset of the node itself.
+        void keep(osg::Node& node)
+        {
+            osg::Group* parent = mProxy;
+            for (const osg::StateSet* stateSet : mStateSets)
+            {
+                osg::ref_ptr<osg::Group> group = new osg::Group;
+                group->setStateSet(const_cast<osg::StateSet*>(stateSet));
+                parent->addChild(group);
+                parent = group;
+            }
+            osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(mMatrices.back());
+            transform->setDataVariance(osg::Object::STATIC);
+            transform->addChild(&node);
+            parent->addChild(transform);
+        }
+
+        void keepDrawable(osg::Drawable& drawable)
+        {
+            // the drawable's own stateset was already pushed, but it stays attached to the shared drawable
+            const osg::StateSet* ownStateSet = drawable.getStateSet();
+            if (ownStateSet)
+                mStateSets.pop_back();
+            keep(drawable);
+            if (ownStateSet)
+                mStateSets.push_back(ownStateSet);
+        }
+
+        const unsigned int mCastsShadowMask;
+        osg::ref_ptr<osg::Group> mProxy;
+        std::vector<osg::Matrix> mMatrices;
+        std::vector<SceneUtil::ShadowsBin::State> mStates;
+        std::vector<const osg::StateSet*> mStateSets;
+        std::vector<bool> mTwoSided;
+        MergedCasters mMerged[2];
+    };
+}
+
+namespace SceneUtil
+{
+    osg::ref_ptr<osg::Group> createShadowProxy(osg::Node& node, unsigned int castsShadowMask)
+    {
+        ShadowProxyVisitor visitor(castsShadowMask);
+        node.accept(visitor);
+        return visitor.getProxy();
+    }
+}
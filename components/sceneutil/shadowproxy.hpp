@@ -0,0 +1,41 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_SHADOWPROXY_H
+#define OPENMW_COMPONENTS_SCENEUTIL_SHADOWPROXY_H
+
+#include <osg/Group>
+#include <osg/NodeVisitor>
+#include <osg/ref_ptr>
+
+#include "nodecallback.hpp"
+
+namespace SceneUtil
+{
+    /// Skips its subgraph in traversals which draw shadow proxies, i.e. whose traversal mask contains the proxy mask.
+    class ShadowProxyCullCallback : public NodeCallback<ShadowProxyCullCallback>
+    {
+    public:
+        explicit ShadowProxyCullCallback(unsigned int proxyMask)
+            : mProxyMask(proxyMask)
+        {
+        }
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv)
+        {
+            if (nv->getTraversalMask() & mProxyMask)
+                return;
+            traverse(node, nv);
+        }
+
+    private:
+        unsigned int mProxyMask;
+    };
+
+    /// @brief Create a stand-in for a static subgraph to draw in shadow maps instead of it.
+    /// @par Geometry which casts shadows without needing its texture is merged into positions-only geometry, one for
+    /// each cull face mode. Alpha tested or blended parts and subgraphs which can't be merged are shared with the original,
+    /// together with their statesets and transforms, so the casting programs of the ShadowsBin still apply to them.
+    /// @param castsShadowMask nodes without any of these bits are left out, like the shadow cameras' cull mask would.
+    /// @return nullptr if nothing in the subgraph casts shadows
+    osg::ref_ptr<osg::Group> createShadowProxy(osg::Node& node, unsigned int castsShadowMask);
+}
+
+#endif
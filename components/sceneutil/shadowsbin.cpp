@@ -79,33 +79,7 @@ StateGraph* ShadowsBin::cullStateGraph(StateGraph* sg, StateGraph* root, std::un
         if (!ss)
             continue;
 
-        accumulateModeState(ss, state.mAlphaBlend, state.mAlphaBlendOverride, GL_BLEND);
-
-        const osg::StateSet::AttributeList& attributes = ss->getAttributeList();
-        osg::StateSet::AttributeList::const_iterator found = attributes.find(std::make_pair(osg::StateAttribute::MATERIAL, 0));
-        if (found != attributes.end())
-        {
-            const osg::StateSet::RefAttributePair& rap = found->second;
-            accumulateState(state.mMaterial, static_cast<osg::Material*>(rap.first.get()), state.mMaterialOverride, rap.second);
-            if (state.mMaterial && !materialNeedShadows(state.mMaterial))
-                state.mMaterial = nullptr;
-        }
-
-        found = attributes.find(std::make_pair(osg::StateAttribute::ALPHAFUNC, 0));
-        if (found != attributes.end())
-        {
-            // As force shaders is on, we know this is really a RemovedAlphaFunc
-            const osg::StateSet::RefAttributePair& rap = found->second;
-            accumulateState(state.mAlphaFunc, static_cast<osg::AlphaFunc*>(rap.first.get()), state.mAlphaFuncOverride, rap.second);
-        }
-
-        if (!cullFaceOverridden)
-        {
-            // osg::FrontFace specifies triangle winding, not front-face culling. We can't safely reparent anything under it unless GL_CULL_FACE is off or we flip face culling.
-            found = attributes.find(std::make_pair(osg::StateAttribute::FRONTFACE, 0));
-            if (found != attributes.end())
-                state.mImportantState = true;
-        }
+        state.accumulate(*ss, cullFaceOverridden);
 
         if ((*itr) != sg && !state.interesting())
             uninterestingCache.insert(*itr);
@@ -146,7 +120,38 @@ StateGraph* ShadowsBin::cullStateGraph(StateGraph* sg, StateGraph* root, std::un
     return sg;
 }
 
-inline bool ShadowsBin::State::needTexture() const
+void ShadowsBin::State::accumulate(const osg::StateSet& stateSet, bool cullFaceOverridden)
+{
+    accumulateModeState(&stateSet, mAlphaBlend, mAlphaBlendOverride, GL_BLEND);
+
+    const osg::StateSet::AttributeList& attributes = stateSet.getAttributeList();
+    osg::StateSet::AttributeList::const_iterator found = attributes.find(std::make_pair(osg::StateAttribute::MATERIAL, 0));
+    if (found != attributes.end())
+    {
+        const osg::StateSet::RefAttributePair& rap = found->second;
+        accumulateState(mMaterial, static_cast<osg::Material*>(rap.first.get()), mMaterialOverride, rap.second);
+        if (mMaterial && !materialNeedShadows(mMaterial))
+            mMaterial = nullptr;
+    }
+
+    found = attributes.find(std::make_pair(osg::StateAttribute::ALPHAFUNC, 0));
+    if (found != attributes.end())
+    {
+        // As force shaders is on, we know this is really a RemovedAlphaFunc
+        const osg::StateSet::RefAttributePair& rap = found->second;
+        accumulateState(mAlphaFunc, static_cast<osg::AlphaFunc*>(rap.first.get()), mAlphaFuncOverride, rap.second);
+    }
+
+    if (!cullFaceOverridden)
+    {
+        // osg::FrontFace specifies triangle winding, not front-face culling. We can't safely reparent anything under it unless GL_CULL_FACE is off or we flip face culling.
+        found = attributes.find(std::make_pair(osg::StateAttribute::FRONTFACE, 0));
+        if (found != attributes.end())
+            mImportantState = true;
+    }
+}
+
+bool ShadowsBin::State::needTexture() const
 {
     return mAlphaBlend || (mAlphaFunc && mAlphaFunc->getFunction() != GL_ALWAYS);
 }
@@ -51,6 +51,8 @@ namespace SceneUtil
             osg::Material* mMaterial;
             bool mMaterialOverride;
             bool mImportantState;
+            /// Apply the state that matters for shadow casting from a stateset below the previous ones.
+            void accumulate(const osg::StateSet& stateSet, bool cullFaceOverridden);
             bool needTexture() const;
             bool needShadows() const;
             // A state is interesting if there's anything about it that might affect whether we can optimise child state
@@ -37,6 +37,7 @@ Skeleton::Skeleton()
     , mActive(Active)
     , mLastFrameNumber(0)
     , mLastCullFrameNumber(0)
+    , mLastUpdateFrameNumber(0)
 {
 
 }
@@ -48,6 +49,7 @@ Skeleton::Skeleton(const Skeleton &copy, const osg::CopyOp &copyop)
     , mActive(copy.mActive)
     , mLastFrameNumber(0)
     , mLastCullFrameNumber(0)
+    , mLastUpdateFrameNumber(0)
 {
 
 }
@@ -101,6 +103,7 @@ Bone* Skeleton::getBone(const std::string &name)
 
 void Skeleton::updateBoneMatrices(unsigned int traversalNumber)
 {
+    std::lock_guard<std::mutex> lock(mBoneMatricesMutex);
     if (traversalNumber != mLastFrameNumber)
         mNeedToUpdateBoneMatrices = true;
 
@@ -128,6 +131,12 @@ bool Skeleton::getActive() const
     return mActive != Inactive;
 }
 
+bool Skeleton::isOffScreen() const
+{
+    // The update traversal of a frame runs before its cull traversals
+    return mLastUpdateFrameNumber != 0 && mLastCullFrameNumber < mLastUpdateFrameNumber;
+}
+
 void Skeleton::markDirty()
 {
     mLastFrameNumber = 0;
@@ -139,6 +148,7 @@ void Skeleton::traverse(osg::NodeVisitor& nv)
 {
     if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
     {
+        mLastUpdateFrameNumber = nv.getTraversalNumber();
         if (mActive == Inactive && mLastFrameNumber != 0)
             return;
         if (mActive == SemiActive && mLastFrameNumber != 0 && mLastCullFrameNumber+3 <= nv.getTraversalNumber())
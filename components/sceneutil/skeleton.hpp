@@ -4,6 +4,7 @@
 #include <osg/Group>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace SceneUtil
@@ -61,6 +62,9 @@ namespace SceneUtil
 
         bool getActive() const;
 
+        /// Was the skeleton left out of the cull traversals of the last frame?
+        bool isOffScreen() const;
+
         void traverse(osg::NodeVisitor& nv) override;
 
         void markDirty();
@@ -83,6 +87,10 @@ namespace SceneUtil
 
         unsigned int mLastFrameNumber;
         unsigned int mLastCullFrameNumber;
+        unsigned int mLastUpdateFrameNumber;
+
+        // the bone matrices may be requested by RigGeometries culled concurrently
+        std::mutex mBoneMatricesMutex;
     };
 
 }
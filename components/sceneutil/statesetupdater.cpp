@@ -45,6 +45,7 @@ namespace SceneUtil
 
     osg::StateSet* StateSetUpdater::getCvDependentStateset(osgUtil::CullVisitor* cv)
     {
+        std::lock_guard<std::mutex> lock(mStateSetsCullMutex);
         auto it = mStateSetsCull.find(cv);
         if (it == mStateSetsCull.end())
         {
@@ -60,6 +61,7 @@ namespace SceneUtil
     {
         mStateSetsUpdate[0] = nullptr;
         mStateSetsUpdate[1] = nullptr;
+        std::lock_guard<std::mutex> lock(mStateSetsCullMutex);
         mStateSetsCull.clear();
     }
 
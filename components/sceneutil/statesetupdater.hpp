@@ -5,6 +5,7 @@
 
 #include <map>
 #include <array>
+#include <mutex>
 
 namespace osgUtil
 {
@@ -24,7 +25,7 @@ namespace SceneUtil
     /// @par If set as an UpdateCallback, race conditions are prevented using a "double buffering" scheme - we have two StateSets that take turns,
     ///     one StateSet we can write to, the second one is currently in use by the draw traversal of the last frame.
     /// @par If set as a CullCallback, race conditions are prevented by mapping statesets to cull visitors - OSG has two cull visitors that take turns,
-    ///     allowing the updater to automatically scale for the number of views.
+    ///     allowing the updater to automatically scale for the number of views. Cull visitors may traverse the node concurrently.
     /// @note When used as a CullCallback, StateSetUpdater will have no effect on leaf nodes such as osg::Geometry and must be used on branch nodes only.
     /// @note Do not add the same StateSetUpdater to multiple nodes.
     /// @note Do not add multiple StateSetUpdaters on the same Node as they will conflict - instead use the CompositeStateSetUpdater.
@@ -55,6 +56,7 @@ namespace SceneUtil
 
         std::array<osg::ref_ptr<osg::StateSet>, 2> mStateSetsUpdate;
         std::map<osgUtil::CullVisitor*, osg::ref_ptr<osg::StateSet>> mStateSetsCull;
+        std::mutex mStateSetsCullMutex;
     };
 
     /// @brief A variant of the StateSetController that can be made up of multiple controllers all controlling the same target.
@@ -0,0 +1,58 @@
+#include "vertexupdate.hpp"
+
+namespace SceneUtil
+{
+
+namespace
+{
+    osg::ref_ptr<WorkQueue> sVertexUpdateQueue;
+
+    class VertexUpdate : public WorkItem
+    {
+    public:
+        explicit VertexUpdate(std::function<void()>&& update) : mUpdate(std::move(update)) {}
+
+        void doWork() override
+        {
+            mUpdate();
+        }
+
+    private:
+        std::function<void()> mUpdate;
+    };
+}
+
+void setVertexUpdateQueue(osg::ref_ptr<WorkQueue> queue)
+{
+    sVertexUpdateQueue = std::move(queue);
+}
+
+void VertexUpdateCallback::run(std::function<void()>&& update)
+{
+    // The previous update of this geometry may still be running if the geometry was culled without being drawn
+    wait();
+
+    if (!sVertexUpdateQueue)
+    {
+        mUpdate = nullptr;
+        update();
+        return;
+    }
+
+    mUpdate = new VertexUpdate(std::move(update));
+    sVertexUpdateQueue->addWorkItem(mUpdate);
+}
+
+void VertexUpdateCallback::wait() const
+{
+    if (mUpdate)
+        mUpdate->waitTillDone();
+}
+
+void VertexUpdateCallback::drawImplementation(osg::RenderInfo& renderInfo, const osg::Drawable* drawable) const
+{
+    wait();
+    drawable->drawImplementation(renderInfo);
+}
+
+}
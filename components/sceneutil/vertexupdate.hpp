@@ -0,0 +1,38 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_VERTEXUPDATE_H
+#define OPENMW_COMPONENTS_SCENEUTIL_VERTEXUPDATE_H
+
+#include <osg/Drawable>
+
+#include <functional>
+
+#include "workqueue.hpp"
+
+namespace SceneUtil
+{
+
+    /// Set the queue RigGeometry and MorphGeometry update their vertices on, or nullptr to update them in the cull
+    /// traversal.
+    /// @note Not thread safe, has to be set while nothing is rendered.
+    void setVertexUpdateQueue(osg::ref_ptr<WorkQueue> queue);
+
+    /// @brief Updates the vertices of one of the double buffered geometries used by RigGeometry and MorphGeometry.
+    /// @note Set as draw callback of the updated geometry, this waits for the update before the geometry is drawn.
+    class VertexUpdateCallback : public osg::Drawable::DrawCallback
+    {
+    public:
+        /// Run the update on the vertex update queue, or right away if there is none. The update must only access
+        /// data which stays untouched until the geometry is drawn, as the cull traversal goes on meanwhile.
+        void run(std::function<void()>&& update);
+
+        /// Wait until the last update is done.
+        void wait() const;
+
+        void drawImplementation(osg::RenderInfo& renderInfo, const osg::Drawable* drawable) const override;
+
+    private:
+        osg::ref_ptr<WorkItem> mUpdate;
+    };
+
+}
+
+#endif
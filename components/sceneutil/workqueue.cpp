@@ -1,8 +1,13 @@
 #include "workqueue.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 
+#include <algorithm>
 #include <numeric>
+#include <string>
+
+#include <osg/Stats>
 
 namespace SceneUtil
 {
@@ -33,8 +38,15 @@ bool WorkItem::isDone() const
     return mDone;
 }
 
-WorkQueue::WorkQueue(std::size_t workerThreads)
+void WorkItem::cancel()
+{
+    mCancelled = true;
+    abort();
+}
+
+WorkQueue::WorkQueue(std::size_t workerThreads, std::optional<Misc::ThreadGroup> group)
     : mIsReleased(false)
+    , mGroup(group)
 {
     start(workerThreads);
 }
@@ -51,15 +63,21 @@ void WorkQueue::start(std::size_t workerThreads)
         mIsReleased = false;
     }
     while (mThreads.size() < workerThreads)
-        mThreads.emplace_back(std::make_unique<WorkThread>(*this));
+        mThreads.emplace_back(std::make_unique<WorkThread>(*this, mGroup));
+
+    const std::lock_guard lock(mMutex);
+    for (Lane& lane : mLanes)
+        lane.mMaxActive = mThreads.size();
+    // Keep threads for more urgent work when there is a lot to do in the background
+    getLane(WorkPriority::Low).mMaxActive = std::max<std::size_t>(1, mThreads.size() / 2);
 }
 
 void WorkQueue::stop()
 {
     {
         std::unique_lock<std::mutex> lock(mMutex);
-        while (!mQueue.empty())
-            mQueue.pop_back();
+        for (Lane& lane : mLanes)
+            lane.mQueue.clear();
         mIsReleased = true;
         mCondition.notify_all();
     }
@@ -67,7 +85,7 @@ void WorkQueue::stop()
     mThreads.clear();
 }
 
-void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
+void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, WorkPriority priority, bool front)
 {
     if (item->isDone())
     {
@@ -76,33 +94,66 @@ void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
     }
 
     std::unique_lock<std::mutex> lock(mMutex);
+    item->mPriority = priority;
+    item->mQueued = std::chrono::steady_clock::now();
+    Lane& lane = getLane(priority);
     if (front)
-        mQueue.push_front(std::move(item));
+        lane.mQueue.push_front(std::move(item));
     else
-        mQueue.push_back(std::move(item));
+        lane.mQueue.push_back(std::move(item));
     mCondition.notify_one();
 }
 
+WorkQueue::Lane* WorkQueue::getNextLane()
+{
+    for (Lane& lane : mLanes)
+    {
+        // Cancelled items are dropped without counting towards the limit
+        while (!lane.mQueue.empty() && lane.mQueue.front()->isCancelled())
+        {
+            lane.mQueue.front()->signalDone();
+            lane.mQueue.pop_front();
+        }
+        if (!lane.mQueue.empty() && lane.mActive < lane.mMaxActive)
+            return &lane;
+    }
+    return nullptr;
+}
+
 osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem()
 {
     std::unique_lock<std::mutex> lock(mMutex);
-    while (mQueue.empty() && !mIsReleased)
+    Lane* lane = nullptr;
+    while ((lane = getNextLane()) == nullptr && !mIsReleased)
     {
         mCondition.wait(lock);
     }
-    if (!mQueue.empty())
+    if (lane == nullptr)
+        return nullptr;
+
+    osg::ref_ptr<WorkItem> item = std::move(lane->mQueue.front());
+    lane->mQueue.pop_front();
+    ++lane->mActive;
+    ++lane->mStarted;
+    lane->mTotalLatency += std::chrono::steady_clock::now() - item->mQueued;
+    return item;
+}
+
+void WorkQueue::finishWorkItem(WorkItem& item)
+{
     {
-        osg::ref_ptr<WorkItem> item = std::move(mQueue.front());
-        mQueue.pop_front();
-        return item;
+        std::unique_lock<std::mutex> lock(mMutex);
+        --getLane(item.mPriority).mActive;
     }
-    return nullptr;
+    // A thread waiting for a lane at its limit may continue now
+    mCondition.notify_one();
 }
 
 unsigned int WorkQueue::getNumItems() const
 {
     std::unique_lock<std::mutex> lock(mMutex);
-    return mQueue.size();
+    return std::accumulate(mLanes.begin(), mLanes.end(), 0u,
+        [] (unsigned int r, const Lane& lane) { return r + static_cast<unsigned int>(lane.mQueue.size()); });
 }
 
 unsigned int WorkQueue::getNumActiveThreads() const
@@ -111,8 +162,33 @@ unsigned int WorkQueue::getNumActiveThreads() const
         [] (auto r, const auto& t) { return r + t->isActive(); });
 }
 
-WorkThread::WorkThread(WorkQueue& workQueue)
+void WorkQueue::reportStats(unsigned int frameNumber, osg::Stats& stats)
+{
+    static const std::array<std::string, 3> latencyNames {
+        "WorkQueue High Latency",
+        "WorkQueue Normal Latency",
+        "WorkQueue Low Latency",
+    };
+
+    stats.setAttribute(frameNumber, "WorkQueue", getNumItems());
+    stats.setAttribute(frameNumber, "WorkThread", getNumActiveThreads());
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (std::size_t i = 0; i < mLanes.size(); ++i)
+    {
+        Lane& lane = mLanes[i];
+        if (lane.mStarted == 0)
+            continue;
+        const std::chrono::duration<double, std::milli> latency = lane.mTotalLatency / lane.mStarted;
+        stats.setAttribute(frameNumber, latencyNames[i], latency.count());
+        lane.mTotalLatency = {};
+        lane.mStarted = 0;
+    }
+}
+
+WorkThread::WorkThread(WorkQueue& workQueue, std::optional<Misc::ThreadGroup> group)
     : mWorkQueue(&workQueue)
+    , mGroup(group)
     , mActive(false)
     , mThread([this] { run(); })
 {
@@ -125,13 +201,20 @@ WorkThread::~WorkThread()
 
 void WorkThread::run()
 {
+    Debug::Tracer::instance().setThreadName("WorkThread");
+    const std::shared_ptr<Misc::ThreadUsage> usage = Misc::ThreadBudget::instance().registerCurrentThread(mGroup);
     while (true)
     {
         osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
         if (!item)
             return;
         mActive = true;
-        item->doWork();
+        {
+            const Debug::ScopedTrace trace("SceneUtil::WorkItem");
+            const Misc::ScopedThreadBusy busy(usage.get());
+            item->doWork();
+        }
+        mWorkQueue->finishWorkItem(*item);
         item->signalDone();
         mActive = false;
     }
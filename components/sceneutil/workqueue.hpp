@@ -4,15 +4,35 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <optional>
+
+#include <components/misc/threadbudget.hpp>
+
+namespace osg
+{
+    class Stats;
+}
 
 namespace SceneUtil
 {
 
+    /// Lanes of the WorkQueue, threads take items from the first lane that has any.
+    enum class WorkPriority
+    {
+        /// Needed soon by the game, e.g. preloading cells the player is about to enter.
+        High,
+        Normal,
+        /// Not needed by the game, e.g. writing caches and screenshots.
+        Low,
+    };
+
     class WorkItem : public osg::Referenced
     {
     public:
@@ -30,44 +50,80 @@ namespace SceneUtil
         /// Set abort flag in order to return from doWork() as soon as possible. May not be respected by all WorkItems.
         virtual void abort() {}
 
+        /// Abort the work and skip it entirely if no thread has started it yet. The item is still signalled as done.
+        void cancel();
+
+        bool isCancelled() const { return mCancelled; }
+
     private:
         std::atomic_bool mDone {false};
+        std::atomic_bool mCancelled {false};
         std::mutex mMutex;
         std::condition_variable mCondition;
+
+        friend class WorkQueue;
+        WorkPriority mPriority = WorkPriority::Normal;
+        std::chrono::steady_clock::time_point mQueued;
     };
 
     class WorkThread;
 
     /// @brief A work queue that users can push work items onto, to be completed by one or more background threads.
-    /// @note Work items will be processed in the order that they were given in, however
+    /// @note Work items of the same priority will be processed in the order that they were given in, however
     /// if multiple work threads are involved then it is possible for a later item to complete before earlier items.
+    /// Items of a higher priority are taken first, the number of threads working on low priority items is limited
+    /// to keep threads available for more urgent work.
     class WorkQueue : public osg::Referenced
     {
     public:
-        WorkQueue(std::size_t workerThreads);
+        /// @param group subsystem the threads are accounted to by the thread budget
+        WorkQueue(std::size_t workerThreads, std::optional<Misc::ThreadGroup> group = std::nullopt);
         ~WorkQueue();
 
         void start(std::size_t workerThreads);
 
         void stop();
 
-        /// Add a new work item to the back of the queue.
+        /// Add a new work item to the back of the queue of its priority.
         /// @par The work item's waitTillDone() method may be used by the caller to wait until the work is complete.
-        /// @param front If true, add item to the front of the queue. If false (default), add to the back.
-        void addWorkItem(osg::ref_ptr<WorkItem> item, bool front=false);
+        /// @param front If true, add item to the front of the queue of its priority. If false (default), add to the back.
+        void addWorkItem(osg::ref_ptr<WorkItem> item, WorkPriority priority = WorkPriority::Normal, bool front = false);
 
         /// Get the next work item from the front of the queue. If the queue is empty, waits until a new item is added.
+        /// Cancelled items are signalled as done and skipped.
         /// If the workqueue is in the process of being destroyed, may return nullptr.
-        /// @par Used internally by the WorkThread.
+        /// @par Used internally by the WorkThread, which has to call finishWorkItem once the work is done.
         osg::ref_ptr<WorkItem> removeWorkItem();
 
+        /// @par Used internally by the WorkThread.
+        void finishWorkItem(WorkItem& item);
+
         unsigned int getNumItems() const;
 
         unsigned int getNumActiveThreads() const;
 
+        /// Report the number of queued items and active threads, and the mean time items of each priority waited
+        /// in the queue since the last report.
+        void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
     private:
+        struct Lane
+        {
+            std::deque<osg::ref_ptr<WorkItem>> mQueue;
+            std::size_t mActive = 0;
+            std::size_t mMaxActive = 0;
+            std::chrono::steady_clock::duration mTotalLatency {};
+            std::size_t mStarted = 0;
+        };
+
         bool mIsReleased;
-        std::deque<osg::ref_ptr<WorkItem> > mQueue;
+        const std::optional<Misc::ThreadGroup> mGroup;
+        std::array<Lane, 3> mLanes;
+
+        Lane& getLane(WorkPriority priority) { return mLanes[static_cast<std::size_t>(priority)]; }
+
+        /// Find the lane to take the next item from, nullptr if none of them may run one.
+        Lane* getNextLane();
 
         mutable std::mutex mMutex;
         std::condition_variable mCondition;
@@ -79,7 +135,7 @@ namespace SceneUtil
     class WorkThread
     {
     public:
-        WorkThread(WorkQueue& workQueue);
+        WorkThread(WorkQueue& workQueue, std::optional<Misc::ThreadGroup> group);
 
         ~WorkThread();
 
@@ -87,6 +143,7 @@ namespace SceneUtil
 
     private:
         WorkQueue* mWorkQueue;
+        const std::optional<Misc::ThreadGroup> mGroup;
         std::atomic<bool> mActive;
         std::thread mThread;
 
@@ -10,7 +10,7 @@
 
 void SceneUtil::writeScene(osg::Node *node, const std::string& filename, const std::string& format)
 {
-    registerSerializers();
+    skipGeometryDataSerialization();
 
     osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgt");
     if (!rw)
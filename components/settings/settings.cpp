@@ -12,12 +12,14 @@ namespace Settings
 CategorySettingValueMap Manager::mDefaultSettings = CategorySettingValueMap();
 CategorySettingValueMap Manager::mUserSettings = CategorySettingValueMap();
 CategorySettingVector Manager::mChangedSettings = CategorySettingVector();
+std::uint64_t Manager::mGeneration = 1;
 
 void Manager::clear()
 {
     mDefaultSettings.clear();
     mUserSettings.clear();
     mChangedSettings.clear();
+    ++mGeneration;
 }
 
 std::string Manager::load(const Files::ConfigurationManager& cfgMgr)
@@ -46,6 +48,8 @@ std::string Manager::load(const Files::ConfigurationManager& cfgMgr)
     if (boost::filesystem::exists(settingspath))
         parser.loadSettingsFile(settingspath, mUserSettings, false, false);
 
+    ++mGeneration;
+
     return settingspath;
 }
 
@@ -148,6 +152,7 @@ void Manager::setString(const std::string &setting, const std::string &category,
     mUserSettings[key] = value;
 
     mChangedSettings.insert(key);
+    ++mGeneration;
 }
 
 void Manager::setInt (const std::string& setting, const std::string& category, const int value)
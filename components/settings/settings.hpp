@@ -3,6 +3,7 @@
 
 #include "categories.hpp"
 
+#include <cstdint>
 #include <set>
 #include <map>
 #include <string>
@@ -68,6 +69,12 @@ namespace Settings
         static void setBool (const std::string& setting, const std::string& category, bool value);
         static void setVector2 (const std::string& setting, const std::string& category, osg::Vec2f value);
         static void setVector3 (const std::string& setting, const std::string& category, osg::Vec3f value);
+
+        static std::uint64_t getGeneration() { return mGeneration; }
+        ///< incremented whenever any setting value may have changed, used by SettingValue to refresh its cached value
+
+    private:
+        static std::uint64_t mGeneration;
     };
 
 }
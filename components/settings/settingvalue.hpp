@@ -0,0 +1,96 @@
+#ifndef COMPONENTS_SETTINGS_SETTINGVALUE_H
+#define COMPONENTS_SETTINGS_SETTINGVALUE_H
+
+#include "settings.hpp"
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Settings
+{
+    ///
+    /// \brief Typed handle to a single setting, parsed once and again only after any setting has been changed
+    ///
+    /// Reading the value compares the generation of the Manager with the one the value was parsed at, so the
+    /// handle sees changes right away, like the getters of the Manager do. Like the Manager itself it is not
+    /// thread safe, so it's meant to be used from the main thread.
+    ///
+    template <class T>
+    class SettingValue
+    {
+    public:
+        SettingValue(std::string setting, std::string category)
+            : mSetting(std::move(setting))
+            , mCategory(std::move(category))
+        {
+        }
+
+        const T& get() const
+        {
+            if (mGeneration != Manager::getGeneration())
+            {
+                mValue = parse();
+                mGeneration = Manager::getGeneration();
+            }
+            return mValue;
+        }
+
+        void set(const T& value) const
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                Manager::setBool(mSetting, mCategory, value);
+            else if constexpr (std::is_same_v<T, int>)
+                Manager::setInt(mSetting, mCategory, value);
+            else if constexpr (std::is_same_v<T, float>)
+                Manager::setFloat(mSetting, mCategory, value);
+            else if constexpr (std::is_same_v<T, double>)
+                Manager::setDouble(mSetting, mCategory, value);
+            else if constexpr (std::is_same_v<T, std::string>)
+                Manager::setString(mSetting, mCategory, value);
+            else if constexpr (std::is_same_v<T, osg::Vec2f>)
+                Manager::setVector2(mSetting, mCategory, value);
+            else
+            {
+                static_assert(std::is_same_v<T, osg::Vec3f>, "Unsupported setting type");
+                Manager::setVector3(mSetting, mCategory, value);
+            }
+        }
+
+        const std::string& getSetting() const { return mSetting; }
+
+        const std::string& getCategory() const { return mCategory; }
+
+    private:
+        const std::string mSetting;
+        const std::string mCategory;
+        mutable T mValue {};
+        mutable std::uint64_t mGeneration = 0;
+
+        T parse() const
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return Manager::getBool(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, int>)
+                return Manager::getInt(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, std::int64_t>)
+                return Manager::getInt64(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, float>)
+                return Manager::getFloat(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, double>)
+                return Manager::getDouble(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, std::string>)
+                return Manager::getString(mSetting, mCategory);
+            else if constexpr (std::is_same_v<T, osg::Vec2f>)
+                return Manager::getVector2(mSetting, mCategory);
+            else
+            {
+                static_assert(std::is_same_v<T, osg::Vec3f>, "Unsupported setting type");
+                return Manager::getVector3(mSetting, mCategory);
+            }
+        }
+    };
+}
+
+#endif // COMPONENTS_SETTINGS_SETTINGVALUE_H
@@ -2,12 +2,16 @@
 
 #include <fstream>
 #include <algorithm>
+#include <cstdint>
 #include <sstream>
 
+#include <osg/Drawable>
 #include <osg/Program>
+#include <osg/RenderInfo>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <components/debug/debuglog.hpp>
 #include <components/misc/stringops.hpp>
@@ -15,7 +19,131 @@
 namespace Shader
 {
 
+    namespace
+    {
+        constexpr char programBinaryMagic[8] = {'O', 'M', 'W', 'P', 'B', 'I', 'N', '1'};
+
+        /// FNV-1a, stored in the files as a second check next to the std::hash file name
+        std::uint64_t checksum(const std::string& value)
+        {
+            std::uint64_t result = 14695981039346656037ull;
+            for (const char c : value)
+            {
+                result ^= static_cast<unsigned char>(c);
+                result *= 1099511628211ull;
+            }
+            return result;
+        }
+
+        void writeProgramBinary(const std::string& path, std::uint64_t keyChecksum, const osg::Program::ProgramBinary& binary)
+        {
+            const boost::filesystem::path tempPath = path + ".tmp";
+            {
+                boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+                const std::uint32_t format = binary.getFormat();
+                const std::uint32_t size = binary.getSize();
+                stream.write(programBinaryMagic, sizeof(programBinaryMagic));
+                stream.write(reinterpret_cast<const char*>(&keyChecksum), sizeof(keyChecksum));
+                stream.write(reinterpret_cast<const char*>(&format), sizeof(format));
+                stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                stream.write(reinterpret_cast<const char*>(binary.getData()), size);
+                if (!stream)
+                {
+                    Log(Debug::Warning) << "Warning: Unable to write shader program binary " << path;
+                    return;
+                }
+            }
+            boost::system::error_code error;
+            boost::filesystem::rename(tempPath, path, error);
+            if (error)
+                Log(Debug::Warning) << "Warning: Unable to write shader program binary " << path << ": " << error.message();
+        }
+
+        osg::ref_ptr<osg::Program::ProgramBinary> readProgramBinary(const std::string& path, std::uint64_t keyChecksum)
+        {
+            boost::filesystem::ifstream stream(path, std::ios::binary);
+            if (!stream)
+                return nullptr;
+            char magic[sizeof(programBinaryMagic)];
+            std::uint64_t fileChecksum = 0;
+            std::uint32_t format = 0;
+            std::uint32_t size = 0;
+            stream.read(magic, sizeof(magic));
+            stream.read(reinterpret_cast<char*>(&fileChecksum), sizeof(fileChecksum));
+            stream.read(reinterpret_cast<char*>(&format), sizeof(format));
+            stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+            if (!stream || !std::equal(magic, magic + sizeof(magic), programBinaryMagic) || fileChecksum != keyChecksum || size == 0)
+                return nullptr;
+            osg::ref_ptr<osg::Program::ProgramBinary> binary = new osg::Program::ProgramBinary;
+            binary->allocate(size);
+            binary->setFormat(format);
+            stream.read(reinterpret_cast<char*>(binary->getData()), size);
+            if (!stream)
+                return nullptr;
+            return binary;
+        }
+    }
+
+    /// Retrieves the binaries of newly linked programs. Programs are linked when they are first applied, so this is
+    /// retried every frame until it happens.
+    class ProgramBinarySaver : public osg::Drawable
+    {
+    public:
+        ProgramBinarySaver()
+        {
+            setSupportsDisplayList(false);
+            setCullingActive(false);
+        }
+
+        void add(osg::Program* program, const std::string& path, std::uint64_t keyChecksum)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.push_back(Pending {program, path, keyChecksum});
+        }
+
+        void drawImplementation(osg::RenderInfo& renderInfo) const override
+        {
+            osg::State& state = *renderInfo.getState();
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto it = mPending.begin(); it != mPending.end();)
+            {
+                osg::ref_ptr<osg::Program> program;
+                if (!it->mProgram.lock(program))
+                {
+                    it = mPending.erase(it);
+                    continue;
+                }
+                osg::Program::PerContextProgram* pcp = program->getPCP(state);
+                if (!pcp || !pcp->isLinked())
+                {
+                    ++it;
+                    continue;
+                }
+                osg::ref_ptr<osg::Program::ProgramBinary> binary = pcp->compileProgramBinary(state);
+                if (binary && binary->getSize() > 0)
+                    writeProgramBinary(it->mPath, it->mChecksum, *binary);
+                it = mPending.erase(it);
+            }
+        }
+
+    private:
+        struct Pending
+        {
+            osg::observer_ptr<osg::Program> mProgram;
+            std::string mPath;
+            std::uint64_t mChecksum;
+        };
+
+        mutable std::vector<Pending> mPending;
+        mutable std::mutex mMutex;
+    };
+
     ShaderManager::ShaderManager()
+        : mProgramBinarySaver(new ProgramBinarySaver)
+    {
+    }
+
+    ShaderManager::~ShaderManager()
     {
     }
 
@@ -348,6 +476,7 @@ namespace Shader
             osg::ref_ptr<osg::Program> program = programTemplate ? cloneProgram(programTemplate) : osg::ref_ptr<osg::Program>(new osg::Program);
             program->addShader(vertexShader);
             program->addShader(fragmentShader);
+            setupProgramBinary(*program);
             found = mPrograms.insert(std::make_pair(std::make_pair(vertexShader, fragmentShader), program)).first;
         }
         return found->second;
@@ -383,6 +512,13 @@ namespace Shader
                 continue;
             shader->setShaderSource(shaderSource);
         }
+
+        // Binaries of the old sources must not be loaded when the programs are linked again
+        for (const auto& [_, program] : mPrograms)
+        {
+            program->setProgramBinary(nullptr);
+            setupProgramBinary(*program);
+        }
     }
 
     void ShaderManager::releaseGLObjects(osg::State *state)
@@ -397,4 +533,49 @@ namespace Shader
             program->releaseGLObjects(state);
     }
 
+    void ShaderManager::setProgramBinaryCache(const std::string& path, const std::string& driverId)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        boost::system::error_code error;
+        boost::filesystem::create_directories(path, error);
+        if (error)
+        {
+            Log(Debug::Warning) << "Warning: Unable to create shader cache directory " << path << ": " << error.message();
+            return;
+        }
+        mProgramBinaryPath = path;
+        mDriverId = driverId;
+    }
+
+    osg::Drawable* ShaderManager::getProgramBinarySaver()
+    {
+        return mProgramBinarySaver;
+    }
+
+    void ShaderManager::setupProgramBinary(osg::Program& program)
+    {
+        if (mProgramBinaryPath.empty())
+            return;
+
+        // Everything that affects linking: the driver, the sources and the bindings set up by program templates
+        std::ostringstream key;
+        key << mDriverId << '\0';
+        for (unsigned int i = 0; i < program.getNumShaders(); ++i)
+            key << program.getShader(i)->getType() << '\0' << program.getShader(i)->getShaderSource() << '\0';
+        for (const auto& [name, index] : program.getAttribBindingList())
+            key << "attrib " << name << ' ' << index << '\0';
+        for (const auto& [name, index] : program.getFragDataBindingList())
+            key << "fragdata " << name << ' ' << index << '\0';
+        for (const auto& [name, index] : program.getUniformBlockBindingList())
+            key << "block " << name << ' ' << index << '\0';
+        const std::string keyString = key.str();
+
+        const std::string path = Misc::StringUtils::format("%s/%016zx.bin", mProgramBinaryPath, std::hash<std::string>()(keyString));
+        const std::uint64_t keyChecksum = checksum(keyString);
+        if (osg::ref_ptr<osg::Program::ProgramBinary> binary = readProgramBinary(path, keyChecksum))
+            program.setProgramBinary(binary);
+        else
+            mProgramBinarySaver->add(&program, path, keyChecksum);
+    }
+
 }
@@ -4,14 +4,22 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #include <osg/ref_ptr>
+#include <osg/observer_ptr>
 
 #include <osg/Shader>
 #include <osg/Program>
 
+namespace osg
+{
+    class Drawable;
+}
+
 namespace Shader
 {
+    class ProgramBinarySaver;
 
     /// @brief Reads shader template files and turns them into a concrete shader, based on a list of define's.
     /// @par Shader templates can get the value of a define with the syntax @define.
@@ -20,6 +28,7 @@ namespace Shader
     public:
 
         ShaderManager();
+        ~ShaderManager();
 
         void setShaderPath(const std::string& path);
 
@@ -51,7 +60,17 @@ namespace Shader
 
         void releaseGLObjects(osg::State* state);
 
+        /// Keep the binaries of linked programs in the given directory and load them instead of linking the programs
+        /// again. Binaries are only reused with the driver they were created by, as identified by driverId.
+        /// @note Binaries can only be retrieved on the draw thread, so the drawable returned by getProgramBinarySaver()
+        /// has to be part of the rendered scene.
+        void setProgramBinaryCache(const std::string& path, const std::string& driverId);
+
+        osg::Drawable* getProgramBinarySaver();
+
     private:
+        void setupProgramBinary(osg::Program& program);
+
         std::string mPath;
 
         DefineMap mGlobalDefines;
@@ -70,6 +89,10 @@ namespace Shader
         std::mutex mMutex;
 
         osg::ref_ptr<const osg::Program> mProgramTemplate;
+
+        std::string mProgramBinaryPath;
+        std::string mDriverId;
+        osg::ref_ptr<ProgramBinarySaver> mProgramBinarySaver;
     };
 
     bool parseFors(std::string& source, const std::string& templateName);
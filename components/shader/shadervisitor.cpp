@@ -152,6 +152,7 @@ namespace Shader
         , mTexStageRequiringTangents(-1)
         , mSoftParticles(false)
         , mSoftParticleSize(0.f)
+        , mSkinning(false)
         , mNode(nullptr)
     {
     }
@@ -638,6 +639,9 @@ namespace Shader
         }
 
         defineMap["softParticles"] = reqs.mSoftParticles ? "1" : "0";
+        defineMap["instancing"] = mInstancing ? "1" : "0";
+        defineMap["skinning"] = reqs.mSkinning ? "1" : "0";
+        defineMap["maxBones"] = std::to_string(SceneUtil::RigGeometry::sMaxGpuSkinningBones);
 
         std::string shaderPrefix;
         if (!node.getUserValue("shaderPrefix", shaderPrefix))
@@ -648,7 +652,16 @@ namespace Shader
 
         if (vertexShader && fragmentShader)
         {
-            auto program = mShaderManager.getProgram(vertexShader, fragmentShader, mProgramTemplate);
+            osg::ref_ptr<const osg::Program> programTemplate = mProgramTemplate;
+            if (reqs.mSkinning)
+            {
+                const osg::Program* baseTemplate = mProgramTemplate ? mProgramTemplate.get() : mShaderManager.getProgramTemplate();
+                osg::ref_ptr<osg::Program> skinningTemplate = baseTemplate ? ShaderManager::cloneProgram(baseTemplate) : osg::ref_ptr<osg::Program>(new osg::Program);
+                skinningTemplate->addBindAttribLocation("aBoneIndices", 4);
+                skinningTemplate->addBindAttribLocation("aBoneWeights", 5);
+                programTemplate = skinningTemplate;
+            }
+            auto program = mShaderManager.getProgram(vertexShader, fragmentShader, programTemplate);
             writableStateSet->setAttributeAndModes(program, osg::StateAttribute::ON);
             addedState->setAttributeAndModes(program);
 
@@ -822,8 +835,10 @@ namespace Shader
     void ShaderVisitor::apply(osg::Drawable& drawable)
     {
         auto partsys = dynamic_cast<osgParticle::ParticleSystem*>(&drawable);
+        auto rig = dynamic_cast<SceneUtil::RigGeometry*>(&drawable);
 
-        bool needPop = drawable.getStateSet() || partsys;
+        // A skinned drawable needs its own program
+        bool needPop = drawable.getStateSet() || partsys || (rig && mGpuSkinning);
 
         if (needPop)
         {
@@ -841,10 +856,19 @@ namespace Shader
 
         if (!mRequirements.empty())
         {
+            if (rig && needPop)
+            {
+                ShaderRequirements& rigReqs = mRequirements.back();
+                rigReqs.mSkinning = mGpuSkinning && (rigReqs.mShaderRequired || mForceShaders) && mDefaultShaderPrefix == "objects"
+                    && rig->setGpuSkinning(true);
+            }
+            else if (rig)
+                rig->setGpuSkinning(false);
+
             const ShaderRequirements& reqs = mRequirements.back();
             createProgram(reqs);
 
-            if (auto rig = dynamic_cast<SceneUtil::RigGeometry*>(&drawable))
+            if (rig)
             {
                 osg::ref_ptr<osg::Geometry> sourceGeometry = rig->getSourceGeometry();
                 if (sourceGeometry && adjustGeometry(*sourceGeometry, reqs))
@@ -858,7 +882,11 @@ namespace Shader
             }
         }
         else
+        {
+            if (rig)
+                rig->setGpuSkinning(false);
             ensureFFP(drawable);
+        }
 
         if (needPop)
             popRequirements();
@@ -48,6 +48,12 @@ namespace Shader
 
         void setOpaqueDepthTex(osg::ref_ptr<osg::Texture2D> texture);
 
+        /// Geometry is drawn instanced, with per-instance offsets and rotations in the aOffset and aRotation attributes.
+        void setInstancing(bool instancing) { mInstancing = instancing; }
+
+        /// Skin RigGeometry in the vertex shader where possible, see SceneUtil::RigGeometry::setGpuSkinning.
+        void setGpuSkinning(bool skinning) { mGpuSkinning = skinning; }
+
         void apply(osg::Node& node) override;
 
         void apply(osg::Drawable& drawable) override;
@@ -73,6 +79,10 @@ namespace Shader
 
         bool mConvertAlphaTestToAlphaToCoverage;
 
+        bool mInstancing = false;
+
+        bool mGpuSkinning = false;
+
         ShaderManager& mShaderManager;
         Resource::ImageManager& mImageManager;
 
@@ -104,6 +114,8 @@ namespace Shader
             bool mSoftParticles;
             float mSoftParticleSize;
 
+            bool mSkinning;
+
             // the Node that requested these requirements
             osg::Node* mNode;
         };
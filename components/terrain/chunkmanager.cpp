@@ -1,12 +1,19 @@
 #include "chunkmanager.hpp"
 
+#include <iomanip>
 #include <sstream>
 
 #include <osg/Texture2D>
 #include <osg/Material>
 
+#include <osgDB/Registry>
+
 #include <osgUtil/IncrementalCompileOperation>
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
 #include <components/resource/objectcache.hpp>
 #include <components/resource/scenemanager.hpp>
 
@@ -74,6 +81,7 @@ osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f& cen
 void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
     stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
+    stats->setAttribute(frameNumber, "Terrain Chunk Memory", mCache->getMemoryUsage());
 }
 
 void ChunkManager::clearCache()
@@ -89,6 +97,56 @@ void ChunkManager::releaseGLObjects(osg::State *state)
     mBufferCache.releaseGLObjects(state);
 }
 
+void ChunkManager::setCompositeMapCachePath(const std::string& path)
+{
+    mCompositeMapCachePath.clear();
+    if (path.empty())
+        return;
+
+    boost::system::error_code error;
+    boost::filesystem::create_directories(path, error);
+    if (error)
+    {
+        Log(Debug::Warning) << "Warning: Unable to create composite map cache directory " << path << ": " << error.message();
+        return;
+    }
+    mCompositeMapCachePath = path;
+}
+
+std::string ChunkManager::getCompositeMapCacheFile(float chunkSize, const osg::Vec2f& chunkCenter)
+{
+    // The map only depends on the area it covers, its resolution and the textures painted on that area,
+    // so the vertex LOD of the chunk doesn't need to be part of the key
+    std::ostringstream stream;
+    stream << mCompositeMapCachePath << "/" << chunkCenter.x() << "_" << chunkCenter.y() << "_" << chunkSize
+           << "_" << mCompositeMapSize << "_" << std::hex << std::setfill('0') << std::setw(16)
+           << mStorage->getBlendmapHash(chunkSize, chunkCenter) << ".dds";
+    return stream.str();
+}
+
+osg::ref_ptr<osg::Texture2D> ChunkManager::loadCachedCompositeMap(const std::string& path)
+{
+    boost::filesystem::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return nullptr;
+
+    osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension("dds");
+    if (!reader)
+        return nullptr;
+
+    osgDB::ReaderWriter::ReadResult result = reader->readImage(stream);
+    if (!result.success() || !result.getImage() || result.getImage()->s() != static_cast<int>(mCompositeMapSize))
+    {
+        Log(Debug::Warning) << "Warning: Ignoring invalid cached composite map " << path;
+        return nullptr;
+    }
+
+    osg::ref_ptr<osg::Texture2D> texture = createCompositeMapRTT();
+    texture->setImage(result.getImage());
+    texture->setUnRefImageDataAfterApply(true);
+    return texture;
+}
+
 osg::ref_ptr<osg::Texture2D> ChunkManager::createCompositeMapRTT()
 {
     osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D;
@@ -190,7 +248,9 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
     if (!templateGeometry)
     {
         osg::ref_ptr<osg::Vec3Array> positions (new osg::Vec3Array);
-        osg::ref_ptr<osg::Vec3Array> normals (new osg::Vec3Array);
+        // Normals are packed into bytes, which is plenty for lighting and takes a quarter of the vertex memory
+        osg::ref_ptr<osg::Vec3bArray> normals (new osg::Vec3bArray);
+        normals->setNormalize(true);
         osg::ref_ptr<osg::Vec4ubArray> colors (new osg::Vec4ubArray);
         colors->setNormalize(true);
 
@@ -254,18 +314,31 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
     {
         if (useCompositeMap)
         {
-            osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
-            compositeMap->mTexture = createCompositeMapRTT();
+            std::string cacheFile;
+            osg::ref_ptr<osg::Texture2D> texture;
+            if (!mCompositeMapCachePath.empty())
+            {
+                cacheFile = getCompositeMapCacheFile(chunkSize, chunkCenter);
+                texture = loadCachedCompositeMap(cacheFile);
+            }
 
-            createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
+            if (!texture)
+            {
+                osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
+                compositeMap->mTexture = createCompositeMapRTT();
+                compositeMap->mCachePath = cacheFile;
 
-            mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+                createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
 
-            geometry->setCompositeMap(compositeMap);
-            geometry->setCompositeMapRenderer(mCompositeMapRenderer);
+                mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+
+                geometry->setCompositeMap(compositeMap);
+                geometry->setCompositeMapRenderer(mCompositeMapRenderer);
+                texture = compositeMap->mTexture;
+            }
 
             TextureLayer layer;
-            layer.mDiffuseMap = compositeMap->mTexture;
+            layer.mDiffuseMap = texture;
             layer.mParallax = false;
             layer.mSpecular = false;
             geometry->setPasses(::Terrain::createPasses(mSceneManager->getForceShaders() || !mSceneManager->getClampLighting(), &mSceneManager->getShaderManager(), std::vector<TextureLayer>(1, layer), std::vector<osg::ref_ptr<osg::Texture2D> >(), 1.f, 1.f));
@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 #define OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 
+#include <string>
 #include <tuple>
 
 #include <components/resource/resourcemanager.hpp>
@@ -42,6 +43,9 @@ namespace Terrain
         void setCompositeMapLevel(float level) { mCompositeMapLevel = level; }
         void setMaxCompositeGeometrySize(float maxCompGeometrySize) { mMaxCompGeometrySize = maxCompGeometrySize; }
 
+        /// Load finished composite maps from, and save them to, the given directory. An empty path disables the cache.
+        void setCompositeMapCachePath(const std::string& path);
+
         void setNodeMask(unsigned int mask) { mNodeMask = mask; }
         unsigned int getNodeMask() override { return mNodeMask; }
 
@@ -60,6 +64,10 @@ namespace Terrain
 
         std::vector<osg::ref_ptr<osg::StateSet> > createPasses(float chunkSize, const osg::Vec2f& chunkCenter, bool forCompositeMap);
 
+        std::string getCompositeMapCacheFile(float chunkSize, const osg::Vec2f& chunkCenter);
+
+        osg::ref_ptr<osg::Texture2D> loadCachedCompositeMap(const std::string& path);
+
         Terrain::Storage* mStorage;
         Resource::SceneManager* mSceneManager;
         TextureManager* mTextureManager;
@@ -73,6 +81,8 @@ namespace Terrain
         unsigned int mCompositeMapSize;
         float mCompositeMapLevel;
         float mMaxCompGeometrySize;
+
+        std::string mCompositeMapCachePath;
     };
 
 }
@@ -4,11 +4,68 @@
 #include <osg/Texture2D>
 #include <osg/RenderInfo>
 
+#include <osgDB/Registry>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
 
+#include <components/debug/debuglog.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
 namespace Terrain
 {
 
+namespace
+{
+    void writeCompositeMap(const osg::Image& image, const std::string& path)
+    {
+        osgDB::ReaderWriter* writer = osgDB::Registry::instance()->getReaderWriterForExtension("dds");
+        if (!writer)
+        {
+            Log(Debug::Error) << "Error: Unable to write composite map, can't find a dds ReaderWriter";
+            return;
+        }
+
+        // Write to a temporary file first so that a concurrent load never sees a partial map
+        const boost::filesystem::path tempPath = path + ".tmp";
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            osgDB::ReaderWriter::WriteResult result = writer->writeImage(image, stream);
+            if (!result.success() || !stream)
+            {
+                Log(Debug::Warning) << "Warning: Unable to write composite map " << path << ": " << result.message();
+                return;
+            }
+        }
+
+        boost::system::error_code error;
+        boost::filesystem::rename(tempPath, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: Unable to write composite map " << path << ": " << error.message();
+    }
+
+    class WriteCompositeMapWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        WriteCompositeMapWorkItem(osg::ref_ptr<osg::Image> image, const std::string& path)
+            : mImage(std::move(image))
+            , mPath(path)
+        {
+        }
+
+        void doWork() override
+        {
+            writeCompositeMap(*mImage, mPath);
+        }
+
+    private:
+        osg::ref_ptr<osg::Image> mImage;
+        std::string mPath;
+    };
+}
+
 CompositeMapRenderer::CompositeMapRenderer()
     : mTargetFrameRate(120)
     , mMinimumTimeAvailable(0.0025)
@@ -138,14 +195,52 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
         }
     }
     if (compositeMap.mCompiled == compositeMap.mDrawables.size())
+    {
         compositeMap.mDrawables = std::vector<osg::ref_ptr<osg::Drawable>>();
 
+        if (!compositeMap.mCachePath.empty())
+            saveCompositeMap(compositeMap, state);
+    }
+
     state.haveAppliedAttribute(osg::StateAttribute::VIEWPORT);
 
     GLuint fboId = state.getGraphicsContext() ? state.getGraphicsContext()->getDefaultFboId() : 0;
     ext->glBindFramebuffer(GL_FRAMEBUFFER_EXT, fboId);
 }
 
+void CompositeMapRenderer::saveCompositeMap(const CompositeMap& compositeMap, osg::State& state) const
+{
+    osg::GLExtensions* ext = state.get<osg::GLExtensions>();
+    if (!ext->isTextureCompressionS3TCSupported)
+        return;
+
+    const int width = compositeMap.mTexture->getTextureWidth();
+    const int height = compositeMap.mTexture->getTextureHeight();
+
+    // Let the driver compress the finished map while copying it out of the framebuffer
+    mFBO->apply(state, osg::FrameBufferObject::READ_FRAMEBUFFER);
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0, 0, width, height, 0);
+
+    osg::ref_ptr<osg::Image> image = new osg::Image;
+    image->readImageFromCurrentTexture(state.getContextID(), false);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &texture);
+    state.haveAppliedTextureAttribute(state.getActiveTextureUnit(), osg::StateAttribute::TEXTURE);
+
+    if (!image->data())
+        return;
+
+    if (mWorkQueue)
+        mWorkQueue->addWorkItem(new WriteCompositeMapWorkItem(image, compositeMap.mCachePath), SceneUtil::WorkPriority::Low);
+    else
+        writeCompositeMap(*image, compositeMap.mCachePath);
+}
+
 void CompositeMapRenderer::setMinimumTimeAvailableForCompile(double time)
 {
     mMinimumTimeAvailable = time;
@@ -184,6 +279,11 @@ unsigned int CompositeMapRenderer::getCompileSetSize() const
     return mCompileSet.size();
 }
 
+void CompositeMapRenderer::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+{
+    mWorkQueue = workQueue;
+}
+
 CompositeMap::CompositeMap()
     : mCompiled(0)
 {
@@ -5,6 +5,7 @@
 
 #include <set>
 #include <mutex>
+#include <string>
 
 namespace osg
 {
@@ -13,6 +14,11 @@ namespace osg
     class Texture2D;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
 
@@ -24,6 +30,8 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable> > mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+        /// If not empty, the finished map is compressed and written to this file
+        std::string mCachePath;
     };
 
     /**
@@ -53,7 +61,12 @@ namespace Terrain
 
         unsigned int getCompileSetSize() const;
 
+        /// Set the queue used to write composite maps to the disk cache. If null, they are written on the draw thread.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
     private:
+        void saveCompositeMap(const CompositeMap& compositeMap, osg::State& state) const;
+
         float mTargetFrameRate;
         double mMinimumTimeAvailable;
         mutable osg::Timer mTimer;
@@ -66,6 +79,8 @@ namespace Terrain
         mutable std::mutex mMutex;
 
         osg::ref_ptr<osg::FrameBufferObject> mFBO;
+
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
     };
 
 }
@@ -4,11 +4,14 @@
 #include <osg/ShapeDrawable>
 #include <osg/PolygonMode>
 #include <osg/Material>
+#include <osg/OcclusionQueryNode>
 
+#include <algorithm>
 #include <limits>
 
 #include <components/misc/constants.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/nodecallback.hpp>
 #include <components/loadinglistener/reporter.hpp>
 #include <components/resource/resourcesystem.hpp>
 
@@ -39,6 +42,21 @@ namespace
         return 1 << depth;
     }
 
+    class CountTraversalCallback : public SceneUtil::NodeCallback<CountTraversalCallback>
+    {
+    public:
+        CountTraversalCallback(std::atomic<unsigned int>& counter) : mCounter(counter) {}
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv)
+        {
+            ++mCounter;
+            traverse(node, nv);
+        }
+
+    private:
+        std::atomic<unsigned int>& mCounter;
+    };
+
     unsigned int Log2( unsigned int n )
     {
         unsigned int targetlevel = 0;
@@ -279,6 +297,9 @@ QuadTreeWorld::QuadTreeWorld(osg::Group *parent, osg::Group *compileRoot, Resour
     , mViewDistance(std::numeric_limits<float>::max())
     , mMinSize(1/8.f)
     , mDebugTerrainChunks(debugChunks)
+    , mOcclusionCulling(false)
+    , mOcclusionTested(0)
+    , mOcclusionVisible(0)
 {
     mChunkManager->setCompositeMapSize(compMapResolution);
     mChunkManager->setCompositeMapLevel(compMapLevel);
@@ -378,7 +399,24 @@ void QuadTreeWorld::loadRenderingNode(ViewDataEntry& entry, ViewData* vd, float
         for (QuadTreeWorld::ChunkManager* m : mChunkManagers)
         {
             osg::ref_ptr<osg::Node> n = m->getChunk(entry.mNode->getSize(), entry.mNode->getCenter(), DefaultLodCallback::getNativeLodLevel(entry.mNode, mMinSize), entry.mLodFlags, activeGrid, vd->getViewPoint(), compile);
-            if (n) pat->addChild(n);
+            if (!n)
+                continue;
+            // The terrain is the main occluder and has to stay the first child for the water culling
+            if (mOcclusionCulling && m != mChunkManager.get() && m != mDebugChunkManager.get())
+            {
+                // Accessed by the cull callbacks only, so the counts are those of all cameras
+                osg::ref_ptr<osg::Group> visible = new osg::Group;
+                visible->addCullCallback(new CountTraversalCallback(mOcclusionVisible));
+                visible->addChild(n);
+
+                osg::ref_ptr<osg::OcclusionQueryNode> query = new osg::OcclusionQueryNode;
+                query->setQueriesEnabled(true);
+                query->setVisibilityThreshold(0);
+                query->addCullCallback(new CountTraversalCallback(mOcclusionTested));
+                query->addChild(visible);
+                n = query;
+            }
+            pat->addChild(n);
         }
         entry.mRenderingNode = pat;
     }
@@ -446,34 +484,46 @@ void QuadTreeWorld::accept(osg::NodeVisitor &nv)
     osg::Object * viewer = isCullVisitor ? static_cast<osgUtil::CullVisitor*>(&nv)->getCurrentCamera() : nullptr;
     bool needsUpdate = true;
     osg::Vec3f viewPoint = viewer ? nv.getViewPoint() : nv.getEyePoint();
+    const float cellWorldSize = mStorage->getCellWorldSize();
+    const double referenceTime = nv.getFrameStamp() ? nv.getFrameStamp()->getReferenceTime() : 0.0;
+
+    // The map of views is locked only to pick a view, each view is locked on its own while in use so that
+    // cameras culled concurrently traverse the quad tree and create their chunks in parallel.
+    // A view must never be locked while waiting for mViewDataMutex.
+    std::unique_lock<std::mutex> lock(mViewDataMutex);
     ViewData *vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate);
+    // keep the view from being cleared by another traversal while it is in use
+    if (referenceTime != 0.0)
+        vd->setLastUsageTimeStamp(referenceTime);
+    const osg::Vec4i activeGrid = mActiveGrid;
+    std::unique_lock<std::shared_mutex> viewLock(vd->getMutex());
+    lock.unlock();
+
     if (needsUpdate)
     {
         vd->reset();
-        DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, mActiveGrid);
+        DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, activeGrid);
         mRootNode->traverseNodes(vd, viewPoint, &lodCallback);
     }
 
-    const float cellWorldSize = mStorage->getCellWorldSize();
-
     for (unsigned int i=0; i<vd->getNumEntries(); ++i)
+        loadRenderingNode(vd->getEntry(i), vd, cellWorldSize, activeGrid, false);
+    viewLock.unlock();
+
     {
-        ViewDataEntry& entry = vd->getEntry(i);
-        loadRenderingNode(entry, vd, cellWorldSize, mActiveGrid, false);
-        entry.mRenderingNode->accept(nv);
+        const std::shared_lock<std::shared_mutex> readLock(vd->getMutex());
+        for (unsigned int i=0; i<vd->getNumEntries(); ++i)
+            vd->getEntry(i).mRenderingNode->accept(nv);
     }
 
+    lock.lock();
     if (mHeightCullCallback && isCullVisitor)
-        updateWaterCullingView(mHeightCullCallback, vd, static_cast<osgUtil::CullVisitor*>(&nv), mStorage->getCellWorldSize(), !isGridEmpty());
+        updateWaterCullingView(mHeightCullCallback, vd, static_cast<osgUtil::CullVisitor*>(&nv), cellWorldSize, !isGridEmpty());
 
     vd->setChanged(false);
 
-    double referenceTime = nv.getFrameStamp() ? nv.getFrameStamp()->getReferenceTime() : 0.0;
     if (referenceTime != 0.0)
-    {
-        vd->setLastUsageTimeStamp(referenceTime);
         mViewDataMap->clearUnusedViews(referenceTime);
-    }
 }
 
 void QuadTreeWorld::ensureQuadTreeBuilt()
@@ -553,6 +603,13 @@ void QuadTreeWorld::reportStats(unsigned int frameNumber, osg::Stats *stats)
 {
     if (mCompositeMapRenderer)
         stats->setAttribute(frameNumber, "Composite", mCompositeMapRenderer->getCompileSetSize());
+    if (mOcclusionCulling)
+    {
+        const unsigned int tested = mOcclusionTested.exchange(0);
+        const unsigned int visible = mOcclusionVisible.exchange(0);
+        stats->setAttribute(frameNumber, "Occlusion Tested", tested);
+        stats->setAttribute(frameNumber, "Occlusion Culled", tested - std::min(tested, visible));
+    }
 }
 
 void QuadTreeWorld::loadCell(int x, int y)
@@ -588,6 +645,20 @@ void QuadTreeWorld::rebuildViews()
     mViewDataMap->rebuildViews();
 }
 
+void QuadTreeWorld::setOcclusionCulling(bool enabled)
+{
+    if (mOcclusionCulling == enabled)
+        return;
+    mOcclusionCulling = enabled;
+    mViewDataMap->rebuildViews();
+}
+
+void QuadTreeWorld::setCompositeMapCache(const std::string& path, SceneUtil::WorkQueue* workQueue)
+{
+    mChunkManager->setCompositeMapCachePath(path);
+    mCompositeMapRenderer->setWorkQueue(workQueue);
+}
+
 void QuadTreeWorld::setViewDistance(float viewDistance)
 {
     if (mViewDistance == viewDistance)
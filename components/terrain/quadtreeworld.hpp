@@ -4,14 +4,21 @@
 #include "world.hpp"
 #include "terraingrid.hpp"
 
+#include <atomic>
 #include <mutex>
 #include <memory>
+#include <string>
 
 namespace osg
 {
     class NodeVisitor;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
     class RootNode;
@@ -45,6 +52,14 @@ namespace Terrain
         void preload(View* view, const osg::Vec3f& eyePoint, const osg::Vec4i &cellgrid, std::atomic<bool>& abort, Loading::Reporter& reporter) override;
         void rebuildViews() override;
 
+        /// Wrap the chunks of all chunk managers except the terrain itself in hardware occlusion queries, so that paged
+        /// objects hidden behind nearer geometry are skipped. Query results lag a frame behind.
+        void setOcclusionCulling(bool enabled);
+
+        /// Keep finished composite maps in the given directory, so that they are loaded with their chunk
+        /// rather than rendered again. Files are written using the work queue, if one is given.
+        void setCompositeMapCache(const std::string& path, SceneUtil::WorkQueue* workQueue);
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) override;
 
         class ChunkManager
@@ -73,6 +88,9 @@ namespace Terrain
         osg::ref_ptr<RootNode> mRootNode;
 
         osg::ref_ptr<ViewDataMap> mViewDataMap;
+        // cameras may be culled concurrently, see SceneUtil::RTTCullQueue
+        // guards mViewDataMap, the entries of each view are guarded by ViewData::getMutex()
+        std::mutex mViewDataMutex;
 
         std::vector<ChunkManager*> mChunkManagers;
 
@@ -84,6 +102,9 @@ namespace Terrain
         float mMinSize;
         bool mDebugTerrainChunks;
         std::unique_ptr<DebugChunkManager> mDebugChunkManager;
+        bool mOcclusionCulling;
+        std::atomic<unsigned int> mOcclusionTested;
+        std::atomic<unsigned int> mOcclusionVisible;
     };
 
 }
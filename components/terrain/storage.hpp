@@ -55,11 +55,11 @@ namespace Terrain
         /// @param size size of the terrain chunk in cell units
         /// @param center center of the chunk in cell units
         /// @param positions buffer to write vertices
-        /// @param normals buffer to write vertex normals
+        /// @param normals buffer to write vertex normals, as signed bytes normalized to [-1, 1]
         /// @param colours buffer to write vertex colours
         virtual void fillVertexBuffers (int lodLevel, float size, const osg::Vec2f& center,
                                 osg::ref_ptr<osg::Vec3Array> positions,
-                                osg::ref_ptr<osg::Vec3Array> normals,
+                                osg::ref_ptr<osg::Vec3bArray> normals,
                                 osg::ref_ptr<osg::Vec4ubArray> colours) = 0;
 
         typedef std::vector<osg::ref_ptr<osg::Image> > ImageVector;
@@ -74,8 +74,22 @@ namespace Terrain
         virtual void getBlendmaps (float chunkSize, const osg::Vec2f& chunkCenter, ImageVector& blendmaps,
                                std::vector<LayerInfo>& layerList) = 0;
 
+        /// Get a hash of the layer textures and blend values that getBlendmaps would produce for a terrain chunk.
+        /// Used to tell whether a cached composite map was created from the same data.
+        /// @note May be called from background threads. Make sure to only call thread-safe functions from here!
+        virtual std::size_t getBlendmapHash (float chunkSize, const osg::Vec2f& chunkCenter) = 0;
+
         virtual float getHeightAt (const osg::Vec3f& worldPos) = 0;
 
+        /// Get the heights at many positions at once, as getHeightAt would for each of them.
+        /// @note Faster than single queries for positions close to each other, like samples around an actor.
+        virtual void getHeightsAt (const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights)
+        {
+            heights.resize(worldPositions.size());
+            for (std::size_t i = 0; i < worldPositions.size(); ++i)
+                heights[i] = getHeightAt(worldPositions[i]);
+        }
+
         /// Get the transformation factor for mapping cell units to world units.
         virtual float getCellWorldSize() = 0;
 
@@ -118,9 +118,12 @@ ViewData *ViewDataMap::getViewData(osg::Object *viewer, const osg::Vec3f& viewPo
     if (!(vd->suitableToUse(activeGrid) && (vd->getViewPoint()-viewPoint).length2() < mReuseDistance*mReuseDistance && vd->getWorldUpdateRevision() >= mWorldUpdateRevision))
     {
         float shortestDist = viewer ? mReuseDistance*mReuseDistance : std::numeric_limits<float>::max();
-        const ViewData* mostSuitableView = nullptr;
-        for (const ViewData* other : mUsedViews)
+        ViewData* mostSuitableView = nullptr;
+        for (ViewData* other : mUsedViews)
         {
+            const std::shared_lock<std::shared_mutex> lock(other->getMutex(), std::try_to_lock);
+            if (!lock.owns_lock())
+                continue;
             if (other->suitableToUse(activeGrid) && other->getWorldUpdateRevision() >= mWorldUpdateRevision)
             {
                 float dist = (viewPoint-other->getViewPoint()).length2();
@@ -133,6 +136,8 @@ ViewData *ViewDataMap::getViewData(osg::Object *viewer, const osg::Vec3f& viewPo
         }
         if (mostSuitableView && mostSuitableView != vd)
         {
+            // Can't be updated meanwhile, its owner needs the lock of the caller to start that
+            const std::shared_lock<std::shared_mutex> lock(mostSuitableView->getMutex());
             vd->copyFrom(*mostSuitableView);
             return vd;
         }
@@ -189,6 +194,12 @@ void ViewDataMap::clearUnusedViews(double referenceTime)
     {
         if ((*it)->getLastUsageTimeStamp() + mExpiryDelay < referenceTime)
         {
+            const std::unique_lock<std::shared_mutex> lock((*it)->getMutex(), std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                ++it;
+                continue;
+            }
             (*it)->clear();
             mUnusedViews.push_back(*it);
             it = mUsedViews.erase(it);
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <deque>
+#include <shared_mutex>
 
 #include <osg/Node>
 
@@ -66,7 +67,12 @@ namespace Terrain
         unsigned int getWorldUpdateRevision() const { return mWorldUpdateRevision; }
         void setWorldUpdateRevision(int updateRevision) { mWorldUpdateRevision = updateRevision; }
 
+        /// Held exclusively while the entries are updated and shared while they are read, so views of
+        /// cameras culled concurrently can be traversed in parallel and copied from each other.
+        std::shared_mutex& getMutex() { return mMutex; }
+
     private:
+        std::shared_mutex mMutex;
         std::vector<ViewDataEntry> mEntries;
         unsigned int mNumEntries;
         double mLastUsageTimeStamp;
@@ -87,6 +93,7 @@ namespace Terrain
             , mWorldUpdateRevision(0)
         {}
 
+        /// @note Views being updated by another thread are not considered for reuse.
         ViewData* getViewData(osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i &activeGrid, bool& needsUpdate);
 
         ViewData* createOrReuseView();
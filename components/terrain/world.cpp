@@ -123,6 +123,11 @@ float World::getHeightAt(const osg::Vec3f &worldPos)
     return mStorage->getHeightAt(worldPos);
 }
 
+void World::getHeightsAt(const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights)
+{
+    mStorage->getHeightsAt(worldPositions, heights);
+}
+
 void World::updateTextureFiltering()
 {
     if (mTextureManager)
@@ -9,6 +9,7 @@
 #include <limits>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include <components/sceneutil/nodecallback.hpp>
 
@@ -119,6 +120,8 @@ namespace Terrain
 
         float getHeightAt (const osg::Vec3f& worldPos);
 
+        void getHeightsAt (const std::vector<osg::Vec3f>& worldPositions, std::vector<float>& heights);
+
         /// Clears the cached land and landtexture data.
         /// @note Thread safe.
         virtual void clearAssociatedCaches();
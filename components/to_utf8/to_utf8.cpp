@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <algorithm>
 
@@ -47,14 +50,47 @@ using namespace ToUTF8;
 
 namespace
 {
-    std::string_view::iterator skipAscii(std::string_view input)
+    constexpr std::uint64_t ones = 0x0101010101010101ull;
+    constexpr std::uint64_t highBits = 0x80 * ones;
+
+    /// Returns the position of the first zero or non-ASCII character, or the size of the input if there is none.
+    /// The input is checked a word at a time, a word has such a character if any of its bytes has the high bit
+    /// set or becomes negative when one is subtracted.
+    std::size_t skipAscii(std::string_view input, std::size_t pos = 0)
+    {
+        for (std::uint64_t word; pos + sizeof(word) <= input.size(); pos += sizeof(word))
+        {
+            std::memcpy(&word, input.data() + pos, sizeof(word));
+            if (((word - ones) | word) & highBits)
+                break;
+        }
+        for (; pos < input.size(); ++pos)
+        {
+            const unsigned char v = input[pos];
+            if (v == 0 || v >= 128)
+                break;
+        }
+        return pos;
+    }
+
+    bool isContinuation(unsigned char ch)
+    {
+        return (ch & 0xC0) == 0x80;
+    }
+
+    std::size_t getTwoBytesIndex(unsigned char ch1, unsigned char ch2)
     {
-        return std::find_if(input.begin(), input.end(), [] (unsigned char v) { return v == 0 || v >= 128; });
+        return (static_cast<std::size_t>(ch1 & 0x1F) << 6) | (ch2 & 0x3F);
+    }
+
+    std::size_t getThreeBytesIndex(unsigned char ch2, unsigned char ch3)
+    {
+        return (static_cast<std::size_t>(ch2 & 0x3F) << 6) | (ch3 & 0x3F);
     }
 }
 
 Utf8Encoder::Utf8Encoder(const FromType sourceEncoding):
-    mOutput(50*1024)
+    mOutput(50*1024, '\0')
 {
     switch (sourceEncoding)
     {
@@ -84,9 +120,28 @@ Utf8Encoder::Utf8Encoder(const FromType sourceEncoding):
             assert(0);
         }
     }
+
+    // Reverse tables for the conversion back to the legacy encoding. Fill them from the end so the lowest
+    // character wins if several ones share a sequence, like the linear search used to do.
+    mFromTwoBytes.fill(0);
+    mFromThreeBytes.fill(0);
+    for (int i = 255; i >= 128; --i)
+    {
+        const signed char* in = translationArray + i * 6;
+        const unsigned char b1 = in[1], b2 = in[2], b3 = in[3];
+        if (in[0] == 2 && b1 >= 0xC0 && isContinuation(b2))
+            mFromTwoBytes[getTwoBytesIndex(b1, b2)] = static_cast<unsigned char>(i);
+        else if (in[0] == 3 && b1 == 0xE2 && isContinuation(b2) && isContinuation(b3))
+            mFromThreeBytes[getThreeBytesIndex(b2, b3)] = static_cast<unsigned char>(i);
+    }
 }
 
 std::string_view Utf8Encoder::getUtf8(std::string_view input)
+{
+    return getUtf8(input, mOutput);
+}
+
+std::string_view Utf8Encoder::getUtf8(std::string_view input, std::string& buffer) const
 {
     if (input.empty())
         return input;
@@ -105,25 +160,37 @@ std::string_view Utf8Encoder::getUtf8(std::string_view input)
     if(ascii)
         return std::string_view(input.data(), outlen);
 
-    // Make sure the output is large enough
-    resize(outlen);
-    char *out = &mOutput[0];
+    // Make sure the output is large enough, std::string keeps its capacity
+    // and the terminating zero
+    buffer.resize(outlen);
+    char *out = buffer.data();
 
-    // Translate
-    for (auto it = input.begin(); it != input.end() && *it != 0; ++it)
-        copyFromArray(*it, out);
+    // Translate, copying the ASCII runs as a whole
+    std::size_t pos = 0;
+    while (pos < input.size())
+    {
+        const std::size_t asciiEnd = skipAscii(input, pos);
+        std::memcpy(out, input.data() + pos, asciiEnd - pos);
+        out += asciiEnd - pos;
+        pos = asciiEnd;
+        if (pos == input.size() || input[pos] == 0)
+            break;
+        for (; pos < input.size() && static_cast<unsigned char>(input[pos]) >= 128; ++pos)
+            copyFromArray(input[pos], out);
+    }
 
     // Make sure that we wrote the correct number of bytes
-    assert((out-&mOutput[0]) == (int)outlen);
+    assert(out - buffer.data() == static_cast<std::ptrdiff_t>(outlen));
 
-    // And make extra sure the output is null terminated
-    assert(mOutput.size() > outlen);
-    assert(mOutput[outlen] == 0);
-
-    return std::string_view(mOutput.data(), outlen);
+    return std::string_view(buffer.data(), outlen);
 }
 
 std::string_view Utf8Encoder::getLegacyEnc(std::string_view input)
+{
+    return getLegacyEnc(input, mOutput);
+}
+
+std::string_view Utf8Encoder::getLegacyEnc(std::string_view input, std::string& buffer) const
 {
     if (input.empty())
         return input;
@@ -143,34 +210,26 @@ std::string_view Utf8Encoder::getLegacyEnc(std::string_view input)
         return std::string_view(input.data(), outlen);
 
     // Make sure the output is large enough
-    resize(outlen);
-    char *out = &mOutput[0];
+    buffer.resize(outlen);
+    char *out = buffer.data();
 
-    // Translate
-    for (auto it = input.begin(); it != input.end() && *it != 0;)
-        copyFromArrayLegacyEnc(it, input.end(), out);
+    // Translate, copying the ASCII runs as a whole
+    std::size_t pos = 0;
+    while (pos < input.size())
+    {
+        const std::size_t asciiEnd = skipAscii(input, pos);
+        std::memcpy(out, input.data() + pos, asciiEnd - pos);
+        out += asciiEnd - pos;
+        pos = asciiEnd;
+        if (pos == input.size() || input[pos] == 0)
+            break;
+        copyFromArrayLegacyEnc(input, pos, out);
+    }
 
     // Make sure that we wrote the correct number of bytes
-    assert((out-&mOutput[0]) == (int)outlen);
+    assert(out - buffer.data() == static_cast<std::ptrdiff_t>(outlen));
 
-    // And make extra sure the output is null terminated
-    assert(mOutput.size() > outlen);
-    assert(mOutput[outlen] == 0);
-
-    return std::string_view(mOutput.data(), outlen);
-}
-
-// Make sure the output vector is large enough for 'size' bytes,
-// including a terminating zero after it.
-void Utf8Encoder::resize(size_t size)
-{
-    if (mOutput.size() <= size)
-        // Add some extra padding to reduce the chance of having to resize
-        // again later.
-        mOutput.resize(3*size);
-
-    // And make sure the string is zero terminated
-    mOutput[size] = 0;
+    return std::string_view(buffer.data(), outlen);
 }
 
 /** Get the total length length needed to decode the given string with
@@ -187,24 +246,26 @@ std::pair<std::size_t, bool> Utf8Encoder::getLength(std::string_view input) cons
 {
     // Do away with the ascii part of the string first (this is almost
     // always the entire string.)
-    auto it = skipAscii(input);
+    std::size_t pos = skipAscii(input);
 
     // If we're not at the null terminator at this point, then there
     // were some non-ascii characters to deal with. Go to slow-mode for
     // the rest of the string.
-    if (it == input.end() || *it == 0)
-        return {it - input.begin(), true};
+    if (pos == input.size() || input[pos] == 0)
+        return {pos, true};
 
-    std::size_t len = it - input.begin();
+    std::size_t len = pos;
 
-    do
+    while (pos < input.size() && input[pos] != 0)
     {
-        // Find the translated length of this character in the
-        // lookup table.
-        len += translationArray[static_cast<unsigned char>(*it) * 6];
-        ++it;
+        // Find the translated length of the non-ascii characters in the
+        // lookup table, the ascii runs between them are counted as a whole.
+        for (; pos < input.size() && static_cast<unsigned char>(input[pos]) >= 128; ++pos)
+            len += translationArray[static_cast<unsigned char>(input[pos]) * 6];
+        const std::size_t asciiEnd = skipAscii(input, pos);
+        len += asciiEnd - pos;
+        pos = asciiEnd;
     }
-    while (it != input.end() && *it != 0);
 
     return {len, false};
 }
@@ -230,7 +291,7 @@ std::pair<std::size_t, bool> Utf8Encoder::getLengthLegacyEnc(std::string_view in
 {
     // Do away with the ascii part of the string first (this is almost
     // always the entire string.)
-    auto it = skipAscii(input);
+    auto it = input.begin() + skipAscii(input);
 
     // If we're not at the null terminator at this point, then there
     // were some non-ascii characters to deal with. Go to slow-mode for
@@ -271,9 +332,9 @@ std::pair<std::size_t, bool> Utf8Encoder::getLengthLegacyEnc(std::string_view in
     return {len, false};
 }
 
-void Utf8Encoder::copyFromArrayLegacyEnc(std::string_view::iterator& chp, std::string_view::iterator end, char* &out) const
+void Utf8Encoder::copyFromArrayLegacyEnc(std::string_view input, std::size_t& pos, char* &out) const
 {
-    unsigned char ch = *(chp++);
+    unsigned char ch = input[pos++];
     // Optimize for ASCII values
     if (ch < 128)
     {
@@ -302,26 +363,28 @@ void Utf8Encoder::copyFromArrayLegacyEnc(std::string_view::iterator& chp, std::s
         return;
     }
 
-    if (chp == end)
+    if (pos == input.size())
         return;
 
-    unsigned char ch2 = *(chp++);
+    unsigned char ch2 = input[pos++];
     unsigned char ch3 = '\0';
     if (len == 3)
     {
-        if (chp == end)
+        if (pos == input.size())
             return;
-        ch3 = *(chp++);
+        ch3 = input[pos++];
     }
 
-    for (int i = 128; i < 256; i++)
+    unsigned char result = 0;
+    if (len == 2 && isContinuation(ch2))
+        result = mFromTwoBytes[getTwoBytesIndex(ch, ch2)];
+    else if (len == 3 && isContinuation(ch2) && isContinuation(ch3))
+        result = mFromThreeBytes[getThreeBytesIndex(ch2, ch3)];
+
+    if (result != 0)
     {
-        unsigned char b1 = translationArray[i*6 + 1], b2 = translationArray[i*6 + 2], b3 = translationArray[i*6 + 3];
-        if (b1 == ch && b2 == ch2 && (len != 3 || b3 == ch3))
-        {
-            *(out++) = (char)i;
-            return;
-        }
+        *(out++) = static_cast<char>(result);
+        return;
     }
 
     Log(Debug::Info) << "Could not find glyph " << std::hex << (int)ch << " " << (int)ch2 << " " << (int)ch3;
@@ -1,10 +1,11 @@
 #ifndef COMPONENTS_TOUTF8_H
 #define COMPONENTS_TOUTF8_H
 
+#include <array>
 #include <string>
 #include <cstring>
-#include <vector>
 #include <string_view>
+#include <vector>
 
 namespace ToUTF8
 {
@@ -37,15 +38,24 @@ namespace ToUTF8
             /// ASCII-only string. Otherwise returns a view to the input.
             std::string_view getLegacyEnc(std::string_view input);
 
+            /// Same as getUtf8 but converts into the given buffer, which keeps its capacity between calls.
+            /// Doesn't modify the encoder, so it may be shared between threads using a buffer each.
+            std::string_view getUtf8(std::string_view input, std::string& buffer) const;
+
+            /// Same as getLegacyEnc but converts into the given buffer, which keeps its capacity between calls.
+            std::string_view getLegacyEnc(std::string_view input, std::string& buffer) const;
+
         private:
-            inline void resize(std::size_t size);
             inline std::pair<std::size_t, bool> getLength(std::string_view input) const;
             inline void copyFromArray(unsigned char chp, char* &out) const;
             inline std::pair<std::size_t, bool> getLengthLegacyEnc(std::string_view input) const;
-            inline void copyFromArrayLegacyEnc(std::string_view::iterator& chp, std::string_view::iterator end, char* &out) const;
+            inline void copyFromArrayLegacyEnc(std::string_view input, std::size_t& pos, char* &out) const;
 
-            std::vector<char> mOutput;
+            std::string mOutput;
             const signed char* translationArray;
+            // Legacy characters by the last 6 bits of each byte of the UTF-8 sequence, 0 for none
+            std::array<unsigned char, 2048> mFromTwoBytes;
+            std::array<unsigned char, 4096> mFromThreeBytes;
     };
 }
 
@@ -2,6 +2,8 @@
 #define OPENMW_COMPONENTS_RESOURCE_ARCHIVE_H
 
 #include <map>
+#include <optional>
+#include <string_view>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -14,6 +16,14 @@ namespace VFS
         virtual ~File() {}
 
         virtual Files::IStreamPtr open() = 0;
+
+        /// Get a read-only view of the file contents if the archive keeps them in memory, std::nullopt otherwise.
+        /// @note The view is valid as long as the archive is alive.
+        virtual std::optional<std::string_view> getView() { return std::nullopt; }
+
+        /// Prepare the file so that a later open() is cheap, e.g. decompress it into a cache.
+        /// @note May be called from several threads at once.
+        virtual void prefetch() {}
     };
 
     class Archive
@@ -6,10 +6,12 @@
 namespace VFS
 {
 
-BsaArchive::BsaArchive(const std::string &filename)
+BsaArchive::BsaArchive(const std::string &filename, bool memoryMapped)
 {
     mFile = std::make_unique<Bsa::BSAFile>(Bsa::BSAFile());
     mFile->open(filename);
+    if (memoryMapped)
+        mFile->mapIntoMemory();
 
     const Bsa::BSAFile::FileList &filelist = mFile->getList();
     for(Bsa::BSAFile::FileList::const_iterator it = filelist.begin();it != filelist.end();++it)
@@ -53,11 +55,13 @@ std::string BsaArchive::getDescription() const
     return std::string{"BSA: "} + mFile->getFilename();
 }
 
-CompressedBsaArchive::CompressedBsaArchive(const std::string &filename)
+CompressedBsaArchive::CompressedBsaArchive(const std::string &filename, bool memoryMapped)
     : BsaArchive()
 {
-    mFile = std::make_unique<Bsa::BSAFile>(Bsa::CompressedBSAFile());
+    mFile = std::make_unique<Bsa::CompressedBSAFile>();
     mFile->open(filename);
+    if (memoryMapped)
+        mFile->mapIntoMemory();
 
     const Bsa::BSAFile::FileList &filelist = mFile->getList();
     for(Bsa::BSAFile::FileList::const_iterator it = filelist.begin();it != filelist.end();++it)
@@ -92,6 +96,11 @@ Files::IStreamPtr BsaArchiveFile::open()
     return mFile->getFile(mInfo);
 }
 
+std::optional<std::string_view> BsaArchiveFile::getView()
+{
+    return mFile->getFileView(mInfo);
+}
+
 CompressedBsaArchiveFile::CompressedBsaArchiveFile(const Bsa::BSAFile::FileStruct *info, Bsa::CompressedBSAFile* bsa)
     : BsaArchiveFile(info, bsa)
     , mCompressedFile(bsa)
@@ -104,4 +113,9 @@ Files::IStreamPtr CompressedBsaArchiveFile::open()
     return mCompressedFile->getFile(mInfo);
 }
 
+void CompressedBsaArchiveFile::prefetch()
+{
+    mCompressedFile->prefetch(mInfo);
+}
+
 }
@@ -15,6 +15,8 @@ namespace VFS
 
         Files::IStreamPtr open() override;
 
+        std::optional<std::string_view> getView() override;
+
         const Bsa::BSAFile::FileStruct* mInfo;
         Bsa::BSAFile* mFile;
     };
@@ -25,6 +27,11 @@ namespace VFS
         CompressedBsaArchiveFile(const Bsa::BSAFile::FileStruct* info, Bsa::CompressedBSAFile* bsa);
 
         Files::IStreamPtr open() override;
+
+        std::optional<std::string_view> getView() override { return std::nullopt; }
+
+        void prefetch() override;
+
         Bsa::CompressedBSAFile* mCompressedFile;
     };
 
@@ -32,7 +39,8 @@ namespace VFS
     class BsaArchive : public Archive
     {
     public:
-        BsaArchive(const std::string& filename);
+        /// @param memoryMapped Map the archive into memory and serve file data from the mapping.
+        BsaArchive(const std::string& filename, bool memoryMapped = false);
         BsaArchive();
         virtual ~BsaArchive();
         void listResources(std::map<std::string, File*>& out, char (*normalize_function) (char)) override;
@@ -47,7 +55,7 @@ namespace VFS
     class CompressedBsaArchive : public BsaArchive
     {
     public:
-        CompressedBsaArchive(const std::string& filename);
+        CompressedBsaArchive(const std::string& filename, bool memoryMapped = false);
         void listResources(std::map<std::string, File*>& out, char (*normalize_function) (char)) override;
         virtual ~CompressedBsaArchive() {}
 
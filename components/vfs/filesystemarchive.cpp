@@ -1,17 +1,38 @@
 #include "filesystemarchive.hpp"
 
 #include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
 
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include <components/debug/debuglog.hpp>
 
 namespace VFS
 {
+    namespace
+    {
+        constexpr std::string_view sIndexCacheHeader = "openmw vfs index 1";
+
+        // Directories modified this recently may still change within the resolution of their time stamp
+        constexpr std::time_t sMinDirectoryAge = 2;
+
+        std::size_t getPrefixSize(const std::string& path)
+        {
+            std::size_t prefix = path.size();
+            if (prefix > 0 && path[prefix - 1] != '\\' && path[prefix - 1] != '/')
+                ++prefix;
+            return prefix;
+        }
+    }
 
-    FileSystemArchive::FileSystemArchive(const std::string &path)
+    FileSystemArchive::FileSystemArchive(const std::string &path, const std::string& indexCachePath)
         : mBuiltIndex(false)
         , mPath(path)
+        , mIndexCachePath(indexCachePath)
     {
 
     }
@@ -20,27 +41,31 @@ namespace VFS
     {
         if (!mBuiltIndex)
         {
-            typedef boost::filesystem::recursive_directory_iterator directory_iterator;
-
-            directory_iterator end;
-
-            size_t prefix = mPath.size ();
+            Listing listing;
+            if (mIndexCachePath.empty() || !loadIndexCache(listing))
+            {
+                listing = scan();
+                if (!mIndexCachePath.empty())
+                    saveIndexCache(listing);
+            }
+            else
+                Log(Debug::Verbose) << "Loaded the index of " << listing.mFiles.size() << " files in " << mPath << " from cache";
 
-            if (mPath.size () > 0 && mPath [prefix - 1] != '\\' && mPath [prefix - 1] != '/')
-                ++prefix;
+            std::string proper = mPath;
+            if (getPrefixSize(mPath) > mPath.size())
+                proper += static_cast<char>(boost::filesystem::path::preferred_separator);
+            const std::size_t prefix = proper.size();
 
-            for (directory_iterator i (mPath); i != end; ++i)
+            for (const std::string& relative : listing.mFiles)
             {
-                if(boost::filesystem::is_directory (*i))
-                    continue;
-
-                std::string proper = i->path ().string ();
+                proper.resize(prefix);
+                proper += relative;
 
                 FileSystemArchiveFile file(proper);
 
                 std::string searchable;
 
-                std::transform(proper.begin() + prefix, proper.end(), std::back_inserter(searchable), normalize_function);
+                std::transform(relative.begin(), relative.end(), std::back_inserter(searchable), normalize_function);
 
                 const auto inserted = mIndex.insert(std::make_pair(searchable, file));
                 if (!inserted.second)
@@ -59,6 +84,123 @@ namespace VFS
         }
     }
 
+    FileSystemArchive::Listing FileSystemArchive::scan() const
+    {
+        typedef boost::filesystem::recursive_directory_iterator directory_iterator;
+
+        directory_iterator end;
+
+        const size_t prefix = getPrefixSize(mPath);
+
+        Listing result;
+        result.mDirectories.emplace_back(std::string(), boost::filesystem::last_write_time(mPath));
+
+        for (directory_iterator i (mPath); i != end; ++i)
+        {
+            std::string proper = i->path ().string ();
+
+            if(boost::filesystem::is_directory (*i))
+            {
+                if (!mIndexCachePath.empty())
+                    result.mDirectories.emplace_back(proper.substr(prefix), boost::filesystem::last_write_time(i->path()));
+                continue;
+            }
+
+            result.mFiles.push_back(proper.substr(prefix));
+        }
+
+        return result;
+    }
+
+    std::string FileSystemArchive::getIndexCacheFile() const
+    {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>()(mPath) << ".txt";
+        return (boost::filesystem::path(mIndexCachePath) / name.str()).string();
+    }
+
+    bool FileSystemArchive::loadIndexCache(Listing& listing) const
+    {
+        boost::filesystem::ifstream stream(getIndexCacheFile());
+        if (!stream.is_open())
+            return false;
+
+        std::string line;
+        if (!std::getline(stream, line) || line != sIndexCacheHeader)
+            return false;
+        // Different data paths may have the same hash
+        if (!std::getline(stream, line) || line != mPath)
+            return false;
+
+        const boost::filesystem::path root(mPath);
+        while (std::getline(stream, line))
+        {
+            if (line.size() < 2 || line[1] != ' ')
+                return false;
+            if (line[0] == 'f')
+            {
+                listing.mFiles.push_back(line.substr(2));
+                continue;
+            }
+            if (line[0] != 'd')
+                return false;
+
+            // d <time> <path>
+            const std::size_t separator = line.find(' ', 2);
+            if (separator == std::string::npos)
+                return false;
+            std::time_t time = 0;
+            std::istringstream(line.substr(2, separator - 2)) >> time;
+            const std::string relative = line.substr(separator + 1);
+
+            // Adding, removing or renaming an entry changes the time stamp of its directory
+            boost::system::error_code error;
+            const std::time_t current = boost::filesystem::last_write_time(relative.empty() ? root : root / relative, error);
+            if (error || current != time)
+                return false;
+            listing.mDirectories.emplace_back(relative, time);
+        }
+
+        return !listing.mDirectories.empty();
+    }
+
+    void FileSystemArchive::saveIndexCache(const Listing& listing) const
+    {
+        const std::time_t now = std::time(nullptr);
+        for (const auto& [relative, time] : listing.mDirectories)
+        {
+            if (now - time < sMinDirectoryAge)
+                return;
+            if (relative.find('\n') != std::string::npos)
+                return;
+        }
+        for (const std::string& relative : listing.mFiles)
+            if (relative.find('\n') != std::string::npos)
+                return;
+
+        const std::string path = getIndexCacheFile();
+        // Write to a temporary file first, so another instance never reads a partial index
+        const std::string temporary = path + ".tmp";
+        {
+            boost::filesystem::ofstream stream(temporary, std::ios::trunc);
+            stream << sIndexCacheHeader << '\n' << mPath << '\n';
+            for (const auto& [relative, time] : listing.mDirectories)
+                stream << "d " << time << ' ' << relative << '\n';
+            for (const std::string& relative : listing.mFiles)
+                stream << "f " << relative << '\n';
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Warning: failed to write the file index cache " << temporary;
+                return;
+            }
+        }
+
+        boost::system::error_code error;
+        boost::filesystem::rename(temporary, path, error);
+        if (error)
+            Log(Debug::Warning) << "Warning: failed to write the file index cache " << path << ": " << error.message();
+    }
+
     bool FileSystemArchive::contains(const std::string& file, char (*normalize_function)(char)) const
     {
         return mIndex.find(file) != mIndex.end();
@@ -3,6 +3,11 @@
 
 #include "archive.hpp"
 
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace VFS
 {
 
@@ -21,7 +26,9 @@ namespace VFS
     class FileSystemArchive : public Archive
     {
     public:
-        FileSystemArchive(const std::string& path);
+        /// @param indexCachePath directory to store the list of files in, so it doesn't have to be built by
+        /// scanning the whole directory tree on every launch. No cache is used when empty.
+        FileSystemArchive(const std::string& path, const std::string& indexCachePath = {});
 
         void listResources(std::map<std::string, File*>& out, char (*normalize_function) (char)) override;
 
@@ -35,6 +42,23 @@ namespace VFS
 
         bool mBuiltIndex;
         std::string mPath;
+        std::string mIndexCachePath;
+
+        /// Paths of the files and the directories with their modification times, relative to mPath.
+        struct Listing
+        {
+            std::vector<std::string> mFiles;
+            std::vector<std::pair<std::string, std::time_t>> mDirectories;
+        };
+
+        Listing scan() const;
+
+        std::string getIndexCacheFile() const;
+
+        /// Read the cached listing, fails when any of the directories was modified since it was written.
+        bool loadIndexCache(Listing& listing) const;
+
+        void saveIndexCache(const Listing& listing) const;
 
     };
 
@@ -1,7 +1,12 @@
 #include "manager.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
+#include <thread>
 
+#include <components/debug/debuglog.hpp>
+#include <components/debug/tracing.hpp>
 #include <components/misc/stringops.hpp>
 
 #include "archive.hpp"
@@ -21,8 +26,33 @@ namespace
 
     void normalize_path(std::string& path, bool strict)
     {
-        char (*normalize_char)(char) = strict ? &strict_normalize_char : &nonstrict_normalize_char;
-        std::transform(path.begin(), path.end(), path.begin(), normalize_char);
+        if (!strict)
+            Misc::StringUtils::lowerCaseInPlace(path);
+        std::replace(path.begin(), path.end(), '\\', '/');
+    }
+
+    template <char (*normalize)(char)>
+    std::size_t hashNormalized(std::string_view name)
+    {
+        // FNV-1a
+        std::size_t result = 14695981039346656037ull;
+        for (char ch : name)
+        {
+            result ^= static_cast<unsigned char>(normalize(ch));
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+
+    template <char (*normalize)(char)>
+    bool equalNormalized(const std::string& normalized, std::string_view name)
+    {
+        if (normalized.size() != name.size())
+            return false;
+        for (std::size_t i = 0; i < name.size(); ++i)
+            if (normalized[i] != normalize(name[i]))
+                return false;
+        return true;
     }
 
 }
@@ -44,6 +74,7 @@ namespace VFS
     void Manager::reset()
     {
         mIndex.clear();
+        mHashedIndex.clear();
         for (std::vector<Archive*>::iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             delete *it;
         mArchives.clear();
@@ -56,34 +87,137 @@ namespace VFS
 
     void Manager::buildIndex()
     {
+        const Debug::ScopedTrace trace("VFS::Manager::buildIndex");
+
         mIndex.clear();
+        mHashedIndex.clear();
+
+        // Archives are listed concurrently, the results are merged in the order of registration afterwards
+        // so that the last added archive still has priority.
+        std::vector<std::map<std::string, File*>> resources(mArchives.size());
+        std::atomic_size_t next {0};
+        const auto listResources = [&]
+        {
+            for (std::size_t i = next++; i < mArchives.size(); i = next++)
+                mArchives[i]->listResources(resources[i], mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+        };
+        const std::size_t numThreads = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), mArchives.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < numThreads; ++i)
+            threads.emplace_back(listResources);
+        listResources();
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (std::map<std::string, File*>& archiveResources : resources)
+        {
+            if (mIndex.empty())
+                mIndex = std::move(archiveResources);
+            else
+                for (const auto& [name, file] : archiveResources)
+                    mIndex.insert_or_assign(name, file);
+        }
 
-        for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
-            (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+        std::size_t capacity = 16;
+        while (capacity < mIndex.size() * 2)
+            capacity *= 2;
+        mHashedIndex.resize(capacity, HashedEntry {0, nullptr, nullptr});
+        const std::size_t mask = capacity - 1;
+        for (const auto& [name, file] : mIndex)
+        {
+            // Names in the index are already normalized
+            const std::size_t hash = hashNormalized<strict_normalize_char>(name);
+            std::size_t i = hash & mask;
+            while (mHashedIndex[i].mName != nullptr)
+                i = (i + 1) & mask;
+            mHashedIndex[i] = HashedEntry {hash, &name, file};
+        }
     }
 
-    Files::IStreamPtr Manager::get(const std::string &name) const
+    std::size_t Manager::getNameHash(std::string_view name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        return mStrict ? hashNormalized<strict_normalize_char>(name) : hashNormalized<nonstrict_normalize_char>(name);
+    }
 
-        return getNormalized(normalized);
+    const Manager::HashedEntry* Manager::find(std::string_view name, std::size_t hash) const
+    {
+        if (mHashedIndex.empty())
+            return nullptr;
+        const std::size_t mask = mHashedIndex.size() - 1;
+        for (std::size_t i = hash & mask; mHashedIndex[i].mName != nullptr; i = (i + 1) & mask)
+        {
+            const HashedEntry& entry = mHashedIndex[i];
+            if (entry.mHash != hash)
+                continue;
+            if (mStrict ? equalNormalized<strict_normalize_char>(*entry.mName, name)
+                        : equalNormalized<nonstrict_normalize_char>(*entry.mName, name))
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    File* Manager::findFile(const std::string& name) const
+    {
+        const HashedEntry* entry = find(name, getNameHash(name));
+        if (entry == nullptr)
+            throw std::runtime_error("Resource '" + normalizeFilename(name) + "' not found");
+        return entry->mFile;
+    }
+
+    Files::IStreamPtr Manager::get(const std::string &name) const
+    {
+        return findFile(name)->open();
     }
 
     Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
-            throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return findFile(normalizedName)->open();
     }
 
-    bool Manager::exists(const std::string &name) const
+    std::optional<std::string_view> Manager::getView(const std::string& name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        return findFile(name)->getView();
+    }
+
+    void Manager::prefetch(const std::vector<std::string>& names, std::size_t threads) const
+    {
+        std::vector<File*> files;
+        files.reserve(names.size());
+        for (const std::string& name : names)
+            if (const HashedEntry* entry = find(name, getNameHash(name)))
+                files.push_back(entry->mFile);
+
+        std::atomic_size_t next {0};
+        const auto prefetchFiles = [&]
+        {
+            for (std::size_t i = next++; i < files.size(); i = next++)
+            {
+                try
+                {
+                    files[i]->prefetch();
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Warning) << "Failed to prefetch file: " << e.what();
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < std::min(threads, files.size()); ++i)
+            workers.emplace_back(prefetchFiles);
+        prefetchFiles();
+        for (std::thread& worker : workers)
+            worker.join();
+    }
 
-        return mIndex.find(normalized) != mIndex.end();
+    bool Manager::exists(std::string_view name) const
+    {
+        return find(name, getNameHash(name)) != nullptr;
+    }
+
+    bool Manager::exists(std::string_view name, std::size_t hash) const
+    {
+        return find(name, hash) != nullptr;
     }
 
     std::string Manager::normalizeFilename(const std::string& name) const
@@ -5,6 +5,8 @@
 
 #include <vector>
 #include <map>
+#include <optional>
+#include <string_view>
 
 namespace VFS
 {
@@ -65,8 +67,17 @@ namespace VFS
         void buildIndex();
 
         /// Does a file with this name exist?
+        /// @note Doesn't allocate, the name is normalized while it is compared.
         /// @note May be called from any thread once the index has been built.
-        bool exists(const std::string& name) const;
+        bool exists(std::string_view name) const;
+
+        /// Does a file with this name and hash, as returned by getNameHash(), exist?
+        /// @note May be called from any thread once the index has been built.
+        bool exists(std::string_view name, std::size_t hash) const;
+
+        /// Hash of the normalized name, to look up the same name multiple times without hashing it again.
+        /// @note May be called from any thread.
+        std::size_t getNameHash(std::string_view name) const;
 
         /// Normalize the given filename, making slashes/backslashes consistent, and lower-casing if mStrict is false.
         /// @note May be called from any thread once the index has been built.
@@ -82,6 +93,18 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
+        /// Retrieve a read-only view of the file contents without copying them, if the archive providing the file is
+        /// memory mapped. Returns std::nullopt otherwise, the caller is then expected to fall back to get().
+        /// @note Throws an exception if the file can not be found.
+        /// @note The view is valid until reset() is called.
+        /// @note May be called from any thread once the index has been built.
+        std::optional<std::string_view> getView(const std::string& name) const;
+
+        /// Prefetch the given files using the given number of threads, files that don't exist are ignored.
+        /// @see File::prefetch
+        /// @note May be called from any thread once the index has been built.
+        void prefetch(const std::vector<std::string>& names, std::size_t threads) const;
+
         std::string getArchive(const std::string& name) const;
 
         /// Recursivly iterate over the elements of the given path
@@ -91,11 +114,26 @@ namespace VFS
         RecursiveDirectoryRange getRecursiveDirectoryIterator(const std::string& path) const;
 
     private:
+        struct HashedEntry
+        {
+            std::size_t mHash;
+            const std::string* mName;
+            File* mFile;
+        };
+
         bool mStrict;
 
         std::vector<Archive*> mArchives;
 
+        /// Sorted index, used for prefix iteration.
         std::map<std::string, File*> mIndex;
+
+        /// Open addressing hash table over mIndex with linear probing, used for lookups by name.
+        std::vector<HashedEntry> mHashedIndex;
+
+        const HashedEntry* find(std::string_view name, std::size_t hash) const;
+
+        File* findFile(const std::string& name) const;
     };
 
 }
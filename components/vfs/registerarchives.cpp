@@ -3,6 +3,8 @@
 #include <set>
 #include <sstream>
 
+#include <boost/filesystem/operations.hpp>
+
 #include <components/debug/debuglog.hpp>
 
 #include <components/vfs/manager.hpp>
@@ -12,7 +14,8 @@
 namespace VFS
 {
 
-    void registerArchives(VFS::Manager *vfs, const Files::Collections &collections, const std::vector<std::string> &archives, bool useLooseFiles)
+    void registerArchives(VFS::Manager *vfs, const Files::Collections &collections, const std::vector<std::string> &archives, bool useLooseFiles, bool memoryMapArchives,
+        const std::string& indexCachePath)
     {
         const Files::PathContainer& dataDirs = collections.getPaths();
 
@@ -26,9 +29,9 @@ namespace VFS
                 Bsa::BsaVersion bsaVersion = Bsa::CompressedBSAFile::detectVersion(archivePath);
 
                 if (bsaVersion == Bsa::BSAVER_COMPRESSED)
-                    vfs->addArchive(new CompressedBsaArchive(archivePath));
+                    vfs->addArchive(new CompressedBsaArchive(archivePath, memoryMapArchives));
                 else
-                    vfs->addArchive(new BsaArchive(archivePath));
+                    vfs->addArchive(new BsaArchive(archivePath, memoryMapArchives));
             }
             else
             {
@@ -40,6 +43,18 @@ namespace VFS
 
         if (useLooseFiles)
         {
+            std::string cachePath = indexCachePath;
+            if (!cachePath.empty())
+            {
+                boost::system::error_code error;
+                boost::filesystem::create_directories(cachePath, error);
+                if (error)
+                {
+                    Log(Debug::Warning) << "Warning: Unable to create file index cache directory " << cachePath << ": " << error.message();
+                    cachePath.clear();
+                }
+            }
+
             std::set<boost::filesystem::path> seen;
             for (Files::PathContainer::const_iterator iter = dataDirs.begin(); iter != dataDirs.end(); ++iter)
             {
@@ -47,7 +62,7 @@ namespace VFS
                 {
                     Log(Debug::Info) << "Adding data directory " << iter->string();
                     // Last data dir has the highest priority
-                    vfs->addArchive(new FileSystemArchive(iter->string()));
+                    vfs->addArchive(new FileSystemArchive(iter->string(), cachePath));
                 }
                 else
                     Log(Debug::Info) << "Ignoring duplicate data directory " << iter->string();
@@ -8,8 +8,12 @@ namespace VFS
     class Manager;
 
     /// @brief Register BSA and file system archives based on the given OpenMW configuration.
+    /// @param memoryMapArchives Map BSA archives into memory instead of reading them through file streams.
+    /// @param indexCachePath Directory to cache the lists of loose files in, see FileSystemArchive. Empty to always
+    /// scan the data directories.
     void registerArchives (VFS::Manager* vfs, const Files::Collections& collections,
-        const std::vector<std::string>& archives, bool useLooseFiles);
+        const std::vector<std::string>& archives, bool useLooseFiles, bool memoryMapArchives = false,
+        const std::string& indexCachePath = {});
 }
 
 #endif
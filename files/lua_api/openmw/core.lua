@@ -46,6 +46,31 @@
 -- @function [parent=#core] isWorldPaused
 -- @return #boolean
 
+-------------------------------------------------------------------------------
+-- Profiler stats of the scripts that run in the same Lua state as the calling script.
+-- Empty unless the setting `lua profiler` is enabled.
+-- Keys are script paths, every value is a table with fields `memoryUsage` (bytes allocated by the script
+-- and not freed yet, 0 if memory can not be tracked) and `handlers`, which maps handler names to tables
+-- with fields `calls`, `totalTime` and `maxTime` (in seconds).
+-- @function [parent=#core] getScriptStats
+-- @return #table
+-- @usage
+-- for path, script in pairs(core.getScriptStats()) do
+--     local update = script.handlers.onUpdate
+--     if update then print(path, update.totalTime / update.calls) end
+-- end
+
+-------------------------------------------------------------------------------
+-- Cost of the audio in the current frame.
+-- Fields: `sources` (OpenAL sources in use), `stolenSources` (sounds stopped early to free a source),
+-- `streams` (streamed music and voices), `streamUnderruns` (times a stream ran out of data),
+-- `buffers`, `pendingBuffers` and `bufferMemory` (loaded, still decoding and bytes of sound buffers),
+-- `loadTime` (seconds spent loading sound buffers on the main thread), `decodeTime` (seconds spent
+-- decoding sound buffers in the background) and `updateTime` (seconds spent updating the sounds).
+-- The counts of stolen sources and underruns are totals since the game started.
+-- @function [parent=#core] getSoundStats
+-- @return #table
+
 -------------------------------------------------------------------------------
 -- Get a GMST setting from content files.
 -- @function [parent=#core] getGMST
@@ -74,5 +74,36 @@
 --     radius = 10,
 -- })
 
+-------------------------------------------------------------------------------
+-- Cast ray from one point to another without waiting for the result. The ray is cast next to the physics
+-- simulation of the next frame, the callback gets the result in the frame after the request.
+-- Rays requested in the same frame are cast together.
+-- @function [parent=#nearby] asyncCastRay
+-- @param openmw.async#Callback callback The callback to pass the result to, see @{openmw.async#callback}.
+-- @param openmw.util#Vector3 from Start point of the ray.
+-- @param openmw.util#Vector3 to End point of the ray.
+-- @param #table options The same options as in @{openmw.nearby#castRay}.
+-- @usage nearby.asyncCastRay(async:callback(function(res)
+--     if res.hit then print('obstacle at', res.hitPos) end
+-- end), self.position, enemy.position, {ignore=self})
+
+-------------------------------------------------------------------------------
+-- Physics cost of an actor during the last frame
+-- @type ActorPhysicsCost
+-- @field [parent=#ActorPhysicsCost] openmw.core#GameObject object The actor
+-- @field [parent=#ActorPhysicsCost] #number time Seconds spent moving the actor, only measured with the `actor cost stats` setting
+-- @field [parent=#ActorPhysicsCost] #number solverIterations Iterations of the movement solver
+-- @field [parent=#ActorPhysicsCost] #number stepAttempts Attempts to step up onto something
+-- @field [parent=#ActorPhysicsCost] #number contacts Movement traces which hit something
+
+-------------------------------------------------------------------------------
+-- Actors which were the most expensive to move during the last frame, the most expensive first.
+-- @function [parent=#nearby] getExpensivePhysicsActors
+-- @param #number count Maximum number of actors to return (10 by default)
+-- @return #list<#ActorPhysicsCost>
+-- @usage for _, cost in ipairs(nearby.getExpensivePhysicsActors(5)) do
+--     print(cost.object, cost.time, cost.solverIterations)
+-- end
+
 return nil
 
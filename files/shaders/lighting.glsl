@@ -75,6 +75,23 @@ void doLighting(vec3 viewPos, vec3 viewNormal, out vec3 diffuseLight, out vec3 a
     diffuseLight = vec3(0.0);
 #endif
 
+#if @lightingMethodClustered
+    // find the cluster containing this fragment and walk its light list, see LightManager::updateClusters
+    vec4 clusterClipPos = clusterProjection * vec4(viewPos, 1.0);
+    vec2 clusterCoord = clamp(clusterClipPos.xy / clusterClipPos.w * 0.5 + 0.5, 0.0, 0.999);
+    int clusterColumn = int(clusterCoord.x * float(@clusterGridX)) + int(clusterCoord.y * float(@clusterGridY)) * @clusterGridX;
+    float clusterDepth = max(-viewPos.z, clusterDepthRange.x);
+    int clusterSlice = int(clamp(log(clusterDepth / clusterDepthRange.x) * clusterDepthRange.y, 0.0, float(@clusterGridZ - 1)));
+    int clusterRow = clusterSlice * (@maxLights + 1);
+    int clusterLightCount = int(texelFetch2D(clusterMap, ivec2(clusterColumn, clusterRow), 0).r);
+
+    for (int i = 1; i <= clusterLightCount; ++i)
+    {
+        perLightPoint(ambientOut, diffuseOut, int(texelFetch2D(clusterMap, ivec2(clusterColumn, clusterRow + i), 0).r), viewPos, viewNormal);
+        ambientLight += ambientOut;
+        diffuseLight += diffuseOut;
+    }
+#else
     for (int i = @startLight; i < @endLight; ++i)
     {
 #if @lightingMethodUBO
@@ -85,6 +102,7 @@ void doLighting(vec3 viewPos, vec3 viewNormal, out vec3 diffuseLight, out vec3 a
         ambientLight += ambientOut;
         diffuseLight += diffuseOut;
     }
+#endif
 }
 
 vec3 getSpecular(vec3 viewNormal, vec3 viewDirection, float shininess, vec3 matSpec)
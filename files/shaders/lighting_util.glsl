@@ -49,6 +49,14 @@ uniform LightBufferBinding
     LightData LightBuffer[@maxLightsInScene];
 };
 
+#if @lightingMethodClustered
+// light buffer indices of the view space clusters
+uniform sampler2D clusterMap;
+uniform mat4 clusterProjection;
+// near plane and scale of the exponential depth slices
+uniform vec2 clusterDepthRange;
+#endif
+
 #elif @lightingMethodPerObjectUniform
 
 /* Layout:
@@ -66,18 +66,56 @@ varying vec3 passNormal;
 #include "lighting.glsl"
 #include "depth.glsl"
 
+#if @instancing
+// Position and scale, rotation quaternion of the instance
+attribute vec4 aOffset;
+attribute vec4 aRotation;
+
+vec3 rotateByQuat(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+#endif
+
+#if @skinning
+// Indices into boneMatrices and weights of up to four bones, see SceneUtil::RigGeometry
+attribute vec4 aBoneIndices;
+attribute vec4 aBoneWeights;
+uniform mat4 boneMatrices[@maxBones];
+
+mat4 getSkinningMatrix()
+{
+    return boneMatrices[int(aBoneIndices.x)] * aBoneWeights.x
+        + boneMatrices[int(aBoneIndices.y)] * aBoneWeights.y
+        + boneMatrices[int(aBoneIndices.z)] * aBoneWeights.z
+        + boneMatrices[int(aBoneIndices.w)] * aBoneWeights.w;
+}
+#endif
+
 void main(void)
 {
-    gl_Position = projectionMatrix * (gl_ModelViewMatrix * gl_Vertex);
+#if @instancing
+    vec4 vertex = vec4(rotateByQuat(aRotation, gl_Vertex.xyz) * aOffset.w + aOffset.xyz, 1.0);
+    vec3 normal = rotateByQuat(aRotation, gl_Normal);
+#elif @skinning
+    mat4 skinningMatrix = getSkinningMatrix();
+    vec4 vertex = vec4((skinningMatrix * gl_Vertex).xyz, 1.0);
+    vec3 normal = mat3(skinningMatrix) * gl_Normal;
+#else
+    vec4 vertex = gl_Vertex;
+    vec3 normal = gl_Normal;
+#endif
+
+    gl_Position = projectionMatrix * (gl_ModelViewMatrix * vertex);
 
-    vec4 viewPos = (gl_ModelViewMatrix * gl_Vertex);
+    vec4 viewPos = (gl_ModelViewMatrix * vertex);
 
     gl_ClipVertex = viewPos;
     euclideanDepth = length(viewPos.xyz);
     linearDepth = getLinearDepth(gl_Position.z, viewPos.z);
 
 #if (@envMap || !PER_PIXEL_LIGHTING || @shadows_enabled)
-    vec3 viewNormal = normalize((gl_NormalMatrix * gl_Normal).xyz);
+    vec3 viewNormal = normalize((gl_NormalMatrix * normal).xyz);
 #endif
 
 #if @envMap
@@ -110,6 +148,11 @@ void main(void)
 #if @normalMap
     normalMapUV = (gl_TextureMatrix[@normalMapUV] * gl_MultiTexCoord@normalMapUV).xy;
     passTangent = gl_MultiTexCoord7.xyzw;
+#if @instancing
+    passTangent.xyz = rotateByQuat(aRotation, passTangent.xyz);
+#elif @skinning
+    passTangent.xyz = mat3(skinningMatrix) * passTangent.xyz;
+#endif
 #endif
 
 #if @bumpMap
@@ -122,7 +165,7 @@ void main(void)
 
     passColor = gl_Color;
     passViewPos = viewPos.xyz;
-    passNormal = gl_Normal.xyz;
+    passNormal = normal;
 
 #if !PER_PIXEL_LIGHTING
     vec3 diffuseLight, ambientLight;
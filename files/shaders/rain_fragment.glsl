@@ -0,0 +1,29 @@
+#version 120
+
+uniform sampler2D diffuseMap;
+
+uniform float rainAlpha;
+uniform vec3 rainLighting;
+
+varying vec2 diffuseMapUV;
+
+#if @radialFog
+varying float euclideanDepth;
+#else
+varying float linearDepth;
+#endif
+
+void main()
+{
+    gl_FragData[0] = texture2D(diffuseMap, diffuseMapUV);
+    gl_FragData[0].xyz *= clamp(rainLighting, vec3(0.0), vec3(1.0));
+    gl_FragData[0].a *= rainAlpha;
+
+#if @radialFog
+    float fogValue = clamp((euclideanDepth - gl_Fog.start) * gl_Fog.scale, 0.0, 1.0);
+#else
+    float fogValue = clamp((linearDepth - gl_Fog.start) * gl_Fog.scale, 0.0, 1.0);
+#endif
+
+    gl_FragData[0].xyz = mix(gl_FragData[0].xyz, gl_Fog.color.xyz, fogValue);
+}
@@ -0,0 +1,60 @@
+#version 120
+
+uniform mat4 projectionMatrix;
+
+uniform vec3 rainOffset;
+uniform vec3 rainRange;
+uniform float rainAngle;
+uniform int rainCount;
+
+varying vec2 diffuseMapUV;
+
+#if @radialFog
+varying float euclideanDepth;
+#else
+varying float linearDepth;
+#endif
+
+#include "depth.glsl"
+
+void main(void)
+{
+    // x: spin around the vertical axis, y: size, z: index of the drop
+    vec3 drop = gl_MultiTexCoord1.xyz;
+    if (drop.z >= float(rainCount))
+    {
+        // unused drop, move it out of the clip volume
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        diffuseMapUV = vec2(0.0);
+#if @radialFog
+        euclideanDepth = 0.0;
+#else
+        linearDepth = 0.0;
+#endif
+        return;
+    }
+
+    // wrap the drop around the camera, which is at the origin
+    vec3 center = (fract(gl_Vertex.xyz + rainOffset / rainRange) - 0.5) * rainRange;
+
+    vec2 corner = gl_MultiTexCoord0.xy;
+    vec3 offset = vec3((corner.x * 2.0 - 1.0) * 0.1, 0.0, corner.y * 2.0 - 1.0) * drop.y;
+
+    // tilt the drop along the wind, then spin it
+    offset = vec3(offset.x, -offset.z * sin(rainAngle), offset.z * cos(rainAngle));
+    float s = sin(drop.x);
+    float c = cos(drop.x);
+    offset = vec3(offset.x * c - offset.y * s, offset.x * s + offset.y * c, offset.z);
+
+    vec4 viewPos = gl_ModelViewMatrix * vec4(center + offset, 1.0);
+    gl_Position = projectionMatrix * viewPos;
+    gl_ClipVertex = viewPos;
+
+#if @radialFog
+    euclideanDepth = length(viewPos.xyz);
+#else
+    linearDepth = getLinearDepth(gl_Position.z, viewPos.z);
+#endif
+
+    diffuseMapUV = corner;
+}
@@ -0,0 +1,41 @@
+#version 120
+
+// One step of the wave equation on the height field of the ripple map, in red the current height
+// and in green the height of the step before.
+
+varying vec2 uv;
+
+uniform sampler2D previousMap;
+uniform float texelSize;
+uniform vec2 offset;                 // movement of the map since the last step, in texture coordinates
+uniform float damping;               // 0 clears the map
+uniform vec4 ripples[@maxRipples];   // xy position and z radius in texture coordinates, w strength
+uniform int numRipples;
+
+void main(void)
+{
+    vec2 coords = uv + offset;
+    float height = 0.0;
+    float previousHeight = 0.0;
+
+    if (damping > 0.0 && coords.x > texelSize && coords.y > texelSize && coords.x < 1.0 - texelSize && coords.y < 1.0 - texelSize)
+    {
+        vec2 state = texture2D(previousMap, coords).rg;
+        float neighbours = texture2D(previousMap, coords + vec2(texelSize, 0.0)).r
+                         + texture2D(previousMap, coords - vec2(texelSize, 0.0)).r
+                         + texture2D(previousMap, coords + vec2(0.0, texelSize)).r
+                         + texture2D(previousMap, coords - vec2(0.0, texelSize)).r;
+        height = (neighbours * 0.5 - state.g) * damping;
+        previousHeight = state.r;
+    }
+
+    for (int i = 0; i < @maxRipples; ++i)
+    {
+        if (i >= numRipples)
+            break;
+        float distance = length(uv - ripples[i].xy);
+        height += ripples[i].w * max(0.0, 1.0 - distance / ripples[i].z);
+    }
+
+    gl_FragData[0] = vec4(height, previousHeight, 0.0, 1.0);
+}
@@ -8,11 +8,39 @@ uniform int colorMode;
 uniform bool useDiffuseMapForShadowAlpha = true;
 uniform bool alphaTestShadows = true;
 
+// Set for geometry instanced by object paging, see the instancing define of objects_vertex.glsl
+uniform bool useInstancing = false;
+attribute vec4 aOffset;
+attribute vec4 aRotation;
+
+vec3 rotateByQuat(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// Set for geometry skinned on the GPU, see the skinning define of objects_vertex.glsl
+uniform bool useSkinning = false;
+attribute vec4 aBoneIndices;
+attribute vec4 aBoneWeights;
+uniform mat4 boneMatrices[@maxBones];
+
 void main(void)
 {
-    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    vec4 vertex = gl_Vertex;
+    if (useInstancing)
+        vertex = vec4(rotateByQuat(aRotation, gl_Vertex.xyz) * aOffset.w + aOffset.xyz, 1.0);
+    else if (useSkinning)
+    {
+        mat4 skinningMatrix = boneMatrices[int(aBoneIndices.x)] * aBoneWeights.x
+            + boneMatrices[int(aBoneIndices.y)] * aBoneWeights.y
+            + boneMatrices[int(aBoneIndices.z)] * aBoneWeights.z
+            + boneMatrices[int(aBoneIndices.w)] * aBoneWeights.w;
+        vertex = vec4((skinningMatrix * gl_Vertex).xyz, 1.0);
+    }
+
+    gl_Position = gl_ModelViewProjectionMatrix * vertex;
 
-    vec4 viewPos = (gl_ModelViewMatrix * gl_Vertex);
+    vec4 viewPos = (gl_ModelViewMatrix * vertex);
     gl_ClipVertex = viewPos;
 
     if (useDiffuseMapForShadowAlpha)
@@ -0,0 +1,9 @@
+#version 120
+
+varying vec3 direction;
+uniform samplerCube skyCubemap;
+
+void main(void)
+{
+    gl_FragData[0] = vec4(textureCube(skyCubemap, direction).rgb, 1.0);
+}
@@ -0,0 +1,13 @@
+#version 120
+
+varying vec3 direction;
+
+void main(void)
+{
+    direction = gl_Vertex.xyz;
+
+    // only rotate the cube, so that it stays centered on the eye
+    gl_Position = gl_ProjectionMatrix * vec4(mat3(gl_ModelViewMatrix) * gl_Vertex.xyz, 1.0);
+    // depth testing is disabled, keep the cube within the depth range whatever the near plane
+    gl_Position.z = gl_Position.w * 0.5;
+}
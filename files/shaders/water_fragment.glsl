@@ -10,6 +10,8 @@
 
 #define REFRACTION @refraction_enabled
 #define RAIN_RIPPLE_DETAIL @rain_ripple_detail
+#define REFLECTION_REPROJECTION @reflection_reprojection
+#define RIPPLE_MAP @ripple_map
 
 // Inspired by Blender GLSL Water by martinsh ( https://devlog-martinsh.blogspot.de/2012/07/waterundewater-shader-wip.html )
 
@@ -208,6 +210,10 @@ varying float linearDepth;
 uniform sampler2D normalMap;
 
 uniform sampler2D reflectionMap;
+#if REFLECTION_REPROJECTION
+// the view the reflection was rendered for, which may lag behind the current view
+uniform mat4 reflectionViewProjection;
+#endif
 #if REFRACTION
 uniform sampler2D refractionMap;
 uniform sampler2D refractionDepthMap;
@@ -223,6 +229,32 @@ uniform float rainIntensity;
 
 uniform vec2 screenRes;
 
+#if RIPPLE_MAP
+// heights of the ripples around the player, simulated on the GPU
+uniform sampler2D rippleMap;
+uniform vec2 rippleMapOrigin;
+uniform float rippleMapSize;       // 0 until the first step was simulated
+
+const float RIPPLE_MAP_STRENGTH = 2.0;
+
+vec3 rippleMapNormal(vec2 worldPos)
+{
+    if (rippleMapSize <= 0.0)
+        return vec3(0.0);
+
+    vec2 coords = (worldPos - rippleMapOrigin) / rippleMapSize;
+    // fade out towards the edges where the simulation stops
+    float fade = clamp(min(min(coords.x, 1.0 - coords.x), min(coords.y, 1.0 - coords.y)) * 10.0, 0.0, 1.0);
+    if (fade <= 0.0)
+        return vec3(0.0);
+
+    float texel = 1.0 / @rippleMapResolution.0;
+    vec2 gradient = vec2(texture2D(rippleMap, coords + vec2(texel, 0.0)).r - texture2D(rippleMap, coords - vec2(texel, 0.0)).r,
+                         texture2D(rippleMap, coords + vec2(0.0, texel)).r - texture2D(rippleMap, coords - vec2(0.0, texel)).r);
+    return vec3(gradient * RIPPLE_MAP_STRENGTH * fade, 0.0);
+}
+#endif
+
 #define PER_PIXEL_LIGHTING 0
 
 #include "shadows_fragment.glsl"
@@ -268,6 +300,9 @@ void main(void)
       rainRipple = vec4(0.0);
 
     vec3 rippleAdd = rainRipple.xyz * 10.0;
+#if RIPPLE_MAP
+    rippleAdd += rippleMapNormal(worldPos.xy);
+#endif
 
     vec2 bigWaves = vec2(BIG_WAVES_X,BIG_WAVES_Y);
     vec2 midWaves = mix(vec2(MID_WAVES_X,MID_WAVES_Y),vec2(MID_WAVES_RAIN_X,MID_WAVES_RAIN_Y),rainIntensity);
@@ -306,7 +341,13 @@ void main(void)
     screenCoordsOffset *= clamp(realWaterDepth / BUMP_SUPPRESS_DEPTH,0,1);
 #endif
     // reflection
-    vec3 reflection = texture2D(reflectionMap, screenCoords + screenCoordsOffset).rgb;
+#if REFLECTION_REPROJECTION
+    vec4 reflectionClipPos = reflectionViewProjection * vec4(worldPos, 1.0);
+    vec2 reflectionCoords = clamp(reflectionClipPos.xy / max(reflectionClipPos.w, 0.0001) * 0.5 + 0.5, 0.0, 1.0);
+#else
+    vec2 reflectionCoords = screenCoords;
+#endif
+    vec3 reflection = texture2D(reflectionMap, reflectionCoords + screenCoordsOffset).rgb;
 
     // specular
     float specular = pow(max(dot(reflect(vVec, normal), lVec), 0.0),SPEC_HARDNESS) * shadow;